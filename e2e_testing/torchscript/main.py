@@ -4,9 +4,11 @@
 # Also available under a BSD-style license. See LICENSE.
 
 import argparse
+import json
 import re
 import sys
 
+from torch_mlir_e2e_test.torchscript.benchmarking import report_benchmarks, run_benchmarks
 from torch_mlir_e2e_test.torchscript.framework import run_tests
 from torch_mlir_e2e_test.torchscript.reporting import report_results
 from torch_mlir_e2e_test.torchscript.registry import GLOBAL_TEST_REGISTRY
@@ -19,6 +21,7 @@ from torch_mlir_e2e_test.torchscript.configs import (
 )
 
 from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+from torch_mlir_e2e_test.linalg_on_tensors_backends.gpu_refbackend import GpuRefBackendLinalgOnTensorsBackend
 from torch_mlir_e2e_test.tosa_backends.linalg_on_tensors import LinalgOnTensorsTosaBackend
 
 from .xfail_sets import REFBACKEND_XFAIL_SET, TOSA_PASS_SET, EAGER_MODE_XFAIL_SET
@@ -28,7 +31,7 @@ from torch_mlir_e2e_test.test_suite import register_all_tests
 register_all_tests()
 
 def _get_argparse():
-    config_choices = ['native_torch', 'torchscript', 'refbackend', 'tosa', 'eager_mode']
+    config_choices = ['native_torch', 'torchscript', 'refbackend', 'refbackend_gpu', 'tosa', 'eager_mode']
     parser = argparse.ArgumentParser(description='Run torchscript e2e tests.')
     parser.add_argument('-c', '--config',
         choices=config_choices,
@@ -36,10 +39,18 @@ def _get_argparse():
         help=f'''
 Meaning of options:
 "refbackend": run through torch-mlir's RefBackend.
+"refbackend_gpu": run through torch-mlir's RefBackend, with the linalg ops mapped to kernels on a GPU of the platform given by --gpu-platform.
 "tosa": run through torch-mlir's default TOSA backend.
 "native_torch": run the torch.nn.Module as-is without compiling (useful for verifying model is deterministic; ALL tests should pass in this configuration).
 "torchscript": compile the model to a torch.jit.ScriptModule, and then run that as-is (useful for verifying TorchScript is modeling the program correctly).
 "eager_mode": run through torch-mlir's eager mode frontend, using RefBackend for execution.
+''')
+    parser.add_argument('--gpu-platform', choices=['cuda', 'rocm'],
+                        default='cuda',
+                        help='GPU platform of the "refbackend_gpu" config')
+    parser.add_argument('--gpu-chip', default=None, type=str, help='''
+Chip that the "refbackend_gpu" config compiles the kernels for, like sm_80 or
+gfx90a, instead of the default of MLIR.
 ''')
     parser.add_argument('-f', '--filter', default='.*', help='''
 Regular expression specifying which tests to include in this run.
@@ -60,6 +71,28 @@ for more information on building these artifacts.
                         default=False,
                         action='store_true',
                         help='run e2e tests sequentially rather than in parallel')
+    parser.add_argument('-b', '--benchmark',
+                        default=False,
+                        action='store_true',
+                        help='''
+Time the tests instead of checking their results: run each test on the config
+and on "native_torch", one test at a time, and report the latency percentiles
+and the speedup over "native_torch".
+''')
+    parser.add_argument('--benchmark-iterations', default=100, type=int,
+                        help='number of timed runs of each test in benchmark mode')
+    parser.add_argument('--benchmark-warmup', default=5, type=int,
+                        help='number of untimed runs of each test before the timed ones')
+    parser.add_argument('--compile-times-json', default=None, type=str, help='''
+Write the times of the phases of compiling each test, i.e. the import, each
+pipeline and each of its passes, and the backend compile and load, in
+seconds, to this JSON file.
+''')
+    parser.add_argument('--memory-usage-json', default=None, type=str, help='''
+Write the peak resident set size of the process and the peak memory allocated
+by Python while compiling and while running each test, in bytes, to this JSON
+file.
+''')
     return parser
 
 def main():
@@ -77,6 +110,11 @@ def main():
     if args.config == 'tosa':
         config = TosaBackendTestConfig(LinalgOnTensorsTosaBackend())
         xfail_set = all_test_unique_names - TOSA_PASS_SET
+    elif args.config == 'refbackend_gpu':
+        config = LinalgOnTensorsBackendTestConfig(
+            GpuRefBackendLinalgOnTensorsBackend(args.gpu_platform,
+                                                args.gpu_chip))
+        xfail_set = REFBACKEND_XFAIL_SET
     elif args.config == 'native_torch':
         config = NativeTorchTestConfig()
         xfail_set = {}
@@ -101,8 +139,29 @@ def main():
             print(test.unique_name)
         sys.exit(1)
 
+    if args.benchmark:
+        results = run_benchmarks(tests, config, NativeTorchTestConfig(),
+                                 args.benchmark_iterations,
+                                 args.benchmark_warmup)
+        report_benchmarks(results, args.verbose)
+        sys.exit(0)
+
     # Run the tests.
-    results = run_tests(tests, config, args.sequential)
+    results = run_tests(tests, config, args.sequential,
+                        record_compile_times=args.compile_times_json is not None,
+                        record_memory_usage=args.memory_usage_json is not None)
+    if args.compile_times_json is not None:
+        with open(args.compile_times_json, 'w') as f:
+            json.dump({
+                result.unique_name: result.compile_times
+                for result in results if result.compile_times is not None
+            }, f, indent=2, sort_keys=True)
+    if args.memory_usage_json is not None:
+        with open(args.memory_usage_json, 'w') as f:
+            json.dump({
+                result.unique_name: result.memory_usage
+                for result in results if result.memory_usage is not None
+            }, f, indent=2, sort_keys=True)
 
     # Report the test results.
     failed = report_results(results, xfail_set, args.verbose)
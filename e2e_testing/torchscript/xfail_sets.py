@@ -17,7 +17,12 @@ REFBACKEND_XFAIL_SET = COMMON_TORCH_MLIR_LOWERING_XFAILS
 EAGER_MODE_XFAIL_SET = {
     # RefBackend fails
     "TableBatchEmbeddingModule_basic",
-    "QuantizedMLP_basic"
+    "QuantizedMLP_basic",
+    # The kernels of custom ops are only called by the compiled programs.
+    "CustomKernelModule_basic",
+    # Only the sparse parameters of compiled programs are imported, not the
+    # sparse arguments of single ops.
+    "MmSparseWeightModule_basic",
 }
 
 # Write the TOSA set as a "passing" set as it is very early in development
@@ -100,6 +105,8 @@ TOSA_PASS_SET = {
     "ElementwiseFlattenBroadcastModule_basic",
     "SquareModule_basic",
     "MaxPool2dStaticModule_basic",
+    "MaxPool2dCeilModeTrueStaticModule_basic",
+    "AvgPool2dStaticModule_basic",
     "ResNet18StaticModule_basic",
     "NativeLayerNormModule4D_basic",
     "LayerNormNormalizeOverAllDimsModule_basic",
@@ -154,9 +161,12 @@ TOSA_PASS_SET = {
     "ElementwiseNeIntScalarModule_basic",
     "ElementwiseNeFloatTensorModule_basic",
     "ConvolutionModule2DStatic_basic",
+    "ConvolutionModule2DGroupsStatic_basic",
+    "ConvolutionModule2DDepthwiseStatic_basic",
     "ElementwiseNegModule_basic",
     "TestMultipleTensorReturn_basic",
     "AdaptiveAvgPool2dUnitOutputSizeStaticModule_basic",
+    "AdaptiveAvgPool2dNonUnitOutputSizeStaticModule_basic",
     "BaddbmmDynamicModule_basic",
     "BaddbmmStaticModule_basic",
     "BaddbmmWithAlphaBetaModule_basic",
@@ -172,4 +182,9 @@ TOSA_PASS_SET = {
     "TModuleRank2_basic",
     "TransposeIntModule_basic",
     "TransposeIntNegDimsModule_basic",
+    "SoftmaxIntModule_basic",
+    "SoftmaxIntNegDimModule_basic",
+    "_SoftmaxModule_basic",
+    "_LogSoftmaxModule_basic",
+    "_LogSoftmaxModuleStable_basic",
 }
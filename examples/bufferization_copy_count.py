@@ -0,0 +1,56 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# Measures the `memref.copy` ops that the RefBackend bufferization inserts in
+# the e2e test suite programs, with the piecewise bufferization passes and
+# with one-shot bufferization.
+
+from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir.compiler_utils import LINALG_ON_TENSORS_BACKEND_LEGAL_OPS
+from torch_mlir_e2e_test.linalg_on_tensors_backends import refbackend
+from torch_mlir_e2e_test.test_suite import register_all_tests
+from torch_mlir_e2e_test.torchscript.configs.utils import (
+    convert_torchscript_module_to_torch_backend_contract_mlir,
+)
+from torch_mlir_e2e_test.torchscript.registry import GLOBAL_TEST_REGISTRY
+
+
+def bufferize(module, one_shot_bufferize):
+    """Runs the RefBackend pipeline on `module` up to the bufferization."""
+    pipeline = refbackend.get_lowering_pipeline(
+        one_shot_bufferize=one_shot_bufferize)
+    bufferization = (refbackend.ONE_SHOT_BUFFERIZATION if one_shot_bufferize
+                     else refbackend.PIECEWISE_BUFFERIZATION)
+    end = pipeline.index(bufferization) + len(bufferization)
+    run_pipeline_with_repro_report(module, pipeline[:end],
+                                   "Bufferizing with RefBackend")
+
+
+def count_copies(test, one_shot_bufferize):
+    module = convert_torchscript_module_to_torch_backend_contract_mlir(
+        test.program_factory(), LINALG_ON_TENSORS_BACKEND_LEGAL_OPS)
+    run_pipeline_with_repro_report(
+        module, "torch-backend-to-linalg-on-tensors-backend-pipeline",
+        "Lower Torch Backend IR -> Linalg-on-Tensors Backend IR")
+    bufferize(module, one_shot_bufferize)
+    return str(module).count("memref.copy")
+
+
+register_all_tests()
+piecewise_total = one_shot_total = num_programs = 0
+for test in sorted(GLOBAL_TEST_REGISTRY, key=lambda test: test.unique_name):
+    try:
+        piecewise = count_copies(test, one_shot_bufferize=False)
+        one_shot = count_copies(test, one_shot_bufferize=True)
+    except Exception:
+        # Programs that don't compile in either configuration are skipped.
+        continue
+    if piecewise != one_shot:
+        print(f"{test.unique_name}: {piecewise} -> {one_shot}")
+    piecewise_total += piecewise
+    one_shot_total += one_shot
+    num_programs += 1
+print(f"memref.copy ops in {num_programs} programs: "
+      f"{piecewise_total} -> {one_shot_total}")
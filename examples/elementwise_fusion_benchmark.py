@@ -0,0 +1,78 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# Measures the effect of elementwise fusion in the RefBackend lowering
+# pipeline on a bias + GELU + residual chain: the number of `linalg.generic`
+# ops, the bytes of tensors they write, and the runtime.
+
+import re
+import timeit
+
+import torch
+
+import torch_mlir
+from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir.passmanager import PassManager
+from torch_mlir_e2e_test.linalg_on_tensors_backends import refbackend
+
+FUSION_PASS = "func.func(linalg-fuse-elementwise-ops)"
+ELEMENT_BYTES = {"f32": 4, "f64": 8, "i1": 1, "i32": 4, "i64": 8}
+
+
+class BiasGeluResidual(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.bias = torch.nn.Parameter(torch.rand(1024))
+
+    def forward(self, x):
+        y = x + self.bias
+        y = 0.5 * y * (1.0 + torch.tanh(0.7978845608 * (y + 0.044715 * y * y * y)))
+        return y + x
+
+
+def generic_op_traffic(module):
+    """Returns the number of `linalg.generic` ops and bytes they write."""
+    asm = module.operation.get_asm(large_elements_limit=10)
+    num_ops = asm.count("linalg.generic")
+    num_bytes = 0
+    for shape, dtype in re.findall(r"\} -> tensor<((?:\d+x)*)(\w+)>", asm):
+        num_elements = 1
+        for size in shape.split("x")[:-1]:
+            num_elements *= int(size)
+        num_bytes += num_elements * ELEMENT_BYTES[dtype]
+    return num_ops, num_bytes
+
+
+def compile_to_linalg(model, example_input):
+    return torch_mlir.compile(model, example_input,
+                              output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+
+
+def benchmark(model, example_input, pipeline, description):
+    module = compile_to_linalg(model, example_input)
+    run_pipeline_with_repro_report(module, pipeline, description)
+    forward = refbackend.RefBackendInvoker(module).forward
+    arg = example_input.numpy()
+    return min(timeit.repeat(lambda: forward(arg), number=10, repeat=5)) / 10
+
+
+model = BiasGeluResidual()
+model.eval()
+example_input = torch.rand(512, 1024)
+
+module = compile_to_linalg(model, example_input)
+unfused_ops, unfused_bytes = generic_op_traffic(module)
+with module.context:
+    PassManager.parse(FUSION_PASS).run(module)
+fused_ops, fused_bytes = generic_op_traffic(module)
+print(f"linalg.generic ops: {unfused_ops} -> {fused_ops}")
+print(f"bytes written by linalg.generic ops: {unfused_bytes} -> {fused_bytes}")
+
+unfused_pipeline = refbackend.LOWERING_PIPELINE.replace(FUSION_PASS + ",", "")
+unfused_time = benchmark(model, example_input, unfused_pipeline,
+                         "Lowering without elementwise fusion")
+fused_time = benchmark(model, example_input, refbackend.LOWERING_PIPELINE,
+                       "Lowering with elementwise fusion")
+print(f"time per call: {unfused_time * 1e3:.3f} ms -> {fused_time * 1e3:.3f} ms")
@@ -18,6 +18,7 @@ namespace torch {
 namespace TMTensor {
 
 std::unique_ptr<OperationPass<func::FuncOp>> createTMTensorToLoopsPass();
+std::unique_ptr<OperationPass<func::FuncOp>> createTMTensorTilePass();
 std::unique_ptr<OperationPass<func::FuncOp>> createTMTensorBufferizePass();
 
 void registerPasses();
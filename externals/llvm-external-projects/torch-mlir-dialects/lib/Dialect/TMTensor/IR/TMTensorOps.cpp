@@ -16,6 +16,7 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/Dialect/Utils/StructuredOpsUtils.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -84,6 +85,23 @@ OpFoldResult TMTensor::getDim(OpBuilder &builder, Location loc, Value v,
   return builder.getI64IntegerAttr(t.getDimSize(dim));
 }
 
+/// Returns a `memref.subview` or a `tensor.extract_slice` of `source`.
+static Value getSlice(OpBuilder &b, Location loc, Value source,
+                      ArrayRef<OpFoldResult> offsets,
+                      ArrayRef<OpFoldResult> sizes,
+                      ArrayRef<OpFoldResult> strides) {
+  return TypeSwitch<Type, Value>(source.getType())
+      .Case<RankedTensorType>([&](RankedTensorType t) -> Value {
+        return b.create<tensor::ExtractSliceOp>(loc, source, offsets, sizes,
+                                                strides);
+      })
+      .Case<MemRefType>([&](MemRefType type) -> Value {
+        return b.create<memref::SubViewOp>(loc, source, offsets, sizes,
+                                           strides);
+      })
+      .Default([&](Type t) { return nullptr; });
+}
+
 //===----------------------------------------------------------------------===//
 // ScanOp
 //===----------------------------------------------------------------------===//
@@ -266,6 +284,96 @@ static LogicalResult foldMemRefCast(Operation *op) {
   return success(folded);
 }
 
+/// Returns whether the tile at `offset` of `size` covers the whole dimension
+/// `dim` of `source`, whose size is either static or a `tensor.dim` or
+/// `memref.dim` of `source`, like in the iteration domains.
+static bool isWholeDim(OpFoldResult offset, OpFoldResult size, Value source,
+                       int64_t dim) {
+  if (getConstantIntValue(offset) != static_cast<int64_t>(0))
+    return false;
+  auto sourceType = source.getType().cast<ShapedType>();
+  if (!sourceType.isDynamicDim(dim))
+    return getConstantIntValue(size) == sourceType.getDimSize(dim);
+  auto sizeValue = size.dyn_cast<Value>();
+  Operation *dimOp = sizeValue ? sizeValue.getDefiningOp() : nullptr;
+  if (!dimOp || !isa<tensor::DimOp, memref::DimOp>(dimOp))
+    return false;
+  return dimOp->getOperand(0) == source &&
+         getConstantIntValue(dimOp->getOperand(1)) == dim;
+}
+
+SmallVector<Operation *>
+ScanOp::getTiledImplementation(OpBuilder &builder, ValueRange outputs,
+                               ArrayRef<OpFoldResult> offsets,
+                               ArrayRef<OpFoldResult> sizes,
+                               bool /*tileDestOperands*/) {
+  int64_t rank = getOperandRank();
+  assert(outputs.size() == this->outputs().size() &&
+         offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  // A tile of the scanned dimension needs the accumulated value of the tiles
+  // before it, so the scanned dimension can't be tiled.
+  int64_t scanDim = dimension();
+  if (!isWholeDim(offsets[scanDim], sizes[scanDim], input(), scanDim))
+    return {};
+  Location loc = getLoc();
+  auto oneAttr = builder.getI64IntegerAttr(1);
+  SmallVector<OpFoldResult> strides(rank, oneAttr);
+  SmallVector<Value> tiledOperands;
+  tiledOperands.push_back(
+      getSlice(builder, loc, input(), offsets, sizes, strides));
+  tiledOperands.push_back(
+      getSlice(builder, loc, outputs[0], offsets, sizes, strides));
+  if (rank > 1) {
+    SmallVector<OpFoldResult> accumulatorOffsets, accumulatorSizes;
+    if (failed(getResultTilePosition(builder, 1, offsets, sizes,
+                                     accumulatorOffsets, accumulatorSizes))) {
+      return {};
+    }
+    SmallVector<OpFoldResult> accumulatorStrides(rank - 1, oneAttr);
+    tiledOperands.push_back(getSlice(builder, loc, outputs[1],
+                                     accumulatorOffsets, accumulatorSizes,
+                                     accumulatorStrides));
+  } else {
+    tiledOperands.push_back(outputs[1]);
+  }
+
+  SmallVector<Type> resultTypes;
+  if (hasTensorSemantics()) {
+    resultTypes.push_back(tiledOperands[1].getType());
+    resultTypes.push_back(tiledOperands[2].getType());
+  }
+  Operation *tiledScanOp = cast<TMTensorOp>(getOperation())
+                               .clone(builder, loc, resultTypes, tiledOperands);
+  return {tiledScanOp};
+}
+
+SmallVector<Value> ScanOp::getDestinationOperands(OpBuilder &builder) {
+  return SmallVector<Value>(outputs().begin(), outputs().end());
+}
+
+LogicalResult ScanOp::getResultTilePosition(
+    OpBuilder &builder, unsigned resultNumber, ArrayRef<OpFoldResult> offsets,
+    ArrayRef<OpFoldResult> sizes, SmallVector<OpFoldResult> &resultOffsets,
+    SmallVector<OpFoldResult> &resultSizes) {
+  if (resultNumber == 0) {
+    resultOffsets.assign(offsets.begin(), offsets.end());
+    resultSizes.assign(sizes.begin(), sizes.end());
+    return success();
+  }
+  if (resultNumber == 1) {
+    // The accumulator has all the dimensions but the scanned one.
+    for (auto i : llvm::seq<int64_t>(0, getOperandRank())) {
+      if (i == static_cast<int64_t>(dimension()))
+        continue;
+      resultOffsets.push_back(offsets[i]);
+      resultSizes.push_back(sizes[i]);
+    }
+    return success();
+  }
+  return failure();
+}
+
 LogicalResult ScanOp::fold(ArrayRef<Attribute>,
                            SmallVectorImpl<OpFoldResult> &) {
   return foldMemRefCast(*this);
@@ -429,11 +537,89 @@ SmallVector<Range> ScatterOp::getIterationDomain(OpBuilder &builder) {
   return ranges;
 }
 
-LogicalResult ScatterOp::generateScalarImplementation(OpBuilder &b,
-                                                      Location loc,
-                                                      ValueRange ivs) {
+SmallVector<Value> ScatterOp::getDestinationOperands(OpBuilder &builder) {
+  return {original()};
+}
+
+SmallVector<Operation *>
+ScatterOp::getTiledImplementation(OpBuilder &builder, ValueRange outputs,
+                                  ArrayRef<OpFoldResult> offsets,
+                                  ArrayRef<OpFoldResult> sizes,
+                                  bool /*tileDestOperands*/) {
+  assert(outputs.size() >= 1 && offsets.size() >= 1 && sizes.size() >= 1);
+  Location loc = getLoc();
+  auto zeroAttr = builder.getI64IntegerAttr(0);
+  auto oneAttr = builder.getI64IntegerAttr(1);
+
+  // Slice of the updates.
+  auto updateRank = getUpdateType().getRank();
+  SmallVector<OpFoldResult> updateStrides(updateRank, oneAttr);
+  Value tiledUpdate =
+      getSlice(builder, loc, updates(), offsets, sizes, updateStrides);
+
+  // Slice of the indices, for the updates of the tile.
+  auto indicesRank = getIndicesType().getRank();
+  SmallVector<OpFoldResult> indicesOffsets(indicesRank, zeroAttr);
+  SmallVector<OpFoldResult> indicesSizes(indicesRank);
+  indicesOffsets[0] = offsets[0];
+  indicesSizes[0] = sizes[0];
+  for (auto dim : llvm::seq<int64_t>(1, indicesRank))
+    indicesSizes[dim] = getDim(builder, loc, indices(), dim);
+  SmallVector<OpFoldResult> indicesStrides(indicesRank, oneAttr);
+  Value tiledIndices = getSlice(builder, loc, indices(), indicesOffsets,
+                                indicesSizes, indicesStrides);
+
+  // Slice of the original.
+  SmallVector<OpFoldResult> originalOffsets, originalSizes;
+  if (failed(getResultTilePosition(builder, 0, offsets, sizes, originalOffsets,
+                                   originalSizes))) {
+    return {};
+  }
+  auto originalRank = getOriginalType().getRank();
+  SmallVector<OpFoldResult> originalStrides(originalRank, oneAttr);
+  Value tiledOriginal = getSlice(builder, loc, outputs[0], originalOffsets,
+                                 originalSizes, originalStrides);
+
+  SmallVector<Type> resultTypes;
+  if (getNumResults())
+    resultTypes.push_back(tiledOriginal.getType());
+  Operation *tiledScatterOp =
+      cast<TMTensorOp>(getOperation())
+          .clone(builder, loc, resultTypes,
+                 ValueRange{tiledUpdate, tiledIndices, tiledOriginal});
+  return {tiledScatterOp};
+}
+
+LogicalResult ScatterOp::getResultTilePosition(
+    OpBuilder &builder, unsigned resultNumber, ArrayRef<OpFoldResult> offsets,
+    ArrayRef<OpFoldResult> sizes, SmallVector<OpFoldResult> &resultOffsets,
+    SmallVector<OpFoldResult> &resultSizes) {
+  // Any update can write anywhere in the leading dimensions of the original,
+  // which are addressed by the indices, while its trailing dimensions are
+  // those of the update slices. The update slices can't be tiled along the
+  // dimensions they are also offset by the indices along.
+  auto originalRank = getOriginalType().getRank();
+  auto updateRank = getUpdateType().getRank();
+  int64_t numIndexedDims = originalRank - updateRank + 1;
+  if (getIndexDepth() > numIndexedDims)
+    return failure();
+
+  auto zeroAttr = builder.getI64IntegerAttr(0);
+  resultOffsets.resize(originalRank, zeroAttr);
+  resultSizes.resize(originalRank);
+  Location loc = getLoc();
+  for (auto dim : llvm::seq<int64_t>(0, numIndexedDims))
+    resultSizes[dim] = getDim(builder, loc, original(), dim);
+  for (auto dim : llvm::seq<int64_t>(numIndexedDims, originalRank)) {
+    resultOffsets[dim] = offsets[dim - numIndexedDims + 1];
+    resultSizes[dim] = sizes[dim - numIndexedDims + 1];
+  }
+  return success();
+}
+
+SmallVector<Value> ScatterOp::getOriginalIndices(OpBuilder &b, Location loc,
+                                                 ValueRange ivs) {
   auto indexDepth = getIndexDepth();
-  Value update = b.create<memref::LoadOp>(loc, updates(), ivs);
   SmallVector<Value> starts;
   SmallVector<Value> loadIndices;
   loadIndices.push_back(ivs.front());
@@ -458,7 +644,14 @@ LogicalResult ScatterOp::generateScalarImplementation(OpBuilder &b,
       cast = b.create<arith::AddIOp>(loc, cast, starts[i]);
     starts[i] = cast;
   }
+  return starts;
+}
 
+LogicalResult ScatterOp::generateScalarImplementation(OpBuilder &b,
+                                                      Location loc,
+                                                      ValueRange ivs) {
+  Value update = b.create<memref::LoadOp>(loc, updates(), ivs);
+  SmallVector<Value> starts = getOriginalIndices(b, loc, ivs);
   Value init = b.create<memref::LoadOp>(loc, original(), starts);
 
   BlockAndValueMapping bvm;
@@ -476,6 +669,601 @@ LogicalResult ScatterOp::generateScalarImplementation(OpBuilder &b,
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// AttentionOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult AttentionOp::verify() {
+  if (getNumInputs() != 3 && getNumInputs() != 4) {
+    return emitOpError("expected three or four input operands");
+  }
+  if (getNumOutputs() != 1) {
+    return emitOpError("expected one output operand");
+  }
+  int64_t rank = getQueryRank();
+  auto elementType = getQueryType().getElementType();
+  if (rank < 2) {
+    return emitOpError("expected query to have rank of at least 2");
+  }
+  if (!elementType.isa<FloatType>()) {
+    return emitOpError("expected query element type to be float");
+  }
+  for (OpOperand *opOperand : getInputAndOutputOperands()) {
+    auto type = opOperand->get().getType().cast<ShapedType>();
+    if (type.getRank() != rank) {
+      return emitOpError("expected all operands to have identical ranks");
+    }
+    if (type.getElementType() != elementType) {
+      return emitOpError("expected all operands to have identical element "
+                         "types");
+    }
+  }
+
+  auto isCompatible = [](int64_t lhs, int64_t rhs) {
+    return lhs == ShapedType::kDynamicSize ||
+           rhs == ShapedType::kDynamicSize || lhs == rhs;
+  };
+  ArrayRef<int64_t> queryShape = getQueryType().getShape();
+  ArrayRef<int64_t> keyShape = key().getType().cast<ShapedType>().getShape();
+  ArrayRef<int64_t> valueShape =
+      value().getType().cast<ShapedType>().getShape();
+  ArrayRef<int64_t> outputShape =
+      output().getType().cast<ShapedType>().getShape();
+  for (int64_t i = 0; i < rank - 2; i++) {
+    if (!isCompatible(queryShape[i], keyShape[i]) ||
+        !isCompatible(queryShape[i], valueShape[i]) ||
+        !isCompatible(queryShape[i], outputShape[i])) {
+      return emitOpError("incompatible batch dimensions");
+    }
+  }
+  if (!isCompatible(queryShape[rank - 1], keyShape[rank - 1])) {
+    return emitOpError("incompatible query/key shapes");
+  }
+  if (!isCompatible(keyShape[rank - 2], valueShape[rank - 2])) {
+    return emitOpError("incompatible key/value shapes");
+  }
+  if (!isCompatible(queryShape[rank - 2], outputShape[rank - 2]) ||
+      !isCompatible(valueShape[rank - 1], outputShape[rank - 1])) {
+    return emitOpError("incompatible output shape");
+  }
+  if (Value maskValue = mask()) {
+    ArrayRef<int64_t> maskShape =
+        maskValue.getType().cast<ShapedType>().getShape();
+    SmallVector<int64_t> scoresShape(queryShape.drop_back());
+    scoresShape.push_back(keyShape[rank - 2]);
+    for (int64_t i = 0; i < rank; i++) {
+      if (maskShape[i] != 1 && !isCompatible(maskShape[i], scoresShape[i])) {
+        return emitOpError("incompatible mask shape");
+      }
+    }
+  }
+  return success();
+}
+
+SmallVector<Range> AttentionOp::getIterationDomain(OpBuilder &builder) {
+  // One loop per batch dimension and one for the query rows.
+  int64_t loopRank = getQueryRank() - 1;
+  SmallVector<Range> loopBounds(loopRank);
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  for (auto dim : llvm::seq<int64_t>(0, loopRank)) {
+    loopBounds[dim].offset = zero;
+    loopBounds[dim].size = getDimValue(builder, loc, query(), dim);
+    loopBounds[dim].stride = one;
+  }
+  return loopBounds;
+}
+
+SmallVector<StringRef> AttentionOp::getLoopIteratorTypes() {
+  return SmallVector<StringRef>(getQueryRank() - 1,
+                                getParallelIteratorTypeName());
+}
+
+bool AttentionOp::payloadUsesValueFromOperand(OpOperand *opOperand) {
+  // The output row is overwritten before being accumulated into.
+  return opOperand->get() != output();
+}
+
+// Generates the computation of one output row, streaming over the keys with
+// an online softmax:
+//     max = -inf, sum = 0, output[m, :] = 0
+//     for n:
+//       score = scale * dot(query[m, :], key[n, :]) + mask[m, n]
+//       newMax = max(max, score)
+//       correction = exp(max - newMax)
+//       weight = exp(score - newMax)
+//       sum = sum * correction + weight
+//       output[m, :] = output[m, :] * correction + weight * value[n, :]
+//       max = newMax
+//     output[m, :] = output[m, :] / sum
+
+LogicalResult AttentionOp::generateScalarImplementation(OpBuilder &b,
+                                                        Location loc,
+                                                        ValueRange ivs) {
+  int64_t rank = getQueryRank();
+  auto elementType = getQueryType().getElementType().cast<FloatType>();
+  Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  Value zeroFloat =
+      b.create<arith::ConstantOp>(loc, b.getFloatAttr(elementType, 0.0));
+  Value negInf = b.create<arith::ConstantOp>(
+      loc, b.getFloatAttr(elementType,
+                          APFloat::getInf(elementType.getFloatSemantics(),
+                                          /*Negative=*/true)));
+  Value scaleValue = b.create<arith::ConstantOp>(
+      loc, b.getFloatAttr(elementType, scale().convertToDouble()));
+  Value headDim = getDimValue(b, loc, query(), rank - 1);
+  Value numKeys = getDimValue(b, loc, key(), rank - 2);
+  Value valueDim = getDimValue(b, loc, value(), rank - 1);
+
+  ValueRange batchIvs = ivs.drop_back();
+  Value row = ivs.back();
+  auto getIndices = [&](Value i, Value j) {
+    SmallVector<Value> indices(batchIvs.begin(), batchIvs.end());
+    indices.push_back(i);
+    indices.push_back(j);
+    return indices;
+  };
+
+  b.create<scf::ForOp>(
+      loc, zero, valueDim, one, ValueRange{},
+      [&](OpBuilder &b, Location loc, Value d, ValueRange args) {
+        b.create<memref::StoreOp>(loc, zeroFloat, output(), getIndices(row, d));
+        b.create<scf::YieldOp>(loc);
+      });
+
+  auto keyLoop = b.create<scf::ForOp>(
+      loc, zero, numKeys, one, ValueRange{negInf, zeroFloat},
+      [&](OpBuilder &b, Location loc, Value n, ValueRange args) {
+        Value max = args[0], sum = args[1];
+        auto dot = b.create<scf::ForOp>(
+            loc, zero, headDim, one, ValueRange{zeroFloat},
+            [&](OpBuilder &b, Location loc, Value k, ValueRange args) {
+              Value q =
+                  b.create<memref::LoadOp>(loc, query(), getIndices(row, k));
+              Value kv = b.create<memref::LoadOp>(loc, key(), getIndices(n, k));
+              Value acc = b.create<arith::AddFOp>(
+                  loc, args[0], b.create<arith::MulFOp>(loc, q, kv));
+              b.create<scf::YieldOp>(loc, acc);
+            });
+        Value score =
+            b.create<arith::MulFOp>(loc, dot.getResult(0), scaleValue);
+        if (Value maskValue = mask()) {
+          auto maskType = maskValue.getType().cast<ShapedType>();
+          SmallVector<Value> maskIndices = getIndices(row, n);
+          for (int64_t i = 0; i < rank; i++) {
+            if (maskType.getDimSize(i) == 1)
+              maskIndices[i] = zero;
+          }
+          score = b.create<arith::AddFOp>(
+              loc, score,
+              b.create<memref::LoadOp>(loc, maskValue, maskIndices));
+        }
+        Value newMax = b.create<arith::MaxFOp>(loc, max, score);
+        // While all the scores seen so far are -inf (e.g. masked out), shift
+        // by 0 instead of -inf so that their weights are 0 rather than NaN.
+        Value isNegInf = b.create<arith::CmpFOp>(
+            loc, arith::CmpFPredicate::OEQ, newMax, negInf);
+        Value shift =
+            b.create<arith::SelectOp>(loc, isNegInf, zeroFloat, newMax);
+        Value correction = b.create<math::ExpOp>(
+            loc, b.create<arith::SubFOp>(loc, max, shift));
+        Value weight = b.create<math::ExpOp>(
+            loc, b.create<arith::SubFOp>(loc, score, shift));
+        Value newSum = b.create<arith::AddFOp>(
+            loc, b.create<arith::MulFOp>(loc, sum, correction), weight);
+        b.create<scf::ForOp>(
+            loc, zero, valueDim, one, ValueRange{},
+            [&](OpBuilder &b, Location loc, Value d, ValueRange args) {
+              SmallVector<Value> outputIndices = getIndices(row, d);
+              Value acc =
+                  b.create<memref::LoadOp>(loc, output(), outputIndices);
+              Value v =
+                  b.create<memref::LoadOp>(loc, value(), getIndices(n, d));
+              Value newAcc = b.create<arith::AddFOp>(
+                  loc, b.create<arith::MulFOp>(loc, acc, correction),
+                  b.create<arith::MulFOp>(loc, weight, v));
+              b.create<memref::StoreOp>(loc, newAcc, output(), outputIndices);
+              b.create<scf::YieldOp>(loc);
+            });
+        b.create<scf::YieldOp>(loc, ValueRange{newMax, newSum});
+      });
+
+  Value sum = keyLoop.getResult(1);
+  b.create<scf::ForOp>(
+      loc, zero, valueDim, one, ValueRange{},
+      [&](OpBuilder &b, Location loc, Value d, ValueRange args) {
+        SmallVector<Value> outputIndices = getIndices(row, d);
+        Value acc = b.create<memref::LoadOp>(loc, output(), outputIndices);
+        b.create<memref::StoreOp>(loc, b.create<arith::DivFOp>(loc, acc, sum),
+                                  output(), outputIndices);
+        b.create<scf::YieldOp>(loc);
+      });
+  return success();
+}
+
+/// Clones the comparator `block` with its arguments mapped to `args`, and
+/// returns the `i1` it yields.
+static Value cloneComparator(OpBuilder &b, Block &block, ValueRange args) {
+  BlockAndValueMapping bvm;
+  bvm.map(block.getArguments(), args);
+  for (auto &blockOp : block.without_terminator())
+    b.clone(blockOp, bvm);
+  return bvm.lookupOrDefault(block.getTerminator()->getOperand(0));
+}
+
+/// Verifies that `region` is a comparator of elements of `elementTypes`,
+/// taking two of each of them.
+static LogicalResult verifyComparator(Operation *op, Region &region,
+                                      ArrayRef<Type> elementTypes) {
+  Block &block = region.front();
+  if (block.getNumArguments() != 2 * elementTypes.size()) {
+    return op->emitOpError("expected region to have ")
+           << 2 * elementTypes.size() << " arguments";
+  }
+  for (auto it : llvm::enumerate(elementTypes)) {
+    if (block.getArgument(2 * it.index()).getType() != it.value() ||
+        block.getArgument(2 * it.index() + 1).getType() != it.value()) {
+      return op->emitOpError("expected region arguments #")
+             << 2 * it.index() << " and #" << 2 * it.index() + 1
+             << " to be of type " << it.value();
+    }
+  }
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  if (yieldOp.getNumOperands() != 1 ||
+      !yieldOp.getOperand(0).getType().isInteger(1)) {
+    return op->emitOpError("expected region to yield a single i1");
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// SortOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult SortOp::verify() {
+  if (getNumInputs() != 0) {
+    return emitOpError("expected no input operands");
+  }
+  if (getNumOutputs() == 0) {
+    return emitOpError("expected at least one output operand");
+  }
+  int64_t rank = getOperandRank();
+  if (dimension() >= static_cast<uint64_t>(rank)) {
+    return emitOpError("dimension must be within [0, ") << rank << ")";
+  }
+  ArrayRef<int64_t> shape = getOperandType(0).getShape();
+  SmallVector<Type> elementTypes;
+  for (OpOperand *opOperand : getOutputOperands()) {
+    auto type = opOperand->get().getType().cast<ShapedType>();
+    if (type.getRank() != rank) {
+      return emitOpError("expected all operands to have identical ranks");
+    }
+    if (llvm::any_of(llvm::zip(shape, type.getShape()),
+                     [](std::tuple<int64_t, int64_t> s) {
+                       return std::get<0>(s) != ShapedType::kDynamicSize &&
+                              std::get<1>(s) != ShapedType::kDynamicSize &&
+                              std::get<0>(s) != std::get<1>(s);
+                     })) {
+      return emitOpError("expected all operands to have compatible shapes");
+    }
+    elementTypes.push_back(type.getElementType());
+  }
+  return verifyComparator(getOperation(), region(), elementTypes);
+}
+
+SmallVector<Range> SortOp::getIterationDomain(OpBuilder &builder) {
+  int64_t operandRank = getOperandRank();
+  SmallVector<Range> loopBounds(operandRank);
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  for (auto dim : llvm::seq<int64_t>(0, operandRank)) {
+    loopBounds[dim].offset = zero;
+    loopBounds[dim].size = getDimValue(builder, loc, operand(0), dim);
+    loopBounds[dim].stride = one;
+  }
+  // Each slice along `dimension` is sorted as a whole by a single iteration.
+  loopBounds[dimension()].size = one;
+  return loopBounds;
+}
+
+SmallVector<StringRef> SortOp::getLoopIteratorTypes() {
+  SmallVector<StringRef> iteratorTypes(getOperandRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[dimension()] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+bool SortOp::payloadUsesValueFromOperand(OpOperand *opOperand) {
+  // The outputs are sorted in place.
+  return true;
+}
+
+// Generates a bottom-up merge sort of the slice of the outputs along
+// `dimension` at `ivs`. Each pass merges the pairs of adjacent sorted runs of
+// `width` elements into a scratch buffer, which is then copied back:
+//     for (width = 1; width < size; width *= 2):
+//       for lo in [0, size) step 2 * width:
+//         mid, hi = min(lo + width, size), min(lo + 2 * width, size)
+//         i, j = lo, mid
+//         for k in [lo, hi):
+//           if j < hi and (i >= mid or comparator(outputs[j], outputs[i])):
+//             scratch[k] = outputs[j++]
+//           else:
+//             scratch[k] = outputs[i++]
+//       outputs = scratch
+// This takes O(size * log(size)) comparisons. Only taking the element of the
+// right run when it is strictly before the one of the left run keeps the sort
+// stable.
+LogicalResult SortOp::generateScalarImplementation(OpBuilder &b, Location loc,
+                                                   ValueRange ivs) {
+  uint64_t sortDim = dimension();
+  Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  Value two = b.create<arith::ConstantIndexOp>(loc, 2);
+  Value size = getDimValue(b, loc, operand(0), sortDim);
+  auto getIndices = [&](Value i) {
+    SmallVector<Value> indices(ivs.begin(), ivs.end());
+    indices[sortDim] = i;
+    return indices;
+  };
+
+  SmallVector<Value> scratches;
+  for (OpOperand *opOperand : getOutputOperands()) {
+    Type elementType =
+        opOperand->get().getType().cast<ShapedType>().getElementType();
+    scratches.push_back(b.create<memref::AllocOp>(
+        loc, MemRefType::get({ShapedType::kDynamicSize}, elementType),
+        ValueRange{size}));
+  }
+
+  Type indexType = b.getIndexType();
+  auto whileOp =
+      b.create<scf::WhileOp>(loc, TypeRange{indexType}, ValueRange{one});
+  {
+    OpBuilder::InsertionGuard guard(b);
+    Block *before = b.createBlock(&whileOp.getBefore(),
+                                  whileOp.getBefore().end(), {indexType}, {loc});
+    Value isUnsorted = b.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ult, before->getArgument(0), size);
+    b.create<scf::ConditionOp>(loc, isUnsorted, before->getArguments());
+
+    Block *after = b.createBlock(&whileOp.getAfter(), whileOp.getAfter().end(),
+                                 {indexType}, {loc});
+    Value width = after->getArgument(0);
+    Value doubleWidth = b.create<arith::MulIOp>(loc, width, two);
+    b.create<scf::ForOp>(
+        loc, zero, size, doubleWidth, ValueRange{},
+        [&](OpBuilder &b, Location loc, Value lo, ValueRange args) {
+          Value mid = b.create<arith::MinUIOp>(
+              loc, b.create<arith::AddIOp>(loc, lo, width), size);
+          Value hi = b.create<arith::MinUIOp>(
+              loc, b.create<arith::AddIOp>(loc, lo, doubleWidth), size);
+          // Once a run is exhausted, its last element is read instead of the
+          // one past its end, and ignored.
+          Value leftLast = b.create<arith::SubIOp>(loc, mid, one);
+          Value rightLast = b.create<arith::SubIOp>(loc, hi, one);
+          b.create<scf::ForOp>(
+              loc, lo, hi, one, ValueRange{lo, mid},
+              [&](OpBuilder &b, Location loc, Value k, ValueRange args) {
+                Value i = args[0], j = args[1];
+                SmallVector<Value> leftIndices =
+                    getIndices(b.create<arith::MinUIOp>(loc, i, leftLast));
+                SmallVector<Value> rightIndices =
+                    getIndices(b.create<arith::MinUIOp>(loc, j, rightLast));
+                SmallVector<Value> left, right, comparatorArgs;
+                for (OpOperand *opOperand : getOutputOperands()) {
+                  left.push_back(b.create<memref::LoadOp>(
+                      loc, opOperand->get(), leftIndices));
+                  right.push_back(b.create<memref::LoadOp>(
+                      loc, opOperand->get(), rightIndices));
+                  comparatorArgs.push_back(right.back());
+                  comparatorArgs.push_back(left.back());
+                }
+                Value isRightBefore =
+                    cloneComparator(b, region().front(), comparatorArgs);
+                Value isLeftDone = b.create<arith::CmpIOp>(
+                    loc, arith::CmpIPredicate::uge, i, mid);
+                Value hasRight = b.create<arith::CmpIOp>(
+                    loc, arith::CmpIPredicate::ult, j, hi);
+                Value takeRight = b.create<arith::AndIOp>(
+                    loc, hasRight,
+                    b.create<arith::OrIOp>(loc, isLeftDone, isRightBefore));
+                for (auto it : llvm::enumerate(scratches)) {
+                  Value value = b.create<arith::SelectOp>(
+                      loc, takeRight, right[it.index()], left[it.index()]);
+                  b.create<memref::StoreOp>(loc, value, it.value(), k);
+                }
+                Value nextI = b.create<arith::SelectOp>(
+                    loc, takeRight, i, b.create<arith::AddIOp>(loc, i, one));
+                Value nextJ = b.create<arith::SelectOp>(
+                    loc, takeRight, b.create<arith::AddIOp>(loc, j, one), j);
+                b.create<scf::YieldOp>(loc, ValueRange{nextI, nextJ});
+              });
+          b.create<scf::YieldOp>(loc);
+        });
+    b.create<scf::ForOp>(
+        loc, zero, size, one, ValueRange{},
+        [&](OpBuilder &b, Location loc, Value k, ValueRange args) {
+          for (auto it : llvm::enumerate(getOutputOperands())) {
+            Value value =
+                b.create<memref::LoadOp>(loc, scratches[it.index()], k);
+            b.create<memref::StoreOp>(loc, value, it.value()->get(),
+                                      getIndices(k));
+          }
+          b.create<scf::YieldOp>(loc);
+        });
+    b.create<scf::YieldOp>(loc, doubleWidth);
+  }
+  for (Value scratch : scratches)
+    b.create<memref::DeallocOp>(loc, scratch);
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// TopkOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult TopkOp::verify() {
+  if (getNumInputs() != 1) {
+    return emitOpError("expected one input operand");
+  }
+  if (getNumOutputs() != 2) {
+    return emitOpError("expected two output operands");
+  }
+  int64_t rank = getInputRank();
+  if (dimension() >= static_cast<uint64_t>(rank)) {
+    return emitOpError("dimension must be within [0, ") << rank << ")";
+  }
+  auto valuesType = outputValues().getType().cast<ShapedType>();
+  auto indicesType = outputIndices().getType().cast<ShapedType>();
+  if (valuesType.getRank() != rank || indicesType.getRank() != rank) {
+    return emitOpError("expected all operands to have identical ranks");
+  }
+  Type elementType = getInputType().getElementType();
+  if (valuesType.getElementType() != elementType) {
+    return emitOpError(
+        "expected input/output value element types to be identical");
+  }
+  if (!indicesType.getElementType().isa<IntegerType>()) {
+    return emitOpError("expected output indices to be of integer type");
+  }
+  auto isCompatible = [](int64_t lhs, int64_t rhs) {
+    return lhs == ShapedType::kDynamicSize ||
+           rhs == ShapedType::kDynamicSize || lhs == rhs;
+  };
+  ArrayRef<int64_t> inputShape = getInputType().getShape();
+  for (int64_t i = 0; i < rank; i++) {
+    if (!isCompatible(valuesType.getDimSize(i), indicesType.getDimSize(i))) {
+      return emitOpError("incompatible output value/indices shapes");
+    }
+    if (i != static_cast<int64_t>(dimension()) &&
+        !isCompatible(inputShape[i], valuesType.getDimSize(i))) {
+      return emitOpError("incompatible input/output shapes");
+    }
+  }
+  return verifyComparator(getOperation(), region(), {elementType});
+}
+
+SmallVector<Range> TopkOp::getIterationDomain(OpBuilder &builder) {
+  int64_t inputRank = getInputRank();
+  SmallVector<Range> loopBounds(inputRank);
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  for (auto dim : llvm::seq<int64_t>(0, inputRank)) {
+    loopBounds[dim].offset = zero;
+    loopBounds[dim].size = getDimValue(builder, loc, input(), dim);
+    loopBounds[dim].stride = one;
+  }
+  return loopBounds;
+}
+
+SmallVector<StringRef> TopkOp::getLoopIteratorTypes() {
+  SmallVector<StringRef> iteratorTypes(getInputRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[dimension()] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+bool TopkOp::payloadUsesValueFromOperand(OpOperand *opOperand) {
+  // The outputs are only read where they were already written.
+  return opOperand->get() == input();
+}
+
+// Generates the selection of the element at `ivs`, at `position` along
+// `dimension`. The first `k` elements are always inserted, and the others only
+// if they are better than the worst of the ones selected so far:
+//     if position < k or comparator(input[position], values[k - 1]):
+//       value, index = input[position], position
+//       for i in [0, min(position + 1, k)):
+//         if i == position or comparator(value, values[i]):
+//           swap((value, index), (values[i], indices[i]))
+// An element is never swapped with an equal one, which was found first.
+LogicalResult TopkOp::generateScalarImplementation(OpBuilder &b, Location loc,
+                                                   ValueRange ivs) {
+  uint64_t kDim = dimension();
+  Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  Value k = getDimValue(b, loc, outputValues(), kDim);
+  Value position = ivs[kDim];
+  Block &comparator = region().front();
+  auto getIndices = [&](Value i) {
+    SmallVector<Value> indices(ivs.begin(), ivs.end());
+    indices[kDim] = i;
+    return indices;
+  };
+
+  Value isEmpty =
+      b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq, k, zero);
+  b.create<scf::IfOp>(
+      loc, TypeRange{}, isEmpty, [&](OpBuilder &b, Location loc) {
+        b.create<scf::YieldOp>(loc);
+      },
+      [&](OpBuilder &b, Location loc) {
+        Value value = b.create<memref::LoadOp>(loc, input(), ivs);
+        Value index = b.create<arith::IndexCastOp>(
+            loc, outputIndices().getType().cast<ShapedType>().getElementType(),
+            position);
+        Value isFirstK = b.create<arith::CmpIOp>(
+            loc, arith::CmpIPredicate::ult, position, k);
+        auto shouldInsert = b.create<scf::IfOp>(
+            loc, TypeRange{b.getI1Type()}, isFirstK,
+            [&](OpBuilder &b, Location loc) {
+              Value trueValue = b.create<arith::ConstantIntOp>(loc, 1, 1);
+              b.create<scf::YieldOp>(loc, trueValue);
+            },
+            [&](OpBuilder &b, Location loc) {
+              Value last = b.create<memref::LoadOp>(
+                  loc, outputValues(),
+                  getIndices(b.create<arith::SubIOp>(loc, k, one)));
+              b.create<scf::YieldOp>(
+                  loc, cloneComparator(b, comparator, {value, last}));
+            });
+        b.create<scf::IfOp>(
+            loc, TypeRange{}, shouldInsert.getResult(0),
+            [&](OpBuilder &b, Location loc) {
+              Value ub = b.create<arith::MinUIOp>(
+                  loc, b.create<arith::AddIOp>(loc, position, one), k);
+              b.create<scf::ForOp>(
+                  loc, zero, ub, one, ValueRange{value, index},
+                  [&](OpBuilder &b, Location loc, Value i, ValueRange args) {
+                    SmallVector<Value> indices = getIndices(i);
+                    Value selectedValue =
+                        b.create<memref::LoadOp>(loc, outputValues(), indices);
+                    Value selectedIndex = b.create<memref::LoadOp>(
+                        loc, outputIndices(), indices);
+                    // The element at `position` hasn't been written yet.
+                    Value isUnset = b.create<arith::CmpIOp>(
+                        loc, arith::CmpIPredicate::eq, i, position);
+                    Value isBetter = b.create<arith::OrIOp>(
+                        loc, isUnset,
+                        cloneComparator(b, comparator,
+                                        {args[0], selectedValue}));
+                    auto select = [&](Value trueValue, Value falseValue) {
+                      return b.create<arith::SelectOp>(loc, isBetter,
+                                                       trueValue, falseValue);
+                    };
+                    b.create<memref::StoreOp>(loc,
+                                              select(args[0], selectedValue),
+                                              outputValues(), indices);
+                    b.create<memref::StoreOp>(loc,
+                                              select(args[1], selectedIndex),
+                                              outputIndices(), indices);
+                    Value carriedValue = select(selectedValue, args[0]);
+                    Value carriedIndex = select(selectedIndex, args[1]);
+                    b.create<scf::YieldOp>(
+                        loc, ValueRange{carriedValue, carriedIndex});
+                  });
+              b.create<scf::YieldOp>(loc);
+            });
+        b.create<scf::YieldOp>(loc);
+      });
+  return success();
+}
+
 #define DEFINE_OP_GET_EFFECTS(OP_NAME)                                         \
   void OP_NAME::getEffects(                                                    \
       SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>      \
@@ -488,6 +1276,9 @@ LogicalResult ScatterOp::generateScalarImplementation(OpBuilder &b,
 
 DEFINE_OP_GET_EFFECTS(ScanOp)
 DEFINE_OP_GET_EFFECTS(ScatterOp)
+DEFINE_OP_GET_EFFECTS(AttentionOp)
+DEFINE_OP_GET_EFFECTS(SortOp)
+DEFINE_OP_GET_EFFECTS(TopkOp)
 
 namespace {
 /// This is derived from mlir/lib/Dialect/Linalg/IR/LinalgOps.cpp without any
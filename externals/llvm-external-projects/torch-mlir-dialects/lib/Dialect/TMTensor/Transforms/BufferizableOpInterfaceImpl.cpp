@@ -0,0 +1,125 @@
+//===------------------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir-dialects/Dialect/TMTensor/Transforms/BufferizableOpInterfaceImpl.h"
+
+#include "mlir/Dialect/Bufferization/IR/BufferizableOpInterface.h"
+#include "mlir/Dialect/Bufferization/IR/Bufferization.h"
+#include "mlir/IR/Dialect.h"
+#include "mlir/IR/Operation.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorDialect.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorOps.h"
+
+using namespace mlir;
+using namespace mlir::bufferization;
+using namespace mlir::torch::TMTensor;
+
+/// Bufferizes `op` by cloning it on the buffers of its operands. The outputs
+/// are updated in place, so the result buffers are the output buffers, and
+/// One-Shot Bufferize decides whether they need to be copies.
+static LogicalResult bufferizeTMTensorOp(RewriterBase &rewriter, TMTensorOp op,
+                                         const BufferizationOptions &options) {
+  OpBuilder::InsertionGuard g(rewriter);
+  rewriter.setInsertionPoint(op);
+
+  // Nothing to do. This op is already bufferized.
+  if (op.hasBufferSemantics())
+    return success();
+  if (!op.hasTensorSemantics())
+    return op->emitError() << "op does not have tensor semantics";
+
+  SmallVector<Value> newOperands;
+  for (OpOperand *opOperand : op.getInputOperands()) {
+    if (op.isScalar(opOperand)) {
+      newOperands.push_back(opOperand->get());
+      continue;
+    }
+    FailureOr<Value> buffer = getBuffer(rewriter, opOperand->get(), options);
+    if (failed(buffer))
+      return failure();
+    newOperands.push_back(*buffer);
+  }
+  SmallVector<Value> newOutputBuffers;
+  for (OpOperand *opOperand : op.getOutputOperands()) {
+    FailureOr<Value> buffer = getBuffer(rewriter, opOperand->get(), options);
+    if (failed(buffer))
+      return failure();
+    newOutputBuffers.push_back(*buffer);
+  }
+  newOperands.append(newOutputBuffers.begin(), newOutputBuffers.end());
+
+  // Set the insertion point again, after the copies and allocations that may
+  // have been created for the buffers.
+  rewriter.setInsertionPoint(op);
+  op.clone(rewriter, op.getLoc(), /*resultTypes=*/TypeRange{}, newOperands);
+  replaceOpWithBufferizedValues(rewriter, op, newOutputBuffers);
+  return success();
+}
+
+namespace {
+/// The `BufferizableOpInterface` of the TMTensor ops, which, like destination
+/// style Linalg ops, compute their results in their outputs.
+template <typename OpTy>
+struct TMTensorOpInterface
+    : public BufferizableOpInterface::ExternalModel<TMTensorOpInterface<OpTy>,
+                                                    OpTy> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    auto tmtensorOp = cast<TMTensorOp>(op);
+    // The inputs are always read, the outputs only when the payload uses them.
+    if (!tmtensorOp.isOutputTensor(&opOperand))
+      return true;
+    return tmtensorOp.payloadUsesValueFromOperand(&opOperand);
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return cast<TMTensorOp>(op).isOutputTensor(&opOperand);
+  }
+
+  SmallVector<OpOperand *>
+  getAliasingOpOperand(Operation *op, OpResult opResult,
+                       const AnalysisState &state) const {
+    auto tmtensorOp = cast<TMTensorOp>(op);
+    return {tmtensorOp.getOutputOperand(opResult.getResultNumber())};
+  }
+
+  SmallVector<OpResult> getAliasingOpResult(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    auto tmtensorOp = cast<TMTensorOp>(op);
+    if (!tmtensorOp.isOutputTensor(&opOperand))
+      return {};
+    return {op->getResult(opOperand.getOperandNumber() -
+                          tmtensorOp.getNumInputs())};
+  }
+
+  BufferRelation bufferRelation(Operation *op, OpResult opResult,
+                                const AnalysisState &state) const {
+    return BufferRelation::Equivalent;
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    return bufferizeTMTensorOp(rewriter, cast<TMTensorOp>(op), options);
+  }
+};
+} // namespace
+
+/// Attaches the interface to each of `OpTys`.
+template <typename... OpTys>
+static void attachInterface(MLIRContext *context) {
+  (OpTys::template attachInterface<TMTensorOpInterface<OpTys>>(*context), ...);
+}
+
+void mlir::torch::TMTensor::registerBufferizableOpInterfaceExternalModels(
+    DialectRegistry &registry) {
+  registry.addExtension(+[](MLIRContext *context, TMTensorDialect *dialect) {
+    attachInterface<ScanOp, ScatterOp, AttentionOp, SortOp, TopkOp>(context);
+  });
+}
@@ -13,6 +13,7 @@
 #include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
@@ -87,6 +88,463 @@ struct ScalarLoopOpInterfaceLowerToLoopsPattern : public RewritePattern {
 };
 } // namespace
 
+/// Lowers a `tm_tensor.scan` to a parallel block scan, instead of the
+/// sequential loop of its `ScalarLoopOpInterface`. The scanned dimension is
+/// split into blocks of `blockSize` elements, and then:
+///   1. each block is scanned on its own, all blocks in parallel,
+///   2. the last element of each block is combined, in order, with the last
+///      element of the block before it, which makes both of them final,
+///   3. the other elements of each block are combined, all in parallel, with
+///      the last element of the block before it.
+/// Only step 2 is sequential, and it only takes one step per block.
+namespace {
+struct ScanOpLowerToParallelLoopsPattern : public OpRewritePattern<ScanOp> {
+  ScanOpLowerToParallelLoopsPattern(MLIRContext *context, int64_t blockSize)
+      : OpRewritePattern<ScanOp>(context, /*benefit=*/2),
+        blockSize(blockSize) {}
+
+  LogicalResult matchAndRewrite(ScanOp scanOp,
+                                PatternRewriter &rewriter) const override {
+    if (!scanOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(
+          scanOp, "lower to loops needs to have buffer semantics");
+    }
+    Location loc = scanOp.getLoc();
+    int64_t rank = scanOp.getOperandRank();
+    uint64_t scanDim = scanOp.dimension();
+    bool isInclusive = scanOp.inclusive();
+    Value input = scanOp.input();
+    Value output = scanOp.output();
+    Value accumulator = scanOp.accumulator();
+    Type elementType = scanOp.getOperandType().getElementType();
+
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value blockSizeValue =
+        rewriter.create<arith::ConstantIndexOp>(loc, blockSize);
+    SmallVector<Value> sizes;
+    for (int64_t i = 0; i < rank; i++)
+      sizes.push_back(rewriter.createOrFold<memref::DimOp>(loc, input, i));
+    Value size = sizes[scanDim];
+    Value numBlocks = rewriter.create<arith::DivUIOp>(
+        loc,
+        rewriter.create<arith::AddIOp>(
+            loc, size,
+            rewriter.create<arith::ConstantIndexOp>(loc, blockSize - 1)),
+        blockSizeValue);
+
+    auto withScanIndex = [&](ValueRange ivs, Value index) {
+      SmallVector<Value> indices(ivs.begin(), ivs.end());
+      indices[scanDim] = index;
+      return indices;
+    };
+    auto accumulatorIndices = [&](ValueRange ivs) {
+      SmallVector<Value> indices;
+      for (size_t i = 0; i < ivs.size(); i++) {
+        if (i != scanDim)
+          indices.push_back(ivs[i]);
+      }
+      return indices;
+    };
+    auto combine = [&](OpBuilder &b, Value lhs, Value rhs) -> Value {
+      Block &srcBlock = scanOp.region().front();
+      BlockAndValueMapping bvm;
+      bvm.map(srcBlock.getArgument(0), lhs);
+      bvm.map(srcBlock.getArgument(1), rhs);
+      for (auto &blockOp : srcBlock.without_terminator())
+        b.clone(blockOp, bvm);
+      return bvm.lookupOrDefault(srcBlock.getTerminator()->getOperand(0));
+    };
+    // Element `index` of the scanned sequence, which is the input shifted by
+    // one after the accumulator for an exclusive scan.
+    auto loadScanned = [&](OpBuilder &b, Location loc, ValueRange ivs,
+                           Value index) -> Value {
+      if (isInclusive)
+        return b.create<memref::LoadOp>(loc, input, withScanIndex(ivs, index));
+      Value isFirst = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                              index, zero);
+      auto ifOp = b.create<scf::IfOp>(
+          loc, TypeRange{elementType}, isFirst,
+          [&](OpBuilder &b, Location loc) {
+            Value value = b.create<memref::LoadOp>(loc, accumulator,
+                                                   accumulatorIndices(ivs));
+            b.create<scf::YieldOp>(loc, value);
+          },
+          [&](OpBuilder &b, Location loc) {
+            Value previous = b.create<arith::SubIOp>(loc, index, one);
+            Value value = b.create<memref::LoadOp>(
+                loc, input, withScanIndex(ivs, previous));
+            b.create<scf::YieldOp>(loc, value);
+          });
+      return ifOp.getResult(0);
+    };
+    // The start and end of block `block`.
+    auto getBlockBounds = [&](OpBuilder &b, Location loc, Value block) {
+      Value start = b.create<arith::MulIOp>(loc, block, blockSizeValue);
+      Value end = b.create<arith::MinUIOp>(
+          loc, b.create<arith::AddIOp>(loc, start, blockSizeValue), size);
+      return std::make_pair(start, end);
+    };
+
+    // Loops over all the dims but the scanned one, along which they loop
+    // over the blocks.
+    SmallVector<Value> lbs(rank, zero), ubs(sizes), steps(rank, one);
+    ubs[scanDim] = numBlocks;
+
+    // Step 1.
+    rewriter.create<scf::ParallelOp>(
+        loc, lbs, ubs, steps, [&](OpBuilder &b, Location loc, ValueRange ivs) {
+          Value start, end;
+          std::tie(start, end) = getBlockBounds(b, loc, ivs[scanDim]);
+          b.create<memref::StoreOp>(loc, loadScanned(b, loc, ivs, start),
+                                    output, withScanIndex(ivs, start));
+          b.create<scf::ForOp>(
+              loc, b.create<arith::AddIOp>(loc, start, one), end, one,
+              ValueRange{},
+              [&](OpBuilder &b, Location loc, Value iv, ValueRange args) {
+                Value previous = b.create<memref::LoadOp>(
+                    loc, output,
+                    withScanIndex(ivs, b.create<arith::SubIOp>(loc, iv, one)));
+                Value value =
+                    combine(b, previous, loadScanned(b, loc, ivs, iv));
+                b.create<memref::StoreOp>(loc, value, output,
+                                          withScanIndex(ivs, iv));
+                b.create<scf::YieldOp>(loc);
+              });
+        });
+
+    // Step 2, which also sets the accumulator to the last element, like the
+    // sequential lowering does.
+    SmallVector<Value> carryUbs(sizes);
+    carryUbs[scanDim] = one;
+    rewriter.create<scf::ParallelOp>(
+        loc, lbs, carryUbs, steps,
+        [&](OpBuilder &b, Location loc, ValueRange ivs) {
+          b.create<scf::ForOp>(
+              loc, one, numBlocks, one, ValueRange{},
+              [&](OpBuilder &b, Location loc, Value block, ValueRange args) {
+                Value start, end;
+                std::tie(start, end) = getBlockBounds(b, loc, block);
+                SmallVector<Value> carryIndices = withScanIndex(
+                    ivs, b.create<arith::SubIOp>(loc, start, one));
+                SmallVector<Value> lastIndices =
+                    withScanIndex(ivs, b.create<arith::SubIOp>(loc, end, one));
+                Value value = combine(
+                    b, b.create<memref::LoadOp>(loc, output, carryIndices),
+                    b.create<memref::LoadOp>(loc, output, lastIndices));
+                b.create<memref::StoreOp>(loc, value, output, lastIndices);
+                b.create<scf::YieldOp>(loc);
+              });
+          Value hasMany = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::ugt, size, one);
+          b.create<scf::IfOp>(
+              loc, TypeRange{}, hasMany, [&](OpBuilder &b, Location loc) {
+                Value lastIndex = b.create<arith::SubIOp>(loc, size, one);
+                Value last = b.create<memref::LoadOp>(
+                    loc, output, withScanIndex(ivs, lastIndex));
+                b.create<memref::StoreOp>(loc, last, accumulator,
+                                          accumulatorIndices(ivs));
+                b.create<scf::YieldOp>(loc);
+              });
+        });
+
+    // Step 3.
+    SmallVector<Value> propagateLbs(lbs);
+    propagateLbs[scanDim] = one;
+    rewriter.create<scf::ParallelOp>(
+        loc, propagateLbs, ubs, steps,
+        [&](OpBuilder &b, Location loc, ValueRange ivs) {
+          Value start, end;
+          std::tie(start, end) = getBlockBounds(b, loc, ivs[scanDim]);
+          Value carry = b.create<memref::LoadOp>(
+              loc, output,
+              withScanIndex(ivs, b.create<arith::SubIOp>(loc, start, one)));
+          b.create<scf::ParallelOp>(
+              loc, ValueRange{start},
+              ValueRange{b.create<arith::SubIOp>(loc, end, one)},
+              ValueRange{one},
+              [&](OpBuilder &b, Location loc, ValueRange innerIvs) {
+                SmallVector<Value> indices = withScanIndex(ivs, innerIvs[0]);
+                Value value = combine(
+                    b, carry, b.create<memref::LoadOp>(loc, output, indices));
+                b.create<memref::StoreOp>(loc, value, output, indices);
+              });
+        });
+
+    rewriter.eraseOp(scanOp);
+    return success();
+  }
+
+private:
+  int64_t blockSize;
+};
+} // namespace
+
+/// Returns the kind of `memref.atomic_rmw` computing the combiner of
+/// `scatterOp`, if it is a single commutative op of its two arguments.
+static Optional<arith::AtomicRMWKind> getAtomicRMWKind(ScatterOp scatterOp) {
+  Block &block = scatterOp.region().front();
+  if (!llvm::hasSingleElement(block.without_terminator()))
+    return llvm::None;
+  Operation &combiner = block.front();
+  if (combiner.getNumOperands() != 2 || combiner.getNumResults() != 1 ||
+      block.getTerminator()->getOperand(0) != combiner.getResult(0))
+    return llvm::None;
+  Value lhs = combiner.getOperand(0);
+  Value rhs = combiner.getOperand(1);
+  Value update = block.getArgument(0);
+  Value current = block.getArgument(1);
+  if (!((lhs == update && rhs == current) || (lhs == current && rhs == update)))
+    return llvm::None;
+  if (isa<arith::AddFOp>(combiner))
+    return arith::AtomicRMWKind::addf;
+  if (isa<arith::AddIOp>(combiner))
+    return arith::AtomicRMWKind::addi;
+  if (isa<arith::MulFOp>(combiner))
+    return arith::AtomicRMWKind::mulf;
+  if (isa<arith::MulIOp>(combiner))
+    return arith::AtomicRMWKind::muli;
+  if (isa<arith::MaxFOp>(combiner))
+    return arith::AtomicRMWKind::maxf;
+  if (isa<arith::MaxSIOp>(combiner))
+    return arith::AtomicRMWKind::maxs;
+  if (isa<arith::MaxUIOp>(combiner))
+    return arith::AtomicRMWKind::maxu;
+  if (isa<arith::MinFOp>(combiner))
+    return arith::AtomicRMWKind::minf;
+  if (isa<arith::MinSIOp>(combiner))
+    return arith::AtomicRMWKind::mins;
+  if (isa<arith::MinUIOp>(combiner))
+    return arith::AtomicRMWKind::minu;
+  return llvm::None;
+}
+
+/// Lowers a `tm_tensor.scatter` to parallel loops, instead of the sequential
+/// loops of its `ScalarLoopOpInterface`:
+///   - with unique indices, all the updates are independent, and are applied
+///     in parallel,
+///   - otherwise, if the combiner maps to a `memref.atomic_rmw`, the updates
+///     are applied in parallel with atomic read-modify-writes,
+///   - otherwise, the updates are applied in order and only the elements of
+///     each update slice are updated in parallel.
+namespace {
+struct ScatterOpLowerToParallelLoopsPattern
+    : public OpRewritePattern<ScatterOp> {
+  ScatterOpLowerToParallelLoopsPattern(MLIRContext *context)
+      : OpRewritePattern<ScatterOp>(context, /*benefit=*/2) {}
+
+  LogicalResult matchAndRewrite(ScatterOp scatterOp,
+                                PatternRewriter &rewriter) const override {
+    if (!scatterOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(
+          scatterOp, "lower to loops needs to have buffer semantics");
+    }
+    Optional<arith::AtomicRMWKind> atomicKind;
+    if (!scatterOp.unique_indices())
+      atomicKind = getAtomicRMWKind(scatterOp);
+    bool isSequential = !scatterOp.unique_indices() && !atomicKind;
+    if (isSequential && scatterOp.isScalarUpdate()) {
+      return rewriter.notifyMatchFailure(
+          scatterOp, "expected unique indices, an atomic combiner or slices");
+    }
+
+    Location loc = scatterOp.getLoc();
+    SmallVector<Range> loopRanges = scatterOp.getIterationDomain(rewriter);
+    auto buildBody = [&](OpBuilder &b, Location loc, ValueRange ivs) {
+      if (!atomicKind) {
+        (void)scatterOp.generateScalarImplementation(b, loc, ivs);
+        return;
+      }
+      Value update = b.create<memref::LoadOp>(loc, scatterOp.updates(), ivs);
+      b.create<memref::AtomicRMWOp>(
+          loc, update.getType(), *atomicKind, update, scatterOp.original(),
+          scatterOp.getOriginalIndices(b, loc, ivs));
+    };
+    auto buildParallelLoops = [&](OpBuilder &b, Location loc,
+                                  ArrayRef<Range> ranges,
+                                  SmallVector<Value> outerIvs) {
+      SmallVector<Value> lbs, ubs, steps;
+      for (const Range &range : ranges) {
+        lbs.push_back(range.offset);
+        ubs.push_back(range.size);
+        steps.push_back(range.stride);
+      }
+      b.create<scf::ParallelOp>(
+          loc, lbs, ubs, steps,
+          [&](OpBuilder &b, Location loc, ValueRange innerIvs) {
+            outerIvs.append(innerIvs.begin(), innerIvs.end());
+            buildBody(b, loc, outerIvs);
+          });
+    };
+
+    if (isSequential) {
+      // Updates to the same slice must be applied in order, but the elements
+      // of a slice are all distinct.
+      rewriter.create<scf::ForOp>(
+          loc, loopRanges[0].offset, loopRanges[0].size, loopRanges[0].stride,
+          ValueRange{},
+          [&](OpBuilder &b, Location loc, Value iv, ValueRange args) {
+            buildParallelLoops(b, loc, makeArrayRef(loopRanges).drop_front(),
+                               {iv});
+            b.create<scf::YieldOp>(loc);
+          });
+    } else {
+      buildParallelLoops(rewriter, loc, loopRanges, {});
+    }
+    rewriter.eraseOp(scatterOp);
+    return success();
+  }
+};
+} // namespace
+
+/// Clones the combiner of `scatterOp` to combine `update` into `current`, and
+/// returns the combined value.
+static Value cloneScatterCombiner(OpBuilder &b, ScatterOp scatterOp,
+                                  Value update, Value current) {
+  BlockAndValueMapping bvm;
+  Block &block = scatterOp.region().front();
+  bvm.map(block.getArgument(0), update);
+  bvm.map(block.getArgument(1), current);
+  for (Operation &blockOp : block.without_terminator())
+    b.clone(blockOp, bvm);
+  return bvm.lookupOrDefault(block.getTerminator()->getOperand(0));
+}
+
+/// Lowers a `tm_tensor.scatter` whose indices may repeat, such as a histogram,
+/// to parallel loops without atomics, by privatizing `original`:
+///   - `numCopies` private copies of `original` are filled with the identity
+///     of the combiner,
+///   - the updates are split in `numCopies` contiguous chunks, and each chunk
+///     is scattered sequentially into its own copy, in parallel with the
+///     other chunks,
+///   - the copies are then combined into `original`, in parallel over its
+///     elements.
+/// This needs a combiner that is associative and commutative and has an
+/// identity, so it is only applied to the combiners `memref.atomic_rmw`
+/// supports. It trades `numCopies` times the size of `original` of scratch
+/// memory for having no contention between the threads.
+namespace {
+struct ScatterOpLowerToPrivatizedLoopsPattern
+    : public OpRewritePattern<ScatterOp> {
+  ScatterOpLowerToPrivatizedLoopsPattern(MLIRContext *context,
+                                         int64_t numCopies)
+      : OpRewritePattern<ScatterOp>(context, /*benefit=*/3),
+        numCopies(numCopies) {}
+
+  LogicalResult matchAndRewrite(ScatterOp scatterOp,
+                                PatternRewriter &rewriter) const override {
+    if (!scatterOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(
+          scatterOp, "lower to loops needs to have buffer semantics");
+    }
+    if (scatterOp.unique_indices()) {
+      return rewriter.notifyMatchFailure(
+          scatterOp, "unique indices don't need privatization");
+    }
+    Optional<arith::AtomicRMWKind> kind = getAtomicRMWKind(scatterOp);
+    if (!kind) {
+      return rewriter.notifyMatchFailure(
+          scatterOp, "expected an associative and commutative combiner");
+    }
+
+    Location loc = scatterOp.getLoc();
+    Value original = scatterOp.original();
+    auto originalType = original.getType().cast<MemRefType>();
+    Type elementType = originalType.getElementType();
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value copies = rewriter.create<arith::ConstantIndexOp>(loc, numCopies);
+
+    SmallVector<Value> originalSizes;
+    SmallVector<Value> privateDynamicSizes;
+    SmallVector<int64_t> privateShape{numCopies};
+    for (int64_t dim = 0, e = originalType.getRank(); dim < e; ++dim) {
+      Value size = rewriter.create<memref::DimOp>(loc, original, dim);
+      originalSizes.push_back(size);
+      privateShape.push_back(originalType.getDimSize(dim));
+      if (originalType.isDynamicDim(dim))
+        privateDynamicSizes.push_back(size);
+    }
+    Value privateCopies = rewriter.create<memref::AllocOp>(
+        loc, MemRefType::get(privateShape, elementType), privateDynamicSizes);
+
+    SmallVector<Value> privateLbs(privateShape.size(), zero);
+    SmallVector<Value> privateUbs{copies};
+    privateUbs.append(originalSizes);
+    SmallVector<Value> privateSteps(privateShape.size(), one);
+    Value identity =
+        arith::getIdentityValue(*kind, elementType, rewriter, loc);
+    rewriter.create<scf::ParallelOp>(
+        loc, privateLbs, privateUbs, privateSteps,
+        [&](OpBuilder &b, Location loc, ValueRange ivs) {
+          b.create<memref::StoreOp>(loc, identity, privateCopies, ivs);
+        });
+
+    SmallVector<Range> loopRanges = scatterOp.getIterationDomain(rewriter);
+    Value numUpdates = loopRanges[0].size;
+    Value chunkSize = rewriter.create<arith::CeilDivUIOp>(
+        loc, numUpdates, copies);
+    rewriter.create<scf::ParallelOp>(
+        loc, zero, copies, one,
+        [&](OpBuilder &b, Location loc, ValueRange copyIvs) {
+          Value copy = copyIvs.front();
+          Value chunkBegin = b.create<arith::MulIOp>(loc, copy, chunkSize);
+          Value chunkEnd = b.create<arith::MinUIOp>(
+              loc, b.create<arith::AddIOp>(loc, chunkBegin, chunkSize),
+              numUpdates);
+          SmallVector<Value> lbs{chunkBegin}, ubs{chunkEnd}, steps;
+          for (const Range &range : makeArrayRef(loopRanges).drop_front()) {
+            lbs.push_back(range.offset);
+            ubs.push_back(range.size);
+          }
+          for (const Range &range : loopRanges)
+            steps.push_back(range.stride);
+          scf::buildLoopNest(
+              b, loc, lbs, ubs, steps,
+              [&](OpBuilder &b, Location loc, ValueRange ivs) {
+                Value update =
+                    b.create<memref::LoadOp>(loc, scatterOp.updates(), ivs);
+                SmallVector<Value> privateIndices{copy};
+                llvm::append_range(privateIndices,
+                                   scatterOp.getOriginalIndices(b, loc, ivs));
+                Value current = b.create<memref::LoadOp>(loc, privateCopies,
+                                                         privateIndices);
+                Value combined =
+                    cloneScatterCombiner(b, scatterOp, update, current);
+                b.create<memref::StoreOp>(loc, combined, privateCopies,
+                                          privateIndices);
+              });
+        });
+
+    SmallVector<Value> lbs(originalSizes.size(), zero);
+    SmallVector<Value> steps(originalSizes.size(), one);
+    rewriter.create<scf::ParallelOp>(
+        loc, lbs, originalSizes, steps,
+        [&](OpBuilder &b, Location loc, ValueRange ivs) {
+          Value init = b.create<memref::LoadOp>(loc, original, ivs);
+          auto forOp = b.create<scf::ForOp>(
+              loc, zero, copies, one, ValueRange{init},
+              [&](OpBuilder &b, Location loc, Value copy, ValueRange args) {
+                SmallVector<Value> privateIndices{copy};
+                privateIndices.append(ivs.begin(), ivs.end());
+                Value partial = b.create<memref::LoadOp>(loc, privateCopies,
+                                                         privateIndices);
+                b.create<scf::YieldOp>(
+                    loc, cloneScatterCombiner(b, scatterOp, partial,
+                                              args.front()));
+              });
+          b.create<memref::StoreOp>(loc, forOp.getResult(0), original, ivs);
+        });
+    rewriter.create<memref::DeallocOp>(loc, privateCopies);
+    rewriter.eraseOp(scatterOp);
+    return success();
+  }
+
+private:
+  int64_t numCopies;
+};
+} // namespace
+
 //===----------------------------------------------------------------------===//
 // Pass
 //===----------------------------------------------------------------------===//
@@ -104,6 +562,16 @@ struct TMTensorToLoopsPass : public TMTensorToLoopsBase<TMTensorToLoopsPass> {
 
     RewritePatternSet patterns(context);
     patterns.insert<ScalarLoopOpInterfaceLowerToLoopsPattern>(context);
+    if (scanBlockSize > 0) {
+      patterns.insert<ScanOpLowerToParallelLoopsPattern>(context,
+                                                         scanBlockSize);
+    }
+    if (parallelScatter)
+      patterns.insert<ScatterOpLowerToParallelLoopsPattern>(context);
+    if (scatterPrivateCopies > 0) {
+      patterns.insert<ScatterOpLowerToPrivatizedLoopsPattern>(
+          context, scatterPrivateCopies);
+    }
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
@@ -0,0 +1,77 @@
+//===------------------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/TileUsingInterface.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/TilingInterface.h"
+#include "mlir/Pass/Pass.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorDialect.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorOps.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/Transforms/PassDetail.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/Transforms/Passes.h"
+#include "llvm/ADT/SmallVector.h"
+
+using namespace mlir;
+using namespace mlir::torch::TMTensor;
+
+namespace {
+/// A `PatternRewriter` for applying the tiling pattern to a given op, outside
+/// of a pattern driver.
+struct TilingRewriter : public PatternRewriter {
+  TilingRewriter(MLIRContext *context) : PatternRewriter(context) {}
+};
+
+struct TMTensorTilePass : public TMTensorTileBase<TMTensorTilePass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<mlir::arith::ArithmeticDialect, memref::MemRefDialect,
+                    scf::SCFDialect, tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    SmallVector<TilingInterface> ops;
+    getOperation().walk([&](TilingInterface op) {
+      if (isa<TMTensorOp>(op.getOperation()))
+        ops.push_back(op);
+    });
+
+    TilingRewriter rewriter(context);
+    for (TilingInterface op : ops) {
+      SmallVector<int64_t> opTileSizes(op.getLoopIteratorTypes().size(), 0);
+      for (unsigned i = 0; i < opTileSizes.size() && i < tileSizes.size(); i++)
+        opTileSizes[i] = tileSizes[i];
+      // A tile of the scanned dimension needs the accumulated value of the
+      // tiles before it.
+      if (auto scanOp = dyn_cast<ScanOp>(op.getOperation()))
+        opTileSizes[scanOp.dimension()] = 0;
+      if (llvm::all_of(opTileSizes, [](int64_t size) { return size == 0; }))
+        continue;
+
+      scf::SCFTilingOptions options;
+      options.setTileSizes(opTileSizes);
+      scf::TileUsingSCFForOp pattern(context, options);
+      rewriter.setInsertionPoint(op);
+      if (failed(pattern.returningMatchAndRewrite(op, rewriter))) {
+        op.emitError("failed to tile");
+        return signalPassFailure();
+      }
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+torch::TMTensor::createTMTensorTilePass() {
+  return std::make_unique<TMTensorTilePass>();
+}
@@ -365,3 +365,157 @@ func.func @scatter_partial_slices(%arg0: memref<2x64x12xf32>, %arg1: memref<2x3x
 // CHECK-NEXT:           %[[ADD2:.+]] = arith.addi %[[CAST2]], %[[ARG5]] : index
 // CHECK-NEXT:           %[[LOAD3:.+]] = memref.load %[[ARG0]][%[[CAST0]], %[[ADD1]], %[[ADD2]]] : memref<2x64x12xf32>
 // CHECK-NEXT:           memref.store %[[LOAD3]], %[[ARG0]][%[[CAST0]], %[[ADD1]], %[[ADD2]]] : memref<2x64x12xf32>
+
+// -----
+
+func.func @attention(%arg0: memref<2x4x8xf32>, %arg1: memref<2x6x8xf32>,
+                     %arg2: memref<2x6x3xf32>, %arg3: memref<2x4x3xf32>) {
+  tm_tensor.attention scale(1.250000e-01)
+    ins(%arg0, %arg1, %arg2 : memref<2x4x8xf32>, memref<2x6x8xf32>, memref<2x6x3xf32>)
+    outs(%arg3 : memref<2x4x3xf32>)
+  return
+}
+// CHECK-LABEL: func.func @attention
+// CHECK-SAME:    %[[Q:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[K:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[V:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[OUT:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C2:.+]] = arith.constant 2 : index
+// CHECK-DAG:     %[[C4:.+]] = arith.constant 4 : index
+// CHECK-DAG:     %[[C6:.+]] = arith.constant 6 : index
+// CHECK-DAG:     %[[NEG_INF:.+]] = arith.constant 0xFF800000 : f32
+// CHECK:         scf.for %[[B:.+]] = %[[C0]] to %[[C2]] step %[[C1]] {
+// CHECK:           scf.for %[[M:.+]] = %[[C0]] to %[[C4]] step %[[C1]] {
+// CHECK:             scf.for
+// CHECK:               memref.store %{{.*}}, %[[OUT]][%[[B]], %[[M]], %{{.*}}]
+// CHECK:             %[[ROW:.+]]:2 = scf.for %[[N:.+]] = %[[C0]] to %[[C6]] step %[[C1]] iter_args(%[[MAX:.+]] = %[[NEG_INF]], %[[SUM:.+]] = %{{.*}}) -> (f32, f32) {
+// CHECK:               %[[DOT:.+]] = scf.for
+// CHECK:                 memref.load %[[Q]][%[[B]], %[[M]], %{{.*}}]
+// CHECK:                 memref.load %[[K]][%[[B]], %[[N]], %{{.*}}]
+// CHECK:               %[[SCORE:.+]] = arith.mulf %[[DOT]], %{{.*}} : f32
+// CHECK:               %[[NEW_MAX:.+]] = arith.maxf %[[MAX]], %[[SCORE]] : f32
+// CHECK:               math.exp
+// CHECK:               math.exp
+// CHECK:               scf.for
+// CHECK:                 memref.load %[[V]][%[[B]], %[[N]], %{{.*}}]
+// CHECK:                 memref.store %{{.*}}, %[[OUT]][%[[B]], %[[M]], %{{.*}}]
+// CHECK:               scf.yield %[[NEW_MAX]], %{{.*}} : f32, f32
+// CHECK:             scf.for
+// CHECK:               arith.divf %{{.*}}, %[[ROW]]#1 : f32
+
+// -----
+
+func.func @sort_1d(%arg0: memref<128xf32>, %arg1: memref<128xi64>) {
+  tm_tensor.sort dimension(0)
+    outs(%arg0, %arg1 : memref<128xf32>, memref<128xi64>) {
+  ^bb0(%lhs: f32, %rhs: f32, %lhs_index: i64, %rhs_index: i64):
+    %0 = arith.cmpf olt, %lhs, %rhs : f32
+    tm_tensor.yield %0 : i1
+  }
+  return
+}
+// CHECK-LABEL: func.func @sort_1d
+// CHECK-SAME:    %[[VALUES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C2:.+]] = arith.constant 2 : index
+// CHECK-DAG:     %[[C128:.+]] = arith.constant 128 : index
+// CHECK:         scf.for %{{.+}} = %[[C0]] to %[[C1]] step %[[C1]] {
+// CHECK:           %[[VALUES_SCRATCH:.+]] = memref.alloc(%[[C128]]) : memref<?xf32>
+// CHECK:           %[[INDICES_SCRATCH:.+]] = memref.alloc(%[[C128]]) : memref<?xi64>
+// CHECK:           scf.while (%[[WIDTH_ARG:.+]] = %[[C1]]) : (index) -> index {
+// CHECK:             %[[IS_UNSORTED:.+]] = arith.cmpi ult, %[[WIDTH_ARG]], %[[C128]] : index
+// CHECK:             scf.condition(%[[IS_UNSORTED]]) %[[WIDTH_ARG]] : index
+// CHECK:           } do {
+// CHECK:           ^bb0(%[[WIDTH:.+]]: index):
+// CHECK:             %[[DOUBLE_WIDTH:.+]] = arith.muli %[[WIDTH]], %[[C2]] : index
+// CHECK:             scf.for %[[LO:.+]] = %[[C0]] to %[[C128]] step %[[DOUBLE_WIDTH]] {
+// CHECK:               %[[MID:.+]] = arith.minui
+// CHECK:               %[[HI:.+]] = arith.minui
+// CHECK:               %[[LEFT_LAST:.+]] = arith.subi %[[MID]], %[[C1]] : index
+// CHECK:               %[[RIGHT_LAST:.+]] = arith.subi %[[HI]], %[[C1]] : index
+// CHECK:               scf.for %[[K:.+]] = %[[LO]] to %[[HI]] step %[[C1]] iter_args(%[[I:.+]] = %[[LO]], %[[J:.+]] = %[[MID]]) -> (index, index) {
+// CHECK:                 %[[LEFT:.+]] = arith.minui %[[I]], %[[LEFT_LAST]] : index
+// CHECK:                 %[[RIGHT:.+]] = arith.minui %[[J]], %[[RIGHT_LAST]] : index
+// CHECK:                 %[[LV:.+]] = memref.load %[[VALUES]][%[[LEFT]]]
+// CHECK:                 %[[RV:.+]] = memref.load %[[VALUES]][%[[RIGHT]]]
+// CHECK:                 %[[LI:.+]] = memref.load %[[INDICES]][%[[LEFT]]]
+// CHECK:                 %[[RI:.+]] = memref.load %[[INDICES]][%[[RIGHT]]]
+// CHECK:                 %[[IS_RIGHT_BEFORE:.+]] = arith.cmpf olt, %[[RV]], %[[LV]] : f32
+// CHECK:                 %[[IS_LEFT_DONE:.+]] = arith.cmpi uge, %[[I]], %[[MID]] : index
+// CHECK:                 %[[HAS_RIGHT:.+]] = arith.cmpi ult, %[[J]], %[[HI]] : index
+// CHECK:                 %[[EITHER:.+]] = arith.ori %[[IS_LEFT_DONE]], %[[IS_RIGHT_BEFORE]] : i1
+// CHECK:                 %[[TAKE_RIGHT:.+]] = arith.andi %[[HAS_RIGHT]], %[[EITHER]] : i1
+// CHECK:                 %[[V:.+]] = arith.select %[[TAKE_RIGHT]], %[[RV]], %[[LV]] : f32
+// CHECK:                 memref.store %[[V]], %[[VALUES_SCRATCH]][%[[K]]]
+// CHECK:                 %[[IDX:.+]] = arith.select %[[TAKE_RIGHT]], %[[RI]], %[[LI]] : i64
+// CHECK:                 memref.store %[[IDX]], %[[INDICES_SCRATCH]][%[[K]]]
+// CHECK:                 scf.yield
+// CHECK:               }
+// CHECK:             }
+// CHECK:             scf.for %[[K:.+]] = %[[C0]] to %[[C128]] step %[[C1]] {
+// CHECK:               %[[V:.+]] = memref.load %[[VALUES_SCRATCH]][%[[K]]]
+// CHECK:               memref.store %[[V]], %[[VALUES]][%[[K]]]
+// CHECK:               %[[IDX:.+]] = memref.load %[[INDICES_SCRATCH]][%[[K]]]
+// CHECK:               memref.store %[[IDX]], %[[INDICES]][%[[K]]]
+// CHECK:             }
+// CHECK:             scf.yield %[[DOUBLE_WIDTH]] : index
+// CHECK:           }
+// CHECK:           memref.dealloc %[[VALUES_SCRATCH]] : memref<?xf32>
+// CHECK:           memref.dealloc %[[INDICES_SCRATCH]] : memref<?xi64>
+
+// -----
+
+func.func @topk_2d(%arg0: memref<4x128xf32>, %arg1: memref<4x8xf32>,
+                   %arg2: memref<4x8xi64>) {
+  tm_tensor.topk dimension(1)
+    ins(%arg0 : memref<4x128xf32>)
+    outs(%arg1, %arg2 : memref<4x8xf32>, memref<4x8xi64>) {
+  ^bb0(%lhs: f32, %rhs: f32):
+    %0 = arith.cmpf ogt, %lhs, %rhs : f32
+    tm_tensor.yield %0 : i1
+  }
+  return
+}
+// CHECK-LABEL: func.func @topk_2d
+// CHECK-SAME:    %[[INPUT:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[VALUES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C4:.+]] = arith.constant 4 : index
+// CHECK-DAG:     %[[C7:.+]] = arith.constant 7 : index
+// CHECK-DAG:     %[[C8:.+]] = arith.constant 8 : index
+// CHECK-DAG:     %[[C128:.+]] = arith.constant 128 : index
+// CHECK:         scf.for %[[B:.+]] = %[[C0]] to %[[C4]] step %[[C1]] {
+// CHECK:           scf.for %[[N:.+]] = %[[C0]] to %[[C128]] step %[[C1]] {
+// CHECK:             scf.if
+// CHECK:             } else {
+// CHECK:               %[[VALUE:.+]] = memref.load %[[INPUT]][%[[B]], %[[N]]]
+// CHECK:               %[[INDEX:.+]] = arith.index_cast %[[N]] : index to i64
+// CHECK:               %[[IS_FIRST_K:.+]] = arith.cmpi ult, %[[N]], %[[C8]] : index
+// CHECK:               %[[INSERT:.+]] = scf.if %[[IS_FIRST_K]] -> (i1) {
+// CHECK:               } else {
+// CHECK:                 %[[LAST:.+]] = memref.load %[[VALUES]][%[[B]], %[[C7]]]
+// CHECK:                 %[[BETTER:.+]] = arith.cmpf ogt, %[[VALUE]], %[[LAST]] : f32
+// CHECK:                 scf.yield %[[BETTER]] : i1
+// CHECK:               }
+// CHECK:               scf.if %[[INSERT]] {
+// CHECK:                 %[[POS_P1:.+]] = arith.addi %[[N]], %[[C1]] : index
+// CHECK:                 %[[UB:.+]] = arith.minui %[[POS_P1]], %[[C8]] : index
+// CHECK:                 scf.for %[[I:.+]] = %[[C0]] to %[[UB]] step %[[C1]] iter_args(%[[CARRIED_VALUE:.+]] = %[[VALUE]], %[[CARRIED_INDEX:.+]] = %[[INDEX]]) -> (f32, i64) {
+// CHECK:                   %[[SELECTED_VALUE:.+]] = memref.load %[[VALUES]][%[[B]], %[[I]]]
+// CHECK:                   %[[SELECTED_INDEX:.+]] = memref.load %[[INDICES]][%[[B]], %[[I]]]
+// CHECK:                   %[[IS_UNSET:.+]] = arith.cmpi eq, %[[I]], %[[N]] : index
+// CHECK:                   %[[CMP:.+]] = arith.cmpf ogt, %[[CARRIED_VALUE]], %[[SELECTED_VALUE]] : f32
+// CHECK:                   %[[IS_BETTER:.+]] = arith.ori %[[IS_UNSET]], %[[CMP]] : i1
+// CHECK:                   %[[NEW_VALUE:.+]] = arith.select %[[IS_BETTER]], %[[CARRIED_VALUE]], %[[SELECTED_VALUE]] : f32
+// CHECK:                   memref.store %[[NEW_VALUE]], %[[VALUES]][%[[B]], %[[I]]]
+// CHECK:                   %[[NEW_INDEX:.+]] = arith.select %[[IS_BETTER]], %[[CARRIED_INDEX]], %[[SELECTED_INDEX]] : i64
+// CHECK:                   memref.store %[[NEW_INDEX]], %[[INDICES]][%[[B]], %[[I]]]
+// CHECK:                   %[[NEXT_VALUE:.+]] = arith.select %[[IS_BETTER]], %[[SELECTED_VALUE]], %[[CARRIED_VALUE]] : f32
+// CHECK:                   %[[NEXT_INDEX:.+]] = arith.select %[[IS_BETTER]], %[[SELECTED_INDEX]], %[[CARRIED_INDEX]] : i64
+// CHECK:                   scf.yield %[[NEXT_VALUE]], %[[NEXT_INDEX]] : f32, i64
@@ -0,0 +1,162 @@
+// RUN: torch-mlir-dialects-opt -split-input-file -tm-tensor-to-loops="scan-block-size=32 parallel-scatter=true" %s | FileCheck %s
+
+func.func @scan_1d_inclusive(%0: memref<128xi32>, %1: memref<128xi32>) {
+  %c0 = memref.alloc() : memref<i32>
+  tm_tensor.scan dimension(0) inclusive(true)
+    ins(%0 : memref<128xi32>) outs(%1, %c0 : memref<128xi32>, memref<i32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  }
+  return
+}
+// CHECK-LABEL: func.func @scan_1d_inclusive
+// CHECK-SAME:    %[[BUFI:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[BUFO:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C32:.+]] = arith.constant 32 : index
+// CHECK-DAG:     %[[C128:.+]] = arith.constant 128 : index
+// CHECK-DAG:     %[[ACC:.+]] = memref.alloc() : memref<i32>
+// CHECK:         scf.parallel (%[[BLOCK:.+]]) = (%[[C0]]) to (%[[NUM_BLOCKS:.+]]) step (%[[C1]])
+// CHECK:           %[[START:.+]] = arith.muli %[[BLOCK]], %[[C32]] : index
+// CHECK:           %[[V1:.+]] = memref.load %[[BUFI]][%[[START]]]
+// CHECK:           memref.store %[[V1]], %[[BUFO]][%[[START]]]
+// CHECK:           scf.for %[[I:.+]] =
+// CHECK:             %[[PREV:.+]] = arith.subi %[[I]], %[[C1]] : index
+// CHECK:             %[[V2:.+]] = memref.load %[[BUFO]][%[[PREV]]]
+// CHECK:             %[[V3:.+]] = memref.load %[[BUFI]][%[[I]]]
+// CHECK:             %[[V4:.+]] = arith.addi %[[V2]], %[[V3]] : i32
+// CHECK:             memref.store %[[V4]], %[[BUFO]][%[[I]]]
+// CHECK:         scf.parallel
+// CHECK:           scf.for %[[B:.+]] = %[[C1]] to %[[NUM_BLOCKS]] step %[[C1]]
+// CHECK:             %[[V5:.+]] = arith.addi
+// CHECK:             memref.store %[[V5]], %[[BUFO]]
+// CHECK:           scf.if
+// CHECK:             %[[LAST:.+]] = memref.load %[[BUFO]]
+// CHECK:             memref.store %[[LAST]], %[[ACC]][]
+// CHECK:         scf.parallel (%[[BLOCK2:.+]]) = (%[[C1]]) to (%[[NUM_BLOCKS]]) step (%[[C1]])
+// CHECK:           %[[CARRY:.+]] = memref.load %[[BUFO]]
+// CHECK:           scf.parallel (%[[J:.+]]) =
+// CHECK:             %[[V6:.+]] = memref.load %[[BUFO]][%[[J]]]
+// CHECK:             %[[V7:.+]] = arith.addi %[[CARRY]], %[[V6]] : i32
+// CHECK:             memref.store %[[V7]], %[[BUFO]][%[[J]]]
+
+// -----
+
+func.func @scan_2d_exclusive(%0: memref<16x32xi32>, %1: memref<16x32xi32>) {
+  %t0 = memref.alloc() : memref<32xi32>
+  tm_tensor.scan dimension(0) inclusive(false)
+    ins(%0 : memref<16x32xi32>) outs(%1, %t0 : memref<16x32xi32>, memref<32xi32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  }
+  return
+}
+// CHECK-LABEL: func.func @scan_2d_exclusive
+// CHECK-SAME:    %[[BUFI:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[BUFO:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C32:.+]] = arith.constant 32 : index
+// CHECK-DAG:     %[[ACC:.+]] = memref.alloc() : memref<32xi32>
+// CHECK:         scf.parallel (%[[BLOCK:.+]], %[[J:.+]]) = (%[[C0]], %[[C0]]) to (%{{.+}}, %[[C32]]) step (%[[C1]], %[[C1]])
+// CHECK:           %[[START:.+]] = arith.muli %[[BLOCK]], %[[C32]] : index
+// CHECK:           %[[COND:.+]] = arith.cmpi eq, %[[START]], %[[C0]] : index
+// CHECK:           scf.if %[[COND]] -> (i32) {
+// CHECK:             %[[V1:.+]] = memref.load %[[ACC]][%[[J]]]
+// CHECK:             scf.yield %[[V1]] : i32
+// CHECK:           } else {
+// CHECK:             %[[PREV:.+]] = arith.subi %[[START]], %[[C1]] : index
+// CHECK:             %[[V2:.+]] = memref.load %[[BUFI]][%[[PREV]], %[[J]]]
+// CHECK:             scf.yield %[[V2]] : i32
+// CHECK:           }
+// CHECK:           scf.for
+// CHECK:         scf.parallel
+// CHECK:           scf.for
+// CHECK:           scf.if
+// CHECK:             memref.store %{{.+}}, %[[ACC]][%{{.+}}]
+// CHECK:         scf.parallel
+// CHECK:           scf.parallel
+
+// -----
+
+func.func @scatter_update_scalar_1D(
+    %original: memref<8xi32>, %indices: memref<3x1xi32>,
+    %updates: memref<3xi32>) {
+  tm_tensor.scatter unique_indices(true)
+    ins(%updates, %indices : memref<3xi32>, memref<3x1xi32>)
+    outs(%original : memref<8xi32>)  {
+  ^bb0(%arg0: i32, %arg1: i32):  // no predecessors
+    tm_tensor.yield %arg0 : i32
+  }
+  return
+}
+// CHECK-LABEL: func.func @scatter_update_scalar_1D
+// CHECK-SAME:    %[[ORIGINAL:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[UPDATES:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C3:.+]] = arith.constant 3 : index
+// CHECK:         scf.parallel (%[[I:.+]]) = (%[[C0]]) to (%[[C3]]) step (%[[C1]]) {
+// CHECK:           %[[T1:.+]] = memref.load %[[UPDATES]][%[[I]]] : memref<3xi32>
+// CHECK:           %[[T2:.+]] =  memref.load %[[INDICES]][%[[I]], %[[C0]]] : memref<3x1xi32>
+// CHECK:           %[[IDX:.+]] = arith.index_cast %[[T2]] : i32 to index
+// CHECK:           memref.store %[[T1]], %[[ORIGINAL]][%[[IDX]]]
+
+// -----
+
+func.func @scatter_add_scalar_1D_non_unique(
+    %original: memref<8xf32>, %indices: memref<3x1xi32>,
+    %updates: memref<3xf32>) {
+  tm_tensor.scatter unique_indices(false)
+    ins(%updates, %indices : memref<3xf32>, memref<3x1xi32>)
+    outs(%original : memref<8xf32>)  {
+  ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+    %0 = arith.addf %arg1, %arg0 : f32
+    tm_tensor.yield %0 : f32
+  }
+  return
+}
+// CHECK-LABEL: func.func @scatter_add_scalar_1D_non_unique
+// CHECK-SAME:    %[[ORIGINAL:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[UPDATES:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C3:.+]] = arith.constant 3 : index
+// CHECK:         scf.parallel (%[[I:.+]]) = (%[[C0]]) to (%[[C3]]) step (%[[C1]]) {
+// CHECK:           %[[T1:.+]] = memref.load %[[UPDATES]][%[[I]]] : memref<3xf32>
+// CHECK:           %[[T2:.+]] = memref.load %[[INDICES]][%[[I]], %[[C0]]] : memref<3x1xi32>
+// CHECK:           %[[IDX:.+]] = arith.index_cast %[[T2]] : i32 to index
+// CHECK:           memref.atomic_rmw addf %[[T1]], %[[ORIGINAL]][%[[IDX]]] : (f32, memref<8xf32>) -> f32
+
+// -----
+
+func.func @scatter_update_slice_2D_non_unique(
+    %original: memref<4x3xi32>, %indices: memref<2x1xi32>,
+    %updates: memref<2x3xi32>) {
+  tm_tensor.scatter unique_indices(false)
+    ins(%updates, %indices : memref<2x3xi32>, memref<2x1xi32>)
+    outs(%original : memref<4x3xi32>)  {
+  ^bb0(%arg0: i32, %arg1: i32):  // no predecessors
+    tm_tensor.yield %arg0 : i32
+  }
+  return
+}
+// CHECK-LABEL: func.func @scatter_update_slice_2D_non_unique
+// CHECK-SAME:    %[[ORIGINAL:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[UPDATES:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C2:.+]] = arith.constant 2 : index
+// CHECK-DAG:     %[[C3:.+]] = arith.constant 3 : index
+// CHECK:         scf.for %[[I:.+]] = %[[C0]] to %[[C2]] step %[[C1]] {
+// CHECK:           scf.parallel (%[[J:.+]]) = (%[[C0]]) to (%[[C3]]) step (%[[C1]]) {
+// CHECK:             %[[UPDATE:.+]] = memref.load %[[UPDATES]][%[[I]], %[[J]]]
+// CHECK:             %[[INDEX:.+]] = memref.load %[[INDICES]][%[[I]], %[[C0]]]
+// CHECK:             %[[LOC:.+]] = arith.index_cast %[[INDEX]] : i32 to index
+// CHECK:             memref.store %[[UPDATE]], %[[ORIGINAL]][%[[LOC]], %[[J]]]
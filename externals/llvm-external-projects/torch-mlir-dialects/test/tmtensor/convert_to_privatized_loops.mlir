@@ -0,0 +1,47 @@
+// RUN: torch-mlir-dialects-opt -split-input-file -tm-tensor-to-loops="scatter-private-copies=4" %s | FileCheck %s
+
+func.func @histogram(
+    %original: memref<8xi64>, %indices: memref<100x1xi32>,
+    %updates: memref<100xi64>) {
+  tm_tensor.scatter unique_indices(false)
+    ins(%updates, %indices : memref<100xi64>, memref<100x1xi32>)
+    outs(%original : memref<8xi64>)  {
+  ^bb0(%arg0: i64, %arg1: i64):  // no predecessors
+    %0 = arith.addi %arg1, %arg0 : i64
+    tm_tensor.yield %0 : i64
+  }
+  return
+}
+// CHECK-LABEL: func.func @histogram
+// CHECK-SAME:    %[[ORIGINAL:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[INDICES:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[UPDATES:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG:     %[[C4:.+]] = arith.constant 4 : index
+// CHECK-DAG:     %[[C8:.+]] = arith.constant 8 : index
+// CHECK-DAG:     %[[C25:.+]] = arith.constant 25 : index
+// CHECK-DAG:     %[[C100:.+]] = arith.constant 100 : index
+// CHECK-DAG:     %[[ZERO:.+]] = arith.constant 0 : i64
+// CHECK:         %[[PRIVATE:.+]] = memref.alloc() : memref<4x8xi64>
+// CHECK:         scf.parallel (%[[P:.+]], %[[B:.+]]) = (%[[C0]], %[[C0]]) to (%[[C4]], %[[C8]]) step (%[[C1]], %[[C1]]) {
+// CHECK:           memref.store %[[ZERO]], %[[PRIVATE]][%[[P]], %[[B]]]
+// CHECK:         scf.parallel (%[[COPY:.+]]) = (%[[C0]]) to (%[[C4]]) step (%[[C1]]) {
+// CHECK:           %[[BEGIN:.+]] = arith.muli %[[COPY]], %[[C25]]
+// CHECK:           %[[NEXT:.+]] = arith.addi %[[BEGIN]], %[[C25]]
+// CHECK:           %[[END:.+]] = arith.minui %[[NEXT]], %[[C100]]
+// CHECK:           scf.for %[[I:.+]] = %[[BEGIN]] to %[[END]] step %[[C1]] {
+// CHECK:             %[[UPDATE:.+]] = memref.load %[[UPDATES]][%[[I]]]
+// CHECK:             %[[INDEX:.+]] = memref.load %[[INDICES]][%[[I]], %[[C0]]]
+// CHECK:             %[[BIN:.+]] = arith.index_cast %[[INDEX]] : i32 to index
+// CHECK:             %[[CURRENT:.+]] = memref.load %[[PRIVATE]][%[[COPY]], %[[BIN]]]
+// CHECK:             %[[SUM:.+]] = arith.addi %[[CURRENT]], %[[UPDATE]] : i64
+// CHECK:             memref.store %[[SUM]], %[[PRIVATE]][%[[COPY]], %[[BIN]]]
+// CHECK:         scf.parallel (%[[J:.+]]) = (%[[C0]]) to (%[[C8]]) step (%[[C1]]) {
+// CHECK:           %[[INIT:.+]] = memref.load %[[ORIGINAL]][%[[J]]]
+// CHECK:           %[[TOTAL:.+]] = scf.for %[[K:.+]] = %[[C0]] to %[[C4]] step %[[C1]] iter_args(%[[ACC:.+]] = %[[INIT]]) -> (i64) {
+// CHECK:             %[[PARTIAL:.+]] = memref.load %[[PRIVATE]][%[[K]], %[[J]]]
+// CHECK:             %[[ADD:.+]] = arith.addi %[[ACC]], %[[PARTIAL]] : i64
+// CHECK:             scf.yield %[[ADD]] : i64
+// CHECK:           memref.store %[[TOTAL]], %[[ORIGINAL]][%[[J]]]
+// CHECK:         memref.dealloc %[[PRIVATE]]
@@ -326,3 +326,45 @@ func.func @scatter_original_rank_mismatch(
     } -> tensor<?x?xi64>
   return %0 : tensor<?x?xi64>
 }
+
+// -----
+
+func.func @attention_key_shape_mismatch(
+    %query : tensor<2x4x8xf32>, %key : tensor<2x6x16xf32>,
+    %value : tensor<2x6x3xf32>, %init : tensor<2x4x3xf32>) -> tensor<2x4x3xf32> {
+  // expected-error @+1 {{incompatible query/key shapes}}
+  %0 = tm_tensor.attention scale(1.000000e+00)
+      ins(%query, %key, %value : tensor<2x4x8xf32>, tensor<2x6x16xf32>, tensor<2x6x3xf32>)
+      outs(%init : tensor<2x4x3xf32>) -> tensor<2x4x3xf32>
+  return %0 : tensor<2x4x3xf32>
+}
+
+// -----
+
+func.func @sort_mismatched_comparator(%values : tensor<?xf32>,
+    %indices : tensor<?xi64>) -> (tensor<?xf32>, tensor<?xi64>) {
+  // expected-error @+1 {{expected region to have 4 arguments}}
+  %0:2 = tm_tensor.sort dimension(0)
+      outs(%values, %indices : tensor<?xf32>, tensor<?xi64>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %1 = arith.cmpf olt, %lhs, %rhs : f32
+        tm_tensor.yield %1 : i1
+      } -> tensor<?xf32>, tensor<?xi64>
+  return %0#0, %0#1 : tensor<?xf32>, tensor<?xi64>
+}
+
+// -----
+
+func.func @topk_mismatched_shapes(%input : tensor<4x?xf32>,
+    %values : tensor<3x2xf32>, %indices : tensor<3x2xi64>)
+    -> (tensor<3x2xf32>, tensor<3x2xi64>) {
+  // expected-error @+1 {{incompatible input/output shapes}}
+  %0:2 = tm_tensor.topk dimension(1)
+      ins(%input : tensor<4x?xf32>)
+      outs(%values, %indices : tensor<3x2xf32>, tensor<3x2xi64>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %1 = arith.cmpf ogt, %lhs, %rhs : f32
+        tm_tensor.yield %1 : i1
+      } -> tensor<3x2xf32>, tensor<3x2xi64>
+  return %0#0, %0#1 : tensor<3x2xf32>, tensor<3x2xi64>
+}
@@ -0,0 +1,82 @@
+// RUN: torch-mlir-dialects-opt -split-input-file -one-shot-bufferize %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @scan_1d_inclusive(
+// CHECK-SAME:            %[[IN_TENSOR:.*]]: tensor<128xi32>) -> tensor<128xi32> {
+// CHECK-DAG:       %[[IN_MEMREF:.*]] = bufferization.to_memref %[[IN_TENSOR]]
+// CHECK-DAG:       %[[OUT_MEMREF:.*]] = memref.alloc() {{.*}}: memref<128xi32>
+// CHECK-DAG:       %[[ACC_MEMREF:.*]] = memref.alloc() {{.*}}: memref<i32>
+// CHECK-NOT:       memref.copy
+// CHECK:           tm_tensor.scan dimension(0) inclusive(true) ins(%[[IN_MEMREF]] : {{.*}})
+// CHECK-SAME:            outs(%[[OUT_MEMREF]], %[[ACC_MEMREF]] : memref<128xi32>, memref<i32>) {
+// CHECK:           %[[OUT_TENSOR:.*]] = bufferization.to_tensor %[[OUT_MEMREF]] : memref<128xi32>
+// CHECK:           return %[[OUT_TENSOR]] : tensor<128xi32>
+func.func @scan_1d_inclusive(%in: tensor<128xi32>) -> tensor<128xi32> {
+  %out = bufferization.alloc_tensor() : tensor<128xi32>
+  %acc = bufferization.alloc_tensor() : tensor<i32>
+  %ret_out, %ret_acc = tm_tensor.scan dimension(0) inclusive(true)
+    ins(%in : tensor<128xi32>) outs(%out, %acc: tensor<128xi32>, tensor<i32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  } -> tensor<128xi32>, tensor<i32>
+  return %ret_out : tensor<128xi32>
+}
+
+// -----
+
+// The scatter updates the result of the scan in place.
+// CHECK-LABEL:   func.func @scan_then_scatter(
+// CHECK-DAG:       %[[OUT_MEMREF:.*]] = memref.alloc() {{.*}}: memref<8xi32>
+// CHECK-DAG:       %[[ACC_MEMREF:.*]] = memref.alloc() {{.*}}: memref<i32>
+// CHECK-NOT:       memref.copy
+// CHECK:           tm_tensor.scan
+// CHECK-SAME:            outs(%[[OUT_MEMREF]], %[[ACC_MEMREF]] : memref<8xi32>, memref<i32>)
+// CHECK-NOT:       memref.copy
+// CHECK:           tm_tensor.scatter unique_indices(false)
+// CHECK-SAME:            outs(%[[OUT_MEMREF]] : memref<8xi32>)
+// CHECK:           %[[OUT_TENSOR:.*]] = bufferization.to_tensor %[[OUT_MEMREF]] : memref<8xi32>
+// CHECK:           return %[[OUT_TENSOR]] : tensor<8xi32>
+func.func @scan_then_scatter(
+    %in: tensor<8xi32>, %indices: tensor<3x1xi32>,
+    %updates: tensor<3xi32>) -> tensor<8xi32> {
+  %out = bufferization.alloc_tensor() : tensor<8xi32>
+  %acc = bufferization.alloc_tensor() : tensor<i32>
+  %scan, %scan_acc = tm_tensor.scan dimension(0) inclusive(true)
+    ins(%in : tensor<8xi32>) outs(%out, %acc: tensor<8xi32>, tensor<i32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  } -> tensor<8xi32>, tensor<i32>
+  %0 = tm_tensor.scatter unique_indices(false)
+    ins(%updates, %indices : tensor<3xi32>, tensor<3x1xi32>)
+    outs(%scan : tensor<8xi32>)  {
+  ^bb0(%update: i32, %orig: i32):  // no predecessors
+    %sum = arith.addi %orig, %update : i32
+    tm_tensor.yield %sum : i32
+  } -> tensor<8xi32>
+  return %0 : tensor<8xi32>
+}
+
+// -----
+
+// Function arguments are not writable, so the scatter updates a copy.
+// CHECK-LABEL:   func.func @scatter_update_scalar_1D(
+// CHECK-SAME:            %[[ORIG_TENSOR:.*]]: tensor<8xi32>,
+// CHECK:           %[[ORIG_MEMREF:.*]] = bufferization.to_memref %[[ORIG_TENSOR]]
+// CHECK:           %[[ORIG_MEMREF_NEW:.*]] = memref.alloc() {{.*}}: memref<8xi32>
+// CHECK:           memref.copy %[[ORIG_MEMREF]], %[[ORIG_MEMREF_NEW]]
+// CHECK:           tm_tensor.scatter unique_indices(true)
+// CHECK-SAME:            outs(%[[ORIG_MEMREF_NEW]] : memref<8xi32>)
+// CHECK:           %[[OUT_TENSOR:.*]] = bufferization.to_tensor %[[ORIG_MEMREF_NEW]] : memref<8xi32>
+// CHECK:           return %[[OUT_TENSOR]] : tensor<8xi32>
+func.func @scatter_update_scalar_1D(
+    %original: tensor<8xi32>, %indices: tensor<3x1xi32>,
+    %updates: tensor<3xi32>) -> tensor<8xi32> {
+  %0 = tm_tensor.scatter unique_indices(true)
+    ins(%updates, %indices : tensor<3xi32>, tensor<3x1xi32>)
+    outs(%original : tensor<8xi32>)  {
+  ^bb0(%update: i32, %orig: i32):  // no predecessors
+    tm_tensor.yield %update : i32
+  } -> tensor<8xi32>
+  return %0 : tensor<8xi32>
+}
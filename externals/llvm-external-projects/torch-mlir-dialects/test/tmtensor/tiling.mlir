@@ -0,0 +1,75 @@
+// RUN: torch-mlir-dialects-opt -split-input-file -tm-tensor-tile="tile-sizes=4,8" %s | FileCheck %s
+
+// The dimension other than the scanned one is tiled.
+func.func @scan_2d_dim0(%input: tensor<16x32xi32>, %output: tensor<16x32xi32>, %acc: tensor<32xi32>) -> (tensor<16x32xi32>, tensor<32xi32>) {
+  %0:2 = tm_tensor.scan dimension(0) inclusive(true)
+    ins(%input : tensor<16x32xi32>) outs(%output, %acc : tensor<16x32xi32>, tensor<32xi32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  } -> tensor<16x32xi32>, tensor<32xi32>
+  return %0#0, %0#1 : tensor<16x32xi32>, tensor<32xi32>
+}
+// CHECK-LABEL: func.func @scan_2d_dim0
+// CHECK-SAME:    %[[INPUT:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[OUTPUT:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[ACC:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C8:.+]] = arith.constant 8 : index
+// CHECK-DAG:     %[[C32:.+]] = arith.constant 32 : index
+// CHECK:         %[[RESULT:.+]]:2 = scf.for %[[IV:.+]] = %[[C0]] to %[[C32]] step %[[C8]]
+// CHECK-SAME:        iter_args(%[[OUTPUT_ARG:.+]] = %[[OUTPUT]], %[[ACC_ARG:.+]] = %[[ACC]])
+// CHECK-NOT:       scf.for
+// CHECK-DAG:       %[[INPUT_TILE:.+]] = tensor.extract_slice %[[INPUT]][0, %[[IV]]] [16, 8] [1, 1]
+// CHECK-DAG:       %[[OUTPUT_TILE:.+]] = tensor.extract_slice %[[OUTPUT_ARG]][0, %[[IV]]] [16, 8] [1, 1]
+// CHECK-DAG:       %[[ACC_TILE:.+]] = tensor.extract_slice %[[ACC_ARG]][%[[IV]]] [8] [1]
+// CHECK:           %[[SCAN:.+]]:2 = tm_tensor.scan dimension(0) inclusive(true)
+// CHECK-SAME:          ins(%[[INPUT_TILE]] : tensor<16x8xi32>) outs(%[[OUTPUT_TILE]], %[[ACC_TILE]] : tensor<16x8xi32>, tensor<8xi32>)
+// CHECK-DAG:       tensor.insert_slice %[[SCAN]]#0 into %[[OUTPUT_ARG]][0, %[[IV]]] [16, 8] [1, 1]
+// CHECK-DAG:       tensor.insert_slice %[[SCAN]]#1 into %[[ACC_ARG]][%[[IV]]] [8] [1]
+// CHECK:         return %[[RESULT]]#0, %[[RESULT]]#1
+
+// -----
+
+// The scanned dimension is left untiled, even though it has a tile size.
+func.func @scan_2d_dim1(%input: tensor<16x32xi32>, %output: tensor<16x32xi32>, %acc: tensor<16xi32>) -> (tensor<16x32xi32>, tensor<16xi32>) {
+  %0:2 = tm_tensor.scan dimension(1) inclusive(true)
+    ins(%input : tensor<16x32xi32>) outs(%output, %acc : tensor<16x32xi32>, tensor<16xi32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  } -> tensor<16x32xi32>, tensor<16xi32>
+  return %0#0, %0#1 : tensor<16x32xi32>, tensor<16xi32>
+}
+// CHECK-LABEL: func.func @scan_2d_dim1
+// CHECK-SAME:    %[[INPUT:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[OUTPUT:[a-zA-Z0-9]+]]
+// CHECK-SAME:    %[[ACC:[a-zA-Z0-9]+]]
+// CHECK-DAG:     %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C4:.+]] = arith.constant 4 : index
+// CHECK-DAG:     %[[C16:.+]] = arith.constant 16 : index
+// CHECK:         scf.for %[[IV:.+]] = %[[C0]] to %[[C16]] step %[[C4]]
+// CHECK-SAME:        iter_args(%[[OUTPUT_ARG:.+]] = %[[OUTPUT]], %[[ACC_ARG:.+]] = %[[ACC]])
+// CHECK-NOT:       scf.for
+// CHECK-DAG:       %[[INPUT_TILE:.+]] = tensor.extract_slice %[[INPUT]][%[[IV]], 0] [4, 32] [1, 1]
+// CHECK-DAG:       %[[OUTPUT_TILE:.+]] = tensor.extract_slice %[[OUTPUT_ARG]][%[[IV]], 0] [4, 32] [1, 1]
+// CHECK-DAG:       %[[ACC_TILE:.+]] = tensor.extract_slice %[[ACC_ARG]][%[[IV]]] [4] [1]
+// CHECK:           tm_tensor.scan dimension(1) inclusive(true)
+// CHECK-SAME:          ins(%[[INPUT_TILE]] : tensor<4x32xi32>) outs(%[[OUTPUT_TILE]], %[[ACC_TILE]] : tensor<4x32xi32>, tensor<4xi32>)
+
+// -----
+
+// A 1-D scan has no dimension to tile.
+func.func @scan_1d(%input: tensor<128xi32>, %output: tensor<128xi32>, %acc: tensor<i32>) -> (tensor<128xi32>, tensor<i32>) {
+  %0:2 = tm_tensor.scan dimension(0) inclusive(true)
+    ins(%input : tensor<128xi32>) outs(%output, %acc : tensor<128xi32>, tensor<i32>) {
+    ^bb0(%arg0 : i32, %arg1 : i32):
+      %sum = arith.addi %arg0, %arg1 : i32
+      tm_tensor.yield %sum : i32
+  } -> tensor<128xi32>, tensor<i32>
+  return %0#0, %0#1 : tensor<128xi32>, tensor<i32>
+}
+// CHECK-LABEL: func.func @scan_1d
+// CHECK-NOT:     scf.for
+// CHECK:         tm_tensor.scan dimension(0) inclusive(true)
+// CHECK-SAME:        ins(%{{.+}} : tensor<128xi32>)
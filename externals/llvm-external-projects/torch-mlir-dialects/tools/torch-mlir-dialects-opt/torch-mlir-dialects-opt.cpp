@@ -8,6 +8,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Bufferization/IR/Bufferization.h"
+#include "mlir/Dialect/Bufferization/Transforms/Passes.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
@@ -20,6 +22,7 @@
 #include "mlir/Transforms/Passes.h"
 #include "torch-mlir-dialects/Dialect/TMTensor/IR/ScalarLoopOpInterface.h"
 #include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorDialect.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/Transforms/BufferizableOpInterfaceImpl.h"
 #include "torch-mlir-dialects/Dialect/TMTensor/Transforms/Passes.h"
 
 using namespace mlir;
@@ -30,6 +33,7 @@ int main(int argc, char **argv) {
 
   registerTransformsPasses();
   registerSCFPasses();
+  bufferization::registerBufferizationPasses();
 
   // Local dialects.
   mlir::torch::TMTensor::registerPasses();
@@ -39,9 +43,12 @@ int main(int argc, char **argv) {
       // Local dialects
       mlir::torch::TMTensor::TMTensorDialect,
       // Upstream dialects
-      mlir::arith::ArithmeticDialect, mlir::linalg::LinalgDialect,
+      mlir::arith::ArithmeticDialect, mlir::bufferization::BufferizationDialect,
+      mlir::linalg::LinalgDialect,
       mlir::func::FuncDialect, mlir::memref::MemRefDialect,
       mlir::scf::SCFDialect, mlir::tensor::TensorDialect>();
+  mlir::torch::TMTensor::registerBufferizableOpInterfaceExternalModels(
+      registry);
 
   return mlir::asMainReturnCode(
       mlir::MlirOptMain(argc, argv, "MLIR modular optimizer driver\n", registry,
@@ -0,0 +1,45 @@
+/*===-- torch-mlir-c/Context.h - Context functions ----------------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef TORCHMLIR_C_CONTEXT_H
+#define TORCHMLIR_C_CONTEXT_H
+
+#include "mlir-c/IR.h"
+#include "mlir-c/Support.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Makes `context` run its parallel work on a thread pool shared by all the
+ * contexts of the process for which this is called, rather than on threads
+ * of its own, so that compiling in many contexts at once doesn't
+ * oversubscribe the cores. A context with multithreading disabled stays
+ * single-threaded. Must be called before `context` is used from several
+ * threads.
+ */
+MLIR_CAPI_EXPORTED void
+torchMlirContextUseSharedThreadPool(MlirContext context);
+
+/** Parses `functions`, a module of shape functions in the form of those of
+ * the shape library, e.g. the shape functions of the custom ops of an
+ * extension, and adds them to the shape library of `context`. The functions
+ * whose names the library already has are left out. Must not be called
+ * while passes run in `context`. Returns failure if `functions` doesn't
+ * parse or has a function differing from the one of the same name in the
+ * library, in which case nothing is added.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult
+torchMlirContextAddToShapeLibrary(MlirContext context, MlirStringRef functions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TORCHMLIR_C_CONTEXT_H
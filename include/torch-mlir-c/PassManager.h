@@ -0,0 +1,67 @@
+/*===-- torch-mlir-c/PassManager.h - Pass manager functions -------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef TORCHMLIR_C_PASSMANAGER_H
+#define TORCHMLIR_C_PASSMANAGER_H
+
+#include "mlir-c/Pass.h"
+#include "mlir-c/Support.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Makes `passManager` write a reproducer to `outputFile` when a pass fails
+ * or crashes: the operation it ran on, as it was before the pipeline, with
+ * the pipeline, which `torch-mlir-opt -run-reproducer` runs again. The
+ * operation is cloned before running the pipeline, and only printed if it
+ * fails.
+ */
+MLIR_CAPI_EXPORTED void
+torchMlirPassManagerEnableCrashReproducerGeneration(MlirPassManager passManager,
+                                                    MlirStringRef outputFile);
+
+/** The profile of the passes run by a pass manager, see
+ * `torchMlirPassManagerEnableProfiling`.
+ */
+typedef struct {
+  void *ptr;
+} TorchMlirPassProfiler;
+
+/** Makes `passManager` profile the passes it runs, and returns the profiler,
+ * which it owns.
+ */
+MLIR_CAPI_EXPORTED TorchMlirPassProfiler
+torchMlirPassManagerEnableProfiling(MlirPassManager passManager);
+
+/** A callback receiving the profile of a pass: the time spent in its runs, the
+ * number of operations in the operations it ran on, before and after it ran,
+ * and the increase of each of its statistics, all summed over its runs.
+ */
+typedef void (*TorchMlirPassProfileCallback)(
+    MlirStringRef pass, int64_t runs, double seconds, int64_t opsBefore,
+    int64_t opsAfter, intptr_t numStatistics,
+    const MlirStringRef *statisticNames, const uint64_t *statisticValues,
+    void *userData);
+
+/** Calls `callback` with the profile of each pass run so far, in the order in
+ * which they first ran.
+ */
+MLIR_CAPI_EXPORTED void
+torchMlirPassProfilerForEachPass(TorchMlirPassProfiler profiler,
+                                 TorchMlirPassProfileCallback callback,
+                                 void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TORCHMLIR_C_PASSMANAGER_H
@@ -0,0 +1,76 @@
+/*===-- torch-mlir-c/RefBackend.h - RefBackend functions ----------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef TORCHMLIR_C_REFBACKEND_H
+#define TORCHMLIR_C_REFBACKEND_H
+
+#include "mlir-c/IR.h"
+#include "mlir-c/Support.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Compiles `module`, in the LLVM dialect, to a position independent object
+ * file for the host at `path`, optimizing it at `optLevel` (0 to 3) like the
+ * ExecutionEngine does. Errors are emitted as diagnostics on the module.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult torchMlirRefBackendEmitObjectFile(
+    MlirModule module, MlirStringRef path, int optLevel);
+
+/** Calls the packed interface `function` of a RefBackend function once for
+ * each of the `numCalls` argument arrays `packedArgs`, on up to `numThreads`
+ * threads. The calls must not return their results through callbacks.
+ */
+MLIR_CAPI_EXPORTED void
+torchMlirRefBackendInvokePackedBatch(void (*function)(void **),
+                                     void ***packedArgs, intptr_t numCalls,
+                                     int numThreads);
+
+/** Returns the addresses of the runtime functions that the modules
+ * instrumented by `refback-insert-kernel-profiling` call, to bind them to
+ * `refbackend_profile_begin` and `refbackend_profile_end`.
+ */
+MLIR_CAPI_EXPORTED void
+torchMlirRefBackendGetProfilingFunctions(void **begin, void **end);
+
+/** Calls `callback` on the profile of each kernel called so far, from the
+ * most to the least time spent, with its name, number of calls, total time in
+ * nanoseconds and total bytes accessed.
+ */
+MLIR_CAPI_EXPORTED void torchMlirRefBackendForEachKernelProfile(
+    void (*callback)(MlirStringRef kernel, int64_t calls, int64_t nanoseconds,
+                     int64_t bytes, void *userData),
+    void *userData);
+
+/** Discards the profiles of the kernels called so far. */
+MLIR_CAPI_EXPORTED void torchMlirRefBackendResetKernelProfiles(void);
+
+/** Calls `callback` on each kernel of the library that the modules compiled
+ * with `refback-lower-linalg-to-library-calls` call, with its name and the
+ * address of its C interface.
+ */
+MLIR_CAPI_EXPORTED void torchMlirRefBackendForEachLibraryKernel(
+    void (*callback)(MlirStringRef name, void *address, void *userData),
+    void *userData);
+
+/** Gets the functions allocating and freeing the managed memory of the
+ * modules lowered for GPUs, with the driver of `platform`, `cuda` or `rocm`,
+ * to bind them to `_mlir_alloc`, `_mlir_aligned_alloc` and `_mlir_free`. On
+ * failure, calls `onError` with the error message.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult torchMlirRefBackendGetGpuAllocator(
+    MlirStringRef platform, void **alloc, void **alignedAlloc, void **free,
+    MlirStringCallback onError, void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TORCHMLIR_C_REFBACKEND_H
@@ -32,6 +32,35 @@ MLIR_CAPI_EXPORTED MlirValue torchMlirAdjustStaticInformation(
     MlirBlock block, MlirOperation insertBefore, MlirValue value,
     MlirType desiredType, bool userAllowsRefinement);
 
+//===----------------------------------------------------------------------===//
+// Tensor literals.
+//===----------------------------------------------------------------------===//
+
+/// A callback releasing the buffer of a tensor literal, with the `userData`
+/// given along with the buffer.
+typedef void (*TorchMlirBufferDeleter)(void *userData);
+
+/// Gets the elements attribute of a tensor literal of shape `shape` from the
+/// `numBytes` bytes at `data`, which hold the elements of the
+/// `c10::ScalarType` `scalarType` in row-major order, as in a contiguous CPU
+/// `at::Tensor`. The bytes are loaded as they are, except for bools, which
+/// are bit-packed.
+///
+/// `deleter`, if not null, is called with `userData` once `data` is no longer
+/// needed, which is before this function returns.
+///
+/// Returns null and emits an error at `loc` if the scalar type isn't
+/// supported or `numBytes` doesn't match the shape.
+MLIR_CAPI_EXPORTED MlirAttribute torchMlirTensorLiteralElementsGet(
+    MlirLocation loc, intptr_t rank, const int64_t *shape, int8_t scalarType,
+    size_t numBytes, const void *data, TorchMlirBufferDeleter deleter,
+    void *userData);
+
+/// Creates a detached `torch.vtensor.literal` op, or a `torch.tensor.literal`
+/// op if `valueSemantics` is false, with the value `elements`.
+MLIR_CAPI_EXPORTED MlirOperation torchMlirTensorLiteralCreate(
+    MlirLocation loc, MlirAttribute elements, bool valueSemantics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,7 +16,8 @@
 
 namespace mlir {
 namespace torch {
-std::unique_ptr<OperationPass<func::FuncOp>> createConvertTorchToLinalgPass();
+std::unique_ptr<OperationPass<func::FuncOp>>
+createConvertTorchToLinalgPass(bool convIm2col, int64_t reductionSplitFactor);
 }
 } // namespace mlir
 
@@ -58,6 +58,17 @@ convertReduceMeanOp(PatternRewriter &rewriter, Operation *op,
                     RankedTensorType output_type, Value input_value,
                     ElementsAttr axes_elems, bool keep_dims);
 
+// Lowers Softmax to a sequence of TOSA ops.
+llvm::Optional<Value> convertSoftmaxOp(PatternRewriter &rewriter, Operation *op,
+                                       RankedTensorType output_type,
+                                       Value logits_value, int64_t dim);
+
+// Lowers LogSoftmax to a sequence of TOSA ops.
+llvm::Optional<Value> convertLogSoftmaxOp(PatternRewriter &rewriter,
+                                          Operation *op,
+                                          RankedTensorType output_type,
+                                          Value logits_value, int64_t dim);
+
 } // namespace tosa
 } // namespace mlir
 
@@ -10,7 +10,13 @@
 #ifndef TORCHMLIR_DIALECT_TORCH_IR_TORCHDIALECT_H
 #define TORCHMLIR_DIALECT_TORCH_IR_TORCHDIALECT_H
 
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
+#include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Dialect.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include <mutex>
 
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h.inc"
 
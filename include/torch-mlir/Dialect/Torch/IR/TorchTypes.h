@@ -31,8 +31,8 @@ class ValueTensorType;
 
 /// Common getter function signature that covers all tensor types.
 /// Used for sharing code between NonValueTensorType and ValueTensorType.
-using GetTensorTypeFn =
-    llvm::function_ref<Type(MLIRContext *, Optional<ArrayRef<int64_t>>, Type)>;
+using GetTensorTypeFn = llvm::function_ref<Type(
+    MLIRContext *, Optional<ArrayRef<int64_t>>, Type, Attribute)>;
 
 /// The representation of an unknown dimension size in an ArrayRef<int64_t>.
 constexpr static int64_t kUnknownSize = -1;
@@ -53,6 +53,13 @@ public:
   /// convenient API.
   Type getOptionalDtype() const;
 
+  /// Get the raw nullable sparse tensor encoding of this tensor type, which
+  /// is null for dense tensors.
+  Attribute getOptionalSparsity() const;
+
+  /// Return true if this type has a sparse tensor encoding.
+  bool hasSparsity() const { return static_cast<bool>(getOptionalSparsity()); }
+
   /// Return true if this type has a list of sizes.
   bool hasSizes() const { return getOptionalSizes().hasValue(); }
 
@@ -89,10 +96,13 @@ public:
   Type getWithSizesAndDtypeFrom(BaseTensorType other) const;
 
   /// Return a type of the same kind as this one, but with given raw optional
-  /// sizes and raw optional dtype.
+  /// sizes and raw optional dtype, and no sparsity.
   Type getWithSizesAndDtype(Optional<ArrayRef<int64_t>> optionalSizes,
                             Type optionalDtype) const;
 
+  /// Return this type with the given raw optional sparsity.
+  BaseTensorType getWithSparsity(Attribute optionalSparsity) const;
+
   /// Return a type with the same shape and dtype as this one, but with
   /// value semantics.
   ValueTensorType getWithValueSemantics() const;
@@ -143,6 +153,14 @@ inline Type BaseTensorType::getOptionalDtype() const {
   llvm_unreachable("not a BaseTensorType!");
 }
 
+inline Attribute BaseTensorType::getOptionalSparsity() const {
+  if (auto tensor = dyn_cast<NonValueTensorType>())
+    return tensor.getOptionalSparsity();
+  if (auto tensor = dyn_cast<ValueTensorType>())
+    return tensor.getOptionalSparsity();
+  llvm_unreachable("not a BaseTensorType!");
+}
+
 inline bool BaseTensorType::classof(Type type) {
   return type.isa<NonValueTensorType, ValueTensorType>();
 }
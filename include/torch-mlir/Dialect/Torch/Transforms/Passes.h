@@ -26,6 +26,10 @@ std::unique_ptr<OperationPass<ModuleOp>> createGlobalizeObjectGraphPass();
 std::unique_ptr<OperationPass<ModuleOp>>
 createPrepareForGlobalizeObjectGraphPass();
 
+/// What the backend lowering pipelines do with the runtime asserts checking
+/// dynamic shapes.
+enum class RuntimeAssertsMode { Keep, Hoist, Elide };
+
 struct TorchLoweringPipelineOptions
     : public PassPipelineOptions<TorchLoweringPipelineOptions> {
   // If this option is true, then perform optimizations.
@@ -37,6 +41,82 @@ struct TorchLoweringPipelineOptions
   // If this option is true, skip decomposition of complex operations.
   Option<bool> decompose{*this, "decompose-complex-ops", llvm::cl::desc("Decompose complex operations."),
                         llvm::cl::init(true)};                      
+
+  // Names of ops (e.g. `torch.aten._softmax`) that the backend lowers
+  // directly, and that therefore must not be decomposed.
+  ListOption<std::string> backendLegalOps{
+      *this, "backend-legal-ops",
+      llvm::cl::desc("List of ops to be considered legal for the backend.")};
+
+  // If this option is true, lower 2D convolutions to an im2col unfolding
+  // plus a matmul on the linalg-on-tensors path. This is usually faster for
+  // small batches and large kernels, for backends whose matmul is better
+  // optimized than their convolution.
+  Option<bool> convIm2col{
+      *this, "conv-im2col",
+      llvm::cl::desc("Lower 2D convolutions to im2col plus matmul."),
+      llvm::cl::init(false)};
+
+  // If this option is positive, full reductions of static tensors whose
+  // number of elements is a multiple of it are split into that many
+  // independent partial reductions plus a final combine, so that they can
+  // run in parallel, on the linalg-on-tensors path.
+  Option<int64_t> reductionSplitFactor{
+      *this, "reduction-split-factor",
+      llvm::cl::desc("Number of partial reductions to split full reductions "
+                     "into (0 to disable)."),
+      llvm::cl::init(0)};
+
+  // If this option is true, compile the program for inference: dropout and
+  // batch norm ops run in inference mode even if their training flag is not
+  // a constant `false`.
+  Option<bool> inference{
+      *this, "inference",
+      llvm::cl::desc("Run dropout and batch norm ops in inference mode."),
+      llvm::cl::init(false)};
+
+  // What to do with the runtime asserts checking dynamic shapes on the
+  // linalg-on-tensors path. Hoisting them to the start of each function,
+  // deduplicated, keeps them out of the kernels. Eliding them assumes that
+  // the program is only called with valid shapes.
+  Option<RuntimeAssertsMode> runtimeAsserts{
+      *this, "runtime-asserts",
+      llvm::cl::desc("What to do with runtime asserts on dynamic shapes."),
+      llvm::cl::init(RuntimeAssertsMode::Keep),
+      llvm::cl::values(
+          clEnumValN(RuntimeAssertsMode::Keep, "keep",
+                     "Keep the asserts where they are."),
+          clEnumValN(RuntimeAssertsMode::Hoist, "hoist",
+                     "Hoist the asserts to function entry and deduplicate "
+                     "them."),
+          clEnumValN(RuntimeAssertsMode::Elide, "elide",
+                     "Erase the asserts, assuming valid shapes."))};
+
+  // If this option is non-empty, compute matmuls and convolutions of f32
+  // tensors in this 16-bit float type (`bf16` or `f16`), accumulating in f32.
+  Option<std::string> autoCastDtype{
+      *this, "auto-cast-dtype",
+      llvm::cl::desc("16-bit float type to compute matmuls and convolutions "
+                     "in (empty to disable)."),
+      llvm::cl::init("")};
+
+  // If this option is true, the weights of the program, i.e. the tensors of
+  // the global slots that it never mutates, become trailing arguments of its
+  // public functions instead of constants, so that a single compiled module
+  // serves every set of weights of the same architecture.
+  Option<bool> weightsAsArguments{
+      *this, "weights-as-arguments",
+      llvm::cl::desc("Pass the weights as arguments of the functions."),
+      llvm::cl::init(false)};
+
+  // The maximum number of rounds of shape and dtype refinement,
+  // simplification and decomposition, which are repeated until the program
+  // stops changing.
+  Option<int64_t> maxSimplificationIterations{
+      *this, "max-simplification-iterations",
+      llvm::cl::desc("Maximum number of rounds of the simplification "
+                     "pipeline to run until the program stops changing."),
+      llvm::cl::init(10)};
 };
 
 /// Creates a pipeline that lowers the object graph IR that is produced by
@@ -54,19 +134,60 @@ void createTorchFunctionToTorchBackendPipeline(
 void createTorchShapeRefinementPipeline(
     OpPassManager &pm, const TorchLoweringPipelineOptions &options);
 
-std::unique_ptr<OperationPass<ModuleOp>> createAdjustCallingConventionsPass();
+/// Creates a pipeline doing one round of shape and dtype refinement, followed
+/// by the simplifications and decompositions that the refined types enable.
+void createTorchSimplificationPipeline(
+    OpPassManager &pm, const TorchLoweringPipelineOptions &options);
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createSimplifyToFixedPointPass(int64_t maxIterations, bool optimize,
+                               bool decompose,
+                               ArrayRef<std::string> backendLegalOps);
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createAdjustCallingConventionsPass(bool weightsAsArguments = false);
 
 std::unique_ptr<OperationPass<func::FuncOp>> createRefineTypesPass();
 
+std::unique_ptr<OperationPass<ModuleOp>>
+createRefineTypesInterprocedurallyPass();
+
 std::unique_ptr<OperationPass<ModuleOp>> createInlineGlobalSlotsPass();
 
+std::unique_ptr<OperationPass<ModuleOp>> createDeduplicateLiteralsPass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createLowerMutableGlobalSlotsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createForceInferenceModePass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createFoldConvBatchNormPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createFoldLiteralTensorsPass(int64_t maxElements,
+                             int64_t maxSplatElements);
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createElideDtypeConversionsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createAutoCastPass(StringRef dtype);
+
+std::unique_ptr<OperationPass<func::FuncOp>> createGlobalValueNumberingPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createMultiversionExpectedShapesPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createLoopInvariantCodeMotionPass();
+
 std::unique_ptr<OperationPass<func::FuncOp>> createReduceOpVariantsPass();
 
 std::unique_ptr<OperationPass<func::FuncOp>> createMaximizeValueSemanticsPass();
 
 std::unique_ptr<OperationPass<ModuleOp>> createRefinePublicReturnPass();
 
-std::unique_ptr<OperationPass<func::FuncOp>> createDecomposeComplexOpsPass();
+std::unique_ptr<OperationPass<func::FuncOp>>
+createDecomposeComplexOpsPass(ArrayRef<std::string> legalOps);
 
 std::unique_ptr<OperationPass<ModuleOp>> createPreprocessShapeLibraryPass();
 
@@ -9,15 +9,20 @@
 #ifndef TORCHMLIR_DIALECT_TORCH_UTILS_H
 #define TORCHMLIR_DIALECT_TORCH_UTILS_H
 
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/Value.h"
 #include "mlir/Support/LLVM.h"
 #include "torch-mlir/Dialect/Torch/Utils/TorchUpstream.h"
 
+#include <limits>
+
 namespace mlir {
 namespace torch {
 namespace Torch {
 
+class PrimIfOp;
+
 int64_t toPositiveDim(int64_t dim, int64_t inputRank);
 bool isValidDim(int64_t dim, int64_t inputRank);
 bool getListConstructElements(Value v, SmallVectorImpl<Value> &elems);
@@ -46,6 +51,116 @@ bool isBuiltInType(Type type);
 // -1 is returned if the tensorRank can't be determined.
 int getTensorRank(Value tensor);
 
+/// A conservative range [`min`, `max`] of the values of a `!torch.int`.
+struct IntRange {
+  int64_t min = std::numeric_limits<int64_t>::min();
+  int64_t max = std::numeric_limits<int64_t>::max();
+
+  bool isNonNegative() const { return min >= 0; }
+  /// Returns true if the value is known to be in [`lower`, `upper`).
+  bool isWithin(int64_t lower, int64_t upper) const {
+    return min >= lower && max < upper;
+  }
+};
+
+/// Returns a conservative range of the values that the `!torch.int` `v` can
+/// take, found by looking at how `v` is computed (constants, sizes of tensors
+/// and lengths of lists, and integer arithmetic on those).
+IntRange getIntRange(Value v);
+
+/// Returns `attr` with its dimensions permuted by `permutation`, i.e. dimension
+/// `i` of the result is dimension `permutation[i]` of `attr`. This lets
+/// lowerings transpose constant weights at compile time instead of emitting a
+/// transpose that runs at every invocation. Fails if the element type is not
+/// byte-sized.
+FailureOr<DenseElementsAttr>
+transposeElementsAttr(DenseElementsAttr attr, ArrayRef<int64_t> permutation);
+
+/// Returns true if `op` is an `aten._log_softmax_backward_data` along the last
+/// dimension of a rank 1 or 2 tensor, whose `grad_output` is computed by an
+/// `aten.nll_loss_backward` used only by `op`. This is the backward of a
+/// cross-entropy loss, which backends can compute in one pass without
+/// materializing the gradient of the log-softmax output.
+bool isLogSoftmaxBackwardOfNllLoss(Operation *op);
+
+/// Returns true if `op` may return a view of its first operand, i.e. a
+/// non-value tensor sharing its storage.
+bool isViewLikeOp(Operation *op);
+
+/// Gets the scale and zero point of the per-tensor quantized `tensor`, which
+/// are operands of the op that produces it, or of the quantized tensor that a
+/// relu producing it keeps the quantization of.
+LogicalResult getPerTensorQuantizationParams(Value tensor, Value &scale,
+                                             Value &zeroPoint);
+
+/// Returns true if the non-value tensor `tensor`, or a view of it, may be
+/// mutated in place by one of its users. This includes the batch norms in
+/// training mode, which update their running stats in place.
+bool isMutatedInPlace(Value tensor);
+
+/// Returns true if `op` computes the same results wherever its operands are
+/// available, so that it can be moved there or merged with an equivalent op:
+/// it is a value-semantic, read-only or effect-free op without regions that
+/// doesn't draw random numbers, and none of its operands and results is a
+/// non-value tensor or a list that may be mutated.
+bool isMovableComputation(Operation *op);
+
+/// Returns true if `v` is defined outside of `region`, i.e. neither in it nor
+/// in the regions nested in it.
+bool isDefinedOutside(Value v, Region &region);
+
+/// Hoists the movable ops of the `then` branch of `ifOp` computed from values
+/// defined outside of it that have an op of the `else` branch equivalent to
+/// them by `isEquivalent` before `ifOp`, replaces the equivalent ops with
+/// them, and returns them. The ops that depend on hoisted ops only are
+/// hoisted in turn. Ops of a single branch are left alone, since they may rely
+/// on the condition, e.g. for an index to be in bounds.
+SmallVector<Operation *>
+hoistCommonOps(PrimIfOp ifOp,
+               function_ref<bool(Operation *, Operation *)> isEquivalent);
+
+/// The operands of an attention subgraph rooted at its final matmul:
+///   matmul(softmax(scale * matmul(query, transpose(key)) + mask), value)
+/// where the scaling and the mask are optional, and the softmax is over the
+/// last dimension.
+struct AttentionMatch {
+  Value query, key, value, mask;
+  double scale = 1.0;
+  /// The ops of the subgraph other than the root, users before producers.
+  SmallVector<Operation *> intermediateOps;
+};
+
+/// Matches the attention subgraph rooted at the `aten.matmul` op `op`. Each
+/// intermediate result must only feed the next op of the subgraph, and the
+/// mask, if any, must have static sizes so that it is known which of its
+/// dimensions are broadcast.
+FailureOr<AttentionMatch> matchAttention(Operation *op);
+
+/// Returns true if the `aten.matmul` op `op` is either matmul of an attention
+/// subgraph, which must be kept whole until it is lowered.
+bool isAttentionMatmul(Operation *op);
+
+/// Returns the name of the natively compiled kernel that the `torch.operator`
+/// `op` calls, which is its `torch.custom_kernel` attribute, or an empty
+/// string if `op` is not a call to a custom kernel. The calls to custom
+/// kernels have value semantics, and their results have the dtype of their
+/// first tensor input.
+StringRef getCustomKernel(Operation *op);
+
+/// Returns the inputs of the custom kernel call `op`, i.e. the operands of
+/// the op before the shapes of its results are attached.
+OperandRange getCustomKernelInputs(Operation *op);
+
+/// Returns the `!torch.list<int>` shapes of the results of the custom kernel
+/// call `op`, one per result, which are its trailing operands once
+/// attached by `setCustomKernelResultShapes`, or an empty range before that.
+OperandRange getCustomKernelResultShapes(Operation *op);
+
+/// Attaches `shapes` to the custom kernel call `op` as the shapes of its
+/// results, replacing the ones attached before, if any. The backends
+/// allocate the results of the kernel with these shapes.
+void setCustomKernelResultShapes(Operation *op, ValueRange shapes);
+
 } // namespace Torch
 } // namespace torch
 } // namespace mlir
@@ -42,6 +42,24 @@ std::unique_ptr<OperationPass<ModuleOp>> createFuncBackendTypeConversionPass();
 std::unique_ptr<OperationPass<func::FuncOp>>
 createFinalizingBackendTypeConversionPass();
 
+std::unique_ptr<OperationPass<func::FuncOp>>
+createTosaPropagateChannelsLastPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createInsertSliceDestinationPassingPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createOptimizeRuntimeAssertsPass(bool elide);
+
+std::unique_ptr<OperationPass<func::FuncOp>> createNarrowIndexTensorsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createScalarizeZeroRankTensorsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createAnnotateBufferReusePass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createExternalizeLiteralsPass();
+
 std::unique_ptr<OperationPass<ModuleOp>>
 createVerifyLinalgOnTensorsBackendContractPass();
 
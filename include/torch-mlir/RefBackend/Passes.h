@@ -29,9 +29,33 @@ std::unique_ptr<OperationPass<func::FuncOp>> createExpandOpsForLLVMPass();
 
 std::unique_ptr<OperationPass<ModuleOp>> createInsertRngGlobalsPass();
 
+std::unique_ptr<OperationPass<ModuleOp>> createLowerGlobalTensorsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createUpdateGlobalsInPlacePass();
+
 std::unique_ptr<OperationPass<func::FuncOp>> createMungeMemrefCopyPass();
 
 std::unique_ptr<OperationPass<func::FuncOp>> createGeneralizeTensorPadPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createFuseMultiUseElementwiseOpsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+createInterchangeReductionLoopsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createTileAndPadLinalgOpsPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createVectorizeLinalgOpsPass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createLowerLinalgToLibraryCallsPass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createBufferizeKernelCallsPass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createPlanMemoryPass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createInsertKernelProfilingPass();
+
+std::unique_ptr<OperationPass<ModuleOp>> createMapHostMemoryToGpuPass();
 } // namespace RefBackend
 } // namespace torch
 } // namespace mlir
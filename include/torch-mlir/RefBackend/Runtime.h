@@ -0,0 +1,205 @@
+//===------------------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+//
+// A runtime for the modules compiled by the RefBackend, for running them from
+// C++ without Python. It loads either a module lowered to the LLVM dialect,
+// which it JIT compiles with the ExecutionEngine, or a shared library written
+// by `export_shared_library` in `refbackend.py`.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TORCHMLIR_REFBACKEND_RUNTIME_H
+#define TORCHMLIR_REFBACKEND_RUNTIME_H
+
+#include "mlir/ExecutionEngine/CRunnerUtils.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mlir {
+class ModuleOp;
+
+namespace torch {
+namespace RefBackend {
+
+/// An argument or an output of a RefBackend function: an unranked memref
+/// descriptor, pointing to the ranked descriptor of the memref.
+struct MemRefArg {
+  int64_t rank;
+  void *descriptor;
+};
+
+/// Returns the argument for the ranked memref descriptor `memRef`, which must
+/// outlive the calls it is passed to.
+template <typename T, int N>
+MemRefArg getMemRefArg(StridedMemRefType<T, N> &memRef) {
+  return {N, &memRef};
+}
+
+/// A loaded RefBackend module.
+///
+/// Only the functions with static result shapes can be invoked: they write
+/// their results to outputs allocated by the caller, whose types are
+/// recorded in the `refbackend.result_types` attribute. The other functions
+/// return their results through callbacks, which only the Python invoker
+/// provides.
+///
+/// The module can be shared by several threads. Its functions are called
+/// concurrently if they are reentrant, otherwise one at a time.
+class Runtime {
+public:
+  /// The packed interface of a function, taking an array of pointers to its
+  /// arguments.
+  using PackedFunction = void (*)(void **);
+
+  virtual ~Runtime();
+
+  /// JIT compiles `module`, lowered to the LLVM dialect by the RefBackend, at
+  /// `optLevel` (0 to 3), linking it with the shared libraries
+  /// `sharedLibPaths`, like the async runtime for multithreaded modules.
+  static llvm::Expected<std::unique_ptr<Runtime>>
+  loadModule(ModuleOp module, llvm::ArrayRef<llvm::StringRef> sharedLibPaths,
+             int optLevel = 2);
+
+  /// Parses the module, lowered to the LLVM dialect by the RefBackend, in the
+  /// file at `path`, and JIT compiles it like `loadModule`.
+  static llvm::Expected<std::unique_ptr<Runtime>>
+  loadModuleFile(llvm::StringRef path,
+                 llvm::ArrayRef<llvm::StringRef> sharedLibPaths,
+                 int optLevel = 2);
+
+  /// Loads the shared library at `path`, written by `export_shared_library`.
+  static llvm::Expected<std::unique_ptr<Runtime>>
+  loadSharedLibrary(llvm::StringRef path);
+
+  /// Calls the function `name` on `inputs`, writing its results to
+  /// `outputs`, which must have the types returned by `getResultTypes`.
+  /// Scalar results are written to rank-0 outputs.
+  llvm::Error invoke(llvm::StringRef name, llvm::ArrayRef<MemRefArg> inputs,
+                     llvm::ArrayRef<MemRefArg> outputs);
+
+  /// Returns the result types of the function `name`, as strings like
+  /// `memref<2x3xf32>` or `i64`, or an error if it cannot be invoked.
+  llvm::Expected<llvm::ArrayRef<std::string>>
+  getResultTypes(llvm::StringRef name) const;
+
+  /// Returns whether the functions can be called concurrently.
+  bool isReentrant() const { return reentrant; }
+
+protected:
+  Runtime(llvm::StringMap<std::vector<std::string>> resultTypes,
+          bool reentrant)
+      : resultTypes(std::move(resultTypes)), reentrant(reentrant) {}
+
+  /// Returns the packed interface of the function `name`.
+  virtual llvm::Expected<PackedFunction> lookupPacked(llvm::StringRef name) = 0;
+
+private:
+  llvm::StringMap<std::vector<std::string>> resultTypes;
+  bool reentrant;
+  // Serializes the calls to the functions that aren't reentrant.
+  std::mutex mutex;
+  // The packed interfaces looked up so far, guarded by `lookupMutex`.
+  llvm::StringMap<PackedFunction> packedFunctions;
+  std::mutex lookupMutex;
+};
+
+/// The time spent in a kernel instrumented by
+/// `refback-insert-kernel-profiling`, over all its calls.
+struct KernelProfile {
+  /// The name of the op and its location, which is that of the Torch op it
+  /// was lowered from.
+  std::string kernel;
+  int64_t calls;
+  int64_t nanoseconds;
+  /// The sizes of the memrefs that the kernel read or wrote, summed over the
+  /// calls.
+  int64_t bytes;
+};
+
+/// Returns the time at which an instrumented kernel starts. The instrumented
+/// modules call this as `refbackend_profile_begin`.
+int64_t profileKernelBegin();
+
+/// Records a call to the kernel named `kernel`, which started at `start` and
+/// accessed `bytes` bytes. The instrumented modules call this as
+/// `refbackend_profile_end`.
+void profileKernelEnd(StridedMemRefType<char, 1> *kernel, int64_t start,
+                      int64_t bytes);
+
+/// Returns the profiles of the kernels called so far by all the modules of
+/// the process, from the most to the least time spent.
+std::vector<KernelProfile> getKernelProfiles();
+
+/// Discards the profiles of the kernels called so far.
+void resetKernelProfiles();
+
+/// A kernel of the library that the modules compiled with
+/// `refback-lower-linalg-to-library-calls` call instead of generated loops.
+struct LibraryKernel {
+  /// The name of the function that the modules call, like
+  /// `refbackend_kernel_matmul_f32`.
+  const char *name;
+  /// The implementation of its C interface.
+  void *address;
+};
+
+/// Returns the kernels of the library.
+llvm::ArrayRef<LibraryKernel> getLibraryKernels();
+
+/// The allocator of the modules lowered for GPUs, whose buffers are in managed
+/// memory, which both the host and the kernels access. The modules lowered
+/// by `convert-memref-to-llvm{use-generic-functions=true}` call these
+/// functions as `_mlir_alloc`, `_mlir_aligned_alloc` and `_mlir_free`.
+struct GpuAllocator {
+  void *(*alloc)(uint64_t size);
+  /// Returns null for alignments over 256 bytes, which the managed
+  /// allocations don't guarantee.
+  void *(*alignedAlloc)(uint64_t alignment, uint64_t size);
+  void (*free)(void *ptr);
+};
+
+/// Returns the allocator using the driver of `platform`, `cuda` or `rocm`,
+/// which is loaded on the first call rather than linked to the runtime, or an
+/// error if it cannot be loaded.
+llvm::Expected<GpuAllocator> getGpuAllocator(llvm::StringRef platform);
+
+/// Accumulates the product of `lhs` (M x K) and `rhs` (K x N) into `out`
+/// (M x N), like `linalg.matmul`.
+void matmulKernelF32(StridedMemRefType<float, 2> *lhs,
+                     StridedMemRefType<float, 2> *rhs,
+                     StridedMemRefType<float, 2> *out);
+
+/// Accumulates the products of the matrices of `lhs` (B x M x K) and `rhs`
+/// (B x K x N) into `out` (B x M x N), like `linalg.batch_matmul`.
+void batchMatmulKernelF32(StridedMemRefType<float, 3> *lhs,
+                          StridedMemRefType<float, 3> *rhs,
+                          StridedMemRefType<float, 3> *out);
+
+/// Accumulates the convolution of `input` (N x C x H x W) with `filter`
+/// (F x C x KH x KW) into `out` (N x F x OH x OW), like
+/// `linalg.conv_2d_nchw_fchw` with the given strides and dilations. The
+/// input is already padded.
+void conv2DNchwFchwKernelF32(StridedMemRefType<float, 4> *input,
+                             StridedMemRefType<float, 4> *filter,
+                             StridedMemRefType<float, 4> *out,
+                             int64_t strideH, int64_t strideW,
+                             int64_t dilationH, int64_t dilationW);
+
+} // namespace RefBackend
+} // namespace torch
+} // namespace mlir
+
+#endif // TORCHMLIR_REFBACKEND_RUNTIME_H
@@ -0,0 +1,44 @@
+//===- Context.cpp - C Interface for MLIR contexts ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir-c/Context.h"
+
+#include "mlir/CAPI/IR.h"
+#include "mlir/CAPI/Support.h"
+#include "mlir/Parser/Parser.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
+#include "llvm/Support/ThreadPool.h"
+
+using namespace mlir;
+
+void torchMlirContextUseSharedThreadPool(MlirContext context) {
+  MLIRContext *ctx = unwrap(context);
+  if (!ctx->isMultithreadingEnabled())
+    return;
+  // One thread per core, started on demand.
+  static llvm::ThreadPool sharedThreadPool;
+  if (&ctx->getThreadPool() == &sharedThreadPool)
+    return;
+  // This destroys the thread pool owned by the context, if any.
+  ctx->disableMultithreading();
+  ctx->setThreadPool(sharedThreadPool);
+}
+
+MlirLogicalResult torchMlirContextAddToShapeLibrary(MlirContext context,
+                                                    MlirStringRef functions) {
+  MLIRContext *ctx = unwrap(context);
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(unwrap(functions), ctx);
+  if (!module)
+    return mlirLogicalResultFailure();
+  if (failed(ctx->getOrLoadDialect<torch::Torch::TorchDialect>()
+                 ->addToShapeLibrary(std::move(module))))
+    return mlirLogicalResultFailure();
+  return mlirLogicalResultSuccess();
+}
@@ -0,0 +1,152 @@
+//===- PassManager.cpp - C Interface for the pass manager -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir-c/PassManager.h"
+
+#include "mlir/CAPI/Pass.h"
+#include "mlir/CAPI/Support.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include <chrono>
+#include <mutex>
+
+using namespace mlir;
+
+void torchMlirPassManagerEnableCrashReproducerGeneration(
+    MlirPassManager passManager, MlirStringRef outputFile) {
+  unwrap(passManager)
+      ->enableCrashReproducerGeneration(unwrap(outputFile),
+                                        /*genLocalReproducer=*/false);
+}
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct PassProfile {
+  std::string name;
+  int64_t runs = 0;
+  double seconds = 0;
+  int64_t opsBefore = 0;
+  int64_t opsAfter = 0;
+  std::vector<std::pair<std::string, uint64_t>> statistics;
+};
+
+// Records the profiles of the passes, which the pass manager may run
+// concurrently on different operations.
+class PassProfiler : public PassInstrumentation {
+public:
+  void runBeforePass(Pass *pass, Operation *op) override {
+    if (isAdaptor(pass))
+      return;
+    Run run;
+    run.opsBefore = countOps(op);
+    for (Pass::Statistic *statistic : pass->getStatistics())
+      run.statistics.push_back(statistic->getValue());
+    run.start = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    runs[{pass, op}] = std::move(run);
+  }
+
+  void runAfterPass(Pass *pass, Operation *op) override { record(pass, op); }
+
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    record(pass, op);
+  }
+
+  void forEachPass(TorchMlirPassProfileCallback callback, void *userData) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const PassProfile &profile : profiles) {
+      SmallVector<MlirStringRef> names;
+      SmallVector<uint64_t> values;
+      for (const auto &statistic : profile.statistics) {
+        names.push_back(wrap(StringRef(statistic.first)));
+        values.push_back(statistic.second);
+      }
+      callback(wrap(StringRef(profile.name)), profile.runs, profile.seconds,
+               profile.opsBefore, profile.opsAfter, names.size(),
+               names.data(), values.data(), userData);
+    }
+  }
+
+private:
+  struct Run {
+    Clock::time_point start;
+    int64_t opsBefore;
+    std::vector<uint64_t> statistics;
+  };
+
+  // The adaptors running nested pipelines, which aren't profiled themselves
+  // since the time they take is that of their passes.
+  static bool isAdaptor(Pass *pass) {
+    return pass->getName().endswith("OpToOpPassAdaptor");
+  }
+
+  static int64_t countOps(Operation *op) {
+    int64_t count = 0;
+    op->walk([&](Operation *) { ++count; });
+    return count;
+  }
+
+  void record(Pass *pass, Operation *op) {
+    if (isAdaptor(pass))
+      return;
+    Clock::time_point end = Clock::now();
+    int64_t opsAfter = countOps(op);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = runs.find({pass, op});
+    if (it == runs.end())
+      return;
+    Run run = std::move(it->second);
+    runs.erase(it);
+
+    // The clones of a pass run on other threads share its profile.
+    const Pass *original = pass->getThreadingSiblingOrThis();
+    auto inserted = indices.try_emplace(original, profiles.size());
+    if (inserted.second) {
+      profiles.emplace_back();
+      profiles.back().name = pass->getArgument().empty()
+                                 ? pass->getName().str()
+                                 : pass->getArgument().str();
+    }
+    PassProfile &profile = profiles[inserted.first->second];
+    ++profile.runs;
+    profile.seconds += std::chrono::duration<double>(end - run.start).count();
+    profile.opsBefore += run.opsBefore;
+    profile.opsAfter += opsAfter;
+    ArrayRef<Pass::Statistic *> statistics = pass->getStatistics();
+    profile.statistics.resize(statistics.size());
+    for (auto it : llvm::enumerate(statistics)) {
+      auto &statistic = profile.statistics[it.index()];
+      statistic.first = it.value()->getName();
+      statistic.second += it.value()->getValue() - run.statistics[it.index()];
+    }
+  }
+
+  std::mutex mutex;
+  DenseMap<std::pair<Pass *, Operation *>, Run> runs;
+  DenseMap<const Pass *, size_t> indices;
+  std::vector<PassProfile> profiles;
+};
+} // namespace
+
+TorchMlirPassProfiler
+torchMlirPassManagerEnableProfiling(MlirPassManager passManager) {
+  auto profiler = std::make_unique<PassProfiler>();
+  PassProfiler *result = profiler.get();
+  unwrap(passManager)->addInstrumentation(std::move(profiler));
+  return {result};
+}
+
+void torchMlirPassProfilerForEachPass(TorchMlirPassProfiler profiler,
+                                      TorchMlirPassProfileCallback callback,
+                                      void *userData) {
+  static_cast<PassProfiler *>(profiler.ptr)->forEachPass(callback, userData);
+}
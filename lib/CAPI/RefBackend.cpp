@@ -0,0 +1,166 @@
+//===- RefBackend.cpp - C Interface for the RefBackend --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir-c/RefBackend.h"
+
+#include "mlir/CAPI/IR.h"
+#include "mlir/CAPI/Support.h"
+#include "mlir/ExecutionEngine/OptUtils.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Export.h"
+#include "torch-mlir/RefBackend/Runtime.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Target/TargetMachine.h"
+
+using namespace mlir;
+using namespace mlir::torch::RefBackend;
+
+// Returns a target machine for the host CPU and all its features, which is
+// what the ExecutionEngine compiles for too.
+static std::unique_ptr<llvm::TargetMachine>
+createHostTargetMachine(ModuleOp module) {
+  std::string triple = llvm::sys::getProcessTriple();
+  std::string error;
+  const llvm::Target *target =
+      llvm::TargetRegistry::lookupTarget(triple, error);
+  if (!target) {
+    module.emitError() << "cannot find the host target: " << error;
+    return nullptr;
+  }
+  llvm::SubtargetFeatures features;
+  llvm::StringMap<bool> hostFeatures;
+  if (llvm::sys::getHostCPUFeatures(hostFeatures))
+    for (auto &feature : hostFeatures)
+      features.AddFeature(feature.first(), feature.second);
+  // The object is linked into a shared library, which requires position
+  // independent code, unlike the code that the ExecutionEngine JITs.
+  return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+      triple, llvm::sys::getHostCPUName(), features.getString(),
+      llvm::TargetOptions(), llvm::Reloc::PIC_));
+}
+
+MlirLogicalResult torchMlirRefBackendEmitObjectFile(MlirModule module,
+                                                    MlirStringRef path,
+                                                    int optLevel) {
+  ModuleOp moduleOp = unwrap(module);
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  registerLLVMDialectTranslation(*moduleOp.getContext());
+
+  std::unique_ptr<llvm::TargetMachine> targetMachine =
+      createHostTargetMachine(moduleOp);
+  if (!targetMachine)
+    return mlirLogicalResultFailure();
+
+  llvm::LLVMContext llvmContext;
+  std::unique_ptr<llvm::Module> llvmModule =
+      translateModuleToLLVMIR(moduleOp, llvmContext);
+  if (!llvmModule) {
+    moduleOp.emitError() << "failed to translate the module to LLVM IR";
+    return mlirLogicalResultFailure();
+  }
+  llvmModule->setTargetTriple(targetMachine->getTargetTriple().str());
+  llvmModule->setDataLayout(targetMachine->createDataLayout());
+
+  auto transformer = makeOptimizingTransformer(optLevel, /*sizeLevel=*/0,
+                                               targetMachine.get());
+  if (llvm::Error error = transformer(llvmModule.get())) {
+    moduleOp.emitError() << "failed to optimize the LLVM IR: "
+                         << llvm::toString(std::move(error));
+    return mlirLogicalResultFailure();
+  }
+
+  std::error_code errorCode;
+  llvm::ToolOutputFile output(unwrap(path), errorCode, llvm::sys::fs::OF_None);
+  if (errorCode) {
+    moduleOp.emitError() << "cannot open '" << unwrap(path)
+                         << "': " << errorCode.message();
+    return mlirLogicalResultFailure();
+  }
+  llvm::legacy::PassManager codegenPasses;
+  if (targetMachine->addPassesToEmitFile(codegenPasses, output.os(),
+                                         /*DwoOut=*/nullptr,
+                                         llvm::CGFT_ObjectFile)) {
+    moduleOp.emitError() << "the host target cannot emit object files";
+    return mlirLogicalResultFailure();
+  }
+  codegenPasses.run(*llvmModule);
+  output.keep();
+  return mlirLogicalResultSuccess();
+}
+
+void torchMlirRefBackendInvokePackedBatch(void (*function)(void **),
+                                          void ***packedArgs,
+                                          intptr_t numCalls, int numThreads) {
+  if (numThreads <= 1 || numCalls <= 1) {
+    for (intptr_t i = 0; i < numCalls; i++)
+      function(packedArgs[i]);
+    return;
+  }
+  // Each thread runs a contiguous chunk of the calls.
+  intptr_t numChunks = std::min<intptr_t>(numThreads, numCalls);
+  intptr_t chunkSize = (numCalls + numChunks - 1) / numChunks;
+  llvm::ThreadPool pool(llvm::hardware_concurrency(numChunks));
+  for (intptr_t begin = 0; begin < numCalls; begin += chunkSize) {
+    intptr_t end = std::min(begin + chunkSize, numCalls);
+    pool.async([=] {
+      for (intptr_t i = begin; i < end; i++)
+        function(packedArgs[i]);
+    });
+  }
+  pool.wait();
+}
+
+void torchMlirRefBackendGetProfilingFunctions(void **begin, void **end) {
+  *begin = reinterpret_cast<void *>(&profileKernelBegin);
+  *end = reinterpret_cast<void *>(&profileKernelEnd);
+}
+
+void torchMlirRefBackendForEachKernelProfile(
+    void (*callback)(MlirStringRef kernel, int64_t calls, int64_t nanoseconds,
+                     int64_t bytes, void *userData),
+    void *userData) {
+  for (const KernelProfile &profile : getKernelProfiles())
+    callback(wrap(StringRef(profile.kernel)), profile.calls,
+             profile.nanoseconds, profile.bytes, userData);
+}
+
+void torchMlirRefBackendResetKernelProfiles() { resetKernelProfiles(); }
+
+void torchMlirRefBackendForEachLibraryKernel(
+    void (*callback)(MlirStringRef name, void *address, void *userData),
+    void *userData) {
+  for (const LibraryKernel &kernel : getLibraryKernels())
+    callback(mlirStringRefCreateFromCString(kernel.name), kernel.address,
+             userData);
+}
+
+MlirLogicalResult torchMlirRefBackendGetGpuAllocator(
+    MlirStringRef platform, void **alloc, void **alignedAlloc, void **free,
+    MlirStringCallback onError, void *userData) {
+  llvm::Expected<GpuAllocator> allocator = getGpuAllocator(unwrap(platform));
+  if (!allocator) {
+    std::string message = llvm::toString(allocator.takeError());
+    onError(wrap(StringRef(message)), userData);
+    return mlirLogicalResultFailure();
+  }
+  *alloc = reinterpret_cast<void *>(allocator->alloc);
+  *alignedAlloc = reinterpret_cast<void *>(allocator->alignedAlloc);
+  *free = reinterpret_cast<void *>(allocator->free);
+  return mlirLogicalResultSuccess();
+}
@@ -16,8 +16,12 @@
 #include "torch-mlir/InitAll.h"
 
 void torchMlirRegisterAllDialects(MlirContext context) {
-  mlir::DialectRegistry registry;
-  mlir::torch::registerAllDialects(registry);
+  // Every context registers the same dialects, so build the registry once.
+  static const mlir::DialectRegistry registry = [] {
+    mlir::DialectRegistry registry;
+    mlir::torch::registerAllDialects(registry);
+    return registry;
+  }();
   unwrap(context)->appendDialectRegistry(registry);
   // TODO: Don't eagerly load once D88162 is in and clients can do this.
   unwrap(context)->loadAllAvailableDialects();
@@ -11,8 +11,11 @@
 
 #include "mlir/CAPI/IR.h"
 #include "mlir/CAPI/Support.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Utils/TorchUpstream.h"
+#include "llvm/ADT/ScopeExit.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -73,3 +76,138 @@ MlirValue torchMlirAdjustStaticInformation(MlirBlock block_,
   // No known adjustment.
   return {};
 }
+
+//===----------------------------------------------------------------------===//
+// Tensor literals
+//===----------------------------------------------------------------------===//
+
+// Returns the element type of the elements attributes of the literals of
+// `scalarType`, which is signed or unsigned like the importer's, or null if
+// the scalar type isn't supported.
+static Type getLiteralElementType(MLIRContext *context,
+                                  torch_upstream::ScalarType scalarType) {
+  using torch_upstream::ScalarType;
+  switch (scalarType) {
+  case ScalarType::Byte:
+    return IntegerType::get(context, 8, IntegerType::Unsigned);
+  case ScalarType::Char:
+    return IntegerType::get(context, 8, IntegerType::Signed);
+  case ScalarType::Short:
+    return IntegerType::get(context, 16, IntegerType::Signed);
+  case ScalarType::Int:
+    return IntegerType::get(context, 32, IntegerType::Signed);
+  case ScalarType::Long:
+    return IntegerType::get(context, 64, IntegerType::Signed);
+  case ScalarType::Bool:
+    return IntegerType::get(context, 1);
+  case ScalarType::Double:
+    return Float64Type::get(context);
+  case ScalarType::Float:
+    return Float32Type::get(context);
+  case ScalarType::BFloat16:
+    return BFloat16Type::get(context);
+  case ScalarType::Half:
+    return Float16Type::get(context);
+  case ScalarType::QInt8:
+    return Torch::QInt8Type::get(context);
+  case ScalarType::QUInt8:
+    return Torch::QUInt8Type::get(context);
+  default:
+    return nullptr;
+  }
+}
+
+// Returns the size in bytes of an element of `elementType` in an
+// `at::Tensor`.
+static int64_t getTorchElementSize(Type elementType) {
+  if (elementType.isa<Torch::QInt8Type, Torch::QUInt8Type>())
+    return 1;
+  return std::max<int64_t>(elementType.getIntOrFloatBitWidth() / 8, 1);
+}
+
+MlirAttribute torchMlirTensorLiteralElementsGet(
+    MlirLocation loc_, intptr_t rank, const int64_t *shape, int8_t scalarType,
+    size_t numBytes, const void *data, TorchMlirBufferDeleter deleter,
+    void *userData) {
+  // The attribute owns a copy of the data, so the buffer is released
+  // whichever way this returns.
+  auto releaseBuffer = llvm::make_scope_exit([&]() {
+    if (deleter)
+      deleter(userData);
+  });
+  Location loc = unwrap(loc_);
+  MLIRContext *context = loc.getContext();
+
+  Type elementType = getLiteralElementType(
+      context, static_cast<torch_upstream::ScalarType>(scalarType));
+  if (!elementType) {
+    emitError(loc) << "unsupported scalar type for a tensor literal: "
+                   << static_cast<int>(scalarType);
+    return {nullptr};
+  }
+  // The quantized types are stored as the integers they are made of, and the
+  // op that imports the literal gives them their quantization scheme.
+  Type storageType = elementType;
+  if (elementType.isa<Torch::QInt8Type>())
+    storageType = IntegerType::get(context, 8, IntegerType::Signed);
+  else if (elementType.isa<Torch::QUInt8Type>())
+    storageType = IntegerType::get(context, 8, IntegerType::Unsigned);
+  ArrayRef<int64_t> sizes(shape, rank);
+  auto shapedType = RankedTensorType::getChecked(
+      [&]() { return emitError(loc); }, sizes, storageType);
+  if (!shapedType)
+    return {nullptr};
+
+  int64_t numElements = shapedType.getNumElements();
+  if (static_cast<int64_t>(numBytes) !=
+      numElements * getTorchElementSize(elementType)) {
+    emitError(loc) << "expected " << numElements
+                   << " elements for a tensor literal of type " << shapedType
+                   << ", but got " << numBytes << " bytes";
+    return {nullptr};
+  }
+
+  auto rawData = static_cast<const char *>(data);
+  if (!elementType.isInteger(1)) {
+    // The in-memory layout of the other dtypes is exactly the raw storage
+    // format of DenseElementsAttr, so the data is loaded in bulk instead of
+    // element by element.
+    return wrap(DenseElementsAttr::getFromRawBuffer(
+        shapedType, ArrayRef<char>(rawData, numBytes)));
+  }
+
+  // DenseElementsAttr stores i1 elements bit-packed (LSB first), so pack the
+  // one-byte-per-element bool storage into that format. A splat is encoded
+  // as a single all-zeros or all-ones byte.
+  auto boolData = reinterpret_cast<const uint8_t *>(rawData);
+  bool isSplat =
+      numElements > 0 &&
+      std::all_of(boolData, boolData + numElements, [&](uint8_t b) {
+        return (b != 0) == (boolData[0] != 0);
+      });
+  SmallVector<char> packed;
+  if (isSplat) {
+    packed.push_back(boolData[0] ? 0xff : 0x00);
+  } else {
+    packed.resize((numElements + 7) / 8, 0);
+    for (int64_t i = 0; i < numElements; i++) {
+      if (boolData[i])
+        packed[i / 8] |= 1 << (i % 8);
+    }
+  }
+  return wrap(DenseElementsAttr::getFromRawBuffer(shapedType, packed));
+}
+
+MlirOperation torchMlirTensorLiteralCreate(MlirLocation loc,
+                                           MlirAttribute elements,
+                                           bool valueSemantics) {
+  OpBuilder builder(unwrap(mlirLocationGetContext(loc)));
+  auto value = unwrap(elements).cast<ElementsAttr>();
+  if (valueSemantics)
+    return wrap(
+        builder.create<Torch::ValueTensorLiteralOp>(unwrap(loc), value)
+            .getOperation());
+  return wrap(
+      builder.create<Torch::NonValueTensorLiteralOp>(unwrap(loc), value)
+          .getOperation());
+}
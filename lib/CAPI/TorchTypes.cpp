@@ -215,7 +215,8 @@ MlirType torchMlirTorchNonValueTensorTypeGetFromAttribute(MlirAttribute attr) {
   auto attrTensorType = unwrap(attr).getType().cast<RankedTensorType>();
   return wrap(Torch::NonValueTensorType::get(attrTensorType.getContext(),
                                              attrTensorType.getShape(),
-                                             attrTensorType.getElementType()));
+                                             attrTensorType.getElementType(),
+                                             attrTensorType.getEncoding()));
 }
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/Conversion/TorchToLinalg/TorchToLinalg.h"
+
+#include "../PassDetail.h"
+#include "PopulatePatterns.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "torch-mlir/Conversion/Utils/Utils.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+namespace {
+// Lowers a call to a custom kernel to a `torch_c.call_kernel` writing into
+// tensors of the shapes computed by the shape function of the op.
+class ConvertCustomKernelCall : public OpConversionPattern<OperatorOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(OperatorOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    StringRef kernel = getCustomKernel(op);
+    if (kernel.empty())
+      return rewriter.notifyMatchFailure(op, "not a call to a custom kernel");
+    OperandRange resultShapes = getCustomKernelResultShapes(op);
+    if (resultShapes.size() != op->getNumResults())
+      return rewriter.notifyMatchFailure(
+          op, "the shapes of the results are not attached");
+
+    Location loc = op.getLoc();
+    ValueRange inputs = adaptor.getOperands().take_front(
+        getCustomKernelInputs(op).size());
+    for (Value input : inputs) {
+      Type type = input.getType();
+      if (!type.isa<RankedTensorType>() && !type.isInteger(64) && !type.isF64())
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: inputs other than tensors, ints and floats");
+    }
+
+    SmallVector<Value> outputs;
+    SmallVector<Type> resultTypes;
+    for (auto it : llvm::zip(op->getResults(), resultShapes)) {
+      auto resultType = getTypeConverter()
+                            ->convertType(std::get<0>(it).getType())
+                            .dyn_cast_or_null<RankedTensorType>();
+      if (!resultType)
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: results other than ranked tensors");
+      SmallVector<Value> sizes;
+      if (!getListConstructElements(std::get<1>(it), sizes))
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: the result shapes must be list constructs");
+      sizes = getTypeConvertedValues(rewriter, loc, getTypeConverter(), sizes);
+      for (Value &size : sizes)
+        size = castIntToIndex(rewriter, loc, size);
+      Value initTensor = rewriter.create<linalg::InitTensorOp>(
+          loc, sizes, resultType.getElementType());
+      outputs.push_back(
+          rewriter.create<tensor::CastOp>(loc, resultType, initTensor));
+      resultTypes.push_back(resultType);
+    }
+
+    rewriter.replaceOpWithNewOp<TorchConversion::CallKernelOp>(
+        op, resultTypes, kernel, inputs, outputs);
+    return success();
+  }
+};
+} // namespace
+
+void mlir::torch::torch_to_linalg::populateCustomKernelsPatternsAndLegality(
+    TypeConverter &typeConverter, RewritePatternSet &patterns,
+    ConversionTarget &target) {
+  MLIRContext *context = patterns.getContext();
+  target.addLegalOp<TorchConversion::CallKernelOp>();
+  target.addDynamicallyLegalOp<OperatorOp>(
+      [](OperatorOp op) { return getCustomKernel(op).empty(); });
+  patterns.add<ConvertCustomKernelCall>(typeConverter, context);
+}
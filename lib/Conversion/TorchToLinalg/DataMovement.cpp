@@ -86,10 +86,14 @@ public:
 } // namespace
 
 namespace {
-/// The `ConvertAtenViewOp` conversion pattern converts `aten.View` op to
-/// `linalg.TensorExpandShape` op only when one or multiple static dimensions
-/// are expanded. All the other cases of `aten.View` op need to be handled.
-/// TODO: Handle all the other cases of `aten.View` op.
+/// The `ConvertAtenViewOp` conversion pattern converts `aten.view` op to
+/// `tensor.expand_shape` or `tensor.collapse_shape` when the view only expands
+/// or only collapses groups of dimensions that can be identified from the size
+/// list and the static shape of the input. All the other views, including
+/// ones of dynamic dimensions that are neither grouped nor split statically
+/// and ones with a `-1` dimension that can only be inferred at runtime, are
+/// converted to `tensor.reshape` with a shape computed at runtime. Value
+/// tensors are contiguous, so none of these copy data.
 class ConvertAtenViewOp : public OpConversionPattern<AtenViewOp> {
 public:
   using OpConversionPattern::OpConversionPattern;
@@ -101,24 +105,11 @@ public:
     Location loc = op.getLoc();
     Value input = adaptor.self();
     auto inputType = input.getType().cast<RankedTensorType>();
-    ArrayRef<int64_t> inputShape = inputType.getShape();
     int64_t inputRank = inputType.getRank();
     TypeConverter *typeConverter = getTypeConverter();
     auto resultType =
         typeConverter->convertType(op.getType()).cast<RankedTensorType>();
     int64_t resultRank = resultType.getRank();
-    if (resultRank == 0)
-      return rewriter.notifyMatchFailure(op,
-                                         "result shape of rank 0 is invalid");
-
-    // TODO: add support for case inputRank 0 expanded to size 1
-    if (inputRank == 0)
-      return rewriter.notifyMatchFailure(
-          op, "unimplemented: input rank 0 is not supported");
-
-    bool isCollapse = inputRank > resultRank ? true : false;
-    int64_t collapsedRank = isCollapse ? resultRank : inputRank;
-    int64_t expandedRank = isCollapse ? inputRank : resultRank;
 
     // Extract the desired output size as a list of integers. This list should
     // have been created using the operation `torch.prim.ListConstruct`.
@@ -135,29 +126,151 @@ public:
           op, "desired size list length mismatches with the result type rank");
     }
 
+    // A tensor of a single element is viewed as another one by adding or
+    // removing unit dimensions.
+    if (inputRank == 0 || resultRank == 0) {
+      Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+      for (int64_t i = 0; i < inputRank; i++) {
+        if (inputType.isDynamicDim(i))
+          checkDimEqualHelper(rewriter, loc, getDimOp(rewriter, loc, input, i),
+                              one);
+      }
+      auto unitType = [&](int64_t rank) {
+        return RankedTensorType::get(SmallVector<int64_t>(rank, 1),
+                                     resultType.getElementType());
+      };
+      Value unitInput =
+          rewriter.create<tensor::CastOp>(loc, unitType(inputRank), input);
+      SmallVector<ReassociationIndices> reassociation;
+      Value result =
+          inputRank == 0
+              ? rewriter
+                    .create<tensor::ExpandShapeOp>(loc, unitType(resultRank),
+                                                   unitInput, reassociation)
+                    .result()
+              : rewriter
+                    .create<tensor::CollapseShapeOp>(loc, unitType(resultRank),
+                                                     unitInput, reassociation)
+                    .result();
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+      return success();
+    }
+
+    // A view of the same rank either changes no dimension, or both expands
+    // and collapses some.
+    FailureOr<Value> result = failure();
+    if (inputRank == resultRank) {
+      if (isStaticallyIdentity(op, inputType, outputSizeTorchInt)) {
+        rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, input);
+        return success();
+      }
+    } else {
+      result = createExpandOrCollapse(op, input, outputSizeTorchInt,
+                                      outputSizeInt, rewriter);
+    }
+    if (failed(result))
+      result = createReshape(op, input, outputSizeTorchInt, outputSizeInt,
+                             resultType, rewriter);
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, *result);
+    return success();
+  }
+
+private:
+  /// Whether the view of `inputType` with the same rank is known to not
+  /// change any dimension, because all of its sizes but at most one `-1` are
+  /// either the corresponding sizes of the input or equal static sizes.
+  static bool isStaticallyIdentity(AtenViewOp op, RankedTensorType inputType,
+                                   ArrayRef<Value> outputSizeTorchInt) {
+    bool hasInferredDim = false;
+    for (auto en : llvm::enumerate(outputSizeTorchInt)) {
+      int64_t inputDim;
+      int64_t size;
+      if (matchPattern(en.value(),
+                       m_TorchTensorSizeInt(op.self(), &inputDim)) &&
+          inputDim == (int64_t)en.index())
+        continue;
+      if (!matchPattern(en.value(), m_TorchConstantInt(&size)))
+        return false;
+      if (size == -1 && !hasInferredDim) {
+        hasInferredDim = true;
+        continue;
+      }
+      if (size != inputType.getDimSize(en.index()))
+        return false;
+    }
+    return true;
+  }
+
+  /// Creates a `tensor.reshape` of `input` to the sizes `outputSizeInt`, where
+  /// a `-1` size is computed from the number of elements of `input`.
+  Value createReshape(AtenViewOp op, Value input,
+                      ArrayRef<Value> outputSizeTorchInt,
+                      ArrayRef<Value> outputSizeInt,
+                      RankedTensorType resultType,
+                      ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    Value numElements = getTensorSize(rewriter, loc, input);
+    Value one = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getI64IntegerAttr(1));
+    Value knownNumElements = one;
+    llvm::Optional<int64_t> inferredDim;
+    SmallVector<Value> sizes(outputSizeInt.begin(), outputSizeInt.end());
+    for (auto en : llvm::enumerate(outputSizeTorchInt)) {
+      int64_t size;
+      if (!inferredDim && matchPattern(en.value(), m_TorchConstantInt(&size)) &&
+          size == -1) {
+        inferredDim = en.index();
+        continue;
+      }
+      knownNumElements = rewriter.create<arith::MulIOp>(loc, knownNumElements,
+                                                        sizes[en.index()]);
+    }
+    if (inferredDim) {
+      sizes[*inferredDim] =
+          rewriter.create<arith::DivSIOp>(loc, numElements, knownNumElements);
+      knownNumElements = rewriter.create<arith::MulIOp>(
+          loc, knownNumElements, sizes[*inferredDim]);
+    }
+    Value isValidShape = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, numElements, knownNumElements);
+    rewriter.create<cf::AssertOp>(
+        loc, isValidShape,
+        rewriter.getStringAttr(
+            "desired size is not compatible with the input tensor size"));
+
+    for (Value &size : sizes)
+      size = castIntToIndex(rewriter, loc, size);
+    Value shape = rewriter.create<tensor::FromElementsOp>(loc, sizes);
+    return rewriter.create<tensor::ReshapeOp>(loc, resultType, input, shape);
+  }
+
+  /// Creates a `tensor.expand_shape` or `tensor.collapse_shape` of `input` for
+  /// the view `op`, or returns failure if the groups of dimensions that are
+  /// collapsed or expanded can't be determined statically.
+  FailureOr<Value>
+  createExpandOrCollapse(AtenViewOp op, Value input,
+                         ArrayRef<Value> outputSizeTorchInt,
+                         ArrayRef<Value> outputSizeInt,
+                         ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    auto inputType = input.getType().cast<RankedTensorType>();
+    ArrayRef<int64_t> inputShape = inputType.getShape();
+    int64_t inputRank = inputType.getRank();
+    int64_t resultRank = outputSizeInt.size();
+    Type elementType = inputType.getElementType();
+
+    bool isCollapse = inputRank > resultRank ? true : false;
+    int64_t collapsedRank = isCollapse ? resultRank : inputRank;
+    int64_t expandedRank = isCollapse ? inputRank : resultRank;
+
     SmallVector<Value> inputSize = getTensorSizes(rewriter, loc, input);
     ArrayRef<Value> expandedShapeInt =
-        llvm::makeArrayRef(isCollapse ? inputSize : outputSizeInt);
+        isCollapse ? llvm::makeArrayRef(inputSize) : outputSizeInt;
     ArrayRef<Value> collapsedShapeInt =
-        llvm::makeArrayRef(isCollapse ? outputSizeInt : inputSize);
-
-    // Currently, we only handle the expanding or collapsing cases or the
-    // identity cases where the rank and shape of the input and result are
-    // equal, and the input itself is the result. We do not handle expanding And
-    // collapsing happening at the same time or cases where it's neither
-    // collapsing nor expanding like view of [2,3] for 3x2 tensor.
-    // TODO: For the expanding And collapsing case, we will need to identify
-    // which dimensions are collapsing and which are expanding and do it in two
-    // steps.
-    // TODO: For neither collapsing nor expanding, we could find a intermediate
-    // shape to collapse and then expanded to the target shape. Like [2,3] =>
-    // [6] => [3, 2].
-    if (inputRank == resultRank) {
-      for (unsigned i = 0; i < inputRank; i++)
-        checkDimEqualHelper(rewriter, loc, inputSize[i], outputSizeInt[i]);
-      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, input);
-      return success();
-    }
+        isCollapse ? outputSizeInt : llvm::makeArrayRef(inputSize);
+    // The runtime checks are only created once the reassociation is known to
+    // be valid.
+    SmallVector<std::pair<Value, Value>> dimEqualities;
 
     // Iterate through the view op size list to do the following:
     //
@@ -262,8 +375,9 @@ public:
       // is unchanged.
       if (!reassociation[collapsedDim].empty()) {
         if (expandedDim != reassociation[collapsedDim][0])
-          return op.emitOpError("Unsupported: expanded dims are off from the "
-                                "expected dim got from reassociation");
+          return rewriter.notifyMatchFailure(
+              op, "expanded dims are off from the expected dim got from "
+                  "reassociation");
         collapsedDim++;
         expandedDim++;
         continue;
@@ -304,8 +418,8 @@ public:
 
       // collpasedDims are expanded to [expandedDim, expandedDimNext)
       if (expandedDimNext - expandedDim < (int64_t)collapsedDims.size())
-        op.emitError("unimplemented: mixed of expanding and collapsing "
-                     "operations for view");
+        return rewriter.notifyMatchFailure(
+            op, "mixed expanding and collapsing operations for view");
       for (auto collapsedDim : collapsedDims) {
         if (collapsedShape[collapsedDim] == kUnknownSize) {
           if (expandedDim >= expandedDimNext) {
@@ -313,8 +427,8 @@ public:
                 op,
                 "desired size is not compatible with the input tensor size");
           }
-          checkDimEqualHelper(rewriter, loc, collapsedShapeInt[collapsedDim],
-                              expandedShapeInt[expandedDim]);
+          dimEqualities.emplace_back(collapsedShapeInt[collapsedDim],
+                                     expandedShapeInt[expandedDim]);
           // To meet the second requirement from tensor.expand_shape
           // verification code.
           expandedShape[expandedDim] = kUnknownSize;
@@ -352,26 +466,23 @@ public:
 
     if (collapsedDim != collapsedRank || expandedDim != expandedRank)
       return rewriter.notifyMatchFailure(op, "view shape is not supported");
-    Type adjustedResultType =
-        RankedTensorType::get(isCollapse ? collapsedShape : expandedShape,
-                              resultType.getElementType());
-    Type adjustedInputType =
-        RankedTensorType::get(isCollapse ? expandedShape : collapsedShape,
-                              resultType.getElementType());
+    for (auto &dimEquality : dimEqualities)
+      checkDimEqualHelper(rewriter, loc, dimEquality.first, dimEquality.second);
+    Type adjustedResultType = RankedTensorType::get(
+        isCollapse ? collapsedShape : expandedShape, elementType);
+    Type adjustedInputType = RankedTensorType::get(
+        isCollapse ? expandedShape : collapsedShape, elementType);
     Value castedInput =
         rewriter.create<tensor::CastOp>(loc, adjustedInputType, input);
-    Value result =
-        isCollapse
-            ? rewriter
-                  .create<tensor::CollapseShapeOp>(loc, adjustedResultType,
-                                                   castedInput, reassociation)
-                  .result()
-            : rewriter
-                  .create<tensor::ExpandShapeOp>(loc, adjustedResultType,
-                                                 castedInput, reassociation)
-                  .result();
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
-    return success();
+    if (isCollapse)
+      return rewriter
+          .create<tensor::CollapseShapeOp>(loc, adjustedResultType,
+                                           castedInput, reassociation)
+          .result();
+    return rewriter
+        .create<tensor::ExpandShapeOp>(loc, adjustedResultType, castedInput,
+                                       reassociation)
+        .result();
   }
 };
 } // namespace
@@ -728,6 +839,96 @@ public:
 };
 } // namespace
 
+// Computes the offsets, sizes and strides of the `tensor.extract_slice` or
+// `tensor.insert_slice` that `op`, whose operands are those of
+// `aten.slice.Tensor` after `self`, reads or writes of `input`.
+template <typename OpTy, typename OpAdaptor>
+static LogicalResult
+prepareArgumentsForSlicingOp(OpTy op, OpAdaptor adaptor, Value input,
+                             ConversionPatternRewriter &rewriter,
+                             SmallVector<Value> &resultShape,
+                             SmallVector<Value> &offsets,
+                             SmallVector<Value> &strides) {
+  Location loc = op.getLoc();
+  RankedTensorType inputType = input.getType().cast<RankedTensorType>();
+  Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+
+  int64_t dim;
+  if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
+    return op->emitError("unimplemented: dim is not constant");
+
+  SmallVector<Value> inputShape = getTensorSizes(rewriter, loc, input);
+  Value dimSize = inputShape[dim];
+
+  auto adjustStartOrEnd = [&](Value startOrEndTorchType,
+                              Value startOrEndBuiltin, Value valueForNone) {
+    if (startOrEndTorchType.getType().isa<Torch::NoneType>())
+      return valueForNone;
+    // Only emit the normalization and clamping that can't be proven to be
+    // no-ops from the range of `startOrEnd`.
+    IntRange range = getIntRange(startOrEndTorchType);
+    int64_t staticDimSize = inputType.getDimSize(dim);
+    auto dimSizeAsInt = castIndexToInt64(rewriter, loc, dimSize);
+    Value startOrEndAtLeastZero = startOrEndBuiltin;
+    if (!range.isNonNegative()) {
+      Value startOrEndToPositive = toPositiveDimDynamic(
+          rewriter, loc, startOrEndBuiltin, dimSizeAsInt);
+      // startOrEnd < 0 ? 0 : startOrEnd
+      Value cst0 = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getZeroAttr(dimSizeAsInt.getType()));
+      Value predDimSltZero = rewriter.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::slt, startOrEndToPositive, cst0);
+      startOrEndAtLeastZero = rewriter.create<arith::SelectOp>(
+          loc, predDimSltZero, cst0, startOrEndToPositive);
+    }
+    if (range.isNonNegative() && staticDimSize != ShapedType::kDynamicSize &&
+        range.max <= staticDimSize)
+      return castIntToIndex(rewriter, loc, startOrEndAtLeastZero);
+    // startOrEnd > dimSizeAsInt ? dimSizeAsInt : startOrEnd
+    Value startOrEndSgtDimSize = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::sgt, startOrEndAtLeastZero, dimSizeAsInt);
+    Value startOrEndBoundedByDimSize = rewriter.create<arith::SelectOp>(
+        loc, startOrEndSgtDimSize, dimSizeAsInt, startOrEndAtLeastZero);
+
+    return castIntToIndex(rewriter, loc, startOrEndBoundedByDimSize);
+  };
+
+  if (op.start().getType().template isa<OptionalType>() ||
+      op.end().getType().template isa<OptionalType>())
+    return rewriter.notifyMatchFailure(op, "unimplemented optional type arg");
+  Value start = adjustStartOrEnd(op.start(), adaptor.start(), zero);
+  Value end = adjustStartOrEnd(op.end(), adaptor.end(), dimSize);
+
+  // end >= start ? end : start
+  Value endSgeStart = rewriter.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::sge, end, start);
+  end = rewriter.create<arith::SelectOp>(loc, endSgeStart, end, start);
+
+  int64_t step;
+  if (!matchPattern(op.step(), m_TorchConstantInt(&step))) {
+    if (!op.step().getType().template isa<Torch::NoneType>())
+      return op->emitError("unimplemented: step is not constant");
+    step = 1;
+  }
+
+  // Slice logic: resultSize = floordiv(end - start + step - 1,  step)
+  Value stepIndex = rewriter.create<arith::ConstantIndexOp>(loc, step);
+  Value len = rewriter.create<arith::SubIOp>(loc, end, start);
+  Value resultSize = rewriter.create<arith::AddIOp>(loc, len, stepIndex);
+  resultSize = rewriter.create<arith::SubIOp>(loc, resultSize, one);
+  resultSize = rewriter.create<arith::FloorDivSIOp>(loc, resultSize, stepIndex);
+
+  resultShape = getTensorSizes(rewriter, loc, input);
+  resultShape[dim] = resultSize;
+
+  offsets.assign(inputType.getRank(), zero);
+  strides.assign(inputType.getRank(), one);
+  offsets[dim] = start;
+  strides[dim] = rewriter.create<arith::MulIOp>(loc, strides[dim], stepIndex);
+  return success();
+}
+
 namespace {
 class ConvertAtenSliceTensorOp : public OpConversionPattern<AtenSliceTensorOp> {
 public:
@@ -742,79 +943,76 @@ public:
     TypeConverter *typeConverter = getTypeConverter();
 
     auto input = adaptor.self();
-    RankedTensorType inputType = input.getType().cast<RankedTensorType>();
     RankedTensorType resultType =
         typeConverter->convertType(op->getResult(0).getType())
             .cast<RankedTensorType>();
-    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
-    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
 
-    int64_t dim;
-    if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
-      return op->emitError("unimplemented: dim is not constant");
-
-    SmallVector<Value> inputShape = getTensorSizes(rewriter, loc, input);
-    Value dimSize = inputShape[dim];
-
-    auto adjustStartOrEnd = [&](Value startOrEndTorchType,
-                                Value startOrEndBuiltin, Value valueForNone) {
-      if (startOrEndTorchType.getType().isa<Torch::NoneType>())
-        return valueForNone;
-      auto dimSizeAsInt = castIndexToInt64(rewriter, loc, dimSize);
-      Value startOrEndToPositive =
-          toPositiveDimDynamic(rewriter, loc, startOrEndBuiltin, dimSizeAsInt);
-      // startOrEnd < 0 ? 0 : startOrEnd
-      Value cst0 = rewriter.create<arith::ConstantOp>(
-          loc, rewriter.getZeroAttr(dimSizeAsInt.getType()));
-      Value predDimSltZero = rewriter.create<arith::CmpIOp>(
-          loc, arith::CmpIPredicate::slt, startOrEndToPositive, cst0);
-      Value startOrEndAtLeastZero = rewriter.create<arith::SelectOp>(
-          loc, predDimSltZero, cst0, startOrEndToPositive);
-      // startOrEnd > dimSizeAsInt ? dimSizeAsInt : startOrEnd
-      Value startOrEndSgtDimSize = rewriter.create<arith::CmpIOp>(
-          loc, arith::CmpIPredicate::sgt, startOrEndAtLeastZero, dimSizeAsInt);
-      Value startOrEndBoundedByDimSize = rewriter.create<arith::SelectOp>(
-          loc, startOrEndSgtDimSize, dimSizeAsInt, startOrEndAtLeastZero);
+    SmallVector<Value> resultShape, offsets, strides;
+    if (failed(prepareArgumentsForSlicingOp(op, adaptor, input, rewriter,
+                                            resultShape, offsets, strides)))
+      return failure();
 
-      return castIntToIndex(rewriter, loc, startOrEndBoundedByDimSize);
-    };
+    Value result = rewriter.create<tensor::ExtractSliceOp>(
+        loc, input, offsets, resultShape, strides);
 
-    if (op.start().getType().isa<OptionalType>() ||
-        op.end().getType().isa<OptionalType>())
-      return rewriter.notifyMatchFailure(op, "unimplemented optional type arg");
-    Value start = adjustStartOrEnd(op.start(), adaptor.start(), zero);
-    Value end = adjustStartOrEnd(op.end(), adaptor.end(), dimSize);
-
-    // end >= start ? end : start
-    Value endSgeStart = rewriter.create<arith::CmpIOp>(
-        loc, arith::CmpIPredicate::sge, end, start);
-    end = rewriter.create<arith::SelectOp>(loc, endSgeStart, end, start);
-
-    int64_t step;
-    if (!matchPattern(op.step(), m_TorchConstantInt(&step))) {
-      if (!op.step().getType().isa<Torch::NoneType>())
-        return op->emitError("unimplemented: step is not constant");
-      step = 1;
-    }
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+    return success();
+  }
+};
+} // namespace
 
-    // Slice logic: resultSize = floordiv(end - start + step - 1,  step)
-    Value stepIndex = rewriter.create<arith::ConstantIndexOp>(loc, step);
-    Value len = rewriter.create<arith::SubIOp>(loc, end, start);
-    Value resultSize = rewriter.create<arith::AddIOp>(loc, len, stepIndex);
-    resultSize = rewriter.create<arith::SubIOp>(loc, resultSize, one);
-    resultSize =
-        rewriter.create<arith::FloorDivSIOp>(loc, resultSize, stepIndex);
+namespace {
+// `aten.slice_scatter` is lowered to a `tensor.insert_slice` of `src` into
+// `self`. One-shot bufferization updates `self` in place when it has no other
+// uses, so that only the slice is written, while the per-dialect
+// bufferization of the default RefBackend pipeline still copies `self`.
+class ConvertAtenSliceScatterOp
+    : public OpConversionPattern<AtenSliceScatterOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenSliceScatterOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
 
-    SmallVector<Value> resultShape = getTensorSizes(rewriter, loc, input);
-    resultShape[dim] = resultSize;
+    Location loc = op.getLoc();
+    TypeConverter *typeConverter = getTypeConverter();
 
-    SmallVector<Value> offsets(inputType.getRank(), zero);
-    SmallVector<Value> strides(inputType.getRank(), one);
-    offsets[dim] = start;
-    strides[dim] = rewriter.create<arith::MulIOp>(loc, strides[dim], stepIndex);
+    Value input = adaptor.self();
+    Value src = adaptor.src();
+    RankedTensorType inputType = input.getType().cast<RankedTensorType>();
+    RankedTensorType srcType = src.getType().cast<RankedTensorType>();
+    RankedTensorType resultType =
+        typeConverter->convertType(op->getResult(0).getType())
+            .cast<RankedTensorType>();
+    if (srcType.getRank() != inputType.getRank())
+      return rewriter.notifyMatchFailure(op,
+                                         "src must have the rank of self");
+    if (srcType.getElementType() != inputType.getElementType())
+      return rewriter.notifyMatchFailure(
+          op, "src must have the element type of self");
 
-    Value result = rewriter.create<tensor::ExtractSliceOp>(
-        loc, input, offsets, resultShape, strides);
+    SmallVector<Value> resultShape, offsets, strides;
+    if (failed(prepareArgumentsForSlicingOp(op, adaptor, input, rewriter,
+                                            resultShape, offsets, strides)))
+      return failure();
+
+    // The sizes of the slice are those of `src`, which PyTorch requires to
+    // match the ones computed from the slicing arguments.
+    SmallVector<Value> srcShape = getTensorSizes(rewriter, loc, src);
+    for (auto it : llvm::enumerate(srcShape)) {
+      Value isSameSize = rewriter.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, it.value(), resultShape[it.index()]);
+      rewriter.create<cf::AssertOp>(
+          loc, isSameSize,
+          rewriter.getStringAttr("src must have the size of the slice"));
+    }
+    // The static sizes of `src` must be attributes for the slice to have its
+    // type.
+    Value result = rewriter.create<tensor::InsertSliceOp>(
+        loc, src, input, getAsOpFoldResult(offsets),
+        getAsOpFoldResult(srcShape), getAsOpFoldResult(strides));
 
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
     return success();
@@ -1039,6 +1237,8 @@ void mlir::torch::torch_to_linalg::populateDataMovementPatternsAndLegality(
   patterns.add<ConvertAtenPermuteOp>(typeConverter, context);
   target.addIllegalOp<AtenSliceTensorOp>();
   patterns.add<ConvertAtenSliceTensorOp>(typeConverter, context);
+  target.addIllegalOp<AtenSliceScatterOp>();
+  patterns.add<ConvertAtenSliceScatterOp>(typeConverter, context);
   target.addIllegalOp<AtenCatOp>();
   patterns.add<ConvertAtenCatOp>(typeConverter, context);
   target.addIllegalOp<AtenBroadcastToOp>();
@@ -15,6 +15,7 @@
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Matchers.h"
 #include "torch-mlir/Conversion/Utils/Utils.h"
@@ -109,6 +110,15 @@ public:
 } // namespace
 
 namespace {
+// Embedding lookups copy whole rows of the weight. They are lowered to a loop
+// nest over the indices that copies each row with a `tensor.extract_slice` and
+// `tensor.insert_slice` pair, which bufferize to contiguous row copies, rather
+// than to a `linalg.generic` extracting one element at a time:
+//
+// for i in range(indices.size[0])
+//    ...
+//       index = indices[i, ...]
+//       output[i, ..., :] = weight[index, :]
 class ConvertAtenEmbeddingOp : public OpConversionPattern<AtenEmbeddingOp> {
 public:
   using OpConversionPattern::OpConversionPattern;
@@ -126,43 +136,283 @@ public:
     auto weightTy = weight.getType().cast<RankedTensorType>();
     if (weightTy.getRank() != 2)
       return rewriter.notifyMatchFailure(op, "weight must be rank 2");
+    Value numEmbeddings = getDimOp(rewriter, loc, weight, 0);
     Value embeddingDim = getDimOp(rewriter, loc, weight, 1);
     Type elemTy = weightTy.getElementType();
 
     SmallVector<Value> sizes = getTensorSizes(rewriter, loc, indices);
     sizes.push_back(embeddingDim);
-    int64_t resultRank = sizes.size();
-
-    auto indicesTy = indices.getType().cast<RankedTensorType>();
-    int64_t indicesRank = indicesTy.getRank();
-    SmallVector<AffineExpr> indicesExprs;
-    for (int i = 0; i < indicesRank; i++)
-      indicesExprs.push_back(rewriter.getAffineDimExpr(i));
-    auto indicesAffineMap = AffineMap::get(
-        /*dimCount=*/resultRank,
-        /*symbolCount=*/0, indicesExprs, op->getContext());
-    SmallVector<AffineMap, 2> indexingMaps = {
-        indicesAffineMap,
-        rewriter.getMultiDimIdentityMap(resultRank),
+    int64_t indicesRank = sizes.size() - 1;
+    Value result = rewriter.create<linalg::InitTensorOp>(loc, sizes, elemTy);
+
+    Value c0 = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value c1 = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    SmallVector<scf::ForOp> loops;
+    SmallVector<Value> ivs;
+    for (int64_t i = 0; i < indicesRank; i++) {
+      auto loop = rewriter.create<scf::ForOp>(loc, c0, sizes[i], c1, result);
+      rewriter.setInsertionPointToStart(loop.getBody());
+      loops.push_back(loop);
+      ivs.push_back(loop.getInductionVar());
+      result = loop.getRegionIterArgs()[0];
+    }
+
+    Value index = castIntToIndex(
+        rewriter, loc, rewriter.create<tensor::ExtractOp>(loc, indices, ivs));
+    Value indexLTNumEmbeddings = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ult, index, numEmbeddings);
+    rewriter.create<cf::AssertOp>(
+        loc, indexLTNumEmbeddings,
+        rewriter.getStringAttr("index must be in [0, num_embeddings)"));
+
+    OpFoldResult zero = rewriter.getIndexAttr(0);
+    OpFoldResult one = rewriter.getIndexAttr(1);
+    // A static embedding dim must be an attribute for the slices to have the
+    // static row type.
+    OpFoldResult rowSize = getAsOpFoldResult(embeddingDim);
+    auto rowType = RankedTensorType::get({weightTy.getDimSize(1)}, elemTy);
+    Value row = rewriter.create<tensor::ExtractSliceOp>(
+        loc, rowType, weight, ArrayRef<OpFoldResult>{index, zero},
+        ArrayRef<OpFoldResult>{one, rowSize},
+        ArrayRef<OpFoldResult>{one, one});
+    SmallVector<OpFoldResult> offsets(ivs.begin(), ivs.end());
+    offsets.push_back(zero);
+    SmallVector<OpFoldResult> rowSizes(indicesRank, one);
+    rowSizes.push_back(rowSize);
+    SmallVector<OpFoldResult> strides(indicesRank + 1, one);
+    result = rewriter.create<tensor::InsertSliceOp>(loc, row, result, offsets,
+                                                    rowSizes, strides);
+
+    for (scf::ForOp loop : llvm::reverse(loops)) {
+      rewriter.create<scf::YieldOp>(loc, result);
+      result = loop.getResult(0);
+      rewriter.setInsertionPointAfter(loop);
+    }
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, result);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Embedding bags pool the rows of the weight selected by each bag of indices.
+// The rows are accumulated one at a time into the pooled row of the bag, so
+// the gathered rows are never materialized:
+//
+// for b in range(num_bags)
+//    acc = init
+//    for j in range(offsets[b], offsets[b + 1])
+//       acc = combine(acc, weight[indices[j], :] * per_sample_weights[j])
+//    output[b, :] = finalize(acc, offsets[b + 1] - offsets[b])
+//
+// Only the pooled output is produced. The other results, which are only used
+// by the backward pass, must be unused.
+class ConvertAtenEmbeddingBagPaddingIdxOp
+    : public OpConversionPattern<AtenEmbeddingBagPaddingIdxOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenEmbeddingBagPaddingIdxOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    Location loc = op->getLoc();
+    Value weight = adaptor.weight();
+    Value indices = adaptor.indices();
+    Value offsets = adaptor.offsets();
+    Value perSampleWeights = adaptor.per_sample_weights();
+    bool hasPerSampleWeights =
+        !perSampleWeights.getType().isa<Torch::NoneType>();
+
+    // The modes, as in PyTorch.
+    enum { kSum = 0, kMean = 1, kMax = 2 };
+    int64_t mode;
+    if (!matchPattern(op.mode(), m_TorchConstantInt(&mode)) || mode < kSum ||
+        mode > kMax)
+      return rewriter.notifyMatchFailure(op,
+                                         "mode must be a constant 0, 1 or 2");
+    if (hasPerSampleWeights && mode != kSum)
+      return rewriter.notifyMatchFailure(
+          op, "per_sample_weights are only supported with mode 'sum'");
+    bool includeLastOffset;
+    if (!matchPattern(op.include_last_offset(),
+                      m_TorchConstantBool(&includeLastOffset)))
+      return rewriter.notifyMatchFailure(
+          op, "include_last_offset must be a constant bool");
+    if (!op.padding_idx().getType().isa<Torch::NoneType>())
+      return rewriter.notifyMatchFailure(op, "unimplemented: padding_idx");
+    if (llvm::any_of(op->getResults().drop_front(),
+                     [](Value result) { return !result.use_empty(); }))
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: only the pooled output can be used");
+
+    auto weightTy = weight.getType().cast<RankedTensorType>();
+    auto elemTy = weightTy.getElementType().dyn_cast<mlir::FloatType>();
+    if (weightTy.getRank() != 2 || !elemTy)
+      return rewriter.notifyMatchFailure(op, "weight must be a float matrix");
+    if (indices.getType().cast<RankedTensorType>().getRank() != 1 ||
+        offsets.getType().cast<RankedTensorType>().getRank() != 1)
+      return rewriter.notifyMatchFailure(op,
+                                         "indices and offsets must be rank 1");
+
+    Value c0 = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value c1 = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value numEmbeddings = getDimOp(rewriter, loc, weight, 0);
+    Value embeddingDim = getDimOp(rewriter, loc, weight, 1);
+    Value numIndices = getDimOp(rewriter, loc, indices, 0);
+    Value numOffsets = getDimOp(rewriter, loc, offsets, 0);
+    Value numBags = includeLastOffset
+                        ? rewriter.create<arith::SubIOp>(loc, numOffsets, c1)
+                        : numOffsets;
+
+    Value zero =
+        rewriter.create<arith::ConstantOp>(loc, rewriter.getZeroAttr(elemTy));
+    Value initElem = zero;
+    if (mode == kMax) {
+      initElem = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getFloatAttr(
+                   elemTy, APFloat::getInf(elemTy.getFloatSemantics(),
+                                           /*Negative=*/true)));
+    }
+    Value output = rewriter.create<linalg::InitTensorOp>(
+        loc, ValueRange{numBags, embeddingDim}, elemTy);
+
+    auto bagLoop =
+        rewriter.create<scf::ForOp>(loc, c0, numBags, c1, ValueRange{output});
+    rewriter.setInsertionPointToStart(bagLoop.getBody());
+    Value bag = bagLoop.getInductionVar();
+    auto getOffset = [&](Value i) {
+      Value offset = rewriter.create<tensor::ExtractOp>(loc, offsets, i);
+      return castIntToIndex(rewriter, loc, offset);
     };
-    SmallVector<StringRef> iteratorTypes(sizes.size(),
-                                         getParallelIteratorTypeName());
-    Value initTensor =
-        rewriter.create<linalg::InitTensorOp>(loc, sizes, elemTy);
-    Value embeddingResult =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, initTensor.getType(), indices, initTensor,
-                /*indexingMaps=*/indexingMaps, /*iteratorTypes=*/iteratorTypes,
-                [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value index = args[0];
-                  createLinalgPayloadCalculationForGatherOps(
-                      b, loc, weight, weightTy.getRank(), index, /*dim=*/0,
-                      resultRank);
-                })
-            .getResult(0);
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType,
-                                                embeddingResult);
+    Value start = getOffset(bag);
+    // The end of the last bag is the end of the indices, unless it is given
+    // by the last offset.
+    Value nextBag = rewriter.create<arith::AddIOp>(loc, bag, c1);
+    Value end;
+    if (includeLastOffset) {
+      end = getOffset(nextBag);
+    } else {
+      Value isLastBag = rewriter.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, nextBag, numOffsets);
+      Value nextOffset = getOffset(
+          rewriter.create<arith::SelectOp>(loc, isLastBag, bag, nextBag));
+      end = rewriter.create<arith::SelectOp>(loc, isLastBag, numIndices,
+                                             nextOffset);
+    }
+
+    // A static embedding dim must be an attribute for the pooled rows and the
+    // slices to have the static row type.
+    OpFoldResult rowSize = getAsOpFoldResult(embeddingDim);
+    Value accInit = rewriter.create<linalg::InitTensorOp>(
+        loc, ArrayRef<OpFoldResult>{rowSize}, elemTy);
+    accInit = rewriter.create<linalg::FillOp>(loc, initElem, accInit)
+                  .getResult(0);
+    auto rowLoop =
+        rewriter.create<scf::ForOp>(loc, start, end, c1, ValueRange{accInit});
+    rewriter.setInsertionPointToStart(rowLoop.getBody());
+    Value j = rowLoop.getInductionVar();
+    Value acc = rowLoop.getRegionIterArgs()[0];
+    Value index = castIntToIndex(
+        rewriter, loc, rewriter.create<tensor::ExtractOp>(loc, indices, j));
+    Value indexLTNumEmbeddings = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ult, index, numEmbeddings);
+    rewriter.create<cf::AssertOp>(
+        loc, indexLTNumEmbeddings,
+        rewriter.getStringAttr("index must be in [0, num_embeddings)"));
+    OpFoldResult zeroAttr = rewriter.getIndexAttr(0);
+    OpFoldResult oneAttr = rewriter.getIndexAttr(1);
+    auto rowType = RankedTensorType::get({weightTy.getDimSize(1)}, elemTy);
+    Value row = rewriter.create<tensor::ExtractSliceOp>(
+        loc, rowType, weight, ArrayRef<OpFoldResult>{index, zeroAttr},
+        ArrayRef<OpFoldResult>{oneAttr, rowSize},
+        ArrayRef<OpFoldResult>{oneAttr, oneAttr});
+    Value sampleWeight;
+    if (hasPerSampleWeights) {
+      sampleWeight = convertScalarToDtype(
+          rewriter, loc,
+          rewriter.create<tensor::ExtractOp>(loc, perSampleWeights, j),
+          elemTy);
+    }
+
+    auto createRowwise =
+        [&](ValueRange inputs, Value init,
+            function_ref<Value(OpBuilder &, Location, ValueRange)> bodyBuild) {
+          SmallVector<AffineMap> indexingMaps(
+              inputs.size() + 1, rewriter.getMultiDimIdentityMap(1));
+          return rewriter
+              .create<linalg::GenericOp>(
+                  loc, init.getType(), inputs, init, indexingMaps,
+                  getParallelIteratorTypeName(),
+                  [&](OpBuilder &b, Location loc, ValueRange args) {
+                    b.create<linalg::YieldOp>(loc, bodyBuild(b, loc, args));
+                  })
+              .getResult(0);
+        };
+    Value newAcc = createRowwise(
+        row, acc, [&](OpBuilder &b, Location loc, ValueRange args) -> Value {
+          Value element = args[0];
+          if (mode == kMax)
+            return b.create<arith::MaxFOp>(loc, args[1], element);
+          if (sampleWeight)
+            element = b.create<arith::MulFOp>(loc, element, sampleWeight);
+          return b.create<arith::AddFOp>(loc, args[1], element);
+        });
+    rewriter.create<scf::YieldOp>(loc, newAcc);
+    rewriter.setInsertionPointAfter(rowLoop);
+
+    Value pooled = rowLoop.getResult(0);
+    Value bagSize = rewriter.create<arith::SubIOp>(loc, end, start);
+    if (mode == kMean) {
+      // Empty bags are all zeros, so dividing them by 1 leaves them as is.
+      Value divisor = rewriter.create<arith::SIToFPOp>(
+          loc, elemTy,
+          rewriter.create<arith::IndexCastOp>(
+              loc, rewriter.getI64Type(),
+              rewriter.create<arith::MaxSIOp>(loc, bagSize, c1)));
+      pooled = createRowwise({}, pooled,
+                             [&](OpBuilder &b, Location loc, ValueRange args) {
+                               return b.create<arith::DivFOp>(loc, args[0],
+                                                              divisor);
+                             });
+    } else if (mode == kMax) {
+      // Empty bags are all zeros, as in PyTorch.
+      Value isEmpty = rewriter.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, bagSize, c0);
+      pooled = createRowwise({}, pooled,
+                             [&](OpBuilder &b, Location loc, ValueRange args) {
+                               return b.create<arith::SelectOp>(loc, isEmpty,
+                                                                zero, args[0]);
+                             });
+    }
+    Value newOutput = rewriter.create<tensor::InsertSliceOp>(
+        loc, pooled, bagLoop.getRegionIterArgs()[0],
+        ArrayRef<OpFoldResult>{bag, zeroAttr},
+        ArrayRef<OpFoldResult>{oneAttr, rowSize},
+        ArrayRef<OpFoldResult>{oneAttr, oneAttr});
+    rewriter.create<scf::YieldOp>(loc, newOutput);
+    rewriter.setInsertionPointAfter(bagLoop);
+
+    // The other results are unused, so any tensor of their type will do.
+    SmallVector<Value> results;
+    for (Value result : op->getResults()) {
+      auto resultType = getTypeConverter()
+                            ->convertType(result.getType())
+                            .cast<RankedTensorType>();
+      if (results.empty()) {
+        results.push_back(rewriter.create<tensor::CastOp>(
+            loc, resultType, bagLoop.getResult(0)));
+        continue;
+      }
+      SmallVector<Value> sizes;
+      for (int64_t size : resultType.getShape()) {
+        if (size == ShapedType::kDynamicSize)
+          sizes.push_back(c0);
+      }
+      results.push_back(rewriter.create<linalg::InitTensorOp>(
+          loc, sizes, resultType.getShape(), resultType.getElementType()));
+    }
+    rewriter.replaceOp(op, results);
     return success();
   }
 };
@@ -245,6 +495,17 @@ public:
 } // namespace
 
 namespace {
+// Lowers advanced indexing with any combination of index tensors and `None`s
+// (and implicit trailing `None`s) to a single `linalg.generic` reading each
+// element of the result from the input with one `tensor.extract`.
+//
+// The index tensors are broadcast together. If they index consecutive
+// dimensions, the broadcast dimensions replace these dimensions in the
+// result. Otherwise, they come first in the result. For example, for an
+// input of shape [A, B, C] and index tensors `i` and `j` of shape [N]:
+//
+// x[i, :, j]: output[n, b] = input[i[n], b, j[n]]
+// x[:, i, j]: output[a, n] = input[a, i[n], j[n]]
 class ConvertAtenIndexTensorOp : public OpConversionPattern<AtenIndexTensorOp> {
 public:
   using OpConversionPattern::OpConversionPattern;
@@ -262,65 +523,133 @@ public:
       return rewriter.notifyMatchFailure(
           op, "unimplemented: the indices list is not from a list construct");
     }
-    if (indicesTuple.size() != 1) {
+
+    RankedTensorType inputType = input.getType().cast<RankedTensorType>();
+    int64_t inputRank = inputType.getRank();
+    if (static_cast<int64_t>(indicesTuple.size()) > inputRank)
+      return rewriter.notifyMatchFailure(op, "more indices than dimensions");
+
+    // The index tensors and the input dimensions they index.
+    SmallVector<Value> indexTensorsTorch;
+    SmallVector<int64_t> indexedDims;
+    for (auto it : llvm::enumerate(indicesTuple)) {
+      if (it.value().getType().isa<Torch::NoneType>())
+        continue;
+      indexTensorsTorch.push_back(it.value());
+      indexedDims.push_back(it.index());
+    }
+    if (indexTensorsTorch.empty())
       return rewriter.notifyMatchFailure(
-          op, "unimplemented: only one index tensor is supported");
+          op, "unimplemented: expected at least one index tensor");
+    SmallVector<Value> indexTensors = getTypeConvertedValues(
+        rewriter, loc, getTypeConverter(), indexTensorsTorch);
+    int64_t broadcastRank = 0;
+    for (Value indexTensor : indexTensors) {
+      auto indexTensorType = indexTensor.getType().cast<RankedTensorType>();
+      if (indexTensorType.getElementType().isInteger(1))
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: boolean mask index tensors");
+      broadcastRank = std::max(broadcastRank, indexTensorType.getRank());
     }
 
-    SmallVector<Value> indicesVal =
-        getTypeConvertedValues(rewriter, loc, getTypeConverter(), indicesTuple);
-    Value indexTensor = indicesVal[0];
-    if (failed(checkNotNone(rewriter, op, indexTensor))) {
-      return rewriter.notifyMatchFailure(
-          op, "unimplemented: index tensor must not be None");
+    int64_t numIndexed = indexedDims.size();
+    bool indexedDimsAreConsecutive =
+        indexedDims.back() - indexedDims.front() + 1 == numIndexed;
+    int64_t broadcastStart =
+        indexedDimsAreConsecutive ? indexedDims.front() : 0;
+    int64_t resultRank = inputRank - numIndexed + broadcastRank;
+
+    // Compute the position in the result of each input dimension that is not
+    // indexed, and the result shape.
+    SmallVector<Value> resultShape(resultRank);
+    SmallVector<int64_t> resultDimOfInputDim(inputRank, -1);
+    int64_t numUnindexedSeen = 0;
+    for (int64_t d = 0; d < inputRank; d++) {
+      if (llvm::is_contained(indexedDims, d))
+        continue;
+      int64_t resultDim;
+      if (!indexedDimsAreConsecutive)
+        resultDim = broadcastRank + numUnindexedSeen;
+      else if (d < indexedDims.front())
+        resultDim = d;
+      else
+        resultDim = d - numIndexed + broadcastRank;
+      numUnindexedSeen++;
+      resultDimOfInputDim[d] = resultDim;
+      resultShape[resultDim] = getDimOp(rewriter, loc, input, d);
     }
 
-    RankedTensorType inputType = input.getType().cast<RankedTensorType>();
-    RankedTensorType indexTensorType =
-        indexTensor.getType().cast<RankedTensorType>();
-    RankedTensorType resultType = getTypeConverter()
-                                      ->convertType(op->getResult(0).getType())
-                                      .cast<RankedTensorType>();
-    Type elementType = resultType.getElementType();
-    int inputRank = inputType.getRank();
-    int indexTensorRank = indexTensorType.getRank();
-
-    // This result shape calculation assumes that there is only one
-    // index tensor and that it is indexing the first dimension of the
-    // input tensor. The calculation for arbitrary inputs is much more complex.
-    SmallVector<Value> resultShape;
-    for (auto i : llvm::seq(0, indexTensorRank)) {
-      resultShape.push_back(getDimOp(rewriter, loc, indexTensor, i));
+    // Broadcast the index tensors together, with the same requirements as
+    // for elementwise ops: sizes must match unless they are statically 1.
+    SmallVector<Value> broadcastShape(broadcastRank);
+    SmallVector<AffineMap> indexingMaps;
+    for (Value indexTensor : indexTensors) {
+      auto indexTensorType = indexTensor.getType().cast<RankedTensorType>();
+      int64_t rank = indexTensorType.getRank();
+      SmallVector<AffineExpr> exprs;
+      for (int64_t i = 0; i < rank; i++) {
+        if (indexTensorType.getDimSize(i) == 1) {
+          exprs.push_back(rewriter.getAffineConstantExpr(0));
+          continue;
+        }
+        int64_t broadcastDim = broadcastRank - rank + i;
+        exprs.push_back(
+            rewriter.getAffineDimExpr(broadcastStart + broadcastDim));
+        Value size = getDimOp(rewriter, loc, indexTensor, i);
+        if (!broadcastShape[broadcastDim]) {
+          broadcastShape[broadcastDim] = size;
+          continue;
+        }
+        Value sizesMatch = rewriter.create<arith::CmpIOp>(
+            loc, arith::CmpIPredicate::eq, broadcastShape[broadcastDim], size);
+        rewriter.create<cf::AssertOp>(
+            loc, sizesMatch,
+            rewriter.getStringAttr("mismatched size for broadcast"));
+      }
+      indexingMaps.push_back(AffineMap::get(resultRank, /*symbolCount=*/0,
+                                            exprs, op->getContext()));
     }
-    for (auto i : llvm::seq(1, inputRank)) {
-      resultShape.push_back(getDimOp(rewriter, loc, input, i));
+    for (int64_t i = 0; i < broadcastRank; i++) {
+      Value size = broadcastShape[i];
+      if (!size)
+        size = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+      resultShape[broadcastStart + i] = size;
     }
-    int resultRank = resultShape.size();
+    indexingMaps.push_back(rewriter.getMultiDimIdentityMap(resultRank));
 
-    Value initTensor =
-        rewriter.create<linalg::InitTensorOp>(loc, resultShape, elementType);
-    SmallVector<AffineExpr> indicesExpr, resultExpr;
-    SmallVector<StringRef> iteratorTypes;
-
-    for (auto i : llvm::seq(0, indexTensorRank))
-      indicesExpr.push_back(rewriter.getAffineDimExpr(i));
-    for (auto i : llvm::seq(0, resultRank)) {
-      resultExpr.push_back(rewriter.getAffineDimExpr(i));
-      iteratorTypes.push_back(getParallelIteratorTypeName());
-    }
-    auto indexingMaps = AffineMap::inferFromExprList({indicesExpr, resultExpr});
+    RankedTensorType resultType = getTypeConverter()
+                                      ->convertType(op->getResult(0).getType())
+                                      .cast<RankedTensorType>();
+    Value initTensor = rewriter.create<linalg::InitTensorOp>(
+        loc, resultShape, resultType.getElementType());
+    SmallVector<StringRef> iteratorTypes(resultRank,
+                                         getParallelIteratorTypeName());
+    Value c0 = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<Value> inputShape = getTensorSizes(rewriter, loc, input);
 
     Value finalRes =
         rewriter
             .create<linalg::GenericOp>(
-                loc, initTensor.getType(), indexTensor, initTensor,
+                loc, initTensor.getType(), indexTensors, initTensor,
                 indexingMaps, iteratorTypes,
                 [&](OpBuilder &b, Location loc, ValueRange args) {
-                  SmallVector<Value> extractionIndices{
-                      castIntToIndex(b, loc, args[0])};
-                  for (auto i : llvm::seq(1, inputRank)) {
-                    extractionIndices.push_back(b.create<linalg::IndexOp>(
-                        loc, i + indexTensorRank - 1));
+                  SmallVector<Value> extractionIndices;
+                  for (int64_t d = 0; d < inputRank; d++) {
+                    if (resultDimOfInputDim[d] >= 0) {
+                      extractionIndices.push_back(b.create<linalg::IndexOp>(
+                          loc, resultDimOfInputDim[d]));
+                      continue;
+                    }
+                    // Negative indices count from the end of the dimension.
+                    int64_t k =
+                        llvm::find(indexedDims, d) - indexedDims.begin();
+                    Value index = castIntToIndex(b, loc, args[k]);
+                    Value isNegative = b.create<arith::CmpIOp>(
+                        loc, arith::CmpIPredicate::slt, index, c0);
+                    Value wrapped =
+                        b.create<arith::AddIOp>(loc, index, inputShape[d]);
+                    extractionIndices.push_back(b.create<arith::SelectOp>(
+                        loc, isNegative, wrapped, index));
                   }
                   Value extractedElement = b.create<tensor::ExtractOp>(
                       loc, input, extractionIndices);
@@ -334,6 +663,334 @@ public:
 };
 } // namespace
 
+namespace {
+// The operands of the upsampling ops: an output size with optional scales,
+// or, for the `.vec` variants, either an output size or scale factors.
+struct UpsampleOperands {
+  Value outputSize;
+  Value scaleFactors;
+  Value scalesH;
+  Value scalesW;
+  Value alignCorners;
+};
+} // namespace
+
+static UpsampleOperands getUpsampleOperands(AtenUpsampleNearest2dOp op) {
+  return {op.output_size(), Value(), op.scales_h(), op.scales_w(), Value()};
+}
+static UpsampleOperands getUpsampleOperands(AtenUpsampleNearest2dVecOp op) {
+  return {op.output_size(), op.scale_factors(), Value(), Value(), Value()};
+}
+static UpsampleOperands getUpsampleOperands(AtenUpsampleBilinear2dOp op) {
+  return {op.output_size(), Value(), op.scales_h(), op.scales_w(),
+          op.align_corners()};
+}
+static UpsampleOperands getUpsampleOperands(AtenUpsampleBilinear2dVecOp op) {
+  return {op.output_size(), op.scale_factors(), Value(), Value(),
+          op.align_corners()};
+}
+
+// Computes the sizes of the spatial dimensions of the result of an upsampling
+// op, and the scales from output to input coordinates, in `coordType`. As in
+// PyTorch, a given scale factor `s` maps the coordinates by `1 / s`, and the
+// ratio of the input and output sizes is used otherwise.
+static LogicalResult getUpsampleSizesAndScales(
+    Operation *op, ConversionPatternRewriter &rewriter,
+    TypeConverter *typeConverter, Value input,
+    const UpsampleOperands &operands, bool alignCorners, Type coordType,
+    SmallVectorImpl<Value> &outputSizes, SmallVectorImpl<Value> &scales) {
+  Location loc = op->getLoc();
+  SmallVector<Value> scaleFactors;
+  if (operands.scaleFactors &&
+      !operands.scaleFactors.getType().isa<Torch::NoneType>()) {
+    if (!getListConstructElements(operands.scaleFactors, scaleFactors))
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: scale factors not from a list construct");
+  } else if (operands.scalesH) {
+    for (Value scale : {operands.scalesH, operands.scalesW})
+      scaleFactors.push_back(
+          scale.getType().isa<Torch::NoneType>() ? Value() : scale);
+  } else {
+    scaleFactors.resize(2);
+  }
+  if (scaleFactors.size() != 2)
+    return rewriter.notifyMatchFailure(op, "expected two scale factors");
+  for (Value &scale : scaleFactors) {
+    if (scale)
+      scale = typeConverter->materializeTargetConversion(
+          rewriter, loc, typeConverter->convertType(scale.getType()), scale);
+  }
+
+  SmallVector<Value> sizes;
+  bool sizesFromScales = operands.outputSize.getType().isa<Torch::NoneType>();
+  if (!sizesFromScales &&
+      !getListConstructElements(operands.outputSize, sizes))
+    return rewriter.notifyMatchFailure(
+        op, "unimplemented: output size not from a list construct");
+  if (!sizesFromScales && sizes.size() != 2)
+    return rewriter.notifyMatchFailure(op, "expected two output sizes");
+  if (!sizesFromScales)
+    sizes = getTypeConvertedValues(rewriter, loc, typeConverter, sizes);
+
+  Type f64Type = rewriter.getF64Type();
+  Type i64Type = rewriter.getI64Type();
+  auto toCoord = [&](Value size) -> Value {
+    return rewriter.create<arith::SIToFPOp>(
+        loc, coordType, castIndexToInt64(rewriter, loc, size));
+  };
+  for (int64_t i = 0; i < 2; i++) {
+    Value inputSize = getDimOp(rewriter, loc, input, i + 2);
+    Value scale = scaleFactors[i];
+    Value outputSize;
+    if (sizesFromScales) {
+      if (!scale)
+        return rewriter.notifyMatchFailure(
+            op, "expected an output size or scale factors");
+      // The output size is truncated like in PyTorch's `compute_output_size`.
+      Value size = rewriter.create<arith::MulFOp>(
+          loc,
+          rewriter.create<arith::SIToFPOp>(
+              loc, f64Type, castIndexToInt64(rewriter, loc, inputSize)),
+          scale);
+      outputSize = castIntToIndex(
+          rewriter, loc, rewriter.create<arith::FPToSIOp>(loc, i64Type, size));
+    } else {
+      outputSize = castIntToIndex(rewriter, loc, sizes[i]);
+    }
+    outputSizes.push_back(outputSize);
+
+    Value one = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getFloatAttr(coordType, 1.0));
+    if (alignCorners) {
+      // (in - 1) / (out - 1), or 0 if the output has a single element.
+      Value inputMax = rewriter.create<arith::SubFOp>(loc, toCoord(inputSize),
+                                                      one);
+      Value outputMax = rewriter.create<arith::SubFOp>(
+          loc, toCoord(outputSize), one);
+      Value zero = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getFloatAttr(coordType, 0.0));
+      Value isSingle = rewriter.create<arith::CmpFOp>(
+          loc, arith::CmpFPredicate::OLE, outputMax, zero);
+      scales.push_back(rewriter.create<arith::SelectOp>(
+          loc, isSingle, zero,
+          rewriter.create<arith::DivFOp>(loc, inputMax, outputMax)));
+    } else if (scale) {
+      // The inverse is computed in double before the conversion, as in
+      // PyTorch.
+      Value inverse = rewriter.create<arith::DivFOp>(
+          loc,
+          rewriter.create<arith::ConstantOp>(
+              loc, rewriter.getFloatAttr(f64Type, 1.0)),
+          scale);
+      if (coordType != f64Type)
+        inverse = rewriter.create<arith::TruncFOp>(loc, coordType, inverse);
+      scales.push_back(inverse);
+    } else {
+      scales.push_back(rewriter.create<arith::DivFOp>(
+          loc, toCoord(inputSize), toCoord(outputSize)));
+    }
+  }
+  return success();
+}
+
+// Returns the tensors of the input coordinates that each output coordinate
+// along a spatial dimension reads, computed once per output coordinate rather
+// than once per output element. For nearest-neighbor upsampling, that is the
+// nearest input coordinate. For bilinear upsampling, that is the two input
+// coordinates to interpolate between, and the weight of the second.
+static SmallVector<Value>
+getUpsampleSourceCoordinates(OpBuilder &b, Location loc, Value inputSize,
+                             Value outputSize, Value scale, bool bilinear,
+                             bool alignCorners, Type coordType) {
+  Type i64Type = b.getI64Type();
+  SmallVector<Type> types{i64Type};
+  if (bilinear)
+    types.append({i64Type, coordType});
+  SmallVector<Value> inits;
+  for (Type type : types)
+    inits.push_back(b.create<linalg::InitTensorOp>(loc, outputSize, type));
+  SmallVector<AffineMap> indexingMaps(types.size(),
+                                      b.getMultiDimIdentityMap(1));
+  SmallVector<StringRef> iteratorTypes(1, getParallelIteratorTypeName());
+  Value inputMax = castIndexToInt64(
+      b, loc,
+      b.create<arith::SubIOp>(loc, inputSize,
+                              b.create<arith::ConstantIndexOp>(loc, 1)));
+  auto generic = b.create<linalg::GenericOp>(
+      loc, ValueRange(inits).getTypes(), ValueRange(), inits, indexingMaps,
+      iteratorTypes,
+      [&](OpBuilder &b, Location loc, ValueRange args) {
+        Value dst = b.create<arith::SIToFPOp>(
+            loc, coordType,
+            castIndexToInt64(b, loc, b.create<linalg::IndexOp>(loc, 0)));
+        if (!bilinear) {
+          // min(floor(dst * scale), in - 1), as in PyTorch's `nearest_idx`.
+          Value src = b.create<arith::MulFOp>(loc, dst, scale);
+          Value index = b.create<arith::FPToSIOp>(loc, i64Type, src);
+          b.create<linalg::YieldOp>(
+              loc, ValueRange{b.create<arith::MinSIOp>(loc, index, inputMax)});
+          return;
+        }
+        // As in PyTorch's `area_pixel_compute_source_index`.
+        Value src;
+        if (alignCorners) {
+          src = b.create<arith::MulFOp>(loc, dst, scale);
+        } else {
+          Value half =
+              b.create<arith::ConstantOp>(loc, b.getFloatAttr(coordType, 0.5));
+          Value zero =
+              b.create<arith::ConstantOp>(loc, b.getFloatAttr(coordType, 0.0));
+          src = b.create<arith::SubFOp>(
+              loc,
+              b.create<arith::MulFOp>(
+                  loc, b.create<arith::AddFOp>(loc, dst, half), scale),
+              half);
+          src = b.create<arith::MaxFOp>(loc, src, zero);
+        }
+        Value index0 = b.create<arith::FPToSIOp>(loc, i64Type, src);
+        Value index1 = b.create<arith::MinSIOp>(
+            loc,
+            b.create<arith::AddIOp>(loc, index0,
+                                    b.create<arith::ConstantOp>(
+                                        loc, b.getI64IntegerAttr(1))),
+            inputMax);
+        Value weight1 = b.create<arith::SubFOp>(
+            loc, src, b.create<arith::SIToFPOp>(loc, coordType, index0));
+        b.create<linalg::YieldOp>(loc, ValueRange{index0, index1, weight1});
+      });
+  return llvm::to_vector<3>(generic.getResults());
+}
+
+namespace {
+// Lowers the nearest-neighbor and bilinear upsampling of NCHW tensors to a
+// `linalg.generic` over the output, which reads the input elements at the
+// coordinates precomputed for each output row and column:
+//
+// for h in range(out_h): ih[h] = nearest(h)
+// for w in range(out_w): iw[w] = nearest(w)
+// for n, c, h, w: output[n, c, h, w] = input[n, c, ih[h], iw[w]]
+//
+// Bilinear upsampling precomputes the two input coordinates and the weights
+// of each output coordinate, and interpolates between the four input
+// elements around it.
+template <typename OpTy>
+class ConvertAtenUpsample2dOp : public OpConversionPattern<OpTy> {
+public:
+  using OpConversionPattern<OpTy>::OpConversionPattern;
+  using OpAdaptor = typename OpTy::Adaptor;
+  LogicalResult
+  matchAndRewrite(OpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+
+    Location loc = op.getLoc();
+    Value input = adaptor.getOperands()[0];
+    auto inputType = input.getType().template cast<RankedTensorType>();
+    if (inputType.getRank() != 4)
+      return rewriter.notifyMatchFailure(op, "expected an NCHW input");
+    auto resultType = this->getTypeConverter()
+                          ->convertType(op.getType())
+                          .template cast<RankedTensorType>();
+    Type elementType = resultType.getElementType();
+
+    UpsampleOperands operands = getUpsampleOperands(op);
+    bool bilinear = static_cast<bool>(operands.alignCorners);
+    bool alignCorners = false;
+    if (bilinear &&
+        !matchPattern(operands.alignCorners,
+                      m_TorchConstantBool(&alignCorners)))
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: align_corners must be a constant");
+    // The coordinates are computed in float like PyTorch's kernels, and in
+    // double for the bilinear upsampling of double tensors.
+    Type coordType = rewriter.getF32Type();
+    if (bilinear) {
+      if (!elementType.isa<mlir::FloatType>())
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: bilinear upsampling of non-float tensors");
+      if (elementType.isF64())
+        coordType = elementType;
+    }
+
+    SmallVector<Value> outputSizes, scales;
+    if (failed(getUpsampleSizesAndScales(
+            op, rewriter, this->getTypeConverter(), input, operands,
+            alignCorners, coordType, outputSizes, scales)))
+      return failure();
+
+    SmallVector<Value> coordinates;
+    SmallVector<AffineMap> indexingMaps;
+    for (int64_t i = 0; i < 2; i++) {
+      SmallVector<Value> dimCoordinates = getUpsampleSourceCoordinates(
+          rewriter, loc, getDimOp(rewriter, loc, input, i + 2),
+          outputSizes[i], scales[i], bilinear, alignCorners, coordType);
+      AffineMap map =
+          AffineMap::get(4, 0, rewriter.getAffineDimExpr(i + 2));
+      coordinates.append(dimCoordinates.begin(), dimCoordinates.end());
+      indexingMaps.append(dimCoordinates.size(), map);
+    }
+    indexingMaps.push_back(rewriter.getMultiDimIdentityMap(4));
+
+    SmallVector<Value> resultShape{getDimOp(rewriter, loc, input, 0),
+                                   getDimOp(rewriter, loc, input, 1),
+                                   outputSizes[0], outputSizes[1]};
+    Value initTensor =
+        rewriter.create<linalg::InitTensorOp>(loc, resultShape, elementType);
+    SmallVector<StringRef> iteratorTypes(4, getParallelIteratorTypeName());
+    Value result =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, initTensor.getType(), coordinates, initTensor,
+                indexingMaps, iteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value n = b.create<linalg::IndexOp>(loc, 0);
+                  Value c = b.create<linalg::IndexOp>(loc, 1);
+                  auto extract = [&](Value h, Value w) -> Value {
+                    Value element = b.create<tensor::ExtractOp>(
+                        loc, input,
+                        ValueRange{n, c, castIntToIndex(b, loc, h),
+                                   castIntToIndex(b, loc, w)});
+                    if (bilinear && elementType != coordType)
+                      element =
+                          b.create<arith::ExtFOp>(loc, coordType, element);
+                    return element;
+                  };
+                  if (!bilinear) {
+                    b.create<linalg::YieldOp>(loc, extract(args[0], args[1]));
+                    return;
+                  }
+                  Value h0 = args[0], h1 = args[1], hWeight1 = args[2];
+                  Value w0 = args[3], w1 = args[4], wWeight1 = args[5];
+                  Value one = b.create<arith::ConstantOp>(
+                      loc, b.getFloatAttr(coordType, 1.0));
+                  Value hWeight0 = b.create<arith::SubFOp>(loc, one, hWeight1);
+                  Value wWeight0 = b.create<arith::SubFOp>(loc, one, wWeight1);
+                  auto interpolate = [&](Value h) -> Value {
+                    return b.create<arith::AddFOp>(
+                        loc,
+                        b.create<arith::MulFOp>(loc, wWeight0,
+                                                extract(h, w0)),
+                        b.create<arith::MulFOp>(loc, wWeight1,
+                                                extract(h, w1)));
+                  };
+                  Value value = b.create<arith::AddFOp>(
+                      loc,
+                      b.create<arith::MulFOp>(loc, hWeight0, interpolate(h0)),
+                      b.create<arith::MulFOp>(loc, hWeight1,
+                                              interpolate(h1)));
+                  if (elementType != coordType)
+                    value = b.create<arith::TruncFOp>(loc, elementType, value);
+                  b.create<linalg::YieldOp>(loc, value);
+                })
+            .getResult(0);
+
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+    return success();
+  }
+};
+} // namespace
+
 void mlir::torch::torch_to_linalg::
     populateIndirectDataMovementPatternsAndLegality(
         TypeConverter &typeConverter, RewritePatternSet &patterns,
@@ -343,8 +1000,17 @@ void mlir::torch::torch_to_linalg::
   patterns.add<ConvertAtenGatherOp>(typeConverter, context);
   target.addIllegalOp<AtenEmbeddingOp>();
   patterns.add<ConvertAtenEmbeddingOp>(typeConverter, context);
+  target.addIllegalOp<AtenEmbeddingBagPaddingIdxOp>();
+  patterns.add<ConvertAtenEmbeddingBagPaddingIdxOp>(typeConverter, context);
   target.addIllegalOp<AtenIndexSelectOp>();
   patterns.add<ConvertAtenIndexSelectOp>(typeConverter, context);
+  target.addIllegalOp<AtenUpsampleNearest2dOp, AtenUpsampleNearest2dVecOp,
+                      AtenUpsampleBilinear2dOp, AtenUpsampleBilinear2dVecOp>();
+  patterns.add<ConvertAtenUpsample2dOp<AtenUpsampleNearest2dOp>,
+               ConvertAtenUpsample2dOp<AtenUpsampleNearest2dVecOp>,
+               ConvertAtenUpsample2dOp<AtenUpsampleBilinear2dOp>,
+               ConvertAtenUpsample2dOp<AtenUpsampleBilinear2dVecOp>>(
+      typeConverter, context);
   target.addIllegalOp<AtenIndexTensorOp>();
   patterns.add<ConvertAtenIndexTensorOp>(typeConverter, context);
 }
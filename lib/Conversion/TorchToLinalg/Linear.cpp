@@ -15,6 +15,7 @@
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Matchers.h"
 #include "torch-mlir/Conversion/Utils/Utils.h"
@@ -27,6 +28,96 @@ using namespace mlir;
 using namespace mlir::torch;
 using namespace mlir::torch::Torch;
 
+// If `v` is an `aten.transpose.int` of the last two dimensions, returns its
+// input converted to a builtin tensor, so that matmuls can read it with swapped
+// indexing maps instead of from a transposed copy. `aten.t` needs no handling:
+// it is decomposed into `aten.transpose.int` before reaching this point.
+static Value getTransposeInput(OpBuilder &b, Location loc,
+                               TypeConverter *typeConverter, Value v) {
+  auto transpose = v.getDefiningOp<AtenTransposeIntOp>();
+  if (!transpose)
+    return nullptr;
+  int64_t rank = getTensorRank(transpose.self());
+  int64_t dim0, dim1;
+  if (rank < 2 || !matchPattern(transpose.dim0(), m_TorchConstantInt(&dim0)) ||
+      !matchPattern(transpose.dim1(), m_TorchConstantInt(&dim1)))
+    return nullptr;
+  dim0 = toPositiveDim(dim0, rank);
+  dim1 = toPositiveDim(dim1, rank);
+  if (std::min(dim0, dim1) != rank - 2 || std::max(dim0, dim1) != rank - 1)
+    return nullptr;
+  Value input = transpose.self();
+  auto type = typeConverter->convertType(input.getType())
+                  .dyn_cast_or_null<RankedTensorType>();
+  if (!type || type.getRank() < 2)
+    return nullptr;
+  return typeConverter->materializeTargetConversion(b, loc, type, input);
+}
+
+// Returns the element type in which the products of a matmul or convolution
+// with a result of `elementType` are accumulated: f32 for 16-bit floats, like
+// PyTorch's CPU kernels do, so that long dot products keep their precision,
+// and `elementType` otherwise.
+static Type getAccumulatorElementType(Type elementType) {
+  if (elementType.isBF16() || elementType.isF16())
+    return Float32Type::get(elementType.getContext());
+  return elementType;
+}
+
+// Rounds the accumulator `acc` to the element type of `resultType` if it is
+// wider, and casts it to `resultType`.
+static Value castAccumulatorToResultType(OpBuilder &b, Location loc, Value acc,
+                                         RankedTensorType resultType) {
+  Type elementType = resultType.getElementType();
+  if (acc.getType().cast<RankedTensorType>().getElementType() != elementType) {
+    acc = torch_to_linalg::createElementwiseLinalgGeneric(
+        b, loc, acc, elementType,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          b.create<linalg::YieldOp>(
+              loc, convertScalarToDtype(b, loc, args[0], elementType));
+        });
+  }
+  return b.create<tensor::CastOp>(loc, resultType, acc);
+}
+
+// Creates the matmul of the rank 2 `lhs` and `rhs` accumulated into `init`,
+// as a `linalg.generic` reading `lhs` (resp. `rhs`) transposed if
+// `isLhsTransposed` (resp. `isRhsTransposed`) is set.
+static Value createTransposedMatmul(OpBuilder &b, Location loc, Value lhs,
+                                    Value rhs, Value init,
+                                    bool isLhsTransposed,
+                                    bool isRhsTransposed) {
+  // (m, n, k)
+  AffineExpr m = b.getAffineDimExpr(0);
+  AffineExpr n = b.getAffineDimExpr(1);
+  AffineExpr k = b.getAffineDimExpr(2);
+  SmallVector<AffineExpr> lhsExprs = {m, k};
+  if (isLhsTransposed)
+    std::swap(lhsExprs[0], lhsExprs[1]);
+  SmallVector<AffineExpr> rhsExprs = {k, n};
+  if (isRhsTransposed)
+    std::swap(rhsExprs[0], rhsExprs[1]);
+  SmallVector<AffineExpr> outExprs = {m, n};
+  auto indexingMaps =
+      AffineMap::inferFromExprList({lhsExprs, rhsExprs, outExprs});
+  SmallVector<StringRef> iteratorTypes = {getParallelIteratorTypeName(),
+                                          getParallelIteratorTypeName(),
+                                          getReductionIteratorTypeName()};
+  return b
+      .create<linalg::GenericOp>(
+          loc, init.getType(), ValueRange{lhs, rhs}, init, indexingMaps,
+          iteratorTypes,
+          [](OpBuilder &b, Location loc, ValueRange args) {
+            Type accType = args[2].getType();
+            Value lhs = convertScalarToDtype(b, loc, args[0], accType);
+            Value rhs = convertScalarToDtype(b, loc, args[1], accType);
+            Value mul = b.create<arith::MulFOp>(loc, lhs, rhs);
+            Value add = b.create<arith::AddFOp>(loc, mul, args[2]);
+            b.create<linalg::YieldOp>(loc, add);
+          })
+      .getResult(0);
+}
+
 namespace {
 class ConvertAtenMmOp : public OpConversionPattern<AtenMmOp> {
 public:
@@ -56,10 +147,22 @@ public:
           op, "expected both operands to aten.mm to be rank 2");
     }
 
-    Value lhsDim0 = rewriter.create<tensor::DimOp>(loc, lhs, 0);
-    Value lhsDim1 = rewriter.create<tensor::DimOp>(loc, lhs, 1);
-    Value rhsDim0 = rewriter.create<tensor::DimOp>(loc, rhs, 0);
-    Value rhsDim1 = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+    // Read transposed operands (e.g. `x @ w.t()`) directly.
+    Value untransposedLhs =
+        getTransposeInput(rewriter, loc, getTypeConverter(), op.self());
+    Value untransposedRhs =
+        getTransposeInput(rewriter, loc, getTypeConverter(), op.mat2());
+    if (untransposedLhs)
+      lhs = untransposedLhs;
+    if (untransposedRhs)
+      rhs = untransposedRhs;
+
+    int64_t lhsRowDim = untransposedLhs ? 1 : 0;
+    int64_t rhsRowDim = untransposedRhs ? 1 : 0;
+    Value lhsDim0 = rewriter.create<tensor::DimOp>(loc, lhs, lhsRowDim);
+    Value lhsDim1 = rewriter.create<tensor::DimOp>(loc, lhs, 1 - lhsRowDim);
+    Value rhsDim0 = rewriter.create<tensor::DimOp>(loc, rhs, rhsRowDim);
+    Value rhsDim1 = rewriter.create<tensor::DimOp>(loc, rhs, 1 - rhsRowDim);
     Value contractingDimEqual = rewriter.create<arith::CmpIOp>(
         loc, arith::CmpIPredicate::eq, lhsDim1, rhsDim0);
     rewriter.create<cf::AssertOp>(
@@ -67,24 +170,35 @@ public:
         rewriter.getStringAttr(
             "mismatching contracting dimension for torch.aten.mm"));
 
-    Type newResultType = getTypeConverter()->convertType(op.getType());
-    Type elementType = newResultType.cast<TensorType>().getElementType();
+    auto newResultType = getTypeConverter()
+                             ->convertType(op.getType())
+                             .cast<RankedTensorType>();
+    Type elementType =
+        getAccumulatorElementType(newResultType.getElementType());
     Value initTensor = rewriter.create<linalg::InitTensorOp>(
         loc, ValueRange{lhsDim0, rhsDim1}, elementType);
     Value c0 = rewriter.create<arith::ConstantOp>(
         loc, FloatAttr::get(elementType, 0.0));
     Value zeroFill =
         rewriter.create<linalg::FillOp>(loc, c0, initTensor).getResult(0);
-    Value matmul = rewriter
-                       .create<linalg::MatmulOp>(loc, zeroFill.getType(),
-                                                 ValueRange{lhs, rhs}, zeroFill)
-                       .getResult(0);
+    Value matmul;
+    if (untransposedLhs || untransposedRhs) {
+      matmul = createTransposedMatmul(rewriter, loc, lhs, rhs, zeroFill,
+                                      untransposedLhs != nullptr,
+                                      untransposedRhs != nullptr);
+    } else {
+      matmul = rewriter
+                   .create<linalg::MatmulOp>(loc, zeroFill.getType(),
+                                             ValueRange{lhs, rhs}, zeroFill)
+                   .getResult(0);
+    }
     // When constructed with just dynamic sizes, InitTensorOp will have a result
     // type which has all `?`'s for dimensions, which might not be the result
     // type of `op`. The constraints on later linalg ops means that the result
     // of the MatmulOp will have this type too. So cast it to the desired type
     // so that in the end we have the original result type.
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, matmul);
+    rewriter.replaceOp(
+        op, castAccumulatorToResultType(rewriter, loc, matmul, newResultType));
 
     return success();
   }
@@ -171,9 +285,10 @@ public:
     unsigned lhsRank = lhsType.getRank();
     unsigned rhsRank = rhsType.getRank();
 
-    Type newResultType = getTypeConverter()->convertType(op.getType());
-    auto resultType = newResultType.cast<RankedTensorType>();
-    Type elementType = resultType.getElementType();
+    auto resultType = getTypeConverter()
+                          ->convertType(op.getType())
+                          .cast<RankedTensorType>();
+    Type elementType = getAccumulatorElementType(resultType.getElementType());
 
     // The different cases of torch_matmul op is mentioned here:
     // https://pytorch.org/docs/stable/generated/torch.matmul.html
@@ -191,7 +306,8 @@ public:
               .create<linalg::DotOp>(loc, zeroTensor.getType(),
                                      ValueRange{lhs, rhs}, zeroTensor)
               .getResult(0);
-      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, dotProd);
+      rewriter.replaceOp(
+          op, castAccumulatorToResultType(rewriter, loc, dotProd, resultType));
       return success();
     }
 
@@ -209,7 +325,8 @@ public:
               .create<linalg::VecmatOp>(loc, zeroTensor.getType(),
                                         ValueRange{lhs, rhs}, zeroTensor)
               .getResult(0);
-      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, matmul);
+      rewriter.replaceOp(
+          op, castAccumulatorToResultType(rewriter, loc, matmul, resultType));
       return success();
     }
 
@@ -227,7 +344,8 @@ public:
               .create<linalg::MatvecOp>(loc, zeroTensor.getType(),
                                         ValueRange{lhs, rhs}, zeroTensor)
               .getResult(0);
-      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, matmul);
+      rewriter.replaceOp(
+          op, castAccumulatorToResultType(rewriter, loc, matmul, resultType));
       return success();
     }
 
@@ -244,6 +362,18 @@ public:
         return rewriter.notifyMatchFailure(op, "expected batch dimensions");
       }
 
+      // Read transposed matrices (e.g. `q @ k.transpose(-2, -1)`) directly,
+      // with swapped indexing maps.
+      Value untransposedLhs =
+          getTransposeInput(rewriter, loc, getTypeConverter(), op.self());
+      Value untransposedRhs =
+          getTransposeInput(rewriter, loc, getTypeConverter(), op.other());
+      if (untransposedLhs)
+        lhs = untransposedLhs;
+      if (untransposedRhs)
+        rhs = untransposedRhs;
+      bool anyTransposed = untransposedLhs || untransposedRhs;
+
       // The `broadcastedBatchShape` contains batch dimensions of the resultant
       // matrix.
       SmallVector<Value> broadcastedBatchShape(batchRank);
@@ -262,49 +392,87 @@ public:
         broadcastedBatchShape[batchRank - i] = maxDim;
       }
 
-      Value lhsDim0 = getDimOp(rewriter, loc, lhs, lhsRank - 2);
-      Value lhsDim1 = getDimOp(rewriter, loc, lhs, lhsRank - 1);
-      Value rhsDim0 = getDimOp(rewriter, loc, rhs, rhsRank - 2);
-      Value rhsDim1 = getDimOp(rewriter, loc, rhs, rhsRank - 1);
+      unsigned lhsRowDim = lhsRank - (untransposedLhs ? 1 : 2);
+      unsigned lhsColDim = lhsRank - (untransposedLhs ? 2 : 1);
+      unsigned rhsRowDim = rhsRank - (untransposedRhs ? 1 : 2);
+      unsigned rhsColDim = rhsRank - (untransposedRhs ? 2 : 1);
+      Value lhsDim0 = getDimOp(rewriter, loc, lhs, lhsRowDim);
+      Value lhsDim1 = getDimOp(rewriter, loc, lhs, lhsColDim);
+      Value rhsDim0 = getDimOp(rewriter, loc, rhs, rhsRowDim);
+      Value rhsDim1 = getDimOp(rewriter, loc, rhs, rhsColDim);
       checkDimEqualHelper(rewriter, loc, lhsDim1, rhsDim0);
 
-      // Compute broadcasted shape of both the matrices in integer format.
-      SmallVector<Value> lhsBroadcastToShape(broadcastedBatchShape);
-      lhsBroadcastToShape.push_back(lhsDim0);
-      lhsBroadcastToShape.push_back(lhsDim1);
-      SmallVector<Value> rhsBroadcastToShape(broadcastedBatchShape);
-      rhsBroadcastToShape.push_back(rhsDim0);
-      rhsBroadcastToShape.push_back(rhsDim1);
-      for (unsigned i = 0; i < maxRank; i++) {
-        lhsBroadcastToShape[i] =
-            castIndexToInt64(rewriter, loc, lhsBroadcastToShape[i]);
-        rhsBroadcastToShape[i] =
-            castIndexToInt64(rewriter, loc, rhsBroadcastToShape[i]);
-      }
-
-      // Broadcast the batch dimensions of both the matrices.
-      Value broadcastedLhs, broadcastedRhs;
-      if (failed(torch_to_linalg::broadcastToGivenShape(
-              op, rewriter, lhs, lhsBroadcastToShape, broadcastedLhs))) {
-        return rewriter.notifyMatchFailure(
-            op, "unable to perform broadcast operation");
-      }
-      if (failed(torch_to_linalg::broadcastToGivenShape(
-              op, rewriter, rhs, rhsBroadcastToShape, broadcastedRhs))) {
-        return rewriter.notifyMatchFailure(
-            op, "unable to perform broadcast operation");
+      // Rather than materializing the broadcast operands, the broadcast is
+      // expressed in the indexing maps: a batch dimension that an operand
+      // lacks or has with a static size of 1 is not indexed by the loop, and
+      // the other ones must match the result. Returns the batch part of the
+      // indexing map of `operand`, and whether it is broadcast.
+      auto getBatchExprs = [&](Value operand, SmallVector<AffineExpr> &exprs) {
+        auto type = operand.getType().cast<RankedTensorType>();
+        unsigned operandBatchRank = type.getRank() - 2;
+        bool isBroadcast = operandBatchRank != batchRank;
+        for (unsigned i = 0; i < operandBatchRank; i++) {
+          unsigned resultDim = batchRank - operandBatchRank + i;
+          if (type.getDimSize(i) == 1) {
+            exprs.push_back(rewriter.getAffineConstantExpr(0));
+            isBroadcast |= resultType.getDimSize(resultDim) != 1;
+            continue;
+          }
+          Value dim = getDimOp(rewriter, loc, operand, i);
+          checkDimEqualHelper(rewriter, loc, dim,
+                              broadcastedBatchShape[resultDim]);
+          exprs.push_back(rewriter.getAffineDimExpr(resultDim));
+        }
+        return isBroadcast;
+      };
+      SmallVector<AffineExpr> lhsExpr;
+      SmallVector<AffineExpr> rhsExpr;
+      bool isLhsBroadcast = getBatchExprs(lhs, lhsExpr);
+      bool isRhsBroadcast = getBatchExprs(rhs, rhsExpr);
+
+      // `tensor.expand_shape` supports at most one dynamic dimension per
+      // expanded group.
+      auto hasAtMostOneDynamicDim = [](ArrayRef<int64_t> shape) {
+        return llvm::count(shape, kUnknownSize) <= 1;
+      };
+      ArrayRef<int64_t> resultShape = resultType.getShape();
+      auto accResultType = RankedTensorType::get(resultShape, elementType);
+
+      // A batch of matrices times a single matrix (e.g. a linear layer
+      // applied to a batch of sequences) is a single `linalg.matmul` on the
+      // lhs with its batch dimensions collapsed into its rows.
+      if (rhsRank == 2 && !isLhsBroadcast && !anyTransposed &&
+          hasAtMostOneDynamicDim(resultShape.drop_back())) {
+        SmallVector<ReassociationIndices> reassociation(2);
+        for (unsigned i = 0; i < maxRank; i++)
+          reassociation[i == maxRank - 1].push_back(i);
+        Value collapsedLhs = rewriter.create<tensor::CollapseShapeOp>(
+            loc, lhs, reassociation);
+        SmallVector<Value> matmulShape = {
+            getDimOp(rewriter, loc, collapsedLhs, 0), rhsDim1};
+        Value initTensor = rewriter.create<linalg::InitTensorOp>(
+            loc, getAsOpFoldResult(matmulShape), elementType);
+        Value c0 = rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getZeroAttr(elementType));
+        Value zeroTensor =
+            rewriter.create<linalg::FillOp>(loc, c0, initTensor).getResult(0);
+        Value matmul =
+            rewriter
+                .create<linalg::MatmulOp>(loc, zeroTensor.getType(),
+                                          ValueRange{collapsedLhs, rhs},
+                                          zeroTensor)
+                .getResult(0);
+        Value expandResult = rewriter.create<tensor::ExpandShapeOp>(
+            loc, accResultType, matmul, reassociation);
+        rewriter.replaceOp(op, castAccumulatorToResultType(
+                                   rewriter, loc, expandResult, resultType));
+        return success();
       }
 
-      // Check if the result of the matrix multiplication has more than one
-      // dynamic batch dimensions.
-      ArrayRef<int64_t> batchDimsInt = resultType.getShape().drop_back(2);
-      bool multipleDynamicBatchDims =
-          llvm::count(batchDimsInt, kUnknownSize) > 1;
-
-      // TODO: Lowering to `linalg.BatchMatmul` is only possible when there is
-      // at most one dynamic batch dimension due to limited support of the
-      // `tensor.ExpandShape` op.
-      if (!multipleDynamicBatchDims) {
+      // Without broadcasting, the batch dimensions of both the matrices can
+      // be collapsed into one for `linalg.batch_matmul`.
+      if (!isLhsBroadcast && !isRhsBroadcast && !anyTransposed &&
+          hasAtMostOneDynamicDim(resultShape.drop_back(2))) {
         // Collapse the batch dimensions into one dimension. The resultant rank
         // will always be 3.
         SmallVector<ReassociationIndices> reassociation(3);
@@ -314,9 +482,9 @@ public:
           reassociation[j].push_back(i);
         }
         Value collapsedLhs = rewriter.create<tensor::CollapseShapeOp>(
-            op->getLoc(), broadcastedLhs, reassociation);
+            op->getLoc(), lhs, reassociation);
         Value collapsedRhs = rewriter.create<tensor::CollapseShapeOp>(
-            op->getLoc(), broadcastedRhs, reassociation);
+            op->getLoc(), rhs, reassociation);
 
         // Compute the result shape after collapsing the batch dimensions.
         SmallVector<Value> collapsedResultShape;
@@ -344,19 +512,15 @@ public:
                     ValueRange{collapsedLhs, collapsedRhs}, zeroTensor)
                 .getResult(0);
         Value expandResult = rewriter.create<tensor::ExpandShapeOp>(
-            loc, resultType, batchMatMul, reassociation);
-        rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType,
-                                                    expandResult);
+            loc, accResultType, batchMatMul, reassociation);
+        rewriter.replaceOp(op, castAccumulatorToResultType(
+                                   rewriter, loc, expandResult, resultType));
         return success();
       }
 
-      SmallVector<AffineExpr> lhsExpr;
-      SmallVector<AffineExpr> rhsExpr;
       SmallVector<AffineExpr> outExpr;
       SmallVector<StringRef> iteratorTypes;
       for (unsigned i = 0; i < batchRank; i++) {
-        lhsExpr.push_back(rewriter.getAffineDimExpr(i));
-        rhsExpr.push_back(rewriter.getAffineDimExpr(i));
         outExpr.push_back(rewriter.getAffineDimExpr(i));
         iteratorTypes.push_back(getParallelIteratorTypeName());
       }
@@ -364,13 +528,17 @@ public:
                                      rewriter.getAffineDimExpr(batchRank + 1)});
       rhsExpr.insert(rhsExpr.end(), {rewriter.getAffineDimExpr(batchRank + 1),
                                      rewriter.getAffineDimExpr(batchRank + 2)});
+      if (untransposedLhs)
+        std::swap(lhsExpr[lhsExpr.size() - 2], lhsExpr.back());
+      if (untransposedRhs)
+        std::swap(rhsExpr[rhsExpr.size() - 2], rhsExpr.back());
       outExpr.insert(outExpr.end(), {rewriter.getAffineDimExpr(batchRank),
                                      rewriter.getAffineDimExpr(batchRank + 2)});
 
-      SmallVector<Value> resultShape(broadcastedBatchShape);
-      resultShape.insert(resultShape.end(), {lhsDim0, rhsDim1});
+      SmallVector<Value> outShape(broadcastedBatchShape);
+      outShape.insert(outShape.end(), {lhsDim0, rhsDim1});
       Value zeroTensor =
-          createZeroInitTensor(rewriter, loc, resultShape, elementType);
+          createZeroInitTensor(rewriter, loc, outShape, elementType);
       auto indexingMaps =
           AffineMap::inferFromExprList({lhsExpr, rhsExpr, outExpr});
       iteratorTypes.insert(iteratorTypes.end(),
@@ -379,19 +547,23 @@ public:
       Value finalRes =
           rewriter
               .create<linalg::GenericOp>(
-                  loc, zeroTensor.getType(),
-                  ValueRange{broadcastedLhs, broadcastedRhs}, zeroTensor,
+                  loc, zeroTensor.getType(), ValueRange{lhs, rhs}, zeroTensor,
                   /*indexingMaps=*/indexingMaps,
                   /*iteratorTypes=*/iteratorTypes,
                   [&](OpBuilder &b, Location loc, ValueRange args) {
-                    Value l = args[0], r = args[1], res = args[2];
+                    Value res = args[2];
+                    Value l = convertScalarToDtype(b, loc, args[0],
+                                                   res.getType());
+                    Value r = convertScalarToDtype(b, loc, args[1],
+                                                   res.getType());
                     Value mul = b.create<arith::MulFOp>(loc, l, r);
                     Value add = b.create<arith::AddFOp>(loc, mul, res);
                     b.create<linalg::YieldOp>(loc, add);
                   })
               .getResult(0);
 
-      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, finalRes);
+      rewriter.replaceOp(
+          op, castAccumulatorToResultType(rewriter, loc, finalRes, resultType));
       return success();
     }
     return failure();
@@ -437,8 +609,11 @@ public:
     // Check the matrixs shapes are valid for mulplication.
     checkDimEqualHelper(rewriter, loc, lhsDim2, rhsDim1);
 
-    Type newResultType = getTypeConverter()->convertType(op.getType());
-    Type elementType = newResultType.cast<TensorType>().getElementType();
+    auto newResultType = getTypeConverter()
+                             ->convertType(op.getType())
+                             .cast<RankedTensorType>();
+    Type elementType =
+        getAccumulatorElementType(newResultType.getElementType());
     Value initTensor0 = createZeroInitTensor(
         rewriter, loc, ValueRange{lhsDim0, lhsDim1, rhsDim2}, elementType);
 
@@ -447,7 +622,8 @@ public:
             .create<linalg::BatchMatmulOp>(loc, initTensor0.getType(),
                                            ValueRange{lhs, rhs}, initTensor0)
             .getResult(0);
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, bmm);
+    rewriter.replaceOp(
+        op, castAccumulatorToResultType(rewriter, loc, bmm, newResultType));
     return success();
   }
 };
@@ -501,6 +677,21 @@ public:
             op, "unimplemented: size-1 broadcasting for aten::LinearOp");
     }
 
+    // Collapse the batch dimension of a rank 3 input into its rows, so that
+    // this is a single `linalg.matmul` with the weights as they are, rather
+    // than a `linalg.batch_matmul` with the weights copied for every batch.
+    // `tensor.expand_shape` can't split a dimension into two dynamic ones, so
+    // that case keeps the batched form.
+    ArrayRef<int64_t> inputShape = inputType.getShape();
+    SmallVector<ReassociationIndices> batchReassociation = {{0, 1}, {2}};
+    bool collapseBatch =
+        inputType.getRank() == 3 &&
+        llvm::count(inputShape.drop_back(), kUnknownSize) <= 1;
+    if (collapseBatch) {
+      input = rewriter.create<tensor::CollapseShapeOp>(loc, input,
+                                                       batchReassociation);
+      inputType = input.getType().cast<RankedTensorType>();
+    }
 
     Value batchDim = nullptr;
     int restDim = 0;
@@ -511,8 +702,18 @@ public:
 
     Value inputDim0 = getDimOp(rewriter, loc, input, restDim + 0);
     Value inputDim1 = getDimOp(rewriter, loc, input, restDim + 1);
-    Value weightDim0 = getDimOp(rewriter, loc, weight, 0);
-    Value weightDim1 = getDimOp(rewriter, loc, weight, 1);
+    // If the weights are a transpose, the matmul reads its input directly,
+    // which is already in the (K, M) layout it needs.
+    Value untransposedWeight =
+        weightType.getRank() == 2
+            ? getTransposeInput(rewriter, loc, getTypeConverter(), op.weight())
+            : nullptr;
+    Value weightDim0 = untransposedWeight
+                           ? getDimOp(rewriter, loc, untransposedWeight, 1)
+                           : getDimOp(rewriter, loc, weight, 0);
+    Value weightDim1 = untransposedWeight
+                           ? getDimOp(rewriter, loc, untransposedWeight, 0)
+                           : getDimOp(rewriter, loc, weight, 1);
     Value contractingDimEqual = rewriter.create<arith::CmpIOp>(
         loc, arith::CmpIPredicate::eq, inputDim1, weightDim1);
     rewriter.create<cf::AssertOp>(
@@ -531,13 +732,13 @@ public:
           rewriter.getStringAttr("mismatching bias size for aten.linear"));
     }
 
+    Type accType = getAccumulatorElementType(inputType.getElementType());
     Value initTensor;
     SmallVector<AffineMap> broadcastIndexingMaps;
     Value transposedWeightInitTensor;
     if (inputType.getRank() > 2) {
       initTensor = rewriter.create<linalg::InitTensorOp>(
-          loc, ValueRange{batchDim, inputDim0, weightDim0},
-          inputType.getElementType());
+          loc, ValueRange{batchDim, inputDim0, weightDim0}, accType);
       transposedWeightInitTensor = rewriter.create<linalg::InitTensorOp>(
           loc, ValueRange{batchDim, weightDim1, weightDim0},
           weightType.getElementType());
@@ -548,8 +749,7 @@ public:
           rewriter.getMultiDimIdentityMap(inputType.getRank())};
     } else {
       initTensor = rewriter.create<linalg::InitTensorOp>(
-          loc, ValueRange{inputDim0, weightDim0},
-          inputType.getElementType());
+          loc, ValueRange{inputDim0, weightDim0}, accType);
       transposedWeightInitTensor = rewriter.create<linalg::InitTensorOp>(
           loc, ValueRange{weightDim1, weightDim0}, weightType.getElementType());
       broadcastIndexingMaps = {
@@ -568,15 +768,14 @@ public:
                   loc, initTensor.getType(), bias, initTensor,
                   /*indexingMaps=*/broadcastIndexingMaps,
                   /*iteratorTypes=*/iteratorTypes,
-                  [](OpBuilder &b, Location loc, ValueRange args) {
-                    b.create<linalg::YieldOp>(loc, args[0]);
+                  [&](OpBuilder &b, Location loc, ValueRange args) {
+                    b.create<linalg::YieldOp>(
+                        loc, convertScalarToDtype(b, loc, args[0], accType));
                   })
               .getResult(0);
     } else {
-      Type elementType =
-          input.getType().cast<RankedTensorType>().getElementType();
       Value c0float = rewriter.create<arith::ConstantOp>(
-          loc, FloatAttr::get(elementType, 0.0));
+          loc, FloatAttr::get(accType, 0.0));
       broadcasted = rewriter.create<linalg::FillOp>(loc, c0float, initTensor)
                            .getResult(0);
     }
@@ -591,17 +790,56 @@ public:
              rewriter.getAffineDimExpr(0 + restDim)},
             context),
         rewriter.getMultiDimIdentityMap(inputType.getRank())};
-    Value transposedWeights =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, transposedWeightInitTensor.getType(), weight,
-                transposedWeightInitTensor,
-                /*indexingMaps=*/transposeIndexingMaps,
-                /*iteratorTypes=*/iteratorTypes,
-                [](OpBuilder &b, Location loc, ValueRange args) {
-                  b.create<linalg::YieldOp>(loc, args[0]);
-                })
-            .getResult(0);
+    // If the weights are constant, transpose them at compile time instead of
+    // at every invocation. Only the broadcast over the batch dimension, if
+    // any, remains to be done at runtime.
+    DenseElementsAttr weightAttr;
+    bool weightsTransposed = false;
+    if (untransposedWeight) {
+      weight = untransposedWeight;
+      weightsTransposed = true;
+    } else if (weightType.getRank() == 2 &&
+               matchPattern(op.weight(), m_Constant(&weightAttr))) {
+      FailureOr<DenseElementsAttr> transposedWeightAttr =
+          transposeElementsAttr(weightAttr, {1, 0});
+      if (succeeded(transposedWeightAttr)) {
+        // The elements of signed and unsigned integer literals are converted
+        // to the signless type of the builtin tensor.
+        DenseElementsAttr elements = *transposedWeightAttr;
+        Type elementType = weightType.getElementType();
+        if (elements.getElementType() != elementType) {
+          unsigned bitWidth = elementType.getIntOrFloatBitWidth();
+          elements = elements.mapValues(elementType, [&](const APInt &v) {
+            return APInt(bitWidth, v.getSExtValue());
+          });
+        }
+        weight = rewriter.create<arith::ConstantOp>(loc, elements);
+        weightsTransposed = true;
+      }
+    }
+    if (weightsTransposed)
+      transposeIndexingMaps[0] = AffineMap::get(
+          /*dimCount=*/inputType.getRank(), /*symbolCount=*/0,
+          {rewriter.getAffineDimExpr(0 + restDim),
+           rewriter.getAffineDimExpr(1 + restDim)},
+          context);
+    Value transposedWeights;
+    if (!batchDim && weightsTransposed) {
+      transposedWeights = weight;
+      rewriter.eraseOp(transposedWeightInitTensor.getDefiningOp());
+    } else {
+      transposedWeights =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, transposedWeightInitTensor.getType(), weight,
+                  transposedWeightInitTensor,
+                  /*indexingMaps=*/transposeIndexingMaps,
+                  /*iteratorTypes=*/iteratorTypes,
+                  [](OpBuilder &b, Location loc, ValueRange args) {
+                    b.create<linalg::YieldOp>(loc, args[0]);
+                  })
+              .getResult(0);
+    }
     Value matmul;
     if (batchDim)
       matmul = rewriter
@@ -616,18 +854,530 @@ public:
                        ValueRange{input, transposedWeights}, broadcasted)
                    .getResult(0);
 
-    Type newResultType = getTypeConverter()->convertType(op.getType());
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, matmul);
+    if (collapseBatch) {
+      int64_t outputSize = weightType.getDimSize(0);
+      matmul = rewriter.create<tensor::CastOp>(
+          loc,
+          RankedTensorType::get({inputType.getDimSize(0), outputSize},
+                                accType),
+          matmul);
+      matmul = rewriter.create<tensor::ExpandShapeOp>(
+          loc,
+          RankedTensorType::get({inputShape[0], inputShape[1], outputSize},
+                                accType),
+          matmul, batchReassociation);
+    }
+
+    auto newResultType = getTypeConverter()
+                             ->convertType(op.getType())
+                             .cast<RankedTensorType>();
+    rewriter.replaceOp(
+        op, castAccumulatorToResultType(rewriter, loc, matmul, newResultType));
     return success();
   }
 };
 } // namespace
 
 namespace {
-class ConvertAtenConvolutionOp : public OpConversionPattern<AtenConvolutionOp> {
+// Quantized tensors are represented by their integer representation, so
+// creating one from it is a no-op.
+class ConvertPerTensorAffineCreateOp
+    : public OpConversionPattern<PerTensorAffineCreateOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(PerTensorAffineCreateOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Type resultType = getTypeConverter()->convertType(op.getType());
+    if (!resultType || adaptor.int_repr().getType() != resultType)
+      return rewriter.notifyMatchFailure(
+          op, "expected int_repr of the integer type of the result");
+    rewriter.replaceOp(op, adaptor.int_repr());
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Lowers `quantized::linear` keeping int8 math:
+//   acc[m, n] = sum_k (x[m, k] - x_zp) * (w[n, k] - w_zp)   (in i32)
+//   y[m, n] = clamp(round((acc[m, n] * x_scale * w_scale + bias[n]) /
+//                         y_scale) + y_zp)
+// The contraction has the arithmetic of `linalg.quantized_matmul`, but reads
+// the weights in the (N, K) layout that they are stored in, rather than the
+// (K, N) one that `linalg.quantized_matmul` requires. The requantization is a
+// single elementwise epilogue over the i32 accumulator.
+class ConvertQuantizedLinearOp : public OpConversionPattern<QuantizedLinearOp> {
 public:
   using OpConversionPattern::OpConversionPattern;
   LogicalResult
+  matchAndRewrite(QuantizedLinearOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    MLIRContext *context = op.getContext();
+    auto params = op.W_prepack().getDefiningOp<LinearParamsCreateOp>();
+    if (!params)
+      return rewriter.notifyMatchFailure(op, "expected known linear params");
+    Value inputScale, inputZeroPoint, weightScale, weightZeroPoint;
+    if (failed(getPerTensorQuantizationParams(op.X(), inputScale,
+                                              inputZeroPoint)) ||
+        failed(getPerTensorQuantizationParams(params.weight(), weightScale,
+                                              weightZeroPoint)))
+      return rewriter.notifyMatchFailure(
+          op, "expected per-tensor quantized input and weight");
+
+    auto inputDtype =
+        op.X().getType().cast<BaseTensorType>().getOptionalDtype();
+    auto weightDtype =
+        params.weight().getType().cast<BaseTensorType>().getOptionalDtype();
+    auto resultDtype = op.getType().cast<BaseTensorType>().getOptionalDtype();
+    auto isQuantized = [](Type dtype) {
+      return dtype && dtype.isa<QInt8Type, QUInt8Type>();
+    };
+    if (!isQuantized(inputDtype) || !isQuantized(weightDtype) ||
+        !isQuantized(resultDtype))
+      return rewriter.notifyMatchFailure(op, "expected 8-bit quantized types");
+
+    TypeConverter *typeConverter = getTypeConverter();
+    auto toBuiltin = [&](Value v) {
+      return typeConverter->materializeTargetConversion(
+          rewriter, loc, typeConverter->convertType(v.getType()), v);
+    };
+    Value input = adaptor.X();
+    Value weight = toBuiltin(params.weight());
+    auto inputType = input.getType().cast<RankedTensorType>();
+    auto weightType = weight.getType().cast<RankedTensorType>();
+    if (inputType.getRank() != 2 || weightType.getRank() != 2)
+      return rewriter.notifyMatchFailure(op,
+                                         "expected rank 2 input and weight");
+    Value bias;
+    if (params.bias()) {
+      bias = toBuiltin(params.bias());
+      auto biasType = bias.getType().cast<RankedTensorType>();
+      if (biasType.getRank() != 1 || !biasType.getElementType().isF32())
+        return rewriter.notifyMatchFailure(op, "expected rank 1 f32 bias");
+    }
+
+    Value inputDim0 = getDimOp(rewriter, loc, input, 0);
+    Value inputDim1 = getDimOp(rewriter, loc, input, 1);
+    Value weightDim0 = getDimOp(rewriter, loc, weight, 0);
+    Value weightDim1 = getDimOp(rewriter, loc, weight, 1);
+    checkDimEqualHelper(rewriter, loc, inputDim1, weightDim1);
+    if (bias)
+      checkDimEqualHelper(rewriter, loc, weightDim0,
+                          getDimOp(rewriter, loc, bias, 0));
+
+    Type i32Type = rewriter.getI32Type();
+    Type f32Type = rewriter.getF32Type();
+    auto toI32 = [&](Value zeroPoint) {
+      return rewriter.create<arith::TruncIOp>(loc, i32Type,
+                                              toBuiltin(zeroPoint));
+    };
+    Value inputZp = toI32(inputZeroPoint);
+    Value weightZp = toI32(weightZeroPoint);
+    bool isInputUnsigned = inputDtype.isa<QUInt8Type>();
+    bool isWeightUnsigned = weightDtype.isa<QUInt8Type>();
+
+    // (m, n, k)
+    AffineExpr m = rewriter.getAffineDimExpr(0);
+    AffineExpr n = rewriter.getAffineDimExpr(1);
+    AffineExpr k = rewriter.getAffineDimExpr(2);
+    SmallVector<AffineMap> indexingMaps = {
+        AffineMap::get(3, 0, {m, k}, context),
+        AffineMap::get(3, 0, {n, k}, context),
+        AffineMap::get(3, 0, {m, n}, context)};
+    SmallVector<StringRef> iteratorTypes = {getParallelIteratorTypeName(),
+                                            getParallelIteratorTypeName(),
+                                            getReductionIteratorTypeName()};
+    Value accInit = createZeroInitTensor(
+        rewriter, loc, ValueRange{inputDim0, weightDim0}, i32Type);
+    Value acc =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, accInit.getType(), ValueRange{input, weight}, accInit,
+                indexingMaps, iteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  auto extend = [&](Value v, bool isUnsigned) -> Value {
+                    if (isUnsigned)
+                      return b.create<arith::ExtUIOp>(loc, i32Type, v);
+                    return b.create<arith::ExtSIOp>(loc, i32Type, v);
+                  };
+                  Value x = b.create<arith::SubIOp>(
+                      loc, extend(args[0], isInputUnsigned), inputZp);
+                  Value w = b.create<arith::SubIOp>(
+                      loc, extend(args[1], isWeightUnsigned), weightZp);
+                  Value mul = b.create<arith::MulIOp>(loc, x, w);
+                  b.create<linalg::YieldOp>(
+                      loc, ValueRange{b.create<arith::AddIOp>(loc, args[2],
+                                                              mul)});
+                })
+            .getResult(0);
+
+    // Requantize. PyTorch rounds half to even, while this rounds half up;
+    // they only differ on exact ties.
+    auto toF32 = [&](Value scale) {
+      return rewriter.create<arith::TruncFOp>(loc, f32Type, toBuiltin(scale));
+    };
+    Value accScale = rewriter.create<arith::MulFOp>(loc, toF32(inputScale),
+                                                    toF32(weightScale));
+    Value resultScale = toF32(op.Y_scale_i());
+    Value resultZp = rewriter.create<arith::SIToFPOp>(
+        loc, f32Type, toBuiltin(op.Y_zero_point_i()));
+    bool isResultUnsigned = resultDtype.isa<QUInt8Type>();
+    Value qMin = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getF32FloatAttr(isResultUnsigned ? 0 : -128));
+    Value qMax = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getF32FloatAttr(isResultUnsigned ? 255 : 127));
+    Value half =
+        rewriter.create<arith::ConstantOp>(loc, rewriter.getF32FloatAttr(0.5));
+    SmallVector<Value> epilogueOperands = {acc};
+    if (bias)
+      epilogueOperands.push_back(bias);
+    Type i8Type = rewriter.getIntegerType(8);
+    Value result = torch_to_linalg::createElementwiseLinalgGeneric(
+        rewriter, loc, epilogueOperands, i8Type,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value real = b.create<arith::MulFOp>(
+              loc, b.create<arith::SIToFPOp>(loc, f32Type, args[0]), accScale);
+          if (bias)
+            real = b.create<arith::AddFOp>(loc, real, args[1]);
+          Value scaled = b.create<arith::DivFOp>(loc, real, resultScale);
+          Value rounded = b.create<math::FloorOp>(
+              loc, b.create<arith::AddFOp>(loc, scaled, half));
+          Value q = b.create<arith::AddFOp>(loc, rounded, resultZp);
+          q = b.create<arith::MaxFOp>(loc, q, qMin);
+          q = b.create<arith::MinFOp>(loc, q, qMax);
+          Value quantized =
+              isResultUnsigned
+                  ? b.create<arith::FPToUIOp>(loc, i8Type, q).getResult()
+                  : b.create<arith::FPToSIOp>(loc, i8Type, q).getResult();
+          b.create<linalg::YieldOp>(loc, quantized);
+        });
+    Type newResultType = typeConverter->convertType(op.getType());
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, result);
+    // The params hold a quantized tensor, which has no builtin counterpart
+    // once converted, so they can't be left behind.
+    if (params->hasOneUse())
+      rewriter.eraseOp(params);
+    return success();
+  }
+};
+} // namespace
+
+// Returns the reassociation merging dimensions `dim` and `dim + 1` of a tensor
+// of rank `rank + 1`.
+static SmallVector<ReassociationIndices>
+getGroupsReassociation(int64_t rank, int64_t dim) {
+  SmallVector<ReassociationIndices> reassociation(rank);
+  for (int64_t i = 0, j = 0; i < rank; i++) {
+    reassociation[i].push_back(j++);
+    if (i == dim)
+      reassociation[i].push_back(j++);
+  }
+  return reassociation;
+}
+
+// Splits dimension `dim` of `tensor` into `groups` and `size / groups`.
+static Value expandGroups(OpBuilder &b, Location loc, Value tensor,
+                          int64_t dim, int64_t groups) {
+  auto type = tensor.getType().cast<RankedTensorType>();
+  SmallVector<int64_t> shape(type.getShape());
+  int64_t size = shape[dim];
+  shape[dim] = size == kUnknownSize ? kUnknownSize : size / groups;
+  shape.insert(shape.begin() + dim, groups);
+  return b.create<tensor::ExpandShapeOp>(
+      loc, RankedTensorType::get(shape, type.getElementType()), tensor,
+      getGroupsReassociation(type.getRank(), dim));
+}
+
+// Creates a 2D convolution with `groups` groups, as a `linalg.generic` with
+// the indexing maps of `linalg.conv_2d_ngchw_fgchw`: the channels of the
+// input, weight and output are split into groups, and each group of output
+// channels only reduces over the input channels of its group.
+static Value createGroupedConv2D(OpBuilder &b, Location loc, Value input,
+                                 Value weight, Value init, int64_t groups,
+                                 ArrayRef<int64_t> strides,
+                                 ArrayRef<int64_t> dilations) {
+  MLIRContext *context = b.getContext();
+  Value groupedInput = expandGroups(b, loc, input, /*dim=*/1, groups);
+  Value groupedWeight = expandGroups(b, loc, weight, /*dim=*/0, groups);
+  Value groupedInit = expandGroups(b, loc, init, /*dim=*/1, groups);
+
+  // (n, g, f, oh, ow, c, kh, kw)
+  SmallVector<AffineExpr> d;
+  for (unsigned i = 0; i < 8; i++)
+    d.push_back(b.getAffineDimExpr(i));
+  AffineExpr h = d[3] * strides[0] + d[6] * dilations[0];
+  AffineExpr w = d[4] * strides[1] + d[7] * dilations[1];
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(8, 0, {d[0], d[1], d[5], h, w}, context),
+      AffineMap::get(8, 0, {d[1], d[2], d[5], d[6], d[7]}, context),
+      AffineMap::get(8, 0, {d[0], d[1], d[2], d[3], d[4]}, context)};
+  SmallVector<StringRef> iteratorTypes(5, getParallelIteratorTypeName());
+  iteratorTypes.append(3, getReductionIteratorTypeName());
+  Value conv =
+      b.create<linalg::GenericOp>(
+           loc, groupedInit.getType(), ValueRange{groupedInput, groupedWeight},
+           groupedInit, indexingMaps, iteratorTypes,
+           [](OpBuilder &b, Location loc, ValueRange args) {
+             Value mul = b.create<arith::MulFOp>(loc, args[0], args[1]);
+             b.create<linalg::YieldOp>(
+                 loc, ValueRange{b.create<arith::AddFOp>(loc, args[2], mul)});
+           })
+          .getResult(0);
+  return b.create<tensor::CollapseShapeOp>(
+      loc, init.getType(), conv, getGroupsReassociation(/*rank=*/4, /*dim=*/1));
+}
+
+// Creates a 2D depthwise convolution with a channel multiplier of 1, as a
+// `linalg.generic` with the indexing maps of
+// `linalg.depthwise_conv_2d_nchw_chw`. There is no reduction over channels.
+static Value createDepthwiseConv2D(OpBuilder &b, Location loc, Value input,
+                                   Value weight, Value init,
+                                   ArrayRef<int64_t> strides,
+                                   ArrayRef<int64_t> dilations) {
+  MLIRContext *context = b.getContext();
+  // Drop the unit input channel dimension of the weight.
+  auto weightType = weight.getType().cast<RankedTensorType>();
+  Value collapsedWeight = b.create<tensor::CollapseShapeOp>(
+      loc,
+      RankedTensorType::get({weightType.getDimSize(0), weightType.getDimSize(2),
+                             weightType.getDimSize(3)},
+                            weightType.getElementType()),
+      weight, getGroupsReassociation(/*rank=*/3, /*dim=*/0));
+
+  // (n, c, oh, ow, kh, kw)
+  SmallVector<AffineExpr> d;
+  for (unsigned i = 0; i < 6; i++)
+    d.push_back(b.getAffineDimExpr(i));
+  AffineExpr h = d[2] * strides[0] + d[4] * dilations[0];
+  AffineExpr w = d[3] * strides[1] + d[5] * dilations[1];
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(6, 0, {d[0], d[1], h, w}, context),
+      AffineMap::get(6, 0, {d[1], d[4], d[5]}, context),
+      AffineMap::get(6, 0, {d[0], d[1], d[2], d[3]}, context)};
+  SmallVector<StringRef> iteratorTypes(4, getParallelIteratorTypeName());
+  iteratorTypes.append(2, getReductionIteratorTypeName());
+  return b
+      .create<linalg::GenericOp>(
+          loc, init.getType(), ValueRange{input, collapsedWeight}, init,
+          indexingMaps, iteratorTypes,
+          [](OpBuilder &b, Location loc, ValueRange args) {
+            Value mul = b.create<arith::MulFOp>(loc, args[0], args[1]);
+            b.create<linalg::YieldOp>(
+                loc, ValueRange{b.create<arith::AddFOp>(loc, args[2], mul)});
+          })
+      .getResult(0);
+}
+
+// Creates a 2D transposed convolution with a dilation of 1 as a
+// `linalg.generic` that gathers, for each output element, the input elements
+// and kernel taps contributing to it:
+//   out[n, f, oy, ox] += in[n, c, iy, ix] * weight[c, f, ky, kx]
+//   where oy + padding = iy * stride + ky (and likewise along x).
+// For a given `oy`, only the taps ky = (oy + padding) % stride + j * stride
+// contribute, with iy = (oy + padding) / stride - j. So rather than
+// convolving an input stuffed with zeros, the reduction is over the
+// ceil(kernelSize / stride) values of `j`, and out of bounds taps are masked.
+static Value createTransposedConv2D(OpBuilder &b, Location loc, Value input,
+                                    Value weight, Value init,
+                                    ArrayRef<int64_t> strides,
+                                    ArrayRef<int64_t> paddings) {
+  Type elementType = init.getType().cast<RankedTensorType>().getElementType();
+  // The reduction dims (c, jy, jx) don't index any operand, so give them an
+  // operand to infer their sizes from.
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Value> reductionSizes = {getDimOp(b, loc, input, 1)};
+  SmallVector<Value> inputSizes, kernelSizes;
+  for (unsigned i = 0; i < 2; i++) {
+    inputSizes.push_back(getDimOp(b, loc, input, i + 2));
+    kernelSizes.push_back(getDimOp(b, loc, weight, i + 2));
+    // ceil(kernelSize / stride)
+    Value stride = b.create<arith::ConstantIndexOp>(loc, strides[i]);
+    Value strideSub1 = b.create<arith::SubIOp>(loc, stride, one);
+    reductionSizes.push_back(b.create<arith::DivUIOp>(
+        loc, b.create<arith::AddIOp>(loc, kernelSizes[i], strideSub1),
+        stride));
+  }
+  Value reductionShape =
+      b.create<linalg::InitTensorOp>(loc, reductionSizes, elementType);
+
+  MLIRContext *context = b.getContext();
+  // (n, f, oy, ox, c, jy, jx)
+  SmallVector<AffineExpr> d;
+  for (unsigned i = 0; i < 7; i++)
+    d.push_back(b.getAffineDimExpr(i));
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(7, 0, {d[4], d[5], d[6]}, context),
+      AffineMap::get(7, 0, {d[0], d[1], d[2], d[3]}, context)};
+  SmallVector<StringRef> iteratorTypes(4, getParallelIteratorTypeName());
+  iteratorTypes.append(3, getReductionIteratorTypeName());
+  return b
+      .create<linalg::GenericOp>(
+          loc, init.getType(), reductionShape, init, indexingMaps,
+          iteratorTypes,
+          [&](OpBuilder &b, Location loc, ValueRange args) {
+            Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+            Value n = b.create<linalg::IndexOp>(loc, 0);
+            Value f = b.create<linalg::IndexOp>(loc, 1);
+            Value c = b.create<linalg::IndexOp>(loc, 4);
+            Value valid;
+            SmallVector<Value> inputIndices = {n, c};
+            SmallVector<Value> weightIndices = {c, f};
+            for (unsigned i = 0; i < 2; i++) {
+              Value o = b.create<linalg::IndexOp>(loc, 2 + i);
+              Value j = b.create<linalg::IndexOp>(loc, 5 + i);
+              Value stride = b.create<arith::ConstantIndexOp>(loc, strides[i]);
+              Value padding =
+                  b.create<arith::ConstantIndexOp>(loc, paddings[i]);
+              Value position = b.create<arith::AddIOp>(loc, o, padding);
+              Value k = b.create<arith::AddIOp>(
+                  loc, b.create<arith::RemUIOp>(loc, position, stride),
+                  b.create<arith::MulIOp>(loc, j, stride));
+              // When j > position / stride, the subtraction wraps around and
+              // fails the unsigned bounds check.
+              Value in = b.create<arith::SubIOp>(
+                  loc, b.create<arith::DivUIOp>(loc, position, stride), j);
+              Value inBounds = b.create<arith::AndIOp>(
+                  loc,
+                  b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult, k,
+                                          kernelSizes[i]),
+                  b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult, in,
+                                          inputSizes[i]));
+              valid =
+                  valid ? b.create<arith::AndIOp>(loc, valid, inBounds)
+                        : inBounds;
+              inputIndices.push_back(in);
+              weightIndices.push_back(k);
+            }
+            // Clamp the indices of masked taps to stay in bounds.
+            for (unsigned i = 2; i < 4; i++) {
+              inputIndices[i] = b.create<arith::SelectOp>(
+                  loc, valid, inputIndices[i], zero);
+              weightIndices[i] = b.create<arith::SelectOp>(
+                  loc, valid, weightIndices[i], zero);
+            }
+            Value mul = b.create<arith::MulFOp>(
+                loc, b.create<tensor::ExtractOp>(loc, input, inputIndices),
+                b.create<tensor::ExtractOp>(loc, weight, weightIndices));
+            Value zeroFloat = b.create<arith::ConstantOp>(
+                loc, FloatAttr::get(elementType, 0.0));
+            Value contribution =
+                b.create<arith::SelectOp>(loc, valid, mul, zeroFloat);
+            b.create<linalg::YieldOp>(
+                loc, ValueRange{
+                         b.create<arith::AddFOp>(loc, args[1], contribution)});
+          })
+      .getResult(0);
+}
+
+// Returns the size of dimension `dim` of `tensor`, as an attribute if it is
+// static.
+static OpFoldResult getDimSize(OpBuilder &b, Location loc, Value tensor,
+                               int64_t dim) {
+  int64_t size = tensor.getType().cast<RankedTensorType>().getDimSize(dim);
+  if (size != kUnknownSize)
+    return b.getIndexAttr(size);
+  return getDimOp(b, loc, tensor, dim);
+}
+
+// Creates a 2D convolution of the already padded `input` by unfolding its
+// patches into the columns of a matrix (im2col) and multiplying the weight,
+// viewed as a F x (C * KH * KW) matrix, with it:
+//   cols[(c, kh, kw), (n, oh, ow)] = input[n, c, oh * sh + kh * dh,
+//                                          ow * sw + kw * dw]
+//   out[n, f, oh, ow] = init[n, f, oh, ow] + (weight x cols)[f, (n, oh, ow)]
+// This materializes KH * KW copies of the input, but turns the convolution
+// into a `linalg.matmul`, which backends optimize much better than the
+// convolution loop nest. The kernel and output spatial sizes (`outputSizes`)
+// must be static.
+static Value createIm2colConv2D(OpBuilder &b, Location loc, Value input,
+                                Value weight, Value init,
+                                ArrayRef<int64_t> outputSizes,
+                                ArrayRef<int64_t> strides,
+                                ArrayRef<int64_t> dilations) {
+  MLIRContext *context = b.getContext();
+  Type elementType = init.getType().cast<RankedTensorType>().getElementType();
+  auto weightType = weight.getType().cast<RankedTensorType>();
+
+  // (c, kh, kw, n, oh, ow)
+  SmallVector<AffineExpr> d;
+  for (unsigned i = 0; i < 6; i++)
+    d.push_back(b.getAffineDimExpr(i));
+  AffineExpr h = d[4] * strides[0] + d[1] * dilations[0];
+  AffineExpr w = d[5] * strides[1] + d[2] * dilations[1];
+  SmallVector<OpFoldResult> colsSizes = {
+      getDimSize(b, loc, input, 1),
+      b.getIndexAttr(weightType.getDimSize(2)),
+      b.getIndexAttr(weightType.getDimSize(3)),
+      getDimSize(b, loc, input, 0),
+      b.getIndexAttr(outputSizes[0]),
+      b.getIndexAttr(outputSizes[1])};
+  Value colsInit =
+      b.create<linalg::InitTensorOp>(loc, colsSizes, elementType);
+  SmallVector<AffineMap> colsIndexingMaps = {
+      AffineMap::get(6, 0, {d[3], d[0], h, w}, context),
+      b.getMultiDimIdentityMap(6)};
+  SmallVector<StringRef> colsIteratorTypes(6, getParallelIteratorTypeName());
+  Value cols = b.create<linalg::GenericOp>(
+                    loc, colsInit.getType(), input, colsInit,
+                    colsIndexingMaps, colsIteratorTypes,
+                    [](OpBuilder &b, Location loc, ValueRange args) {
+                      b.create<linalg::YieldOp>(loc, args[0]);
+                    })
+                   .getResult(0);
+  SmallVector<ReassociationIndices> colsReassociation = {{0, 1, 2}, {3, 4, 5}};
+  Value colsMatrix =
+      b.create<tensor::CollapseShapeOp>(loc, cols, colsReassociation);
+  SmallVector<ReassociationIndices> weightReassociation = {{0}, {1, 2, 3}};
+  Value weightMatrix =
+      b.create<tensor::CollapseShapeOp>(loc, weight, weightReassociation);
+
+  SmallVector<OpFoldResult> matmulSizes = {
+      getDimSize(b, loc, weightMatrix, 0), getDimSize(b, loc, colsMatrix, 1)};
+  Value matmulInit =
+      b.create<linalg::InitTensorOp>(loc, matmulSizes, elementType);
+  Value c0float =
+      b.create<arith::ConstantOp>(loc, FloatAttr::get(elementType, 0.0));
+  Value zeroMatmulInit =
+      b.create<linalg::FillOp>(loc, c0float, matmulInit).getResult(0);
+  Value matmul = b.create<linalg::MatmulOp>(
+                      loc, zeroMatmulInit.getType(),
+                      ValueRange{weightMatrix, colsMatrix}, zeroMatmulInit)
+                     .getResult(0);
+
+  // Split the columns back into (n, oh, ow), and add the (f, n, oh, ow)
+  // product to the (n, f, oh, ow) init.
+  auto matmulType = matmul.getType().cast<RankedTensorType>();
+  auto inputType = input.getType().cast<RankedTensorType>();
+  auto expandedType = RankedTensorType::get(
+      {matmulType.getDimSize(0), inputType.getDimSize(0), outputSizes[0],
+       outputSizes[1]},
+      elementType);
+  SmallVector<ReassociationIndices> matmulReassociation = {{0}, {1, 2, 3}};
+  Value expanded = b.create<tensor::ExpandShapeOp>(loc, expandedType, matmul,
+                                                   matmulReassociation);
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(4, 0, {d[1], d[0], d[2], d[3]}, context),
+      b.getMultiDimIdentityMap(4)};
+  SmallVector<StringRef> iteratorTypes(4, getParallelIteratorTypeName());
+  return b
+      .create<linalg::GenericOp>(
+          loc, init.getType(), expanded, init, indexingMaps, iteratorTypes,
+          [](OpBuilder &b, Location loc, ValueRange args) {
+            Value add = b.create<arith::AddFOp>(loc, args[1], args[0]);
+            b.create<linalg::YieldOp>(loc, add);
+          })
+      .getResult(0);
+}
+
+namespace {
+class ConvertAtenConvolutionOp : public OpConversionPattern<AtenConvolutionOp> {
+public:
+  ConvertAtenConvolutionOp(TypeConverter &typeConverter, MLIRContext *context,
+                           bool convIm2col)
+      : OpConversionPattern(typeConverter, context), convIm2col(convIm2col) {}
+  LogicalResult
   matchAndRewrite(AtenConvolutionOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
@@ -672,24 +1422,51 @@ public:
     for (size_t i = 2; i < inRank; i++)
       weightDims.push_back(getDimOp(rewriter, loc, weight, i));
 
-    // Guard unused values (transposed, groups)
-    int64_t group_size;
-    if (!matchPattern(op.groups(), m_TorchConstantInt(&group_size)) ||
-        group_size != 1)
+    int64_t groups;
+    if (!matchPattern(op.groups(), m_TorchConstantInt(&groups)) || groups < 1)
       return rewriter.notifyMatchFailure(
-          op, "unimplemented: only group size of 1 supported");
-    bool transposed = true;
-    if (!matchPattern(op.transposed(), m_TorchConstantBool(&transposed)) ||
-        transposed)
+          op, "unimplemented: only constant positive groups supported");
+    int64_t numChannels =
+        input.getType().cast<RankedTensorType>().getDimSize(1);
+    auto weightType = weight.getType().cast<RankedTensorType>();
+    int64_t numFilters = weightType.getDimSize(0);
+    if (groups != 1 && (numChannels == kUnknownSize ||
+                        numFilters == kUnknownSize ||
+                        numChannels % groups != 0 || numFilters % groups != 0))
       return rewriter.notifyMatchFailure(
-          op, "unimplemented: only non-transposed convolution supported");
+          op, "unimplemented: grouped convolution with channels that are "
+              "dynamic or not divisible by groups");
+    bool isDepthwise = groups != 1 && groups == numChannels &&
+                       numFilters == groups && weightType.getDimSize(1) == 1;
 
-    // Pad the input tensor according to padding.
-    SmallVector<int64_t, 4> paddingIncludingNC = {0, 0};
-    paddingIncludingNC.insert(paddingIncludingNC.end(), paddingInts.begin(),
-                              paddingInts.end());
-    Value paddedInput = torch_to_linalg::getZeroPaddedTensor(
-        op, rewriter, input, paddingIncludingNC);
+    bool transposed;
+    if (!matchPattern(op.transposed(), m_TorchConstantBool(&transposed)))
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: only constant transposed supported");
+    SmallVector<int64_t> outputPaddingInts;
+    if (transposed) {
+      if (groups != 1)
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: grouped transposed convolution");
+      if (llvm::any_of(dilationInts, [](int64_t d) { return d != 1; }))
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: dilated transposed convolution");
+      if (!matchPattern(op.output_padding(),
+                        m_TorchConstantIntList(outputPaddingInts)))
+        return rewriter.notifyMatchFailure(
+            op, "only support constant int output paddings");
+    }
+
+    // Pad the input tensor according to padding. Transposed convolutions
+    // crop their output by the padding instead.
+    Value paddedInput = input;
+    if (!transposed) {
+      SmallVector<int64_t, 4> paddingIncludingNC = {0, 0};
+      paddingIncludingNC.insert(paddingIncludingNC.end(), paddingInts.begin(),
+                                paddingInts.end());
+      paddedInput = torch_to_linalg::getZeroPaddedTensor(op, rewriter, input,
+                                                         paddingIncludingNC);
+    }
 
     SmallVector<Value> paddingIntValues =
         getAsConstantIntValues(rewriter, loc, paddingInts);
@@ -698,20 +1475,48 @@ public:
     SmallVector<Value> strideIntValues =
         getAsConstantIntValues(rewriter, loc, strideInts);
 
-    SmallVector<Value> outDims{N, F};
-    for (size_t i = 0; i < inRank - 2; i++)
+    SmallVector<Value> outputPaddingIntValues =
+        getAsConstantIntValues(rewriter, loc, outputPaddingInts);
+
+    // The weight of a transposed convolution is in form of C*F*H*W.
+    SmallVector<Value> outDims{N,
+                               transposed ? getDimOp(rewriter, loc, weight, 1)
+                                          : F};
+    for (size_t i = 0; i < inRank - 2; i++) {
+      if (transposed) {
+        outDims.push_back(torch_to_linalg::getOutputDimForConvTransposeOps(
+            rewriter, loc, inDims[i], paddingIntValues[i],
+            dilationIntValues[i], castIndexToInt(weightDims[i]),
+            strideIntValues[i], outputPaddingIntValues[i]));
+        continue;
+      }
       outDims.push_back(torch_to_linalg::getOutputDimForConvOps(
           rewriter, loc, inDims[i], paddingIntValues[i], dilationIntValues[i],
           castIndexToInt(weightDims[i]), strideIntValues[i]));
+    }
 
+    // The im2col unfolding needs static sizes for the columns of its matrix.
+    auto resultType =
+        getTypeConverter()->convertType(op.getType()).cast<RankedTensorType>();
+    bool useIm2col = convIm2col && !transposed && groups == 1 &&
+                     weightType.getDimSize(2) != kUnknownSize &&
+                     weightType.getDimSize(3) != kUnknownSize &&
+                     resultType.getDimSize(2) != kUnknownSize &&
+                     resultType.getDimSize(3) != kUnknownSize;
+
+    // Only the named convolution op accumulates in a wider type than its
+    // operands.
+    bool useNamedConv = !useIm2col && !transposed && groups == 1;
+    Type accType =
+        useNamedConv ? getAccumulatorElementType(elementType) : elementType;
     Value initTensor =
-        rewriter.create<linalg::InitTensorOp>(loc, outDims, elementType);
+        rewriter.create<linalg::InitTensorOp>(loc, outDims, accType);
 
     Value bias = adaptor.bias();
     Value biasInitTensor;
     if (bias.getType().isa<Torch::NoneType>()) {
       Value c0float = rewriter.create<arith::ConstantOp>(
-          loc, FloatAttr::get(elementType, 0.0));
+          loc, FloatAttr::get(accType, 0.0));
       biasInitTensor = rewriter.create<linalg::FillOp>(loc, c0float, initTensor)
                            .getResult(0);
     } else {
@@ -728,37 +1533,60 @@ public:
                          rewriter.getAffineDimExpr(1), context),
           rewriter.getMultiDimIdentityMap(resultRank)};
       SmallVector<StringRef> iteratorTypes(resultRank, "parallel");
-      biasInitTensor = rewriter
-                           .create<linalg::GenericOp>(
-                               loc, initTensor.getType(), bias, initTensor,
-                               indexingMaps, iteratorTypes,
-                               [](OpBuilder &b, Location loc, ValueRange args) {
-                                 b.create<linalg::YieldOp>(loc, args[0]);
-                               })
-                           .getResult(0);
+      biasInitTensor =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, initTensor.getType(), bias, initTensor, indexingMaps,
+                  iteratorTypes,
+                  [&](OpBuilder &b, Location loc, ValueRange args) {
+                    b.create<linalg::YieldOp>(
+                        loc, convertScalarToDtype(b, loc, args[0], accType));
+                  })
+              .getResult(0);
     }
 
     auto stridesAttr = rewriter.getI64VectorAttr(strideInts);
     auto dilationAttr = rewriter.getI64VectorAttr(dilationInts);
 
     // TODO: add 1D and 3D case
-    Value conv =
-        rewriter
-            .create<linalg::Conv2DNchwFchwOp>(
-                loc, biasInitTensor.getType(), ValueRange{paddedInput, weight},
-                biasInitTensor, stridesAttr, dilationAttr)
-            .getResult(0);
+    Value conv;
+    if (useIm2col) {
+      conv = createIm2colConv2D(
+          rewriter, loc, paddedInput, weight, biasInitTensor,
+          {resultType.getDimSize(2), resultType.getDimSize(3)}, strideInts,
+          dilationInts);
+    } else if (transposed) {
+      conv = createTransposedConv2D(rewriter, loc, input, weight,
+                                    biasInitTensor, strideInts, paddingInts);
+    } else if (useNamedConv) {
+      conv = rewriter
+                 .create<linalg::Conv2DNchwFchwOp>(
+                     loc, biasInitTensor.getType(),
+                     ValueRange{paddedInput, weight}, biasInitTensor,
+                     stridesAttr, dilationAttr)
+                 .getResult(0);
+    } else if (isDepthwise) {
+      conv = createDepthwiseConv2D(rewriter, loc, paddedInput, weight,
+                                   biasInitTensor, strideInts, dilationInts);
+    } else {
+      conv = createGroupedConv2D(rewriter, loc, paddedInput, weight,
+                                 biasInitTensor, groups, strideInts,
+                                 dilationInts);
+    }
 
-    Type newResultType = getTypeConverter()->convertType(op.getType());
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, conv);
+    rewriter.replaceOp(
+        op, castAccumulatorToResultType(rewriter, loc, conv, resultType));
     return success();
   }
+
+private:
+  bool convIm2col;
 };
 } // namespace
 
 void mlir::torch::torch_to_linalg::populateLinearPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
-    ConversionTarget &target) {
+    ConversionTarget &target, bool convIm2col) {
   MLIRContext *context = patterns.getContext();
   target.addIllegalOp<AtenMmOp>();
   patterns.add<ConvertAtenMmOp>(typeConverter, context);
@@ -770,6 +1598,10 @@ void mlir::torch::torch_to_linalg::populateLinearPatternsAndLegality(
   patterns.add<ConvertAtenBmmOp>(typeConverter, context);
   target.addIllegalOp<AtenLinearOp>();
   patterns.add<ConvertAtenLinearOp>(typeConverter, context);
+  target.addIllegalOp<PerTensorAffineCreateOp>();
+  patterns.add<ConvertPerTensorAffineCreateOp>(typeConverter, context);
+  target.addIllegalOp<QuantizedLinearOp>();
+  patterns.add<ConvertQuantizedLinearOp>(typeConverter, context);
   target.addIllegalOp<AtenConvolutionOp>();
-  patterns.add<ConvertAtenConvolutionOp>(typeConverter, context);
+  patterns.add<ConvertAtenConvolutionOp>(typeConverter, context, convIm2col);
 }
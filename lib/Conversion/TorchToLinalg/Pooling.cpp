@@ -58,16 +58,15 @@ checkAndGetPoolingParameters(OpTy op, ConversionPatternRewriter &rewriter,
   return success();
 }
 
-// Creates a pooling operation based on the type specified by `OpTy` and
-// arguments passed.
-template <typename OpTy>
-static LogicalResult createPoolingOp(
+// Pads the input of a pooling op with `initValueAttr` and computes the shape
+// of its output.
+static LogicalResult createPaddedInputAndOutputShape(
     Operation *op, ConversionPatternRewriter &rewriter, Value self,
     bool supportFPInputOnly, bool ceilMode,
     SmallVectorImpl<Value> &kernelSizeIntValues,
     SmallVectorImpl<int64_t> &strideInts, SmallVectorImpl<int64_t> &paddingInts,
     SmallVectorImpl<int64_t> &dilationInts, Attribute initValueAttr,
-    SmallVectorImpl<Value> &outTensorShape, Value &paddedInput, Value &result) {
+    SmallVectorImpl<Value> &outTensorShape, Value &paddedInput) {
   Location loc = op->getLoc();
   Type elementType = self.getType().cast<RankedTensorType>().getElementType();
   if (!elementType.isa<mlir::FloatType>() && !supportFPInputOnly)
@@ -104,8 +103,30 @@ static LogicalResult createPoolingOp(
       rewriter, loc, W, paddingIntValues[1], dilationIntValues[1],
       kernelSizeIntValues[1], strideIntValues[1], ceilMode);
 
-  // Create output tensor initialized with smallest floating point value.
   outTensorShape.insert(outTensorShape.begin(), {N, C, hOut, wOut});
+  return success();
+}
+
+// Creates a pooling operation based on the type specified by `OpTy` and
+// arguments passed.
+template <typename OpTy>
+static LogicalResult createPoolingOp(
+    Operation *op, ConversionPatternRewriter &rewriter, Value self,
+    bool supportFPInputOnly, bool ceilMode,
+    SmallVectorImpl<Value> &kernelSizeIntValues,
+    SmallVectorImpl<int64_t> &strideInts, SmallVectorImpl<int64_t> &paddingInts,
+    SmallVectorImpl<int64_t> &dilationInts, Attribute initValueAttr,
+    SmallVectorImpl<Value> &outTensorShape, Value &paddedInput, Value &result) {
+  if (failed(createPaddedInputAndOutputShape(
+          op, rewriter, self, supportFPInputOnly, ceilMode, kernelSizeIntValues,
+          strideInts, paddingInts, dilationInts, initValueAttr, outTensorShape,
+          paddedInput)))
+    return failure();
+
+  Location loc = op->getLoc();
+  Type elementType = self.getType().cast<RankedTensorType>().getElementType();
+  // Create output tensor initialized with smallest floating point value.
+  Value initValue = rewriter.create<arith::ConstantOp>(loc, initValueAttr);
   Value outTensorInitialized =
       createInitTensor(rewriter, loc, outTensorShape, elementType, initValue);
 
@@ -124,6 +145,31 @@ static LogicalResult createPoolingOp(
   return success();
 }
 
+// Returns the indexing maps and iterator types of a `linalg.generic` pooling
+// over the padded input, with the loops N, C, Hout, Wout, kH and kW. The maps
+// are those of the padded input, of a window tensor of shape [kH, kW] and of
+// each of the `numOutputs` outputs.
+static void getPoolingGenericMapsAndIteratorTypes(
+    OpBuilder &b, ArrayRef<int64_t> strideInts, ArrayRef<int64_t> dilationInts,
+    int64_t numOutputs, SmallVectorImpl<AffineMap> &indexingMaps,
+    SmallVectorImpl<StringRef> &iteratorTypes) {
+  SmallVector<AffineExpr> inputExprs, kernelExprs, outputExprs;
+  for (unsigned i = 0; i < 4; i++)
+    outputExprs.push_back(b.getAffineDimExpr(i));
+  inputExprs.push_back(b.getAffineDimExpr(0));
+  inputExprs.push_back(b.getAffineDimExpr(1));
+  for (unsigned i = 0; i < 2; i++) {
+    inputExprs.push_back(b.getAffineDimExpr(2 + i) * strideInts[i] +
+                         b.getAffineDimExpr(4 + i) * dilationInts[i]);
+    kernelExprs.push_back(b.getAffineDimExpr(4 + i));
+  }
+  SmallVector<SmallVector<AffineExpr>> exprs = {inputExprs, kernelExprs};
+  exprs.append(numOutputs, outputExprs);
+  indexingMaps.append(AffineMap::inferFromExprList(exprs));
+  iteratorTypes.append(4, getParallelIteratorTypeName());
+  iteratorTypes.append(2, getReductionIteratorTypeName());
+}
+
 namespace {
 class ConvertAtenMaxPool2dOp : public OpConversionPattern<AtenMaxPool2dOp> {
 public:
@@ -175,14 +221,11 @@ public:
 } // namespace
 
 namespace {
-// Returns the result of maxpool2d over the input tensor. And the corresponding
+// Returns the result of maxpool2d over the input tensor, and the corresponding
 // indices of the input tensor for the values of the result tensor.
 //
-// The result of the maxpool2d operation is calculated using the helper function
-// written above. For finding the indices, we follow the below method:
-//
-// Let's say the input tensor is a 4-d tensor. The maxpool2d and indices will
-// also be a 4-d tensor. Then:
+// Both are computed in a single traversal of the input, carrying the running
+// maximum and its index together:
 // for i in range(N):
 //     for j in range(C):
 //         for m in range(Hout):
@@ -190,12 +233,16 @@ namespace {
 //                 for p in range(kH):
 //                     for r in range(kW):
 //                         indexH = m * stride[0] + p * dilation[0]
-//                         indexW = n * stride[0] + r * dilation[0]
-//                         if paddedInput[i, j, indexH, indexW] ==
+//                         indexW = n * stride[1] + r * dilation[1]
+//                         if paddedInput[i, j, indexH, indexW] >
 //                            maxPool2d[i, j, m, n]:
+//                             maxPool2d[i, j, m, n] =
+//                                 paddedInput[i, j, indexH, indexW]
 //                             indices[i, j, m, n] = (indexH - padding[0]) * W +
 //                                                   (indexW - padding[1])
 //
+// As in PyTorch, NaNs are propagated and the first maximum of each window is
+// the one whose index is returned.
 class ConvertAtenMaxPool2dWithIndicesOp
     : public OpConversionPattern<AtenMaxPool2dWithIndicesOp> {
 public:
@@ -231,20 +278,23 @@ public:
             strideInts, paddingInts)))
       return rewriter.notifyMatchFailure(op, "invalid pooling parameters");
 
-    // `maxpool2d` contains the result of maxpool2d operation over the input.
     auto smallestFPValueAttr = rewriter.getFloatAttr(
         elementType,
         APFloat::getLargest(
             elementType.cast<mlir::FloatType>().getFloatSemantics(),
             /*Negative=*/true));
-    Value maxPool2d, paddedInput;
+    Value paddedInput;
     SmallVector<Value, 4> outTensorShape;
-    if (failed(createPoolingOp<linalg::PoolingNchwMaxOp>(
+    if (failed(createPaddedInputAndOutputShape(
             op, rewriter, self, /*supportFPInput=*/false, ceilMode,
             kernelSizeIntValues, strideInts, paddingInts, dilationInts,
-            smallestFPValueAttr, outTensorShape, paddedInput, maxPool2d)))
+            smallestFPValueAttr, outTensorShape, paddedInput)))
       return rewriter.notifyMatchFailure(op, "unable to compute maxpool2d");
 
+    Value smallestFPValue =
+        rewriter.create<arith::ConstantOp>(loc, smallestFPValueAttr);
+    Value maxPool2dTensor = createInitTensor(rewriter, loc, outTensorShape,
+                                             elementType, smallestFPValue);
     Value cstMinusOne =
         rewriter.create<arith::ConstantOp>(loc, rewriter.getI64IntegerAttr(-1));
     Value indicesTensor =
@@ -263,88 +313,72 @@ public:
     Value windowTensor = rewriter.create<linalg::InitTensorOp>(
         loc, kernelSize, indicesRankedTensorType.getElementType());
 
-    SmallVector<AffineExpr> inputExprs, outputExprs, kernelExprs;
-    for (unsigned i = 0; i < 4; i++) {
-      inputExprs.push_back(rewriter.getAffineDimExpr(i));
-      outputExprs.push_back(rewriter.getAffineDimExpr(i));
-    }
-    kernelExprs.push_back(rewriter.getAffineDimExpr(4));
-    kernelExprs.push_back(rewriter.getAffineDimExpr(5));
-
-    // Here we have six dimensions, each corresponding to N, C, Hout, Wout, kH,
-    // and kW, respectively, as described in the algorithm above.
-    SmallVector<AffineMap> indexingMaps =
-        AffineMap::inferFromExprList({inputExprs, kernelExprs, outputExprs});
-    SmallVector<StringRef> iteratorTypes(4, getParallelIteratorTypeName());
-    iteratorTypes.push_back(getReductionIteratorTypeName());
-    iteratorTypes.push_back(getReductionIteratorTypeName());
+    SmallVector<AffineMap> indexingMaps;
+    SmallVector<StringRef> iteratorTypes;
+    getPoolingGenericMapsAndIteratorTypes(rewriter, strideInts, dilationInts,
+                                          /*numOutputs=*/2, indexingMaps,
+                                          iteratorTypes);
 
     // Input format is : [N, C, H, W]
     Value inputShapeW = getDimOp(rewriter, loc, self, 3);
 
-    Value indicesResult =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, /*resultTensorTypes=*/indicesTensor.getType(),
-                /*inputs=*/ValueRange({maxPool2d, windowTensor}),
-                /*outputs=*/indicesTensor,
-                /*indexingMaps=*/indexingMaps,
-                /*iteratorTypes=*/iteratorTypes,
-                [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value maxVal = args[0], res = args[2];
-
-                  Value i = b.create<linalg::IndexOp>(loc, 0);
-                  Value j = b.create<linalg::IndexOp>(loc, 1);
-                  Value m = b.create<linalg::IndexOp>(loc, 2);
-                  Value n = b.create<linalg::IndexOp>(loc, 3);
-                  Value p = b.create<linalg::IndexOp>(loc, 4);
-                  Value r = b.create<linalg::IndexOp>(loc, 5);
-
-                  Value mTimesStride =
-                      b.create<arith::MulIOp>(loc, m, stride[0]);
-                  Value pTimesDilation =
-                      b.create<arith::MulIOp>(loc, p, dilation[0]);
-                  Value indexH = b.create<arith::AddIOp>(loc, mTimesStride,
-                                                         pTimesDilation);
-                  Value nTimesStride =
-                      b.create<arith::MulIOp>(loc, n, stride[1]);
-                  Value rTimesDilation =
-                      b.create<arith::MulIOp>(loc, r, dilation[1]);
-                  Value indexW = b.create<arith::AddIOp>(loc, nTimesStride,
-                                                         rTimesDilation);
-                  Value input = b.create<tensor::ExtractOp>(
-                      loc, paddedInput, ValueRange{i, j, indexH, indexW});
-                  Value pred = b.create<arith::CmpFOp>(
-                      loc, arith::CmpFPredicate::OEQ, input, maxVal);
-
-                  Value indexHMinusPadding =
-                      b.create<arith::SubIOp>(loc, indexH, padding[0]);
-                  Value indexWMinusPadding =
-                      b.create<arith::SubIOp>(loc, indexW, padding[1]);
-                  Value outIndex = b.create<arith::MulIOp>(
-                      loc, indexHMinusPadding, inputShapeW);
-                  outIndex = b.create<arith::AddIOp>(loc, outIndex,
-                                                     indexWMinusPadding);
-                  Value result = b.create<arith::SelectOp>(
-                      loc, pred, castIndexToInt64(b, loc, outIndex), res);
-
-                  Value predInvalidIndex = b.create<arith::CmpIOp>(
-                      loc, arith::CmpIPredicate::eq, res, cstMinusOne);
-                  Value out = b.create<arith::SelectOp>(loc, predInvalidIndex,
-                                                        result, res);
-
-                  b.create<linalg::YieldOp>(loc, out);
-                })
-            .getResult(0);
+    auto genericOp = rewriter.create<linalg::GenericOp>(
+        loc,
+        /*resultTensorTypes=*/
+        TypeRange{maxPool2dTensor.getType(), indicesTensor.getType()},
+        /*inputs=*/ValueRange({paddedInput, windowTensor}),
+        /*outputs=*/ValueRange({maxPool2dTensor, indicesTensor}),
+        /*indexingMaps=*/indexingMaps,
+        /*iteratorTypes=*/iteratorTypes,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value input = args[0], maxVal = args[2], maxIndex = args[3];
+
+          Value m = b.create<linalg::IndexOp>(loc, 2);
+          Value n = b.create<linalg::IndexOp>(loc, 3);
+          Value p = b.create<linalg::IndexOp>(loc, 4);
+          Value r = b.create<linalg::IndexOp>(loc, 5);
+
+          Value mTimesStride = b.create<arith::MulIOp>(loc, m, stride[0]);
+          Value pTimesDilation = b.create<arith::MulIOp>(loc, p, dilation[0]);
+          Value indexH =
+              b.create<arith::AddIOp>(loc, mTimesStride, pTimesDilation);
+          Value nTimesStride = b.create<arith::MulIOp>(loc, n, stride[1]);
+          Value rTimesDilation = b.create<arith::MulIOp>(loc, r, dilation[1]);
+          Value indexW =
+              b.create<arith::AddIOp>(loc, nTimesStride, rTimesDilation);
+          Value indexHMinusPadding =
+              b.create<arith::SubIOp>(loc, indexH, padding[0]);
+          Value indexWMinusPadding =
+              b.create<arith::SubIOp>(loc, indexW, padding[1]);
+          Value outIndex =
+              b.create<arith::MulIOp>(loc, indexHMinusPadding, inputShapeW);
+          outIndex = b.create<arith::AddIOp>(loc, outIndex, indexWMinusPadding);
+
+          // Take the input if it is a new maximum, if it is a NaN, or if
+          // no element of the window has been taken yet.
+          Value isGreater = b.create<arith::CmpFOp>(
+              loc, arith::CmpFPredicate::OGT, input, maxVal);
+          Value isNaN = b.create<arith::CmpFOp>(loc, arith::CmpFPredicate::UNO,
+                                                input, input);
+          Value isFirst = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::eq, maxIndex, cstMinusOne);
+          Value pred = b.create<arith::OrIOp>(loc, isGreater, isNaN);
+          pred = b.create<arith::OrIOp>(loc, pred, isFirst);
+          Value newMaxVal =
+              b.create<arith::SelectOp>(loc, pred, input, maxVal);
+          Value newMaxIndex = b.create<arith::SelectOp>(
+              loc, pred, castIndexToInt64(b, loc, outIndex), maxIndex);
+          b.create<linalg::YieldOp>(loc, ValueRange{newMaxVal, newMaxIndex});
+        });
 
     Type maxPool2dResultType =
         getTypeConverter()->convertType(op->getResult(0).getType());
     Type indicesResultType =
         getTypeConverter()->convertType(op->getResult(1).getType());
-    Value outMaxpool2d =
-        rewriter.create<tensor::CastOp>(loc, maxPool2dResultType, maxPool2d);
-    Value outIndices =
-        rewriter.create<tensor::CastOp>(loc, indicesResultType, indicesResult);
+    Value outMaxpool2d = rewriter.create<tensor::CastOp>(
+        loc, maxPool2dResultType, genericOp.getResult(0));
+    Value outIndices = rewriter.create<tensor::CastOp>(
+        loc, indicesResultType, genericOp.getResult(1));
 
     rewriter.replaceOp(op, {outMaxpool2d, outIndices});
     return success();
@@ -390,9 +424,62 @@ public:
           op, "unimplemented: count_include_pad is expected to be true");
     }
 
-    // `sumPool2d` contains the result of sumpool2d operation over the input.
-    Value sumPool2d, paddedInput;
+    Value kHtimeskW = rewriter.create<arith::MulIOp>(
+        loc, kernelSizeIntValues[0], kernelSizeIntValues[1]);
+    Value divisor = op.divisor_override().getType().isa<Torch::NoneType>()
+                        ? kHtimeskW
+                        : adaptor.divisor_override();
+    divisor = convertScalarToDtype(rewriter, loc, divisor, resultElementType);
+
+    Value avgPool2d, paddedInput;
     SmallVector<Value, 4> outTensorShape;
+    if (resultElementType.isa<mlir::FloatType>()) {
+      // Accumulate the input elements scaled by the reciprocal of the
+      // divisor, so that the average is computed in a single traversal of
+      // the input.
+      if (failed(createPaddedInputAndOutputShape(
+              op, rewriter, self, /*supportFPInput=*/true, ceilMode,
+              kernelSizeIntValues, strideInts, paddingInts, dilationInts,
+              rewriter.getZeroAttr(inputElementType), outTensorShape,
+              paddedInput)))
+        return rewriter.notifyMatchFailure(op, "unable to compute avgpool2d");
+      Value one = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getFloatAttr(resultElementType, 1.0));
+      Value reciprocal = rewriter.create<arith::DivFOp>(loc, one, divisor);
+      Value zero = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getZeroAttr(resultElementType));
+      Value outputTensor = createInitTensor(rewriter, loc, outTensorShape,
+                                            resultElementType, zero);
+      Value windowTensor = rewriter.create<linalg::InitTensorOp>(
+          loc, castIntVectorToIndexVector(rewriter, loc, kernelSizeIntValues),
+          resultElementType);
+      SmallVector<AffineMap> indexingMaps;
+      SmallVector<StringRef> iteratorTypes;
+      getPoolingGenericMapsAndIteratorTypes(rewriter, strideInts, dilationInts,
+                                            /*numOutputs=*/1, indexingMaps,
+                                            iteratorTypes);
+      avgPool2d =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, outputTensor.getType(),
+                  ValueRange{paddedInput, windowTensor}, outputTensor,
+                  /*indexingMaps=*/indexingMaps,
+                  /*iteratorTypes=*/iteratorTypes,
+                  [&](OpBuilder &b, Location loc, ValueRange args) {
+                    Value scaled =
+                        b.create<arith::MulFOp>(loc, args[0], reciprocal);
+                    Value sum = b.create<arith::AddFOp>(loc, args[2], scaled);
+                    b.create<linalg::YieldOp>(loc, sum);
+                  })
+              .getResult(0);
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, avgPool2d);
+      return success();
+    }
+
+    // Integer division doesn't distribute over the sum, so compute the sum
+    // first and divide it afterwards.
+    // `sumPool2d` contains the result of sumpool2d operation over the input.
+    Value sumPool2d;
     if (failed(createPoolingOp<linalg::PoolingNchwSumOp>(
             op, rewriter, self, /*supportFPInput=*/true, ceilMode,
             kernelSizeIntValues, strideInts, paddingInts, dilationInts,
@@ -400,31 +487,20 @@ public:
             sumPool2d)))
       return rewriter.notifyMatchFailure(op, "unable to compute sumpool2d");
 
-    Value kHtimeskW = rewriter.create<arith::MulIOp>(
-        loc, kernelSizeIntValues[0], kernelSizeIntValues[1]);
-    Value divisor = op.divisor_override().getType().isa<Torch::NoneType>()
-                        ? kHtimeskW
-                        : adaptor.divisor_override();
-    divisor = convertScalarToDtype(rewriter, loc, divisor, resultElementType);
-
     Value outputTensor = rewriter.create<linalg::InitTensorOp>(
         loc, outTensorShape, resultElementType);
     SmallVector<AffineMap> indexingMapsAvg(2,
                                            rewriter.getMultiDimIdentityMap(4));
     SmallVector<StringRef> iteratorTypesAvg(4, "parallel");
 
-    Value avgPool2d =
+    avgPool2d =
         rewriter
             .create<linalg::GenericOp>(
                 loc, outputTensor.getType(), sumPool2d, outputTensor,
                 /*indexingMaps=*/indexingMapsAvg,
                 /*iteratorTypes=*/iteratorTypesAvg,
                 [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value avg;
-                  if (resultElementType.isa<mlir::IntegerType>())
-                    avg = b.create<arith::DivSIOp>(loc, args[0], divisor);
-                  else if (resultElementType.isa<mlir::FloatType>())
-                    avg = b.create<arith::DivFOp>(loc, args[0], divisor);
+                  Value avg = b.create<arith::DivSIOp>(loc, args[0], divisor);
                   b.create<linalg::YieldOp>(loc, avg);
                 })
             .getResult(0);
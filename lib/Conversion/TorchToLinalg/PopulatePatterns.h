@@ -39,9 +39,12 @@ namespace torch_to_linalg {
 void populateTensorScalarInteropPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
     ConversionTarget &target);
+// If `convIm2col` is true, 2D convolutions with static kernel and output
+// spatial sizes are lowered to an im2col unfolding plus a `linalg.matmul`.
 void populateLinearPatternsAndLegality(TypeConverter &typeConverter,
                                        RewritePatternSet &patterns,
-                                       ConversionTarget &target);
+                                       ConversionTarget &target,
+                                       bool convIm2col);
 void populatePoolingPatternsAndLegality(TypeConverter &typeConverter,
                                         RewritePatternSet &patterns,
                                         ConversionTarget &target);
@@ -51,9 +54,13 @@ void populateRandomPatternsAndLegality(TypeConverter &typeConverter,
 void populateUncategorizedPatternsAndLegality(TypeConverter &typeConverter,
                                               RewritePatternSet &patterns,
                                               ConversionTarget &target);
+// If `reductionSplitFactor` is positive, full reductions of static tensors
+// whose number of elements is a multiple of it are split into that many
+// partial reductions plus a final combine.
 void populateReductionPatternsAndLegality(TypeConverter &typeConverter,
                                           RewritePatternSet &patterns,
-                                          ConversionTarget &target);
+                                          ConversionTarget &target,
+                                          int64_t reductionSplitFactor);
 void populateDataMovementPatternsAndLegality(TypeConverter &typeConverter,
                                              RewritePatternSet &patterns,
                                              ConversionTarget &target);
@@ -63,6 +70,10 @@ void populateIndirectDataMovementPatternsAndLegality(
 void populateTensorConstructorsPatternsAndLegality(TypeConverter &typeConverter,
                                                    RewritePatternSet &patterns,
                                                    ConversionTarget &target);
+// Lowers the calls to custom kernels whose result shapes are attached.
+void populateCustomKernelsPatternsAndLegality(TypeConverter &typeConverter,
+                                              RewritePatternSet &patterns,
+                                              ConversionTarget &target);
 //void populateCustomOpExamplePatternsAndLegality(TypeConverter &typeConverter,
 //                                                RewritePatternSet &patterns,
 //                                                ConversionTarget &target);
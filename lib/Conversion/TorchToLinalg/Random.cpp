@@ -24,6 +24,8 @@
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
 
+#include <cmath>
+
 using namespace mlir;
 using namespace mlir::torch;
 using namespace mlir::torch::Torch;
@@ -58,6 +60,72 @@ public:
 } // namespace
 
 
+// Returns the high and low 32 bits of the product of the i32 values `lhs` and
+// `rhs`.
+static std::pair<Value, Value> createMulHiLo(OpBuilder &b, Location loc,
+                                             Value lhs, Value rhs) {
+  Type i64 = b.getI64Type();
+  Value product =
+      b.create<arith::MulIOp>(loc, b.create<arith::ExtUIOp>(loc, i64, lhs),
+                              b.create<arith::ExtUIOp>(loc, i64, rhs));
+  Value c32 = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(32));
+  Type i32 = b.getI32Type();
+  Value hi = b.create<arith::TruncIOp>(
+      loc, i32, b.create<arith::ShRUIOp>(loc, product, c32));
+  Value lo = b.create<arith::TruncIOp>(loc, i32, product);
+  return {hi, lo};
+}
+
+// Returns the first 64 bits of the Philox-4x32-10 hash of the i64 `counter`
+// under the i64 `key`. Philox is a counter-based generator: its outputs for
+// distinct counters are independent random numbers, so they can be computed
+// in any order and in parallel.
+// Refer to "Parallel random numbers: as easy as 1, 2, 3", Salmon et al., SC11.
+static Value createPhilox(OpBuilder &b, Location loc, Value counter,
+                          Value key) {
+  Type i32 = b.getI32Type();
+  Type i64 = b.getI64Type();
+  Value c32 = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(32));
+  auto splitI64 = [&](Value v) -> std::pair<Value, Value> {
+    return {b.create<arith::TruncIOp>(loc, i32, v),
+            b.create<arith::TruncIOp>(
+                loc, i32, b.create<arith::ShRUIOp>(loc, v, c32))};
+  };
+  auto getI32 = [&](uint32_t v) -> Value {
+    return b.create<arith::ConstantOp>(
+        loc, b.getI32IntegerAttr(static_cast<int32_t>(v)));
+  };
+
+  Value zero = getI32(0);
+  Value ctr[4] = {zero, zero, zero, zero};
+  std::tie(ctr[0], ctr[1]) = splitI64(counter);
+  Value k[2];
+  std::tie(k[0], k[1]) = splitI64(key);
+  Value multiplier0 = getI32(0xD2511F53);
+  Value multiplier1 = getI32(0xCD9E8D57);
+  Value weyl0 = getI32(0x9E3779B9);
+  Value weyl1 = getI32(0xBB67AE85);
+  for (int round = 0; round < 10; round++) {
+    if (round != 0) {
+      k[0] = b.create<arith::AddIOp>(loc, k[0], weyl0);
+      k[1] = b.create<arith::AddIOp>(loc, k[1], weyl1);
+    }
+    Value hi0, lo0, hi1, lo1;
+    std::tie(hi0, lo0) = createMulHiLo(b, loc, multiplier0, ctr[0]);
+    std::tie(hi1, lo1) = createMulHiLo(b, loc, multiplier1, ctr[2]);
+    ctr[0] = b.create<arith::XOrIOp>(
+        loc, b.create<arith::XOrIOp>(loc, hi1, ctr[1]), k[0]);
+    ctr[1] = lo1;
+    ctr[2] = b.create<arith::XOrIOp>(
+        loc, b.create<arith::XOrIOp>(loc, hi0, ctr[3]), k[1]);
+    ctr[3] = lo0;
+  }
+  Value lo = b.create<arith::ExtUIOp>(loc, i64, ctr[0]);
+  Value hi = b.create<arith::ExtUIOp>(loc, i64, ctr[1]);
+  return b.create<arith::OrIOp>(loc, b.create<arith::ShLIOp>(loc, hi, c32),
+                                lo);
+}
+
 namespace {
 class ConvertValsemVariantAtenUniformOp
     : public OpConversionPattern<ValsemVariantAtenUniformOp> {
@@ -84,31 +152,21 @@ public:
           op, "The generator has to ben None because only global default "
               "generator is supported");
 
-    // Build the core formula of LCG Algorithm that makes use of element index:
-    // For output matrix with rank N:
-    // temp1 = (cast(I64, index(D.0)) + seed) * multiplier + incrementStep
-    // ...
-    // tempN = (cast(I64, index(D.(N))) + tempN-1) * multiplier + incr
-    // Refer to https://reviews.llvm.org/D101364.
-    // The value of multiplier and incrementStep are referenced from
-    // https://en.wikipedia.org/wiki/Linear_congruential_generator for 2^64.
-    Value multiplier = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI64IntegerAttr(6364136223846793005));
-    Value incrementStep = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI64IntegerAttr(1442695040888963407));
-    // Tn = (index + Tn-1) * multiplier + incrementStep
-    auto getNextTemp = [&](OpBuilder &b, Value index, Value temp) {
-      Value castIndex =
-          b.create<arith::IndexCastOp>(loc, b.getI64Type(), index);
-      Value add = b.create<arith::AddIOp>(loc, castIndex, temp);
-      Value mult = b.create<arith::MulIOp>(loc, add, multiplier);
-      return b.create<arith::AddIOp>(loc, mult, incrementStep);
-    };
-
-    // Get initial seed, min and max used by `linalg.generic` compute payload.
-    Value initialSeed = rewriter.create<TorchConversion::GetNextSeedOp>(loc);
+    // Get the seed, min and max used by the `linalg.generic` compute payload.
+    Value seed = rewriter.create<TorchConversion::GetNextSeedOp>(loc);
     Value min = convertScalarToDtype(rewriter, loc, from, elemTy);
     Value max = convertScalarToDtype(rewriter, loc, to, elemTy);
+    Value range = rewriter.create<arith::SubFOp>(loc, max, min);
+
+    // Each element is the Philox hash of its linear index under the seed, so
+    // the elements are independent of each other and of the order they are
+    // computed in. The top `precision` bits of the hash give a value in
+    // [0, 1) with all the values representable in `elemTy`.
+    int precision = elemTy.cast<mlir::FloatType>().getFPMantissaWidth();
+    Value shift = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getI64IntegerAttr(64 - precision));
+    Value unitScale = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getFloatAttr(elemTy, std::ldexp(1.0, -precision)));
 
     // Construct the `linalg.generic` op.
     auto resultRank = resultType.getRank();
@@ -117,6 +175,9 @@ public:
     SmallVector<StringRef> iteratorTypes(resultRank,
                                          getParallelIteratorTypeName());
     SmallVector<Value> sizes = getTensorSizes(rewriter, loc, self);
+    SmallVector<Value> sizesInt;
+    for (Value size : sizes)
+      sizesInt.push_back(castIndexToInt64(rewriter, loc, size));
     Value initTensor =
         rewriter.create<linalg::InitTensorOp>(loc, sizes, elemTy);
     Value uniformRes =
@@ -125,25 +186,25 @@ public:
                 loc, initTensor.getType(), /*inputs=*/ValueRange{},
                 /*outputs=*/initTensor, indexingMaps, iteratorTypes,
                 [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value temp = initialSeed;
+                  Value linearIndex = b.create<arith::ConstantOp>(
+                      loc, b.getI64IntegerAttr(0));
                   for (int i = 0; i < resultRank; i++) {
-                    Value index = b.create<linalg::IndexOp>(loc, i);
-                    temp = getNextTemp(b, index, temp);
+                    Value index = b.create<arith::IndexCastOp>(
+                        loc, b.getI64Type(), b.create<linalg::IndexOp>(loc, i));
+                    linearIndex = b.create<arith::AddIOp>(
+                        loc, b.create<arith::MulIOp>(loc, linearIndex,
+                                                     sizesInt[i]),
+                        index);
                   }
-                  // scale = (max - min) * const(F64,  5.4210108E-20)
-                  // which is derived from rand(min,max) =
-                  // rand()/(RAND_MAX/(max-min)) where RAND_MAX = 2^64 - 1
-                  Value epsilon = b.create<arith::ConstantOp>(
-                      loc, b.getFloatAttr(min.getType(), 5.4210108E-20));
-                  Value range = b.create<arith::SubFOp>(loc, max, min);
-                  Value scale = b.create<arith::MulFOp>(loc, range, epsilon);
-
-                  // res = cast(F64, tempN) * scale + min
-                  Value updateFloat =
-                      b.create<arith::UIToFPOp>(loc, elemTy, temp);
-                  Value updateScaled =
-                      b.create<arith::MulFOp>(loc, updateFloat, scale);
-                  Value res = b.create<arith::AddFOp>(loc, updateScaled, min);
+                  Value random = createPhilox(b, loc, linearIndex, seed);
+
+                  // res = cast(random >> shift) * 2^-precision * range + min
+                  Value bits = b.create<arith::ShRUIOp>(loc, random, shift);
+                  Value unit = b.create<arith::MulFOp>(
+                      loc, b.create<arith::UIToFPOp>(loc, elemTy, bits),
+                      unitScale);
+                  Value scaled = b.create<arith::MulFOp>(loc, unit, range);
+                  Value res = b.create<arith::AddFOp>(loc, scaled, min);
                   b.create<linalg::YieldOp>(loc, res);
                 })
             .getResult(0);
@@ -30,60 +30,83 @@ using namespace mlir::torch;
 using namespace mlir::torch::Torch;
 
 namespace {
-// Aten maxdim lowering represents the MaxDim op as an linalg.indexed_generic
-// op, producing two output buffers.
+// Lowers aten.max.dim and aten.min.dim to a single linalg.generic op with two
+// results, so that the input is only read once.
 //
-// The first output buffer contains the maximum value found. It is initialized
-// to the minimum representable value of the input element type.
+// The first result contains the extremum found. It is initialized to -inf
+// (+inf for min), or the minimum (maximum) value of an integer type.
 //
-// The second output buffer contains the index of the found maximum value. It is
-// initialized to 0 and is resulting integer type.
+// The second result contains the index of the found extremum. It is
+// initialized to 0 and is of the integer result type.
 //
-// The indexed_generic op updates both the maximum value and index if the
-// current value exceeds the running max.
-class ConvertAtenMaxDimOp : public OpConversionPattern<AtenMaxDimOp> {
+// Both results are updated when the current value is strictly greater (less)
+// than the running extremum, so that the first index is kept on ties. As in
+// PyTorch, NaNs propagate: the first NaN is the result.
+template <typename OpTy>
+class ConvertAtenMinMaxDimOp : public OpConversionPattern<OpTy> {
 public:
-  using OpConversionPattern<AtenMaxDimOp>::OpConversionPattern;
+  using OpConversionPattern<OpTy>::OpConversionPattern;
+  using OpAdaptor = typename OpTy::Adaptor;
 
   LogicalResult
-  matchAndRewrite(AtenMaxDimOp maxDimOp, OpAdaptor adaptor,
+  matchAndRewrite(OpTy op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-
-    Location loc = maxDimOp.getLoc();
+    bool isMax = std::is_same<OpTy, AtenMaxDimOp>::value;
+    Location loc = op.getLoc();
     Value input = adaptor.self();
     RankedTensorType valResultType =
-        getTypeConverter()
-            ->convertType(maxDimOp.getResult(0).getType())
-            .cast<RankedTensorType>();
+        this->getTypeConverter()
+            ->convertType(op.getResult(0).getType())
+            .template cast<RankedTensorType>();
     RankedTensorType idxResultType =
-        getTypeConverter()
-            ->convertType(maxDimOp.getResult(1).getType())
-            .cast<RankedTensorType>();
+        this->getTypeConverter()
+            ->convertType(op.getResult(1).getType())
+            .template cast<RankedTensorType>();
     RankedTensorType inputType = input.getType().cast<RankedTensorType>();
     Type idxElementType = idxResultType.getElementType();
     if (!idxElementType.isa<IntegerType>())
       return rewriter.notifyMatchFailure(
-          maxDimOp,
-          "aten.max_dim to linalg.* requires integer-like result type");
+          op, "aten.max_dim to linalg.* requires integer-like result type");
 
     bool keepDim = false;
-    if (!matchPattern(maxDimOp.keepdim(), m_TorchConstantBool(&keepDim)))
+    if (!matchPattern(op.keepdim(), m_TorchConstantBool(&keepDim)))
       return rewriter.notifyMatchFailure(
-          maxDimOp, "aten.max_dim requires boolean value for keepdim");
+          op, "aten.max_dim requires boolean value for keepdim");
 
     int64_t dim;
-    if (!matchPattern(maxDimOp.dim(), m_TorchConstantInt(&dim)))
+    if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
       return rewriter.notifyMatchFailure(
-          maxDimOp, "aten.max_dim to linalg.* requires int value for Dim");
+          op, "aten.max_dim to linalg.* requires int value for Dim");
     dim = toPositiveDim(dim, inputType.getRank());
     if (!isValidDim(dim, inputType.getRank()))
-      return rewriter.notifyMatchFailure(maxDimOp, "dim is not a valid dim");
+      return rewriter.notifyMatchFailure(op, "dim is not a valid dim");
 
     Type inElementType = inputType.getElementType();
-    if (!inElementType.isa<mlir::FloatType>()) {
+    Attribute fillValueAttr;
+    bool isUnsigned = false;
+    if (auto floatType = inElementType.dyn_cast<mlir::FloatType>()) {
+      fillValueAttr = rewriter.getFloatAttr(
+          floatType,
+          APFloat::getInf(floatType.getFloatSemantics(), /*Negative=*/isMax));
+    } else if (auto intType = inElementType.dyn_cast<IntegerType>()) {
+      auto dtype = op.self()
+                       .getType()
+                       .template cast<BaseTensorType>()
+                       .getDtype()
+                       .template cast<IntegerType>();
+      unsigned width = intType.getWidth();
+      isUnsigned = dtype.isUnsigned() || width == 1;
+      APInt fillValue;
+      if (isUnsigned)
+        fillValue = isMax ? APInt::getMinValue(width)
+                          : APInt::getMaxValue(width);
+      else
+        fillValue = isMax ? APInt::getSignedMinValue(width)
+                          : APInt::getSignedMaxValue(width);
+      fillValueAttr = rewriter.getIntegerAttr(intType, fillValue);
+    } else {
       return rewriter.notifyMatchFailure(
-          maxDimOp,
-          "aten.max_dim to linalg.* requires Float input element type");
+          op, "aten.max_dim to linalg.* requires float or integer input");
     }
 
     // Constant op to account for the reduction along dim.
@@ -100,21 +123,10 @@ public:
     Value filledTensorIdx =
         createZeroInitTensor(rewriter, loc, resultShape, idxElementType);
 
-    // Second fill the output buffer for the running max.
-    Value initTensorMax =
-        rewriter.create<linalg::InitTensorOp>(loc, resultShape, inElementType)
-            .result();
-
-    FloatAttr fillValueMaxAttr = rewriter.getFloatAttr(
-        inElementType,
-        APFloat::getLargest(
-            inElementType.cast<mlir::FloatType>().getFloatSemantics(), true));
-
-    Value fillValueMax =
-        rewriter.create<arith::ConstantOp>(loc, fillValueMaxAttr);
-    Value filledTensorMax =
-        rewriter.create<linalg::FillOp>(loc, fillValueMax, initTensorMax)
-            .result();
+    // Second fill the output buffer for the running extremum.
+    Value fillValue = rewriter.create<arith::ConstantOp>(loc, fillValueAttr);
+    Value filledTensorVal =
+        createInitTensor(rewriter, loc, resultShape, inElementType, fillValue);
 
     // Create the affine expressions that will be used to
     // iterate over the input and output tensors.
@@ -139,37 +151,50 @@ public:
     auto maps = AffineMap::inferFromExprList({exprs, resultExprs, resultExprs});
     auto linalgOp = rewriter.create<linalg::GenericOp>(
         loc,
-        ArrayRef<Type>({filledTensorMax.getType(), filledTensorIdx.getType()}),
-        input, ValueRange({filledTensorMax, filledTensorIdx}), maps,
-        iteratorTypes,
-        [&](OpBuilder &nestedBuilder, Location nestedLoc,
-            ValueRange blockArgs) {
+        ArrayRef<Type>({filledTensorVal.getType(), filledTensorIdx.getType()}),
+        input, ValueRange({filledTensorVal, filledTensorIdx}), maps,
+        iteratorTypes, [&](OpBuilder &b, Location loc, ValueRange blockArgs) {
           Value newValue = blockArgs[0];
           Value oldValue = blockArgs[1];
           Value oldIndex = blockArgs[2];
 
-          Value newIndex = rewriter.create<arith::IndexCastOp>(
-              nestedLoc, oldIndex.getType(),
-              rewriter.create<linalg::IndexOp>(loc, dim));
+          Value newIndex = b.create<arith::IndexCastOp>(
+              loc, oldIndex.getType(), b.create<linalg::IndexOp>(loc, dim));
 
           Value predicate;
-          if (inElementType.isa<mlir::FloatType>())
-            predicate = rewriter.create<arith::CmpFOp>(
-                nestedLoc, arith::CmpFPredicate::OGT, newValue, oldValue);
-          auto resultMax = rewriter.create<arith::SelectOp>(
-              nestedLoc, predicate, newValue, oldValue);
-          auto resultIndex = rewriter.create<arith::SelectOp>(
-              nestedLoc, predicate, newIndex, oldIndex);
-          nestedBuilder.create<linalg::YieldOp>(
-              nestedLoc, ValueRange({resultMax, resultIndex}));
+          if (inElementType.isa<mlir::FloatType>()) {
+            // Unordered comparisons are true if `newValue` is NaN. Once the
+            // running extremum is NaN, it is never replaced.
+            Value isBetter = b.create<arith::CmpFOp>(
+                loc,
+                isMax ? arith::CmpFPredicate::UGT : arith::CmpFPredicate::ULT,
+                newValue, oldValue);
+            Value isOldOrdered = b.create<arith::CmpFOp>(
+                loc, arith::CmpFPredicate::ORD, oldValue, oldValue);
+            predicate = b.create<arith::AndIOp>(loc, isBetter, isOldOrdered);
+          } else {
+            arith::CmpIPredicate cmp;
+            if (isUnsigned)
+              cmp = isMax ? arith::CmpIPredicate::ugt
+                          : arith::CmpIPredicate::ult;
+            else
+              cmp = isMax ? arith::CmpIPredicate::sgt
+                          : arith::CmpIPredicate::slt;
+            predicate = b.create<arith::CmpIOp>(loc, cmp, newValue, oldValue);
+          }
+          auto resultVal =
+              b.create<arith::SelectOp>(loc, predicate, newValue, oldValue);
+          auto resultIndex =
+              b.create<arith::SelectOp>(loc, predicate, newIndex, oldIndex);
+          b.create<linalg::YieldOp>(loc, ValueRange({resultVal, resultIndex}));
         });
 
     // This cast is required to fix the shape in the case of keepDim=True
-    Value maxValuesCast = rewriter.create<tensor::CastOp>(
-        loc, valResultType, linalgOp.getResult(0));
-    Value maxIdxCast = rewriter.create<tensor::CastOp>(loc, idxResultType,
-                                                       linalgOp.getResult(1));
-    rewriter.replaceOp(maxDimOp, {maxValuesCast, maxIdxCast});
+    Value valuesCast = rewriter.create<tensor::CastOp>(loc, valResultType,
+                                                       linalgOp.getResult(0));
+    Value idxCast = rewriter.create<tensor::CastOp>(loc, idxResultType,
+                                                    linalgOp.getResult(1));
+    rewriter.replaceOp(op, {valuesCast, idxCast});
     return success();
   }
 };
@@ -391,11 +416,109 @@ private:
     };
 
     Value initElem = createInitElementForReduceOp(rewriter, loc, op, elemType);
-    Value reduceOp = torch_to_linalg::createReductionLinalgGeneric(
-        rewriter, loc, opInfo, initElem, reductionBodyBuilder);
+    Value reduceOp;
+    if (shouldSplitReduction(opInfo)) {
+      reduceOp = createSplitReduction(loc, op, operands, opInfo, initElem,
+                                      reductionBodyBuilder, rewriter);
+    } else {
+      reduceOp = torch_to_linalg::createReductionLinalgGeneric(
+          rewriter, loc, opInfo, initElem, reductionBodyBuilder);
+    }
     return err ? Value{} : reduceOp;
   }
 
+  /// Whether the reduction is over all the dimensions of a static tensor whose
+  /// number of elements is a multiple of `reductionSplitFactor`, and larger
+  /// than it.
+  bool
+  shouldSplitReduction(const torch_to_linalg::ReductionOpInfo &opInfo) const {
+    if (reductionSplitFactor <= 1)
+      return false;
+    auto inputType = opInfo.tensorOperand.getType().cast<RankedTensorType>();
+    if (!inputType.hasStaticShape() || inputType.getRank() == 0 ||
+        static_cast<int64_t>(opInfo.dimSet.size()) != inputType.getRank())
+      return false;
+    int64_t numElements = inputType.getNumElements();
+    return numElements > reductionSplitFactor &&
+           numElements % reductionSplitFactor == 0;
+  }
+
+  /// Generate a full reduction as two linalg.generic operations: the input is
+  /// viewed as a `reductionSplitFactor` x (N / `reductionSplitFactor`) matrix
+  /// whose rows are reduced independently, with a parallel outer loop, and the
+  /// partial results are then combined. The payload of the first reduction is
+  /// that of the unsplit reduction. The combine adds the partial results, or
+  /// takes their max for `aten.max`.
+  Value createSplitReduction(
+      Location loc, Operation *op, ArrayRef<Value> operands,
+      const torch_to_linalg::ReductionOpInfo &opInfo, Value initElem,
+      function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild,
+      ConversionPatternRewriter &rewriter) const {
+    MLIRContext *context = rewriter.getContext();
+    Value input = opInfo.tensorOperand;
+    auto inputType = input.getType().cast<RankedTensorType>();
+    int64_t rank = inputType.getRank();
+    Type elemType = initElem.getType();
+    int64_t numElements = inputType.getNumElements();
+
+    SmallVector<ReassociationIndices> flatten(1);
+    for (int64_t i = 0; i < rank; i++)
+      flatten[0].push_back(i);
+    Value flat = rewriter.create<tensor::CollapseShapeOp>(loc, input, flatten);
+    auto splitType = RankedTensorType::get(
+        {reductionSplitFactor, numElements / reductionSplitFactor},
+        inputType.getElementType());
+    Value split = rewriter.create<tensor::ExpandShapeOp>(
+        loc, splitType, flat, ArrayRef<ReassociationIndices>{{0, 1}});
+
+    AffineExpr d0 = rewriter.getAffineDimExpr(0);
+    AffineExpr d1 = rewriter.getAffineDimExpr(1);
+    Value partialInit = rewriter.create<linalg::InitTensorOp>(
+        loc, ArrayRef<int64_t>{reductionSplitFactor}, elemType);
+    partialInit =
+        rewriter.create<linalg::FillOp>(loc, initElem, partialInit).result();
+    Value partial =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, partialInit.getType(), split, partialInit,
+                ArrayRef<AffineMap>{AffineMap::get(2, 0, {d0, d1}, context),
+                                    AffineMap::get(2, 0, {d0}, context)},
+                ArrayRef<StringRef>{getParallelIteratorTypeName(),
+                                    getReductionIteratorTypeName()},
+                bodyBuild)
+            .getResult(0);
+
+    // The combined result has the shape of the unsplit reduction: a scalar,
+    // or all ones if `keepDim`.
+    SmallVector<Value> resultShape;
+    SmallVector<AffineExpr> resultExprs;
+    if (opInfo.keepDim) {
+      resultShape.assign(rank,
+                         rewriter.create<arith::ConstantIndexOp>(loc, 1));
+      resultExprs.assign(rank, rewriter.getAffineConstantExpr(0));
+    }
+    Value resultInit =
+        createInitTensor(rewriter, loc, resultShape, elemType, initElem);
+    return rewriter
+        .create<linalg::GenericOp>(
+            loc, resultInit.getType(), partial, resultInit,
+            ArrayRef<AffineMap>{AffineMap::get(1, 0, {d0}, context),
+                                AffineMap::get(1, 0, resultExprs, context)},
+            ArrayRef<StringRef>{getReductionIteratorTypeName()},
+            [&](OpBuilder &b, Location loc, ValueRange args) {
+              Value combined;
+              if (isa<AtenLinalgVectorNormOp>(op)) {
+                combined = b.create<arith::AddFOp>(loc, args[0], args[1]);
+              } else {
+                // Partial sums and maxes are combined like input elements.
+                combined = createLinalgPayloadForReduceOp(b, loc, args, op,
+                                                          operands, elemType);
+              }
+              b.create<linalg::YieldOp>(loc, combined);
+            })
+        .getResult(0);
+  }
+
   /// Depending on the operation, check validity of the result's element type.
   LogicalResult
   validateReductionElementType(Operation *op, Type elemType,
@@ -408,9 +531,11 @@ private:
   }
 
 public:
-  ConvertReductionOp(TypeConverter &typeConverter, MLIRContext *context)
+  ConvertReductionOp(TypeConverter &typeConverter, MLIRContext *context,
+                     int64_t reductionSplitFactor)
       : ConversionPattern(typeConverter, MatchAnyOpTypeTag(), /*benefit=*/1,
-                          context) {}
+                          context),
+        reductionSplitFactor(reductionSplitFactor) {}
   LogicalResult
   matchAndRewrite(Operation *op, ArrayRef<Value> operands,
                   ConversionPatternRewriter &rewriter) const override {
@@ -453,18 +578,360 @@ public:
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, reduceOp);
     return success();
   }
+
+private:
+  int64_t reductionSplitFactor;
+};
+} // namespace
+
+namespace {
+// Softmax and log-softmax lowering that reads the input only twice, instead of
+// once per op of the max/sub/exp/sum/div decomposition.
+//
+// The first linalg.generic computes the max and the sum of the exponentials
+// along `dim` in a single pass, using the "online" recurrence that rescales
+// the running sum whenever a new max is found:
+//   max' = max(max, x)
+//   sum' = sum * exp(max - max') + exp(x - max')
+// Only one exponential is needed per element, since one of the two terms is
+// exp(0) = 1.
+//
+// The second linalg.generic computes `exp(x - max) / sum` for softmax, or
+// `x - max - log(sum)` for log-softmax.
+class ConvertSoftmaxOp : public ConversionPattern {
+public:
+  ConvertSoftmaxOp(TypeConverter &typeConverter, MLIRContext *context)
+      : ConversionPattern(typeConverter, MatchAnyOpTypeTag(), /*benefit=*/1,
+                          context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isa<AtenSoftmaxIntOp, Aten_SoftmaxOp, AtenLogSoftmaxIntOp,
+             Aten_LogSoftmaxOp>(op))
+      return rewriter.notifyMatchFailure(op, "not a softmax op");
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    bool isLogSoftmax = isa<AtenLogSoftmaxIntOp, Aten_LogSoftmaxOp>(op);
+
+    // All the softmax ops are (self, dim, dtype) or (self, dim, half_to_float).
+    Value dtypeOrHalfToFloat = op->getOperand(2);
+    if (isa<AtenSoftmaxIntOp, AtenLogSoftmaxIntOp>(op)) {
+      if (!dtypeOrHalfToFloat.getType().isa<Torch::NoneType>())
+        return rewriter.notifyMatchFailure(op, "unimplemented: non-None dtype");
+    } else {
+      bool halfToFloat;
+      if (!matchPattern(dtypeOrHalfToFloat, m_TorchConstantBool(&halfToFloat)))
+        return rewriter.notifyMatchFailure(
+            op, "expected a constant boolean value for half_to_float");
+      if (halfToFloat)
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: half_to_float is true");
+    }
+
+    Location loc = op->getLoc();
+    Value input = operands[0];
+    auto inputType = input.getType().cast<RankedTensorType>();
+    auto elementType = inputType.getElementType().dyn_cast<mlir::FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(op, "expected float element type");
+    int64_t rank = inputType.getRank();
+    int64_t dim;
+    if (!matchPattern(op->getOperand(1), m_TorchConstantInt(&dim)))
+      return rewriter.notifyMatchFailure(op, "dim must be constant");
+    dim = toPositiveDim(dim, rank);
+    if (!isValidDim(dim, rank))
+      return rewriter.notifyMatchFailure(op, "dim is not a valid dim");
+
+    Value max, sum;
+    torch_to_linalg::createMaxAndSumOfExpsReduction(rewriter, loc, input, dim,
+                                                    max, sum);
+
+    SmallVector<Value> inputShape = getTensorSizes(rewriter, loc, input);
+    SmallVector<AffineExpr> exprs, reducedExprs;
+    for (int64_t i = 0; i < rank; i++) {
+      exprs.push_back(rewriter.getAffineDimExpr(i));
+      if (i != dim)
+        reducedExprs.push_back(rewriter.getAffineDimExpr(i));
+    }
+
+    SmallVector<StringRef> parallelIteratorTypes(
+        rank, getParallelIteratorTypeName());
+    if (isLogSoftmax) {
+      // Take the log of the sums once, rather than once per element.
+      sum = torch_to_linalg::createElementwiseLinalgGeneric(
+          rewriter, loc, sum, elementType,
+          [](OpBuilder &b, Location loc, ValueRange args) {
+            b.create<linalg::YieldOp>(
+                loc, b.create<math::LogOp>(loc, args[0]).getResult());
+          });
+    }
+
+    Value initResult =
+        rewriter.create<linalg::InitTensorOp>(loc, inputShape, elementType);
+    auto normalizeMaps = AffineMap::inferFromExprList(
+        {exprs, reducedExprs, reducedExprs, exprs});
+    Value result =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, initResult.getType(), ValueRange({input, max, sum}),
+                initResult, normalizeMaps, parallelIteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value shifted =
+                      b.create<arith::SubFOp>(loc, args[0], args[1]);
+                  Value normalized;
+                  if (isLogSoftmax) {
+                    normalized = b.create<arith::SubFOp>(loc, shifted, args[2]);
+                  } else {
+                    normalized = b.create<arith::DivFOp>(
+                        loc, b.create<math::ExpOp>(loc, shifted), args[2]);
+                  }
+                  b.create<linalg::YieldOp>(loc, normalized);
+                })
+            .getResult(0);
+
+    Type resultType =
+        getTypeConverter()->convertType(op->getResult(0).getType());
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Softmax and log-softmax backward lowering that reads the gradient and the
+// output of the forward op only twice, instead of materializing the
+// intermediates of their decompositions.
+//
+// The first linalg.generic computes the sum along `dim` of
+// `grad_output * output` for softmax, or of `grad_output` for log-softmax.
+//
+// The second linalg.generic computes the gradient from that sum:
+//   softmax:     grad_input = output * (grad_output - sum)
+//   log-softmax: grad_input = grad_output - exp(output) * sum
+class ConvertSoftmaxBackwardOp : public ConversionPattern {
+public:
+  ConvertSoftmaxBackwardOp(TypeConverter &typeConverter, MLIRContext *context)
+      : ConversionPattern(typeConverter, MatchAnyOpTypeTag(), /*benefit=*/1,
+                          context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isa<Aten_SoftmaxBackwardDataOp, Aten_LogSoftmaxBackwardDataOp>(op))
+      return rewriter.notifyMatchFailure(op, "not a softmax backward op");
+    // The backward of a cross-entropy loss is lowered as a whole.
+    if (isLogSoftmaxBackwardOfNllLoss(op))
+      return rewriter.notifyMatchFailure(
+          op, "handled with the nll_loss_backward it consumes");
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    bool isLogSoftmax = isa<Aten_LogSoftmaxBackwardDataOp>(op);
+
+    // Both ops are (grad_output, output, dim, input_dtype).
+    Location loc = op->getLoc();
+    Value gradOutput = operands[0];
+    Value output = operands[1];
+    auto resultType = getTypeConverter()
+                          ->convertType(op->getResult(0).getType())
+                          .cast<RankedTensorType>();
+    auto elementType = resultType.getElementType().dyn_cast<mlir::FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(op, "expected float element type");
+    if (gradOutput.getType().cast<RankedTensorType>().getElementType() !=
+            elementType ||
+        output.getType().cast<RankedTensorType>().getElementType() !=
+            elementType)
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: input_dtype different from the gradient dtype");
+    int64_t rank = resultType.getRank();
+    int64_t dim;
+    if (!matchPattern(op->getOperand(2), m_TorchConstantInt(&dim)))
+      return rewriter.notifyMatchFailure(op, "dim must be constant");
+    dim = toPositiveDim(dim, rank);
+    if (!isValidDim(dim, rank))
+      return rewriter.notifyMatchFailure(op, "dim is not a valid dim");
+
+    SmallVector<Value> shape = getTensorSizes(rewriter, loc, gradOutput);
+    SmallVector<Value> reducedShape;
+    SmallVector<AffineExpr> exprs, reducedExprs;
+    SmallVector<StringRef> reductionIteratorTypes;
+    for (int64_t i = 0; i < rank; i++) {
+      exprs.push_back(rewriter.getAffineDimExpr(i));
+      if (i == dim) {
+        reductionIteratorTypes.push_back(getReductionIteratorTypeName());
+        continue;
+      }
+      reducedExprs.push_back(rewriter.getAffineDimExpr(i));
+      reducedShape.push_back(shape[i]);
+      reductionIteratorTypes.push_back(getParallelIteratorTypeName());
+    }
+
+    Value initSum =
+        createZeroInitTensor(rewriter, loc, reducedShape, elementType);
+    auto sumMaps = AffineMap::inferFromExprList({exprs, exprs, reducedExprs});
+    Value sum =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, initSum.getType(), ValueRange{gradOutput, output},
+                initSum, sumMaps, reductionIteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value term = args[0];
+                  if (!isLogSoftmax)
+                    term = b.create<arith::MulFOp>(loc, args[0], args[1]);
+                  b.create<linalg::YieldOp>(
+                      loc, b.create<arith::AddFOp>(loc, args[2], term)
+                               .getResult());
+                })
+            .getResult(0);
+
+    Value initResult =
+        rewriter.create<linalg::InitTensorOp>(loc, shape, elementType);
+    auto gradMaps =
+        AffineMap::inferFromExprList({exprs, exprs, reducedExprs, exprs});
+    SmallVector<StringRef> parallelIteratorTypes(
+        rank, getParallelIteratorTypeName());
+    Value result =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, initResult.getType(), ValueRange{gradOutput, output, sum},
+                initResult, gradMaps, parallelIteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value gradOutput = args[0], output = args[1], sum = args[2];
+                  Value gradInput;
+                  if (isLogSoftmax) {
+                    Value softmax = b.create<math::ExpOp>(loc, output);
+                    gradInput = b.create<arith::SubFOp>(
+                        loc, gradOutput,
+                        b.create<arith::MulFOp>(loc, softmax, sum));
+                  } else {
+                    gradInput = b.create<arith::MulFOp>(
+                        loc, output,
+                        b.create<arith::SubFOp>(loc, gradOutput, sum));
+                  }
+                  b.create<linalg::YieldOp>(loc, gradInput);
+                })
+            .getResult(0);
+
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Lowers aten.var and aten.std with a single reduction over the input, using
+// Welford's algorithm to update the running count, mean and sum of squared
+// differences from the mean (m2) for each element:
+//   count' = count + 1
+//   mean' = mean + (x - mean) / count'
+//   m2' = m2 + (x - mean) * (x - mean')
+// The variance is then m2 / count, or m2 / (count - 1) if `unbiased`.
+class ConvertAtenVarStdOp : public ConversionPattern {
+public:
+  ConvertAtenVarStdOp(TypeConverter &typeConverter, MLIRContext *context)
+      : ConversionPattern(typeConverter, MatchAnyOpTypeTag(), /*benefit=*/1,
+                          context) {}
+
+  LogicalResult
+  matchAndRewrite(Operation *op, ArrayRef<Value> operands,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isa<AtenVarOp, AtenStdOp>(op))
+      return rewriter.notifyMatchFailure(op, "not a var or std op");
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    bool isStd = isa<AtenStdOp>(op);
+
+    // Both ops are (self, unbiased).
+    bool unbiased;
+    if (!matchPattern(op->getOperand(1), m_TorchConstantBool(&unbiased)))
+      return rewriter.notifyMatchFailure(op, "unbiased must be constant");
+
+    Location loc = op->getLoc();
+    Value input = operands[0];
+    auto inputType = input.getType().cast<RankedTensorType>();
+    auto elementType = inputType.getElementType().dyn_cast<mlir::FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(op, "expected float element type");
+    int64_t rank = inputType.getRank();
+
+    // The count is kept as an integer, since float counts stop increasing
+    // once they reach 2^mantissa_bits.
+    Type countType = rewriter.getI64Type();
+    Value initCount = createZeroInitTensor(rewriter, loc, {}, countType);
+    Value initMean = createZeroInitTensor(rewriter, loc, {}, elementType);
+    Value initM2 = createZeroInitTensor(rewriter, loc, {}, elementType);
+    SmallVector<AffineMap> indexingMaps = {
+        rewriter.getMultiDimIdentityMap(rank),
+        AffineMap::get(rank, /*symbolCount=*/0, {}, rewriter.getContext())};
+    indexingMaps.resize(4, indexingMaps[1]);
+    SmallVector<StringRef> iteratorTypes(rank,
+                                         getReductionIteratorTypeName());
+    auto welford = rewriter.create<linalg::GenericOp>(
+        loc,
+        TypeRange{initCount.getType(), initMean.getType(), initM2.getType()},
+        input, ValueRange{initCount, initMean, initM2}, indexingMaps,
+        iteratorTypes, [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value x = args[0], count = args[1], mean = args[2], m2 = args[3];
+          Value one = b.create<arith::ConstantOp>(
+              loc, b.getIntegerAttr(countType, 1));
+          Value newCount = b.create<arith::AddIOp>(loc, count, one);
+          Value newCountFloat =
+              b.create<arith::SIToFPOp>(loc, elementType, newCount);
+          Value delta = b.create<arith::SubFOp>(loc, x, mean);
+          Value newMean = b.create<arith::AddFOp>(
+              loc, mean, b.create<arith::DivFOp>(loc, delta, newCountFloat));
+          Value newDelta = b.create<arith::SubFOp>(loc, x, newMean);
+          Value newM2 = b.create<arith::AddFOp>(
+              loc, m2, b.create<arith::MulFOp>(loc, delta, newDelta));
+          b.create<linalg::YieldOp>(loc, ValueRange{newCount, newMean, newM2});
+        });
+
+    Value result = torch_to_linalg::createElementwiseLinalgGeneric(
+        rewriter, loc, ValueRange{welford.getResult(0), welford.getResult(2)},
+        elementType, [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value count = args[0], m2 = args[1];
+          if (unbiased) {
+            // Bessel's correction.
+            Value one = b.create<arith::ConstantOp>(
+                loc, b.getIntegerAttr(countType, 1));
+            count = b.create<arith::SubIOp>(loc, count, one);
+          }
+          Value countFloat = b.create<arith::SIToFPOp>(loc, elementType, count);
+          Value var = b.create<arith::DivFOp>(loc, m2, countFloat);
+          if (isStd)
+            var = b.create<math::SqrtOp>(loc, var);
+          b.create<linalg::YieldOp>(loc, var);
+        });
+
+    Type resultType =
+        getTypeConverter()->convertType(op->getResult(0).getType());
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+    return success();
+  }
 };
 } // namespace
 
 void mlir::torch::torch_to_linalg::populateReductionPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
-    ConversionTarget &target) {
+    ConversionTarget &target, int64_t reductionSplitFactor) {
   MLIRContext *context = patterns.getContext();
   target.addIllegalOp<AtenMaxDimOp>();
-  patterns.add<ConvertAtenMaxDimOp>(typeConverter, context);
+  patterns.add<ConvertAtenMinMaxDimOp<AtenMaxDimOp>>(typeConverter, context);
+  target.addIllegalOp<AtenMinDimOp>();
+  patterns.add<ConvertAtenMinMaxDimOp<AtenMinDimOp>>(typeConverter, context);
   target.addIllegalOp<AtenSumOp>();
   target.addIllegalOp<AtenSumDimIntListOp>();
   target.addIllegalOp<AtenMaxOp>();
   target.addIllegalOp<AtenLinalgVectorNormOp>();
-  patterns.add<ConvertReductionOp>(typeConverter, context);
+  patterns.add<ConvertReductionOp>(typeConverter, context,
+                                   reductionSplitFactor);
+  target.addIllegalOp<AtenSoftmaxIntOp, Aten_SoftmaxOp, AtenLogSoftmaxIntOp,
+                      Aten_LogSoftmaxOp>();
+  patterns.add<ConvertSoftmaxOp>(typeConverter, context);
+  target.addIllegalOp<Aten_SoftmaxBackwardDataOp,
+                      Aten_LogSoftmaxBackwardDataOp>();
+  patterns.add<ConvertSoftmaxBackwardOp>(typeConverter, context);
+  target.addIllegalOp<AtenVarOp, AtenStdOp>();
+  patterns.add<ConvertAtenVarStdOp>(typeConverter, context);
 }
@@ -39,10 +39,15 @@ public:
     Value self = adaptor.self();
     Value dim = adaptor.dim();
     auto type = self.getType().cast<RankedTensorType>();
-    Value inputRank = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI64IntegerAttr(type.getRank()));
-    Value dimPositive = toPositiveDimDynamic(rewriter, loc, dim, inputRank);
-    assertIsValidDim(rewriter, loc, dimPositive, inputRank);
+    Value dimPositive = dim;
+    // The normalization and checks are not needed if `dim` is known to be a
+    // valid non-negative dimension.
+    if (!getIntRange(op.dim()).isWithin(0, type.getRank())) {
+      Value inputRank = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getI64IntegerAttr(type.getRank()));
+      dimPositive = toPositiveDimDynamic(rewriter, loc, dim, inputRank);
+      assertIsValidDim(rewriter, loc, dimPositive, inputRank);
+    }
     Value size = rewriter.create<tensor::DimOp>(
         loc, adaptor.self(), castIntToIndex(rewriter, loc, dimPositive));
     rewriter.replaceOp(op, castIndexToInt64(rewriter, loc, size));
@@ -16,6 +16,8 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
@@ -38,13 +40,20 @@ namespace {
 class ConvertTorchToLinalg
     : public ConvertTorchToLinalgBase<ConvertTorchToLinalg> {
 public:
+  ConvertTorchToLinalg() = default;
+  ConvertTorchToLinalg(bool convIm2col, int64_t reductionSplitFactor) {
+    this->convIm2col = convIm2col;
+    this->reductionSplitFactor = reductionSplitFactor;
+  }
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<linalg::LinalgDialect>();
     registry.insert<math::MathDialect>();
+    registry.insert<scf::SCFDialect>();
     registry.insert<func::FuncDialect>();
     registry.insert<tensor::TensorDialect>();
     registry.insert<arith::ArithmeticDialect>();
     registry.insert<cf::ControlFlowDialect>();
+    registry.insert<sparse_tensor::SparseTensorDialect>();
     TorchConversion::getBackendTypeConversionDependentDialects(registry);
   }
 
@@ -53,7 +62,9 @@ public:
     ConversionTarget target(*context);
     target.addLegalDialect<linalg::LinalgDialect, func::FuncDialect,
                            cf::ControlFlowDialect, math::MathDialect,
-                           tensor::TensorDialect, arith::ArithmeticDialect>();
+                           scf::SCFDialect, tensor::TensorDialect,
+                           arith::ArithmeticDialect,
+                           sparse_tensor::SparseTensorDialect>();
     target.addLegalOp<TorchConversion::GetNextSeedOp>();
 
     TypeConverter typeConverter;
@@ -67,21 +78,23 @@ public:
     torch_to_linalg::populateTensorScalarInteropPatternsAndLegality(
         typeConverter, patterns, target);
     torch_to_linalg::populateLinearPatternsAndLegality(typeConverter, patterns,
-                                                       target);
+                                                       target, convIm2col);
     torch_to_linalg::populatePoolingPatternsAndLegality(typeConverter, patterns,
                                                         target);
     torch_to_linalg::populateRandomPatternsAndLegality(typeConverter, patterns,
                                                        target);
     torch_to_linalg::populateUncategorizedPatternsAndLegality(typeConverter,
                                                               patterns, target);
-    torch_to_linalg::populateReductionPatternsAndLegality(typeConverter,
-                                                          patterns, target);
+    torch_to_linalg::populateReductionPatternsAndLegality(
+        typeConverter, patterns, target, reductionSplitFactor);
     torch_to_linalg::populateDataMovementPatternsAndLegality(typeConverter,
                                                              patterns, target);
     torch_to_linalg::populateIndirectDataMovementPatternsAndLegality(
         typeConverter, patterns, target);
     torch_to_linalg::populateTensorConstructorsPatternsAndLegality(
         typeConverter, patterns, target);
+    torch_to_linalg::populateCustomKernelsPatternsAndLegality(
+        typeConverter, patterns, target);
 
     if (failed(applyPartialConversion(getOperation(), target,
                                       std::move(patterns))))
@@ -91,6 +104,8 @@ public:
 } // namespace
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::torch::createConvertTorchToLinalgPass() {
-  return std::make_unique<ConvertTorchToLinalg>();
+mlir::torch::createConvertTorchToLinalgPass(bool convIm2col,
+                                            int64_t reductionSplitFactor) {
+  return std::make_unique<ConvertTorchToLinalg>(convIm2col,
+                                                reductionSplitFactor);
 }
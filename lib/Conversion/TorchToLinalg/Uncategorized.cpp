@@ -16,6 +16,7 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Matchers.h"
 #include "torch-mlir/Conversion/Utils/Utils.h"
@@ -265,6 +266,22 @@ static Value createLinalgPayloadCalculationForElementwiseOp(
     Value cdf = buildUnitNormalCdf(b, loc, payloadArgs[0]);
     return b.create<arith::MulFOp>(loc, payloadArgs[0], cdf);
   }
+  if (auto tanhBackward = dyn_cast<AtenTanhBackwardOp>(op)) {
+    if (!tanhBackward.getType()
+             .cast<ValueTensorType>()
+             .getDtype()
+             .isa<mlir::FloatType>()) {
+      tanhBackward.emitError("unimplemented: non-floating point dtype");
+      return nullptr;
+    }
+    // grad_input = grad_output * (1 - output^2), where output = tanh(x).
+    Value gradOutput = payloadArgs[0], output = payloadArgs[1];
+    Value one = b.create<arith::ConstantOp>(
+        loc, FloatAttr::get(output.getType(), 1.0));
+    Value derivative = b.create<arith::SubFOp>(
+        loc, one, b.create<arith::MulFOp>(loc, output, output));
+    return b.create<arith::MulFOp>(loc, gradOutput, derivative);
+  }
   if (auto geluBackward = dyn_cast<AtenGeluBackwardOp>(op)) {
     if (!geluBackward.getType()
              .cast<ValueTensorType>()
@@ -916,8 +933,8 @@ public:
   LogicalResult
   matchAndRewrite(Operation *op, ArrayRef<Value> operands,
                   ConversionPatternRewriter &rewriter) const override {
-    if (!isa<AtenTanhOp, AtenReluOp, AtenLeakyReluOp, AtenGeluOp,
-             AtenGeluBackwardOp, AtenAddTensorOp, AtenMulTensorOp,
+    if (!isa<AtenTanhOp, AtenTanhBackwardOp, AtenReluOp, AtenLeakyReluOp,
+             AtenGeluOp, AtenGeluBackwardOp, AtenAddTensorOp, AtenMulTensorOp,
              AtenDivTensorOp, AtenDivTensorModeOp, AtenSubTensorOp,
              AtenLerpTensorOp, AtenSigmoidOp, AtenExpOp, AtenMinimumOp,
              AtenMaximumOp, AtenToDtypeOp, AtenClampOp, AtenRsubScalarOp,
@@ -941,6 +958,11 @@ public:
     auto resultType = getTypeConverter()
                           ->convertType(op->getResult(0).getType())
                           .cast<RankedTensorType>();
+    // The result of ops that came from in-place variants overwrites their
+    // first operand, so compute it into that operand's tensor.
+    Value destination;
+    if (op->hasAttr("torch.inplace"))
+      destination = operands[0];
     bool hadErrorCreatingPayload = false;
     Value generic = torch_to_linalg::createElementwiseLinalgGeneric(
         rewriter, loc, tensorOperands, resultType.getElementType(),
@@ -952,7 +974,8 @@ public:
             return;
           }
           b.create<linalg::YieldOp>(loc, result);
-        });
+        },
+        destination);
     if (hadErrorCreatingPayload)
       return failure();
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, generic);
@@ -1068,6 +1091,143 @@ public:
 };
 } // namespace
 
+// Lowers `aten.cross_entropy_loss`, i.e. the `aten.nll_loss_forward` of the
+// `aten.log_softmax` of `self` along the class dimension, without
+// materializing the log-softmax. The loss of each sample is:
+//   loss[i] = weight[t] * (log(sum_c(exp(self[i][c] - max[i]))) + max[i] -
+//                          self[i][t])
+// where t = target[i] and max[i] = max_c(self[i][c]), or 0 if t is
+// `ignore_index`. The max and the sum of the exponentials are computed in a
+// single traversal of `self`, after which only the target element of each
+// sample is read.
+namespace {
+class ConvertAtenCrossEntropyLossOp
+    : public OpConversionPattern<AtenCrossEntropyLossOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenCrossEntropyLossOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    Location loc = op->getLoc();
+    Value input = adaptor.self();
+    Value target = adaptor.target();
+    bool weightIsNone = op.weight().getType().isa<Torch::NoneType>();
+    Value weight = adaptor.weight();
+
+    int64_t reduction;
+    if (!matchPattern(op.reduction(), m_TorchConstantInt(&reduction)))
+      return rewriter.notifyMatchFailure(op, "reduction must be constant");
+    double labelSmoothing;
+    if (!matchPattern(op.label_smoothing(),
+                      m_TorchConstantFloat(&labelSmoothing)) ||
+        labelSmoothing != 0.0)
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: label_smoothing must be 0.0");
+
+    auto inputType = input.getType().cast<RankedTensorType>();
+    int64_t inputRank = inputType.getRank();
+    auto elementType = inputType.getElementType().dyn_cast<mlir::FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(op, "expected float input");
+    // TODO: Add support for k-dim loss.
+    if (inputRank != 1 && inputRank != 2)
+      return rewriter.notifyMatchFailure(op,
+                                         "unimplemented: input of rank > 2");
+    if (!hasElementType<mlir::IntegerType>(target))
+      return rewriter.notifyMatchFailure(op, "expected integer target");
+    int64_t targetRank = inputRank - 1;
+    Value ignoreIndex = castIntToIndex(rewriter, loc, adaptor.ignore_index());
+
+    Value max, sumOfExps;
+    torch_to_linalg::createMaxAndSumOfExpsReduction(
+        rewriter, loc, input, /*dim=*/inputRank - 1, max, sumOfExps);
+
+    // Compute the loss and the weight of each sample.
+    SmallVector<Value> targetShape = getTensorSizes(rewriter, loc, target);
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getZeroAttr(elementType));
+    Value lossInit =
+        rewriter.create<linalg::InitTensorOp>(loc, targetShape, elementType);
+    Value weightInit =
+        rewriter.create<linalg::InitTensorOp>(loc, targetShape, elementType);
+    SmallVector<AffineMap> indexingMaps(
+        5, rewriter.getMultiDimIdentityMap(targetRank));
+    SmallVector<StringRef> iteratorTypes(targetRank,
+                                         getParallelIteratorTypeName());
+    auto perSample = rewriter.create<linalg::GenericOp>(
+        loc, TypeRange{lossInit.getType(), weightInit.getType()},
+        ValueRange{target, max, sumOfExps}, ValueRange{lossInit, weightInit},
+        indexingMaps, iteratorTypes,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value targetElem = castIntToIndex(b, loc, args[0]);
+          Value isIgnored = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::eq, targetElem, ignoreIndex);
+          // Don't read out of bounds for ignored samples.
+          Value c0 = b.create<arith::ConstantIndexOp>(loc, 0);
+          Value classIndex =
+              b.create<arith::SelectOp>(loc, isIgnored, c0, targetElem);
+          SmallVector<Value> extractionIndices{classIndex};
+          if (inputRank == 2)
+            extractionIndices.insert(extractionIndices.begin(),
+                                     b.create<linalg::IndexOp>(loc, 0));
+          Value logit =
+              b.create<tensor::ExtractOp>(loc, input, extractionIndices);
+          Value weightElem = getConstant(b, loc, 1, elementType);
+          if (!weightIsNone)
+            weightElem = b.create<tensor::ExtractOp>(loc, weight, classIndex);
+          weightElem =
+              b.create<arith::SelectOp>(loc, isIgnored, zero, weightElem);
+          Value logSumExp = b.create<arith::AddFOp>(
+              loc, b.create<math::LogOp>(loc, args[2]), args[1]);
+          Value loss = b.create<arith::MulFOp>(
+              loc, b.create<arith::SubFOp>(loc, logSumExp, logit), weightElem);
+          b.create<linalg::YieldOp>(loc, ValueRange{loss, weightElem});
+        });
+    Value finalRes = perSample.getResult(0);
+
+    if (reduction == torch_upstream::Reduction::Sum ||
+        reduction == torch_upstream::Reduction::Mean) {
+      // Sum the losses and, for the mean, the weights, which is the number of
+      // samples that are not ignored if there are no weights.
+      Value lossSum = createZeroInitTensor(rewriter, loc, {}, elementType);
+      Value weightSum = createZeroInitTensor(rewriter, loc, {}, elementType);
+      AffineMap sampleMap = rewriter.getMultiDimIdentityMap(targetRank);
+      AffineMap scalarMap = AffineMap::get(targetRank, /*symbolCount=*/0,
+                                           op->getContext());
+      SmallVector<StringRef> reductionIteratorTypes(
+          targetRank, getReductionIteratorTypeName());
+      auto sums = rewriter.create<linalg::GenericOp>(
+          loc, TypeRange{lossSum.getType(), weightSum.getType()},
+          perSample.getResults(), ValueRange{lossSum, weightSum},
+          ArrayRef<AffineMap>{sampleMap, sampleMap, scalarMap, scalarMap},
+          reductionIteratorTypes,
+          [&](OpBuilder &b, Location loc, ValueRange args) {
+            Value newLossSum = b.create<arith::AddFOp>(loc, args[0], args[2]);
+            Value newWeightSum = b.create<arith::AddFOp>(loc, args[1], args[3]);
+            b.create<linalg::YieldOp>(loc,
+                                      ValueRange{newLossSum, newWeightSum});
+          });
+      finalRes = sums.getResult(0);
+      if (reduction == torch_upstream::Reduction::Mean) {
+        finalRes = torch_to_linalg::createElementwiseLinalgGeneric(
+            rewriter, loc, sums.getResults(), elementType,
+            [&](OpBuilder &b, Location loc, ValueRange args) {
+              b.create<linalg::YieldOp>(
+                  loc, b.create<arith::DivFOp>(loc, args[0], args[1])
+                           .getResult());
+            });
+      }
+    }
+
+    Type resultType = getTypeConverter()->convertType(op.getType());
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, finalRes);
+    return success();
+  }
+};
+} // namespace
+
 /// Inverted STD: rSTD = 1 / sqrt(var + eps).
 static Value calculateRSTD(OpBuilder &b, Location loc, Type elemTy, Value eps,
                            Value var) {
@@ -1099,6 +1259,203 @@ static Value createLinalgPayloadCalculationForNormOpsWithVar(
   return result;
 }
 
+// Computes the mean and the sum of squared differences from the mean of the
+// elements of `input` reduced into each element of the stats, indexed by
+// `statsMap`, in a single pass over the input using Welford's algorithm:
+//   count' = count + 1
+//   mean' = mean + (x - mean) / count'
+//   m2' = m2 + (x - mean) * (x - mean')
+static std::pair<Value, Value>
+createWelfordReduction(OpBuilder &b, Location loc, Value input,
+                       AffineMap statsMap, ArrayRef<StringRef> iteratorTypes,
+                       ValueRange statsSizes) {
+  auto inputType = input.getType().cast<RankedTensorType>();
+  Type elemTy = inputType.getElementType();
+  SmallVector<AffineMap> indexingMaps{
+      b.getMultiDimIdentityMap(inputType.getRank()), // input
+      statsMap,                                      // count
+      statsMap,                                      // mean
+      statsMap,                                      // m2
+  };
+  Value initCountTensor = createZeroInitTensor(b, loc, statsSizes, elemTy);
+  Value initMeanTensor = createZeroInitTensor(b, loc, statsSizes, elemTy);
+  Value initM2Tensor = createZeroInitTensor(b, loc, statsSizes, elemTy);
+  auto welford = b.create<linalg::GenericOp>(
+      loc,
+      TypeRange{initCountTensor.getType(), initMeanTensor.getType(),
+                initM2Tensor.getType()},
+      input, ValueRange{initCountTensor, initMeanTensor, initM2Tensor},
+      /*indexingMaps=*/indexingMaps,
+      /*iteratorTypes=*/iteratorTypes,
+      [&](OpBuilder &b, Location loc, ValueRange args) {
+        Value input = args[0], count = args[1], mean = args[2], m2 = args[3];
+        Value one =
+            b.create<arith::ConstantOp>(loc, b.getFloatAttr(elemTy, 1.0));
+        Value newCount = b.create<arith::AddFOp>(loc, count, one);
+        Value delta = b.create<arith::SubFOp>(loc, input, mean);
+        Value newMean = b.create<arith::AddFOp>(
+            loc, mean, b.create<arith::DivFOp>(loc, delta, newCount));
+        Value newDelta = b.create<arith::SubFOp>(loc, input, newMean);
+        Value newM2 = b.create<arith::AddFOp>(
+            loc, m2, b.create<arith::MulFOp>(loc, delta, newDelta));
+        b.create<linalg::YieldOp>(loc, ValueRange{newCount, newMean, newM2});
+      });
+  return {welford.getResult(1), welford.getResult(2)};
+}
+
+// Returns the number of elements of each channel of `input`, i.e. of all its
+// dimensions but dimension 1, as a float of the element type of `input`.
+static Value getBatchNormChannelSize(OpBuilder &b, Location loc, Value input) {
+  auto inputType = input.getType().cast<RankedTensorType>();
+  Value count = b.create<arith::ConstantIndexOp>(loc, 1);
+  for (int64_t i = 0; i < inputType.getRank(); i++) {
+    if (i != 1)
+      count = b.create<arith::MulIOp>(loc, count, getDimOp(b, loc, input, i));
+  }
+  return b.create<arith::SIToFPOp>(loc, inputType.getElementType(),
+                                   castIndexToInt64(b, loc, count));
+}
+
+namespace {
+// The results of a batch norm in training mode.
+struct BatchNormTrainingResults {
+  Value output;
+  Value mean;
+  Value invstd;
+  // Null if no running stats are given.
+  Value newRunningMean;
+  Value newRunningVar;
+};
+} // namespace
+
+// Lowers a batch norm in training mode, which normalizes each channel of the
+// input (N, C, D?, H?, W?) with the mean and the biased variance of its
+// elements. The stats are computed in a single pass over the input, so that
+// the input is only read twice: once for the stats and once to normalize it.
+// A per-channel op computes the inverse standard deviation and, if
+// `runningMean` and `runningVar` are given, their updates with the unbiased
+// variance:
+//   newRunningMean = (1 - momentum) * runningMean + momentum * mean
+//   newRunningVar = (1 - momentum) * runningVar + momentum * m2 / (n - 1)
+// `weight` and `bias` may be null. `momentum` and `eps` are f64 scalars.
+static BatchNormTrainingResults
+createBatchNormTraining(OpBuilder &b, Location loc, Value input, Value weight,
+                        Value bias, Value runningMean, Value runningVar,
+                        Value momentum, Value eps) {
+  MLIRContext *context = b.getContext();
+  auto inputType = input.getType().cast<RankedTensorType>();
+  int64_t inputRank = inputType.getRank();
+  Type elemTy = inputType.getElementType();
+  BatchNormTrainingResults results;
+
+  // Step 1. Get the mean and the sum of squared differences from the mean of
+  // each channel.
+  AffineMap inputMap = b.getMultiDimIdentityMap(inputRank);
+  AffineMap channelMap = AffineMap::get(
+      /*dimCount=*/inputRank, /*symbolCount=*/0, b.getAffineDimExpr(1),
+      context);
+  SmallVector<StringRef> statsIteratorTypes(inputRank,
+                                            getReductionIteratorTypeName());
+  statsIteratorTypes[1] = getParallelIteratorTypeName();
+  Value numChannels = getDimOp(b, loc, input, 1);
+  Value m2;
+  std::tie(results.mean, m2) = createWelfordReduction(
+      b, loc, input, channelMap, statsIteratorTypes, numChannels);
+
+  // Step 2. Get the inverse standard deviation and the new running stats.
+  Value count = getBatchNormChannelSize(b, loc, input);
+  bool updateRunningStats = runningMean && runningVar;
+  SmallVector<Value> channelInputs{m2};
+  SmallVector<Value> channelOutputs{
+      b.create<linalg::InitTensorOp>(loc, numChannels, elemTy)};
+  Value momentumElem, oneMinusMomentum, countMinusOne;
+  if (updateRunningStats) {
+    channelInputs.append({results.mean, runningMean, runningVar});
+    channelOutputs.push_back(
+        b.create<linalg::InitTensorOp>(loc, numChannels, elemTy));
+    channelOutputs.push_back(
+        b.create<linalg::InitTensorOp>(loc, numChannels, elemTy));
+    Value one = b.create<arith::ConstantOp>(loc, b.getFloatAttr(elemTy, 1.0));
+    momentumElem = convertScalarToDtype(b, loc, momentum, elemTy);
+    oneMinusMomentum = b.create<arith::SubFOp>(loc, one, momentumElem);
+    countMinusOne = b.create<arith::SubFOp>(loc, count, one);
+  }
+  SmallVector<AffineMap> channelIndexingMaps(
+      channelInputs.size() + channelOutputs.size(),
+      b.getMultiDimIdentityMap(1));
+  auto channelStats = b.create<linalg::GenericOp>(
+      loc, ValueRange(channelOutputs).getTypes(), channelInputs,
+      channelOutputs, channelIndexingMaps,
+      ArrayRef<StringRef>{getParallelIteratorTypeName()},
+      [&](OpBuilder &b, Location loc, ValueRange args) {
+        Value m2 = args[0];
+        Value var = b.create<arith::DivFOp>(loc, m2, count);
+        SmallVector<Value> yields{calculateRSTD(b, loc, elemTy, eps, var)};
+        if (updateRunningStats) {
+          Value mean = args[1], runningMean = args[2], runningVar = args[3];
+          auto lerp = [&](Value running, Value batch) -> Value {
+            return b.create<arith::AddFOp>(
+                loc, b.create<arith::MulFOp>(loc, oneMinusMomentum, running),
+                b.create<arith::MulFOp>(loc, momentumElem, batch));
+          };
+          Value unbiasedVar = b.create<arith::DivFOp>(loc, m2, countMinusOne);
+          yields.push_back(lerp(runningMean, mean));
+          yields.push_back(lerp(runningVar, unbiasedVar));
+        }
+        b.create<linalg::YieldOp>(loc, yields);
+      });
+  results.invstd = channelStats.getResult(0);
+  if (updateRunningStats) {
+    results.newRunningMean = channelStats.getResult(1);
+    results.newRunningVar = channelStats.getResult(2);
+  }
+
+  // Step 3. Normalize the input.
+  SmallVector<Value> inputs{input, results.mean, results.invstd};
+  SmallVector<AffineMap> indexingMaps{inputMap, channelMap, channelMap};
+  if (weight) {
+    inputs.push_back(weight);
+    indexingMaps.push_back(channelMap);
+  }
+  if (bias) {
+    inputs.push_back(bias);
+    indexingMaps.push_back(channelMap);
+  }
+  indexingMaps.push_back(inputMap);
+  Value initTensor = b.create<linalg::InitTensorOp>(
+      loc, getTensorSizes(b, loc, input), elemTy);
+  SmallVector<StringRef> iteratorTypes(inputRank,
+                                       getParallelIteratorTypeName());
+  results.output =
+      b.create<linalg::GenericOp>(
+           loc, initTensor.getType(), inputs, initTensor, indexingMaps,
+           iteratorTypes,
+           [&](OpBuilder &b, Location loc, ValueRange args) {
+             Value input = args[0], mean = args[1], invstd = args[2];
+             Value result = b.create<arith::MulFOp>(
+                 loc, b.create<arith::SubFOp>(loc, input, mean), invstd);
+             unsigned next = 3;
+             if (weight)
+               result = b.create<arith::MulFOp>(loc, result, args[next++]);
+             if (bias)
+               result = b.create<arith::AddFOp>(loc, result, args[next++]);
+             b.create<linalg::YieldOp>(loc, result);
+           })
+          .getResult(0);
+  return results;
+}
+
+// Returns `value`, an optional tensor operand converted to the backend types,
+// or null if it is None.
+static Value getOptionalTensor(Value value) {
+  return value.getType().isa<Torch::NoneType>() ? Value() : value;
+}
+
+static bool isConstantTrue(Value value) {
+  bool constant;
+  return matchPattern(value, m_TorchConstantBool(&constant)) && constant;
+}
+
 namespace {
 class ConvertAtenBatchNormOp : public OpConversionPattern<AtenBatchNormOp> {
 public:
@@ -1119,6 +1476,23 @@ public:
     if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
       return failure();
 
+    // In training mode, the input is normalized with its own stats. The
+    // running stats are updated by `valsem.aten.native_batch_norm.functional`
+    // instead, which `aten.batch_norm` is reduced to when they are given.
+    if (isConstantTrue(op.training())) {
+      if (input.getType().cast<RankedTensorType>().getRank() <= 2)
+        return rewriter.notifyMatchFailure(
+            op, "input should have rank larger than 2");
+      BatchNormTrainingResults results = createBatchNormTraining(
+          rewriter, loc, input, getOptionalTensor(weight),
+          getOptionalTensor(bias), /*runningMean=*/nullptr,
+          /*runningVar=*/nullptr, adaptor.momentum(), eps);
+      Type newResultType = getTypeConverter()->convertType(op.getType());
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType,
+                                                  results.output);
+      return success();
+    }
+
     // TODO: Handle the None cases for the optional parameters:
     // weight, bias.
     if (failed(checkNotNone(rewriter, op, weight)) ||
@@ -1205,6 +1579,201 @@ public:
 };
 } // namespace
 
+namespace {
+// Lowers `aten.native_batch_norm` in training mode, and its variant that also
+// returns the updated running stats.
+template <typename OpTy>
+class ConvertNativeBatchNormTrainingOp : public OpConversionPattern<OpTy> {
+public:
+  using OpConversionPattern<OpTy>::OpConversionPattern;
+  using OpAdaptor = typename OpTy::Adaptor;
+  LogicalResult
+  matchAndRewrite(OpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    if (!isConstantTrue(op.training()))
+      return rewriter.notifyMatchFailure(op, "only training mode is handled");
+    Value input = adaptor.input();
+    if (input.getType().template cast<RankedTensorType>().getRank() <= 2)
+      return rewriter.notifyMatchFailure(
+          op, "input should have rank larger than 2");
+
+    BatchNormTrainingResults results = createBatchNormTraining(
+        rewriter, op.getLoc(), input, getOptionalTensor(adaptor.weight()),
+        getOptionalTensor(adaptor.bias()),
+        getOptionalTensor(adaptor.running_mean()),
+        getOptionalTensor(adaptor.running_var()), adaptor.momentum(),
+        adaptor.eps());
+    SmallVector<Value> values{results.output, results.mean, results.invstd};
+    if (op->getNumResults() == 5) {
+      if (!results.newRunningMean)
+        return rewriter.notifyMatchFailure(op, "expected running stats");
+      values.append({results.newRunningMean, results.newRunningVar});
+    }
+    SmallVector<Value> newResults;
+    for (auto it : llvm::zip(op->getResultTypes(), values)) {
+      Type resultType =
+          this->getTypeConverter()->convertType(std::get<0>(it));
+      newResults.push_back(rewriter.create<tensor::CastOp>(
+          op.getLoc(), resultType, std::get<1>(it)));
+    }
+    rewriter.replaceOp(op, newResults);
+    return success();
+  }
+};
+} // namespace
+
+// The gradients of a batch norm in training mode, where `xmu` is
+// `input - save_mean`, `N` the number of elements of each channel, and the
+// sums are over all the elements of a channel:
+//   grad_bias = sum(dy)
+//   grad_weight = sum(dy * xmu) * save_invstd
+//   grad_input = (dy - xmu * sum(dy * xmu) * save_invstd^2 / N
+//                 - sum(dy) / N) * save_invstd * weight
+// Both sums are computed in a single reduction over the channels, so the whole
+// backward reads `input` and `grad_out` twice.
+namespace {
+class ConvertAtenNativeBatchNormBackwardOp
+    : public OpConversionPattern<AtenNativeBatchNormBackwardOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenNativeBatchNormBackwardOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    MLIRContext *context = op->getContext();
+    Location loc = op->getLoc();
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    if (!isConstantTrue(op.train()))
+      return rewriter.notifyMatchFailure(op, "only training mode is handled");
+    Value gradOut = adaptor.grad_out();
+    Value input = adaptor.input();
+    Value weight = getOptionalTensor(adaptor.weight());
+    Value saveMean = adaptor.save_mean();
+    Value saveInvstd = adaptor.save_invstd();
+    if (failed(checkNotNone(rewriter, op, saveMean)) ||
+        failed(checkNotNone(rewriter, op, saveInvstd)))
+      return failure();
+
+    auto inputType = input.getType().cast<RankedTensorType>();
+    int64_t inputRank = inputType.getRank();
+    Type elemTy = inputType.getElementType();
+    if (inputRank <= 2)
+      return rewriter.notifyMatchFailure(
+          op, "input should have rank larger than 2");
+
+    AffineMap inputMap = rewriter.getMultiDimIdentityMap(inputRank);
+    AffineMap channelMap = AffineMap::get(
+        /*dimCount=*/inputRank, /*symbolCount=*/0,
+        rewriter.getAffineDimExpr(1), context);
+    AffineMap vectorMap = rewriter.getMultiDimIdentityMap(1);
+    Value numChannels = getDimOp(rewriter, loc, input, 1);
+
+    // Step 1. Get sum(dy) and sum(dy * xmu) of each channel.
+    Value initSumDy =
+        createZeroInitTensor(rewriter, loc, numChannels, elemTy);
+    Value initSumDyXmu =
+        createZeroInitTensor(rewriter, loc, numChannels, elemTy);
+    SmallVector<StringRef> reductionIteratorTypes(
+        inputRank, getReductionIteratorTypeName());
+    reductionIteratorTypes[1] = getParallelIteratorTypeName();
+    auto sums = rewriter.create<linalg::GenericOp>(
+        loc, TypeRange{initSumDy.getType(), initSumDyXmu.getType()},
+        ValueRange{gradOut, input, saveMean},
+        ValueRange{initSumDy, initSumDyXmu},
+        /*indexingMaps=*/
+        ArrayRef<AffineMap>{inputMap, inputMap, channelMap, channelMap,
+                            channelMap},
+        /*iteratorTypes=*/reductionIteratorTypes,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value dy = args[0], input = args[1], mean = args[2],
+                sumDy = args[3], sumDyXmu = args[4];
+          Value xmu = b.create<arith::SubFOp>(loc, input, mean);
+          Value newSumDy = b.create<arith::AddFOp>(loc, sumDy, dy);
+          Value newSumDyXmu = b.create<arith::AddFOp>(
+              loc, sumDyXmu, b.create<arith::MulFOp>(loc, dy, xmu));
+          b.create<linalg::YieldOp>(loc, ValueRange{newSumDy, newSumDyXmu});
+        });
+    Value sumDy = sums.getResult(0);
+    Value sumDyXmu = sums.getResult(1);
+
+    // Step 2. Get the per-channel factors of the input gradient, and the
+    // weight gradient.
+    Value count = getBatchNormChannelSize(rewriter, loc, input);
+    SmallVector<Value> channelInputs{sumDy, sumDyXmu, saveInvstd};
+    if (weight)
+      channelInputs.push_back(weight);
+    SmallVector<Value> channelOutputs;
+    for (int i = 0; i < 4; i++) {
+      channelOutputs.push_back(
+          rewriter.create<linalg::InitTensorOp>(loc, numChannels, elemTy));
+    }
+    SmallVector<AffineMap> channelIndexingMaps(
+        channelInputs.size() + channelOutputs.size(), vectorMap);
+    auto factors = rewriter.create<linalg::GenericOp>(
+        loc, ValueRange(channelOutputs).getTypes(), channelInputs,
+        channelOutputs, channelIndexingMaps,
+        ArrayRef<StringRef>{getParallelIteratorTypeName()},
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value sumDy = args[0], sumDyXmu = args[1], invstd = args[2];
+          Value gradWeight = b.create<arith::MulFOp>(loc, sumDyXmu, invstd);
+          Value projScale = b.create<arith::DivFOp>(
+              loc, b.create<arith::MulFOp>(loc, gradWeight, invstd), count);
+          Value gradMean = b.create<arith::DivFOp>(loc, sumDy, count);
+          Value inputScale = invstd;
+          if (weight)
+            inputScale = b.create<arith::MulFOp>(loc, invstd, args[3]);
+          b.create<linalg::YieldOp>(
+              loc, ValueRange{gradWeight, projScale, gradMean, inputScale});
+        });
+    Value gradWeight = factors.getResult(0);
+    Value projScale = factors.getResult(1);
+    Value gradMean = factors.getResult(2);
+    Value inputScale = factors.getResult(3);
+
+    // Step 3. Get the input gradient.
+    Value initGradInput = rewriter.create<linalg::InitTensorOp>(
+        loc, getTensorSizes(rewriter, loc, input), elemTy);
+    SmallVector<StringRef> iteratorTypes(inputRank,
+                                         getParallelIteratorTypeName());
+    Value gradInput =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, initGradInput.getType(),
+                ValueRange{gradOut, input, saveMean, projScale, gradMean,
+                           inputScale},
+                initGradInput,
+                /*indexingMaps=*/
+                ArrayRef<AffineMap>{inputMap, inputMap, channelMap, channelMap,
+                                    channelMap, channelMap, inputMap},
+                /*iteratorTypes=*/iteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value dy = args[0], input = args[1], mean = args[2],
+                        projScale = args[3], gradMean = args[4],
+                        inputScale = args[5];
+                  Value xmu = b.create<arith::SubFOp>(loc, input, mean);
+                  Value result = b.create<arith::SubFOp>(
+                      loc, dy, b.create<arith::MulFOp>(loc, xmu, projScale));
+                  result = b.create<arith::SubFOp>(loc, result, gradMean);
+                  result = b.create<arith::MulFOp>(loc, result, inputScale);
+                  b.create<linalg::YieldOp>(loc, result);
+                })
+            .getResult(0);
+
+    SmallVector<Value> newResults;
+    for (auto it : llvm::zip(op->getResultTypes(),
+                             ValueRange{gradInput, gradWeight, sumDy})) {
+      Type resultType = getTypeConverter()->convertType(std::get<0>(it));
+      newResults.push_back(
+          rewriter.create<tensor::CastOp>(loc, resultType, std::get<1>(it)));
+    }
+    rewriter.replaceOp(op, newResults);
+    return success();
+  }
+};
+} // namespace
+
 // For layernorm, the mean and standard-deviation are calculated separately over
 // the last certain number dimensions which have to be of the shape specified by
 // normalized_shape.
@@ -1218,7 +1787,7 @@ public:
 // Step 1. Check if all the arguments meet the requirements.
 // Step 2. Common parts to be used for getting mean and var.
 //         This includes elements count, affineMap and iteratorTypes.
-// Step 3. Get mean.
+// Step 3. Get mean and the sum of squared differences from it in one pass.
 // Step 4. Get rSTD.
 // Step 5. Get layernorm.
 namespace {
@@ -1314,76 +1883,14 @@ public:
     Value elemCntsFloat =
         rewriter.create<arith::SIToFPOp>(loc, elemTy, elemCnts);
 
-    // Helper to calculate mean and var.
-    auto genMeanOrVarCalculation = [&](Value sumOrSquareSum) {
-      SmallVector<AffineMap> indexingMaps(
-          2, rewriter.getMultiDimIdentityMap(meanAndVarShapeRank));
-      Value initShapeTensor = rewriter.create<linalg::InitTensorOp>(
-          loc, meanAndVarShapeSizes, elemTy);
-      return rewriter
-          .create<linalg::GenericOp>(
-              loc, initShapeTensor.getType(), sumOrSquareSum, initShapeTensor,
-              /*indexingMaps=*/indexingMaps,
-              /*iteratorTypes=*/meanAndVarIterationTypes,
-              [&](OpBuilder &b, Location loc, ValueRange args) {
-                Value sumOrSqureSum = args[0];
-                Value result =
-                    b.create<arith::DivFOp>(loc, sumOrSqureSum, elemCntsFloat);
-                b.create<linalg::YieldOp>(loc, result);
-              })
-          .getResult(0);
-    };
-
-    // Step 3. Get mean.
-
-    // Get sum to be used for calculating mean.
-    SmallVector<AffineMap, 2> sumIndexingMaps = {
-        inputShapeAffineMap,      // input
-        meanAndVarShapeAffineMap, // output
-    };
-    auto initSumTensor =
-        createZeroInitTensor(rewriter, loc, meanAndVarShapeSizes, elemTy);
-    Value sum = rewriter
-                    .create<linalg::GenericOp>(
-                        loc, initSumTensor.getType(), input, initSumTensor,
-                        /*indexingMaps=*/sumIndexingMaps,
-                        /*iteratorTypes=*/inputShapeIteratorTypes,
-                        [&](OpBuilder &b, Location loc, ValueRange args) {
-                          Value input = args[0], sum = args[1];
-                          Value result =
-                              rewriter.create<arith::AddFOp>(loc, sum, input);
-                          b.create<linalg::YieldOp>(loc, result);
-                        })
-                    .getResult(0);
-    Value mean = genMeanOrVarCalculation(sum);
+    // Step 3. Get mean and the sum of squared differences from the mean, in a
+    // single pass over the input.
+    Value mean, m2;
+    std::tie(mean, m2) = createWelfordReduction(
+        rewriter, loc, input, meanAndVarShapeAffineMap,
+        inputShapeIteratorTypes, meanAndVarShapeSizes);
 
     // Step 4. Get rSTD.
-
-    // Calculate squareSum for the layer.
-    SmallVector<AffineMap> squareSumIndexingMaps{
-        inputShapeAffineMap,
-        meanAndVarShapeAffineMap,
-        meanAndVarShapeAffineMap,
-    };
-    auto initSquareSumTensor =
-        createZeroInitTensor(rewriter, loc, meanAndVarShapeSizes, elemTy);
-    Value squareSum =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, initSquareSumTensor.getType(), ValueRange{input, mean},
-                initSquareSumTensor,
-                /*indexingMaps=*/squareSumIndexingMaps,
-                /*iteratorTypes=*/inputShapeIteratorTypes,
-                [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value input = args[0], mean = args[1], squareSum = args[2];
-                  Value sub = rewriter.create<arith::SubFOp>(loc, input, mean);
-                  Value square = rewriter.create<arith::MulFOp>(loc, sub, sub);
-                  Value result =
-                      rewriter.create<arith::AddFOp>(loc, squareSum, square);
-                  b.create<linalg::YieldOp>(loc, result);
-                })
-            .getResult(0);
-    Value var = genMeanOrVarCalculation(squareSum);
     Value rSTDTensor = rewriter.create<linalg::InitTensorOp>(
         loc, meanAndVarShapeSizes, elemTy);
     SmallVector<AffineMap> rSTDIndexingMap(
@@ -1391,11 +1898,13 @@ public:
 
     Value rSTD = rewriter
                      .create<linalg::GenericOp>(
-                         loc, rSTDTensor.getType(), var, rSTDTensor,
+                         loc, rSTDTensor.getType(), m2, rSTDTensor,
                          rSTDIndexingMap, meanAndVarIterationTypes,
                          [&](OpBuilder &b, Location loc, ValueRange args) {
+                           Value var = b.create<arith::DivFOp>(loc, args[0],
+                                                               elemCntsFloat);
                            Value result =
-                               calculateRSTD(b, loc, elemTy, eps, args[0]);
+                               calculateRSTD(b, loc, elemTy, eps, var);
                            b.create<linalg::YieldOp>(loc, result);
                          })
                      .getResult(0);
@@ -1470,6 +1979,164 @@ public:
 };
 } // namespace
 
+// Creates the gradient of the `nll_loss_forward` of `op` with respect to its
+// input `self`. The operands are those of `op`, converted, with `weight` being
+// null if it is `None`.
+//
+// If `logSoftmaxOutput` is non-null, `self` is the log-softmax along the class
+// dimension of some logits, and the gradient with respect to the logits is
+// created instead. As the gradient with respect to `self` is nonzero only at
+// the target class, the gradient of the log-softmax
+//   grad_logits = grad_self - exp(log_softmax) * sum(grad_self, class_dim)
+// simplifies to `exp(log_softmax) * s - (class == target ? s : 0)`, where `s`
+// is the weighted gradient of the loss of the sample. So the gradient of each
+// logit is computed from the corresponding log-softmax output alone, without
+// a reduction.
+static FailureOr<Value> createNllLossBackward(
+    AtenNllLossBackwardOp op, Value gradOutput, Value self, Value target,
+    Value weight, Value ignoreIndexInt, Value totalWeight,
+    Value logSoftmaxOutput, ConversionPatternRewriter &rewriter) {
+  Location loc = op->getLoc();
+  Value ignoreIndex = castIntToIndex(rewriter, loc, ignoreIndexInt);
+
+  auto inputType = self.getType().cast<RankedTensorType>();
+  int inputRank = inputType.getRank();
+  auto gradOutputType = gradOutput.getType().cast<RankedTensorType>();
+  Type resultElementType = gradOutputType.getElementType();
+
+  int64_t reduction;
+  if (!matchPattern(op.reduction(), m_TorchConstantInt(&reduction)))
+    return rewriter.notifyMatchFailure(op, "dim must be constant");
+
+  if (!hasElementType<mlir::FloatType>(gradOutput) ||
+      !hasElementType<mlir::FloatType>(gradOutput) ||
+      (weight && !hasElementType<mlir::FloatType>(weight))) {
+    return rewriter.notifyMatchFailure(
+        op, "`gradOutput`, 'weight', and `totalWeight` must be tensors of "
+            "type float");
+  }
+
+  if (!hasElementType<mlir::IntegerType>(target)) {
+    return rewriter.notifyMatchFailure(
+        op, "`target` must be a tensor of integer type");
+  }
+
+  auto outputSize = getTensorSizes(rewriter, loc, self);
+  Value gradInputTensor =
+      createZeroInitTensor(rewriter, loc, outputSize, resultElementType);
+
+  auto getAffineMapForSingleElementTensor = [&](Value tensor) {
+    auto tensorType = tensor.getType().cast<RankedTensorType>();
+    SmallVector<AffineExpr> affineExprs(tensorType.getRank(),
+                                        rewriter.getAffineConstantExpr(0));
+    return AffineMap::get(inputRank, /*symbolCount=*/0, affineExprs,
+                          op->getContext());
+  };
+
+  AffineMap gradOutMap = AffineMap::get(inputRank, /*symbolCount=*/0,
+                                        rewriter.getAffineDimExpr(0));
+  if (reduction != torch_upstream::Reduction::None || inputRank == 1)
+    gradOutMap = getAffineMapForSingleElementTensor(gradOutput);
+  AffineMap targetMap = AffineMap::get(inputRank, /*symbolCount=*/0,
+                                       rewriter.getAffineDimExpr(0));
+  if (inputRank == 1)
+    targetMap = getAffineMapForSingleElementTensor(target);
+  AffineMap totalWeightMap = getAffineMapForSingleElementTensor(totalWeight);
+  AffineMap resultMap = rewriter.getMultiDimIdentityMap(inputRank);
+
+  SmallVector<Value> inputs{gradOutput, target, totalWeight};
+  SmallVector<AffineMap> indexingMaps{gradOutMap, targetMap, totalWeightMap};
+  if (logSoftmaxOutput) {
+    inputs.push_back(logSoftmaxOutput);
+    indexingMaps.push_back(resultMap);
+  }
+  indexingMaps.push_back(resultMap);
+  SmallVector<StringRef> iteratorTypes(inputRank,
+                                       getParallelIteratorTypeName());
+
+  // The code generation is equivalent to the following pseudo-code:
+  //
+  // for batch_index in len(input.size(0)):
+  //     for class_index in len(input.size(1)):
+  //         target_elem = target[batch_index]
+  //
+  //         if reduction == None:
+  //             grad_out_elem = grad_output[batchIndex]
+  //         else:
+  //             grad_out_elem = grad_output[0]
+  //
+  //         if reduction == Mean:
+  //             total_weight_elem = total_weight[0]
+  //             grad_out_elem /= total_weight_elem
+  //
+  //         weight_elem = weight[target_elem] if weight != None else 1
+  //
+  //         if target_elem != class_index or target_elem == ignore_index:
+  //             grad_input_elem = -weight_elem * grad_out_elem
+  //         else:
+  //             grad_input_elem = 0
+  //         grad_input[batch_index, target_elem] = grad_input_elem
+  //
+  // NOTE: In the case of not batch dimension, `batch_index` essentially
+  // becomes zero.
+  Value gradInput =
+      rewriter
+          .create<linalg::GenericOp>(
+              loc, gradInputTensor.getType(), inputs, gradInputTensor,
+              indexingMaps, iteratorTypes,
+              [&](OpBuilder &b, Location loc, ValueRange args) {
+                Value gradOutElem = args[0];
+                Value targetElem = castIntToIndex(b, loc, args[1]);
+                Value totalWeightElem = args[2];
+                Value classIndex =
+                    b.create<linalg::IndexOp>(loc, inputRank - 1);
+
+                if (reduction == torch_upstream::Reduction::Mean) {
+                  gradOutElem = b.create<arith::DivFOp>(loc, gradOutElem,
+                                                        totalWeightElem);
+                }
+
+                Value weightElem = getConstant(b, loc, 1, resultElementType);
+                if (weight) {
+                  weightElem =
+                      b.create<tensor::ExtractOp>(loc, weight, targetElem);
+                }
+                Value targetNeqClassIndex = b.create<arith::CmpIOp>(
+                    loc, arith::CmpIPredicate::ne, targetElem, classIndex);
+                Value targetEqIgnoreIndex = b.create<arith::CmpIOp>(
+                    loc, arith::CmpIPredicate::eq, targetElem, ignoreIndex);
+                Value zero = getConstant(b, loc, 0, resultElementType);
+
+                if (logSoftmaxOutput) {
+                  Value sampleGrad =
+                      b.create<arith::MulFOp>(loc, weightElem, gradOutElem);
+                  sampleGrad = b.create<arith::SelectOp>(
+                      loc, targetEqIgnoreIndex, zero, sampleGrad);
+                  Value softmax = b.create<math::ExpOp>(loc, args[3]);
+                  Value gradInElem =
+                      b.create<arith::MulFOp>(loc, softmax, sampleGrad);
+                  Value targetGrad = b.create<arith::SelectOp>(
+                      loc, targetNeqClassIndex, zero, sampleGrad);
+                  gradInElem =
+                      b.create<arith::SubFOp>(loc, gradInElem, targetGrad);
+                  b.create<linalg::YieldOp>(loc, gradInElem);
+                  return;
+                }
+
+                Value negGradOutElem =
+                    b.create<arith::NegFOp>(loc, gradOutElem);
+                Value weightedNegGradOutElem =
+                    b.create<arith::MulFOp>(loc, weightElem, negGradOutElem);
+                Value gradInputIsZero = b.create<arith::OrIOp>(
+                    loc, targetNeqClassIndex, targetEqIgnoreIndex);
+                Value gradInElem = b.create<arith::SelectOp>(
+                    loc, gradInputIsZero, zero, weightedNegGradOutElem);
+                b.create<linalg::YieldOp>(loc, gradInElem);
+              })
+          ->getResult(0);
+  return gradInput;
+}
+
 namespace {
 class ConvertAtenNllLossBackwardOp
     : public OpConversionPattern<AtenNllLossBackwardOp> {
@@ -1481,136 +2148,65 @@ public:
     if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
       return failure();
 
-    Location loc = op->getLoc();
-    Value gradOutput = adaptor.grad_output();
-    Value input = adaptor.self();
-    Value target = adaptor.target();
-    Value weight = adaptor.weight();
     bool weightIsNone = op.weight().getType().isa<Torch::NoneType>();
-    Value ignoreIndex = castIntToIndex(rewriter, loc, adaptor.ignore_index());
-    Value totalWeight = adaptor.total_weight();
-
-    auto inputType = input.getType().cast<RankedTensorType>();
-    int inputRank = inputType.getRank();
-    auto gradOutputType = gradOutput.getType().cast<RankedTensorType>();
-    Type resultElementType = gradOutputType.getElementType();
-
-    int64_t reduction;
-    if (!matchPattern(op.reduction(), m_TorchConstantInt(&reduction)))
-      return rewriter.notifyMatchFailure(op, "dim must be constant");
+    FailureOr<Value> gradInput = createNllLossBackward(
+        op, adaptor.grad_output(), adaptor.self(), adaptor.target(),
+        weightIsNone ? Value() : adaptor.weight(), adaptor.ignore_index(),
+        adaptor.total_weight(), /*logSoftmaxOutput=*/Value(), rewriter);
+    if (failed(gradInput))
+      return failure();
 
-    if (!hasElementType<mlir::FloatType>(gradOutput) ||
-        !hasElementType<mlir::FloatType>(gradOutput) ||
-        (!weightIsNone && !hasElementType<mlir::FloatType>(weight))) {
-      return rewriter.notifyMatchFailure(
-          op, "`gradOutput`, 'weight', and `totalWeight` must be tensors of "
-              "type float");
-    }
+    RankedTensorType resultType = getTypeConverter()
+                                      ->convertType(op->getResult(0).getType())
+                                      .cast<RankedTensorType>();
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, *gradInput);
+    return success();
+  }
+};
+} // namespace
 
-    if (!hasElementType<mlir::IntegerType>(target)) {
+namespace {
+// Lowers the backward of a cross-entropy loss, i.e. an
+// `aten._log_softmax_backward_data` of the gradient computed by an
+// `aten.nll_loss_backward`, to a single pass over the log-softmax output (see
+// `createNllLossBackward`). The linalg-on-tensors backend keeps
+// `aten._log_softmax_backward_data` legal for this.
+class ConvertAten_LogSoftmaxBackwardDataOp
+    : public OpConversionPattern<Aten_LogSoftmaxBackwardDataOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(Aten_LogSoftmaxBackwardDataOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    if (!isLogSoftmaxBackwardOfNllLoss(op))
       return rewriter.notifyMatchFailure(
-          op, "`target` must be a tensor of integer type");
-    }
-
-    auto outputSize = getTensorSizes(rewriter, loc, input);
-    Value gradInputTensor =
-        createZeroInitTensor(rewriter, loc, outputSize, resultElementType);
-
-    auto getAffineMapForSingleElementTensor = [&](Value tensor) {
-      auto tensorType = tensor.getType().cast<RankedTensorType>();
-      SmallVector<AffineExpr> affineExprs(tensorType.getRank(),
-                                          rewriter.getAffineConstantExpr(0));
-      return AffineMap::get(inputRank, /*symbolCount=*/0, affineExprs,
-                            op->getContext());
-    };
-
-    AffineMap gradOutMap = AffineMap::get(inputRank, /*symbolCount=*/0,
-                                          rewriter.getAffineDimExpr(0));
-    if (reduction != torch_upstream::Reduction::None || inputRank == 1)
-      gradOutMap = getAffineMapForSingleElementTensor(gradOutput);
-    AffineMap targetMap = AffineMap::get(inputRank, /*symbolCount=*/0,
-                                         rewriter.getAffineDimExpr(0));
-    if (inputRank == 1)
-      targetMap = getAffineMapForSingleElementTensor(target);
-    AffineMap totalWeightMap = getAffineMapForSingleElementTensor(totalWeight);
-    AffineMap resultMap = rewriter.getMultiDimIdentityMap(inputRank);
-
-    SmallVector<AffineMap> indexingMaps{gradOutMap, targetMap, totalWeightMap,
-                                        resultMap};
-    SmallVector<StringRef> iteratorTypes(inputRank,
-                                         getParallelIteratorTypeName());
+          op, "expected the backward of a cross-entropy loss");
+    auto nllLossBackward =
+        op.grad_output().getDefiningOp<AtenNllLossBackwardOp>();
 
-    // The code generation is equivalent to the following pseudo-code:
-    //
-    // for batch_index in len(input.size(0)):
-    //     for class_index in len(input.size(1)):
-    //         target_elem = target[batch_index]
-    //
-    //         if reduction == None:
-    //             grad_out_elem = grad_output[batchIndex]
-    //         else:
-    //             grad_out_elem = grad_output[0]
-    //
-    //         if reduction == Mean:
-    //             total_weight_elem = total_weight[0]
-    //             grad_out_elem /= total_weight_elem
-    //
-    //         weight_elem = weight[target_elem] if weight != None else 1
-    //
-    //         if target_elem != class_index or target_elem == ignore_index:
-    //             grad_input_elem = -weight_elem * grad_out_elem
-    //         else:
-    //             grad_input_elem = 0
-    //         grad_input[batch_index, target_elem] = grad_input_elem
-    //
-    // NOTE: In the case of not batch dimension, `batch_index` essentially
-    // becomes zero.
-    Value gradInput =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, gradInputTensor.getType(),
-                ValueRange{gradOutput, target, totalWeight}, gradInputTensor,
-                indexingMaps, iteratorTypes,
-                [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value gradOutElem = args[0];
-                  Value targetElem = castIntToIndex(b, loc, args[1]);
-                  Value totalWeightElem = args[2];
-                  Value classIndex =
-                      b.create<linalg::IndexOp>(loc, inputRank - 1);
-
-                  if (reduction == torch_upstream::Reduction::Mean) {
-                    gradOutElem = b.create<arith::DivFOp>(loc, gradOutElem,
-                                                          totalWeightElem);
-                  }
-
-                  Value negGradOutElem =
-                      b.create<arith::NegFOp>(loc, gradOutElem);
-                  Value weightElem = getConstant(b, loc, 1, resultElementType);
-                  if (!weightIsNone) {
-                    weightElem =
-                        b.create<tensor::ExtractOp>(loc, weight, targetElem);
-                  }
-                  Value weightedNegGradOutElem =
-                      b.create<arith::MulFOp>(loc, weightElem, negGradOutElem);
-
-                  Value targetNeqClassIndex = b.create<arith::CmpIOp>(
-                      loc, arith::CmpIPredicate::ne, targetElem, classIndex);
-                  Value targetEqIgnoreIndex = b.create<arith::CmpIOp>(
-                      loc, arith::CmpIPredicate::eq, targetElem, ignoreIndex);
-                  Value gradInputIsZero = b.create<arith::OrIOp>(
-                      loc, targetNeqClassIndex, targetEqIgnoreIndex);
-
-                  Value zero = getConstant(b, loc, 0, resultElementType);
-                  Value gradInElem = b.create<arith::SelectOp>(
-                      loc, gradInputIsZero, zero, weightedNegGradOutElem);
-                  b.create<linalg::YieldOp>(loc, gradInElem);
-                })
-            ->getResult(0);
+    Location loc = op->getLoc();
+    TypeConverter *typeConverter = getTypeConverter();
+    SmallVector<Value> nllOperands{
+        nllLossBackward.grad_output(), nllLossBackward.target(),
+        nllLossBackward.ignore_index(), nllLossBackward.total_weight()};
+    bool weightIsNone =
+        nllLossBackward.weight().getType().isa<Torch::NoneType>();
+    if (!weightIsNone)
+      nllOperands.push_back(nllLossBackward.weight());
+    SmallVector<Value> converted =
+        getTypeConvertedValues(rewriter, loc, typeConverter, nllOperands);
+    Value logSoftmaxOutput = adaptor.output();
+    FailureOr<Value> gradInput = createNllLossBackward(
+        nllLossBackward, converted[0], logSoftmaxOutput, converted[1],
+        weightIsNone ? Value() : converted[4], converted[2], converted[3],
+        logSoftmaxOutput, rewriter);
+    if (failed(gradInput))
+      return failure();
 
-    RankedTensorType resultType = getTypeConverter()
-                                      ->convertType(op->getResult(0).getType())
-                                      .cast<RankedTensorType>();
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, gradInput);
+    Type resultType = typeConverter->convertType(op.getType());
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, *gradInput);
     return success();
   }
 };
@@ -1645,8 +2241,18 @@ public:
     RankedTensorType resultType = getTypeConverter()
                                       ->convertType(op->getResult(0).getType())
                                       .cast<RankedTensorType>();
-    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType,
-                                                adaptor.operand());
+    Value operand = adaptor.operand();
+    auto operandType = operand.getType().cast<RankedTensorType>();
+    // Casting to or from a sparse tensor changes how its elements are stored.
+    if (operandType.getEncoding() != resultType.getEncoding()) {
+      operand = rewriter.create<sparse_tensor::ConvertOp>(
+          op.getLoc(),
+          RankedTensorType::get(operandType.getShape(),
+                                operandType.getElementType(),
+                                resultType.getEncoding()),
+          operand);
+    }
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, operand);
     return success();
   }
 };
@@ -1657,28 +2263,40 @@ void mlir::torch::torch_to_linalg::populateUncategorizedPatternsAndLegality(
     ConversionTarget &target) {
   MLIRContext *context = patterns.getContext();
   target.addIllegalOp<
-      AtenTanhOp, AtenReluOp, AtenLeakyReluOp, AtenGeluOp, AtenGeluBackwardOp,
-      AtenAddTensorOp, AtenMulTensorOp, AtenDivTensorOp, AtenDivTensorModeOp,
-      AtenSubTensorOp, AtenLerpTensorOp, AtenSigmoidOp, AtenMinimumOp,
-      AtenMaximumOp, AtenToDtypeOp, AtenClampOp, AtenRsubScalarOp, AtenLogOp,
-      AtenErfOp, AtenSqrtOp, AtenFloorOp, AtenCeilOp, AtenPowTensorScalarOp,
-      AtenLog2Op, AtenRsqrtOp, AtenAbsOp, AtenReciprocalOp,
-      AtenBitwiseAndTensorOp, AtenGtScalarOp, AtenGeScalarOp, AtenEqScalarOp,
-      AtenLtScalarOp, AtenLeScalarOp, AtenWhereSelfOp, AtenGtTensorOp,
-      AtenEqTensorOp, AtenLtTensorOp, AtenThresholdOp, AtenThresholdBackwardOp,
-      AtenCloneOp, AtenSinOp, AtenCosOp, AtenNeScalarOp, AtenMaskedFillScalarOp,
-      AtenLogicalOrOp, AtenTriuOp>();
+      AtenTanhOp, AtenTanhBackwardOp, AtenReluOp, AtenLeakyReluOp, AtenGeluOp,
+      AtenGeluBackwardOp, AtenAddTensorOp, AtenMulTensorOp, AtenDivTensorOp,
+      AtenDivTensorModeOp, AtenSubTensorOp, AtenLerpTensorOp, AtenSigmoidOp,
+      AtenMinimumOp, AtenMaximumOp, AtenToDtypeOp, AtenClampOp,
+      AtenRsubScalarOp, AtenLogOp, AtenErfOp, AtenSqrtOp, AtenFloorOp,
+      AtenCeilOp, AtenPowTensorScalarOp, AtenLog2Op, AtenRsqrtOp, AtenAbsOp,
+      AtenReciprocalOp, AtenBitwiseAndTensorOp, AtenGtScalarOp, AtenGeScalarOp,
+      AtenEqScalarOp, AtenLtScalarOp, AtenLeScalarOp, AtenWhereSelfOp,
+      AtenGtTensorOp, AtenEqTensorOp, AtenLtTensorOp, AtenThresholdOp,
+      AtenThresholdBackwardOp, AtenCloneOp, AtenSinOp, AtenCosOp,
+      AtenNeScalarOp, AtenMaskedFillScalarOp, AtenLogicalOrOp, AtenTriuOp>();
   patterns.add<ConvertElementwiseOp>(typeConverter, context);
   target.addIllegalOp<AtenNllLossForwardOp>();
   patterns.add<ConvertAtenDetachOp>(typeConverter, context);
   target.addIllegalOp<AtenDetachOp>();
   patterns.add<ConvertAtenNllLossForwardOp>(typeConverter, context);
+  target.addIllegalOp<AtenCrossEntropyLossOp>();
+  patterns.add<ConvertAtenCrossEntropyLossOp>(typeConverter, context);
   target.addIllegalOp<AtenBatchNormOp>();
   patterns.add<ConvertAtenBatchNormOp>(typeConverter, context);
+  target.addIllegalOp<AtenNativeBatchNormOp,
+                      ValsemVariantAtenNativeBatchNormFunctionalOp>();
+  patterns.add<ConvertNativeBatchNormTrainingOp<AtenNativeBatchNormOp>,
+               ConvertNativeBatchNormTrainingOp<
+                   ValsemVariantAtenNativeBatchNormFunctionalOp>>(typeConverter,
+                                                                  context);
+  target.addIllegalOp<AtenNativeBatchNormBackwardOp>();
+  patterns.add<ConvertAtenNativeBatchNormBackwardOp>(typeConverter, context);
   target.addIllegalOp<AtenNativeLayerNormOp>();
   patterns.add<ConvertAtenNativeLayerNormOp>(typeConverter, context);
   target.addIllegalOp<AtenNllLossBackwardOp>();
   patterns.add<ConvertAtenNllLossBackwardOp>(typeConverter, context);
+  target.addIllegalOp<Aten_LogSoftmaxBackwardDataOp>();
+  patterns.add<ConvertAten_LogSoftmaxBackwardDataOp>(typeConverter, context);
   patterns.add<ConvertTensorStaticInfoCastOp>(typeConverter, context);
   target.addIllegalOp<TensorStaticInfoCastOp>();
 }
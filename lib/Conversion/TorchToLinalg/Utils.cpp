@@ -14,6 +14,7 @@
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Tensor/Utils/Utils.h"
 #include "mlir/IR/Matchers.h"
@@ -97,6 +98,29 @@ Value torch_to_linalg::getOutputDimForConvOps(OpBuilder &b, Location loc,
   return castIntToIndex(b, loc, out);
 }
 
+Value torch_to_linalg::getOutputDimForConvTransposeOps(
+    OpBuilder &b, Location loc, Value in, Value paddingInt, Value dilationInt,
+    Value kernelSizeInt, Value strideInt, Value outputPaddingInt) {
+  Value c1 = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(1));
+  Value c2 = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(2));
+
+  // (in - 1) * stride - 2 * padding
+  Value inSub1 =
+      b.create<arith::SubIOp>(loc, castIndexToInt64(b, loc, in), c1);
+  Value doublePadding = b.create<arith::MulIOp>(loc, paddingInt, c2);
+  Value temp = b.create<arith::SubIOp>(
+      loc, b.create<arith::MulIOp>(loc, inSub1, strideInt), doublePadding);
+
+  // dilation * (kernelSize - 1) + outputPadding + 1
+  Value kernelSizeSub1 = b.create<arith::SubIOp>(loc, kernelSizeInt, c1);
+  Value dilationTimesKernelSize =
+      b.create<arith::MulIOp>(loc, dilationInt, kernelSizeSub1);
+  temp = b.create<arith::AddIOp>(loc, temp, dilationTimesKernelSize);
+  temp = b.create<arith::AddIOp>(loc, temp, outputPaddingInt);
+  Value out = b.create<arith::AddIOp>(loc, temp, c1);
+  return castIntToIndex(b, loc, out);
+}
+
 Value torch_to_linalg::createReductionLinalgGeneric(
     OpBuilder &b, Location loc, const ReductionOpInfo &opInfo, Value initElem,
     function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild) {
@@ -150,10 +174,117 @@ Value torch_to_linalg::createReductionLinalgGeneric(
       .getResult(0);
 }
 
-Value torch_to_linalg::createElementwiseLinalgGeneric(
-    OpBuilder &b, Location loc, ValueRange tensorOperands,
-    Type resultElementType,
-    function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild) {
+// Identifies the size of a dimension symbolically: either as dimension `second`
+// of the tensor `first`, or, if `second` is negative, as the index value
+// `first` itself. Sizes with the same identifier are equal at runtime.
+using SymbolicDimSize = std::pair<Value, int64_t>;
+
+// Returns the identifier of the size of dimension `dim` of `tensor`, looking
+// through ops whose result sizes are those of their operands or init tensors.
+// This makes the dimensions of results of previously lowered ops refer back
+// to the dimension they were computed from, so that, e.g., the dynamic batch
+// dimension of all tensors in a chain of elementwise ops gets the same
+// identifier.
+static SymbolicDimSize getSymbolicDimSize(Value tensor, int64_t dim) {
+  while (true) {
+    if (auto cast = tensor.getDefiningOp<tensor::CastOp>()) {
+      tensor = cast.source();
+      continue;
+    }
+    if (auto linalgOp = tensor.getDefiningOp<linalg::LinalgOp>()) {
+      int64_t resultNumber = tensor.cast<OpResult>().getResultNumber();
+      tensor = linalgOp.getOutputOperand(resultNumber)->get();
+      continue;
+    }
+    if (auto initTensor = tensor.getDefiningOp<linalg::InitTensorOp>()) {
+      if (!initTensor.isDynamicSize(dim))
+        break;
+      Value size = initTensor.getDynamicSize(dim);
+      auto dimOp = size.getDefiningOp<tensor::DimOp>();
+      Optional<int64_t> index = dimOp ? dimOp.getConstantIndex() : None;
+      if (!index)
+        return {size, -1};
+      tensor = dimOp.source();
+      dim = *index;
+      continue;
+    }
+    break;
+  }
+  return {tensor, dim};
+}
+
+// If `tensor` is the result of a `linalg.generic` that only broadcasts its
+// input, such as the ones created by `broadcastToGivenShape`, returns that
+// input and the indexing map reading it.
+static Optional<std::pair<Value, AffineMap>> getBroadcastSource(Value tensor) {
+  if (auto cast = tensor.getDefiningOp<tensor::CastOp>())
+    tensor = cast.source();
+  auto generic = tensor.getDefiningOp<linalg::GenericOp>();
+  if (!generic || generic.getNumInputs() != 1 ||
+      generic.getNumOutputs() != 1 ||
+      generic.getNumParallelLoops() != generic.getNumLoops())
+    return None;
+  OpOperand *input = generic.getInputOperand(0);
+  OpOperand *output = generic.getOutputOperand(0);
+  if (!output->get().getDefiningOp<linalg::InitTensorOp>() ||
+      !generic.getTiedIndexingMap(output).isIdentity())
+    return None;
+  Block *body = generic.getBody();
+  auto yield = cast<linalg::YieldOp>(body->getTerminator());
+  if (&body->front() != yield.getOperation() ||
+      yield.getOperand(0) != body->getArgument(0))
+    return None;
+  return std::make_pair(input->get(), generic.getTiedIndexingMap(input));
+}
+
+// Computes the broadcast result shape and the indexing maps of elementwise
+// `tensorOperands` of rank at most `resultRank` when all their shapes are
+// static. Returns false if a shape is dynamic, or if two sizes can't be
+// broadcast together, which is left to the runtime checks of the general
+// case to report.
+static bool getStaticBroadcastShapeAndMaps(
+    ValueRange tensorOperands, int64_t resultRank, MLIRContext *context,
+    SmallVectorImpl<int64_t> &resultShape,
+    SmallVectorImpl<AffineMap> &indexingMaps) {
+  resultShape.assign(resultRank, 1);
+  for (Value tensorOperand : tensorOperands) {
+    auto type = tensorOperand.getType().cast<RankedTensorType>();
+    if (!type.hasStaticShape())
+      return false;
+    for (auto size : llvm::enumerate(type.getShape())) {
+      int64_t &resultSize =
+          resultShape[size.index() + (resultRank - type.getRank())];
+      if (size.value() == 1)
+        continue;
+      if (resultSize != 1 && resultSize != size.value())
+        return false;
+      resultSize = size.value();
+    }
+  }
+  for (Value tensorOperand : tensorOperands) {
+    auto type = tensorOperand.getType().cast<RankedTensorType>();
+    SmallVector<AffineExpr> exprs;
+    for (auto size : llvm::enumerate(type.getShape())) {
+      if (size.value() == 1) {
+        exprs.push_back(getAffineConstantExpr(0, context));
+        continue;
+      }
+      exprs.push_back(getAffineDimExpr(
+          size.index() + (resultRank - type.getRank()), context));
+    }
+    indexingMaps.push_back(AffineMap::get(
+        /*dimCount=*/resultRank, /*symbolCount=*/0, exprs, context));
+  }
+  return true;
+}
+
+// Computes the broadcast result shape and the indexing maps of elementwise
+// `tensorOperands` of rank at most `resultRank`, emitting runtime checks that
+// the sizes of the operands can be broadcast together.
+static SmallVector<OpFoldResult>
+getDynamicBroadcastShapeAndMaps(OpBuilder &b, Location loc,
+                                ValueRange tensorOperands, int64_t resultRank,
+                                SmallVectorImpl<AffineMap> &indexingMaps) {
   // The overall error handling strategy here is best viewed by thinking about
   // what happens for a single result dimension. This loop not structured that
   // way because it is hard to create the affine maps for each operand unless
@@ -173,22 +304,11 @@ Value torch_to_linalg::createElementwiseLinalgGeneric(
   //     emit error check "if the size does not match the non-broadcasted
   //     traversal size along this dimension, error"
   // ```
-  SmallVector<int64_t> operandRanks;
-  operandRanks.resize(tensorOperands.size());
-  llvm::transform(tensorOperands, operandRanks.begin(), [](Value tensor) {
-    return tensor.getType().dyn_cast<RankedTensorType>().getRank();
-  });
-
-  auto resultRankIt =
-      std::max_element(operandRanks.begin(), operandRanks.end());
-  assert(resultRankIt != operandRanks.end() && "Unable to get result rank.");
-  int64_t resultRank = *resultRankIt;
-
   // Initialize the resultShape to all 1's, as a fallback in case
   // all sizes along that result dimension are statically 1.
   auto c1 = b.create<arith::ConstantIndexOp>(loc, /*value=*/1);
   SmallVector<Value> resultShape(resultRank, c1);
-  SmallVector<AffineMap> indexingMaps;
+  SmallVector<SymbolicDimSize> resultSymbolicShape(resultRank);
   for (Value tensorOperand : tensorOperands) {
     SmallVector<AffineExpr> exprs;
     auto type = tensorOperand.getType().cast<RankedTensorType>();
@@ -214,7 +334,13 @@ Value torch_to_linalg::createElementwiseLinalgGeneric(
       // Now, we need to ensure that such iteration is not going to trigger
       // undefined behavior, by doing appropriate checks against the current
       // dimension size.
-      auto currentDimSize = getDimOp(b, loc, tensorOperand, size.index());
+      SymbolicDimSize currentSymbolicDimSize =
+          getSymbolicDimSize(tensorOperand, size.index());
+      Value currentDimSize =
+          currentSymbolicDimSize.second < 0
+              ? currentSymbolicDimSize.first
+              : getDimOp(b, loc, currentSymbolicDimSize.first,
+                         currentSymbolicDimSize.second);
 
       // If the result size of this dimension has so far only hit the
       // statically-known-to-be-1 case above (i.e., we have not yet assigned a
@@ -223,9 +349,15 @@ Value torch_to_linalg::createElementwiseLinalgGeneric(
       // dimension size.
       if (resultShape[resultDim] == c1) {
         resultShape[resultDim] = currentDimSize;
+        resultSymbolicShape[resultDim] = currentSymbolicDimSize;
         continue;
       }
 
+      // If the size is symbolically the same as the running result size, the
+      // check below is known to succeed, so don't emit it.
+      if (resultSymbolicShape[resultDim] == currentSymbolicDimSize)
+        continue;
+
       // We prohibit the size-1 dynamic broadcasting scenario, so just check
       // for exact equality with the running result size.
       // This is the check which protects against the undefined behavior of
@@ -241,22 +373,146 @@ Value torch_to_linalg::createElementwiseLinalgGeneric(
         /*dimCount=*/resultRank, /*symbolCount=*/0, exprs, b.getContext()));
   }
 
+  return getAsOpFoldResult(resultShape);
+}
+
+Value torch_to_linalg::createElementwiseLinalgGeneric(
+    OpBuilder &b, Location loc, ValueRange tensorOperands,
+    Type resultElementType,
+    function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild,
+    Value destination) {
+  SmallVector<int64_t> operandRanks;
+  operandRanks.resize(tensorOperands.size());
+  llvm::transform(tensorOperands, operandRanks.begin(), [](Value tensor) {
+    return tensor.getType().dyn_cast<RankedTensorType>().getRank();
+  });
+
+  auto resultRankIt =
+      std::max_element(operandRanks.begin(), operandRanks.end());
+  assert(resultRankIt != operandRanks.end() && "Unable to get result rank.");
+  int64_t resultRank = *resultRankIt;
+
+  // When all the shapes are static, the result shape is known at compile
+  // time and no runtime checks are needed, so don't emit any `tensor.dim` or
+  // `cf.assert` ops.
+  SmallVector<AffineMap> indexingMaps;
+  SmallVector<int64_t> staticResultShape;
+  SmallVector<OpFoldResult> resultSizes;
+  if (getStaticBroadcastShapeAndMaps(tensorOperands, resultRank,
+                                     b.getContext(), staticResultShape,
+                                     indexingMaps)) {
+    for (int64_t size : staticResultShape)
+      resultSizes.push_back(b.getIndexAttr(size));
+  } else {
+    resultSizes = getDynamicBroadcastShapeAndMaps(b, loc, tensorOperands,
+                                                  resultRank, indexingMaps);
+  }
+
   SmallVector<StringRef> iteratorTypes(resultRank,
                                        getParallelIteratorTypeName());
   // Add the indexing map for the outs init tensor.
   indexingMaps.push_back(b.getMultiDimIdentityMap(resultRank));
 
-  Value initTensor = b.create<linalg::InitTensorOp>(
-      loc, getAsOpFoldResult(resultShape), resultElementType);
+  Value initTensor;
+  auto destinationIt = llvm::find(tensorOperands, destination);
+  if (destination && destinationIt != tensorOperands.end() &&
+      indexingMaps[destinationIt - tensorOperands.begin()].isIdentity() &&
+      destination.getType().cast<RankedTensorType>().getElementType() ==
+          resultElementType)
+    initTensor = destination;
+  else
+    initTensor =
+        b.create<linalg::InitTensorOp>(loc, resultSizes, resultElementType);
+
+  // Read broadcasted operands directly from the tensor they are broadcasted
+  // from, like the zero-stride views `expand` creates in PyTorch. The
+  // broadcast is then dead, and no tensor of the broadcasted shape is
+  // materialized. The sizes and checks above are still derived from the
+  // broadcasted operands.
+  SmallVector<Value> inputs(tensorOperands.begin(), tensorOperands.end());
+  for (auto it : llvm::enumerate(inputs)) {
+    if (it.value() == initTensor)
+      continue;
+    if (auto source = getBroadcastSource(it.value())) {
+      it.value() = source->first;
+      indexingMaps[it.index()] =
+          source->second.compose(indexingMaps[it.index()]);
+    }
+  }
   return b
       .create<linalg::GenericOp>(loc,
                                  /*resultTensorTypes=*/initTensor.getType(),
-                                 /*inputs=*/tensorOperands,
+                                 /*inputs=*/inputs,
                                  /*outputs=*/initTensor, indexingMaps,
                                  iteratorTypes, bodyBuild)
       .getResult(0);
 }
 
+void torch_to_linalg::createMaxAndSumOfExpsReduction(OpBuilder &b,
+                                                     Location loc, Value input,
+                                                     int64_t dim, Value &max,
+                                                     Value &sum) {
+  auto inputType = input.getType().cast<RankedTensorType>();
+  auto elementType = inputType.getElementType().cast<mlir::FloatType>();
+  int64_t rank = inputType.getRank();
+  SmallVector<Value> inputShape = getTensorSizes(b, loc, input);
+  SmallVector<Value> reducedShape;
+  SmallVector<AffineExpr> exprs, reducedExprs;
+  SmallVector<StringRef> iteratorTypes;
+  for (int64_t i = 0; i < rank; i++) {
+    exprs.push_back(b.getAffineDimExpr(i));
+    if (i == dim) {
+      iteratorTypes.push_back(getReductionIteratorTypeName());
+      continue;
+    }
+    iteratorTypes.push_back(getParallelIteratorTypeName());
+    reducedExprs.push_back(b.getAffineDimExpr(i));
+    reducedShape.push_back(inputShape[i]);
+  }
+
+  Value negInf = b.create<arith::ConstantOp>(
+      loc, b.getFloatAttr(elementType,
+                          APFloat::getInf(elementType.getFloatSemantics(),
+                                          /*Negative=*/true)));
+  Value zero = b.create<arith::ConstantOp>(loc, b.getZeroAttr(elementType));
+  Value one =
+      b.create<arith::ConstantOp>(loc, b.getFloatAttr(elementType, 1.0));
+  Value initMax =
+      b.create<linalg::InitTensorOp>(loc, reducedShape, elementType);
+  initMax = b.create<linalg::FillOp>(loc, negInf, initMax).result();
+  Value initSum = createZeroInitTensor(b, loc, reducedShape, elementType);
+
+  auto reductionMaps =
+      AffineMap::inferFromExprList({exprs, reducedExprs, reducedExprs});
+  auto reduction = b.create<linalg::GenericOp>(
+      loc, ArrayRef<Type>({initMax.getType(), initSum.getType()}), input,
+      ValueRange({initMax, initSum}), reductionMaps, iteratorTypes,
+      [&](OpBuilder &b, Location loc, ValueRange args) {
+        Value x = args[0], max = args[1], sum = args[2];
+        Value newMax = b.create<arith::MaxFOp>(loc, max, x);
+        Value otherValue = b.create<arith::MinFOp>(loc, max, x);
+        Value scale = b.create<math::ExpOp>(
+            loc, b.create<arith::SubFOp>(loc, otherValue, newMax));
+        // If `x` is the new max, the old sum is rescaled and exp(0) = 1 is
+        // added for `x`. Otherwise, exp(x - max) is added.
+        Value isNewMax =
+            b.create<arith::CmpFOp>(loc, arith::CmpFPredicate::OGT, x, max);
+        Value rescaledSum = b.create<arith::AddFOp>(
+            loc, b.create<arith::MulFOp>(loc, sum, scale), one);
+        Value increasedSum = b.create<arith::AddFOp>(loc, sum, scale);
+        Value newSum = b.create<arith::SelectOp>(loc, isNewMax, rescaledSum,
+                                                 increasedSum);
+        // As long as all the values seen are -inf, `scale` is NaN, but the
+        // sum of their exponentials is 0.
+        Value allNegInf = b.create<arith::CmpFOp>(
+            loc, arith::CmpFPredicate::OEQ, newMax, negInf);
+        newSum = b.create<arith::SelectOp>(loc, allNegInf, zero, newSum);
+        b.create<linalg::YieldOp>(loc, ValueRange({newMax, newSum}));
+      });
+  max = reduction.getResult(0);
+  sum = reduction.getResult(1);
+}
+
 // Broadcasts input tensor based on the broadcastToShape.
 LogicalResult torch_to_linalg::broadcastToGivenShape(
     Operation *op, PatternRewriter &rewriter, Value input,
@@ -39,6 +39,15 @@ Value getOutputDimForConvOps(OpBuilder &b, Location loc, Value in,
                              Value kernelSizeInt, Value strideInt,
                              bool ceilMode = false);
 
+// Helper function to calculate the output tensor dims for transposed
+// convolutions. Along each dim:
+// dim_out = (dim_in - 1) * stride - 2 * padding +
+//           dilation * (kernelSize - 1) + outputPadding + 1
+Value getOutputDimForConvTransposeOps(OpBuilder &b, Location loc, Value in,
+                                      Value paddingInt, Value dilationInt,
+                                      Value kernelSizeInt, Value strideInt,
+                                      Value outputPaddingInt);
+
 // Create a reduction of `opInfo.tensorOperand`, reducing along the dimensions
 // in `opInfo.dimSet`. If `opInfo.keepDim` is true, the output tensor is the
 // same rank as the `opInfo.tensorOperand` and reduced dimensions are set to
@@ -49,11 +58,26 @@ Value createReductionLinalgGeneric(
     function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild);
 
 // Create a pointwise operation that uses values in `tensorOperands`, such that
-// the element type of the resulting tensor is `resultElementType`.
+// the element type of the resulting tensor is `resultElementType`. If
+// `destination` is one of `tensorOperands` and is not broadcasted, it is used
+// as the init tensor of the result instead of a new one, so that bufferization
+// can compute the result in place.
 Value createElementwiseLinalgGeneric(
     OpBuilder &b, Location loc, ValueRange tensorOperands,
     Type resultElementType,
-    function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild);
+    function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild,
+    Value destination = {});
+
+// Computes, in a single linalg.generic, the max `max` and the sum of the
+// exponentials shifted by that max `sum` of the float tensor `input` along
+// `dim`. The results have the shape of `input` without `dim`. The running sum
+// is rescaled whenever a new max is found, with the "online" recurrence:
+//   max' = max(max, x)
+//   sum' = sum * exp(max - max') + exp(x - max')
+// Only one exponential is needed per element, since one of the two terms is
+// exp(0) = 1.
+void createMaxAndSumOfExpsReduction(OpBuilder &b, Location loc, Value input,
+                                    int64_t dim, Value &max, Value &sum);
 
 // Broadcasts input tensor based on the broadcastToShape.
 LogicalResult broadcastToGivenShape(Operation *op, PatternRewriter &rewriter,
@@ -317,6 +317,133 @@ public:
 };
 } // namespace
 
+// Returns true if `op` doesn't write to memory, so that it can't create a
+// dependence between the iterations of a loop.
+static bool isWriteFree(Operation *op) {
+  if (op->hasTrait<Torch::OpTrait::HasValueSemantics>() ||
+      op->hasTrait<Torch::OpTrait::ReadOnly>())
+    return true;
+  return MemoryEffectOpInterface::hasNoEffect(op);
+}
+
+// Returns the op combining each iter arg of the for-like `op` with a value
+// computed independently of the previous iterations, or failure if the
+// iterations of `op` may depend on each other. The iterations are independent
+// when the body doesn't write to memory, and each iter arg is only used to
+// compute its next value with an associative and commutative integer op, so
+// that the iterations can be reordered.
+static FailureOr<SmallVector<Operation *>>
+getIndependentIterationsReductions(PrimLoopOp op) {
+  if (!op.isForLike())
+    return failure();
+  Block &body = op.region().front();
+  auto condition = cast<PrimLoopConditionOp>(body.getTerminator());
+  WalkResult walkResult = op.region().walk([&](Operation *nested) {
+    if (nested == condition.getOperation() || isWriteFree(nested))
+      return WalkResult::advance();
+    return WalkResult::interrupt();
+  });
+  if (walkResult.wasInterrupted())
+    return failure();
+
+  SmallVector<Operation *> reductions;
+  for (auto en : llvm::enumerate(condition.iterArgs())) {
+    BlockArgument iterArg = body.getArgument(en.index() + 1);
+    Operation *reduction = en.value().getDefiningOp();
+    if (!reduction || reduction->getBlock() != &body ||
+        !isa<AtenAddIntOp, AtenMulIntOp>(reduction) ||
+        !en.value().hasOneUse() || !iterArg.hasOneUse() ||
+        *iterArg.user_begin() != reduction ||
+        reduction->getOperand(0) == reduction->getOperand(1))
+      return failure();
+    reductions.push_back(reduction);
+  }
+  return reductions;
+}
+
+namespace {
+// Converts the Torch::PrimLoopOp which is ``For-like`` and whose iterations
+// are independent into scf::ParallelOp, with an scf::ReduceOp per iter arg.
+class ConvertTorchPrimLoopForLikeOpToParallel
+    : public OpConversionPattern<PrimLoopOp> {
+public:
+  using OpConversionPattern<PrimLoopOp>::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(PrimLoopOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    FailureOr<SmallVector<Operation *>> reductions =
+        getIndependentIterationsReductions(op);
+    if (failed(reductions))
+      return rewriter.notifyMatchFailure(
+          op, "expected for-like loop with independent iterations");
+
+    TypeConverter *typeConverter = getTypeConverter();
+    Block &body = op.region().front();
+    SmallVector<Value> reducedValues;
+    for (auto en : llvm::enumerate(*reductions)) {
+      Operation *reduction = en.value();
+      Value iterArg = body.getArgument(en.index() + 1);
+      Value reduced = reduction->getOperand(0) == iterArg
+                          ? reduction->getOperand(1)
+                          : reduction->getOperand(0);
+      if (!typeConverter->convertType(reduced.getType()))
+        return rewriter.notifyMatchFailure(op, "unsupported type of iter arg");
+      reducedValues.push_back(reduced);
+    }
+
+    // Currently only lower-bound = 0 and step = 1 is supported.
+    Location loc = op.getLoc();
+    Value lowerBoundIndex = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value stepIndex = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value upperBoundIndex = rewriter.create<arith::IndexCastOp>(
+        loc, rewriter.getIndexType(), adaptor.maxTripCount());
+    auto parallelOp = rewriter.create<scf::ParallelOp>(
+        loc, lowerBoundIndex, upperBoundIndex, stepIndex,
+        adaptor.iterArgsInit(),
+        [&](OpBuilder &b, Location loc, ValueRange ivs, ValueRange) {
+          Value iv =
+              b.create<arith::IndexCastOp>(loc, b.getI64Type(), ivs.front());
+          Value torchIv = typeConverter->materializeSourceConversion(
+              b, loc, Torch::IntType::get(op->getContext()), {iv});
+          body.getArgument(0).replaceAllUsesWith(torchIv);
+
+          // Inline the torch loop body operations, except for the reductions,
+          // which become scf.reduce ops.
+          Block *block = b.getInsertionBlock();
+          for (Operation &operation :
+               llvm::make_early_inc_range(body.without_terminator())) {
+            if (!llvm::is_contained(*reductions, &operation))
+              operation.moveBefore(block, block->end());
+          }
+          b.setInsertionPointToEnd(block);
+          for (auto it : llvm::zip(*reductions, reducedValues)) {
+            Operation *reduction = std::get<0>(it);
+            Value reduced = std::get<1>(it);
+            Type torchType = reduced.getType();
+            Value operand = typeConverter->materializeTargetConversion(
+                b, loc, typeConverter->convertType(torchType), {reduced});
+            b.create<scf::ReduceOp>(
+                loc, operand,
+                [&](OpBuilder &b, Location loc, Value lhs, Value rhs) {
+                  Value torchLhs = typeConverter->materializeSourceConversion(
+                      b, loc, torchType, {lhs});
+                  Value torchRhs = typeConverter->materializeSourceConversion(
+                      b, loc, torchType, {rhs});
+                  Operation *combined = b.clone(*reduction);
+                  combined->setOperands({torchLhs, torchRhs});
+                  Value result = typeConverter->materializeTargetConversion(
+                      b, loc, operand.getType(), combined->getResult(0));
+                  b.create<scf::ReduceReturnOp>(loc, result);
+                });
+          }
+        });
+
+    rewriter.replaceOp(op, parallelOp->getResults());
+    return success();
+  }
+};
+} // namespace
+
 namespace {
 class ConvertTorchToSCF : public ConvertTorchToSCFBase<ConvertTorchToSCF> {
 public:
@@ -343,6 +470,9 @@ public:
     target.addIllegalOp<PrimLoopOp>();
     patterns.add<ConvertTorchPrimLoopWhileLikeOp>(typeConverter, context);
     patterns.add<ConvertTorchPrimLoopForLikeOp>(typeConverter, context);
+    patterns.add<ConvertTorchPrimLoopForLikeOpToParallel>(typeConverter,
+                                                          context,
+                                                          /*benefit=*/2);
 
     if (failed(applyPartialConversion(getOperation(), target,
                                       std::move(patterns))))
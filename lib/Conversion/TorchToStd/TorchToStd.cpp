@@ -14,6 +14,7 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Traits.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -22,6 +23,7 @@
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionDialect.h"
+#include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
 #include "torch-mlir/Dialect/TorchConversion/Transforms/BackendTypeConversion.h"
 
 using namespace mlir;
@@ -168,6 +170,28 @@ public:
   matchAndRewrite(ValueTensorLiteralOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     MLIRContext *context = op->getContext();
+    if (auto elements = op.valueAttr().dyn_cast<SparseElementsAttr>()) {
+      // The elements of a sparse literal are materialized as a dense constant,
+      // which `sparse_tensor.convert` packs into the storage of its encoding.
+      auto type = elements.getType().cast<RankedTensorType>();
+      Type elemTy = type.getElementType();
+      DenseElementsAttr values = elements.getValues();
+      if (auto intType = elemTy.dyn_cast<IntegerType>()) {
+        unsigned bitWidth = intType.getWidth();
+        elemTy = IntegerType::get(context, bitWidth);
+        values = values.mapValues(elemTy, [&](const APInt &v) {
+          return APInt(bitWidth, v.getSExtValue());
+        });
+      }
+      auto denseType = RankedTensorType::get(type.getShape(), elemTy);
+      Value constant = rewriter.create<arith::ConstantOp>(
+          op.getLoc(),
+          SparseElementsAttr::get(denseType, elements.getIndices(), values));
+      rewriter.replaceOpWithNewOp<sparse_tensor::ConvertOp>(
+          op, RankedTensorType::get(type.getShape(), elemTy, type.getEncoding()),
+          constant);
+      return success();
+    }
     if (auto elements = op.valueAttr().dyn_cast<DenseIntElementsAttr>()) {
       Type elemTy = op.valueAttr().getElementType();
       unsigned bitWidth = elemTy.getIntOrFloatBitWidth();
@@ -198,6 +222,25 @@ public:
 };
 } // namespace
 
+namespace {
+// The data of the external literal is not loaded by the compiler: a data
+// attribute would be uniqued in the `MLIRContext`, and so kept alive until
+// the context is destroyed. The backend reads the file instead.
+class ConvertTorchTensorExternalLiteralOp
+    : public OpConversionPattern<ValueTensorExternalLiteralOp> {
+public:
+  using OpConversionPattern<ValueTensorExternalLiteralOp>::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(ValueTensorExternalLiteralOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Type type = getTypeConverter()->convertType(op.getType());
+    rewriter.replaceOpWithNewOp<TorchConversion::ExternalLiteralOp>(
+        op, type, op.fileAttr(), op.offsetAttr());
+    return success();
+  }
+};
+} // namespace
+
 namespace {
 template <typename OpTy>
 class ConvertTorchConstantOp : public OpConversionPattern<OpTy> {
@@ -302,6 +345,7 @@ public:
     registry.insert<tensor::TensorDialect>();
     registry.insert<cf::ControlFlowDialect>();
     registry.insert<math::MathDialect>();
+    registry.insert<sparse_tensor::SparseTensorDialect>();
     TorchConversion::getBackendTypeConversionDependentDialects(registry);
   }
 
@@ -310,7 +354,8 @@ public:
     ConversionTarget target(*context);
     target.addLegalDialect<Torch::TorchDialect, func::FuncDialect,
                            arith::ArithmeticDialect, tensor::TensorDialect,
-                           cf::ControlFlowDialect, math::MathDialect>();
+                           cf::ControlFlowDialect, math::MathDialect,
+                           sparse_tensor::SparseTensorDialect>();
 
     TypeConverter typeConverter;
     typeConverter.addConversion([](Type type) { return type; });
@@ -349,6 +394,9 @@ public:
         typeConverter, context);
     target.addIllegalOp<ValueTensorLiteralOp>();
     patterns.add<ConvertTorchTensorLiteralOp>(typeConverter, context);
+    target.addIllegalOp<ValueTensorExternalLiteralOp>();
+    target.addLegalOp<TorchConversion::ExternalLiteralOp>();
+    patterns.add<ConvertTorchTensorExternalLiteralOp>(typeConverter, context);
 
     target.addIllegalOp<ConstantBoolOp>();
     patterns.add<ConvertTorchConstantOp<ConstantBoolOp>>(typeConverter,
@@ -11,6 +11,7 @@
 
 #include "../PassDetail.h"
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -133,8 +134,9 @@ public:
     // 1.) `input` tensor maps to the indices in scatter op. `input` is
     // expanded from 1-d to 2-d, and its element type is set to i32 as required
     // for the scatter op.
-    // 2.) `updates` is a 1-d dummy tensor with the size equivalent to the
-    // `input`.
+    // 2.) `updates` is a 1-d tensor of ones with the size equivalent to the
+    // `input`, so that the combiner is a plain add of the update, which the
+    // TMTensor lowerings can parallelize.
     // 3.) `bincount` a 1-d tensor maps to the original in scatter op
     // with size equal to the max(max(input) + 1, minlength).
     SmallVector<int64_t> expandedInputSizes{inputType.getShape()[0], 1};
@@ -157,16 +159,16 @@ public:
                           .cast<RankedTensorType>();
     Type resultElemType = resultType.getElementType();
 
-    SmallVector<Value, 1> inputSizeDynamic =
-        getTensorSizesUntilDim(rewriter, loc, input, 0);
-    Value updatesTensor = rewriter.create<linalg::InitTensorOp>(
-        loc, getAsOpFoldResult(inputSizeDynamic), resultElemType);
-
     Value constantZero = rewriter.create<arith::ConstantOp>(
         loc, rewriter.getZeroAttr(resultElemType));
     Value constantOne = rewriter.create<arith::ConstantIntOp>(
         loc, 1, resultElemType.getIntOrFloatBitWidth());
 
+    SmallVector<Value, 1> inputSizeDynamic =
+        getTensorSizesUntilDim(rewriter, loc, input, 0);
+    Value updatesTensor = createInitTensor(rewriter, loc, inputSizeDynamic,
+                                           resultElemType, constantOne);
+
     // Bincount size = max(max(input) + 1, minlength)
     Value maxInputPlusOne =
         rewriter.create<arith::AddIOp>(loc, maxInput, constantOne);
@@ -179,8 +181,8 @@ public:
     Value scatterOp = createTMTensorScatterOp(
         rewriter, loc, updatesTensor, indices, bincountTensor,
         /*uniqueIndices=*/false,
-        [&](OpBuilder &b, Location loc, Value _, Value bincountElem) {
-          Value add = b.create<arith::AddIOp>(loc, bincountElem, constantOne);
+        [&](OpBuilder &b, Location loc, Value update, Value bincountElem) {
+          Value add = b.create<arith::AddIOp>(loc, bincountElem, update);
           b.create<TMTensor::YieldOp>(loc, add);
         });
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, scatterOp);
@@ -274,9 +276,11 @@ public:
     indices = typeConverter->materializeTargetConversion(
         rewriter, loc, typeConverter->convertType(indices.getType()), indices);
 
+    // PyTorch leaves the result undefined for repeated indices unless the
+    // values are accumulated, so the indices can then be taken to be unique.
     bool invalidInputTypeFound = false;
     Value scatterOp = createTMTensorScatterOp(
-        rewriter, loc, values, indices, input, /*uniqueIndices=*/false,
+        rewriter, loc, values, indices, input, /*uniqueIndices=*/!accumulate,
         [&](OpBuilder &b, Location loc, Value valuesElement,
             Value inputElement) {
           Value yieldValue = valuesElement;
@@ -523,6 +527,286 @@ public:
 };
 } // namespace
 
+// Creates the comparator of a `tm_tensor.sort` or `tm_tensor.topk` in
+// `region`, with arguments of `argTypes`. It returns true if its first
+// argument, a float or an integer, is greater (or lower, if not `greater`)
+// than its second one. Like in PyTorch, NaN is greater than any other float,
+// so NaNs are sorted last in ascending order and first in descending order.
+static void createComparatorRegion(Location loc, Region &region,
+                                   TypeRange argTypes, bool greater) {
+  Block &block = region.emplaceBlock();
+  block.addArguments(argTypes, SmallVector<Location>(argTypes.size(), loc));
+  OpBuilder regionBuilder(region);
+  Value lhs = block.getArgument(0);
+  Value rhs = block.getArgument(1);
+  Value isBefore;
+  if (lhs.getType().isa<mlir::FloatType>()) {
+    // The unordered predicates are also true if either operand is NaN. A NaN
+    // is never before another element when it is `lhs` in ascending order,
+    // or `rhs` in descending order.
+    isBefore = regionBuilder.create<arith::CmpFOp>(
+        loc, greater ? arith::CmpFPredicate::UGT : arith::CmpFPredicate::ULT,
+        lhs, rhs);
+    Value nanNotBefore = greater ? rhs : lhs;
+    Value isNotNan = regionBuilder.create<arith::CmpFOp>(
+        loc, arith::CmpFPredicate::ORD, nanNotBefore, nanNotBefore);
+    isBefore = regionBuilder.create<arith::AndIOp>(loc, isBefore, isNotNan);
+  } else {
+    isBefore = regionBuilder.create<arith::CmpIOp>(
+        loc, greater ? arith::CmpIPredicate::sgt : arith::CmpIPredicate::slt,
+        lhs, rhs);
+  }
+  regionBuilder.create<TMTensor::YieldOp>(loc, isBefore);
+}
+
+namespace {
+class ConvertAtenTopkOp : public OpConversionPattern<AtenTopkOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenTopkOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    Location loc = op.getLoc();
+    Value self = adaptor.self();
+    auto selfType = self.getType().cast<RankedTensorType>();
+    int64_t rank = selfType.getRank();
+    Type elementType = selfType.getElementType();
+    Type dtype = op.self().getType().cast<BaseTensorType>().getDtype();
+    if (!elementType.isa<mlir::FloatType, mlir::IntegerType>() ||
+        dtype.isUnsignedInteger())
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: input tensor must be of integer type or float "
+              "type");
+
+    int64_t dim;
+    if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
+      return rewriter.notifyMatchFailure(op, "dim must be constant");
+    dim = toPositiveDim(dim, rank);
+    if (!isValidDim(dim, rank))
+      return rewriter.notifyMatchFailure(op, "dim is statically invalid");
+    bool largest;
+    if (!matchPattern(op.largest(), m_TorchConstantBool(&largest)))
+      return rewriter.notifyMatchFailure(op, "largest must be constant");
+    // `sorted` is ignored since `tm_tensor.topk` always sorts its results.
+
+    auto valuesType = typeConverter->convertType(op.values().getType())
+                          .cast<RankedTensorType>();
+    auto indicesType = typeConverter->convertType(op.indices().getType())
+                           .cast<RankedTensorType>();
+    // `tm_tensor.topk` fills its outputs from the input, so `k` must be
+    // between 0 and the size of `dim`, like PyTorch checks.
+    int64_t k;
+    if (matchPattern(op.k(), m_TorchConstantInt(&k))) {
+      if (k < 0)
+        return rewriter.notifyMatchFailure(op, "k must be non-negative");
+      if (!selfType.isDynamicDim(dim) && k > selfType.getDimSize(dim))
+        return rewriter.notifyMatchFailure(
+            op, "k must not be larger than the size of dim");
+    }
+    SmallVector<Value> sizes = getTensorSizes(rewriter, loc, self);
+    Value kIndex = castIntToIndex(rewriter, loc, adaptor.k());
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value kIsNonNegative = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::sge, kIndex, zero);
+    rewriter.create<cf::AssertOp>(
+        loc, kIsNonNegative, rewriter.getStringAttr("k must be non-negative"));
+    Value kIsInRange = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::sle, kIndex, sizes[dim]);
+    rewriter.create<cf::AssertOp>(
+        loc, kIsInRange,
+        rewriter.getStringAttr("k must not be larger than the size of dim"));
+    sizes[dim] = kIndex;
+    Value initValues = rewriter.create<linalg::InitTensorOp>(
+        loc, getAsOpFoldResult(sizes), elementType);
+    Value initIndices = rewriter.create<linalg::InitTensorOp>(
+        loc, getAsOpFoldResult(sizes), indicesType.getElementType());
+
+    auto topkOp = rewriter.create<TMTensor::TopkOp>(
+        loc, TypeRange{initValues.getType(), initIndices.getType()},
+        ValueRange{self}, ValueRange{initValues, initIndices}, dim);
+    createComparatorRegion(loc, topkOp.region(), {elementType, elementType},
+                           /*greater=*/largest);
+
+    Value values =
+        rewriter.create<tensor::CastOp>(loc, valuesType, topkOp.getResult(0));
+    Value indices =
+        rewriter.create<tensor::CastOp>(loc, indicesType, topkOp.getResult(1));
+    rewriter.replaceOp(op, {values, indices});
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class ConvertAtenSortOp : public OpConversionPattern<AtenSortOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenSortOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    Location loc = op.getLoc();
+    Value self = adaptor.self();
+    auto selfType = self.getType().cast<RankedTensorType>();
+    int64_t rank = selfType.getRank();
+    Type elementType = selfType.getElementType();
+    Type dtype = op.self().getType().cast<BaseTensorType>().getDtype();
+    if (!elementType.isa<mlir::FloatType, mlir::IntegerType>() ||
+        dtype.isUnsignedInteger())
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: input tensor must be of integer type or float "
+              "type");
+
+    int64_t dim;
+    if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
+      return rewriter.notifyMatchFailure(op, "dim must be constant");
+    dim = toPositiveDim(dim, rank);
+    if (!isValidDim(dim, rank))
+      return rewriter.notifyMatchFailure(op, "dim is statically invalid");
+    bool descending;
+    if (!matchPattern(op.descending(), m_TorchConstantBool(&descending)))
+      return rewriter.notifyMatchFailure(op, "descending must be constant");
+
+    auto valuesType = typeConverter->convertType(op.values().getType())
+                          .cast<RankedTensorType>();
+    auto indicesType = typeConverter->convertType(op.indices().getType())
+                           .cast<RankedTensorType>();
+    Type indicesElemType = indicesType.getElementType();
+
+    // The indices are sorted along with the values, starting as the positions
+    // of the elements along `dim`.
+    SmallVector<Value> sizes = getTensorSizes(rewriter, loc, self);
+    Value initIndices = rewriter.create<linalg::InitTensorOp>(
+        loc, getAsOpFoldResult(sizes), indicesElemType);
+    SmallVector<AffineMap> indexingMaps = {
+        rewriter.getMultiDimIdentityMap(rank)};
+    SmallVector<StringRef> iteratorTypes(rank, getParallelIteratorTypeName());
+    Value positions =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, initIndices.getType(), /*inputs=*/ValueRange{},
+                initIndices, indexingMaps, iteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value index = b.create<linalg::IndexOp>(loc, dim);
+                  Value position =
+                      b.create<arith::IndexCastOp>(loc, indicesElemType, index);
+                  b.create<linalg::YieldOp>(loc, position);
+                })
+            .getResult(0);
+
+    auto sortOp = rewriter.create<TMTensor::SortOp>(
+        loc, TypeRange{selfType, positions.getType()}, ValueRange{},
+        ValueRange{self, positions}, dim);
+    createComparatorRegion(
+        loc, sortOp.region(),
+        {elementType, elementType, indicesElemType, indicesElemType},
+        /*greater=*/descending);
+
+    Value values =
+        rewriter.create<tensor::CastOp>(loc, valuesType, sortOp.getResult(0));
+    Value indices =
+        rewriter.create<tensor::CastOp>(loc, indicesType, sortOp.getResult(1));
+    rewriter.replaceOp(op, {values, indices});
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Rewrites an attention subgraph into a `tm_tensor.attention` op, which
+// never materializes the matrix of scores.
+class ConvertAttention : public OpConversionPattern<AtenMatmulOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenMatmulOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    FailureOr<AttentionMatch> match = matchAttention(op);
+    if (failed(match))
+      return rewriter.notifyMatchFailure(op, "not an attention subgraph");
+
+    Location loc = op.getLoc();
+    auto toBuiltinTensor = [&](Value v) {
+      return getTypeConverter()->materializeTargetConversion(
+          rewriter, loc, getTypeConverter()->convertType(v.getType()), v);
+    };
+    Value query = toBuiltinTensor(match->query);
+    Value key = toBuiltinTensor(match->key);
+    Value value = adaptor.other();
+    auto queryType = query.getType().cast<RankedTensorType>();
+    int64_t rank = queryType.getRank();
+    Type elementType = queryType.getElementType();
+
+    // The matmuls would fail on these at runtime anyway.
+    SmallVector<Value> outputSizes;
+    for (int64_t i = 0; i < rank - 2; i++) {
+      Value queryDim = getDimOp(rewriter, loc, query, i);
+      checkDimEqualHelper(rewriter, loc, queryDim,
+                          getDimOp(rewriter, loc, key, i));
+      checkDimEqualHelper(rewriter, loc, queryDim,
+                          getDimOp(rewriter, loc, value, i));
+      outputSizes.push_back(queryDim);
+    }
+    Value numQueries = getDimOp(rewriter, loc, query, rank - 2);
+    Value numKeys = getDimOp(rewriter, loc, key, rank - 2);
+    checkDimEqualHelper(rewriter, loc, getDimOp(rewriter, loc, query, rank - 1),
+                        getDimOp(rewriter, loc, key, rank - 1));
+    checkDimEqualHelper(rewriter, loc, numKeys,
+                        getDimOp(rewriter, loc, value, rank - 2));
+    outputSizes.push_back(numQueries);
+    outputSizes.push_back(getDimOp(rewriter, loc, value, rank - 1));
+
+    SmallVector<Value> inputs = {query, key, value};
+    if (match->mask) {
+      Value mask = toBuiltinTensor(match->mask);
+      auto maskType = mask.getType().cast<RankedTensorType>();
+      int64_t leadingDims = rank - maskType.getRank();
+      if (leadingDims > 0) {
+        // Add the leading unit dimensions that the addition broadcasts.
+        SmallVector<ReassociationIndices> reassociation(maskType.getRank());
+        for (int64_t i = 0; i <= leadingDims; i++)
+          reassociation[0].push_back(i);
+        for (int64_t i = 1; i < maskType.getRank(); i++)
+          reassociation[i].push_back(leadingDims + i);
+        SmallVector<int64_t> expandedShape(leadingDims, 1);
+        expandedShape.append(maskType.getShape().begin(),
+                             maskType.getShape().end());
+        mask = rewriter.create<tensor::ExpandShapeOp>(
+            loc, RankedTensorType::get(expandedShape, elementType), mask,
+            reassociation);
+        maskType = mask.getType().cast<RankedTensorType>();
+      }
+      // The mask has static sizes, so its unit dimensions are the ones that
+      // are broadcast.
+      SmallVector<Value> scoresSizes(outputSizes.begin(),
+                                     outputSizes.end() - 1);
+      scoresSizes.push_back(numKeys);
+      for (int64_t i = 0; i < rank; i++) {
+        if (maskType.getDimSize(i) != 1)
+          checkDimEqualHelper(rewriter, loc, getDimOp(rewriter, loc, mask, i),
+                              scoresSizes[i]);
+      }
+      inputs.push_back(mask);
+    }
+
+    Value init =
+        rewriter.create<linalg::InitTensorOp>(loc, outputSizes, elementType);
+    auto attention = rewriter.create<TMTensor::AttentionOp>(
+        loc, init.getType(), inputs, init,
+        rewriter.getF64FloatAttr(match->scale));
+    Type newResultType = getTypeConverter()->convertType(op.getType());
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType,
+                                                attention->getResult(0));
+    for (Operation *intermediateOp : match->intermediateOps)
+      rewriter.eraseOp(intermediateOp);
+    return success();
+  }
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 // The pass
 // -----------------------------------------------------------------------------
@@ -536,6 +820,7 @@ public:
     registry.insert<func::FuncDialect>();
     registry.insert<tensor::TensorDialect>();
     registry.insert<arith::ArithmeticDialect>();
+    registry.insert<cf::ControlFlowDialect>();
     registry.insert<TMTensorDialect>();
     TorchConversion::getBackendTypeConversionDependentDialects(registry);
   }
@@ -545,7 +830,8 @@ public:
     ConversionTarget target(*context);
     target.addLegalDialect<linalg::LinalgDialect, func::FuncDialect,
                            tensor::TensorDialect, arith::ArithmeticDialect,
-                           Torch::TorchDialect, TMTensorDialect>();
+                           cf::ControlFlowDialect, Torch::TorchDialect,
+                           TMTensorDialect>();
 
     TypeConverter typeConverter;
     typeConverter.addConversion([](Type type) { return type; });
@@ -560,6 +846,15 @@ public:
     target.addIllegalOp<AtenMaxPool2dWithIndicesBackwardOp>();
     patterns.add<ConvertAtenMaxPool2dWithIndicesBackwardOp>(typeConverter,
                                                             context);
+    target.addIllegalOp<AtenTopkOp>();
+    patterns.add<ConvertAtenTopkOp>(typeConverter, context);
+    target.addIllegalOp<AtenSortOp>();
+    patterns.add<ConvertAtenSortOp>(typeConverter, context);
+    // Only the matmuls ending an attention subgraph are converted here; the
+    // others are left to TorchToLinalg.
+    target.addDynamicallyLegalOp<AtenMatmulOp>(
+        [](AtenMatmulOp op) { return failed(matchAttention(op)); });
+    patterns.add<ConvertAttention>(typeConverter, context);
 
     if (failed(applyPartialConversion(getOperation(), target,
                                       std::move(patterns))))
@@ -23,6 +23,8 @@
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionDialect.h"
 #include "torch-mlir/Dialect/TorchConversion/Transforms/BackendTypeConversion.h"
 
+#include <cmath>
+
 using namespace mlir;
 using namespace mlir::torch;
 using namespace mlir::torch::Torch;
@@ -489,6 +491,45 @@ LogicalResult ConvertAtenOp<AtenSigmoidOp>::matchAndRewrite(
   }
 }
 
+// Returns true if `tensor` is a Torch tensor of 8-bit quantized dtype.
+static bool isQuantizedTensor(Value tensor) {
+  auto type = tensor.getType().dyn_cast<BaseTensorType>();
+  return type && type.hasDtype() &&
+         type.getDtype().isa<Torch::QInt8Type, Torch::QUInt8Type>();
+}
+
+static bool isUnsignedQuantizedTensor(Value tensor) {
+  return tensor.getType().cast<BaseTensorType>().getDtype().isa<QUInt8Type>();
+}
+
+// Gets the constant scale and zero point of the per-tensor quantized Torch
+// tensor `tensor`.
+static LogicalResult
+getConstantPerTensorQuantizationParams(Value tensor, double &scale,
+                                       int64_t &zeroPoint) {
+  Value scaleValue, zeroPointValue;
+  if (failed(getPerTensorQuantizationParams(tensor, scaleValue,
+                                            zeroPointValue)))
+    return failure();
+  return success(matchPattern(scaleValue, m_TorchConstantFloat(&scale)) &&
+                 matchPattern(zeroPointValue, m_TorchConstantInt(&zeroPoint)));
+}
+
+// TOSA integer ops are signed, while `quint8` tensors are represented by the
+// bytes of their unsigned values. Flipping the sign bit maps these bytes to
+// signed ones in the same order, subtracting 128 from their value, and back.
+static Value flipSignBit(PatternRewriter &rewriter, Operation *op,
+                         Value tensor) {
+  auto type = tensor.getType().cast<RankedTensorType>();
+  auto signBitType = RankedTensorType::get(
+      SmallVector<int64_t>(type.getRank(), 1), type.getElementType());
+  Value signBit = rewriter.create<tosa::ConstOp>(
+      op->getLoc(), signBitType,
+      DenseElementsAttr::get(signBitType, APInt(8, 0x80)));
+  return rewriter.create<tosa::BitwiseXorOp>(op->getLoc(), type, tensor,
+                                             signBit);
+}
+
 template <>
 LogicalResult ConvertAtenOp<AtenReluOp>::matchAndRewrite(
     AtenReluOp op, OpAdaptor adaptor,
@@ -500,7 +541,29 @@ LogicalResult ConvertAtenOp<AtenReluOp>::matchAndRewrite(
   int64_t clampMin = 0;
   Value clampIn = self;
   if (selfTy) {
-    // Rescale the clampIn for quantized types. TBD
+    // The relu of a quantized tensor clamps it from below at its zero point.
+    if (isQuantizedTensor(op.self())) {
+      double scale;
+      int64_t zeroPoint;
+      if (failed(getConstantPerTensorQuantizationParams(op.self(), scale,
+                                                        zeroPoint)))
+        return rewriter.notifyMatchFailure(
+            op, "expected constant per-tensor quantization parameters");
+      bool isUnsigned = isUnsignedQuantizedTensor(op.self());
+      if (isUnsigned) {
+        clampIn = flipSignBit(rewriter, op, clampIn);
+        zeroPoint -= 128;
+      }
+      Value result = rewriter.create<tosa::ClampOp>(
+          op->getLoc(), selfTy, clampIn, rewriter.getI64IntegerAttr(zeroPoint),
+          rewriter.getI64IntegerAttr(std::numeric_limits<int8_t>::max()),
+          rewriter.getF32FloatAttr(0.0f), rewriter.getF32FloatAttr(0.0f));
+      if (isUnsigned)
+        result = flipSignBit(rewriter, op, result);
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(
+          op, getTypeConverter()->convertType(op.getType()), result);
+      return success();
+    }
     if (!selfTy.getElementType().isa<mlir::FloatType>()) {
       return op.emitError(
           "Only floating-point datatype legalization currently supported");
@@ -668,6 +731,52 @@ public:
   }
 };
 
+using SoftmaxConvFunc = llvm::Optional<Value> (*)(PatternRewriter &,
+                                                  Operation *,
+                                                  RankedTensorType, Value,
+                                                  int64_t);
+
+// Softmax and log_softmax are lowered directly to their compact TOSA
+// sequences, rather than to the many small ops of their decomposition. This
+// is used for ops that compute in the dtype of their input, i.e. without a
+// `dtype` or with `half_to_float` false.
+template <typename AtenOpT, SoftmaxConvFunc ConversionFuncT>
+class ConvertAtenSoftmaxOp : public OpConversionPattern<AtenOpT> {
+public:
+  using OpConversionPattern<AtenOpT>::OpConversionPattern;
+  using OpAdaptor = typename AtenOpT::Adaptor;
+  LogicalResult
+  matchAndRewrite(AtenOpT op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto selfTy =
+        adaptor.self().getType().template dyn_cast<RankedTensorType>();
+    if (!selfTy)
+      return op.emitError("Only ranked tensor types supported in TOSA softmax");
+    auto outputTy = OpConversionPattern<AtenOpT>::getTypeConverter()
+                        ->convertType(op.getType())
+                        .template cast<RankedTensorType>();
+    // The TOSA backend keeps these ops from being decomposed, so there is no
+    // fallback: report why the op can't be lowered.
+    if (outputTy.getElementType() != selfTy.getElementType())
+      return op.emitError(
+          "Unimplemented: softmax with a different result dtype");
+
+    int64_t dim;
+    if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
+      return op.emitError("dim must be a constant int");
+    dim = toPositiveDim(dim, selfTy.getRank());
+    if (!isValidDim(dim, selfTy.getRank()))
+      return op.emitError("dim is statically invalid");
+
+    llvm::Optional<Value> result =
+        ConversionFuncT(rewriter, op, outputTy, adaptor.self(), dim);
+    if (!result)
+      return failure();
+    rewriter.replaceOp(op, {result.getValue()});
+    return success();
+  }
+};
+
 template <>
 LogicalResult ConvertAtenOp<AtenArgmaxOp>::matchAndRewrite(
     AtenArgmaxOp op, OpAdaptor adaptor,
@@ -1072,9 +1181,16 @@ public:
     // increasing. E.g. [0, 1, 2, 3]: No transpose [1, 0, 2, 3]: Transpose dim0
     // and dim1 The order need not be sequential, since one or more dims may
     // have been removed due to broadcasting.
-    auto isTransposeRequired = [](SmallVector<int32_t> transposedDims) -> bool {
+    // Moving dims of size 1 doesn't move any data, so it is left to the
+    // reshape that always follows. For example, the rank broadcasted RHS
+    // 1x6x7 of a 4x5x6 LHS is only reshaped, not transposed, to 1x6x7.
+    auto isTransposeRequired = [](ArrayRef<int32_t> transposedDims,
+                                  ArrayRef<int64_t> transposedShape) -> bool {
       int32_t lastDim = -1;
-      for (auto &dim : transposedDims) {
+      for (auto it : llvm::zip(transposedDims, transposedShape)) {
+        int32_t dim = std::get<0>(it);
+        if (std::get<1>(it) == 1)
+          continue;
         if (lastDim > dim)
           return true;
         lastDim = dim;
@@ -1082,6 +1198,44 @@ public:
       return false;
     };
 
+    // Transposes `tensor` by `perms` into `type`. A transpose of a
+    // tosa.transpose, like that of the rhs of `q @ k.transpose(-2, -1)`, is
+    // composed into a single transpose of its input, or into that input if
+    // the two cancel out.
+    auto createTranspose = [&](Value tensor, ArrayRef<int32_t> perms,
+                               RankedTensorType type) -> Value {
+      SmallVector<int32_t> composedPerms(perms.begin(), perms.end());
+      DenseIntElementsAttr producerPermsAttr;
+      if (auto producer = tensor.getDefiningOp<tosa::TransposeOp>()) {
+        if (matchPattern(producer.perms(), m_Constant(&producerPermsAttr))) {
+          SmallVector<int32_t> producerPerms;
+          for (APInt perm : producerPermsAttr.getValues<APInt>())
+            producerPerms.push_back(perm.getSExtValue());
+          for (auto &perm : composedPerms)
+            perm = producerPerms[perm];
+          tensor = producer.input1();
+        }
+      }
+      bool isIdentity = llvm::all_of(llvm::enumerate(composedPerms),
+                                     [](auto it) {
+                                       return it.value() ==
+                                              static_cast<int32_t>(it.index());
+                                     });
+      if (isIdentity && tensor.getType() == type)
+        return tensor;
+      llvm::Optional<Value> permsConst = tosa::getConstTensor<int32_t>(
+          rewriter, op,
+          /*vec=*/composedPerms,
+          /*shape=*/{static_cast<int32_t>(composedPerms.size())});
+      return rewriter
+          .create<tosa::TransposeOp>(
+              op->getLoc(),
+              OpConversionPattern<AtenOpT>::getTypeConverter()->convertType(
+                  type),
+              tensor, permsConst.getValue())
+          .getResult();
+    };
+
     SmallVector<TensorShape_t> commonElems, lhsSqueezedElems, rhsSqueezedElems;
 
     if (!performBatchDimBroadcast) {
@@ -1174,28 +1328,16 @@ public:
       transposedLhsDims.push_back(maxInputRank - 1);
       transposedLhsShape.push_back(lhsBroadcastedShape[maxInputRank - 1]);
 
-      bool lhsNeedsTranspose = isTransposeRequired(transposedLhsDims);
+      bool lhsNeedsTranspose =
+          isTransposeRequired(transposedLhsDims, transposedLhsShape);
 
       auto lhsReshapeInput = rankBroadcastedLhs;
 
       if (lhsNeedsTranspose) {
         auto transposedLhsType =
             RankedTensorType::get(transposedLhsShape, rhsElemTy);
-
-        llvm::Optional<Value> transposedLhsDimsConst =
-            tosa::getConstTensor<int32_t>(
-                rewriter, op,
-                /*vec=*/transposedLhsDims,
-                /*shape=*/{static_cast<int32_t>(transposedLhsDims.size())});
-
-        lhsReshapeInput =
-            rewriter
-                .create<tosa::TransposeOp>(
-                    op->getLoc(),
-                    OpConversionPattern<AtenOpT>::getTypeConverter()
-                        ->convertType(transposedLhsType),
-                    rankBroadcastedLhs, transposedLhsDimsConst.getValue())
-                .getResult();
+        lhsReshapeInput = createTranspose(rankBroadcastedLhs,
+                                          transposedLhsDims, transposedLhsType);
       }
 
       // LHS = {common, lhs_squeezed, matmul_dim}
@@ -1256,26 +1398,14 @@ public:
                                         rhsSqueezedValue});
       auto newRhsType = RankedTensorType::get(newRhsShape, rhsElemTy);
 
-      bool rhsNeedsTranspose = isTransposeRequired(transposedRhsDims);
+      bool rhsNeedsTranspose =
+          isTransposeRequired(transposedRhsDims, transposedRhsShape);
 
       auto transposedRhsValue = rankBroadcastedRhs;
 
-      if (rhsNeedsTranspose) {
-        llvm::Optional<Value> transposedRhsDimsConst =
-            tosa::getConstTensor<int32_t>(
-                rewriter, op,
-                /*vec=*/transposedRhsDims,
-                /*shape=*/{static_cast<int32_t>(transposedRhsDims.size())});
-
-        transposedRhsValue =
-            rewriter
-                .create<tosa::TransposeOp>(
-                    op->getLoc(),
-                    OpConversionPattern<AtenOpT>::getTypeConverter()
-                        ->convertType(transposedRhsType),
-                    rankBroadcastedRhs, transposedRhsDimsConst.getValue())
-                .getResult();
-      }
+      if (rhsNeedsTranspose)
+        transposedRhsValue = createTranspose(
+            rankBroadcastedRhs, transposedRhsDims, transposedRhsType);
 
       // reshape
       matmulRhs = rewriter.create<tosa::ReshapeOp>(
@@ -1404,9 +1534,15 @@ public:
 
       computeOpShape(reshapedOpShape, transposedOpDims, transposedOpShape);
 
-      bool opNeedsTranspose = isTransposeRequired(transposedOpDims);
+      bool opNeedsTranspose =
+          isTransposeRequired(transposedOpDims, reshapedOpShape);
 
-      // Perform reshape
+      // Perform reshape. Without a transpose, reshape straight to the final
+      // shape, which only differs from reshapedOpShape by the position of
+      // unit dims. The 2-D case only computes reshapedOpShape, which is
+      // already final.
+      if (!opNeedsTranspose && maxInputRank > 2)
+        reshapedOpShape = transposedOpShape;
       auto reshapedOpType =
           RankedTensorType::get(reshapedOpShape, outputElemTy);
       auto reshapedOp = rewriter.create<tosa::ReshapeOp>(
@@ -1601,19 +1737,36 @@ public:
     std::swap(transposedRhsShape[rhsRank - 1], transposedRhsShape[rhsRank - 2]);
     std::swap(transposedRhsDims[rhsRank - 1], transposedRhsDims[rhsRank - 2]);
 
-    llvm::Optional<Value> transposedRhsShapeConst =
-        tosa::getConstTensor<int32_t>(
-            rewriter, op,
-            /*vec=*/transposedRhsDims,
-            /*shape=*/{static_cast<int32_t>(transposedRhsDims.size())});
-
     auto transposedRhsType =
         RankedTensorType::get(transposedRhsShape, rhsElemTy);
-    rhs = rewriter.create<tosa::TransposeOp>(
-        op->getLoc(),
-        OpConversionPattern<AtenOpT>::getTypeConverter()->convertType(
-            transposedRhsType),
-        rhs, transposedRhsShapeConst.getValue());
+
+    // Constant weights are transposed at compile time rather than at every
+    // inference.
+    DenseElementsAttr weightAttr;
+    FailureOr<DenseElementsAttr> transposedWeightAttr = failure();
+    if (matchPattern(op.weight(), m_Constant(&weightAttr)) &&
+        weightAttr.getType().getElementType() == rhsElemTy) {
+      SmallVector<int64_t> perms(transposedRhsDims.begin(),
+                                 transposedRhsDims.end());
+      transposedWeightAttr = transposeElementsAttr(weightAttr, perms);
+    }
+    if (succeeded(transposedWeightAttr)) {
+      rhs = rewriter.create<tosa::ConstOp>(op->getLoc(),
+                                           transposedWeightAttr->getType(),
+                                           *transposedWeightAttr);
+    } else {
+      llvm::Optional<Value> transposedRhsShapeConst =
+          tosa::getConstTensor<int32_t>(
+              rewriter, op,
+              /*vec=*/transposedRhsDims,
+              /*shape=*/{static_cast<int32_t>(transposedRhsDims.size())});
+
+      rhs = rewriter.create<tosa::TransposeOp>(
+          op->getLoc(),
+          OpConversionPattern<AtenOpT>::getTypeConverter()->convertType(
+              transposedRhsType),
+          rhs, transposedRhsShapeConst.getValue());
+    }
 
     Value matmulOutput;
     if (failed(
@@ -1709,6 +1862,28 @@ LogicalResult ConvertAtenOp<AtenConvolutionOp>::matchAndRewrite(
   if (!weightTy.hasStaticShape())
     return op.emitError("Unimplemented: TOSA only supports static weight");
 
+  bool transposed;
+  if (!matchPattern(op.transposed(), m_TorchConstantBool(&transposed)) ||
+      transposed)
+    return rewriter.notifyMatchFailure(
+        op, "Unimplemented: only non-transposed convolutions supported");
+
+  int64_t groups;
+  if (!matchPattern(op.groups(), m_TorchConstantInt(&groups)) || groups < 1)
+    return rewriter.notifyMatchFailure(
+        op, "Unimplemented: only constant positive groups supported");
+  int64_t numChannels = inputShape[1];
+  if (groups != 1 &&
+      (numChannels == ShapedType::kDynamicSize || numChannels % groups != 0 ||
+       weightShape[0] % groups != 0))
+    return rewriter.notifyMatchFailure(
+        op, "Unimplemented: grouped convolution with channels that are "
+            "dynamic or not divisible by groups");
+  bool isDepthwise = groups != 1 && groups == numChannels;
+  if (groups != 1 && !isDepthwise && !inputTy.hasStaticShape())
+    return rewriter.notifyMatchFailure(
+        op, "Unimplemented: grouped convolution with dynamic input shape");
+
   // Bias is optional. TOSA mandates a zero tensor here, so construct one if
   // required.
   auto bias = adaptor.bias();
@@ -1754,7 +1929,7 @@ LogicalResult ConvertAtenOp<AtenConvolutionOp>::matchAndRewrite(
     return rewriter.notifyMatchFailure(op,
                                        "non-const dilation list unsupported");
 
-  // TOSA works in NHWC and takes OHWI weights. Perform the necessary transpose.
+  // TOSA works in NHWC. Perform the necessary transpose.
   llvm::Optional<Value> nchwToNhwcTransposeConst =
       tosa::getConstTensor<int32_t>(rewriter, op,
                                     /*vec=*/{0, 2, 3, 1},
@@ -1771,26 +1946,53 @@ LogicalResult ConvertAtenOp<AtenConvolutionOp>::matchAndRewrite(
               nchwToNhwcTransposeConst.getValue())
           .getResult();
 
-  SmallVector<int64_t> transposedWeightShape(
-      {weightShape[0], weightShape[2], weightShape[3], weightShape[1]});
-  auto transposedWeightType =
-      RankedTensorType::get(transposedWeightShape, weightElemTy);
-  auto transposedWeight =
-      rewriter
-          .create<tosa::TransposeOp>(
-              op->getLoc(),
-              getTypeConverter()->convertType(transposedWeightType), weight,
-              nchwToNhwcTransposeConst.getValue())
-          .getResult();
+  // Transposes the weights by `perms` and reshapes them to `newShape`.
+  // Constant weights are transformed at compile time rather than at every
+  // invocation.
+  auto transformWeight = [&](ArrayRef<int64_t> perms,
+                             ArrayRef<int64_t> newShape) -> Value {
+    SmallVector<int64_t> transposedShape;
+    for (int64_t perm : perms)
+      transposedShape.push_back(weightShape[perm]);
+    auto transposedType = RankedTensorType::get(transposedShape, weightElemTy);
+    auto newType = RankedTensorType::get(newShape, weightElemTy);
+    DenseElementsAttr weightAttr;
+    if (matchPattern(op.weight(), m_Constant(&weightAttr)) &&
+        weightAttr.getType().getElementType() == weightElemTy) {
+      FailureOr<DenseElementsAttr> transposedWeightAttr =
+          transposeElementsAttr(weightAttr, perms);
+      if (succeeded(transposedWeightAttr)) {
+        DenseElementsAttr newWeightAttr =
+            transposedWeightAttr->reshape(newType);
+        return rewriter.create<tosa::ConstOp>(
+            op->getLoc(), newWeightAttr.getType(), newWeightAttr);
+      }
+    }
+    SmallVector<int32_t> perms32(perms.begin(), perms.end());
+    llvm::Optional<Value> permsConst = tosa::getConstTensor<int32_t>(
+        rewriter, op, /*vec=*/perms32,
+        /*shape=*/{static_cast<int32_t>(perms.size())});
+    Value transformed =
+        rewriter
+            .create<tosa::TransposeOp>(
+                op->getLoc(), getTypeConverter()->convertType(transposedType),
+                weight, permsConst.getValue())
+            .getResult();
+    if (transposedShape != newShape)
+      transformed = rewriter.create<tosa::ReshapeOp>(
+          op->getLoc(), newType, transformed,
+          rewriter.getI64ArrayAttr(newShape));
+    return transformed;
+  };
 
   int64_t outputHDim, outputWDim;
   if (inputTy.hasStaticShape()) {
     outputHDim = (transposedInputShape[1] + padding[0] + padding[1] -
-                  dilation[0] * (transposedWeightShape[1] - 1) - 1) /
+                  dilation[0] * (weightShape[2] - 1) - 1) /
                      stride[0] +
                  1;
     outputWDim = (transposedInputShape[2] + padding[2] + padding[3] -
-                  dilation[1] * (transposedWeightShape[2] - 1) - 1) /
+                  dilation[1] * (weightShape[3] - 1) - 1) /
                      stride[1] +
                  1;
   } else {
@@ -1801,18 +2003,88 @@ LogicalResult ConvertAtenOp<AtenConvolutionOp>::matchAndRewrite(
   // Output shape is NHWC, to be transposed back to NCHW. Output elemTy for
   // quantized input is i32, which gets rescaled down to quantized output range.
   SmallVector<int64_t> outputShape = {transposedInputShape[0], outputHDim,
-                                      outputWDim, transposedWeightShape[0]};
+                                      outputWDim, weightShape[0]};
   auto convOpTy = RankedTensorType::get(outputShape, biasElemTy);
 
-  Value convOpResult =
-      rewriter
-          .create<tosa::Conv2DOp>(op->getLoc(),
-                                  getTypeConverter()->convertType(convOpTy),
-                                  transposedInput, transposedWeight, bias,
-                                  rewriter.getI64ArrayAttr(padding),
-                                  rewriter.getI64ArrayAttr(stride),
-                                  rewriter.getI64ArrayAttr(dilation))
-          .getResult();
+  auto paddingAttr = rewriter.getI64ArrayAttr(padding);
+  auto strideAttr = rewriter.getI64ArrayAttr(stride);
+  auto dilationAttr = rewriter.getI64ArrayAttr(dilation);
+  Value convOpResult;
+  if (isDepthwise) {
+    // TOSA takes depthwise weights as [KH, KW, C, M], where M is the channel
+    // multiplier, and computes output channel c * M + m with filter m of input
+    // channel c, like PyTorch does. Transposing the [C * M, 1, KH, KW] weights
+    // to [KH, KW, 1, C * M] thus leaves them in the right order to be
+    // reshaped.
+    Value depthwiseWeight = transformWeight(
+        {2, 3, 1, 0}, {weightShape[2], weightShape[3], numChannels,
+                       weightShape[0] / numChannels});
+    convOpResult =
+        rewriter
+            .create<tosa::DepthwiseConv2DOp>(
+                op->getLoc(), getTypeConverter()->convertType(convOpTy),
+                transposedInput, depthwiseWeight, bias, paddingAttr,
+                strideAttr, dilationAttr)
+            .getResult();
+  } else {
+    // TOSA works in NHWC and takes OHWI weights.
+    Value transposedWeight = transformWeight(
+        {0, 2, 3, 1},
+        {weightShape[0], weightShape[2], weightShape[3], weightShape[1]});
+    if (groups == 1) {
+      convOpResult =
+          rewriter
+              .create<tosa::Conv2DOp>(op->getLoc(),
+                                      getTypeConverter()->convertType(convOpTy),
+                                      transposedInput, transposedWeight, bias,
+                                      paddingAttr, strideAttr, dilationAttr)
+              .getResult();
+    } else {
+      // TOSA has no grouped convolution, so compute each group as a separate
+      // convolution of its slice of the input channels with its slice of the
+      // filters, and concatenate their outputs along the channels.
+      int64_t inGroupSize = numChannels / groups;
+      int64_t outGroupSize = weightShape[0] / groups;
+      SmallVector<int64_t> inputSliceShape(transposedInputShape);
+      inputSliceShape[3] = inGroupSize;
+      SmallVector<int64_t> weightSliceShape = {outGroupSize, weightShape[2],
+                                               weightShape[3], weightShape[1]};
+      SmallVector<int64_t> groupOutputShape(outputShape);
+      groupOutputShape[3] = outGroupSize;
+      auto biasTy = bias.getType().cast<RankedTensorType>();
+      SmallVector<Value> groupResults;
+      for (int64_t g = 0; g < groups; g++) {
+        Value inputSlice = rewriter.create<tosa::SliceOp>(
+            op->getLoc(),
+            RankedTensorType::get(inputSliceShape, inputElemTy),
+            transposedInput,
+            rewriter.getI64ArrayAttr({0, 0, 0, g * inGroupSize}),
+            rewriter.getI64ArrayAttr(inputSliceShape));
+        Value weightSlice = rewriter.create<tosa::SliceOp>(
+            op->getLoc(),
+            RankedTensorType::get(weightSliceShape, weightElemTy),
+            transposedWeight,
+            rewriter.getI64ArrayAttr({g * outGroupSize, 0, 0, 0}),
+            rewriter.getI64ArrayAttr(weightSliceShape));
+        Value biasSlice = rewriter.create<tosa::SliceOp>(
+            op->getLoc(),
+            RankedTensorType::get({outGroupSize}, biasTy.getElementType()),
+            bias, rewriter.getI64ArrayAttr({g * outGroupSize}),
+            rewriter.getI64ArrayAttr({outGroupSize}));
+        groupResults.push_back(
+            rewriter
+                .create<tosa::Conv2DOp>(
+                    op->getLoc(),
+                    RankedTensorType::get(groupOutputShape, biasElemTy),
+                    inputSlice, weightSlice, biasSlice, paddingAttr,
+                    strideAttr, dilationAttr)
+                .getResult());
+      }
+      convOpResult = rewriter.create<tosa::ConcatOp>(
+          op->getLoc(), getTypeConverter()->convertType(convOpTy),
+          groupResults, rewriter.getI64IntegerAttr(3));
+    }
+  }
 
   llvm::Optional<Value> nhwcToNchwTransposeConst =
       tosa::getConstTensor<int32_t>(rewriter, op,
@@ -2169,11 +2441,169 @@ LogicalResult ConvertAtenOp<ValueTensorLiteralOp>::matchAndRewrite(
   auto outputTy = getTypeConverter()
                       ->convertType(op.getType())
                       .template cast<RankedTensorType>();
+  // Signed and unsigned integer literals, such as the integer representation
+  // of quantized weights, become signless.
+  if (auto elements = op.valueAttr().dyn_cast<DenseIntElementsAttr>()) {
+    if (elements.getElementType() != outputTy.getElementType()) {
+      unsigned bitWidth = outputTy.getElementTypeBitWidth();
+      rewriter.replaceOpWithNewOp<tosa::ConstOp>(
+          op, outputTy,
+          elements.mapValues(outputTy.getElementType(), [&](const APInt &v) {
+            return APInt(bitWidth, v.getSExtValue());
+          }));
+      return success();
+    }
+  }
   rewriter.replaceOpWithNewOp<tosa::ConstOp>(op, outputTy, adaptor.value());
 
   return success();
 }
 
+// Quantized tensors are represented by their integer representation, so
+// creating one from it is a no-op.
+template <>
+LogicalResult ConvertAtenOp<PerTensorAffineCreateOp>::matchAndRewrite(
+    PerTensorAffineCreateOp op, OpAdaptor adaptor,
+    ConversionPatternRewriter &rewriter) const {
+  Type resultTy = getTypeConverter()->convertType(op.getType());
+  if (!resultTy || adaptor.int_repr().getType() != resultTy)
+    return rewriter.notifyMatchFailure(
+        op, "expected int_repr of the integer type of the result");
+  rewriter.replaceOp(op, adaptor.int_repr());
+  return success();
+}
+
+// Lowers `quantized::linear` to an integer-only tosa.fully_connected:
+//   acc[m, n] = sum_k x[m, k] * w[n, k] + qbias[n]   (in i32)
+//   y[m, n] = rescale(acc[m, n], x_scale * w_scale / y_scale) + y_zp
+// The weights are constant and symmetrically quantized, so the input zero
+// point term -x_zp * sum_k w[n, k] is folded with the float bias, quantized
+// to the accumulator scale, into the i32 bias `qbias`.
+template <>
+LogicalResult ConvertAtenOp<QuantizedLinearOp>::matchAndRewrite(
+    QuantizedLinearOp op, OpAdaptor adaptor,
+    ConversionPatternRewriter &rewriter) const {
+  auto params = op.W_prepack().getDefiningOp<LinearParamsCreateOp>();
+  if (!params)
+    return rewriter.notifyMatchFailure(op, "expected known linear params");
+  if (!isQuantizedTensor(op.X()) || !isQuantizedTensor(params.weight()) ||
+      !isQuantizedTensor(op.getResult()))
+    return rewriter.notifyMatchFailure(op, "expected 8-bit quantized types");
+  if (isUnsignedQuantizedTensor(params.weight()))
+    return rewriter.notifyMatchFailure(op, "Unimplemented: quint8 weights");
+
+  double inputScale, weightScale, outputScale;
+  int64_t inputZp, weightZp, outputZp;
+  if (failed(getConstantPerTensorQuantizationParams(op.X(), inputScale,
+                                                    inputZp)) ||
+      failed(getConstantPerTensorQuantizationParams(params.weight(),
+                                                    weightScale, weightZp)) ||
+      !matchPattern(op.Y_scale_i(), m_TorchConstantFloat(&outputScale)) ||
+      !matchPattern(op.Y_zero_point_i(), m_TorchConstantInt(&outputZp)))
+    return rewriter.notifyMatchFailure(
+        op, "expected constant per-tensor quantization parameters");
+  if (weightZp != 0)
+    return rewriter.notifyMatchFailure(
+        op, "Unimplemented: asymmetrically quantized weights");
+
+  DenseIntElementsAttr weightAttr;
+  auto weightCreate = params.weight().getDefiningOp<PerTensorAffineCreateOp>();
+  if (!weightCreate ||
+      !matchPattern(weightCreate.int_repr(), m_Constant(&weightAttr)))
+    return rewriter.notifyMatchFailure(op, "expected constant weights");
+  ShapedType weightAttrTy = weightAttr.getType();
+  if (weightAttrTy.getRank() != 2)
+    return rewriter.notifyMatchFailure(op, "expected rank 2 weights");
+  int64_t outChannels = weightAttrTy.getDimSize(0);
+  int64_t inChannels = weightAttrTy.getDimSize(1);
+
+  SmallVector<double> bias(outChannels, 0.0);
+  if (params.bias()) {
+    DenseFPElementsAttr biasAttr;
+    if (!matchPattern(params.bias(), m_Constant(&biasAttr)) ||
+        biasAttr.getNumElements() != outChannels)
+      return rewriter.notifyMatchFailure(op, "expected constant float bias");
+    int64_t i = 0;
+    for (APFloat value : biasAttr.getValues<APFloat>()) {
+      bool losesInfo;
+      value.convert(APFloat::IEEEdouble(), APFloat::rmNearestTiesToEven,
+                    &losesInfo);
+      bias[i++] = value.convertToDouble();
+    }
+  }
+
+  Value input = adaptor.X();
+  auto inputTy = input.getType().cast<RankedTensorType>();
+  if (inputTy.getRank() != 2)
+    return rewriter.notifyMatchFailure(op, "expected rank 2 input");
+  if (isUnsignedQuantizedTensor(op.X())) {
+    input = flipSignBit(rewriter, op, input);
+    inputZp -= 128;
+  }
+
+  Type i8Ty = rewriter.getIntegerType(8);
+  SmallVector<APInt> weights;
+  SmallVector<int32_t> quantizedBias(outChannels);
+  double accScale = inputScale * weightScale;
+  for (int64_t n = 0; n < outChannels; n++)
+    quantizedBias[n] = static_cast<int32_t>(std::round(bias[n] / accScale));
+  int64_t i = 0;
+  for (APInt value : weightAttr.getValues<APInt>()) {
+    int64_t w = value.getSExtValue();
+    weights.push_back(APInt(8, w, /*isSigned=*/true));
+    quantizedBias[i++ / inChannels] -= inputZp * w;
+  }
+  auto weightTy = RankedTensorType::get({outChannels, inChannels}, i8Ty);
+  Value weight = rewriter.create<tosa::ConstOp>(
+      op->getLoc(), weightTy, DenseElementsAttr::get(weightTy, weights));
+  Value biasConst =
+      tosa::getConstTensor<int32_t>(rewriter, op, quantizedBias, {outChannels})
+          .getValue();
+
+  auto accTy = RankedTensorType::get({inputTy.getDimSize(0), outChannels},
+                                     rewriter.getI32Type());
+  Value acc = rewriter.create<tosa::FullyConnectedOp>(op->getLoc(), accTy,
+                                                      input, weight, biasConst);
+
+  bool isOutputUnsigned = isUnsignedQuantizedTensor(op.getResult());
+  if (isOutputUnsigned)
+    outputZp -= 128;
+  Value result = tosa::buildRescale(
+      rewriter, op, accTy.clone(i8Ty), acc, accScale / outputScale,
+      /*input_zp=*/0, outputZp, /*double_round=*/true, /*scale32=*/true);
+  if (isOutputUnsigned)
+    result = flipSignBit(rewriter, op, result);
+
+  rewriter.replaceOpWithNewOp<tensor::CastOp>(
+      op, getTypeConverter()->convertType(op.getType()), result);
+  // The params hold a quantized tensor, which has no TOSA counterpart, so
+  // they can't be left behind. They are erased with the last of the linears
+  // using them, whose conversion commits or rolls back with the others.
+  bool isLastUser = llvm::all_of(params->getUsers(), [&](Operation *user) {
+    return isa<QuantizedLinearOp>(user) && user->getBlock() == op->getBlock() &&
+           !op->isBeforeInBlock(user);
+  });
+  if (isLastUser)
+    rewriter.eraseOp(params);
+  return success();
+}
+
+// External literals are loaded from their file and converted to tosa.const .
+template <>
+LogicalResult ConvertAtenOp<ValueTensorExternalLiteralOp>::matchAndRewrite(
+    ValueTensorExternalLiteralOp op, OpAdaptor adaptor,
+    ConversionPatternRewriter &rewriter) const {
+  auto outputTy = getTypeConverter()
+                      ->convertType(op.getType())
+                      .template cast<RankedTensorType>();
+  FailureOr<DenseElementsAttr> elements = op.readElements(outputTy);
+  if (failed(elements))
+    return failure();
+  rewriter.replaceOpWithNewOp<tosa::ConstOp>(op, outputTy, *elements);
+
+  return success();
+}
+
 template <>
 LogicalResult ConvertAtenOp<AtenFlattenUsingIntsOp>::matchAndRewrite(
     AtenFlattenUsingIntsOp op, OpAdaptor adaptor,
@@ -2522,6 +2952,35 @@ static Value buildUnitNormalCdf(ConversionPatternRewriter &rewriter,
   return normalCdf;
 }
 
+// Approximates the unit normal CDF with a tanh, like PyTorch's
+// gelu(approximate="tanh") does:
+//   cdf(x) = 0.5 * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+static Value buildTanhApproximateUnitNormalCdf(
+    ConversionPatternRewriter &rewriter, Operation *op, Value x) {
+  auto loc = op->getLoc();
+  auto outType = x.getType();
+  auto one = tosa::getConstTensor<float>(rewriter, op, 1, {}).getValue();
+  auto oneHalf = tosa::getConstTensor<float>(rewriter, op, 0.5, {}).getValue();
+  auto kappa =
+      tosa::getConstTensor<float>(rewriter, op, 0.044715, {}).getValue();
+  auto sqrt2OverPi =
+      tosa::getConstTensor<float>(rewriter, op, 0.7978845608, {}).getValue();
+
+  Value xSquared =
+      rewriter.create<tosa::MulOp>(loc, outType, x, x, /*shift=*/0);
+  Value xCubed =
+      rewriter.create<tosa::MulOp>(loc, outType, xSquared, x, /*shift=*/0);
+  Value kappaXCubed =
+      rewriter.create<tosa::MulOp>(loc, outType, kappa, xCubed, /*shift=*/0);
+  Value inner = rewriter.create<tosa::AddOp>(loc, outType, x, kappaXCubed);
+  Value tanhArg = rewriter.create<tosa::MulOp>(loc, outType, sqrt2OverPi,
+                                               inner, /*shift=*/0);
+  Value tanh = rewriter.create<tosa::TanhOp>(loc, outType, tanhArg);
+  Value tanhPlus1 = rewriter.create<tosa::AddOp>(loc, outType, one, tanh);
+  return rewriter.create<tosa::MulOp>(loc, outType, oneHalf, tanhPlus1,
+                                      /*shift=*/0);
+}
+
 // This lowering is based on Torch to LinAlg lowering.
 template <>
 LogicalResult ConvertAtenOp<AtenGeluOp>::matchAndRewrite(
@@ -2538,14 +2997,16 @@ LogicalResult ConvertAtenOp<AtenGeluOp>::matchAndRewrite(
     return op.emitError("Only floating-point datatype legalization supported");
   }
 
-  // TODO: Handle approximate.
   std::string approximate;
   if (!matchPattern(op.approximate(), m_TorchConstantStr(approximate)) ||
-      approximate != "none") {
+      (approximate != "none" && approximate != "tanh")) {
     return op.emitError("Unsupported value of approximate");
   }
 
-  Value cdf = buildUnitNormalCdf(rewriter, op, adaptor.self());
+  Value cdf = approximate == "tanh"
+                  ? buildTanhApproximateUnitNormalCdf(rewriter, op,
+                                                      adaptor.self())
+                  : buildUnitNormalCdf(rewriter, op, adaptor.self());
   rewriter.replaceOpWithNewOp<tosa::MulOp>(
       op, getTypeConverter()->convertType(op.getType()), adaptor.self(), cdf,
       /*shift=*/0);
@@ -2912,6 +3373,17 @@ public:
     // stride = inputDim // outputDim
     // kernel = inputDim - (outputDim-1)* stride
     // pad = 0, dilation = 1
+    // This gives the windows of PyTorch, from floor(i * inputDim / outputDim)
+    // to ceil((i + 1) * inputDim / outputDim), only when outputDim divides
+    // inputDim.
+    if (inputHDim == ShapedType::kDynamicSize ||
+        inputWDim == ShapedType::kDynamicSize)
+      return rewriter.notifyMatchFailure(
+          op, "Adaptive pooling of dynamic spatial dims unsupported.");
+    if (inputHDim % outputHDim != 0 || inputWDim % outputWDim != 0)
+      return rewriter.notifyMatchFailure(
+          op, "Adaptive pooling to output sizes that don't divide the input "
+              "sizes unsupported.");
 
     int64_t strideH = inputShape[inputRank - 2] / outputHDim;
     int64_t strideW = inputShape[inputRank - 1] / outputWDim;
@@ -2940,10 +3412,12 @@ public:
   }
 };
 
+// Returns the output type of a pooling op with the TOSA padding `padArray`,
+// i.e. {top, bottom, left, right}.
 template <typename AtenOpT, typename tosaOp>
 static Type getOutputTypeForNonAdaptivePoolingOp(
     RankedTensorType inputTy, SmallVectorImpl<int64_t> &kernelSize,
-    SmallVectorImpl<int64_t> &strideArray, SmallVectorImpl<int64_t> &padArray,
+    SmallVectorImpl<int64_t> &strideArray, ArrayRef<int64_t> padArray,
     SmallVectorImpl<int64_t> &dilationArray) {
   auto inputShape = inputTy.getShape();
   auto inputRank = inputTy.getRank();
@@ -2951,10 +3425,10 @@ static Type getOutputTypeForNonAdaptivePoolingOp(
 
   int64_t outputHDim = ConvertAtenPoolingBaseOp<AtenOpT, tosaOp>::getOutputDim(
       inputShape[inputRank - 2], kernelSize[0], strideArray[0], padArray[0],
-      padArray[0], dilationArray[0]);
+      padArray[1], dilationArray[0]);
   int64_t outputWDim = ConvertAtenPoolingBaseOp<AtenOpT, tosaOp>::getOutputDim(
-      inputShape[inputRank - 1], kernelSize[1], strideArray[1], padArray[1],
-      padArray[1], dilationArray[1]);
+      inputShape[inputRank - 1], kernelSize[1], strideArray[1], padArray[2],
+      padArray[3], dilationArray[1]);
   SmallVector<int64_t> outputShape;
   if (inputRank > 3)
     outputShape.push_back(inputShape[0]);
@@ -2965,12 +3439,14 @@ static Type getOutputTypeForNonAdaptivePoolingOp(
 }
 
 // Checks the validity of pooling parameters and stores them in the respective
-// vector. Also, gets the output type for the pooling op.
+// vector. Also, gets the output type for the pooling op. `ceil_mode` is only
+// supported if `supportsCeilMode`, for ops whose result doesn't change when
+// the input is padded at the bottom and right, like max pooling.
 template <typename AtenOpT, typename tosaOp>
 static LogicalResult getOutputTypeAndPoolingParameters(
     AtenOpT op, ConversionPatternRewriter &rewriter, Value inputXchw,
     SmallVectorImpl<int64_t> &dilationArray, Type &outputTy, ArrayAttr &kernel,
-    ArrayAttr &stride, ArrayAttr &pad) {
+    ArrayAttr &stride, ArrayAttr &pad, bool supportsCeilMode = false) {
 
   RankedTensorType inputTy = inputXchw.getType().cast<RankedTensorType>();
   if (!inputTy)
@@ -2992,22 +3468,43 @@ static LogicalResult getOutputTypeAndPoolingParameters(
     return rewriter.notifyMatchFailure(
         op, "Non-const padding factor for pooling op unsupported");
 
-  kernel = rewriter.getI64ArrayAttr(kernelSizeInts);
-  stride = rewriter.getI64ArrayAttr(strideInts);
-  pad = rewriter.getI64ArrayAttr(
+  // TOSA uses 4D padding {t, b, l, r} while Torch defines 2D padding {t, l}.
+  SmallVector<int64_t> padArray(
       {paddingInts[0], paddingInts[0], paddingInts[1], paddingInts[1]});
 
-  // FIXME: add ceil_mode support.
   bool ceilMode;
   if (!matchPattern(op.ceil_mode(), m_TorchConstantBool(&ceilMode)))
     return rewriter.notifyMatchFailure(
         op, "only support constant bool ceil_mode for pooling op");
-  if (ceilMode)
+  if (ceilMode && !supportsCeilMode)
     return rewriter.notifyMatchFailure(
         op, "only support ceil_mode equals to False for pooling op");
+  if (ceilMode) {
+    // The output size is rounded up rather than down, except that the last
+    // window must start in the input or its top/left padding. Pad the bottom
+    // and right of the input so that the last window fits.
+    for (int i = 0; i < 2; i++) {
+      int64_t inputDim = inputTy.getShape()[inputRank - 2 + i];
+      if (inputDim == ShapedType::kDynamicSize)
+        return rewriter.notifyMatchFailure(
+            op, "ceil_mode pooling of dynamic spatial dims unsupported");
+      int64_t paddedDim = inputDim + 2 * paddingInts[i];
+      int64_t windowDim = dilationArray[i] * (kernelSizeInts[i] - 1) + 1;
+      int64_t outputDim =
+          llvm::divideCeil(paddedDim - windowDim, strideInts[i]) + 1;
+      if ((outputDim - 1) * strideInts[i] >= inputDim + paddingInts[i])
+        outputDim--;
+      padArray[2 * i + 1] += std::max<int64_t>(
+          0, (outputDim - 1) * strideInts[i] + windowDim - paddedDim);
+    }
+  }
+
+  kernel = rewriter.getI64ArrayAttr(kernelSizeInts);
+  stride = rewriter.getI64ArrayAttr(strideInts);
+  pad = rewriter.getI64ArrayAttr(padArray);
 
   outputTy = getOutputTypeForNonAdaptivePoolingOp<AtenOpT, tosaOp>(
-      inputTy, kernelSizeInts, strideInts, paddingInts, dilationArray);
+      inputTy, kernelSizeInts, strideInts, padArray, dilationArray);
 
   return success();
 }
@@ -3029,10 +3526,11 @@ public:
     if (dilationArray[0] > 1 || dilationArray[1] > 1)
       return op.emitError("Cannot process non-unit pooling dilation.");
 
+    // TOSA max pooling ignores the padding, so ceil_mode only pads more.
     if (failed(getOutputTypeAndPoolingParameters<AtenMaxPool2dOp,
                                                  tosa::MaxPool2dOp>(
             op, rewriter, adaptor.self(), dilationArray, outputTy, kernel,
-            stride, pad)))
+            stride, pad, /*supportsCeilMode=*/true)))
       return rewriter.notifyMatchFailure(
           op, "invalid pooling parameters or input type");
 
@@ -3061,10 +3559,46 @@ public:
       return rewriter.notifyMatchFailure(
           op, "invalid pooling parameters or input type");
 
+    bool countIncludePad;
+    if (!matchPattern(op.count_include_pad(),
+                      m_TorchConstantBool(&countIncludePad)))
+      return rewriter.notifyMatchFailure(
+          op, "only support constant bool count_include_pad for pooling op");
+    if (!op.divisor_override().getType().isa<Torch::NoneType>())
+      return rewriter.notifyMatchFailure(
+          op, "divisor_override for pooling op unsupported");
+
     // Transpose to xHWC
     input = ConvertAtenPoolingBaseOp<AtenAvgPool2dOp, tosa::AvgPool2dOp>::
         transposePoolingInputToHwc(op, rewriter, adaptor.self());
 
+    // TOSA leaves the padding out of the averages. For PyTorch to count it,
+    // pad the input with zeros instead.
+    SmallVector<int64_t> padArray;
+    for (APInt padValue : pad.getAsValueRange<IntegerAttr>())
+      padArray.push_back(padValue.getSExtValue());
+    if (countIncludePad &&
+        llvm::any_of(padArray, [](int64_t padValue) { return padValue; })) {
+      auto inputTy = input.getType().cast<RankedTensorType>();
+      int64_t inputRank = inputTy.getRank();
+      SmallVector<int32_t> paddings(2 * inputRank, 0);
+      SmallVector<int64_t> paddedShape(inputTy.getShape());
+      for (int i = 0; i < 2; i++) {
+        int64_t dim = inputRank - 3 + i;
+        paddings[2 * dim] = padArray[2 * i];
+        paddings[2 * dim + 1] = padArray[2 * i + 1];
+        if (paddedShape[dim] != ShapedType::kDynamicSize)
+          paddedShape[dim] += padArray[2 * i] + padArray[2 * i + 1];
+      }
+      llvm::Optional<Value> paddingsConst = tosa::getConstTensor<int32_t>(
+          rewriter, op, paddings, {static_cast<int32_t>(inputRank), 2});
+      input = rewriter.create<tosa::PadOp>(
+          op->getLoc(),
+          RankedTensorType::get(paddedShape, inputTy.getElementType()), input,
+          paddingsConst.getValue());
+      pad = rewriter.getI64ArrayAttr({0, 0, 0, 0});
+    }
+
     return success();
   }
 };
@@ -3276,6 +3810,16 @@ public:
                                         mlir::tosa::convertReduceSumOp)
 #undef INSERT_ALLDIMS_REDUCTION_OP_PATTERN
 
+#define INSERT_SOFTMAX_OP_PATTERN(AtenOp, ConversionFunc)                      \
+  target.addIllegalOp<AtenOp>();                                               \
+  patterns.add<ConvertAtenSoftmaxOp<AtenOp, ConversionFunc>>(typeConverter,    \
+                                                             context);
+    INSERT_SOFTMAX_OP_PATTERN(AtenSoftmaxIntOp, tosa::convertSoftmaxOp)
+    INSERT_SOFTMAX_OP_PATTERN(Aten_SoftmaxOp, tosa::convertSoftmaxOp)
+    INSERT_SOFTMAX_OP_PATTERN(AtenLogSoftmaxIntOp, tosa::convertLogSoftmaxOp)
+    INSERT_SOFTMAX_OP_PATTERN(Aten_LogSoftmaxOp, tosa::convertLogSoftmaxOp)
+#undef INSERT_SOFTMAX_OP_PATTERN
+
 #define INSERT_SQUEEZE_OP_PATTERN(AtenOp, TemplateForm)                        \
   target.addIllegalOp<AtenOp>();                                               \
   patterns.add<TemplateForm<AtenOp>>(typeConverter, context);
@@ -3341,6 +3885,9 @@ public:
     INSERT_ATENOP_PATTERN(AtenRsubScalarOp);
     INSERT_ATENOP_PATTERN(AtenConvolutionOp);
     INSERT_ATENOP_PATTERN(ValueTensorLiteralOp);
+    INSERT_ATENOP_PATTERN(ValueTensorExternalLiteralOp);
+    INSERT_ATENOP_PATTERN(PerTensorAffineCreateOp);
+    INSERT_ATENOP_PATTERN(QuantizedLinearOp);
     INSERT_ATENOP_PATTERN(AtenReshapeOp);
     INSERT_ATENOP_PATTERN(AtenBatchNormOp);
     INSERT_ATENOP_PATTERN(AtenNativeLayerNormOp);
@@ -310,5 +310,87 @@ convertReduceMeanOp(PatternRewriter &rewriter, Operation *op,
   return val;
 }
 
+// Computes logits - reduce_max(logits, dim), the exp of which can't overflow.
+// Also returns the type of the reduction along `dim`, which keeps the reduced
+// dim so that it broadcasts against the logits.
+static llvm::Optional<Value>
+buildShiftedLogits(PatternRewriter &rewriter, Operation *op, Value logits_value,
+                   int64_t dim, RankedTensorType &reduced_type) {
+  RankedTensorType logits_type =
+      logits_value.getType().dyn_cast<RankedTensorType>();
+  if (!logits_type || !logits_type.getElementType().isa<mlir::FloatType>()) {
+    op->emitOpError("Softmax: expected ranked floating-point logits");
+    return llvm::None;
+  }
+
+  SmallVector<int64_t> reduced_shape(logits_type.getShape().begin(),
+                                     logits_type.getShape().end());
+  reduced_shape[dim] = 1;
+  reduced_type =
+      RankedTensorType::get(reduced_shape, logits_type.getElementType());
+
+  auto max_op = CreateOpAndInfer<tosa::ReduceMaxOp>(
+      rewriter, op->getLoc(), reduced_type, logits_value,
+      rewriter.getI64IntegerAttr(dim));
+  return CreateOpAndInfer<tosa::SubOp>(rewriter, op->getLoc(), logits_type,
+                                       logits_value, max_op.getResult())
+      .getResult();
+}
+
+// Lowers Softmax to a sequence of TOSA ops.
+llvm::Optional<Value> convertSoftmaxOp(PatternRewriter &rewriter, Operation *op,
+                                       RankedTensorType output_type,
+                                       Value logits_value, int64_t dim) {
+  // softmax is lowered as followed:
+  // op1 = sub(logits, reduce_max(logits, dim))
+  // op2 = exp(op1)
+  // op3 = reciprocal(reduce_sum(op2, dim))
+  // op4 = mul(op2, op3)
+  RankedTensorType reduced_type;
+  auto shifted = buildShiftedLogits(rewriter, op, logits_value, dim,
+                                    reduced_type);
+  if (!shifted)
+    return llvm::None;
+
+  auto exp_op = CreateOpAndInfer<tosa::ExpOp>(
+      rewriter, op->getLoc(), shifted->getType(), shifted.getValue());
+  auto sum_op = CreateOpAndInfer<tosa::ReduceSumOp>(
+      rewriter, op->getLoc(), reduced_type, exp_op.getResult(),
+      rewriter.getI64IntegerAttr(dim));
+  auto reciprocal_op = CreateOpAndInfer<tosa::ReciprocalOp>(
+      rewriter, op->getLoc(), reduced_type, sum_op.getResult());
+  return CreateOpAndInfer<tosa::MulOp>(rewriter, op->getLoc(), output_type,
+                                       exp_op.getResult(),
+                                       reciprocal_op.getResult(), 0)
+      .getResult();
+}
+
+// Lowers LogSoftmax to a sequence of TOSA ops.
+llvm::Optional<Value> convertLogSoftmaxOp(PatternRewriter &rewriter,
+                                          Operation *op,
+                                          RankedTensorType output_type,
+                                          Value logits_value, int64_t dim) {
+  // log_softmax is lowered as followed:
+  // op1 = sub(logits, reduce_max(logits, dim))
+  // op2 = log(reduce_sum(exp(op1), dim))
+  // op3 = sub(op1, op2)
+  RankedTensorType reduced_type;
+  auto shifted = buildShiftedLogits(rewriter, op, logits_value, dim,
+                                    reduced_type);
+  if (!shifted)
+    return llvm::None;
+
+  auto exp_op = CreateOpAndInfer<tosa::ExpOp>(
+      rewriter, op->getLoc(), shifted->getType(), shifted.getValue());
+  auto sum_op = CreateOpAndInfer<tosa::ReduceSumOp>(
+      rewriter, op->getLoc(), reduced_type, exp_op.getResult(),
+      rewriter.getI64IntegerAttr(dim));
+  auto log_op = CreateOpAndInfer<tosa::LogOp>(rewriter, op->getLoc(),
+                                              reduced_type, sum_op.getResult());
+  return CreateOpAndInfer<tosa::SubOp>(rewriter, op->getLoc(), output_type,
+                                       shifted.getValue(), log_op.getResult())
+      .getResult();
+}
+
 } // namespace tosa
 } // namespace mlir
@@ -100,6 +100,89 @@ void TorchDialect::printType(Type type, DialectAsmPrinter &printer) const {
   printTorchDialectType(type, printer);
 }
 
+const SymbolTable *TorchDialect::getOrParseShapeLibrary(
+    function_ref<OwningOpRef<ModuleOp>()> parse) {
+  std::lock_guard<std::mutex> lock(shapeLibraryMutex);
+  if (!shapeLibrary && !shapeLibraryMergeFailed) {
+    shapeLibrary = parse();
+    if (shapeLibrary) {
+      shapeLibrarySymbolTable = std::make_unique<SymbolTable>(*shapeLibrary);
+      shapeLibraryMergeFailed = failed(mergeShapeLibraryExtensions());
+    }
+  }
+  if (shapeLibraryMergeFailed)
+    return nullptr;
+  return shapeLibrarySymbolTable.get();
+}
+
+// Returns whether `lhs` and `rhs` print the same, e.g. are the same function
+// imported twice.
+static bool printsTheSame(Operation *lhs, Operation *rhs) {
+  std::string lhsAsm, rhsAsm;
+  llvm::raw_string_ostream lhsStream(lhsAsm), rhsStream(rhsAsm);
+  lhs->print(lhsStream, OpPrintingFlags().useLocalScope());
+  rhs->print(rhsStream, OpPrintingFlags().useLocalScope());
+  return lhsStream.str() == rhsStream.str();
+}
+
+// Checks that the symbols of `functions` that are already in `symbolTable`
+// are the same there.
+static LogicalResult checkNoConflicts(ModuleOp functions,
+                                      SymbolTable &symbolTable) {
+  for (Operation &op : functions.getBody()->getOperations()) {
+    auto symbol = dyn_cast<SymbolOpInterface>(op);
+    if (!symbol)
+      continue;
+    Operation *existing = symbolTable.lookup(symbol.getName());
+    if (existing && !printsTheSame(&op, existing)) {
+      return op.emitError() << "shape function '" << symbol.getName()
+                            << "' differs from the one of the same name "
+                               "already in the shape library";
+    }
+  }
+  return success();
+}
+
+LogicalResult
+TorchDialect::addToShapeLibrary(OwningOpRef<ModuleOp> functions) {
+  std::lock_guard<std::mutex> lock(shapeLibraryMutex);
+  if (shapeLibrarySymbolTable) {
+    if (failed(checkNoConflicts(*functions, *shapeLibrarySymbolTable)))
+      return failure();
+  } else {
+    for (OwningOpRef<ModuleOp> &extension : shapeLibraryExtensions) {
+      SymbolTable extensionSymbolTable(*extension);
+      if (failed(checkNoConflicts(*functions, extensionSymbolTable)))
+        return failure();
+    }
+  }
+  shapeLibraryExtensions.push_back(std::move(functions));
+  if (shapeLibrary)
+    return mergeShapeLibraryExtensions();
+  return success();
+}
+
+LogicalResult TorchDialect::mergeShapeLibraryExtensions() {
+  // The extensions added before the shape library was parsed are only
+  // checked against it now.
+  for (OwningOpRef<ModuleOp> &extension : shapeLibraryExtensions) {
+    if (failed(checkNoConflicts(*extension, *shapeLibrarySymbolTable)))
+      return failure();
+  }
+  for (OwningOpRef<ModuleOp> &extension : shapeLibraryExtensions) {
+    for (Operation &op :
+         llvm::make_early_inc_range(extension->getBody()->getOperations())) {
+      auto symbol = dyn_cast<SymbolOpInterface>(op);
+      if (!symbol || shapeLibrarySymbolTable->lookup(symbol.getName()))
+        continue;
+      op.remove();
+      shapeLibrarySymbolTable->insert(&op);
+    }
+  }
+  shapeLibraryExtensions.clear();
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Dialect initialize method.
 //===----------------------------------------------------------------------===//
@@ -141,6 +224,30 @@ LogicalResult TorchDialect::verifyRegionArgAttribute(Operation *op,
     return success();
   }
 
+  if (namedAttr.getName().getValue() == "torch.expected_shape") {
+    auto func = dyn_cast<func::FuncOp>(op);
+    if (!func)
+      return op->emitError()
+             << "'torch.expected_shape' must be attached to a func";
+    auto attr = namedAttr.getValue().dyn_cast<ArrayAttr>();
+    if (!attr || !llvm::all_of(attr, [](Attribute size) {
+          return size.isa<IntegerAttr>();
+        }))
+      return op->emitError()
+             << "'torch.expected_shape' must be an array of integers";
+    if (!func.getFunctionType().getInput(argIndex).isa<BaseTensorType>())
+      return op->emitError() << "'torch.expected_shape' must be attached to "
+                                "an argument of !torch.tensor/!torch.vtensor "
+                                "type";
+    return success();
+  }
+
+  if (namedAttr.getName().getValue() == "torch.weight_name") {
+    if (!namedAttr.getValue().isa<StringAttr>())
+      return op->emitError() << "'torch.weight_name' must be StringAttr";
+    return success();
+  }
+
   return op->emitError() << "unknown region arg attribute '"
                          << namedAttr.getName().getValue() << "'";
 }
@@ -19,6 +19,7 @@
 #include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -672,6 +673,33 @@ OpFoldResult AtenToDtypeOp::fold(ArrayRef<Attribute> operands) {
   return getOperand(0);
 }
 
+//===----------------------------------------------------------------------===//
+// AtenContiguousOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult AtenContiguousOp::fold(ArrayRef<Attribute> operands) {
+  // Memory layout is not observable in value semantics, so `contiguous` of a
+  // value tensor is that tensor itself, whatever the memory format.
+  if (self().getType().isa<ValueTensorType>() && self().getType() == getType())
+    return self();
+  return nullptr;
+}
+
+//===----------------------------------------------------------------------===//
+// ValsemVariantAtenCopyOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult ValsemVariantAtenCopyOp::fold(ArrayRef<Attribute> operands) {
+  // The result is `src` broadcast to the shape of `self` and converted to its
+  // dtype. When `src` statically has the shape and dtype of the result, this
+  // doesn't change it.
+  auto srcType = src().getType().dyn_cast<ValueTensorType>();
+  if (!srcType || srcType != getType() || !srcType.hasDtype() ||
+      !srcType.areAllSizesKnown())
+    return nullptr;
+  return src();
+}
+
 //===----------------------------------------------------------------------===//
 // AtenToDtypeLayoutOp
 //===----------------------------------------------------------------------===//
@@ -832,6 +860,54 @@ void AtenAddTensorOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
   });
 }
 
+// Returns the int converted to a tensor by the `prim.NumToTensor.Scalar`
+// producing `v`, or nullptr.
+static Value getNumToTensorInt(Value v) {
+  auto numToTensor = v.getDefiningOp<PrimNumToTensorScalarOp>();
+  if (!numToTensor || !numToTensor.a().getType().isa<Torch::IntType>())
+    return nullptr;
+  return numToTensor.a();
+}
+
+//===----------------------------------------------------------------------===//
+// AtenSubTensorOp
+//===----------------------------------------------------------------------===//
+
+void AtenSubTensorOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
+                                                  MLIRContext *context) {
+  // `aten.sub.Tensor(NumToTensor(a), NumToTensor(b), alpha)` is canonicalized
+  // to `NumToTensor(aten.sub.int(a, aten.mul.int(b, alpha)))`.
+  patterns.add(+[](AtenSubTensorOp op, PatternRewriter &rewriter) {
+    Value lhs = getNumToTensorInt(op.self());
+    Value rhs = getNumToTensorInt(op.other());
+    if (!lhs || !rhs || !op.alpha().getType().isa<Torch::IntType>())
+      return rewriter.notifyMatchFailure(op, "expected int scalar operands");
+    Value mul = rewriter.create<AtenMulIntOp>(op.getLoc(), rhs, op.alpha());
+    Value sub = rewriter.create<AtenSubIntOp>(op.getLoc(), lhs, mul);
+    rewriter.replaceOpWithNewOp<PrimNumToTensorScalarOp>(op, op.getType(), sub);
+    return success();
+  });
+}
+
+//===----------------------------------------------------------------------===//
+// AtenMulTensorOp
+//===----------------------------------------------------------------------===//
+
+void AtenMulTensorOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
+                                                  MLIRContext *context) {
+  // `aten.mul.Tensor(NumToTensor(a), NumToTensor(b))` is canonicalized to
+  // `NumToTensor(aten.mul.int(a, b))`.
+  patterns.add(+[](AtenMulTensorOp op, PatternRewriter &rewriter) {
+    Value lhs = getNumToTensorInt(op.self());
+    Value rhs = getNumToTensorInt(op.other());
+    if (!lhs || !rhs)
+      return rewriter.notifyMatchFailure(op, "expected int scalar operands");
+    Value mul = rewriter.create<AtenMulIntOp>(op.getLoc(), lhs, rhs);
+    rewriter.replaceOpWithNewOp<PrimNumToTensorScalarOp>(op, op.getType(), mul);
+    return success();
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // AtenSizeOp
 //===----------------------------------------------------------------------===//
@@ -1141,7 +1217,7 @@ LogicalResult NonValueTensorLiteralOp::inferReturnTypes(
   RankedTensorType tensorType = attr.getType().cast<RankedTensorType>();
   NonValueTensorType returnType =
       NonValueTensorType::get(tensorType.getContext(), tensorType.getShape(),
-                              tensorType.getElementType());
+                              tensorType.getElementType(), tensorType.getEncoding());
   inferredReturnTypes.push_back(returnType);
   return success();
 }
@@ -1180,7 +1256,7 @@ LogicalResult ValueTensorLiteralOp::inferReturnTypes(
   RankedTensorType tensorType = attr.getType().cast<RankedTensorType>();
   ValueTensorType returnType =
       ValueTensorType::get(tensorType.getContext(), tensorType.getShape(),
-                           tensorType.getElementType());
+                           tensorType.getElementType(), tensorType.getEncoding());
   inferredReturnTypes.push_back(returnType);
   return success();
 }
@@ -1189,6 +1265,42 @@ OpFoldResult ValueTensorLiteralOp::fold(ArrayRef<Attribute> operands) {
   return valueAttr();
 }
 
+//===----------------------------------------------------------------------===//
+// ValueTensorExternalLiteralOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult ValueTensorExternalLiteralOp::verify() {
+  auto type = getType().cast<ValueTensorType>();
+  if (!type.hasSizes() || !type.hasDtype() ||
+      llvm::any_of(type.getSizes(),
+                   [](int64_t size) { return size == kUnknownSize; }))
+    return emitError() << "result type must have static sizes and a dtype";
+  if (!type.getDtype().isIntOrFloat() ||
+      type.getDtype().getIntOrFloatBitWidth() % 8 != 0)
+    return emitError() << "unsupported dtype " << type.getDtype();
+  if (offset() < 0)
+    return emitError() << "offset must be non-negative";
+  return success();
+}
+
+FailureOr<DenseElementsAttr>
+ValueTensorExternalLiteralOp::readElements(ShapedType type) {
+  int64_t numBytes =
+      type.getNumElements() * (type.getElementTypeBitWidth() / 8);
+  auto buffer = llvm::MemoryBuffer::getFileSlice(
+      file(), numBytes, offset(), /*IsVolatile=*/false);
+  if (std::error_code ec = buffer.getError()) {
+    return emitError() << "could not read " << numBytes << " bytes at offset "
+                       << offset() << " from '" << file()
+                       << "': " << ec.message();
+  }
+  ArrayRef<char> data((*buffer)->getBufferStart(),
+                      (*buffer)->getBufferSize());
+  if (static_cast<int64_t>(data.size()) != numBytes)
+    return emitError() << "file '" << file() << "' is too short";
+  return DenseElementsAttr::getFromRawBuffer(type, data);
+}
+
 //----------------------------------------------------------------------------//
 // TensorStaticInfoCast
 //----------------------------------------------------------------------------//
@@ -1641,13 +1753,72 @@ static OpFoldResult atenBinaryIntOperatorFoldHelper(OpTy op,
   return getI64IntegerAttr(op.getContext(), f(lhs, rhs));
 }
 
+// Returns true if `v` is a `torch.constant.int` of value `c`.
+static bool isConstantInt(Value v, int64_t c) {
+  int64_t value;
+  return matchPattern(v, m_TorchConstantInt(&value)) && value == c;
+}
+
+// Adds patterns canonicalizing the associative and commutative int op `OpTy`
+// so that chains of it with constants fold their constants together:
+//   op(c, x) -> op(x, c)
+//   op(op(x, c1), c2) -> op(x, op(c1, c2))
+template <typename OpTy>
+static void addAssociativeIntOpPatterns(RewritePatternSet &patterns) {
+  patterns.add(+[](OpTy op, PatternRewriter &rewriter) {
+    int64_t c;
+    bool lhsConstant = matchPattern(op.a(), m_TorchConstantInt(&c));
+    bool rhsConstant = matchPattern(op.b(), m_TorchConstantInt(&c));
+    if (lhsConstant && !rhsConstant) {
+      rewriter.replaceOpWithNewOp<OpTy>(op, op.b(), op.a());
+      return success();
+    }
+    auto inner = op.a().template getDefiningOp<OpTy>();
+    if (!rhsConstant || !inner ||
+        !matchPattern(inner.b(), m_TorchConstantInt(&c)))
+      return rewriter.notifyMatchFailure(op, "expected op(op(x, c1), c2)");
+    Value constant = rewriter.create<OpTy>(op.getLoc(), inner.b(), op.b());
+    rewriter.replaceOpWithNewOp<OpTy>(op, inner.a(), constant);
+    return success();
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // AtenFloordivIntOp
 //===----------------------------------------------------------------------===//
 
 OpFoldResult AtenFloordivIntOp::fold(ArrayRef<Attribute> operands) {
-  return atenBinaryIntOperatorFoldHelper(
-      *this, [](int64_t a, int64_t b) { return std::floor(a / (double)b); });
+  if (isConstantInt(b(), 1))
+    return a();
+  // Division by zero raises an error at runtime, so it is not folded.
+  if (isConstantInt(b(), 0))
+    return nullptr;
+  return atenBinaryIntOperatorFoldHelper(*this, [](int64_t a, int64_t b) {
+    // Python rounds the quotient towards negative infinity.
+    int64_t quotient = a / b;
+    if (a % b != 0 && ((a < 0) != (b < 0)))
+      quotient--;
+    return quotient;
+  });
+}
+
+void AtenFloordivIntOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
+                                                    MLIRContext *context) {
+  // `(x * c1) // c2` is canonicalized to `x * (c1 / c2)` when `c2` divides
+  // `c1`, which removes the multiply-then-divide round trips of view shape
+  // computations.
+  patterns.add(+[](AtenFloordivIntOp op, PatternRewriter &rewriter) {
+    auto mul = op.a().getDefiningOp<AtenMulIntOp>();
+    int64_t factor, divisor;
+    if (!mul || !matchPattern(mul.b(), m_TorchConstantInt(&factor)) ||
+        !matchPattern(op.b(), m_TorchConstantInt(&divisor)) || divisor == 0 ||
+        factor % divisor != 0)
+      return rewriter.notifyMatchFailure(op, "expected (x * c1) // c2");
+    Value quotient = rewriter.create<Torch::ConstantIntOp>(
+        op.getLoc(), rewriter.getI64IntegerAttr(factor / divisor));
+    rewriter.replaceOpWithNewOp<AtenMulIntOp>(op, mul.a(), quotient);
+    return success();
+  });
 }
 
 //===----------------------------------------------------------------------===//
@@ -1655,8 +1826,17 @@ OpFoldResult AtenFloordivIntOp::fold(ArrayRef<Attribute> operands) {
 //===----------------------------------------------------------------------===//
 
 OpFoldResult AtenRemainderIntOp::fold(ArrayRef<Attribute> operands) {
-  return atenBinaryIntOperatorFoldHelper(
-      *this, [](int64_t a, int64_t b) { return a % b; });
+  if (isConstantInt(b(), 1))
+    return getI64IntegerAttr(getContext(), 0);
+  if (isConstantInt(b(), 0))
+    return nullptr;
+  return atenBinaryIntOperatorFoldHelper(*this, [](int64_t a, int64_t b) {
+    // Python gives the remainder the sign of the divisor.
+    int64_t remainder = a % b;
+    if (remainder != 0 && ((remainder < 0) != (b < 0)))
+      remainder += b;
+    return remainder;
+  });
 }
 
 //===----------------------------------------------------------------------===//
@@ -1664,15 +1844,28 @@ OpFoldResult AtenRemainderIntOp::fold(ArrayRef<Attribute> operands) {
 //===----------------------------------------------------------------------===//
 
 OpFoldResult AtenAddIntOp::fold(ArrayRef<Attribute> operands) {
+  if (isConstantInt(b(), 0))
+    return a();
+  if (isConstantInt(a(), 0))
+    return b();
   return atenBinaryIntOperatorFoldHelper(
       *this, [](int64_t a, int64_t b) { return a + b; });
 }
 
+void AtenAddIntOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
+                                               MLIRContext *context) {
+  addAssociativeIntOpPatterns<AtenAddIntOp>(patterns);
+}
+
 //===----------------------------------------------------------------------===//
 // AtenSubIntOp
 //===----------------------------------------------------------------------===//
 
 OpFoldResult AtenSubIntOp::fold(ArrayRef<Attribute> operands) {
+  if (isConstantInt(b(), 0))
+    return a();
+  if (a() == b())
+    return getI64IntegerAttr(getContext(), 0);
   return atenBinaryIntOperatorFoldHelper(
       *this, [](int64_t a, int64_t b) { return a - b; });
 }
@@ -1689,9 +1882,18 @@ OpFoldResult AtenMulIntOp::fold(ArrayRef<Attribute> operands) {
     return getI64IntegerAttr(getContext(), 0);
   if (lConstant && rConstant)
     return getI64IntegerAttr(getContext(), lhs * rhs);
+  if (rConstant && rhs == 1)
+    return getOperand(0);
+  if (lConstant && lhs == 1)
+    return getOperand(1);
   return nullptr;
 }
 
+void AtenMulIntOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
+                                               MLIRContext *context) {
+  addAssociativeIntOpPatterns<AtenMulIntOp>(patterns);
+}
+
 //===----------------------------------------------------------------------===//
 // AtenNegIntOp
 //===----------------------------------------------------------------------===//
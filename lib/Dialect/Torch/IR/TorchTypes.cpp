@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "torch-mlir/Dialect/Torch/IR/TorchTypes.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
 #include "mlir/IR/DialectImplementation.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
@@ -77,6 +78,13 @@ bool Torch::isValidSubtype(Type subtype, Type type) {
   if (subtype.isa<ValueTensorType>() && type.isa<ValueTensorType>() &&
       type == ValueTensorType::getWithLeastStaticInformation(type.getContext()))
     return true;
+
+  // A tensor type without a sparsity holds tensors of any layout.
+  if (auto tensorSubtype = subtype.dyn_cast<BaseTensorType>()) {
+    if (tensorSubtype.hasSparsity() && type.isa<BaseTensorType>() &&
+        !type.cast<BaseTensorType>().hasSparsity())
+      return isValidSubtype(tensorSubtype.getWithSparsity(Attribute()), type);
+  }
   return false;
 }
 
@@ -188,6 +196,17 @@ Type BaseTensorType::getWithSizesAndDtype(
   llvm_unreachable("not a BaseTensorType!");
 }
 
+BaseTensorType
+BaseTensorType::getWithSparsity(Attribute optionalSparsity) const {
+  if (isa<NonValueTensorType>())
+    return NonValueTensorType::get(getContext(), getOptionalSizes(),
+                                   getOptionalDtype(), optionalSparsity);
+  if (isa<ValueTensorType>())
+    return ValueTensorType::get(getContext(), getOptionalSizes(),
+                                getOptionalDtype(), optionalSparsity);
+  llvm_unreachable("not a BaseTensorType!");
+}
+
 ValueTensorType BaseTensorType::getWithValueSemantics() const {
   if (auto tensor = dyn_cast<NonValueTensorType>())
     return tensor.getWithValueSemantics();
@@ -199,12 +218,27 @@ ValueTensorType BaseTensorType::getWithValueSemantics() const {
 static LogicalResult
 verifyTensorType(function_ref<InFlightDiagnostic()> emitError,
                  Optional<ArrayRef<int64_t>> optionalSizes,
-                 Type optionalDtype) {
+                 Type optionalDtype, Attribute optionalSparsity) {
   if (optionalDtype && !isValidTorchDtype(optionalDtype)) {
     emitError() << "invalid dtype " << optionalDtype
                 << " for !torch.tensor type";
     return failure();
   }
+  if (optionalSparsity) {
+    auto encoding =
+        optionalSparsity.dyn_cast<sparse_tensor::SparseTensorEncodingAttr>();
+    if (!encoding) {
+      emitError() << "invalid sparsity " << optionalSparsity
+                  << " for !torch.tensor type";
+      return failure();
+    }
+    if (!optionalSizes ||
+        encoding.getDimLevelType().size() != optionalSizes->size()) {
+      emitError() << "sparsity " << optionalSparsity
+                  << " requires sizes of the same rank";
+      return failure();
+    }
+  }
   return success();
 }
 
@@ -213,7 +247,8 @@ Type parseTensorType(MLIRContext *context, AsmParser &parser,
   llvm::SMLoc startLoc = parser.getCurrentLocation();
   if (parser.parseOptionalLess())
     return getTensorType(context,
-                         /*optionalSizes=*/None, /*optionalDtype=*/Type());
+                         /*optionalSizes=*/None, /*optionalDtype=*/Type(),
+                         /*optionalSparsity=*/Attribute());
   bool hasSizes;
   SmallVector<int64_t> sizes;
   if (succeeded(parser.parseOptionalStar())) {
@@ -258,6 +293,11 @@ Type parseTensorType(MLIRContext *context, AsmParser &parser,
     if (parser.parseType(optionalDtype))
       return Type();
   }
+  Attribute optionalSparsity;
+  if (succeeded(parser.parseOptionalComma())) {
+    if (parser.parseAttribute(optionalSparsity))
+      return Type();
+  }
   if (parser.parseGreater())
     return Type();
   Optional<ArrayRef<int64_t>> optionalSizes;
@@ -265,16 +305,16 @@ Type parseTensorType(MLIRContext *context, AsmParser &parser,
     optionalSizes.emplace(sizes);
 
   if (failed(verifyTensorType([&]() { return parser.emitError(startLoc); },
-                              optionalSizes, optionalDtype)))
+                              optionalSizes, optionalDtype, optionalSparsity)))
     return Type();
 
-  return getTensorType(context, optionalSizes, optionalDtype);
+  return getTensorType(context, optionalSizes, optionalDtype, optionalSparsity);
 }
 
 static void printTensorType(AsmPrinter &printer,
                             Optional<ArrayRef<int64_t>> optionalSizes,
-                            Type optionalDtype) {
-  if (!optionalSizes && !optionalDtype)
+                            Type optionalDtype, Attribute optionalSparsity) {
+  if (!optionalSizes && !optionalDtype && !optionalSparsity)
     return;
   printer << "<";
   if (optionalSizes) {
@@ -296,6 +336,10 @@ static void printTensorType(AsmPrinter &printer,
     printer.printType(optionalDtype);
   else
     printer << "unk";
+  if (optionalSparsity) {
+    printer << ",";
+    printer.printAttribute(optionalSparsity);
+  }
   printer << ">";
 }
 
@@ -305,7 +349,7 @@ static void printTensorType(AsmPrinter &printer,
 
 ValueTensorType NonValueTensorType::getWithValueSemantics() const {
   return ValueTensorType::get(getContext(), getOptionalSizes(),
-                              getOptionalDtype());
+                              getOptionalDtype(), getOptionalSparsity());
 }
 
 NonValueTensorType
@@ -318,8 +362,9 @@ NonValueTensorType::getWithLeastStaticInformation(MLIRContext *context) {
 LogicalResult
 NonValueTensorType::verify(function_ref<InFlightDiagnostic()> emitError,
                            Optional<ArrayRef<int64_t>> optionalSizes,
-                           Type optionalDtype) {
-  return verifyTensorType(emitError, optionalSizes, optionalDtype);
+                           Type optionalDtype, Attribute optionalSparsity) {
+  return verifyTensorType(emitError, optionalSizes, optionalDtype,
+                          optionalSparsity);
 }
 
 Type NonValueTensorType::parse(AsmParser &parser) {
@@ -327,13 +372,15 @@ Type NonValueTensorType::parse(AsmParser &parser) {
   return parseTensorType(
       context, parser,
       [](MLIRContext *context, Optional<ArrayRef<int64_t>> optionalSizes,
-         Type optionalType) {
-        return NonValueTensorType::get(context, optionalSizes, optionalType);
+         Type optionalType, Attribute optionalSparsity) {
+        return NonValueTensorType::get(context, optionalSizes, optionalType,
+                                       optionalSparsity);
       });
 }
 
 void NonValueTensorType::print(AsmPrinter &printer) const {
-  printTensorType(printer, getOptionalSizes(), getOptionalDtype());
+  printTensorType(printer, getOptionalSizes(), getOptionalDtype(),
+                  getOptionalSparsity());
 }
 
 //===----------------------------------------------------------------------===//
@@ -342,7 +389,7 @@ void NonValueTensorType::print(AsmPrinter &printer) const {
 
 NonValueTensorType ValueTensorType::getWithoutValueSemantics() const {
   return NonValueTensorType::get(getContext(), getOptionalSizes(),
-                                 getOptionalDtype());
+                                 getOptionalDtype(), getOptionalSparsity());
 }
 
 ValueTensorType
@@ -358,6 +405,10 @@ static Type convertDtypeToBuiltinElementType(MLIRContext *context, Type dtype) {
   } else if (auto integerType = dtype.dyn_cast<IntegerType>()) {
     return IntegerType::get(context, integerType.getWidth(),
                             IntegerType::Signless);
+  } else if (dtype.isa<Torch::QInt8Type, Torch::QUInt8Type>()) {
+    // Quantized tensors are represented by their integer representation. Their
+    // scale and zero point are operands of the ops producing them.
+    return IntegerType::get(context, 8);
   }
   emitError(UnknownLoc::get(context))
       << "unimplemented: conversion of dtype " << dtype
@@ -373,14 +424,15 @@ TensorType ValueTensorType::toBuiltinTensor() const {
   Type elementType = convertDtypeToBuiltinElementType(getContext(), getDtype());
   if (!elementType)
     return nullptr;
-  return RankedTensorType::get(getSizes(), elementType);
+  return RankedTensorType::get(getSizes(), elementType, getOptionalSparsity());
 }
 
 LogicalResult
 ValueTensorType::verify(function_ref<InFlightDiagnostic()> emitError,
                         Optional<ArrayRef<int64_t>> optionalSizes,
-                        Type optionalDtype) {
-  return verifyTensorType(emitError, optionalSizes, optionalDtype);
+                        Type optionalDtype, Attribute optionalSparsity) {
+  return verifyTensorType(emitError, optionalSizes, optionalDtype,
+                          optionalSparsity);
 }
 
 Type ValueTensorType::parse(AsmParser &parser) {
@@ -388,13 +440,15 @@ Type ValueTensorType::parse(AsmParser &parser) {
   return parseTensorType(
       context, parser,
       [](MLIRContext *context, Optional<ArrayRef<int64_t>> optionalSizes,
-         Type optionalType) {
-        return ValueTensorType::get(context, optionalSizes, optionalType);
+         Type optionalType, Attribute optionalSparsity) {
+        return ValueTensorType::get(context, optionalSizes, optionalType,
+                                       optionalSparsity);
       });
 }
 
 void ValueTensorType::print(AsmPrinter &printer) const {
-  printTensorType(printer, getOptionalSizes(), getOptionalDtype());
+  printTensorType(printer, getOptionalSizes(), getOptionalDtype(),
+                  getOptionalSparsity());
 }
 
 Type Torch::meetTensorTypes(BaseTensorType lhs, BaseTensorType rhs) {
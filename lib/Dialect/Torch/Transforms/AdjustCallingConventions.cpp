@@ -18,6 +18,8 @@
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "llvm/ADT/MapVector.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -261,11 +263,106 @@ static LogicalResult adjustCallingConventions(func::FuncOp func,
   return success();
 }
 
+// Returns the literal that the tensor global slot `globalSlot` is
+// initialized with if it holds a weight: a tensor that the program never
+// sets nor mutates. Returns null otherwise.
+static NonValueTensorLiteralOp getWeightLiteral(GlobalSlotOp globalSlot,
+                                                ModuleOp module) {
+  if (!globalSlot.typeBound().isa<NonValueTensorType>())
+    return nullptr;
+  auto init = cast<GlobalSlotInitOp>(globalSlot.getBody()->getTerminator());
+  auto literal = init.initialValue().getDefiningOp<NonValueTensorLiteralOp>();
+  if (!literal)
+    return nullptr;
+  Optional<SymbolTable::UseRange> uses =
+      SymbolTable::getSymbolUses(globalSlot, module);
+  if (!uses)
+    return nullptr;
+  for (const SymbolTable::SymbolUse &use : *uses) {
+    auto get = dyn_cast<GlobalSlotGetOp>(use.getUser());
+    if (!get || isMutatedInPlace(get.result()))
+      return nullptr;
+  }
+  return literal;
+}
+
+// Replaces the reads of the weights of `module` in its public functions by
+// new arguments of these functions, appended in the order of the slots and
+// annotated with the names of the slots, and erases the weights.
+static LogicalResult liftWeightsToArguments(ModuleOp module) {
+  llvm::MapVector<StringAttr, ValueTensorType> weights;
+  for (auto globalSlot : module.getOps<GlobalSlotOp>())
+    if (NonValueTensorLiteralOp literal =
+            getWeightLiteral(globalSlot, module)) {
+      // The type of the literal may be less refined than its value.
+      auto type = literal.valueAttr().getType().cast<RankedTensorType>();
+      weights[globalSlot.sym_nameAttr()] = ValueTensorType::get(
+          module.getContext(), type.getShape(), type.getElementType());
+    }
+  if (weights.empty())
+    return success();
+
+  for (auto func : module.getOps<func::FuncOp>()) {
+    DenseMap<StringAttr, SmallVector<GlobalSlotGetOp>> reads;
+    func.walk([&](GlobalSlotGetOp get) {
+      if (weights.count(get.slotAttr().getAttr()))
+        reads[get.slotAttr().getAttr()].push_back(get);
+    });
+    if (reads.empty())
+      continue;
+    if (func.isPrivate())
+      return func.emitError("unimplemented: weights read in a private "
+                            "function, which must be inlined first");
+
+    Block &entryBlock = func.getBody().front();
+    OpBuilder b(func.getContext());
+    for (auto &weight : weights) {
+      auto it = reads.find(weight.first);
+      if (it == reads.end())
+        continue;
+      unsigned index = func.getNumArguments();
+      func.insertArgument(index, weight.second,
+                          b.getDictionaryAttr(b.getNamedAttr(
+                              "torch.weight_name", weight.first)),
+                          func.getLoc());
+      b.setInsertionPointToStart(&entryBlock);
+      Value tensor = b.create<CopyToNonValueTensorOp>(
+          func.getLoc(), func.getArgument(index));
+      for (GlobalSlotGetOp get : it->second) {
+        Value replacement = tensor;
+        if (replacement.getType() != get.getType()) {
+          b.setInsertionPoint(get);
+          replacement = b.create<TensorStaticInfoCastOp>(
+              get.getLoc(), get.getType(), replacement);
+        }
+        get.replaceAllUsesWith(replacement);
+        get.erase();
+      }
+    }
+  }
+
+  SymbolTable symbolTable(module);
+  for (auto &weight : weights) {
+    Operation *globalSlot = symbolTable.lookup(weight.first);
+    if (SymbolTable::symbolKnownUseEmpty(globalSlot, module))
+      globalSlot->erase();
+  }
+  return success();
+}
+
 namespace {
 class AdjustCallingConventionsPass
     : public AdjustCallingConventionsBase<AdjustCallingConventionsPass> {
+public:
+  AdjustCallingConventionsPass() = default;
+  AdjustCallingConventionsPass(bool weightsAsArguments) {
+    this->weightsAsArguments = weightsAsArguments;
+  }
+
   void runOnOperation() override {
     auto module = getOperation();
+    if (weightsAsArguments && failed(liftWeightsToArguments(module)))
+      return signalPassFailure();
     TypeBoundMap typeBoundMap;
     for (auto func : module.getOps<func::FuncOp>()) {
       for (int i = 0, e = func.getNumArguments(); i != e; i++) {
@@ -285,6 +382,7 @@ class AdjustCallingConventionsPass
 } // namespace
 
 std::unique_ptr<OperationPass<ModuleOp>>
-mlir::torch::Torch::createAdjustCallingConventionsPass() {
-  return std::make_unique<AdjustCallingConventionsPass>();
+mlir::torch::Torch::createAdjustCallingConventionsPass(
+    bool weightsAsArguments) {
+  return std::make_unique<AdjustCallingConventionsPass>(weightsAsArguments);
 }
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+static bool isF32Tensor(Value v) {
+  auto type = v.getType().dyn_cast<ValueTensorType>();
+  return type && type.hasDtype() && type.getDtype().isF32();
+}
+
+namespace {
+// Computes a matmul or convolution of f32 tensors in `lowPrecisionType`:
+//   op(a, b) -> to.dtype(op(to.dtype(a, bf16), to.dtype(b, bf16)), f32)
+// The backends accumulate the products of such ops in f32, so only the
+// operands and the result are rounded.
+class CastMatmulAndConvToLowPrecision : public RewritePattern {
+public:
+  CastMatmulAndConvToLowPrecision(MLIRContext *context, Type lowPrecisionType)
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context),
+        lowPrecisionType(lowPrecisionType) {}
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    if (!isa<AtenMmOp, AtenBmmOp, AtenMatmulOp, AtenLinearOp,
+             AtenConvolutionOp, AtenConv2dOp>(op))
+      return rewriter.notifyMatchFailure(op, "expected matmul or convolution");
+    Value result = op->getResult(0);
+    if (!isF32Tensor(result))
+      return rewriter.notifyMatchFailure(op, "expected f32 result");
+
+    Location loc = op->getLoc();
+    SmallVector<Value> newOperands;
+    for (Value operand : op->getOperands()) {
+      if (isF32Tensor(operand))
+        operand =
+            convertTensorToDtype(rewriter, loc, operand, lowPrecisionType);
+      newOperands.push_back(operand);
+    }
+    auto resultType = result.getType().cast<ValueTensorType>();
+    Type newResultType = resultType.getWithSizesAndDtype(
+        resultType.getSizes(), lowPrecisionType);
+    Operation *newOp =
+        rewriter.create(loc, op->getName().getIdentifier(), newOperands,
+                        newResultType, op->getAttrs());
+    rewriter.replaceOp(op, convertTensorToDtype(rewriter, loc,
+                                                newOp->getResult(0),
+                                                resultType.getDtype()));
+    return success();
+  }
+
+private:
+  Type lowPrecisionType;
+};
+} // namespace
+
+namespace {
+// Folds `to.dtype(to.dtype(x, f32), dtype(x))` into `x` for a 16-bit float
+// `x`, which is exact since f32 represents all the bf16 and f16 values. This
+// keeps the result of a matmul feeding another one in low precision.
+class FoldLowPrecisionRoundTrip : public OpRewritePattern<AtenToDtypeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(AtenToDtypeOp op,
+                                PatternRewriter &rewriter) const override {
+    auto producer = op.self().getDefiningOp<AtenToDtypeOp>();
+    if (!producer || !isF32Tensor(producer.getResult()))
+      return rewriter.notifyMatchFailure(op, "expected cast from f32");
+    Value input = producer.self();
+    auto inputType = input.getType().dyn_cast<ValueTensorType>();
+    if (!inputType || !inputType.hasDtype() ||
+        !(inputType.getDtype().isBF16() || inputType.getDtype().isF16()) ||
+        inputType != op.getType())
+      return rewriter.notifyMatchFailure(
+          op, "expected round trip of a 16-bit float tensor through f32");
+    rewriter.replaceOp(op, input);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class AutoCastPass : public AutoCastBase<AutoCastPass> {
+public:
+  AutoCastPass() = default;
+  AutoCastPass(StringRef dtype) { this->dtype = dtype.str(); }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    Type lowPrecisionType;
+    if (dtype == "bf16") {
+      lowPrecisionType = mlir::FloatType::getBF16(context);
+    } else if (dtype == "f16") {
+      lowPrecisionType = mlir::FloatType::getF16(context);
+    } else {
+      getOperation().emitError() << "unsupported auto-cast dtype '" << dtype
+                                 << "', expected 'bf16' or 'f16'";
+      return signalPassFailure();
+    }
+
+    RewritePatternSet patterns(context);
+    patterns.add<CastMatmulAndConvToLowPrecision>(context, lowPrecisionType);
+    patterns.add<FoldLowPrecisionRoundTrip>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createAutoCastPass(StringRef dtype) {
+  return std::make_unique<AutoCastPass>(dtype);
+}
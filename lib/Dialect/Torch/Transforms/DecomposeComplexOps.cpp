@@ -221,6 +221,87 @@ public:
 };
 } // namespace
 
+namespace {
+// Decompose `aten.select_scatter` into an `aten.slice_scatter` of the
+// unsqueezed `src` over the single index it selects.
+class DecomposeAtenSelectScatterOp
+    : public OpRewritePattern<AtenSelectScatterOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(AtenSelectScatterOp op,
+                                PatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto selfType = op.self().getType().cast<BaseTensorType>();
+    if (!selfType.hasSizes())
+      return rewriter.notifyMatchFailure(op, "unimplemented: unranked self");
+    ArrayRef<int64_t> selfSizes = selfType.getSizes();
+    int64_t dim, index;
+    if (!matchPattern(op.dim(), m_TorchConstantInt(&dim)))
+      return rewriter.notifyMatchFailure(op, "dim must be constant");
+    dim = toPositiveDim(dim, selfSizes.size());
+    if (!isValidDim(dim, selfSizes.size()))
+      return rewriter.notifyMatchFailure(op, "dim is statically invalid");
+    // A negative index needs the size of `dim` to be made positive, since
+    // `index + 1` doesn't end the slice for `index` = -1.
+    bool isConstantIndex = matchPattern(op.index(), m_TorchConstantInt(&index));
+    if (isConstantIndex && index < 0 && selfSizes[dim] != kUnknownSize)
+      index += selfSizes[dim];
+
+    auto srcType = op.src().getType().cast<BaseTensorType>();
+    Type unsqueezedSrcType;
+    if (srcType.hasSizes()) {
+      SmallVector<int64_t> unsqueezedSizes(srcType.getSizes().begin(),
+                                           srcType.getSizes().end());
+      unsqueezedSizes.insert(unsqueezedSizes.begin() + dim, 1);
+      unsqueezedSrcType = srcType.getWithSizesAndDtype(
+          unsqueezedSizes, srcType.getOptionalDtype());
+    } else {
+      unsqueezedSrcType =
+          srcType.getWithSizesAndDtype(None, srcType.getOptionalDtype());
+    }
+    Value cstDim =
+        rewriter.create<ConstantIntOp>(loc, rewriter.getI64IntegerAttr(dim));
+    Value unsqueezedSrc = rewriter.create<AtenUnsqueezeOp>(
+        loc, unsqueezedSrcType, op.src(), cstDim);
+    Value one =
+        rewriter.create<ConstantIntOp>(loc, rewriter.getI64IntegerAttr(1));
+    Value start;
+    if (isConstantIndex && index >= 0) {
+      start = rewriter.create<ConstantIntOp>(loc,
+                                             rewriter.getI64IntegerAttr(index));
+    } else {
+      // The index isn't known to be non-negative, e.g. the index of a loop
+      // imported from `x[:, i] = y`. Normalize it at runtime:
+      //   start = index + size(self, dim) if index < 0 else index
+      Value zero =
+          rewriter.create<ConstantIntOp>(loc, rewriter.getI64IntegerAttr(0));
+      Value isNegative = rewriter.create<AtenGtIntOp>(loc, zero, op.index());
+      Type intType = rewriter.getType<Torch::IntType>();
+      auto primIf = rewriter.create<PrimIfOp>(loc, intType, isNegative);
+      {
+        Region &thenRegion = primIf.thenRegion();
+        rewriter.createBlock(&thenRegion, thenRegion.end());
+        Value dimSize = rewriter.create<AtenSizeIntOp>(loc, op.self(), cstDim);
+        Value positiveIndex =
+            rewriter.create<AtenAddIntOp>(loc, intType, op.index(), dimSize);
+        rewriter.create<PrimIfYieldOp>(loc, positiveIndex);
+      }
+      {
+        Region &elseRegion = primIf.elseRegion();
+        rewriter.createBlock(&elseRegion, elseRegion.end());
+        rewriter.create<PrimIfYieldOp>(loc, op.index());
+      }
+      rewriter.setInsertionPointAfter(primIf);
+      start = primIf.getResult(0);
+    }
+    Value end = rewriter.create<AtenAddIntOp>(loc, one.getType(), start, one);
+    rewriter.replaceOpWithNewOp<AtenSliceScatterOp>(
+        op, op.getType(), op.self(), unsqueezedSrc, cstDim, start, end, one);
+    return success();
+  }
+};
+} // namespace
+
 namespace {
 class DecomposeAtenZeroFunctionalOp
     : public OpRewritePattern<AtenZeroFunctionalOp> {
@@ -442,12 +523,15 @@ public:
 };
 } // namespace
 
-// Decompose `AtenArgMaxOp` into `AtenMaxDimOp`.
+// Decompose `AtenArgmaxOp` into `AtenMaxDimOp`, and `AtenArgminOp` into
+// `AtenMinDimOp`. Both are lowered to a single reduction computing the values
+// and the indices together, so only the indices are used.
 namespace {
-class DecomposeAtenArgMaxOp : public OpRewritePattern<AtenArgmaxOp> {
+template <typename OpTy, typename DimOpTy>
+class DecomposeAtenArgMinMaxOp : public OpRewritePattern<OpTy> {
 public:
-  using OpRewritePattern::OpRewritePattern;
-  LogicalResult matchAndRewrite(AtenArgmaxOp op,
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+  LogicalResult matchAndRewrite(OpTy op,
                                 PatternRewriter &rewriter) const override {
     Location loc = op.getLoc();
     Value input = op.self();
@@ -467,7 +551,7 @@ public:
             .cast<BaseTensorType>();
 
     // If the dim type is `NoneType` i.e. reduce along all the dimensions.
-    // `AtenMaxDimOp` doesn't support dim as `NoneType` so first the input
+    // `DimOpTy` doesn't support dim as `NoneType` so first the input
     // tensor is flattened to 1d tensor and then the reduction happens on the
     // 0th dimension.
     if (dim.getType().isa<Torch::NoneType>()) {
@@ -480,13 +564,13 @@ public:
       input = rewriter.create<AtenFlattenUsingIntsOp>(loc, flattenType, input,
                                                       dim, end);
     }
-    Value maxResult =
+    Value indices =
         rewriter
-            .create<AtenMaxDimOp>(loc, valueTensorType, indicesTensorType,
-                                  input, dim, keepDim)
+            .create<DimOpTy>(loc, valueTensorType, indicesTensorType, input,
+                             dim, keepDim)
             .indices();
 
-    rewriter.replaceOp(op, maxResult);
+    rewriter.replaceOp(op, indices);
     return success();
   }
 };
@@ -1897,6 +1981,22 @@ public:
 };
 } // namespace
 
+// Returns whether `op` pools spatial dims of unknown size to a single
+// element, whose window is only known at runtime. Backends lowering the op
+// directly need static spatial dims, so this case is always decomposed.
+static bool isDynamicUnitAdaptiveAvgPool2d(AtenAdaptiveAvgPool2dOp op) {
+  SmallVector<int64_t> outputSize;
+  if (!matchPattern(op.output_size(), m_TorchConstantIntList(outputSize)) ||
+      !llvm::all_of(outputSize, [](int64_t size) { return size == 1; }))
+    return false;
+  auto inputType = op.self().getType().cast<BaseTensorType>();
+  if (!inputType.hasSizes())
+    return true;
+  ArrayRef<int64_t> inputShape = inputType.getSizes();
+  return inputShape.size() < 2 ||
+         llvm::is_contained(inputShape.take_back(2), kUnknownSize);
+}
+
 namespace {
 // Decompose `aten.adaptive_avg_pool2d` op into `aten.avg_pool2d` op.
 //
@@ -2104,6 +2204,11 @@ class DecomposeAtenNumpyTOp : public OpRewritePattern<AtenNumpyTOp> {
 namespace {
 class DecomposeComplexOpsPass
     : public DecomposeComplexOpsBase<DecomposeComplexOpsPass> {
+public:
+  DecomposeComplexOpsPass() = default;
+  DecomposeComplexOpsPass(ArrayRef<std::string> legalOps) {
+    this->legalOps = legalOps;
+  }
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
@@ -2152,12 +2257,18 @@ class DecomposeComplexOpsPass
     target.addIllegalOp<AtenMeanDimOp>();
     patterns.add<DecomposeAtenSelectIntOp>(context);
     target.addIllegalOp<AtenSelectIntOp>();
+    patterns.add<DecomposeAtenSelectScatterOp>(context);
+    target.addIllegalOp<AtenSelectScatterOp>();
     patterns.add<DecomposeAtenMatmulOp>(context);
     target.addIllegalOp<AtenTOp>();
     patterns.add<DecomposeAtenTOp>(context);
     patterns.add<DecomposeAten_LogSoftmaxBackwardDataOp>(context);
     target.addIllegalOp<Aten_LogSoftmaxBackwardDataOp>();
     target.addDynamicallyLegalOp<AtenMatmulOp>([](AtenMatmulOp op) {
+      // The matmuls of an attention subgraph are kept for TorchToTMTensor,
+      // which lowers the whole subgraph.
+      if (isAttentionMatmul(op))
+        return true;
       int lhsRank = getTensorRank(op.self());
       int rhsRank = getTensorRank(op.other());
 
@@ -2172,7 +2283,14 @@ class DecomposeComplexOpsPass
     target.addIllegalOp<AtenAddcdivOp>();
     target.addIllegalOp<AtenLayerNormOp>();
     patterns.add<DecomposeAtenLayerNormOp>(context);
-    target.addIllegalOp<AtenNativeBatchNormOp>();
+    // Batch norms in training mode are lowered as a whole, computing the
+    // batch stats in a single pass over the input.
+    target.addDynamicallyLegalOp<AtenNativeBatchNormOp>(
+        [](AtenNativeBatchNormOp op) {
+          bool training;
+          return matchPattern(op.training(), m_TorchConstantBool(&training)) &&
+                 training;
+        });
     patterns.add<DecomposeAtenNativeBatchNormOp>(context);
     target.addIllegalOp<AtenConvolutionOverrideableOp>();
     patterns.add<DecomposeAtenConvolutionOverrideableOp>(context);
@@ -2182,8 +2300,12 @@ class DecomposeComplexOpsPass
     target.addIllegalOp<AtenArangeOp>();
     patterns.add<DecomposeAtenArangeStartOp>(context);
     target.addIllegalOp<AtenArangeStartOp>();
-    patterns.add<DecomposeAtenArgMaxOp>(context);
+    patterns.add<DecomposeAtenArgMinMaxOp<AtenArgmaxOp, AtenMaxDimOp>>(
+        context);
     target.addIllegalOp<AtenArgmaxOp>();
+    patterns.add<DecomposeAtenArgMinMaxOp<AtenArgminOp, AtenMinDimOp>>(
+        context);
+    target.addIllegalOp<AtenArgminOp>();
     patterns.add<DecomposeAtenSquareOp>(context);
     target.addIllegalOp<AtenSquareOp>();
     patterns.add<DecomposeAtenVarOp>(context);
@@ -2251,6 +2373,24 @@ class DecomposeComplexOpsPass
     patterns.add<DecomposeAtenNumpyTOp>(context);
     target.addIllegalOp<AtenNumpyTOp>();
 
+    // Ops that the backend handles directly are left alone. A misspelled name
+    // would silently keep the op decomposed, so unknown names are errors.
+    for (std::string opName : legalOps) {
+      OperationName name(opName, context);
+      if (!name.isRegistered()) {
+        getOperation().emitError() << "unknown op '" << opName
+                                   << "' in legal-ops";
+        return signalPassFailure();
+      }
+      target.addLegalOp(name);
+    }
+    if (llvm::is_contained(legalOps,
+                           AtenAdaptiveAvgPool2dOp::getOperationName().str()))
+      target.addDynamicallyLegalOp<AtenAdaptiveAvgPool2dOp>(
+          [](AtenAdaptiveAvgPool2dOp op) {
+            return !isDynamicUnitAdaptiveAvgPool2d(op);
+          });
+
     if (failed(applyPartialConversion(getOperation(), target,
                                       std::move(patterns)))) {
       return signalPassFailure();
@@ -2259,6 +2399,7 @@ class DecomposeComplexOpsPass
 };
 } // namespace
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::torch::Torch::createDecomposeComplexOpsPass() {
-  return std::make_unique<DecomposeComplexOpsPass>();
+mlir::torch::Torch::createDecomposeComplexOpsPass(
+    ArrayRef<std::string> legalOps) {
+  return std::make_unique<DecomposeComplexOpsPass>(legalOps);
 }
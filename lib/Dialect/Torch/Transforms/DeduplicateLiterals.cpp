@@ -0,0 +1,93 @@
+//===- DeduplicateLiterals.cpp -----------------------------------*- C++-*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+// Returns true if `op` is a tensor literal that can be replaced by any other
+// literal with the same payload and type.
+static bool isDeduplicatableLiteral(Operation *op) {
+  if (isa<ValueTensorLiteralOp, ValueTensorExternalLiteralOp>(op))
+    return true;
+  // Non-value tensors have object identity, so they can only be merged if
+  // they are never mutated, i.e. only copied to value tensors.
+  if (isa<NonValueTensorLiteralOp>(op)) {
+    return llvm::all_of(op->getUsers(), [](Operation *user) {
+      return isa<CopyToValueTensorOp>(user);
+    });
+  }
+  return false;
+}
+
+namespace {
+class DeduplicateLiteralsPass
+    : public DeduplicateLiteralsBase<DeduplicateLiteralsPass> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (func.isExternal())
+        continue;
+      deduplicateLiterals(func);
+    }
+  }
+
+  void deduplicateLiterals(func::FuncOp func) {
+    // Attributes are uniqued by the context, so literals with the same payload
+    // have the same attribute dictionary.
+    using LiteralKey = std::tuple<const void *, Attribute, Type>;
+    auto getKey = [](Operation *op) {
+      return LiteralKey{op->getName().getAsOpaquePointer(),
+                        op->getAttrDictionary(), op->getResult(0).getType()};
+    };
+    DenseMap<LiteralKey, Operation *> firstLiteral;
+    SmallVector<Operation *> literalsToHoist;
+    SmallVector<Operation *> duplicates;
+    func.walk([&](Operation *op) {
+      if (!isDeduplicatableLiteral(op))
+        return;
+      auto it = firstLiteral.try_emplace(getKey(op), op);
+      if (it.second)
+        return;
+      if (!llvm::is_contained(literalsToHoist, it.first->second))
+        literalsToHoist.push_back(it.first->second);
+      duplicates.push_back(op);
+    });
+
+    // The kept literal might be in a nested region or a later block than its
+    // duplicates, so move it to the start of the function to dominate them.
+    Block &entry = func.getBody().front();
+    Block::iterator insertionPoint = entry.begin();
+    for (Operation *op : literalsToHoist) {
+      if (&*insertionPoint == op)
+        ++insertionPoint;
+      else
+        op->moveBefore(&entry, insertionPoint);
+    }
+    for (Operation *op : duplicates) {
+      op->replaceAllUsesWith(firstLiteral[getKey(op)]);
+      op->erase();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::Torch::createDeduplicateLiteralsPass() {
+  return std::make_unique<DeduplicateLiteralsPass>();
+}
@@ -36,6 +36,18 @@ public:
     Block *block = &op.body().front();
     Operation *terminator = block->getTerminator();
     ValueRange results = terminator->getOperands();
+    // The backends allocate the results of a custom kernel before calling
+    // it, so its shape calculation is kept, and attached to the call.
+    Operation &kernel = block->front();
+    if (!getCustomKernel(&kernel).empty()) {
+      Block *shapeBlock = &op.shapeCalculation().front();
+      Operation *yieldShapes = shapeBlock->getTerminator();
+      SmallVector<Value> shapes = yieldShapes->getOperands();
+      rewriter.eraseOp(yieldShapes);
+      rewriter.mergeBlockBefore(shapeBlock, op);
+      rewriter.updateRootInPlace(
+          &kernel, [&]() { setCustomKernelResultShapes(&kernel, shapes); });
+    }
     rewriter.mergeBlockBefore(block, op);
     rewriter.replaceOp(op, results);
     rewriter.eraseOp(terminator);
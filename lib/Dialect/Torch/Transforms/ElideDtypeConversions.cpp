@@ -0,0 +1,334 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "llvm/ADT/APSInt.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+static bool isSignedInteger(mlir::IntegerType type) {
+  return !type.isUnsigned() && type.getWidth() != 1;
+}
+
+// Returns true if all the values of dtype `from` are represented exactly in
+// dtype `to`, so that converting from `from` to `to` never changes a value.
+static bool isExactConversion(Type from, Type to) {
+  if (from == to || from.isInteger(1))
+    return true;
+  if (to.isInteger(1))
+    return false;
+  auto toFloat = to.dyn_cast<mlir::FloatType>();
+  if (auto fromFloat = from.dyn_cast<mlir::FloatType>()) {
+    if (!toFloat)
+      return false;
+    const llvm::fltSemantics &fromSemantics = fromFloat.getFloatSemantics();
+    const llvm::fltSemantics &toSemantics = toFloat.getFloatSemantics();
+    return APFloat::semanticsPrecision(toSemantics) >=
+               APFloat::semanticsPrecision(fromSemantics) &&
+           APFloat::semanticsMaxExponent(toSemantics) >=
+               APFloat::semanticsMaxExponent(fromSemantics) &&
+           APFloat::semanticsMinExponent(toSemantics) <=
+               APFloat::semanticsMinExponent(fromSemantics);
+  }
+  auto fromInt = from.dyn_cast<mlir::IntegerType>();
+  if (!fromInt)
+    return false;
+  // The number of bits of the magnitude of the values of `from`.
+  unsigned magnitudeBits =
+      isSignedInteger(fromInt) ? fromInt.getWidth() - 1 : fromInt.getWidth();
+  if (toFloat)
+    return magnitudeBits <=
+           APFloat::semanticsPrecision(toFloat.getFloatSemantics());
+  auto toInt = to.dyn_cast<mlir::IntegerType>();
+  if (!toInt || (isSignedInteger(fromInt) && !isSignedInteger(toInt)))
+    return false;
+  return magnitudeBits <= (isSignedInteger(toInt) ? toInt.getWidth() - 1
+                                                  : toInt.getWidth());
+}
+
+// Returns the dtype `op` converts to if it's a plain conversion of a value
+// tensor with a known dtype, which doesn't change anything but the dtype.
+static Type getConversionDtype(AtenToDtypeOp op) {
+  bool nonBlocking, copy;
+  if (!matchPattern(op.non_blocking(), m_TorchConstantBool(&nonBlocking)) ||
+      nonBlocking || !matchPattern(op.copy(), m_TorchConstantBool(&copy)) ||
+      copy || !op.memory_format().getType().isa<Torch::NoneType>())
+    return nullptr;
+  auto inputType = op.self().getType().dyn_cast<ValueTensorType>();
+  auto resultType = op.getType().dyn_cast<ValueTensorType>();
+  if (!inputType || !inputType.hasDtype() || !resultType ||
+      !resultType.hasDtype())
+    return nullptr;
+  return resultType.getDtype();
+}
+
+static Type getDtype(Value v) {
+  auto type = v.getType().dyn_cast<ValueTensorType>();
+  return type && type.hasDtype() ? type.getDtype() : nullptr;
+}
+
+// Converts the elements of `attr` to `dtype` like `aten.to.dtype`: floats are
+// rounded to nearest, truncated towards zero when converted to ints, and ints
+// are wrapped around. Fails on the float to int conversions whose result is
+// not defined.
+static FailureOr<DenseElementsAttr> convertElements(DenseElementsAttr attr,
+                                                    Type dtype) {
+  auto tensorType = RankedTensorType::get(attr.getType().getShape(), dtype);
+  Type elementType = attr.getElementType();
+  auto intType = elementType.dyn_cast<mlir::IntegerType>();
+  if (!intType && !elementType.isa<mlir::FloatType>())
+    return failure();
+  bool isSplat = attr.isSplat();
+
+  if (auto floatType = dtype.dyn_cast<mlir::FloatType>()) {
+    const llvm::fltSemantics &semantics = floatType.getFloatSemantics();
+    SmallVector<APFloat> values;
+    if (intType) {
+      for (APInt value : attr.getValues<APInt>()) {
+        APFloat result(semantics);
+        result.convertFromAPInt(value, isSignedInteger(intType),
+                                APFloat::rmNearestTiesToEven);
+        values.push_back(result);
+        if (isSplat)
+          break;
+      }
+    } else {
+      for (APFloat value : attr.getValues<APFloat>()) {
+        bool losesInfo;
+        value.convert(semantics, APFloat::rmNearestTiesToEven, &losesInfo);
+        values.push_back(value);
+        if (isSplat)
+          break;
+      }
+    }
+    return DenseElementsAttr::get(tensorType, values);
+  }
+
+  auto resultIntType = dtype.dyn_cast<mlir::IntegerType>();
+  if (!resultIntType)
+    return failure();
+  unsigned width = resultIntType.getWidth();
+  SmallVector<APInt> values;
+  if (intType) {
+    for (APInt value : attr.getValues<APInt>()) {
+      if (width == 1)
+        values.push_back(APInt(1, !value.isZero()));
+      else if (isSignedInteger(intType))
+        values.push_back(value.sextOrTrunc(width));
+      else
+        values.push_back(value.zextOrTrunc(width));
+      if (isSplat)
+        break;
+    }
+  } else {
+    for (APFloat value : attr.getValues<APFloat>()) {
+      if (width == 1) {
+        values.push_back(APInt(1, !value.isZero()));
+      } else {
+        APSInt result(width, /*isUnsigned=*/resultIntType.isUnsigned());
+        bool isExact;
+        if (value.convertToInteger(result, APFloat::rmTowardZero, &isExact) &
+            APFloat::opInvalidOp)
+          return failure();
+        values.push_back(result);
+      }
+      if (isSplat)
+        break;
+    }
+  }
+  return DenseElementsAttr::get(tensorType, values);
+}
+
+namespace {
+// Folds `to.dtype(to.dtype(x, B), C)` into `to.dtype(x, C)`, or `x` if it has
+// dtype `C`, when converting `x` to `B` is exact. For example, the f32 results
+// promoted to f64 and converted back to f32 are used directly.
+class FoldExactConversionChain : public OpRewritePattern<AtenToDtypeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(AtenToDtypeOp op,
+                                PatternRewriter &rewriter) const override {
+    auto producer = op.self().getDefiningOp<AtenToDtypeOp>();
+    if (!getConversionDtype(op) || !producer ||
+        !getConversionDtype(producer))
+      return rewriter.notifyMatchFailure(op, "expected chain of conversions");
+    Value input = producer.self();
+    if (!isExactConversion(getDtype(input), getDtype(producer.getResult())))
+      return rewriter.notifyMatchFailure(op, "the first conversion rounds");
+
+    if (input.getType() == op.getType()) {
+      rewriter.replaceOp(op, input);
+      return success();
+    }
+    rewriter.replaceOpWithNewOp<AtenToDtypeOp>(
+        op, op.getType(), input, op.dtype(), op.non_blocking(), op.copy(),
+        op.memory_format());
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Folds the conversion of a `torch.vtensor.literal` into a literal of the
+// converted elements. Only splats, and literals without other uses, are
+// folded, so that no elements are duplicated.
+class FoldConversionOfLiteral : public OpRewritePattern<AtenToDtypeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(AtenToDtypeOp op,
+                                PatternRewriter &rewriter) const override {
+    Type dtype = getConversionDtype(op);
+    auto literal = op.self().getDefiningOp<ValueTensorLiteralOp>();
+    if (!dtype || !literal)
+      return rewriter.notifyMatchFailure(op, "expected conversion of literal");
+    auto attr = literal.valueAttr().dyn_cast<DenseElementsAttr>();
+    if (!attr || (!attr.isSplat() && !literal->hasOneUse()))
+      return rewriter.notifyMatchFailure(
+          op, "expected splat or literal without other uses");
+    auto resultType = op.getType().cast<ValueTensorType>();
+    if (!resultType.hasSizes() ||
+        resultType.getSizes() != attr.getType().getShape())
+      return rewriter.notifyMatchFailure(op, "expected static result type");
+
+    FailureOr<DenseElementsAttr> converted = convertElements(attr, dtype);
+    if (failed(converted))
+      return rewriter.notifyMatchFailure(op, "unsupported conversion");
+    rewriter.replaceOpWithNewOp<ValueTensorLiteralOp>(op, *converted);
+    return success();
+  }
+};
+} // namespace
+
+// Returns the value of dtype `dtype` that `operand`, a tensor of a wider float
+// dtype, is converted from without rounding, or null if there is none. A
+// splat literal, like a scale factor, whose value is exact in `dtype` is
+// returned in `narrowLiteral` instead, to be created by the caller.
+static Value getNarrowOperand(Value operand, Type dtype,
+                              DenseElementsAttr &narrowLiteral) {
+  Type operandDtype = getDtype(operand);
+  if (operandDtype == dtype)
+    return operand;
+  if (auto conversion = operand.getDefiningOp<AtenToDtypeOp>()) {
+    Value input = conversion.self();
+    if (getConversionDtype(conversion) && getDtype(input) == dtype)
+      return input;
+    return nullptr;
+  }
+  auto literal = operand.getDefiningOp<ValueTensorLiteralOp>();
+  if (!literal || !operandDtype)
+    return nullptr;
+  auto attr = literal.valueAttr().dyn_cast<DenseElementsAttr>();
+  if (!attr || !attr.isSplat())
+    return nullptr;
+  FailureOr<DenseElementsAttr> narrow = convertElements(attr, dtype);
+  if (failed(narrow))
+    return nullptr;
+  FailureOr<DenseElementsAttr> roundTrip =
+      convertElements(*narrow, operandDtype);
+  if (failed(roundTrip) || *roundTrip != attr)
+    return nullptr;
+  narrowLiteral = *narrow;
+  return operand;
+}
+
+namespace {
+// Computes `to.dtype(op(to.dtype(a, W), to.dtype(b, W)), N)` as `op(a, b)`
+// for float tensors `a` and `b` of dtype `N`, when `op` is an add, sub, mul,
+// div, neg, abs, relu, maximum or minimum without other uses. `W` is the
+// wider float dtype the operands were promoted to.
+//
+// This is exact: the neg, abs, relu, maximum and minimum don't round, and the
+// results of the other ops rounded to `W` and then to `N` are the results
+// rounded to `N` directly, since the precision of `W` is at least twice that
+// of `N` plus two bits, for f32 and f16 or bf16, and f64 and f32.
+class NarrowPromotedOp : public OpRewritePattern<AtenToDtypeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(AtenToDtypeOp op,
+                                PatternRewriter &rewriter) const override {
+    auto narrowType =
+        getConversionDtype(op).dyn_cast_or_null<mlir::FloatType>();
+    Operation *promoted = op.self().getDefiningOp();
+    if (!narrowType || !promoted || !promoted->hasOneUse())
+      return rewriter.notifyMatchFailure(op, "expected conversion of an op");
+    if (!isa<AtenAddTensorOp, AtenSubTensorOp, AtenMulTensorOp,
+             AtenDivTensorOp, AtenNegOp, AtenAbsOp, AtenReluOp, AtenMaximumOp,
+             AtenMinimumOp>(promoted))
+      return rewriter.notifyMatchFailure(op, "unsupported op");
+    if (isa<AtenAddTensorOp, AtenSubTensorOp>(promoted)) {
+      int64_t alpha;
+      if (!matchPattern(promoted->getOperand(2), m_TorchConstantInt(&alpha)) ||
+          alpha != 1)
+        return rewriter.notifyMatchFailure(op, "expected alpha of 1");
+    }
+    auto wideType = getDtype(op.self()).dyn_cast_or_null<mlir::FloatType>();
+    if (!wideType ||
+        APFloat::semanticsPrecision(wideType.getFloatSemantics()) <
+            2 * APFloat::semanticsPrecision(narrowType.getFloatSemantics()) +
+                2 ||
+        !isExactConversion(narrowType, wideType))
+      return rewriter.notifyMatchFailure(
+          op, "the promoted dtype is not wide enough");
+
+    SmallVector<Value> newOperands;
+    SmallVector<DenseElementsAttr> narrowLiterals;
+    for (Value operand : promoted->getOperands()) {
+      DenseElementsAttr narrowLiteral;
+      if (operand.getType().isa<ValueTensorType>()) {
+        operand = getNarrowOperand(operand, narrowType, narrowLiteral);
+        if (!operand)
+          return rewriter.notifyMatchFailure(
+              op, "expected operands converted from the narrow dtype");
+      }
+      newOperands.push_back(operand);
+      narrowLiterals.push_back(narrowLiteral);
+    }
+    for (auto it : llvm::enumerate(narrowLiterals)) {
+      if (it.value())
+        newOperands[it.index()] = rewriter.create<ValueTensorLiteralOp>(
+            op.getLoc(), it.value());
+    }
+    Operation *newOp = rewriter.create(
+        promoted->getLoc(), promoted->getName().getIdentifier(), newOperands,
+        op.getType(), promoted->getAttrs());
+    rewriter.replaceOp(op, newOp->getResults());
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class ElideDtypeConversionsPass
+    : public ElideDtypeConversionsBase<ElideDtypeConversionsPass> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FoldExactConversionChain, FoldConversionOfLiteral,
+                 NarrowPromotedOp>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createElideDtypeConversionsPass() {
+  return std::make_unique<ElideDtypeConversionsPass>();
+}
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+
+#include <cmath>
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+static double toDouble(APFloat value) {
+  bool losesInfo;
+  value.convert(APFloat::IEEEdouble(), APFloat::rmNearestTiesToEven,
+                &losesInfo);
+  return value.convertToDouble();
+}
+
+static APFloat fromDouble(double value, const llvm::fltSemantics &semantics) {
+  APFloat result(value);
+  bool losesInfo;
+  result.convert(semantics, APFloat::rmNearestTiesToEven, &losesInfo);
+  return result;
+}
+
+// Returns the elements of the constant float tensor `v` of `numElements`
+// elements, or an empty vector if `v` is not such a constant. If `v` is
+// `torch.constant.none`, returns `numElements` copies of `defaultValue`.
+static SmallVector<double> getConstantFloatTensorOrDefault(Value v,
+                                                          int64_t numElements,
+                                                          double defaultValue) {
+  if (v.getType().isa<Torch::NoneType>())
+    return SmallVector<double>(numElements, defaultValue);
+  DenseElementsAttr attr;
+  if (!matchPattern(v, m_Constant(&attr)) ||
+      !attr.getElementType().isa<mlir::FloatType>() ||
+      attr.getNumElements() != numElements)
+    return {};
+  SmallVector<double> values;
+  for (APFloat value : attr.getValues<APFloat>())
+    values.push_back(toDouble(value));
+  return values;
+}
+
+namespace {
+// Folds an inference-mode `aten.batch_norm` into the convolution producing
+// its input, when all the weights involved are constants:
+//   scale = weight / sqrt(running_var + eps)
+//   conv_weight' = conv_weight * scale (per output channel)
+//   conv_bias' = (conv_bias - running_mean) * scale + bias
+class FoldConvBatchNorm : public OpRewritePattern<AtenBatchNormOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(AtenBatchNormOp op,
+                                PatternRewriter &rewriter) const override {
+    bool training;
+    if (!matchPattern(op.training(), m_TorchConstantBool(&training)) ||
+        training)
+      return rewriter.notifyMatchFailure(op, "expected inference mode");
+    double eps;
+    if (!matchPattern(op.eps(), m_TorchConstantFloat(&eps)))
+      return rewriter.notifyMatchFailure(op, "expected constant eps");
+
+    Operation *conv = op.input().getDefiningOp();
+    if (!conv || !isa<AtenConvolutionOp, AtenConv2dOp>(conv) ||
+        !conv->getResult(0).hasOneUse())
+      return rewriter.notifyMatchFailure(
+          op, "expected input to be a convolution used only by the batch norm");
+    if (conv->getResult(0).getType() != op.getType())
+      return rewriter.notifyMatchFailure(
+          op, "expected convolution and batch norm types to match");
+    if (auto convolution = dyn_cast<AtenConvolutionOp>(conv)) {
+      bool transposed;
+      if (!matchPattern(convolution.transposed(),
+                        m_TorchConstantBool(&transposed)) ||
+          transposed)
+        return rewriter.notifyMatchFailure(
+            op, "unimplemented: transposed convolution");
+    }
+    // Both convolution ops have the weight and bias as operands 1 and 2.
+    Value convWeight = conv->getOperand(1);
+    Value convBias = conv->getOperand(2);
+
+    DenseElementsAttr weightAttr;
+    if (!matchPattern(convWeight, m_Constant(&weightAttr)))
+      return rewriter.notifyMatchFailure(op, "expected constant conv weight");
+    auto floatType = weightAttr.getElementType().dyn_cast<mlir::FloatType>();
+    ShapedType weightType = weightAttr.getType();
+    if (!floatType || weightType.getRank() < 1)
+      return rewriter.notifyMatchFailure(op, "expected float conv weight");
+    int64_t numChannels = weightType.getDimSize(0);
+
+    SmallVector<double> mean =
+        getConstantFloatTensorOrDefault(op.running_mean(), numChannels, 0.0);
+    SmallVector<double> var =
+        getConstantFloatTensorOrDefault(op.running_var(), numChannels, 1.0);
+    SmallVector<double> gamma =
+        getConstantFloatTensorOrDefault(op.weight(), numChannels, 1.0);
+    SmallVector<double> beta =
+        getConstantFloatTensorOrDefault(op.bias(), numChannels, 0.0);
+    SmallVector<double> bias =
+        getConstantFloatTensorOrDefault(convBias, numChannels, 0.0);
+    // TorchScript always passes the running stats in inference mode, so we
+    // don't bother handling them being `None`.
+    if (op.running_mean().getType().isa<Torch::NoneType>() ||
+        op.running_var().getType().isa<Torch::NoneType>() || mean.empty() ||
+        var.empty() || gamma.empty() || beta.empty() || bias.empty())
+      return rewriter.notifyMatchFailure(
+          op, "expected constant batch norm parameters and conv bias");
+
+    const llvm::fltSemantics &semantics = floatType.getFloatSemantics();
+    SmallVector<APFloat> newBias;
+    SmallVector<double> scale;
+    for (int64_t c = 0; c < numChannels; c++) {
+      scale.push_back(gamma[c] / std::sqrt(var[c] + eps));
+      newBias.push_back(
+          fromDouble((bias[c] - mean[c]) * scale[c] + beta[c], semantics));
+    }
+    int64_t elementsPerChannel =
+        numChannels == 0 ? 0 : weightType.getNumElements() / numChannels;
+    SmallVector<APFloat> newWeight;
+    int64_t i = 0;
+    for (APFloat value : weightAttr.getValues<APFloat>())
+      newWeight.push_back(fromDouble(
+          toDouble(value) * scale[i++ / elementsPerChannel], semantics));
+
+    Location loc = op.getLoc();
+    rewriter.setInsertionPoint(conv);
+    Value newWeightLiteral = rewriter.create<ValueTensorLiteralOp>(
+        loc, DenseElementsAttr::get(weightType, newWeight));
+    Value newBiasLiteral = rewriter.create<ValueTensorLiteralOp>(
+        loc, DenseElementsAttr::get(
+                 RankedTensorType::get({numChannels}, floatType), newBias));
+    rewriter.updateRootInPlace(conv, [&]() {
+      conv->setOperand(1, newWeightLiteral);
+      conv->setOperand(2, newBiasLiteral);
+    });
+    rewriter.replaceOp(op, conv->getResults());
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class FoldConvBatchNormPass
+    : public FoldConvBatchNormBase<FoldConvBatchNormPass> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FoldConvBatchNorm>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createFoldConvBatchNormPass() {
+  return std::make_unique<FoldConvBatchNormPass>();
+}
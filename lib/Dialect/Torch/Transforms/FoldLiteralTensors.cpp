@@ -0,0 +1,490 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+
+#include <cmath>
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+static double toDouble(APFloat value) {
+  bool losesInfo;
+  value.convert(APFloat::IEEEdouble(), APFloat::rmNearestTiesToEven,
+                &losesInfo);
+  return value.convertToDouble();
+}
+
+static APFloat fromDouble(double value, const llvm::fltSemantics &semantics) {
+  APFloat result(value);
+  bool losesInfo;
+  result.convert(semantics, APFloat::rmNearestTiesToEven, &losesInfo);
+  return result;
+}
+
+static int64_t getNumElements(ArrayRef<int64_t> shape) {
+  int64_t numElements = 1;
+  for (int64_t size : shape)
+    numElements *= size;
+  return numElements;
+}
+
+// Returns true if `v` is a float scalar or a tensor of floats.
+static bool hasFloatElements(Value v) {
+  if (v.getType().isa<Torch::FloatType>())
+    return true;
+  auto type = v.getType().dyn_cast<ValueTensorType>();
+  return type && type.hasDtype() && type.getDtype().isa<mlir::FloatType>();
+}
+
+namespace {
+// The elements of a constant tensor or scalar, with ints and bools read as
+// int64_t and floats as double. Scalars and splats are read as 0-d tensors,
+// which broadcast to any shape.
+template <typename T> struct Literal {
+  SmallVector<int64_t> shape;
+  SmallVector<T> elements;
+};
+} // namespace
+
+// Reads the constant scalar, splat literal or `torch.vtensor.literal` of at
+// most `maxElements` elements `v`. Floats can only be read as double.
+template <typename T>
+static FailureOr<Literal<T>> readLiteral(Value v, int64_t maxElements) {
+  bool isFloat = std::is_floating_point<T>::value;
+  Literal<T> literal;
+  int64_t intValue;
+  double floatValue;
+  bool boolValue;
+  if (matchPattern(v, m_TorchConstantBool(&boolValue))) {
+    literal.elements.push_back(static_cast<T>(boolValue));
+    return literal;
+  }
+  if (matchPattern(v, m_TorchConstantInt(&intValue))) {
+    literal.elements.push_back(static_cast<T>(intValue));
+    return literal;
+  }
+  if (matchPattern(v, m_TorchConstantFloat(&floatValue))) {
+    if (!isFloat)
+      return failure();
+    literal.elements.push_back(static_cast<T>(floatValue));
+    return literal;
+  }
+
+  DenseElementsAttr attr;
+  if (!matchPattern(v, m_Constant(&attr)))
+    return failure();
+  bool isSplat = attr.isSplat();
+  if (!isSplat && attr.getNumElements() > maxElements)
+    return failure();
+  Type elementType = attr.getElementType();
+  if (elementType.isa<mlir::FloatType>()) {
+    if (!isFloat)
+      return failure();
+    for (APFloat value : attr.getValues<APFloat>()) {
+      literal.elements.push_back(static_cast<T>(toDouble(value)));
+      if (isSplat)
+        break;
+    }
+  } else if (auto intType = elementType.dyn_cast<mlir::IntegerType>()) {
+    bool isSigned = !intType.isUnsigned() && intType.getWidth() != 1;
+    for (APInt value : attr.getValues<APInt>()) {
+      literal.elements.push_back(static_cast<T>(
+          isSigned ? value.getSExtValue()
+                   : static_cast<int64_t>(value.getZExtValue())));
+      if (isSplat)
+        break;
+    }
+  } else {
+    return failure();
+  }
+  if (!isSplat)
+    literal.shape = llvm::to_vector(attr.getType().getShape());
+  return literal;
+}
+
+// Reads the constant scalar or 1-element literal `v`.
+template <typename T> static FailureOr<T> readScalar(Value v) {
+  FailureOr<Literal<T>> literal = readLiteral<T>(v, /*maxElements=*/1);
+  if (failed(literal) || literal->elements.size() != 1)
+    return failure();
+  return literal->elements[0];
+}
+
+// Returns the elements of `literal` broadcast to `shape` with the semantics of
+// PyTorch, or failure if its shape isn't broadcastable to `shape`.
+template <typename T>
+static FailureOr<SmallVector<T>> broadcastTo(const Literal<T> &literal,
+                                             ArrayRef<int64_t> shape) {
+  int64_t rank = shape.size();
+  int64_t offset = rank - literal.shape.size();
+  if (offset < 0)
+    return failure();
+  // Strides (in elements) of the dimensions of `literal` aligned with those
+  // of `shape`, which are 0 for the broadcast dimensions.
+  SmallVector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (int64_t i = literal.shape.size() - 1; i >= 0; i--) {
+    int64_t size = literal.shape[i];
+    if (size != 1 && size != shape[i + offset])
+      return failure();
+    if (size != 1)
+      strides[i + offset] = stride;
+    stride *= size;
+  }
+
+  SmallVector<T> elements;
+  int64_t numElements = getNumElements(shape);
+  elements.reserve(numElements);
+  for (int64_t i = 0; i < numElements; i++) {
+    int64_t sourceOffset = 0;
+    int64_t remaining = i;
+    for (int64_t d = rank - 1; d >= 0; d--) {
+      sourceOffset += remaining % shape[d] * strides[d];
+      remaining /= shape[d];
+    }
+    elements.push_back(literal.elements[sourceOffset]);
+  }
+  return elements;
+}
+
+// Returns the elementwise function computed by `op`, or nullptr if `op` isn't
+// supported. Comparisons return 1 for true and 0 for false.
+template <typename T>
+static std::function<T(ArrayRef<T>)> getElementwiseFn(Operation *op) {
+  if (isa<AtenNegOp>(op))
+    return [](ArrayRef<T> x) { return -x[0]; };
+  if (isa<AtenAbsOp>(op))
+    return [](ArrayRef<T> x) { return x[0] < 0 ? -x[0] : x[0]; };
+  if (isa<AtenReluOp>(op))
+    return [](ArrayRef<T> x) { return x[0] > 0 ? x[0] : static_cast<T>(0); };
+  if (isa<AtenSqrtOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(std::sqrt(x[0])); };
+  if (isa<AtenRsqrtOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(1.0 / std::sqrt(x[0])); };
+  if (isa<AtenReciprocalOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(1.0 / x[0]); };
+  if (isa<AtenExpOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(std::exp(x[0])); };
+  if (isa<AtenSinOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(std::sin(x[0])); };
+  if (isa<AtenCosOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(std::cos(x[0])); };
+  // The binary ops with an `alpha` get it as their third operand.
+  if (isa<AtenAddTensorOp, AtenAddScalarOp>(op))
+    return [](ArrayRef<T> x) { return x[0] + x[1] * x[2]; };
+  if (isa<AtenSubTensorOp, AtenSubScalarOp>(op))
+    return [](ArrayRef<T> x) { return x[0] - x[1] * x[2]; };
+  if (isa<AtenMulTensorOp, AtenMulScalarOp>(op))
+    return [](ArrayRef<T> x) { return x[0] * x[1]; };
+  if (isa<AtenDivTensorOp, AtenDivScalarOp>(op))
+    return [](ArrayRef<T> x) { return x[0] / x[1]; };
+  if (isa<AtenMaximumOp>(op))
+    return [](ArrayRef<T> x) { return std::max(x[0], x[1]); };
+  if (isa<AtenMinimumOp>(op))
+    return [](ArrayRef<T> x) { return std::min(x[0], x[1]); };
+  if (isa<AtenEqTensorOp, AtenEqScalarOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(x[0] == x[1]); };
+  if (isa<AtenNeScalarOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(x[0] != x[1]); };
+  if (isa<AtenGtTensorOp, AtenGtScalarOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(x[0] > x[1]); };
+  if (isa<AtenGeScalarOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(x[0] >= x[1]); };
+  if (isa<AtenLtTensorOp, AtenLtScalarOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(x[0] < x[1]); };
+  if (isa<AtenLeScalarOp>(op))
+    return [](ArrayRef<T> x) { return static_cast<T>(x[0] <= x[1]); };
+  return nullptr;
+}
+
+// Evaluates the elementwise `op` with literal operands, computing in `T`.
+// Returns a single element when the result is a splat.
+template <typename T>
+static FailureOr<SmallVector<T>> evaluateElementwise(Operation *op,
+                                                     ArrayRef<int64_t> shape,
+                                                     int64_t maxElements) {
+  std::function<T(ArrayRef<T>)> fn = getElementwiseFn<T>(op);
+  if (!fn)
+    return failure();
+  bool hasAlpha = isa<AtenAddTensorOp, AtenAddScalarOp, AtenSubTensorOp,
+                      AtenSubScalarOp>(op);
+  int64_t numTensorOperands =
+      hasAlpha ? 2 : std::min<int64_t>(op->getNumOperands(), 2);
+
+  SmallVector<Literal<T>> literals;
+  for (Value operand : op->getOperands().take_front(numTensorOperands)) {
+    FailureOr<Literal<T>> literal = readLiteral<T>(operand, maxElements);
+    if (failed(literal))
+      return failure();
+    literals.push_back(std::move(*literal));
+  }
+  // Splat operands compute a splat, whatever the size of the result.
+  if (llvm::all_of(literals, [](const Literal<T> &literal) {
+        return literal.shape.empty();
+      }))
+    shape = ArrayRef<int64_t>();
+  else if (getNumElements(shape) > maxElements)
+    return failure();
+
+  SmallVector<SmallVector<T>> operands;
+  for (const Literal<T> &literal : literals) {
+    FailureOr<SmallVector<T>> elements = broadcastTo(literal, shape);
+    if (failed(elements))
+      return failure();
+    operands.push_back(std::move(*elements));
+  }
+  SmallVector<T> args(operands.size(), 0);
+  if (hasAlpha) {
+    FailureOr<T> alpha = readScalar<T>(op->getOperand(2));
+    if (failed(alpha))
+      return failure();
+    args.push_back(*alpha);
+  }
+
+  SmallVector<T> elements;
+  int64_t numElements = getNumElements(shape);
+  elements.reserve(numElements);
+  for (int64_t i = 0; i < numElements; i++) {
+    for (auto it : llvm::enumerate(operands))
+      args[it.index()] = it.value()[i];
+    elements.push_back(fn(args));
+  }
+  return elements;
+}
+
+// Evaluates the ops constructing a tensor from scalars or from a literal of
+// another shape: fills, `aten.arange` variants and broadcasts. Returns a
+// single element when the result is a splat.
+template <typename T>
+static FailureOr<SmallVector<T>>
+evaluateConstructionOp(Operation *op, ArrayRef<int64_t> shape,
+                       int64_t maxElements) {
+  if (isa<AtenZerosOp, AtenNewZerosOp>(op))
+    return SmallVector<T>{0};
+  if (isa<AtenOnesOp, AtenNewOnesOp>(op))
+    return SmallVector<T>{1};
+  // The filled tensor is a value tensor, so its contents don't matter.
+  if (auto fill = dyn_cast<ValsemVariantAtenFillScalarOp>(op)) {
+    FailureOr<T> value = readScalar<T>(fill.value());
+    if (failed(value))
+      return failure();
+    return SmallVector<T>{*value};
+  }
+
+  if (isa<AtenExpandOp, AtenBroadcastToOp>(op)) {
+    FailureOr<Literal<T>> literal =
+        readLiteral<T>(op->getOperand(0), maxElements);
+    if (failed(literal))
+      return failure();
+    if (literal->shape.empty())
+      return literal->elements;
+    if (getNumElements(shape) > maxElements)
+      return failure();
+    return broadcastTo(*literal, shape);
+  }
+
+  Value start, end, step;
+  if (auto arange = dyn_cast<AtenArangeOp>(op)) {
+    end = arange.end();
+  } else if (auto arange = dyn_cast<AtenArangeStartOp>(op)) {
+    start = arange.start();
+    end = arange.end();
+  } else if (auto arange = dyn_cast<AtenArangeStartStepOp>(op)) {
+    start = arange.start();
+    end = arange.end();
+    step = arange.step();
+  } else {
+    return failure();
+  }
+  FailureOr<double> endValue = readScalar<double>(end);
+  FailureOr<T> startValue = start ? readScalar<T>(start) : FailureOr<T>(0);
+  FailureOr<T> stepValue = step ? readScalar<T>(step) : FailureOr<T>(1);
+  if (failed(endValue) || failed(startValue) || failed(stepValue) ||
+      *stepValue == 0 || shape.size() != 1 || shape[0] > maxElements)
+    return failure();
+  // Don't trust a result type that disagrees with the bounds.
+  double length = std::ceil((*endValue - *startValue) / (double)*stepValue);
+  if (shape[0] != std::max<int64_t>(static_cast<int64_t>(length), 0))
+    return failure();
+  SmallVector<T> elements;
+  for (int64_t i = 0; i < shape[0]; i++)
+    elements.push_back(*startValue + static_cast<T>(i) * *stepValue);
+  return elements;
+}
+
+// Returns the literal of type `type` with the elements `elements`, or the
+// splat of `elements[0]` if there is only one.
+template <typename T>
+static DenseElementsAttr createLiteralAttr(ValueTensorType type,
+                                           ArrayRef<T> elements) {
+  auto tensorType = RankedTensorType::get(type.getSizes(), type.getDtype());
+  if (auto floatType = type.getDtype().dyn_cast<mlir::FloatType>()) {
+    SmallVector<APFloat> values;
+    for (T element : elements)
+      values.push_back(fromDouble(element, floatType.getFloatSemantics()));
+    return DenseElementsAttr::get(tensorType, values);
+  }
+  unsigned width = type.getDtype().getIntOrFloatBitWidth();
+  SmallVector<APInt> values;
+  for (T element : elements) {
+    int64_t value = static_cast<int64_t>(element);
+    values.push_back(width == 1 ? APInt(1, value != 0)
+                                : APInt(width, value, /*isSigned=*/true));
+  }
+  return DenseElementsAttr::get(tensorType, values);
+}
+
+// Evaluates the shape `op` that only moves the elements of its literal input
+// around.
+static FailureOr<DenseElementsAttr>
+evaluateShapeOp(Operation *op, RankedTensorType resultType,
+                int64_t maxElements) {
+  if (!isa<AtenViewOp, AtenReshapeOp, AtenUnsqueezeOp, AtenSqueezeOp,
+           AtenSqueezeDimOp, AtenFlattenUsingIntsOp, AtenTransposeIntOp,
+           AtenPermuteOp>(op))
+    return failure();
+  DenseElementsAttr attr;
+  if (!matchPattern(op->getOperand(0), m_Constant(&attr)) ||
+      (!attr.isSplat() && attr.getNumElements() > maxElements) ||
+      attr.getElementType() != resultType.getElementType())
+    return failure();
+
+  int64_t rank = attr.getType().getRank();
+  SmallVector<int64_t> permutation;
+  if (auto transpose = dyn_cast<AtenTransposeIntOp>(op)) {
+    int64_t dim0, dim1;
+    if (!matchPattern(transpose.dim0(), m_TorchConstantInt(&dim0)) ||
+        !matchPattern(transpose.dim1(), m_TorchConstantInt(&dim1)))
+      return failure();
+    dim0 = toPositiveDim(dim0, rank);
+    dim1 = toPositiveDim(dim1, rank);
+    if (!isValidDim(dim0, rank) || !isValidDim(dim1, rank))
+      return failure();
+    permutation = llvm::to_vector(llvm::seq<int64_t>(0, rank));
+    std::swap(permutation[dim0], permutation[dim1]);
+  } else if (auto permute = dyn_cast<AtenPermuteOp>(op)) {
+    if (!matchPattern(permute.dims(), m_TorchConstantIntList(permutation)) ||
+        static_cast<int64_t>(permutation.size()) != rank)
+      return failure();
+    for (int64_t &dim : permutation) {
+      dim = toPositiveDim(dim, rank);
+      if (!isValidDim(dim, rank))
+        return failure();
+    }
+  }
+  if (!permutation.empty()) {
+    FailureOr<DenseElementsAttr> transposed =
+        transposeElementsAttr(attr, permutation);
+    if (failed(transposed))
+      return failure();
+    attr = *transposed;
+  }
+  // The other ops keep the elements in the same order.
+  if (attr.getNumElements() != resultType.getNumElements())
+    return failure();
+  return attr.reshape(resultType);
+}
+
+template <typename T>
+static FailureOr<DenseElementsAttr>
+evaluate(Operation *op, ValueTensorType type, int64_t maxElements) {
+  FailureOr<SmallVector<T>> elements =
+      evaluateElementwise<T>(op, type.getSizes(), maxElements);
+  if (failed(elements))
+    elements = evaluateConstructionOp<T>(op, type.getSizes(), maxElements);
+  if (failed(elements))
+    return failure();
+  return createLiteralAttr<T>(type, *elements);
+}
+
+namespace {
+// Replaces an elementwise, shape or construction op whose operands are all
+// literal tensors or constant scalars by the literal it computes. Integer
+// results are computed with int64_t and float results with double, rounded to
+// the result dtype.
+class FoldLiteralTensorOp : public RewritePattern {
+public:
+  FoldLiteralTensorOp(MLIRContext *context, int64_t maxElements,
+                      int64_t maxSplatElements)
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context),
+        maxElements(maxElements), maxSplatElements(maxSplatElements) {}
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    if (op->getNumResults() != 1 || isa<ValueTensorLiteralOp>(op))
+      return rewriter.notifyMatchFailure(op, "expected an op with one result");
+    auto type = op->getResult(0).getType().dyn_cast<ValueTensorType>();
+    if (!type || !type.hasSizes() || !type.hasDtype() ||
+        llvm::is_contained(type.getSizes(), kUnknownSize))
+      return rewriter.notifyMatchFailure(op, "expected static result type");
+    if (!type.getDtype().isa<mlir::FloatType, mlir::IntegerType>())
+      return rewriter.notifyMatchFailure(op, "unsupported result dtype");
+    // The results that aren't splats are bounded by `maxElements` below.
+    if (getNumElements(type.getSizes()) > maxSplatElements)
+      return rewriter.notifyMatchFailure(op, "result too large to fold");
+
+    FailureOr<DenseElementsAttr> attr = evaluateShapeOp(
+        op, RankedTensorType::get(type.getSizes(), type.getDtype()),
+        maxElements);
+    if (failed(attr)) {
+      // Comparisons and ops mixing ints and floats are computed in floats.
+      bool computeInFloat =
+          type.getDtype().isa<mlir::FloatType>() ||
+          llvm::any_of(op->getOperands().take_front(2), hasFloatElements);
+      attr = computeInFloat ? evaluate<double>(op, type, maxElements)
+                            : evaluate<int64_t>(op, type, maxElements);
+    }
+    if (failed(attr))
+      return rewriter.notifyMatchFailure(op, "expected literal operands");
+    rewriter.replaceOpWithNewOp<ValueTensorLiteralOp>(op, *attr);
+    return success();
+  }
+
+private:
+  int64_t maxElements;
+  int64_t maxSplatElements;
+};
+} // namespace
+
+namespace {
+class FoldLiteralTensorsPass
+    : public FoldLiteralTensorsBase<FoldLiteralTensorsPass> {
+public:
+  FoldLiteralTensorsPass() = default;
+  FoldLiteralTensorsPass(int64_t maxElements, int64_t maxSplatElements) {
+    this->maxElements = maxElements;
+    this->maxSplatElements = maxSplatElements;
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FoldLiteralTensorOp>(context, maxElements, maxSplatElements);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createFoldLiteralTensorsPass(int64_t maxElements,
+                                                 int64_t maxSplatElements) {
+  return std::make_unique<FoldLiteralTensorsPass>(maxElements,
+                                                  maxSplatElements);
+}
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+// Makes `flag`, the training mode operand of an op, a constant `false`.
+static void setToFalse(OpBuilder &b, Operation *op, MutableOperandRange flag) {
+  bool value;
+  if (matchPattern(flag[0].get(), m_TorchConstantBool(&value)) && !value)
+    return;
+  b.setInsertionPoint(op);
+  flag.assign(b.create<ConstantBoolOp>(op->getLoc(), false));
+}
+
+// Returns whether `value` is a `torch.constant.none`, possibly derefined.
+static bool isConstantNone(Value value) {
+  if (auto derefine = value.getDefiningOp<DerefineOp>())
+    value = derefine.operand();
+  return value.getDefiningOp<ConstantNoneOp>() != nullptr;
+}
+
+// Makes the batch norm `op` use its running stats. Without them, e.g. for
+// `track_running_stats=False`, the batch norm always normalizes with the
+// stats of the batch, so `training` is left unchanged.
+template <typename OpTy>
+static void setBatchNormToInference(OpBuilder &b, OpTy op) {
+  if (isConstantNone(op.running_mean()) || isConstantNone(op.running_var()))
+    return;
+  setToFalse(b, op, op.trainingMutable());
+}
+
+namespace {
+class ForceInferenceModePass
+    : public ForceInferenceModeBase<ForceInferenceModePass> {
+  void runOnOperation() override {
+    OpBuilder b(&getContext());
+    getOperation().walk([&](Operation *op) {
+      if (auto dropout = dyn_cast<AtenDropoutOp>(op))
+        setToFalse(b, op, dropout.trainMutable());
+      else if (auto dropout = dyn_cast<AtenDropout_Op>(op))
+        setToFalse(b, op, dropout.trainMutable());
+      else if (auto dropout = dyn_cast<AtenNativeDropoutOp>(op))
+        setToFalse(b, op, dropout.trainMutable());
+      else if (auto batchNorm = dyn_cast<AtenBatchNormOp>(op))
+        setBatchNormToInference(b, batchNorm);
+      else if (auto batchNorm = dyn_cast<AtenNativeBatchNormOp>(op))
+        setBatchNormToInference(b, batchNorm);
+    });
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createForceInferenceModePass() {
+  return std::make_unique<ForceInferenceModePass>();
+}
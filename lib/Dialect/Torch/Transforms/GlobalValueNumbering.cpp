@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "llvm/ADT/ScopedHashTable.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+// Returns true if swapping the first two operands of `op` doesn't change its
+// results. `aten.add.Tensor` is only commutative when `alpha` is 1, since it
+// scales the second operand.
+static bool isCommutative(Operation *op) {
+  if (isa<AtenMulTensorOp, AtenMaximumOp, AtenMinimumOp, AtenEqTensorOp,
+          AtenNeTensorOp, AtenLogicalOrOp, AtenAddIntOp, AtenMulIntOp>(op))
+    return true;
+  if (auto add = dyn_cast<AtenAddTensorOp>(op)) {
+    int64_t alpha;
+    return matchPattern(add.alpha(), m_TorchConstantInt(&alpha)) && alpha == 1;
+  }
+  return false;
+}
+
+// Returns the operands of `op`, with the first two in a canonical order if
+// `op` is commutative, so that e.g. `aten.mul.Tensor %a, %b` and
+// `aten.mul.Tensor %b, %a` get the same value number.
+static SmallVector<Value, 4> getCanonicalOperands(Operation *op) {
+  SmallVector<Value, 4> operands(op->getOperands());
+  if (isCommutative(op) &&
+      operands[1].getAsOpaquePointer() < operands[0].getAsOpaquePointer())
+    std::swap(operands[0], operands[1]);
+  return operands;
+}
+
+// Returns true if `lhs` and `rhs` compute the same results, up to the order
+// of the operands of commutative ops.
+static bool isEquivalent(Operation *lhs, Operation *rhs) {
+  return lhs->getName() == rhs->getName() &&
+         lhs->getAttrDictionary() == rhs->getAttrDictionary() &&
+         llvm::equal(lhs->getResultTypes(), rhs->getResultTypes()) &&
+         getCanonicalOperands(lhs) == getCanonicalOperands(rhs);
+}
+
+namespace {
+struct ValueNumberInfo : public llvm::DenseMapInfo<Operation *> {
+  static unsigned getHashValue(const Operation *opC) {
+    auto *op = const_cast<Operation *>(opC);
+    SmallVector<Value, 4> operands = getCanonicalOperands(op);
+    return llvm::hash_combine(
+        op->getName(), op->getAttrDictionary(),
+        llvm::hash_combine_range(op->result_type_begin(),
+                                 op->result_type_end()),
+        llvm::hash_combine_range(operands.begin(), operands.end()));
+  }
+  static bool isEqual(const Operation *lhsC, const Operation *rhsC) {
+    auto *lhs = const_cast<Operation *>(lhsC);
+    auto *rhs = const_cast<Operation *>(rhsC);
+    if (lhs == rhs)
+      return true;
+    if (lhs == getEmptyKey() || lhs == getTombstoneKey() ||
+        rhs == getEmptyKey() || rhs == getTombstoneKey())
+      return false;
+    return isEquivalent(lhs, rhs);
+  }
+};
+} // namespace
+
+namespace {
+// Numbers the movable ops of a function in a scope per block, nested like the
+// regions, so that an op is replaced by an equivalent op of an enclosing
+// block, which dominates it.
+class ValueNumbering {
+public:
+  void numberBlock(Block &block) {
+    ScopeTy scope(knownOps);
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      for (Region &region : op.getRegions()) {
+        for (Block &nestedBlock : region)
+          numberBlock(nestedBlock);
+      }
+      if (auto ifOp = dyn_cast<PrimIfOp>(op)) {
+        for (Operation *hoisted : hoistCommonOps(ifOp, isEquivalent))
+          numberOp(hoisted);
+      }
+      numberOp(&op);
+    }
+  }
+
+private:
+  using ScopeTy = llvm::ScopedHashTableScope<Operation *, Operation *,
+                                             ValueNumberInfo>;
+
+  // Replaces `op` with the equivalent op already numbered, if any.
+  void numberOp(Operation *op) {
+    if (!isMovableComputation(op))
+      return;
+    if (Operation *existing = knownOps.lookup(op)) {
+      op->replaceAllUsesWith(existing->getResults());
+      op->erase();
+      return;
+    }
+    knownOps.insert(op, op);
+  }
+
+  llvm::ScopedHashTable<Operation *, Operation *, ValueNumberInfo> knownOps;
+};
+} // namespace
+
+namespace {
+class GlobalValueNumberingPass
+    : public GlobalValueNumberingBase<GlobalValueNumberingPass> {
+  void runOnOperation() override {
+    ValueNumbering valueNumbering;
+    for (Block &block : getOperation().getBody())
+      valueNumbering.numberBlock(block);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createGlobalValueNumberingPass() {
+  return std::make_unique<GlobalValueNumberingPass>();
+}
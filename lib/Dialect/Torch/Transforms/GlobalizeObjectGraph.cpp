@@ -143,6 +143,8 @@ private:
         op->emitError() << "Reference to non-existing module slot " << slotName
                         << "in " << moduleType.getClassName();
       usedSlots.insert(slotIt->getValue());
+      if (isa<PrimSetAttrOp>(op))
+        mutatedSlots.insert(slotIt->getValue());
     });
     return success();
   }
@@ -167,6 +169,14 @@ private:
         if (failed(
                 recursivelyTraverse(slot.value().getDefiningOp<NnModuleOp>())))
           return failure();
+      } else if (GlobalSlotOp sharedGlobalSlot =
+                     findGlobalSlotToShare(slot, attr)) {
+        assert(slotToGlobalSlot.find(slot) == slotToGlobalSlot.end());
+        if (!attr.isPrivate())
+          sharedGlobalSlot.setVisibility(SymbolTable::Visibility::Public);
+        slotToGlobalSlot[slot] = sharedGlobalSlot;
+        slotLinkageInfo[slot] =
+            LinkageInfo{sharedGlobalSlot.sym_name().str(), attr.isPrivate()};
       } else {
         std::string linkageName = llvm::join(nameStack, ".");
         auto globalSlot = globalSlotBuilder.create<GlobalSlotOp>(
@@ -177,6 +187,8 @@ private:
         assert(slotToGlobalSlot.find(slot) == slotToGlobalSlot.end());
         slotToGlobalSlot[slot] = globalSlot;
         slotLinkageInfo[slot] = LinkageInfo{linkageName, attr.isPrivate()};
+        if (hasMeaningfulObjectIdentity(slot.value().getType()))
+          firstSlotInitializedWith.try_emplace(slot.value(), slot);
         if (failed(populateGlobalSlotInitializer(globalSlot, slot)))
           return failure();
       }
@@ -191,6 +203,25 @@ private:
     }
     return success();
   }
+  // Returns the global slot already created for another slot that holds the
+  // same object as `slot`, if the two can be modeled by a single global slot.
+  //
+  // This is the case for tied parameters (e.g. an embedding shared with the LM
+  // head), which the importer materializes as a single value used by multiple
+  // slots. As long as neither slot is ever reassigned, reading either slot
+  // always yields the same object, so they are one global slot.
+  GlobalSlotOp findGlobalSlotToShare(SlotOp slot, AttrOp attr) {
+    auto it = firstSlotInitializedWith.find(slot.value());
+    if (it == firstSlotInitializedWith.end())
+      return nullptr;
+    SlotOp otherSlot = it->second;
+    if (mutatedSlots.contains(slot) || mutatedSlots.contains(otherSlot))
+      return nullptr;
+    GlobalSlotOp globalSlot = slotToGlobalSlot[otherSlot];
+    if (globalSlot.typeBound() != attr.type())
+      return nullptr;
+    return globalSlot;
+  }
   LogicalResult populateGlobalSlotInitializer(GlobalSlotOp globalSlot,
                                               SlotOp slot) {
     OpBuilder builder(globalSlot.getContext());
@@ -261,6 +292,11 @@ private:
   // Used to keep track of all the used torch slots so that the restrictions can
   // be applied to those slots only.
   DenseSet<SlotOp> usedSlots;
+  // The subset of `usedSlots` that are assigned to with `PrimSetAttrOp`.
+  DenseSet<SlotOp> mutatedSlots;
+  // For each value with meaningful object identity, the first slot that we
+  // created a global slot for that is initialized with it.
+  DenseMap<Value, SlotOp> firstSlotInitializedWith;
 };
 } // namespace
 
@@ -501,11 +537,83 @@ verifyPublicMonomorphizations(ModuleOp module, SymbolTable &symbolTable,
   return success(!sawError);
 }
 
+namespace {
+// A function that replaces all monomorphizations of a function that only uses
+// its instance arguments to read slots that are not modules. Instead of being
+// specialized to the global slots of one instance, it takes the values of the
+// slots it reads as extra trailing arguments, which callers read from the
+// global slots of the instances that they would have passed.
+//
+// This bounds the number of functions created for models with many instances
+// of the same class (e.g. the experts of a mixture-of-experts model).
+struct SharedMonomorphization {
+  // A slot read by the function, and its type.
+  struct SlotArg {
+    int argIndex;
+    std::string name;
+    Type type;
+  };
+  func::FuncOp func;
+  std::vector<SlotArg> slotArgs;
+};
+} // namespace
+
+// Returns true if `func` only uses its arguments of `NnModuleType` to read
+// slots that are not modules, so that all its monomorphizations can share a
+// single function. Any other use, e.g. setting a slot, passing the instance
+// to a call or returning it, depends on the instance itself.
+static bool canShareMonomorphizations(func::FuncOp func) {
+  for (BlockArgument arg : func.getArguments()) {
+    if (!arg.getType().isa<NnModuleType>())
+      continue;
+    for (Operation *user : arg.getUsers()) {
+      auto primGetAttr = dyn_cast<PrimGetAttrOp>(user);
+      if (!primGetAttr || primGetAttr.getType().isa<NnModuleType>())
+        return false;
+    }
+  }
+  return true;
+}
+
+// Rewrite `func` in place into the function shared by all of its
+// monomorphizations, populating `shared`.
+static void createSharedMonomorphization(func::FuncOp func,
+                                         SharedMonomorphization &shared) {
+  shared.func = func;
+  SmallVector<PrimGetAttrOp> primGetAttrs;
+  func.walk([&](PrimGetAttrOp op) { primGetAttrs.push_back(op); });
+  int numOriginalArgs = func.getNumArguments();
+  for (PrimGetAttrOp op : primGetAttrs) {
+    int argIndex = op.receiver().cast<BlockArgument>().getArgNumber();
+    auto it = llvm::find_if(
+        shared.slotArgs, [&](const SharedMonomorphization::SlotArg &slotArg) {
+          return slotArg.argIndex == argIndex && slotArg.name == op.name();
+        });
+    if (it == shared.slotArgs.end()) {
+      shared.slotArgs.push_back({argIndex, op.name().str(), op.getType()});
+      func.insertArgument(func.getNumArguments(), op.getType(),
+                          /*argAttrs=*/nullptr, op.getLoc());
+      it = std::prev(shared.slotArgs.end());
+    }
+    int slotArgNumber = numOriginalArgs + (it - shared.slotArgs.begin());
+    op.replaceAllUsesWith(func.getArgument(slotArgNumber));
+    op->erase();
+  }
+  llvm::BitVector argsToErase(func.getNumArguments());
+  for (auto type : llvm::enumerate(func.getArgumentTypes())) {
+    if (type.value().isa<NnModuleType>())
+      argsToErase.set(type.index());
+  }
+  func.eraseArguments(argsToErase);
+  func.setVisibility(SymbolTable::Visibility::Private);
+}
+
 // Rewrite `func`, given that all values of `NnModuleType` have been mapped in
 // `mapping` to corresponding global instances.
 static LogicalResult rewriteMonomorphizedFuncClone(
     func::FuncOp func, BlockAndValueMapping mapping, SymbolTable &symbolTable,
     DenseMap<Monomorphization, func::FuncOp> &newFuncs,
+    DenseMap<func::FuncOp, SharedMonomorphization> &sharedFuncs,
     ObjectGraphInfo &objectGraphInfo) {
 
   SmallVector<Operation *> toErase;
@@ -548,9 +656,29 @@ static LogicalResult rewriteMonomorphizedFuncClone(
         llvm::make_filter_range(op->getOperands(), [](Value v) {
           return !v.getType().isa<NnModuleType>();
         }));
-    assert(newFuncs.find(monomorphization) != newFuncs.end());
-    auto newOp = OpBuilder(op).create<func::CallOp>(
-        op.getLoc(), newFuncs[monomorphization], newArguments);
+    func::FuncOp callee;
+    auto shared = sharedFuncs.find(monomorphization.func);
+    if (shared != sharedFuncs.end()) {
+      // Pass the values of the slots of the instances to the shared function.
+      for (auto &slotArg : shared->second.slotArgs) {
+        auto instance = mapping.lookup(op.getOperand(slotArg.argIndex))
+                            .getDefiningOp<NnModuleOp>();
+        SlotOp affectedSlot;
+        for (auto slot : instance.getOps<SlotOp>()) {
+          if (slot.name() == slotArg.name)
+            affectedSlot = slot;
+        }
+        newArguments.push_back(OpBuilder(op).create<GlobalSlotGetOp>(
+            op.getLoc(), slotArg.type,
+            objectGraphInfo.getGlobalSlotFor(affectedSlot).sym_name()));
+      }
+      callee = shared->second.func;
+    } else {
+      assert(newFuncs.find(monomorphization) != newFuncs.end());
+      callee = newFuncs[monomorphization];
+    }
+    auto newOp =
+        OpBuilder(op).create<func::CallOp>(op.getLoc(), callee, newArguments);
     op.replaceAllUsesWith(newOp);
     toErase.push_back(op);
     return WalkResult::advance();
@@ -578,7 +706,8 @@ static LogicalResult rewriteMonomorphizedFuncClone(
   return success(!walkResult.wasInterrupted());
 }
 
-static LogicalResult globalizeObjectGraph(ModuleOp module) {
+static LogicalResult globalizeObjectGraph(ModuleOp module,
+                                          int minSharedMonomorphizations) {
 
   // Step 1: Traverse object graph and collect information.
 
@@ -636,19 +765,47 @@ static LogicalResult globalizeObjectGraph(ModuleOp module) {
 
   // Step 4: Clone/rewrite functions to implement the necessary
   // monomorphizations.
+  auto getLinkageInfo =
+      [&](const Monomorphization &monomorphization) -> Optional<LinkageInfo> {
+    // If it is potentially a method, check its linkage info.
+    if (monomorphization.argInstances.size() == 0 ||
+        monomorphization.argInstances[0].argIndex != 0)
+      return None;
+    return objectGraphInfo.getFuncLinkageInfo(
+        monomorphization.argInstances[0].instance.getDefiningOp<NnModuleOp>(),
+        monomorphization.func);
+  };
+
+  // Find the functions with at least `minSharedMonomorphizations`
+  // monomorphizations that can all share a single function. Their
+  // monomorphizations must all be private, since the shared function has a
+  // different signature. The functions with fewer monomorphizations are still
+  // cloned, since the clones are named after their instances.
+  DenseMap<func::FuncOp, int> numMonomorphizations;
+  DenseSet<func::FuncOp> funcsWithPublicMonomorphizations;
+  for (auto &monomorphization : tracker.getMonomorphizations()) {
+    numMonomorphizations[monomorphization.func] += 1;
+    Optional<LinkageInfo> linkageInfo = getLinkageInfo(monomorphization);
+    if (linkageInfo.hasValue() && !linkageInfo->isPrivate)
+      funcsWithPublicMonomorphizations.insert(monomorphization.func);
+  }
+  DenseMap<func::FuncOp, SharedMonomorphization> sharedFuncs;
+  for (auto &kv : numMonomorphizations) {
+    func::FuncOp func = kv.first;
+    if (kv.second > 1 && kv.second >= minSharedMonomorphizations &&
+        !funcsWithPublicMonomorphizations.contains(func) &&
+        canShareMonomorphizations(func))
+      sharedFuncs[func] = SharedMonomorphization();
+  }
+
   DenseMap<Monomorphization, func::FuncOp> newFuncs;
   int uniquifier = 0;
   for (auto &monomorphization : tracker.getMonomorphizations()) {
+    if (sharedFuncs.count(monomorphization.func))
+      continue;
     auto newFunc = cast<func::FuncOp>(monomorphization.func->clone());
     newFuncs[monomorphization] = newFunc;
-    Optional<LinkageInfo> linkageInfo = None;
-    // If it is potentially a method, check its linkage info.
-    if (monomorphization.argInstances.size() != 0 &&
-        monomorphization.argInstances[0].argIndex == 0) {
-      linkageInfo = objectGraphInfo.getFuncLinkageInfo(
-          monomorphization.argInstances[0].instance.getDefiningOp<NnModuleOp>(),
-          monomorphization.func);
-    }
+    Optional<LinkageInfo> linkageInfo = getLinkageInfo(monomorphization);
     if (linkageInfo.hasValue()) {
       // It's a method.
       newFunc.setVisibility(linkageInfo->isPrivate
@@ -664,12 +821,33 @@ static LogicalResult globalizeObjectGraph(ModuleOp module) {
     module.push_back(newFunc);
   }
 
+  // The shared functions are rewritten in place, now that all clones of the
+  // original functions have been created. They are moved after the clones, so
+  // that the functions appear in the same order as before.
+  for (auto &kv : tracker.getMonomorphizations()) {
+    auto it = sharedFuncs.find(kv.func);
+    if (it == sharedFuncs.end() || it->second.func)
+      continue;
+    createSharedMonomorphization(kv.func, it->second);
+    kv.func->moveBefore(module.getBody(), module.getBody()->end());
+  }
+
   for (auto &kv : newFuncs) {
     BlockAndValueMapping mapping;
     if (failed(analyzeInstances(kv.second, kv.first.argInstances, mapping)))
       return failure();
     if (failed(rewriteMonomorphizedFuncClone(kv.second, mapping, symbolTable,
-                                             newFuncs, objectGraphInfo)))
+                                             newFuncs, sharedFuncs,
+                                             objectGraphInfo)))
+      return failure();
+  }
+  // The shared functions don't have any values of `NnModuleType` left, but
+  // their calls to free functions still need to be rewritten.
+  for (auto &kv : sharedFuncs) {
+    if (failed(rewriteMonomorphizedFuncClone(kv.second.func,
+                                             BlockAndValueMapping(),
+                                             symbolTable, newFuncs,
+                                             sharedFuncs, objectGraphInfo)))
       return failure();
   }
 
@@ -678,6 +856,9 @@ static LogicalResult globalizeObjectGraph(ModuleOp module) {
   for (auto &kv : newFuncs) {
     liveFuncs.insert(kv.second);
   }
+  for (auto &kv : sharedFuncs) {
+    liveFuncs.insert(kv.second.func);
+  }
   for (auto &op : llvm::make_early_inc_range(module.getOps())) {
     if (isa<GlobalSlotOp>(&op))
       continue;
@@ -697,7 +878,8 @@ namespace {
 class GlobalizeObjectGraphPass
     : public GlobalizeObjectGraphBase<GlobalizeObjectGraphPass> {
   void runOnOperation() override {
-    if (failed(globalizeObjectGraph(getOperation())))
+    if (failed(globalizeObjectGraph(getOperation(),
+                                    minSharedMonomorphizations)))
       return signalPassFailure();
   }
 };
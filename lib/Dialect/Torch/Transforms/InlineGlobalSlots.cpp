@@ -15,6 +15,7 @@
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
@@ -48,8 +49,11 @@ class InlineGlobalSlotsPass
 
       if (!globalSlot)
         continue;
-      if (isa<Torch::GlobalSlotGetOp>(use.getUser()))
-        continue;
+      // The tensors read from a slot are the object stored in it, so mutating
+      // them in place writes to the slot.
+      if (auto globalSlotGet = dyn_cast<Torch::GlobalSlotGetOp>(use.getUser()))
+        if (!isMutatedInPlace(globalSlotGet.result()))
+          continue;
 
       potentiallyWrittenGlobalSlots.insert(globalSlot);
     }
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+// Returns true if `op` never raises an error, so that it can be executed even
+// where the program would not have executed it.
+static bool cannotFail(Operation *op) {
+  return op->hasTrait<mlir::OpTrait::ConstantLike>() ||
+         isa<PrimListConstructOp, PrimTupleConstructOp, DerefineOp,
+             AtenAddIntOp, AtenSubIntOp, AtenMulIntOp, AtenNegIntOp,
+             AtenEqIntOp, AtenNeIntOp, AtenLtIntOp, AtenLeIntOp, AtenGtIntOp,
+             AtenGeIntOp, AtenLenTOp, AtenSizeOp, AtenDimOp, PrimDtypeOp,
+             PrimDeviceOp>(op);
+}
+
+// Returns true if the body of `loop` is known to run at least once.
+static bool runsAtLeastOnce(PrimLoopOp loop) {
+  int64_t maxTripCount;
+  bool initialCondition;
+  return matchPattern(loop.maxTripCount(),
+                      m_TorchConstantInt(&maxTripCount)) &&
+         maxTripCount > 0 &&
+         matchPattern(loop.initialCondition(),
+                      m_TorchConstantBool(&initialCondition)) &&
+         initialCondition;
+}
+
+// Hoists the ops of the body of `loop` that only depend on values defined
+// outside of it before it. Their results are then computed once instead of
+// in every iteration. Unless the body runs at least once, only the ops that
+// cannot fail are hoisted, since the others may raise an error that the
+// program never raised, e.g. when indexing an empty list.
+static void hoistLoopInvariants(PrimLoopOp loop) {
+  Region &body = loop.region();
+  bool mayHoistFailingOps = runsAtLeastOnce(loop);
+  for (Operation &op :
+       llvm::make_early_inc_range(body.front().without_terminator())) {
+    if (!isMovableComputation(&op) ||
+        (!mayHoistFailingOps && !cannotFail(&op)) ||
+        !llvm::all_of(op.getOperands(),
+                      [&](Value v) { return isDefinedOutside(v, body); }))
+      continue;
+    op.moveBefore(loop);
+  }
+}
+
+// Returns true if `lhs` and `rhs` compute the same results.
+static bool isEquivalent(Operation *lhs, Operation *rhs) {
+  return lhs->getName() == rhs->getName() &&
+         lhs->getAttrDictionary() == rhs->getAttrDictionary() &&
+         llvm::equal(lhs->getOperands(), rhs->getOperands()) &&
+         llvm::equal(lhs->getResultTypes(), rhs->getResultTypes());
+}
+
+namespace {
+class LoopInvariantCodeMotionPass
+    : public LoopInvariantCodeMotionBase<LoopInvariantCodeMotionPass> {
+  void runOnOperation() override {
+    // Visit the nested regions first, so that the ops hoisted out of them can
+    // then be hoisted further.
+    getOperation().walk([&](Operation *op) {
+      if (auto loop = dyn_cast<PrimLoopOp>(op))
+        hoistLoopInvariants(loop);
+      else if (auto ifOp = dyn_cast<PrimIfOp>(op))
+        hoistCommonOps(ifOp, isEquivalent);
+    });
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createLoopInvariantCodeMotionPass() {
+  return std::make_unique<LoopInvariantCodeMotionPass>();
+}
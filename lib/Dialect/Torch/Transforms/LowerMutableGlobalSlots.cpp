@@ -0,0 +1,170 @@
+//===- LowerMutableGlobalSlots.cpp -------------------------------*- C++-*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "llvm/ADT/MapVector.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+namespace {
+// A tensor slot, and what it is lowered to.
+struct TensorSlot {
+  // The value-semantic type of the tensors stored in the slot.
+  ValueTensorType type;
+  // Whether the slot is set, or its tensor mutated in place, by the program.
+  bool written = false;
+};
+} // namespace
+
+// Returns the literal that `globalSlot` is initialized with, if any.
+static NonValueTensorLiteralOp getInitialLiteral(GlobalSlotOp globalSlot) {
+  auto init = cast<GlobalSlotInitOp>(globalSlot.getBody()->getTerminator());
+  return init.initialValue().getDefiningOp<NonValueTensorLiteralOp>();
+}
+
+// Rewrites the accesses to the tensor slots in `func`, which must all be in
+// its entry block, as described in the pass description.
+static LogicalResult
+lowerSlotAccesses(func::FuncOp func,
+                  const llvm::MapVector<StringAttr, TensorSlot> &slots) {
+  auto getSlot = [&](FlatSymbolRefAttr symbol) -> const TensorSlot * {
+    auto it = slots.find(symbol.getAttr());
+    return it == slots.end() ? nullptr : &it->second;
+  };
+  auto walkResult = func.walk([&](Operation *op) {
+    FlatSymbolRefAttr symbol;
+    if (auto get = dyn_cast<GlobalSlotGetOp>(op))
+      symbol = get.slotAttr();
+    else if (auto set = dyn_cast<GlobalSlotSetOp>(op))
+      symbol = set.slotAttr();
+    if (!symbol || !getSlot(symbol) ||
+        op->getBlock() == &func.getBody().front())
+      return WalkResult::advance();
+    op->emitError("unimplemented: tensor global slot accessed outside of the "
+                  "entry block of its function");
+    return WalkResult::interrupt();
+  });
+  if (walkResult.wasInterrupted())
+    return failure();
+
+  // The tensor object stored in each slot at the current point of the
+  // function. Like in Python, all the reads of a slot between two writes
+  // return the same object, whose mutations are seen by the later reads.
+  DenseMap<StringAttr, Value> objects;
+  OpBuilder builder(func.getContext());
+  for (Operation &op :
+       llvm::make_early_inc_range(func.getBody().front().getOperations())) {
+    Location loc = op.getLoc();
+    builder.setInsertionPoint(&op);
+    if (auto get = dyn_cast<GlobalSlotGetOp>(op)) {
+      const TensorSlot *slot = getSlot(get.slotAttr());
+      if (!slot)
+        continue;
+      Value &object = objects[get.slotAttr().getAttr()];
+      if (!object) {
+        Value value =
+            builder.create<GlobalSlotGetOp>(loc, slot->type, get.slotAttr());
+        object = builder.create<CopyToNonValueTensorOp>(loc, value);
+      }
+      Value replacement = object;
+      if (replacement.getType() != get.getType())
+        replacement = builder.create<TensorStaticInfoCastOp>(
+            loc, get.getType(), replacement);
+      get.replaceAllUsesWith(replacement);
+      get.erase();
+    } else if (auto set = dyn_cast<GlobalSlotSetOp>(op)) {
+      if (!getSlot(set.slotAttr()))
+        continue;
+      objects[set.slotAttr().getAttr()] = set.value();
+      set.erase();
+    } else if (isa<func::ReturnOp>(op)) {
+      // Store the contents of the objects of the written slots back.
+      for (auto &it : slots) {
+        Value object = objects.lookup(it.first);
+        if (!object || !it.second.written)
+          continue;
+        Value value = builder.create<CopyToValueTensorOp>(loc, object);
+        if (value.getType() != it.second.type)
+          value = builder.create<TensorStaticInfoCastOp>(loc, it.second.type,
+                                                         value);
+        builder.create<GlobalSlotSetOp>(
+            loc, FlatSymbolRefAttr::get(it.first), value);
+      }
+    }
+  }
+  return success();
+}
+
+namespace {
+class LowerMutableGlobalSlotsPass
+    : public LowerMutableGlobalSlotsBase<LowerMutableGlobalSlotsPass> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+
+    llvm::MapVector<StringAttr, TensorSlot> slots;
+    for (auto globalSlot : module.getOps<GlobalSlotOp>()) {
+      if (!globalSlot.typeBound().isa<NonValueTensorType>())
+        continue;
+      NonValueTensorLiteralOp literal = getInitialLiteral(globalSlot);
+      if (!literal) {
+        globalSlot.emitError("unimplemented: tensor global slot not "
+                             "initialized with a tensor literal");
+        return signalPassFailure();
+      }
+
+      // Store a value-semantic literal in the slot, whose type is that of
+      // the slot from now on.
+      OpBuilder builder(literal);
+      auto valueLiteral = builder.create<ValueTensorLiteralOp>(
+          literal.getLoc(), literal.valueAttr());
+      globalSlot.getBody()->getTerminator()->setOperand(0, valueLiteral);
+      if (literal->use_empty())
+        literal.erase();
+      TensorSlot &slot = slots[globalSlot.sym_nameAttr()];
+      slot.type = valueLiteral.getType().cast<ValueTensorType>();
+      globalSlot->setAttr("typeBound", TypeAttr::get(slot.type));
+    }
+    if (slots.empty())
+      return;
+
+    module.walk([&](Operation *op) {
+      if (auto set = dyn_cast<GlobalSlotSetOp>(op)) {
+        auto it = slots.find(set.slotAttr().getAttr());
+        if (it != slots.end())
+          it->second.written = true;
+      } else if (auto get = dyn_cast<GlobalSlotGetOp>(op)) {
+        auto it = slots.find(get.slotAttr().getAttr());
+        if (it != slots.end() && isMutatedInPlace(get.result()))
+          it->second.written = true;
+      }
+    });
+
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (func.isExternal())
+        continue;
+      if (failed(lowerSlotAccesses(func, slots)))
+        return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::Torch::createLowerMutableGlobalSlotsPass() {
+  return std::make_unique<LowerMutableGlobalSlotsPass>();
+}
@@ -16,6 +16,7 @@
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -27,19 +28,6 @@ static Value assertNonValueTensor(Value tensor) {
   return tensor;
 }
 
-static bool isViewLikeOp(Operation *op) {
-  // AtenContiguousOp might return a view, so this is conservatively
-  // correct. We could potentially be more precise and identify the cases
-  // that it does not return a view and treat those as having value
-  // semantics.
-  return isa<AtenBroadcastToOp, AtenContiguousOp, AtenDetachOp, AtenExpandAsOp,
-             AtenExpandOp, AtenFlattenUsingIntsOp, AtenPermuteOp, AtenReshapeOp,
-             Aten_ReshapeAliasOp, AtenSelectIntOp, AtenSliceTensorOp,
-             AtenSqueezeDimOp, AtenSqueezeOp, AtenTOp, AtenToDtypeOp,
-             AtenTransposeIntOp, AtenUnsqueezeOp, AtenViewOp,
-             TensorStaticInfoCastOp, AtenToDtypeLayoutOp, AtenNumpyTOp>(op);
-}
-
 namespace {
 class AbstractlyInterpretCopyToNonValueTensorOpUsersWithinABlock
     : public OpRewritePattern<CopyToNonValueTensorOp> {
@@ -56,19 +44,24 @@ public:
   };
 
   // Check that graph rewriting is possible by doing an abstract
-  // interpretation within a single basic block. If rewriting is
-  // possible, the interpreted ops are returned split into their
-  // respective categories.
+  // interpretation within a single basic block, and the regions of the ops
+  // in it. If rewriting is possible, the interpreted ops are returned split
+  // into their respective categories.
   static FailureOr<InterpretedOps> abstractlyInterpretSlice(
       CopyToNonValueTensorOp copyToNonValueTensor,
       const DenseMap<Operation *, SmallVector<Value>> &nonValueTensorsUsedByOp,
       PatternRewriter &rewriter) {
-    // Sort by order in the block, so we can abstractly interpret the ops.
-    SmallVector<Operation *> nonValueTensorUsers(
-        llvm::make_first_range(nonValueTensorsUsedByOp));
-    llvm::sort(nonValueTensorUsers, [](Operation *lhs, Operation *rhs) {
-      return lhs->isBeforeInBlock(rhs);
-    });
+    // Sort in program order, so we can abstractly interpret the ops. Ops in
+    // the regions of an op come right after it.
+    SmallVector<Operation *> nonValueTensorUsers;
+    for (Operation &op : llvm::make_range(
+             copyToNonValueTensor->getIterator(),
+             copyToNonValueTensor->getBlock()->end())) {
+      op.walk<WalkOrder::PreOrder>([&](Operation *nestedOp) {
+        if (nonValueTensorsUsedByOp.count(nestedOp))
+          nonValueTensorUsers.push_back(nestedOp);
+      });
+    }
 
     // We track the available aliases at each point as well as split the
     // users into view-like, copy-to-value, and overwrite ops as we walk
@@ -98,6 +91,14 @@ public:
       } else if (auto copyToValueTensor = dyn_cast<CopyToValueTensorOp>(user)) {
         result.copyLikeOps.push_back(copyToValueTensor);
       } else if (auto overwrite = dyn_cast<OverwriteTensorContentsOp>(user)) {
+        // An overwrite in a region would only conditionally (or repeatedly)
+        // change the contents of the tensor, which can't be expressed by
+        // simply forwarding the new value to the later users.
+        if (overwrite->getBlock() != copyToNonValueTensor->getBlock()) {
+          return rewriter.notifyMatchFailure(
+              copyToNonValueTensor,
+              "unimplemented: overwrite nested in a region");
+        }
         // To simplify the analysis, we only support the case where the
         // only aliases used after an overwrite are the aliases generated
         // after plus the alias being overwritten.
@@ -120,6 +121,7 @@ public:
   // value semantics everywhere.
   static void rewriteSlice(const InterpretedOps &ops,
                            PatternRewriter &rewriter) {
+    Block *block = ops.copyLikeOps.front()->getBlock();
 
     DenseMap<int, Type> originalReturnTypes;
     if (ops.returnOp.hasValue()) {
@@ -142,7 +144,10 @@ public:
       Value overwritten = assertNonValueTensor(overwrite.overwritten());
       overwritten.replaceUsesWithIf(
           overwrite.value(), [&](const OpOperand &operand) {
-            return !operand.getOwner()->isBeforeInBlock(overwrite);
+            // Uses nested in the regions of an op are ordered like that op.
+            Operation *owner =
+                block->findAncestorOpInBlock(*operand.getOwner());
+            return !owner->isBeforeInBlock(overwrite);
           });
       rewriter.eraseOp(overwrite);
     }
@@ -199,7 +204,10 @@ public:
     while (!workList.empty()) {
       OpOperand &operand = workList.pop_back_val();
       Operation *op = operand.getOwner();
-      if (op->getBlock() != copy->getBlock()) {
+      // Users nested in the regions of ops such as `torch.prim.If` and
+      // `torch.prim.Loop` are fine, since the regions are executed in
+      // program order with respect to the rest of the block.
+      if (!copy->getBlock()->findAncestorOpInBlock(*op)) {
         return rewriter.notifyMatchFailure(
             copy, "can only analyze within a single basic block");
       }
@@ -264,8 +272,8 @@ namespace {
 // and ending at CopyToValueTensorOp's. If all intervening ops
 // are just view-like operations (i.e. no mutation), then we can trivially
 // convert them all to value semantics.
-// This pattern handles the case where views span multiple basic blocks,
-// which is currently not supported by
+// This pattern handles the case where views span multiple basic blocks of a
+// CFG region, which is currently not supported by
 // `AbstractlyInterpretCopyToNonValueTensorOpUsersWithinABlock`.
 class RewriteViewLikeSubgraph
     : public OpRewritePattern<CopyToNonValueTensorOp> {
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/Builders.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+static constexpr StringLiteral kExpectedShapeAttrName = "torch.expected_shape";
+
+namespace {
+struct SpecializedArg {
+  BlockArgument arg;
+  ArrayRef<int64_t> sizes;
+  SmallVector<int64_t> expectedShape;
+};
+} // namespace
+
+// Returns the arguments of `func` with a `torch.expected_shape` more static
+// than their type.
+static FailureOr<SmallVector<SpecializedArg>>
+getSpecializedArgs(func::FuncOp func) {
+  SmallVector<SpecializedArg> specializedArgs;
+  for (BlockArgument arg : func.getArguments()) {
+    auto expectedShapeAttr =
+        func.getArgAttrOfType<ArrayAttr>(arg.getArgNumber(),
+                                         kExpectedShapeAttrName);
+    if (!expectedShapeAttr)
+      continue;
+    auto type = arg.getType().dyn_cast<ValueTensorType>();
+    if (!type || !type.hasSizes() ||
+        type.getSizes().size() != expectedShapeAttr.size()) {
+      return func.emitError() << "expected shape of argument "
+                              << arg.getArgNumber()
+                              << " must be for a value tensor of its rank";
+    }
+    SpecializedArg specialized{arg, type.getSizes(), {}};
+    bool isMoreStatic = false;
+    for (auto it : llvm::zip(type.getSizes(), expectedShapeAttr)) {
+      int64_t size = std::get<0>(it);
+      int64_t expectedSize = std::get<1>(it).cast<IntegerAttr>().getInt();
+      if (expectedSize < 0 || (size != kUnknownSize && size != expectedSize)) {
+        return func.emitError() << "expected shape of argument "
+                                << arg.getArgNumber()
+                                << " doesn't match its static sizes";
+      }
+      isMoreStatic |= size == kUnknownSize;
+      specialized.expectedShape.push_back(expectedSize);
+    }
+    if (isMoreStatic)
+      specializedArgs.push_back(specialized);
+  }
+  return specializedArgs;
+}
+
+// Returns whether the sizes of the dynamic dimensions of the specialized
+// arguments are the expected ones. The comparisons are chained like the
+// `and` of TorchScript, so that they lower to plain `scf.if`s.
+static Value createExpectedShapeCheck(OpBuilder &b, Location loc,
+                                      ArrayRef<SpecializedArg> args) {
+  Value isExpected;
+  for (const SpecializedArg &specialized : args) {
+    for (auto it : llvm::enumerate(specialized.sizes)) {
+      if (it.value() != kUnknownSize)
+        continue;
+      Value dim =
+          b.create<ConstantIntOp>(loc, b.getI64IntegerAttr(it.index()));
+      Value size = b.create<AtenSizeIntOp>(loc, specialized.arg, dim);
+      Value expectedSize = b.create<ConstantIntOp>(
+          loc, b.getI64IntegerAttr(specialized.expectedShape[it.index()]));
+      Value isExpectedSize = b.create<AtenEqIntOp>(loc, size, expectedSize);
+      if (!isExpected) {
+        isExpected = isExpectedSize;
+        continue;
+      }
+      auto primIf =
+          b.create<PrimIfOp>(loc, b.getType<Torch::BoolType>(), isExpected);
+      b.createBlock(&primIf.thenRegion(), primIf.thenRegion().end());
+      b.create<PrimIfYieldOp>(loc, isExpectedSize);
+      b.createBlock(&primIf.elseRegion(), primIf.elseRegion().end());
+      b.create<PrimIfYieldOp>(
+          loc, ValueRange{b.create<ConstantBoolOp>(loc, false)});
+      b.setInsertionPointAfter(primIf);
+      isExpected = primIf.getResult(0);
+    }
+  }
+  return isExpected;
+}
+
+// Turns the body of `func` into
+//   if <the dynamic sizes of the arguments are the expected ones>:
+//     <body, with the arguments cast to their expected shapes>
+//   else:
+//     <body>
+// Refining the types then makes the first version fully static.
+//
+// The users of the arguments in the first version read the static casts
+// directly when they allow refining their types, so that the canonicalizer
+// can't fold the casts away before the types are refined. The others read
+// them cast back to the original types.
+static LogicalResult multiversion(func::FuncOp func) {
+  FailureOr<SmallVector<SpecializedArg>> specializedArgs =
+      getSpecializedArgs(func);
+  if (failed(specializedArgs))
+    return failure();
+  for (unsigned i = 0, e = func.getNumArguments(); i < e; i++)
+    func.removeArgAttr(i, kExpectedShapeAttrName);
+  if (specializedArgs->empty())
+    return success();
+  if (!func.getBody().hasOneBlock())
+    return func.emitError("unimplemented: multiversioning a function with "
+                          "more than one block");
+
+  Block &body = func.getBody().front();
+  auto returnOp = cast<func::ReturnOp>(body.getTerminator());
+  Location loc = func.getLoc();
+  OpBuilder b(func.getContext());
+  b.setInsertionPointToStart(&body);
+  Value isExpected = createExpectedShapeCheck(b, loc, *specializedArgs);
+  auto primIf =
+      b.create<PrimIfOp>(loc, returnOp.getOperandTypes(), isExpected);
+
+  // The generic version is the original body.
+  Block *elseBlock =
+      b.createBlock(&primIf.elseRegion(), primIf.elseRegion().end());
+  elseBlock->getOperations().splice(elseBlock->end(), body.getOperations(),
+                                    std::next(primIf->getIterator()),
+                                    returnOp->getIterator());
+  b.create<PrimIfYieldOp>(loc, returnOp.getOperands());
+
+  // The specialized version reads the arguments through casts to their
+  // expected shapes.
+  b.createBlock(&primIf.thenRegion(), primIf.thenRegion().end());
+  BlockAndValueMapping mapping;
+  SmallVector<Value> expectedArgs;
+  for (const SpecializedArg &specialized : *specializedArgs) {
+    auto type = specialized.arg.getType().cast<ValueTensorType>();
+    Value expected = b.create<TensorStaticInfoCastOp>(
+        loc,
+        type.getWithSizesAndDtype(makeArrayRef(specialized.expectedShape),
+                                  type.getDtype()),
+        specialized.arg);
+    mapping.map(specialized.arg, expected);
+    expectedArgs.push_back(expected);
+  }
+  for (Operation &op : elseBlock->without_terminator())
+    b.clone(op, mapping);
+  b.create<PrimIfYieldOp>(
+      loc, llvm::to_vector(llvm::map_range(returnOp.getOperands(),
+                                           [&](Value v) {
+                                             return mapping.lookupOrDefault(v);
+                                           })));
+
+  b.setInsertionPointAfter(expectedArgs.back().getDefiningOp());
+  for (auto it : llvm::zip(*specializedArgs, expectedArgs)) {
+    Value expected = std::get<1>(it);
+    Value castBack;
+    for (OpOperand &use : llvm::make_early_inc_range(expected.getUses())) {
+      if (use.getOwner()->hasTrait<Torch::OpTrait::AllowsTypeRefinement>())
+        continue;
+      if (!castBack)
+        castBack = b.create<TensorStaticInfoCastOp>(
+            loc, std::get<0>(it).arg.getType(), expected);
+      use.set(castBack);
+    }
+  }
+
+  returnOp->setOperands(primIf.getResults());
+  return success();
+}
+
+namespace {
+class MultiversionExpectedShapesPass
+    : public MultiversionExpectedShapesBase<MultiversionExpectedShapesPass> {
+  void runOnOperation() override {
+    if (failed(multiversion(getOperation())))
+      return signalPassFailure();
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::Torch::createMultiversionExpectedShapesPass() {
+  return std::make_unique<MultiversionExpectedShapesPass>();
+}
@@ -30,6 +30,11 @@ void mlir::torch::registerTorchPasses() {
       "torch-function-to-torch-backend-pipeline",
       "Pipeline lowering a Torch function to Torch backend form.",
       mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline);
+  mlir::PassPipelineRegistration<Torch::TorchLoweringPipelineOptions>(
+      "torch-simplification-pipeline",
+      "Pipeline doing one round of refinement and simplification of a Torch "
+      "function.",
+      mlir::torch::Torch::createTorchSimplificationPipeline);
   mlir::PassPipelineRegistration<Torch::TorchLoweringPipelineOptions>(
       "torch-shape-refinement-pipeline", "Pipeline refining shapes of tensors.",
       mlir::torch::Torch::createTorchShapeRefinementPipeline);
@@ -89,7 +94,7 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
   // "optimize hard enough that it works" transformations.
 
   // Incorporate user annotations and remove signature Python-isms.
-  pm.addPass(createAdjustCallingConventionsPass());
+  pm.addPass(createAdjustCallingConventionsPass(options.weightsAsArguments));
 
   if (options.optimize) {
     // Eliminate the PrimTupleIndexOp generated from the
@@ -102,8 +107,29 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
     // Also don't rely on this pass to expose constants into the program to
     // simplify handling of "optional".
     pm.addPass(createInlineGlobalSlotsPass());
+    // The batch norms whose `training` flag is read from a slot may update
+    // their running stats, which are only inlined once the flag is folded
+    // to false, e.g. for a module in eval mode.
+    pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+    pm.addPass(createInlineGlobalSlotsPass());
+    // Merge the identical literals that inlining the global slots exposed.
+    pm.addPass(createDeduplicateLiteralsPass());
   }
 
+  // Turn the tensor global slots that are left, which the program mutates,
+  // into value-semantic slots read and written once per call.
+  pm.addPass(createLowerMutableGlobalSlotsPass());
+
+  // Drop the training-only computations before they get analyzed. This runs
+  // before ReduceOpVariants, which turns the batch norms in training mode into
+  // updates of their running stats.
+  if (options.inference)
+    pm.addNestedPass<func::FuncOp>(Torch::createForceInferenceModePass());
+
+  // Add a static version of the functions for the expected shapes of their
+  // dynamic arguments, before the types get refined.
+  pm.addNestedPass<func::FuncOp>(Torch::createMultiversionExpectedShapesPass());
+
   // Reduce variants of ops to a smaller set of primitives.
   pm.addNestedPass<func::FuncOp>(createReduceOpVariantsPass());
 
@@ -113,10 +139,6 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
     // RaiseException, unimplemented tensor ops, and only-used-in-training
     // operations on `torch.global_slot`'s.
     pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
-    // OPT-ONLY: We may have deleted some `torch.global_slot.get` /
-    // `torch.global_slot.get` ops, which may have left more
-    // `torch.global_slot`'s unused.
-    pm.addPass(createSymbolDCEPass());
   }
 
   //===--------------------------------------------------------------------===//
@@ -126,6 +148,44 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
   // Convert the bulk of non-ABI-visible !torch.tensor's to !torch.vtensor's.
   pm.addNestedPass<func::FuncOp>(Torch::createMaximizeValueSemanticsPass());
 
+  if (options.optimize) {
+    // OPT-ONLY: We may have deleted some `torch.global_slot.get` /
+    // `torch.global_slot.get` ops, which may have left more
+    // `torch.global_slot`'s unused.
+    // This runs right before the module-level shape reification rather than
+    // after the canonicalization above, so that the function passes from
+    // ReduceOpVariants to MaximizeValueSemantics form a single group, which
+    // the pass manager runs on all the functions in parallel.
+    pm.addPass(createSymbolDCEPass());
+  }
+
+  // Refine the shapes and dtypes of the program, then simplify and decompose
+  // it with the information found, until it stops changing: decompositions
+  // and folds expose new ops to refine, which in turn expose more folds.
+  pm.addPass(Torch::createSimplifyToFixedPointPass(
+      options.maxSimplificationIterations, options.optimize, options.decompose,
+      options.backendLegalOps));
+
+  if (options.optimize) {
+    // Merge the tensors computed several times, e.g. in both branches of a
+    // `prim.If` or with swapped operands, which CSE doesn't, then compute
+    // the loop-invariant ops of `prim.Loop`s, including the ones created by
+    // the decompositions, once before the loops.
+    pm.addNestedPass<func::FuncOp>(Torch::createGlobalValueNumberingPass());
+    pm.addNestedPass<func::FuncOp>(Torch::createLoopInvariantCodeMotionPass());
+  }
+
+  // Lower the precision of matmuls and convolutions once `aten.matmul` has
+  // been decomposed, so that its `aten.mm` and `aten.bmm` forms are seen.
+  if (!options.autoCastDtype.empty())
+    pm.addNestedPass<func::FuncOp>(
+        Torch::createAutoCastPass(options.autoCastDtype));
+
+  // TODO: VerifyTorchBackendContractPass.
+}
+
+void mlir::torch::Torch::createTorchSimplificationPipeline(
+    OpPassManager &pm, const TorchLoweringPipelineOptions &options) {
   // Do shape refinement.
   // This must be run before RefineTypes (which primarily does dtype inference),
   // because Torch type promotion rules actually depend on the shape of the
@@ -138,13 +198,6 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
   // the previous pass. Doing this is ABI-compatible for our backends.
   pm.addPass(Torch::createRefinePublicReturnPass());
 
-  if (options.optimize) {
-    // This can fold away some branches given the information got from
-    // RefineTypes before doing maximize value sematics which only works with
-    // basic blocks.
-    pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
-  }
-
   if (options.optimize) {
     // All the type refinement we've done above has exposed new information
     // that allows folding away more stuff.
@@ -153,14 +206,27 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
     // as lists, RaiseException, unimplemented aten ops, and
     // only-used-in-training operations on `torch.global_slot`'s.
     pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+    // The `training` flags of batch norms are now constant, so fold the
+    // inference-mode ones into the convolutions feeding them.
+    pm.addNestedPass<func::FuncOp>(Torch::createFoldConvBatchNormPass());
   }
 
   if (options.decompose) {
-    pm.addNestedPass<func::FuncOp>(Torch::createDecomposeComplexOpsPass());
+    pm.addNestedPass<func::FuncOp>(
+        Torch::createDecomposeComplexOpsPass(options.backendLegalOps));
     pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
   }
 
-  // TODO: VerifyTorchBackendContractPass.
+  if (options.optimize) {
+    // Compute the ops on small literal tensors, including the ones exposed by
+    // the decompositions, at compile time.
+    pm.addNestedPass<func::FuncOp>(
+        Torch::createFoldLiteralTensorsPass(/*maxElements=*/4096,
+                                            /*maxSplatElements=*/1 << 20));
+    // Remove the conversions to wider dtypes and back introduced by type
+    // promotion, including the ones of the literals folded above.
+    pm.addNestedPass<func::FuncOp>(Torch::createElideDtypeConversionsPass());
+  }
 }
 
 void mlir::torch::Torch::createTorchShapeRefinementPipeline(
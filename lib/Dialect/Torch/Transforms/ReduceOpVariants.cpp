@@ -12,6 +12,7 @@
 #include "mlir/Transforms/DialectConversion.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "llvm/ADT/StringExtras.h"
 
 using namespace mlir;
@@ -36,6 +37,13 @@ static void createOverwriteTensorContents(PatternRewriter &rewriter,
                                              overwrittenTensor);
 }
 
+// Record on the value-semantic replacement `op` of an in-place op that its
+// result overwrites its first operand. Backends can use this as a hint to
+// compute the result into the storage of that operand.
+static void markInplace(Operation *op) {
+  op->setAttr("torch.inplace", UnitAttr::get(op->getContext()));
+}
+
 namespace {
 // Convert value semantic ops operating on mutable arrays to instead operate on
 // immutable tensors.
@@ -45,7 +53,8 @@ public:
       : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context) {}
   LogicalResult matchAndRewrite(Operation *op,
                                 PatternRewriter &rewriter) const override {
-    if (!op->hasTrait<Torch::OpTrait::HasValueSemantics>())
+    if (!op->hasTrait<Torch::OpTrait::HasValueSemantics>() &&
+        getCustomKernel(op).empty())
       return rewriter.notifyMatchFailure(op, "does not have value semantics");
 
     rewriter.startRootUpdate(op);
@@ -171,6 +180,7 @@ public:
       return failure();
     }
 
+    markInplace(newOp);
     auto tensor =
         rewriter.create<CopyToValueTensorOp>(loc, newOp->getResult(0));
     createOverwriteTensorContents(rewriter, loc, tensor, op->getOperand(0));
@@ -208,6 +218,7 @@ public:
            "Torch JIT operators shouldn't have regions or successors");
 
     Operation *newOp = rewriter.create(state);
+    markInplace(newOp);
     auto tensor =
         rewriter.create<CopyToValueTensorOp>(op->getLoc(), newOp->getResult(0));
     createOverwriteTensorContents(rewriter, op->getLoc(), tensor,
@@ -219,6 +230,146 @@ public:
 };
 } // namespace
 
+namespace {
+// Reduce an `aten.copy_` into a chain of `aten.slice.Tensor` and
+// `aten.select.int` views of a tensor, which is how slice assignments like
+// `x[:, i] = y` are imported, to `aten.slice_scatter`s and
+// `aten.select_scatter`s of the copied values into the tensor + an overwrite
+// of the tensor. Unlike an overwrite of the view, this lets backends whose
+// bufferization updates tensors in place, like one-shot bufferization, write
+// only the slice instead of materializing a copy of the whole tensor.
+class ReduceCopyIntoSlice : public OpRewritePattern<AtenCopy_Op> {
+public:
+  ReduceCopyIntoSlice(MLIRContext *context)
+      : OpRewritePattern<AtenCopy_Op>(context, /*benefit=*/2) {}
+  LogicalResult matchAndRewrite(AtenCopy_Op op,
+                                PatternRewriter &rewriter) const override {
+    if (!op->use_empty())
+      return rewriter.notifyMatchFailure(op, "result of the copy is used");
+
+    // The views that are only used to be copied into, innermost first.
+    SmallVector<Operation *> views;
+    Value base = op.self();
+    while (base.hasOneUse() &&
+           isa_and_nonnull<AtenSliceTensorOp, AtenSelectIntOp>(
+               base.getDefiningOp())) {
+      views.push_back(base.getDefiningOp());
+      base = views.back()->getOperand(0);
+    }
+    if (views.empty())
+      return rewriter.notifyMatchFailure(op, "not a copy into a slice");
+    if (!base.getType().isa<NonValueTensorType>())
+      return rewriter.notifyMatchFailure(op, "sliced tensor is not mutable");
+
+    // Read the views from the value of the base tensor, outermost first.
+    Location loc = op.getLoc();
+    SmallVector<Value> viewInputs;
+    Value value = rewriter.create<CopyToValueTensorOp>(loc, base);
+    for (Operation *view : llvm::reverse(views)) {
+      viewInputs.push_back(value);
+      Operation *valueView = rewriter.clone(*view);
+      valueView->setOperand(0, value);
+      value = valueView->getResult(0);
+      value.setType(
+          value.getType().cast<NonValueTensorType>().getWithValueSemantics());
+    }
+
+    // Copy into the innermost view, then scatter each updated view into its
+    // input, innermost first.
+    Value src = rewriter.create<CopyToValueTensorOp>(loc, op.src());
+    Value updated = rewriter.create<ValsemVariantAtenCopyOp>(
+        loc, value.getType(), value, src, op.non_blocking());
+    Operation *scatter = nullptr;
+    for (auto it : llvm::zip(views, llvm::reverse(viewInputs))) {
+      Operation *view = std::get<0>(it);
+      Value input = std::get<1>(it);
+      if (auto slice = dyn_cast<AtenSliceTensorOp>(view)) {
+        scatter = rewriter.create<AtenSliceScatterOp>(
+            loc, input.getType(), input, updated, slice.dim(), slice.start(),
+            slice.end(), slice.step());
+      } else {
+        auto select = cast<AtenSelectIntOp>(view);
+        scatter = rewriter.create<AtenSelectScatterOp>(
+            loc, input.getType(), input, updated, select.dim(),
+            select.index());
+      }
+      updated = scatter->getResult(0);
+    }
+    markInplace(scatter);
+    createOverwriteTensorContents(rewriter, loc, updated, base);
+
+    rewriter.eraseOp(op);
+    for (Operation *view : views)
+      rewriter.eraseOp(view);
+    return success();
+  }
+};
+} // namespace
+
+// Returns the non-value tensor that `value` is, possibly through a
+// `torch.derefine`, or null.
+static Value getNonValueTensor(Value value) {
+  if (auto derefine = value.getDefiningOp<DerefineOp>())
+    value = derefine.operand();
+  return value.getType().isa<NonValueTensorType>() ? value : Value();
+}
+
+// Returns the running mean and variance that `op`, a batch norm, updates in
+// place, which it does in training mode if they are given.
+template <typename OpTy>
+static Optional<std::pair<Value, Value>> getUpdatedRunningStats(OpTy op) {
+  bool training;
+  if (!matchPattern(op.training(), m_TorchConstantBool(&training)) ||
+      !training)
+    return None;
+  Value runningMean = getNonValueTensor(op.running_mean());
+  Value runningVar = getNonValueTensor(op.running_var());
+  if (!runningMean || !runningVar)
+    return None;
+  return std::make_pair(runningMean, runningVar);
+}
+
+namespace {
+// Reduce a batch norm in training mode to
+// `torch.valsem.aten.native_batch_norm.functional` + overwrites of its running
+// stats with the updated ones.
+template <typename OpTy>
+class ReduceBatchNormRunningStatsUpdate : public OpRewritePattern<OpTy> {
+public:
+  ReduceBatchNormRunningStatsUpdate(MLIRContext *context)
+      : OpRewritePattern<OpTy>(context, /*benefit=*/2) {}
+  LogicalResult matchAndRewrite(OpTy op,
+                                PatternRewriter &rewriter) const override {
+    Optional<std::pair<Value, Value>> runningStats =
+        getUpdatedRunningStats(op);
+    if (!runningStats)
+      return rewriter.notifyMatchFailure(op, "no running stats to update");
+    Value runningMean = runningStats->first;
+    Value runningVar = runningStats->second;
+
+    Location loc = op.getLoc();
+    auto inputType = op.input().getType().template cast<BaseTensorType>();
+    Type statType = inputType.getWithSizesAndDtype(
+        ArrayRef<int64_t>{kUnknownSize}, inputType.getOptionalDtype());
+    auto newOp = rewriter.create<ValsemVariantAtenNativeBatchNormFunctionalOp>(
+        loc,
+        TypeRange{op->getResult(0).getType(), statType, statType,
+                  runningMean.getType(), runningVar.getType()},
+        op.input(), op.weight(), op.bias(), runningMean, runningVar,
+        op.training(), op.momentum(), op.eps());
+    for (auto it : llvm::zip(ValueRange{newOp.new_running_mean(),
+                                        newOp.new_running_var()},
+                             ValueRange{runningMean, runningVar})) {
+      auto tensor = rewriter.create<CopyToValueTensorOp>(loc, std::get<0>(it));
+      createOverwriteTensorContents(rewriter, loc, tensor, std::get<1>(it));
+    }
+    rewriter.replaceOp(
+        op, newOp->getResults().take_front(op->getNumResults()));
+    return success();
+  }
+};
+} // namespace
+
 static LogicalResult
 reduceNonValueTensorLiteralOpToValueTensorLiteralOp(NonValueTensorLiteralOp op,
                                                     PatternRewriter &rewriter) {
@@ -239,6 +390,10 @@ class ReduceOpVariantsPass : public ReduceOpVariantsBase<ReduceOpVariantsPass> {
     patterns.add<ReduceTrailingUnderscoreInplaceVariant>(context);
     patterns.add(reduceNonValueTensorLiteralOpToValueTensorLiteralOp);
     patterns.add<ReduceNonValueSemanticOps>(context);
+    patterns.add<ReduceCopyIntoSlice>(context);
+    patterns.add<ReduceBatchNormRunningStatsUpdate<AtenBatchNormOp>,
+                 ReduceBatchNormRunningStatsUpdate<AtenNativeBatchNormOp>>(
+        context);
 
     ConversionTarget target(*context);
     target.addIllegalOp<NonValueTensorLiteralOp>();
@@ -250,7 +405,15 @@ class ReduceOpVariantsPass : public ReduceOpVariantsBase<ReduceOpVariantsPass> {
     target.addIllegalOp<Aten_IndexPutImpl_Op>();
     target.addIllegalOp<AtenCopy_Op>();
     target.markUnknownOpDynamicallyLegal([](Operation *op) {
-      if (op->hasTrait<Torch::OpTrait::HasValueSemantics>()) {
+      if (auto batchNorm = dyn_cast<AtenBatchNormOp>(op)) {
+        if (getUpdatedRunningStats(batchNorm))
+          return false;
+      } else if (auto batchNorm = dyn_cast<AtenNativeBatchNormOp>(op)) {
+        if (getUpdatedRunningStats(batchNorm))
+          return false;
+      }
+      if (op->hasTrait<Torch::OpTrait::HasValueSemantics>() ||
+          !getCustomKernel(op).empty()) {
         auto hasValueSemantics = [](Type t) {
           // TODO: Make this an allowlist based on a closed torch dialect
           // type system.
@@ -12,6 +12,8 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/Threading.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
 
@@ -25,22 +27,35 @@ class RefinePublicReturnPass
     : public RefinePublicReturnBase<RefinePublicReturnPass> {
   void runOnOperation() override {
     auto module = getOperation();
+    // Find the uses of all the functions in one walk of the module rather
+    // than one per function.
+    SymbolTableCollection symbolTables;
+    SymbolUserMap symbolUsers(symbolTables, module);
+    SmallVector<func::FuncOp> funcs;
+    bool hadError = false;
     module.walk([&](func::FuncOp func) {
       if (func.getVisibility() != SymbolTable::Visibility::Public)
         return;
       if (func.isExternal())
         return;
-      auto uses = SymbolTable::getSymbolUses(func, module);
-      if (!uses || uses->begin() != uses->end()) {
+      if (!symbolUsers.useEmpty(func)) {
         func.emitError() << "unimplemented: cannot refine public return for "
                          << "for public function with uses";
-        return signalPassFailure();
+        hadError = true;
+        return;
       }
-      rewriteSignature(func);
+      funcs.push_back(func);
     });
+    if (hadError)
+      return signalPassFailure();
+
+    // Each rewrite only modifies its function, so they run in parallel.
+    if (failed(failableParallelForEach(&getContext(), funcs,
+                                       rewriteSignature)))
+      return signalPassFailure();
   }
 
-  void rewriteSignature(func::FuncOp func) {
+  static LogicalResult rewriteSignature(func::FuncOp func) {
     // Find the unique return op.
     func::ReturnOp returnOp;
     WalkResult walkResult = func.walk([&](func::ReturnOp op) {
@@ -50,9 +65,9 @@ class RefinePublicReturnPass
       return WalkResult::advance();
     });
     if (walkResult.wasInterrupted()) {
-      func.emitError() << "unimplemented: refining returns for function with "
-                          "more than one return op";
-      return signalPassFailure();
+      return func.emitError()
+             << "unimplemented: refining returns for function with "
+                "more than one return op";
     }
 
     // Get the new operands. Either the original operand, or for tensors,
@@ -93,6 +108,7 @@ class RefinePublicReturnPass
     auto funcType = func.getFunctionType();
     func.setType(FunctionType::get(funcType.getContext(), funcType.getInputs(),
                                    ValueRange(newOperands).getTypes()));
+    return success();
   }
 };
 
@@ -633,14 +633,17 @@ ChangeResult TypeAnalyzer::visitOperation(
           ValsemVariantAtenBernoulliTensorOp, ValsemVariantAtenFillScalarOp,
           AtenHardsigmoidOp, AtenCloneOp, AtenHardswishOp, AtenSiluOp,
           AtenHardtanhOp, AtenMaskedSelectOp, AtenMaxPool2dOp, AtenAvgPool2dOp,
-          AtenAdaptiveAvgPool2dOp, AtenFlattenUsingIntsOp, AtenSqueezeOp,
+          AtenAdaptiveAvgPool2dOp, AtenUpsampleNearest2dOp,
+          AtenUpsampleNearest2dVecOp, AtenUpsampleBilinear2dOp,
+          AtenUpsampleBilinear2dVecOp, AtenFlattenUsingIntsOp, AtenSqueezeOp,
           AtenSqueezeDimOp, AtenUnsqueezeOp, AtenViewOp, Aten_UnsafeViewOp,
           AtenReshapeOp, Aten_ReshapeAliasOp, AtenResize_Op, AtenTransposeIntOp,
           AtenTOp, AtenPermuteOp, AtenIndexSelectOp, AtenSelectIntOp,
-          AtenSliceTensorOp, AtenGatherOp, AtenExpandOp, AtenExpandAsOp,
-          AtenBroadcastToOp, AtenRepeatOp, AtenConstantPadNdOp, AtenPadOp,
-          AtenZero_Op, AtenIndexTensorOp, ValsemVariantAtenIndexPutImplOp,
-          AtenIndexPutOp, ValsemVariantAtenCopyOp, AtenZeroFunctionalOp,
+          AtenSliceTensorOp, AtenSelectScatterOp, AtenSliceScatterOp,
+          AtenGatherOp, AtenExpandOp, AtenExpandAsOp, AtenBroadcastToOp,
+          AtenRepeatOp, AtenConstantPadNdOp, AtenPadOp, AtenZero_Op,
+          AtenIndexTensorOp, ValsemVariantAtenIndexPutImplOp, AtenIndexPutOp,
+          ValsemVariantAtenCopyOp, AtenZeroFunctionalOp,
           AtenIndexPutHackedTwinOp, AtenMaskedFillScalarOp, AtenFlipOp,
           PrimAbsScalarOp, AtenNumpyTOp, AtenTriuOp>(op)) {
     return incorporateKnowledge(op->getResult(0), operands[0]->getValue());
@@ -779,6 +782,14 @@ ChangeResult TypeAnalyzer::visitOperation(
     return incorporateKnowledge(op->getResult(0), knowledge);
   }
 
+  if (isa<AtenCrossEntropyLossOp>(op)) {
+    auto self = operands[0]->getValue();
+    auto knowledge =
+        ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+    knowledge.dtype = self.dtype;
+    return incorporateKnowledge(op->getResult(0), knowledge);
+  }
+
   // 2 results take dtype from first operand.
   if (isa<AtenNllLossForwardOp>(op)) {
     auto self = operands[0]->getValue();
@@ -794,7 +805,8 @@ ChangeResult TypeAnalyzer::visitOperation(
   }
 
   // 3 results take dtype from first operand.
-  if (isa<AtenNativeLayerNormOp, AtenNativeBatchNormOp>(op)) {
+  if (isa<AtenNativeLayerNormOp, AtenNativeBatchNormOp,
+          AtenNativeBatchNormBackwardOp>(op)) {
     auto self = operands[0]->getValue();
     auto result0Knowledge =
         ValueKnowledge::getTensorPessimisticValueState(op->getContext());
@@ -811,7 +823,20 @@ ChangeResult TypeAnalyzer::visitOperation(
     return changed;
   }
 
-  if (isa<AtenMaxPool2dWithIndicesOp>(op)) {
+  // All the results take dtype from the input.
+  if (isa<ValsemVariantAtenNativeBatchNormFunctionalOp>(op)) {
+    auto self = operands[0]->getValue();
+    auto changed = ChangeResult::NoChange;
+    for (Value result : op->getResults()) {
+      auto knowledge =
+          ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+      knowledge.dtype = self.dtype;
+      changed |= incorporateKnowledge(result, knowledge);
+    }
+    return changed;
+  }
+
+  if (isa<AtenMaxPool2dWithIndicesOp, AtenTopkOp, AtenSortOp>(op)) {
     auto self = operands[0]->getValue();
     auto result0Knowledge =
         ValueKnowledge::getTensorPessimisticValueState(op->getContext());
@@ -859,29 +884,33 @@ ChangeResult TypeAnalyzer::visitOperation(
     return visitReductionAlongDimIntListOp(meanDim, meanDim.dim(),
                                            meanDim.keepdim(), dtype, operands);
   }
-  if (auto argmax = dyn_cast<AtenArgmaxOp>(op)) {
-    Value dim = argmax.dim();
+  if (isa<AtenArgmaxOp, AtenArgminOp>(op)) {
+    // Both ops are (self, dim, keepdim).
+    Value dim = op->getOperand(1);
     Type dtype = IntegerType::get(op->getContext(), 64, IntegerType::Signed);
     if (dim.getType().isa<Torch::NoneType>())
       return visitReductionAlongAllDimsOp(op, dtype, operands);
     if (dim.getType().isa<Torch::IntType>())
-      return visitReductionAlongDimIntOp(argmax, argmax.dim(), argmax.keepdim(),
-                                         dtype, operands);
+      return visitReductionAlongDimIntOp(op, dim, op->getOperand(2), dtype,
+                                         operands);
   }
   if (auto anyDim = dyn_cast<AtenAnyDimOp>(op)) {
     Type dtype = operands[0]->getValue().dtype;
     return visitReductionAlongDimIntOp(anyDim, anyDim.dim(), anyDim.keepdim(),
                                        dtype, operands);
   }
-  if (auto maxDim = dyn_cast<AtenMaxDimOp>(op)) {
+  if (isa<AtenMaxDimOp, AtenMinDimOp>(op)) {
+    // Both ops are (self, dim, keepdim).
+    Value dim = op->getOperand(1);
+    Value keepDim = op->getOperand(2);
     Type firstResDtype = operands[0]->getValue().dtype;
     Type secondResDtype =
         IntegerType::get(op->getContext(), 64, IntegerType::Signed);
     ChangeResult firstRes = visitReductionAlongDimIntOp(
-        maxDim, maxDim.dim(), maxDim.keepdim(), firstResDtype, operands);
-    return firstRes |
-           visitReductionAlongDimIntOp(maxDim, maxDim.dim(), maxDim.keepdim(),
-                                       secondResDtype, operands, /*resNum=*/1);
+        op, dim, keepDim, firstResDtype, operands);
+    return firstRes | visitReductionAlongDimIntOp(op, dim, keepDim,
+                                                  secondResDtype, operands,
+                                                  /*resNum=*/1);
   }
   if (auto mean = dyn_cast<AtenMeanOp>(op)) {
     Type defaultDtype = operands[0]->getValue().dtype;
@@ -969,6 +998,21 @@ ChangeResult TypeAnalyzer::visitOperation(
     return incorporateKnowledge(embedding.getResult(), knowledge);
   }
 
+  if (auto embeddingBag = dyn_cast<AtenEmbeddingBagPaddingIdxOp>(op)) {
+    // The pooled rows have the dtype of the weight, and the other results are
+    // indices or counts.
+    auto knowledge =
+        ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+    knowledge.dtype = operands[0]->getValue().dtype;
+    ChangeResult changed =
+        incorporateKnowledge(embeddingBag.getResult(0), knowledge);
+    knowledge.dtype =
+        IntegerType::get(op->getContext(), 64, IntegerType::Signed);
+    for (Value result : embeddingBag->getResults().drop_front())
+      changed |= incorporateKnowledge(result, knowledge);
+    return changed;
+  }
+
   if (auto softmaxIntOp = dyn_cast<AtenSoftmaxIntOp>(op)) {
     return visitAtenSoftmaxLikeOp(softmaxIntOp, operands);
   }
@@ -999,6 +1043,23 @@ ChangeResult TypeAnalyzer::visitOperation(
         vectorNorm, vectorNorm.dim(), vectorNorm.keepdim(), dtype, operands);
   }
 
+  // The results of the custom kernels have the dtype of their first tensor
+  // input.
+  if (!getCustomKernel(op).empty()) {
+    ValueKnowledge knowledge =
+        ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+    for (auto it : llvm::zip(op->getOperands(), operands)) {
+      if (std::get<0>(it).getType().isa<BaseTensorType>()) {
+        knowledge.dtype = std::get<1>(it)->getValue().dtype;
+        break;
+      }
+    }
+    ChangeResult changed = ChangeResult::NoChange;
+    for (Value result : op->getResults())
+      changed |= incorporateKnowledge(result, knowledge);
+    return changed;
+  }
+
   // Otherwise, this is an unknown operation. Just mark all results as
   // having reached a pessimistic fixpoint.
   return markAllPessimisticFixpoint(op->getResults());
@@ -1290,7 +1351,8 @@ static Type getMostRefinedStaticType(Value v, TypeAnalyzer &analyzer) {
                                  ValueKnowledge const &knowledge) {
     return tensorType
         .getWithSizesAndDtype(tensorType.getOptionalSizes(), knowledge.dtype)
-        .cast<BaseTensorType>();
+        .cast<BaseTensorType>()
+        .getWithSparsity(tensorType.getOptionalSparsity());
   };
 
   if (auto tensorType = v.getType().dyn_cast<BaseTensorType>()) {
@@ -1338,11 +1400,14 @@ static Type getMostRefinedStaticType(Value v, TypeAnalyzer &analyzer) {
 // The `torch.copy.to_tensor` / `torch.copy.to_vtensor` are examples of the
 // latter case, since their operand and result types must have the same shape
 // and dtype -- we know that our transfer functions and updating logic will do
-// the right thing forthose ops.
+// the right thing forthose ops. The calls to custom kernels don't constrain
+// their types at all, and their results must be refined in place for the
+// backends to allocate them.
 //
 static bool allowsTypeRefinementOrIsSafeToRefine(Operation *op) {
   return op->hasTrait<mlir::torch::Torch::OpTrait::AllowsTypeRefinement>() ||
-         isa<CopyToNonValueTensorOp, CopyToValueTensorOp>(op);
+         isa<CopyToNonValueTensorOp, CopyToValueTensorOp>(op) ||
+         !getCustomKernel(op).empty();
 }
 
 // Some operations have extra verification logic regarding the relationship
@@ -1496,10 +1561,145 @@ void optimize(func::FuncOp func, TypeAnalyzer &analyzer) {
   });
 }
 
+// Returns the calls to `func` if it is private and all of its uses are
+// `func.call` ops in `module`.
+static Optional<SmallVector<func::CallOp>>
+getAllCallsOfPrivateFunc(func::FuncOp func, ModuleOp module) {
+  if (!func.isPrivate() || func.isExternal())
+    return None;
+  auto uses = SymbolTable::getSymbolUses(func, module);
+  if (!uses)
+    return None;
+  SmallVector<func::CallOp> calls;
+  for (SymbolTable::SymbolUse use : *uses) {
+    auto call = dyn_cast<func::CallOp>(use.getUser());
+    if (!call)
+      return None;
+    calls.push_back(call);
+  }
+  return calls;
+}
+
+// Embeds the knowledge about the arguments and results of `func` that the
+// interprocedural analysis found in the signature of `func`, updating all
+// of its `calls`.
+//
+// `optimize` has already refined the types of all values inside the
+// function, so this only needs to update the signature and add static info
+// casts at the boundaries. Only tensor types are handled.
+static void refineSignature(func::FuncOp func, ArrayRef<func::CallOp> calls,
+                            TypeAnalyzer &analyzer) {
+  Block &entry = func.getBody().front();
+  SmallVector<Type> argTypes(func.getArgumentTypes().begin(),
+                             func.getArgumentTypes().end());
+  for (BlockArgument arg : entry.getArguments()) {
+    Type originalType = arg.getType();
+    if (!originalType.isa<BaseTensorType>())
+      continue;
+    Type refinedType = getMostRefinedStaticType(arg, analyzer);
+    if (!refinedType || refinedType == originalType)
+      continue;
+    // Uses in the body still expect the original type. Later
+    // canonicalizations fold the cast into them where possible.
+    OpBuilder b(&entry, entry.begin());
+    Value originalTypedArg =
+        b.create<TensorStaticInfoCastOp>(func.getLoc(), originalType, arg);
+    arg.replaceAllUsesExcept(originalTypedArg,
+                             originalTypedArg.getDefiningOp());
+    arg.setType(refinedType);
+    argTypes[arg.getArgNumber()] = refinedType;
+    for (func::CallOp call : calls) {
+      OpBuilder b(call);
+      Value operand = call.getOperand(arg.getArgNumber());
+      if (operand.getType() != refinedType) {
+        call->setOperand(arg.getArgNumber(),
+                         b.create<TensorStaticInfoCastOp>(
+                             call.getLoc(), refinedType, operand));
+      }
+    }
+  }
+
+  // `optimize` ensures that returned values of refined type are first cast to
+  // the type in the signature. Return the refined values directly instead, if
+  // all return ops agree on their type.
+  SmallVector<func::ReturnOp> returnOps;
+  func.walk([&](func::ReturnOp op) { returnOps.push_back(op); });
+  SmallVector<Type> resultTypes(func.getResultTypes().begin(),
+                                func.getResultTypes().end());
+  for (int i = 0, e = resultTypes.size(); i != e; i++) {
+    Type originalType = resultTypes[i];
+    if (!originalType.isa<BaseTensorType>())
+      continue;
+    Type refinedType;
+    for (func::ReturnOp returnOp : returnOps) {
+      Value operand = returnOp.getOperand(i);
+      if (auto cast = operand.getDefiningOp<TensorStaticInfoCastOp>())
+        operand = cast.getOperand();
+      if (refinedType && operand.getType() != refinedType) {
+        refinedType = nullptr;
+        break;
+      }
+      refinedType = operand.getType();
+    }
+    if (!refinedType || refinedType == originalType)
+      continue;
+    for (func::ReturnOp returnOp : returnOps) {
+      Value operand = returnOp.getOperand(i);
+      if (auto cast = operand.getDefiningOp<TensorStaticInfoCastOp>())
+        returnOp->setOperand(i, cast.getOperand());
+    }
+    resultTypes[i] = refinedType;
+    for (func::CallOp call : calls) {
+      Value result = call.getResult(i);
+      OpBuilder b(call->getBlock(), std::next(call->getIterator()));
+      Value originalTypedResult =
+          b.create<TensorStaticInfoCastOp>(call.getLoc(), originalType, result);
+      result.replaceAllUsesExcept(originalTypedResult,
+                                  originalTypedResult.getDefiningOp());
+      result.setType(refinedType);
+    }
+  }
+
+  func.setType(FunctionType::get(func.getContext(), argTypes, resultTypes));
+}
+
+// Returns true if `type` leaves room for static information that
+// `getMostRefinedStaticType` could add.
+static bool isRefinableType(Type type) {
+  if (auto tensorType = type.dyn_cast<BaseTensorType>())
+    return !tensorType.hasDtype();
+  return type.isa<OptionalType, NumberType>();
+}
+
+// Returns true if `optimize` could change any value in `func`, i.e. if any of
+// the values it considers has a refinable type. All other values already have
+// exactly the knowledge intrinsic to their type.
+static bool hasRefinableValues(func::FuncOp func) {
+  auto isRefinable = [](Value v) { return isRefinableType(v.getType()); };
+  WalkResult walkResult = func.walk([&](Operation *op) {
+    if (llvm::any_of(op->getResults(), isRefinable))
+      return WalkResult::interrupt();
+    if (isa<RegionBranchOpInterface>(op)) {
+      for (Region &region : op->getRegions()) {
+        if (!region.empty() &&
+            llvm::any_of(region.front().getArguments(), isRefinable))
+          return WalkResult::interrupt();
+      }
+    }
+    return WalkResult::advance();
+  });
+  return walkResult.wasInterrupted();
+}
+
 namespace {
 class RefineTypesPass : public RefineTypesBase<RefineTypesPass> {
   void runOnOperation() override {
     auto func = getOperation();
+    // This pass is often run repeatedly, interleaved with canonicalizations.
+    // Once everything is refined (the common case for later runs), nothing
+    // can change, so don't pay for the analysis.
+    if (!hasRefinableValues(func))
+      return markAllAnalysesPreserved();
     TypeAnalyzer analyzer(&getContext());
     analyzer.run(func);
     optimize(func, analyzer);
@@ -1511,3 +1711,29 @@ std::unique_ptr<OperationPass<func::FuncOp>>
 mlir::torch::Torch::createRefineTypesPass() {
   return std::make_unique<RefineTypesPass>();
 }
+
+namespace {
+class RefineTypesInterprocedurallyPass
+    : public RefineTypesInterprocedurallyBase<
+          RefineTypesInterprocedurallyPass> {
+  void runOnOperation() override {
+    auto module = getOperation();
+    // When run on a module, the analysis propagates knowledge from call sites
+    // into the arguments of private functions whose uses are all known, and
+    // from their returns into the results of the calls.
+    TypeAnalyzer analyzer(&getContext());
+    analyzer.run(module);
+    for (auto func : module.getOps<func::FuncOp>())
+      optimize(func, analyzer);
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (auto calls = getAllCallsOfPrivateFunc(func, module))
+        refineSignature(func, *calls, analyzer);
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::Torch::createRefineTypesInterprocedurallyPass() {
+  return std::make_unique<RefineTypesInterprocedurallyPass>();
+}
@@ -12,6 +12,7 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Builders.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/InliningUtils.h"
@@ -214,58 +215,103 @@ populateShapeCalculationRegion(ShapeCalculateOp op, ValueRange originalOperands,
   return success();
 }
 
+// Wraps the ops nested in `root` that have a shape function in
+// `shapeLibrary` in a `torch.shape.calculate` op, and appends the names of
+// those shape functions to `neededShapeFunctions`.
+static LogicalResult
+reifyShapeCalculations(Operation *root, const SymbolTable &shapeLibrary,
+                       SmallVectorImpl<std::string> &neededShapeFunctions) {
+  MLIRContext *context = root->getContext();
+  bool hadError = false;
+  root->walk([&](Operation *op) {
+    Location loc = op->getLoc();
+    auto name = op->getName().stripDialect();
+    // For value-semantic variant ops, i.e. valsem-ops (ops that are
+    // mechanically consistent with existing torch conventions of in-place vs.
+    //  out-of-place (value-semantic) variants), remove the prefix when
+    // looking them up in the shape library.
+    if (name.startswith("valsem."))
+      name = name.drop_front(strlen("valsem."));
+    // The ops without a registered op, like the custom ops of extensions,
+    // are looked up by the name of their operator.
+    auto operatorOp = dyn_cast<OperatorOp>(op);
+    if (operatorOp)
+      name = operatorOp.name();
+    auto shapeFunctionName = ("__torch_mlir_shape_fn." + Twine(name)).str();
+    auto shapeFunction = shapeLibrary.lookup<func::FuncOp>(shapeFunctionName);
+    if (!shapeFunction)
+      return;
+    neededShapeFunctions.push_back(shapeFunctionName);
+    auto shapeCalculate =
+        OpBuilder(op).create<ShapeCalculateOp>(loc, op->getResultTypes());
+    op->replaceAllUsesWith(shapeCalculate);
+    {
+      // Move the op into the body of the `torch.shape.calculate` op and yield
+      // its results.
+      OpBuilder b(context);
+      Block *block = b.createBlock(&shapeCalculate.body());
+      op->moveBefore(block, block->end());
+      b.setInsertionPointAfter(op);
+      b.create<ShapeCalculateYieldOp>(loc, op->getResults());
+    }
+    // The shapes of the results of a custom kernel call, attached by an
+    // earlier round of refinement, are not passed to the shape function.
+    ValueRange operands = op->getOperands();
+    if (operatorOp)
+      operands = getCustomKernelInputs(op);
+    if (failed(populateShapeCalculationRegion(shapeCalculate, operands,
+                                              shapeFunction))) {
+      hadError = true;
+      return;
+    }
+  });
+  return failure(hadError);
+}
+
 namespace {
+// The ops nested in an op of the module, and the shape functions they need.
+struct ReificationRoot {
+  Operation *op;
+  SmallVector<std::string> neededShapeFunctions;
+};
+
 class ReifyShapeCalculationsPass
     : public ReifyShapeCalculationsBase<ReifyShapeCalculationsPass> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     ModuleOp module = getOperation();
 
-    // TODO: Find a way to not have to parse this every time.
     // The shape library is O(#ops we know about), and this pass should be
-    // O(#ops in the program) ideally.
-    auto shapeLibrary = parseSourceString<ModuleOp>(getShapeLibrary(), context);
+    // O(#ops in the program) ideally, so it is only parsed and indexed once
+    // per context. Lookups in it are then O(1).
+    const SymbolTable *shapeLibrary =
+        context->getLoadedDialect<TorchDialect>()->getOrParseShapeLibrary(
+            [&]() {
+              return parseSourceString<ModuleOp>(getShapeLibrary(), context);
+            });
+    if (!shapeLibrary) {
+      module.emitError() << "failed to parse the shape library or merge the "
+                            "shape functions added to it";
+      return signalPassFailure();
+    }
 
     // Walk all the operations, and if we have a shape function, wrap the op
-    // in a `torch.shape.calculate` op.
-    SmallVector<std::string> neededShapeFunctions;
-    bool hadError = false;
-    module.walk([&](Operation *op) {
-      Location loc = op->getLoc();
-      auto name = op->getName().stripDialect();
-      // For value-semantic variant ops, i.e. valsem-ops (ops that are
-      // mechanically consistent with existing torch conventions of in-place vs.
-      //  out-of-place (value-semantic) variants), remove the prefix when
-      // looking them up in the shape library.
-      if (name.startswith("valsem."))
-        name = name.drop_front(strlen("valsem."));
-      auto shapeFunctionName = ("__torch_mlir_shape_fn." + Twine(name)).str();
-      auto shapeFunction =
-          shapeLibrary->lookupSymbol<func::FuncOp>(shapeFunctionName);
-      if (!shapeFunction)
-        return;
-      neededShapeFunctions.push_back(shapeFunctionName);
-      auto shapeCalculate =
-          OpBuilder(op).create<ShapeCalculateOp>(loc, op->getResultTypes());
-      op->replaceAllUsesWith(shapeCalculate);
-      {
-        // Move the op into the body of the `torch.shape.calculate` op and yield
-        // its results.
-        OpBuilder b(context);
-        Block *block = b.createBlock(&shapeCalculate.body());
-        op->moveBefore(block, block->end());
-        b.setInsertionPointAfter(op);
-        b.create<ShapeCalculateYieldOp>(loc, op->getResults());
-      }
-      if (failed(populateShapeCalculationRegion(
-              shapeCalculate, op->getOperands(), shapeFunction))) {
-        hadError = true;
-        return;
-      }
-    });
-
-    if (hadError)
+    // in a `torch.shape.calculate` op. This only modifies the ops nested in
+    // each function (or other op of the module) and reads the shared shape
+    // library, so the functions are processed in parallel. Only importing the
+    // shape functions below modifies the module itself.
+    SmallVector<ReificationRoot> roots;
+    for (Operation &op : *module.getBody())
+      roots.push_back(ReificationRoot{&op, {}});
+    if (failed(failableParallelForEach(
+            context, roots, [&](ReificationRoot &root) {
+              return reifyShapeCalculations(root.op, *shapeLibrary,
+                                            root.neededShapeFunctions);
+            })))
       return signalPassFailure();
+    SmallVector<std::string> neededShapeFunctions;
+    for (ReificationRoot &root : roots)
+      llvm::append_range(neededShapeFunctions, root.neededShapeFunctions);
 
     // Import just the functions we need. This includes transitive callees,
     // so we use a worklist algorithm.
@@ -276,12 +322,13 @@ class ReifyShapeCalculationsPass
       auto symName = worklist.pop_back_val();
       if (importedFunctions.count(symName))
         continue;
-      auto func = shapeLibrary->lookupSymbol<mlir::func::FuncOp>(symName);
-      assert(func && "broken shape library");
-      // Move the shape function from the library to the module this pass
-      // is running on. (this mutates the library, but we re-parse it each time
-      // so this is safe to do).
-      func->moveBefore(&module.getBody()->front());
+      auto libraryFunc = shapeLibrary->lookup<mlir::func::FuncOp>(symName);
+      assert(libraryFunc && "broken shape library");
+      // Copy the shape function from the library to the module this pass
+      // is running on. The library is shared by all runs of this pass in the
+      // context, so it must not be mutated.
+      auto func = libraryFunc.clone();
+      module.getBody()->push_front(func);
       // Set the visibility to private so that the shape functions go away
       // nicely after we are done with them.
       func.setVisibility(SymbolTable::Visibility::Private);
@@ -24,14 +24,14 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSet.h"
 
+#include <map>
+
 using namespace mlir;
 using namespace mlir::torch;
 using namespace mlir::torch::Torch;
 
 namespace {
 // TODO: Only unroll inside the shape calculation region.
-// Maybe do this by only applying patterns and folding greedily on the ops
-// inside the region + the shape.calculate op itself?
 class FullyUnrollPrimLoopOp : public OpRewritePattern<PrimLoopOp> {
 public:
   using OpRewritePattern::OpRewritePattern;
@@ -270,8 +270,7 @@ public:
 } // namespace
 
 static void refineShapeCalculateResult(ShapeCalculateOp op, int resultNum,
-                                       PatternRewriter &rewriter,
-                                       bool &madeChange) {
+                                       OpBuilder &rewriter, bool &madeChange) {
   auto yieldValues = op.body().front().getTerminator();
   auto yieldShapes = op.shapeCalculation().front().getTerminator();
   auto shape = yieldShapes->getOperand(resultNum);
@@ -385,6 +384,161 @@ public:
 };
 } // namespace
 
+// Computes a key for the `shapeCalculation` region of `op` such that two
+// shape calculations with the same key simplify to the same result (up to the
+// renaming of captured values). The key consists of the structure of the
+// region and the static information that the simplification patterns can use
+// about each value captured from above: the type of tensors, and the value of
+// constants and of lists of constants. The captured values are appended to
+// `captures` in the order that they are first used.
+//
+// Returns failure if the region captures values that the patterns could
+// analyze further (e.g. non-constant lists) or lists that may be mutated, in
+// which case the shape calculation cannot be memoized.
+static LogicalResult
+computeShapeCalculationKey(ShapeCalculateOp op, SmallVectorImpl<uintptr_t> &key,
+                           SmallVectorImpl<Value> &captures) {
+  Region &region = op.shapeCalculation();
+  DenseMap<Value, unsigned> localValues;
+  DenseMap<Value, unsigned> captureIndices;
+  DenseMap<Block *, unsigned> blockIndices;
+  auto addOpaque = [&](const void *pointer) {
+    key.push_back(reinterpret_cast<uintptr_t>(pointer));
+  };
+  auto addBlock = [&](Block &block) {
+    blockIndices.try_emplace(&block, blockIndices.size());
+    key.push_back(block.getNumArguments());
+    for (BlockArgument arg : block.getArguments()) {
+      addOpaque(arg.getType().getAsOpaquePointer());
+      localValues.try_emplace(arg, localValues.size());
+    }
+  };
+  auto addCapture = [&](Value value) -> LogicalResult {
+    auto it = captureIndices.try_emplace(value, captures.size());
+    key.push_back(/*isCapture=*/1);
+    key.push_back(it.first->second);
+    if (!it.second)
+      return success();
+    captures.push_back(value);
+    addOpaque(value.getType().getAsOpaquePointer());
+    Attribute attr;
+    if (matchPattern(value, m_Constant(&attr))) {
+      addOpaque(attr.getAsOpaquePointer());
+      return success();
+    }
+    if (auto listConstruct = value.getDefiningOp<PrimListConstructOp>()) {
+      // A list that may be mutated can hold other elements where each shape
+      // calculation uses it, which the key doesn't see.
+      if (isListPotentiallyMutated(listConstruct))
+        return failure();
+      key.push_back(listConstruct->getNumOperands());
+      for (Value element : listConstruct->getOperands()) {
+        if (!matchPattern(element, m_Constant(&attr)))
+          return failure();
+        addOpaque(attr.getAsOpaquePointer());
+      }
+      return success();
+    }
+    // Tensors only contribute their type, and block arguments are opaque.
+    if (value.getType().isa<BaseTensorType>() || value.isa<BlockArgument>())
+      return success();
+    return failure();
+  };
+
+  for (Type type : op->getResultTypes())
+    addOpaque(type.getAsOpaquePointer());
+  for (Block &block : region)
+    addBlock(block);
+  auto addOp = [&](Operation *nested) -> WalkResult {
+    addOpaque(nested->getName().getAsOpaquePointer());
+    addOpaque(nested->getAttrDictionary().getAsOpaquePointer());
+    key.push_back(nested->getNumOperands());
+    for (Value operand : nested->getOperands()) {
+      if (!region.isAncestor(operand.getParentRegion())) {
+        if (failed(addCapture(operand)))
+          return WalkResult::interrupt();
+        continue;
+      }
+      auto it = localValues.find(operand);
+      if (it == localValues.end())
+        return WalkResult::interrupt();
+      key.push_back(/*isCapture=*/0);
+      key.push_back(it->second);
+    }
+    key.push_back(nested->getNumResults());
+    for (Value result : nested->getResults()) {
+      addOpaque(result.getType().getAsOpaquePointer());
+      localValues.try_emplace(result, localValues.size());
+    }
+    key.push_back(nested->getNumSuccessors());
+    for (Block *successor : nested->getSuccessors())
+      key.push_back(blockIndices.lookup(successor));
+    key.push_back(nested->getNumRegions());
+    for (Region &nestedRegion : nested->getRegions()) {
+      key.push_back(nestedRegion.getBlocks().size());
+      for (Block &block : nestedRegion)
+        addBlock(block);
+    }
+    return WalkResult::advance();
+  };
+  WalkResult walkResult = region.walk<WalkOrder::PreOrder>(addOp);
+  return failure(walkResult.wasInterrupted());
+}
+
+// Replaces the `shapeCalculation` region of `op` with a copy of the already
+// simplified one of `simplified`, which had the same key where `op` captures
+// `captures` and `simplified` captured `simplifiedCaptures`.
+//
+// Returns failure if the simplified region uses values that are not available
+// to `op`.
+static LogicalResult
+copySimplifiedShapeCalculation(ShapeCalculateOp simplified,
+                               ArrayRef<Value> simplifiedCaptures,
+                               ShapeCalculateOp op, ArrayRef<Value> captures) {
+  Region &simplifiedRegion = simplified.shapeCalculation();
+  BlockAndValueMapping mapping;
+  for (auto it : llvm::zip(simplifiedCaptures, captures))
+    mapping.map(std::get<0>(it), std::get<1>(it));
+
+  // Simplification can introduce uses of constants that were not captured
+  // before (e.g. by folding). These are rematerialized inside the region,
+  // since they might not dominate `op`.
+  SmallVector<Operation *> constantsToClone;
+  WalkResult walkResult = simplifiedRegion.walk([&](Operation *nested) {
+    for (Value operand : nested->getOperands()) {
+      if (simplifiedRegion.isAncestor(operand.getParentRegion()) ||
+          mapping.contains(operand))
+        continue;
+      Operation *def = operand.getDefiningOp();
+      if (!def || !def->hasTrait<OpTrait::ConstantLike>())
+        return WalkResult::interrupt();
+      if (!llvm::is_contained(constantsToClone, def))
+        constantsToClone.push_back(def);
+    }
+    return WalkResult::advance();
+  });
+  if (walkResult.wasInterrupted())
+    return failure();
+
+  Region &region = op.shapeCalculation();
+  region.dropAllReferences();
+  region.getBlocks().clear();
+  OpBuilder b(op.getContext());
+  b.setInsertionPointToStart(&simplifiedRegion.front());
+  // Clone the constants into the region being copied from temporarily, so
+  // that the single `cloneInto` below picks them up.
+  for (Operation *constant : constantsToClone) {
+    Operation *clone = b.clone(*constant);
+    constant->getResult(0).replaceUsesWithIf(
+        clone->getResult(0), [&](OpOperand &use) {
+          return simplifiedRegion.isAncestor(
+              use.getOwner()->getParentRegion());
+        });
+  }
+  simplifiedRegion.cloneInto(&region, mapping);
+  return success();
+}
+
 namespace {
 class SimplifyShapeCalculationsPass
     : public SimplifyShapeCalculationsBase<SimplifyShapeCalculationsPass> {
@@ -401,17 +555,64 @@ class SimplifyShapeCalculationsPass
     Aten__Getitem__TOp::getCanonicalizationPatterns(patterns, context);
     AtenSizeOp::getCanonicalizationPatterns(patterns, context);
     AtenLenTOp::getCanonicalizationPatterns(patterns, context);
+    FrozenRewritePatternSet frozenPatterns(std::move(patterns));
 
     // TODO: Debug visitation order to make this more efficient.
     // A single linear scan should suffice.
     GreedyRewriteConfig config;
     config.useTopDownTraversal = true;
     config.maxIterations = GreedyRewriteConfig::kNoIterationLimit;
-    if (failed(applyPatternsAndFoldGreedily(getOperation(), std::move(patterns),
+
+    // First, simplify each shape calculation on its own, in program order so
+    // that refined result types are visible to later shape calculations.
+    // Models often contain many structurally identical shape calculations
+    // (e.g. the same op in every layer), so the result of simplifying each
+    // one is memoized and copied to later identical ones instead of being
+    // recomputed.
+    simplifyShapeCalculationsWithMemoization(frozenPatterns, config);
+
+    // Then simplify the whole function, which cleans up anything that needs
+    // to look across shape calculations.
+    if (failed(applyPatternsAndFoldGreedily(getOperation(), frozenPatterns,
                                             config))) {
       return signalPassFailure();
     }
   }
+
+  void simplifyShapeCalculationsWithMemoization(
+      const FrozenRewritePatternSet &patterns,
+      const GreedyRewriteConfig &config) {
+    struct MemoizedShapeCalculation {
+      ShapeCalculateOp op;
+      SmallVector<Value> captures;
+    };
+    std::map<SmallVector<uintptr_t>, MemoizedShapeCalculation> memo;
+
+    SmallVector<ShapeCalculateOp> shapeCalculateOps;
+    getOperation().walk(
+        [&](ShapeCalculateOp op) { shapeCalculateOps.push_back(op); });
+    for (ShapeCalculateOp op : shapeCalculateOps) {
+      SmallVector<uintptr_t> key;
+      SmallVector<Value> captures;
+      if (failed(computeShapeCalculationKey(op, key, captures)))
+        continue;
+      auto it = memo.find(key);
+      if (it == memo.end() ||
+          failed(copySimplifiedShapeCalculation(it->second.op,
+                                                it->second.captures, op,
+                                                captures))) {
+        // Errors here are not fatal, since the whole function is simplified
+        // again afterwards.
+        (void)applyPatternsAndFoldGreedily(op.shapeCalculation(), patterns,
+                                           config);
+        memo[key] = {op, captures};
+      }
+      OpBuilder b(op);
+      bool madeChange = false;
+      for (int i = 0, e = op->getNumResults(); i != e; i++)
+        refineShapeCalculateResult(op, i, b, madeChange);
+    }
+  }
 };
 } // namespace
 
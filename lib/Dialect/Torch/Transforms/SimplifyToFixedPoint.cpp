@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/PassManager.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "llvm/ADT/Hashing.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+// Returns a hash of the structure of `module`: the names, attributes and
+// result types of its ops, which values they use, and how they are nested.
+// Values are identified by the order in which they are defined, so that ops
+// that a pass recreates identically don't count as a change.
+static llvm::hash_code hashModuleStructure(ModuleOp module) {
+  DenseMap<Value, unsigned> valueIds;
+  unsigned nextId = 1;
+  llvm::hash_code hash(0);
+  module.walk<WalkOrder::PreOrder>([&](Operation *op) {
+    hash = llvm::hash_combine(hash, op->getName(), op->getAttrDictionary());
+    for (Value operand : op->getOperands())
+      hash = llvm::hash_combine(hash, valueIds.lookup(operand));
+    for (Value result : op->getResults()) {
+      valueIds[result] = nextId++;
+      hash = llvm::hash_combine(hash, result.getType());
+    }
+    // The arguments of the nested blocks are defined before the ops in them,
+    // which the walk visits next.
+    for (Region &region : op->getRegions()) {
+      hash = llvm::hash_combine(hash, region.getBlocks().size());
+      for (Block &block : region) {
+        hash = llvm::hash_combine(hash, block.getOperations().size());
+        for (BlockArgument arg : block.getArguments()) {
+          valueIds[arg] = nextId++;
+          hash = llvm::hash_combine(hash, arg.getType());
+        }
+      }
+    }
+  });
+  return hash;
+}
+
+namespace {
+class SimplifyToFixedPointPass
+    : public SimplifyToFixedPointBase<SimplifyToFixedPointPass> {
+public:
+  SimplifyToFixedPointPass() = default;
+  SimplifyToFixedPointPass(int64_t maxIterations, bool optimize, bool decompose,
+                           ArrayRef<std::string> backendLegalOps) {
+    this->maxIterations = maxIterations;
+    this->optimize = optimize;
+    this->decompose = decompose;
+    this->backendLegalOps = backendLegalOps;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    OpPassManager pm(ModuleOp::getOperationName());
+    buildSimplificationPipeline(pm);
+    pm.getDependentDialects(registry);
+  }
+
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    OpPassManager pm(ModuleOp::getOperationName());
+    buildSimplificationPipeline(pm);
+
+    llvm::hash_code hash = hashModuleStructure(module);
+    for (int64_t i = 0; i < maxIterations; i++) {
+      if (failed(runPipeline(pm, module)))
+        return signalPassFailure();
+      llvm::hash_code newHash = hashModuleStructure(module);
+      if (newHash == hash)
+        return;
+      hash = newHash;
+    }
+    // Programs that still change after `maxIterations` rounds are left in
+    // their last state: the cap only bounds the compile time.
+  }
+
+private:
+  void buildSimplificationPipeline(OpPassManager &pm) const {
+    TorchLoweringPipelineOptions options;
+    options.optimize = optimize.getValue();
+    options.decompose = decompose.getValue();
+    options.backendLegalOps = llvm::to_vector(backendLegalOps);
+    createTorchSimplificationPipeline(pm, options);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::Torch::createSimplifyToFixedPointPass(
+    int64_t maxIterations, bool optimize, bool decompose,
+    ArrayRef<std::string> backendLegalOps) {
+  return std::make_unique<SimplifyToFixedPointPass>(maxIterations, optimize,
+                                                    decompose, backendLegalOps);
+}
@@ -10,6 +10,8 @@
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "mlir/IR/BuiltinDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchTraits.h"
+#include "llvm/Support/CheckedArithmetic.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -55,6 +57,8 @@ torch_upstream::ScalarType Torch::getScalarTypeForType(Type type) {
     return torch_upstream::ScalarType::Bool;
   if (type.isBF16())
     return torch_upstream::ScalarType::BFloat16;
+  if (type.isF16())
+    return torch_upstream::ScalarType::Half;
   llvm::report_fatal_error("unhandled type for getScalarTypeForType");
 }
 
@@ -74,6 +78,8 @@ Type Torch::getTypeForScalarType(
     return IntegerType::get(context, 1);
   case torch_upstream::ScalarType::BFloat16:
     return mlir::FloatType::getBF16(context);
+  case torch_upstream::ScalarType::Half:
+    return mlir::FloatType::getF16(context);
   default:
     return Type();
   }
@@ -128,3 +134,439 @@ int Torch::getTensorRank(Value tensor) {
   }
   return tensorRank;
 }
+
+// Bounds the number of ops looked through by `getIntRange`, which is called
+// from lowering patterns and so must stay cheap on long chains of arithmetic.
+static constexpr int kMaxIntRangeDepth = 8;
+
+static IntRange getIntRangeImpl(Value v, int depth) {
+  IntRange unknown;
+  int64_t value;
+  if (matchPattern(v, m_TorchConstantInt(&value)))
+    return {value, value};
+  if (depth >= kMaxIntRangeDepth)
+    return unknown;
+
+  // Combines the ranges of the operands of a binary op with `combine`, which
+  // returns None on overflow.
+  auto combineRanges = [&](Value lhs, Value rhs, auto combine) -> IntRange {
+    IntRange lhsRange = getIntRangeImpl(lhs, depth + 1);
+    IntRange rhsRange = getIntRangeImpl(rhs, depth + 1);
+    auto a = combine(lhsRange.min, rhsRange.min);
+    auto b = combine(lhsRange.min, rhsRange.max);
+    auto c = combine(lhsRange.max, rhsRange.min);
+    auto d = combine(lhsRange.max, rhsRange.max);
+    if (!a || !b || !c || !d)
+      return unknown;
+    return {std::min({*a, *b, *c, *d}), std::max({*a, *b, *c, *d})};
+  };
+
+  Operation *op = v.getDefiningOp();
+  if (!op)
+    return unknown;
+  if (auto size = dyn_cast<AtenSizeIntOp>(op)) {
+    auto tensorType = size.self().getType().cast<BaseTensorType>();
+    int64_t dim;
+    if (tensorType.hasSizes() &&
+        matchPattern(size.dim(), m_TorchConstantInt(&dim))) {
+      ArrayRef<int64_t> sizes = tensorType.getSizes();
+      dim = toPositiveDim(dim, sizes.size());
+      if (isValidDim(dim, sizes.size()) && sizes[dim] != kUnknownSize)
+        return {sizes[dim], sizes[dim]};
+    }
+    return {0, unknown.max};
+  }
+  if (auto len = dyn_cast<AtenLenTOp>(op)) {
+    SmallVector<Value> elements;
+    if (getListConstructElements(len.a(), elements)) {
+      int64_t numElements = elements.size();
+      return {numElements, numElements};
+    }
+    return {0, unknown.max};
+  }
+  if (auto add = dyn_cast<AtenAddIntOp>(op)) {
+    return combineRanges(add.a(), add.b(), [](int64_t a, int64_t b) {
+      return llvm::checkedAdd(a, b);
+    });
+  }
+  if (auto sub = dyn_cast<AtenSubIntOp>(op)) {
+    return combineRanges(sub.a(), sub.b(), [](int64_t a, int64_t b) {
+      return llvm::checkedSub(a, b);
+    });
+  }
+  if (auto mul = dyn_cast<AtenMulIntOp>(op)) {
+    return combineRanges(mul.a(), mul.b(), [](int64_t a, int64_t b) {
+      return llvm::checkedMul(a, b);
+    });
+  }
+  if (auto neg = dyn_cast<AtenNegIntOp>(op)) {
+    IntRange range = getIntRangeImpl(neg.a(), depth + 1);
+    if (range.min == unknown.min)
+      return unknown;
+    return {-range.max, -range.min};
+  }
+  return unknown;
+}
+
+IntRange Torch::getIntRange(Value v) { return getIntRangeImpl(v, 0); }
+
+FailureOr<DenseElementsAttr>
+Torch::transposeElementsAttr(DenseElementsAttr attr,
+                             ArrayRef<int64_t> permutation) {
+  ShapedType type = attr.getType();
+  ArrayRef<int64_t> shape = type.getShape();
+  int64_t rank = type.getRank();
+  assert(static_cast<int64_t>(permutation.size()) == rank &&
+         "permutation must have one entry per dimension");
+  SmallVector<int64_t> resultShape;
+  for (int64_t dim : permutation)
+    resultShape.push_back(shape[dim]);
+  auto resultType = RankedTensorType::get(resultShape, type.getElementType());
+  if (attr.isSplat())
+    return attr.reshape(resultType);
+
+  Type elementType = type.getElementType();
+  if (!elementType.isIntOrFloat() || elementType.getIntOrFloatBitWidth() % 8)
+    return failure();
+  int64_t elementBytes = elementType.getIntOrFloatBitWidth() / 8;
+
+  // Strides (in elements) of the dimensions of `attr`.
+  SmallVector<int64_t> strides(rank, 1);
+  for (int64_t i = rank - 2; i >= 0; i--)
+    strides[i] = strides[i + 1] * shape[i + 1];
+
+  ArrayRef<char> data = attr.getRawData();
+  int64_t numElements = type.getNumElements();
+  std::vector<char> resultData(numElements * elementBytes);
+  SmallVector<int64_t> resultIndex(rank, 0);
+  for (int64_t i = 0; i < numElements; i++) {
+    int64_t sourceOffset = 0;
+    for (int64_t d = 0; d < rank; d++)
+      sourceOffset += resultIndex[d] * strides[permutation[d]];
+    std::copy_n(data.begin() + sourceOffset * elementBytes, elementBytes,
+                resultData.begin() + i * elementBytes);
+    // Advance the multi-dimensional index of the result element.
+    for (int64_t d = rank - 1; d >= 0; d--) {
+      if (++resultIndex[d] < resultShape[d])
+        break;
+      resultIndex[d] = 0;
+    }
+  }
+  return DenseElementsAttr::getFromRawBuffer(resultType, resultData);
+}
+
+bool Torch::isLogSoftmaxBackwardOfNllLoss(Operation *op) {
+  auto logSoftmaxBackward = dyn_cast<Aten_LogSoftmaxBackwardDataOp>(op);
+  if (!logSoftmaxBackward)
+    return false;
+  Value gradOutput = logSoftmaxBackward.grad_output();
+  if (!gradOutput.getDefiningOp<AtenNllLossBackwardOp>() ||
+      !gradOutput.hasOneUse())
+    return false;
+  int64_t rank = getTensorRank(logSoftmaxBackward.output());
+  int64_t dim;
+  if (!matchPattern(logSoftmaxBackward.dim(), m_TorchConstantInt(&dim)))
+    return false;
+  return (rank == 1 || rank == 2) && toPositiveDim(dim, rank) == rank - 1;
+}
+
+bool Torch::isViewLikeOp(Operation *op) {
+  // AtenContiguousOp might return a view, so this is conservatively
+  // correct. We could potentially be more precise and identify the cases
+  // that it does not return a view and treat those as having value
+  // semantics.
+  return isa<AtenBroadcastToOp, AtenContiguousOp, AtenDetachOp, AtenExpandAsOp,
+             AtenExpandOp, AtenFlattenUsingIntsOp, AtenPermuteOp, AtenReshapeOp,
+             Aten_ReshapeAliasOp, AtenSelectIntOp, AtenSliceTensorOp,
+             AtenSqueezeDimOp, AtenSqueezeOp, AtenTOp, AtenToDtypeOp,
+             AtenTransposeIntOp, AtenUnsqueezeOp, AtenViewOp,
+             TensorStaticInfoCastOp, AtenToDtypeLayoutOp, AtenNumpyTOp>(op);
+}
+
+// Returns true if `use` is the running mean or variance of a batch norm that
+// may be in training mode, which updates them in place.
+template <typename OpTy>
+static bool isUpdatedRunningStat(OpOperand &use) {
+  auto batchNorm = dyn_cast<OpTy>(use.getOwner());
+  if (!batchNorm || (use.get() != batchNorm.running_mean() &&
+                     use.get() != batchNorm.running_var()))
+    return false;
+  bool training;
+  return !matchPattern(batchNorm.training(), m_TorchConstantBool(&training)) ||
+         training;
+}
+
+LogicalResult Torch::getPerTensorQuantizationParams(Value tensor,
+                                                    Value &scale,
+                                                    Value &zeroPoint) {
+  if (auto create = tensor.getDefiningOp<PerTensorAffineCreateOp>()) {
+    scale = create.scale();
+    zeroPoint = create.offset();
+    return success();
+  }
+  if (auto linear = tensor.getDefiningOp<QuantizedLinearOp>()) {
+    scale = linear.Y_scale_i();
+    zeroPoint = linear.Y_zero_point_i();
+    return success();
+  }
+  if (auto relu = tensor.getDefiningOp<AtenReluOp>())
+    return getPerTensorQuantizationParams(relu.self(), scale, zeroPoint);
+  return failure();
+}
+
+bool Torch::isMutatedInPlace(Value tensor) {
+  SmallVector<Value> worklist = {tensor};
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    for (OpOperand &use : value.getUses()) {
+      Operation *user = use.getOwner();
+      // The in-place ops mutate their first operand.
+      bool isInPlaceOp =
+          isa<AtenUniform_Op, AtenBernoulli_FloatOp, AtenBernoulli_TensorOp,
+              AtenZero_Op, AtenFill_ScalarOp, Aten_IndexPutImpl_Op,
+              AtenCopy_Op>(user) ||
+          user->hasTrait<Torch::OpTrait::IsTrailingUnderscoreInplaceVariant>();
+      bool isMutatingUse = isInPlaceOp && use.getOperandNumber() == 0;
+      if (auto overwrite = dyn_cast<OverwriteTensorContentsOp>(user))
+        isMutatingUse = use.get() == overwrite.overwritten();
+      if (isMutatingUse || isUpdatedRunningStat<AtenBatchNormOp>(use) ||
+          isUpdatedRunningStat<AtenNativeBatchNormOp>(use))
+        return true;
+      // The optional tensors, like the running stats of a batch norm, are
+      // the tensor itself, also when selected by a `prim.If`.
+      if (isViewLikeOp(user) || isa<DerefineOp>(user))
+        worklist.push_back(user->getResult(0));
+      else if (isa<PrimIfYieldOp>(user))
+        worklist.push_back(
+            user->getParentOp()->getResult(use.getOperandNumber()));
+    }
+  }
+  return false;
+}
+
+// Returns true if `op` draws random numbers, so that each execution of it
+// computes a different result.
+static bool isRandomOp(Operation *op) {
+  return isa<AtenRandLikeOp, AtenBernoulliOp, AtenDropoutOp,
+             AtenNativeDropoutOp, ValsemVariantAtenUniformOp,
+             ValsemVariantAtenBernoulliFloatOp,
+             ValsemVariantAtenBernoulliTensorOp>(op) ||
+         llvm::any_of(op->getOperandTypes(),
+                      [](Type type) { return type.isa<GeneratorType>(); });
+}
+
+// Returns true if `v` has the same value wherever it is used, i.e. it is not a
+// non-value tensor or a list that may be mutated.
+static bool isImmutable(Value v) {
+  if (v.getType().isa<NonValueTensorType>())
+    return false;
+  if (v.getType().isa<Torch::ListType>())
+    return !isListPotentiallyMutated(v);
+  return true;
+}
+
+bool Torch::isMovableComputation(Operation *op) {
+  if (op->getNumRegions() != 0 || isRandomOp(op))
+    return false;
+  if (!op->hasTrait<Torch::OpTrait::HasValueSemantics>() &&
+      !op->hasTrait<Torch::OpTrait::ReadOnly>() &&
+      !MemoryEffectOpInterface::hasNoEffect(op))
+    return false;
+  return llvm::all_of(op->getOperands(), isImmutable) &&
+         llvm::all_of(op->getResults(), isImmutable);
+}
+
+bool Torch::isDefinedOutside(Value v, Region &region) {
+  return !region.isAncestor(v.getParentRegion());
+}
+
+SmallVector<Operation *> Torch::hoistCommonOps(
+    PrimIfOp ifOp, function_ref<bool(Operation *, Operation *)> isEquivalent) {
+  SmallVector<Operation *> hoisted;
+  Region &thenRegion = ifOp.thenRegion();
+  Region &elseRegion = ifOp.elseRegion();
+  for (Operation &thenOp :
+       llvm::make_early_inc_range(thenRegion.front().without_terminator())) {
+    if (!isMovableComputation(&thenOp) ||
+        !llvm::all_of(thenOp.getOperands(), [&](Value v) {
+          return isDefinedOutside(v, thenRegion);
+        }))
+      continue;
+    auto elseOp = llvm::find_if(
+        elseRegion.front().without_terminator(),
+        [&](Operation &op) { return isEquivalent(&thenOp, &op); });
+    if (elseOp == elseRegion.front().without_terminator().end())
+      continue;
+    thenOp.moveBefore(ifOp);
+    elseOp->replaceAllUsesWith(thenOp.getResults());
+    elseOp->erase();
+    hoisted.push_back(&thenOp);
+  }
+  return hoisted;
+}
+
+// The attribute naming the kernel of a custom kernel call, and the attribute
+// recording the number of its inputs once the shapes of its results are
+// attached after them.
+static constexpr StringRef kCustomKernelAttr = "torch.custom_kernel";
+static constexpr StringRef kCustomKernelNumInputsAttr =
+    "torch.custom_kernel_num_inputs";
+
+StringRef Torch::getCustomKernel(Operation *op) {
+  if (!isa<OperatorOp>(op))
+    return {};
+  auto kernel = op->getAttrOfType<StringAttr>(kCustomKernelAttr);
+  return kernel ? kernel.getValue() : StringRef();
+}
+
+OperandRange Torch::getCustomKernelInputs(Operation *op) {
+  auto numInputs = op->getAttrOfType<IntegerAttr>(kCustomKernelNumInputsAttr);
+  if (!numInputs)
+    return op->getOperands();
+  return op->getOperands().take_front(numInputs.getInt());
+}
+
+OperandRange Torch::getCustomKernelResultShapes(Operation *op) {
+  return op->getOperands().drop_front(getCustomKernelInputs(op).size());
+}
+
+void Torch::setCustomKernelResultShapes(Operation *op, ValueRange shapes) {
+  SmallVector<Value> operands = llvm::to_vector(getCustomKernelInputs(op));
+  op->setAttr(kCustomKernelNumInputsAttr,
+              IntegerAttr::get(IntegerType::get(op->getContext(), 64),
+                               operands.size()));
+  llvm::append_range(operands, shapes);
+  op->setOperands(operands);
+}
+
+static bool matchConstantScalar(Value v, double &value) {
+  int64_t intValue;
+  if (matchPattern(v, m_TorchConstantFloat(&value)))
+    return true;
+  if (!matchPattern(v, m_TorchConstantInt(&intValue)))
+    return false;
+  value = intValue;
+  return true;
+}
+
+FailureOr<AttentionMatch> Torch::matchAttention(Operation *root) {
+  auto op = dyn_cast<AtenMatmulOp>(root);
+  if (!op)
+    return failure();
+  AttentionMatch match;
+  match.value = op.other();
+  auto resultType = op.getType().dyn_cast<ValueTensorType>();
+  if (!resultType || !resultType.hasSizes() || !resultType.hasDtype() ||
+      !resultType.getDtype().isa<mlir::FloatType>())
+    return failure();
+  int64_t rank = resultType.getSizes().size();
+  if (rank < 2)
+    return failure();
+
+  // Each intermediate result must only feed the next op of the subgraph,
+  // since it is not computed anymore.
+  auto getIntermediateOp = [&](Value v) -> Operation * {
+    Operation *definingOp = v.getDefiningOp();
+    if (!definingOp || !v.hasOneUse())
+      return nullptr;
+    match.intermediateOps.push_back(definingOp);
+    return definingOp;
+  };
+  Operation *softmax = getIntermediateOp(op.self());
+  if (!softmax)
+    return failure();
+  int64_t dim;
+  if (auto softmaxInt = dyn_cast<AtenSoftmaxIntOp>(softmax)) {
+    if (!softmaxInt.dtype().getType().isa<Torch::NoneType>())
+      return failure();
+  } else if (auto softmaxOp = dyn_cast<Aten_SoftmaxOp>(softmax)) {
+    bool halfToFloat;
+    if (!matchPattern(softmaxOp.half_to_float(),
+                      m_TorchConstantBool(&halfToFloat)) ||
+        halfToFloat)
+      return failure();
+  } else {
+    return failure();
+  }
+  // Both softmax ops are (self, dim, ...).
+  if (!matchPattern(softmax->getOperand(1), m_TorchConstantInt(&dim)) ||
+      toPositiveDim(dim, rank) != rank - 1)
+    return failure();
+  Value scores = softmax->getOperand(0);
+
+  if (auto add = scores.getDefiningOp<AtenAddTensorOp>()) {
+    double alpha;
+    if (!getIntermediateOp(scores) ||
+        !matchConstantScalar(add.alpha(), alpha) || alpha != 1.0)
+      return failure();
+    match.mask = add.other();
+    scores = add.self();
+  }
+
+  if (auto div = scores.getDefiningOp<AtenDivScalarOp>()) {
+    double divisor;
+    if (!getIntermediateOp(scores) ||
+        !matchConstantScalar(div.other(), divisor) || divisor == 0.0)
+      return failure();
+    match.scale = 1.0 / divisor;
+    scores = div.self();
+  } else if (auto mul = scores.getDefiningOp<AtenMulScalarOp>()) {
+    if (!getIntermediateOp(scores) ||
+        !matchConstantScalar(mul.other(), match.scale))
+      return failure();
+    scores = mul.self();
+  }
+
+  Operation *queryKey = getIntermediateOp(scores);
+  if (!queryKey || !isa<AtenMatmulOp>(queryKey))
+    return failure();
+  match.query = queryKey->getOperand(0);
+  auto transpose = dyn_cast_or_null<AtenTransposeIntOp>(
+      getIntermediateOp(queryKey->getOperand(1)));
+  int64_t dim0, dim1;
+  if (!transpose ||
+      !matchPattern(transpose.dim0(), m_TorchConstantInt(&dim0)) ||
+      !matchPattern(transpose.dim1(), m_TorchConstantInt(&dim1)))
+    return failure();
+  dim0 = toPositiveDim(dim0, rank);
+  dim1 = toPositiveDim(dim1, rank);
+  if (std::min(dim0, dim1) != rank - 2 || std::max(dim0, dim1) != rank - 1)
+    return failure();
+  match.key = transpose.self();
+
+  // Batch dimensions of different ranks would be broadcast by the matmuls.
+  for (Value v : {match.query, match.key, match.value}) {
+    auto type = v.getType().dyn_cast<ValueTensorType>();
+    if (!type || !type.hasSizes() || type.getSizes().size() != rank ||
+        type.getOptionalDtype() != resultType.getDtype())
+      return failure();
+  }
+  if (match.mask) {
+    // A dynamic dimension of the mask may be 1 at runtime and be broadcast,
+    // which the attention op doesn't do.
+    auto type = match.mask.getType().dyn_cast<ValueTensorType>();
+    if (!type || !type.areAllSizesKnown() || type.getSizes().empty() ||
+        type.getSizes().size() > rank ||
+        type.getOptionalDtype() != resultType.getDtype())
+      return failure();
+  }
+  return match;
+}
+
+bool Torch::isAttentionMatmul(Operation *op) {
+  if (!isa<AtenMatmulOp>(op))
+    return false;
+  if (succeeded(matchAttention(op)))
+    return true;
+  // Otherwise `op` can only be the matmul of the query and the key, which is
+  // followed by at most a scaling, a mask and the softmax before the root.
+  Operation *user = op;
+  for (int i = 0; i < 4 && user->hasOneUse(); i++) {
+    user = *user->getUsers().begin();
+    if (!isa<AtenMatmulOp>(user))
+      continue;
+    FailureOr<AttentionMatch> match = matchAttention(user);
+    return succeeded(match) && llvm::is_contained(match->intermediateOps, op);
+  }
+  return false;
+}
@@ -55,5 +55,46 @@ OpFoldResult ToI64Op::fold(llvm::ArrayRef<mlir::Attribute> operands) {
   }
 }
 
+//===----------------------------------------------------------------------===//
+// GlobalTensorLoadOp / GlobalTensorStoreOp
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verifyGlobalTensorUse(Operation *op,
+                                           FlatSymbolRefAttr symbol, Type type,
+                                           SymbolTableCollection &symbolTable) {
+  auto global =
+      symbolTable.lookupNearestSymbolFrom<GlobalTensorOp>(op, symbol);
+  if (!global)
+    return op->emitOpError() << "'" << symbol.getValue()
+                             << "' does not reference a valid global tensor";
+  if (global.type() != type)
+    return op->emitOpError() << "type " << type
+                             << " does not match the type of the global "
+                             << global.type();
+  return success();
+}
+
+LogicalResult
+GlobalTensorLoadOp::verifySymbolUses(SymbolTableCollection &symbolTable) {
+  return verifyGlobalTensorUse(*this, globalAttr(), getType(), symbolTable);
+}
+
+LogicalResult
+GlobalTensorStoreOp::verifySymbolUses(SymbolTableCollection &symbolTable) {
+  return verifyGlobalTensorUse(*this, globalAttr(), value().getType(),
+                               symbolTable);
+}
+
+//===----------------------------------------------------------------------===//
+// CallKernelOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult CallKernelOp::verify() {
+  if (outputs().getTypes() != results().getTypes())
+    return emitOpError("expected the types of the results to match the types "
+                       "of the outputs");
+  return success();
+}
+
 #define GET_OP_CLASSES
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.cpp.inc"
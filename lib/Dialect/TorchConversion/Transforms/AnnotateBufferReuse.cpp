@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/CallInterfaces.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorInterfaces.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+static constexpr StringRef kReuseSlotAttr = "torch_c.reuse_slot";
+
+// Returns the result of `use`'s owner that holds the tensor of `use` once
+// bufferized in place: the result tied to an output of a destination-style
+// op, or the result of a view. Returns null if the result is a fresh tensor,
+// and fails if the op is unknown, in which case all its tensor results may
+// alias the operand.
+static FailureOr<Value> getAliasingResult(OpOperand &use) {
+  Operation *op = use.getOwner();
+  unsigned numInputs;
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(op))
+    numInputs = linalgOp.getNumInputs();
+  else if (auto tmTensorOp = dyn_cast<TMTensor::TMTensorOp>(op))
+    numInputs = tmTensorOp.getNumInputs();
+  else if (auto insertSlice = dyn_cast<tensor::InsertSliceOp>(op))
+    return use.get() == insertSlice.dest() ? insertSlice.getResult() : Value();
+  else if (isa<tensor::CastOp, tensor::ExtractSliceOp, tensor::ExpandShapeOp,
+               tensor::CollapseShapeOp>(op))
+    return op->getResult(0);
+  else if (isa<tensor::ExtractOp, tensor::DimOp>(op))
+    return Value();
+  else
+    return failure();
+  if (use.getOperandNumber() < numInputs)
+    return Value();
+  return op->getResult(use.getOperandNumber() - numInputs);
+}
+
+namespace {
+// A fresh tensor of the entry block, live from the op at index `begin` to the
+// one at index `end` of that block.
+struct LiveTensor {
+  linalg::InitTensorOp init;
+  int64_t size;
+  unsigned begin;
+  unsigned end;
+};
+} // namespace
+
+// Returns the index in `block` of the last op using the tensor of `init`, or
+// a tensor aliasing it once bufferized, or None if it escapes the block.
+static Optional<unsigned>
+getLastUse(linalg::InitTensorOp init, Block &block,
+           const DenseMap<Operation *, unsigned> &indices) {
+  unsigned end = indices.lookup(init);
+  SmallVector<Value> worklist{init.getResult()};
+  DenseSet<Value> visited;
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (!visited.insert(value).second)
+      continue;
+    for (OpOperand &use : value.getUses()) {
+      Operation *user = use.getOwner();
+      Operation *ancestor = block.findAncestorOpInBlock(*user);
+      if (!ancestor || user->hasTrait<OpTrait::IsTerminator>() ||
+          isa<CallOpInterface>(user))
+        return None;
+      end = std::max(end, indices.lookup(ancestor));
+      FailureOr<Value> result = getAliasingResult(use);
+      if (failed(result)) {
+        for (Value result : user->getResults())
+          if (result.getType().isa<TensorType>())
+            worklist.push_back(result);
+      } else if (*result) {
+        worklist.push_back(*result);
+      }
+    }
+  }
+  return end;
+}
+
+// Gives each `linalg.init_tensor` its own op, so that its uses are
+// different tensors with their own lifetimes. CSE merges the identical
+// `linalg.init_tensor` ops, which would otherwise make a single tensor of
+// all the outputs that have the same shape.
+static void splitInitTensors(Block &block) {
+  for (auto init :
+       llvm::make_early_inc_range(block.getOps<linalg::InitTensorOp>())) {
+    SmallVector<OpOperand *> uses;
+    for (OpOperand &use : init->getUses())
+      uses.push_back(&use);
+    OpBuilder b(init);
+    for (OpOperand *use : llvm::drop_begin(uses)) {
+      Operation *ancestor = block.findAncestorOpInBlock(*use->getOwner());
+      if (!ancestor)
+        continue;
+      b.setInsertionPoint(ancestor);
+      use->set(b.clone(*init)->getResult(0));
+    }
+  }
+}
+
+// Annotates the fresh tensors of the entry block of `func` with the slots
+// they can be stored in, such that tensors live at the same time are in
+// different slots.
+static void annotateReuseSlots(func::FuncOp func) {
+  Block &block = func.getBody().front();
+  splitInitTensors(block);
+  DenseMap<Operation *, unsigned> indices;
+  for (auto it : llvm::enumerate(block))
+    indices[&it.value()] = it.index();
+
+  SmallVector<LiveTensor> tensors;
+  for (auto init : block.getOps<linalg::InitTensorOp>()) {
+    RankedTensorType type = init.getType();
+    if (!type.hasStaticShape() || !type.getElementType().isIntOrFloat())
+      continue;
+    Optional<unsigned> end = getLastUse(init, block, indices);
+    if (!end)
+      continue;
+    int64_t elementSize = llvm::divideCeil(type.getElementTypeBitWidth(), 8);
+    tensors.push_back(
+        {init, type.getNumElements() * elementSize, indices[init], *end});
+  }
+
+  // Linear scan in program order: each tensor takes the first slot of its
+  // size whose tensors are all dead by the time it is created.
+  struct Slot {
+    int64_t size;
+    unsigned end;
+  };
+  SmallVector<Slot> slots;
+  Builder b(func.getContext());
+  for (LiveTensor &tensor : tensors) {
+    auto *slot = llvm::find_if(slots, [&](const Slot &slot) {
+      return slot.size == tensor.size && slot.end < tensor.begin;
+    });
+    if (slot == slots.end()) {
+      slots.push_back({tensor.size, tensor.end});
+      slot = &slots.back();
+    }
+    slot->end = tensor.end;
+    tensor.init->setAttr(kReuseSlotAttr,
+                         b.getI64IntegerAttr(slot - slots.begin()));
+  }
+}
+
+namespace {
+class AnnotateBufferReusePass
+    : public AnnotateBufferReuseBase<AnnotateBufferReusePass> {
+  void runOnOperation() override {
+    func::FuncOp func = getOperation();
+    if (func.isDeclaration())
+      return;
+    annotateReuseSlots(func);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::TorchConversion::createAnnotateBufferReusePass() {
+  return std::make_unique<AnnotateBufferReusePass>();
+}
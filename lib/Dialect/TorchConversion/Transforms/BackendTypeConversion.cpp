@@ -23,6 +23,23 @@ void mlir::torch::TorchConversion::getBackendTypeConversionDependentDialects(
 // Type conversion setup.
 //===----------------------------------------------------------------------===//
 
+// Returns the value of type `type` that `input` was materialized from by an
+// op of type `OpTy`, or null if there is none.
+//
+// The torch-to-backend conversions run one after the other, and wrap the
+// values produced by each of them in materializations back to the Torch types
+// for the ops that it doesn't convert. Looking through these materializations
+// lets the ops converted by a later conversion use the builtin values
+// directly, instead of materializing them again, so that no pairs of
+// materializations are left for the finalizing conversion to fold.
+template <typename OpTy>
+static Value lookThroughMaterialization(Value input, Type type) {
+  auto op = input.getDefiningOp<OpTy>();
+  if (op && op->getOperand(0).getType() == type)
+    return op->getOperand(0);
+  return nullptr;
+}
+
 static void
 setupValueTensorToBuiltinTensorConversion(ConversionTarget &target,
                                           TypeConverter &typeConverter) {
@@ -37,6 +54,9 @@ setupValueTensorToBuiltinTensorConversion(ConversionTarget &target,
                                             Location loc) -> Value {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<Torch::BaseTensorType>());
+    if (Value value =
+            lookThroughMaterialization<FromBuiltinTensorOp>(inputs[0], type))
+      return value;
     return builder.create<ToBuiltinTensorOp>(loc, inputs[0]);
   });
   auto sourceMaterialization = [](OpBuilder &builder,
@@ -44,6 +64,9 @@ setupValueTensorToBuiltinTensorConversion(ConversionTarget &target,
                                   ValueRange inputs, Location loc) -> Value {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<TensorType>());
+    if (Value value =
+            lookThroughMaterialization<ToBuiltinTensorOp>(inputs[0], type))
+      return value;
     return builder.create<FromBuiltinTensorOp>(loc, type, inputs[0]);
   };
   typeConverter.addSourceMaterialization(sourceMaterialization);
@@ -64,12 +87,16 @@ static void setupTorchBoolToI1Conversion(ConversionTarget &target,
       return None;
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<Torch::BoolType>());
+    if (Value value = lookThroughMaterialization<FromI1Op>(inputs[0], type))
+      return value;
     return builder.create<ToI1Op>(loc, inputs[0]).getResult();
   });
   auto sourceMaterialization = [](OpBuilder &builder, Torch::BoolType type,
                                   ValueRange inputs, Location loc) -> Value {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<IntegerType>());
+    if (Value value = lookThroughMaterialization<ToI1Op>(inputs[0], type))
+      return value;
     return builder.create<FromI1Op>(loc, inputs[0]);
   };
   typeConverter.addSourceMaterialization(sourceMaterialization);
@@ -93,12 +120,16 @@ static void setupTorchIntToI64Conversion(ConversionTarget &target,
     if (!inputs[0].getType().isa<Torch::IntType>())
       return None;
     assert(inputs.size() == 1);
+    if (Value value = lookThroughMaterialization<FromI64Op>(inputs[0], type))
+      return value;
     return builder.create<ToI64Op>(loc, inputs[0]).getResult();
   });
   auto sourceMaterialization = [](OpBuilder &builder, Torch::IntType type,
                                   ValueRange inputs, Location loc) -> Value {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<IntegerType>());
+    if (Value value = lookThroughMaterialization<ToI64Op>(inputs[0], type))
+      return value;
     return builder.create<FromI64Op>(loc, inputs[0]);
   };
   typeConverter.addSourceMaterialization(sourceMaterialization);
@@ -116,12 +147,16 @@ static void setupTorchFloatToF64Conversion(ConversionTarget &target,
                                             Location loc) -> Optional<Value> {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<Torch::FloatType>());
+    if (Value value = lookThroughMaterialization<FromF64Op>(inputs[0], type))
+      return value;
     return builder.create<ToF64Op>(loc, inputs[0]).getResult();
   });
   auto sourceMaterialization = [](OpBuilder &builder, Torch::FloatType type,
                                   ValueRange inputs, Location loc) -> Value {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<Float64Type>());
+    if (Value value = lookThroughMaterialization<ToF64Op>(inputs[0], type))
+      return value;
     return builder.create<FromF64Op>(loc, inputs[0]);
   };
   typeConverter.addSourceMaterialization(sourceMaterialization);
@@ -146,12 +181,18 @@ static void setupTorchGeneratorToI64Conversion(ConversionTarget &target,
     if (!inputs[0].getType().isa<Torch::GeneratorType>())
       return None;
     assert(inputs.size() == 1);
+    if (Value value =
+            lookThroughMaterialization<I64ToGeneratorOp>(inputs[0], type))
+      return value;
     return builder.create<GeneratorToI64Op>(loc, inputs[0]).getResult();
   });
   auto sourceMaterialization = [](OpBuilder &builder, Torch::GeneratorType type,
                                   ValueRange inputs, Location loc) -> Value {
     assert(inputs.size() == 1);
     assert(inputs[0].getType().isa<IntegerType>());
+    if (Value value =
+            lookThroughMaterialization<GeneratorToI64Op>(inputs[0], type))
+      return value;
     return builder.create<I64ToGeneratorOp>(loc, inputs[0]);
   };
   typeConverter.addSourceMaterialization(sourceMaterialization);
@@ -15,6 +15,7 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
 #include "torch-mlir/Dialect/TorchConversion/Transforms/BackendTypeConversion.h"
 #include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
@@ -27,6 +28,74 @@ using namespace mlir::torch::TorchConversion;
 // FuncBackendTypeConversionPass
 //===----------------------------------------------------------------------===//
 
+// Returns `elements` with signless integer elements, like the constants that
+// tensor literals are converted to.
+static ElementsAttr getBuiltinElements(ElementsAttr elements) {
+  auto dense = elements.dyn_cast<DenseIntElementsAttr>();
+  if (!dense || dense.getElementType().isSignlessInteger())
+    return elements;
+  unsigned bitWidth = dense.getElementType().getIntOrFloatBitWidth();
+  Type elemTy = IntegerType::get(elements.getContext(), bitWidth);
+  return dense.mapValues(elemTy, [&](const APInt &v) { return v; });
+}
+
+// Replaces the `torch.global_slot`s holding value-semantic tensors, which
+// must be initialized with a literal, with `torch_c.global_tensor`s.
+static LogicalResult convertTensorGlobalSlots(ModuleOp module) {
+  for (auto globalSlot :
+       llvm::make_early_inc_range(module.getOps<Torch::GlobalSlotOp>())) {
+    auto type = globalSlot.typeBound().dyn_cast<Torch::ValueTensorType>();
+    if (!type)
+      continue;
+    auto init = cast<Torch::GlobalSlotInitOp>(
+        globalSlot.getBody()->getTerminator());
+    auto literal =
+        init.initialValue().getDefiningOp<Torch::ValueTensorLiteralOp>();
+    if (!literal)
+      return globalSlot.emitError("unimplemented: tensor global slot not "
+                                  "initialized with a tensor literal");
+    OpBuilder builder(globalSlot);
+    builder.create<GlobalTensorOp>(
+        globalSlot.getLoc(), globalSlot.sym_nameAttr(),
+        globalSlot.sym_visibilityAttr(), TypeAttr::get(type.toBuiltinTensor()),
+        getBuiltinElements(literal.valueAttr()));
+    globalSlot.erase();
+  }
+  return success();
+}
+
+namespace {
+class ConvertGlobalSlotGetOp
+    : public OpConversionPattern<Torch::GlobalSlotGetOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(Torch::GlobalSlotGetOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Type type = getTypeConverter()->convertType(op.getType());
+    if (!type.isa<TensorType>())
+      return failure();
+    rewriter.replaceOpWithNewOp<GlobalTensorLoadOp>(op, type, op.slotAttr());
+    return success();
+  }
+};
+
+class ConvertGlobalSlotSetOp
+    : public OpConversionPattern<Torch::GlobalSlotSetOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(Torch::GlobalSlotSetOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!adaptor.value().getType().isa<TensorType>())
+      return failure();
+    rewriter.replaceOpWithNewOp<GlobalTensorStoreOp>(op, op.slotAttr(),
+                                                     adaptor.value());
+    return success();
+  }
+};
+} // namespace
+
 namespace {
 struct FuncBackendTypeConversionPass
     : public FuncBackendTypeConversionBase<FuncBackendTypeConversionPass> {
@@ -39,12 +108,26 @@ struct FuncBackendTypeConversionPass
     auto module = getOperation();
     auto *context = &getContext();
 
+    if (failed(convertTensorGlobalSlots(module)))
+      return signalPassFailure();
+
     TypeConverter typeConverter;
     RewritePatternSet patterns(context);
     ConversionTarget target(*context);
     typeConverter.addConversion([](Type type) { return type; });
     TorchConversion::setupBackendTypeConversion(target, typeConverter);
 
+    patterns.add<ConvertGlobalSlotGetOp>(typeConverter, context);
+    target.addDynamicallyLegalOp<Torch::GlobalSlotGetOp>(
+        [](Torch::GlobalSlotGetOp op) {
+          return !op.getType().isa<Torch::ValueTensorType>();
+        });
+    patterns.add<ConvertGlobalSlotSetOp>(typeConverter, context);
+    target.addDynamicallyLegalOp<Torch::GlobalSlotSetOp>(
+        [](Torch::GlobalSlotSetOp op) {
+          return !op.value().getType().isa<Torch::ValueTensorType>();
+        });
+
     populateFunctionOpInterfaceTypeConversionPattern<func::FuncOp>(
         patterns, typeConverter);
     target.addDynamicallyLegalOp<func::FuncOp>([&](func::FuncOp op) {
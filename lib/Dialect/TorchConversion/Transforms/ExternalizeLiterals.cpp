@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionDialect.h"
+#include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+// Like the tensors written by the TorchScript importer, each tensor starts on
+// a page boundary so that the file can be mapped into memory.
+static constexpr int64_t kAlignment = 4096;
+
+// Returns the elements of `op`, a tensor literal, if they are worth moving to
+// a file that stores them as a contiguous row-major buffer.
+static DenseIntOrFPElementsAttr getExternalizableElements(Operation *op,
+                                                          int64_t minBytes) {
+  Attribute value;
+  if (auto literal = dyn_cast<Torch::ValueTensorLiteralOp>(op))
+    value = literal.valueAttr();
+  else if (op->getResult(0).getType().isa<RankedTensorType>())
+    value = cast<arith::ConstantOp>(op).getValue();
+  auto elements = value.dyn_cast_or_null<DenseIntOrFPElementsAttr>();
+  if (!elements || elements.isSplat())
+    return nullptr;
+  // Booleans are stored as packed bits.
+  int64_t bitWidth = elements.getType().getElementTypeBitWidth();
+  if (bitWidth % 8 != 0)
+    return nullptr;
+  if (elements.getNumElements() * (bitWidth / 8) < minBytes)
+    return nullptr;
+  return elements;
+}
+
+// Returns whether the module has external literals referring to `file`.
+static bool refersToFile(ModuleOp module, StringRef file) {
+  return module
+      .walk([&](Operation *op) {
+        StringAttr literalFile;
+        if (auto literal = dyn_cast<Torch::ValueTensorExternalLiteralOp>(op))
+          literalFile = literal.fileAttr();
+        else if (auto literal = dyn_cast<ExternalLiteralOp>(op))
+          literalFile = literal.fileAttr();
+        return literalFile && literalFile.getValue() == file
+                   ? WalkResult::interrupt()
+                   : WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+namespace {
+class ExternalizeLiteralsPass
+    : public ExternalizeLiteralsBase<ExternalizeLiteralsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<TorchConversionDialect>();
+  }
+
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    if (file.empty()) {
+      module.emitError("the file to externalize the literals to is not set");
+      return signalPassFailure();
+    }
+
+    SmallVector<std::pair<Operation *, DenseIntOrFPElementsAttr>> literals;
+    module.walk([&](Operation *op) {
+      if (!isa<Torch::ValueTensorLiteralOp, arith::ConstantOp>(op))
+        return;
+      if (auto elements = getExternalizableElements(op, minBytes))
+        literals.emplace_back(op, elements);
+    });
+
+    // Append to a file that the module already refers to, so that its
+    // contents stay valid.
+    uint64_t offset = 0;
+    auto flags = llvm::sys::fs::OF_None;
+    if (refersToFile(module, file)) {
+      if (std::error_code ec = llvm::sys::fs::file_size(file, offset)) {
+        module.emitError() << "could not get the size of '" << file
+                           << "': " << ec.message();
+        return signalPassFailure();
+      }
+      flags = llvm::sys::fs::OF_Append;
+    }
+    std::error_code ec;
+    llvm::raw_fd_ostream os(file, ec, flags);
+    if (ec) {
+      module.emitError() << "could not open '" << file
+                         << "': " << ec.message();
+      return signalPassFailure();
+    }
+
+    // Attributes are uniqued, so identical literals share their offset.
+    DenseMap<Attribute, uint64_t> offsets;
+    OpBuilder b(module.getContext());
+    StringAttr fileAttr = b.getStringAttr(file);
+    for (auto &it : literals) {
+      Operation *op = it.first;
+      DenseIntOrFPElementsAttr elements = it.second;
+      auto inserted = offsets.try_emplace(elements, 0);
+      if (inserted.second) {
+        uint64_t alignedOffset = llvm::alignTo(offset, kAlignment);
+        os.write_zeros(alignedOffset - offset);
+        ArrayRef<char> data = elements.getRawData();
+        os.write(data.data(), data.size());
+        inserted.first->second = alignedOffset;
+        offset = alignedOffset + data.size();
+      }
+
+      b.setInsertionPoint(op);
+      IntegerAttr offsetAttr = b.getI64IntegerAttr(inserted.first->second);
+      Operation *externalLiteral;
+      if (isa<Torch::ValueTensorLiteralOp>(op)) {
+        externalLiteral = b.create<Torch::ValueTensorExternalLiteralOp>(
+            op->getLoc(), op->getResult(0).getType(), fileAttr, offsetAttr);
+      } else {
+        externalLiteral = b.create<ExternalLiteralOp>(
+            op->getLoc(), op->getResult(0).getType(), fileAttr, offsetAttr);
+      }
+      op->replaceAllUsesWith(externalLiteral);
+      op->erase();
+    }
+
+    os.close();
+    if (os.has_error()) {
+      module.emitError() << "could not write to '" << file
+                         << "': " << os.error().message();
+      os.clear_error();
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::TorchConversion::createExternalizeLiteralsPass() {
+  return std::make_unique<ExternalizeLiteralsPass>();
+}
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+namespace {
+// Makes the elementwise `linalg.generic` computing the source of a
+// `tensor.insert_slice` write into the slice of the destination it is inserted
+// into, instead of into a fresh tensor:
+//   %0 = linalg.generic ins(...) outs(%init)
+//   %1 = tensor.insert_slice %0 into %dest[offsets][sizes][strides]
+// becomes
+//   %slice = tensor.extract_slice %dest[offsets][sizes][strides]
+//   %0 = linalg.generic ins(...) outs(%slice)
+//   %1 = tensor.insert_slice %0 into %dest[offsets][sizes][strides]
+// Bufferization then computes the generic in place in the destination buffer,
+// and the insert_slice of the slice into itself is a no-op, so that e.g. the
+// inputs of a concatenation are never copied.
+class ComputeInsertedSliceInPlace
+    : public OpRewritePattern<tensor::InsertSliceOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(tensor::InsertSliceOp op,
+                                PatternRewriter &rewriter) const override {
+    Value source = op.source();
+    auto cast = source.getDefiningOp<tensor::CastOp>();
+    if (cast && cast->hasOneUse())
+      source = cast.source();
+    auto producer = source.getDefiningOp<linalg::GenericOp>();
+    if (!producer || producer->getNumResults() != 1 || !source.hasOneUse() ||
+        producer.getNumOutputs() != 1)
+      return rewriter.notifyMatchFailure(op, "expected a single-use generic");
+    if (producer.getNumParallelLoops() != producer.getNumLoops())
+      return rewriter.notifyMatchFailure(op, "expected an elementwise generic");
+    OpOperand *output = producer.getOutputOperand(0);
+    if (!output->get().getDefiningOp<linalg::InitTensorOp>() ||
+        producer.payloadUsesValueFromOperand(output) ||
+        !producer.getTiedIndexingMap(output).isIdentity())
+      return rewriter.notifyMatchFailure(
+          op, "expected a generic computing a fresh tensor");
+    if (op.getSourceType().getRank() != op.getType().getRank())
+      return rewriter.notifyMatchFailure(op, "unimplemented: rank reduction");
+
+    rewriter.setInsertionPoint(op);
+    Value slice = rewriter.create<tensor::ExtractSliceOp>(
+        op.getLoc(), op.dest(), op.getMixedOffsets(), op.getMixedSizes(),
+        op.getMixedStrides());
+    // The destination and offsets may be defined after the generic, which has
+    // no other user.
+    rewriter.updateRootInPlace(producer, [&]() {
+      producer->moveBefore(op);
+      output->set(slice);
+      producer->getResult(0).setType(slice.getType());
+    });
+    rewriter.updateRootInPlace(
+        op, [&]() { op.sourceMutable().assign(producer->getResult(0)); });
+    if (cast)
+      rewriter.eraseOp(cast);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class InsertSliceDestinationPassingPass
+    : public InsertSliceDestinationPassingBase<
+          InsertSliceDestinationPassingPass> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<ComputeInsertedSliceInPlace>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::TorchConversion::createInsertSliceDestinationPassingPass() {
+  return std::make_unique<InsertSliceDestinationPassingPass>();
+}
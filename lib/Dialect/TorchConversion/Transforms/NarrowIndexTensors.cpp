@@ -0,0 +1,265 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+
+#include <limits>
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+static bool isNarrowableDimSize(ShapedType type, int64_t dim) {
+  return !type.isDynamicDim(dim) &&
+         type.getDimSize(dim) <= std::numeric_limits<int32_t>::max();
+}
+
+// Returns whether `index` is only used as offsets of `op` along dimensions of
+// `type` that are narrowable.
+template <typename OpTy>
+static bool isBoundedSliceOffset(OpTy op, ShapedType type, Value index) {
+  if (llvm::is_contained(op.sizes(), index) ||
+      llvm::is_contained(op.strides(), index))
+    return false;
+  for (auto it : llvm::enumerate(op.getMixedOffsets())) {
+    if (it.value().template dyn_cast<Value>() == index &&
+        !isNarrowableDimSize(type, it.index()))
+      return false;
+  }
+  return true;
+}
+
+// Returns whether `index` only indexes dimensions of static size at most
+// INT32_MAX, possibly after being wrapped (for negative indices) or compared
+// in bounds checks. The value of any such in-bounds index fits in an i32.
+static bool isBoundedIndex(Value index) {
+  SmallVector<Value> worklist{index};
+  DenseSet<Value> visited;
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (!visited.insert(value).second)
+      continue;
+    for (OpOperand &use : value.getUses()) {
+      Operation *user = use.getOwner();
+      if (isa<arith::CmpIOp>(user))
+        continue;
+      if (isa<arith::AddIOp, arith::SubIOp, arith::SelectOp>(user)) {
+        worklist.push_back(user->getResult(0));
+        continue;
+      }
+      if (auto extract = dyn_cast<tensor::ExtractOp>(user)) {
+        if (!isNarrowableDimSize(extract.tensor().getType().cast<ShapedType>(),
+                                 use.getOperandNumber() - 1))
+          return false;
+        continue;
+      }
+      if (auto slice = dyn_cast<tensor::ExtractSliceOp>(user)) {
+        if (!isBoundedSliceOffset(slice, slice.getSourceType(), value))
+          return false;
+        continue;
+      }
+      if (auto slice = dyn_cast<tensor::InsertSliceOp>(user)) {
+        if (!isBoundedSliceOffset(slice, slice.getType(), value))
+          return false;
+        continue;
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool isUnsignedPredicate(arith::CmpIPredicate predicate) {
+  return predicate == arith::CmpIPredicate::ult ||
+         predicate == arith::CmpIPredicate::ule ||
+         predicate == arith::CmpIPredicate::ugt ||
+         predicate == arith::CmpIPredicate::uge;
+}
+
+// Returns whether `element`, an element of an i64 index tensor, is only cast
+// to bounded indices, or compared with constants strictly inside the i32 range
+// (e.g. the check that it is non-negative), so that it can be an i32 instead.
+// The comparisons then agree for the values saturated to the i32 range.
+static bool isNarrowableElement(Value element) {
+  for (OpOperand &use : element.getUses()) {
+    Operation *user = use.getOwner();
+    if (auto cast = dyn_cast<arith::IndexCastOp>(user)) {
+      if (!cast.getType().isa<IndexType>() || !isBoundedIndex(cast))
+        return false;
+      continue;
+    }
+    if (auto cmp = dyn_cast<arith::CmpIOp>(user)) {
+      APInt constant;
+      if (isUnsignedPredicate(cmp.getPredicate()) ||
+          !matchPattern(cmp->getOperand(1 - use.getOperandNumber()),
+                        m_ConstantInt(&constant)) ||
+          constant.sle(std::numeric_limits<int32_t>::min()) ||
+          constant.sge(std::numeric_limits<int32_t>::max()))
+        return false;
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+// Returns whether all the uses of `tensor` read its elements as narrowable
+// elements, possibly through casts.
+static bool isNarrowableIndexTensor(Value tensor) {
+  for (OpOperand &use : tensor.getUses()) {
+    Operation *user = use.getOwner();
+    if (auto extract = dyn_cast<tensor::ExtractOp>(user)) {
+      if (use.get() != extract.tensor() || !isNarrowableElement(extract))
+        return false;
+      continue;
+    }
+    if (auto cast = dyn_cast<tensor::CastOp>(user)) {
+      if (!isNarrowableIndexTensor(cast))
+        return false;
+      continue;
+    }
+    if (auto generic = dyn_cast<linalg::GenericOp>(user)) {
+      if (!generic.hasTensorSemantics() ||
+          use.getOperandNumber() >= generic.getNumInputs() ||
+          !isNarrowableElement(generic.getTiedBlockArgument(&use)))
+        return false;
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+static Type getNarrowedType(Type type) {
+  auto tensorType = type.cast<RankedTensorType>();
+  return RankedTensorType::get(tensorType.getShape(),
+                               IntegerType::get(type.getContext(), 32),
+                               tensorType.getEncoding());
+}
+
+static void narrowElement(Value element) {
+  OpBuilder b(element.getContext());
+  element.setType(b.getI32Type());
+  for (OpOperand &use : element.getUses()) {
+    auto cmp = dyn_cast<arith::CmpIOp>(use.getOwner());
+    if (!cmp)
+      continue;
+    unsigned constantIndex = 1 - use.getOperandNumber();
+    APInt constant;
+    matchPattern(cmp->getOperand(constantIndex), m_ConstantInt(&constant));
+    b.setInsertionPoint(cmp);
+    cmp->setOperand(constantIndex,
+                    b.create<arith::ConstantOp>(
+                        cmp.getLoc(),
+                        b.getI32IntegerAttr(constant.getSExtValue())));
+  }
+}
+
+// Updates the uses of `tensor`, whose type was narrowed, to read i32s.
+static void narrowUses(Value tensor) {
+  for (OpOperand &use : tensor.getUses()) {
+    Operation *user = use.getOwner();
+    if (auto extract = dyn_cast<tensor::ExtractOp>(user)) {
+      narrowElement(extract);
+    } else if (auto castOp = dyn_cast<tensor::CastOp>(user)) {
+      castOp.getResult().setType(getNarrowedType(castOp.getType()));
+      narrowUses(castOp);
+    } else {
+      narrowElement(
+          cast<linalg::GenericOp>(user).getTiedBlockArgument(&use));
+    }
+  }
+}
+
+// Saturates the i64 `value` to the i32 range and truncates it. An index out
+// of the i32 range becomes INT32_MIN or INT32_MAX, which is still out of the
+// bounds of any narrowable dimension, also once wrapped for negative values,
+// so the bounds checks still catch it rather than an index truncated into
+// bounds.
+static Value saturateToI32(OpBuilder &b, Location loc, Value value) {
+  Value min = b.create<arith::ConstantOp>(
+      loc, b.getI64IntegerAttr(std::numeric_limits<int32_t>::min()));
+  Value max = b.create<arith::ConstantOp>(
+      loc, b.getI64IntegerAttr(std::numeric_limits<int32_t>::max()));
+  value = b.create<arith::MaxSIOp>(loc, value, min);
+  value = b.create<arith::MinSIOp>(loc, value, max);
+  return b.create<arith::TruncIOp>(loc, b.getI32Type(), value);
+}
+
+// Narrows `tensor` to an i32 tensor if it is computed by a constant whose
+// values fit in an i32, or by a `linalg.generic` into a fresh tensor, and is
+// only used as indices into dimensions of static size at most INT32_MAX.
+static void narrowIndexTensor(OpResult tensor) {
+  auto type = tensor.getType().dyn_cast<RankedTensorType>();
+  if (!type || !type.getElementType().isSignlessInteger(64) ||
+      tensor.use_empty() || !isNarrowableIndexTensor(tensor))
+    return;
+
+  Operation *producer = tensor.getOwner();
+  OpBuilder b(producer);
+  if (isa<arith::ConstantOp>(producer)) {
+    DenseIntElementsAttr values;
+    if (!matchPattern(tensor, m_Constant(&values)) ||
+        !llvm::all_of(values.getValues<APInt>(), [](APInt value) {
+          return value.isSignedIntN(32);
+        }))
+      return;
+    producer->setAttr("value",
+                      values.mapValues(b.getI32Type(), [](const APInt &value) {
+                        return value.trunc(32);
+                      }));
+  } else if (auto generic = dyn_cast<linalg::GenericOp>(producer)) {
+    if (!generic.hasTensorSemantics())
+      return;
+    OpOperand *output = generic.getOutputOperand(tensor.getResultNumber());
+    auto init = output->get().getDefiningOp<linalg::InitTensorOp>();
+    BlockArgument outputArg = generic.getTiedBlockArgument(output);
+    if (!init || !outputArg.use_empty())
+      return;
+    output->set(b.create<linalg::InitTensorOp>(
+        init.getLoc(), init.getMixedSizes(), b.getI32Type()));
+    outputArg.setType(b.getI32Type());
+    Operation *yield = generic.getBody()->getTerminator();
+    b.setInsertionPoint(yield);
+    Value yielded = yield->getOperand(tensor.getResultNumber());
+    yield->setOperand(tensor.getResultNumber(),
+                      saturateToI32(b, yielded.getLoc(), yielded));
+  } else {
+    return;
+  }
+  tensor.setType(getNarrowedType(type));
+  narrowUses(tensor);
+}
+
+namespace {
+class NarrowIndexTensorsPass
+    : public NarrowIndexTensorsBase<NarrowIndexTensorsPass> {
+  void runOnOperation() override {
+    SmallVector<OpResult> tensors;
+    getOperation().walk([&](Operation *op) {
+      if (isa<arith::ConstantOp, linalg::GenericOp>(op))
+        llvm::append_range(tensors, op->getResults());
+    });
+    for (OpResult tensor : tensors)
+      narrowIndexTensor(tensor);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::TorchConversion::createNarrowIndexTensorsPass() {
+  return std::make_unique<NarrowIndexTensorsPass>();
+}
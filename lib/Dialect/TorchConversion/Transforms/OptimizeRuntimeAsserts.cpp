@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+// Collects into `slice`, in topological order, the ops computing `value`.
+// Returns false if `value` can't be computed at the start of `entryBlock`,
+// because it depends on an op with side effects or regions, or on a block
+// argument other than those of `entryBlock`.
+static bool collectHoistableSlice(Value value, Block *entryBlock,
+                                  llvm::SetVector<Operation *> &slice) {
+  if (auto arg = value.dyn_cast<BlockArgument>())
+    return arg.getOwner() == entryBlock;
+  Operation *op = value.getDefiningOp();
+  if (slice.contains(op))
+    return true;
+  if (op->getNumRegions() != 0 || !MemoryEffectOpInterface::hasNoEffect(op))
+    return false;
+  for (Value operand : op->getOperands()) {
+    if (!collectHoistableSlice(operand, entryBlock, slice))
+      return false;
+  }
+  slice.insert(op);
+  return true;
+}
+
+namespace {
+class OptimizeRuntimeAssertsPass
+    : public OptimizeRuntimeAssertsBase<OptimizeRuntimeAssertsPass> {
+public:
+  OptimizeRuntimeAssertsPass() = default;
+  OptimizeRuntimeAssertsPass(bool elide) { this->elide = elide; }
+
+  void runOnOperation() override {
+    func::FuncOp func = getOperation();
+    if (elide) {
+      func.walk([](cf::AssertOp op) { op.erase(); });
+      return;
+    }
+    if (func.getBody().empty())
+      return;
+
+    // Only the asserts of the entry block are hoisted: those in nested
+    // regions might not execute at all.
+    Block *entryBlock = &func.getBody().front();
+    SmallVector<cf::AssertOp> asserts(entryBlock->getOps<cf::AssertOp>());
+    DenseSet<Value> checkedConditions;
+    // The hoisted asserts and the ops computing their conditions are moved
+    // in order before this op.
+    Operation *insertionPoint = &entryBlock->front();
+    // The first assert that stays in place. The ops after it may only be
+    // valid when its condition holds, e.g. a `tensor.extract` at an index
+    // checked to be in bounds, so they are never hoisted above it.
+    Operation *firstKeptAssert = nullptr;
+    for (cf::AssertOp op : asserts) {
+      if (!checkedConditions.insert(op.getArg()).second) {
+        if (op == insertionPoint)
+          insertionPoint = op->getNextNode();
+        op.erase();
+        continue;
+      }
+      llvm::SetVector<Operation *> slice;
+      if (!collectHoistableSlice(op.getArg(), entryBlock, slice) ||
+          (firstKeptAssert &&
+           llvm::any_of(slice, [&](Operation *sliceOp) {
+             return firstKeptAssert->isBeforeInBlock(sliceOp);
+           }))) {
+        if (!firstKeptAssert)
+          firstKeptAssert = op;
+        continue;
+      }
+      slice.insert(op);
+      for (Operation *sliceOp : slice) {
+        if (sliceOp == insertionPoint) {
+          insertionPoint = sliceOp->getNextNode();
+          continue;
+        }
+        if (sliceOp->isBeforeInBlock(insertionPoint))
+          continue;
+        sliceOp->moveBefore(insertionPoint);
+      }
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::TorchConversion::createOptimizeRuntimeAssertsPass(bool elide) {
+  return std::make_unique<OptimizeRuntimeAssertsPass>(elide);
+}
@@ -60,7 +60,9 @@ void TorchConversion::createTorchBackendToLinalgOnTensorsBackendPipeline(
   // (e.g. dimensions which must be constant in a ranked programming model)
   // and those constants get somewhat obscured by TorchToStd.
   pm.addNestedPass<func::FuncOp>(createConvertTorchToTMTensorPass());
-  pm.addNestedPass<func::FuncOp>(createConvertTorchToLinalgPass());
+  pm.addNestedPass<func::FuncOp>(
+      createConvertTorchToLinalgPass(options.convIm2col,
+                                     options.reductionSplitFactor));
   pm.addNestedPass<func::FuncOp>(createConvertTorchToSCFPass());
   pm.addNestedPass<func::FuncOp>(createConvertTorchToStdPass());
   pm.addNestedPass<func::FuncOp>(memref::createExpandOpsPass());
@@ -68,12 +70,30 @@ void TorchConversion::createTorchBackendToLinalgOnTensorsBackendPipeline(
   if (options.optimize) {
     // Clean up any non-canonical code introduced above..
     pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+    // Compute the ops on 0-d tensors with scalar arithmetic.
+    pm.addNestedPass<func::FuncOp>(
+        TorchConversion::createScalarizeZeroRankTensorsPass());
     // Resolve `dim` ops on tensors (which currently live in the `memref`
     // dialect for some reason -- we don't have memrefs at this level).
     pm.addNestedPass<func::FuncOp>(
         memref::createResolveShapedTypeResultDimsPass());
     // The resolution of `dim` ops tends to create identical ops. CSE them.
     pm.addNestedPass<func::FuncOp>(createCSEPass());
+    // Read the computed index tensors as i32s.
+    pm.addNestedPass<func::FuncOp>(
+        TorchConversion::createNarrowIndexTensorsPass());
+    // Compute the inputs of concatenations in the concatenated tensor.
+    pm.addNestedPass<func::FuncOp>(
+        TorchConversion::createInsertSliceDestinationPassingPass());
+  }
+
+  // Runs after the CSE above, so that asserts checking the same condition
+  // are deduplicated.
+  if (options.runtimeAsserts != Torch::RuntimeAssertsMode::Keep) {
+    pm.addNestedPass<func::FuncOp>(
+        TorchConversion::createOptimizeRuntimeAssertsPass(
+            /*elide=*/options.runtimeAsserts ==
+            Torch::RuntimeAssertsMode::Elide));
   }
 
   // Finish the type conversion from `torch` types to the types of the
@@ -83,6 +103,12 @@ void TorchConversion::createTorchBackendToLinalgOnTensorsBackendPipeline(
   pm.addNestedPass<func::FuncOp>(
       TorchConversion::createFinalizingBackendTypeConversionPass());
 
+  if (options.optimize) {
+    // Tell the bufferizers which tensors can share a buffer.
+    pm.addNestedPass<func::FuncOp>(
+        TorchConversion::createAnnotateBufferReusePass());
+  }
+
   // Verify that we have lowered to the form that linalg on tensors backends
   // expect. This fails compilation (signalPassFailure) if the IR is not in the
   // correct form.
@@ -100,6 +126,10 @@ void TorchConversion::createTorchBackendToTosaBackendPipeline(
   pm.addNestedPass<func::FuncOp>(createTosaMakeBroadcastablePass());
 
   if (options.optimize) {
+    // Compute convolution subgraphs in NHWC, leaving the layout transposes
+    // only at their boundaries.
+    pm.addNestedPass<func::FuncOp>(
+        TorchConversion::createTosaPropagateChannelsLastPass());
     // Clean up any non-canonical code introduced above..
     pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
     // The resolution of `dim` ops tends to create identical ops. CSE them.
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+static bool isZeroRankTensor(Value value) {
+  auto type = value.getType().dyn_cast<RankedTensorType>();
+  return type && type.getRank() == 0;
+}
+
+// Returns the scalar a 0-d tensor is built from with `tensor.from_elements`,
+// or null.
+static Value getScalarElement(Value tensor) {
+  if (auto cast = tensor.getDefiningOp<tensor::CastOp>())
+    tensor = cast.source();
+  if (!isZeroRankTensor(tensor))
+    return Value();
+  auto fromElements = tensor.getDefiningOp<tensor::FromElementsOp>();
+  if (!fromElements)
+    return Value();
+  return fromElements.elements()[0];
+}
+
+namespace {
+// Computes the body of a `linalg.generic` on 0-d tensors on the extracted
+// elements of its operands:
+//   %0 = linalg.generic ins(%a, %b : tensor<f32>, tensor<f32>) outs(%init) {
+//     ^bb0(%x: f32, %y: f32, %out: f32):
+//       %1 = arith.addf %x, %y : f32
+//       linalg.yield %1 : f32
+//   } -> tensor<f32>
+// becomes
+//   %x = tensor.extract %a[] : tensor<f32>
+//   %y = tensor.extract %b[] : tensor<f32>
+//   %1 = arith.addf %x, %y : f32
+//   %0 = tensor.from_elements %1 : tensor<f32>
+// The extracts then fold with the `tensor.from_elements` of the producers, so
+// that chains of ops on 0-d tensors become plain scalar arithmetic.
+class ScalarizeZeroRankGeneric : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics() || op.getNumLoops() != 0 ||
+        !llvm::all_of(op->getOperands(), isZeroRankTensor))
+      return rewriter.notifyMatchFailure(op, "not a generic on 0-d tensors");
+
+    Location loc = op.getLoc();
+    Block *body = op.getBody();
+    BlockAndValueMapping mapping;
+    for (auto it : llvm::zip(body->getArguments(), op->getOperands())) {
+      BlockArgument arg = std::get<0>(it);
+      if (arg.use_empty())
+        continue;
+      mapping.map(arg, rewriter.create<tensor::ExtractOp>(
+                           loc, std::get<1>(it), ValueRange{}));
+    }
+    for (Operation &bodyOp : body->without_terminator())
+      rewriter.clone(bodyOp, mapping);
+
+    SmallVector<Value> results;
+    for (auto it : llvm::zip(body->getTerminator()->getOperands(),
+                             op->getResultTypes())) {
+      results.push_back(rewriter.create<tensor::FromElementsOp>(
+          loc, std::get<1>(it), mapping.lookupOrDefault(std::get<0>(it))));
+    }
+    rewriter.replaceOp(op, results);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Replaces a `linalg.fill` of a 0-d tensor with a `tensor.from_elements` of
+// the fill value.
+class ScalarizeZeroRankFill : public OpRewritePattern<linalg::FillOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::FillOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics() || op->getNumResults() != 1)
+      return rewriter.notifyMatchFailure(op, "expected a fill on tensors");
+    Value result = op->getResult(0);
+    Value value = op.getInputOperand(0)->get();
+    auto resultType = result.getType().cast<RankedTensorType>();
+    if (resultType.getRank() != 0 ||
+        value.getType() != resultType.getElementType())
+      return rewriter.notifyMatchFailure(op, "not a fill of a 0-d tensor");
+    rewriter.replaceOpWithNewOp<tensor::FromElementsOp>(op, resultType, value);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Passes the scalar of a 0-d input built by `tensor.from_elements` to the
+// body of a `linalg.generic` directly, instead of as a broadcast operand, e.g.
+// for the scalar operand of `aten.mul.Tensor(%x, %scale)` where `%scale` is
+// the result of other scalarized ops.
+class ForwardScalarInputToGenericBody
+    : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics() || op.getNumLoops() == 0)
+      return rewriter.notifyMatchFailure(op, "handled by scalarization");
+
+    Value scalar;
+    unsigned scalarIndex = 0;
+    for (OpOperand *input : op.getInputOperands()) {
+      scalar = getScalarElement(input->get());
+      if (scalar) {
+        scalarIndex = input->getOperandNumber();
+        break;
+      }
+    }
+    if (!scalar)
+      return rewriter.notifyMatchFailure(op, "no input built from a scalar");
+
+    SmallVector<Value> inputs;
+    SmallVector<AffineMap> indexingMaps;
+    for (OpOperand *input : op.getInputOperands()) {
+      if (input->getOperandNumber() == scalarIndex)
+        continue;
+      inputs.push_back(input->get());
+      indexingMaps.push_back(op.getTiedIndexingMap(input));
+    }
+    for (OpOperand *output : op.getOutputOperands())
+      indexingMaps.push_back(op.getTiedIndexingMap(output));
+
+    auto newOp = rewriter.create<linalg::GenericOp>(
+        op.getLoc(), op->getResultTypes(), inputs, op.outputs(),
+        rewriter.getAffineMapArrayAttr(indexingMaps), op.iterator_types(),
+        op.docAttr(), op.library_callAttr());
+    rewriter.inlineRegionBefore(op.region(), newOp.region(),
+                                newOp.region().end());
+    Block *body = newOp.getBody();
+    body->getArgument(scalarIndex).replaceAllUsesWith(scalar);
+    body->eraseArgument(scalarIndex);
+    rewriter.replaceOp(op, newOp->getResults());
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class ScalarizeZeroRankTensorsPass
+    : public ScalarizeZeroRankTensorsBase<ScalarizeZeroRankTensorsPass> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<ScalarizeZeroRankGeneric, ScalarizeZeroRankFill,
+                 ForwardScalarInputToGenericBody>(context);
+    // Look through the casts between 0-d tensors, so that the extracts fold
+    // with the `tensor.from_elements` of their producers.
+    tensor::CastOp::getCanonicalizationPatterns(patterns, context);
+    tensor::ExtractOp::getCanonicalizationPatterns(patterns, context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::TorchConversion::createScalarizeZeroRankTensorsPass() {
+  return std::make_unique<ScalarizeZeroRankTensorsPass>();
+}
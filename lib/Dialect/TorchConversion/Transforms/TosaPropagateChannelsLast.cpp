@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tosa/IR/TosaOps.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::TorchConversion;
+
+// Returns the permutation of `op`, or failure if it is not a constant.
+static FailureOr<SmallVector<int64_t>> getPermutation(tosa::TransposeOp op) {
+  DenseIntElementsAttr permsAttr;
+  if (!matchPattern(op.perms(), m_Constant(&permsAttr)))
+    return failure();
+  SmallVector<int64_t> perms;
+  for (APInt perm : permsAttr.getValues<APInt>())
+    perms.push_back(perm.getSExtValue());
+  return perms;
+}
+
+static SmallVector<int64_t> invertPermutation(ArrayRef<int64_t> perms) {
+  SmallVector<int64_t> inverse(perms.size());
+  for (auto it : llvm::enumerate(perms))
+    inverse[it.value()] = it.index();
+  return inverse;
+}
+
+// Returns `type` with its dimensions permuted by `perms`, with the semantics
+// of `tosa.transpose`: dimension `i` of the result is dimension `perms[i]` of
+// `type`.
+static RankedTensorType permuteType(RankedTensorType type,
+                                    ArrayRef<int64_t> perms) {
+  SmallVector<int64_t> shape;
+  for (int64_t perm : perms)
+    shape.push_back(type.getDimSize(perm));
+  return RankedTensorType::get(shape, type.getElementType());
+}
+
+static Value createTranspose(PatternRewriter &rewriter, Location loc,
+                             Value input, ArrayRef<int64_t> perms,
+                             Type resultType) {
+  auto permsType = RankedTensorType::get({static_cast<int64_t>(perms.size())},
+                                         rewriter.getI32Type());
+  SmallVector<int32_t> perms32(perms.begin(), perms.end());
+  Value permsConst = rewriter.create<tosa::ConstOp>(
+      loc, permsType, DenseElementsAttr::get(permsType, makeArrayRef(perms32)));
+  return rewriter.create<tosa::TransposeOp>(loc, resultType, input,
+                                            permsConst);
+}
+
+// Ops that compute each element of their result from the elements at the same
+// position in their operands, and thus commute with transposes. This includes
+// the `tensor.cast`s that TorchToTosa ends the lowerings of convolutions and
+// pooling ops with.
+static bool isElementwise(Operation *op) {
+  return isa<tensor::CastOp, tosa::AbsOp, tosa::AddOp, tosa::CastOp,
+             tosa::CeilOp, tosa::ClampOp, tosa::DivOp, tosa::EqualOp,
+             tosa::ExpOp, tosa::FloorOp, tosa::GreaterEqualOp, tosa::GreaterOp,
+             tosa::LogOp, tosa::LogicalAndOp, tosa::LogicalNotOp,
+             tosa::LogicalOrOp, tosa::MaximumOp, tosa::MinimumOp, tosa::MulOp,
+             tosa::NegateOp, tosa::PowOp, tosa::ReciprocalOp, tosa::ReluNOp,
+             tosa::RsqrtOp, tosa::SelectOp, tosa::SigmoidOp, tosa::SubOp,
+             tosa::TanhOp>(op);
+}
+
+namespace {
+// Composes `transpose(transpose(x, p1), p2)` into a single transpose of `x`,
+// or into `x` itself when the two transposes cancel out. This removes the
+// NHWC -> NCHW -> NHWC round trips between consecutive convolutions and
+// pooling ops once the transposes in between have been sunk.
+class FoldTransposeOfTranspose : public OpRewritePattern<tosa::TransposeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(tosa::TransposeOp op,
+                                PatternRewriter &rewriter) const override {
+    auto producer = op.input1().getDefiningOp<tosa::TransposeOp>();
+    if (!producer)
+      return rewriter.notifyMatchFailure(op, "expected transposed input");
+    FailureOr<SmallVector<int64_t>> perms = getPermutation(op);
+    FailureOr<SmallVector<int64_t>> producerPerms = getPermutation(producer);
+    if (failed(perms) || failed(producerPerms))
+      return rewriter.notifyMatchFailure(op, "expected constant permutations");
+
+    SmallVector<int64_t> composed;
+    for (int64_t perm : *perms)
+      composed.push_back((*producerPerms)[perm]);
+    Value input = producer.input1();
+    bool isIdentity = llvm::all_of(llvm::enumerate(composed), [](auto it) {
+      return it.value() == static_cast<int64_t>(it.index());
+    });
+    if (isIdentity && input.getType() == op.getType()) {
+      rewriter.replaceOp(op, input);
+      return success();
+    }
+    rewriter.replaceOp(op, createTranspose(rewriter, op.getLoc(), input,
+                                           composed, op.getType()));
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Sinks a `tosa.transpose` below the elementwise op using it:
+//   elementwise(transpose(x, p), y) -> transpose(elementwise(x, y'), p)
+// where `y'` is `y` with the inverse permutation applied. This is only done
+// when doing so for all the other operands is free: they are transposes with
+// the same permutation, constants, which are transposed at compile time, or
+// tensors with at most one non-unit dimension (such as a broadcast bias),
+// which are simply reshaped. The transposes bypassed must have no other users:
+// they would otherwise stay alive, and sinking would add a transpose instead of
+// moving one.
+class SinkTransposeBelowElementwise : public RewritePattern {
+public:
+  SinkTransposeBelowElementwise(MLIRContext *context)
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context) {}
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    if (!isElementwise(op) || op->getNumResults() != 1)
+      return rewriter.notifyMatchFailure(op, "expected elementwise op");
+    auto resultType = op->getResult(0).getType().dyn_cast<RankedTensorType>();
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "expected ranked result");
+
+    auto isOnlyUsedByOp = [&](tosa::TransposeOp transpose) {
+      return llvm::all_of(transpose->getUsers(),
+                          [&](Operation *user) { return user == op; });
+    };
+    Optional<SmallVector<int64_t>> perms;
+    for (Value operand : op->getOperands()) {
+      auto transpose = operand.getDefiningOp<tosa::TransposeOp>();
+      if (!transpose || !isOnlyUsedByOp(transpose))
+        continue;
+      FailureOr<SmallVector<int64_t>> transposePerms =
+          getPermutation(transpose);
+      if (succeeded(transposePerms)) {
+        perms = *transposePerms;
+        break;
+      }
+    }
+    if (!perms)
+      return rewriter.notifyMatchFailure(op, "expected transposed operand");
+    SmallVector<int64_t> inversePerms = invertPermutation(*perms);
+
+    Location loc = op->getLoc();
+    SmallVector<Value> newOperands;
+    for (Value operand : op->getOperands()) {
+      auto operandType = operand.getType().dyn_cast<RankedTensorType>();
+      if (!operandType || operandType.getRank() != resultType.getRank())
+        return rewriter.notifyMatchFailure(op,
+                                           "expected operands of same rank");
+
+      if (auto transpose = operand.getDefiningOp<tosa::TransposeOp>()) {
+        FailureOr<SmallVector<int64_t>> transposePerms =
+            getPermutation(transpose);
+        if (succeeded(transposePerms) && *transposePerms == *perms &&
+            isOnlyUsedByOp(transpose)) {
+          newOperands.push_back(transpose.input1());
+          continue;
+        }
+      }
+
+      RankedTensorType newOperandType =
+          permuteType(operandType, inversePerms);
+      DenseElementsAttr attr;
+      if (matchPattern(operand, m_Constant(&attr))) {
+        FailureOr<DenseElementsAttr> transposedAttr =
+            Torch::transposeElementsAttr(attr, inversePerms);
+        if (failed(transposedAttr))
+          return rewriter.notifyMatchFailure(op, "unsupported constant");
+        newOperands.push_back(rewriter.create<tosa::ConstOp>(
+            loc, transposedAttr->getType(), *transposedAttr));
+        continue;
+      }
+
+      // Permuting a tensor with at most one non-unit dimension doesn't move
+      // any data.
+      if (operandType.hasStaticShape() &&
+          llvm::count_if(operandType.getShape(),
+                         [](int64_t size) { return size != 1; }) <= 1) {
+        newOperands.push_back(rewriter.create<tosa::ReshapeOp>(
+            loc, newOperandType, operand,
+            rewriter.getI64ArrayAttr(newOperandType.getShape())));
+        continue;
+      }
+      return rewriter.notifyMatchFailure(
+          op, "expected operands that can be transposed for free");
+    }
+
+    Operation *newOp =
+        rewriter.create(loc, op->getName().getIdentifier(), newOperands,
+                        permuteType(resultType, inversePerms), op->getAttrs());
+    rewriter.replaceOp(op, createTranspose(rewriter, loc, newOp->getResult(0),
+                                           *perms, resultType));
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class TosaPropagateChannelsLastPass
+    : public TosaPropagateChannelsLastBase<TosaPropagateChannelsLastPass> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FoldTransposeOfTranspose, SinkTransposeBelowElementwise>(
+        context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::TorchConversion::createTosaPropagateChannelsLastPass() {
+  return std::make_unique<TosaPropagateChannelsLastPass>();
+}
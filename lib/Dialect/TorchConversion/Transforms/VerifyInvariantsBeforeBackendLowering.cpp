@@ -12,6 +12,7 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
 #include "torch-mlir/Dialect/TorchConversion/Transforms/Passes.h"
 
@@ -56,7 +57,12 @@ class VerifyInvariantsBeforeBackendLoweringPass
         }
       }
       for (Operation &op : *block) {
-        if (isa<Torch::OperatorOp>(op)) {
+        // The calls to custom kernels are lowered by the backends once the
+        // shapes of their results are known.
+        if (isa<Torch::OperatorOp>(op) &&
+            (Torch::getCustomKernel(&op).empty() ||
+             Torch::getCustomKernelResultShapes(&op).size() !=
+                 op.getNumResults())) {
           op.emitError()
               .append("unsupported by backend lowering: `torch.operator` op")
               .attachNote()
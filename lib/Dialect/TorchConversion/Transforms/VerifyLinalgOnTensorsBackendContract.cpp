@@ -16,6 +16,7 @@
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/OpDefinition.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -67,6 +68,10 @@ class VerifyLinalgOnTensorsBackendContractPass
         opHasLegalTypes);
 
     target.addDynamicallyLegalOp<GetNextSeedOp>(opHasLegalTypes);
+    target.addDynamicallyLegalOp<GlobalTensorOp, GlobalTensorLoadOp,
+                                 GlobalTensorStoreOp>(opHasLegalTypes);
+    target.addDynamicallyLegalOp<ExternalLiteralOp>(opHasLegalTypes);
+    target.addDynamicallyLegalOp<CallKernelOp>(opHasLegalTypes);
 
     // Basic scalar operations.
     target.addDynamicallyLegalDialect<func::FuncDialect>(isLegalScalarOp);
@@ -81,6 +86,9 @@ class VerifyLinalgOnTensorsBackendContractPass
     target.addDynamicallyLegalDialect<cf::ControlFlowDialect>(opHasLegalTypes);
     target.addDynamicallyLegalDialect<TMTensorDialect>(opHasLegalTypes);
     target.addDynamicallyLegalDialect<scf::SCFDialect>(opHasLegalTypes);
+    // Sparse tensors are only converted between storage formats, which the
+    // backend lowers with the sparse compiler.
+    target.addDynamicallyLegalOp<sparse_tensor::ConvertOp>(opHasLegalTypes);
 
     // ConstantOp is used for tensors and for scalars.
     target.addDynamicallyLegalOp<arith::ConstantOp>(opHasLegalTypes);
@@ -0,0 +1,129 @@
+//===- LibraryKernels.cpp - Library kernels for RefBackend modules --------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+//
+// The kernels that `refback-lower-linalg-to-library-calls` replaces the
+// statically shaped matmuls and convolutions with. The products are computed
+// by the `cblas_sgemm` of the BLAS library that the runtime is built with,
+// if `TORCH_MLIR_REFBACKEND_CBLAS` is set, and by portable loops otherwise.
+// The convolutions are lowered to products by unfolding their input.
+//
+// The operands are contiguous in row-major order, which the pass checks.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/RefBackend/Runtime.h"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef TORCH_MLIR_REFBACKEND_USE_CBLAS
+#include <cblas.h>
+#endif
+
+using namespace mlir::torch::RefBackend;
+
+// These names must be kept in sync with `refbackend.py` and the RefBackend
+// passes.
+static const LibraryKernel kLibraryKernels[] = {
+    {"refbackend_kernel_matmul_f32",
+     reinterpret_cast<void *>(&matmulKernelF32)},
+    {"refbackend_kernel_batch_matmul_f32",
+     reinterpret_cast<void *>(&batchMatmulKernelF32)},
+    {"refbackend_kernel_conv_2d_nchw_fchw_f32",
+     reinterpret_cast<void *>(&conv2DNchwFchwKernelF32)},
+};
+
+llvm::ArrayRef<LibraryKernel> mlir::torch::RefBackend::getLibraryKernels() {
+  return kLibraryKernels;
+}
+
+template <typename T, int N>
+static T *getData(StridedMemRefType<T, N> *memRef) {
+  return memRef->data + memRef->offset;
+}
+
+// Accumulates the product of the row-major matrices `lhs` (m x k) and `rhs`
+// (k x n) into `out` (m x n).
+static void gemm(int64_t m, int64_t n, int64_t k, const float *lhs,
+                 const float *rhs, float *out) {
+#ifdef TORCH_MLIR_REFBACKEND_USE_CBLAS
+  cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k,
+              /*alpha=*/1.0f, lhs, /*lda=*/k, rhs, /*ldb=*/n, /*beta=*/1.0f,
+              out, /*ldc=*/n);
+#else
+  // Blocked along k so that the rows of `rhs` read by a block stay in the
+  // cache across the rows of `out`. The innermost loop runs along the rows
+  // of `rhs` and `out`, which the C++ compiler vectorizes.
+  constexpr int64_t kBlock = 64;
+  for (int64_t k0 = 0; k0 < k; k0 += kBlock) {
+    int64_t k1 = std::min(k0 + kBlock, k);
+    for (int64_t i = 0; i < m; i++) {
+      float *outRow = out + i * n;
+      for (int64_t p = k0; p < k1; p++) {
+        float a = lhs[i * k + p];
+        const float *rhsRow = rhs + p * n;
+        for (int64_t j = 0; j < n; j++)
+          outRow[j] += a * rhsRow[j];
+      }
+    }
+  }
+#endif
+}
+
+void mlir::torch::RefBackend::matmulKernelF32(
+    StridedMemRefType<float, 2> *lhs, StridedMemRefType<float, 2> *rhs,
+    StridedMemRefType<float, 2> *out) {
+  gemm(out->sizes[0], out->sizes[1], lhs->sizes[1], getData(lhs), getData(rhs),
+       getData(out));
+}
+
+void mlir::torch::RefBackend::batchMatmulKernelF32(
+    StridedMemRefType<float, 3> *lhs, StridedMemRefType<float, 3> *rhs,
+    StridedMemRefType<float, 3> *out) {
+  for (int64_t b = 0; b < out->sizes[0]; b++)
+    gemm(out->sizes[1], out->sizes[2], lhs->sizes[2],
+         getData(lhs) + b * lhs->strides[0],
+         getData(rhs) + b * rhs->strides[0],
+         getData(out) + b * out->strides[0]);
+}
+
+void mlir::torch::RefBackend::conv2DNchwFchwKernelF32(
+    StridedMemRefType<float, 4> *input, StridedMemRefType<float, 4> *filter,
+    StridedMemRefType<float, 4> *out, int64_t strideH, int64_t strideW,
+    int64_t dilationH, int64_t dilationW) {
+  int64_t channels = input->sizes[1], height = input->sizes[2],
+          width = input->sizes[3];
+  int64_t filters = filter->sizes[0], kernelH = filter->sizes[2],
+          kernelW = filter->sizes[3];
+  int64_t outH = out->sizes[2], outW = out->sizes[3];
+
+  // Each image is unfolded into a (C * KH * KW) x (OH * OW) matrix of the
+  // input elements that each filter element multiplies, so that the
+  // convolution is the product of the (F x C * KH * KW) filter by it.
+  std::vector<float> columns(channels * kernelH * kernelW * outH * outW);
+  for (int64_t n = 0; n < out->sizes[0]; n++) {
+    const float *image = getData(input) + n * input->strides[0];
+    float *column = columns.data();
+    for (int64_t c = 0; c < channels; c++) {
+      for (int64_t kh = 0; kh < kernelH; kh++) {
+        for (int64_t kw = 0; kw < kernelW; kw++) {
+          for (int64_t oh = 0; oh < outH; oh++) {
+            const float *row = image + (c * height + oh * strideH +
+                                        kh * dilationH) * width +
+                               kw * dilationW;
+            for (int64_t ow = 0; ow < outW; ow++)
+              *column++ = row[ow * strideW];
+          }
+        }
+      }
+    }
+    gemm(filters, outH * outW, channels * kernelH * kernelW, getData(filter),
+         columns.data(), getData(out) + n * out->strides[0]);
+  }
+}
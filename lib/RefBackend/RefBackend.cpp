@@ -15,15 +15,30 @@
 //===----------------------------------------------------------------------===//
 
 #include "PassDetail.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/Math/Transforms/Approximation.h"
 #include "mlir/Dialect/Math/Transforms/Passes.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Dialect/Vector/Transforms/VectorRewritePatterns.h"
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "mlir/Transforms/RegionUtils.h"
+#include "torch-mlir-dialects/Dialect/TMTensor/IR/TMTensorInterfaces.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
 #include "torch-mlir/Dialect/TorchConversion/Transforms/BackendTypeConversion.h"
 #include "torch-mlir/RefBackend/Passes.h"
@@ -52,7 +67,11 @@ void mlir::torch::RefBackend::registerRefBackendPasses() { ::registerPasses(); }
 static bool isArgMemRefTypeValid(Type type) {
   if (auto memRefType = type.dyn_cast<MemRefType>()) {
     Type elemTy = memRefType.getElementType();
-    if (elemTy.isa<Float32Type>()) {
+    if (elemTy.isa<Float16Type>()) {
+      return true;
+    } else if (elemTy.isBF16()) {
+      return true;
+    } else if (elemTy.isa<Float32Type>()) {
       return true;
     } else if (elemTy.isa<Float64Type>()) {
       return true;
@@ -82,6 +101,8 @@ static Type getAbiTypeForMemRef(Type type) {
 static std::string getTypeToken(Type type) {
   if (type.isSignlessInteger())
     return ("i" + Twine(type.getIntOrFloatBitWidth())).str();
+  else if (type.isBF16())
+    return "bf16";
   else if (type.isa<mlir::FloatType>())
     return ("f" + Twine(type.getIntOrFloatBitWidth())).str();
   else if (auto memRefType = type.dyn_cast<UnrankedMemRefType>())
@@ -114,8 +135,110 @@ static void replaceReturnWithCall(OpBuilder b, func::ReturnOp op,
   toErase.push_back(op);
 }
 
+// Returns whether the caller can allocate the buffers for the results of
+// `func`, which requires their shapes to be static. The outputs are
+// contiguous whatever the layouts of the results.
+static bool hasStaticResultShapes(func::FuncOp func) {
+  return llvm::all_of(func.getFunctionType().getResults(), [](Type type) {
+    auto memRefType = type.dyn_cast<MemRefType>();
+    return !memRefType || memRefType.hasStaticShape();
+  });
+}
+
+// Returns the buffer that `value` casts, if any.
+static Value lookThroughCasts(Value value) {
+  while (auto cast = value.getDefiningOp<memref::CastOp>())
+    value = cast.source();
+  return value;
+}
+
+// Returns a copy of `value` in a new contiguous buffer.
+static Value copyToIdentityLayout(OpBuilder &b, Location loc, Value value) {
+  auto type = value.getType().cast<MemRefType>();
+  SmallVector<Value> dynamicSizes;
+  for (auto it : llvm::enumerate(type.getShape()))
+    if (ShapedType::isDynamic(it.value()))
+      dynamicSizes.push_back(b.create<memref::DimOp>(loc, value, it.index()));
+  Value copy = b.create<memref::AllocOp>(
+      loc, MemRefType::get(type.getShape(), type.getElementType()),
+      dynamicSizes);
+  b.create<memref::CopyOp>(loc, value, copy);
+  return copy;
+}
+
+// Rewrites the results of `func` into output arguments, appended to its
+// arguments, that the caller allocates with the types recorded in the
+// `refbackend.result_types` attribute. Scalar results are stored into rank-0
+// outputs. A memref result allocated by the function is computed in its
+// output directly, and the other ones are copied into it.
+static void convertResultsToOutputs(func::FuncOp func,
+                                    SmallVectorImpl<Type> &newArgTypes) {
+  Block &entryBlock = func.getBody().front();
+  OpBuilder b(func.getBody());
+  SmallVector<Value> outputs;
+  SmallVector<Type> outputTypes;
+  for (Type type : func.getFunctionType().getResults()) {
+    MemRefType outputType;
+    if (auto memRefType = type.dyn_cast<MemRefType>())
+      outputType = MemRefType::get(memRefType.getShape(),
+                                   memRefType.getElementType());
+    else
+      outputType = MemRefType::get({}, type);
+    outputTypes.push_back(type.isa<MemRefType>() ? Type(outputType) : type);
+    BlockArgument arg =
+        entryBlock.addArgument(getAbiTypeForMemRef(outputType), func.getLoc());
+    newArgTypes.push_back(arg.getType());
+    outputs.push_back(b.create<memref::CastOp>(func.getLoc(), outputType, arg));
+  }
+  func->setAttr("refbackend.result_types", b.getTypeArrayAttr(outputTypes));
+
+  SmallVector<func::ReturnOp> returnOps;
+  func.walk([&](func::ReturnOp op) { returnOps.push_back(op); });
+  // With several returns, an allocation may reach only some of them, and
+  // another result would then be computed in the same output.
+  bool canWriteInPlace = returnOps.size() == 1;
+  for (func::ReturnOp op : returnOps) {
+    b.setInsertionPoint(op);
+    SmallVector<Value> results(op.getOperands());
+    for (auto it : llvm::enumerate(results)) {
+      Value result = it.value();
+      Value output = outputs[it.index()];
+      if (!result.getType().isa<MemRefType>()) {
+        b.create<memref::StoreOp>(op.getLoc(), result, output);
+        continue;
+      }
+      auto alloc = lookThroughCasts(result).getDefiningOp<memref::AllocOp>();
+      if (canWriteInPlace && alloc && alloc.getType() == output.getType()) {
+        // The same allocation returned again is copied from this output.
+        alloc.replaceAllUsesWith(output);
+        alloc.erase();
+        for (Value &other : results)
+          if (other == result)
+            other = output;
+        continue;
+      }
+      b.create<memref::CopyOp>(op.getLoc(), result, output);
+    }
+    b.create<func::ReturnOp>(op.getLoc());
+    op.erase();
+  }
+}
+
+// Returns `result`, or a copy of it in a new buffer if it isn't a buffer that
+// the function allocates, so that the caller can take ownership of it and free
+// it. The buffers already in `returned` are copied too, so that each result
+// is freed once.
+static Value getOwnedResult(OpBuilder &b, Location loc, Value result,
+                            DenseSet<Value> &returned) {
+  Value buffer = lookThroughCasts(result);
+  if (buffer.getDefiningOp<memref::AllocOp>() &&
+      returned.insert(buffer).second)
+    return result;
+  return copyToIdentityLayout(b, loc, result);
+}
+
 static LogicalResult mungeFunction(
-    func::FuncOp func,
+    func::FuncOp func, bool destinationPassing, bool ownedResults,
     std::map<std::string, std::vector<Type>> &invokedConsumeFuncReturnFuncs) {
   // Only need to call mungeFunction for functions callable from outside of the
   // module.
@@ -139,13 +262,24 @@ static LogicalResult mungeFunction(
     auto type = arg.getType();
     if (!isArgMemRefTypeValid(type))
       return emitError(arg.getLoc(),
-                       "argument must be a memref of f32, f64, i32, i64, i1");
+                       "argument must be a memref of f16, bf16, f32, f64, i32, i64, i1");
+    // The arguments with a layout read the strides and offset of the
+    // descriptors they are passed, so the caller doesn't need to make them
+    // contiguous.
+    if (!type.cast<MemRefType>().getLayout().isIdentity())
+      func->setAttr("refbackend.strided_arguments", b.getUnitAttr());
     auto cast = b.create<memref::CastOp>(arg.getLoc(), type, arg);
     arg.replaceAllUsesExcept(cast, cast);
     arg.setType(getAbiTypeForMemRef(type));
     newArgTypes.push_back(arg.getType());
   }
 
+  if (destinationPassing && hasStaticResultShapes(func)) {
+    convertResultsToOutputs(func, newArgTypes);
+    func.setType(FunctionType::get(func.getContext(), newArgTypes, {}));
+    return success();
+  }
+
   SmallVector<Operation *> toErase;
   func.walk([&](func::ReturnOp op) {
     auto types = op.getOperandTypes();
@@ -153,10 +287,19 @@ static LogicalResult mungeFunction(
     // Memref Types.
     std::vector<Type> retTypes;
     SmallVector<Value> retVals;
+    DenseSet<Value> returned;
     for (auto en : llvm::enumerate(types)) {
       Type retType = en.value();
       Value retVal = op.getOperand(en.index());
       if (auto memrefReturnType = retType.dyn_cast<MemRefType>()) {
+        // The caller reads the results as contiguous, so those with a
+        // layout are copied unless they are known to be allocated by the
+        // function.
+        if (ownedResults)
+          retVal = getOwnedResult(b, op.getLoc(), retVal, returned);
+        else if (!memrefReturnType.getLayout().isIdentity() &&
+                 !lookThroughCasts(retVal).getDefiningOp<memref::AllocOp>())
+          retVal = copyToIdentityLayout(b, op.getLoc(), retVal);
         auto elemType = memrefReturnType.getElementType();
         retType = UnrankedMemRefType::get(elemType, 0);
         // Cast to unranked memref type before sending it as a function
@@ -189,7 +332,8 @@ class MungeCallingConventions
     OpBuilder b(module.getBodyRegion());
     std::map<std::string, std::vector<Type>> invokedConsumeFuncReturnFuncs;
     for (auto func : module.getOps<func::FuncOp>()) {
-      if (failed(mungeFunction(func, invokedConsumeFuncReturnFuncs)))
+      if (failed(mungeFunction(func, destinationPassing, ownedResults,
+                               invokedConsumeFuncReturnFuncs)))
         return signalPassFailure();
     }
 
@@ -231,9 +375,11 @@ static void createGlobalVariableForSeed(OpBuilder &b, ModuleOp module) {
       /*alignment=*/nullptr);
 }
 
-// Generate sequence for getting the next seed with LCG step:
-//    nextSeed = (multiplier * currentSeed + incrementStep) mod 64.
-// Refer to https://en.wikipedia.org/wiki/Linear_congruential_generator.
+// Generate sequence for getting the next seed:
+//    nextSeed = currentSeed + 1.
+// RNG ops hash the index of each element they generate with their seed (see
+// the Philox generator in TorchToLinalg), so consecutive seeds already give
+// independent streams, and they never repeat.
 static Value lowerGetNextSeed(OpBuilder &b, Location loc) {
   // Get the current seed value.
   auto memref1DType = MemRefType::get({}, b.getI64Type());
@@ -241,18 +387,8 @@ static Value lowerGetNextSeed(OpBuilder &b, Location loc) {
       b.create<memref::GetGlobalOp>(loc, memref1DType, getSeedGobalVarName());
   Value currentSeed = b.create<memref::LoadOp>(loc, globalVar);
 
-  // The value of multiplier and incrementStep are referenced from
-  // https://en.wikipedia.org/wiki/Linear_congruential_generator for 2^64.
-  Value multiplier = b.create<arith::ConstantOp>(
-      loc, b.getI64IntegerAttr(6364136223846793005));
-  Value incrementStep = b.create<arith::ConstantOp>(
-      loc, b.getI64IntegerAttr(1442695040888963407));
-  // temp = multiplier * currentSeed + incrementStep
-  Value mul = b.create<arith::MulIOp>(loc, currentSeed, multiplier);
-  Value temp = b.create<arith::AddIOp>(loc, mul, incrementStep);
-  // temp mod 64 = temp & 63
-  Value cst127 = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(127));
-  Value nextSeed = b.create<arith::AndIOp>(loc, temp, cst127);
+  Value one = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(1));
+  Value nextSeed = b.create<arith::AddIOp>(loc, currentSeed, one);
   b.create<memref::StoreOp>(loc, nextSeed, globalVar);
   return nextSeed;
 }
@@ -263,18 +399,22 @@ namespace {
 class InsertRngGlobals : public InsertRngGlobalsBase<InsertRngGlobals> {
   void runOnOperation() override {
     auto module = getOperation();
+    SmallVector<Operation *> toErase;
+    module.walk(
+        [&](TorchConversion::GetNextSeedOp op) { toErase.push_back(op); });
+    // Programs without RNG ops, e.g. those compiled for inference, don't get
+    // a seed.
+    if (toErase.empty())
+      return;
+
     OpBuilder b(module.getBodyRegion());
     createGlobalVariableForSeed(b, module);
-    SmallVector<Operation *> toErase;
-    module.walk([&](TorchConversion::GetNextSeedOp op) {
+    for (auto op : toErase) {
       b.setInsertionPoint(op);
-      Value seed = lowerGetNextSeed(b, op.getLoc());
-      op.replaceAllUsesWith(seed);
-      toErase.push_back(op);
-    });
-
-    for (auto op : toErase)
+      Value seed = lowerGetNextSeed(b, op->getLoc());
+      op->replaceAllUsesWith(ValueRange{seed});
       op->erase();
+    }
   }
 };
 } // namespace
@@ -284,15 +424,463 @@ mlir::torch::RefBackend::createInsertRngGlobalsPass() {
   return std::make_unique<InsertRngGlobals>();
 }
 
+//===----------------------------------------------------------------------===//
+// LowerGlobalTensors
+//===----------------------------------------------------------------------===//
+
+// The prefix of the memref globals holding the global tensors, which make the
+// functions non-reentrant like the arenas and the seed.
+static constexpr StringRef kStatePrefix = "__refbackend_state_";
+
+static MemRefType getGlobalTensorMemRefType(Type type) {
+  auto tensorType = type.cast<RankedTensorType>();
+  return MemRefType::get(tensorType.getShape(), tensorType.getElementType());
+}
+
+static FlatSymbolRefAttr getStateSymbol(FlatSymbolRefAttr global) {
+  return FlatSymbolRefAttr::get(global.getContext(),
+                                (kStatePrefix + global.getValue()).str());
+}
+
+// Returns whether the tensor loaded by `load`, or a tensor computed from it,
+// may be used once a later store has overwritten the global, in which case
+// the load must copy the global rather than alias it.
+static bool isLiveAcrossStore(TorchConversion::GlobalTensorLoadOp load) {
+  Block *block = load->getBlock();
+  Operation *store = nullptr;
+  for (Operation *op = load->getNextNode(); op && !store;
+       op = op->getNextNode()) {
+    op->walk([&](TorchConversion::GlobalTensorStoreOp nested) {
+      if (nested.globalAttr() == load.globalAttr() && !store)
+        store = op;
+    });
+  }
+  if (!store)
+    return false;
+  SmallVector<Value> worklist = {load.getResult()};
+  DenseSet<Value> visited;
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (!visited.insert(value).second)
+      continue;
+    for (Operation *user : value.getUsers()) {
+      if (user == store)
+        continue;
+      Operation *ancestor = block->findAncestorOpInBlock(*user);
+      if (!ancestor || !ancestor->isBeforeInBlock(store))
+        return true;
+      for (Value result : user->getResults())
+        if (result.getType().isa<TensorType>())
+          worklist.push_back(result);
+    }
+  }
+  return false;
+}
+
+// The prefix of the memref globals holding the external literals, and the
+// function that the runtime calls once to load them into the globals, with
+// the tensors read from the files described by its
+// `refbackend.external_literals` attribute. The globals are only written by
+// that function, so they don't make the other functions non-reentrant.
+static constexpr StringRef kExternalLiteralPrefix =
+    "__refbackend_external_literal_";
+static constexpr StringRef kLoadExternalLiteralsFuncName =
+    "refbackend_load_external_literals";
+
+static std::string getExternalLiteralGlobalName(unsigned index) {
+  return (kExternalLiteralPrefix + Twine(index)).str();
+}
+
+// Replaces each external literal by a load of an uninitialized memref global,
+// one per distinct literal, and creates the function storing the data of the
+// literals into the globals.
+static void lowerExternalLiterals(ModuleOp module) {
+  SmallVector<TorchConversion::ExternalLiteralOp> literals;
+  module.walk(
+      [&](TorchConversion::ExternalLiteralOp op) { literals.push_back(op); });
+  if (literals.empty())
+    return;
+
+  OpBuilder b(module.getBodyRegion());
+  OpBuilder globalBuilder(module.getBodyRegion());
+  DenseMap<std::tuple<StringRef, int64_t, Type>, unsigned> globalIndices;
+  SmallVector<Attribute> descriptions;
+  SmallVector<Type> types;
+  for (TorchConversion::ExternalLiteralOp op : literals) {
+    MemRefType type = getGlobalTensorMemRefType(op.getType());
+    auto inserted = globalIndices.insert(
+        {std::make_tuple(op.file(), op.offset(), op.getType()),
+         globalIndices.size()});
+    std::string name = getExternalLiteralGlobalName(inserted.first->second);
+    if (inserted.second) {
+      globalBuilder.create<memref::GlobalOp>(
+          op.getLoc(), name,
+          /*sym_visibility=*/b.getStringAttr("private"),
+          /*type=*/type,
+          /*initial_value=*/b.getUnitAttr(),
+          /*constant=*/false,
+          /*alignment=*/nullptr);
+      descriptions.push_back(b.getDictionaryAttr(
+          {b.getNamedAttr("file", op.fileAttr()),
+           b.getNamedAttr("offset", op.offsetAttr()),
+           b.getNamedAttr("type", TypeAttr::get(type))}));
+      types.push_back(op.getType());
+    }
+    b.setInsertionPoint(op);
+    Value memref = b.create<memref::GetGlobalOp>(op.getLoc(), type, name);
+    op.replaceAllUsesWith(
+        b.create<bufferization::ToTensorOp>(op.getLoc(), memref).getResult());
+    op.erase();
+  }
+
+  Location loc = module.getLoc();
+  b.setInsertionPointToEnd(module.getBody());
+  auto loadFunc = b.create<func::FuncOp>(
+      loc, kLoadExternalLiteralsFuncName,
+      FunctionType::get(module.getContext(), types, {}));
+  loadFunc->setAttr("refbackend.external_literals",
+                    b.getArrayAttr(descriptions));
+  Block *body = loadFunc.addEntryBlock();
+  b.setInsertionPointToStart(body);
+  for (BlockArgument arg : body->getArguments()) {
+    MemRefType type = getGlobalTensorMemRefType(arg.getType());
+    Value source = b.create<bufferization::ToMemrefOp>(loc, type, arg);
+    Value memref = b.create<memref::GetGlobalOp>(
+        loc, type, getExternalLiteralGlobalName(arg.getArgNumber()));
+    b.create<memref::CopyOp>(loc, source, memref);
+  }
+  b.create<func::ReturnOp>(loc);
+}
+
+namespace {
+class LowerGlobalTensors : public LowerGlobalTensorsBase<LowerGlobalTensors> {
+  void runOnOperation() override {
+    auto module = getOperation();
+    lowerExternalLiterals(module);
+    OpBuilder b(module.getBodyRegion());
+    for (auto global : llvm::make_early_inc_range(
+             module.getOps<TorchConversion::GlobalTensorOp>())) {
+      b.setInsertionPoint(global);
+      b.create<memref::GlobalOp>(
+          global.getLoc(), (kStatePrefix + global.sym_name()).str(),
+          /*sym_visibility=*/b.getStringAttr("private"),
+          /*type=*/getGlobalTensorMemRefType(global.type()),
+          /*initial_value=*/global.initial_value(),
+          /*constant=*/false,
+          /*alignment=*/nullptr);
+      global.erase();
+    }
+
+    module.walk([&](TorchConversion::GlobalTensorLoadOp op) {
+      b.setInsertionPoint(op);
+      MemRefType type = getGlobalTensorMemRefType(op.getType());
+      Value memref = b.create<memref::GetGlobalOp>(
+          op.getLoc(), type, getStateSymbol(op.globalAttr()).getValue());
+      if (isLiveAcrossStore(op)) {
+        Value copy = b.create<memref::AllocOp>(op.getLoc(), type);
+        b.create<memref::CopyOp>(op.getLoc(), memref, copy);
+        memref = copy;
+      }
+      op.replaceAllUsesWith(
+          b.create<bufferization::ToTensorOp>(op.getLoc(), memref).getResult());
+      op.erase();
+    });
+    module.walk([&](TorchConversion::GlobalTensorStoreOp op) {
+      b.setInsertionPoint(op);
+      MemRefType type = getGlobalTensorMemRefType(op.value().getType());
+      Value source =
+          b.create<bufferization::ToMemrefOp>(op.getLoc(), type, op.value());
+      Value memref = b.create<memref::GetGlobalOp>(
+          op.getLoc(), type, getStateSymbol(op.globalAttr()).getValue());
+      b.create<memref::CopyOp>(op.getLoc(), source, memref);
+      op.erase();
+    });
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createLowerGlobalTensorsPass() {
+  return std::make_unique<LowerGlobalTensors>();
+}
+
+//===----------------------------------------------------------------------===//
+// UpdateGlobalsInPlace
+//===----------------------------------------------------------------------===//
+
+// Returns the global that `value` is a `memref.get_global` of, if any.
+static FlatSymbolRefAttr getGlobalOf(Value value) {
+  if (auto getGlobal = value.getDefiningOp<memref::GetGlobalOp>())
+    return getGlobal.nameAttr();
+  return nullptr;
+}
+
+// Returns whether the op `op`, in the same block as `begin` and `end` or
+// nested in an op of that block, is strictly between them.
+static bool isBetween(Operation *op, Operation *begin, Operation *end) {
+  op = begin->getBlock()->findAncestorOpInBlock(*op);
+  return op && op != begin && op != end && begin->isBeforeInBlock(op) &&
+         op->isBeforeInBlock(end);
+}
+
+// Tries to compute the update of a global, bufferized as
+//   memref.copy %global, %alloc
+//   <read and write %alloc>
+//   memref.copy %alloc, %global
+// directly in the global, erasing the copies and the alloc.
+static void tryUpdateInPlace(memref::CopyOp copyBack) {
+  FlatSymbolRefAttr global = getGlobalOf(copyBack.target());
+  auto alloc = copyBack.source().getDefiningOp<memref::AllocOp>();
+  if (!global || !alloc || alloc.getType() != copyBack.target().getType())
+    return;
+  Block *block = copyBack->getBlock();
+  memref::CopyOp copyIn;
+  for (Operation *user : alloc->getUsers()) {
+    auto copy = dyn_cast<memref::CopyOp>(user);
+    if (copy && copy.target() == alloc.getResult() &&
+        copy->getBlock() == block && copy->isBeforeInBlock(copyBack) &&
+        getGlobalOf(copy.source()) == global &&
+        (!copyIn || copyIn->isBeforeInBlock(copy)))
+      copyIn = copy;
+  }
+  if (!copyIn)
+    return;
+
+  // The alloc must only be used between the copies, and the global must not
+  // be accessed there, through another `memref.get_global` or a call.
+  for (Operation *user : alloc->getUsers())
+    if (user != copyIn && user != copyBack &&
+        !isBetween(user, copyIn, copyBack))
+      return;
+  for (Operation *op = copyIn->getNextNode(); op != copyBack;
+       op = op->getNextNode()) {
+    bool accessesGlobal = false;
+    op->walk([&](Operation *nested) {
+      if (isa<CallOpInterface>(nested))
+        accessesGlobal = true;
+      for (Value operand : nested->getOperands())
+        if (getGlobalOf(operand) == global)
+          accessesGlobal = true;
+    });
+    if (accessesGlobal)
+      return;
+  }
+
+  alloc.replaceAllUsesWith(copyIn.source());
+  copyIn.erase();
+  copyBack.erase();
+  alloc.erase();
+}
+
+namespace {
+class UpdateGlobalsInPlace
+    : public UpdateGlobalsInPlaceBase<UpdateGlobalsInPlace> {
+  void runOnOperation() override {
+    SmallVector<memref::CopyOp> copies;
+    getOperation().walk([&](memref::CopyOp copy) {
+      if (getGlobalOf(copy.target()))
+        copies.push_back(copy);
+    });
+    for (memref::CopyOp copy : copies)
+      tryUpdateInPlace(copy);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createUpdateGlobalsInPlacePass() {
+  return std::make_unique<UpdateGlobalsInPlace>();
+}
+
 //===----------------------------------------------------------------------===//
 // ExpandOpsForLLVM
 //===----------------------------------------------------------------------===//
 
+// Returns `type`, a scalar or a vector, with the element type `elementType`.
+static Type getTypeWithElementType(Type type, Type elementType) {
+  if (auto vectorType = type.dyn_cast<VectorType>())
+    return VectorType::get(vectorType.getShape(), elementType);
+  return elementType;
+}
+
+// Returns a constant integer `value` of `type`, a scalar or a vector.
+static Value createIntegerConstant(OpBuilder &b, Location loc, Type type,
+                                   int64_t value) {
+  Attribute attr = b.getIntegerAttr(getElementTypeOrSelf(type), value);
+  if (auto vectorType = type.dyn_cast<VectorType>())
+    attr = DenseElementsAttr::get(vectorType, attr);
+  return b.create<arith::ConstantOp>(loc, attr);
+}
+
+static bool hasBF16ElementType(Type type) {
+  return getElementTypeOrSelf(type).isBF16();
+}
+
+static bool hasHalfPrecisionElementType(Type type) {
+  Type elementType = getElementTypeOrSelf(type);
+  return elementType.isF16() || elementType.isBF16();
+}
+
+namespace {
+// Computes in f32 the math ops on f16 or bf16 values, whose polynomial
+// approximations and LLVM intrinsics are only available in f32, and the
+// arithmetic on bf16 values, which LLVM has no instructions for:
+//   op(a : bf16) -> truncf(op(extf(a) : f32))
+class PromoteHalfPrecisionOpToF32 : public RewritePattern {
+public:
+  PromoteHalfPrecisionOpToF32(MLIRContext *context)
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context) {}
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    bool isMathOp = isa<math::MathDialect>(op->getDialect());
+    bool isArithOp =
+        isa<arith::AddFOp, arith::SubFOp, arith::MulFOp, arith::DivFOp,
+            arith::RemFOp, arith::NegFOp, arith::MaxFOp, arith::MinFOp,
+            arith::CmpFOp, arith::SIToFPOp, arith::UIToFPOp, arith::FPToSIOp,
+            arith::FPToUIOp>(op);
+    if (!isMathOp && !isArithOp)
+      return rewriter.notifyMatchFailure(op, "expected math or arith op");
+    auto needsPromotion = [&](Type type) {
+      return isMathOp ? hasHalfPrecisionElementType(type)
+                      : hasBF16ElementType(type);
+    };
+    if (llvm::none_of(op->getOperandTypes(), needsPromotion) &&
+        llvm::none_of(op->getResultTypes(), needsPromotion))
+      return rewriter.notifyMatchFailure(op, "expected half precision values");
+
+    Location loc = op->getLoc();
+    Type f32Type = rewriter.getF32Type();
+    SmallVector<Value> newOperands;
+    for (Value operand : op->getOperands()) {
+      if (needsPromotion(operand.getType()))
+        operand = rewriter.create<arith::ExtFOp>(
+            loc, getTypeWithElementType(operand.getType(), f32Type), operand);
+      newOperands.push_back(operand);
+    }
+    SmallVector<Type> newResultTypes;
+    for (Type type : op->getResultTypes())
+      newResultTypes.push_back(needsPromotion(type)
+                                   ? getTypeWithElementType(type, f32Type)
+                                   : type);
+    Operation *newOp =
+        rewriter.create(loc, op->getName().getIdentifier(), newOperands,
+                        newResultTypes, op->getAttrs());
+    SmallVector<Value> results;
+    for (auto it : llvm::zip(op->getResults(), newOp->getResults())) {
+      Value result = std::get<1>(it);
+      if (result.getType() != std::get<0>(it).getType())
+        result = rewriter.create<arith::TruncFOp>(
+            loc, std::get<0>(it).getType(), result);
+      results.push_back(result);
+    }
+    rewriter.replaceOp(op, results);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Extends bf16 values to f32 by shifting their bits into the high half of an
+// i32, since LLVM can't lower `fpext` from bf16.
+class ExpandBF16ExtF : public OpRewritePattern<arith::ExtFOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(arith::ExtFOp op,
+                                PatternRewriter &rewriter) const override {
+    Value in = op.getOperand();
+    if (!hasBF16ElementType(in.getType()))
+      return rewriter.notifyMatchFailure(op, "expected extension of bf16");
+    Location loc = op.getLoc();
+    Type type = in.getType();
+    Type i16Type = getTypeWithElementType(type, rewriter.getI16Type());
+    Type i32Type = getTypeWithElementType(type, rewriter.getI32Type());
+    Type f32Type = getTypeWithElementType(type, rewriter.getF32Type());
+    Value bits = rewriter.create<arith::BitcastOp>(loc, i16Type, in);
+    bits = rewriter.create<arith::ExtUIOp>(loc, i32Type, bits);
+    bits = rewriter.create<arith::ShLIOp>(
+        loc, bits, createIntegerConstant(rewriter, loc, i32Type, 16));
+    Value result = rewriter.create<arith::BitcastOp>(loc, f32Type, bits);
+    if (result.getType() != op.getType())
+      result = rewriter.create<arith::ExtFOp>(loc, op.getType(), result);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Rounds f32 values to the nearest bf16, ties to even, by integer arithmetic
+// on their bits, since LLVM can't lower `fptrunc` to bf16:
+//   (bits(x) + 0x7fff + ((bits(x) >> 16) & 1)) >> 16
+// NaNs are mapped to the canonical bf16 NaN, which the rounding could turn
+// into infinities.
+class ExpandBF16TruncF : public OpRewritePattern<arith::TruncFOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(arith::TruncFOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!hasBF16ElementType(op.getType()))
+      return rewriter.notifyMatchFailure(op, "expected truncation to bf16");
+    Location loc = op.getLoc();
+    Type type = op.getType();
+    Type i16Type = getTypeWithElementType(type, rewriter.getI16Type());
+    Type i32Type = getTypeWithElementType(type, rewriter.getI32Type());
+    Type f32Type = getTypeWithElementType(type, rewriter.getF32Type());
+    auto constant = [&](Type type, int64_t value) {
+      return createIntegerConstant(rewriter, loc, type, value);
+    };
+
+    Value in = op.getOperand();
+    // Values wider than f32 are rounded to f32 first.
+    if (getElementTypeOrSelf(in.getType()) != rewriter.getF32Type())
+      in = rewriter.create<arith::TruncFOp>(loc, f32Type, in);
+    Value bits = rewriter.create<arith::BitcastOp>(loc, i32Type, in);
+    Value sixteen = constant(i32Type, 16);
+    Value lsb = rewriter.create<arith::AndIOp>(
+        loc, rewriter.create<arith::ShRUIOp>(loc, bits, sixteen),
+        constant(i32Type, 1));
+    Value bias = rewriter.create<arith::AddIOp>(loc, constant(i32Type, 0x7fff),
+                                                lsb);
+    Value rounded = rewriter.create<arith::AddIOp>(loc, bits, bias);
+    Value truncated = rewriter.create<arith::TruncIOp>(
+        loc, i16Type, rewriter.create<arith::ShRUIOp>(loc, rounded, sixteen));
+    Value isNan = rewriter.create<arith::CmpFOp>(loc, arith::CmpFPredicate::UNO,
+                                                 in, in);
+    Value result = rewriter.create<arith::SelectOp>(
+        loc, isNan, constant(i16Type, 0x7fc0), truncated);
+    rewriter.replaceOpWithNewOp<arith::BitcastOp>(op, type, result);
+    return success();
+  }
+};
+} // namespace
+
 namespace {
 class ExpandOpsForLLVM : public ExpandOpsForLLVMBase<ExpandOpsForLLVM> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    // The polynomial approximations of the vector ops use vector ops too.
+    registry.insert<vector::VectorDialect>();
+  }
+
   void runOnOperation() override {
     auto func = getOperation();
     auto *context = &getContext();
+    // Compute in f32 the half precision ops that LLVM can't lower, and expand
+    // the conversions between bf16 and f32 that this introduces.
+    RewritePatternSet promotionPatterns(context);
+    promotionPatterns.add<PromoteHalfPrecisionOpToF32, ExpandBF16ExtF,
+                          ExpandBF16TruncF>(context);
+    if (failed(applyPatternsAndFoldGreedily(func,
+                                            std::move(promotionPatterns))))
+      return signalPassFailure();
+
+    if (fastMath) {
+      RewritePatternSet approximationPatterns(context);
+      populateMathPolynomialApproximationPatterns(approximationPatterns);
+      if (failed(applyPatternsAndFoldGreedily(
+              func, std::move(approximationPatterns))))
+        return signalPassFailure();
+    }
+
     RewritePatternSet patterns(context);
     populateExpandTanhPattern(patterns);
     patterns.add<math::ErfPolynomialApproximation>(patterns.getContext());
@@ -340,12 +928,26 @@ Operation *createLinalgCopyOp(OpBuilder &b, Location loc, Value from,
       });
 }
 
+// Returns whether `type` is a ranked memref whose elements are contiguous in
+// row-major order.
+static bool isContiguousMemRefType(Type type) {
+  auto memRefType = type.dyn_cast<MemRefType>();
+  return memRefType && memRefType.getLayout().isIdentity();
+}
+
 namespace {
+// Rewrites the copies between strided memrefs into loops. The copies between
+// contiguous memrefs are kept, since `convert-memref-to-llvm` lowers them to
+// a single `memcpy`; only the strided ones need the `memrefCopy` function of
+// the runtime, which the RefBackend doesn't load.
 class MemrefCopyOpToLinalg : public OpRewritePattern<memref::CopyOp> {
   using OpRewritePattern<memref::CopyOp>::OpRewritePattern;
 
   LogicalResult matchAndRewrite(memref::CopyOp copyOp,
                                 PatternRewriter &rewriter) const override {
+    if (isContiguousMemRefType(copyOp.source().getType()) &&
+        isContiguousMemRefType(copyOp.target().getType()))
+      return rewriter.notifyMatchFailure(copyOp, "lowered to memcpy");
     Operation *linalgCopy = createLinalgCopyOp(
         rewriter, copyOp.getLoc(), copyOp.source(), copyOp.target());
     rewriter.replaceOp(copyOp, linalgCopy->getResults());
@@ -394,3 +996,1229 @@ std::unique_ptr<OperationPass<func::FuncOp>>
 mlir::torch::RefBackend::createGeneralizeTensorPadPass() {
   return std::make_unique<GeneralizeTensorPad>();
 }
+
+//===----------------------------------------------------------------------===//
+// FuseMultiUseElementwiseOps
+//===----------------------------------------------------------------------===//
+
+// Returns whether `op` is a `linalg.generic` on tensors with only parallel
+// loops, writing each of its outputs elementwise.
+static bool isElementwiseGeneric(linalg::GenericOp op) {
+  return op.hasTensorSemantics() &&
+         op.getNumParallelLoops() == op.getNumLoops() &&
+         llvm::all_of(op.getOutputOperands(), [&](OpOperand *output) {
+           return op.getTiedIndexingMap(output).isIdentity();
+         });
+}
+
+// Returns whether the results of `producer` can be computed in the loop nest
+// of `consumer`: both are elementwise over the same iteration space, the
+// consumer reads the results of the producer elementwise, and their other
+// uses come after the consumer, where the fused op is created.
+static bool isFusableMultiUseProducer(linalg::GenericOp producer,
+                                      linalg::GenericOp consumer) {
+  if (!isElementwiseGeneric(producer) ||
+      producer->getBlock() != consumer->getBlock() ||
+      producer.getNumLoops() != consumer.getNumLoops())
+    return false;
+  bool hasOtherUses = false;
+  for (OpOperand &use : producer->getUses()) {
+    if (use.getOwner() == consumer) {
+      if (!consumer.getTiedIndexingMap(&use).isIdentity() ||
+          use.getOperandNumber() >= consumer.getNumInputs())
+        return false;
+      continue;
+    }
+    Operation *user =
+        consumer->getBlock()->findAncestorOpInBlock(*use.getOwner());
+    if (!user || !consumer->isBeforeInBlock(user))
+      return false;
+    hasOtherUses = true;
+  }
+  // The producers whose only user is the consumer are left to
+  // `linalg-fuse-elementwise-ops`.
+  return hasOtherUses;
+}
+
+namespace {
+// Fuses an elementwise producer into its elementwise consumer, keeping the
+// results of the producer as additional results of the fused op:
+//   %m = linalg.generic ins(%buf, %grad) outs(%buf)     // buf * 0.9 + grad
+//   %p = linalg.generic ins(%param, %m) outs(%param)    // param - lr * m
+//   <store %m and %p>
+// becomes
+//   %p, %m = linalg.generic ins(%param, %buf, %grad) outs(%param, %buf)
+//   <store %m and %p>
+class FuseMultiUseElementwiseProducer
+    : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp consumer,
+                                PatternRewriter &rewriter) const override {
+    if (!isElementwiseGeneric(consumer))
+      return rewriter.notifyMatchFailure(consumer, "not elementwise");
+    linalg::GenericOp producer;
+    for (OpOperand *input : consumer.getInputOperands()) {
+      auto candidate = input->get().getDefiningOp<linalg::GenericOp>();
+      if (candidate && isFusableMultiUseProducer(candidate, consumer)) {
+        producer = candidate;
+        break;
+      }
+    }
+    if (!producer)
+      return rewriter.notifyMatchFailure(consumer, "no fusable producer");
+
+    // The operands of the fused op: the inputs of the consumer that the
+    // producer doesn't compute, then the inputs of the producer, then the
+    // outputs of both.
+    SmallVector<OpOperand *> consumerInputs;
+    for (OpOperand *input : consumer.getInputOperands()) {
+      if (input->get().getDefiningOp() != producer.getOperation())
+        consumerInputs.push_back(input);
+    }
+    SmallVector<Value> inputs, outputs;
+    SmallVector<AffineMap> indexingMaps;
+    SmallVector<Type> resultTypes;
+    auto addOperands = [&](linalg::GenericOp op, ArrayRef<OpOperand *> operands,
+                           SmallVectorImpl<Value> &values) {
+      for (OpOperand *operand : operands) {
+        values.push_back(operand->get());
+        indexingMaps.push_back(op.getTiedIndexingMap(operand));
+      }
+    };
+    addOperands(consumer, consumerInputs, inputs);
+    addOperands(producer, producer.getInputOperands(), inputs);
+    addOperands(consumer, consumer.getOutputOperands(), outputs);
+    addOperands(producer, producer.getOutputOperands(), outputs);
+    llvm::append_range(resultTypes, consumer->getResultTypes());
+    llvm::append_range(resultTypes, producer->getResultTypes());
+
+    auto fused = rewriter.create<linalg::GenericOp>(
+        consumer.getLoc(), resultTypes, inputs, outputs,
+        rewriter.getAffineMapArrayAttr(indexingMaps),
+        consumer.iterator_types(), /*doc=*/StringAttr(),
+        /*library_call=*/StringAttr());
+    Block *block = rewriter.createBlock(&fused.region());
+    for (Value value : llvm::concat<Value>(inputs, outputs)) {
+      block->addArgument(value.getType().cast<ShapedType>().getElementType(),
+                         consumer.getLoc());
+    }
+    auto newArgs = block->getArguments();
+    BlockAndValueMapping mapping;
+    unsigned numConsumerInputs = consumerInputs.size();
+    unsigned numProducerInputs = producer.getNumInputs();
+    unsigned numInputs = numConsumerInputs + numProducerInputs;
+    unsigned numConsumerOutputs = consumer.getNumOutputs();
+
+    // The body of the producer, then that of the consumer, reading the values
+    // yielded by the producer.
+    Block *producerBody = producer.getBody();
+    for (unsigned i = 0; i < numProducerInputs; i++)
+      mapping.map(producerBody->getArgument(i),
+                  newArgs[numConsumerInputs + i]);
+    for (unsigned i = 0, e = producer.getNumOutputs(); i < e; i++)
+      mapping.map(producerBody->getArgument(numProducerInputs + i),
+                  newArgs[numInputs + numConsumerOutputs + i]);
+    for (Operation &op : producerBody->without_terminator())
+      rewriter.clone(op, mapping);
+    SmallVector<Value> producerYields = llvm::to_vector(
+        llvm::map_range(producerBody->getTerminator()->getOperands(),
+                        [&](Value v) { return mapping.lookupOrDefault(v); }));
+
+    Block *consumerBody = consumer.getBody();
+    unsigned nextConsumerInput = 0;
+    for (OpOperand *input : consumer.getInputOperands()) {
+      BlockArgument arg = consumer.getTiedBlockArgument(input);
+      if (input->get().getDefiningOp() == producer.getOperation()) {
+        unsigned resultNumber = input->get().cast<OpResult>().getResultNumber();
+        mapping.map(arg, producerYields[resultNumber]);
+      } else {
+        mapping.map(arg, newArgs[nextConsumerInput++]);
+      }
+    }
+    for (OpOperand *output : consumer.getOutputOperands())
+      mapping.map(consumer.getTiedBlockArgument(output),
+                  newArgs[numInputs + output->getOperandNumber() -
+                          consumer.getNumInputs()]);
+    for (Operation &op : consumerBody->without_terminator())
+      rewriter.clone(op, mapping);
+    SmallVector<Value> yields = llvm::to_vector(
+        llvm::map_range(consumerBody->getTerminator()->getOperands(),
+                        [&](Value v) { return mapping.lookupOrDefault(v); }));
+    llvm::append_range(yields, producerYields);
+    rewriter.create<linalg::YieldOp>(consumer.getLoc(), yields);
+
+    ValueRange fusedResults = fused->getResults();
+    rewriter.replaceOp(consumer, fusedResults.take_front(numConsumerOutputs));
+    rewriter.replaceOp(producer, fusedResults.drop_front(numConsumerOutputs));
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class FuseMultiUseElementwiseOps
+    : public FuseMultiUseElementwiseOpsBase<FuseMultiUseElementwiseOps> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FuseMultiUseElementwiseProducer>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createFuseMultiUseElementwiseOpsPass() {
+  return std::make_unique<FuseMultiUseElementwiseOps>();
+}
+
+//===----------------------------------------------------------------------===//
+// InterchangeReductionLoops
+//===----------------------------------------------------------------------===//
+
+// Returns the order of the loops of `op` in which its input with the most
+// dimensions is read in row-major order, with the loops it doesn't index
+// outermost, or an empty vector if no input indexes all the loops.
+static SmallVector<unsigned> getRowMajorLoopOrder(linalg::GenericOp op) {
+  OpOperand *reference = nullptr;
+  for (OpOperand *input : op.getInputOperands()) {
+    AffineMap map = op.getTiedIndexingMap(input);
+    if (!map.isPermutation())
+      continue;
+    if (!reference ||
+        map.getNumResults() > op.getTiedIndexingMap(reference).getNumResults())
+      reference = input;
+  }
+  if (!reference)
+    return {};
+  SmallVector<unsigned> order;
+  for (AffineExpr expr : op.getTiedIndexingMap(reference).getResults())
+    order.push_back(expr.cast<AffineDimExpr>().getPosition());
+  return order;
+}
+
+namespace {
+// Interchanges the loops of a reduction so that its input is read in
+// row-major order. For example, the sum over the rows of a transposed tensor,
+// with the transpose fused into its input:
+//   linalg.generic {indexing_maps = [(d0, d1) -> (d1, d0), (d0, d1) -> (d0)],
+//                   iterator_types = ["parallel", "reduction"]}
+// reads a column of the input in its inner loop, which is a cache miss per
+// element for large tensors. It becomes
+//   linalg.generic {indexing_maps = [(d0, d1) -> (d0, d1), (d0, d1) -> (d1)],
+//                   iterator_types = ["reduction", "parallel"]}
+// whose inner loop reads a row of the input and updates a row of partial
+// sums, which LLVM vectorizes.
+class InterchangeReductionLoopsPattern
+    : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics() || op.getNumReductionLoops() == 0)
+      return rewriter.notifyMatchFailure(op, "expected reduction on tensors");
+    SmallVector<unsigned> order = getRowMajorLoopOrder(op);
+    if (order.empty())
+      return rewriter.notifyMatchFailure(
+          op, "expected an input indexed by all the loops");
+    if (llvm::equal(order, llvm::seq<unsigned>(0, order.size())))
+      return rewriter.notifyMatchFailure(op, "already in row-major order");
+    if (failed(linalg::interchangeGenericOp(rewriter, op, order)))
+      return failure();
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+class InterchangeReductionLoops
+    : public InterchangeReductionLoopsBase<InterchangeReductionLoops> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<InterchangeReductionLoopsPattern>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createInterchangeReductionLoopsPass() {
+  return std::make_unique<InterchangeReductionLoops>();
+}
+
+//===----------------------------------------------------------------------===//
+// Library kernels
+//===----------------------------------------------------------------------===//
+
+// The kernels of the library compiled into the runtime, which must be kept in
+// sync with `refbackend.py` and `LibraryKernels.cpp`.
+static constexpr StringRef kLibraryKernelPrefix = "refbackend_kernel_";
+static constexpr StringRef kMatmulKernel = "refbackend_kernel_matmul_f32";
+static constexpr StringRef kBatchMatmulKernel =
+    "refbackend_kernel_batch_matmul_f32";
+static constexpr StringRef kConv2DNchwFchwKernel =
+    "refbackend_kernel_conv_2d_nchw_fchw_f32";
+
+// The custom kernels registered by the user, which must be kept in sync with
+// `refbackend.py`.
+static constexpr StringRef kCustomKernelPrefix = "refbackend_custom_kernel_";
+
+// Returns the library kernel that computes `op`, or an empty string if there
+// is none. The kernels take statically shaped f32 operands. Whether they are
+// contiguous is only known once bufferized, so the strided ones are copied to
+// contiguous buffers around the call rather than leaving the op, which isn't
+// tiled either, to the naive loops.
+static StringRef getLibraryKernel(linalg::LinalgOp op) {
+  StringRef kernel;
+  if (isa<linalg::MatmulOp>(op))
+    kernel = kMatmulKernel;
+  else if (isa<linalg::BatchMatmulOp>(op))
+    kernel = kBatchMatmulKernel;
+  else if (isa<linalg::Conv2DNchwFchwOp>(op))
+    kernel = kConv2DNchwFchwKernel;
+  else
+    return {};
+  for (Type type : op->getOperandTypes()) {
+    auto shapedType = type.dyn_cast<ShapedType>();
+    if (!shapedType || !shapedType.hasStaticShape() ||
+        !shapedType.getElementType().isF32() ||
+        sparse_tensor::getSparseTensorEncoding(type))
+      return {};
+  }
+  return kernel;
+}
+
+//===----------------------------------------------------------------------===//
+// TileAndPadLinalgOps
+//===----------------------------------------------------------------------===//
+
+// Returns the sizes of the tiles that `op` is cut into, one per loop of its
+// iteration domain, or an empty list for the ops that are left as is. A size
+// of 0 leaves the corresponding loop untiled.
+//
+// The tiles of the contractions are small enough for their operands to stay
+// in the L1 cache and to be vectorized by `refback-vectorize-linalg-ops`. The
+// convolutions, which the vectorizer does not handle, are only blocked along
+// the output and input channels and the output rows for locality, which also
+// bounds the slice of their padded input that each tile reads.
+static SmallVector<int64_t> getTileSizes(linalg::LinalgOp op) {
+  // The sparse compiler generates the loops of the ops on sparse tensors,
+  // which only visit their stored elements.
+  if (llvm::any_of(op->getOperandTypes(), [](Type type) {
+        return sparse_tensor::getSparseTensorEncoding(type) != nullptr;
+      }))
+    return {};
+  // Loops: m, n, k.
+  if (isa<linalg::MatmulOp>(op))
+    return {8, 16, 8};
+  // Loops: b, m, n, k.
+  if (isa<linalg::BatchMatmulOp>(op))
+    return {1, 8, 16, 8};
+  // Loops: m, k.
+  if (isa<linalg::MatvecOp>(op))
+    return {16, 16};
+  // Loops: n, f, oh, ow, c, kh, kw.
+  if (isa<linalg::Conv2DNchwFchwOp>(op))
+    return {1, 16, 1, 0, 16, 0, 0};
+  return {};
+}
+
+// The vector ops on bf16 have no LLVM lowering, so contractions in bf16 are
+// left to the scalar loops, which `refback-expand-ops-for-llvm` promotes.
+static bool isVectorizableContraction(linalg::LinalgOp op) {
+  if (!isa<linalg::MatmulOp, linalg::BatchMatmulOp, linalg::MatvecOp>(op))
+    return false;
+  return llvm::none_of(op->getOperandTypes(), [](Type type) {
+    return getElementTypeOrSelf(type).isBF16();
+  });
+}
+
+// Returns true if the results of the linalg ops that `op` reads, directly or
+// through other linalg ops, each have a single use. Fusing `op` tiles these
+// producers too, so a producer whose result is also used elsewhere would be
+// computed both whole and tile by tile.
+static bool hasOnlySingleUseProducers(linalg::LinalgOp op) {
+  return llvm::all_of(op->getOperands(), [](Value operand) {
+    auto producer = operand.getDefiningOp<linalg::LinalgOp>();
+    return !producer ||
+           (operand.hasOneUse() && hasOnlySingleUseProducers(producer));
+  });
+}
+
+// Returns the matmul whose result the elementwise `op` reads, and which it
+// is the only user of, so that `op` can be fused in as an epilogue.
+static linalg::LinalgOp getFusableContraction(linalg::GenericOp op,
+                                              bool libraryCalls) {
+  if (!op.hasTensorSemantics() ||
+      op.getNumParallelLoops() != op.getNumLoops() ||
+      op.getNumOutputs() != 1 || !hasOnlySingleUseProducers(op))
+    return nullptr;
+  for (OpOperand *input : op.getInputOperands()) {
+    auto producer = input->get().getDefiningOp<linalg::LinalgOp>();
+    if (producer && isa<linalg::MatmulOp, linalg::BatchMatmulOp>(producer) &&
+        input->get().hasOneUse() &&
+        op.getTiedIndexingMap(input).isIdentity() &&
+        !getTileSizes(producer).empty() &&
+        !(libraryCalls && !getLibraryKernel(producer).empty()))
+      return producer;
+  }
+  return nullptr;
+}
+
+// Tiles the elementwise epilogues of the matmuls (bias, activation, residual
+// add) along the parallel loops of the matmul tiles and computes the tiles of
+// the matmuls in the same loops, so that each tile of the result is written
+// once, while it is still in the cache, rather than stored by the matmul and
+// read back by the epilogue. The matmul tiles are tiled again along their
+// reduction, and padded, like the other contractions.
+static void fuseEpilogues(func::FuncOp func, IRRewriter &rewriter,
+                          bool libraryCalls) {
+  SmallVector<std::pair<linalg::GenericOp, linalg::LinalgOp>> epilogues;
+  func.walk([&](linalg::GenericOp op) {
+    if (linalg::LinalgOp contraction =
+            getFusableContraction(op, libraryCalls))
+      epilogues.emplace_back(op, contraction);
+  });
+  for (auto it : epilogues) {
+    linalg::GenericOp epilogue = it.first;
+    linalg::LinalgOp contraction = it.second;
+    // The tile sizes of the parallel loops of the matmul, which are the
+    // leading ones.
+    SmallVector<int64_t> tileSizes = getTileSizes(contraction);
+    tileSizes.resize(contraction.getNumParallelLoops());
+    rewriter.setInsertionPoint(epilogue);
+    FailureOr<linalg::TileLoopNest> loopNest =
+        linalg::tileConsumerAndFuseProducers(
+            rewriter, epilogue, tileSizes, /*tileInterchange=*/{},
+            /*tileDistribution=*/llvm::None);
+    if (failed(loopNest) || loopNest->isEmpty())
+      continue;
+    rewriter.replaceOp(epilogue, loopNest->getRootOpReplacementResults());
+    if (contraction->use_empty())
+      rewriter.eraseOp(contraction);
+  }
+}
+
+namespace {
+class TileAndPadLinalgOps
+    : public TileAndPadLinalgOpsBase<TileAndPadLinalgOps> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<AffineDialect, scf::SCFDialect, tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    IRRewriter rewriter(&getContext());
+    fuseEpilogues(getOperation(), rewriter, libraryCalls);
+
+    SmallVector<linalg::LinalgOp> ops;
+    getOperation().walk([&](linalg::LinalgOp op) {
+      // The library kernels block the ops they compute themselves.
+      if (libraryCalls && !getLibraryKernel(op).empty())
+        return;
+      if (op.hasTensorSemantics() && !getTileSizes(op).empty())
+        ops.push_back(op);
+    });
+
+    for (linalg::LinalgOp op : ops) {
+      bool vectorizable = isVectorizableContraction(op);
+      linalg::LinalgTilingOptions tilingOptions;
+      tilingOptions.setTileSizes(getTileSizes(op));
+      rewriter.setInsertionPoint(op);
+      FailureOr<linalg::TiledLinalgOp> tiled =
+          linalg::tileLinalgOp(rewriter, op, tilingOptions);
+      if (failed(tiled))
+        continue;
+      rewriter.replaceOp(op, tiled->tensorResults);
+
+      // The tiles at the boundaries of the iteration domain, or all of them
+      // when the sizes are dynamic, are smaller than the tile sizes. Pad them
+      // with zeros, which don't change the result of a contraction, so that
+      // the vectorizer sees the same static shape for all of them.
+      linalg::LinalgOp tiledOp = tiled->op;
+      if (!vectorizable || !tiledOp.hasDynamicShape())
+        continue;
+      SmallVector<int64_t> paddingDimensions =
+          llvm::to_vector(llvm::seq<int64_t>(0, tiledOp.getNumLoops()));
+      SmallVector<Attribute> paddingValues;
+      for (Value operand : tiledOp->getOperands())
+        paddingValues.push_back(
+            rewriter.getZeroAttr(getElementTypeOrSelf(operand.getType())));
+      rewriter.setInsertionPoint(tiledOp);
+      linalg::LinalgOp paddedOp;
+      FailureOr<SmallVector<Value>> paddedResults = linalg::rewriteAsPaddedOp(
+          rewriter, tiledOp, paddingDimensions, paddingValues,
+          /*packPaddings=*/{}, paddedOp);
+      if (succeeded(paddedResults))
+        rewriter.replaceOp(tiledOp, *paddedResults);
+    }
+
+    // The convolutions read a zero padded copy of their input. Pad the slice
+    // of the input that each tile reads instead, which stays in the cache,
+    // rather than writing and reading back a padded copy of the whole input.
+    RewritePatternSet patterns(&getContext());
+    patterns.add<linalg::ExtractSliceOfPadTensorSwapPattern>(&getContext());
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns))))
+      return signalPassFailure();
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createTileAndPadLinalgOpsPass() {
+  return std::make_unique<TileAndPadLinalgOps>();
+}
+
+//===----------------------------------------------------------------------===//
+// VectorizeLinalgOps
+//===----------------------------------------------------------------------===//
+
+// The largest iteration domain that a contraction is unrolled into vector
+// ops for. This is the size of the tiles that `refback-tile-and-pad-linalg-ops`
+// produces, and keeps the vectorizer from unrolling untiled ops.
+static constexpr int64_t kMaxVectorizedIterations = 1024;
+
+namespace {
+class VectorizeStaticContraction
+    : public OpInterfaceRewritePattern<linalg::LinalgOp> {
+public:
+  using OpInterfaceRewritePattern::OpInterfaceRewritePattern;
+  LogicalResult matchAndRewrite(linalg::LinalgOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!isVectorizableContraction(op) || !op.hasBufferSemantics())
+      return rewriter.notifyMatchFailure(op, "expected contraction on memrefs");
+    if (op.hasDynamicShape())
+      return rewriter.notifyMatchFailure(op, "expected static shape");
+    int64_t numIterations = 1;
+    for (int64_t size : op.getStaticLoopRanges())
+      numIterations *= size;
+    if (numIterations > kMaxVectorizedIterations)
+      return rewriter.notifyMatchFailure(op, "iteration domain too large");
+    return linalg::vectorize(rewriter, op);
+  }
+};
+} // namespace
+
+namespace {
+class VectorizeLinalgOps : public VectorizeLinalgOpsBase<VectorizeLinalgOps> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<vector::VectorDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<VectorizeStaticContraction>(context);
+    // The vectorizer expresses the contractions as elementwise products and
+    // reductions. Turn them back into `vector.contract` and lower that to
+    // outer products, which map onto SIMD multiply-adds.
+    vector::populateVectorReductionToContractPatterns(patterns);
+    vector::populateVectorTransferPermutationMapLoweringPatterns(patterns);
+    vector::populateVectorContractLoweringPatterns(
+        patterns, vector::VectorTransformsOptions().setVectorTransformsOptions(
+                      vector::VectorContractLowering::OuterProduct));
+    vector::populateVectorMultiReductionLoweringPatterns(
+        patterns, vector::VectorMultiReductionLowering::InnerParallel);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createVectorizeLinalgOpsPass() {
+  return std::make_unique<VectorizeLinalgOps>();
+}
+
+//===----------------------------------------------------------------------===//
+// LowerLinalgToLibraryCalls
+//===----------------------------------------------------------------------===//
+
+namespace {
+class LowerLinalgToLibraryCalls
+    : public LowerLinalgToLibraryCallsBase<LowerLinalgToLibraryCalls> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    SmallVector<linalg::LinalgOp> ops;
+    module.walk([&](linalg::LinalgOp op) {
+      if (op.hasBufferSemantics() && !getLibraryKernel(op).empty())
+        ops.push_back(op);
+    });
+    if (ops.empty())
+      return;
+
+    SymbolTable symbolTable(module);
+    OpBuilder b(module.getBodyRegion());
+    for (linalg::LinalgOp op : ops) {
+      Location loc = op.getLoc();
+      b.setInsertionPoint(op);
+      SmallVector<Value> args;
+      // The strided operands, and the contiguous copies passed in their
+      // place. The outputs are also copied in, since the kernels accumulate
+      // into them.
+      SmallVector<std::pair<OpOperand *, Value>> copies;
+      for (OpOperand &operand : op->getOpOperands()) {
+        Value arg = operand.get();
+        auto type = arg.getType().cast<MemRefType>();
+        if (!isContiguousMemRefType(type)) {
+          Value buffer = b.create<memref::AllocOp>(
+              loc, MemRefType::get(type.getShape(), type.getElementType()));
+          b.create<memref::CopyOp>(loc, arg, buffer);
+          copies.emplace_back(&operand, buffer);
+          arg = buffer;
+        }
+        SmallVector<int64_t> sizes(type.getRank(), ShapedType::kDynamicSize);
+        args.push_back(b.create<memref::CastOp>(
+            loc, MemRefType::get(sizes, type.getElementType()), arg));
+      }
+      if (auto conv = dyn_cast<linalg::Conv2DNchwFchwOp>(op.getOperation())) {
+        for (DenseIntElementsAttr attr : {conv.strides(), conv.dilations()})
+          for (int64_t value : attr.getValues<int64_t>())
+            args.push_back(
+                b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(value)));
+      }
+
+      StringRef kernel = getLibraryKernel(op);
+      if (!symbolTable.lookup(kernel)) {
+        OpBuilder::InsertionGuard guard(b);
+        b.setInsertionPointToStart(module.getBody());
+        auto func = b.create<func::FuncOp>(
+            module.getLoc(), kernel,
+            b.getFunctionType(ValueRange(args).getTypes(), {}));
+        func.setPrivate();
+        addEmitCInterfaceAttr(func);
+        symbolTable.insert(func);
+      }
+      b.create<func::CallOp>(loc, kernel, TypeRange(), args);
+      for (auto &copy : copies) {
+        if (copy.first->getOperandNumber() >= op.getNumInputs())
+          b.create<memref::CopyOp>(loc, copy.second, copy.first->get());
+        b.create<memref::DeallocOp>(loc, copy.second);
+      }
+      op->erase();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createLowerLinalgToLibraryCallsPass() {
+  return std::make_unique<LowerLinalgToLibraryCalls>();
+}
+
+//===----------------------------------------------------------------------===//
+// BufferizeKernelCalls
+//===----------------------------------------------------------------------===//
+
+// Returns `type` with dynamic sizes, which is the type of the memrefs that
+// the custom kernels take.
+static MemRefType getKernelArgType(ShapedType type) {
+  SmallVector<int64_t> sizes(type.getRank(), ShapedType::kDynamicSize);
+  return MemRefType::get(sizes, type.getElementType());
+}
+
+namespace {
+class BufferizeKernelCalls
+    : public BufferizeKernelCallsBase<BufferizeKernelCalls> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    SmallVector<TorchConversion::CallKernelOp> ops;
+    module.walk([&](TorchConversion::CallKernelOp op) { ops.push_back(op); });
+    if (ops.empty())
+      return;
+
+    SymbolTable symbolTable(module);
+    OpBuilder b(module.getBodyRegion());
+    for (TorchConversion::CallKernelOp op : ops) {
+      Location loc = op.getLoc();
+      b.setInsertionPoint(op);
+      SmallVector<Value> args;
+      for (Value input : op.inputs()) {
+        auto type = input.getType().dyn_cast<RankedTensorType>();
+        if (!type) {
+          args.push_back(input);
+          continue;
+        }
+        Value buffer = b.create<bufferization::ToMemrefOp>(
+            loc, MemRefType::get(type.getShape(), type.getElementType()),
+            input);
+        args.push_back(
+            b.create<memref::CastOp>(loc, getKernelArgType(type), buffer));
+      }
+      SmallVector<Value> results;
+      for (Value output : op.outputs()) {
+        auto type = output.getType().cast<RankedTensorType>();
+        SmallVector<Value> dynamicSizes;
+        for (int64_t i = 0, e = type.getRank(); i < e; ++i)
+          if (type.isDynamicDim(i))
+            dynamicSizes.push_back(b.create<tensor::DimOp>(loc, output, i));
+        Value buffer = b.create<memref::AllocOp>(
+            loc, MemRefType::get(type.getShape(), type.getElementType()),
+            dynamicSizes);
+        args.push_back(
+            b.create<memref::CastOp>(loc, getKernelArgType(type), buffer));
+        results.push_back(b.create<bufferization::ToTensorOp>(loc, buffer));
+      }
+
+      std::string kernel = (kCustomKernelPrefix + op.kernel()).str();
+      FunctionType kernelType =
+          b.getFunctionType(ValueRange(args).getTypes(), {});
+      if (auto func = symbolTable.lookup<func::FuncOp>(kernel)) {
+        if (func.getFunctionType() != kernelType) {
+          op.emitError() << "the types of the call to kernel '" << op.kernel()
+                         << "' don't match those of another call to it: "
+                         << kernelType << " vs. " << func.getFunctionType();
+          return signalPassFailure();
+        }
+      } else {
+        OpBuilder::InsertionGuard guard(b);
+        b.setInsertionPointToStart(module.getBody());
+        auto func = b.create<func::FuncOp>(module.getLoc(), kernel, kernelType);
+        func.setPrivate();
+        addEmitCInterfaceAttr(func);
+        symbolTable.insert(func);
+      }
+      b.create<func::CallOp>(loc, kernel, TypeRange(), args);
+      op.replaceAllUsesWith(results);
+      op.erase();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createBufferizeKernelCallsPass() {
+  return std::make_unique<BufferizeKernelCalls>();
+}
+
+//===----------------------------------------------------------------------===//
+// PlanMemory
+//===----------------------------------------------------------------------===//
+
+// The alignment of the buffers in the arena, which is that of the cache lines
+// and of the widest vector loads.
+static constexpr int64_t kArenaAlignment = 64;
+
+// Collects the ops that use `buffer` or a value aliasing it, and returns false
+// if the buffer escapes the function or is freed explicitly. Any memref that
+// an op using the buffer produces, and any memref block argument of the
+// regions of such an op, is conservatively taken to alias it.
+static bool collectBufferUsers(Value buffer,
+                               SmallVectorImpl<Operation *> &users) {
+  SmallVector<Value> worklist{buffer};
+  DenseSet<Value> visited;
+  auto addAliases = [&](ValueRange values) {
+    for (Value value : values)
+      if (value.getType().isa<BaseMemRefType>())
+        worklist.push_back(value);
+  };
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (!visited.insert(value).second)
+      continue;
+    for (Operation *user : value.getUsers()) {
+      // The library and custom kernels only access their operands during the
+      // call.
+      auto call = dyn_cast<func::CallOp>(user);
+      bool isLibraryCall =
+          call && (call.getCallee().startswith(kLibraryKernelPrefix) ||
+                   call.getCallee().startswith(kCustomKernelPrefix));
+      if (!isLibraryCall &&
+          isa<func::ReturnOp, CallOpInterface, memref::DeallocOp>(user))
+        return false;
+      users.push_back(user);
+      addAliases(user->getResults());
+      for (Region &region : user->getRegions())
+        for (Block &block : region)
+          addAliases(block.getArguments());
+      if (user->hasTrait<OpTrait::IsTerminator>())
+        addAliases(user->getParentOp()->getResults());
+    }
+  }
+  return true;
+}
+
+namespace {
+// A buffer allocated in the entry block of a function, and live from the op
+// at index `begin` to the one at index `end` of that block.
+struct PlannedBuffer {
+  memref::AllocOp alloc;
+  int64_t size;
+  unsigned begin;
+  unsigned end;
+  int64_t offset = 0;
+};
+} // namespace
+
+// Returns the buffers of `func` that can be placed in an arena: those with a
+// static shape and identity layout that are allocated in its entry block and
+// don't escape it.
+static SmallVector<PlannedBuffer> getPlannableBuffers(func::FuncOp func) {
+  Block &entryBlock = func.getBody().front();
+  DenseMap<Operation *, unsigned> indices;
+  for (auto it : llvm::enumerate(entryBlock))
+    indices[&it.value()] = it.index();
+
+  SmallVector<PlannedBuffer> buffers;
+  for (auto alloc : entryBlock.getOps<memref::AllocOp>()) {
+    MemRefType type = alloc.getType();
+    if (!type.hasStaticShape() || !type.getLayout().isIdentity() ||
+        type.getMemorySpace() || !type.getElementType().isIntOrFloat())
+      continue;
+    if (alloc.alignment() && *alloc.alignment() > kArenaAlignment)
+      continue;
+    SmallVector<Operation *> users;
+    if (!collectBufferUsers(alloc, users))
+      continue;
+    PlannedBuffer buffer;
+    buffer.alloc = alloc;
+    int64_t elementSize = llvm::divideCeil(type.getElementTypeBitWidth(), 8);
+    buffer.size = std::max<int64_t>(type.getNumElements() * elementSize, 1);
+    buffer.begin = buffer.end = indices[alloc];
+    for (Operation *user : users)
+      buffer.end = std::max(
+          buffer.end, indices[entryBlock.findAncestorOpInBlock(*user)]);
+    buffers.push_back(buffer);
+  }
+  return buffers;
+}
+
+// Assigns offsets in the arena to `buffers` so that any two of them that are
+// live at the same time don't overlap, and returns the size of the arena.
+// This is the greedy-by-size heuristic: the largest buffers are placed first,
+// each at the lowest offset that doesn't overlap a buffer already placed.
+static int64_t assignOffsets(MutableArrayRef<PlannedBuffer> buffers) {
+  SmallVector<PlannedBuffer *> bySize;
+  for (PlannedBuffer &buffer : buffers)
+    bySize.push_back(&buffer);
+  llvm::stable_sort(bySize, [](PlannedBuffer *a, PlannedBuffer *b) {
+    return a->size > b->size;
+  });
+
+  int64_t arenaSize = 0;
+  SmallVector<PlannedBuffer *> placed;
+  for (PlannedBuffer *buffer : bySize) {
+    SmallVector<PlannedBuffer *> live;
+    for (PlannedBuffer *other : placed)
+      if (other->begin <= buffer->end && buffer->begin <= other->end)
+        live.push_back(other);
+    llvm::sort(live, [](PlannedBuffer *a, PlannedBuffer *b) {
+      return a->offset < b->offset;
+    });
+    int64_t offset = 0;
+    for (PlannedBuffer *other : live) {
+      if (offset + buffer->size <= other->offset)
+        break;
+      offset = std::max(
+          offset, llvm::alignTo(other->offset + other->size, kArenaAlignment));
+    }
+    buffer->offset = offset;
+    arenaSize = std::max(arenaSize, offset + buffer->size);
+    placed.push_back(buffer);
+  }
+  return arenaSize;
+}
+
+// Returns an arena of type `arenaType` for `func` that is a global, so that
+// its memory is allocated once for all the calls to the function. This makes
+// the function non-reentrant.
+static Value createGlobalArena(OpBuilder &b, SymbolTable &symbolTable,
+                               func::FuncOp func, MemRefType arenaType) {
+  b.setInsertionPoint(func);
+  auto arena = b.create<memref::GlobalOp>(
+      func.getLoc(), ("__refbackend_arena_" + func.getName()).str(),
+      /*sym_visibility=*/b.getStringAttr("private"),
+      /*type=*/arenaType,
+      /*initial_value=*/b.getUnitAttr(),
+      /*constant=*/false,
+      /*alignment=*/b.getI64IntegerAttr(kArenaAlignment));
+  symbolTable.insert(arena);
+  b.setInsertionPointToStart(&func.getBody().front());
+  return b.create<memref::GetGlobalOp>(func.getLoc(), arenaType,
+                                       arena.sym_name());
+}
+
+// Returns an arena of type `arenaType` for `func` that is allocated on entry
+// and freed on return, which keeps the function reentrant with a single
+// allocation per call.
+static Value createArenaPerCall(OpBuilder &b, func::FuncOp func,
+                                MemRefType arenaType) {
+  b.setInsertionPointToStart(&func.getBody().front());
+  Value arena = b.create<memref::AllocOp>(
+      func.getLoc(), arenaType, b.getI64IntegerAttr(kArenaAlignment));
+  func.walk([&](func::ReturnOp op) {
+    b.setInsertionPoint(op);
+    b.create<memref::DeallocOp>(op.getLoc(), arena);
+  });
+  return arena;
+}
+
+namespace {
+class PlanMemory : public PlanMemoryBase<PlanMemory> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    SymbolTable symbolTable(module);
+    OpBuilder b(module.getBodyRegion());
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (func.isDeclaration())
+        continue;
+      SmallVector<PlannedBuffer> buffers = getPlannableBuffers(func);
+      if (buffers.empty())
+        continue;
+      int64_t arenaSize = assignOffsets(buffers);
+
+      auto arenaType = MemRefType::get({arenaSize}, b.getI8Type());
+      Value arenaBuffer = arenaPerCall
+                              ? createArenaPerCall(b, func, arenaType)
+                              : createGlobalArena(b, symbolTable, func,
+                                                  arenaType);
+      for (PlannedBuffer &buffer : buffers) {
+        b.setInsertionPoint(buffer.alloc);
+        Location loc = buffer.alloc.getLoc();
+        Value offset = b.create<arith::ConstantIndexOp>(loc, buffer.offset);
+        Value view = b.create<memref::ViewOp>(loc, buffer.alloc.getType(),
+                                              arenaBuffer, offset,
+                                              /*sizes=*/ValueRange());
+        buffer.alloc.replaceAllUsesWith(view);
+        buffer.alloc.erase();
+      }
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createPlanMemoryPass() {
+  return std::make_unique<PlanMemory>();
+}
+
+//===----------------------------------------------------------------------===//
+// InsertKernelProfiling
+//===----------------------------------------------------------------------===//
+
+// The functions of the runtime that time the kernels, which must be kept in
+// sync with `refbackend.py` and `Runtime.cpp`.
+static constexpr StringRef kProfileBeginFunc = "refbackend_profile_begin";
+static constexpr StringRef kProfileEndFunc = "refbackend_profile_end";
+
+// Returns the type of the names of the kernels passed to the runtime.
+static MemRefType getKernelNameType(MLIRContext *context) {
+  return MemRefType::get({ShapedType::kDynamicSize},
+                         IntegerType::get(context, 8));
+}
+
+// Declares the runtime functions `refbackend_profile_begin() -> i64`, which
+// returns the start time of a kernel, and `refbackend_profile_end(name,
+// start, bytes)`, which records a call to it.
+static void declareProfilingFunctions(OpBuilder &b, SymbolTable &symbolTable,
+                                      ModuleOp module) {
+  b.setInsertionPointToStart(module.getBody());
+  Type i64 = b.getI64Type();
+  auto declare = [&](StringRef name, FunctionType type) {
+    auto func = b.create<func::FuncOp>(module.getLoc(), name, type);
+    func.setPrivate();
+    addEmitCInterfaceAttr(func);
+    symbolTable.insert(func);
+  };
+  declare(kProfileBeginFunc, b.getFunctionType({}, {i64}));
+  declare(kProfileEndFunc,
+          b.getFunctionType({getKernelNameType(b.getContext()), i64, i64}, {}));
+}
+
+// Returns a constant global holding the name of the kernel `op`, which is the
+// name of the op and its location, so that the time spent in the kernel can
+// be traced back to the Torch op it was lowered from. The kernels with the
+// same name share the global.
+static memref::GlobalOp
+getOrCreateKernelName(OpBuilder &b, SymbolTable &symbolTable, ModuleOp module,
+                      Operation *op, llvm::StringMap<memref::GlobalOp> &names) {
+  std::string name;
+  llvm::raw_string_ostream os(name);
+  os << op->getName() << " at ";
+  op->getLoc().print(os);
+  os.flush();
+  memref::GlobalOp &global = names[name];
+  if (global)
+    return global;
+
+  SmallVector<int8_t> bytes(name.begin(), name.end());
+  auto type = MemRefType::get({static_cast<int64_t>(bytes.size())},
+                              b.getI8Type());
+  OpBuilder::InsertionGuard guard(b);
+  b.setInsertionPointToStart(module.getBody());
+  global = b.create<memref::GlobalOp>(
+      module.getLoc(), "__refbackend_kernel_name",
+      /*sym_visibility=*/b.getStringAttr("private"),
+      /*type=*/type,
+      /*initial_value=*/
+      DenseElementsAttr::get(
+          RankedTensorType::get(type.getShape(), type.getElementType()),
+          llvm::makeArrayRef(bytes)),
+      /*constant=*/true,
+      /*alignment=*/nullptr);
+  symbolTable.insert(global);
+  return global;
+}
+
+// Returns the number of bytes of the memrefs `memrefs`.
+static Value getBytesAccessed(OpBuilder &b, Location loc, ValueRange memrefs) {
+  Value total = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(0));
+  for (Value operand : memrefs) {
+    auto type = operand.getType().dyn_cast<MemRefType>();
+    if (!type || !type.getElementType().isIntOrFloat())
+      continue;
+    int64_t staticSize = llvm::divideCeil(type.getElementTypeBitWidth(), 8);
+    for (int64_t size : type.getShape())
+      if (!ShapedType::isDynamic(size))
+        staticSize *= size;
+    Value bytes =
+        b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(staticSize));
+    for (auto it : llvm::enumerate(type.getShape())) {
+      if (!ShapedType::isDynamic(it.value()))
+        continue;
+      Value size = b.create<memref::DimOp>(loc, operand, it.index());
+      size = b.create<arith::IndexCastOp>(loc, b.getI64Type(), size);
+      bytes = b.create<arith::MulIOp>(loc, bytes, size);
+    }
+    total = b.create<arith::AddIOp>(loc, total, bytes);
+  }
+  return total;
+}
+
+static bool isKernelOp(Operation *op) {
+  return isa<linalg::LinalgOp, TMTensor::TMTensorOp>(op);
+}
+
+namespace {
+// A kernel to time: a linalg or TMTensor op, or the loop nest computing the
+// tiles of one, which is named after the first op it computes.
+struct Kernel {
+  Operation *op;
+  Operation *namedOp;
+};
+} // namespace
+
+// Returns the op that the loop nest `loop` computes the tiles of if all the
+// linalg and TMTensor ops in it were created from the same op, e.g. the tiles
+// of a matmul and the fills and copies padding them, or nullptr otherwise.
+// The first reduction is preferred over the padding to name the kernel.
+static Operation *getTiledKernelOp(Operation *loop) {
+  Operation *first = nullptr;
+  Operation *firstReduction = nullptr;
+  bool sameLocation = true;
+  loop->walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (!isKernelOp(op))
+      return WalkResult::advance();
+    if (!first)
+      first = op;
+    else if (op->getLoc() != first->getLoc())
+      sameLocation = false;
+    auto linalgOp = dyn_cast<linalg::LinalgOp>(op);
+    if (!firstReduction && linalgOp && linalgOp.getNumReductionLoops() > 0)
+      firstReduction = op;
+    return WalkResult::skip();
+  });
+  if (!sameLocation)
+    return nullptr;
+  return firstReduction ? firstReduction : first;
+}
+
+namespace {
+class InsertKernelProfiling
+    : public InsertKernelProfilingBase<InsertKernelProfiling> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    SmallVector<Kernel> kernels;
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (func.isDeclaration())
+        continue;
+      // The ops nested in a kernel are timed as part of it. The tiles of a
+      // tiled matmul are computed in a loop nest, which is timed as a whole,
+      // so that the runtime is only called once per kernel.
+      func.walk<WalkOrder::PreOrder>([&](Operation *op) {
+        if (isKernelOp(op)) {
+          kernels.push_back({op, op});
+          return WalkResult::skip();
+        }
+        if (!isa<scf::ForOp, scf::ParallelOp>(op))
+          return WalkResult::advance();
+        Operation *namedOp = getTiledKernelOp(op);
+        if (!namedOp)
+          return WalkResult::advance();
+        kernels.push_back({op, namedOp});
+        return WalkResult::skip();
+      });
+    }
+    if (kernels.empty())
+      return;
+
+    SymbolTable symbolTable(module);
+    OpBuilder b(module.getBodyRegion());
+    declareProfilingFunctions(b, symbolTable, module);
+    llvm::StringMap<memref::GlobalOp> names;
+    for (Kernel kernel : kernels) {
+      Operation *op = kernel.op;
+      memref::GlobalOp global = getOrCreateKernelName(
+          b, symbolTable, module, kernel.namedOp, names);
+      Location loc = kernel.namedOp->getLoc();
+      b.setInsertionPoint(op);
+      Value name = b.create<memref::GetGlobalOp>(loc, global.type(),
+                                                 global.sym_name());
+      name = b.create<memref::CastOp>(loc, getKernelNameType(&getContext()),
+                                      name);
+      // A loop nest accesses the whole memrefs that its tiles are views of.
+      SetVector<Value> memrefs(op->getOperands().begin(),
+                               op->getOperands().end());
+      getUsedValuesDefinedAbove(op->getRegions(), memrefs);
+      Value bytes = getBytesAccessed(b, loc, memrefs.getArrayRef());
+      Value start = b.create<func::CallOp>(loc, kProfileBeginFunc,
+                                           b.getI64Type(), ValueRange())
+                        .getResult(0);
+      b.setInsertionPointAfter(op);
+      b.create<func::CallOp>(loc, kProfileEndFunc, TypeRange(),
+                             ValueRange{name, start, bytes});
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createInsertKernelProfilingPass() {
+  return std::make_unique<InsertKernelProfiling>();
+}
+
+//===----------------------------------------------------------------------===//
+// MapHostMemoryToGpu
+//===----------------------------------------------------------------------===//
+
+// The granularity at which the GPU drivers pin host memory. Each global
+// starts on its own page, so that no page is registered twice.
+static constexpr int64_t kHostPageSize = 4096;
+
+// The function registering the globals of a module with the GPU driver, which
+// the runtime calls once when the module is loaded.
+static constexpr StringRef kRegisterGpuMemoryFuncName =
+    "refbackend_register_gpu_memory";
+
+// Copies `src` to `dst` with the GPU driver, waiting for the copy. Only the
+// asynchronous form of `gpu.memcpy` is lowered to the runtime wrappers.
+static void copyWithGpu(OpBuilder &b, Location loc, Value src, Value dst) {
+  Type tokenType = b.getType<gpu::AsyncTokenType>();
+  Value token =
+      b.create<gpu::WaitOp>(loc, tokenType, ValueRange()).asyncToken();
+  token = b.create<gpu::MemcpyOp>(loc, tokenType, ValueRange{token}, dst, src)
+              .asyncToken();
+  b.create<gpu::WaitOp>(loc, Type(), ValueRange{token});
+}
+
+// Creates the function registering `globals` with the GPU driver. Calling it
+// once at load time, rather than on the first call of the module, keeps
+// concurrent first calls from racing to register the same pages.
+static void createRegisterGpuMemoryFunc(OpBuilder &b, ModuleOp module,
+                                        ArrayRef<memref::GlobalOp> globals) {
+  Location loc = module.getLoc();
+  b.setInsertionPointToEnd(module.getBody());
+  auto func = b.create<func::FuncOp>(loc, kRegisterGpuMemoryFuncName,
+                                     b.getFunctionType({}, {}));
+  addEmitCInterfaceAttr(func);
+  b.setInsertionPointToStart(func.addEntryBlock());
+  for (memref::GlobalOp global : globals) {
+    MemRefType type = global.type();
+    Value memref =
+        b.create<memref::GetGlobalOp>(loc, type, global.sym_name());
+    memref = b.create<memref::CastOp>(
+        loc, UnrankedMemRefType::get(type.getElementType(), 0), memref);
+    b.create<gpu::HostRegisterOp>(loc, memref);
+  }
+  b.create<func::ReturnOp>(loc);
+}
+
+// Replaces the memref that the argument `arg` of `func` is cast to by a copy
+// in memory allocated by the module, which the kernels can access. The
+// outputs are copied back to the memory of the caller on return.
+static LogicalResult stageArgument(OpBuilder &b, func::FuncOp func,
+                                   BlockArgument arg, bool isOutput) {
+  memref::CastOp cast;
+  for (Operation *user : arg.getUsers())
+    if ((cast = dyn_cast<memref::CastOp>(user)))
+      break;
+  if (!cast)
+    return success();
+  auto type = cast.getType().cast<MemRefType>();
+  if (!type.getLayout().isIdentity())
+    return cast.emitError("strided arguments cannot be mapped to the GPU");
+
+  Location loc = arg.getLoc();
+  b.setInsertionPointAfter(cast);
+  SmallVector<Value> dynamicSizes;
+  for (auto it : llvm::enumerate(type.getShape()))
+    if (ShapedType::isDynamic(it.value()))
+      dynamicSizes.push_back(b.create<memref::DimOp>(loc, arg, it.index()));
+  Value staged = b.create<memref::AllocOp>(loc, type, dynamicSizes);
+  cast.getResult().replaceAllUsesWith(staged);
+  // The outputs are only written, and the inputs only read.
+  if (!isOutput)
+    copyWithGpu(b, loc, cast, staged);
+  func.walk([&](func::ReturnOp op) {
+    b.setInsertionPoint(op);
+    if (isOutput)
+      copyWithGpu(b, op.getLoc(), staged, cast);
+    b.create<memref::DeallocOp>(op.getLoc(), staged);
+  });
+  return success();
+}
+
+namespace {
+class MapHostMemoryToGpu
+    : public MapHostMemoryToGpuBase<MapHostMemoryToGpu> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    SmallVector<memref::GlobalOp> globals;
+    for (auto global : module.getOps<memref::GlobalOp>()) {
+      // The drivers only pin writable memory, and fail to register a page
+      // twice.
+      global->removeAttr(global.constantAttrName());
+      int64_t alignment = global.alignment().getValueOr(0);
+      global.alignmentAttr(OpBuilder(global).getI64IntegerAttr(
+          std::max(alignment, kHostPageSize)));
+      if (global.type().getNumElements() > 0)
+        globals.push_back(global);
+    }
+
+    OpBuilder b(module.getBodyRegion());
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (func.isPrivate() || func.isDeclaration())
+        continue;
+      // The outputs of the functions with static result shapes follow their
+      // inputs.
+      int64_t numOutputs = 0;
+      if (auto resultTypes =
+              func->getAttrOfType<ArrayAttr>("refbackend.result_types"))
+        numOutputs = resultTypes.size();
+      int64_t numInputs = func.getNumArguments() - numOutputs;
+      for (BlockArgument arg : func.getArguments()) {
+        if (failed(stageArgument(b, func, arg,
+                                 arg.getArgNumber() >= numInputs)))
+          return signalPassFailure();
+      }
+    }
+    if (!globals.empty())
+      createRegisterGpuMemoryFunc(b, module, globals);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createMapHostMemoryToGpuPass() {
+  return std::make_unique<MapHostMemoryToGpu>();
+}
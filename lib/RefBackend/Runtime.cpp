@@ -0,0 +1,555 @@
+//===- Runtime.cpp - Runtime for RefBackend modules -----------------------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/RefBackend/Runtime.h"
+
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include "mlir/ExecutionEngine/OptUtils.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/TargetSelect.h"
+
+#include <chrono>
+
+using namespace mlir;
+using namespace mlir::torch::RefBackend;
+
+// These names must be kept in sync with `refbackend.py` and the RefBackend
+// passes.
+static constexpr StringRef kResultTypesAttr = "refbackend.result_types";
+static constexpr StringRef kConsumeReturnPrefix =
+    "refbackend_consume_func_return_";
+static constexpr StringRef kArenaPrefix = "__refbackend_arena_";
+static constexpr StringRef kSeedGlobal = "global_seed";
+static constexpr StringRef kStatePrefix = "__refbackend_state_";
+static constexpr StringRef kCInterfacePrefix = "_mlir_ciface_";
+static constexpr StringRef kConsumeReturnFuncsSymbol =
+    "refbackend_consume_return_funcs";
+static constexpr StringRef kResultTypesSymbol = "refbackend_result_types";
+static constexpr StringRef kReentrantSymbol = "refbackend_reentrant";
+static constexpr StringRef kPackedPrefix = "refbackend_packed_";
+static constexpr StringRef kProfileBeginFunc = "refbackend_profile_begin";
+static constexpr StringRef kProfileEndFunc = "refbackend_profile_end";
+static constexpr StringRef kCallbackSuffix = "_callback";
+
+static llvm::Error makeError(const Twine &message) {
+  return llvm::createStringError(llvm::inconvertibleErrorCode(), message);
+}
+
+// Returns the rank of the output for a result of type `type`, like
+// `memref<2x3xf32>`, which is 0 for scalars.
+static int64_t getOutputRank(StringRef type) {
+  if (!type.consume_front("memref<"))
+    return 0;
+  return type.count('x');
+}
+
+//===----------------------------------------------------------------------===//
+// Kernel profiles
+//===----------------------------------------------------------------------===//
+
+namespace {
+struct KernelCounters {
+  int64_t calls = 0;
+  int64_t nanoseconds = 0;
+  int64_t bytes = 0;
+};
+} // namespace
+
+namespace {
+// The counters of the kernels called by one thread, by name. Each thread
+// only takes its own mutex when a kernel ends, which no other thread takes
+// unless the profiles are read or reset.
+struct ThreadProfiles {
+  std::mutex mutex;
+  llvm::StringMap<KernelCounters> counters;
+};
+} // namespace
+
+static std::mutex &getThreadsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// The profiles of all the threads that called a kernel, guarded by
+// `getThreadsMutex`. They outlive their threads.
+static std::vector<std::shared_ptr<ThreadProfiles>> &getAllThreadProfiles() {
+  static std::vector<std::shared_ptr<ThreadProfiles>> threads;
+  return threads;
+}
+
+static ThreadProfiles &getThreadProfiles() {
+  thread_local std::shared_ptr<ThreadProfiles> profiles = [] {
+    auto profiles = std::make_shared<ThreadProfiles>();
+    std::lock_guard<std::mutex> lock(getThreadsMutex());
+    getAllThreadProfiles().push_back(profiles);
+    return profiles;
+  }();
+  return *profiles;
+}
+
+int64_t mlir::torch::RefBackend::profileKernelBegin() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void mlir::torch::RefBackend::profileKernelEnd(
+    StridedMemRefType<char, 1> *kernel, int64_t start, int64_t bytes) {
+  int64_t end = profileKernelBegin();
+  StringRef name(kernel->data + kernel->offset, kernel->sizes[0]);
+  ThreadProfiles &profiles = getThreadProfiles();
+  std::lock_guard<std::mutex> lock(profiles.mutex);
+  KernelCounters &counters = profiles.counters[name];
+  counters.calls++;
+  counters.nanoseconds += end - start;
+  counters.bytes += bytes;
+}
+
+std::vector<KernelProfile> mlir::torch::RefBackend::getKernelProfiles() {
+  llvm::StringMap<KernelCounters> totals;
+  {
+    std::lock_guard<std::mutex> threadsLock(getThreadsMutex());
+    for (auto &thread : getAllThreadProfiles()) {
+      std::lock_guard<std::mutex> lock(thread->mutex);
+      for (auto &entry : thread->counters) {
+        KernelCounters &total = totals[entry.first()];
+        total.calls += entry.second.calls;
+        total.nanoseconds += entry.second.nanoseconds;
+        total.bytes += entry.second.bytes;
+      }
+    }
+  }
+  std::vector<KernelProfile> profiles;
+  for (auto &entry : totals)
+    profiles.push_back({entry.first().str(), entry.second.calls,
+                        entry.second.nanoseconds, entry.second.bytes});
+  llvm::sort(profiles, [](const KernelProfile &a, const KernelProfile &b) {
+    return a.nanoseconds > b.nanoseconds;
+  });
+  return profiles;
+}
+
+void mlir::torch::RefBackend::resetKernelProfiles() {
+  std::lock_guard<std::mutex> threadsLock(getThreadsMutex());
+  for (auto &thread : getAllThreadProfiles()) {
+    std::lock_guard<std::mutex> lock(thread->mutex);
+    thread->counters.clear();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// GPU allocator
+//===----------------------------------------------------------------------===//
+
+// The alignment of the managed allocations of both drivers.
+static constexpr uint64_t kManagedAlignment = 256;
+// The `CU_MEM_ATTACH_GLOBAL` and `hipMemAttachGlobal` flags, making managed
+// memory accessible from any stream.
+static constexpr unsigned kAttachGlobal = 1;
+
+// Sets `function` to the address of the symbol `name` of `library`, or sets
+// `error` if it has no such symbol.
+template <typename FunctionType>
+static bool lookUpFunction(llvm::sys::DynamicLibrary &library,
+                           const char *name, FunctionType &function,
+                           std::string &error) {
+  function =
+      reinterpret_cast<FunctionType>(library.getAddressOfSymbol(name));
+  if (!function)
+    error = (Twine("the GPU driver has no function '") + name + "'").str();
+  return function;
+}
+
+namespace {
+// The functions of the CUDA driver API allocating managed memory. They need a
+// current context, which is the primary context of the first device, like in
+// the MLIR CUDA runtime wrappers.
+struct CudaDriver {
+  std::string error;
+  void *context = nullptr;
+  int (*cuCtxPushCurrent)(void *context) = nullptr;
+  int (*cuCtxPopCurrent)(void **context) = nullptr;
+  int (*cuMemAllocManaged)(uint64_t *ptr, size_t size,
+                           unsigned flags) = nullptr;
+  int (*cuMemFree)(uint64_t ptr) = nullptr;
+};
+
+// The functions of the HIP runtime allocating managed memory.
+struct HipRuntime {
+  std::string error;
+  int (*hipMallocManaged)(void **ptr, size_t size, unsigned flags) = nullptr;
+  int (*hipFree)(void *ptr) = nullptr;
+};
+} // namespace
+
+static const CudaDriver &getCudaDriver() {
+  static const CudaDriver driver = [] {
+    CudaDriver driver;
+    std::string &error = driver.error;
+    auto library =
+        llvm::sys::DynamicLibrary::getPermanentLibrary("libcuda.so.1", &error);
+    if (!library.isValid())
+      return driver;
+    int (*cuInit)(unsigned flags);
+    int (*cuDeviceGet)(int *device, int ordinal);
+    int (*cuDevicePrimaryCtxRetain)(void **context, int device);
+    if (!lookUpFunction(library, "cuInit", cuInit, error) ||
+        !lookUpFunction(library, "cuDeviceGet", cuDeviceGet, error) ||
+        !lookUpFunction(library, "cuDevicePrimaryCtxRetain",
+                        cuDevicePrimaryCtxRetain, error) ||
+        !lookUpFunction(library, "cuCtxPushCurrent_v2",
+                        driver.cuCtxPushCurrent, error) ||
+        !lookUpFunction(library, "cuCtxPopCurrent_v2", driver.cuCtxPopCurrent,
+                        error) ||
+        !lookUpFunction(library, "cuMemAllocManaged",
+                        driver.cuMemAllocManaged, error) ||
+        !lookUpFunction(library, "cuMemFree_v2", driver.cuMemFree, error))
+      return driver;
+    int device;
+    if (cuInit(0) || cuDeviceGet(&device, 0) ||
+        cuDevicePrimaryCtxRetain(&driver.context, device))
+      error = "could not initialize the first CUDA device";
+    return driver;
+  }();
+  return driver;
+}
+
+static void *cudaAlloc(uint64_t size) {
+  const CudaDriver &driver = getCudaDriver();
+  uint64_t ptr;
+  driver.cuCtxPushCurrent(driver.context);
+  // Like `malloc`, an empty allocation returns a unique pointer.
+  if (driver.cuMemAllocManaged(&ptr, std::max<uint64_t>(size, 1),
+                               kAttachGlobal))
+    ptr = 0;
+  void *context;
+  driver.cuCtxPopCurrent(&context);
+  return reinterpret_cast<void *>(ptr);
+}
+
+static void *cudaAlignedAlloc(uint64_t alignment, uint64_t size) {
+  return alignment <= kManagedAlignment ? cudaAlloc(size) : nullptr;
+}
+
+static void cudaFree(void *ptr) {
+  if (!ptr)
+    return;
+  const CudaDriver &driver = getCudaDriver();
+  driver.cuCtxPushCurrent(driver.context);
+  driver.cuMemFree(reinterpret_cast<uint64_t>(ptr));
+  void *context;
+  driver.cuCtxPopCurrent(&context);
+}
+
+static const HipRuntime &getHipRuntime() {
+  static const HipRuntime runtime = [] {
+    HipRuntime runtime;
+    std::string &error = runtime.error;
+    auto library = llvm::sys::DynamicLibrary::getPermanentLibrary(
+        "libamdhip64.so", &error);
+    if (!library.isValid())
+      return runtime;
+    if (lookUpFunction(library, "hipMallocManaged", runtime.hipMallocManaged,
+                       error))
+      lookUpFunction(library, "hipFree", runtime.hipFree, error);
+    return runtime;
+  }();
+  return runtime;
+}
+
+static void *hipAlloc(uint64_t size) {
+  void *ptr;
+  if (getHipRuntime().hipMallocManaged(&ptr, std::max<uint64_t>(size, 1),
+                                       kAttachGlobal))
+    return nullptr;
+  return ptr;
+}
+
+static void *hipAlignedAlloc(uint64_t alignment, uint64_t size) {
+  return alignment <= kManagedAlignment ? hipAlloc(size) : nullptr;
+}
+
+static void hipFree(void *ptr) {
+  if (ptr)
+    getHipRuntime().hipFree(ptr);
+}
+
+llvm::Expected<GpuAllocator>
+mlir::torch::RefBackend::getGpuAllocator(StringRef platform) {
+  if (platform == "cuda") {
+    const std::string &error = getCudaDriver().error;
+    if (!error.empty())
+      return makeError("could not load the CUDA driver: " + error);
+    return GpuAllocator{cudaAlloc, cudaAlignedAlloc, cudaFree};
+  }
+  if (platform == "rocm") {
+    const std::string &error = getHipRuntime().error;
+    if (!error.empty())
+      return makeError("could not load the HIP runtime: " + error);
+    return GpuAllocator{hipAlloc, hipAlignedAlloc, hipFree};
+  }
+  return makeError("unknown GPU platform '" + platform +
+                   "', expected 'cuda' or 'rocm'");
+}
+
+//===----------------------------------------------------------------------===//
+// Runtime
+//===----------------------------------------------------------------------===//
+
+Runtime::~Runtime() = default;
+
+llvm::Expected<llvm::ArrayRef<std::string>>
+Runtime::getResultTypes(StringRef name) const {
+  auto it = resultTypes.find(name);
+  if (it == resultTypes.end())
+    return makeError("'" + name +
+                     "' is not a function with static result shapes");
+  return llvm::makeArrayRef(it->second);
+}
+
+llvm::Error Runtime::invoke(StringRef name, ArrayRef<MemRefArg> inputs,
+                            ArrayRef<MemRefArg> outputs) {
+  llvm::Expected<ArrayRef<std::string>> types = getResultTypes(name);
+  if (!types)
+    return types.takeError();
+  if (outputs.size() != types->size())
+    return makeError("'" + name + "' expects " + Twine(types->size()) +
+                     " outputs, got " + Twine(outputs.size()));
+  for (auto it : llvm::enumerate(*types)) {
+    if (outputs[it.index()].rank != getOutputRank(it.value()))
+      return makeError("output " + Twine(it.index()) + " of '" + name +
+                       "' must have the type " + it.value());
+  }
+
+  PackedFunction function;
+  {
+    std::lock_guard<std::mutex> lock(lookupMutex);
+    auto it = packedFunctions.find(name);
+    if (it == packedFunctions.end()) {
+      llvm::Expected<PackedFunction> lookedUp = lookupPacked(name);
+      if (!lookedUp)
+        return lookedUp.takeError();
+      it = packedFunctions.try_emplace(name, *lookedUp).first;
+    }
+    function = it->second;
+  }
+
+  // The C interface of the functions takes pointers to the unranked memref
+  // descriptors, and each packed argument points to one of those pointers.
+  SmallVector<MemRefArg> args(inputs.begin(), inputs.end());
+  args.append(outputs.begin(), outputs.end());
+  SmallVector<MemRefArg *> argPointers;
+  for (MemRefArg &arg : args)
+    argPointers.push_back(&arg);
+  SmallVector<void *> packedArgs;
+  for (MemRefArg *&argPointer : argPointers)
+    packedArgs.push_back(&argPointer);
+
+  if (reentrant) {
+    function(packedArgs.data());
+    return llvm::Error::success();
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  function(packedArgs.data());
+  return llvm::Error::success();
+}
+
+//===----------------------------------------------------------------------===//
+// JIT compiled modules
+//===----------------------------------------------------------------------===//
+
+namespace {
+class JitRuntime : public Runtime {
+public:
+  JitRuntime(std::unique_ptr<ExecutionEngine> engine,
+             llvm::StringMap<std::vector<std::string>> resultTypes,
+             bool reentrant)
+      : Runtime(std::move(resultTypes), reentrant), engine(std::move(engine)) {}
+
+protected:
+  llvm::Expected<PackedFunction> lookupPacked(StringRef name) override {
+    // The packed interface of the function itself takes the expanded memref
+    // descriptors, while that of its C interface takes the pointers to the
+    // unranked descriptors that `invoke` passes.
+    return engine->lookupPacked((kCInterfacePrefix + name).str());
+  }
+
+private:
+  std::unique_ptr<ExecutionEngine> engine;
+};
+} // namespace
+
+// Stands in for the functions consuming the returns, which the Python invoker
+// provides. `Runtime::invoke` never calls the functions returning through
+// them.
+static void unsupportedConsumeReturn() {
+  llvm::report_fatal_error(
+      "the functions with dynamic result shapes cannot be invoked");
+}
+
+llvm::Expected<std::unique_ptr<Runtime>>
+Runtime::loadModule(ModuleOp module, ArrayRef<StringRef> sharedLibPaths,
+                    int optLevel) {
+  llvm::StringMap<std::vector<std::string>> resultTypes;
+  SmallVector<std::string> consumeReturnFuncs;
+  bool reentrant = true;
+  for (Operation &op : *module.getBody()) {
+    auto name = op.getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName());
+    if (!name)
+      continue;
+    if (name.getValue().startswith(kArenaPrefix) ||
+        name.getValue().startswith(kStatePrefix) ||
+        name.getValue() == kSeedGlobal)
+      reentrant = false;
+    if (name.getValue().startswith(kConsumeReturnPrefix))
+      consumeReturnFuncs.push_back(name.getValue().str());
+    if (name.getValue().startswith(kCInterfacePrefix))
+      continue;
+    auto types = op.getAttrOfType<ArrayAttr>(kResultTypesAttr);
+    if (!types)
+      continue;
+    std::vector<std::string> &typeStrings = resultTypes[name.getValue()];
+    for (Attribute type : types) {
+      std::string typeString;
+      llvm::raw_string_ostream os(typeString);
+      type.cast<TypeAttr>().getValue().print(os);
+      typeStrings.push_back(os.str());
+    }
+  }
+
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  registerLLVMDialectTranslation(*module.getContext());
+
+  auto transformer = makeOptimizingTransformer(optLevel, /*sizeLevel=*/0,
+                                               /*targetMachine=*/nullptr);
+  ExecutionEngineOptions options;
+  options.transformer = transformer;
+  options.jitCodeGenOptLevel = static_cast<llvm::CodeGenOpt::Level>(optLevel);
+  options.sharedLibPaths = sharedLibPaths;
+  auto engine = ExecutionEngine::create(module, options);
+  if (!engine)
+    return engine.takeError();
+  (*engine)->registerSymbols([&](llvm::orc::MangleAndInterner interner) {
+    llvm::orc::SymbolMap symbolMap;
+    for (const std::string &name : consumeReturnFuncs)
+      symbolMap[interner(kCInterfacePrefix.str() + name)] =
+          llvm::JITEvaluatedSymbol::fromPointer(&unsupportedConsumeReturn);
+    symbolMap[interner((kCInterfacePrefix + kProfileBeginFunc).str())] =
+        llvm::JITEvaluatedSymbol::fromPointer(&profileKernelBegin);
+    symbolMap[interner((kCInterfacePrefix + kProfileEndFunc).str())] =
+        llvm::JITEvaluatedSymbol::fromPointer(&profileKernelEnd);
+    for (const LibraryKernel &kernel : getLibraryKernels())
+      symbolMap[interner((kCInterfacePrefix + kernel.name).str())] =
+          llvm::JITEvaluatedSymbol::fromPointer(kernel.address);
+    return symbolMap;
+  });
+  return std::unique_ptr<Runtime>(std::make_unique<JitRuntime>(
+      std::move(*engine), std::move(resultTypes), reentrant));
+}
+
+llvm::Expected<std::unique_ptr<Runtime>>
+Runtime::loadModuleFile(StringRef path, ArrayRef<StringRef> sharedLibPaths,
+                        int optLevel) {
+  MLIRContext context;
+  context.loadDialect<LLVM::LLVMDialect>();
+  OwningOpRef<ModuleOp> module = parseSourceFile<ModuleOp>(path, &context);
+  if (!module)
+    return makeError("cannot parse the module in '" + path + "'");
+  // The ExecutionEngine holds the translated LLVM IR, so the module and its
+  // context can be released once it is created.
+  return loadModule(*module, sharedLibPaths, optLevel);
+}
+
+//===----------------------------------------------------------------------===//
+// Shared libraries
+//===----------------------------------------------------------------------===//
+
+namespace {
+class SharedLibraryRuntime : public Runtime {
+public:
+  SharedLibraryRuntime(llvm::sys::DynamicLibrary library,
+                       llvm::StringMap<std::vector<std::string>> resultTypes,
+                       bool reentrant)
+      : Runtime(std::move(resultTypes), reentrant), library(library) {}
+
+protected:
+  llvm::Expected<PackedFunction> lookupPacked(StringRef name) override {
+    void *address =
+        library.getAddressOfSymbol((kPackedPrefix + name).str().c_str());
+    if (!address)
+      return makeError("the library has no function '" + name + "'");
+    return reinterpret_cast<PackedFunction>(address);
+  }
+
+private:
+  llvm::sys::DynamicLibrary library;
+};
+} // namespace
+
+llvm::Expected<std::unique_ptr<Runtime>>
+Runtime::loadSharedLibrary(StringRef path) {
+  std::string error;
+  // The libraries are never unloaded, since the functions of a library may
+  // still be running on other threads when the runtime is destroyed.
+  llvm::sys::DynamicLibrary library =
+      llvm::sys::DynamicLibrary::getPermanentLibrary(path.str().c_str(),
+                                                     &error);
+  if (!library.isValid())
+    return makeError("cannot load '" + path + "': " + error);
+
+  auto *resultTypesString = static_cast<const char **>(
+      library.getAddressOfSymbol(kResultTypesSymbol.data()));
+  auto *reentrant =
+      static_cast<const int *>(library.getAddressOfSymbol(kReentrantSymbol.data()));
+  if (!resultTypesString || !reentrant ||
+      !library.getAddressOfSymbol(kConsumeReturnFuncsSymbol.data()))
+    return makeError("'" + path + "' was not written by the RefBackend");
+
+  // Libraries of instrumented modules call the profiling functions through
+  // pointers that the loader sets.
+  if (auto *begin = static_cast<decltype(&profileKernelBegin) *>(
+          library.getAddressOfSymbol(
+              (kProfileBeginFunc + kCallbackSuffix).str().c_str())))
+    *begin = &profileKernelBegin;
+  if (auto *end = static_cast<decltype(&profileKernelEnd) *>(
+          library.getAddressOfSymbol(
+              (kProfileEndFunc + kCallbackSuffix).str().c_str())))
+    *end = &profileKernelEnd;
+  // Likewise for the library kernels that the module calls.
+  for (const LibraryKernel &kernel : getLibraryKernels())
+    if (auto *callback = static_cast<void **>(library.getAddressOfSymbol(
+            (kernel.name + kCallbackSuffix).str().c_str())))
+      *callback = kernel.address;
+
+  // The result types are recorded as `name=type,type;...`.
+  llvm::StringMap<std::vector<std::string>> resultTypes;
+  SmallVector<StringRef> entries;
+  StringRef(*resultTypesString).split(entries, ';', /*MaxSplit=*/-1,
+                                      /*KeepEmpty=*/false);
+  for (StringRef entry : entries) {
+    StringRef name, types;
+    std::tie(name, types) = entry.split('=');
+    SmallVector<StringRef> typeStrings;
+    types.split(typeStrings, ',');
+    std::vector<std::string> &functionTypes = resultTypes[name];
+    for (StringRef type : typeStrings)
+      functionTypes.push_back(type.str());
+  }
+  return std::unique_ptr<Runtime>(std::make_unique<SharedLibraryRuntime>(
+      library, std::move(resultTypes), *reentrant != 0));
+}
@@ -10,7 +10,10 @@
 #include "mlir-c/Bindings/Python/Interop.h"
 #include "mlir-c/Registration.h"
 #include "mlir/Bindings/Python/PybindAdaptors.h"
+#include "torch-mlir-c/Context.h"
 #include "torch-mlir-c/Dialects.h"
+#include "torch-mlir-c/PassManager.h"
+#include "torch-mlir-c/RefBackend.h"
 #include "torch-mlir-c/Registration.h"
 
 namespace py = pybind11;
@@ -30,4 +33,182 @@ PYBIND11_MODULE(_torchMlir, m) {
         }
       },
       py::arg("context"), py::arg("load") = true);
+
+  m.def(
+      "add_to_shape_library",
+      [](MlirContext context, const std::string &functions) {
+        MlirLogicalResult result = torchMlirContextAddToShapeLibrary(
+            context, mlirStringRefCreate(functions.data(), functions.size()));
+        if (mlirLogicalResultIsFailure(result))
+          throw std::runtime_error(
+              "Failed to add the shape functions to the shape library. See "
+              "the diagnostics for the reason.");
+      },
+      py::arg("context"), py::arg("functions"),
+      "Adds the shape functions of the module `functions`, in its textual "
+      "form, to the shape library of `context`, leaving out the ones whose "
+      "names the library already has. A function differing from the one of "
+      "the same name is an error.");
+
+  m.def(
+      "run_pass_manager",
+      [](MlirPassManager passManager, MlirModule module) {
+        MlirLogicalResult result;
+        {
+          py::gil_scoped_release release;
+          result = mlirPassManagerRun(passManager, module);
+        }
+        if (mlirLogicalResultIsFailure(result))
+          throw std::runtime_error("Failure while executing pass pipeline.");
+      },
+      py::arg("pass_manager"), py::arg("module"),
+      "Runs the pass manager on the module without holding the GIL, so that "
+      "other threads can compile meanwhile. The module must not be used by "
+      "another thread until it returns.");
+
+  m.def(
+      "enable_crash_reproducer_generation",
+      [](MlirPassManager passManager, const std::string &outputFile) {
+        torchMlirPassManagerEnableCrashReproducerGeneration(
+            passManager,
+            mlirStringRefCreate(outputFile.data(), outputFile.size()));
+      },
+      py::arg("pass_manager"), py::arg("output_file"),
+      "Makes the pass manager write a reproducer to `output_file` if a pass "
+      "fails, without printing the IR when none does.");
+
+  m.def(
+      "enable_pass_profiling",
+      [](MlirPassManager passManager) {
+        return reinterpret_cast<uintptr_t>(
+            torchMlirPassManagerEnableProfiling(passManager).ptr);
+      },
+      py::arg("pass_manager"),
+      "Makes the pass manager profile the passes it runs, and returns the "
+      "profiler, which lives as long as the pass manager.");
+
+  m.def(
+      "get_pass_profiles",
+      [](uintptr_t profiler) {
+        py::list profiles;
+        torchMlirPassProfilerForEachPass(
+            {reinterpret_cast<void *>(profiler)},
+            [](MlirStringRef pass, int64_t runs, double seconds,
+               int64_t opsBefore, int64_t opsAfter, intptr_t numStatistics,
+               const MlirStringRef *statisticNames,
+               const uint64_t *statisticValues, void *userData) {
+              py::dict statistics;
+              for (intptr_t i = 0; i < numStatistics; ++i)
+                statistics[py::str(statisticNames[i].data,
+                                   statisticNames[i].length)] =
+                    statisticValues[i];
+              static_cast<py::list *>(userData)->append(py::make_tuple(
+                  std::string(pass.data, pass.length), runs, seconds,
+                  opsBefore, opsAfter, statistics));
+            },
+            &profiles);
+        return profiles;
+      },
+      py::arg("profiler"),
+      "Returns the profiles of the passes run so far, as tuples of the pass, "
+      "the number of runs, the time in seconds, the numbers of operations "
+      "before and after and the increases of the statistics.");
+
+  m.def(
+      "refbackend_emit_object_file",
+      [](MlirModule module, const std::string &path, int optLevel) {
+        MlirLogicalResult result = torchMlirRefBackendEmitObjectFile(
+            module, mlirStringRefCreate(path.data(), path.size()), optLevel);
+        if (mlirLogicalResultIsFailure(result))
+          throw std::runtime_error("failed to emit an object file to " + path);
+      },
+      py::arg("module"), py::arg("path"), py::arg("opt_level") = 2,
+      "Compiles a module in the LLVM dialect to an object file for the host.");
+
+  m.def(
+      "refbackend_invoke_packed_batch",
+      [](uintptr_t function, uintptr_t packedArgs, intptr_t numCalls,
+         int numThreads) {
+        py::gil_scoped_release release;
+        torchMlirRefBackendInvokePackedBatch(
+            reinterpret_cast<void (*)(void **)>(function),
+            reinterpret_cast<void ***>(packedArgs), numCalls, numThreads);
+      },
+      py::arg("function"), py::arg("packed_args"), py::arg("num_calls"),
+      py::arg("num_threads") = 1,
+      "Calls the packed interface of a RefBackend function at the address "
+      "`function` on each of the argument arrays at `packed_args`.");
+
+  m.def(
+      "refbackend_get_profiling_functions",
+      []() {
+        void *begin, *end;
+        torchMlirRefBackendGetProfilingFunctions(&begin, &end);
+        return py::make_tuple(reinterpret_cast<uintptr_t>(begin),
+                              reinterpret_cast<uintptr_t>(end));
+      },
+      "Returns the addresses of the runtime functions called by the kernels "
+      "instrumented by `refback-insert-kernel-profiling`.");
+
+  m.def(
+      "refbackend_get_kernel_profiles",
+      []() {
+        py::list profiles;
+        torchMlirRefBackendForEachKernelProfile(
+            [](MlirStringRef kernel, int64_t calls, int64_t nanoseconds,
+               int64_t bytes, void *userData) {
+              static_cast<py::list *>(userData)->append(py::make_tuple(
+                  std::string(kernel.data, kernel.length), calls,
+                  nanoseconds, bytes));
+            },
+            &profiles);
+        return profiles;
+      },
+      "Returns the (kernel, calls, nanoseconds, bytes) profiles of the "
+      "instrumented kernels called so far, from the most to the least time "
+      "spent.");
+
+  m.def("refbackend_reset_kernel_profiles",
+        []() { torchMlirRefBackendResetKernelProfiles(); },
+        "Discards the profiles of the kernels called so far.");
+
+  m.def(
+      "refbackend_get_library_kernels",
+      []() {
+        py::dict kernels;
+        torchMlirRefBackendForEachLibraryKernel(
+            [](MlirStringRef name, void *address, void *userData) {
+              (*static_cast<py::dict *>(userData))[py::str(
+                  name.data, name.length)] =
+                  reinterpret_cast<uintptr_t>(address);
+            },
+            &kernels);
+        return kernels;
+      },
+      "Returns the addresses of the library kernels called by the modules "
+      "compiled with `refback-lower-linalg-to-library-calls`, by name.");
+
+  m.def(
+      "refbackend_get_gpu_allocator",
+      [](const std::string &platform) {
+        void *alloc, *alignedAlloc, *free;
+        std::string error;
+        MlirLogicalResult result = torchMlirRefBackendGetGpuAllocator(
+            mlirStringRefCreate(platform.data(), platform.size()), &alloc,
+            &alignedAlloc, &free,
+            [](MlirStringRef message, void *userData) {
+              static_cast<std::string *>(userData)->append(message.data,
+                                                           message.length);
+            },
+            &error);
+        if (mlirLogicalResultIsFailure(result))
+          throw std::runtime_error(error);
+        return py::make_tuple(reinterpret_cast<uintptr_t>(alloc),
+                              reinterpret_cast<uintptr_t>(alignedAlloc),
+                              reinterpret_cast<uintptr_t>(free));
+      },
+      py::arg("platform"),
+      "Returns the addresses of the functions allocating and freeing the "
+      "managed memory of the modules lowered for GPUs, with the driver of "
+      "`platform`.");
 }
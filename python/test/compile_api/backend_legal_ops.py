@@ -0,0 +1,36 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the ops listed in `backend_legal_ops` are not decomposed, and
+# that misspelled op names are reported.
+
+import torch
+
+import torch_mlir
+
+class AddmmModule(torch.nn.Module):
+    def forward(self, bias, x, y):
+        return torch.addmm(bias, x, y)
+
+args = [torch.rand(3), torch.rand(2, 4), torch.rand(4, 3)]
+
+print(torch_mlir.compile(AddmmModule(), args))
+# CHECK-LABEL: @forward
+# CHECK-NOT: torch.aten.addmm
+# CHECK: torch.aten.mm
+
+print(torch_mlir.compile(AddmmModule(), args,
+                         backend_legal_ops=["torch.aten.addmm"]))
+# CHECK-LABEL: @forward
+# CHECK: torch.aten.addmm
+
+try:
+    torch_mlir.compile(AddmmModule(), args,
+                       backend_legal_ops=["torch.aten.addmm.default"])
+except Exception as e:
+    print(e)
+# CHECK: unknown op 'torch.aten.addmm.default' in legal-ops
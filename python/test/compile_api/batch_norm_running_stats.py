@@ -0,0 +1,33 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that a batch norm in training mode writes its updated running stats
+# back to the slots of the module, and that in eval mode they are inlined as
+# constants.
+
+import torch
+
+import torch_mlir
+
+class BatchNormModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.bn = torch.nn.BatchNorm2d(3)
+    def forward(self, x):
+        return self.bn(x)
+
+example_input = torch.ones(2, 3, 4, 4)
+
+print(torch_mlir.compile(BatchNormModule().train(), example_input))
+# CHECK-LABEL: @forward
+# CHECK-DAG: torch.global_slot.set @bn.running_mean
+# CHECK-DAG: torch.global_slot.set @bn.running_var
+
+print(torch_mlir.compile(BatchNormModule().eval(), example_input))
+# CHECK-LABEL: @forward
+# CHECK-NOT: torch.global_slot.set
+# CHECK: torch.aten.batch_norm
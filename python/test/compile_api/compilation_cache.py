@@ -0,0 +1,122 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import os
+import tempfile
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.compilation_cache import CACHE_DIR_ENV_VAR, CompilationCache, get_compilation_cache
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class TanhModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+    def forward(self, x):
+        return torch.ops.aten.tanh(x)
+
+tanh_example_input = torch.ones(2, 3)
+
+with tempfile.TemporaryDirectory() as cache_dir:
+    # Filling the cache.
+    print(torch_mlir.compile(TanhModule(), tanh_example_input,
+                             cache_dir=cache_dir))
+    # CHECK-LABEL: @forward
+    # CHECK: torch.aten.tanh %{{.*}} : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    print(len(os.listdir(cache_dir)))
+    # CHECK: 1
+
+    # Hitting the cache.
+    print(torch_mlir.compile(TanhModule(), tanh_example_input,
+                             cache_dir=cache_dir))
+    # CHECK-LABEL: @forward
+    # CHECK: torch.aten.tanh %{{.*}} : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    print(len(os.listdir(cache_dir)))
+    # CHECK: 1
+
+    # A different output type is a different entry.
+    print(torch_mlir.compile(TanhModule(), tanh_example_input,
+                             output_type=torch_mlir.OutputType.LINALG_ON_TENSORS,
+                             cache_dir=cache_dir))
+    # CHECK-LABEL: @forward
+    # CHECK: math.tanh
+    print(len(os.listdir(cache_dir)))
+    # CHECK: 2
+
+    # The raw output of the importer is not cached.
+    print(torch_mlir.compile(TanhModule(), tanh_example_input,
+                             output_type=torch_mlir.OutputType.RAW,
+                             cache_dir=cache_dir))
+    # CHECK: torch.nn_module {
+    print(len(os.listdir(cache_dir)))
+    # CHECK: 2
+
+with tempfile.TemporaryDirectory() as cache_dir:
+    # The RefBackend caches the shared library of the module, which `compile`
+    # returns the path of and `load` loads.
+    backend = RefBackendLinalgOnTensorsBackend(cache_dir=cache_dir)
+    expected = TanhModule()(tanh_example_input).numpy()
+    for _ in range(2):
+        module = torch_mlir.compile(
+            TanhModule(), tanh_example_input,
+            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+        compiled = backend.compile(module)
+        print(os.path.dirname(compiled) == cache_dir, compiled.endswith(".so"))
+        result = backend.load(compiled).forward(tanh_example_input.numpy())
+        print(f"refbackend: {'PASS' if np.allclose(result, expected) else 'FAIL'}")
+        print(len(os.listdir(cache_dir)))
+    # CHECK: True True
+    # CHECK-NEXT: refbackend: PASS
+    # CHECK-NEXT: 1
+    # CHECK-NEXT: True True
+    # CHECK-NEXT: refbackend: PASS
+    # CHECK-NEXT: 1
+
+with tempfile.TemporaryDirectory() as cache_dir:
+    # Without a directory, the cache is the one of the environment variable.
+    os.environ.pop(CACHE_DIR_ENV_VAR, None)
+    print(get_compilation_cache())
+    # CHECK: None
+    os.environ[CACHE_DIR_ENV_VAR] = cache_dir
+    print(get_compilation_cache().directory == cache_dir)
+    # CHECK: True
+    torch_mlir.compile(TanhModule(), tanh_example_input,
+                       output_type=torch_mlir.OutputType.TOSA)
+    print(len(os.listdir(cache_dir)))
+    # CHECK: 1
+    del os.environ[CACHE_DIR_ENV_VAR]
+
+with tempfile.TemporaryDirectory() as cache_dir:
+    cache = CompilationCache(cache_dir)
+    # The boundaries of the parts of a key count.
+    print(cache.get_key("ab", "c") == cache.get_key("a", "bc"))
+    # CHECK: False
+    print(cache.get_key("ab", "c") == cache.get_key("ab", "c"))
+    # CHECK: True
+
+    key = cache.get_key("entry")
+    print(cache.load(key, ".txt"))
+    # CHECK: None
+    cache.store(key, ".txt", b"contents")
+    print(cache.load(key, ".txt"))
+    # CHECK: b'contents'
+
+    # A failed write leaves neither the entry nor a temporary file behind.
+    def failing_write(path):
+        with open(path, "w") as f:
+            f.write("partial")
+        raise RuntimeError("write failed")
+    other_key = cache.get_key("other entry")
+    try:
+        cache.store_file(other_key, ".txt", failing_write)
+    except RuntimeError as e:
+        print(e)
+    # CHECK: write failed
+    print(cache.load(other_key, ".txt"), len(os.listdir(cache_dir)))
+    # CHECK: None 1
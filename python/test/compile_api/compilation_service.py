@@ -0,0 +1,48 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+import torch_mlir
+
+class ScaleModule(torch.nn.Module):
+    def __init__(self, scale):
+        super().__init__()
+        self.scale = scale
+    def forward(self, x):
+        return x * self.scale
+
+models = [(ScaleModule(float(i)), torch.ones(2, 3)) for i in range(8)]
+
+with torch_mlir.CompilationService(max_workers=4) as service:
+    modules = service.compile_all(
+        models, output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+
+# The results are in the order of the models.
+for module in modules:
+    print(module)
+# CHECK-LABEL: @forward
+# CHECK: arith.constant 0.000000e+00 : f64
+# CHECK-LABEL: @forward
+# CHECK: arith.constant 1.000000e+00 : f64
+# CHECK-LABEL: @forward
+# CHECK: arith.constant 2.000000e+00 : f64
+
+# A failure is reported by the future of its model.
+class UnsupportedModule(torch.nn.Module):
+    def forward(self, x):
+        return torch.ops.aten.nonzero(x)
+
+future = torch_mlir.get_compilation_service().submit(
+    UnsupportedModule(), torch.ones(2, 3),
+    output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+try:
+    future.result()
+except Exception as e:
+    print(e)
+# CHECK: Lowering TorchScript IR -> Torch Backend IR failed with the following diagnostics:
+# CHECK: nonzero
@@ -0,0 +1,58 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that calls made on several threads at once to one loaded module each
+# get their own results back, whether the module is reentrant or the invoker
+# serializes the calls.
+
+import os
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.ir import Module
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class MatmulTanh(torch.nn.Module):
+    def forward(self, x, y):
+        return torch.tanh(torch.mm(x, y))
+
+x = torch.rand(16, 32)
+y = torch.rand(32, 8)
+module = torch_mlir.compile(MatmulTanh(), [x, y],
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+asm = module.operation.get_asm()
+
+np.random.seed(0)
+inputs = [(np.random.rand(16, 32).astype(np.float32),
+           np.random.rand(32, 8).astype(np.float32)) for _ in range(64)]
+expected = [np.tanh(np.matmul(a, b)) for a, b in inputs]
+
+def check(invoker):
+    with ThreadPoolExecutor(max_workers=8) as executor:
+        results = list(executor.map(lambda args: invoker.forward(*args),
+                                    inputs))
+    ok = all(np.allclose(r, e, rtol=1e-5) for r, e in zip(results, expected))
+    return "PASS" if ok else "FAIL"
+
+with tempfile.TemporaryDirectory() as tmp_dir:
+    for reentrant in [False, True]:
+        backend = RefBackendLinalgOnTensorsBackend(reentrant=reentrant)
+        compiled = backend.compile(Module.parse(asm, module.context))
+        print(f"reentrant={reentrant} jit: {check(backend.load(compiled))}")
+        path = os.path.join(tmp_dir, f"reentrant_{reentrant}.so")
+        backend.export_shared_library(compiled, path)
+        print(f"reentrant={reentrant} shared library: "
+              f"{check(backend.load_shared_library(path))}")
+
+# CHECK: reentrant=False jit: PASS
+# CHECK: reentrant=False shared library: PASS
+# CHECK: reentrant=True jit: PASS
+# CHECK: reentrant=True shared library: PASS
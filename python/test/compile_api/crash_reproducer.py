@@ -0,0 +1,50 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that a failing pipeline writes a reproducer of the module it was run
+# on, and that a successful one writes nothing.
+
+import os
+import tempfile
+
+from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+from torch_mlir.ir import Module
+
+ASM = """
+module attributes {torch.debug_module_name = "CrashReproducerTest"} {
+  func.func @forward(%arg0: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32> {
+    return %arg0 : !torch.vtensor<[2],f32>
+  }
+}
+"""
+repro_path = os.path.join(tempfile.gettempdir(), "CrashReproducerTest.mlir")
+if os.path.exists(repro_path):
+    os.remove(repro_path)
+
+module = Module.parse(ASM, context=ModuleBuilder().context)
+run_pipeline_with_repro_report(module, "func.func(canonicalize)",
+                               "Canonicalizing")
+print(os.path.exists(repro_path))
+# CHECK: False
+
+# The torch types are illegal in the linalg-on-tensors backend contract.
+try:
+    run_pipeline_with_repro_report(
+        module, "torch-verify-linalg-on-tensors-backend-contract",
+        "Verifying the backend contract")
+except Exception as e:
+    print(e)
+# CHECK: Verifying the backend contract failed with the following diagnostics:
+# CHECK: Error can be reproduced with:
+# CHECK: $ torch-mlir-opt -run-reproducer {{.*}}CrashReproducerTest.mlir
+
+with open(repro_path) as f:
+    print(f.read())
+os.remove(repro_path)
+# CHECK-DAG: torch-verify-linalg-on-tensors-backend-contract
+# CHECK-DAG: func.func @forward(%{{.*}}: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32>
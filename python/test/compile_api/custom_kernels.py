@@ -0,0 +1,83 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import ctypes
+from typing import List
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.custom_kernels import (get_custom_kernel_symbol,
+                                       register_custom_kernel)
+from torch_mlir.runtime import (make_nd_memref_descriptor,
+                                ranked_memref_to_numpy)
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+lib = torch.library.Library("torch_mlir_compile_api_test", "DEF")
+lib.define("repeat(Tensor x, int times) -> Tensor")
+lib.impl("repeat", lambda x, times: x.repeat(times), "CPU")
+
+def repeat_shape(x: List[int], times: int) -> List[int]:
+    return [x[0] * times]
+
+Memref1DF32 = ctypes.POINTER(make_nd_memref_descriptor(1, ctypes.c_float))
+
+@ctypes.CFUNCTYPE(None, Memref1DF32, ctypes.c_int64, Memref1DF32)
+def repeat_kernel(x, times, out):
+    ranked_memref_to_numpy(out)[...] = np.tile(ranked_memref_to_numpy(x),
+                                               times)
+
+register_custom_kernel("torch_mlir_compile_api_test.repeat", repeat_shape,
+                       repeat_kernel)
+
+class RepeatModule(torch.nn.Module):
+    def forward(self, x):
+        return torch.ops.torch_mlir_compile_api_test.repeat(x, 3) * 2.0
+
+x = torch.rand(5)
+module = torch_mlir.compile(RepeatModule(), x,
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+print(module)
+# CHECK-LABEL: @forward
+# CHECK: torch_c.call_kernel "torch__mlir__compile__api__test_drepeat" ins(%{{.*}}, %{{.*}} : tensor<5xf32>, i64) outs(%{{.*}} : tensor<15xf32>) -> tensor<15xf32>
+
+backend = RefBackendLinalgOnTensorsBackend()
+result = backend.load(backend.compile(module)).forward(x.numpy())
+expected = RepeatModule()(x).numpy()
+print(f"repeat: {'PASS' if np.allclose(result, expected) else 'FAIL'}")
+# CHECK: repeat: PASS
+
+# Op names differing only in their dots and underscores have distinct symbols.
+print(*(get_custom_kernel_symbol(name)
+        for name in ["my_ops.a_b", "my_ops.a.b", "my.ops_a_b"]))
+# CHECK: my__ops_da__b my__ops_da_db my_dops__a__b
+
+# Adding a shape function differing from the one of the same name in the shape
+# library is an error, while adding the same one again is not.
+from torch_mlir._mlir_libs._torchMlir import add_to_shape_library
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+
+def shape_library_asm(body: str) -> str:
+    return f"""
+func.func @__torch_mlir_shape_fn.my_ops.f(%arg0: !torch.list<int>) -> !torch.list<int> {{
+  {body}
+}}"""
+
+identity = shape_library_asm("return %arg0 : !torch.list<int>")
+empty = shape_library_asm(
+    "%0 = torch.prim.ListConstruct : () -> !torch.list<int>\n"
+    "  return %0 : !torch.list<int>")
+context = ModuleBuilder().context
+add_to_shape_library(context, identity)
+add_to_shape_library(context, identity)
+try:
+    add_to_shape_library(context, empty)
+    print("conflict: FAIL")
+except RuntimeError:
+    print("conflict: PASS")
+# CHECK: conflict: PASS
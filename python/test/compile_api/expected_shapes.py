@@ -0,0 +1,29 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+import torch_mlir
+
+class TanhModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+    def forward(self, x):
+        return torch.ops.aten.tanh(x)
+
+placeholder = torch_mlir.TensorPlaceholder.like(
+    torch.ones(8, 3), dynamic_axes=[0], specialize=True)
+
+print(torch_mlir.compile(TanhModule(), placeholder))
+# CHECK-LABEL: @forward(
+# CHECK-SAME: %[[ARG:.*]]: !torch.vtensor<[?,3],f32>) -> !torch.vtensor<[?,3],f32>
+# CHECK: %[[SIZE:.*]] = torch.aten.size.int %[[ARG]]
+# CHECK: %[[EQ:.*]] = torch.aten.eq.int %[[SIZE]]
+# CHECK: torch.prim.If %[[EQ]]
+# CHECK: torch.aten.tanh %{{.*}} : !torch.vtensor<[8,3],f32> -> !torch.vtensor<[8,3],f32>
+# CHECK: } else {
+# CHECK: torch.aten.tanh %[[ARG]] : !torch.vtensor<[?,3],f32> -> !torch.vtensor<[?,3],f32>
@@ -0,0 +1,42 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import os
+import tempfile
+
+import torch
+
+import torch_mlir
+from torch_mlir.ir import Module
+
+
+class LinearModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.linear = torch.nn.Linear(16, 16)
+    def forward(self, x):
+        return self.linear(x)
+
+with tempfile.TemporaryDirectory() as tmp:
+    weights_file = os.path.join(tmp, "weights.bin")
+    module = torch_mlir.compile(
+        LinearModule(), torch.ones(2, 16),
+        output_type=torch_mlir.OutputType.LINALG_ON_TENSORS,
+        external_weights_file=weights_file)
+    # The weight is stored in the file, the bias is too small to be.
+    print(os.path.getsize(weights_file))
+    # CHECK: 1024
+    asm = module.operation.get_asm()
+    print(asm)
+    # CHECK-LABEL: func.func @forward(
+    # CHECK: torch_c.external_literal "{{.*}}weights.bin", 0 : tensor<16x16xf32>
+    # CHECK: arith.constant dense<{{.*}}> : tensor<16xf32>
+
+    # The module is reloaded from its text, without the weights.
+    reloaded = Module.parse(asm, context=module.context)
+    print(reloaded.operation.get_asm() == asm)
+    # CHECK: True
@@ -0,0 +1,63 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the polynomial approximations of the RefBackend's fast-math mode
+# agree with the libm results of the default mode to within the bound that
+# the documentation of `fast_math` states.
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.ir import Module
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class UnaryModule(torch.nn.Module):
+    def __init__(self, op):
+        super().__init__()
+        self.op = op
+    def forward(self, x):
+        return self.op(x)
+
+# The ops and the inputs they are tested on.
+CASES = [
+    ("exp", torch.exp, np.linspace(-80, 80, 100001)),
+    ("log", torch.log, np.geomspace(1e-30, 1e30, 100001)),
+    ("tanh", torch.tanh, np.linspace(-10, 10, 100001)),
+    ("sigmoid", torch.sigmoid, np.linspace(-30, 30, 100001)),
+    ("erf", torch.erf, np.linspace(-5, 5, 100001)),
+]
+# The documented bound on the difference with libm, absolute for the results
+# below 1 in magnitude and relative above.
+ERROR_BOUND = 1e-6
+
+libm_backend = RefBackendLinalgOnTensorsBackend()
+fast_math_backend = RefBackendLinalgOnTensorsBackend(fast_math=True)
+for name, op, inputs in CASES:
+    x = torch.tensor(inputs, dtype=torch.float32)
+    # The module only holds `op` as a Python attribute, so it is traced.
+    module = torch_mlir.compile(UnaryModule(op), x,
+                                output_type=torch_mlir.OutputType.LINALG_ON_TENSORS,
+                                use_tracing=True)
+    asm = module.operation.get_asm()
+    results = []
+    for backend in (libm_backend, fast_math_backend):
+        invoker = backend.load(backend.compile(Module.parse(asm, module.context)))
+        results.append(invoker.forward(x.numpy()))
+    expected, result = results
+    error = np.abs(result - expected) / np.maximum(np.abs(expected), 1)
+    if error.max() <= ERROR_BOUND:
+        print(f"{name}: PASS")
+    else:
+        print(f"{name}: FAIL, max error {error.max()} at x = "
+              f"{inputs[error.argmax()]}")
+
+# CHECK: exp: PASS
+# CHECK: log: PASS
+# CHECK: tanh: PASS
+# CHECK: sigmoid: PASS
+# CHECK: erf: PASS
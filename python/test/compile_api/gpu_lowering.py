@@ -0,0 +1,38 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the GPU RefBackend lowers the kernels to NVVM, up to their
+# serialization, which needs the CUDA toolkit.
+
+import torch
+
+import torch_mlir
+from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir_e2e_test.linalg_on_tensors_backends.gpu_refbackend import get_gpu_lowering_pipeline
+
+class SumModule(torch.nn.Module):
+    def forward(self, x):
+        # The reduction loop runs sequentially in each thread of the kernel.
+        return torch.sum(x, dim=1)
+
+module = torch_mlir.compile(SumModule(), torch.ones(33, 70),
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+pipeline = get_gpu_lowering_pipeline("cuda")
+pipeline = pipeline[:pipeline.index(",gpu-to-cubin")] + ")"
+run_pipeline_with_repro_report(module, pipeline,
+                               "Lowering the kernels of the GPU RefBackend")
+print(module)
+
+# CHECK:      gpu.module
+# CHECK-NOT:    scf.
+# CHECK:        llvm.func @{{.*}} attributes {gpu.kernel, nvvm.kernel}
+# CHECK-NOT:    scf.
+# CHECK:          nvvm.read.ptx.sreg.tid.x
+# CHECK-NOT:    scf.
+# CHECK:          llvm.cond_br
+# CHECK-NOT:    scf.
+# CHECK:          llvm.return
@@ -0,0 +1,95 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+import torch_mlir
+from torch_mlir.compilation_cache import ImportCache
+
+# Count the imports, which only the compiles missing the cache make.
+num_imports = 0
+
+class CountingModuleBuilder(torch_mlir.ModuleBuilder):
+    def import_module(self, *args, **kwargs):
+        global num_imports
+        num_imports += 1
+        return super().import_module(*args, **kwargs)
+
+torch_mlir.ModuleBuilder = CountingModuleBuilder
+
+class ScaleModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.scale = torch.nn.Parameter(torch.ones(3))
+    def forward(self, x):
+        return x * self.scale
+
+model = ScaleModule()
+example_input = torch.ones(2, 3)
+
+print(torch_mlir.compile(model, example_input))
+# CHECK-LABEL: @forward
+# CHECK: torch.vtensor.literal(dense<1.000000e+00> : tensor<3xf32>)
+print(num_imports)
+# CHECK: 1
+
+# The same model compiled again is reused.
+print(torch_mlir.compile(model, example_input))
+# CHECK-LABEL: @forward
+# CHECK: torch.vtensor.literal(dense<1.000000e+00> : tensor<3xf32>)
+print(num_imports)
+# CHECK: 1
+
+# Scripting unrelated code, which adds functions to the compilation unit of the
+# model, doesn't invalidate the result.
+@torch.jit.script
+def unrelated(x: torch.Tensor) -> torch.Tensor:
+    return x + 1
+print(torch_mlir.compile(model, example_input))
+# CHECK-LABEL: @forward
+# CHECK: torch.vtensor.literal(dense<1.000000e+00> : tensor<3xf32>)
+print(num_imports)
+# CHECK: 1
+
+# A different output type is compiled again.
+print(torch_mlir.compile(model, example_input,
+                         output_type=torch_mlir.OutputType.LINALG_ON_TENSORS))
+# CHECK-LABEL: @forward
+# CHECK: arith.mulf
+print(num_imports)
+# CHECK: 2
+
+# Updating a weight in place invalidates the result.
+with torch.no_grad():
+    model.scale.fill_(2.0)
+print(torch_mlir.compile(model, example_input))
+# CHECK-LABEL: @forward
+# CHECK: torch.vtensor.literal(dense<2.000000e+00> : tensor<3xf32>)
+print(num_imports)
+# CHECK: 3
+
+# So does a new instance of the model.
+torch_mlir.compile(ScaleModule(), example_input)
+print(num_imports)
+# CHECK: 4
+
+# The cache is bounded by its number of entries and by the size of their
+# assembly, evicting the least recently used entries.
+tensor = torch.ones(1)
+cache = ImportCache(max_entries=2, max_size=10)
+cache.store("a", [tensor], "aaa")
+cache.store("b", [tensor], "bbb")
+cache.load("a", [tensor])
+cache.store("c", [tensor], "ccc")
+print([key for key in "abc" if cache.load(key, [tensor]) is not None])
+# CHECK: ['a', 'c']
+cache.store("d", [tensor], "dddddddd")
+print([key for key in "abcd" if cache.load(key, [tensor]) is not None])
+# CHECK: ['d']
+cache.store("e", [tensor], "e" * 11)
+print(cache.load("e", [tensor]), cache.size)
+# CHECK: None 8
@@ -0,0 +1,61 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that `invoke_batch` computes the same results as invoking the
+# function once per call, sequentially and on several threads.
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.ir import Module
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class MatmulAddModule(torch.nn.Module):
+    def forward(self, x, y):
+        return torch.matmul(x, y) + 1.0, torch.sum(x, dim=1)
+
+x = torch.rand(5, 7)
+y = torch.rand(7, 3)
+module = torch_mlir.compile(MatmulAddModule(), [x, y],
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+asm = module.operation.get_asm()
+
+np.random.seed(0)
+batch = [(np.random.rand(5, 7).astype(np.float32),
+          np.random.rand(7, 3).astype(np.float32)) for _ in range(16)]
+
+def matches(results, expected):
+    return len(results) == len(expected) and all(
+        all(np.allclose(r, e, rtol=1e-5) for r, e in zip(result, expected))
+        for result, expected in zip(results, expected))
+
+for reentrant in [False, True]:
+    backend = RefBackendLinalgOnTensorsBackend(reentrant=reentrant)
+    invoker = backend.load(
+        backend.compile(Module.parse(asm, module.context)))
+    expected = [invoker.forward(*args) for args in batch]
+    for num_threads in [1, 4]:
+        results = invoker.invoke_batch("forward", batch,
+                                       num_threads=num_threads)
+        status = "PASS" if matches(results, expected) else "FAIL"
+        print(f"reentrant={reentrant} num_threads={num_threads}: {status}")
+    # The results are written to the given outputs.
+    outs = [(np.empty((5, 3), np.float32), np.empty((5,), np.float32))
+            for _ in batch]
+    results = invoker.invoke_batch("forward", batch, outs=outs)
+    written = all(result[0] is out[0] and result[1] is out[1]
+                  for result, out in zip(results, outs))
+    status = "PASS" if written and matches(results, expected) else "FAIL"
+    print(f"reentrant={reentrant} outs: {status}")
+
+# CHECK: reentrant=False num_threads=1: PASS
+# CHECK: reentrant=False num_threads=4: PASS
+# CHECK: reentrant=False outs: PASS
+# CHECK: reentrant=True num_threads=1: PASS
+# CHECK: reentrant=True num_threads=4: PASS
+# CHECK: reentrant=True outs: PASS
@@ -0,0 +1,39 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the kernels of a module compiled with profiling are timed.
+
+import torch
+
+import torch_mlir
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend, get_kernel_profile_report, reset_kernel_profiles
+
+class MatmulRelu(torch.nn.Module):
+    def forward(self, x, y):
+        return torch.relu(torch.mm(x, y))
+
+x = torch.rand(64, 32)
+y = torch.rand(32, 16)
+module = torch_mlir.compile(MatmulRelu(), [x, y],
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+backend = RefBackendLinalgOnTensorsBackend(profile=True)
+invoker = backend.load(backend.compile(module))
+
+reset_kernel_profiles()
+for _ in range(3):
+    invoker.forward(x.numpy(), y.numpy())
+print(get_kernel_profile_report())
+
+# CHECK: time (ms)      %    calls     GB/s  kernel
+# CHECK-DAG: linalg.matmul at {{.*}}kernel_profiling.py
+# CHECK-DAG: linalg.generic at {{.*}}kernel_profiling.py
+
+reset_kernel_profiles()
+print(get_kernel_profile_report())
+
+# CHECK: time (ms)      %    calls     GB/s  kernel
+# CHECK-NOT: linalg
@@ -0,0 +1,49 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the matmuls and convolutions computed by the library kernels of
+# the RefBackend runtime agree with PyTorch.
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class MatmulModule(torch.nn.Module):
+    def forward(self, x, y):
+        return torch.matmul(x, y)
+
+class ConvModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.conv = torch.nn.Conv2d(3, 8, 3, stride=2, padding=1, dilation=2)
+    def forward(self, x):
+        return self.conv(x)
+
+torch.manual_seed(0)
+CASES = [
+    ("matmul", MatmulModule(), (torch.rand(33, 70), torch.rand(70, 17))),
+    ("batch_matmul", MatmulModule(),
+     (torch.rand(3, 33, 70), torch.rand(3, 70, 17))),
+    ("conv", ConvModule(), (torch.rand(2, 3, 17, 19),)),
+]
+
+backend = RefBackendLinalgOnTensorsBackend(library_calls=True)
+for name, model, args in CASES:
+    module = torch_mlir.compile(model, args,
+                                output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+    compiled = backend.compile(module)
+    calls_library = "refbackend_kernel_" in compiled.operation.get_asm()
+    result = backend.load(compiled).forward(*[arg.numpy() for arg in args])
+    expected = model(*args).detach().numpy()
+    ok = calls_library and np.allclose(result, expected, rtol=1e-4, atol=1e-4)
+    print(f"{name}: {'PASS' if ok else 'FAIL'}")
+
+# CHECK: matmul: PASS
+# CHECK: batch_matmul: PASS
+# CHECK: conv: PASS
@@ -0,0 +1,42 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the kernels compiled for several threads run their parallel
+# loops on the async runtime and compute the same results as sequentially.
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.ir import Module
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend, get_lowering_pipeline
+
+class MatmulReluSum(torch.nn.Module):
+    def forward(self, x, y):
+        return torch.sum(torch.relu(torch.mm(x, y) - 0.5), dim=0)
+
+x = torch.rand(64, 32)
+y = torch.rand(32, 48)
+module = torch_mlir.compile(MatmulReluSum(), [x, y],
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+asm = module.operation.get_asm()
+
+print("async-parallel-for" in get_lowering_pipeline(num_threads=1))
+# CHECK: False
+print("async-parallel-for{num-workers=4}" in get_lowering_pipeline(
+    num_threads=4))
+# CHECK: True
+
+expected = MatmulReluSum()(x, y).numpy()
+for num_threads in [1, 4]:
+    backend = RefBackendLinalgOnTensorsBackend(num_threads=num_threads)
+    invoker = backend.load(backend.compile(Module.parse(asm, module.context)))
+    result = invoker.forward(x.numpy(), y.numpy())
+    status = "PASS" if np.allclose(result, expected, rtol=1e-5) else "FAIL"
+    print(f"num_threads={num_threads}: {status}")
+# CHECK: num_threads=1: PASS
+# CHECK: num_threads=4: PASS
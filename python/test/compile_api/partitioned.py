@@ -0,0 +1,69 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that a model with an op that runs in PyTorch is compiled around it,
+# and computes the same results as PyTorch.
+
+import torch
+
+from torch_mlir.partitioning import compile_partitioned
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class Model(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.linear = torch.nn.Linear(16, 8)
+    def forward(self, x):
+        y = torch.relu(self.linear(x))
+        y, _ = torch.sort(y, dim=1)
+        return torch.tanh(y) * 2.0
+
+torch.manual_seed(0)
+model = Model()
+x = torch.rand(4, 16)
+partitioned = compile_partitioned(model, [x],
+                                  RefBackendLinalgOnTensorsBackend(),
+                                  fallback_ops=["aten::sort"])
+print(partitioned.summary())
+# CHECK: compiled:
+# CHECK-NEXT: fallback: aten::sort
+# CHECK-NEXT: compiled:
+
+for shape in [(4, 16), (7, 16)]:
+    x = torch.rand(*shape)
+    ok = torch.allclose(partitioned(x), model(x), rtol=1e-5, atol=1e-5)
+    print(f"{shape}: {'PASS' if ok else 'FAIL'}")
+# CHECK: (4, 16): PASS
+# CHECK: (7, 16): PASS
+
+# The in-place update of the buffer, whose result isn't used, runs on every
+# call.
+class CountingModel(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.register_buffer("calls", torch.zeros(1))
+    def forward(self, x):
+        self.calls.add_(1.0)
+        return torch.tanh(x) * 2.0
+
+model = CountingModel()
+partitioned = compile_partitioned(model, [torch.rand(4, 16)],
+                                  RefBackendLinalgOnTensorsBackend())
+calls = partitioned.module.calls.item()
+for _ in range(3):
+    partitioned(torch.rand(4, 16))
+print(f"calls: {int(partitioned.module.calls.item() - calls)}")
+# CHECK: calls: 3
+
+# The results whose dtype the graph doesn't know take the one of the array,
+# bf16 for the raw bits of one.
+import numpy as np
+from torch_mlir.partitioning import _from_numpy
+
+print(_from_numpy(np.ones(2, np.float32), None).dtype,
+      _from_numpy(np.zeros(2, np.uint16), None).dtype)
+# CHECK: torch.float32 torch.bfloat16
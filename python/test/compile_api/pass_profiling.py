@@ -0,0 +1,37 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+import torch_mlir
+
+class TanhModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+    def forward(self, x):
+        return torch.ops.aten.tanh(x)
+
+module, report = torch_mlir.compile(TanhModule(), torch.ones(2, 3),
+                                    output_type=torch_mlir.OutputType.LINALG_ON_TENSORS,
+                                    profile=True)
+print(module)
+# CHECK-LABEL: @forward
+# CHECK: linalg.generic
+
+pipelines = sorted({profile.pipeline for profile in report.passes})
+print(pipelines)
+# CHECK: ['Lowering Torch Backend IR -> Linalg-on-Tensors Backend IR', 'Lowering TorchScript IR -> Torch Backend IR']
+
+# The nested passes run once per function.
+canonicalize = [profile for profile in report.passes if profile.name == "canonicalize"]
+print(len(canonicalize) > 0 and all(profile.runs >= 1 and profile.ops_before > 0 for profile in canonicalize))
+# CHECK: True
+print(report)
+# CHECK: time (s)
+# CHECK: Lowering TorchScript IR -> Torch Backend IR:
+# CHECK: symbol-dce
+# CHECK: total
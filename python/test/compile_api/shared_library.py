@@ -0,0 +1,55 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that a module exported to a shared library and loaded back computes
+# the same results as the JIT compiled module, including functions returning
+# several results of different types.
+
+import os
+import tempfile
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class MatmulArgmax(torch.nn.Module):
+    def forward(self, x, y):
+        z = torch.matmul(x, y) + 1.0
+        return z, torch.argmax(z, dim=1)
+
+x = torch.rand(5, 7)
+y = torch.rand(7, 3)
+module = torch_mlir.compile(MatmulArgmax(), [x, y],
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+backend = RefBackendLinalgOnTensorsBackend()
+compiled = backend.compile(module)
+jit_results = backend.load(compiled).forward(x.numpy(), y.numpy())
+
+with tempfile.TemporaryDirectory() as tmp_dir:
+    path = os.path.join(tmp_dir, "matmul_argmax.so")
+    backend.export_shared_library(compiled, path)
+    invoker = backend.load_shared_library(path)
+    print(type(invoker).__name__)
+    # CHECK: RefBackendSharedLibraryInvoker
+
+    results = invoker.forward(x.numpy(), y.numpy())
+    print([r.dtype for r in results])
+    # CHECK: [dtype('float32'), dtype('int64')]
+    expected = [r.numpy() for r in MatmulArgmax()(x, y)]
+    matches = all(
+        np.allclose(r, j) and np.allclose(r, e)
+        for r, j, e in zip(results, jit_results, expected))
+    print(f"shared library: {'PASS' if matches else 'FAIL'}")
+    # CHECK: shared library: PASS
+
+    # `load` also loads a library from its path.
+    results = backend.load(path).forward(x.numpy(), y.numpy())
+    matches = all(np.allclose(r, j) for r, j in zip(results, jit_results))
+    print(f"load path: {'PASS' if matches else 'FAIL'}")
+    # CHECK: load path: PASS
@@ -0,0 +1,73 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+import torch_mlir
+
+class TanhModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+    def forward(self, x):
+        return torch.ops.aten.tanh(x)
+
+dynamic_batch = torch_mlir.TensorPlaceholder([-1, 3], torch.float32)
+specializations = [torch.ones(1, 3), torch.ones(8, 3)]
+
+print(torch_mlir.compile(TanhModule(), dynamic_batch,
+                         specializations=specializations))
+# CHECK-LABEL: @forward(
+# CHECK: torch.aten.tanh %{{.*}} : !torch.vtensor<[?,3],f32> -> !torch.vtensor<[?,3],f32>
+# CHECK-LABEL: @forward_0(
+# CHECK: torch.aten.tanh %{{.*}} : !torch.vtensor<[1,3],f32> -> !torch.vtensor<[1,3],f32>
+# CHECK-LABEL: @forward_1(
+# CHECK: torch.aten.tanh %{{.*}} : !torch.vtensor<[8,3],f32> -> !torch.vtensor<[8,3],f32>
+
+print(torch_mlir.get_specialized_entry_point(specializations, torch.rand(8, 3)))
+# CHECK: forward_1
+print(torch_mlir.get_specialized_entry_point(specializations, torch.rand(5, 3)))
+# CHECK: forward
+print(torch_mlir.get_specialized_entry_point(specializations, torch.rand(1, 3).double()))
+# CHECK: forward
+
+# The other symbols of the specializations that collide are renamed, along
+# with their uses, except for the identical external declarations.
+from torch_mlir import _merge_specializations
+from torch_mlir.ir import Context, Module
+
+def parse(forward_body: str) -> Module:
+    return Module.parse(f"""
+func.func private @external(i32) -> i32
+func.func private @helper(%arg0: i32) -> i32 {{
+  {forward_body}
+}}
+func.func private @helper_0(%arg0: i32) -> i32 {{
+  return %arg0 : i32
+}}
+func.func @forward(%arg0: i32) -> i32 {{
+  %0 = call @helper(%arg0) : (i32) -> i32
+  %1 = call @helper_0(%0) : (i32) -> i32
+  return %1 : i32
+}}""", context=Context())
+
+print(_merge_specializations(
+    parse("%0 = call @external(%arg0) : (i32) -> i32\n  return %0 : i32"),
+    [parse("return %arg0 : i32")]))
+# CHECK-LABEL: func.func private @external(
+# CHECK-NOT: @external(
+# CHECK-LABEL: func.func private @helper(
+# CHECK: call @external
+# CHECK-LABEL: func.func private @helper_0(
+# CHECK-LABEL: func.func @forward(
+# CHECK: call @helper(
+# CHECK: call @helper_0(
+# CHECK-LABEL: func.func private @helper_1(
+# CHECK-NEXT: return %arg0
+# CHECK-LABEL: func.func private @helper_0_0(
+# CHECK-LABEL: func.func @forward_0(
+# CHECK: call @helper_1(
+# CHECK: call @helper_0_0(
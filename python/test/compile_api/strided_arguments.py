@@ -0,0 +1,55 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# Checks that the RefBackend computes the right results for transposed and
+# channels-last inputs, both when it reads them through their strides and when
+# the invoker makes them contiguous.
+
+import numpy as np
+import torch
+
+import torch_mlir
+from torch_mlir.ir import Module
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+class AddModule(torch.nn.Module):
+    def forward(self, x, y):
+        return x + 2 * y
+
+x = torch.rand(3, 4, 5, 6)
+y = torch.rand(3, 4, 5, 6)
+module = torch_mlir.compile(AddModule(), [x, y],
+                            output_type=torch_mlir.OutputType.LINALG_ON_TENSORS)
+asm = module.operation.get_asm()
+
+# The inputs share the memory of tensors with other layouts.
+inputs = [
+    ("transposed", x.transpose(0, 3).contiguous().transpose(0, 3),
+     y.transpose(1, 2).contiguous().transpose(1, 2)),
+    ("channels_last", x.contiguous(memory_format=torch.channels_last),
+     y.contiguous(memory_format=torch.channels_last)),
+    ("sliced", torch.rand(3, 4, 5, 12)[..., ::2], y),
+]
+
+for strided in [False, True]:
+    backend = RefBackendLinalgOnTensorsBackend(one_shot_bufferize=True,
+                                               strided_arguments=strided)
+    invoker = backend.load(
+        backend.compile(Module.parse(asm, module.context)))
+    for name, lhs, rhs in inputs:
+        assert not lhs.is_contiguous()
+        result = invoker.forward(lhs.numpy(), rhs.numpy())
+        expected = (lhs + 2 * rhs).numpy()
+        status = "PASS" if np.allclose(result, expected) else "FAIL"
+        print(f"strided={strided} {name}: {status}")
+
+# CHECK: strided=False transposed: PASS
+# CHECK: strided=False channels_last: PASS
+# CHECK: strided=False sliced: PASS
+# CHECK: strided=True transposed: PASS
+# CHECK: strided=True channels_last: PASS
+# CHECK: strided=True sliced: PASS
@@ -0,0 +1,37 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+import torch_mlir
+
+class LinearModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.fc = torch.nn.Linear(3, 2)
+    def forward(self, x):
+        return self.fc(x)
+
+torch.manual_seed(0)
+model = LinearModule()
+module = torch_mlir.compile(model, torch.ones(4, 3),
+                            weights_as_arguments=True)
+print(module)
+# CHECK-LABEL: @forward
+# CHECK-SAME: !torch.vtensor<[4,3],f32>
+# CHECK-SAME: !torch.vtensor<[2,3],f32> {torch.weight_name = "fc.weight"}
+# CHECK-SAME: !torch.vtensor<[2],f32> {torch.weight_name = "fc.bias"}
+# CHECK-NOT: torch.vtensor.literal
+
+# The weights of any model of the same architecture can be passed.
+fine_tuned = LinearModule()
+weights = torch_mlir.get_weight_arguments(module, fine_tuned)
+print([tuple(weight.shape) for weight in weights])
+print(all(torch.equal(weight, parameter)
+          for weight, parameter in zip(weights, fine_tuned.parameters())))
+# CHECK: [(2, 3), (2,)]
+# CHECK: True
@@ -0,0 +1,43 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+
+import torch
+
+from framework import run_test
+from torch_mlir.eager_mode import torch_mlir_tensor
+from torch_mlir.eager_mode.torch_mlir_dispatch import (
+    get_op_signature,
+    normalize_args_kwargs,
+)
+from torch_mlir.eager_mode.torch_mlir_tensor import (
+    TorchMLIRTensor,
+    async_compilation,
+    wait_for_compilations,
+)
+
+
+# CHECK: PASS - runs_through_pytorch_until_compiled
+@run_test
+def runs_through_pytorch_until_compiled():
+    a = torch.rand(3, 7)
+    b = torch.rand(3, 7)
+    x = TorchMLIRTensor(a)
+    y = TorchMLIRTensor(b)
+    target = torch.ops.aten.atan2.default
+    signature = get_op_signature(target, normalize_args_kwargs(target, (x, y), {}))
+    with async_compilation():
+        # The first call doesn't wait for the compilation it starts.
+        first = torch.atan2(x, y)
+        assert signature in torch_mlir_tensor.pending_compiles
+        wait_for_compilations()
+        second = torch.atan2(x, y)
+    assert signature not in torch_mlir_tensor.pending_compiles
+    assert signature in torch_mlir_tensor.compiled_ops
+    expected = torch.atan2(a, b)
+    assert torch.allclose(TorchMLIRTensor.unwrap(first), expected)
+    assert torch.allclose(TorchMLIRTensor.unwrap(second), expected)
@@ -0,0 +1,45 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+
+import torch
+
+from framework import run_test
+from torch_mlir.eager_mode import torch_mlir_tensor
+from torch_mlir.eager_mode.torch_mlir_tensor import TorchMLIRTensor, dynamic_shapes
+
+
+def compiled_kernels(op):
+    return [signature for signature in torch_mlir_tensor.compiled_ops if signature[0] is op]
+
+
+# CHECK: PASS - reuses_kernels_across_shapes
+@run_test
+def reuses_kernels_across_shapes():
+    with dynamic_shapes():
+        for batch in [2, 3, 5]:
+            a = torch.rand(batch, 6)
+            b = torch.rand(6, 4)
+            x = TorchMLIRTensor(a)
+            y = TorchMLIRTensor(b)
+            z = torch.mm(torch.tanh(x), y).sum(1)
+            assert z.shape == (batch,)
+            assert torch.allclose(TorchMLIRTensor.unwrap(z), torch.mm(torch.tanh(a), b).sum(1))
+    assert len(compiled_kernels(torch.ops.aten.tanh.default)) == 1
+    assert len(compiled_kernels(torch.ops.aten.mm.default)) == 1
+    assert len(compiled_kernels(torch.ops.aten.sum.dim_IntList)) == 1
+
+
+# CHECK: PASS - keeps_broadcast_sizes_static
+@run_test
+def keeps_broadcast_sizes_static():
+    with dynamic_shapes():
+        a = torch.rand(4, 3)
+        for b in [torch.rand(4, 3), torch.rand(1, 3), torch.rand(7, 3)[:4]]:
+            result = TorchMLIRTensor.unwrap(TorchMLIRTensor(a) * TorchMLIRTensor(b))
+            assert torch.allclose(result, a * b)
+    assert len(compiled_kernels(torch.ops.aten.mul.Tensor)) == 2
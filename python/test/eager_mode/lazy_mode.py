@@ -0,0 +1,54 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+
+import torch
+
+from framework import run_test
+from torch_mlir.eager_mode import torch_mlir_tensor
+from torch_mlir.eager_mode.lazy_graph import LazyValue
+from torch_mlir.eager_mode.torch_mlir_tensor import TorchMLIRTensor, lazy_mode
+
+
+# CHECK: PASS - records_until_observed
+@run_test
+def records_until_observed():
+    a = torch.rand(3, 4)
+    b = torch.rand(3, 4)
+    with lazy_mode():
+        x = TorchMLIRTensor(a)
+        y = TorchMLIRTensor(b)
+        z = torch.tanh(x * y + x)
+        assert isinstance(z._elem, LazyValue)
+        assert len(torch_mlir_tensor._pending_graph.nodes) == 3
+        assert z.shape == (3, 4) and z.dtype == torch.float32
+        result = TorchMLIRTensor.unwrap(z)
+        assert not torch_mlir_tensor._pending_graph.nodes
+    assert torch.allclose(result, torch.tanh(a * b + a))
+
+
+# CHECK: PASS - flushes_on_exit
+@run_test
+def flushes_on_exit():
+    a = torch.rand(2, 5)
+    with lazy_mode():
+        x = TorchMLIRTensor(a)
+        y = torch.relu(x - 0.5)
+    assert y._elem.result is not None
+    assert torch.allclose(TorchMLIRTensor.unwrap(y), torch.relu(a - 0.5))
+
+
+# CHECK: PASS - flushes_before_in_place_ops
+@run_test
+def flushes_before_in_place_ops():
+    a = torch.rand(4)
+    with lazy_mode():
+        x = TorchMLIRTensor(a)
+        y = x * 2
+        x.add_(1)
+        result = TorchMLIRTensor.unwrap(y)
+    assert torch.allclose(result, a * 2)
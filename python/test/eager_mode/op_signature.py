@@ -0,0 +1,51 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+
+import torch
+
+from framework import run_test
+from torch_mlir.eager_mode.torch_mlir_dispatch import (
+    get_op_signature,
+    normalize_args_kwargs,
+)
+
+
+def signature(target, *args, **kwargs):
+    return get_op_signature(target, normalize_args_kwargs(target, args, kwargs))
+
+
+# CHECK: PASS - same_dtypes_and_shapes
+@run_test
+def same_dtypes_and_shapes():
+    target = torch.ops.aten.add.Tensor
+    assert signature(target, torch.ones(2, 3), torch.zeros(2, 3)) == signature(
+        target, torch.rand(2, 3), torch.rand(2, 3)
+    )
+
+
+# CHECK: PASS - different_shapes_dtypes_and_overloads
+@run_test
+def different_shapes_dtypes_and_overloads():
+    a = torch.rand(2, 3)
+    key = signature(torch.ops.aten.add.Tensor, a, a)
+    assert key != signature(torch.ops.aten.add.Tensor, a, torch.rand(1, 3))
+    assert key != signature(torch.ops.aten.add.Tensor, a, a.double())
+    assert key != signature(torch.ops.aten.sub.Tensor, a, a)
+
+
+# CHECK: PASS - different_scalars
+@run_test
+def different_scalars():
+    target = torch.ops.aten.add.Tensor
+    a = torch.rand(2, 3)
+    assert signature(target, a, a, alpha=2) != signature(target, a, a, alpha=3)
+    # Equal scalars of different types are imported as different constants.
+    assert signature(target, a, a, alpha=1) != signature(target, a, a, alpha=1.0)
+    target = torch.ops.aten.max_pool2d_with_indices.default
+    a = torch.rand(1, 3, 8, 8)
+    assert signature(target, a, [3, 3]) != signature(target, a, [2, 2])
@@ -0,0 +1,95 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+from torch_mlir_e2e_test.torchscript.benchmarking import report_benchmarks, run_benchmarks
+from torch_mlir_e2e_test.torchscript.annotations import annotate_args, export
+from torch_mlir_e2e_test.torchscript.framework import Test, TestUtils
+from torch_mlir_e2e_test.torchscript.registry import register_test_case, GLOBAL_TEST_REGISTRY
+from torch_mlir_e2e_test.torchscript.configs import LinalgOnTensorsBackendTestConfig, NativeTorchTestConfig, TorchScriptTestConfig
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+
+class MmModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, lhs, rhs):
+        return torch.mm(lhs, rhs)
+
+
+@register_test_case(module_factory=lambda: MmModule())
+def MmModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(4, 4), tu.rand(4, 4))
+
+
+class FailingModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x):
+        return torch.mm(x, x)
+
+
+@register_test_case(module_factory=lambda: FailingModule())
+def FailingModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(4, 4))
+    module.forward(tu.rand(2, 3))
+
+
+class AnnotatedMmModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([4, 4], torch.float32, True),
+        ([4, 4], torch.float32, True),
+    ])
+    def forward(self, lhs, rhs):
+        return torch.mm(lhs, rhs)
+
+
+class CountingBackend(RefBackendLinalgOnTensorsBackend):
+    """Counts the loads of the compiled artifacts."""
+    loads = 0
+
+    def load(self, module):
+        CountingBackend.loads += 1
+        return super().load(module)
+
+
+def main():
+    results = run_benchmarks(GLOBAL_TEST_REGISTRY, TorchScriptTestConfig(),
+                             NativeTorchTestConfig(), iterations=3,
+                             warmup_iterations=1)
+    mm_result = next(result for result in results if result.unique_name == "MmModule_basic")
+    assert len(mm_result.latencies) == 3 and len(mm_result.baseline_latencies) == 3
+    report_benchmarks(results)
+
+    # The artifact is loaded once, outside of the timed runs.
+    mm_test = Test(unique_name="AnnotatedMmModule_basic",
+                   program_factory=AnnotatedMmModule,
+                   program_invoker=lambda module, tu: module.forward(
+                       tu.rand(4, 4), tu.rand(4, 4)))
+    results = run_benchmarks([mm_test],
+                             LinalgOnTensorsBackendTestConfig(CountingBackend()),
+                             NativeTorchTestConfig(), iterations=3,
+                             warmup_iterations=1)
+    assert results[0].error is None and len(results[0].latencies) == 3
+    print(f"loads: {CountingBackend.loads}")
+
+
+# CHECK: p50 (ms)
+# CHECK: x  MmModule_basic
+# CHECK: FAIL  FailingModule_basic
+# CHECK: Geometric mean speedup over 1 tests
+# CHECK: loads: 1
+if __name__ == '__main__':
+    main()
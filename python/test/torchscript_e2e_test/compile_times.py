@@ -0,0 +1,55 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+from torch_mlir_e2e_test.torchscript.annotations import annotate_args, export
+from torch_mlir_e2e_test.torchscript.framework import run_tests, TestUtils
+from torch_mlir_e2e_test.torchscript.registry import register_test_case, GLOBAL_TEST_REGISTRY
+from torch_mlir_e2e_test.torchscript.configs import LinalgOnTensorsBackendTestConfig
+from torch_mlir_e2e_test.linalg_on_tensors_backends.refbackend import RefBackendLinalgOnTensorsBackend
+
+
+class MmModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, lhs, rhs):
+        return torch.mm(lhs, rhs)
+
+
+@register_test_case(module_factory=lambda: MmModule())
+def MmModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(4, 4), tu.rand(4, 4))
+
+
+def main():
+    config = LinalgOnTensorsBackendTestConfig(RefBackendLinalgOnTensorsBackend())
+    results = run_tests(GLOBAL_TEST_REGISTRY, config, sequential=True,
+                        record_compile_times=True)
+    for phase in sorted(results[0].compile_times):
+        if "/" not in phase:
+            print(phase)
+    print(any(phase.startswith("torch-backend-pipeline/") for phase in results[0].compile_times))
+    print(run_tests(GLOBAL_TEST_REGISTRY, config, sequential=True)[0].compile_times)
+
+
+# CHECK: backend-compile
+# CHECK-NEXT: backend-load
+# CHECK-NEXT: import
+# CHECK-NEXT: linalg-on-tensors-backend-pipeline
+# CHECK-NEXT: torch-backend-pipeline
+# CHECK-NEXT: True
+# CHECK-NEXT: None
+if __name__ == '__main__':
+    main()
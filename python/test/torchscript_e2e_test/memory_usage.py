@@ -0,0 +1,51 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import tracemalloc
+
+import torch
+
+from torch_mlir_e2e_test.torchscript.framework import run_tests, TestUtils
+from torch_mlir_e2e_test.torchscript.registry import register_test_case, GLOBAL_TEST_REGISTRY
+from torch_mlir_e2e_test.torchscript.configs import TorchScriptTestConfig
+
+
+class LargeModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x):
+        # 64 MiB of float32.
+        return torch.ones(4096, 4096) + x
+
+
+@register_test_case(module_factory=lambda: LargeModule())
+def LargeModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(4096))
+
+
+def main():
+    config = TorchScriptTestConfig()
+    result = run_tests(GLOBAL_TEST_REGISTRY, config, sequential=True,
+                       record_memory_usage=True)[0]
+    print(sorted(result.memory_usage))
+    print(result.memory_usage["run_peak_rss"] >= 64 * 2**20)
+    print(run_tests(GLOBAL_TEST_REGISTRY, config, sequential=True)[0].memory_usage)
+    # Tracing started by the caller is left running.
+    tracemalloc.start()
+    run_tests(GLOBAL_TEST_REGISTRY, config, sequential=True,
+              record_memory_usage=True)
+    print(tracemalloc.is_tracing())
+    tracemalloc.stop()
+
+
+# CHECK: ['compile_peak_allocated', 'compile_peak_rss', 'run_peak_allocated', 'run_peak_rss']
+# CHECK-NEXT: True
+# CHECK-NEXT: None
+# CHECK-NEXT: True
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,54 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import os
+
+import torch
+
+from torch_mlir_e2e_test.torchscript.framework import run_tests, TestUtils
+from torch_mlir_e2e_test.torchscript.reporting import report_results
+from torch_mlir_e2e_test.torchscript.registry import register_test_case, GLOBAL_TEST_REGISTRY
+from torch_mlir_e2e_test.torchscript.configs import TorchScriptTestConfig
+
+
+class MmModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, lhs, rhs):
+        return torch.mm(lhs, rhs)
+
+
+# CHECK: PASS - "MmModule_basic"
+@register_test_case(module_factory=lambda: MmModule())
+def MmModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(4, 4), tu.rand(4, 4))
+
+
+# The worker running the test exits without sending its result, and the
+# other tests still run in the remaining workers.
+# CHECK: FAIL - "MmModule_crash"
+# CHECK:     Runtime error: Testing process terminated.
+@register_test_case(module_factory=lambda: MmModule())
+def MmModule_crash(module, tu: TestUtils):
+    os._exit(1)
+
+
+# CHECK: PASS - "MmModule_large"
+@register_test_case(module_factory=lambda: MmModule())
+def MmModule_large(module, tu: TestUtils):
+    module.forward(tu.rand(256, 256), tu.rand(256, 256))
+
+
+def main():
+    config = TorchScriptTestConfig()
+    results = run_tests(GLOBAL_TEST_REGISTRY, config)
+    report_results(results, set(), verbose=True)
+
+
+if __name__ == '__main__':
+    main()
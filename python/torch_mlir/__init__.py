@@ -3,13 +3,25 @@
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 # Also available under a BSD-style license. See LICENSE.
 
-from typing import Sequence, Union, List
+from concurrent.futures import Future, ThreadPoolExecutor
+from typing import Any, Optional, Sequence, Tuple, Union, List
 from enum import Enum
+import os
+import threading
 
 import torch
 
+from torch_mlir.ir import ArrayAttr, DictAttr, IntegerAttr, IntegerType
+from torch_mlir.ir import Module, StringAttr, SymbolTable
 from torch_mlir.passmanager import PassManager
+from .compilation_cache import ImportCache, get_compilation_cache
 from .compiler_utils import run_pipeline_with_repro_report
+from .compiler_utils import CompileReport, PassProfile
+from .compiler_utils import get_torch_backend_pipeline
+from .compiler_utils import LINALG_ON_TENSORS_BACKEND_LEGAL_OPS
+from .compiler_utils import TOSA_BACKEND_LEGAL_OPS
+from .custom_kernels import get_custom_kernels_version
+from .custom_kernels import prepare_custom_kernels
 from torch_mlir.dialects.torch.importer.jit_ir import ClassAnnotator, ModuleBuilder
 
 
@@ -50,27 +62,54 @@ class TensorPlaceholder:
     placeholder = TensorPlaceholder.like(torch.ones(3, 4), dynamic_axes=[1])
     # Equivalent to `TensorPlaceholder([3, -1], torch.float32)`
     ```
+
+    A placeholder with dynamic axes can also have an expected shape, which
+    the compiled module has a fully static version of the function for:
+    ```python
+    placeholder = TensorPlaceholder.like(torch.ones(3, 4), dynamic_axes=[1],
+                                         specialize=True)
+    # Equivalent to `TensorPlaceholder([3, -1], torch.float32,
+    #                                  expected_shape=[3, 4])`
+    ```
     """
 
-    def __init__(self, shape: List[int], dtype: torch.dtype):
+    def __init__(self,
+                 shape: List[int],
+                 dtype: torch.dtype,
+                 expected_shape: Optional[List[int]] = None):
         """Create a tensor with shape `shape` and dtype `dtype`.
 
         Args:
             shape: The shape of the tensor. A size of `-1` indicates that the
             dimension has an unknown size.
             dtype: The dtype of the tensor.
+            expected_shape: The shape the tensor is expected to have most of
+            the time, with the sizes of `shape` that are not `-1`. The
+            compiled function then checks the sizes of the arguments on
+            entry, and runs a version specialized to the expected shapes if
+            they have them.
         """
+        if expected_shape is not None:
+            assert len(expected_shape) == len(shape) and all(
+                size in (-1, expected_size)
+                for size, expected_size in zip(shape, expected_shape)), \
+                "The expected shape must have the sizes of the shape"
         self.shape = shape
         self.dtype = dtype
+        self.expected_shape = expected_shape
 
     @staticmethod
-    def like(tensor: torch.Tensor, dynamic_axes: List[int] = None):
+    def like(tensor: torch.Tensor,
+             dynamic_axes: List[int] = None,
+             specialize: bool = False):
         """Create a tensor placeholder that is like the given tensor.
 
         Args:
             tensor: The tensor to create a placeholder for.
             dynamic_axes: A list of dynamic axes. If specified, the compiled
             module will allow those axes to be any size at runtime.
+            specialize: Whether the shape of `tensor` is the expected shape
+            of the placeholder.
         """
         if dynamic_axes is None:
             dynamic_axes = []
@@ -80,7 +119,8 @@ class TensorPlaceholder:
                 shape.append(-1)
             else:
                 shape.append(dim)
-        return TensorPlaceholder(shape, tensor.dtype)
+        expected_shape = list(tensor.shape) if specialize else None
+        return TensorPlaceholder(shape, tensor.dtype, expected_shape)
 
 
 _example_arg = Union[TensorPlaceholder, torch.Tensor]
@@ -89,9 +129,23 @@ _example_arg = Union[TensorPlaceholder, torch.Tensor]
 def compile(model: torch.nn.Module,
             example_args: Union[_example_arg, Sequence[_example_arg]],
             output_type: OutputType = OutputType.TORCH,
-            use_tracing=False):
+            use_tracing=False,
+            backend_legal_ops: Optional[Sequence[str]] = None,
+            inference: bool = False,
+            auto_cast_dtype: Optional[str] = None,
+            cache_dir: Optional[str] = None,
+            specializations: Sequence[Union[_example_arg,
+                                            Sequence[_example_arg]]] = (),
+            profile: bool = False,
+            weights_as_arguments: bool = False,
+            external_weights_file: Optional[str] = None):
     """Convert a PyTorch model to MLIR.
 
+    Converting a model again in the same process, with its code, its weights
+    and the arguments of `compile` unchanged, reuses the previous result
+    instead of importing and lowering the model again. A weight updated in
+    place, e.g. by an optimizer step, invalidates the result.
+
     Args:
         model: The PyTorch model to convert.
         example_args: A list of example arguments to use when inferring the
@@ -103,24 +157,177 @@ def compile(model: torch.nn.Module,
             details.
         use_tracing: If True, use `torch.jit.trace` to convert the model to
             JIT IR rather than `torch.jit.script`.
+        backend_legal_ops: Names of ops (e.g. "torch.aten.matmul") that must
+            not be decomposed, because the backend consuming the output has
+            its own lowering for them. Defaults to the ops handled natively
+            by the backend of `output_type`, if any.
+        inference: If True, compile the model for inference only: dropout is
+            removed and batch norms use their running stats, even if the
+            model is in training mode or its training flag is not a
+            constant.
+        auto_cast_dtype: If "bf16" or "f16", the matmuls and convolutions of
+            float32 tensors are computed in that type, with their products
+            accumulated in float32. All the other ops stay in float32.
+        cache_dir: The directory of an on-disk cache of the converted modules,
+            keyed by the imported module, the pipelines and the torch-mlir
+            build. Converting a model a second time then only imports it.
+            Defaults to the `TORCH_MLIR_COMPILATION_CACHE_DIR` environment
+            variable, and no cache if that isn't set either.
+        specializations: More sets of example arguments, each like
+            `example_args`. For the i-th of them, the module also contains a
+            `forward_<i>` function, specialized to their shapes and dtypes.
+            This gives fully static code for the common shapes, e.g. a few
+            batch sizes, next to a `forward` whose `example_args` have
+            dynamic axes to serve the other shapes. Use
+            `get_specialized_entry_point` to pick the function to call.
+        profile: If True, profile the passes of the pipelines, and return a
+            `CompileReport` of the time each pass took and of the numbers of
+            operations before and after it, next to the module.
+        weights_as_arguments: If True, the weights of the model, i.e. its
+            parameters and buffers that `forward` never updates, are not
+            embedded in the module but passed as trailing arguments of
+            `forward`, so that a single compiled module serves every
+            fine-tuned variant of the model. `get_weight_arguments` gives
+            the arguments to pass for a given variant.
+        external_weights_file: If given, the weights of the model are written
+            to this file, each aligned to a page boundary, and the module
+            only refers to them with `torch.vtensor.external_literal` ops,
+            or `torch_c.external_literal` ops at the linalg-on-tensors
+            backend contract. The module is then quick to print and parse
+            regardless of the size of the model, e.g. to hand it over to
+            another stage of a build along with the file. Tensors smaller
+            than 1 KiB stay in the module. The in-process and on-disk caches
+            of converted modules are not used, since the file could change
+            after a module referring to it is cached. This is the only way
+            to keep the weights out of the MLIRContext: the RefBackend reads
+            them from the file when it loads the compiled module, while the
+            weights of the models compiled without it, and those lowered to
+            TOSA, are attributes living as long as the context.
 
     Returns:
         An MLIR module that contains the converted model in the specified
-        output type.
+        output type, and its `CompileReport` if `profile` is True.
+    """
+
+    if specializations and output_type == OutputType.RAW:
+        raise Exception("Specializations are not supported with OutputType.RAW")
+
+    report = CompileReport() if profile else None
+    pipelines = []
+    if output_type != OutputType.RAW:
+        pipelines = _get_pipelines(output_type, backend_legal_ops, inference,
+                                   auto_cast_dtype, weights_as_arguments)
+
+    scripted = None
+    if not use_tracing:
+        with _import_lock:
+            scripted = torch.jit.script(model)
+    cache = None
+    if external_weights_file is None:
+        cache = get_compilation_cache(cache_dir)
+    # Each specialization imports the same weights to the same offsets of
+    # `external_weights_file`, so the file stays valid for all of them.
+    modules = [
+        _compile_module(model, scripted, args, output_type, pipelines, cache,
+                        report, external_weights_file)
+        for args in [example_args, *specializations]
+    ]
+    module = modules[0]
+    if specializations:
+        module = _merge_specializations(module, modules[1:])
+    return (module, report) if profile else module
+
+
+class CompilationService:
+    """Compiles many models concurrently.
+
+    Each model is compiled by `compile` in a context of its own, on one of
+    `max_workers` threads, which defaults to the number of cores. The pass
+    pipelines run without holding the GIL, and all the contexts run their
+    parallel work on a thread pool shared by the process, so compiling many
+    models at once keeps the cores busy without oversubscribing them. The
+    models are scripted, traced and imported one at a time.
     """
 
+    def __init__(self, max_workers: Optional[int] = None):
+        self.executor = ThreadPoolExecutor(
+            max_workers or os.cpu_count(),
+            thread_name_prefix="torch_mlir_compile")
+
+    def submit(self, model: torch.nn.Module,
+               example_args: Union[_example_arg, Sequence[_example_arg]],
+               **kwargs) -> Future:
+        """Starts compiling `model` with `compile`, with the same arguments,
+        and returns the future of its result."""
+        return self.executor.submit(compile, model, example_args, **kwargs)
+
+    def compile_all(self, models: Sequence[Tuple[torch.nn.Module, Any]],
+                    **kwargs) -> list:
+        """Compiles each of the `(model, example_args)` of `models` with the
+        same other arguments, and returns their results in order."""
+        futures = [self.submit(model, example_args, **kwargs)
+                   for model, example_args in models]
+        return [future.result() for future in futures]
+
+    def shutdown(self, wait: bool = True):
+        """Stops accepting models, and waits for the submitted ones to be
+        compiled if `wait` is True."""
+        self.executor.shutdown(wait)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.shutdown()
+
+
+_compilation_service: Optional[CompilationService] = None
+_compilation_service_lock = threading.Lock()
+
+
+def get_compilation_service() -> CompilationService:
+    """Returns the `CompilationService` of the process, with a thread per
+    core, created on first use."""
+    global _compilation_service
+    with _compilation_service_lock:
+        if _compilation_service is None:
+            _compilation_service = CompilationService()
+        return _compilation_service
+
+
+def _get_pipelines(output_type: OutputType,
+                   backend_legal_ops: Optional[Sequence[str]],
+                   inference: bool, auto_cast_dtype: Optional[str],
+                   weights_as_arguments: bool):
+    """Returns the pipelines lowering an imported module to `output_type`,
+    with their descriptions."""
+    if backend_legal_ops is None:
+        backend_legal_ops = []
+        if output_type == OutputType.LINALG_ON_TENSORS:
+            backend_legal_ops = LINALG_ON_TENSORS_BACKEND_LEGAL_OPS
+        elif output_type == OutputType.TOSA:
+            backend_legal_ops = TOSA_BACKEND_LEGAL_OPS
+    pipelines = [(get_torch_backend_pipeline(backend_legal_ops, inference,
+                                             auto_cast_dtype,
+                                             weights_as_arguments),
+                  "Lowering TorchScript IR -> Torch Backend IR")]
+    if output_type == OutputType.TOSA:
+        pipelines.append(("torch-backend-to-tosa-backend-pipeline",
+                          "Lowering Torch Backend IR -> TOSA Backend IR"))
+    elif output_type == OutputType.LINALG_ON_TENSORS:
+        pipelines.append(
+            ("torch-backend-to-linalg-on-tensors-backend-pipeline",
+             "Lowering Torch Backend IR -> Linalg-on-Tensors Backend IR"))
+    elif output_type != OutputType.TORCH:
+        raise Exception(f"Unknown OutputType: {output_type}")
+    return pipelines
+
+
+def _to_placeholders(example_args) -> List[TensorPlaceholder]:
     # Special case -- many models have just one input, so canonicalize a single
     # tensor to a list of a single tensor to make the API more ergonomic.
     if isinstance(example_args, (torch.Tensor, TensorPlaceholder)):
         example_args = (example_args,)
-
-    # TODO: Don't hardcode "forward". See `torch.onnx.export` and
-    # `torch.jit.trace_module` for API inspiration.
-    if use_tracing:
-        scripted = torch.jit.trace(model, tuple(example_args))
-    else:
-        scripted = torch.jit.script(model)
-
     # Convert all concrete inputs to TensorPlaceholder's, for consistency.
     arg_placeholders = []
     for arg in example_args:
@@ -129,42 +336,244 @@ def compile(model: torch.nn.Module,
         else:
             assert isinstance(arg, torch.Tensor)
             arg_placeholders.append(TensorPlaceholder.like(arg))
+    return arg_placeholders
+
+
+# The modules compiled in this process, so that compiling a model again, with
+# unchanged code, weights and arguments, is only a parse of the result.
+_import_cache = ImportCache()
+
+# Held while scripting, tracing or importing a model, which isn't safe to do
+# on several threads at once. The pipelines lowering the imported modules run
+# concurrently.
+_import_lock = threading.Lock()
 
-    class_annotator = ClassAnnotator()
-    forward_annotation = [None]
-    for arg in arg_placeholders:
-        # Assume that all tensors have value semantics for now.
-        forward_annotation.append((arg.shape, arg.dtype, True))
-    class_annotator.exportNone(scripted._c._type())
-    class_annotator.exportPath(scripted._c._type(), ["forward"])
-    class_annotator.annotateArgs(
-        scripted._c._type(), ["forward"], forward_annotation)
 
-    mb = ModuleBuilder()
-    mb.import_module(scripted._c, class_annotator)
+def _compile_module(model: torch.nn.Module,
+                    scripted: Optional[torch.jit.ScriptModule],
+                    example_args, output_type: OutputType, pipelines, cache,
+                    report: Optional[CompileReport],
+                    external_weights_file: Optional[str] = None) -> Module:
+    """Imports `model`, with `forward` annotated with the shapes and dtypes of
+    `example_args`, and runs `pipelines`, lowering it to `output_type`, on
+    it. The model is traced on `example_args` if `scripted` is None.
 
+    The result of a previous compile of the same TorchScript module in this
+    process is reused, unless the passes are profiled into `report`, the
+    weights are written to `external_weights_file` or the module is only
+    imported.
+    """
+    if isinstance(example_args, (torch.Tensor, TensorPlaceholder)):
+        example_args = (example_args,)
+
+    # TODO: Don't hardcode "forward". See `torch.onnx.export` and
+    # `torch.jit.trace_module` for API inspiration.
+    if scripted is None:
+        with _import_lock:
+            scripted = torch.jit.trace(model, tuple(example_args))
+
+    placeholders = _to_placeholders(example_args)
+    # The class annotator and the fingerprint read the types of the
+    # TorchScript module, like the importer, so they are under the lock too.
+    with _import_lock:
+        class_annotator = ClassAnnotator()
+        forward_annotation = [None]
+        for arg in placeholders:
+            # Assume that all tensors have value semantics for now.
+            forward_annotation.append((arg.shape, arg.dtype, True))
+        class_annotator.exportNone(scripted._c._type())
+        class_annotator.exportPath(scripted._c._type(), ["forward"])
+        class_annotator.annotateArgs(
+            scripted._c._type(), ["forward"], forward_annotation)
+
+        key = None
+        # The raw imports aren't cached, as they also have the functions that
+        # the fingerprint leaves out.
+        if (report is None and external_weights_file is None and
+                pipelines):
+            fingerprint, tensors = ModuleBuilder.get_import_fingerprint(
+                scripted._c, class_annotator)
+            if fingerprint is not None:
+                key = (fingerprint,
+                       repr([placeholder.expected_shape
+                             for placeholder in placeholders]),
+                       output_type.name,
+                       tuple(pipeline for pipeline, _ in pipelines),
+                       # The registered kernels change the imported module.
+                       get_custom_kernels_version())
+                cached = _import_cache.load(key, tensors)
+                if cached is not None:
+                    # Parsed in a new context with the dialects registered,
+                    # like the imported modules.
+                    return Module.parse(cached,
+                                        context=ModuleBuilder().context)
+
+        mb = ModuleBuilder()
+        mb.import_module(scripted._c, class_annotator,
+                         externalWeightsFile=external_weights_file)
+        # Scripts the shape functions of the custom kernels.
+        prepare_custom_kernels(mb.module)
+    _annotate_expected_shapes(mb.module, placeholders)
+    module = _lower_module(mb.module, output_type, pipelines, cache, report)
+    if key is not None:
+        _import_cache.store(key, tensors, module.operation.get_asm())
+    return module
+
+
+def _annotate_expected_shapes(module: Module,
+                              placeholders: List[TensorPlaceholder]):
+    """Adds a `torch.expected_shape` attribute to the arguments of the
+    imported `forward` whose placeholders have an expected shape."""
+    if all(placeholder.expected_shape is None for placeholder in placeholders):
+        return
+    with module.context:
+        i64 = IntegerType.get_signless(64)
+        for op in module.body.operations:
+            # The imported `forward` is the function whose arguments, after
+            # `self`, have the type bounds of the annotation.
+            if "arg_attrs" not in op.attributes:
+                continue
+            arg_attrs = [DictAttr(attrs)
+                         for attrs in ArrayAttr(op.attributes["arg_attrs"])]
+            if not any("torch.type_bound" in attrs for attrs in arg_attrs):
+                continue
+            new_arg_attrs = [arg_attrs[0]]
+            for attrs, placeholder in zip(arg_attrs[1:], placeholders):
+                named_attrs = {attrs[i].name: attrs[i].attr
+                               for i in range(len(attrs))}
+                if placeholder.expected_shape is not None:
+                    named_attrs["torch.expected_shape"] = ArrayAttr.get([
+                        IntegerAttr.get(i64, size)
+                        for size in placeholder.expected_shape
+                    ])
+                new_arg_attrs.append(DictAttr.get(named_attrs))
+            op.attributes["arg_attrs"] = ArrayAttr.get(new_arg_attrs)
+            return
+
+
+def _lower_module(module: Module, output_type: OutputType, pipelines, cache,
+                  report: Optional[CompileReport]) -> Module:
+    """Runs `pipelines`, lowering `module` to `output_type`, on it, or loads
+    the result from `cache`.
+
+    The passes that run are profiled into `report`, if given. The raw output
+    of the importer is not cached, since there is nothing to reuse.
+    """
     if output_type == OutputType.RAW:
-        return mb.module
+        cache = None
+    if cache is not None:
+        key = cache.get_key(module.operation.get_asm(), output_type.name,
+                            *[pipeline for pipeline, _ in pipelines])
+        cached = cache.load(key, ".mlir")
+        if cached is not None:
+            return Module.parse(cached.decode(), context=module.context)
 
-    run_pipeline_with_repro_report(mb.module,
-                                   "torchscript-module-to-torch-backend-pipeline",
-                                   "Lowering TorchScript IR -> Torch Backend IR")
+    for pipeline, description in pipelines:
+        run_pipeline_with_repro_report(module, pipeline, description, report)
 
-    if output_type == OutputType.TORCH:
-        return mb.module
+    if cache is not None:
+        cache.store(key, ".mlir", module.operation.get_asm().encode())
+    return module
 
-    if output_type == OutputType.TOSA:
-        run_pipeline_with_repro_report(
-            mb.module,
-            "torch-backend-to-tosa-backend-pipeline",
-            "Lowering Torch Backend IR -> TOSA Backend IR")
-        return mb.module
-
-    if output_type == OutputType.LINALG_ON_TENSORS:
-        run_pipeline_with_repro_report(
-            mb.module,
-            "torch-backend-to-linalg-on-tensors-backend-pipeline",
-            "Lowering Torch Backend IR -> Linalg-on-Tensors Backend IR")
-        return mb.module
-
-    raise Exception(f"Unknown OutputType: {output_type}")
+
+def _merge_specializations(module: Module,
+                           specialized_modules: List[Module]) -> Module:
+    """Returns `module` with the functions of each of `specialized_modules`
+    added, where the `forward` of the i-th of them is renamed to
+    `forward_<i>`.
+
+    The other symbols of the specialized modules whose names `module` already
+    has are renamed to names that neither module has, except for the external
+    function declarations identical to those of `module`, which are shared.
+    """
+    symbol_table = SymbolTable(module.operation)
+    with module.context:
+        for i, specialized in enumerate(specialized_modules):
+            # The modules don't share a context, so the functions are
+            # parsed again in the one of `module`.
+            specialized = Module.parse(str(specialized.operation))
+            specialized_symbol_table = SymbolTable(specialized.operation)
+
+            def rename(op, name: str, new_name: str):
+                SymbolTable.set_symbol_name(op, new_name)
+                SymbolTable.replace_all_symbol_uses(name, new_name,
+                                                    specialized.operation)
+
+            for op in list(specialized.body.operations):
+                name = StringAttr(SymbolTable.get_symbol_name(op)).value
+                if name == "forward":
+                    assert f"forward_{i}" not in symbol_table
+                    rename(op, name, f"forward_{i}")
+                    continue
+                if name not in symbol_table:
+                    continue
+                if _is_external_function(op) and \
+                        str(op) == str(symbol_table[name]):
+                    op.operation.erase()
+                    continue
+                unique = 0
+                while (f"{name}_{unique}" in symbol_table or
+                       f"{name}_{unique}" in specialized_symbol_table):
+                    unique += 1
+                rename(op, name, f"{name}_{unique}")
+            for op in list(specialized.body.operations):
+                op.operation.detach_from_parent()
+                symbol_table.insert(op)
+    return module
+
+
+def _is_external_function(op) -> bool:
+    return op.operation.name == "func.func" and \
+        len(op.regions[0].blocks) == 0
+
+
+def get_specialized_entry_point(
+        specializations: Sequence[Union[_example_arg, Sequence[_example_arg]]],
+        args: Union[torch.Tensor, Sequence[torch.Tensor]]) -> str:
+    """Returns the function to call on `args` in a module compiled with
+    `specializations`.
+
+    This is `forward_<i>` for the first of the specializations whose shapes
+    and dtypes `args` have, where an axis of size `-1` matches any size, and
+    `forward` if there is none.
+    """
+    if isinstance(args, torch.Tensor):
+        args = (args,)
+    for i, specialization in enumerate(specializations):
+        placeholders = _to_placeholders(specialization)
+        if len(placeholders) == len(args) and all(
+                placeholder.dtype == arg.dtype
+                and len(placeholder.shape) == arg.dim() and all(
+                    size == -1 or size == arg_size
+                    for size, arg_size in zip(placeholder.shape, arg.shape))
+                for placeholder, arg in zip(placeholders, args)):
+            return f"forward_{i}"
+    return "forward"
+
+
+def get_weight_arguments(module: Module,
+                         model: torch.nn.Module,
+                         function: str = "forward") -> List[torch.Tensor]:
+    """Returns the tensors of `model` to pass as the weight arguments of
+    `function` in a module compiled with `weights_as_arguments`.
+
+    `model` can be any model with the architecture of the compiled one, e.g.
+    a fine-tuned variant of it. The weight arguments are the trailing
+    arguments of `function` that have a `torch.weight_name` attribute, which
+    is the name of the tensor in `model.state_dict()`.
+    """
+    state_dict = model.state_dict()
+    with module.context:
+        for op in module.body.operations:
+            if StringAttr(op.attributes["sym_name"]).value != function:
+                continue
+            if "arg_attrs" not in op.attributes:
+                return []
+            names = []
+            for arg_attrs in ArrayAttr(op.attributes["arg_attrs"]):
+                arg_attrs = DictAttr(arg_attrs)
+                if "torch.weight_name" in arg_attrs:
+                    name = StringAttr(arg_attrs["torch.weight_name"]).value
+                    names.append(name)
+            return [state_dict[name].detach() for name in names]
+    raise Exception(f"No function named {function} in the module")
@@ -0,0 +1,165 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import collections
+import functools
+import hashlib
+import os
+import tempfile
+import threading
+import weakref
+from typing import Callable, Optional, Sequence
+
+from torch_mlir import _mlir_libs
+
+# The environment variable naming the directory of the cache used when none is
+# given explicitly.
+CACHE_DIR_ENV_VAR = "TORCH_MLIR_COMPILATION_CACHE_DIR"
+
+
+@functools.lru_cache(maxsize=None)
+def get_compiler_fingerprint() -> str:
+    """Returns a string that changes whenever torch-mlir is rebuilt.
+
+    This is the package version and the size and modification time of the
+    native libraries, which contain the passes, so that development builds
+    that don't bump the version still invalidate the cache.
+    """
+    try:
+        from importlib.metadata import version
+        parts = [version("torch-mlir")]
+    except Exception:
+        parts = ["unknown"]
+    libs_dir = os.path.dirname(_mlir_libs.__file__)
+    for name in sorted(os.listdir(libs_dir)):
+        if not name.endswith((".so", ".dylib", ".dll", ".pyd")):
+            continue
+        stat = os.stat(os.path.join(libs_dir, name))
+        parts.append(f"{name}:{stat.st_size}:{stat.st_mtime_ns}")
+    return "\n".join(parts)
+
+
+class CompilationCache:
+    """A content-addressed on-disk cache of compilation results.
+
+    The entries are keyed by a hash of everything the result depends on,
+    typically the input module and the pipelines that were run on it, so they
+    never need to be invalidated: a change of any of them is a new key. Writes
+    are atomic, so several processes can share a cache.
+    """
+
+    def __init__(self, directory: str):
+        self.directory = directory
+        os.makedirs(directory, exist_ok=True)
+
+    def get_key(self, *parts) -> str:
+        """Returns the key of a result depending on `parts` and torch-mlir."""
+        hasher = hashlib.sha256()
+        for part in (get_compiler_fingerprint(), *parts):
+            if isinstance(part, str):
+                part = part.encode()
+            # Prefix the parts by their length so that their boundaries count.
+            hasher.update(len(part).to_bytes(8, "little"))
+            hasher.update(part)
+        return hasher.hexdigest()
+
+    def get_path(self, key: str, suffix: str) -> str:
+        """Returns the path of the entry for `key`, which may not exist."""
+        return os.path.join(self.directory, key + suffix)
+
+    def load(self, key: str, suffix: str) -> Optional[bytes]:
+        """Returns the contents of the entry for `key`, if any."""
+        try:
+            with open(self.get_path(key, suffix), "rb") as f:
+                return f.read()
+        except FileNotFoundError:
+            return None
+
+    def store(self, key: str, suffix: str, data: bytes):
+        """Stores `data` as the entry for `key`."""
+
+        def write(path):
+            with open(path, "wb") as f:
+                f.write(data)
+
+        self.store_file(key, suffix, write)
+
+    def store_file(self, key: str, suffix: str, write: Callable[[str], None]):
+        """Stores the file that `write` writes to the path it is given as the
+        entry for `key`, and returns the path of the entry."""
+        fd, tmp_path = tempfile.mkstemp(dir=self.directory, suffix=suffix)
+        os.close(fd)
+        try:
+            write(tmp_path)
+            path = self.get_path(key, suffix)
+            os.replace(tmp_path, path)
+            return path
+        except BaseException:
+            os.remove(tmp_path)
+            raise
+
+
+class ImportCache:
+    """An in-process cache of the modules compiled from TorchScript modules.
+
+    The entries are keyed by the `ModuleBuilder.get_import_fingerprint` of
+    the TorchScript module, by the output type and by the pipelines that
+    were run on it. The
+    fingerprint describes the tensors of the module by their identity and
+    version rather than by their contents, so an entry only matches while
+    the very tensors it was compiled from are alive. The entries hold weak
+    references to them, and keep the assembly of the module, which is
+    context-independent. The least recently used entries are evicted when
+    there are more than `max_entries` of them, or when the assembly of all
+    of them exceeds `max_size` characters. Modules whose assembly is larger
+    than that, i.e. those with large weights, are not cached.
+    """
+
+    def __init__(self, max_entries: int = 16, max_size: int = 64 << 20):
+        self.max_entries = max_entries
+        self.max_size = max_size
+        self.size = 0
+        self.entries = collections.OrderedDict()
+        self.lock = threading.Lock()
+
+    def load(self, key, tensors: Sequence) -> Optional[str]:
+        """Returns the assembly stored for `key` and `tensors`, if any."""
+        with self.lock:
+            entry = self.entries.get(key)
+            if entry is None:
+                return None
+            refs, asm = entry
+            if len(refs) != len(tensors) or any(
+                    ref() is not tensor for ref, tensor in zip(refs, tensors)):
+                return None
+            self.entries.move_to_end(key)
+            return asm
+
+    def store(self, key, tensors: Sequence, asm: str):
+        """Stores the assembly `asm` for `key` and `tensors`."""
+        if len(asm) > self.max_size:
+            return
+        refs = [weakref.ref(tensor) for tensor in tensors]
+        with self.lock:
+            old = self.entries.pop(key, None)
+            if old is not None:
+                self.size -= len(old[1])
+            self.entries[key] = (refs, asm)
+            self.size += len(asm)
+            while (len(self.entries) > self.max_entries
+                   or self.size > self.max_size):
+                _, (_, evicted) = self.entries.popitem(last=False)
+                self.size -= len(evicted)
+
+
+def get_compilation_cache(
+        cache_dir: Optional[str] = None) -> Optional[CompilationCache]:
+    """Returns the cache in `cache_dir`, defaulting to the directory in the
+    `TORCH_MLIR_COMPILATION_CACHE_DIR` environment variable, or None if
+    neither is set."""
+    cache_dir = cache_dir or os.environ.get(CACHE_DIR_ENV_VAR)
+    if not cache_dir:
+        return None
+    return CompilationCache(cache_dir)
@@ -7,8 +7,71 @@ from io import StringIO
 import os
 import sys
 import tempfile
+import threading
+from typing import Dict, List, NamedTuple, Optional
 from torch_mlir.passmanager import PassManager
 from torch_mlir.ir import StringAttr
+from torch_mlir._mlir_libs._torchMlir import enable_crash_reproducer_generation
+from torch_mlir._mlir_libs._torchMlir import enable_pass_profiling
+from torch_mlir._mlir_libs._torchMlir import get_pass_profiles
+from torch_mlir._mlir_libs._torchMlir import run_pass_manager
+
+# Ops that the linalg-on-tensors backend lowers directly, and that the Torch
+# backend pipeline should therefore not decompose.
+LINALG_ON_TENSORS_BACKEND_LEGAL_OPS = [
+    "torch.aten._softmax",
+    "torch.aten.softmax.int",
+    "torch.aten._log_softmax",
+    "torch.aten.log_softmax.int",
+    "torch.aten._softmax_backward_data",
+    "torch.aten._log_softmax_backward_data",
+    "torch.aten.tanh_backward",
+    "torch.aten.var",
+    "torch.aten.std",
+]
+
+# Ops that the TOSA backend lowers directly to compact TOSA sequences, and
+# that the Torch backend pipeline should therefore not decompose.
+TOSA_BACKEND_LEGAL_OPS = [
+    "torch.aten._softmax",
+    "torch.aten.softmax.int",
+    "torch.aten._log_softmax",
+    "torch.aten.log_softmax.int",
+    # Lowered to a single tosa.avg_pool2d whenever the output size divides
+    # the static input size, which the decomposition only handles for a few
+    # sizes. The pooling of dynamic spatial dims to a single element is still
+    # decomposed.
+    "torch.aten.adaptive_avg_pool2d",
+]
+
+def get_torch_backend_pipeline(backend_legal_ops=(), inference=False,
+                               auto_cast_dtype=None,
+                               weights_as_arguments=False,
+                               from_function=False):
+    """Gets the TorchScript -> Torch backend pipeline.
+
+    The ops in `backend_legal_ops` are not decomposed. If `inference` is True,
+    dropout and batch norm ops are compiled in inference mode. If
+    `auto_cast_dtype` is "bf16" or "f16", matmuls and convolutions compute in
+    that type. If `weights_as_arguments` is True, the parameters that the
+    program never updates are trailing arguments of `forward`. If
+    `from_function` is True, the pipeline starts from imported TorchScript
+    functions rather than from an imported module.
+    """
+    pipeline = ("torch-function-to-torch-backend-pipeline" if from_function
+                else "torchscript-module-to-torch-backend-pipeline")
+    options = []
+    if backend_legal_ops:
+        options.append("backend-legal-ops=" + ",".join(backend_legal_ops))
+    if inference:
+        options.append("inference=true")
+    if auto_cast_dtype:
+        options.append("auto-cast-dtype=" + auto_cast_dtype)
+    if weights_as_arguments:
+        options.append("weights-as-arguments=true")
+    if not options:
+        return pipeline
+    return pipeline + "{" + " ".join(options) + "}"
 
 def get_module_name_for_debug_dump(module):
     """Gets a name suitable for a debug dump.
@@ -19,40 +82,130 @@ def get_module_name_for_debug_dump(module):
         return "UnnammedModule"
     return StringAttr(module.operation.attributes["torch.debug_module_name"]).value
 
+class PassProfile(NamedTuple):
+    """The profile of a pass of a pipeline, summed over its runs, e.g. on each
+    function for the passes nested on functions."""
+    # The description of the pipeline.
+    pipeline: str
+    # The pass, by its command line argument.
+    name: str
+    runs: int
+    seconds: float
+    # The numbers of operations in the operations that the pass ran on.
+    ops_before: int
+    ops_after: int
+    # The increase of each statistic of the pass. The statistics are only
+    # counted in builds of LLVM with statistics enabled, e.g. with assertions.
+    statistics: Dict[str, int]
+
+
+class CompileReport:
+    """The profiles of the passes run by `run_pipeline_with_repro_report`."""
+
+    def __init__(self):
+        self.passes: List[PassProfile] = []
+
+    @property
+    def total_seconds(self) -> float:
+        return sum(profile.seconds for profile in self.passes)
+
+    def __str__(self):
+        lines = [
+            f"{'time (s)':>10} {'%':>6} {'runs':>6} {'ops before':>11} "
+            f"{'ops after':>10}  pass"
+        ]
+        total = self.total_seconds
+        pipeline = None
+        for profile in self.passes:
+            if profile.pipeline != pipeline:
+                pipeline = profile.pipeline
+                lines.append(f"{pipeline}:")
+            percent = 100 * profile.seconds / total if total else 0
+            statistics = ", ".join(f"{name}={value}"
+                                   for name, value in profile.statistics.items()
+                                   if value)
+            lines.append(
+                f"{profile.seconds:>10.4f} {percent:>6.1f} {profile.runs:>6} "
+                f"{profile.ops_before:>11} {profile.ops_after:>10}  "
+                f"{profile.name}" + (f" ({statistics})" if statistics else ""))
+        lines.append(f"{total:>10.4f} {100.0:>6.1f}  total")
+        return "\n".join(lines)
+
+
+class _ThreadLocalStderr:
+    """Stands in for `sys.stderr`, writing to the buffer of the thread that
+    writes, if it captures its output, so that pipelines running on several
+    threads each get their own diagnostics."""
+
+    def __init__(self, stderr):
+        self.stderr = stderr
+        self.local = threading.local()
+
+    def write(self, text):
+        buffer = getattr(self.local, "buffer", None)
+        return (self.stderr if buffer is None else buffer).write(text)
+
+    def __getattr__(self, name):
+        return getattr(self.stderr, name)
+
+
+_stderr_lock = threading.Lock()
+
+
+def _capture_stderr(buffer: Optional[StringIO]):
+    """Makes the writes of this thread to `sys.stderr` go to `buffer`, or
+    back to `sys.stderr` if it is None."""
+    with _stderr_lock:
+        if not isinstance(sys.stderr, _ThreadLocalStderr):
+            sys.stderr = _ThreadLocalStderr(sys.stderr)
+        sys.stderr.local.buffer = buffer
+
+
 def run_pipeline_with_repro_report(module,
                                    pipeline: str,
-                                   description: str):
-    """Runs `pipeline` on `module`, with a nice repro report if it fails."""
+                                   description: str,
+                                   report: Optional[CompileReport] = None):
+    """Runs `pipeline` on `module`, with a nice repro report if it fails.
+
+    If `report` is given, the profiles of the passes are added to it.
+    """
     module_name = get_module_name_for_debug_dump(module)
+    # TODO: More robust.
+    # - don't arbitrarily clutter up /tmp. When a test suite has many
+    #   tests, this can be a big disk cost (also, /tmp/ is frequently a
+    #   RAM fs, which increases worries about capacity).
+    # - don't have colliding filenames (hard to do without cluttering
+    #   up /tmp)
+    # - if we do have have colliding filenames, writes should at least
+    #   avoid being racy.
+    filename = os.path.join(tempfile.gettempdir(), module_name + ".mlir")
+    stderr = StringIO()
     try:
-        original_stderr = sys.stderr 
-        sys.stderr = StringIO()
-        asm_for_error_report = module.operation.get_asm(
-            large_elements_limit=10, enable_debug_info=True)
+        _capture_stderr(stderr)
         # Lower module in place to make it ready for compiler backends.
         with module.context:
             pm = PassManager.parse(pipeline)
-            pm.run(module)
+            # The pass manager clones the module before running the pipeline
+            # and writes it to `filename` only if a pass fails, so that
+            # successful runs don't pay for printing it.
+            enable_crash_reproducer_generation(pm, filename)
+            profiler = None if report is None else enable_pass_profiling(pm)
+            try:
+                run_pass_manager(pm, module)
+            finally:
+                if profiler is not None:
+                    report.passes.extend(
+                        PassProfile(description, *profile)
+                        for profile in get_pass_profiles(profiler))
     except Exception as e:
-        # TODO: More robust.
-        # - don't arbitrarily clutter up /tmp. When a test suite has many
-        #   tests, this can be a big disk cost (also, /tmp/ is frequently a
-        #   RAM fs, which increases worries about capacity).
-        # - don't have colliding filenames (hard to do without cluttering
-        #   up /tmp)
-        # - if we do have have colliding filenames, writes should at least
-        #   avoid being racy.
-        filename = os.path.join(tempfile.gettempdir(), module_name + ".mlir")
-        with open(filename, 'w') as f:
-            f.write(asm_for_error_report)
         debug_options="-mlir-print-ir-after-all -mlir-disable-threading"
         raise Exception(f"""
 {description} failed with the following diagnostics:
-{sys.stderr.getvalue()}
+{stderr.getvalue()}
 
 Error can be reproduced with:
-$ torch-mlir-opt -pass-pipeline='{pipeline}' {filename}
+$ torch-mlir-opt -run-reproducer {filename}
 Add '{debug_options}' to get the IR dump for debugging purpose.
 """) from None
     finally:
-        sys.stderr = original_stderr
+        _capture_stderr(None)
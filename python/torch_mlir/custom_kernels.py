@@ -0,0 +1,238 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""Natively compiled kernels for custom ops.
+
+A custom op, registered with PyTorch by an extension or `torch.library`, is
+imported as a `torch.operator`, which the backends can't lower. Registering a
+kernel for it with `register_custom_kernel` makes the compiled programs call
+the kernel instead:
+
+```
+def scale_shape(x: List[int], factor: float) -> List[int]:
+    return x
+
+register_custom_kernel("my_ops.scale", scale_shape, scale_kernel)
+```
+
+The shape function computes the shapes of the results from those of the
+tensor inputs and from the other inputs, like the functions of the shape
+library. The results have the dtype of the first tensor input.
+
+The kernel is the address of a C function, or a `ctypes` function object,
+called through the C interface of MLIR: it takes a pointer to the ranked
+memref descriptor of each tensor input, `int64_t` and `double` for the int and
+float inputs, in their order, then a pointer to the descriptor of each
+result, which the compiled program allocates and the kernel writes. The
+descriptors of the inputs are contiguous. The kernel must not keep the
+pointers after it returns, nor have other side effects.
+
+Only the RefBackend links the kernels, when the module is JIT compiled.
+"""
+
+import ctypes
+import threading
+from typing import Callable, Dict, Union
+
+import torch
+
+from torch_mlir.ir import Module, StringAttr
+from torch_mlir.passmanager import PassManager
+from torch_mlir._mlir_libs._torchMlir import add_to_shape_library
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+
+__all__ = [
+    "register_custom_kernel",
+    "get_custom_kernel_symbol",
+    "get_custom_kernel_address",
+    "get_custom_kernels_version",
+    "prepare_custom_kernels",
+]
+
+# The attribute that marks the `torch.operator`s calling a custom kernel.
+CUSTOM_KERNEL_ATTR = "torch.custom_kernel"
+
+
+def get_custom_kernel_symbol(op_name: str) -> str:
+    """Returns the name that the compiled programs call the kernel of the op
+    `op_name` by, which is only made of letters, digits and underscores.
+
+    The letters and digits are kept, and the other characters are escaped:
+    `_` as `__`, `.` as `_d` and any other as `_x` followed by the hex digits
+    of its UTF-8 bytes. Distinct op names then have distinct symbols, e.g.
+    `my_ops.scale` is `my__ops_dscale`.
+    """
+    symbol = []
+    for c in op_name:
+        if c.isascii() and c.isalnum():
+            symbol.append(c)
+        elif c == "_":
+            symbol.append("__")
+        elif c == ".":
+            symbol.append("_d")
+        else:
+            symbol.extend(f"_x{b:02x}" for b in c.encode("utf-8"))
+    return "".join(symbol)
+
+
+def _walk_graph_nodes(block):
+    for node in block.nodes():
+        yield node
+        for nested in node.blocks():
+            yield from _walk_graph_nodes(nested)
+
+
+def _get_scripted_callees(function, functions_by_name, callees):
+    """Adds the scripted functions that `function` calls, directly or not, to
+    `callees`, by their qualified names."""
+    for node in _walk_graph_nodes(function.graph):
+        if node.kind() != "prim::CallFunction":
+            continue
+        constant = node.inputsAt(0).node()
+        if constant.kind() != "prim::Constant" or \
+                not constant.hasAttribute("name"):
+            continue
+        for callee in functions_by_name.get(constant.s("name"), []):
+            if callee.qualified_name not in callees:
+                callees[callee.qualified_name] = callee
+                _get_scripted_callees(callee, functions_by_name, callees)
+
+
+class _CustomKernel:
+
+    def __init__(self, op_name: str, shape_function: Callable, kernel):
+        self.op_name = op_name
+        self.symbol = get_custom_kernel_symbol(op_name)
+        self.shape_function = shape_function
+        # Keeps the `ctypes` function object, and so the trampoline that
+        # its address points to, alive.
+        self.kernel = kernel
+        if isinstance(kernel, int):
+            self.address = kernel
+        else:
+            self.address = ctypes.cast(kernel, ctypes.c_void_p).value
+        self._shape_library_asm = None
+
+    def get_shape_library_asm(self) -> str:
+        """Returns the module holding the shape function of the op, named as
+        in the shape library, and its callees."""
+        if self._shape_library_asm is not None:
+            return self._shape_library_asm
+        scripted = torch.jit.script(self.shape_function)
+        # The shape function may call other scripted functions, which are in
+        # the same compilation unit as it. Only those are imported, not the
+        # unrelated functions that the process scripted.
+        functions_by_name = {}
+        for function in torch.jit._state._python_cu.get_functions():
+            functions_by_name.setdefault(function.name, []).append(function)
+        functions = {scripted.qualified_name: scripted}
+        _get_scripted_callees(scripted, functions_by_name, functions)
+        mb = ModuleBuilder()
+        for function in functions.values():
+            mb.import_function(function)
+        with mb.module.context:
+            for op in mb.module.body.operations:
+                name = StringAttr(op.attributes["sym_name"]).value
+                if name == scripted.qualified_name:
+                    op.attributes["sym_name"] = StringAttr.get(
+                        f"__torch_mlir_shape_fn.{self.op_name}")
+                else:
+                    op.attributes["sym_visibility"] = StringAttr.get(
+                        "private")
+        pm = PassManager.parse("symbol-dce,canonicalize",
+                               context=mb.module.context)
+        pm.run(mb.module)
+        self._shape_library_asm = mb.module.operation.get_asm()
+        return self._shape_library_asm
+
+
+_lock = threading.Lock()
+_custom_kernels: Dict[str, _CustomKernel] = {}
+# Incremented by each registration, as it changes how modules are imported.
+_custom_kernels_version = 0
+
+
+def register_custom_kernel(op_name: str, shape_function: Callable,
+                           kernel: Union[int, ctypes._CFuncPtr]):
+    """Makes the programs compiled after this call `kernel` for the custom op
+    `op_name`, like `my_ops.scale` for `torch.ops.my_ops.scale`, or
+    `my_ops.scale.Tensor` for one of its overloads.
+
+    Args:
+      op_name: The name of the `torch.operator` that the op is imported as.
+      shape_function: A TorchScript-compatible function computing the shapes
+        of the results of the op, with `List[int]` in place of its tensors.
+      kernel: The address of the kernel, or a `ctypes` function object,
+        which is kept alive.
+    """
+    global _custom_kernels_version
+    with _lock:
+        _custom_kernels[op_name] = _CustomKernel(op_name, shape_function,
+                                                 kernel)
+        _custom_kernels_version += 1
+
+
+def get_custom_kernels_version() -> int:
+    """Returns a number that changes whenever a kernel is registered, so that
+    what is derived from the registered kernels, like the imported modules,
+    can be cached under it."""
+    with _lock:
+        return _custom_kernels_version
+
+
+def get_custom_kernel_address(symbol: str) -> int:
+    """Returns the address of the kernel that the compiled programs call as
+    `symbol`, which `get_custom_kernel_symbol` derives from its op name."""
+    with _lock:
+        for custom_kernel in _custom_kernels.values():
+            if custom_kernel.symbol == symbol:
+                return custom_kernel.address
+    raise KeyError(f"No custom kernel is registered as {symbol!r}")
+
+
+def _walk_operations(operation):
+    for region in operation.regions:
+        for block in region:
+            for op in block.operations:
+                yield op
+                yield from _walk_operations(op.operation)
+
+
+def prepare_custom_kernels(module: Module):
+    """Marks the calls of the imported `module` to the ops with a registered
+    kernel, and adds their shape functions to the shape library of its
+    context.
+
+    This scripts the shape functions the first time they are used, so it must
+    be called under `torch_mlir._import_lock`, like the other uses of
+    TorchScript."""
+    with _lock:
+        custom_kernels = dict(_custom_kernels)
+    if not custom_kernels:
+        return
+    used_kernels = {}
+    with module.context:
+        for op in _walk_operations(module.operation):
+            if op.operation.name != "torch.operator":
+                continue
+            name = StringAttr(op.attributes["name"]).value
+            custom_kernel = custom_kernels.get(name)
+            if custom_kernel is None:
+                continue
+            op.attributes[CUSTOM_KERNEL_ATTR] = StringAttr.get(
+                custom_kernel.symbol)
+            used_kernels[name] = custom_kernel
+    for name, custom_kernel in used_kernels.items():
+        with _lock:
+            asm = custom_kernel.get_shape_library_asm()
+        try:
+            add_to_shape_library(module.context, asm)
+        except RuntimeError as e:
+            # The shape library of the context already has a different shape
+            # function for the op, e.g. the one of a kernel registered for it
+            # before, which would be used in place of this one.
+            raise RuntimeError(
+                f"The shape function of the custom op {name!r} conflicts "
+                f"with the one already in the shape library of the context"
+            ) from e
@@ -509,6 +509,11 @@ def aten〇argmax(self: List[int], dim: Optional[int] = None, keepdim: bool = Fa
         return []
     return _reduce_along_dim(self, dim, keepdim)
 
+def aten〇argmin(self: List[int], dim: Optional[int] = None, keepdim: bool = False) -> List[int]:
+    if dim is None:
+        return []
+    return _reduce_along_dim(self, dim, keepdim)
+
 def aten〇any〇dim(self: List[int], dim: int, keepdim: bool = False) -> List[int]:
     return _reduce_along_dim(self, dim, keepdim)
 
@@ -516,6 +521,10 @@ def aten〇max〇dim(self: List[int], dim: int, keepdim: bool = False) -> Tuple[
     reduced_shape = _reduce_along_dim(self, dim, keepdim)
     return reduced_shape, reduced_shape
 
+def aten〇min〇dim(self: List[int], dim: int, keepdim: bool = False) -> Tuple[List[int], List[int]]:
+    reduced_shape = _reduce_along_dim(self, dim, keepdim)
+    return reduced_shape, reduced_shape
+
 def aten〇mean〇dim(self: List[int], dim: List[int], keepdim: bool = False, dtype: Optional[int] = None) -> List[int]:
     return upstream_shape_functions.mean_dim(self, dim, keepdim, dtype)
 
@@ -571,6 +580,19 @@ def aten〇baddbmm(self: List[int], batch1: List[int], batch2: List[int], beta:
 def aten〇embedding(weight: List[int], indices: List[int], padding_idx: int = -1, scale_grad_by_freq: bool = False, sparse: bool = False) -> List[int]:
     return upstream_shape_functions.embedding(weight, indices, padding_idx, scale_grad_by_freq, sparse)
 
+# Only the shape of the pooled output, the first result, matches PyTorch for
+# all modes. The shapes of the other results vary between PyTorch kernels.
+def aten〇embedding_bag〇padding_idx(weight: List[int], indices: List[int], offsets: List[int], scale_grad_by_freq: bool, mode: int, sparse: bool, per_sample_weights: Optional[List[int]], include_last_offset: bool, padding_idx: Optional[int]) -> Tuple[List[int], List[int], List[int], List[int]]:
+    num_bags = offsets[0]
+    if include_last_offset:
+        num_bags = num_bags - 1
+    output = [num_bags, weight[1]]
+    if mode == 2:
+        max_indices = [num_bags, weight[1]]
+    else:
+        max_indices = [num_bags]
+    return output, [indices[0]], [num_bags], max_indices
+
 def aten〇repeat(self: List[int], repeats: List[int]) -> List[int]:
     assert len(repeats) >= len(self)
     ndim = len(repeats)
@@ -669,6 +691,31 @@ def aten〇avg_pool2d(self: List[int], kernel_size: List[int], stride: List[int]
 def aten〇adaptive_avg_pool2d(self: List[int], output_size: List[int]) -> List[int]:
     return upstream_shape_functions.adaptive_avg_pool2d(self, output_size)
 
+def aten〇upsample_nearest2d(self: List[int], output_size: List[int], scales_h: Optional[float] = None, scales_w: Optional[float] = None) -> List[int]:
+    return [self[0], self[1], output_size[0], output_size[1]]
+
+@check_shape_function([
+    Invocation(TensorOfShape(2, 3, 4, 5), [6, 7], None), # Explicit output size.
+    Invocation(TensorOfShape(2, 3, 4, 5), None, [2.0, 1.5]), # Scale factors.
+    ErrorInvocation(TensorOfShape(2, 3, 4, 5), None, None), # Neither given.
+])
+def aten〇upsample_nearest2d〇vec(input: List[int], output_size: Optional[List[int]], scale_factors: Optional[List[float]]) -> List[int]:
+    out = upstream_shape_functions.upsample_nearest2d(input, output_size, scale_factors)
+    assert out is not None
+    return out
+
+def aten〇upsample_bilinear2d(self: List[int], output_size: List[int], align_corners: bool, scales_h: Optional[float] = None, scales_w: Optional[float] = None) -> List[int]:
+    return [self[0], self[1], output_size[0], output_size[1]]
+
+@check_shape_function([
+    Invocation(TensorOfShape(2, 3, 4, 5), [6, 7], False, None), # Explicit output size.
+    Invocation(TensorOfShape(2, 3, 4, 5), None, True, [2.0, 1.5]), # Scale factors.
+])
+def aten〇upsample_bilinear2d〇vec(input: List[int], output_size: Optional[List[int]], align_corners: bool, scale_factors: Optional[List[float]]) -> List[int]:
+    out = upstream_shape_functions.upsample_nearest2d(input, output_size, scale_factors)
+    assert out is not None
+    return out
+
 def aten〇flatten〇using_ints(self: List[int], start_dim: int = 0, end_dim: int = -1) -> List[int]:
     return upstream_shape_functions.flatten(self, start_dim, end_dim)
 
@@ -880,10 +927,24 @@ def aten〇topk(self: List[int], k: int, dim: int = -1, largest: bool = True, so
     self[dim] = k
     return self, self
 
+@check_shape_function([
+    Invocation(TensorOfShape(2, 3)), # Basic case.
+    Invocation(TensorOfShape(2, 3), dim=0, descending=True), # Explicit args.
+])
+def aten〇sort(self: List[int], dim: int = -1, descending: bool = False) -> Tuple[List[int], List[int]]:
+    return self, self
+
 def aten〇conv2d(input: List[int], weight: List[int], bias: Optional[List[int]] = None, stride: List[int] = (1, 1), padding: List[int] = (0, 0), dilation: List[int] = (1, 1), groups: int = 1) -> List[int]:
     return upstream_shape_functions.conv2d(input, weight, bias, stride, padding, dilation, groups)
 
 def aten〇convolution(input: List[int], weight: List[int], bias: Optional[List[int]], stride: List[int], padding: List[int], dilation: List[int], transposed: bool, output_padding: List[int], groups: int) -> List[int]:
+    if transposed:
+        # The weight of a transposed convolution is in form of C*F*H*W, with
+        # F being the number of output channels per group.
+        output_size = [input[0], weight[1] * groups]
+        for i in range(2, len(input)):
+            output_size.append((input[i] - 1) * stride[i - 2] - 2 * padding[i - 2] + dilation[i - 2] * (weight[i] - 1) + output_padding[i - 2] + 1)
+        return output_size
     return upstream_shape_functions.conv_output_size(input, weight, bias, stride, padding, dilation, groups)
     
 def aten〇flip(self: List[int], dims: List[int]) -> List[int]:
@@ -904,6 +965,12 @@ def aten〇slice〇Tensor(self: List[int], dim: int = 0, start: Optional[int] =
 def aten〇select〇int(self: List[int], dim: int, index: int) -> List[int]:
     return upstream_shape_functions.select(self, dim, index)
 
+def aten〇slice_scatter(self: List[int], src: List[int], dim: int = 0, start: Optional[int] = None, end: Optional[int] = None, step: int = 1) -> List[int]:
+    return upstream_shape_functions.unary(self)
+
+def aten〇select_scatter(self: List[int], src: List[int], dim: int, index: int) -> List[int]:
+    return upstream_shape_functions.unary(self)
+
 def aten〇index_select(self: List[int], dim: int, index: List[int]) -> List[int]:
     return upstream_shape_functions.index_select(self, dim, index)
 
@@ -941,6 +1008,17 @@ def aten〇nll_loss_forward(self: List[int], target: List[int], weight: Optional
 def aten〇nll_loss_backward(grad_output: List[int], self: List[int], target: List[int], weight: Optional[List[int]], reduction: int, ignore_index: int, total_weight: List[int]) -> List[int]:
     return upstream_shape_functions.unary(self)
 
+@check_shape_function([
+    Invocation(TensorOfShape(2, 3), LongTensorOfShape(2)), # Basic case.
+    Invocation(TensorOfShape(3), LongTensorOfShape()), # No batch dim.
+    Invocation(TensorOfShape(2, 3), LongTensorOfShape(2), None, 0), # No reduction.
+])
+def aten〇cross_entropy_loss(self: List[int], target: List[int], weight: Optional[List[int]] = None, reduction: int = 1, ignore_index: int = -100, label_smoothing: float = 0.0) -> List[int]:
+    scalar_shape: List[int] = []
+    if reduction == 0:
+        return upstream_shape_functions.unary(target)
+    return scalar_shape
+
 @check_shape_function([
     Invocation(TensorOfShape(2, 5, 2, 2, 3), [2, 2, 3], None, None, 1e-6), # Basic case.
 ])
@@ -966,6 +1044,13 @@ def aten〇native_batch_norm(input: List[int], weight: Optional[List[int]], bias
         return input, [input[1]], [input[1]]
     return input, [0], [0]
 
+@not_present_in_registry
+def aten〇native_batch_norm〇functional(input: List[int], weight: Optional[List[int]], bias: Optional[List[int]], running_mean: List[int], running_var: List[int], training: bool, momentum: float, eps: float) -> Tuple[List[int], List[int], List[int], List[int], List[int]]:
+    return input, [input[1]], [input[1]], running_mean, running_var
+
+def aten〇native_batch_norm_backward(grad_out: List[int], input: List[int], weight: Optional[List[int]], running_mean: Optional[List[int]], running_var: Optional[List[int]], save_mean: Optional[List[int]], save_invstd: Optional[List[int]], train: bool, eps: float, output_mask: List[bool]) -> Tuple[List[int], List[int], List[int]]:
+    return input, [input[1]], [input[1]]
+
 # TODO: This should be upstreamed.
 # See https://github.com/pytorch/pytorch/pull/76889 for an example.
 def pad_shape_fn(input: List[int], pad: List[int]):
@@ -22,10 +22,15 @@ using namespace torch_mlir;
 
 MlirOperation torch_mlir::importJitFunctionAsFuncOp(
     MlirContext context, torch::jit::Function *function,
-    std::function<MlirAttribute(int)> getArgAttribute) {
+    std::function<MlirAttribute(int)> getArgAttribute,
+    const ImportOptions &importOptions) {
   // Useful for debugging:
   // graph->dump();
+  torch::jit::Block *jitBlock =
+      torch::jit::toGraphFunction(*function).graph()->block();
   MlirLocation loc = mlirLocationUnknownGet(context);
+  if (importOptions.locationImportMode == LocationImportMode::Function)
+    loc = getMlirLocationFromBlock(context, jitBlock);
   MlirType functionType =
       getFunctionTypeFromSchema(context, function->getSchema());
   // Use the function's qualified name from the compilation unit.
@@ -67,9 +72,8 @@ MlirOperation torch_mlir::importJitFunctionAsFuncOp(
                                  appendToBlock, loc, yieldedValues, resultTypes,
                                  /*userAllowsRefinement=*/false));
   };
-  MlirBlock block = importBlock(
-      context, torch::jit::toGraphFunction(*function).graph()->block(),
-      createTerminator, inputTypes);
+  MlirBlock block = importBlock(context, jitBlock, createTerminator,
+                                inputTypes, importOptions);
   mlirRegionAppendOwnedBlock(bodyRegion, block);
   return func;
 }
@@ -0,0 +1,48 @@
+//===- import_options.h -----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TORCHMLIRJITIRIMPORTER_CSRC_IMPORT_OPTIONS_H
+#define TORCHMLIRJITIRIMPORTER_CSRC_IMPORT_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+namespace torch_mlir {
+
+/// How source locations of TorchScript nodes are imported.
+enum class LocationImportMode {
+  /// Each op gets the file/line/column location of the node it comes from.
+  All,
+  /// All ops of a function share a single location: that of the first node of
+  /// the function that has one.
+  Function,
+  /// All ops get an unknown location.
+  None,
+};
+
+/// Options controlling how the importer translates TorchScript to MLIR.
+struct ImportOptions {
+  /// How source locations are imported. Dropping them makes import faster and
+  /// the IR smaller, which speeds up all later compilation.
+  LocationImportMode locationImportMode = LocationImportMode::All;
+
+  /// If non-empty, the data of tensors held by the imported module that are
+  /// at least `externalWeightsMinBytes` large is written to this file
+  /// (overwriting it) instead of being embedded in the IR. Such tensors are
+  /// imported as `torch.vtensor.external_literal` ops referring to the file.
+  std::string externalWeightsFile;
+
+  /// The minimum size in bytes of a tensor for it to be stored in
+  /// `externalWeightsFile`. Smaller tensors are embedded in the IR as usual.
+  int64_t externalWeightsMinBytes = 1024;
+};
+
+} // namespace torch_mlir
+
+#endif // TORCHMLIRJITIRIMPORTER_CSRC_IMPORT_OPTIONS_H
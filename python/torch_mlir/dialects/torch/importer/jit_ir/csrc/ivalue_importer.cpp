@@ -12,6 +12,7 @@
 #include "function_importer.h"
 #include "torch_to_mlir_utils.h"
 
+#include <fstream>
 #include <unordered_map>
 
 #include "mlir_utils.h"
@@ -19,8 +20,10 @@
 #include "mlir-c/BuiltinAttributes.h"
 #include "mlir-c/BuiltinTypes.h"
 #include "mlir-c/Diagnostics.h"
+#include "torch-mlir-c/TorchOps.h"
 #include "torch-mlir-c/TorchTypes.h"
 
+#include "ATen/Parallel.h"
 #include "ATen/native/quantized/PackedParams.h"
 #include "caffe2/core/scope_guard.h"
 
@@ -72,6 +75,17 @@ struct IValueEq {
 };
 } // namespace
 
+// Returns true if `lhs` and `rhs` are views of exactly the same elements of
+// the same storage, and hence are indistinguishable aliases of each other.
+static bool isSameView(const at::Tensor &lhs, const at::Tensor &rhs) {
+  return lhs.storage().unsafeGetStorageImpl() ==
+             rhs.storage().unsafeGetStorageImpl() &&
+         lhs.storage_offset() == rhs.storage_offset() &&
+         lhs.sizes() == rhs.sizes() && lhs.strides() == rhs.strides() &&
+         lhs.scalar_type() == rhs.scalar_type() &&
+         !lhs.is_quantized() && !rhs.is_quantized();
+}
+
 namespace {
 /// Helper class for holding state during recursive IValue import.
 ///
@@ -92,23 +106,29 @@ namespace {
 ///   - the address of the at::StorageImpl is the identity of the "storage".
 ///
 /// Multiple different tensors can share the same underlying storage. We
-/// currently import tensors by identity and emit errors in the case of tensors
-/// with different identity but sharing the same storage. This is done because
-/// correctly modeling the many ways that tensors can overlap and alias when
-/// they share storage is difficult. Example hard cases are weird
+/// import tensors by identity, and additionally unify tensors with different
+/// identity that are exact views of the same storage (same storage offset,
+/// sizes, strides and dtype). Such tensors are indistinguishable aliases of
+/// each other (this commonly happens for tied parameters), so importing them
+/// as the same value is correct and avoids duplicating the data. We emit
+/// errors in all other cases of tensors sharing the same storage. This is done
+/// because correctly modeling the many ways that tensors can overlap and alias
+/// when they share storage is difficult. Example hard cases are weird
 /// strides/offsets that overlap, and even cases where the data types mismatch
 /// (PyTorch allows this!).
 class IValueImporter {
 public:
   IValueImporter(MlirBlock importBlock, MlirContext context,
-                 ClassAnnotator &annotator)
-      : importBlock(importBlock), context(context), annotator(annotator) {}
+                 ClassAnnotator &annotator, const ImportOptions &importOptions)
+      : importBlock(importBlock), context(context), annotator(annotator),
+        importOptions(importOptions) {}
 
   MlirValue importIValue(c10::IValue ivalue);
 
 private:
   MlirValue rawImportIValue(c10::IValue ivalue);
   MlirValue importTensor(c10::IValue ivalue);
+  MlirValue importExternalTensorLiteral(at::Tensor tensor, MlirLocation loc);
   MlirValue importModule(torch::jit::Module jitModule);
   void importMethod(torch::jit::Function *function, MlirBlock classTypeBody,
                     const MethodAnnotation &methodAnnotation);
@@ -118,6 +138,11 @@ private:
   MlirBlock importBlock;
   MlirContext context;
   ClassAnnotator &annotator;
+  const ImportOptions &importOptions;
+
+  // The file that tensor data is written to when importing tensors as
+  // `torch.vtensor.external_literal`. Opened on first use.
+  std::ofstream externalWeightsStream;
 
   // Map tracking already-imported values.
   std::unordered_map<c10::IValue, MlirValue, IValueHasher, IValueEq> valueMap;
@@ -130,8 +155,10 @@ private:
   // `__torch__`).
   torch::jit::CompilationUnit *compilationUnit = nullptr;
 
-  // Used to detect potentially aliasing tensors.
-  std::unordered_set<c10::StorageImpl *> seenStorageImpls;
+  // Used to detect potentially aliasing tensors. Maps each storage to the
+  // first tensor imported with that storage.
+  std::unordered_map<c10::StorageImpl *, std::pair<at::Tensor, MlirValue>>
+      seenStorageImpls;
   // The set of ClassType's that have already been imported.
   //
   // ClassType's are referenced via their `classType->name()->qualifiedName()`
@@ -215,11 +242,19 @@ MlirValue IValueImporter::importIValue(c10::IValue ivalue) {
   if (it != valueMap.end()) {
     return it->second;
   }
-  // Reject potentially aliased tensors.
+  // Unify tensors that are exact aliases of an already imported tensor, and
+  // reject other potentially aliased tensors.
   if (ivalue.isTensor()) {
-    c10::StorageImpl *storageImpl =
-        ivalue.toTensor().storage().unsafeGetStorageImpl();
-    if (!seenStorageImpls.insert(storageImpl).second) {
+    const at::Tensor &tensor = ivalue.toTensor();
+    c10::StorageImpl *storageImpl = tensor.storage().unsafeGetStorageImpl();
+    auto storageIt = seenStorageImpls.find(storageImpl);
+    if (storageIt != seenStorageImpls.end()) {
+      const at::Tensor &seenTensor = storageIt->second.first;
+      if (isSameView(tensor, seenTensor)) {
+        MlirValue value = storageIt->second.second;
+        valueMap[ivalue] = value;
+        return value;
+      }
       std::stringstream msg;
       msg << "Unhandled tensor that shares storage with another tensor.";
       if (rootModuleName) {
@@ -232,6 +267,11 @@ MlirValue IValueImporter::importIValue(c10::IValue ivalue) {
   }
   MlirValue value = rawImportIValue(ivalue);
   valueMap[ivalue] = value;
+  if (ivalue.isTensor()) {
+    const at::Tensor &tensor = ivalue.toTensor();
+    seenStorageImpls[tensor.storage().unsafeGetStorageImpl()] = {tensor,
+                                                                 value};
+  }
   return value;
 }
 
@@ -362,19 +402,31 @@ MlirValue IValueImporter::importTensor(c10::IValue ivalue) {
   // TODO: Can we do better?
   MlirLocation loc = mlirLocationUnknownGet(context);
 
-  // Import the bulk tensor representation.
-  at::Tensor tensor = ivalue.toTensor().contiguous();
-  MlirAttribute denseElements = convertTensorToMlirElementsAttr(tensor, loc);
-
-  MlirOperation tensorOp = createMlirOperationAtEnd(
-      importBlock, "torch.tensor.literal", loc,
-      torchMlirTorchNonValueTensorTypeGetFromAttribute(denseElements),
-      toMlirNamedAttribute("value", denseElements));
-  MlirValue tensorReprValue = mlirOperationGetResult(tensorOp, 0);
+  at::Tensor tensor = ivalue.toTensor();
+  bool isExternal =
+      !importOptions.externalWeightsFile.empty() && !tensor.is_quantized() &&
+      !tensor.is_sparse() && tensor.scalar_type() != c10::ScalarType::Bool &&
+      static_cast<int64_t>(tensor.numel() * tensor.element_size()) >=
+          importOptions.externalWeightsMinBytes;
+
+  // Import the bulk tensor representation. Note that
+  // `convertTensorToMlirElementsAttr` takes care of making the tensor
+  // contiguous only if needed, so avoid making an extra copy here.
+  MlirValue tensorReprValue;
+  if (isExternal) {
+    tensorReprValue = importExternalTensorLiteral(tensor, loc);
+  } else {
+    MlirAttribute denseElements = convertTensorToMlirElementsAttr(tensor, loc);
+    MlirOperation tensorOp = torchMlirTensorLiteralCreate(
+        loc, denseElements, /*valueSemantics=*/false);
+    mlirBlockInsertOwnedOperationBefore(
+        importBlock, mlirBlockGetTerminator(importBlock), tensorOp);
+    tensorReprValue = mlirOperationGetResult(tensorOp, 0);
+  }
 
-  // Construct the complete tensor value. This is trivial for most tensors, but
-  // for quantized tensors (and probably sparse too, TBD) there is more for us
-  // to do.
+  // Construct the complete tensor value. This is trivial for most tensors,
+  // including sparse ones, whose layout is part of their type, but for
+  // quantized tensors there is more for us to do.
   MlirValue tensorValue;
   if (tensor.is_quantized()) {
     // Note that Torch models quantization in a type-erased way. So we don't
@@ -392,6 +444,16 @@ MlirValue IValueImporter::importTensor(c10::IValue ivalue) {
           importBlock, "torch.per_tensor_affine.create", loc,
           quantizedTensorType, tensorReprValue, qScale, zeroPoint);
       tensorValue = mlirOperationGetResult(quantizedTensor, 0);
+    } else if (tensor.qscheme() == c10::kPerChannelAffine) {
+      MlirValue qScales =
+          importIValue(c10::IValue(tensor.q_per_channel_scales()));
+      MlirValue zeroPoints =
+          importIValue(c10::IValue(tensor.q_per_channel_zero_points()));
+      MlirValue axis = importIValue(c10::IValue(tensor.q_per_channel_axis()));
+      MlirOperation quantizedTensor = createMlirOperationAtEnd(
+          importBlock, "torch.per_channel_affine.create", loc,
+          quantizedTensorType, tensorReprValue, qScales, zeroPoints, axis);
+      tensorValue = mlirOperationGetResult(quantizedTensor, 0);
     } else {
       std::stringstream msg;
       msg << "Unsupported quantization scheme '"
@@ -405,6 +467,62 @@ MlirValue IValueImporter::importTensor(c10::IValue ivalue) {
   return tensorValue;
 }
 
+MlirValue IValueImporter::importExternalTensorLiteral(at::Tensor tensor,
+                                                      MlirLocation loc) {
+  if (!tensor.device().is_cpu())
+    tensor = tensor.cpu();
+  if (!tensor.is_contiguous())
+    tensor = tensor.contiguous();
+
+  if (!externalWeightsStream.is_open()) {
+    externalWeightsStream.open(importOptions.externalWeightsFile,
+                               std::ios::binary | std::ios::trunc);
+    if (!externalWeightsStream) {
+      std::stringstream msg;
+      msg << "could not open external weights file '"
+          << importOptions.externalWeightsFile << "'";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+
+  // Each tensor starts on a page boundary so that the file can be mapped
+  // directly into memory and the data used in place.
+  constexpr int64_t kAlignment = 4096;
+  int64_t offset = externalWeightsStream.tellp();
+  int64_t alignedOffset = (offset + kAlignment - 1) / kAlignment * kAlignment;
+  std::vector<char> padding(alignedOffset - offset, 0);
+  externalWeightsStream.write(padding.data(), padding.size());
+  externalWeightsStream.write(static_cast<const char *>(tensor.data_ptr()),
+                              tensor.numel() * tensor.element_size());
+  externalWeightsStream.flush();
+  if (!externalWeightsStream) {
+    std::stringstream msg;
+    msg << "could not write to external weights file '"
+        << importOptions.externalWeightsFile << "'";
+    throw std::invalid_argument(msg.str());
+  }
+
+  std::vector<int64_t> shape(tensor.sizes().begin(), tensor.sizes().end());
+  MlirType dtype = getMlirTypeForTorchScalarType(loc, tensor.scalar_type());
+  MlirOperation literal = createMlirOperationAtEnd(
+      importBlock, "torch.vtensor.external_literal", loc,
+      torchMlirTorchValueTensorTypeGet(context, shape.size(), shape.data(),
+                                       dtype),
+      toMlirNamedAttribute(
+          "file", mlirStringAttrGet(context, toMlirStringRef(
+                                                 importOptions
+                                                     .externalWeightsFile))),
+      toMlirNamedAttribute(
+          "offset",
+          mlirIntegerAttrGet(mlirIntegerTypeGet(context, 64), alignedOffset)));
+  MlirOperation copy = createMlirOperationAtEnd(
+      importBlock, "torch.copy.to_tensor", loc,
+      torchMlirTorchNonValueTensorTypeGet(context, shape.size(), shape.data(),
+                                          dtype),
+      mlirOperationGetResult(literal, 0));
+  return mlirOperationGetResult(copy, 0);
+}
+
 void IValueImporter::importMethod(torch::jit::Function *function,
                                   MlirBlock classTypeBody,
                                   const MethodAnnotation &methodAnnotation) {
@@ -474,6 +592,50 @@ void IValueImporter::importClassType(c10::ClassType *classType) {
   createMlirOperationAtEnd(classTypeBody, "torch.class_type_terminator", loc);
 }
 
+// Returns the argument attributes for argument `argIndex` of a function with
+// annotation `annotation`, or a null attribute if there are none.
+static MlirAttribute getFunctionArgAttribute(MlirContext context,
+                                             MethodAnnotation *annotation,
+                                             int argIndex) {
+  if (!annotation || !annotation->argAnnotations.has_value()) {
+    return {nullptr};
+  }
+  c10::optional<std::vector<int64_t>> &maybeShape =
+      annotation->argAnnotations.value()[argIndex].shape;
+  c10::optional<c10::ScalarType> &maybeDtype =
+      annotation->argAnnotations.value()[argIndex].dtype;
+  bool hasValueSemantics =
+      annotation->argAnnotations.value()[argIndex].hasValueSemantics;
+
+  // TODO: Handle unranked tensors and tensors with unknown dtype (but
+  // possibly known ranks/sizes).
+  if (!maybeShape || !maybeDtype) {
+    return {nullptr};
+  }
+
+  std::vector<int64_t> shape = *maybeShape;
+  MlirType dtype = getMlirTypeForTorchScalarType(
+      mlirLocationUnknownGet(context), *maybeDtype);
+  MlirType typeBound;
+  // `std::vector`'s `.data()` method can return nullptr when the
+  // size is 0. This triggers the "nothing known about sizes" case in
+  // the C API constructor, when we want the "we know we have 0 sizes"
+  // case. So use a dummy data pointer.
+  int64_t dummy;
+  int64_t *shapeData = shape.size() == 0 ? &dummy : shape.data();
+  if (hasValueSemantics) {
+    typeBound = torchMlirTorchValueTensorTypeGet(context, shape.size(),
+                                                 shapeData, dtype);
+  } else {
+    typeBound = torchMlirTorchNonValueTensorTypeGet(
+        context, shape.size(), shapeData, dtype);
+  }
+
+  MlirNamedAttribute typeBoundAttr = toMlirNamedAttribute(
+      "torch.type_bound", mlirTypeAttrGet(typeBound));
+  return mlirDictionaryAttrGet(context, 1, &typeBoundAttr);
+}
+
 void IValueImporter::importCompilationUnit(torch::jit::CompilationUnit *cu) {
   if (compilationUnit == nullptr) {
     compilationUnit = cu;
@@ -493,55 +655,49 @@ void IValueImporter::importCompilationUnit(torch::jit::CompilationUnit *cu) {
     return;
   }
 
-  for (torch::jit::Function *function : cu->get_functions()) {
-    // Useful for debugging errors in free functions that end up being
-    // unused. These can be missing when round-tripping through the on-disk
-    // format, even though they still cause import issues when importing
-    // through the larger Python session where they originate.
-    // std::cerr << "NAME: " << function->qualname().qualifiedName() << "\n";
-    // std::cerr << *torch::jit::toGraphFunction(function).graph();
-    MethodAnnotation *annotation =
-        annotator.getMethodAnnotationForFunction(function);
-    MlirOperation func = importJitFunctionAsFuncOp(
-        context, function, [&](int argIndex) -> MlirAttribute {
-          if (!annotation || !annotation->argAnnotations.has_value()) {
-            return {nullptr};
-          }
-          c10::optional<std::vector<int64_t>> &maybeShape =
-              annotation->argAnnotations.value()[argIndex].shape;
-          c10::optional<c10::ScalarType> &maybeDtype =
-              annotation->argAnnotations.value()[argIndex].dtype;
-          bool hasValueSemantics =
-              annotation->argAnnotations.value()[argIndex].hasValueSemantics;
-
-          // TODO: Handle unranked tensors and tensors with unknown dtype (but
-          // possibly known ranks/sizes).
-          if (!maybeShape || !maybeDtype) {
-            return {nullptr};
-          }
-
-          std::vector<int64_t> shape = *maybeShape;
-          MlirType dtype = getMlirTypeForTorchScalarType(
-              mlirLocationUnknownGet(context), *maybeDtype);
-          MlirType typeBound;
-          // `std::vector`'s `.data()` method can return nullptr when the
-          // size is 0. This triggers the "nothing known about sizes" case in
-          // the C API constructor, when we want the "we know we have 0 sizes"
-          // case. So use a dummy data pointer.
-          int64_t dummy;
-          int64_t *shapeData = shape.size() == 0 ? &dummy : shape.data();
-          if (hasValueSemantics) {
-            typeBound = torchMlirTorchValueTensorTypeGet(context, shape.size(),
-                                                         shapeData, dtype);
-          } else {
-            typeBound = torchMlirTorchNonValueTensorTypeGet(
-                context, shape.size(), shapeData, dtype);
-          }
-
-          MlirNamedAttribute typeBoundAttr = toMlirNamedAttribute(
-              "torch.type_bound", mlirTypeAttrGet(typeBound));
-          return mlirDictionaryAttrGet(context, 1, &typeBoundAttr);
-        });
+  // Converting the graphs of the functions is independent for each function
+  // and dominates import time for large models, so it is done in parallel,
+  // building each func op detached from the module. This relies on the MLIR
+  // context having multithreading enabled (the default). The func ops are then
+  // inserted into the module in the original order of `cu->get_functions()`
+  // so that the output is deterministic.
+  std::vector<torch::jit::Function *> functions = cu->get_functions();
+  // Functions can be compiled lazily, which is not safe to do concurrently, so
+  // force it up front.
+  for (torch::jit::Function *function : functions)
+    function->ensure_defined();
+
+  std::vector<MlirOperation> funcs(functions.size(), MlirOperation{nullptr});
+  try {
+    at::parallel_for(0, functions.size(), /*grain_size=*/1,
+                     [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        torch::jit::Function *function = functions[i];
+        // Useful for debugging errors in free functions that end up being
+        // unused. These can be missing when round-tripping through the
+        // on-disk format, even though they still cause import issues when
+        // importing through the larger Python session where they originate.
+        // std::cerr << "NAME: " << function->qualname().qualifiedName()
+        //           << "\n";
+        // std::cerr << *torch::jit::toGraphFunction(function).graph();
+        MethodAnnotation *annotation =
+            annotator.getMethodAnnotationForFunction(function);
+        funcs[i] = importJitFunctionAsFuncOp(
+            context, function, [&](int argIndex) -> MlirAttribute {
+              return getFunctionArgAttribute(context, annotation, argIndex);
+            },
+            importOptions);
+      }
+    });
+  } catch (...) {
+    for (MlirOperation func : funcs) {
+      if (!mlirOperationIsNull(func))
+        mlirOperationDestroy(func);
+    }
+    throw;
+  }
+
+  for (MlirOperation func : funcs) {
     // For IValue importing, the logical linkage structure of the module
     // is determined by the object graph.
     //
@@ -560,10 +716,12 @@ void IValueImporter::importCompilationUnit(torch::jit::CompilationUnit *cu) {
 }
 
 MlirValue torch_mlir::importIValue(c10::IValue ivalue, MlirBlock block,
-                              MlirContext context, ClassAnnotator &annotator) {
+                                   MlirContext context,
+                                   ClassAnnotator &annotator,
+                                   const ImportOptions &importOptions) {
   // When debugging module importing, it can be useful to dump as so:
   // if (ivalue.isModule())
   //   ivalue.toModule().dump(true, false, false);
-  IValueImporter importer(block, context, annotator);
+  IValueImporter importer(block, context, annotator, importOptions);
   return importer.importIValue(ivalue);
 }
@@ -13,6 +13,7 @@
 #include <memory>
 
 #include "class_annotator.h"
+#include "import_options.h"
 
 #include "mlir-c/IR.h"
 
@@ -25,7 +26,8 @@ namespace torch_mlir {
 /// Main entry-point for importing torch IValue's .
 /// Recursively imports `ivalue`, inserting operations at the end of `block`.
 MlirValue importIValue(c10::IValue ivalue, MlirBlock block, MlirContext context,
-                       ClassAnnotator &annotator);
+                       ClassAnnotator &annotator,
+                       const ImportOptions &importOptions);
 
 } // namespace torch_mlir
 
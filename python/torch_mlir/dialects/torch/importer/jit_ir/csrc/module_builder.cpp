@@ -18,8 +18,14 @@
 #include "mlir-c/BuiltinTypes.h"
 #include "mlir-c/Diagnostics.h"
 #include "mlir-c/Registration.h"
+#include "torch-mlir-c/Context.h"
 #include "torch-mlir-c/Registration.h"
 
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace py = pybind11;
 using namespace torch_mlir;
 
@@ -27,13 +33,6 @@ static py::object getMlirIrClass(const char *className) {
   return py::module::import(MAKE_MLIR_PYTHON_QUALNAME("ir")).attr(className);
 }
 
-static py::object createPythonContextIfNone(py::object contextObj) {
-  if (contextObj.is_none()) {
-    contextObj = getMlirIrClass("Context")();
-  }
-  return contextObj;
-}
-
 static MlirContext castPythonObjectToMlirContext(py::object &contextObj) {
   assert(!contextObj.is_none() && "context cannot be None");
   auto contextCapsule = contextObj.attr(MLIR_PYTHON_CAPI_PTR_ATTR);
@@ -45,6 +44,17 @@ static MlirContext castPythonObjectToMlirContext(py::object &contextObj) {
   return context;
 }
 
+static py::object createPythonContextIfNone(py::object contextObj) {
+  if (contextObj.is_none()) {
+    contextObj = getMlirIrClass("Context")();
+    // Each import gets a context of its own, and many may be compiled at
+    // once, so they share their threads.
+    torchMlirContextUseSharedThreadPool(
+        castPythonObjectToMlirContext(contextObj));
+  }
+  return contextObj;
+}
+
 static py::object castMlirModuleToPythonObject(MlirModule module) {
   auto moduleClass = getMlirIrClass("Module");
   auto moduleCapsule =
@@ -75,6 +85,9 @@ stringifyMlirDiagnosticSeverity(MlirDiagnosticSeverity severity) {
 }
 
 static void printDiagnostic(MlirDiagnostic diagnostic) {
+  // Diagnostics can be emitted from the importer's worker threads, which do
+  // not hold the GIL.
+  py::gil_scoped_acquire acquire;
   std::stringstream ss;
   ss << stringifyMlirDiagnosticSeverity(mlirDiagnosticGetSeverity(diagnostic))
      << ": ";
@@ -95,6 +108,8 @@ static void printDiagnostic(MlirDiagnostic diagnostic) {
 static void registerPythonSysStderrDiagnosticHandler(MlirContext context) {
   auto diagnosticHandler = [](MlirDiagnostic diagnostic,
                               void *) -> MlirLogicalResult {
+    // Pass pipelines run without holding the GIL.
+    py::gil_scoped_acquire acquire;
     printDiagnostic(diagnostic);
     for (int i = 0, e = mlirDiagnosticGetNumNotes(diagnostic); i != e; i++) {
       printDiagnostic(mlirDiagnosticGetNote(diagnostic, i));
@@ -125,16 +140,24 @@ ModuleBuilder::ModuleBuilder(pybind11::object contextObj)
 }
 
 torch::jit::StrongFunctionPtr
-ModuleBuilder::importFunction(torch::jit::StrongFunctionPtr function) {
+ModuleBuilder::importFunction(torch::jit::StrongFunctionPtr function,
+                              LocationImportMode locationImportMode) {
   MlirBlock block = getBodyBlock();
   MlirOperation terminator = this->terminator;
-  MlirOperation func = importJitFunctionAsFuncOp(context, function.function_);
+  ImportOptions importOptions;
+  importOptions.locationImportMode = locationImportMode;
+  MlirOperation func = importJitFunctionAsFuncOp(
+      context, function.function_,
+      [](int) -> MlirAttribute { return {nullptr}; }, importOptions);
   mlirBlockInsertOwnedOperationBefore(block, terminator, func);
   return function;
 }
 
 void ModuleBuilder::importModule(torch::jit::Module jitModule,
-                                 py::object maybeClassAnnotator) {
+                                 py::object maybeClassAnnotator,
+                                 py::object maybeExternalWeightsFile,
+                                 int64_t externalWeightsMinBytes,
+                                 LocationImportMode locationImportMode) {
   ClassAnnotator dummyAnnotator;
   ClassAnnotator *classAnnotator = &dummyAnnotator;
   if (!maybeClassAnnotator.is_none()) {
@@ -163,8 +186,161 @@ void ModuleBuilder::importModule(torch::jit::Module jitModule,
   mlirOperationSetAttributeByName(mlirModuleGetOperation(module),
                                   toMlirStringRef("torch.debug_module_name"),
                                   debugModuleNameAttr);
+  ImportOptions importOptions;
+  if (!maybeExternalWeightsFile.is_none()) {
+    importOptions.externalWeightsFile =
+        py::cast<std::string>(maybeExternalWeightsFile);
+  }
+  importOptions.externalWeightsMinBytes = externalWeightsMinBytes;
+  importOptions.locationImportMode = locationImportMode;
+  // The import of function bodies happens on a thread pool, so release the
+  // GIL to allow any diagnostics from the workers to be printed.
+  py::gil_scoped_release release;
   importIValue(jitModule._ivalue(), mlirModuleGetBody(module),
-               mlirModuleGetContext(module), *classAnnotator);
+               mlirModuleGetContext(module), *classAnnotator, importOptions);
+}
+
+namespace {
+/// Describes everything that the import of a module depends on: the graphs of
+/// the methods of its objects and of the functions and methods that they
+/// call, the class types and attributes of its objects, and the annotations.
+/// The other functions of the compilation unit, e.g. the ones of unrelated
+/// scripted code, are left out, as they don't change the lowered module. The
+/// tensors are described by their identity and version counter rather than by
+/// their contents, so that equal descriptions of live tensors imply equal
+/// contents.
+class ImportFingerprinter {
+public:
+  void addFunction(torch::jit::Function *function) {
+    if (!functions.insert(function).second)
+      return;
+    function->ensure_defined();
+    std::shared_ptr<torch::jit::Graph> graph =
+        torch::jit::toGraphFunction(*function).graph();
+    ss << "function " << function->qualname().qualifiedName() << "\n"
+       << graph->toString();
+    addCallees(graph->block());
+  }
+
+  void addClassAnnotator(ClassAnnotator &annotator) {
+    // The annotations are kept in a hash map, so sort them for a
+    // deterministic description.
+    std::vector<std::string> annotations;
+    for (auto &it : annotator.getAnnotationMap())
+      annotations.push_back(it.second->toString());
+    std::sort(annotations.begin(), annotations.end());
+    for (const std::string &annotation : annotations)
+      ss << annotation;
+  }
+
+  void addIValue(const c10::IValue &ivalue) {
+    if (ivalue.isTensor() && ivalue.toTensor().has_storage()) {
+      const at::Tensor &tensor = ivalue.toTensor();
+      ss << "tensor " << tensor.unsafeGetTensorImpl() << " "
+         << tensor.storage().unsafeGetStorageImpl() << " "
+         << tensor.storage().data() << " " << tensor._version() << " "
+         << tensor.scalar_type() << " " << tensor.sizes() << " "
+         << tensor.strides() << " " << tensor.storage_offset() << " "
+         << tensor.is_quantized() << "\n";
+      tensors.push_back(tensor);
+      return;
+    }
+    if (ivalue.isObject() && !ivalue.isCustomClass()) {
+      c10::ivalue::Object *object = ivalue.toObject().get();
+      auto it = objectIndices.find(object);
+      if (it != objectIndices.end()) {
+        ss << "object #" << it->second << "\n";
+        return;
+      }
+      int index = objectIndices.size();
+      objectIndices[object] = index;
+      const c10::ClassTypePtr &classType = object->type();
+      for (torch::jit::Function *method : classType->methods())
+        addFunction(method);
+      ss << "object " << classType->name()->qualifiedName() << " {\n";
+      const std::vector<c10::ClassAttribute> &attributes =
+          classType->getAttributes();
+      for (int i = 0, e = attributes.size(); i != e; i++) {
+        ss << attributes[i].getName() << ": "
+           << attributes[i].getType()->annotation_str() << " = ";
+        addIValue(object->getSlot(i));
+      }
+      ss << "}\n";
+      return;
+    }
+    if (ivalue.isList()) {
+      ss << "list " << ivalue.type()->annotation_str() << " [\n";
+      for (const c10::IValue &element : ivalue.toListRef())
+        addIValue(element);
+      ss << "]\n";
+      return;
+    }
+    if (ivalue.isTuple()) {
+      ss << "tuple (\n";
+      for (const c10::IValue &element : ivalue.toTupleRef().elements())
+        addIValue(element);
+      ss << ")\n";
+      return;
+    }
+    if (ivalue.isGenericDict()) {
+      ss << "dict " << ivalue.type()->annotation_str() << " {\n";
+      for (const auto &entry : ivalue.toGenericDict()) {
+        addIValue(entry.key());
+        addIValue(entry.value());
+      }
+      ss << "}\n";
+      return;
+    }
+    if (ivalue.isNone() || ivalue.isBool() || ivalue.isInt() ||
+        ivalue.isDouble() || ivalue.isString() || ivalue.isDevice()) {
+      ss << ivalue.tagKind() << " " << ivalue << "\n";
+      return;
+    }
+    // E.g. the packed parameters of quantized ops, which can't be described
+    // without their contents.
+    cacheable = false;
+  }
+
+  std::stringstream ss;
+  std::vector<at::Tensor> tensors;
+  bool cacheable = true;
+
+private:
+  /// Adds the functions and methods called in `block`, like the importer
+  /// resolves them.
+  void addCallees(torch::jit::Block *block) {
+    for (torch::jit::Node *node : block->nodes()) {
+      if (node->kind() == c10::prim::CallFunction) {
+        if (auto functionType =
+                node->input(0)->type()->cast<c10::FunctionType>())
+          addFunction(functionType->function());
+      } else if (node->kind() == c10::prim::CallMethod) {
+        if (auto classType = node->input(0)->type()->cast<c10::ClassType>())
+          addFunction(classType->findMethod(node->s(c10::attr::name)));
+      }
+      for (torch::jit::Block *nested : node->blocks())
+        addCallees(nested);
+      if (node->hasAttribute(c10::attr::Subgraph))
+        addCallees(node->g(c10::attr::Subgraph)->block());
+    }
+  }
+
+  std::unordered_map<c10::ivalue::Object *, int> objectIndices;
+  std::unordered_set<torch::jit::Function *> functions;
+};
+} // namespace
+
+py::tuple ModuleBuilder::getImportFingerprint(torch::jit::Module jitModule,
+                                              py::object maybeClassAnnotator) {
+  ImportFingerprinter fingerprinter;
+  if (!maybeClassAnnotator.is_none()) {
+    fingerprinter.addClassAnnotator(
+        *py::cast<ClassAnnotator *>(maybeClassAnnotator));
+  }
+  fingerprinter.addIValue(jitModule._ivalue());
+  if (!fingerprinter.cacheable)
+    return py::make_tuple(py::none(), std::vector<at::Tensor>());
+  return py::make_tuple(fingerprinter.ss.str(), fingerprinter.tensors);
 }
 
 MlirBlock ModuleBuilder::getBodyBlock() {
@@ -173,11 +349,24 @@ MlirBlock ModuleBuilder::getBodyBlock() {
 }
 
 void ModuleBuilder::bind(py::module &m) {
+  py::enum_<LocationImportMode>(m, "LocationImportMode")
+      .value("ALL", LocationImportMode::All)
+      .value("FUNCTION", LocationImportMode::Function)
+      .value("NONE", LocationImportMode::None);
   py::class_<ModuleBuilder>(m, "ModuleBuilder")
       .def(py::init<py::object>(), py::arg("context") = py::none())
       .def_property_readonly("context", &ModuleBuilder::getContextObj)
       .def_property_readonly("module", &ModuleBuilder::getModuleObj)
-      .def("import_function", &ModuleBuilder::importFunction)
+      .def("import_function", &ModuleBuilder::importFunction,
+           py::arg("function"),
+           py::arg("locationImportMode") = LocationImportMode::All)
       .def("import_module", &ModuleBuilder::importModule, py::arg("module"),
-           py::arg("classAnnotator") = py::none());
+           py::arg("classAnnotator") = py::none(),
+           py::arg("externalWeightsFile") = py::none(),
+           py::arg("externalWeightsMinBytes") =
+               ImportOptions().externalWeightsMinBytes,
+           py::arg("locationImportMode") = LocationImportMode::All)
+      .def_static("get_import_fingerprint",
+                  &ModuleBuilder::getImportFingerprint, py::arg("module"),
+                  py::arg("classAnnotator") = py::none());
 }
@@ -11,6 +11,7 @@
 #define TORCHMLIRJITIRIMPORTER_CSRC_BUILDER_H
 
 #include "class_annotator.h"
+#include "import_options.h"
 
 #include "mlir-c/IR.h"
 
@@ -39,13 +40,31 @@ public:
   // Just a bit of naming cruft.
   // Returns the same function, making it suitable as a nested decorator.
   torch::jit::StrongFunctionPtr
-  importFunction(torch::jit::StrongFunctionPtr function);
+  importFunction(torch::jit::StrongFunctionPtr function,
+                 LocationImportMode locationImportMode);
 
   // Imports a torch::jit::Module into the current module, using the
   // annotations, if not none, provided in `maybeClassAnnotator` which should be
   // a ClassAnnotator.
+  // If `maybeExternalWeightsFile` is not none, tensors of at least
+  // `externalWeightsMinBytes` bytes are written to that file and imported as
+  // `torch.vtensor.external_literal` ops instead of being embedded in the IR.
   void importModule(torch::jit::Module jitModule,
-                    py::object maybeClassAnnotator);
+                    py::object maybeClassAnnotator,
+                    py::object maybeExternalWeightsFile,
+                    int64_t externalWeightsMinBytes,
+                    LocationImportMode locationImportMode);
+
+  // Returns a description of everything that importing `jitModule` with the
+  // annotations of `maybeClassAnnotator` depends on, and the tensors that it
+  // refers to. Only the functions that the methods of the module call are
+  // described, not the others of its compilation unit, which the import
+  // still has but the lowering drops. Within a process, equal descriptions of
+  // modules whose tensors are still alive give equal lowered modules, so the
+  // description can key a cache of them that keeps weak references to the
+  // tensors. The description is None for modules that can't be described.
+  static py::tuple getImportFingerprint(torch::jit::Module jitModule,
+                                        py::object maybeClassAnnotator);
 
 private:
   MlirBlock getBodyBlock();
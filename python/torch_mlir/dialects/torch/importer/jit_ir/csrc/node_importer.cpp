@@ -31,7 +31,10 @@ using Node = torch::jit::Node;
 namespace {
 class NodeImporter {
 public:
-  NodeImporter(MlirContext context) : context(context) {}
+  NodeImporter(MlirContext context, const ImportOptions &importOptions,
+               MlirLocation functionLoc)
+      : context(context), importOptions(importOptions),
+        functionLoc(functionLoc) {}
 
   void importNode(Node *node, MlirBlock appendToBlock);
   MlirBlock importBlock(
@@ -39,6 +42,7 @@ public:
       c10::optional<c10::ArrayRef<MlirType>> blockArgTypes = c10::nullopt);
 
 private:
+  MlirLocation getLocation(Node *node);
   MlirBlock
   createBlockFor(Block *jitBlock,
                  c10::optional<c10::ArrayRef<MlirType>> blockArgTypes);
@@ -48,6 +52,9 @@ private:
   std::vector<MlirValue> lookupMappedValues(c10::ArrayRef<Value *> values);
 
   MlirContext context;
+  const ImportOptions &importOptions;
+  // The location of all ops when using `LocationImportMode::Function`.
+  MlirLocation functionLoc;
   std::unordered_map<Value *, MlirValue> valueMap;
 };
 } // namespace
@@ -76,8 +83,20 @@ rearrangeDictConstructInputs(std::vector<MlirValue> &inputs) {
   return rearranged;
 }
 
+MlirLocation NodeImporter::getLocation(Node *node) {
+  switch (importOptions.locationImportMode) {
+  case LocationImportMode::All:
+    return getMlirLocationFromNode(context, node);
+  case LocationImportMode::Function:
+    return functionLoc;
+  case LocationImportMode::None:
+    break;
+  }
+  return mlirLocationUnknownGet(context);
+}
+
 void NodeImporter::importNode(Node *node, MlirBlock appendToBlock) {
-  MlirLocation loc = getMlirLocationFromNode(context, node);
+  MlirLocation loc = getLocation(node);
   auto kind = node->kind();
 
   auto createAndMapTrivialNode = [&](Node *node, const std::string &opName,
@@ -195,10 +214,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock) {
                                                       c10::attr::value)))));
     } else if (output->type()->cast<c10::TensorType>()) {
       MlirAttribute attr = importAttribute(loc, node, c10::attr::value);
-      op = createMlirOperation(
-          "torch.tensor.literal", loc,
-          torchMlirTorchNonValueTensorTypeGetFromAttribute(attr),
-          toMlirNamedAttribute("value", attr));
+      op = torchMlirTensorLiteralCreate(loc, attr, /*valueSemantics=*/false);
     } else if (output->type()->cast<c10::DeviceObjType>()) {
       op = createMlirOperation(
           "torch.constant.device", loc,
@@ -217,10 +233,15 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock) {
               mlirFlatSymbolRefAttrGet(context, toMlirStringRef(symName))));
     } else if (output->type()->cast<c10::ListType>()) {
       ClassAnnotator dummyAnnotator;
+      // Constants are always embedded in the IR, since each function is
+      // imported independently.
+      ImportOptions constantImportOptions = importOptions;
+      constantImportOptions.externalWeightsFile.clear();
       MlirValue listValue = importIValue(node->ival(c10::attr::value),
                                          appendToBlock,
                                          context,
-                                         dummyAnnotator);
+                                         dummyAnnotator,
+                                         constantImportOptions);
       mapResults(node, mlirOpResultGetOwner(listValue));
       return; // Early return, since `importIValue` already added op to block.
     } else {
@@ -352,7 +373,7 @@ MlirBlock NodeImporter::importBlock(
 MlirBlock NodeImporter::createBlockFor(
     Block *jitBlock, c10::optional<c10::ArrayRef<MlirType>> blockArgTypes) {
   Node *paramNode = jitBlock->param_node();
-  MlirLocation loc = getMlirLocationFromNode(context, paramNode);
+  MlirLocation loc = getLocation(paramNode);
   std::vector<MlirType> paramNodeTypes =
       getMlirTypesFromValues(loc, paramNode->outputs());
   if (!blockArgTypes)
@@ -405,7 +426,11 @@ NodeImporter::lookupMappedValues(c10::ArrayRef<Value *> values) {
 MlirBlock
 torch_mlir::importBlock(MlirContext context, Block *jitBlock,
                         CreateTerminatorFn createTerminator,
-                        c10::optional<c10::ArrayRef<MlirType>> blockArgTypes) {
-  NodeImporter importer(context);
+                        c10::optional<c10::ArrayRef<MlirType>> blockArgTypes,
+                        const ImportOptions &importOptions) {
+  MlirLocation functionLoc = mlirLocationUnknownGet(context);
+  if (importOptions.locationImportMode == LocationImportMode::Function)
+    functionLoc = getMlirLocationFromBlock(context, jitBlock);
+  NodeImporter importer(context, importOptions, functionLoc);
   return importer.importBlock(jitBlock, createTerminator, blockArgTypes);
 }
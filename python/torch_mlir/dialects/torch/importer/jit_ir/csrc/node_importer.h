@@ -12,6 +12,8 @@
 
 #include <memory>
 
+#include "import_options.h"
+
 #include "mlir-c/IR.h"
 
 #include <torch/csrc/jit/api/compilation_unit.h>
@@ -34,10 +36,14 @@ using CreateTerminatorFn =
 /// are required to be for correctness. The code will internally attempt to
 /// adjust the types to the block argument types.
 /// TODO: Formalize what type conversions are allowed here.
+///
+/// `jitBlock` is expected to be the body of a function, which is relevant for
+/// `LocationImportMode::Function`.
 MlirBlock importBlock(
     MlirContext context, torch::jit::Block *jitBlock,
     CreateTerminatorFn createTerminator,
-    c10::optional<c10::ArrayRef<MlirType>> blockArgTypes = c10::nullopt);
+    c10::optional<c10::ArrayRef<MlirType>> blockArgTypes = c10::nullopt,
+    const ImportOptions &importOptions = {});
 
 } // namespace torch_mlir
 
@@ -12,6 +12,7 @@
 #include "ivalue_importer.h"
 
 #include <ATen/TensorUtils.h>
+#include <algorithm>
 #include <unordered_map>
 
 #include "mlir_utils.h"
@@ -19,6 +20,7 @@
 #include "mlir-c/BuiltinAttributes.h"
 #include "mlir-c/BuiltinTypes.h"
 #include "mlir-c/Diagnostics.h"
+#include "mlir-c/Dialect/SparseTensor.h"
 #include "torch-mlir-c/TorchOps.h"
 #include "torch-mlir-c/TorchTypes.h"
 
@@ -266,17 +268,72 @@ torch_mlir::getFunctionTypeFromSchema(MlirContext context,
                              outputTypes.size(), outputTypes.data());
 }
 
+/// Returns the `#sparse_tensor.encoding` that a sparse COO tensor of `rank`
+/// is stored with: a compressed vector, or CSR for matrices, the formats the
+/// sparse compiler generates the most efficient loops for.
+static MlirAttribute getSparseTensorEncoding(MlirContext context,
+                                             int64_t rank) {
+  std::vector<MlirSparseTensorDimLevelType> dimLevelTypes(
+      rank, MLIR_SPARSE_TENSOR_DIM_LEVEL_DENSE);
+  dimLevelTypes.back() = MLIR_SPARSE_TENSOR_DIM_LEVEL_COMPRESSED;
+  return mlirSparseTensorEncodingAttrGet(
+      context, dimLevelTypes.size(), dimLevelTypes.data(),
+      /*dimOrdering=*/MlirAffineMap{nullptr}, /*pointerBitWidth=*/0,
+      /*indexBitWidth=*/0);
+}
+
+MlirAttribute
+torch_mlir::convertSparseTensorToMlirElementsAttr(at::Tensor tensor,
+                                                  MlirLocation loc) {
+  if (tensor.layout() != c10::Layout::Sparse || tensor.dim() < 1 ||
+      tensor.dim() > 2 || tensor.dense_dim() != 0) {
+    std::stringstream msg;
+    msg << "Unsupported import sparse tensor: " << tensor
+        << " (only sparse COO vectors and matrices without dense dimensions "
+           "are supported)";
+    throw std::invalid_argument(msg.str());
+  }
+  MlirContext context = mlirLocationGetContext(loc);
+  tensor = tensor.cpu().coalesce();
+
+  // The indices of a COO tensor are a `rank x nnz` matrix, while those of a
+  // SparseElementsAttr are a `nnz x rank` one.
+  at::Tensor indices = tensor.indices().t().contiguous();
+  std::vector<int64_t> indicesShape(indices.sizes().begin(),
+                                    indices.sizes().end());
+  MlirAttribute denseIndices = mlirDenseElementsAttrInt64Get(
+      mlirRankedTensorTypeGet(indicesShape.size(), indicesShape.data(),
+                              mlirIntegerTypeGet(context, 64),
+                              mlirAttributeGetNull()),
+      indices.numel(), indices.data_ptr<int64_t>());
+  MlirAttribute denseValues =
+      convertTensorToMlirElementsAttr(tensor.values(), loc);
+
+  std::vector<int64_t> shape(tensor.sizes().begin(), tensor.sizes().end());
+  MlirType type = mlirRankedTensorTypeGet(
+      shape.size(), shape.data(),
+      mlirShapedTypeGetElementType(mlirAttributeGetType(denseValues)),
+      getSparseTensorEncoding(context, shape.size()));
+  return mlirSparseElementsAttribute(type, denseIndices, denseValues);
+}
+
 MlirAttribute torch_mlir::convertTensorToMlirElementsAttr(at::Tensor tensor,
                                                           MlirLocation loc) {
-  using at::ScalarType;
-
   auto throwUnsupportedTensorError = [&]() {
     std::stringstream msg;
     msg << "Unsupported import tensor type: " << tensor;
     throw std::invalid_argument(msg.str());
   };
 
-  // Get a C-contiguous form as we can bulk-load that into a DenseElementsAttr.
+  if (tensor.is_sparse())
+    return convertSparseTensorToMlirElementsAttr(tensor, loc);
+
+  // Get a C-contiguous CPU form as we can bulk-load that into a
+  // DenseElementsAttr. Both of these are no-ops (and do not copy) for the
+  // common case of a CPU-resident, contiguous parameter, so the only copy of
+  // the data made during import is the one owned by the attribute itself.
+  if (!tensor.device().is_cpu())
+    tensor = tensor.cpu();
   if (!tensor.is_contiguous())
     tensor = tensor.contiguous();
 
@@ -285,61 +342,25 @@ MlirAttribute torch_mlir::convertTensorToMlirElementsAttr(at::Tensor tensor,
   at::checkLayout(at::CheckedFrom("accessing contiguous"), tensor,
                   c10::Layout::Strided);
 
-  // Construct the ShapedType.
-
   // The element type is usually just the mapped ScalarType itself, but for
-  // quantized types it might differ (e.g. QInt8 becomes Char). Caller code is
-  // responsible for materializing the proper op that incorporates the
-  // quantization scheme to create a tensor of e.g. `!torch.qint8` element type.
-  MlirType elementType = getMlirTypeForTorchScalarType(
-      loc, c10::toUnderlying(tensor.scalar_type()));
+  // quantized types it is the integer type they are made of (e.g. QInt8
+  // becomes Char). Caller code is responsible for materializing the proper op
+  // that incorporates the quantization scheme to create a tensor of e.g.
+  // `!torch.qint8` element type.
+  //
+  // The contiguous storage of the tensor is handed over directly rather than
+  // going through the per-dtype getters (which build an intermediate ArrayRef
+  // and convert element-by-element). The tensor outlives the call, so there
+  // is no deleter.
   std::vector<int64_t> shape(tensor.sizes().begin(), tensor.sizes().end());
-  MlirType shapedType = mlirRankedTensorTypeGetChecked(
-      loc, shape.size(), shape.data(), elementType, {nullptr});
-  if (mlirTypeIsNull(shapedType)) {
-    throwUnsupportedTensorError();
-  }
-
-  // Import DenseElementsAttr data.
-  // TODO: Support bool tensors.
-  // TODO: More import formats in C-API.
-  auto numElements = tensor.numel();
-  auto tensor_cpu = tensor.cpu().contiguous();
-  auto tensorData = tensor_cpu.data_ptr();
-  switch (tensor.scalar_type()) {
-  case ScalarType::Int:
-    return mlirDenseElementsAttrInt32Get(
-        shapedType, numElements, static_cast<const int32_t *>(tensorData));
-    break;
-  case ScalarType::Long:
-    return mlirDenseElementsAttrInt64Get(
-        shapedType, numElements, static_cast<const int64_t *>(tensorData));
-    break;
-  case ScalarType::Float:
-    return mlirDenseElementsAttrFloatGet(
-        shapedType, numElements, static_cast<const float *>(tensorData));
-    break;
-  case ScalarType::Double:
-    return mlirDenseElementsAttrDoubleGet(
-        shapedType, numElements, static_cast<const double *>(tensorData));
-    break;
-  case ScalarType::Bool:
-    return mlirDenseElementsAttrBoolGet(shapedType, numElements,
-                                        static_cast<const int *>(tensorData));
-    break;
-  case ScalarType::QInt8:
-    return mlirDenseElementsAttrInt8Get(
-        shapedType, numElements, static_cast<const int8_t *>(tensorData));
-  case ScalarType::QUInt8:
-    return mlirDenseElementsAttrUInt8Get(
-        shapedType, numElements, static_cast<const uint8_t *>(tensorData));
-  case ScalarType::BFloat16:
-    return mlirDenseElementsAttrBFloat16Get(
-        shapedType, numElements, static_cast<const uint16_t *>(tensorData));
-  default:
+  MlirAttribute attr = torchMlirTensorLiteralElementsGet(
+      loc, shape.size(), shape.data(),
+      static_cast<int8_t>(tensor.scalar_type()),
+      tensor.numel() * tensor.element_size(), tensor.data_ptr(),
+      /*deleter=*/nullptr, /*userData=*/nullptr);
+  if (mlirAttributeIsNull(attr))
     throwUnsupportedTensorError();
-  }
-  return {nullptr}; // Unreachable.
+  return attr;
 }
 
 MlirAttribute torch_mlir::importAttribute(MlirLocation loc,
@@ -381,6 +402,15 @@ MlirLocation torch_mlir::getMlirLocationFromNode(MlirContext context,
   return mlirLocationUnknownGet(context);
 }
 
+MlirLocation torch_mlir::getMlirLocationFromBlock(MlirContext context,
+                                                  torch::jit::Block *block) {
+  for (torch::jit::Node *node : block->nodes()) {
+    if (node->sourceRange().file_line_col())
+      return getMlirLocationFromNode(context, node);
+  }
+  return mlirLocationUnknownGet(context);
+}
+
 std::vector<MlirType>
 torch_mlir::getMlirTypesFromValues(MlirLocation loc,
                                    c10::ArrayRef<torch::jit::Value *> values) {
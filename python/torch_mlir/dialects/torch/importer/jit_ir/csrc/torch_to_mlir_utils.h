@@ -55,12 +55,22 @@ MlirType getFunctionTypeFromSchema(MlirContext context,
 MlirAttribute convertTensorToMlirElementsAttr(at::Tensor tensor,
                                               MlirLocation loc);
 
+/// Creates a SparseElementsAttr that holds the same values as the sparse COO
+/// `tensor`, whose type has the `#sparse_tensor.encoding` of its layout.
+MlirAttribute convertSparseTensorToMlirElementsAttr(at::Tensor tensor,
+                                                    MlirLocation loc);
+
 MlirAttribute importAttribute(MlirLocation loc, torch::jit::Node *node,
                               c10::Symbol symbol);
 
 MlirLocation getMlirLocationFromNode(MlirContext context,
                                      torch::jit::Node *node);
 
+/// Returns the location of the first node in `block` that has a source
+/// location, or an unknown location if there is none.
+MlirLocation getMlirLocationFromBlock(MlirContext context,
+                                      torch::jit::Block *block);
+
 std::vector<MlirType>
 getMlirTypesFromValues(MlirLocation loc,
                        c10::ArrayRef<torch::jit::Value *> values);
@@ -1,3 +1,6 @@
 import os
 
 EAGER_MODE_DEBUG = os.environ.get("EAGER_MODE_DEBUG", 'False').lower() in ('true', '1', 't')
+EAGER_MODE_LAZY = os.environ.get("EAGER_MODE_LAZY", 'False').lower() in ('true', '1', 't')
+EAGER_MODE_ASYNC_COMPILE = os.environ.get("EAGER_MODE_ASYNC_COMPILE", 'False').lower() in ('true', '1', 't')
+EAGER_MODE_DYNAMIC_SHAPES = os.environ.get("EAGER_MODE_DYNAMIC_SHAPES", 'False').lower() in ('true', '1', 't')
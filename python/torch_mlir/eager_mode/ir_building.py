@@ -23,7 +23,7 @@ to convert the TorchScript function into MLIR using the `torch` dialect.
 
 import abc
 import re
-from typing import Any, Optional, Iterable, Dict
+from typing import Any, Callable, Optional, Iterable, Dict
 from typing import Union
 
 import numpy as np
@@ -35,6 +35,7 @@ from torch._ops import OpOverload
 from torch_mlir import ir
 from torch_mlir.dialects.func import FuncOp
 from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+from torch_mlir.eager_mode.torch_mlir_dispatch import get_dynamic_shape
 
 
 class TorchMlirType(abc.ABC):
@@ -220,32 +221,25 @@ def is_list_of_tensors_type(typ: torch._C.Type):
 name_mangle_regex = re.compile("[^a-zA-Z0-9]")
 
 
-def build_ts_script_function(
-    schema: torch._C.FunctionSchema, kwargs: Dict[str, Any]
-) -> torch.jit.ScriptFunction:
-    """Build a torch.jit.ScriptFunction that corresponds to the schema.
-
-    Constants are inlined for the purposes of invalidating the compile cache when they change.
+def insert_op_node(
+    graph: torch._C.Graph,
+    schema: torch._C.FunctionSchema,
+    kwargs: Dict[str, Any],
+    get_tensor_input: Callable[[str, torch._C.Type], torch._C.Value],
+) -> torch._C.Node:
+    """Insert a node for the op with `schema` at the end of `graph`.
 
-    Parameters
-    ----------
-    schema: torch._C.FunctionSchema
-        PyTorch's representation for ops, contains type information needed for inlining constants into the TS graph.
-    kwargs: Dict
-        A dictionary with all arguments passed in through __torch_dispatch__ (including int/float/bool params).
+    Constants are inlined, and the value of each tensor arg is given by `get_tensor_input`, called with the name of
+    the arg in `kwargs` and its TorchScript type.
 
     Returns
     -------
-    torch.jit.ScriptFunction
-        Fully specialized (all constants) TS graph whose only arguments are tensors.
+    torch._C.Node
+        The node of the op, whose outputs are the results of the op.
     """
 
-    # Creates empty TS graph.
-    graph = torch._C.Graph()
     # Creates and inserts node with identifier `schema.name`; NB node has no inputs or outputs at this point.
     node = graph.insertNode(graph.create(schema.name, len(schema.returns)))
-    # Associate graph inputs/outputs with node inputs/outputs.
-    graph_inputs = []
     for arg in schema.arguments:
         arg_name = arg.name if arg.name != "self" else "input"
 
@@ -257,28 +251,21 @@ def build_ts_script_function(
             for kwarg in [
                 kwarg for kwarg in kwargs if f"{arg_name}_flattened" in kwarg
             ]:
-                inp = graph.addInput()
                 el_typ = arg.type.getElementType()
                 if isinstance(el_typ, torch.OptionalType):
                     el_typ = el_typ.getElementType()
-                inp.setType(el_typ)
-                inp.setDebugName(kwarg)
-                inps.append(inp)
-                graph_inputs.append(kwarg)
+                inps.append(get_tensor_input(kwarg, el_typ))
             list_cons = graph.insertNode(graph.create("prim::ListConstruct", inps))
             list_cons.moveBefore(node)
             inp = list_cons.output()
             inp.setType(torch.ListType.ofTensors())
-        # If arg is a tensor, then add input to the graph corresponding to arg.
+        # If arg is a tensor, then get the value of the arg.
         elif is_tensor_type(arg.type) and kwargs[arg_name] is not None:
-            inp = graph.addInput()
             if isinstance(arg.type, torch.OptionalType):
                 el_typ = arg.type.getElementType()
             else:
                 el_typ = arg.type
-            inp.setType(el_typ)
-            inp.setDebugName(arg_name)
-            graph_inputs.append(arg_name)
+            inp = get_tensor_input(arg_name, el_typ)
         # If arg is a constant, inline (at the top of the graph).
         else:
             val = kwargs[arg_name]
@@ -294,6 +281,43 @@ def build_ts_script_function(
 
         node.addInput(inp)
 
+    return node
+
+
+def build_ts_script_function(
+    schema: torch._C.FunctionSchema, kwargs: Dict[str, Any]
+) -> torch.jit.ScriptFunction:
+    """Build a torch.jit.ScriptFunction that corresponds to the schema.
+
+    Constants are inlined for the purposes of invalidating the compile cache when they change.
+
+    Parameters
+    ----------
+    schema: torch._C.FunctionSchema
+        PyTorch's representation for ops, contains type information needed for inlining constants into the TS graph.
+    kwargs: Dict
+        A dictionary with all arguments passed in through __torch_dispatch__ (including int/float/bool params).
+
+    Returns
+    -------
+    torch.jit.ScriptFunction
+        Fully specialized (all constants) TS graph whose only arguments are tensors.
+    """
+
+    # Creates empty TS graph.
+    graph = torch._C.Graph()
+    # Associate graph inputs/outputs with node inputs/outputs.
+    graph_inputs = []
+
+    def add_graph_input(kwarg, typ):
+        inp = graph.addInput()
+        inp.setType(typ)
+        inp.setDebugName(kwarg)
+        graph_inputs.append(kwarg)
+        return inp
+
+    node = insert_op_node(graph, schema, kwargs, add_graph_input)
+
     # Reorder graph inputs to match kwargs.
     permutes = [
         {inp: i for i, inp in enumerate(graph_inputs)}[kwarg]
@@ -313,7 +337,33 @@ def build_ts_script_function(
     return fn
 
 
-def build_mlir_module(op: OpOverload, kwargs: Dict[str, Any]) -> ir.Module:
+def import_script_function(
+    script_fun: torch.jit.ScriptFunction, annotations: Iterable[TorchTensorType]
+) -> ir.Module:
+    """Import a torch.jit.ScriptFunction whose only arguments are tensors into an MLIR module in the `torch` dialect,
+    with the shapes and dtypes of its arguments given by `annotations`."""
+
+    annotations = tuple(annotations)
+    assert len(annotations) == len(
+        list(script_fun.graph.inputs())
+    ), "Number of annotations and number of graph inputs differs."
+
+    mb = ModuleBuilder()
+    mb.import_function(script_fun)
+
+    func_op = get_func_op_with_name(mb.module, script_fun.name)
+    assert (
+        func_op is not None
+    ), "Unable to find FuncOp in new module. Make sure function was imported correctly into ModuleBuilder"
+
+    func_annotation = Annotation(annotations)
+    arg_attrs = AnnotationConverter.to_mlir_array_attr(func_annotation, mb.context)
+    func_op.attributes["arg_attrs"] = arg_attrs
+
+    return mb.module
+
+
+def build_mlir_module(op: OpOverload, kwargs: Dict[str, Any], dynamic_shapes: bool = False) -> ir.Module:
     """Translate input function into an MLIR module in the `torch` dialect.
 
     Parameters
@@ -322,6 +372,9 @@ def build_mlir_module(op: OpOverload, kwargs: Dict[str, Any]) -> ir.Module:
         Callable from the torch.ops.aten module/namespace that has a _schema field.
     kwargs: Dict
         A dictionary with all arguments passed in through __torch_dispatch__ (including int/float,bool params).
+    dynamic_shapes: bool
+        Whether the shapes of the tensor args are those given by `get_dynamic_shape`, so that the module runs on
+        tensors of other sizes.
 
     Returns
     -------
@@ -336,24 +389,8 @@ def build_mlir_module(op: OpOverload, kwargs: Dict[str, Any]) -> ir.Module:
     for arg_name, arg in kwargs.items():
         if isinstance(arg, torch.Tensor):
             assert np.prod(arg.shape) != 0, f"{arg_name} has invalid shape {arg.shape}"
-            annotations.append(TorchTensorType(shape=tuple(arg.shape), dtype=arg.dtype))
-    annotations = tuple(annotations)
+            shape = get_dynamic_shape(arg.shape) if dynamic_shapes else tuple(arg.shape)
+            annotations.append(TorchTensorType(shape=shape, dtype=arg.dtype))
 
     script_fun = build_ts_script_function(op._schema, kwargs)
-    assert len(annotations) == len(
-        list(script_fun.graph.inputs())
-    ), "Number of annotations and number of graph inputs differs."
-
-    mb = ModuleBuilder()
-    mb.import_function(script_fun)
-
-    func_op = get_func_op_with_name(mb.module, script_fun.name)
-    assert (
-        func_op is not None
-    ), "Unable to find FuncOp in new module. Make sure function was imported correctly into ModuleBuilder"
-
-    func_annotation = Annotation(annotations)
-    arg_attrs = AnnotationConverter.to_mlir_array_attr(func_annotation, mb.context)
-    func_op.attributes["arg_attrs"] = arg_attrs
-
-    return mb.module
+    return import_script_function(script_fun, annotations)
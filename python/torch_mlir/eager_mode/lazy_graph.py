@@ -0,0 +1,253 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""
+Lazy capture of the ops dispatched in eager mode.
+
+In lazy mode, the ops dispatched to TorchMLIRTensors aren't run one at a time. They are recorded into a pending
+graph, and their results are placeholder values whose shapes and dtypes are inferred by running the ops on the meta
+device. The graph is compiled as a single module and run when one of its values is observed, e.g., printed, read by
+`.item()` or passed to an op that Torch-MLIR doesn't support. This lets the compiler fuse the ops of the graph, and
+dispatches them in a single call.
+"""
+
+from typing import Callable, List, Optional, Tuple
+
+import numpy as np
+import torch
+from torch.utils._pytree import tree_map
+
+from torch_mlir.eager_mode.ir_building import (
+    TorchTensorType,
+    import_script_function,
+    insert_op_node,
+)
+from torch_mlir.eager_mode.torch_mlir_dispatch import _get_arg_signature
+
+
+class LazyValue:
+    """A result of an op recorded in a pending graph.
+
+    `meta` is the result computed on the meta device, which holds its shape and dtype. `result` is the device tensor
+    holding its value once the graph is run.
+    """
+
+    def __init__(self, graph: "LazyGraph", meta: torch.Tensor):
+        self.graph = graph
+        self.meta = meta
+        self.result = None
+        # The wrapper tensor of the value. The value is an output of the graph only if the wrapper is still alive
+        # when the graph is run; otherwise, it's only used by later ops of the graph.
+        self.wrapper = None
+
+
+class LazyNode:
+    """An op recorded in a pending graph, with its args, where each tensor is either a LazyValue of the graph or a
+    materialized wrapper tensor."""
+
+    def __init__(self, func, args, kwargs, normalized_kwargs, outputs: List[LazyValue]):
+        self.func = func
+        self.args = args
+        self.kwargs = kwargs
+        self.normalized_kwargs = normalized_kwargs
+        self.outputs = outputs
+
+
+# The compiled graphs by their signature, as given by `LazyGraph.get_signature`.
+compiled_graphs = {}
+
+
+class LazyGraph:
+    """A graph of the ops recorded since the last flush."""
+
+    def __init__(self):
+        self.nodes: List[LazyNode] = []
+        self.flushed = False
+
+    def record(self, func, args, kwargs, normalized_kwargs, metas: Tuple[torch.Tensor], get_elem: Callable):
+        """Record the op `func` called with `args` and `kwargs`, whose results have the shapes and dtypes of `metas`.
+
+        `get_elem` returns the device representation of a wrapper tensor without materializing it, i.e., a LazyValue
+        if it is a result of a pending op.
+
+        Returns
+        -------
+        List[LazyValue]
+            The results of the op.
+        """
+        assert not self.flushed, "Recording into a graph that already ran."
+
+        def to_operand(e):
+            if not isinstance(e, torch.Tensor):
+                return e
+            elem = get_elem(e)
+            if isinstance(elem, LazyValue) and elem.result is None:
+                assert elem.graph is self, "Lazy values from different graphs."
+                return elem
+            return e
+
+        outputs = [LazyValue(self, meta) for meta in metas]
+        self.nodes.append(
+            LazyNode(
+                func,
+                tree_map(to_operand, args),
+                tree_map(to_operand, kwargs),
+                {name: to_operand(arg) for name, arg in normalized_kwargs.items()},
+                outputs,
+            )
+        )
+        return outputs
+
+    def get_outputs(self) -> List[LazyValue]:
+        """Returns the values of the graph whose wrapper tensors are still alive."""
+        return [
+            value
+            for node in self.nodes
+            for value in node.outputs
+            if value.wrapper is not None and value.wrapper() is not None
+        ]
+
+    def get_signature(self, outputs: List[LazyValue]):
+        """Returns a key identifying the module built for the graph with `outputs`.
+
+        The key is the signature of each op, with the tensor args given by the op and result they come from or by
+        the index, shape and dtype of the graph input. Returns None if some arg isn't hashable.
+        """
+        value_ids = {
+            id(value): (i, j)
+            for i, node in enumerate(self.nodes)
+            for j, value in enumerate(node.outputs)
+        }
+        input_ids = {}
+
+        def get_operand_signature(arg):
+            if isinstance(arg, LazyValue):
+                return LazyValue, value_ids[id(arg)]
+            if isinstance(arg, torch.Tensor):
+                index = input_ids.setdefault(id(arg), len(input_ids))
+                return torch.Tensor, index, arg.dtype, tuple(arg.shape)
+            return _get_arg_signature(arg)
+
+        signature = (
+            tuple(
+                (node.func, tuple((name, get_operand_signature(arg)) for name, arg in node.normalized_kwargs.items()))
+                for node in self.nodes
+            ),
+            tuple(value_ids[id(value)] for value in outputs),
+        )
+        try:
+            hash(signature)
+        except TypeError:
+            return None
+        return signature
+
+    def build_mlir_module(self, outputs: List[LazyValue]):
+        """Translate the graph into an MLIR module in the `torch` dialect that returns `outputs`.
+
+        The arguments of the module are the wrapper tensors returned by `_get_inputs`.
+        """
+        graph = torch._C.Graph()
+        inputs = self._get_inputs()
+        graph_inputs = {}
+        for i, arg in enumerate(inputs):
+            inp = graph.addInput()
+            inp.setType(torch.TensorType.get())
+            inp.setDebugName(f"arg{i}")
+            graph_inputs[id(arg)] = inp
+        values = {}
+        for node in self.nodes:
+
+            def get_tensor_input(kwarg, typ):
+                arg = node.normalized_kwargs[kwarg]
+                if isinstance(arg, LazyValue):
+                    return values[id(arg)]
+                return graph_inputs[id(arg)]
+
+            ts_node = insert_op_node(graph, node.func._schema, node.normalized_kwargs, get_tensor_input)
+            for value, outp in zip(node.outputs, ts_node.outputs()):
+                values[id(value)] = outp
+        for value in outputs:
+            graph.registerOutput(values[id(value)])
+
+        script_fun = torch._C._create_function_from_graph("lazy_graph", graph)
+        annotations = [TorchTensorType(shape=tuple(inp.shape), dtype=inp.dtype) for inp in inputs]
+        return import_script_function(script_fun, annotations)
+
+    def flush(self, backend, on_error: Optional[Callable[[Exception], None]] = None):
+        """Compile and run the graph, setting the results of its values that are still alive.
+
+        If the graph can't be compiled, its ops run through PyTorch instead, after calling `on_error` with the error.
+        """
+        if self.flushed:
+            return
+        self.flushed = True
+        outputs = self.get_outputs()
+        if not outputs:
+            return
+
+        try:
+            signature = self.get_signature(outputs)
+            compiled = compiled_graphs.get(signature)
+            if compiled is None:
+                compiled = backend.compile(self.build_mlir_module(outputs))
+                if signature is not None:
+                    compiled_graphs[signature] = compiled
+            results = compiled(*[inp.elem for inp in self._get_inputs()])
+            if len(outputs) == 1:
+                results = (results,)
+            for value, result in zip(outputs, results):
+                value.result = result
+        except Exception as e:
+            if on_error is not None:
+                on_error(e)
+            self._run_through_pytorch(backend)
+
+    def _get_inputs(self) -> List[torch.Tensor]:
+        """Returns the wrapper tensors passed as arguments to the module of the graph, in the order in which the ops
+        take them, like the indices in `get_signature`."""
+        inputs = {}
+        for node in self.nodes:
+            for arg in node.normalized_kwargs.values():
+                if isinstance(arg, torch.Tensor):
+                    inputs.setdefault(id(arg), arg)
+        return list(inputs.values())
+
+    def _run_through_pytorch(self, backend):
+        torch_values = {}
+
+        def to_torch(e):
+            if isinstance(e, LazyValue):
+                return torch_values[id(e)]
+            if isinstance(e, torch.Tensor):
+                return backend.transfer_from_device_to_torch(e.elem)
+            return e
+
+        for node in self.nodes:
+            out = node.func(*tree_map(to_torch, node.args), **tree_map(to_torch, node.kwargs))
+            if isinstance(out, torch.Tensor):
+                out = (out,)
+            for value, result in zip(node.outputs, out):
+                torch_values[id(value)] = result
+                value.result = backend.transfer_from_torch_to_device(result)
+
+
+def infer_metas(func, args, kwargs) -> Optional[Tuple[torch.Tensor]]:
+    """Returns the results of `func` computed on the meta device, or None if they aren't all tensors with non-zero
+    sizes or the op has no meta implementation."""
+
+    def to_meta(e):
+        if isinstance(e, torch.Tensor):
+            return torch.empty(e.shape, dtype=e.dtype, device="meta")
+        return e
+
+    try:
+        out = func(*tree_map(to_meta, args), **tree_map(to_meta, kwargs))
+    except Exception:
+        return None
+    metas = (out,) if isinstance(out, torch.Tensor) else out
+    if not isinstance(metas, (tuple, list)) or not all(
+        isinstance(meta, torch.Tensor) and np.prod(meta.shape) != 0 for meta in metas
+    ):
+        return None
+    return tuple(metas)
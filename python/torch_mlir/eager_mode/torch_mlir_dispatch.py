@@ -4,7 +4,7 @@
 # Also available under a BSD-style license. See LICENSE.
 from __future__ import annotations
 
-from typing import Any, Callable, Tuple
+from typing import Any, Callable, Iterable, Optional, Tuple
 from typing import Dict
 
 import torch
@@ -36,6 +36,10 @@ class UnsupportedByTorchMlirEagerMode(Exception):
         return self.value
 
 
+class CompilationPending(UnsupportedByTorchMlirEagerMode):
+    """Raised when the op is being compiled in the background, so that it runs through PyTorch meanwhile."""
+
+
 def normalize_args_kwargs(target: Callable, args: Tuple[Any], kwargs: Dict[str, Any]):
     """Fill in default values for optional args, which are dependent on the schema."""
     sig = _torchscript_schema_to_signature(target._schema)
@@ -64,6 +68,72 @@ def normalize_args_kwargs(target: Callable, args: Tuple[Any], kwargs: Dict[str,
     return immutable_collections.immutable_dict(sorted_kwargs)
 
 
+# The ops whose kernels can be compiled for tensors of any sizes, see `get_dynamic_shape`: the elementwise ops, the
+# reductions and the matrix multiplications.
+DYNAMIC_SHAPE_OPS = frozenset(
+    f"aten::{name}"
+    for name in [
+        # Elementwise.
+        "abs", "add", "ceil", "clamp", "cos", "div", "eq", "erf", "exp", "floor", "ge", "gelu", "gt", "le", "log",
+        "lt", "maximum", "minimum", "mul", "ne", "neg", "pow", "reciprocal", "relu", "rsqrt", "sigmoid", "sin",
+        "sqrt", "sub", "tanh", "where",
+        # Reductions.
+        "amax", "argmax", "log_softmax", "_log_softmax", "max", "mean", "softmax", "_softmax", "std", "sum", "var",
+        # Matrix multiplications.
+        "addmm", "bmm", "linear", "matmul", "mm",
+    ]
+)
+
+
+def supports_dynamic_shapes(op: Callable) -> bool:
+    """Returns whether the kernel of `op` can be compiled for tensors of any sizes."""
+    return op._schema.name in DYNAMIC_SHAPE_OPS
+
+
+def get_dynamic_shape(shape: Iterable[int]) -> Tuple[Optional[int], ...]:
+    """Returns the shape, with None for the dynamic sizes, of the kernel that runs on tensors of shape `shape`.
+
+    The sizes of 1 stay static, since they are broadcast by the elementwise ops, which assume the dynamic sizes of
+    their operands to be equal.
+    """
+    return tuple(1 if size == 1 else None for size in shape)
+
+
+def _get_arg_signature(arg: Any, dynamic_shapes: bool = False):
+    """Returns what the module built for an op depends on about `arg`."""
+    if isinstance(arg, torch.Tensor):
+        shape = get_dynamic_shape(arg.shape) if dynamic_shapes else tuple(arg.shape)
+        return torch.Tensor, arg.dtype, shape
+    if isinstance(arg, (tuple, list)):
+        return type(arg), tuple(_get_arg_signature(a, dynamic_shapes) for a in arg)
+    # The type distinguishes equal scalars like 1, 1.0 and True, which are
+    # imported as different constants.
+    return type(arg), arg
+
+
+def get_op_signature(op: Callable, normalized_kwargs: Dict[str, Any], dynamic_shapes: bool = False):
+    """Returns a key identifying the module that `build_mlir_module` builds for
+    `op` and `normalized_kwargs`, as given by `normalize_args_kwargs`.
+
+    The key is the op overload, the dtypes and shapes of the tensor args and
+    the values of the other args, which are inlined as constants. It is
+    cheaper to compute than building the module, so compiled ops can be looked
+    up by it before any IR is built. With `dynamic_shapes`, the shapes are
+    those given by `get_dynamic_shape`, so that the tensors of different sizes
+    share a key. Returns None if some arg isn't hashable.
+    """
+    signature = (
+        op,
+        dynamic_shapes,
+        tuple((name, _get_arg_signature(arg, dynamic_shapes)) for name, arg in normalized_kwargs.items()),
+    )
+    try:
+        hash(signature)
+    except TypeError:
+        return None
+    return signature
+
+
 def get_registered_op(op):
     registered_op = OP_REGISTRY[(op._schema.name, op._schema.overload_name)]
     return registered_op
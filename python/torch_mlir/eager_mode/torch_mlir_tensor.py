@@ -2,22 +2,34 @@
 # See https://llvm.org/LICENSE.txt for license information.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 # Also available under a BSD-style license. See LICENSE.
+import concurrent.futures
 import contextlib
 import re
 import traceback
 import warnings
+import weakref
 from typing import Any
 
+import numpy as np
 import torch
 from torch.utils._pytree import tree_map
 
 from torch_mlir.eager_mode.ir_building import build_mlir_module
+from torch_mlir.eager_mode.lazy_graph import LazyGraph, LazyValue, infer_metas
 from torch_mlir.eager_mode.torch_mlir_dispatch import (
+    CompilationPending,
     UnsupportedByTorchMlirEagerMode,
     normalize_args_kwargs,
     check_get_aliased_arg,
+    get_op_signature,
+    supports_dynamic_shapes,
+)
+from torch_mlir.eager_mode import (
+    EAGER_MODE_ASYNC_COMPILE,
+    EAGER_MODE_DEBUG,
+    EAGER_MODE_DYNAMIC_SHAPES,
+    EAGER_MODE_LAZY,
 )
-from torch_mlir.eager_mode import EAGER_MODE_DEBUG
 from torch_mlir_e2e_test.eager_backends.refbackend import EagerModeRefBackend
 
 
@@ -35,6 +47,159 @@ def no_dispatch():
 
 backend = EagerModeRefBackend()
 
+# The compiled ops by the signature of their calls, as given by
+# `get_op_signature`, so that calls with a signature already seen dispatch
+# without importing the op again.
+compiled_ops = {}
+
+# Whether the ops that support it are compiled for tensors of any sizes, see `dynamic_shapes`.
+_dynamic_shapes = EAGER_MODE_DYNAMIC_SHAPES
+
+
+@contextlib.contextmanager
+def dynamic_shapes(enabled: bool = True):
+    """Compile the elementwise ops, the reductions and the matrix multiplications for tensors of any sizes, so that
+    their kernels are reused for the tensors of the same ranks and dtypes, instead of compiling them again for each
+    new shape.
+
+    The sizes of 1 stay static, since they are broadcast, so that e.g. adding tensors of shapes [8, 4] and [1, 4]
+    uses another kernel than adding tensors of shapes [8, 4] and [8, 4]. Dynamic shapes are enabled by default when
+    the `EAGER_MODE_DYNAMIC_SHAPES` environment variable is set.
+    """
+    global _dynamic_shapes
+    previous = _dynamic_shapes
+    _dynamic_shapes = enabled
+    try:
+        yield
+    finally:
+        _dynamic_shapes = previous
+
+
+# Whether the ops are compiled in the background, see `async_compilation`.
+_async_compile = EAGER_MODE_ASYNC_COMPILE
+# The compilations running in the background, or that failed, by the signature of the op.
+pending_compiles = {}
+_compile_executor = None
+
+
+@contextlib.contextmanager
+def async_compilation(enabled: bool = True):
+    """Compile the ops with a signature not seen yet on a background thread, running them through PyTorch until their
+    compilation finishes, instead of blocking on it.
+
+    The ops that fail to compile keep running through PyTorch. Asynchronous compilation is enabled by default when the
+    `EAGER_MODE_ASYNC_COMPILE` environment variable is set.
+    """
+    global _async_compile
+    previous = _async_compile
+    _async_compile = enabled
+    try:
+        yield
+    finally:
+        _async_compile = previous
+
+
+def wait_for_compilations():
+    """Wait for the compilations running in the background to finish."""
+    concurrent.futures.wait(list(pending_compiles.values()))
+
+
+def get_compiled_op_async(func, normalized_kwargs, signature, dynamic: bool):
+    """Returns the compiled op for `signature`, or starts compiling it in the background.
+
+    Raises
+    ------
+    CompilationPending
+        If the op is still being compiled.
+    Exception
+        The error of the compilation, if it failed.
+    """
+    global _compile_executor
+    future = pending_compiles.get(signature)
+    if future is None:
+        # Building the module is cheap next to lowering and JIT compiling it,
+        # and uses the args, so it happens on the calling thread.
+        eager_module = build_mlir_module(func, normalized_kwargs, dynamic)
+        if _compile_executor is None:
+            _compile_executor = concurrent.futures.ThreadPoolExecutor(
+                max_workers=1, thread_name_prefix="torch-mlir-eager-compile"
+            )
+        pending_compiles[signature] = future = _compile_executor.submit(backend.compile, eager_module)
+    if not future.done():
+        raise CompilationPending(f"{func} is being compiled.")
+    # A failed compilation stays pending, so that the op isn't compiled again.
+    compiled = future.result()
+    del pending_compiles[signature]
+    compiled_ops[signature] = compiled
+    return compiled
+
+
+# Whether the ops are recorded into the pending graph instead of running one at a time, see `lazy_mode`.
+_lazy_mode = EAGER_MODE_LAZY
+_pending_graph = LazyGraph()
+
+
+@contextlib.contextmanager
+def lazy_mode(enabled: bool = True):
+    """Record the ops dispatched to TorchMLIRTensors into a graph that is compiled and run as one module when one of
+    its values is observed, instead of running the ops one at a time.
+
+    The values are observed when printed, read back into PyTorch (e.g. by `.item()` or an op that runs through
+    PyTorch), written to by an in-place op, or when leaving the context. Lazy mode is enabled by default when the
+    `EAGER_MODE_LAZY` environment variable is set.
+    """
+    global _lazy_mode
+    previous = _lazy_mode
+    _lazy_mode = enabled
+    try:
+        yield
+    finally:
+        _lazy_mode = previous
+        flush_lazy_graph()
+
+
+def _warn_lazy_graph_error(e: Exception):
+    if EAGER_MODE_DEBUG:
+        warnings.warn(traceback.format_exc())
+        warnings.warn(
+            f"Couldn't use TorchMLIR eager for the lazy graph because of error: *{str(e)}*; "
+            f"running through PyTorch eager."
+        )
+
+
+def flush_lazy_graph():
+    """Compile and run the pending graph of lazy mode."""
+    global _pending_graph
+    graph, _pending_graph = _pending_graph, LazyGraph()
+    graph.flush(backend, on_error=_warn_lazy_graph_error)
+
+
+def record_lazy_op(func, args, kwargs, normalized_kwargs):
+    """Record `func` into the pending graph, unless it has to run now.
+
+    Returns
+    -------
+    The LazyValue results of the op, in the structure of the results of `func`, or None if the op wasn't recorded.
+    """
+    if check_get_aliased_arg(func) is not None:
+        # The op writes to one of its args, which the pending ops may read.
+        flush_lazy_graph()
+        return None
+    for arg in normalized_kwargs.values():
+        if isinstance(arg, torch.Tensor) and (
+            not isinstance(arg, TorchMLIRTensor) or np.prod(arg.shape) == 0
+        ):
+            return None
+    metas = infer_metas(func, args, kwargs)
+    if metas is None:
+        return None
+    values = _pending_graph.record(
+        func, args, kwargs, normalized_kwargs, metas, lambda t: t._elem
+    )
+    if len(func._schema.returns) == 1:
+        return values[0]
+    return tuple(values)
+
 UNSUPPORTED_OPS = re.compile(
     "|".join([
         # We don't handle detach as it only pertains to autograd graph construction, which is handled by pytorch.
@@ -68,9 +233,25 @@ class TorchMLIRTensor(torch.Tensor):
     https://github.com/albanD/subclass_zoo
     """
 
-    elem: Any
+    _elem: Any
 
-    __slots__ = ["elem"]
+    __slots__ = ["_elem"]
+
+    @property
+    def elem(self):
+        """The device representation of the tensor, which computes it first if it is a result of a pending op of lazy
+        mode."""
+        elem = self._elem
+        if isinstance(elem, LazyValue):
+            if elem.result is None and elem.graph is _pending_graph:
+                flush_lazy_graph()
+            assert elem.result is not None, "The lazy value was not computed."
+            self._elem = elem = elem.result
+        return elem
+
+    @elem.setter
+    def elem(self, value):
+        self._elem = value
 
     def __new__(cls, elem, **kwargs):
         """Wrap elem (which could be a torch.Tensor or otherwise) in a torch.Tensor subclass.
@@ -94,6 +275,21 @@ class TorchMLIRTensor(torch.Tensor):
                 requires_grad=tensor_meta_data.requires_grad,
             )
             r.elem = elem
+        elif isinstance(elem, LazyValue):
+            r = make_bare_wrapper_subclass(
+                cls=cls,
+                size=elem.meta.size(),
+                strides=elem.meta.stride(),
+                storage_offset=0,
+                dtype=elem.meta.dtype,
+                layout=torch.strided,
+                device=torch.device("cpu"),
+                # Only float tensors can have gradients.
+                requires_grad=elem.meta.dtype in {torch.float, torch.float32, torch.float64}
+                and kwargs.get("requires_grad", False),
+            )
+            r.elem = elem
+            elem.wrapper = weakref.ref(r)
         elif isinstance(elem, torch.nn.Parameter):
             r = make_wrapper_subclass_from_torch_tensor(cls, elem.data, **kwargs)
             r.elem = backend.transfer_from_torch_to_device(elem.detach().data)
@@ -148,16 +344,31 @@ class TorchMLIRTensor(torch.Tensor):
                     raise UnsupportedByTorchMlirEagerMode(
                         f"{normalized_kwargs['memory_format']} memory format not supported."
                     )
-                eager_module = build_mlir_module(func, normalized_kwargs)
+                lazy_out = None
+                if _lazy_mode:
+                    lazy_out = record_lazy_op(func, args, kwargs, normalized_kwargs)
+                if lazy_out is None:
+                    dynamic = _dynamic_shapes and supports_dynamic_shapes(func)
+                    signature = get_op_signature(func, normalized_kwargs, dynamic)
+                    op_mlir_backend_callable = compiled_ops.get(signature)
+                    if op_mlir_backend_callable is None and _async_compile and signature is not None:
+                        op_mlir_backend_callable = get_compiled_op_async(func, normalized_kwargs, signature, dynamic)
+                    if op_mlir_backend_callable is None:
+                        eager_module = build_mlir_module(func, normalized_kwargs, dynamic)
+            if lazy_out is not None:
+                return tree_map(lambda x: cls(x, requires_grad=requires_grad), lazy_out)
             device_tensor_args = [
                 kwarg.elem
                 for _, kwarg in normalized_kwargs.items()
                 if isinstance(kwarg, cls)
             ]
-            assert len(eager_module.body.operations[0].arguments) == len(
-                device_tensor_args
-            ), "Number of parameters and number of arguments differs."
-            op_mlir_backend_callable = backend.compile(eager_module)
+            if op_mlir_backend_callable is None:
+                assert len(eager_module.body.operations[0].arguments) == len(
+                    device_tensor_args
+                ), "Number of parameters and number of arguments differs."
+                op_mlir_backend_callable = backend.compile(eager_module)
+                if signature is not None:
+                    compiled_ops[signature] = op_mlir_backend_callable
             out = op_mlir_backend_callable(*device_tensor_args)
             out = tree_map(
                 lambda x: cls(
@@ -166,7 +377,7 @@ class TorchMLIRTensor(torch.Tensor):
                 out,
             )
         except Exception as e:
-            if EAGER_MODE_DEBUG:
+            if EAGER_MODE_DEBUG and not isinstance(e, CompilationPending):
                 warnings.warn(traceback.format_exc())
                 if isinstance(e, UnsupportedByTorchMlirEagerMode):
                     warnings.warn(
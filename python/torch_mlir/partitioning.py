@@ -0,0 +1,436 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""
+Partial compilation of models with ops that Torch-MLIR can't compile.
+
+The forward graph of the frozen model is split into segments of consecutive
+nodes: compiled segments, made of the ops that Torch-MLIR supports, and
+fallback segments, which run in the TorchScript interpreter. Each compiled
+segment is compiled by a linalg-on-tensors backend, specialized to the shapes
+and dtypes that its inputs have when the model runs on the example arguments.
+The tensors are handed from one segment to the next without copies, as numpy
+arrays sharing the memory of the torch tensors.
+
+The ops that can't be compiled are found by compiling the segments: the op
+named in the diagnostics of a failed compilation falls back to PyTorch, and
+the graph is partitioned again, until all the compiled segments compile.
+"""
+
+import re
+from typing import Callable, Dict, List, Optional, Sequence, Set, Tuple
+
+import numpy as np
+import torch
+
+from torch_mlir.ir import StringAttr
+from torch_mlir.compiler_utils import get_torch_backend_pipeline
+from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir.compiler_utils import LINALG_ON_TENSORS_BACKEND_LEGAL_OPS
+from torch_mlir.eager_mode.ir_building import (
+    TorchTensorType,
+    import_script_function,
+)
+
+__all__ = [
+    "PartitionedModule",
+    "compile_partitioned",
+]
+
+# Constants are not assigned to segments: they are cloned into every segment
+# using them.
+_CONSTANT_KIND = "prim::Constant"
+# The prim nodes that the compiled segments can contain, next to the aten ops.
+_COMPILABLE_PRIM_KINDS = {
+    "prim::ListConstruct",
+    "prim::ListUnpack",
+    "prim::TupleConstruct",
+    "prim::TupleUnpack",
+    "prim::NumToTensor",
+}
+# The maximum number of times the graph is partitioned again after a segment
+# fails to compile.
+_MAX_PARTITIONING_ROUNDS = 32
+# The lowering of the compiled segments, which are imported as functions.
+_PIPELINE = ",".join([
+    get_torch_backend_pipeline(LINALG_ON_TENSORS_BACKEND_LEGAL_OPS,
+                               inference=True,
+                               from_function=True),
+    "torch-backend-to-linalg-on-tensors-backend-pipeline",
+])
+
+# The shapes and dtypes of the inputs of a compiled segment.
+_InputTypes = Tuple[Tuple[Tuple[int, ...], torch.dtype], ...]
+
+
+def _is_tensor(value: torch._C.Value) -> bool:
+    return isinstance(value.type(), torch._C.TensorType)
+
+
+def _is_compilable(node: torch._C.Node) -> bool:
+    if any(True for _ in node.blocks()):
+        return False
+    return node.kind().startswith("aten::") or \
+        node.kind() in _COMPILABLE_PRIM_KINDS
+
+
+def _is_in_place(node: torch._C.Node) -> bool:
+    """Returns whether `node` is an in-place aten op, like `aten::add_`."""
+    kind = node.kind()
+    return kind.startswith("aten::") and kind.endswith("_") and \
+        not kind.endswith("__")
+
+
+def _get_used_values(node: torch._C.Node) -> List[torch._C.Value]:
+    """Returns the values defined outside of `node` that it uses, including
+    those used in its blocks."""
+    used = list(node.inputs())
+    defined = set()
+    for block in node.blocks():
+        defined.update(value.unique() for value in block.inputs())
+        for inner in list(block.nodes()) + [block.returnNode()]:
+            used.extend(value for value in _get_used_values(inner)
+                        if value.unique() not in defined)
+            defined.update(value.unique() for value in inner.outputs())
+    return used
+
+
+class _Segment:
+    """Consecutive nodes of the graph, with the values defined before them
+    that they use, and the values they define that are used after them or
+    returned."""
+
+    def __init__(self, indices: List[int], compiled: bool):
+        # The positions of the nodes in the graph.
+        self.indices = indices
+        self.compiled = compiled
+        self.inputs: List[torch._C.Value] = []
+        self.outputs: List[torch._C.Value] = []
+        # The TorchScript function of the segment, returning the tuple of its
+        # outputs. It runs the fallback segments, and the compiled segments
+        # called on inputs of other shapes than those they were compiled for.
+        self.function = None
+        # The compiled function, taking and returning numpy arrays, and the
+        # shapes and dtypes of the inputs it was compiled for.
+        self.compiled_function = None
+        self.input_types: Optional[_InputTypes] = None
+
+
+def _get_segments(nodes: List[torch._C.Node], graph_outputs: Set[int],
+                  is_fallback: Callable[[int], bool]) -> List[_Segment]:
+    """Splits `nodes` into maximal runs of compilable and of fallback nodes,
+    and finds the inputs and outputs of the runs."""
+    segments: List[_Segment] = []
+    for index, node in enumerate(nodes):
+        if node.kind() == _CONSTANT_KIND:
+            continue
+        compiled = not is_fallback(index)
+        if not segments or segments[-1].compiled != compiled:
+            segments.append(_Segment([], compiled))
+        segments[-1].indices.append(index)
+
+    # The segment defining each value, and the segments using it.
+    definer: Dict[int, int] = {}
+    users: Dict[int, Set[int]] = {}
+    for i, segment in enumerate(segments):
+        for index in segment.indices:
+            for value in _get_used_values(nodes[index]):
+                users.setdefault(value.unique(), set()).add(i)
+            for value in nodes[index].outputs():
+                definer[value.unique()] = i
+    for i, segment in enumerate(segments):
+        seen = set()
+        for index in segment.indices:
+            node = nodes[index]
+            for value in _get_used_values(node):
+                if value.unique() in seen or \
+                        definer.get(value.unique()) == i or \
+                        value.node().kind() == _CONSTANT_KIND:
+                    continue
+                seen.add(value.unique())
+                segment.inputs.append(value)
+            for value in node.outputs():
+                if value.unique() in graph_outputs or \
+                        users.get(value.unique(), set()) - {i}:
+                    segment.outputs.append(value)
+    return segments
+
+
+def _get_invalid_nodes(nodes: List[torch._C.Node],
+                       segment: _Segment) -> Set[int]:
+    """Returns the nodes of the compiled `segment` that must fall back for it
+    to be compiled as a function of tensors: the nodes using non-tensor
+    values passed from other segments, the nodes defining non-tensor values
+    used by other segments, and the in-place ops updating tensors of other
+    segments. All the nodes fall back if no node computes a tensor."""
+    non_tensor_inputs = {
+        value.unique() for value in segment.inputs if not _is_tensor(value)
+    }
+    non_tensor_outputs = {
+        value.unique() for value in segment.outputs if not _is_tensor(value)
+    }
+    defined = set()
+    invalid = set()
+    for index in segment.indices:
+        node = nodes[index]
+        if any(value.unique() in non_tensor_inputs
+               for value in node.inputs()) or \
+                any(value.unique() in non_tensor_outputs
+                    for value in node.outputs()) or \
+                (_is_in_place(node) and
+                 next(node.inputs()).unique() not in defined):
+            invalid.add(index)
+        defined.update(value.unique() for value in node.outputs())
+    if not any(
+            _is_tensor(value) for index in segment.indices
+            for value in nodes[index].outputs()):
+        invalid.update(segment.indices)
+    return invalid
+
+
+def _build_function(nodes: List[torch._C.Node], segment: _Segment,
+                    name: str):
+    """Returns the TorchScript function running the nodes of `segment` on its
+    inputs and returning the tuple of its outputs."""
+    graph = torch._C.Graph()
+    value_map = {}
+    for value in segment.inputs:
+        inp = graph.addInput()
+        inp.setType(value.type())
+        value_map[value.unique()] = inp
+
+    def map_value(value):
+        mapped = value_map.get(value.unique())
+        if mapped is None:
+            # A constant defined outside of the segment, which is cloned in
+            # front of the node being cloned.
+            constant = graph.createClone(value.node(), lambda v: v)
+            graph.appendNode(constant)
+            mapped = constant.output()
+            value_map[value.unique()] = mapped
+        return mapped
+
+    for index in segment.indices:
+        node = nodes[index]
+        clone = graph.createClone(node, map_value)
+        graph.appendNode(clone)
+        for value, cloned in zip(node.outputs(), clone.outputs()):
+            value_map[value.unique()] = cloned
+    outputs = [value_map[value.unique()] for value in segment.outputs]
+    tuple_node = graph.create("prim::TupleConstruct", outputs, 1)
+    tuple_node.output().setType(
+        torch._C.TupleType([value.type() for value in outputs]))
+    graph.appendNode(tuple_node)
+    graph.registerOutput(tuple_node.output())
+    return torch._C._create_function_from_graph(name, graph)
+
+
+def _get_input_types(args) -> _InputTypes:
+    return tuple((tuple(arg.shape), arg.dtype) for arg in args)
+
+
+def _to_numpy(tensor: torch.Tensor) -> np.ndarray:
+    """Returns an array sharing the memory of `tensor`, unless it isn't
+    contiguous."""
+    tensor = tensor.detach().contiguous()
+    # bf16 tensors are exchanged as their raw bits, which numpy holds as
+    # uint16.
+    if tensor.dtype == torch.bfloat16:
+        return tensor.view(torch.int16).numpy().view(np.uint16)
+    return tensor.numpy()
+
+
+def _from_numpy(array: np.ndarray,
+                dtype: Optional[torch.dtype]) -> torch.Tensor:
+    """Returns a tensor sharing the memory of `array`, of dtype `dtype`, or of
+    that of `array` if it is None."""
+    # numpy has no bf16, nor PyTorch uint16, so uint16 arrays are bf16 ones.
+    if dtype == torch.bfloat16 or (dtype is None and
+                                   array.dtype == np.uint16):
+        return torch.from_numpy(array.view(np.int16)).view(torch.bfloat16)
+    return torch.from_numpy(array)
+
+
+def _compile_segment(segment: _Segment, backend):
+    """Compiles `segment` for the shapes and dtypes of `input_types`, and
+    returns the function invoking it."""
+    annotations = [
+        TorchTensorType(shape=shape, dtype=dtype)
+        for shape, dtype in segment.input_types
+    ]
+    module = import_script_function(segment.function, annotations)
+    with module.context:
+        name = StringAttr(module.body.operations[0].attributes["sym_name"]).value
+    run_pipeline_with_repro_report(
+        module, _PIPELINE,
+        "Lowering a partition of TorchScript IR -> Linalg-on-Tensors IR")
+    return getattr(backend.load(backend.compile(module)), name)
+
+
+def _get_failing_kind(error: Exception) -> Optional[str]:
+    """Returns the kind of the node, like `aten::foo`, of the op that the
+    diagnostics of a failed compilation point at, if any."""
+    message = str(error)
+    match = re.search(r"'torch\.aten\.(\w+)", message) or re.search(
+        r"see current operation: [^\n]*?torch\.aten\.(\w+)", message)
+    return f"aten::{match.group(1)}" if match else None
+
+
+class PartitionedModule:
+    """A model whose forward graph runs as a sequence of compiled segments
+    and of TorchScript segments, as returned by `compile_partitioned`."""
+
+    def __init__(self, module: torch.jit.ScriptModule,
+                 nodes: List[torch._C.Node], segments: List[_Segment]):
+        # The module and the nodes, which own the values of the segments.
+        self.module = module
+        self.nodes = nodes
+        self.segments = segments
+        graph = module.graph
+        self.self_input, *self.inputs = list(graph.inputs())
+        self.output = next(graph.outputs())
+
+    def __call__(self, *args):
+        env = {self.self_input.unique(): self.module._c}
+        env.update(
+            (value.unique(), arg) for value, arg in zip(self.inputs, args))
+        # The segments without outputs still run, for the in-place updates
+        # and the other side effects of their ops.
+        for segment in self.segments:
+            inputs = [env[value.unique()] for value in segment.inputs]
+            outputs = self._run_segment(segment, inputs)
+            env.update((value.unique(), output)
+                       for value, output in zip(segment.outputs, outputs))
+        return env[self.output.unique()]
+
+    forward = __call__
+
+    def _run_segment(self, segment: _Segment, inputs):
+        if segment.compiled_function is None or \
+                _get_input_types(inputs) != segment.input_types:
+            return segment.function(*inputs)
+        arrays = [_to_numpy(arg) for arg in inputs]
+        results = segment.compiled_function(*arrays)
+        if len(segment.outputs) == 1:
+            results = (results,)
+        # The results that are the same array, or one of the inputs, are the
+        # same tensor, like when the segment runs in PyTorch.
+        tensors = {id(array): arg for array, arg in zip(arrays, inputs)}
+        outputs = []
+        for result, value in zip(results, segment.outputs):
+            if id(result) not in tensors:
+                tensors[id(result)] = _from_numpy(result, value.type().dtype())
+            outputs.append(tensors[id(result)])
+        return tuple(outputs)
+
+    def summary(self) -> str:
+        """Returns the segments of the model, one per line, with the number
+        of ops of the compiled ones and the ops of the fallback ones."""
+        lines = []
+        for segment in self.segments:
+            kinds = [self.nodes[index].kind() for index in segment.indices]
+            if segment.compiled_function is not None:
+                lines.append(f"compiled: {len(kinds)} ops")
+            else:
+                lines.append("fallback: " + ", ".join(kinds))
+        return "\n".join(lines)
+
+
+def compile_partitioned(model: torch.nn.Module,
+                        example_args: Sequence[torch.Tensor],
+                        backend,
+                        use_tracing: bool = False,
+                        fallback_ops: Sequence[str] = ()) -> PartitionedModule:
+    """Compiles the parts of `model` that Torch-MLIR supports, and runs the
+    others in PyTorch.
+
+    The model is frozen for inference, and the nodes of its forward graph are
+    split into maximal runs of consecutive compilable and fallback nodes. The
+    compilable runs are compiled by `backend`, a `LinalgOnTensorsBackend`,
+    for the shapes and dtypes that their inputs have when the model runs on
+    `example_args`, and run in TorchScript when called on other shapes. An op
+    that fails to compile falls back to PyTorch everywhere in the graph.
+
+    Args:
+        model: The PyTorch model to compile.
+        example_args: The tensors to run `forward` on to find the shapes and
+            dtypes of the inputs of the compiled segments.
+        backend: The linalg-on-tensors backend compiling the segments.
+        use_tracing: If True, use `torch.jit.trace` to convert the model to
+            JIT IR rather than `torch.jit.script`.
+        fallback_ops: Kinds of the ops, like "aten::nonzero", to run in
+            PyTorch without trying to compile them.
+
+    Returns:
+        A callable running the model on tensors like `example_args`.
+    """
+    if isinstance(example_args, torch.Tensor):
+        example_args = (example_args,)
+    example_args = tuple(example_args)
+    scripted = torch.jit.trace(model, example_args) if use_tracing \
+        else torch.jit.script(model)
+    frozen = torch.jit.freeze(scripted.eval())
+    graph = frozen.graph
+    nodes = list(graph.nodes())
+    graph_outputs = {value.unique() for value in graph.outputs()}
+
+    fallback_kinds = set(fallback_ops)
+    fallback_indices = set(
+        index for index, node in enumerate(nodes) if not _is_compilable(node))
+    # The compiled functions by the graph of the segment and its input types,
+    # so that the segments found again by a later round aren't recompiled.
+    cache = {}
+    for _ in range(_MAX_PARTITIONING_ROUNDS):
+        is_fallback = lambda index: index in fallback_indices or \
+            nodes[index].kind() in fallback_kinds
+        # Move the nodes that can't be compiled as part of a function of
+        # tensors to the fallback segments, until the segments are stable.
+        while True:
+            segments = _get_segments(nodes, graph_outputs, is_fallback)
+            invalid = set()
+            for segment in segments:
+                if segment.compiled:
+                    invalid |= _get_invalid_nodes(nodes, segment)
+            if not invalid:
+                break
+            fallback_indices |= invalid
+
+        for i, segment in enumerate(segments):
+            segment.function = _build_function(nodes, segment, f"segment_{i}")
+        # Record the types of the inputs of the compiled segments on the
+        # example arguments.
+        partitioned = PartitionedModule(frozen, nodes, segments)
+        run_segment = partitioned._run_segment
+
+        def record_input_types(segment, inputs):
+            if segment.compiled:
+                segment.input_types = _get_input_types(inputs)
+            return run_segment(segment, inputs)
+
+        partitioned._run_segment = record_input_types
+        with torch.no_grad():
+            partitioned(*example_args)
+        partitioned._run_segment = run_segment
+
+        failed = False
+        for segment in segments:
+            if not segment.compiled or segment.input_types is None:
+                continue
+            key = (str(segment.function.graph), segment.input_types)
+            if key not in cache:
+                try:
+                    cache[key] = _compile_segment(segment, backend)
+                except Exception as e:
+                    failed = True
+                    kind = _get_failing_kind(e)
+                    kinds = {nodes[index].kind() for index in segment.indices}
+                    if kind in kinds:
+                        fallback_kinds.add(kind)
+                    else:
+                        fallback_indices.update(segment.indices)
+                    continue
+            segment.compiled_function = cache[key]
+        if not failed:
+            return partitioned
+    raise Exception("The partitioning of the graph did not converge")
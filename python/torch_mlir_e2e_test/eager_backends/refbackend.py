@@ -32,6 +32,8 @@ NUMPY_TO_TORCH_DTYPE_DICT = {
     np.int32: torch.int32,
     np.int64: torch.int64,
     np.float16: torch.float16,
+    # The raw bits of bf16 tensors, since numpy has no bf16 dtype.
+    np.uint16: torch.bfloat16,
     np.float32: torch.float32,
     np.float64: torch.float64,
     np.complex64: torch.complex64,
@@ -85,7 +87,15 @@ class EagerModeRefBackend(TorchMLIREagerBackend):
         np.copyto(dst, src)
 
     def transfer_from_device_to_torch(self, e: np.ndarray):
-        return torch.from_numpy(e).clone()
+        # The tensor shares the memory of the array, which owns the buffer
+        # returned by the module and keeps it alive as long as the tensor.
+        # bf16 tensors are exchanged as their raw bits, which numpy holds as
+        # uint16.
+        if e.dtype == np.uint16:
+            return torch.from_numpy(e.view(np.int16)).view(torch.bfloat16)
+        return torch.from_numpy(e)
 
     def transfer_from_torch_to_device(self, tensor: torch.Tensor) -> np.ndarray:
+        if tensor.dtype == torch.bfloat16:
+            return tensor.view(torch.int16).numpy().view(np.uint16)
         return tensor.numpy()
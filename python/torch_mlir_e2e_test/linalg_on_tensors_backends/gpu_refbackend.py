@@ -0,0 +1,245 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import ctypes
+import glob
+import os
+from typing import Optional, Sequence
+
+from torch_mlir.ir import *
+from torch_mlir import _mlir_libs
+from torch_mlir._mlir_libs._torchMlir import refbackend_get_gpu_allocator
+from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+
+from .abc import LinalgOnTensorsBackend
+from .refbackend import (
+    FAST_MATH_EXPAND_OPS_FOR_LLVM,
+    LOWERING_PIPELINE,
+    SEQUENTIAL_LOOPS_LOWERING,
+    TILE_AND_PAD_LINALG_OPS,
+    RefBackendInvoker,
+    is_sparse_module,
+)
+
+__all__ = [
+    "GpuRefBackendLinalgOnTensorsBackend",
+]
+
+# The passes of `LOWERING_PIPELINE` that only make sense on the host: the
+# loop orders and tiling of the ops for the caches, and the vectorization of
+# the contractions. Moving a reduction loop outermost would keep the
+# parallel loops inside it from being mapped onto the GPU.
+HOST_ONLY_PASSES = [
+    "func.func(refback-interchange-reduction-loops)",
+    TILE_AND_PAD_LINALG_OPS,
+    "func.func(refback-vectorize-linalg-ops)",
+]
+
+# The passes of `LOWERING_PIPELINE` that the GPU pipeline runs with other
+# options, or after which it runs more passes.
+INSERT_RNG_GLOBALS = "refback-insert-rng-globals"
+CONVERT_MEMREF_TO_LLVM = "convert-memref-to-llvm"
+RECONCILE_UNREALIZED_CASTS = "reconcile-unrealized-casts"
+
+# Makes the arguments and the globals of the functions accessible to the
+# kernels.
+MAP_HOST_MEMORY_TO_GPU = "refback-map-host-memory-to-gpu"
+# Allocates the buffers with the allocator of the GPU runtime, which places
+# them in managed memory.
+GPU_CONVERT_MEMREF_TO_LLVM = \
+    "convert-memref-to-llvm{use-generic-functions=true}"
+# Lowers the launches of the kernels and the other GPU ops to calls into the
+# runtime wrappers.
+GPU_TO_LLVM = "gpu-to-llvm"
+
+# The function of the modules with globals registering them with the driver,
+# which is called once when the module is loaded.
+REGISTER_GPU_MEMORY_FUNC = "refbackend_register_gpu_memory"
+
+
+def get_gpu_loops_lowering(tile_sizes: Sequence[int],
+                           serialize_kernels: str) -> str:
+    """Returns the passes replacing `SEQUENTIAL_LOOPS_LOWERING`.
+
+    The parallel loops of each linalg op are tiled by `tile_sizes`, the tiles
+    are mapped onto the blocks of a grid and the iterations in a tile onto the
+    threads of the block, and the loops are outlined into kernels, which are
+    lowered by `serialize_kernels`. The reduction loops run sequentially in
+    each thread, and the ops without parallel loops run on the host.
+    """
+    return ",".join([
+        "func.func(convert-linalg-to-parallel-loops)",
+        # The kernels don't link with the math libraries of the devices, so
+        # the math functions are approximated by polynomials.
+        FAST_MATH_EXPAND_OPS_FOR_LLVM,
+        "func.func(arith-expand)",
+        "func.func(scf-parallel-loop-tiling{parallel-loop-tile-sizes=" +
+        ",".join(str(size) for size in tile_sizes) +
+        " no-min-max-bounds=true})",
+        "func.func(gpu-map-parallel-loops)",
+        "func.func(convert-parallel-loops-to-gpu)",
+        "func.func(lower-affine)",
+        "gpu-kernel-outlining",
+        f"gpu.module({serialize_kernels})",
+    ])
+
+
+# The lowering of the kernels to the binaries of each platform, which the
+# runtime wrappers load. The kernels keep the `scf.if` guarding the threads
+# past the bounds of the loops and the `scf.for` of the reduction loops, which
+# the conversions to NVVM and ROCDL don't lower.
+SERIALIZE_KERNELS = {
+    "cuda":
+    "strip-debuginfo,convert-scf-to-cf,convert-gpu-to-nvvm,gpu-to-cubin",
+    "rocm":
+    "strip-debuginfo,convert-scf-to-cf,convert-gpu-to-rocdl,gpu-to-hsaco",
+}
+
+# The number of threads of a block along the first parallel loops of each op,
+# whose product is the size of the block.
+DEFAULT_TILE_SIZES = (16, 16)
+
+
+def get_gpu_lowering_pipeline(platform: str = "cuda",
+                              chip: Optional[str] = None,
+                              tile_sizes: Sequence[int] = DEFAULT_TILE_SIZES
+                              ) -> str:
+    """Returns the lowering pipeline of the GPU RefBackend for `platform`,
+    `cuda` or `rocm`.
+
+    The kernels are compiled for the `chip` of the device, like `sm_80` or
+    `gfx90a`, which defaults to that of the serialization passes of MLIR.
+    HSA code objects only load on the chip they are compiled for, while PTX
+    is compiled again for the device when it's loaded. Each block runs the
+    iterations of a tile of the leading parallel loops of an op, with sizes
+    `tile_sizes`.
+    """
+    assert platform in SERIALIZE_KERNELS, \
+        f"Expected a GPU platform in {list(SERIALIZE_KERNELS)}"
+    serialize_kernels = SERIALIZE_KERNELS[platform]
+    if chip is not None:
+        serialize_kernels += f"{{chip={chip}}}"
+    pipeline = LOWERING_PIPELINE
+    for host_only_pass in HOST_ONLY_PASSES:
+        assert f"{host_only_pass}," in pipeline
+        pipeline = pipeline.replace(f"{host_only_pass},", "")
+    assert SEQUENTIAL_LOOPS_LOWERING in pipeline
+    pipeline = pipeline.replace(
+        SEQUENTIAL_LOOPS_LOWERING,
+        get_gpu_loops_lowering(tile_sizes, serialize_kernels))
+    # The commas also split the options of some passes, which are joined
+    # back unchanged.
+    passes = pipeline.split(",")
+    for old, new in [
+        (INSERT_RNG_GLOBALS, [INSERT_RNG_GLOBALS, MAP_HOST_MEMORY_TO_GPU]),
+        (CONVERT_MEMREF_TO_LLVM, [GPU_CONVERT_MEMREF_TO_LLVM]),
+        (RECONCILE_UNREALIZED_CASTS, [GPU_TO_LLVM,
+                                      RECONCILE_UNREALIZED_CASTS]),
+    ]:
+        assert passes.count(old) == 1
+        index = passes.index(old)
+        passes[index:index + 1] = new
+    return ",".join(passes)
+
+
+def has_gpu_memory_registration(module) -> bool:
+    """Returns whether `module` registers its globals with the driver."""
+    with module.context:
+        for op in module.body:
+            if "sym_name" in op.attributes and \
+                    StringAttr(op.attributes["sym_name"]).value == \
+                    REGISTER_GPU_MEMORY_FUNC:
+                return True
+    return False
+
+
+def get_gpu_runtime_lib(platform: str) -> str:
+    """Returns the path to the MLIR runtime wrappers of `platform` shipped
+    with torch_mlir, which are built if MLIR enables the runner of the
+    platform."""
+    libs_dir = os.path.dirname(_mlir_libs.__file__)
+    candidates = glob.glob(
+        os.path.join(libs_dir, f"*mlir_{platform}_runtime*"))
+    assert candidates, \
+        f"The MLIR {platform} runtime wrappers are not in {libs_dir}"
+    return candidates[0]
+
+
+class GpuRefBackendInvoker(RefBackendInvoker):
+    """Invokes the functions of a module lowered by the GPU RefBackend.
+
+    The buffers of the module are allocated in managed memory by the driver of
+    the platform, so that the results returned to the caller are read on the
+    host without being copied.
+    """
+
+    def __init__(self, module, platform: str, shared_libs=()):
+        alloc, aligned_alloc, free = refbackend_get_gpu_allocator(platform)
+        self.allocator = {
+            "_mlir_alloc": alloc,
+            "_mlir_aligned_alloc": aligned_alloc,
+            "_mlir_free": free,
+        }
+        self.free_owned_buffer = ctypes.CFUNCTYPE(None, ctypes.c_void_p)(free)
+        super().__init__(module, shared_libs)
+        # The globals are registered before any function is called, so that
+        # concurrent calls don't race to register them.
+        if has_gpu_memory_registration(module):
+            self.ee.invoke(REGISTER_GPU_MEMORY_FUNC)
+
+    def _register_runtime_functions(self, module):
+        super()._register_runtime_functions(module)
+        for name, address in self.allocator.items():
+            self.ee.raw_register_runtime(name, address)
+
+
+class GpuRefBackendLinalgOnTensorsBackend(LinalgOnTensorsBackend):
+    """A reference backend running the linalg ops as kernels on a GPU.
+
+    It shares the lowering of the RefBackend, except that the loops of the
+    linalg ops are mapped onto GPU blocks and threads instead of running on
+    the CPU, and the kernels are launched through the MLIR CUDA or ROCm
+    runtime wrappers. The code between the kernels, like the loops of the
+    TMTensor ops, still runs on the host, on the same managed memory.
+    """
+
+    def __init__(self,
+                 platform: str = "cuda",
+                 chip: Optional[str] = None,
+                 tile_sizes: Sequence[int] = DEFAULT_TILE_SIZES):
+        """
+        Args:
+          platform: `cuda` or `rocm`. torch-mlir must be built with an MLIR
+            enabling the runner of the platform, which provides the passes
+            serializing the kernels and the runtime wrappers.
+          chip: The chip the kernels are compiled for, like `sm_80` or
+            `gfx90a`. It must be given on ROCm, unless the device is the
+            default chip of MLIR.
+          tile_sizes: The number of threads of a block along the leading
+            parallel loops of each op.
+        """
+        super().__init__()
+        self.platform = platform
+        self.pipeline = get_gpu_lowering_pipeline(platform, chip, tile_sizes)
+
+    def compile(self, imported_module: Module):
+        """Compiles an imported module in linalg-on-tensors form into a module
+        in the LLVM dialect, embedding the binaries of its kernels.
+
+        Returns:
+          The lowered module, which can be passed to `load`.
+        """
+        assert not is_sparse_module(imported_module), \
+            "The GPU RefBackend doesn't support sparse tensors"
+        run_pipeline_with_repro_report(
+            imported_module, self.pipeline,
+            "Lowering Linalg-on-Tensors IR to LLVM and GPU kernels with the "
+            "GPU RefBackend")
+        return imported_module
+
+    def load(self, module) -> GpuRefBackendInvoker:
+        """Loads a compiled module into the runtime."""
+        return GpuRefBackendInvoker(module, self.platform,
+                                    [get_gpu_runtime_lib(self.platform)])
@@ -4,30 +4,60 @@
 # Also available under a BSD-style license. See LICENSE.
 
 import ctypes
+import glob
+import os
+import re
+import subprocess
+import tempfile
+import threading
+from typing import Optional
+
 import numpy as np
 
 from torch_mlir.ir import *
 from torch_mlir.passmanager import *
 from torch_mlir.execution_engine import *
 from torch_mlir.runtime import *
+from torch_mlir import _mlir_libs
+from torch_mlir._mlir_libs._torchMlir import refbackend_emit_object_file
+from torch_mlir._mlir_libs._torchMlir import refbackend_invoke_packed_batch
+from torch_mlir._mlir_libs._torchMlir import refbackend_get_profiling_functions
+from torch_mlir._mlir_libs._torchMlir import refbackend_get_kernel_profiles
+from torch_mlir._mlir_libs._torchMlir import refbackend_reset_kernel_profiles
+from torch_mlir._mlir_libs._torchMlir import refbackend_get_library_kernels
 # Imported for side effects.
 import torch_mlir.all_passes_registration
 import torch_mlir.dialects.torch
+from torch_mlir.dialects import sparse_tensor
 from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir.compilation_cache import get_compilation_cache
+from torch_mlir.custom_kernels import get_custom_kernel_address
 
 from .abc import LinalgOnTensorsBackend
 
 __all__ = [
     "RefBackendLinalgOnTensorsBackend",
+    "get_kernel_profile_report",
+    "reset_kernel_profiles",
 ]
 
 
+# numpy has no bf16 dtype, so bf16 memrefs are exchanged as arrays of their
+# raw bits. No other memref element type maps to uint16.
+BF16_NP_DTYPE = np.uint16
+
+
 def assert_arg_type_is_supported(ty):
-    SUPPORTED = [np.float32, np.float64, np.int32, np.int64, np.bool_]
+    SUPPORTED = [
+        np.float16, BF16_NP_DTYPE, np.float32, np.float64, np.int32, np.int64,
+        np.bool_
+    ]
     assert ty in SUPPORTED, f"Only numpy arrays with dtypes in {SUPPORTED} are supported"
 
 
 memref_type_to_np_dtype = {
+    "mrf16": np.float16,
+    "mrbf16": BF16_NP_DTYPE,
     "mrf32": np.float32,
     "mrf64": np.float64,
     "mri1": np.bool_,
@@ -57,6 +87,64 @@ def get_return_funcs(module):
     return return_funcs
 
 
+# The attribute recording the result types of the functions that write their
+# results to outputs allocated by the caller.
+RESULT_TYPES_ATTR = "refbackend.result_types"
+
+
+def get_result_types(module):
+    """Returns the result types of the functions with outputs, by name.
+
+    The types are strings like `memref<2x3xf32>` or `i64`.
+    """
+    result_types = {}
+    with module.context:
+        for func in module.body:
+            if RESULT_TYPES_ATTR not in func.attributes:
+                continue
+            func_name = str(func.attributes["sym_name"]).replace('"', '')
+            result_types[func_name] = [
+                str(TypeAttr(attr).value)
+                for attr in ArrayAttr(func.attributes[RESULT_TYPES_ATTR])
+            ]
+    return result_types
+
+
+# The attribute of the functions whose arguments are read through the strides
+# of their descriptors, which needn't be contiguous.
+STRIDED_ARGUMENTS_ATTR = "refbackend.strided_arguments"
+
+
+def get_strided_functions(module):
+    """Returns the names of the functions that take strided arguments."""
+    with module.context:
+        return {
+            StringAttr(func.attributes["sym_name"]).value
+            for func in module.body
+            if STRIDED_ARGUMENTS_ATTR in func.attributes
+        }
+
+
+def get_arg_descriptor(arg, strided: bool):
+    """Returns the descriptor of the numpy array `arg` passed to a function,
+    which is copied into a contiguous array unless the function is `strided`.
+    """
+    assert_arg_type_is_supported(arg.dtype)
+    if not strided and not arg.flags.c_contiguous:
+        arg = np.ascontiguousarray(arg)
+    return ctypes.pointer(ctypes.pointer(get_unranked_memref_descriptor(arg)))
+
+
+def allocate_output(result_type):
+    """Returns an uninitialized array for a result of type `result_type`."""
+    match = re.fullmatch(r"memref<((?:\d+x)*)(\w+)>", result_type)
+    if match:
+        shape = [int(size) for size in match.group(1).split("x")[:-1]]
+        return np.empty(shape, memref_type_to_np_dtype["mr" + match.group(2)])
+    # Scalars are returned through rank-0 outputs.
+    return np.empty((), memref_type_to_np_dtype["mr" + result_type])
+
+
 def get_ctype_func(func_name):
     return_prefix_len = len(CONSUME_RETURN_FUNC_PREFIX)
     ret_types = func_name[return_prefix_len:].split("_")
@@ -72,78 +160,656 @@ def get_ctype_func(func_name):
     return ctypes.CFUNCTYPE(*ctypes_arg), ret_types
 
 
+# The prefix of the globals holding the arenas that `refback-plan-memory`
+# allocates once for all calls, the prefix of the globals holding the global
+# tensors of the program, and the global holding the state of the random
+# number generator, which make the functions non-reentrant.
+ARENA_PREFIX = "__refbackend_arena_"
+STATE_PREFIX = "__refbackend_state_"
+SEED_GLOBAL = "global_seed"
+
+
+def is_reentrant(module):
+    """Returns whether the functions of `module` can run concurrently."""
+    with module.context:
+        for op in module.body:
+            if "sym_name" not in op.attributes:
+                continue
+            name = StringAttr(op.attributes["sym_name"]).value
+            if (name.startswith(ARENA_PREFIX) or
+                    name.startswith(STATE_PREFIX) or name == SEED_GLOBAL):
+                return False
+    return True
+
+
+# The function loading the data of the external literals of a module into
+# its globals, and its attribute describing the file, offset and type of the
+# data of each of its arguments.
+LOAD_EXTERNAL_LITERALS_FUNC = "refbackend_load_external_literals"
+EXTERNAL_LITERALS_ATTR = "refbackend.external_literals"
+
+
+def get_external_literals(module):
+    """Returns the file, offset and type of the data of each argument of the
+    function loading the external literals of `module`.
+    """
+    with module.context:
+        for func in module.body:
+            if EXTERNAL_LITERALS_ATTR not in func.attributes:
+                continue
+            literals = []
+            for attr in ArrayAttr(func.attributes[EXTERNAL_LITERALS_ATTR]):
+                literal = DictAttr(attr)
+                literals.append((StringAttr(literal["file"]).value,
+                                 IntegerAttr(literal["offset"]).value,
+                                 str(TypeAttr(literal["type"]).value)))
+            return literals
+    return []
+
+
+def map_external_literal(file: str, offset: int, memref_type: str):
+    """Returns the read-only array mapping the data of an external literal."""
+    match = re.fullmatch(r"memref<((?:\d+x)*)(\w+)>", memref_type)
+    shape = [int(size) for size in match.group(1).split("x")[:-1]]
+    dtype = memref_type_to_np_dtype["mr" + match.group(2)]
+    return np.memmap(file, dtype, "r", offset, tuple(shape))
+
+
+# The runtime functions timing the kernels of the modules instrumented by
+# `refback-insert-kernel-profiling`.
+PROFILE_BEGIN_FUNC = "refbackend_profile_begin"
+PROFILE_END_FUNC = "refbackend_profile_end"
+
+
+def is_profiled(module):
+    """Returns whether the kernels of `module` are instrumented."""
+    with module.context:
+        for op in module.body:
+            if "sym_name" in op.attributes and \
+                    StringAttr(op.attributes["sym_name"]).value == PROFILE_BEGIN_FUNC:
+                return True
+    return False
+
+
+# The prefix of the kernels of the library compiled into the runtime, which
+# the modules lowered by `refback-lower-linalg-to-library-calls` call, and
+# the C types of the parameters of their C interfaces.
+LIBRARY_KERNEL_PREFIX = "refbackend_kernel_"
+LIBRARY_KERNEL_PARAMS = {
+    "refbackend_kernel_matmul_f32": ["void *"] * 3,
+    "refbackend_kernel_batch_matmul_f32": ["void *"] * 3,
+    "refbackend_kernel_conv_2d_nchw_fchw_f32": ["void *"] * 3 +
+                                               ["int64_t"] * 4,
+}
+
+
+def get_library_kernels(module):
+    """Returns the names of the library kernels that `module` calls."""
+    with module.context:
+        return [
+            StringAttr(op.attributes["sym_name"]).value
+            for op in module.body
+            if "sym_name" in op.attributes and StringAttr(
+                op.attributes["sym_name"]).value.startswith(
+                    LIBRARY_KERNEL_PREFIX)
+        ]
+
+
+# The prefix of the declarations of the custom kernels that the modules
+# lowered by `refback-bufferize-kernel-calls` call, which the invokers bind to
+# the kernels registered with `torch_mlir.custom_kernels`.
+CUSTOM_KERNEL_PREFIX = "refbackend_custom_kernel_"
+
+
+def get_custom_kernels(module):
+    """Returns the names of the custom kernels that `module` calls."""
+    with module.context:
+        return [
+            StringAttr(op.attributes["sym_name"]).value[
+                len(CUSTOM_KERNEL_PREFIX):]
+            for op in module.body
+            if "sym_name" in op.attributes and StringAttr(
+                op.attributes["sym_name"]).value.startswith(
+                    CUSTOM_KERNEL_PREFIX)
+        ]
+
+
+def get_kernel_profile_report() -> str:
+    """Returns a table of the time spent in the instrumented kernels.
+
+    The kernels are listed from the most to the least time spent, by op name
+    and location, with the bandwidth computed from the bytes of the memrefs
+    they access. The profiles accumulate over all the calls made by all the
+    modules of the process until `reset_kernel_profiles` is called.
+    """
+    profiles = refbackend_get_kernel_profiles()
+    total_ns = sum(nanoseconds for _, _, nanoseconds, _ in profiles)
+    lines = [
+        f"{'time (ms)':>10} {'%':>6} {'calls':>8} {'GB/s':>8}  kernel"
+    ]
+    for kernel, calls, nanoseconds, bytes in profiles:
+        percent = 100 * nanoseconds / total_ns if total_ns else 0
+        bandwidth = bytes / nanoseconds if nanoseconds else 0
+        lines.append(f"{nanoseconds / 1e6:>10.3f} {percent:>6.1f} "
+                     f"{calls:>8} {bandwidth:>8.2f}  {kernel}")
+    return "\n".join(lines)
+
+
+def reset_kernel_profiles():
+    """Discards the profiles of the kernels called so far."""
+    refbackend_reset_kernel_profiles()
+
+
+# The C library, whose `free` releases the buffers that the functions transfer
+# to the consume-return callbacks, allocated by `malloc`.
+_libc = ctypes.CDLL(None)
+_libc.free.argtypes = [ctypes.c_void_p]
+
+
+class _OwnedBuffer:
+    """A buffer that a function returned to its caller, which frees it with
+    `free` when the arrays viewing it are garbage collected."""
+
+    def __init__(self, descriptor, dtype, free):
+        self.free = free
+        rank = descriptor.rank
+        # The ranked descriptor holds the allocated and aligned pointers, the
+        # offset, then the sizes and strides, all 64-bit.
+        fields = (ctypes.c_int64 * (3 + 2 * rank)).from_address(
+            descriptor.descriptor)
+        self.allocated = fields[0]
+        itemsize = np.dtype(dtype).itemsize
+        self.__array_interface__ = {
+            "version": 3,
+            "data": (fields[1] + fields[2] * itemsize, False),
+            "shape": tuple(fields[3:3 + rank]),
+            "strides": tuple(stride * itemsize
+                             for stride in fields[3 + rank:3 + 2 * rank]),
+            "typestr": np.dtype(dtype).str,
+        }
+
+    def __del__(self):
+        self.free(self.allocated)
+
+
+def owned_memref_to_numpy(descriptor_ptr, dtype, free=_libc.free):
+    """Returns an array viewing the memref returned by a function lowered with
+    `owned-results`, without copying it.
+
+    The array takes the ownership of the buffer, which is freed once the array
+    and all the arrays and tensors sharing its memory are garbage collected.
+    It is freed by `free`, which must match the allocator of the module.
+    """
+    return np.asarray(_OwnedBuffer(descriptor_ptr[0], dtype, free))
+
+
+def get_results(out, result_types):
+    """Returns the results that a function wrote to the outputs `out`."""
+    results = tuple(output if type.startswith("memref") else output.item()
+                    for output, type in zip(out, result_types))
+    if len(results) == 1:
+        return results[0]
+    return results
+
+
 class RefBackendInvoker:
+    """Invokes the functions of a module lowered by the RefBackend.
+
+    The invoker can be shared by several threads. The results of each call
+    are returned to the thread making it, and the calls run concurrently if
+    the module is reentrant, otherwise one at a time.
+    """
+
+    # The function freeing the buffers returned by the functions of the
+    # module, which `malloc` allocates.
+    free_owned_buffer = _libc.free
 
-    def __init__(self, module):
-        self.ee = ExecutionEngine(module)
-        self.result = None
+    def __init__(self, module, shared_libs=()):
+        self.ee = ExecutionEngine(module, shared_libs=list(shared_libs))
+        # The consume-return callbacks run on the thread calling the function
+        # whose results they receive.
+        self.local = threading.local()
+        self.result_types = get_result_types(module)
+        self.strided_functions = get_strided_functions(module)
+        self.lock = None if is_reentrant(module) else threading.Lock()
 
         return_funcs = get_return_funcs(module)
 
         for ret_func in return_funcs:
-            ctype_wrapper, ret_types = get_ctype_func(ret_func)
+            self.ee.register_runtime(ret_func,
+                                     self._get_consume_return_func(ret_func))
+        self._register_runtime_functions(module)
+        # The data of the external literals is copied from the files into the
+        # globals of the JIT compiled module once, so that it is never held by
+        # the MLIRContext.
+        external_literals = get_external_literals(module)
+        if external_literals:
+            getattr(self, LOAD_EXTERNAL_LITERALS_FUNC)(
+                *[map_external_literal(*literal)
+                  for literal in external_literals])
 
-            def consume_return_funcs(*args):
-                self.result = tuple([
-                    arg if type in elemental_type_to_ctype else
-                    unranked_memref_to_numpy(arg, memref_type_to_np_dtype[type])
-                    for arg, type in zip(args, ret_types)
-                ])
-                if len(self.result) == 1:
-                    self.result = self.result[0]
+    def _register_runtime_functions(self, module):
+        """Binds the functions of the runtime that `module` calls, before it
+        is JIT compiled."""
+        if is_profiled(module):
+            begin, end = refbackend_get_profiling_functions()
+            self.ee.raw_register_runtime("_mlir_ciface_" + PROFILE_BEGIN_FUNC,
+                                         begin)
+            self.ee.raw_register_runtime("_mlir_ciface_" + PROFILE_END_FUNC,
+                                         end)
+        library_kernels = get_library_kernels(module)
+        if library_kernels:
+            addresses = refbackend_get_library_kernels()
+            for kernel in library_kernels:
+                self.ee.raw_register_runtime("_mlir_ciface_" + kernel,
+                                             addresses[kernel])
+        for kernel in get_custom_kernels(module):
+            self.ee.raw_register_runtime(
+                "_mlir_ciface_" + CUSTOM_KERNEL_PREFIX + kernel,
+                get_custom_kernel_address(kernel))
 
-            self.ee.register_runtime(ret_func,
-                                     ctype_wrapper(consume_return_funcs))
+    def _get_consume_return_func(self, ret_func):
+        ctype_wrapper, ret_types = get_ctype_func(ret_func)
+
+        def consume_return_funcs(*args):
+            result = tuple([
+                arg if type in elemental_type_to_ctype else
+                owned_memref_to_numpy(arg, memref_type_to_np_dtype[type],
+                                      self.free_owned_buffer)
+                for arg, type in zip(args, ret_types)
+            ])
+            if len(result) == 1:
+                result = result[0]
+            self.local.result = result
+
+        return ctype_wrapper(consume_return_funcs)
+
+    def _invoke(self, function_name, ffi_args):
+        self.ee.invoke(function_name, *ffi_args)
+
+    def _lookup_packed(self, function_name):
+        # The packed interface of the C interface of the function takes the
+        # pointers to the memref descriptors, like `_invoke`, while that of
+        # the function itself takes the expanded descriptors.
+        return self.ee.raw_lookup("_mlir_ciface_" + function_name)
+
+    def _call(self, function_name, ffi_args):
+        if self.lock is None:
+            self._invoke(function_name, ffi_args)
+            return
+        with self.lock:
+            self._invoke(function_name, ffi_args)
 
     def __getattr__(self, function_name: str):
 
-        def invoke(*args):
-            ffi_args = []
-            for arg in args:
-                assert_arg_type_is_supported(arg.dtype)
-                ffi_args.append(
-                    ctypes.pointer(
-                        ctypes.pointer(get_unranked_memref_descriptor(arg))))
+        def invoke(*args, out=None):
+            """Invokes the function on the numpy arrays `args`.
+
+            The functions with static result shapes write their results to
+            the arrays `out`, which are allocated for each call if not given,
+            and returned. The arguments that aren't contiguous are copied,
+            unless the function takes strided arguments.
+            """
+            strided = function_name in self.strided_functions
+            ffi_args = [get_arg_descriptor(arg, strided) for arg in args]
+
+            result_types = self.result_types.get(function_name)
+            if result_types is None:
+                assert out is None, \
+                    f"{function_name} doesn't write its results to outputs"
+                self.local.result = None
+                self._call(function_name, ffi_args)
+                result = self.local.result
+                assert result is not None, "Invocation didn't produce a result"
+                self.local.result = None
+                return result
 
-            self.ee.invoke(function_name, *ffi_args)
-            result = self.result
-            assert result is not None, "Invocation didn't produce a result"
-            self.result = None
-            return result
+            out = self._append_outputs(ffi_args, result_types, out)
+            self._call(function_name, ffi_args)
+            return get_results(out, result_types)
 
         return invoke
 
+    def _append_outputs(self, ffi_args, result_types, out):
+        if out is None:
+            out = [allocate_output(type) for type in result_types]
+        assert len(out) == len(result_types), \
+            f"Expected {len(result_types)} outputs, got {len(out)}"
+        for output in out:
+            ffi_args.append(
+                ctypes.pointer(
+                    ctypes.pointer(get_unranked_memref_descriptor(output))))
+        return out
+
+    def invoke_batch(self,
+                     function_name: str,
+                     batch,
+                     outs=None,
+                     num_threads: int = 1):
+        """Invokes the function on each tuple of numpy arrays in `batch`.
+
+        The calls of the functions with static result shapes are made in one
+        native call, on up to `num_threads` threads if the module is
+        reentrant, which amortizes the overhead of crossing into native code.
+        They write their results to the arrays `outs[i]` of each call, if
+        given. The other functions are invoked one call at a time.
+
+        Returns the list of the results of each call.
+        """
+        result_types = self.result_types.get(function_name)
+        if result_types is None:
+            assert outs is None, \
+                f"{function_name} doesn't write its results to outputs"
+            invoke = getattr(self, function_name)
+            return [invoke(*args) for args in batch]
+
+        if outs is None:
+            outs = [None] * len(batch)
+        assert len(outs) == len(batch), \
+            f"Expected {len(batch)} lists of outputs, got {len(outs)}"
+        # The descriptors must stay alive until the native call returns.
+        all_ffi_args = []
+        packed_args = (ctypes.c_void_p * len(batch))()
+        strided = function_name in self.strided_functions
+        for i, (args, out) in enumerate(zip(batch, outs)):
+            ffi_args = [get_arg_descriptor(arg, strided) for arg in args]
+            outs[i] = self._append_outputs(ffi_args, result_types, out)
+            packed = (ctypes.c_void_p * len(ffi_args))(
+                *[ctypes.cast(arg, ctypes.c_void_p) for arg in ffi_args])
+            all_ffi_args.append((ffi_args, packed))
+            packed_args[i] = ctypes.cast(packed, ctypes.c_void_p)
+
+        function = self._lookup_packed(function_name)
+        address = ctypes.addressof(packed_args)
+        if self.lock is None:
+            refbackend_invoke_packed_batch(function, address, len(batch),
+                                           num_threads)
+        else:
+            with self.lock:
+                refbackend_invoke_packed_batch(function, address, len(batch))
+        return [get_results(out, result_types) for out in outs]
+
+
+# The symbols of the shared libraries written by `export_shared_library` that
+# hold the comma-separated names of the functions consuming the returns, and
+# the result types of the functions with outputs, as `name=type,type;...`, and
+# whether the functions are reentrant.
+CONSUME_RETURN_FUNCS_SYMBOL = "refbackend_consume_return_funcs"
+RESULT_TYPES_SYMBOL = "refbackend_result_types"
+REENTRANT_SYMBOL = "refbackend_reentrant"
+# The prefix of the packed interfaces of the functions with outputs, which the
+# ExecutionEngine generates when JIT compiling instead.
+PACKED_PREFIX = "refbackend_packed_"
+C_TYPES = {"i1": "bool", "i64": "int64_t", "f32": "float", "f64": "double"}
+
+
+def get_num_c_interface_args(module, function_names):
+    """Returns the number of arguments of the C interfaces of the functions
+    `function_names` of `module`, lowered to LLVM, by name."""
+    num_args = {}
+    with module.context:
+        for func in module.body:
+            if "sym_name" not in func.attributes:
+                continue
+            name = StringAttr(func.attributes["sym_name"]).value
+            if name.startswith("_mlir_ciface_") and \
+                    name[len("_mlir_ciface_"):] in function_names:
+                num_args[name[len("_mlir_ciface_"):]] = len(
+                    func.regions[0].blocks[0].arguments)
+    return num_args
+
+
+def get_shared_library_source(return_funcs, result_types, reentrant,
+                              num_c_interface_args, profiled=False,
+                              library_kernels=()):
+    """Returns the C source of the functions consuming the returns, and of the
+    symbols describing the interface of the library.
+
+    The ExecutionEngine resolves these functions to Python callbacks when it
+    JIT compiles the module. In a shared library, they instead forward to
+    function pointers, named after them with a `_callback` suffix, that the
+    loader sets. The source also defines the packed interfaces of the
+    functions with outputs, with `num_c_interface_args[name]` arguments.
+    With `profiled`, the profiling functions forward to function pointers set
+    by the loader too, and so do the `library_kernels` that the module calls.
+    """
+    lines = [
+        "#include <stdbool.h>",
+        "#include <stdint.h>",
+        f"const char *{CONSUME_RETURN_FUNCS_SYMBOL} = "
+        f"\"{','.join(return_funcs)}\";",
+        f"const char *{RESULT_TYPES_SYMBOL} = \"" + ";".join(
+            f"{name}={','.join(types)}"
+            for name, types in result_types.items()) + "\";",
+        f"const int {REENTRANT_SYMBOL} = {int(reentrant)};",
+    ]
+    for ret_func in return_funcs:
+        _, ret_types = get_ctype_func(ret_func)
+        # The returned memrefs are passed as pointers to unranked memref
+        # descriptors.
+        arg_types = [C_TYPES.get(type, "void *") for type in ret_types]
+        params = ", ".join(
+            f"{type} arg{i}" for i, type in enumerate(arg_types)) or "void"
+        args = ", ".join(f"arg{i}" for i in range(len(arg_types)))
+        lines.append(
+            f"void (*{ret_func}_callback)({', '.join(arg_types) or 'void'});")
+        lines.append(f"void _mlir_ciface_{ret_func}({params}) "
+                     f"{{ {ret_func}_callback({args}); }}")
+    if profiled:
+        lines += [
+            f"int64_t (*{PROFILE_BEGIN_FUNC}_callback)(void);",
+            f"int64_t _mlir_ciface_{PROFILE_BEGIN_FUNC}(void) "
+            f"{{ return {PROFILE_BEGIN_FUNC}_callback(); }}",
+            f"void (*{PROFILE_END_FUNC}_callback)(void *, int64_t, int64_t);",
+            f"void _mlir_ciface_{PROFILE_END_FUNC}(void *name, int64_t start, "
+            f"int64_t bytes) {{ {PROFILE_END_FUNC}_callback(name, start, "
+            f"bytes); }}",
+        ]
+    for kernel in library_kernels:
+        param_types = LIBRARY_KERNEL_PARAMS[kernel]
+        params = ", ".join(
+            f"{type} arg{i}" for i, type in enumerate(param_types))
+        args = ", ".join(f"arg{i}" for i in range(len(param_types)))
+        lines.append(f"void (*{kernel}_callback)({', '.join(param_types)});")
+        lines.append(f"void _mlir_ciface_{kernel}({params}) "
+                     f"{{ {kernel}_callback({args}); }}")
+    for name, num_args in num_c_interface_args.items():
+        # Each packed argument points to the pointer to a memref descriptor.
+        params = ", ".join(["void *"] * num_args) or "void"
+        args = ", ".join(f"*(void **)args[{i}]" for i in range(num_args))
+        lines.append(f"void _mlir_ciface_{name}({params});")
+        lines.append(f"void {PACKED_PREFIX}{name}(void **args) "
+                     f"{{ _mlir_ciface_{name}({args}); }}")
+    return "\n".join(lines) + "\n"
+
+
+def export_shared_library(module, path: str, shared_libs=(), cc: str = "cc"):
+    """Writes `module`, lowered by the RefBackend, to a shared library.
+
+    The module is compiled ahead of time to an object file for the host, and
+    linked by the C compiler `cc` with the functions consuming the returns and
+    with `shared_libs`, so that `RefBackendSharedLibraryInvoker` can run it
+    without JIT compiling it again.
+    """
+    if get_external_literals(module):
+        raise NotImplementedError(
+            "exporting a module with external literals to a shared library")
+    if get_custom_kernels(module):
+        raise NotImplementedError(
+            "exporting a module with custom kernels to a shared library")
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        object_file = os.path.join(tmp_dir, "module.o")
+        source_file = os.path.join(tmp_dir, "consume_return_funcs.c")
+        refbackend_emit_object_file(module, object_file)
+        with open(source_file, "w") as f:
+            result_types = get_result_types(module)
+            f.write(
+                get_shared_library_source(
+                    get_return_funcs(module), result_types,
+                    is_reentrant(module),
+                    get_num_c_interface_args(module, result_types),
+                    is_profiled(module), get_library_kernels(module)))
+        link_args = []
+        for lib in shared_libs:
+            link_args += [lib, f"-Wl,-rpath,{os.path.dirname(lib)}"]
+        subprocess.check_call([
+            cc, "-shared", "-fPIC", "-o", path, source_file, object_file,
+            *link_args
+        ])
+
+
+class RefBackendSharedLibraryInvoker(RefBackendInvoker):
+    """Invokes the functions of a library written by `export_shared_library`."""
+
+    def __init__(self, path: str):
+        self.lib = ctypes.CDLL(path)
+        self.local = threading.local()
+        self.lock = None
+        if not ctypes.c_int.in_dll(self.lib, REENTRANT_SYMBOL).value:
+            self.lock = threading.Lock()
+        # The library doesn't record which functions take strided arguments,
+        # so they are all passed contiguous arguments.
+        self.strided_functions = set()
+        self.result_types = {}
+        result_types = ctypes.c_char_p.in_dll(self.lib,
+                                              RESULT_TYPES_SYMBOL).value
+        for entry in filter(None, result_types.decode().split(";")):
+            name, types = entry.split("=")
+            self.result_types[name] = types.split(",")
+        # The library calls the callbacks through plain pointers, which don't
+        # keep them alive.
+        self.callbacks = []
+
+        return_funcs = ctypes.c_char_p.in_dll(
+            self.lib, CONSUME_RETURN_FUNCS_SYMBOL).value.decode()
+        for ret_func in filter(None, return_funcs.split(",")):
+            callback = self._get_consume_return_func(ret_func)
+            self.callbacks.append(callback)
+            ctypes.c_void_p.in_dll(self.lib, ret_func + "_callback").value = \
+                ctypes.cast(callback, ctypes.c_void_p).value
+        if hasattr(self.lib, PROFILE_BEGIN_FUNC + "_callback"):
+            for name, address in zip((PROFILE_BEGIN_FUNC, PROFILE_END_FUNC),
+                                     refbackend_get_profiling_functions()):
+                ctypes.c_void_p.in_dll(self.lib, name + "_callback").value = \
+                    address
+        for kernel, address in refbackend_get_library_kernels().items():
+            if hasattr(self.lib, kernel + "_callback"):
+                ctypes.c_void_p.in_dll(self.lib, kernel + "_callback").value = \
+                    address
+
+    def _invoke(self, function_name, ffi_args):
+        # The C interface of the functions takes the pointers to the memref
+        # descriptors directly, rather than packed like `ExecutionEngine`.
+        func = getattr(self.lib, "_mlir_ciface_" + function_name)
+        func(*[arg.contents for arg in ffi_args])
+
+    def _lookup_packed(self, function_name):
+        return ctypes.cast(getattr(self.lib, PACKED_PREFIX + function_name),
+                           ctypes.c_void_p).value
+
+
+# The planning of the intermediate buffers, reusing their arenas across calls,
+# and its reentrant variant, allocating the arenas on each call.
+PLAN_MEMORY = "refback-plan-memory"
+REENTRANT_PLAN_MEMORY = "refback-plan-memory{arena-per-call=true}"
+# The expansion of the math ops, and its fast-math variant, approximating the
+# f32 math functions by polynomials instead of calling libm.
+EXPAND_OPS_FOR_LLVM = "func.func(refback-expand-ops-for-llvm)"
+FAST_MATH_EXPAND_OPS_FOR_LLVM = \
+    "func.func(refback-expand-ops-for-llvm{fast-math=true})"
+# The munging of the calling conventions, which the instrumentation of the
+# kernels for profiling is inserted in front of.
+MUNGE_CALLING_CONVENTIONS = \
+    "refback-munge-calling-conventions{destination-passing=true owned-results=true}"
+INSERT_KERNEL_PROFILING = "refback-insert-kernel-profiling"
+# The last pass before bufferization, which the sparse compiler is inserted
+# after for the modules with sparse tensors. It generates the loops of the
+# linalg ops on sparse tensors, and lowers the sparse tensors to the storage
+# of its runtime support library.
+GENERALIZE_TENSOR_PAD = "func.func(refback-generalize-tensor-pad)"
+SPARSE_COMPILER = ",".join([
+    "func.func(linalg-generalize-named-ops)",
+    "sparsification",
+    "sparse-tensor-conversion",
+    "func.func(canonicalize)",
+])
+# The runtime support of the sparse compiler, which creates and reads the
+# sparse tensors.
+SPARSE_RUNTIME_FUNC = "newSparseTensor"
+# The tiling of the matmuls and convolutions, and its variant leaving the ops
+# that the library kernels compute whole, which are replaced by calls to the
+# kernels after the last pass of the bufferization.
+TILE_AND_PAD_LINALG_OPS = "func.func(refback-tile-and-pad-linalg-ops)"
+LIBRARY_TILE_AND_PAD_LINALG_OPS = \
+    "func.func(refback-tile-and-pad-linalg-ops{library-calls=true})"
+UPDATE_GLOBALS_IN_PLACE = "func.func(refback-update-globals-in-place)"
+LOWER_LINALG_TO_LIBRARY_CALLS = "refback-lower-linalg-to-library-calls"
+
+
+# Calls the custom kernels on buffers allocated for their results, before
+# the tensors they read are bufferized.
+BUFFERIZE_KERNEL_CALLS = "refback-bufferize-kernel-calls"
 
 LOWERING_PIPELINE = ",".join([
-    "func.func(refback-generalize-tensor-pad)",
+    # Fuse chains of elementwise ops, and elementwise producers into the
+    # reductions consuming them, so that the intermediate tensors are never
+    # written to memory.
+    "func.func(linalg-fuse-elementwise-ops)",
+    # Fuse the elementwise ops whose results are also used elsewhere, e.g.
+    # the moments of an optimizer update that are both stored and used to
+    # update the parameter, so that each update is a single kernel.
+    "func.func(refback-fuse-multi-use-elementwise-ops)",
+    # Read the inputs of the reductions in row-major order, also when a
+    # transpose was fused into them above.
+    "func.func(refback-interchange-reduction-loops)",
+    # Cut matmuls and convolutions into cache-sized tiles, padding the tiles
+    # of the contractions to a static shape so that they can be vectorized
+    # once bufferized.
+    TILE_AND_PAD_LINALG_OPS,
+    "func.func(canonicalize)",
+    GENERALIZE_TENSOR_PAD,
+    # Turn the global tensors holding the state of the program into memref
+    # globals, persisting across calls.
+    "refback-lower-global-tensors",
     # Bufferize.
     "func.func(scf-bufferize)",
     "func.func(tm-tensor-bufferize)",
+    BUFFERIZE_KERNEL_CALLS,
     "func.func(linalg-init-tensor-to-alloc-tensor)",
     "func.func(linalg-bufferize)",
     "func-bufferize",
     "arith-bufferize",
     "func.func(tensor-bufferize)",
     "func.func(finalizing-bufferize)",
+    # Update the global tensors in place rather than through a copy.
+    UPDATE_GLOBALS_IN_PLACE,
+    # Place the intermediate buffers in a per-function arena reused across
+    # calls, instead of allocating each of them on every call.
+    PLAN_MEMORY,
     # Munge to make it ExecutionEngine compatible.
     # Specifically, we rewrite calling convention boundaries to be in terms
     # of unranked memref, and we rewrite the return to actually be a
     # callback that consumes the return (the final munged function always
     # returns void at the C level -- we get the return value by providing the
     # callback).
-    "refback-munge-calling-conventions",
+    # The functions with static result shapes instead write their results
+    # to outputs allocated by the caller.
+    MUNGE_CALLING_CONVENTIONS,
     # Insert global variable and instruction sequence for getting the next
     # global seed used in stateful rng.
     "refback-insert-rng-globals",
     # Lower to LLVM
     "func.func(tm-tensor-to-loops)",
     "func.func(refback-munge-memref-copy)",
+    "func.func(refback-vectorize-linalg-ops)",
     "func.func(convert-linalg-to-loops)",
+    "func.func(convert-vector-to-scf)",
     "func.func(lower-affine)",
     "convert-scf-to-cf",
-    "func.func(refback-expand-ops-for-llvm)",
+    EXPAND_OPS_FOR_LLVM,
     "func.func(arith-expand)",
     "func.func(convert-math-to-llvm)",
+    "convert-vector-to-llvm",
     "convert-linalg-to-llvm",
     "convert-memref-to-llvm",
     "func.func(convert-arith-to-llvm)",
@@ -153,11 +819,243 @@ LOWERING_PIPELINE = ",".join([
 ])
 
 
+# The passes of `LOWERING_PIPELINE` that turn the linalg ops into sequential
+# loops, and what replaces them when running on more than one thread: the
+# parallel iterators become `scf.parallel` loops, which are split into blocks
+# dispatched as tasks to the async runtime.
+SEQUENTIAL_LOOPS_LOWERING = ",".join([
+    "func.func(convert-linalg-to-loops)",
+    "func.func(convert-vector-to-scf)",
+    "func.func(lower-affine)",
+])
+PARALLEL_LOOPS_LOWERING = ",".join([
+    "func.func(convert-linalg-to-parallel-loops)",
+    "func.func(convert-vector-to-scf)",
+    "async-parallel-for{{num-workers={num_threads}}}",
+    "async-to-async-runtime",
+    "async-runtime-ref-counting",
+    "async-runtime-ref-counting-opt",
+    "func.func(lower-affine)",
+    "convert-async-to-llvm",
+])
+
+
+# The passes of `LOWERING_PIPELINE` that bufferize one dialect at a time, and
+# the one-shot bufferization replacing them. Bufferizing piecewise copies
+# every tensor that a later pass might write to in place, while one-shot
+# bufferization analyzes the whole module and only copies the tensors that
+# are read after being overwritten. The TMTensor ops don't implement the
+# bufferization interfaces and are still bufferized on their own.
+PIECEWISE_BUFFERIZATION = ",".join([
+    "func.func(scf-bufferize)",
+    "func.func(tm-tensor-bufferize)",
+    BUFFERIZE_KERNEL_CALLS,
+    "func.func(linalg-init-tensor-to-alloc-tensor)",
+    "func.func(linalg-bufferize)",
+    "func-bufferize",
+    "arith-bufferize",
+    "func.func(tensor-bufferize)",
+    "func.func(finalizing-bufferize)",
+])
+IDENTITY_LAYOUT_BOUNDARIES = "function-boundary-type-conversion=identity-layout-map"
+STRIDED_BOUNDARIES = "function-boundary-type-conversion=fully-dynamic-layout-map"
+ONE_SHOT_BUFFERIZATION = ",".join([
+    "func.func(tm-tensor-bufferize)",
+    BUFFERIZE_KERNEL_CALLS,
+    "func.func(linalg-init-tensor-to-alloc-tensor)",
+    "one-shot-bufferize{" + " ".join([
+        "allow-return-allocs",
+        "allow-unknown-ops",
+        "bufferize-function-boundaries",
+        "create-deallocs=false",
+        # The arguments and results are contiguous at the function
+        # boundaries, unless the pipeline takes strided arguments.
+        IDENTITY_LAYOUT_BOUNDARIES,
+    ]) + "}",
+    "func.func(canonicalize)",
+    "func.func(finalizing-bufferize)",
+])
+
+
+def get_lowering_pipeline(num_threads: int = 1,
+                          one_shot_bufferize: bool = False,
+                          *,
+                          reentrant: bool = False,
+                          fast_math: bool = False,
+                          profile: bool = False,
+                          strided_arguments: bool = False,
+                          sparse: bool = False,
+                          library_calls: bool = False) -> str:
+    """Returns the RefBackend lowering pipeline for running on `num_threads`.
+
+    With more than one thread, the pipeline calls into the MLIR async runtime,
+    which must be loaded along with the compiled module. With
+    `one_shot_bufferize`, the tensors are bufferized by one-shot
+    bufferization, writing the destinations of the ops in place. With
+    `reentrant`, the arenas of the intermediate buffers are allocated on each
+    call, so that the functions can be called concurrently. With `fast_math`,
+    exp, log, tanh and the other f32 math functions are approximated by
+    polynomials, to within 1e-6 of libm. With `profile`, each kernel is
+    timed, for `get_kernel_profile_report`. With `strided_arguments`, which
+    requires `one_shot_bufferize`, the arguments of the functions are read
+    through the strides of their descriptors, so that transposed or
+    channels-last arrays are passed without being made contiguous. With
+    `sparse`, the ops on sparse tensors are compiled by the sparse compiler,
+    and the module must be loaded along with the C runner utils. With
+    `library_calls`, the statically shaped f32 matmuls and convolutions call
+    the kernels of the library compiled into the runtime, like BLAS, instead
+    of being compiled to loops.
+    """
+    pipeline = LOWERING_PIPELINE
+    if num_threads > 1:
+        assert SEQUENTIAL_LOOPS_LOWERING in pipeline
+        pipeline = pipeline.replace(
+            SEQUENTIAL_LOOPS_LOWERING,
+            PARALLEL_LOOPS_LOWERING.format(num_threads=num_threads))
+    if one_shot_bufferize:
+        assert PIECEWISE_BUFFERIZATION in pipeline
+        pipeline = pipeline.replace(PIECEWISE_BUFFERIZATION,
+                                    ONE_SHOT_BUFFERIZATION)
+    if strided_arguments:
+        assert one_shot_bufferize, \
+            "Strided arguments require one-shot bufferization"
+        pipeline = pipeline.replace(IDENTITY_LAYOUT_BOUNDARIES,
+                                    STRIDED_BOUNDARIES)
+    if sparse:
+        assert GENERALIZE_TENSOR_PAD in pipeline
+        pipeline = pipeline.replace(GENERALIZE_TENSOR_PAD,
+                                    f"{GENERALIZE_TENSOR_PAD},{SPARSE_COMPILER}")
+    if library_calls:
+        assert TILE_AND_PAD_LINALG_OPS in pipeline
+        assert UPDATE_GLOBALS_IN_PLACE in pipeline
+        pipeline = pipeline.replace(TILE_AND_PAD_LINALG_OPS,
+                                    LIBRARY_TILE_AND_PAD_LINALG_OPS)
+        pipeline = pipeline.replace(
+            UPDATE_GLOBALS_IN_PLACE,
+            f"{UPDATE_GLOBALS_IN_PLACE},{LOWER_LINALG_TO_LIBRARY_CALLS}")
+    if reentrant:
+        assert PLAN_MEMORY in pipeline
+        pipeline = pipeline.replace(PLAN_MEMORY, REENTRANT_PLAN_MEMORY)
+    if fast_math:
+        assert EXPAND_OPS_FOR_LLVM in pipeline
+        pipeline = pipeline.replace(EXPAND_OPS_FOR_LLVM,
+                                    FAST_MATH_EXPAND_OPS_FOR_LLVM)
+    if profile:
+        assert MUNGE_CALLING_CONVENTIONS in pipeline
+        pipeline = pipeline.replace(
+            MUNGE_CALLING_CONVENTIONS,
+            f"{INSERT_KERNEL_PROFILING},{MUNGE_CALLING_CONVENTIONS}")
+    return pipeline
+
+
+def get_async_runtime_lib() -> str:
+    """Returns the path to the MLIR async runtime shipped with torch_mlir."""
+    libs_dir = os.path.dirname(_mlir_libs.__file__)
+    candidates = glob.glob(os.path.join(libs_dir, "*mlir_async_runtime*"))
+    assert candidates, f"The MLIR async runtime is not in {libs_dir}"
+    return candidates[0]
+
+
+def get_c_runner_utils_lib() -> str:
+    """Returns the path to the MLIR C runner utils shipped with torch_mlir,
+    which include the runtime support of sparse tensors."""
+    libs_dir = os.path.dirname(_mlir_libs.__file__)
+    candidates = glob.glob(os.path.join(libs_dir, "*mlir_c_runner_utils*"))
+    assert candidates, f"The MLIR C runner utils are not in {libs_dir}"
+    return candidates[0]
+
+
+def is_sparse_type(type) -> bool:
+    """Returns whether `type` is a tensor type with a sparse encoding."""
+    if not RankedTensorType.isinstance(type):
+        return False
+    encoding = RankedTensorType(type).encoding
+    return encoding is not None and \
+        sparse_tensor.EncodingAttr.isinstance(encoding)
+
+
+def has_sparse_values(op) -> bool:
+    """Returns whether a block argument or an op result nested in `op` is a
+    sparse tensor."""
+    for region in op.regions:
+        for block in region.blocks:
+            if any(is_sparse_type(arg.type) for arg in block.arguments):
+                return True
+            for nested in block.operations:
+                if any(is_sparse_type(result.type)
+                       for result in nested.results) or \
+                        has_sparse_values(nested):
+                    return True
+    return False
+
+
+def is_sparse_module(module) -> bool:
+    """Returns whether `module`, in linalg-on-tensors form, has sparse
+    tensors."""
+    with module.context:
+        return has_sparse_values(module.operation)
+
+
 class RefBackendLinalgOnTensorsBackend(LinalgOnTensorsBackend):
     """Main entry-point for the reference backend."""
 
-    def __init__(self):
+    def __init__(self,
+                 num_threads: int = 1,
+                 one_shot_bufferize: bool = False,
+                 cache_dir: Optional[str] = None,
+                 *,
+                 reentrant: bool = False,
+                 fast_math: bool = False,
+                 profile: bool = False,
+                 strided_arguments: bool = False,
+                 library_calls: bool = False):
+        """
+        The options after `cache_dir` are keyword-only, so that adding more of
+        them doesn't change the meaning of positional arguments.
+
+        Args:
+          num_threads: The number of threads that the parallel loops of the
+            compiled kernels are split across. With 1, the kernels are
+            compiled to sequential loops and don't need the async runtime.
+          one_shot_bufferize: Whether to bufferize with one-shot
+            bufferization, which writes the results in place instead of
+            copying the tensors conservatively.
+          cache_dir: The directory of an on-disk cache of the compiled
+            artifacts, as shared libraries keyed by the input module, the
+            lowering pipeline and the torch-mlir build. Defaults to the
+            `TORCH_MLIR_COMPILATION_CACHE_DIR` environment variable, and no
+            cache if that isn't set either.
+          reentrant: Whether the compiled functions can be called from
+            several threads at once. Otherwise, their intermediate buffers
+            are placed in arenas shared by all the calls, and the invokers
+            run one call at a time.
+          fast_math: Whether to approximate the f32 math functions, like exp,
+            log and tanh, by polynomials that LLVM can vectorize, instead of
+            calling libm. The results agree with libm to within 1e-6.
+          profile: Whether to time each linalg and TMTensor op of the
+            compiled functions, and count the bytes it accesses, for
+            `get_kernel_profile_report`. The kernels are named by the
+            locations of the Torch ops they were lowered from.
+          strided_arguments: Whether the compiled functions read their
+            arguments through the strides of the arrays they are passed,
+            instead of the invoker copying the arrays that aren't contiguous.
+            Requires `one_shot_bufferize`.
+          library_calls: Whether the matmuls, batch matmuls and NCHW
+            convolutions on statically shaped f32 tensors call the kernels of
+            the library compiled into the runtime, which use BLAS if the
+            runtime is built with `TORCH_MLIR_REFBACKEND_CBLAS`, instead of
+            being compiled to loops.
+        """
         super().__init__()
+        assert num_threads >= 1, "Expected a positive number of threads"
+        self.num_threads = num_threads
+        self.one_shot_bufferize = one_shot_bufferize
+        self.reentrant = reentrant
+        self.fast_math = fast_math
+        self.profile = profile
+        self.strided_arguments = strided_arguments
+        self.library_calls = library_calls
+        self.cache = get_compilation_cache(cache_dir)
 
     def compile(self, imported_module: Module):
         """Compiles an imported module, with a flat list of functions.
@@ -170,14 +1068,59 @@ class RefBackendLinalgOnTensorsBackend(LinalgOnTensorsBackend):
             dialect.
         Returns:
           An opaque, backend specific compiled artifact object that can be
-          passed to `load`.
+          passed to `load`. With a cache, this is the path to the shared
+          library of the module in the cache.
         """
+        pipeline = get_lowering_pipeline(
+            self.num_threads,
+            self.one_shot_bufferize,
+            reentrant=self.reentrant,
+            fast_math=self.fast_math,
+            profile=self.profile,
+            strided_arguments=self.strided_arguments,
+            sparse=is_sparse_module(imported_module),
+            library_calls=self.library_calls)
+        if self.cache is not None:
+            key = self.cache.get_key(imported_module.operation.get_asm(),
+                                     pipeline)
+            path = self.cache.get_path(key, ".so")
+            if os.path.exists(path):
+                return path
 
         run_pipeline_with_repro_report(
-            imported_module, LOWERING_PIPELINE,
+            imported_module, pipeline,
             "Lowering Linalg-on-Tensors IR to LLVM with RefBackend")
-        return imported_module
+        # The shared libraries don't load external literals, nor link the
+        # custom kernels, so these modules are JIT compiled.
+        if self.cache is None or get_external_literals(imported_module) or \
+                get_custom_kernels(imported_module):
+            return imported_module
+        return self.cache.store_file(
+            key, ".so",
+            lambda path: self.export_shared_library(imported_module, path))
 
     def load(self, module) -> RefBackendInvoker:
         """Loads a compiled artifact into the runtime."""
-        return RefBackendInvoker(module)
+        if isinstance(module, str):
+            return self.load_shared_library(module)
+        return RefBackendInvoker(module, self._get_runtime_libs(module))
+
+    def export_shared_library(self, module, path: str):
+        """Writes a compiled artifact to a shared library at `path`.
+
+        Loading the library with `load_shared_library` is a file load, while
+        `load` JIT compiles the artifact on every process start.
+        """
+        export_shared_library(module, path, self._get_runtime_libs(module))
+
+    def load_shared_library(self, path: str) -> RefBackendInvoker:
+        """Loads a shared library written by `export_shared_library`."""
+        return RefBackendSharedLibraryInvoker(path)
+
+    def _get_runtime_libs(self, module):
+        libs = []
+        if self.num_threads > 1:
+            libs.append(get_async_runtime_lib())
+        if SPARSE_RUNTIME_FUNC in SymbolTable(module.operation):
+            libs.append(get_c_runner_utils_lib())
+        return libs
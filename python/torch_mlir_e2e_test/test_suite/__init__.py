@@ -53,5 +53,8 @@ def register_all_tests():
     from . import return_types
     from . import control_flow
     from . import stats
+    from . import sort
+    from . import upsample
+    from . import custom_kernels
     # TODO: Re-enable after MacOS support is fixed for the extension.
     #from . import custom_op_example
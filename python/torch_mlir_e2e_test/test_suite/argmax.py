@@ -64,3 +64,39 @@ class ArgmaxKeepDimsModule(torch.nn.Module):
 def ArgmaxModule_keepDim(module, tu: TestUtils):
     module.forward(tu.rand(4, 6))
 
+# ==============================================================================
+
+class ArgminModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, a):
+        return torch.argmin(a)
+
+
+@register_test_case(module_factory=lambda: ArgminModule())
+def ArgminModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 4))
+
+# ==============================================================================
+
+class ArgminWithDimModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, a):
+        return torch.argmin(a, dim=1)
+
+@register_test_case(module_factory=lambda: ArgminWithDimModule())
+def ArgminModule_with_dim(module, tu: TestUtils):
+    module.forward(tu.rand(3, 4, 5))
@@ -34,6 +34,31 @@ def SoftmaxBackwardModule_basic(module, tu: TestUtils):
     module.forward(torch.randn(3, 2, 4), torch.randn(3, 2, 4))
 
 
+# ==============================================================================
+
+
+class SoftmaxBackwardLastDimModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1, -1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, grad_output, output):
+        return torch.ops.aten._softmax_backward_data(grad_output,
+                                                     output,
+                                                     dim=-1,
+                                                     input_dtype=6)
+
+
+@register_test_case(module_factory=lambda: SoftmaxBackwardLastDimModule())
+def SoftmaxBackwardLastDimModule_basic(module, tu: TestUtils):
+    module.forward(torch.randn(2, 3, 4, 4), torch.randn(2, 3, 4, 4).softmax(-1))
+
+
 # ==============================================================================
 class TanhBackwardModule(torch.nn.Module):
     def __init__(self):
@@ -93,3 +118,25 @@ class LogSoftmaxBackwardModule(torch.nn.Module):
 @register_test_case(module_factory=lambda: LogSoftmaxBackwardModule())
 def LogSoftmaxBackwardModule_basic(module, tu: TestUtils):
     module.forward(torch.randn(3, 2, 4), torch.randn(3, 2, 4))
+
+# ==============================================================================
+
+class LogSoftmaxBackwardLastDimModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, grad_output, output):
+        return torch.ops.aten._log_softmax_backward_data(grad_output,
+                                                         output,
+                                                         dim=-1,
+                                                         input_dtype=6)
+
+@register_test_case(module_factory=lambda: LogSoftmaxBackwardLastDimModule())
+def LogSoftmaxBackwardLastDimModule_basic(module, tu: TestUtils):
+    module.forward(torch.randn(3, 5), torch.randn(3, 5).log_softmax(-1))
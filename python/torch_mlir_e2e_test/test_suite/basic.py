@@ -795,6 +795,110 @@ def EmbeddingModule1DIndices_basic(module, tu: TestUtils):
 # ==============================================================================
 
 
+class EmbeddingBagSumModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+        torch.manual_seed(0)
+        self.embed = torch.nn.EmbeddingBag(num_embeddings=100,
+                                           embedding_dim=50,
+                                           mode="sum")
+
+    @export
+    @annotate_args([
+        None,
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, indices, offsets):
+        return self.embed.forward(indices, offsets)
+
+
+@register_test_case(module_factory=lambda: EmbeddingBagSumModule())
+def EmbeddingBagSumModule_basic(module, tu: TestUtils):
+    # The second bag is empty.
+    module.forward(torch.randint(100, (7,)), torch.tensor([0, 3, 3, 5]))
+
+
+class EmbeddingBagMeanIncludeLastOffsetModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+        torch.manual_seed(0)
+        self.embed = torch.nn.EmbeddingBag(num_embeddings=100,
+                                           embedding_dim=50,
+                                           mode="mean",
+                                           include_last_offset=True)
+
+    @export
+    @annotate_args([
+        None,
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, indices, offsets):
+        return self.embed.forward(indices, offsets)
+
+
+@register_test_case(
+    module_factory=lambda: EmbeddingBagMeanIncludeLastOffsetModule())
+def EmbeddingBagMeanIncludeLastOffsetModule_basic(module, tu: TestUtils):
+    module.forward(torch.randint(100, (7,)), torch.tensor([0, 3, 3, 6]))
+
+
+class EmbeddingBagMaxModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+        torch.manual_seed(0)
+        self.embed = torch.nn.EmbeddingBag(num_embeddings=100,
+                                           embedding_dim=50,
+                                           mode="max")
+
+    @export
+    @annotate_args([
+        None,
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, indices, offsets):
+        return self.embed.forward(indices, offsets)
+
+
+@register_test_case(module_factory=lambda: EmbeddingBagMaxModule())
+def EmbeddingBagMaxModule_basic(module, tu: TestUtils):
+    module.forward(torch.randint(100, (7,)), torch.tensor([0, 3, 3, 5]))
+
+
+class EmbeddingBagPerSampleWeightsModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+        torch.manual_seed(0)
+        self.embed = torch.nn.EmbeddingBag(num_embeddings=100,
+                                           embedding_dim=50,
+                                           mode="sum")
+
+    @export
+    @annotate_args([
+        None,
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, indices, offsets, per_sample_weights):
+        return self.embed.forward(indices, offsets, per_sample_weights)
+
+
+@register_test_case(module_factory=lambda: EmbeddingBagPerSampleWeightsModule())
+def EmbeddingBagPerSampleWeightsModule_basic(module, tu: TestUtils):
+    module.forward(torch.randint(100, (7,)), torch.tensor([0, 3, 5]),
+                   tu.rand(7))
+
+
+# ==============================================================================
+
+
 class SoftmaxIntModule(torch.nn.Module):
 
     def __init__(self):
@@ -1632,6 +1736,57 @@ def IndexTensorModule3dInput_basic(module, tu: TestUtils):
 # ==============================================================================
 
 
+class IndexTensorMultiInputModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.float32, True),
+        ([-1, -1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, x, index1, index2):
+        return torch.ops.aten.index(x, (None, index1, index2))
+
+
+@register_test_case(module_factory=lambda: IndexTensorMultiInputModule())
+def IndexTensorMultiInputModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(5, 4, 3), torch.randint(4, (2, 3)),
+                   torch.randint(-3, 3, (3,)))
+
+
+# ==============================================================================
+
+
+class IndexTensorMultiInputNonContiguousModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.float32, True),
+        ([-1, -1], torch.int64, True),
+        ([-1, -1], torch.int64, True),
+    ])
+    def forward(self, x, index1, index2):
+        return torch.ops.aten.index(x, (index1, None, index2))
+
+
+@register_test_case(
+    module_factory=lambda: IndexTensorMultiInputNonContiguousModule())
+def IndexTensorMultiInputNonContiguousModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(5, 4, 3), torch.randint(5, (2, 3)),
+                   torch.randint(3, (2, 3)))
+
+
+# ==============================================================================
+
+
 class SquareModule(torch.nn.Module):
 
     def __init__(self):
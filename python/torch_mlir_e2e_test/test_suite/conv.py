@@ -260,3 +260,134 @@ class ConvolutionModule2DStrided(torch.nn.Module):
 @register_test_case(module_factory=lambda: ConvolutionModule2DStrided())
 def ConvolutionModule2DStrided_basic(module, tu: TestUtils):
     module.forward(torch.randn(3, 3, 10, 10), torch.randn(3, 3, 2, 2))
+
+class ConvolutionModule2DGroups(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, 4, -1, -1], torch.float32, True),
+        ([6, 2, 3, 3], torch.float32, True),
+        ([6], torch.float32, True),
+    ])
+    def forward(self, inputVec, weight, bias):
+        return torch.ops.aten.convolution(inputVec,
+                                          weight,
+                                          bias=bias,
+                                          stride=[1, 1],
+                                          padding=[1, 1],
+                                          dilation=[2, 2],
+                                          transposed=False,
+                                          output_padding=[0, 0],
+                                          groups=2)
+
+@register_test_case(module_factory=lambda: ConvolutionModule2DGroups())
+def ConvolutionModule2DGroups_basic(module, tu: TestUtils):
+    module.forward(torch.randn(2, 4, 10, 10), torch.randn(6, 2, 3, 3),
+                   torch.randn(6))
+
+class ConvolutionModule2DDepthwise(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, 4, -1, -1], torch.float32, True),
+        ([4, 1, 3, 3], torch.float32, True),
+    ])
+    def forward(self, inputVec, weight):
+        return torch.ops.aten.convolution(inputVec,
+                                          weight,
+                                          bias=None,
+                                          stride=[2, 2],
+                                          padding=[1, 1],
+                                          dilation=[1, 1],
+                                          transposed=False,
+                                          output_padding=[0, 0],
+                                          groups=4)
+
+@register_test_case(module_factory=lambda: ConvolutionModule2DDepthwise())
+def ConvolutionModule2DDepthwise_basic(module, tu: TestUtils):
+    module.forward(torch.randn(2, 4, 10, 10), torch.randn(4, 1, 3, 3))
+
+class ConvolutionModule2DGroupsStatic(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([2, 4, 10, 10], torch.float32, True),
+        ([6, 2, 3, 3], torch.float32, True),
+        ([6], torch.float32, True),
+    ])
+    def forward(self, inputVec, weight, bias):
+        return torch.ops.aten.convolution(inputVec,
+                                          weight,
+                                          bias=bias,
+                                          stride=[1, 1],
+                                          padding=[1, 1],
+                                          dilation=[2, 2],
+                                          transposed=False,
+                                          output_padding=[0, 0],
+                                          groups=2)
+
+@register_test_case(module_factory=lambda: ConvolutionModule2DGroupsStatic())
+def ConvolutionModule2DGroupsStatic_basic(module, tu: TestUtils):
+    module.forward(torch.randn(2, 4, 10, 10), torch.randn(6, 2, 3, 3),
+                   torch.randn(6))
+
+class ConvolutionModule2DDepthwiseStatic(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([2, 4, 10, 10], torch.float32, True),
+        ([8, 1, 3, 3], torch.float32, True),
+    ])
+    def forward(self, inputVec, weight):
+        return torch.ops.aten.convolution(inputVec,
+                                          weight,
+                                          bias=None,
+                                          stride=[2, 2],
+                                          padding=[1, 1],
+                                          dilation=[1, 1],
+                                          transposed=False,
+                                          output_padding=[0, 0],
+                                          groups=4)
+
+@register_test_case(module_factory=lambda: ConvolutionModule2DDepthwiseStatic())
+def ConvolutionModule2DDepthwiseStatic_basic(module, tu: TestUtils):
+    module.forward(torch.randn(2, 4, 10, 10), torch.randn(8, 1, 3, 3))
+
+class ConvolutionModule2DTransposed(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, inputVec, weight, bias):
+        return torch.ops.aten.convolution(inputVec,
+                                          weight,
+                                          bias=bias,
+                                          stride=[2, 3],
+                                          padding=[1, 2],
+                                          dilation=[1, 1],
+                                          transposed=True,
+                                          output_padding=[1, 0],
+                                          groups=1)
+
+@register_test_case(module_factory=lambda: ConvolutionModule2DTransposed())
+def ConvolutionModule2DTransposed_basic(module, tu: TestUtils):
+    module.forward(torch.randn(2, 4, 7, 6), torch.randn(4, 3, 3, 4),
+                   torch.randn(3))
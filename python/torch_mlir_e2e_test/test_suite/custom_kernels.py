@@ -0,0 +1,59 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import ctypes
+from typing import List
+
+import torch
+
+from torch_mlir.custom_kernels import register_custom_kernel
+from torch_mlir.runtime import (make_nd_memref_descriptor,
+                                ranked_memref_to_numpy)
+from torch_mlir_e2e_test.torchscript.framework import TestUtils
+from torch_mlir_e2e_test.torchscript.registry import register_test_case
+from torch_mlir_e2e_test.torchscript.annotations import annotate_args, export
+
+# ==============================================================================
+
+# A custom op, which PyTorch runs with its CPU implementation, and the compiled
+# programs with the kernel registered below. Note that once defined, the op
+# stays in the PyTorch op registry.
+_lib = torch.library.Library("torch_mlir_test", "DEF")
+_lib.define("scale(Tensor x, float factor) -> Tensor")
+_lib.impl("scale", lambda x, factor: x * factor, "CPU")
+
+
+def _scale_shape(x: List[int], factor: float) -> List[int]:
+    return x
+
+
+_Memref2DF32 = ctypes.POINTER(make_nd_memref_descriptor(2, ctypes.c_float))
+
+
+@ctypes.CFUNCTYPE(None, _Memref2DF32, ctypes.c_double, _Memref2DF32)
+def _scale_kernel(x, factor, out):
+    ranked_memref_to_numpy(out)[...] = ranked_memref_to_numpy(x) * factor
+
+
+register_custom_kernel("torch_mlir_test.scale", _scale_shape, _scale_kernel)
+
+
+class CustomKernelModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.ops.torch_mlir_test.scale(torch.tanh(x), 3.0) + 1.0
+
+
+@register_test_case(module_factory=lambda: CustomKernelModule())
+def CustomKernelModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 4))
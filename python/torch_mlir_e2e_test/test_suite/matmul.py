@@ -209,3 +209,73 @@ class MatmulBroadcastBatchDim(torch.nn.Module):
 def MatmulBroadcastBatchDim_basic(module, tu: TestUtils):
     module.forward(tu.rand(4, 5, 6, 7), tu.rand(5, 7, 6))
     
+    
+# ==============================================================================
+
+class MmSparseWeightModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        torch.manual_seed(0)
+        dense = torch.rand(6, 8)
+        # The weight is a CSR matrix once imported, with about a third of its
+        # elements stored.
+        self.weight = (dense * (dense > 0.65)).to_sparse()
+
+    @export
+    @annotate_args([
+        None,
+        ([8, 5], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.mm(self.weight, x)
+
+
+@register_test_case(module_factory=lambda: MmSparseWeightModule())
+def MmSparseWeightModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(8, 5))
+
+# ==============================================================================
+
+class AttentionModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.float32, True),
+        ([-1, -1, -1], torch.float32, True),
+        ([-1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, q, k, v):
+        scores = torch.matmul(q, k.transpose(-2, -1)) / 8.0
+        return torch.matmul(torch.softmax(scores, dim=-1), v)
+
+
+@register_test_case(module_factory=lambda: AttentionModule())
+def AttentionModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 4, 8), tu.rand(2, 6, 8), tu.rand(2, 6, 5))
+
+# ==============================================================================
+
+class AttentionMaskModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([4, 6], torch.float32, True),
+    ])
+    def forward(self, q, k, v, mask):
+        scores = torch.matmul(q, k.transpose(-2, -1)) * 0.125 + mask
+        return torch.matmul(torch.softmax(scores, dim=-1), v)
+
+
+@register_test_case(module_factory=lambda: AttentionMaskModule())
+def AttentionMaskModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 3, 4, 8), tu.rand(2, 3, 6, 8),
+                   tu.rand(2, 3, 6, 5), tu.rand(4, 6))
@@ -516,3 +516,88 @@ class NllLossModule_backward1DSumWeight(torch.nn.Module):
 def NllLossModuleBackward1DSumWeight_basic(module, tu: TestUtils):
   module.forward(tu.rand(1), tu.rand(3), torch.tensor([2, 3, 0]),
                  torch.rand(3), torch.tensor(3.))
+
+
+class CrossEntropyLossModule(torch.nn.Module):
+
+  def __init__(self):
+    super().__init__()
+
+  @export
+  @annotate_args([
+      None,
+      ([-1, -1], torch.float32, True),
+      ([-1], torch.int64, True),
+  ])
+  def forward(self, x, y):
+    return torch.ops.aten.cross_entropy_loss(x,
+                                             target=y,
+                                             weight=None,
+                                             reduction=1,
+                                             ignore_index=2,
+                                             label_smoothing=0.0)
+
+
+@register_test_case(module_factory=lambda: CrossEntropyLossModule())
+def CrossEntropyLossModule_basic(module, tu: TestUtils):
+  module.forward(tu.rand(4, 5, low=-10, high=10), torch.tensor([2, 3, 0, 4]))
+
+
+class CrossEntropyLossSumWeightModule(torch.nn.Module):
+
+  def __init__(self):
+    super().__init__()
+
+  @export
+  @annotate_args([
+      None,
+      ([-1, -1], torch.float32, True),
+      ([-1], torch.int64, True),
+      ([-1], torch.float32, True),
+  ])
+  def forward(self, x, y, weight):
+    return torch.ops.aten.cross_entropy_loss(x,
+                                             target=y,
+                                             weight=weight,
+                                             reduction=2,
+                                             ignore_index=-100,
+                                             label_smoothing=0.0)
+
+
+@register_test_case(module_factory=lambda: CrossEntropyLossSumWeightModule())
+def CrossEntropyLossSumWeightModule_basic(module, tu: TestUtils):
+  module.forward(tu.rand(4, 5), torch.tensor([2, 3, 0, 4]), tu.rand(5))
+
+
+class CrossEntropyLossBackwardModule(torch.nn.Module):
+
+  def __init__(self):
+    super().__init__()
+
+  @export
+  @annotate_args([
+      None,
+      ([], torch.float32, True),
+      ([-1, -1], torch.float32, True),
+      ([-1], torch.int64, True),
+      ([], torch.float32, True),
+  ])
+  def forward(self, grad_output, x, target, total_weight):
+    log_softmax = torch.ops.aten._log_softmax(x, dim=1, half_to_float=False)
+    grad = torch.ops.aten.nll_loss_backward(grad_output,
+                                            log_softmax,
+                                            target=target,
+                                            weight=None,
+                                            reduction=1,
+                                            ignore_index=1,
+                                            total_weight=total_weight)
+    return torch.ops.aten._log_softmax_backward_data(grad,
+                                                     log_softmax,
+                                                     dim=1,
+                                                     input_dtype=6)
+
+
+@register_test_case(module_factory=lambda: CrossEntropyLossBackwardModule())
+def CrossEntropyLossBackwardModule_basic(module, tu: TestUtils):
+  module.forward(torch.tensor(0.5), tu.rand(3, 4), torch.tensor([2, 3, 1]),
+                 torch.tensor(2.))
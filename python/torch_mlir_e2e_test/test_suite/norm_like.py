@@ -191,6 +191,82 @@ def NativeBatchNormNoneWeightModule_basic(module, tu: TestUtils):
 
 # ==============================================================================
 
+class NativeBatchNormTrainingModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1], torch.float32, True),
+        ([-1], torch.float32, True),
+        ([-1], torch.float32, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, x, weight, bias, running_mean, running_var):
+        output, save_mean, save_invstd = torch.ops.aten.native_batch_norm(
+            x, weight, bias, running_mean, running_var, training=True,
+            momentum=0.1, eps=0.00001)
+        return output, save_mean, save_invstd, running_mean, running_var
+
+
+@register_test_case(module_factory=lambda: NativeBatchNormTrainingModule())
+def NativeBatchNormTrainingModule_basic(module, tu: TestUtils):
+    module.forward(
+        tu.rand(4, 5, 2, 3), tu.rand(5), tu.rand(5), tu.rand(5), tu.rand(5))
+
+# ==============================================================================
+
+class BatchNorm2DTrainingModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.bn2d = torch.nn.BatchNorm2d(3)
+        self.bn2d.train()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, 3, -1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return self.bn2d(x), self.bn2d.running_mean, self.bn2d.running_var
+
+
+@register_test_case(module_factory=lambda: BatchNorm2DTrainingModule())
+def BatchNorm2DTrainingModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(4, 3, 5, 5))
+
+# ==============================================================================
+
+class NativeBatchNormBackwardModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1, -1, -1, -1], torch.float32, True),
+        ([-1], torch.float32, True),
+        ([-1], torch.float32, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, grad_out, x, weight, save_mean, save_invstd):
+        return torch.ops.aten.native_batch_norm_backward(
+            grad_out, x, weight, None, None, save_mean, save_invstd,
+            train=True, eps=0.00001, output_mask=[True, True, True])
+
+
+@register_test_case(module_factory=lambda: NativeBatchNormBackwardModule())
+def NativeBatchNormBackwardModule_basic(module, tu: TestUtils):
+    x = tu.rand(4, 5, 2, 3)
+    save_mean = x.mean(dim=[0, 2, 3])
+    save_invstd = torch.rsqrt(x.var(dim=[0, 2, 3], unbiased=False) + 0.00001)
+    module.forward(tu.rand(4, 5, 2, 3), x, tu.rand(5), save_mean, save_invstd)
+
+# ==============================================================================
+
 class NativeLayerNormModule(torch.nn.Module):
     def __init__(self):
         super().__init__()
@@ -171,6 +171,29 @@ def MaxPool2dCeilModeTrueModule_basic(module, tu: TestUtils):
     module.forward(tu.rand(1, 1, 20, 20, low=0.5, high=1.0))
 
 
+class MaxPool2dCeilModeTrueStaticModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+        self.mp2d = torch.nn.MaxPool2d(kernel_size=[3, 3],
+                                       stride=[2, 2],
+                                       padding=[1, 1],
+                                       ceil_mode=True)
+
+    @export
+    @annotate_args([
+        None,
+        ([1, 8, 14, 14], torch.float32, True),
+    ])
+    def forward(self, x):
+        return self.mp2d(x)
+
+
+@register_test_case(module_factory=lambda: MaxPool2dCeilModeTrueStaticModule())
+def MaxPool2dCeilModeTrueStaticModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(1, 8, 14, 14) - 0.5)
+
+
 class MaxPool2dWith3dInputModule(torch.nn.Module):
 
     def __init__(self):
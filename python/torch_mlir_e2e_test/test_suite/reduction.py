@@ -295,6 +295,62 @@ def ReduceMaxKeepDimReturnBoth_basic(module, tu: TestUtils):
 
 # ==============================================================================
 
+class ReduceMinAlongDim(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.float64, True),
+    ])
+    def forward(self, a):
+        return torch.ops.aten.min(a, 1)[0]
+
+
+@register_test_case(module_factory=lambda: ReduceMinAlongDim())
+def ReduceMinAlongDim_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 4, 5).to(torch.float64))
+
+# ==============================================================================
+
+class ReduceMinKeepDimReturnBoth(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, a):
+        return torch.ops.aten.min(a, 1, keepdim=True)
+
+@register_test_case(module_factory=lambda: ReduceMinKeepDimReturnBoth())
+def ReduceMinKeepDimReturnBoth_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 4, 5, low=5, high=10))
+
+# ==============================================================================
+
+class ReduceMaxAlongDimSignedInt(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1], torch.int64, True),
+    ])
+    def forward(self, a):
+        return torch.ops.aten.max(a, 1)
+
+
+@register_test_case(module_factory=lambda: ReduceMaxAlongDimSignedInt())
+def ReduceMaxAlongDimSignedInt_basic(module, tu: TestUtils):
+    module.forward(torch.randint(-10, 10, (3, 4, 5)))
+
+# ==============================================================================
+
 class ReduceMaxAllDims(torch.nn.Module):
 
   def __init__(self):
@@ -221,6 +221,44 @@ def ViewExpandInferredDimModule_basic(module, tu: TestUtils):
 
 # ==============================================================================
 
+class ViewDynamicRegroupModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+
+    def forward(self, a):
+        return a.view(a.size(1), a.size(0))
+
+@register_test_case(module_factory=lambda: ViewDynamicRegroupModule())
+def ViewDynamicRegroupModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 2))
+
+# ==============================================================================
+
+class ViewDynamicExpandInferredDimModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+
+    def forward(self, a):
+        return a.view(-1, 4, 3)
+
+@register_test_case(module_factory=lambda: ViewDynamicExpandInferredDimModule())
+def ViewDynamicExpandInferredDimModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(6, 4))
+
+# ==============================================================================
+
 class UnsafeViewExpandModule(torch.nn.Module):
     def __init__(self):
         super().__init__()
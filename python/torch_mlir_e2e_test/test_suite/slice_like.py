@@ -232,3 +232,85 @@ def SelectIntModule_basic(module, tu: TestUtils):
     module.forward(torch.randint(10, (5,5)))
 
 # ==============================================================================
+
+class SliceCopyModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x, y):
+        x[1:3] = y
+        return x
+
+
+@register_test_case(module_factory=lambda: SliceCopyModule())
+def SliceCopyModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(6, 8), tu.rand(2, 8))
+
+# ==============================================================================
+
+class SelectCopyModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, x, y):
+        x[:, 2] = y
+        return x
+
+
+@register_test_case(module_factory=lambda: SelectCopyModule())
+def SelectCopyModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(6, 8), tu.rand(6))
+
+# ==============================================================================
+
+class SliceScatterModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x, src):
+        return torch.ops.aten.slice_scatter(x, src, 1, 1, 7, 2)
+
+
+@register_test_case(module_factory=lambda: SliceScatterModule())
+def SliceScatterModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(6, 8), tu.rand(6, 3))
+
+# ==============================================================================
+
+class SelectScatterModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, x, src):
+        return torch.ops.aten.select_scatter(x, src, 0, 3)
+
+
+@register_test_case(module_factory=lambda: SelectScatterModule())
+def SelectScatterModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(6, 8), tu.rand(8))
+
+# ==============================================================================
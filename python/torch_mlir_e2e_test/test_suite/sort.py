@@ -0,0 +1,145 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import torch
+
+from torch_mlir_e2e_test.torchscript.framework import TestUtils
+from torch_mlir_e2e_test.torchscript.registry import register_test_case
+from torch_mlir_e2e_test.torchscript.annotations import annotate_args, export
+
+# ==============================================================================
+
+
+class SortModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.sort(x)
+
+
+@register_test_case(module_factory=lambda: SortModule())
+def SortModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 16))
+
+# ==============================================================================
+
+
+class SortDescendingModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.sort(x, dim=0, descending=True)
+
+
+@register_test_case(module_factory=lambda: SortDescendingModule())
+def SortDescendingModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(16, 3))
+
+# ==============================================================================
+
+
+class TopkModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.topk(x, 4)
+
+
+@register_test_case(module_factory=lambda: TopkModule())
+def TopkModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(3, 64))
+
+# ==============================================================================
+
+
+class TopkSmallestModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.topk(x, 4, dim=0, largest=False)
+
+
+@register_test_case(module_factory=lambda: TopkSmallestModule())
+def TopkSmallestModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(64, 3))
+
+# ==============================================================================
+
+
+class SortNanModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        ascending = torch.sort(x)
+        descending = torch.sort(x, descending=True)
+        return ascending[0], ascending[1], descending[0], descending[1]
+
+
+@register_test_case(module_factory=lambda: SortNanModule())
+def SortNanModule_basic(module, tu: TestUtils):
+    x = tu.rand(3, 16)
+    x[0, 5] = float("nan")
+    x[2, 0] = float("nan")
+    module.forward(x)
+
+# ==============================================================================
+
+
+class TopkNanModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        largest = torch.topk(x, 4)
+        smallest = torch.topk(x, 4, largest=False)
+        return largest[0], largest[1], smallest[0], smallest[1]
+
+
+@register_test_case(module_factory=lambda: TopkNanModule())
+def TopkNanModule_basic(module, tu: TestUtils):
+    x = tu.rand(3, 64)
+    x[1, 10] = float("nan")
+    module.forward(x)
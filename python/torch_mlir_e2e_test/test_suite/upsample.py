@@ -0,0 +1,109 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import torch
+
+from torch_mlir_e2e_test.torchscript.framework import TestUtils
+from torch_mlir_e2e_test.torchscript.registry import register_test_case
+from torch_mlir_e2e_test.torchscript.annotations import annotate_args, export
+
+# ==============================================================================
+
+
+class UpsampleNearest2dModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.ops.aten.upsample_nearest2d(x, [11, 7], None, None)
+
+
+@register_test_case(module_factory=lambda: UpsampleNearest2dModule())
+def UpsampleNearest2dModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 3, 5, 6))
+
+
+class UpsampleNearest2dVecModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.ops.aten.upsample_nearest2d(x, None, [2.0, 1.5])
+
+
+@register_test_case(module_factory=lambda: UpsampleNearest2dVecModule())
+def UpsampleNearest2dVecModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 3, 5, 6))
+
+
+class UpsampleBilinear2dModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.ops.aten.upsample_bilinear2d(x, [11, 7], False, None,
+                                                  None)
+
+
+@register_test_case(module_factory=lambda: UpsampleBilinear2dModule())
+def UpsampleBilinear2dModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 3, 5, 6))
+
+
+class UpsampleBilinear2dAlignCornersModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.ops.aten.upsample_bilinear2d(x, [11, 7], True, None, None)
+
+
+@register_test_case(
+    module_factory=lambda: UpsampleBilinear2dAlignCornersModule())
+def UpsampleBilinear2dAlignCornersModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 3, 5, 6))
+
+
+class UpsampleBilinear2dVecModule(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1, -1, -1], torch.float32, True),
+    ])
+    def forward(self, x):
+        return torch.ops.aten.upsample_bilinear2d(x, None, False, [2.0, 1.5])
+
+
+@register_test_case(module_factory=lambda: UpsampleBilinear2dVecModule())
+def UpsampleBilinear2dVecModule_basic(module, tu: TestUtils):
+    module.forward(tu.rand(2, 3, 5, 6))
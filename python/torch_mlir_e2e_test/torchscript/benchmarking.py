@@ -0,0 +1,115 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""
+Utilities for benchmarking the tests of the test framework.
+
+A benchmark runs the trace of a test, as obtained on native Torch, on a
+TestConfig several times after warming it up, and compares the latencies with
+those of the same trace run on a baseline config, usually
+`NativeTorchTestConfig`.
+"""
+
+from typing import List, NamedTuple, Optional
+
+import time
+import traceback
+
+import numpy as np
+
+from .framework import Test, TestConfig, generate_golden_trace
+
+
+class BenchmarkResult(NamedTuple):
+    # Should match Test.unique_name for corresponding test.
+    unique_name: str
+    # If compiling or running the test failed, a string describing the
+    # failure. If this is not None, the latencies are empty.
+    error: Optional[str]
+    # The latencies of the runs of the trace on the config, in seconds.
+    latencies: List[float]
+    # The latencies of the runs of the trace on the baseline config, in
+    # seconds.
+    baseline_latencies: List[float]
+
+
+def _time_runs(config: TestConfig, test: Test, trace, iterations: int,
+               warmup_iterations: int) -> List[float]:
+    # Only the calls of the trace are timed, not the compilation, the loading
+    # of the artifact nor the conversion of the inputs.
+    artifact = config.compile(test.program_factory())
+    invocations = config.get_invocations(artifact, trace)
+    for _ in range(warmup_iterations):
+        for invoke in invocations:
+            invoke()
+    latencies = []
+    for _ in range(iterations):
+        start = time.perf_counter()
+        for invoke in invocations:
+            invoke()
+        latencies.append(time.perf_counter() - start)
+    return latencies
+
+
+def benchmark_test(test: Test, config: TestConfig, baseline: TestConfig,
+                   iterations: int, warmup_iterations: int) -> BenchmarkResult:
+    """Benchmarks `test` on `config` and `baseline`."""
+    try:
+        trace = generate_golden_trace(test)
+        latencies = _time_runs(config, test, trace, iterations,
+                               warmup_iterations)
+        baseline_latencies = _time_runs(baseline, test, trace, iterations,
+                                        warmup_iterations)
+    except Exception as e:
+        return BenchmarkResult(unique_name=test.unique_name,
+                               error="".join(
+                                   traceback.format_exception(
+                                       type(e), e, e.__traceback__)),
+                               latencies=[],
+                               baseline_latencies=[])
+    return BenchmarkResult(unique_name=test.unique_name,
+                           error=None,
+                           latencies=latencies,
+                           baseline_latencies=baseline_latencies)
+
+
+def run_benchmarks(tests: List[Test], config: TestConfig, baseline: TestConfig,
+                   iterations: int = 100,
+                   warmup_iterations: int = 5) -> List[BenchmarkResult]:
+    """Benchmarks the given `Test`'s on `config` and `baseline`.
+
+    The tests run one at a time, so that they don't compete for the machine.
+    """
+    return [
+        benchmark_test(test, config, baseline, iterations, warmup_iterations)
+        for test in tests
+    ]
+
+
+def report_benchmarks(results: List[BenchmarkResult], verbose: bool = False):
+    """Print a table of the latency percentiles of the benchmarks, in
+    milliseconds, and of their speedups over the baseline.
+
+    The speedup is the ratio of the median latencies.
+    """
+    print(f"{'p50 (ms)':>10} {'p90 (ms)':>10} {'p99 (ms)':>10} "
+          f"{'base p50':>10} {'speedup':>8}  test")
+    speedups = []
+    for result in results:
+        if result.error is not None:
+            print(f"{'FAIL':>54}  {result.unique_name}")
+            if verbose:
+                print(result.error)
+            continue
+        p50, p90, p99 = np.percentile(result.latencies, [50, 90, 99]) * 1e3
+        baseline_p50 = np.percentile(result.baseline_latencies, 50) * 1e3
+        speedup = baseline_p50 / p50
+        speedups.append(speedup)
+        print(f"{p50:>10.3f} {p90:>10.3f} {p99:>10.3f} {baseline_p50:>10.3f} "
+              f"{speedup:>7.2f}x  {result.unique_name}")
+    if speedups:
+        # The geometric mean, which isn't dominated by the largest speedups.
+        geomean = np.exp(np.mean(np.log(speedups)))
+        print(f"\nGeometric mean speedup over {len(speedups)} tests: "
+              f"{geomean:.2f}x")
@@ -13,13 +13,20 @@ import numpy as np
 import torch
 
 from torch_mlir_e2e_test.linalg_on_tensors_backends.abc import LinalgOnTensorsBackend
-from torch_mlir_e2e_test.torchscript.framework import TestConfig, Trace, TraceItem
-from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir_e2e_test.torchscript.framework import (
+    TestConfig,
+    Trace,
+    TraceItem,
+    time_compile_phase,
+)
+from torch_mlir.compiler_utils import LINALG_ON_TENSORS_BACKEND_LEGAL_OPS
 
 from .utils import (
     recursively_convert_to_numpy,
     recursively_convert_from_numpy,
     convert_torchscript_module_to_torch_backend_contract_mlir,
+    get_numpy_invocations,
+    run_timed_pipeline,
 )
 
 
@@ -36,19 +43,22 @@ class LinalgOnTensorsBackendTestConfig(TestConfig):
     def compile(self, program: torch.nn.Module) -> Any:
 
         module = convert_torchscript_module_to_torch_backend_contract_mlir(
-            program)
+            program, LINALG_ON_TENSORS_BACKEND_LEGAL_OPS)
 
-        run_pipeline_with_repro_report(
+        run_timed_pipeline(
             module,
+            "linalg-on-tensors-backend-pipeline",
             "torch-backend-to-linalg-on-tensors-backend-pipeline",
             "Lower Torch Backend IR -> Linalg-on-Tensors Backend IR")
 
-        return self.backend.compile(module)
+        with time_compile_phase("backend-compile"):
+            return self.backend.compile(module)
 
 
 
     def run(self, artifact: Any, trace: Trace) -> Trace:
-        backend_module = self.backend.load(artifact)
+        with time_compile_phase("backend-load"):
+            backend_module = self.backend.load(artifact)
         result: Trace = []
         for item in trace:
             numpy_inputs = recursively_convert_to_numpy(item.inputs)
@@ -59,3 +69,6 @@ class LinalgOnTensorsBackendTestConfig(TestConfig):
                           inputs=item.inputs,
                           output=output))
         return result
+
+    def get_invocations(self, artifact: Any, trace: Trace):
+        return get_numpy_invocations(self.backend.load(artifact), trace)
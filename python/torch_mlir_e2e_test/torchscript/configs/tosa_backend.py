@@ -13,12 +13,19 @@ import numpy as np
 import torch
 
 from torch_mlir_e2e_test.tosa_backends.abc import TosaBackend
-from torch_mlir_e2e_test.torchscript.framework import TestConfig, Trace, TraceItem
-from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir_e2e_test.torchscript.framework import (
+    TestConfig,
+    Trace,
+    TraceItem,
+    time_compile_phase,
+)
+from torch_mlir.compiler_utils import TOSA_BACKEND_LEGAL_OPS
 from .utils import (
     recursively_convert_to_numpy,
     recursively_convert_from_numpy,
     convert_torchscript_module_to_torch_backend_contract_mlir,
+    get_numpy_invocations,
+    run_timed_pipeline,
 )
 
 
@@ -35,19 +42,22 @@ class TosaBackendTestConfig(TestConfig):
     def compile(self, program: torch.nn.Module) -> Any:
 
         module = convert_torchscript_module_to_torch_backend_contract_mlir(
-            program)
+            program, TOSA_BACKEND_LEGAL_OPS)
 
-        run_pipeline_with_repro_report(
+        run_timed_pipeline(
             module,
+            "tosa-backend-pipeline",
             "torch-backend-to-tosa-backend-pipeline",
             "Lower Torch Backend IR -> TOSA Backend IR")
 
-        return self.backend.compile(module)
+        with time_compile_phase("backend-compile"):
+            return self.backend.compile(module)
 
 
 
     def run(self, artifact: Any, trace: Trace) -> Trace:
-        backend_module = self.backend.load(artifact)
+        with time_compile_phase("backend-load"):
+            backend_module = self.backend.load(artifact)
         result: Trace = []
         for item in trace:
             numpy_inputs = recursively_convert_to_numpy(item.inputs)
@@ -58,3 +68,6 @@ class TosaBackendTestConfig(TestConfig):
                           inputs=item.inputs,
                           output=output))
         return result
+
+    def get_invocations(self, artifact: Any, trace: Trace):
+        return get_numpy_invocations(self.backend.load(artifact), trace)
@@ -3,20 +3,34 @@
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 # Also available under a BSD-style license. See LICENSE.
 
+import os
 import sys
-from typing import Any
+from typing import Any, Callable, List
 from io import StringIO
 
 import numpy as np
 import torch
 
+from torch_mlir.ir import Context
 from torch_mlir.dialects.torch.importer.jit_ir import ClassAnnotator, ModuleBuilder
 from torch_mlir.dialects.torch.importer.jit_ir.torchscript_annotations import extract_annotations
+from torch_mlir.compiler_utils import CompileReport
 from torch_mlir.compiler_utils import run_pipeline_with_repro_report
+from torch_mlir.compiler_utils import get_torch_backend_pipeline
+from torch_mlir.custom_kernels import prepare_custom_kernels
+from torch_mlir_e2e_test.torchscript.framework import (
+    add_compile_time,
+    compile_times_recorded,
+    in_worker,
+    time_compile_phase,
+)
 
 
 def recursively_convert_to_numpy(o: Any):
     if isinstance(o, torch.Tensor):
+        # numpy has no bf16 dtype, so the backends take the raw bits.
+        if o.dtype == torch.bfloat16:
+            return o.view(torch.int16).numpy().view(np.uint16)
         return o.numpy()
     if isinstance(o, tuple):
         return tuple(recursively_convert_to_numpy(x) for x in o)
@@ -35,6 +49,8 @@ def recursively_convert_to_numpy(o: Any):
 
 def recursively_convert_from_numpy(o: Any):
     if isinstance(o, np.ndarray):
+        if o.dtype == np.uint16:
+            return torch.from_numpy(o.view(np.int16)).view(torch.bfloat16)
         return torch.from_numpy(o)
     if isinstance(o, tuple):
         return tuple(recursively_convert_from_numpy(x) for x in o)
@@ -52,12 +68,73 @@ def recursively_convert_from_numpy(o: Any):
     raise Exception(f"Unexpected Python function output: {o}")
 
 
-def convert_torchscript_module_to_torch_backend_contract_mlir(program: torch.nn.Module):
+def get_numpy_invocations(backend_module, trace) -> List[Callable[[], Any]]:
+    """Returns a function calling the function of `backend_module` named by
+    each item of `trace` on its inputs, which are converted to numpy up front
+    so that only the calls are timed."""
+    invocations = []
+    for item in trace:
+        function = getattr(backend_module, item.symbol)
+        numpy_inputs = recursively_convert_to_numpy(item.inputs)
+        invocations.append(
+            lambda function=function, inputs=numpy_inputs: function(*inputs))
+    return invocations
+
+
+def run_timed_pipeline(module, phase: str, pipeline: str, description: str):
+    """Runs `pipeline` on `module` like `run_pipeline_with_repro_report`, and
+    times it as the compile phase `phase`, and each of its passes as the
+    phase `<phase>/<pass>`."""
+    report = CompileReport() if compile_times_recorded() else None
+    with time_compile_phase(phase):
+        run_pipeline_with_repro_report(module, pipeline, description, report)
+    if report is not None:
+        for profile in report.passes:
+            add_compile_time(f"{phase}/{profile.name}", profile.seconds)
+
+
+# The number of tests that import their modules into the same context before
+# it's replaced, since the attributes uniqued in a context, like the weights
+# of the modules, are only freed with it.
+CONTEXT_REUSE_LIMIT = 32
+
+# The context shared by the tests run by this process, the process that
+# created it and the number of tests that used it.
+_shared_context = None
+_shared_context_pid = None
+_shared_context_uses = 0
+
+
+def get_shared_context() -> Context:
+    """Returns the context into which the tests import their modules.
+
+    The context is reused by the tests run in the same process, so that they
+    share the dialects loaded into it and the shape library parsed by the
+    Torch backend pipeline. Processes forked by the test framework create
+    their own context, which runs the passes on a single thread, since the
+    workers already use all the CPUs.
+    """
+    global _shared_context, _shared_context_pid, _shared_context_uses
+    if (_shared_context is None or _shared_context_pid != os.getpid()
+            or _shared_context_uses >= CONTEXT_REUSE_LIMIT):
+        _shared_context = Context()
+        if in_worker():
+            _shared_context.enable_multithreading(False)
+        _shared_context_pid = os.getpid()
+        _shared_context_uses = 0
+    _shared_context_uses += 1
+    return _shared_context
+
+
+def convert_torchscript_module_to_torch_backend_contract_mlir(
+        program: torch.nn.Module, backend_legal_ops=()):
     """Perform common lowering from TorchScript to Torch MLIR
 
+    The ops in `backend_legal_ops` are not decomposed.
+
     Returns an MLIR module that satisfies the Torch backend contract.
     """
-    mb = ModuleBuilder()
+    mb = ModuleBuilder(context=get_shared_context())
     scripted = torch.jit.script(program)
     class_annotator = ClassAnnotator()
 
@@ -70,7 +147,8 @@ def convert_torchscript_module_to_torch_backend_contract_mlir(program: torch.nn.
         original_stderr = sys.stderr
         sys.stderr = StringIO()
         # Import the TorchScript module to MLIR
-        mb.import_module(scripted._c, class_annotator)
+        with time_compile_phase("import"):
+            mb.import_module(scripted._c, class_annotator)
     except Exception as e:
         raise Exception(f"""
 PyTorch TorchScript module -> torch-mlir Object Graph IR import failed with:
@@ -82,9 +160,11 @@ Diagnostics:
     finally:
         sys.stderr = original_stderr
 
-    run_pipeline_with_repro_report(
+    prepare_custom_kernels(mb.module)
+    run_timed_pipeline(
         mb.module,
-        "torchscript-module-to-torch-backend-pipeline",
+        "torch-backend-pipeline",
+        get_torch_backend_pipeline(backend_legal_ops),
         "Lowering TorchScript Object Graph IR -> Torch Backend IR")
 
     return mb.module
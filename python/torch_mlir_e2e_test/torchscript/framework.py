@@ -23,6 +23,13 @@ compiling or TorchScript'ing).
 import abc
 from typing import Any, Callable, List, NamedTuple, Optional, TypeVar, Union, Dict
 
+import contextlib
+import pickle
+import queue
+import resource
+import sys
+import time
+import tracemalloc
 import traceback
 
 import torch
@@ -160,6 +167,18 @@ class TestConfig(abc.ABC):
         """
         pass
 
+    def get_invocations(self, artifact: CompiledArtifact,
+                        trace: Trace) -> List[Callable[[], Any]]:
+        """Returns a function making each call of `trace`, for benchmarks to
+        time.
+
+        Backends that load the artifact, or convert the inputs, on each `run`
+        override this to do it once, before returning the functions, so that
+        only the invocations are timed. By default, each function runs its
+        item of the trace with `run`.
+        """
+        return [lambda item=item: self.run(artifact, [item]) for item in trace]
+
 
 # Utilities for common testing trace generation.
 # Also, resets the random seed for reproducibility.
@@ -235,6 +254,12 @@ class TestResult(NamedTuple):
     trace: Optional[Trace]
     # The golden trace which `trace` is expected to match.
     golden_trace: Optional[Trace]
+    # The seconds spent in each phase of compiling and loading the test, by
+    # name, if compile times were recorded. See `time_compile_phase`.
+    compile_times: Optional[Dict[str, float]] = None
+    # The peak memory usage of compiling and running the test, in bytes, if
+    # it was recorded. See `_track_peak_memory`.
+    memory_usage: Optional[Dict[str, int]] = None
 
 
 class _Tracer:
@@ -277,10 +302,109 @@ def generate_golden_trace(test: Test) -> Trace:
     return trace
 
 
-def compile_and_run_test(test: Test, config: TestConfig) -> Any:
+# The compile times of the test being run, if they are recorded.
+_compile_times: Optional[Dict[str, float]] = None
+
+
+def compile_times_recorded() -> bool:
+    """Returns whether the compile times of the test being run are recorded,
+    for the configs to record more detailed times only then."""
+    return _compile_times is not None
+
+
+def add_compile_time(phase: str, seconds: float):
+    """Adds `seconds` to the time of the phase `phase` of compiling the test
+    being run, if the compile times are recorded."""
+    if _compile_times is not None:
+        _compile_times[phase] = _compile_times.get(phase, 0.0) + seconds
+
+
+@contextlib.contextmanager
+def time_compile_phase(phase: str):
+    """Adds the time spent in the block to the phase `phase` of compiling the
+    test being run, like `add_compile_time`.
+
+    TestConfig's use this to time the phases of their `compile`, e.g. the
+    import and each pipeline, and of loading the artifact in `run`.
+    """
+    start = time.perf_counter()
+    try:
+        yield
+    finally:
+        add_compile_time(phase, time.perf_counter() - start)
+
+
+def _reset_peak_rss() -> bool:
+    """Resets the peak resident set size of the process, which only Linux
+    supports. Returns whether it was reset."""
+    try:
+        with open("/proc/self/clear_refs", "w") as f:
+            f.write("5")
+        return True
+    except OSError:
+        return False
+
+
+def _get_peak_rss() -> int:
+    """Returns the peak resident set size of the process, in bytes, since it
+    was last reset."""
+    try:
+        with open("/proc/self/status") as f:
+            for line in f:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1]) * 1024
+    except OSError:
+        pass
+    # The peak since the process started, in kilobytes on Linux and in bytes
+    # on macOS.
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return peak if sys.platform == "darwin" else peak * 1024
+
+
+@contextlib.contextmanager
+def _track_peak_memory(memory_usage: Optional[Dict[str, int]], phase: str):
+    """Records the peak memory usage of the block into `memory_usage`, if it
+    isn't None, as:
+    - `<phase>_peak_rss`: the peak resident set size of the process, which
+      includes the memory allocated by the compiler and the compiled code.
+      On systems other than Linux, this is the peak since the process
+      started.
+    - `<phase>_peak_allocated`: the peak size of the memory allocated by the
+      block through the Python allocators, which tracemalloc traces. This
+      includes Python objects and NumPy arrays, but not the storage of
+      PyTorch tensors, nor the memory of the compiler and the compiled code.
+      If tracemalloc was already tracing, e.g. for a profiler, it is left
+      running. The peak of the block can then only be measured from Python
+      3.9, which can reset the peak; before that, this value is not recorded.
+    """
+    if memory_usage is None:
+        yield
+        return
+    _reset_peak_rss()
+    was_tracing = tracemalloc.is_tracing()
+    can_trace = not was_tracing or hasattr(tracemalloc, "reset_peak")
+    if was_tracing and can_trace:
+        tracemalloc.reset_peak()
+    elif not was_tracing:
+        tracemalloc.start()
+    allocated_before = tracemalloc.get_traced_memory()[0]
+    try:
+        yield
+    finally:
+        if can_trace:
+            memory_usage[f"{phase}_peak_allocated"] = \
+                tracemalloc.get_traced_memory()[1] - allocated_before
+        if not was_tracing:
+            tracemalloc.stop()
+        memory_usage[f"{phase}_peak_rss"] = _get_peak_rss()
+
+
+def _compile_and_run_test(test: Test, config: TestConfig,
+                          memory_usage: Optional[Dict[str, int]]) -> TestResult:
     try:
         golden_trace = generate_golden_trace(test)
-        compiled = config.compile(test.program_factory())
+        with _track_peak_memory(memory_usage, "compile"):
+            compiled = config.compile(test.program_factory())
     except Exception as e:
         return TestResult(unique_name=test.unique_name,
                           compilation_error="".join(
@@ -290,7 +414,8 @@ def compile_and_run_test(test: Test, config: TestConfig) -> Any:
                           trace=None,
                           golden_trace=None)
     try:
-        trace = config.run(compiled, golden_trace)
+        with _track_peak_memory(memory_usage, "run"):
+            trace = config.run(compiled, golden_trace)
     except Exception as e:
         return TestResult(unique_name=test.unique_name,
                           compilation_error=None,
@@ -306,11 +431,41 @@ def compile_and_run_test(test: Test, config: TestConfig) -> Any:
                       golden_trace=golden_trace)
 
 
+def compile_and_run_test(test: Test, config: TestConfig,
+                         record_compile_times=False,
+                         record_memory_usage=False) -> Any:
+    global _compile_times
+    _compile_times = {} if record_compile_times else None
+    memory_usage = {} if record_memory_usage else None
+    try:
+        result = _compile_and_run_test(test, config, memory_usage)
+    finally:
+        compile_times, _compile_times = _compile_times, None
+    return result._replace(compile_times=compile_times,
+                           memory_usage=memory_usage)
+
+
 queue_sentinel = "QUEUE_SENTINEL"
 
+# Whether this process is a worker started by `run_workers_in_parallel`.
+_in_worker = False
+
+
+def in_worker() -> bool:
+    """Returns whether this process is a worker running tests in parallel
+    with other workers."""
+    return _in_worker
+
 
-def run_workers_in_parallel(task_queue: mp.Queue, worker):
-    NUMBER_OF_PROCESSES = min(int(mp.cpu_count() * 1.1), task_queue.qsize())
+def run_workers_in_parallel(task_queue: mp.Queue, num_tasks: int, worker):
+    """Runs `worker(task_queue)` in forked processes until `task_queue` yields
+    `queue_sentinel`, which is put into it once per process after `join`
+    returns.
+
+    Returns the processes, which are still running so that the caller can
+    receive their results, and a `join` function that stops them.
+    """
+    NUMBER_OF_PROCESSES = min(int(mp.cpu_count() * 1.1), num_tasks)
 
     # TODO: We've noticed that on certain 2 core machine parallelizing the tests
     # makes the llvm backend legacy pass manager 20x slower than using a
@@ -319,31 +474,56 @@ def run_workers_in_parallel(task_queue: mp.Queue, worker):
     if mp.cpu_count() == 2:
         NUMBER_OF_PROCESSES = 1
 
+    def run_worker(task_queue):
+        global _in_worker
+        _in_worker = True
+        worker(task_queue)
+
     processes = []
     for i in range(NUMBER_OF_PROCESSES):
-        p = mp.get_context("fork").Process(target=worker, args=(task_queue, ))
+        p = mp.get_context("fork").Process(target=run_worker,
+                                           args=(task_queue, ))
         p.start()
         processes.append(p)
-    for i in range(NUMBER_OF_PROCESSES):
-        task_queue.put(queue_sentinel)
-    for p in processes:
-        p.join()
 
+    def join():
+        for i in range(NUMBER_OF_PROCESSES):
+            task_queue.put(queue_sentinel)
+        for p in processes:
+            p.join()
+
+    return processes, join
 
-def run_tests(tests: List[Test], config: TestConfig, sequential = False) -> List[TestResult]:
-    """Invoke the given `Test`'s with the provided `TestConfig`."""
+
+def run_tests(tests: List[Test], config: TestConfig, sequential = False,
+              record_compile_times = False,
+              record_memory_usage = False) -> List[TestResult]:
+    """Invoke the given `Test`'s with the provided `TestConfig`.
+
+    If `record_compile_times` is True, the results have the times of the
+    phases of compiling the tests. If `record_memory_usage` is True, they
+    have the peak memory usage of compiling and running the tests.
+    """
     if sequential:
-        return [compile_and_run_test(test, config) for test in tests]
+        return [
+            compile_and_run_test(test, config, record_compile_times,
+                                 record_memory_usage)
+            for test in tests
+        ]
 
     # To run e2e tests in parallel:
-    # The tests are put into a synchronized queue. Multiple worker processes are
-    # created. Each worker takes one test at a time from the queue to compile
-    # and execute it. If the test finishes, whether failed or passed, the result
-    # of the test is put into a synchronized list which collects the tests
-    # results from all worker processes.
-    manager = mp.Manager()
-    tests_queue = manager.Queue()
-    sync_results = manager.list()
+    # The tests are put into a queue. Multiple worker processes are forked.
+    # Each worker takes one test at a time from the queue, tells which test it
+    # started, compiles and executes it, and sends the result back, whether
+    # failed or passed. The workers live until all the tests are done, so they
+    # reuse their MLIR context across tests. The results are pickled before
+    # being queued: the queues of `torch.multiprocessing` would otherwise send
+    # each tensor through shared memory with its own file descriptor, and the
+    # tensors of a whole test suite exhaust the file descriptors of the
+    # process.
+    ctx = mp.get_context("fork")
+    tests_queue = ctx.Queue()
+    results_queue = ctx.Queue()
     # This is needed because autograd does not support crossing process
     # boundaries.
     torch.autograd.set_grad_enabled(False)
@@ -353,19 +533,61 @@ def run_tests(tests: List[Test], config: TestConfig, sequential = False) -> List
     tests_dict = {test.unique_name: test for test in tests}
 
     def worker(tests_queue: mp.Queue):
+        pid = mp.current_process().pid
         for test_name in iter(tests_queue.get, queue_sentinel):
-            sync_results.append(
-                compile_and_run_test(tests_dict[test_name], config))
-
-    run_workers_in_parallel(tests_queue, worker)
-    tests_with_results = {result.unique_name for result in sync_results}
-    all_tests = {test.unique_name for test in tests}
+            results_queue.put((pid, test_name, None))
+            result = compile_and_run_test(tests_dict[test_name], config,
+                                          record_compile_times,
+                                          record_memory_usage)
+            results_queue.put((pid, test_name, pickle.dumps(result)))
+
+    processes, join = run_workers_in_parallel(tests_queue, len(tests),
+                                              worker)
+    results = []
+    # The test that each worker is running.
+    running_tests = {}
     # For processes that are crashed due to compile time or runtime error,
     # the error outputs are printed out all together but no TestResult is
     # produced when the process crashed.
     # TODO: Find a clean way to capture the output from crashed process and
     # create more detailed runtime_error for those tests.
-    aborted_tests = all_tests - tests_with_results
+    aborted_tests = []
+    alive = {p.pid: p for p in processes}
+    while len(results) + len(aborted_tests) < len(tests) and alive:
+        try:
+            pid, test_name, result = results_queue.get(timeout=1)
+        except queue.Empty:
+            # The messages of a worker are all sent before it exits, so its
+            # test is aborted if there are none left once it's dead.
+            for pid, p in list(alive.items()):
+                if p.is_alive():
+                    continue
+                del alive[pid]
+                while True:
+                    try:
+                        message = results_queue.get_nowait()
+                    except queue.Empty:
+                        break
+                    if message[2] is None:
+                        running_tests[message[0]] = message[1]
+                    else:
+                        running_tests.pop(message[0], None)
+                        results.append(pickle.loads(message[2]))
+                if pid in running_tests:
+                    aborted_tests.append(running_tests.pop(pid))
+            continue
+        if result is None:
+            running_tests[pid] = test_name
+        else:
+            del running_tests[pid]
+            results.append(pickle.loads(result))
+    join()
+
+    tests_with_results = {result.unique_name for result in results}
+    tests_with_results.update(aborted_tests)
+    # The tests that were never started because all the workers crashed.
+    aborted_tests.extend(test.unique_name for test in tests
+                         if test.unique_name not in tests_with_results)
     aborted_tests_results = [
         TestResult(
             unique_name=aborted_test_name,
@@ -375,7 +597,6 @@ def run_tests(tests: List[Test], config: TestConfig, sequential = False) -> List
             trace=None,
             golden_trace=None) for aborted_test_name in aborted_tests
     ]
-    results = [result for result in sync_results]
     results.extend(aborted_tests_results)
     results.sort(key=lambda result: result.unique_name)
     return results
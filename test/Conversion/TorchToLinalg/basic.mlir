@@ -57,6 +57,136 @@ func.func @torch.aten.mm$no_convert$result_missing_dtype(%arg0: !torch.vtensor<[
 
 // -----
 
+// The transposed rhs is read with swapped indexing maps instead of being
+// materialized.
+// CHECK-DAG: #[[LHS_MAP:.*]] = affine_map<(d0, d1, d2) -> (d0, d2)>
+// CHECK-DAG: #[[RHS_MAP:.*]] = affine_map<(d0, d1, d2) -> (d1, d2)>
+// CHECK-DAG: #[[OUT_MAP:.*]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+// CHECK-LABEL:   func.func @torch.aten.mm$transposed_rhs(
+// CHECK-SAME:                        %[[LHS_VTENSOR:.*]]: !torch.vtensor<[?,16],f32>,
+// CHECK-SAME:                        %[[RHS_VTENSOR:.*]]: !torch.vtensor<[32,16],f32>) -> !torch.vtensor<[?,32],f32> {
+// CHECK:           linalg.generic {indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #[[OUT_MAP]]], iterator_types = ["parallel", "parallel", "reduction"]}
+// CHECK-SAME:        ins(%{{.*}}, %{{.*}} : tensor<?x16xf32>, tensor<32x16xf32>)
+// CHECK-NOT:       linalg.matmul
+func.func @torch.aten.mm$transposed_rhs(%arg0: !torch.vtensor<[?,16],f32>, %arg1: !torch.vtensor<[32,16],f32>) -> !torch.vtensor<[?,32],f32> {
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.transpose.int %arg1, %int0, %int1 : !torch.vtensor<[32,16],f32>, !torch.int, !torch.int -> !torch.vtensor<[16,32],f32>
+  %1 = torch.aten.mm %arg0, %0 : !torch.vtensor<[?,16],f32>, !torch.vtensor<[16,32],f32> -> !torch.vtensor<[?,32],f32>
+  return %1 : !torch.vtensor<[?,32],f32>
+}
+
+// -----
+
+// The products of 16-bit floats are accumulated in f32.
+// CHECK-LABEL:   func.func @torch.aten.mm$bf16(
+// CHECK:           %[[INIT_TENSOR:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}] : tensor<?x?xf32>
+// CHECK:           %[[CF0:.*]] = arith.constant 0.000000e+00 : f32
+// CHECK:           %[[ZEROFILL:.*]] = linalg.fill ins(%[[CF0]] : f32) outs(%[[INIT_TENSOR]] : tensor<?x?xf32>) -> tensor<?x?xf32>
+// CHECK:           %[[MATMUL:.*]] = linalg.matmul ins(%{{.*}}, %{{.*}} : tensor<?x?xbf16>, tensor<?x?xbf16>) outs(%[[ZEROFILL]] : tensor<?x?xf32>) -> tensor<?x?xf32>
+// CHECK:           %[[TRUNC:.*]] = linalg.generic {{.*}} ins(%[[MATMUL]] : tensor<?x?xf32>) outs(%{{.*}} : tensor<?x?xbf16>)
+// CHECK:             arith.truncf %{{.*}} : f32 to bf16
+// CHECK:           tensor.cast %[[TRUNC]] : tensor<?x?xbf16> to tensor<?x2xbf16>
+func.func @torch.aten.mm$bf16(%arg0: !torch.vtensor<[?,?],bf16>, %arg1: !torch.vtensor<[?,?],bf16>) -> !torch.vtensor<[?,2],bf16> {
+  %0 = torch.aten.mm %arg0, %arg1 : !torch.vtensor<[?,?],bf16>, !torch.vtensor<[?,?],bf16> -> !torch.vtensor<[?,2],bf16>
+  return %0 : !torch.vtensor<[?,2],bf16>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.matmul$matrix_rhs(
+// CHECK:           %[[COLLAPSED:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0, 1], [2]] : tensor<4x8x16xf32> into tensor<32x16xf32>
+// CHECK:           %[[MATMUL:.*]] = linalg.matmul ins(%[[COLLAPSED]], %{{.*}} : tensor<32x16xf32>, tensor<16x32xf32>)
+// CHECK:           tensor.expand_shape %[[MATMUL]] {{\[\[}}0, 1], [2]] : tensor<32x32xf32> into tensor<4x8x32xf32>
+func.func @torch.aten.matmul$matrix_rhs(%arg0: !torch.vtensor<[4,8,16],f32>, %arg1: !torch.vtensor<[16,32],f32>) -> !torch.vtensor<[4,8,32],f32> {
+  %0 = torch.aten.matmul %arg0, %arg1 : !torch.vtensor<[4,8,16],f32>, !torch.vtensor<[16,32],f32> -> !torch.vtensor<[4,8,32],f32>
+  return %0 : !torch.vtensor<[4,8,32],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.matmul$batch(
+// CHECK-NOT:       linalg.generic
+// CHECK:           linalg.batch_matmul ins(%{{.*}}, %{{.*}} : tensor<6x8x16xf32>, tensor<6x16x32xf32>)
+func.func @torch.aten.matmul$batch(%arg0: !torch.vtensor<[2,3,8,16],f32>, %arg1: !torch.vtensor<[2,3,16,32],f32>) -> !torch.vtensor<[2,3,8,32],f32> {
+  %0 = torch.aten.matmul %arg0, %arg1 : !torch.vtensor<[2,3,8,16],f32>, !torch.vtensor<[2,3,16,32],f32> -> !torch.vtensor<[2,3,8,32],f32>
+  return %0 : !torch.vtensor<[2,3,8,32],f32>
+}
+
+// -----
+
+// The broadcast of the lhs is folded into its indexing map.
+// CHECK: #[[LHS_MAP:.*]] = affine_map<(d0, d1, d2, d3, d4) -> (0, d2, d3)>
+// CHECK: #[[RHS_MAP:.*]] = affine_map<(d0, d1, d2, d3, d4) -> (d0, d1, d3, d4)>
+// CHECK-LABEL:   func.func @torch.aten.matmul$broadcast(
+// CHECK:           %[[LHS:.*]] = torch_c.to_builtin_tensor %{{.*}} : !torch.vtensor<[1,8,16],f32> -> tensor<1x8x16xf32>
+// CHECK:           linalg.generic {indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #{{.*}}], iterator_types = ["parallel", "parallel", "parallel", "reduction", "parallel"]}
+// CHECK-SAME:        ins(%[[LHS]], %{{.*}} : tensor<1x8x16xf32>, tensor<2x3x16x32xf32>)
+func.func @torch.aten.matmul$broadcast(%arg0: !torch.vtensor<[1,8,16],f32>, %arg1: !torch.vtensor<[2,3,16,32],f32>) -> !torch.vtensor<[2,3,8,32],f32> {
+  %0 = torch.aten.matmul %arg0, %arg1 : !torch.vtensor<[1,8,16],f32>, !torch.vtensor<[2,3,16,32],f32> -> !torch.vtensor<[2,3,8,32],f32>
+  return %0 : !torch.vtensor<[2,3,8,32],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.matmul$batch_bf16(
+// CHECK:           %[[BMM:.*]] = linalg.batch_matmul ins(%{{.*}}, %{{.*}} : tensor<6x8x16xbf16>, tensor<6x16x32xbf16>) outs(%{{.*}} : tensor<6x8x32xf32>) -> tensor<6x8x32xf32>
+// CHECK:           %[[EXPANDED:.*]] = tensor.expand_shape %[[BMM]] {{\[\[}}0, 1], [2], [3]] : tensor<6x8x32xf32> into tensor<2x3x8x32xf32>
+// CHECK:           %[[TRUNC:.*]] = linalg.generic {{.*}} ins(%[[EXPANDED]] : tensor<2x3x8x32xf32>) outs(%{{.*}} : tensor<2x3x8x32xbf16>)
+// CHECK:             arith.truncf %{{.*}} : f32 to bf16
+func.func @torch.aten.matmul$batch_bf16(%arg0: !torch.vtensor<[2,3,8,16],bf16>, %arg1: !torch.vtensor<[2,3,16,32],bf16>) -> !torch.vtensor<[2,3,8,32],bf16> {
+  %0 = torch.aten.matmul %arg0, %arg1 : !torch.vtensor<[2,3,8,16],bf16>, !torch.vtensor<[2,3,16,32],bf16> -> !torch.vtensor<[2,3,8,32],bf16>
+  return %0 : !torch.vtensor<[2,3,8,32],bf16>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.matmul$broadcast_bf16(
+// CHECK:           %[[MATMUL:.*]] = linalg.generic
+// CHECK-SAME:        ins(%{{.*}}, %{{.*}} : tensor<1x8x16xbf16>, tensor<2x3x16x32xbf16>) outs(%{{.*}} : tensor<2x3x8x32xf32>)
+// CHECK:           ^bb0(%[[L:.*]]: bf16, %[[R:.*]]: bf16, %[[ACC:.*]]: f32):
+// CHECK:             %[[L_EXT:.*]] = arith.extf %[[L]] : bf16 to f32
+// CHECK:             %[[R_EXT:.*]] = arith.extf %[[R]] : bf16 to f32
+// CHECK:             %[[MUL:.*]] = arith.mulf %[[L_EXT]], %[[R_EXT]] : f32
+// CHECK:             %[[ADD:.*]] = arith.addf %[[MUL]], %[[ACC]] : f32
+// CHECK:           linalg.generic {{.*}} ins(%[[MATMUL]] : tensor<2x3x8x32xf32>) outs(%{{.*}} : tensor<2x3x8x32xbf16>)
+// CHECK:             arith.truncf %{{.*}} : f32 to bf16
+func.func @torch.aten.matmul$broadcast_bf16(%arg0: !torch.vtensor<[1,8,16],bf16>, %arg1: !torch.vtensor<[2,3,16,32],bf16>) -> !torch.vtensor<[2,3,8,32],bf16> {
+  %0 = torch.aten.matmul %arg0, %arg1 : !torch.vtensor<[1,8,16],bf16>, !torch.vtensor<[2,3,16,32],bf16> -> !torch.vtensor<[2,3,8,32],bf16>
+  return %0 : !torch.vtensor<[2,3,8,32],bf16>
+}
+
+// -----
+
+// The bias initializes the accumulator of the matmul, and the batch is
+// collapsed into the rows of the input rather than broadcasting the weights.
+// CHECK-LABEL:   func.func @torch.aten.linear$batch(
+// CHECK:           %[[INPUT:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0, 1], [2]] : tensor<4x8x16xf32> into tensor<32x16xf32>
+// CHECK:           %[[BIAS:.*]] = linalg.generic
+// CHECK:           %[[MATMUL:.*]] = linalg.matmul ins(%[[INPUT]], %{{.*}} : tensor<32x16xf32>, tensor<?x?xf32>) outs(%[[BIAS]] : tensor<?x?xf32>)
+// CHECK:           %[[CAST:.*]] = tensor.cast %[[MATMUL]] : tensor<?x?xf32> to tensor<32x24xf32>
+// CHECK:           tensor.expand_shape %[[CAST]] {{\[\[}}0, 1], [2]] : tensor<32x24xf32> into tensor<4x8x24xf32>
+// CHECK-NOT:       linalg.batch_matmul
+func.func @torch.aten.linear$batch(%arg0: !torch.vtensor<[4,8,16],f32>, %arg1: !torch.vtensor<[24,16],f32>, %arg2: !torch.vtensor<[24],f32>) -> !torch.vtensor<[4,8,24],f32> {
+  %0 = torch.aten.linear %arg0, %arg1, %arg2 : !torch.vtensor<[4,8,16],f32>, !torch.vtensor<[24,16],f32>, !torch.vtensor<[24],f32> -> !torch.vtensor<[4,8,24],f32>
+  return %0 : !torch.vtensor<[4,8,24],f32>
+}
+
+// -----
+
+// A constant weight is transposed at compile time, with its signed elements
+// converted to the signless type of the builtin tensor.
+// CHECK-LABEL:   func.func @torch.aten.linear$constant_int_weight(
+// CHECK:           %[[WEIGHT:.*]] = arith.constant dense<{{\[\[}}1, 3, 5], [2, 4, 6]]> : tensor<2x3xi64>
+// CHECK:           linalg.matmul ins(%{{.*}}, %[[WEIGHT]] : tensor<4x2xi64>, tensor<2x3xi64>)
+func.func @torch.aten.linear$constant_int_weight(%arg0: !torch.vtensor<[4,2],si64>, %arg1: !torch.vtensor<[3],si64>) -> !torch.vtensor<[4,3],si64> {
+  %0 = torch.vtensor.literal(dense<[[1, 2], [3, 4], [5, 6]]> : tensor<3x2xsi64>) : !torch.vtensor<[3,2],si64>
+  %1 = torch.aten.linear %arg0, %0, %arg1 : !torch.vtensor<[4,2],si64>, !torch.vtensor<[3,2],si64>, !torch.vtensor<[3],si64> -> !torch.vtensor<[4,3],si64>
+  return %1 : !torch.vtensor<[4,3],si64>
+}
+
+// -----
+
 // CHECK-LABEL:     func.func @torch.aten.Int.Tensor$zero_rank
 // CHECK-SAME:          (%[[ARG:.*]]: !torch.vtensor<[],si64>) -> !torch.int {
 // CHECK:               %[[I:.*]] = torch_c.to_builtin_tensor %[[ARG]] : !torch.vtensor<[],si64> -> tensor<i64>
@@ -197,6 +327,17 @@ func.func @torch.tensor_static_info_cast$basic(%t: !torch.vtensor<[?],f32>) -> !
 
 // -----
 
+// CHECK-LABEL:   func.func @torch.tensor_static_info_cast$sparse(
+// CHECK:           %[[T:.*]] = torch_c.to_builtin_tensor %{{.*}} : !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{{.*}}>> -> tensor<4x8xf32, #sparse_tensor.encoding<{{.*}}>>
+// CHECK:           %[[DENSE:.*]] = sparse_tensor.convert %[[T]] : tensor<4x8xf32, #sparse_tensor.encoding<{{.*}}>> to tensor<4x8xf32>
+// CHECK:           %[[T_CAST:.*]] = tensor.cast %[[DENSE]] : tensor<4x8xf32> to tensor<?x?xf32>
+func.func @torch.tensor_static_info_cast$sparse(%t: !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>) -> !torch.vtensor<[?,?],f32> {
+  %t_cast = torch.tensor_static_info_cast %t : !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>> to !torch.vtensor<[?,?],f32>
+  return %t_cast : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
 // CHECK-LABEL:     func.func @torch.aten.neg
 // CHECK: linalg.generic {{.*}} {
 // CHECK-NEXT:    ^bb0(%[[LHS:.*]]: f32, %{{.*}}: f32):
@@ -210,6 +351,20 @@ func.func @torch.aten.neg(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?
 
 // -----
 
+// The results of earlier conversions are used directly, without
+// materializing them again.
+// CHECK-LABEL:     func.func @torch.aten.neg$converted_operand(
+// CHECK-SAME:                                               %[[ARG:.*]]: tensor<?x?xf32>) -> !torch.vtensor<[?,?],f32> {
+// CHECK-NOT:       torch_c.to_builtin_tensor
+// CHECK:           linalg.generic {{.*}} ins(%[[ARG]] : tensor<?x?xf32>)
+func.func @torch.aten.neg$converted_operand(%arg0: tensor<?x?xf32>) -> !torch.vtensor<[?,?],f32> {
+  %0 = torch_c.from_builtin_tensor %arg0 : tensor<?x?xf32> -> !torch.vtensor<[?,?],f32>
+  %1 = torch.aten.neg %0 : !torch.vtensor<[?,?],f32> -> !torch.vtensor<[?,?],f32>
+  return %1 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
 // CHECK-LABEL:     func.func @torch.aten.neg.bf16
 // CHECK: linalg.generic {{.*}} {
 // CHECK-NEXT:    ^bb0(%[[LHS:.*]]: bf16, %{{.*}}: bf16):
@@ -220,3 +375,495 @@ func.func @torch.aten.neg.bf16(%arg0: !torch.vtensor<[?,?],bf16>) -> !torch.vten
   %0 = torch.aten.neg %arg0 : !torch.vtensor<[?,?],bf16> -> !torch.vtensor<[?,?],bf16>
   return %0 : !torch.vtensor<[?,?],bf16>
 }
+
+// -----
+
+// CHECK-LABEL:     func.func @torch.aten.size.int$valid_dim
+// CHECK-NOT:       assert
+// CHECK:           tensor.dim
+func.func @torch.aten.size.int$valid_dim(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.int {
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.size.int %arg0, %int1 : !torch.vtensor<[?,?],f32>, !torch.int -> !torch.int
+  return %0 : !torch.int
+}
+
+// -----
+
+// The start and end are known to be in bounds, so they are used without
+// normalization or clamping.
+// CHECK-LABEL:     func.func @torch.aten.slice.Tensor$in_bounds
+// CHECK-NOT:       arith.select %{{.*}}, %{{.*}}, %{{.*}} : i64
+// CHECK:           tensor.extract_slice
+func.func @torch.aten.slice.Tensor$in_bounds(%arg0: !torch.vtensor<[8,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %int6 = torch.constant.int 6
+  %0 = torch.aten.slice.Tensor %arg0, %int0, %int2, %int6, %int1 : !torch.vtensor<[8,?],f32>, !torch.int, !torch.int, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The max and the sum of the exponentials are computed in the same reduction.
+// CHECK-LABEL:   func.func @torch.aten._softmax(
+// CHECK-SAME:                                   %[[ARG:.*]]: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+// CHECK:           %[[INPUT:.*]] = torch_c.to_builtin_tensor %[[ARG]] : !torch.vtensor<[?,?],f32> -> tensor<?x?xf32>
+// CHECK:           %[[REDUCTION:.*]]:2 = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK-SAME:        ins(%[[INPUT]] : tensor<?x?xf32>) outs(%{{.*}}, %{{.*}} : tensor<?xf32>, tensor<?xf32>)
+// CHECK:             arith.maxf
+// CHECK:             math.exp
+// CHECK:             linalg.yield
+// CHECK:           %[[RESULT:.*]] = linalg.generic
+// CHECK-SAME:        ins(%[[INPUT]], %[[REDUCTION]]#0, %[[REDUCTION]]#1 : tensor<?x?xf32>, tensor<?xf32>, tensor<?xf32>)
+// CHECK:             arith.subf
+// CHECK:             math.exp
+// CHECK:             arith.divf
+// CHECK-NOT:       linalg.generic
+// CHECK:           return
+func.func @torch.aten._softmax(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %0 = torch.aten._softmax %arg0, %int1, %false : !torch.vtensor<[?,?],f32>, !torch.int, !torch.bool -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The sum of grad_output * output is computed in a single reduction, and the
+// gradient in a single elementwise pass.
+// CHECK-LABEL:   func.func @torch.aten._softmax_backward_data(
+// CHECK:           %[[SUM:.*]] = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK:             arith.mulf
+// CHECK:             arith.addf
+// CHECK:           %[[RESULT:.*]] = linalg.generic
+// CHECK-SAME:        ins(%{{.*}}, %{{.*}}, %[[SUM]] : tensor<?x?xf32>, tensor<?x?xf32>, tensor<?xf32>)
+// CHECK:             arith.subf
+// CHECK:             arith.mulf
+// CHECK-NOT:       linalg.generic
+// CHECK:           return
+func.func @torch.aten._softmax_backward_data(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %int-1 = torch.constant.int -1
+  %int6 = torch.constant.int 6
+  %0 = torch.aten._softmax_backward_data %arg0, %arg1, %int-1, %int6 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten._log_softmax_backward_data(
+// CHECK:           %[[SUM:.*]] = linalg.generic
+// CHECK-SAME:        iterator_types = ["reduction", "parallel"]
+// CHECK-NOT:         arith.mulf
+// CHECK:             arith.addf
+// CHECK:           %[[RESULT:.*]] = linalg.generic
+// CHECK-SAME:        ins(%{{.*}}, %{{.*}}, %[[SUM]] : tensor<?x?xf32>, tensor<?x?xf32>, tensor<?xf32>)
+// CHECK:             math.exp
+// CHECK:             arith.mulf
+// CHECK:             arith.subf
+// CHECK-NOT:       linalg.generic
+// CHECK:           return
+func.func @torch.aten._log_softmax_backward_data(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %int0 = torch.constant.int 0
+  %int6 = torch.constant.int 6
+  %0 = torch.aten._log_softmax_backward_data %arg0, %arg1, %int0, %int6 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The mean and the variance are computed in a single reduction.
+// CHECK-LABEL:   func.func @torch.aten.native_layer_norm(
+// CHECK:           %[[WELFORD:.*]]:3 = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK-NOT:         iterator_types = ["parallel", "reduction"]
+// CHECK:           linalg.generic
+// CHECK-SAME:        ins(%[[WELFORD]]#2 : tensor<?xf32>)
+// CHECK:             math.rsqrt
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel"]
+// CHECK-SAME:        ins(%{{.*}}, %[[WELFORD]]#1, %{{.*}}, %{{.*}}, %{{.*}} : tensor<?x?xf32>, tensor<?xf32>, tensor<?xf32>, tensor<?xf32>, tensor<?xf32>)
+func.func @torch.aten.native_layer_norm(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.vtensor<[?],f32>, %arg2: !torch.vtensor<[?],f32>, %arg3: !torch.int) -> !torch.vtensor<[?,?],f32> {
+  %float1.000000e-05 = torch.constant.float 1.000000e-05
+  %0 = torch.prim.ListConstruct %arg3 : (!torch.int) -> !torch.list<int>
+  %result0, %result1, %result2 = torch.aten.native_layer_norm %arg0, %0, %arg1, %arg2, %float1.000000e-05 : !torch.vtensor<[?,?],f32>, !torch.list<int>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.float -> !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,1],f32>, !torch.vtensor<[?,1],f32>
+  return %result0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The batch stats are computed in a single reduction, along with the updates
+// of the running stats.
+// CHECK-LABEL:   func.func @torch.valsem.aten.native_batch_norm.functional(
+// CHECK:           %[[WELFORD:.*]]:3 = linalg.generic
+// CHECK-SAME:        iterator_types = ["reduction", "parallel", "reduction", "reduction"]
+// CHECK-NOT:         "reduction"
+// CHECK:           %[[STATS:.*]]:3 = linalg.generic
+// CHECK-SAME:        ins(%[[WELFORD]]#2, %[[WELFORD]]#1, %{{.*}}, %{{.*}} : tensor<?xf32>, tensor<?xf32>, tensor<?xf32>, tensor<?xf32>)
+// CHECK:             math.rsqrt
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel", "parallel"]
+// CHECK-SAME:        ins(%{{.*}}, %[[WELFORD]]#1, %[[STATS]]#0, %{{.*}}, %{{.*}} : tensor<?x?x?x?xf32>, tensor<?xf32>, tensor<?xf32>, tensor<?xf32>, tensor<?xf32>)
+func.func @torch.valsem.aten.native_batch_norm.functional(%arg0: !torch.vtensor<[?,?,?,?],f32>, %arg1: !torch.vtensor<[?],f32>, %arg2: !torch.vtensor<[?],f32>, %arg3: !torch.vtensor<[?],f32>, %arg4: !torch.vtensor<[?],f32>) -> (!torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>) {
+  %true = torch.constant.bool true
+  %float1.000000e-01 = torch.constant.float 1.000000e-01
+  %float1.000000e-05 = torch.constant.float 1.000000e-05
+  %0:5 = torch.valsem.aten.native_batch_norm.functional %arg0, %arg1, %arg2, %arg3, %arg4, %true, %float1.000000e-01, %float1.000000e-05 : !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.bool, !torch.float, !torch.float -> !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>
+  return %0#0, %0#3, %0#4 : !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.native_batch_norm_backward(
+// CHECK:           %[[SUMS:.*]]:2 = linalg.generic
+// CHECK-SAME:        iterator_types = ["reduction", "parallel", "reduction", "reduction"]
+// CHECK:           %[[FACTORS:.*]]:4 = linalg.generic
+// CHECK-SAME:        ins(%[[SUMS]]#0, %[[SUMS]]#1, %{{.*}}, %{{.*}} : tensor<?xf32>, tensor<?xf32>, tensor<?xf32>, tensor<?xf32>)
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel", "parallel"]
+// CHECK-SAME:        ins(%{{.*}}, %{{.*}}, %{{.*}}, %[[FACTORS]]#1, %[[FACTORS]]#2, %[[FACTORS]]#3 :
+func.func @torch.aten.native_batch_norm_backward(%arg0: !torch.vtensor<[?,?,?,?],f32>, %arg1: !torch.vtensor<[?,?,?,?],f32>, %arg2: !torch.vtensor<[?],f32>, %arg3: !torch.vtensor<[?],f32>, %arg4: !torch.vtensor<[?],f32>) -> (!torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>) {
+  %none = torch.constant.none
+  %true = torch.constant.bool true
+  %float1.000000e-05 = torch.constant.float 1.000000e-05
+  %0 = torch.prim.ListConstruct %true, %true, %true : (!torch.bool, !torch.bool, !torch.bool) -> !torch.list<bool>
+  %result0, %result1, %result2 = torch.aten.native_batch_norm_backward %arg0, %arg1, %arg2, %none, %none, %arg3, %arg4, %true, %float1.000000e-05, %0 : !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.none, !torch.none, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.bool, !torch.float, !torch.list<bool> -> !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>
+  return %result0, %result1, %result2 : !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.std(
+// CHECK:           %[[WELFORD:.*]]:3 = linalg.generic
+// CHECK-SAME:        iterator_types = ["reduction", "reduction"]
+// CHECK-SAME:        ins(%{{.*}} : tensor<?x?xf32>)
+// CHECK-SAME:        outs(%{{.*}}, %{{.*}}, %{{.*}} : tensor<i64>, tensor<f32>, tensor<f32>)
+// CHECK:           linalg.generic
+// CHECK-SAME:        ins(%[[WELFORD]]#0, %[[WELFORD]]#2 : tensor<i64>, tensor<f32>)
+// CHECK:             arith.subi
+// CHECK:             arith.sitofp
+// CHECK:             arith.divf
+// CHECK:             math.sqrt
+func.func @torch.aten.std(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[],f32> {
+  %true = torch.constant.bool true
+  %0 = torch.aten.std %arg0, %true : !torch.vtensor<[?,?],f32>, !torch.bool -> !torch.vtensor<[],f32>
+  return %0 : !torch.vtensor<[],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.convolution$depthwise(
+// CHECK:           %[[WEIGHT:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0, 1], [2], [3]] : tensor<4x1x3x3xf32> into tensor<4x3x3xf32>
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction", "reduction"]
+// CHECK-SAME:        ins(%{{.*}}, %[[WEIGHT]] : tensor<?x4x?x?xf32>, tensor<4x3x3xf32>)
+func.func @torch.aten.convolution$depthwise(%arg0: !torch.vtensor<[?,4,?,?],f32>, %arg1: !torch.vtensor<[4,1,3,3],f32>) -> !torch.vtensor<[?,4,?,?],f32> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int4 = torch.constant.int 4
+  %0 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %2 = torch.aten.convolution %arg0, %arg1, %none, %0, %1, %0, %false, %1, %int4 : !torch.vtensor<[?,4,?,?],f32>, !torch.vtensor<[4,1,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[?,4,?,?],f32>
+  return %2 : !torch.vtensor<[?,4,?,?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.convolution$groups(
+// CHECK:           tensor.expand_shape %{{.*}} {{\[\[}}0], [1, 2], [3], [4]] : tensor<?x4x?x?xf32> into tensor<?x2x2x?x?xf32>
+// CHECK:           tensor.expand_shape %{{.*}} {{\[\[}}0, 1], [2], [3], [4]] : tensor<6x2x3x3xf32> into tensor<2x3x2x3x3xf32>
+// CHECK:           %[[CONV:.*]] = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel", "parallel", "parallel", "reduction", "reduction", "reduction"]
+// CHECK:           tensor.collapse_shape %[[CONV]] {{\[\[}}0], [1, 2], [3], [4]]
+func.func @torch.aten.convolution$groups(%arg0: !torch.vtensor<[?,4,?,?],f32>, %arg1: !torch.vtensor<[6,2,3,3],f32>) -> !torch.vtensor<[?,6,?,?],f32> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %2 = torch.aten.convolution %arg0, %arg1, %none, %0, %1, %0, %false, %1, %int2 : !torch.vtensor<[?,4,?,?],f32>, !torch.vtensor<[6,2,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[?,6,?,?],f32>
+  return %2 : !torch.vtensor<[?,6,?,?],f32>
+}
+
+// -----
+
+// The reduction is over ceil(3 / 2) = 2 kernel taps per spatial dimension
+// instead of the 3 of a convolution over a zero-stuffed input.
+// CHECK-LABEL:   func.func @torch.aten.convolution$transposed(
+// CHECK:           %[[TAPS:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}, %{{.*}}] : tensor<?x?x?xf32>
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction", "reduction", "reduction"]
+// CHECK-SAME:        ins(%[[TAPS]] : tensor<?x?x?xf32>)
+// CHECK:             arith.remui
+// CHECK:             arith.divui
+// CHECK:             tensor.extract
+// CHECK:             tensor.extract
+// CHECK:             arith.select
+func.func @torch.aten.convolution$transposed(%arg0: !torch.vtensor<[1,4,5,5],f32>, %arg1: !torch.vtensor<[4,2,3,3],f32>) -> !torch.vtensor<[1,2,10,10],f32> {
+  %none = torch.constant.none
+  %true = torch.constant.bool true
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0 = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %2 = torch.aten.convolution %arg0, %arg1, %none, %0, %1, %1, %true, %1, %int1 : !torch.vtensor<[1,4,5,5],f32>, !torch.vtensor<[4,2,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,2,10,10],f32>
+  return %2 : !torch.vtensor<[1,2,10,10],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.quantized.linear(
+// CHECK-NOT:       torch.linear_params.create
+// CHECK:           %[[ACC:.*]] = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "reduction"]
+// CHECK-SAME:        ins(%{{.*}}, %{{.*}} : tensor<4x5xi8>, tensor<2x5xi8>)
+// CHECK-SAME:        outs(%{{.*}} : tensor<4x2xi32>)
+// CHECK:             arith.extsi
+// CHECK:             arith.subi
+// CHECK:             arith.extsi
+// CHECK:             arith.subi
+// CHECK:             arith.muli
+// CHECK:             arith.addi
+// CHECK:           } -> tensor<4x2xi32>
+// CHECK:           linalg.generic
+// CHECK-SAME:        ins(%[[ACC]], %{{.*}} : tensor<4x2xi32>, tensor<2xf32>)
+// CHECK:             arith.sitofp
+// CHECK:             arith.mulf
+// CHECK:             arith.addf
+// CHECK:             arith.divf
+// CHECK:             math.floor
+// CHECK:             arith.fptosi
+// CHECK:           } -> tensor<4x2xi8>
+// CHECK-NOT:       torch.quantized.linear
+func.func @torch.quantized.linear(%arg0: !torch.vtensor<[4,5],si8>, %arg1: !torch.vtensor<[2,5],si8>, %arg2: !torch.vtensor<[2],f32>) -> !torch.vtensor<[4,2],!torch.qint8> {
+  %float1 = torch.constant.float 1.000000e-01
+  %float2 = torch.constant.float 2.000000e-01
+  %float3 = torch.constant.float 5.000000e-01
+  %int0 = torch.constant.int 0
+  %int3 = torch.constant.int 3
+  %0 = torch.per_tensor_affine.create %arg0, %float1, %int3 : !torch.vtensor<[4,5],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,5],!torch.qint8>
+  %1 = torch.per_tensor_affine.create %arg1, %float2, %int0 : !torch.vtensor<[2,5],si8>, !torch.float, !torch.int -> !torch.vtensor<[2,5],!torch.qint8>
+  %2 = torch.linear_params.create %1, %arg2 : !torch.vtensor<[2,5],!torch.qint8>, !torch.vtensor<[2],f32>
+  %3 = torch.quantized.linear %0, %2, %float3, %int0 : !torch.vtensor<[4,5],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,2],!torch.qint8>
+  return %3 : !torch.vtensor<[4,2],!torch.qint8>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.min.dim(
+// CHECK:           %[[INF:.*]] = arith.constant 0x7F800000 : f32
+// CHECK:           %[[VALS:.*]] = linalg.fill ins(%[[INF]] : f32)
+// CHECK:           %[[RESULT:.*]]:2 = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK-SAME:        ins(%{{.*}} : tensor<?x?xf32>)
+// CHECK-SAME:        outs(%[[VALS]], %{{.*}} : tensor<?xf32>, tensor<?xi64>)
+// CHECK:             linalg.index 1 : index
+// CHECK:             %[[LESS:.*]] = arith.cmpf ult
+// CHECK:             %[[ORDERED:.*]] = arith.cmpf ord
+// CHECK:             %[[PRED:.*]] = arith.andi %[[LESS]], %[[ORDERED]] : i1
+// CHECK:             arith.select %[[PRED]]
+// CHECK:             arith.select %[[PRED]]
+// CHECK:           } -> (tensor<?xf32>, tensor<?xi64>)
+func.func @torch.aten.min.dim(%arg0: !torch.vtensor<[?,?],f32>) -> (!torch.vtensor<[?],f32>, !torch.vtensor<[?],si64>) {
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %values, %indices = torch.aten.min.dim %arg0, %int1, %false : !torch.vtensor<[?,?],f32>, !torch.int, !torch.bool -> !torch.vtensor<[?],f32>, !torch.vtensor<[?],si64>
+  return %values, %indices : !torch.vtensor<[?],f32>, !torch.vtensor<[?],si64>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.valsem.aten.uniform(
+// CHECK:           %[[SEED:.*]] = torch_c.get_next_seed : () -> i64
+// CHECK:           %[[SHIFT:.*]] = arith.constant 11 : i64
+// CHECK:           %[[UNIT_SCALE:.*]] = arith.constant 1.1102230246251565E-16 : f64
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel"]
+// CHECK:             %[[INDEX0:.*]] = linalg.index 0 : index
+// CHECK:             %[[INDEX1:.*]] = linalg.index 1 : index
+// CHECK:             arith.constant -766435501 : i32
+// CHECK:             arith.constant -845247145 : i32
+// CHECK:             %[[BITS:.*]] = arith.shrui %{{.*}}, %[[SHIFT]] : i64
+// CHECK:             %[[FLOAT:.*]] = arith.uitofp %[[BITS]] : i64 to f64
+// CHECK:             %[[UNIT:.*]] = arith.mulf %[[FLOAT]], %[[UNIT_SCALE]] : f64
+// CHECK:             linalg.yield
+// CHECK:           } -> tensor<?x?xf64>
+func.func @torch.valsem.aten.uniform(%arg0: !torch.vtensor<[?,?],f64>) -> !torch.vtensor<[?,?],f64> {
+  %float0 = torch.constant.float 0.000000e+00
+  %float1 = torch.constant.float 1.000000e+00
+  %none = torch.constant.none
+  %0 = torch.valsem.aten.uniform %arg0, %float0, %float1, %none : !torch.vtensor<[?,?],f64>, !torch.float, !torch.float, !torch.none -> !torch.vtensor<[?,?],f64>
+  return %0 : !torch.vtensor<[?,?],f64>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.embedding(
+// CHECK-SAME:                                    %[[WEIGHT:.*]]: !torch.vtensor<[?,?],f32>,
+// CHECK-SAME:                                    %[[INDICES:.*]]: !torch.vtensor<[?,?],si64>) -> !torch.vtensor<[?,?,?],f32> {
+// CHECK-DAG:       %[[BUILTIN_WEIGHT:.*]] = torch_c.to_builtin_tensor %[[WEIGHT]] : !torch.vtensor<[?,?],f32> -> tensor<?x?xf32>
+// CHECK-DAG:       %[[BUILTIN_INDICES:.*]] = torch_c.to_builtin_tensor %[[INDICES]] : !torch.vtensor<[?,?],si64> -> tensor<?x?xi64>
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor {{.*}} : tensor<?x?x?xf32>
+// CHECK:           %[[RESULT:.*]] = scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC0:.*]] = %[[INIT]]) -> (tensor<?x?x?xf32>) {
+// CHECK:             %[[LOOP:.*]] = scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC1:.*]] = %[[ACC0]]) -> (tensor<?x?x?xf32>) {
+// CHECK:               %[[INDEX_INT:.*]] = tensor.extract %[[BUILTIN_INDICES]][%[[I]], %[[J]]] : tensor<?x?xi64>
+// CHECK:               %[[INDEX:.*]] = arith.index_cast %[[INDEX_INT]] : i64 to index
+// CHECK:               assert %{{.*}}, "index must be in [0, num_embeddings)"
+// CHECK:               %[[ROW:.*]] = tensor.extract_slice %[[BUILTIN_WEIGHT]][%[[INDEX]], 0] [1, %{{.*}}] [1, 1] : tensor<?x?xf32> to tensor<?xf32>
+// CHECK:               %[[INSERT:.*]] = tensor.insert_slice %[[ROW]] into %[[ACC1]][%[[I]], %[[J]], 0] [1, 1, %{{.*}}] [1, 1, 1] : tensor<?xf32> into tensor<?x?x?xf32>
+// CHECK:               scf.yield %[[INSERT]] : tensor<?x?x?xf32>
+// CHECK:             }
+// CHECK:             scf.yield %[[LOOP]] : tensor<?x?x?xf32>
+// CHECK:           }
+func.func @torch.aten.embedding(%weight: !torch.vtensor<[?,?],f32>, %indices: !torch.vtensor<[?,?],si64>) -> !torch.vtensor<[?,?,?],f32> {
+  %int-1 = torch.constant.int -1
+  %false = torch.constant.bool false
+  %0 = torch.aten.embedding %weight, %indices, %int-1, %false, %false : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],si64>, !torch.int, !torch.bool, !torch.bool -> !torch.vtensor<[?,?,?],f32>
+  return %0 : !torch.vtensor<[?,?,?],f32>
+}
+
+// -----
+
+// The rows of a statically shaped weight are sliced with static sizes.
+// CHECK-LABEL:   func.func @torch.aten.embedding$static(
+// CHECK:               %[[ROW:.*]] = tensor.extract_slice %{{.*}}[%{{.*}}, 0] [1, 4] [1, 1] : tensor<10x4xf32> to tensor<4xf32>
+// CHECK:               tensor.insert_slice %[[ROW]] into %{{.*}}[%{{.*}}, %{{.*}}, 0] [1, 1, 4] [1, 1, 1] : tensor<4xf32> into tensor<{{.*}}>
+func.func @torch.aten.embedding$static(%weight: !torch.vtensor<[10,4],f32>, %indices: !torch.vtensor<[2,3],si64>) -> !torch.vtensor<[2,3,4],f32> {
+  %int-1 = torch.constant.int -1
+  %false = torch.constant.bool false
+  %0 = torch.aten.embedding %weight, %indices, %int-1, %false, %false : !torch.vtensor<[10,4],f32>, !torch.vtensor<[2,3],si64>, !torch.int, !torch.bool, !torch.bool -> !torch.vtensor<[2,3,4],f32>
+  return %0 : !torch.vtensor<[2,3,4],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.embedding_bag.padding_idx$sum(
+// CHECK:           %[[OUTPUT:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}] : tensor<?x?xf32>
+// CHECK:           %[[RESULT:.*]] = scf.for %[[BAG:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[OUT:.*]] = %[[OUTPUT]]) -> (tensor<?x?xf32>) {
+// CHECK:             %[[START_INT:.*]] = tensor.extract %{{.*}}[%[[BAG]]] : tensor<?xi64>
+// CHECK:             %[[START:.*]] = arith.index_cast %[[START_INT]] : i64 to index
+// CHECK:             %[[END:.*]] = arith.select
+// CHECK:             %[[ACC_INIT:.*]] = linalg.fill
+// CHECK:             %[[POOLED:.*]] = scf.for %[[J:.*]] = %[[START]] to %[[END]] step %{{.*}} iter_args(%[[ACC:.*]] = %[[ACC_INIT]]) -> (tensor<?xf32>) {
+// CHECK:               %[[ROW:.*]] = tensor.extract_slice %{{.*}}[%{{.*}}, 0] [1, %{{.*}}] [1, 1] : tensor<?x?xf32> to tensor<?xf32>
+// CHECK:               %[[NEW_ACC:.*]] = linalg.generic {{.*}} ins(%[[ROW]] : tensor<?xf32>) outs(%[[ACC]] : tensor<?xf32>) {
+// CHECK:                 arith.addf
+// CHECK:               scf.yield %[[NEW_ACC]] : tensor<?xf32>
+// CHECK:             }
+// CHECK:             %[[INSERT:.*]] = tensor.insert_slice %[[POOLED]] into %[[OUT]][%[[BAG]], 0] [1, %{{.*}}] [1, 1] : tensor<?xf32> into tensor<?x?xf32>
+// CHECK:             scf.yield %[[INSERT]] : tensor<?x?xf32>
+// CHECK:           }
+func.func @torch.aten.embedding_bag.padding_idx$sum(%weight: !torch.vtensor<[?,?],f32>, %indices: !torch.vtensor<[?],si64>, %offsets: !torch.vtensor<[?],si64>) -> !torch.vtensor<[?,?],f32> {
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %none = torch.constant.none
+  %0:4 = torch.aten.embedding_bag.padding_idx %weight, %indices, %offsets, %false, %int0, %false, %none, %false, %none : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],si64>, !torch.vtensor<[?],si64>, !torch.bool, !torch.int, !torch.bool, !torch.none, !torch.bool, !torch.none -> !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],si64>, !torch.vtensor<[?],si64>, !torch.vtensor<[?],si64>
+  return %0#0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The rows of a statically shaped weight are pooled with static sizes.
+// CHECK-LABEL:   func.func @torch.aten.embedding_bag.padding_idx$static(
+// CHECK:             %[[POOLED:.*]] = scf.for {{.*}} -> (tensor<4xf32>) {
+// CHECK:               tensor.extract_slice %{{.*}}[%{{.*}}, 0] [1, 4] [1, 1] : tensor<10x4xf32> to tensor<4xf32>
+// CHECK:             tensor.insert_slice %[[POOLED]] into %{{.*}}[%{{.*}}, 0] [1, 4] [1, 1] : tensor<4xf32> into tensor<{{.*}}>
+func.func @torch.aten.embedding_bag.padding_idx$static(%weight: !torch.vtensor<[10,4],f32>, %indices: !torch.vtensor<[6],si64>, %offsets: !torch.vtensor<[2],si64>) -> !torch.vtensor<[2,4],f32> {
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %none = torch.constant.none
+  %0:4 = torch.aten.embedding_bag.padding_idx %weight, %indices, %offsets, %false, %int0, %false, %none, %false, %none : !torch.vtensor<[10,4],f32>, !torch.vtensor<[6],si64>, !torch.vtensor<[2],si64>, !torch.bool, !torch.int, !torch.bool, !torch.none, !torch.bool, !torch.none -> !torch.vtensor<[2,4],f32>, !torch.vtensor<[?],si64>, !torch.vtensor<[?],si64>, !torch.vtensor<[?],si64>
+  return %0#0 : !torch.vtensor<[2,4],f32>
+}
+
+// -----
+
+// CHECK: #[[INDEX_MAP:.*]] = affine_map<(d0, d1) -> (d0)>
+// CHECK: #[[IDENTITY:.*]] = affine_map<(d0, d1) -> (d0, d1)>
+// CHECK-LABEL:   func.func @torch.aten.index.Tensor$non_contiguous(
+// CHECK-SAME:        %[[INPUT:.*]]: !torch.vtensor<[?,?,?],f32>,
+// CHECK:           %[[BUILTIN_INPUT:.*]] = torch_c.to_builtin_tensor %[[INPUT]] : !torch.vtensor<[?,?,?],f32> -> tensor<?x?x?xf32>
+// CHECK:           assert %{{.*}}, "mismatched size for broadcast"
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}] : tensor<?x?xf32>
+// CHECK:           %[[GENERIC:.*]] = linalg.generic {indexing_maps = [#[[INDEX_MAP]], #[[INDEX_MAP]], #[[IDENTITY]]], iterator_types = ["parallel", "parallel"]} ins(%{{.*}}, %{{.*}} : tensor<?xi64>, tensor<?xi64>) outs(%[[INIT]] : tensor<?x?xf32>) {
+// CHECK:           ^bb0(%[[INDEX0:.*]]: i64, %[[INDEX2:.*]]: i64, %{{.*}}: f32):
+// CHECK:             %[[I0:.*]] = arith.index_cast %[[INDEX0]] : i64 to index
+// CHECK:             %[[NEG0:.*]] = arith.cmpi slt, %[[I0]]
+// CHECK:             %[[WRAPPED0:.*]] = arith.addi %[[I0]]
+// CHECK:             %[[SELECT0:.*]] = arith.select %[[NEG0]], %[[WRAPPED0]], %[[I0]] : index
+// CHECK:             %[[I1:.*]] = linalg.index 1 : index
+// CHECK:             %[[I2:.*]] = arith.index_cast %[[INDEX2]] : i64 to index
+// CHECK:             %[[SELECT2:.*]] = arith.select
+// CHECK:             %[[ELEMENT:.*]] = tensor.extract %[[BUILTIN_INPUT]][%[[SELECT0]], %[[I1]], %[[SELECT2]]] : tensor<?x?x?xf32>
+// CHECK:             linalg.yield %[[ELEMENT]] : f32
+// CHECK:           } -> tensor<?x?xf32>
+func.func @torch.aten.index.Tensor$non_contiguous(%input: !torch.vtensor<[?,?,?],f32>, %index0: !torch.vtensor<[?],si64>, %index2: !torch.vtensor<[?],si64>) -> !torch.vtensor<[?,?],f32> {
+  %none = torch.constant.none
+  %0 = torch.prim.ListConstruct %index0, %none, %index2 : (!torch.vtensor<[?],si64>, !torch.none, !torch.vtensor<[?],si64>) -> !torch.list<optional<vtensor>>
+  %1 = torch.aten.index.Tensor %input, %0 : !torch.vtensor<[?,?,?],f32>, !torch.list<optional<vtensor>> -> !torch.vtensor<[?,?],f32>
+  return %1 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.cross_entropy_loss(
+// CHECK:           %[[REDUCTION:.*]]:2 = linalg.generic {{.*}} iterator_types = ["parallel", "reduction"]} ins(%{{.*}} : tensor<?x?xf32>) outs(%{{.*}}, %{{.*}} : tensor<?xf32>, tensor<?xf32>)
+// CHECK:           %[[PER_SAMPLE:.*]]:2 = linalg.generic {{.*}} iterator_types = ["parallel"]} ins(%{{.*}}, %[[REDUCTION]]#0, %[[REDUCTION]]#1 : tensor<?xi64>, tensor<?xf32>, tensor<?xf32>)
+// CHECK:             tensor.extract %{{.*}}[%{{.*}}, %{{.*}}] : tensor<?x?xf32>
+// CHECK:             math.log
+// CHECK:           %[[SUMS:.*]]:2 = linalg.generic {{.*}} iterator_types = ["reduction"]} ins(%[[PER_SAMPLE]]#0, %[[PER_SAMPLE]]#1 : tensor<?xf32>, tensor<?xf32>) outs(%{{.*}}, %{{.*}} : tensor<f32>, tensor<f32>)
+// CHECK:           linalg.generic {{.*}} ins(%[[SUMS]]#0, %[[SUMS]]#1 : tensor<f32>, tensor<f32>)
+// CHECK:             arith.divf
+func.func @torch.aten.cross_entropy_loss(%input: !torch.vtensor<[?,?],f32>, %target: !torch.vtensor<[?],si64>) -> !torch.vtensor<[],f32> {
+  %none = torch.constant.none
+  %int1 = torch.constant.int 1
+  %int-100 = torch.constant.int -100
+  %float0 = torch.constant.float 0.000000e+00
+  %0 = torch.aten.cross_entropy_loss %input, %target, %none, %int1, %int-100, %float0 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],si64>, !torch.none, !torch.int, !torch.int, !torch.float -> !torch.vtensor<[],f32>
+  return %0 : !torch.vtensor<[],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten._log_softmax_backward_data$nll_loss(
+// CHECK:           %[[GRAD:.*]] = linalg.generic {{.*}} ins(%{{.*}}, %{{.*}}, %{{.*}}, %{{.*}} : tensor<f32>, tensor<?xi64>, tensor<f32>, tensor<?x?xf32>)
+// CHECK:             %[[SOFTMAX:.*]] = math.exp
+// CHECK:             %[[SCALED:.*]] = arith.mulf %[[SOFTMAX]]
+// CHECK:             %[[GRAD_ELEM:.*]] = arith.subf %[[SCALED]]
+// CHECK:             linalg.yield %[[GRAD_ELEM]] : f32
+// CHECK:           %[[CAST:.*]] = tensor.cast %[[GRAD]] : tensor<?x?xf32> to tensor<?x?xf32>
+func.func @torch.aten._log_softmax_backward_data$nll_loss(%grad_output: !torch.vtensor<[],f32>, %output: !torch.vtensor<[?,?],f32>, %target: !torch.vtensor<[?],si64>, %total_weight: !torch.vtensor<[],f32>) -> !torch.vtensor<[?,?],f32> {
+  %none = torch.constant.none
+  %int1 = torch.constant.int 1
+  %int6 = torch.constant.int 6
+  %int-100 = torch.constant.int -100
+  %0 = torch.aten.nll_loss_backward %grad_output, %output, %target, %none, %int1, %int-100, %total_weight : !torch.vtensor<[],f32>, !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],si64>, !torch.none, !torch.int, !torch.int, !torch.vtensor<[],f32> -> !torch.vtensor<[?,?],f32>
+  %1 = torch.aten._log_softmax_backward_data %0, %output, %int1, %int6 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %1 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.slice_scatter(
+// CHECK-SAME:                                        %[[SELF:.*]]: !torch.vtensor<[4,6],f32>, %[[SRC:.*]]: !torch.vtensor<[4,2],f32>) -> !torch.vtensor<[4,6],f32> {
+// CHECK-DAG:       %[[BUILTIN_SELF:.*]] = torch_c.to_builtin_tensor %[[SELF]] : !torch.vtensor<[4,6],f32> -> tensor<4x6xf32>
+// CHECK-DAG:       %[[BUILTIN_SRC:.*]] = torch_c.to_builtin_tensor %[[SRC]] : !torch.vtensor<[4,2],f32> -> tensor<4x2xf32>
+// CHECK:           cf.assert %{{.*}}, "src must have the size of the slice"
+// CHECK:           cf.assert %{{.*}}, "src must have the size of the slice"
+// CHECK:           %[[INSERT:.*]] = tensor.insert_slice %[[BUILTIN_SRC]] into %[[BUILTIN_SELF]][{{.*}}] [4, 2] [{{.*}}] : tensor<4x2xf32> into tensor<4x6xf32>
+// CHECK:           %[[CAST:.*]] = tensor.cast %[[INSERT]] : tensor<4x6xf32> to tensor<4x6xf32>
+// CHECK:           %[[RESULT:.*]] = torch_c.from_builtin_tensor %[[CAST]] : tensor<4x6xf32> -> !torch.vtensor<[4,6],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[4,6],f32>
+func.func @torch.aten.slice_scatter(%self: !torch.vtensor<[4,6],f32>, %src: !torch.vtensor<[4,2],f32>) -> !torch.vtensor<[4,6],f32> {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %int5 = torch.constant.int 5
+  %0 = torch.aten.slice_scatter %self, %src, %int1, %int1, %int5, %int2 : !torch.vtensor<[4,6],f32>, !torch.vtensor<[4,2],f32>, !torch.int, !torch.int, !torch.int, !torch.int -> !torch.vtensor<[4,6],f32>
+  return %0 : !torch.vtensor<[4,6],f32>
+}
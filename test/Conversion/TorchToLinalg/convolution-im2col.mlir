@@ -0,0 +1,39 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg="conv-im2col" -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   func.func @torch.aten.convolution$im2col(
+// CHECK:           %[[COLS:.*]] = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel", "parallel", "parallel", "parallel"]
+// CHECK-SAME:        outs(%{{.*}} : tensor<{{.*}}x3x3x{{.*}}x6x6xf32>)
+// CHECK:           %[[COLS_MATRIX:.*]] = tensor.collapse_shape %[[COLS]] {{\[\[}}0, 1, 2], [3, 4, 5]]
+// CHECK:           %[[WEIGHT_MATRIX:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0], [1, 2, 3]] : tensor<4x3x3x3xf32> into tensor<4x27xf32>
+// CHECK:           %[[MATMUL:.*]] = linalg.matmul ins(%[[WEIGHT_MATRIX]], %[[COLS_MATRIX]] : tensor<4x27xf32>, tensor<{{.*}}>)
+// CHECK:           %[[EXPANDED:.*]] = tensor.expand_shape %[[MATMUL]] {{\[\[}}0], [1, 2, 3]]
+// CHECK:           linalg.generic
+// CHECK-SAME:        ins(%[[EXPANDED]] : tensor<4x{{.*}}x6x6xf32>)
+// CHECK-NOT:       linalg.conv_2d_nchw_fchw
+func.func @torch.aten.convolution$im2col(%arg0: !torch.vtensor<[1,3,8,8],f32>, %arg1: !torch.vtensor<[4,3,3,3],f32>) -> !torch.vtensor<[1,4,6,6],f32> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %0 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %2 = torch.aten.convolution %arg0, %arg1, %none, %0, %1, %0, %false, %1, %int1 : !torch.vtensor<[1,3,8,8],f32>, !torch.vtensor<[4,3,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,4,6,6],f32>
+  return %2 : !torch.vtensor<[1,4,6,6],f32>
+}
+
+// -----
+
+// The columns of the im2col matrix need static spatial sizes.
+// CHECK-LABEL:   func.func @torch.aten.convolution$dynamic_spatial_sizes(
+// CHECK:           linalg.conv_2d_nchw_fchw
+func.func @torch.aten.convolution$dynamic_spatial_sizes(%arg0: !torch.vtensor<[1,3,?,?],f32>, %arg1: !torch.vtensor<[4,3,3,3],f32>) -> !torch.vtensor<[1,4,?,?],f32> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %0 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %2 = torch.aten.convolution %arg0, %arg1, %none, %0, %1, %0, %false, %1, %int1 : !torch.vtensor<[1,3,?,?],f32>, !torch.vtensor<[4,3,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,4,?,?],f32>
+  return %2 : !torch.vtensor<[1,4,?,?],f32>
+}
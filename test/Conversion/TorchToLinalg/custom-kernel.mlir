@@ -0,0 +1,34 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   func.func @custom_kernel(
+// CHECK-SAME:                             %[[ARG:.*]]: !torch.vtensor<[?,4],f32>,
+// CHECK-SAME:                             %[[ALPHA:.*]]: !torch.float,
+// CHECK-SAME:                             %[[SIZE0:.*]]: !torch.int) -> !torch.vtensor<[?,4],f32> {
+// CHECK-DAG:       %[[INPUT:.*]] = torch_c.to_builtin_tensor %[[ARG]] : !torch.vtensor<[?,4],f32> -> tensor<?x4xf32>
+// CHECK-DAG:       %[[ALPHA_F64:.*]] = torch_c.to_f64 %[[ALPHA]]
+// CHECK:           %[[INT4:.*]] = torch.constant.int 4
+// CHECK:           %[[SIZE0_I64:.*]] = torch_c.to_i64 %[[SIZE0]]
+// CHECK:           %[[INT4_I64:.*]] = torch_c.to_i64 %[[INT4]]
+// CHECK:           %[[SIZE0_INDEX:.*]] = arith.index_cast %[[SIZE0_I64]] : i64 to index
+// CHECK:           %[[INT4_INDEX:.*]] = arith.index_cast %[[INT4_I64]] : i64 to index
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor [%[[SIZE0_INDEX]], %[[INT4_INDEX]]] : tensor<?x?xf32>
+// CHECK:           %[[OUTPUT:.*]] = tensor.cast %[[INIT]] : tensor<?x?xf32> to tensor<?x4xf32>
+// CHECK:           %[[RESULT:.*]] = torch_c.call_kernel "my_ops_gelu" ins(%[[INPUT]], %[[ALPHA_F64]] : tensor<?x4xf32>, f64) outs(%[[OUTPUT]] : tensor<?x4xf32>) -> tensor<?x4xf32>
+// CHECK:           %[[RESULT_VTENSOR:.*]] = torch_c.from_builtin_tensor %[[RESULT]] : tensor<?x4xf32> -> !torch.vtensor<[?,4],f32>
+// CHECK:           return %[[RESULT_VTENSOR]] : !torch.vtensor<[?,4],f32>
+func.func @custom_kernel(%arg0: !torch.vtensor<[?,4],f32>, %alpha: !torch.float, %size0: !torch.int) -> !torch.vtensor<[?,4],f32> {
+  %int4 = torch.constant.int 4
+  %shape = torch.prim.ListConstruct %size0, %int4 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.operator "my_ops.gelu"(%arg0, %alpha, %shape) {torch.custom_kernel = "my_ops_gelu", torch.custom_kernel_num_inputs = 2 : i64} : (!torch.vtensor<[?,4],f32>, !torch.float, !torch.list<int>) -> !torch.vtensor<[?,4],f32>
+  return %0 : !torch.vtensor<[?,4],f32>
+}
+
+// -----
+
+// The ops that are not calls to custom kernels are left alone.
+// CHECK-LABEL:   func.func @unresolved_operator(
+// CHECK:           torch.operator "aten.mul.Scalar"
+func.func @unresolved_operator(%arg0: !torch.vtensor<[],f32>, %arg1: !torch.int) -> !torch.vtensor<[],f32> {
+  %0 = torch.operator "aten.mul.Scalar"(%arg0, %arg1) : (!torch.vtensor<[],f32>, !torch.int) -> !torch.vtensor<[],f32>
+  return %0 : !torch.vtensor<[],f32>
+}
@@ -94,3 +94,84 @@ func.func @insufficient_dims_for_triu(%arg0: !torch.vtensor<[?],f32>) -> !torch.
   %0 = torch.aten.triu %arg0, %int0 : !torch.vtensor<[?],f32>, !torch.int -> !torch.vtensor<[?],f32>
   return %0 : !torch.vtensor<[?],f32>
 }
+
+// -----
+
+// The dynamic dimensions of the result of the first op are those of its
+// operand, so no runtime checks are needed when combining them.
+// CHECK-LABEL:   func.func @elementwise$symbolic_dims(
+// CHECK-NOT:       assert
+// CHECK:           return
+func.func @elementwise$symbolic_dims(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor<[?,?],f32> -> !torch.vtensor<[?,?],f32>
+  %1 = torch.aten.mul.Tensor %0, %arg0 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32> -> !torch.vtensor<[?,?],f32>
+  %2 = torch.aten.mul.Tensor %1, %0 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32> -> !torch.vtensor<[?,?],f32>
+  return %2 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The result of an op that came from an in-place variant is computed into the
+// tensor of its first operand.
+// CHECK-LABEL:   func.func @elementwise$inplace(
+// CHECK:           %[[BUILTIN_ARG0:.*]] = torch_c.to_builtin_tensor %arg0 : !torch.vtensor<[?],f32> -> tensor<?xf32>
+// CHECK-NOT:       linalg.init_tensor
+// CHECK:           linalg.generic
+// CHECK-SAME:        outs(%[[BUILTIN_ARG0]] : tensor<?xf32>)
+func.func @elementwise$inplace(%arg0: !torch.vtensor<[?],f32>, %arg1: !torch.vtensor<[?],f32>) -> !torch.vtensor<[?],f32> {
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.add.Tensor %arg0, %arg1, %int1 {torch.inplace} : !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.int -> !torch.vtensor<[?],f32>
+  return %0 : !torch.vtensor<[?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @elementwise$broadcast_operand(
+// CHECK-SAME:                                          %[[SCORES:.*]]: !torch.vtensor<[2,4,8],f32>,
+// CHECK-SAME:                                          %[[MASK:.*]]: !torch.vtensor<[2,1,8],f32>) -> !torch.vtensor<[2,4,8],f32> {
+// CHECK-DAG:       %[[BUILTIN_SCORES:.*]] = torch_c.to_builtin_tensor %[[SCORES]] : !torch.vtensor<[2,4,8],f32> -> tensor<2x4x8xf32>
+// CHECK-DAG:       %[[BUILTIN_MASK:.*]] = torch_c.to_builtin_tensor %[[MASK]] : !torch.vtensor<[2,1,8],f32> -> tensor<2x1x8xf32>
+// The broadcast is left dead by the elementwise op reading the mask directly.
+// CHECK:           linalg.generic {indexing_maps = [affine_map<(d0, d1, d2) -> (d0, d1, d2)>, affine_map<(d0, d1, d2) -> (d0, 0, d2)>, affine_map<(d0, d1, d2) -> (d0, d1, d2)>]
+// CHECK-SAME:      ins(%[[BUILTIN_SCORES]], %[[BUILTIN_MASK]] : tensor<2x4x8xf32>, tensor<2x1x8xf32>)
+func.func @elementwise$broadcast_operand(%arg0: !torch.vtensor<[2,4,8],f32>, %arg1: !torch.vtensor<[2,1,8],f32>) -> !torch.vtensor<[2,4,8],f32> {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %int4 = torch.constant.int 4
+  %int8 = torch.constant.int 8
+  %0 = torch.prim.ListConstruct %int2, %int4, %int8 : (!torch.int, !torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.broadcast_to %arg1, %0 : !torch.vtensor<[2,1,8],f32>, !torch.list<int> -> !torch.vtensor<[2,4,8],f32>
+  %2 = torch.aten.add.Tensor %arg0, %1, %int1 : !torch.vtensor<[2,4,8],f32>, !torch.vtensor<[2,4,8],f32>, !torch.int -> !torch.vtensor<[2,4,8],f32>
+  return %2 : !torch.vtensor<[2,4,8],f32>
+}
+
+// -----
+
+// When all the shapes are static, the result shape is computed at compile time
+// and no runtime broadcast checks are emitted.
+// CHECK-LABEL:   func.func @elementwise$static_broadcast(
+// CHECK-NOT:       tensor.dim
+// CHECK-NOT:       assert
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor [4, 3] : tensor<4x3xf32>
+// CHECK:           linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, 0)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>]
+// CHECK-SAME:      outs(%[[INIT]] : tensor<4x3xf32>)
+func.func @elementwise$static_broadcast(%arg0: !torch.vtensor<[4,1],f32>, %arg1: !torch.vtensor<[3],f32>) -> !torch.vtensor<[4,3],f32> {
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.add.Tensor %arg0, %arg1, %int1 : !torch.vtensor<[4,1],f32>, !torch.vtensor<[3],f32>, !torch.int -> !torch.vtensor<[4,3],f32>
+  return %0 : !torch.vtensor<[4,3],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @elementwise$tanh_backward(
+// CHECK:           linalg.generic
+// CHECK:           ^bb0(%[[GRAD:.*]]: f32, %[[OUT:.*]]: f32, %{{.*}}: f32):
+// CHECK:             %[[ONE:.*]] = arith.constant 1.000000e+00 : f32
+// CHECK:             %[[SQUARE:.*]] = arith.mulf %[[OUT]], %[[OUT]] : f32
+// CHECK:             %[[DERIVATIVE:.*]] = arith.subf %[[ONE]], %[[SQUARE]] : f32
+// CHECK:             %[[RESULT:.*]] = arith.mulf %[[GRAD]], %[[DERIVATIVE]] : f32
+// CHECK:             linalg.yield %[[RESULT]] : f32
+func.func @elementwise$tanh_backward(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %0 = torch.aten.tanh_backward %arg0, %arg1 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32> -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
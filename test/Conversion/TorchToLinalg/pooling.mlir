@@ -27,3 +27,59 @@ func.func @forward(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> !torch.vtensor<[?,?,
   %4 = torch.aten.max_pool2d %arg0, %kernel_size, %stride, %padding, %dilation, %false : !torch.vtensor<[?,?,?,?],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool -> !torch.vtensor<[?,?,?,?],f32>
   return %4 : !torch.vtensor<[?,?,?,?],f32>
 }
+
+// -----
+
+// CHECK-LABEL: func @max_pool2d_with_indices
+func.func @max_pool2d_with_indices(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> (!torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?,?,?,?],si64>) {
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %false = torch.constant.bool false
+  // CHECK: %[[PADDED:.*]] = tensor.pad
+  // CHECK: %[[VALUES_INIT:.*]] = linalg.fill ins(%{{.*}} : f32) outs(%{{.*}} : tensor<?x?x?x?xf32>) -> tensor<?x?x?x?xf32>
+  // CHECK: %[[INDICES_INIT:.*]] = linalg.fill ins(%{{.*}} : i64) outs(%{{.*}} : tensor<?x?x?x?xi64>) -> tensor<?x?x?x?xi64>
+  // CHECK: %[[WINDOW:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}] : tensor<?x?xi64>
+  // CHECK: %[[POOL:.*]]:2 = linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction", "reduction"]} ins(%[[PADDED]], %[[WINDOW]] : tensor<?x?x?x?xf32>, tensor<?x?xi64>) outs(%[[VALUES_INIT]], %[[INDICES_INIT]] : tensor<?x?x?x?xf32>, tensor<?x?x?x?xi64>)
+  // CHECK: ^bb0(%[[IN:.*]]: f32, %{{.*}}: i64, %[[MAX:.*]]: f32, %[[MAX_INDEX:.*]]: i64):
+  // CHECK:   %[[GREATER:.*]] = arith.cmpf ogt, %[[IN]], %[[MAX]] : f32
+  // CHECK:   %[[NAN:.*]] = arith.cmpf uno, %[[IN]], %[[IN]] : f32
+  // CHECK:   %[[FIRST:.*]] = arith.cmpi eq, %[[MAX_INDEX]], %{{.*}} : i64
+  // CHECK:   %[[TAKE:.*]] = arith.ori
+  // CHECK:   %[[TAKE2:.*]] = arith.ori %[[TAKE]], %[[FIRST]] : i1
+  // CHECK:   %[[NEW_MAX:.*]] = arith.select %[[TAKE2]], %[[IN]], %[[MAX]] : f32
+  // CHECK:   %[[NEW_INDEX:.*]] = arith.select %[[TAKE2]], %{{.*}}, %[[MAX_INDEX]] : i64
+  // CHECK:   linalg.yield %[[NEW_MAX]], %[[NEW_INDEX]] : f32, i64
+  %kernel_size = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %stride = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %result:2 = torch.aten.max_pool2d_with_indices %arg0, %kernel_size, %stride, %padding, %dilation, %false : !torch.vtensor<[?,?,?,?],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool -> !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?,?,?,?],si64>
+  return %result#0, %result#1 : !torch.vtensor<[?,?,?,?],f32>, !torch.vtensor<[?,?,?,?],si64>
+}
+
+// -----
+
+// CHECK-LABEL: func @avg_pool2d
+func.func @avg_pool2d(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> !torch.vtensor<[?,?,?,?],f32> {
+  %int0 = torch.constant.int 0
+  %int2 = torch.constant.int 2
+  %false = torch.constant.bool false
+  %true = torch.constant.bool true
+  %none = torch.constant.none
+  // CHECK: %[[PADDED:.*]] = tensor.pad
+  // CHECK: %[[RECIPROCAL:.*]] = arith.divf
+  // CHECK: %[[OUT:.*]] = linalg.fill
+  // CHECK: %[[WINDOW:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}] : tensor<?x?xf32>
+  // CHECK: linalg.generic {{.*}} ins(%[[PADDED]], %[[WINDOW]] : tensor<?x?x?x?xf32>, tensor<?x?xf32>) outs(%[[OUT]] : tensor<?x?x?x?xf32>)
+  // CHECK: ^bb0(%[[IN:.*]]: f32, %{{.*}}: f32, %[[ACC:.*]]: f32):
+  // CHECK:   %[[SCALED:.*]] = arith.mulf %[[IN]], %[[RECIPROCAL]] : f32
+  // CHECK:   %[[SUM:.*]] = arith.addf %[[ACC]], %[[SCALED]] : f32
+  // CHECK:   linalg.yield %[[SUM]] : f32
+  // CHECK-NOT: linalg.generic
+  %kernel_size = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %stride = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.avg_pool2d %arg0, %kernel_size, %stride, %padding, %false, %true, %none : !torch.vtensor<[?,?,?,?],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[?,?,?,?],f32>
+  return %0 : !torch.vtensor<[?,?,?,?],f32>
+}
@@ -0,0 +1,50 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg="reduction-split-factor=4" -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   func.func @torch.aten.sum$split(
+// CHECK:           %[[FLAT:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0, 1]] : tensor<8x16xf32> into tensor<128xf32>
+// CHECK:           %[[SPLIT:.*]] = tensor.expand_shape %[[FLAT]] {{\[\[}}0, 1]] : tensor<128xf32> into tensor<4x32xf32>
+// CHECK:           %[[PARTIAL:.*]] = linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK-SAME:        ins(%[[SPLIT]] : tensor<4x32xf32>)
+// CHECK:             arith.addf
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["reduction"]
+// CHECK-SAME:        ins(%[[PARTIAL]] : tensor<4xf32>)
+// CHECK:             arith.addf
+func.func @torch.aten.sum$split(%arg0: !torch.vtensor<[8,16],f32>) -> !torch.vtensor<[],f32> {
+  %none = torch.constant.none
+  %0 = torch.aten.sum %arg0, %none : !torch.vtensor<[8,16],f32>, !torch.none -> !torch.vtensor<[],f32>
+  return %0 : !torch.vtensor<[],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.max$split(
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK:             arith.maxf
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["reduction"]
+// CHECK:             arith.maxf
+func.func @torch.aten.max$split(%arg0: !torch.vtensor<[64],f32>) -> !torch.vtensor<[],f32> {
+  %0 = torch.aten.max %arg0 : !torch.vtensor<[64],f32> -> !torch.vtensor<[],f32>
+  return %0 : !torch.vtensor<[],f32>
+}
+
+// -----
+
+// Partial reductions are not split.
+// CHECK-LABEL:   func.func @torch.aten.sum.dim_IntList$not_split(
+// CHECK-NOT:       tensor.expand_shape
+// CHECK:           linalg.generic
+// CHECK-SAME:        iterator_types = ["parallel", "reduction"]
+// CHECK-SAME:        ins(%{{.*}} : tensor<8x16xf32>)
+// CHECK-NOT:       linalg.generic
+func.func @torch.aten.sum.dim_IntList$not_split(%arg0: !torch.vtensor<[8,16],f32>) -> !torch.vtensor<[8],f32> {
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %int1 = torch.constant.int 1
+  %0 = torch.prim.ListConstruct %int1 : (!torch.int) -> !torch.list<int>
+  %1 = torch.aten.sum.dim_IntList %arg0, %0, %false, %none : !torch.vtensor<[8,16],f32>, !torch.list<int>, !torch.bool, !torch.none -> !torch.vtensor<[8],f32>
+  return %1 : !torch.vtensor<[8],f32>
+}
@@ -0,0 +1,35 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL: func @upsample_nearest2d
+// CHECK: %[[IH:.*]] = linalg.generic {{.*}} outs(%{{.*}} : tensor<?xi64>)
+// CHECK:   arith.mulf
+// CHECK:   arith.fptosi
+// CHECK:   arith.minsi
+// CHECK: %[[IW:.*]] = linalg.generic {{.*}} outs(%{{.*}} : tensor<?xi64>)
+// CHECK: linalg.generic {indexing_maps = [#{{.*}}, #{{.*}}, #{{.*}}], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%[[IH]], %[[IW]] : tensor<?xi64>, tensor<?xi64>) outs(%{{.*}} : tensor<?x?x?x?xf32>)
+// CHECK:   %[[ELEMENT:.*]] = tensor.extract
+// CHECK:   linalg.yield %[[ELEMENT]] : f32
+func.func @upsample_nearest2d(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> !torch.vtensor<[?,?,?,?],f32> {
+  %int6 = torch.constant.int 6
+  %int7 = torch.constant.int 7
+  %none = torch.constant.none
+  %size = torch.prim.ListConstruct %int6, %int7 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.upsample_nearest2d %arg0, %size, %none, %none : !torch.vtensor<[?,?,?,?],f32>, !torch.list<int>, !torch.none, !torch.none -> !torch.vtensor<[?,?,?,?],f32>
+  return %0 : !torch.vtensor<[?,?,?,?],f32>
+}
+
+// -----
+
+// CHECK-LABEL: func @upsample_bilinear2d_vec
+// CHECK: %[[H:.*]]:3 = linalg.generic {{.*}} outs(%{{.*}}, %{{.*}}, %{{.*}} : tensor<?xi64>, tensor<?xi64>, tensor<?xf32>)
+// CHECK: %[[W:.*]]:3 = linalg.generic {{.*}} outs(%{{.*}}, %{{.*}}, %{{.*}} : tensor<?xi64>, tensor<?xi64>, tensor<?xf32>)
+// CHECK: linalg.generic {{.*}} ins(%[[H]]#0, %[[H]]#1, %[[H]]#2, %[[W]]#0, %[[W]]#1, %[[W]]#2 : {{.*}}) outs(%{{.*}} : tensor<?x?x?x?xf32>)
+// CHECK-COUNT-4: tensor.extract
+func.func @upsample_bilinear2d_vec(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> !torch.vtensor<[?,?,?,?],f32> {
+  %float2 = torch.constant.float 2.000000e+00
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %scales = torch.prim.ListConstruct %float2, %float2 : (!torch.float, !torch.float) -> !torch.list<float>
+  %0 = torch.aten.upsample_bilinear2d.vec %arg0, %none, %false, %scales : !torch.vtensor<[?,?,?,?],f32>, !torch.none, !torch.bool, !torch.list<float> -> !torch.vtensor<[?,?,?,?],f32>
+  return %0 : !torch.vtensor<[?,?,?,?],f32>
+}
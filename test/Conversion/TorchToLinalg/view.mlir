@@ -0,0 +1,56 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.view$expand(
+// CHECK:           %[[EXPANDED:.*]] = tensor.expand_shape %{{.*}} {{\[\[}}0, 1]] : tensor<12xf32> into tensor<3x4xf32>
+// CHECK-NOT:       tensor.reshape
+func.func @torch.aten.view$expand(%arg0: !torch.vtensor<[12],f32>) -> !torch.vtensor<[3,4],f32> {
+  %int3 = torch.constant.int 3
+  %int4 = torch.constant.int 4
+  %0 = torch.prim.ListConstruct %int3, %int4 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.view %arg0, %0 : !torch.vtensor<[12],f32>, !torch.list<int> -> !torch.vtensor<[3,4],f32>
+  return %1 : !torch.vtensor<[3,4],f32>
+}
+
+// -----
+
+// Neither expanding nor collapsing.
+// CHECK-LABEL:   func.func @torch.aten.view$regroup(
+// CHECK:           %[[SHAPE:.*]] = tensor.from_elements %{{.*}}, %{{.*}} : tensor<2xindex>
+// CHECK:           %[[RESHAPED:.*]] = tensor.reshape %{{.*}}(%[[SHAPE]]) : (tensor<3x2xf32>, tensor<2xindex>) -> tensor<2x3xf32>
+func.func @torch.aten.view$regroup(%arg0: !torch.vtensor<[3,2],f32>) -> !torch.vtensor<[2,3],f32> {
+  %int2 = torch.constant.int 2
+  %int3 = torch.constant.int 3
+  %0 = torch.prim.ListConstruct %int2, %int3 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.view %arg0, %0 : !torch.vtensor<[3,2],f32>, !torch.list<int> -> !torch.vtensor<[2,3],f32>
+  return %1 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// The inferred dimension is computed at runtime from the number of elements.
+// CHECK-LABEL:   func.func @torch.aten.view$dynamic_inferred(
+// CHECK:           %[[NUMEL:.*]] = arith.index_cast %{{.*}} : index to i64
+// CHECK:           %[[INFERRED:.*]] = arith.divsi %[[NUMEL]], %{{.*}} : i64
+// CHECK:           cf.assert
+// CHECK:           %[[SHAPE:.*]] = tensor.from_elements %{{.*}}, %{{.*}}, %{{.*}} : tensor<3xindex>
+// CHECK:           tensor.reshape %{{.*}}(%[[SHAPE]]) : (tensor<?x?xf32>, tensor<3xindex>) -> tensor<?x4x?xf32>
+func.func @torch.aten.view$dynamic_inferred(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.int) -> !torch.vtensor<[?,4,?],f32> {
+  %int-1 = torch.constant.int -1
+  %int4 = torch.constant.int 4
+  %0 = torch.prim.ListConstruct %int-1, %int4, %arg1 : (!torch.int, !torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.view %arg0, %0 : !torch.vtensor<[?,?],f32>, !torch.list<int> -> !torch.vtensor<[?,4,?],f32>
+  return %1 : !torch.vtensor<[?,4,?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.view$rank0(
+// CHECK:           %[[EXPANDED:.*]] = tensor.expand_shape %{{.*}} [] : tensor<f32> into tensor<1x1xf32>
+func.func @torch.aten.view$rank0(%arg0: !torch.vtensor<[],f32>) -> !torch.vtensor<[1,1],f32> {
+  %int1 = torch.constant.int 1
+  %0 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.view %arg0, %0 : !torch.vtensor<[],f32>, !torch.list<int> -> !torch.vtensor<[1,1],f32>
+  return %1 : !torch.vtensor<[1,1],f32>
+}
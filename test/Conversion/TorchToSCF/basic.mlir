@@ -214,3 +214,58 @@ func.func @torch.prim.Loop$for_with_multiple_results(%arg0: !torch.int) -> (!tor
   } : (!torch.int, !torch.bool, !torch.float, !torch.float) -> (!torch.float, !torch.float)
   return %0#0, %0#1 : !torch.float, !torch.float
 }
+
+// CHECK-LABEL: func.func @torch.prim.Loop$for_with_independent_iterations
+// CHECK-SAME:  (%[[TORCH_ARG0:.*]]: !torch.int) -> !torch.int {
+// CHECK:         %[[ARG0:.*]] = torch_c.to_i64 %[[TORCH_ARG0]]
+// CHECK:         %[[TORCH_INIT:.*]] = torch.constant.int 0
+// CHECK:         %[[INIT:.*]] = torch_c.to_i64 %[[TORCH_INIT]]
+// CHECK:         %[[LOWER_BOUND:.*]] = arith.constant 0 : index
+// CHECK:         %[[STEP:.*]] = arith.constant 1 : index
+// CHECK:         %[[UPPER_BOUND:.*]] = arith.index_cast %[[ARG0]] : i64 to index
+// CHECK:         %[[LOOP:.*]] = scf.parallel (%[[IV:.*]]) = (%[[LOWER_BOUND]]) to (%[[UPPER_BOUND]]) step (%[[STEP]]) init (%[[INIT]]) -> i64 {
+// CHECK-NEXT:      %[[IV_I64:.*]] = arith.index_cast %[[IV]] : index to i64
+// CHECK-NEXT:      %[[TORCH_IV:.*]] = torch_c.from_i64 %[[IV_I64]]
+// CHECK-NEXT:      %[[TORCH_SQUARE:.*]] = torch.aten.mul.int %[[TORCH_IV]], %[[TORCH_IV]]
+// CHECK-NEXT:      %[[SQUARE:.*]] = torch_c.to_i64 %[[TORCH_SQUARE]]
+// CHECK-NEXT:      scf.reduce(%[[SQUARE]])  : i64 {
+// CHECK-NEXT:      ^bb0(%[[LHS:.*]]: i64, %[[RHS:.*]]: i64):
+// CHECK-NEXT:        %[[TORCH_LHS:.*]] = torch_c.from_i64 %[[LHS]]
+// CHECK-NEXT:        %[[TORCH_RHS:.*]] = torch_c.from_i64 %[[RHS]]
+// CHECK-NEXT:        %[[TORCH_SUM:.*]] = torch.aten.add.int %[[TORCH_LHS]], %[[TORCH_RHS]]
+// CHECK-NEXT:        %[[SUM:.*]] = torch_c.to_i64 %[[TORCH_SUM]]
+// CHECK-NEXT:        scf.reduce.return %[[SUM]] : i64
+// CHECK-NEXT:      }
+// CHECK-NEXT:      scf.yield
+// CHECK-NEXT:    }
+// CHECK-NEXT:    %[[RETURN:.*]] = torch_c.from_i64 %[[LOOP]]
+// CHECK-NEXT:    return %[[RETURN]] : !torch.int
+// CHECK-NEXT:  }
+func.func @torch.prim.Loop$for_with_independent_iterations(%arg0: !torch.int) -> !torch.int {
+  %true = torch.constant.bool true
+  %int0 = torch.constant.int 0
+  %0 = torch.prim.Loop %arg0, %true, init(%int0) {
+  ^bb0(%arg1: !torch.int, %arg2: !torch.int):
+    %1 = torch.aten.mul.int %arg1, %arg1 : !torch.int, !torch.int -> !torch.int
+    %2 = torch.aten.add.int %arg2, %1 : !torch.int, !torch.int -> !torch.int
+    torch.prim.Loop.condition %true, iter(%2 : !torch.int)
+  } : (!torch.int, !torch.bool, !torch.int) -> !torch.int
+  return %0 : !torch.int
+}
+
+// The accumulator is used by another op than its reduction, so the iterations
+// depend on each other.
+// CHECK-LABEL: func.func @torch.prim.Loop$for_with_dependent_iterations
+// CHECK:         scf.for
+// CHECK-NOT:     scf.parallel
+func.func @torch.prim.Loop$for_with_dependent_iterations(%arg0: !torch.int) -> !torch.int {
+  %true = torch.constant.bool true
+  %int1 = torch.constant.int 1
+  %0 = torch.prim.Loop %arg0, %true, init(%int1) {
+  ^bb0(%arg1: !torch.int, %arg2: !torch.int):
+    %1 = torch.aten.mul.int %arg2, %arg2 : !torch.int, !torch.int -> !torch.int
+    %2 = torch.aten.add.int %1, %arg1 : !torch.int, !torch.int -> !torch.int
+    torch.prim.Loop.condition %true, iter(%2 : !torch.int)
+  } : (!torch.int, !torch.bool, !torch.int) -> !torch.int
+  return %0 : !torch.int
+}
@@ -75,6 +75,16 @@ func.func @torch.vtensor.literal() -> !torch.vtensor<[],f32> {
   return %0 : !torch.vtensor<[],f32>
 }
 
+// CHECK-LABEL:   func.func @torch.vtensor.literal$sparse(
+// CHECK:           %[[CST:.*]] = arith.constant sparse<{{\[}}[0, 1], [2, 3]], [1, 2]> : tensor<4x8xi64>
+// CHECK:           %[[SPARSE:.*]] = sparse_tensor.convert %[[CST]] : tensor<4x8xi64> to tensor<4x8xi64, #sparse_tensor.encoding<{{.*}}>>
+// CHECK:           %[[VTENSOR:.*]] = torch_c.from_builtin_tensor %[[SPARSE]] : tensor<4x8xi64, #sparse_tensor.encoding<{{.*}}>> -> !torch.vtensor<[4,8],si64,#sparse_tensor.encoding<{{.*}}>>
+// CHECK:           return %[[VTENSOR]]
+func.func @torch.vtensor.literal$sparse() -> !torch.vtensor<[4,8],si64,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>> {
+  %0 = torch.vtensor.literal(sparse<[[0, 1], [2, 3]], [1, 2]> : tensor<4x8xsi64, #sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>) : !torch.vtensor<[4,8],si64,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>
+  return %0 : !torch.vtensor<[4,8],si64,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>
+}
+
 // CHECK-LABEL:   func.func @torch.constant.bool() -> !torch.bool {
 // CHECK:           %[[CST:.*]] = arith.constant true
 // CHECK:           %[[BOOL:.*]] = torch_c.from_i1 %[[CST]]
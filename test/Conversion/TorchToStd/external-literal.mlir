@@ -0,0 +1,11 @@
+// RUN: torch-mlir-opt -convert-torch-to-std %s | FileCheck %s
+
+// The data isn't read from the file, which the backend loads instead.
+// CHECK-LABEL:   func.func @torch.vtensor.external_literal() -> (!torch.vtensor<[2],f32>, !torch.vtensor<[2],si64>) {
+// CHECK:           %[[F32:.*]] = torch_c.external_literal "weights.bin", 8 : tensor<2xf32>
+// CHECK:           %[[I64:.*]] = torch_c.external_literal "weights.bin", 16 : tensor<2xi64>
+func.func @torch.vtensor.external_literal() -> (!torch.vtensor<[2],f32>, !torch.vtensor<[2],si64>) {
+  %0 = torch.vtensor.external_literal "weights.bin", 8 : !torch.vtensor<[2],f32>
+  %1 = torch.vtensor.external_literal "weights.bin", 16 : !torch.vtensor<[2],si64>
+  return %0, %1 : !torch.vtensor<[2],f32>, !torch.vtensor<[2],si64>
+}
@@ -0,0 +1,69 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-tmtensor -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   func.func @attention(
+// CHECK-SAME:                    %[[Q:.*]]: !torch.vtensor<[?,?,64],f32>, %[[K:.*]]: !torch.vtensor<[?,?,64],f32>, %[[V:.*]]: !torch.vtensor<[?,?,64],f32>, %[[MASK:.*]]: !torch.vtensor<[16,16],f32>) -> !torch.vtensor<[?,?,64],f32> {
+// CHECK-DAG:       %[[BUILTIN_Q:.*]] = torch_c.to_builtin_tensor %[[Q]]
+// CHECK-DAG:       %[[BUILTIN_K:.*]] = torch_c.to_builtin_tensor %[[K]]
+// CHECK-DAG:       %[[BUILTIN_V:.*]] = torch_c.to_builtin_tensor %[[V]]
+// CHECK-DAG:       %[[BUILTIN_MASK:.*]] = torch_c.to_builtin_tensor %[[MASK]]
+// CHECK:           %[[EXPANDED_MASK:.*]] = tensor.expand_shape %[[BUILTIN_MASK]] {{\[\[}}0, 1], [2]] : tensor<16x16xf32> into tensor<1x16x16xf32>
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor [%{{.*}}, %{{.*}}, %{{.*}}] : tensor<?x?x?xf32>
+// CHECK:           %[[ATTENTION:.*]] = tm_tensor.attention scale(1.250000e-01)
+// CHECK-SAME:        ins(%[[BUILTIN_Q]], %[[BUILTIN_K]], %[[BUILTIN_V]], %[[EXPANDED_MASK]] : tensor<?x?x64xf32>, tensor<?x?x64xf32>, tensor<?x?x64xf32>, tensor<1x16x16xf32>)
+// CHECK-SAME:        outs(%[[INIT]] : tensor<?x?x?xf32>) -> tensor<?x?x?xf32>
+// CHECK:           %[[CAST:.*]] = tensor.cast %[[ATTENTION]] : tensor<?x?x?xf32> to tensor<?x?x64xf32>
+// CHECK-NOT:       torch.aten.matmul
+// CHECK-NOT:       torch.aten._softmax
+func.func @attention(%q: !torch.vtensor<[?,?,64],f32>, %k: !torch.vtensor<[?,?,64],f32>, %v: !torch.vtensor<[?,?,64],f32>, %mask: !torch.vtensor<[16,16],f32>) -> !torch.vtensor<[?,?,64],f32> {
+  %int1 = torch.constant.int 1
+  %int-1 = torch.constant.int -1
+  %int-2 = torch.constant.int -2
+  %float8 = torch.constant.float 8.000000e+00
+  %false = torch.constant.bool false
+  %0 = torch.aten.transpose.int %k, %int-2, %int-1 : !torch.vtensor<[?,?,64],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,64,?],f32>
+  %1 = torch.aten.matmul %q, %0 : !torch.vtensor<[?,?,64],f32>, !torch.vtensor<[?,64,?],f32> -> !torch.vtensor<[?,?,?],f32>
+  %2 = torch.aten.div.Scalar %1, %float8 : !torch.vtensor<[?,?,?],f32>, !torch.float -> !torch.vtensor<[?,?,?],f32>
+  %3 = torch.aten.add.Tensor %2, %mask, %int1 : !torch.vtensor<[?,?,?],f32>, !torch.vtensor<[16,16],f32>, !torch.int -> !torch.vtensor<[?,?,?],f32>
+  %4 = torch.aten._softmax %3, %int-1, %false : !torch.vtensor<[?,?,?],f32>, !torch.int, !torch.bool -> !torch.vtensor<[?,?,?],f32>
+  %5 = torch.aten.matmul %4, %v : !torch.vtensor<[?,?,?],f32>, !torch.vtensor<[?,?,64],f32> -> !torch.vtensor<[?,?,64],f32>
+  return %5 : !torch.vtensor<[?,?,64],f32>
+}
+
+// -----
+
+// The scores are used elsewhere, so they have to be materialized anyway.
+// CHECK-LABEL:   func.func @attention$scores_used(
+// CHECK-NOT:       tm_tensor.attention
+// CHECK:           torch.aten.matmul
+// CHECK:           torch.aten.softmax.int
+// CHECK:           torch.aten.matmul
+func.func @attention$scores_used(%q: !torch.vtensor<[2,4,8],f32>, %k: !torch.vtensor<[2,6,8],f32>, %v: !torch.vtensor<[2,6,8],f32>) -> (!torch.vtensor<[2,4,8],f32>, !torch.vtensor<[2,4,6],f32>) {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %none = torch.constant.none
+  %0 = torch.aten.transpose.int %k, %int1, %int2 : !torch.vtensor<[2,6,8],f32>, !torch.int, !torch.int -> !torch.vtensor<[2,8,6],f32>
+  %1 = torch.aten.matmul %q, %0 : !torch.vtensor<[2,4,8],f32>, !torch.vtensor<[2,8,6],f32> -> !torch.vtensor<[2,4,6],f32>
+  %2 = torch.aten.softmax.int %1, %int2, %none : !torch.vtensor<[2,4,6],f32>, !torch.int, !torch.none -> !torch.vtensor<[2,4,6],f32>
+  %3 = torch.aten.matmul %2, %v : !torch.vtensor<[2,4,6],f32>, !torch.vtensor<[2,6,8],f32> -> !torch.vtensor<[2,4,8],f32>
+  return %3, %1 : !torch.vtensor<[2,4,8],f32>, !torch.vtensor<[2,4,6],f32>
+}
+
+// -----
+
+// A dynamic dimension of the mask may be broadcast at runtime.
+// CHECK-LABEL:   func.func @attention$dynamic_mask(
+// CHECK-NOT:       tm_tensor.attention
+// CHECK:           torch.aten.matmul
+// CHECK:           torch.aten.add.Tensor
+// CHECK:           torch.aten.matmul
+func.func @attention$dynamic_mask(%q: !torch.vtensor<[2,4,8],f32>, %k: !torch.vtensor<[2,6,8],f32>, %v: !torch.vtensor<[2,6,8],f32>, %mask: !torch.vtensor<[?,6],f32>) -> !torch.vtensor<[2,4,8],f32> {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %none = torch.constant.none
+  %0 = torch.aten.transpose.int %k, %int1, %int2 : !torch.vtensor<[2,6,8],f32>, !torch.int, !torch.int -> !torch.vtensor<[2,8,6],f32>
+  %1 = torch.aten.matmul %q, %0 : !torch.vtensor<[2,4,8],f32>, !torch.vtensor<[2,8,6],f32> -> !torch.vtensor<[2,4,6],f32>
+  %2 = torch.aten.add.Tensor %1, %mask, %int1 : !torch.vtensor<[2,4,6],f32>, !torch.vtensor<[?,6],f32>, !torch.int -> !torch.vtensor<[2,4,6],f32>
+  %3 = torch.aten.softmax.int %2, %int2, %none : !torch.vtensor<[2,4,6],f32>, !torch.int, !torch.none -> !torch.vtensor<[2,4,6],f32>
+  %4 = torch.aten.matmul %3, %v : !torch.vtensor<[2,4,6],f32>, !torch.vtensor<[2,6,8],f32> -> !torch.vtensor<[2,4,8],f32>
+  return %4 : !torch.vtensor<[2,4,8],f32>
+}
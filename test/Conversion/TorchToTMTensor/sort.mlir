@@ -0,0 +1,52 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-tmtensor -split-input-file -verify-diagnostics | FileCheck %s
+
+// NaNs are sorted last in ascending order.
+// CHECK-LABEL:   func.func @torch.aten.sort$float(
+// CHECK:           tm_tensor.sort dimension(1) outs(%{{.*}}, %{{.*}} : tensor<?x?xf32>, tensor<?x?xi64>) {
+// CHECK:           ^bb0(%[[LHS:.*]]: f32, %[[RHS:.*]]: f32, %{{.*}}: i64, %{{.*}}: i64):
+// CHECK:             %[[LOWER:.*]] = arith.cmpf ult, %[[LHS]], %[[RHS]] : f32
+// CHECK:             %[[LHS_NOT_NAN:.*]] = arith.cmpf ord, %[[LHS]], %[[LHS]] : f32
+// CHECK:             %[[BEFORE:.*]] = arith.andi %[[LOWER]], %[[LHS_NOT_NAN]] : i1
+// CHECK:             tm_tensor.yield %[[BEFORE]] : i1
+func.func @torch.aten.sort$float(%arg0: !torch.vtensor<[?,?],f32>) -> (!torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],si64>) {
+  %int-1 = torch.constant.int -1
+  %false = torch.constant.bool false
+  %values, %indices = torch.aten.sort %arg0, %int-1, %false : !torch.vtensor<[?,?],f32>, !torch.int, !torch.bool -> !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],si64>
+  return %values, %indices : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],si64>
+}
+
+// -----
+
+// NaNs are the largest elements. `k` is checked against the size of `dim`
+// at runtime when the size isn't static.
+// CHECK-LABEL:   func.func @torch.aten.topk$float(
+// CHECK:           %[[K:.*]] = arith.index_cast %{{.*}} : i64 to index
+// CHECK:           %[[K_NON_NEGATIVE:.*]] = arith.cmpi sge, %[[K]], %{{.*}} : index
+// CHECK:           cf.assert %[[K_NON_NEGATIVE]], "k must be non-negative"
+// CHECK:           %[[K_IN_RANGE:.*]] = arith.cmpi sle, %[[K]], %{{.*}} : index
+// CHECK:           cf.assert %[[K_IN_RANGE]], "k must not be larger than the size of dim"
+// CHECK:           tm_tensor.topk dimension(1) ins(%{{.*}} : tensor<?x?xf32>) outs(%{{.*}}, %{{.*}} : tensor<?x?xf32>, tensor<?x?xi64>) {
+// CHECK:           ^bb0(%[[LHS:.*]]: f32, %[[RHS:.*]]: f32):
+// CHECK:             %[[GREATER:.*]] = arith.cmpf ugt, %[[LHS]], %[[RHS]] : f32
+// CHECK:             %[[RHS_NOT_NAN:.*]] = arith.cmpf ord, %[[RHS]], %[[RHS]] : f32
+// CHECK:             %[[BEFORE:.*]] = arith.andi %[[GREATER]], %[[RHS_NOT_NAN]] : i1
+// CHECK:             tm_tensor.yield %[[BEFORE]] : i1
+func.func @torch.aten.topk$float(%arg0: !torch.vtensor<[?,?],f32>) -> (!torch.vtensor<[?,4],f32>, !torch.vtensor<[?,4],si64>) {
+  %int1 = torch.constant.int 1
+  %int4 = torch.constant.int 4
+  %true = torch.constant.bool true
+  %values, %indices = torch.aten.topk %arg0, %int4, %int1, %true, %true : !torch.vtensor<[?,?],f32>, !torch.int, !torch.int, !torch.bool, !torch.bool -> !torch.vtensor<[?,4],f32>, !torch.vtensor<[?,4],si64>
+  return %values, %indices : !torch.vtensor<[?,4],f32>, !torch.vtensor<[?,4],si64>
+}
+
+// -----
+
+// A `k` larger than the static size of `dim` is rejected.
+func.func @torch.aten.topk$k_too_large(%arg0: !torch.vtensor<[?,3],f32>) -> (!torch.vtensor<[?,4],f32>, !torch.vtensor<[?,4],si64>) {
+  %int1 = torch.constant.int 1
+  %int4 = torch.constant.int 4
+  %true = torch.constant.bool true
+  // expected-error @+1 {{failed to legalize operation 'torch.aten.topk' that was explicitly marked illegal}}
+  %values, %indices = torch.aten.topk %arg0, %int4, %int1, %true, %true : !torch.vtensor<[?,3],f32>, !torch.int, !torch.int, !torch.bool, !torch.bool -> !torch.vtensor<[?,4],f32>, !torch.vtensor<[?,4],si64>
+  return %values, %indices : !torch.vtensor<[?,4],f32>, !torch.vtensor<[?,4],si64>
+}
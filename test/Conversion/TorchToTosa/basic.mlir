@@ -794,3 +794,291 @@ func.func @torch.aten.avg_pool2d$basic(%arg0: !torch.vtensor<[1,512,7,7],f32> )
   %0 = torch.aten.avg_pool2d %arg0, %kernel, %stride, %padding, %false, %true, %none : !torch.vtensor<[1,512,7,7],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[1,512,1,1],f32>
   return %0 : !torch.vtensor<[1,512,1,1],f32>
 }
+
+// -----
+
+// The padding counts in the averages, so the input is padded with zeros.
+// CHECK-LABEL:   func.func @torch.aten.avg_pool2d$count_include_pad(
+// CHECK:           %[[NHWC:.*]] = "tosa.transpose"(%{{.*}}, %{{.*}}) : (tensor<1x3x8x8xf32>, tensor<4xi32>) -> tensor<1x8x8x3xf32>
+// CHECK:           %[[PADDINGS:.*]] = "tosa.const"() {value = dense<{{\[\[}}0, 0], [1, 1], [1, 1], [0, 0]]> : tensor<4x2xi32>} : () -> tensor<4x2xi32>
+// CHECK:           %[[PADDED:.*]] = "tosa.pad"(%[[NHWC]], %[[PADDINGS]]) : (tensor<1x8x8x3xf32>, tensor<4x2xi32>) -> tensor<1x10x10x3xf32>
+// CHECK:           %[[POOL:.*]] = "tosa.avg_pool2d"(%[[PADDED]]) {kernel = [3, 3], pad = [0, 0, 0, 0], stride = [2, 2]} : (tensor<1x10x10x3xf32>) -> tensor<1x4x4x3xf32>
+// CHECK:           "tosa.transpose"(%[[POOL]], %{{.*}}) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+func.func @torch.aten.avg_pool2d$count_include_pad(%arg0: !torch.vtensor<[1,3,8,8],f32> ) -> !torch.vtensor<[1,3,4,4],f32> {
+  %int3 = torch.constant.int 3
+  %int2 = torch.constant.int 2
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %true = torch.constant.bool true
+  %none = torch.constant.none
+  %kernel = torch.prim.ListConstruct %int3, %int3 : (!torch.int, !torch.int) -> !torch.list<int>
+  %stride = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.avg_pool2d %arg0, %kernel, %stride, %padding, %false, %true, %none : !torch.vtensor<[1,3,8,8],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[1,3,4,4],f32>
+  return %0 : !torch.vtensor<[1,3,4,4],f32>
+}
+
+// -----
+
+// The last window, which starts in the input, is padded at the bottom and
+// right.
+// CHECK-LABEL:   func.func @torch.aten.max_pool2d$ceil_mode(
+// CHECK:           %[[NHWC:.*]] = "tosa.transpose"(%{{.*}}, %{{.*}}) : (tensor<1x3x7x7xf32>, tensor<4xi32>) -> tensor<1x7x7x3xf32>
+// CHECK:           %[[POOL:.*]] = "tosa.max_pool2d"(%[[NHWC]]) {kernel = [2, 2], pad = [0, 1, 0, 1], stride = [2, 2]} : (tensor<1x7x7x3xf32>) -> tensor<1x4x4x3xf32>
+// CHECK:           "tosa.transpose"(%[[POOL]], %{{.*}}) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+func.func @torch.aten.max_pool2d$ceil_mode(%arg0: !torch.vtensor<[1,3,7,7],f32> ) -> !torch.vtensor<[1,3,4,4],f32> {
+  %int2 = torch.constant.int 2
+  %int1 = torch.constant.int 1
+  %int0 = torch.constant.int 0
+  %true = torch.constant.bool true
+  %kernel = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %stride = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.max_pool2d %arg0, %kernel, %stride, %padding, %dilation, %true : !torch.vtensor<[1,3,7,7],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool -> !torch.vtensor<[1,3,4,4],f32>
+  return %0 : !torch.vtensor<[1,3,4,4],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.convolution$constant_weight(
+// CHECK:           %[[WEIGHT:.*]] = "tosa.const"() {value = dense<{{\[\[\[\[}}1.000000e+00, 2.000000e+00]]], {{\[\[\[}}3.000000e+00, 4.000000e+00]]]]> : tensor<2x1x1x2xf32>} : () -> tensor<2x1x1x2xf32>
+// CHECK-NOT:       "tosa.transpose"({{.*}}) : (tensor<2x2x1x1xf32>
+// CHECK:           "tosa.conv2d"(%{{.*}}, %[[WEIGHT]], %{{.*}})
+func.func @torch.aten.convolution$constant_weight(%arg0: !torch.vtensor<[1,2,4,4],f32>) -> !torch.vtensor<[1,2,4,4],f32> {
+  %0 = torch.vtensor.literal(dense<[[[[1.000000e+00]], [[2.000000e+00]]], [[[3.000000e+00]], [[4.000000e+00]]]]> : tensor<2x2x1x1xf32>) : !torch.vtensor<[2,2,1,1],f32>
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.convolution %arg0, %0, %none, %stride, %padding, %dilation, %false, %output_padding, %int1 : !torch.vtensor<[1,2,4,4],f32>, !torch.vtensor<[2,2,1,1],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,2,4,4],f32>
+  return %1 : !torch.vtensor<[1,2,4,4],f32>
+}
+
+// -----
+
+// The [4, 1, 3, 3] weights are transposed to [3, 3, 1, 4] and reshaped to the
+// [KH, KW, C, M] layout of tosa.depthwise_conv2d.
+// CHECK-LABEL:   func.func @torch.aten.convolution$depthwise(
+// CHECK:           %[[WEIGHT:.*]] = "tosa.const"() {value = dense<{{.*}}> : tensor<3x3x2x2xf32>} : () -> tensor<3x3x2x2xf32>
+// CHECK:           %[[CONV:.*]] = "tosa.depthwise_conv2d"(%{{.*}}, %[[WEIGHT]], %{{.*}}) {dilation = [1, 1], pad = [1, 1, 1, 1], stride = [1, 1]} : (tensor<1x4x4x2xf32>, tensor<3x3x2x2xf32>, tensor<4xf32>) -> tensor<1x4x4x4xf32>
+// CHECK-NOT:       "tosa.conv2d"
+func.func @torch.aten.convolution$depthwise(%arg0: !torch.vtensor<[1,2,4,4],f32>) -> !torch.vtensor<[1,4,4,4],f32> {
+  %0 = torch.vtensor.literal(dense<1.000000e+00> : tensor<4x1x3x3xf32>) : !torch.vtensor<[4,1,3,3],f32>
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.convolution %arg0, %0, %none, %stride, %padding, %dilation, %false, %output_padding, %int2 : !torch.vtensor<[1,2,4,4],f32>, !torch.vtensor<[4,1,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,4,4,4],f32>
+  return %1 : !torch.vtensor<[1,4,4,4],f32>
+}
+
+// -----
+
+// Each group is a tosa.conv2d of a slice of the input channels and of the
+// filters, whose results are concatenated along the channels.
+// CHECK-LABEL:   func.func @torch.aten.convolution$groups(
+// CHECK:           %[[INPUT0:.*]] = "tosa.slice"(%[[INPUT:.*]]) {size = [1, 4, 4, 2], start = [0, 0, 0, 0]} : (tensor<1x4x4x4xf32>) -> tensor<1x4x4x2xf32>
+// CHECK:           %[[WEIGHT0:.*]] = "tosa.slice"(%[[WEIGHT:.*]]) {size = [3, 1, 1, 2], start = [0, 0, 0, 0]} : (tensor<6x1x1x2xf32>) -> tensor<3x1x1x2xf32>
+// CHECK:           %[[BIAS0:.*]] = "tosa.slice"(%[[BIAS:.*]]) {size = [3], start = [0]} : (tensor<6xf32>) -> tensor<3xf32>
+// CHECK:           %[[CONV0:.*]] = "tosa.conv2d"(%[[INPUT0]], %[[WEIGHT0]], %[[BIAS0]]) {{.*}} -> tensor<1x4x4x3xf32>
+// CHECK:           %[[INPUT1:.*]] = "tosa.slice"(%[[INPUT]]) {size = [1, 4, 4, 2], start = [0, 0, 0, 2]}
+// CHECK:           %[[WEIGHT1:.*]] = "tosa.slice"(%[[WEIGHT]]) {size = [3, 1, 1, 2], start = [3, 0, 0, 0]}
+// CHECK:           %[[BIAS1:.*]] = "tosa.slice"(%[[BIAS]]) {size = [3], start = [3]}
+// CHECK:           %[[CONV1:.*]] = "tosa.conv2d"(%[[INPUT1]], %[[WEIGHT1]], %[[BIAS1]]) {{.*}} -> tensor<1x4x4x3xf32>
+// CHECK:           "tosa.concat"(%[[CONV0]], %[[CONV1]]) {axis = 3 : i64} : (tensor<1x4x4x3xf32>, tensor<1x4x4x3xf32>) -> tensor<1x4x4x6xf32>
+func.func @torch.aten.convolution$groups(%arg0: !torch.vtensor<[1,4,4,4],f32>) -> !torch.vtensor<[1,6,4,4],f32> {
+  %0 = torch.vtensor.literal(dense<1.000000e+00> : tensor<6x2x1x1xf32>) : !torch.vtensor<[6,2,1,1],f32>
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.convolution %arg0, %0, %none, %stride, %padding, %dilation, %false, %output_padding, %int2 : !torch.vtensor<[1,4,4,4],f32>, !torch.vtensor<[6,2,1,1],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,6,4,4],f32>
+  return %1 : !torch.vtensor<[1,6,4,4],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.matmul$broadcast_rhs(
+// CHECK-NOT:       tosa.transpose
+// CHECK:           %[[LHS:.*]] = "tosa.reshape"(%{{.*}}) {new_shape = [1, 6, 4]} : (tensor<2x3x4xf32>) -> tensor<1x6x4xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           %[[RHS:.*]] = "tosa.reshape"(%{{.*}}) {new_shape = [1, 4, 5]} : (tensor<1x4x5xf32>) -> tensor<1x4x5xf32>
+// CHECK:           %[[MM:.*]] = "tosa.matmul"(%[[LHS]], %[[RHS]]) : (tensor<1x6x4xf32>, tensor<1x4x5xf32>) -> tensor<1x6x5xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           "tosa.reshape"(%[[MM]]) {new_shape = [2, 3, 5]} : (tensor<1x6x5xf32>) -> tensor<2x3x5xf32>
+// CHECK-NOT:       tosa.transpose
+func.func @torch.aten.matmul$broadcast_rhs(%arg0: !torch.vtensor<[2,3,4],f32>, %arg1: !torch.vtensor<[4,5],f32>) -> !torch.vtensor<[2,3,5],f32> {
+  %0 = torch.aten.matmul %arg0, %arg1 : !torch.vtensor<[2,3,4],f32>, !torch.vtensor<[4,5],f32> -> !torch.vtensor<[2,3,5],f32>
+  return %0 : !torch.vtensor<[2,3,5],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.mm$2d(
+// CHECK:           %[[MM:.*]] = "tosa.matmul"(%{{.*}}, %{{.*}}) : (tensor<1x3x4xf32>, tensor<1x4x5xf32>) -> tensor<1x3x5xf32>
+// CHECK:           "tosa.reshape"(%[[MM]]) {new_shape = [3, 5]} : (tensor<1x3x5xf32>) -> tensor<3x5xf32>
+func.func @torch.aten.mm$2d(%arg0: !torch.vtensor<[3,4],f32>, %arg1: !torch.vtensor<[4,5],f32>) -> !torch.vtensor<[3,5],f32> {
+  %0 = torch.aten.mm %arg0, %arg1 : !torch.vtensor<[3,4],f32>, !torch.vtensor<[4,5],f32> -> !torch.vtensor<[3,5],f32>
+  return %0 : !torch.vtensor<[3,5],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.linear$2d(
+// CHECK:           %[[MM:.*]] = "tosa.matmul"(%{{.*}}, %{{.*}}) : (tensor<1x3x4xf32>, tensor<1x4x5xf32>) -> tensor<1x3x5xf32>
+// CHECK:           %[[RESHAPE:.*]] = "tosa.reshape"(%[[MM]]) {new_shape = [3, 5]} : (tensor<1x3x5xf32>) -> tensor<3x5xf32>
+// CHECK:           "tosa.add"(%[[RESHAPE]], %{{.*}}) : (tensor<3x5xf32>, {{.*}}) -> tensor<3x5xf32>
+func.func @torch.aten.linear$2d(%arg0: !torch.vtensor<[3,4],f32>, %arg1: !torch.vtensor<[5,4],f32>, %arg2: !torch.vtensor<[5],f32>) -> !torch.vtensor<[3,5],f32> {
+  %0 = torch.aten.linear %arg0, %arg1, %arg2 : !torch.vtensor<[3,4],f32>, !torch.vtensor<[5,4],f32>, !torch.vtensor<[5],f32> -> !torch.vtensor<[3,5],f32>
+  return %0 : !torch.vtensor<[3,5],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.quantized.linear(
+// CHECK-NOT:       torch.linear_params.create
+// CHECK-DAG:       %[[WEIGHT:.*]] = "tosa.const"() {value = dense<{{\[\[}}1, -2, 3, -4, 5], [6, 7, 8, 9, 10]]> : tensor<2x5xi8>} : () -> tensor<2x5xi8>
+// CHECK-DAG:       %[[BIAS:.*]] = "tosa.const"() {value = dense<[41, -145]> : tensor<2xi32>} : () -> tensor<2xi32>
+// CHECK:           %[[ACC:.*]] = "tosa.fully_connected"(%{{.*}}, %[[WEIGHT]], %[[BIAS]]) : (tensor<4x5xi8>, tensor<2x5xi8>, tensor<2xi32>) -> tensor<4x2xi32>
+// CHECK:           %[[RESCALED:.*]] = "tosa.rescale"(%[[ACC]]) {double_round = true, input_zp = 0 : i32, multiplier = [{{.*}}], output_zp = 0 : i32, per_channel = false, scale32 = true, shift = [{{.*}}]} : (tensor<4x2xi32>) -> tensor<4x2xi8>
+// CHECK:           "tosa.clamp"(%[[RESCALED]]) {max_fp = 0.000000e+00 : f32, max_int = 127 : i64, min_fp = 0.000000e+00 : f32, min_int = 0 : i64} : (tensor<4x2xi8>) -> tensor<4x2xi8>
+// CHECK-NOT:       torch.quantized.linear
+func.func @torch.quantized.linear(%arg0: !torch.vtensor<[4,5],si8>) -> !torch.vtensor<[4,2],!torch.qint8> {
+  %float1 = torch.constant.float 1.000000e-01
+  %float2 = torch.constant.float 2.000000e-01
+  %float3 = torch.constant.float 5.000000e-01
+  %int0 = torch.constant.int 0
+  %int3 = torch.constant.int 3
+  %weight = torch.vtensor.literal(dense<[[1, -2, 3, -4, 5], [6, 7, 8, 9, 10]]> : tensor<2x5xsi8>) : !torch.vtensor<[2,5],si8>
+  %bias = torch.vtensor.literal(dense<[1.0, -0.5]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %0 = torch.per_tensor_affine.create %arg0, %float1, %int3 : !torch.vtensor<[4,5],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,5],!torch.qint8>
+  %1 = torch.per_tensor_affine.create %weight, %float2, %int0 : !torch.vtensor<[2,5],si8>, !torch.float, !torch.int -> !torch.vtensor<[2,5],!torch.qint8>
+  %2 = torch.linear_params.create %1, %bias : !torch.vtensor<[2,5],!torch.qint8>, !torch.vtensor<[2],f32>
+  %3 = torch.quantized.linear %0, %2, %float3, %int0 : !torch.vtensor<[4,5],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,2],!torch.qint8>
+  %4 = torch.aten.relu %3 : !torch.vtensor<[4,2],!torch.qint8> -> !torch.vtensor<[4,2],!torch.qint8>
+  return %4 : !torch.vtensor<[4,2],!torch.qint8>
+}
+
+// -----
+
+// The params shared by two linears are erased with the last one.
+// CHECK-LABEL:   func.func @torch.quantized.linear$shared_params(
+// CHECK-NOT:       torch.linear_params.create
+// CHECK:           "tosa.fully_connected"
+// CHECK:           "tosa.fully_connected"
+// CHECK-NOT:       torch.linear_params.create
+func.func @torch.quantized.linear$shared_params(%arg0: !torch.vtensor<[4,5],si8>) -> (!torch.vtensor<[4,2],!torch.qint8>, !torch.vtensor<[4,2],!torch.qint8>) {
+  %float1 = torch.constant.float 1.000000e-01
+  %float2 = torch.constant.float 2.000000e-01
+  %float3 = torch.constant.float 5.000000e-01
+  %int0 = torch.constant.int 0
+  %int3 = torch.constant.int 3
+  %weight = torch.vtensor.literal(dense<[[1, -2, 3, -4, 5], [6, 7, 8, 9, 10]]> : tensor<2x5xsi8>) : !torch.vtensor<[2,5],si8>
+  %bias = torch.vtensor.literal(dense<[1.0, -0.5]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %0 = torch.per_tensor_affine.create %arg0, %float1, %int3 : !torch.vtensor<[4,5],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,5],!torch.qint8>
+  %1 = torch.per_tensor_affine.create %weight, %float2, %int0 : !torch.vtensor<[2,5],si8>, !torch.float, !torch.int -> !torch.vtensor<[2,5],!torch.qint8>
+  %2 = torch.linear_params.create %1, %bias : !torch.vtensor<[2,5],!torch.qint8>, !torch.vtensor<[2],f32>
+  %3 = torch.quantized.linear %0, %2, %float3, %int0 : !torch.vtensor<[4,5],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,2],!torch.qint8>
+  %4 = torch.quantized.linear %0, %2, %float1, %int0 : !torch.vtensor<[4,5],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,2],!torch.qint8>
+  return %3, %4 : !torch.vtensor<[4,2],!torch.qint8>, !torch.vtensor<[4,2],!torch.qint8>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.linear$constant_weight(
+// CHECK-NOT:       tosa.transpose
+// CHECK:           "tosa.const"() {value = dense<{{\[\[}}1.000000e+00, 4.000000e+00], [2.000000e+00, 5.000000e+00], [3.000000e+00, 6.000000e+00]]> : tensor<3x2xf32>} : () -> tensor<3x2xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           "tosa.matmul"
+// CHECK-NOT:       tosa.transpose
+func.func @torch.aten.linear$constant_weight(%arg0: !torch.vtensor<[4,3],f32>) -> !torch.vtensor<[4,2],f32> {
+  %none = torch.constant.none
+  %0 = torch.vtensor.literal(dense<[[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]]> : tensor<2x3xf32>) : !torch.vtensor<[2,3],f32>
+  %1 = torch.aten.linear %arg0, %0, %none : !torch.vtensor<[4,3],f32>, !torch.vtensor<[2,3],f32>, !torch.none -> !torch.vtensor<[4,2],f32>
+  return %1 : !torch.vtensor<[4,2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.softmax.int$basic(
+// CHECK-SAME:                                            %[[ARG:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[IN:.*]] = torch_c.to_builtin_tensor %[[ARG]] : !torch.vtensor<[2,3],f32> -> tensor<2x3xf32>
+// CHECK:           %[[MAX:.*]] = "tosa.reduce_max"(%[[IN]]) {axis = 1 : i64} : (tensor<2x3xf32>) -> tensor<2x1xf32>
+// CHECK:           %[[SHIFTED:.*]] = "tosa.sub"(%[[IN]], %[[MAX]]) : (tensor<2x3xf32>, tensor<2x1xf32>) -> tensor<2x3xf32>
+// CHECK:           %[[EXP:.*]] = "tosa.exp"(%[[SHIFTED]]) : (tensor<2x3xf32>) -> tensor<2x3xf32>
+// CHECK:           %[[SUM:.*]] = "tosa.reduce_sum"(%[[EXP]]) {axis = 1 : i64} : (tensor<2x3xf32>) -> tensor<2x1xf32>
+// CHECK:           %[[RECIP:.*]] = "tosa.reciprocal"(%[[SUM]]) : (tensor<2x1xf32>) -> tensor<2x1xf32>
+// CHECK:           %[[MUL:.*]] = "tosa.mul"(%[[EXP]], %[[RECIP]]) {shift = 0 : i32} : (tensor<2x3xf32>, tensor<2x1xf32>) -> tensor<2x3xf32>
+// CHECK:           %[[RESULT:.*]] = torch_c.from_builtin_tensor %[[MUL]] : tensor<2x3xf32> -> !torch.vtensor<[2,3],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[2,3],f32>
+func.func @torch.aten.softmax.int$basic(%arg0: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+  %int-1 = torch.constant.int -1
+  %none = torch.constant.none
+  %0 = torch.aten.softmax.int %arg0, %int-1, %none : !torch.vtensor<[2,3],f32>, !torch.int, !torch.none -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten._log_softmax$basic(
+// CHECK-SAME:                                             %[[ARG:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[IN:.*]] = torch_c.to_builtin_tensor %[[ARG]] : !torch.vtensor<[2,3],f32> -> tensor<2x3xf32>
+// CHECK:           %[[MAX:.*]] = "tosa.reduce_max"(%[[IN]]) {axis = 0 : i64} : (tensor<2x3xf32>) -> tensor<1x3xf32>
+// CHECK:           %[[SHIFTED:.*]] = "tosa.sub"(%[[IN]], %[[MAX]]) : (tensor<2x3xf32>, tensor<1x3xf32>) -> tensor<2x3xf32>
+// CHECK:           %[[EXP:.*]] = "tosa.exp"(%[[SHIFTED]]) : (tensor<2x3xf32>) -> tensor<2x3xf32>
+// CHECK:           %[[SUM:.*]] = "tosa.reduce_sum"(%[[EXP]]) {axis = 0 : i64} : (tensor<2x3xf32>) -> tensor<1x3xf32>
+// CHECK:           %[[LOG:.*]] = "tosa.log"(%[[SUM]]) : (tensor<1x3xf32>) -> tensor<1x3xf32>
+// CHECK:           %[[SUB:.*]] = "tosa.sub"(%[[SHIFTED]], %[[LOG]]) : (tensor<2x3xf32>, tensor<1x3xf32>) -> tensor<2x3xf32>
+// CHECK:           %[[RESULT:.*]] = torch_c.from_builtin_tensor %[[SUB]] : tensor<2x3xf32> -> !torch.vtensor<[2,3],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[2,3],f32>
+func.func @torch.aten._log_softmax$basic(%arg0: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+  %int0 = torch.constant.int 0
+  %false = torch.constant.bool false
+  %0 = torch.aten._log_softmax %arg0, %int0, %false : !torch.vtensor<[2,3],f32>, !torch.int, !torch.bool -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+func.func @torch.aten._softmax$half_to_float(%arg0: !torch.vtensor<[2,3],f16>) -> !torch.vtensor<[2,3],f32> {
+  %int0 = torch.constant.int 0
+  %true = torch.constant.bool true
+  // expected-error @+2 {{Unimplemented: softmax with a different result dtype}}
+  // expected-error @+1 {{failed to legalize operation 'torch.aten._softmax' that was explicitly marked illegal}}
+  %0 = torch.aten._softmax %arg0, %int0, %true : !torch.vtensor<[2,3],f16>, !torch.int, !torch.bool -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.gelu$tanh(
+// CHECK:           "tosa.mul"
+// CHECK:           "tosa.mul"
+// CHECK:           "tosa.mul"
+// CHECK:           "tosa.add"
+// CHECK:           "tosa.mul"
+// CHECK:           "tosa.tanh"
+// CHECK:           "tosa.add"
+// CHECK:           "tosa.mul"
+// CHECK:           "tosa.mul"
+// CHECK-NOT:       torch.aten.gelu
+func.func @torch.aten.gelu$tanh(%arg0: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+  %str = torch.constant.str "tanh"
+  %0 = torch.aten.gelu %arg0, %str : !torch.vtensor<[2,3],f32>, !torch.str -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
@@ -32,22 +32,21 @@ torch.class_type @parent {
 // -----
 
 torch.class_type @c {
-  torch.attr "t1" : !torch.tensor
-  torch.attr "t2" : !torch.tensor
+  torch.attr "t" : !torch.tensor
+  torch.attr "l" : !torch.list<tensor>
 }
 
 // expected-error @+1 {{potentially-aliased value used to initialize multiple slots}}
 %t = torch.tensor.literal(dense<1.000000e+00> : tensor<1xf32>) : !torch.tensor
+%l = torch.prim.ListConstruct %t : (!torch.tensor) -> !torch.list<tensor>
 torch.nn_module {
-  torch.slot "t1", %t : !torch.tensor
-  torch.slot "t2", %t : !torch.tensor
+  torch.slot "t", %t : !torch.tensor
+  torch.slot "l", %l : !torch.list<tensor>
 } : !torch.nn.Module<"c">
 func.func private @use_slot(%arg0 : !torch.nn.Module<"c">) -> !torch.tensor {
-  %t1 = torch.prim.GetAttr %arg0["t1"] : !torch.nn.Module<"c"> -> !torch.tensor
-  %t2 = torch.prim.GetAttr %arg0["t2"] : !torch.nn.Module<"c"> -> !torch.tensor
-  %cst = torch.constant.int 1
-  %ret = torch.aten.add.Tensor %t1, %t2, %cst : !torch.tensor, !torch.tensor, !torch.int -> !torch.tensor
-  return %ret : !torch.tensor
+  %t = torch.prim.GetAttr %arg0["t"] : !torch.nn.Module<"c"> -> !torch.tensor
+  %l = torch.prim.GetAttr %arg0["l"] : !torch.nn.Module<"c"> -> !torch.list<tensor>
+  return %t : !torch.tensor
 }
 
 // -----
@@ -0,0 +1,69 @@
+// RUN: torch-mlir-opt -torch-globalize-object-graph -split-input-file %s | FileCheck %s
+
+// Check that slots initialized with the same object (such as tied parameters)
+// share a single global slot.
+
+// CHECK-LABEL:   torch.global_slot @t1 : !torch.tensor  {
+// CHECK:           %[[T:.*]] = torch.tensor.literal(dense<1.000000e+00> : tensor<1xf32>) : !torch.tensor
+// CHECK:           torch.global_slot.init %[[T]] : !torch.tensor
+// CHECK:         }
+// CHECK-NOT:     torch.global_slot
+
+// CHECK-LABEL:   func.func @forward() -> !torch.tensor {
+// CHECK:           %[[T1:.*]] = torch.global_slot.get @t1 : !torch.tensor
+// CHECK:           %[[T2:.*]] = torch.global_slot.get @t1 : !torch.tensor
+// CHECK:           %[[T3:.*]] = torch.global_slot.get @t1 : !torch.tensor
+torch.class_type @child {
+  torch.attr private "t" : !torch.tensor
+}
+torch.class_type @parent {
+  torch.attr "t1" : !torch.tensor
+  torch.attr "t2" : !torch.tensor
+  torch.attr "m" : !torch.nn.Module<"child">
+  torch.method "forward", @forward
+}
+
+%t = torch.tensor.literal(dense<1.000000e+00> : tensor<1xf32>) : !torch.tensor
+%child = torch.nn_module {
+  torch.slot "t", %t : !torch.tensor
+} : !torch.nn.Module<"child">
+torch.nn_module {
+  torch.slot "t1", %t : !torch.tensor
+  torch.slot "t2", %t : !torch.tensor
+  torch.slot "m", %child : !torch.nn.Module<"child">
+} : !torch.nn.Module<"parent">
+
+func.func private @forward(%arg0 : !torch.nn.Module<"parent">) -> !torch.tensor {
+  %t1 = torch.prim.GetAttr %arg0["t1"] : !torch.nn.Module<"parent"> -> !torch.tensor
+  %t2 = torch.prim.GetAttr %arg0["t2"] : !torch.nn.Module<"parent"> -> !torch.tensor
+  %m = torch.prim.GetAttr %arg0["m"] : !torch.nn.Module<"parent"> -> !torch.nn.Module<"child">
+  %t3 = torch.prim.GetAttr %m["t"] : !torch.nn.Module<"child"> -> !torch.tensor
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.add.Tensor %t1, %t2, %int1 : !torch.tensor, !torch.tensor, !torch.int -> !torch.tensor
+  %1 = torch.aten.add.Tensor %0, %t3, %int1 : !torch.tensor, !torch.tensor, !torch.int -> !torch.tensor
+  return %1 : !torch.tensor
+}
+
+// -----
+
+// Slots that are reassigned cannot share a global slot.
+
+// CHECK-LABEL:   torch.global_slot @t1 : !torch.tensor  {
+// CHECK-LABEL:   torch.global_slot @t2 : !torch.tensor  {
+// CHECK-LABEL:   func.func @set_slot(
+// CHECK:           torch.global_slot.set @t1 = %{{.*}} : !torch.tensor
+torch.class_type @c {
+  torch.attr "t1" : !torch.tensor
+  torch.attr "t2" : !torch.tensor
+  torch.method "set_slot", @set_slot
+}
+
+%t = torch.tensor.literal(dense<1.000000e+00> : tensor<1xf32>) : !torch.tensor
+torch.nn_module {
+  torch.slot "t1", %t : !torch.tensor
+  torch.slot "t2", %t : !torch.tensor
+} : !torch.nn.Module<"c">
+func.func private @set_slot(%arg0 : !torch.nn.Module<"c">, %arg1 : !torch.tensor) {
+  torch.prim.SetAttr %arg0["t1"] = %arg1: !torch.nn.Module<"c">, !torch.tensor
+  return
+}
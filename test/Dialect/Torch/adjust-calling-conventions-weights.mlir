@@ -0,0 +1,85 @@
+// RUN: torch-mlir-opt -torch-adjust-calling-conventions="weights-as-arguments=true" -split-input-file -verify-diagnostics %s | FileCheck %s
+
+// CHECK-NOT:     torch.global_slot
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:                   %[[ARG:.*]]: !torch.vtensor<[3],f32>,
+// CHECK-SAME:                   %[[WEIGHT:.*]]: !torch.vtensor<[3],f32> {torch.weight_name = "fc.weight"},
+// CHECK-SAME:                   %[[BIAS:.*]]: !torch.vtensor<[1],f32> {torch.weight_name = "fc.bias"}) -> !torch.tensor {
+// CHECK:           %[[BIAS_TENSOR:.*]] = torch.copy.to_tensor %[[BIAS]] : !torch.tensor<[1],f32>
+// CHECK:           %[[WEIGHT_TENSOR:.*]] = torch.copy.to_tensor %[[WEIGHT]] : !torch.tensor<[3],f32>
+// CHECK:           %[[WEIGHT_ERASED:.*]] = torch.tensor_static_info_cast %[[WEIGHT_TENSOR]] : !torch.tensor<[3],f32> to !torch.tensor
+// CHECK:           %[[BIAS_ERASED:.*]] = torch.tensor_static_info_cast %[[BIAS_TENSOR]] : !torch.tensor<[1],f32> to !torch.tensor
+// CHECK:           %[[RESULT:.*]] = torch.aten.add.Tensor %[[WEIGHT_ERASED]], %[[BIAS_ERASED]]
+// CHECK:           return %[[RESULT]] : !torch.tensor
+torch.global_slot "private" @fc.weight : !torch.tensor {
+  %0 = torch.tensor.literal(dense<1.0> : tensor<3xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+torch.global_slot "private" @fc.bias : !torch.tensor {
+  %0 = torch.tensor.literal(dense<2.0> : tensor<1xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+func.func @forward(%arg0: !torch.tensor {torch.type_bound = !torch.vtensor<[3],f32>}) -> !torch.tensor {
+  %int1 = torch.constant.int 1
+  %0 = torch.global_slot.get @fc.weight : !torch.tensor
+  %1 = torch.global_slot.get @fc.bias : !torch.tensor
+  %2 = torch.aten.add.Tensor %0, %1, %int1 : !torch.tensor, !torch.tensor, !torch.int -> !torch.tensor
+  return %2 : !torch.tensor
+}
+
+// -----
+
+// Buffers that the program updates stay in their slots.
+
+// CHECK:         torch.global_slot "private" @running_mean
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:                   %[[ARG:.*]]: !torch.vtensor<[3],f32>) -> !torch.tensor {
+// CHECK:           torch.global_slot.get @running_mean
+torch.global_slot "private" @running_mean : !torch.tensor {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<3xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+func.func @forward(%arg0: !torch.tensor {torch.type_bound = !torch.vtensor<[3],f32>}) -> !torch.tensor {
+  %0 = torch.global_slot.get @running_mean : !torch.tensor
+  %1 = torch.copy.to_vtensor %arg0 : !torch.vtensor<[3],f32>
+  %2 = torch.tensor_static_info_cast %1 : !torch.vtensor<[3],f32> to !torch.vtensor
+  torch.overwrite.tensor.contents %2 overwrites %0 : !torch.vtensor, !torch.tensor
+  return %0 : !torch.tensor
+}
+
+// -----
+
+// So do the running stats of a batch norm in training mode, which reach it
+// through a derefine.
+
+// CHECK:         torch.global_slot "private" @running_mean
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:                   %[[ARG:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.tensor {
+// CHECK:           torch.global_slot.get @running_mean
+torch.global_slot "private" @running_mean : !torch.tensor {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<3xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+func.func @forward(%arg0: !torch.tensor {torch.type_bound = !torch.vtensor<[2,3],f32>}) -> !torch.tensor {
+  %true = torch.constant.bool true
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %momentum = torch.constant.float 1.000000e-01
+  %eps = torch.constant.float 1.000000e-05
+  %0 = torch.global_slot.get @running_mean : !torch.tensor
+  %1 = torch.derefine %0 : !torch.tensor to !torch.optional<tensor>
+  %2 = torch.aten.batch_norm %arg0, %none, %none, %1, %none, %true, %momentum, %eps, %false : !torch.tensor, !torch.none, !torch.none, !torch.optional<tensor>, !torch.none, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.tensor
+  return %2 : !torch.tensor
+}
+
+// -----
+
+torch.global_slot "private" @weight : !torch.tensor {
+  %0 = torch.tensor.literal(dense<1.0> : tensor<3xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+// expected-error @+1 {{unimplemented: weights read in a private function}}
+func.func private @helper() -> !torch.tensor {
+  %0 = torch.global_slot.get @weight : !torch.tensor
+  return %0 : !torch.tensor
+}
@@ -0,0 +1,50 @@
+// RUN: torch-mlir-opt -torch-auto-cast -split-input-file %s | FileCheck %s
+// RUN: torch-mlir-opt -torch-auto-cast=dtype=f16 -split-input-file %s | FileCheck %s --check-prefix=F16
+
+// CHECK-LABEL:   func.func @auto_cast$mm(
+// CHECK-SAME:                            %[[LHS:.*]]: !torch.vtensor<[2,3],f32>, %[[RHS:.*]]: !torch.vtensor<[3,4],f32>) -> !torch.vtensor<[2,4],f32> {
+// CHECK-DAG:       %[[BF16:.*]] = torch.constant.int 15
+// CHECK-DAG:       %[[F32:.*]] = torch.constant.int 6
+// CHECK:           %[[LHS_BF16:.*]] = torch.aten.to.dtype %[[LHS]], %[[BF16]], {{.*}} -> !torch.vtensor<[2,3],bf16>
+// CHECK:           %[[RHS_BF16:.*]] = torch.aten.to.dtype %[[RHS]], %[[BF16]], {{.*}} -> !torch.vtensor<[3,4],bf16>
+// CHECK:           %[[MM:.*]] = torch.aten.mm %[[LHS_BF16]], %[[RHS_BF16]] : !torch.vtensor<[2,3],bf16>, !torch.vtensor<[3,4],bf16> -> !torch.vtensor<[2,4],bf16>
+// CHECK:           %[[RESULT:.*]] = torch.aten.to.dtype %[[MM]], %[[F32]], {{.*}} -> !torch.vtensor<[2,4],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[2,4],f32>
+// F16-LABEL:     func.func @auto_cast$mm(
+// F16:             torch.aten.mm {{.*}} -> !torch.vtensor<[2,4],f16>
+func.func @auto_cast$mm(%arg0: !torch.vtensor<[2,3],f32>, %arg1: !torch.vtensor<[3,4],f32>) -> !torch.vtensor<[2,4],f32> {
+  %0 = torch.aten.mm %arg0, %arg1 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[3,4],f32> -> !torch.vtensor<[2,4],f32>
+  return %0 : !torch.vtensor<[2,4],f32>
+}
+
+// -----
+
+// The result of the first linear feeds the second one without going through
+// f32, while the softmax in between two matmuls stays in f32.
+// CHECK-LABEL:   func.func @auto_cast$chain(
+// CHECK:           %[[LINEAR0:.*]] = torch.aten.linear {{.*}} -> !torch.vtensor<[2,4],bf16>
+// CHECK:           %[[LINEAR1:.*]] = torch.aten.linear %[[LINEAR0]], {{.*}} -> !torch.vtensor<[2,4],bf16>
+// CHECK:           %[[LINEAR1_F32:.*]] = torch.aten.to.dtype %[[LINEAR1]], {{.*}} -> !torch.vtensor<[2,4],f32>
+// CHECK:           %[[SOFTMAX:.*]] = torch.aten._softmax %[[LINEAR1_F32]], {{.*}} -> !torch.vtensor<[2,4],f32>
+// CHECK:           %[[SOFTMAX_BF16:.*]] = torch.aten.to.dtype %[[SOFTMAX]], {{.*}} -> !torch.vtensor<[2,4],bf16>
+// CHECK:           torch.aten.mm %[[SOFTMAX_BF16]], {{.*}} -> !torch.vtensor<[2,4],bf16>
+func.func @auto_cast$chain(%arg0: !torch.vtensor<[2,4],f32>, %arg1: !torch.vtensor<[4,4],f32>, %arg2: !torch.vtensor<[4],f32>) -> !torch.vtensor<[2,4],f32> {
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %0 = torch.aten.linear %arg0, %arg1, %arg2 : !torch.vtensor<[2,4],f32>, !torch.vtensor<[4,4],f32>, !torch.vtensor<[4],f32> -> !torch.vtensor<[2,4],f32>
+  %1 = torch.aten.linear %0, %arg1, %arg2 : !torch.vtensor<[2,4],f32>, !torch.vtensor<[4,4],f32>, !torch.vtensor<[4],f32> -> !torch.vtensor<[2,4],f32>
+  %2 = torch.aten._softmax %1, %int1, %false : !torch.vtensor<[2,4],f32>, !torch.int, !torch.bool -> !torch.vtensor<[2,4],f32>
+  %3 = torch.aten.mm %2, %arg1 : !torch.vtensor<[2,4],f32>, !torch.vtensor<[4,4],f32> -> !torch.vtensor<[2,4],f32>
+  return %3 : !torch.vtensor<[2,4],f32>
+}
+
+// -----
+
+// Matmuls of other dtypes are left alone.
+// CHECK-LABEL:   func.func @auto_cast$f64(
+// CHECK-NOT:       torch.aten.to.dtype
+// CHECK:           torch.aten.mm {{.*}} -> !torch.vtensor<[2,4],f64>
+func.func @auto_cast$f64(%arg0: !torch.vtensor<[2,3],f64>, %arg1: !torch.vtensor<[3,4],f64>) -> !torch.vtensor<[2,4],f64> {
+  %0 = torch.aten.mm %arg0, %arg1 : !torch.vtensor<[2,3],f64>, !torch.vtensor<[3,4],f64> -> !torch.vtensor<[2,4],f64>
+  return %0 : !torch.vtensor<[2,4],f64>
+}
@@ -902,6 +902,112 @@ func.func @torch.aten.remainder.int() -> !torch.int {
     return %ret : !torch.int
 }
 
+// CHECK-LABEL:   func.func @torch.aten.floordiv.int$negative() -> !torch.int {
+// CHECK:           %[[CST_4:.*]] = torch.constant.int -4
+// CHECK:           return %[[CST_4]] : !torch.int
+func.func @torch.aten.floordiv.int$negative() -> !torch.int {
+    %cst-18 = torch.constant.int -18
+    %cst5 = torch.constant.int 5
+    %ret = torch.aten.floordiv.int %cst-18, %cst5: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.floordiv.int$by_zero() -> !torch.int {
+// CHECK:           %[[RET:.*]] = torch.aten.floordiv.int
+// CHECK:           return %[[RET]] : !torch.int
+func.func @torch.aten.floordiv.int$by_zero() -> !torch.int {
+    %cst18 = torch.constant.int 18
+    %cst0 = torch.constant.int 0
+    %ret = torch.aten.floordiv.int %cst18, %cst0: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.floordiv.int$of_mul(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK:           %[[CST4:.*]] = torch.constant.int 4
+// CHECK:           %[[RET:.*]] = torch.aten.mul.int %[[ARG]], %[[CST4]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           return %[[RET]] : !torch.int
+func.func @torch.aten.floordiv.int$of_mul(%arg0: !torch.int) -> !torch.int {
+    %cst3 = torch.constant.int 3
+    %cst12 = torch.constant.int 12
+    %0 = torch.aten.mul.int %cst12, %arg0: !torch.int, !torch.int -> !torch.int
+    %ret = torch.aten.floordiv.int %0, %cst3: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.floordiv.int$of_mul_same_factor(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK-NEXT:      return %[[ARG]] : !torch.int
+func.func @torch.aten.floordiv.int$of_mul_same_factor(%arg0: !torch.int) -> !torch.int {
+    %cst3 = torch.constant.int 3
+    %0 = torch.aten.mul.int %arg0, %cst3: !torch.int, !torch.int -> !torch.int
+    %ret = torch.aten.floordiv.int %0, %cst3: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.remainder.int$negative() -> !torch.int {
+// CHECK:           %[[CST2:.*]] = torch.constant.int 2
+// CHECK:           return %[[CST2]] : !torch.int
+func.func @torch.aten.remainder.int$negative() -> !torch.int {
+    %cst-18 = torch.constant.int -18
+    %cst5 = torch.constant.int 5
+    %ret = torch.aten.remainder.int %cst-18, %cst5: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.add.int$zero(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK-NEXT:      return %[[ARG]] : !torch.int
+func.func @torch.aten.add.int$zero(%arg0: !torch.int) -> !torch.int {
+    %cst0 = torch.constant.int 0
+    %ret = torch.aten.add.int %cst0, %arg0: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.add.int$reassociate(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK:           %[[CST5:.*]] = torch.constant.int 5
+// CHECK:           %[[RET:.*]] = torch.aten.add.int %[[ARG]], %[[CST5]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           return %[[RET]] : !torch.int
+func.func @torch.aten.add.int$reassociate(%arg0: !torch.int) -> !torch.int {
+    %cst2 = torch.constant.int 2
+    %cst3 = torch.constant.int 3
+    %0 = torch.aten.add.int %cst2, %arg0: !torch.int, !torch.int -> !torch.int
+    %ret = torch.aten.add.int %0, %cst3: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.sub.int$same_operands(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK:           %[[CST0:.*]] = torch.constant.int 0
+// CHECK:           return %[[CST0]] : !torch.int
+func.func @torch.aten.sub.int$same_operands(%arg0: !torch.int) -> !torch.int {
+    %ret = torch.aten.sub.int %arg0, %arg0: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.mul.int$one(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK-NEXT:      return %[[ARG]] : !torch.int
+func.func @torch.aten.mul.int$one(%arg0: !torch.int) -> !torch.int {
+    %cst1 = torch.constant.int 1
+    %ret = torch.aten.mul.int %arg0, %cst1: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.mul.int$reassociate(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.int) -> !torch.int {
+// CHECK:           %[[CST6:.*]] = torch.constant.int 6
+// CHECK:           %[[RET:.*]] = torch.aten.mul.int %[[ARG]], %[[CST6]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           return %[[RET]] : !torch.int
+func.func @torch.aten.mul.int$reassociate(%arg0: !torch.int) -> !torch.int {
+    %cst2 = torch.constant.int 2
+    %cst3 = torch.constant.int 3
+    %0 = torch.aten.mul.int %arg0, %cst2: !torch.int, !torch.int -> !torch.int
+    %ret = torch.aten.mul.int %cst3, %0: !torch.int, !torch.int -> !torch.int
+    return %ret : !torch.int
+}
+
 // CHECK-LABEL:   func.func @torch.prim.dtype$bfloat16(
 // CHECK-SAME:             %[[T:.*]]: !torch.tensor<*,bf16>) -> !torch.int {
 // CHECK:           %[[CST:.*]] = torch.constant.int 15
@@ -1138,6 +1244,42 @@ func.func @torch.aten.squeeze.dim$zero_rank(%arg0: !torch.tensor<[],f32>) -> !to
   return %0 : !torch.tensor<[],f32>
 }
 
+// CHECK-LABEL:   func.func @torch.aten.contiguous$value_tensor(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.vtensor<[?,3],f32>) -> !torch.vtensor<[?,3],f32> {
+// CHECK-NEXT:      return %[[ARG]] : !torch.vtensor<[?,3],f32>
+func.func @torch.aten.contiguous$value_tensor(%arg0: !torch.vtensor<[?,3],f32>) -> !torch.vtensor<[?,3],f32> {
+  %int0 = torch.constant.int 0
+  %0 = torch.aten.contiguous %arg0, %int0 : !torch.vtensor<[?,3],f32>, !torch.int -> !torch.vtensor<[?,3],f32>
+  return %0 : !torch.vtensor<[?,3],f32>
+}
+
+// CHECK-LABEL:   func.func @torch.aten.contiguous$non_value_tensor(
+// CHECK:           torch.aten.contiguous
+func.func @torch.aten.contiguous$non_value_tensor(%arg0: !torch.tensor<[?,3],f32>) -> !torch.tensor<[?,3],f32> {
+  %int0 = torch.constant.int 0
+  %0 = torch.aten.contiguous %arg0, %int0 : !torch.tensor<[?,3],f32>, !torch.int -> !torch.tensor<[?,3],f32>
+  return %0 : !torch.tensor<[?,3],f32>
+}
+
+// CHECK-LABEL:   func.func @torch.valsem.aten.copy$same_type(
+// CHECK-SAME:            %[[SELF:.*]]: !torch.vtensor<[2,3],f32>,
+// CHECK-SAME:            %[[SRC:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+// CHECK-NEXT:      return %[[SRC]] : !torch.vtensor<[2,3],f32>
+func.func @torch.valsem.aten.copy$same_type(%arg0: !torch.vtensor<[2,3],f32>, %arg1: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+  %false = torch.constant.bool false
+  %0 = torch.valsem.aten.copy %arg0, %arg1, %false : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.bool -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// The copy broadcasts `src` if it has size 1 along the dynamic dimension.
+// CHECK-LABEL:   func.func @torch.valsem.aten.copy$dynamic(
+// CHECK:           torch.valsem.aten.copy
+func.func @torch.valsem.aten.copy$dynamic(%arg0: !torch.vtensor<[?],f32>, %arg1: !torch.vtensor<[?],f32>) -> !torch.vtensor<[?],f32> {
+  %false = torch.constant.bool false
+  %0 = torch.valsem.aten.copy %arg0, %arg1, %false : !torch.vtensor<[?],f32>, !torch.vtensor<[?],f32>, !torch.bool -> !torch.vtensor<[?],f32>
+  return %0 : !torch.vtensor<[?],f32>
+}
+
 // CHECK-LABEL:   func.func @torch.aten.to.dtype$same_dtype(
 // CHECK-SAME:            %[[ARG:.*]]: !torch.tensor<*,f32>) -> !torch.tensor<*,f32> {
 // CHECK-NEXT:      return %[[ARG]] : !torch.tensor<*,f32>
@@ -1328,3 +1470,35 @@ func.func @torch.aten.add.Tensor$canonicalize_literal_0d() -> !torch.vtensor<[],
     %2 = torch.aten.add.Tensor %0, %1, %int3 : !torch.vtensor<[],si64>, !torch.vtensor<[],si64>, !torch.int -> !torch.vtensor<[],si64>
     return %2 : !torch.vtensor<[],si64>
 }
+
+// CHECK-LABEL:   func.func @torch.aten.sub.Tensor$canonicalize_numtotensor_0d(
+// CHECK-SAME:            %[[ARG0:.*]]: !torch.int, %[[ARG1:.*]]: !torch.int) -> !torch.vtensor<[],si64> {
+// CHECK:           %[[INT2:.*]] = torch.constant.int 2
+// CHECK:           %[[MUL:.*]] = torch.aten.mul.int %[[ARG1]], %[[INT2]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           %[[SUB:.*]] = torch.aten.sub.int %[[ARG0]], %[[MUL]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           %[[RET:.*]] = torch.prim.NumToTensor.Scalar %[[SUB]] : !torch.int -> !torch.vtensor<[],si64>
+// CHECK:           return %[[RET]] : !torch.vtensor<[],si64>
+func.func @torch.aten.sub.Tensor$canonicalize_numtotensor_0d(%arg0: !torch.int, %arg1: !torch.int) -> !torch.vtensor<[],si64> {
+    %int2 = torch.constant.int 2
+    %0 = torch.prim.NumToTensor.Scalar %arg0 : !torch.int -> !torch.vtensor<[],si64>
+    %1 = torch.prim.NumToTensor.Scalar %arg1 : !torch.int -> !torch.vtensor<[],si64>
+    %2 = torch.aten.sub.Tensor %0, %1, %int2 : !torch.vtensor<[],si64>, !torch.vtensor<[],si64>, !torch.int -> !torch.vtensor<[],si64>
+    return %2 : !torch.vtensor<[],si64>
+}
+
+// CHECK-LABEL:   func.func @torch.aten.mul.Tensor$canonicalize_numtotensor_0d() -> !torch.vtensor<[],si64> {
+// CHECK:      %[[INT6:.*]] = torch.constant.int 6
+// CHECK:      %[[INT2:.*]] = torch.constant.int 2
+// CHECK:      %[[INT3:.*]] = torch.constant.int 3
+// CHECK:      %[[PR1:.*]] = torch.prim.NumToTensor.Scalar %[[INT2]] : !torch.int -> !torch.vtensor<[],si64>
+// CHECK:      %[[PR2:.*]] = torch.prim.NumToTensor.Scalar %[[INT3]] : !torch.int -> !torch.vtensor<[],si64>
+// CHECK:      %[[PR3:.*]] = torch.prim.NumToTensor.Scalar %[[INT6]] : !torch.int -> !torch.vtensor<[],si64>
+// CHECK:      return %[[PR3]] : !torch.vtensor<[],si64>
+func.func @torch.aten.mul.Tensor$canonicalize_numtotensor_0d() -> !torch.vtensor<[],si64> {
+    %int2 = torch.constant.int 2
+    %int3 = torch.constant.int 3
+    %0 = torch.prim.NumToTensor.Scalar %int2 : !torch.int -> !torch.vtensor<[],si64>
+    %1 = torch.prim.NumToTensor.Scalar %int3 : !torch.int -> !torch.vtensor<[],si64>
+    %2 = torch.aten.mul.Tensor %0, %1 : !torch.vtensor<[],si64>, !torch.vtensor<[],si64> -> !torch.vtensor<[],si64>
+    return %2 : !torch.vtensor<[],si64>
+}
@@ -0,0 +1,8 @@
+// RUN: torch-mlir-opt -torch-decompose-complex-ops="legal-ops=torch.aten.softmax" -verify-diagnostics %s
+
+// expected-error @+1 {{unknown op 'torch.aten.softmax' in legal-ops}}
+func.func @torch.aten.softmax.int(%t: !torch.vtensor<[2,3],f32>, %dim: !torch.int) -> !torch.vtensor<[2,3],f32> {
+  %none = torch.constant.none
+  %ret = torch.aten.softmax.int %t, %dim, %none : !torch.vtensor<[2,3],f32>, !torch.int, !torch.none -> !torch.vtensor<[2,3],f32>
+  return %ret : !torch.vtensor<[2,3],f32>
+}
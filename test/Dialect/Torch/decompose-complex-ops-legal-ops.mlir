@@ -0,0 +1,97 @@
+// RUN: torch-mlir-opt -torch-decompose-complex-ops="legal-ops=torch.aten.softmax.int,torch.aten.addmm,torch.aten.adaptive_avg_pool2d,torch.aten._log_softmax_backward_data" -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @torch.aten.softmax.int$legal(
+// CHECK:           torch.aten.softmax.int
+// CHECK-NOT:       torch.aten.exp
+func.func @torch.aten.softmax.int$legal(%t: !torch.vtensor<[2,3],f32>, %dim: !torch.int) -> !torch.vtensor<[2,3],f32> {
+  %none = torch.constant.none
+  %ret = torch.aten.softmax.int %t, %dim, %none : !torch.vtensor<[2,3],f32>, !torch.int, !torch.none -> !torch.vtensor<[2,3],f32>
+  return %ret : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten._log_softmax$not_legal(
+// CHECK-NOT:       torch.aten._log_softmax
+// CHECK:           torch.aten.exp
+func.func @torch.aten._log_softmax$not_legal(%t: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %ret = torch.aten._log_softmax %t, %int1, %false : !torch.vtensor<[2,3],f32>, !torch.int, !torch.bool -> !torch.vtensor<[2,3],f32>
+  return %ret : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.addmm$legal(
+// CHECK:           torch.aten.addmm
+// CHECK-NOT:       torch.aten.mm
+func.func @torch.aten.addmm$legal(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.vtensor<[?,?],f32>, %arg2: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.addmm %arg0, %arg1, %arg2, %int1, %int1 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
+
+// -----
+
+// The matmuls of an attention subgraph are kept for TorchToTMTensor once its
+// softmax is legal.
+// CHECK-LABEL:   func.func @attention$legal_softmax(
+// CHECK:           torch.aten.matmul
+// CHECK:           torch.aten.softmax.int
+// CHECK:           torch.aten.matmul
+// CHECK-NOT:       torch.aten.bmm
+func.func @attention$legal_softmax(%q: !torch.vtensor<[2,4,8],f32>, %k: !torch.vtensor<[2,6,8],f32>, %v: !torch.vtensor<[2,6,8],f32>) -> !torch.vtensor<[2,4,8],f32> {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %none = torch.constant.none
+  %0 = torch.aten.transpose.int %k, %int1, %int2 : !torch.vtensor<[2,6,8],f32>, !torch.int, !torch.int -> !torch.vtensor<[2,8,6],f32>
+  %1 = torch.aten.matmul %q, %0 : !torch.vtensor<[2,4,8],f32>, !torch.vtensor<[2,8,6],f32> -> !torch.vtensor<[2,4,6],f32>
+  %2 = torch.aten.softmax.int %1, %int2, %none : !torch.vtensor<[2,4,6],f32>, !torch.int, !torch.none -> !torch.vtensor<[2,4,6],f32>
+  %3 = torch.aten.matmul %2, %v : !torch.vtensor<[2,4,6],f32>, !torch.vtensor<[2,6,8],f32> -> !torch.vtensor<[2,4,8],f32>
+  return %3 : !torch.vtensor<[2,4,8],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @torch.aten.adaptive_avg_pool2d$legal(
+// CHECK:           torch.aten.adaptive_avg_pool2d
+// CHECK-NOT:       torch.aten.avg_pool2d
+func.func @torch.aten.adaptive_avg_pool2d$legal(%arg0: !torch.vtensor<[?,3,8,8],f32>) -> !torch.vtensor<[?,3,4,4],f32> {
+  %int4 = torch.constant.int 4
+  %output_size = torch.prim.ListConstruct %int4, %int4 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.adaptive_avg_pool2d %arg0, %output_size : !torch.vtensor<[?,3,8,8],f32>, !torch.list<int> -> !torch.vtensor<[?,3,4,4],f32>
+  return %0 : !torch.vtensor<[?,3,4,4],f32>
+}
+
+// -----
+
+// The pooling of dynamic spatial dims to a single element is still
+// decomposed, since its window is only known at runtime.
+// CHECK-LABEL:   func.func @torch.aten.adaptive_avg_pool2d$dynamic_unit_output(
+// CHECK-NOT:       torch.aten.adaptive_avg_pool2d
+// CHECK:           torch.aten.avg_pool2d
+func.func @torch.aten.adaptive_avg_pool2d$dynamic_unit_output(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> !torch.vtensor<[?,?,1,1],f32> {
+  %int1 = torch.constant.int 1
+  %output_size = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.adaptive_avg_pool2d %arg0, %output_size : !torch.vtensor<[?,?,?,?],f32>, !torch.list<int> -> !torch.vtensor<[?,?,1,1],f32>
+  return %0 : !torch.vtensor<[?,?,1,1],f32>
+}
+
+// -----
+
+// The backward of a cross-entropy loss is kept for backends lowering it as a
+// whole.
+// CHECK-LABEL:   func.func @torch.aten._log_softmax_backward_data$nll_loss(
+// CHECK:           %[[GRAD:.*]] = torch.aten.nll_loss_backward
+// CHECK:           %[[RESULT:.*]] = torch.aten._log_softmax_backward_data %[[GRAD]]
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[?,?],f32>
+func.func @torch.aten._log_softmax_backward_data$nll_loss(%grad_output: !torch.vtensor<[],f32>, %output: !torch.vtensor<[?,?],f32>, %target: !torch.vtensor<[?],si64>, %total_weight: !torch.vtensor<[],f32>) -> !torch.vtensor<[?,?],f32> {
+  %none = torch.constant.none
+  %int1 = torch.constant.int 1
+  %int6 = torch.constant.int 6
+  %int-100 = torch.constant.int -100
+  %0 = torch.aten.nll_loss_backward %grad_output, %output, %target, %none, %int1, %int-100, %total_weight : !torch.vtensor<[],f32>, !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],si64>, !torch.none, !torch.int, !torch.int, !torch.vtensor<[],f32> -> !torch.vtensor<[?,?],f32>
+  %1 = torch.aten._log_softmax_backward_data %0, %output, %int1, %int6 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %1 : !torch.vtensor<[?,?],f32>
+}
@@ -214,6 +214,21 @@ func.func @torch.aten.argmax$reduceall(%arg0: !torch.vtensor<[?,?],f32>) -> !tor
   return %0 : !torch.vtensor<[],si64>
 }
 
+// -----
+// CHECK-LABEL:   func.func @torch.aten.argmin(
+// CHECK-SAME:      %[[INP:.*]]: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?],si64> {
+// CHECK:           %[[CST1:.*]] = torch.constant.int 1
+// CHECK:           %[[FALSE:.*]] = torch.constant.bool false
+// CHECK:           %[[VAL:.*]], %[[IND:.*]] = torch.aten.min.dim %[[INP]], %[[CST1]], %[[FALSE]] :
+// CHECK-SAME:        !torch.vtensor<[?,?],f32>, !torch.int, !torch.bool -> !torch.vtensor<[?],f32>, !torch.vtensor<[?],si64>
+// CHECK:           return %[[IND]] : !torch.vtensor<[?],si64>
+func.func @torch.aten.argmin(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?],si64> {
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %0 = torch.aten.argmin %arg0, %int1, %false : !torch.vtensor<[?,?],f32>, !torch.int, !torch.bool -> !torch.vtensor<[?],si64>
+  return %0 : !torch.vtensor<[?],si64>
+}
+
 // -----
 // CHECK-LABEL:   func.func @torch.aten.square(
 // CHECK-SAME:                            %[[INPUT:.*]]: !torch.vtensor<[?,?,?],f32>) -> !torch.vtensor<[?,?,?],f32> {
@@ -553,6 +568,50 @@ func.func @torch.aten.select.int(%arg0: !torch.vtensor<[?,?],si64>) -> !torch.vt
   return %0 : !torch.vtensor<[?],si64>
 }
 
+// -----
+// CHECK-LABEL:   func.func @torch.aten.select_scatter(
+// CHECK-SAME:                          %[[SELF:.*]]: !torch.vtensor<[4,?],f32>,
+// CHECK-SAME:                          %[[SRC:.*]]: !torch.vtensor<[?],f32>) -> !torch.vtensor<[4,?],f32> {
+// CHECK:           %[[DIM:.*]] = torch.constant.int 0
+// CHECK:           %[[UNSQUEEZED:.*]] = torch.aten.unsqueeze %[[SRC]], %[[DIM]] : !torch.vtensor<[?],f32>, !torch.int -> !torch.vtensor<[1,?],f32>
+// CHECK:           %[[STEP:.*]] = torch.constant.int 1
+// CHECK:           %[[START:.*]] = torch.constant.int 3
+// CHECK:           %[[END:.*]] = torch.aten.add.int %[[START]], %[[STEP]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           %[[RESULT:.*]] = torch.aten.slice_scatter %[[SELF]], %[[UNSQUEEZED]], %[[DIM]], %[[START]], %[[END]], %[[STEP]] : !torch.vtensor<[4,?],f32>, !torch.vtensor<[1,?],f32>, !torch.int, !torch.int, !torch.int, !torch.int -> !torch.vtensor<[4,?],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[4,?],f32>
+func.func @torch.aten.select_scatter(%self: !torch.vtensor<[4,?],f32>, %src: !torch.vtensor<[?],f32>) -> !torch.vtensor<[4,?],f32> {
+  %int0 = torch.constant.int 0
+  %int-1 = torch.constant.int -1
+  %0 = torch.aten.select_scatter %self, %src, %int0, %int-1 : !torch.vtensor<[4,?],f32>, !torch.vtensor<[?],f32>, !torch.int, !torch.int -> !torch.vtensor<[4,?],f32>
+  return %0 : !torch.vtensor<[4,?],f32>
+}
+
+// -----
+// CHECK-LABEL:   func.func @torch.aten.select_scatter$runtime_index(
+// CHECK-SAME:                          %[[SELF:.*]]: !torch.vtensor<[?,?],f32>,
+// CHECK-SAME:                          %[[SRC:.*]]: !torch.vtensor<[?],f32>,
+// CHECK-SAME:                          %[[INDEX:.*]]: !torch.int) -> !torch.vtensor<[?,?],f32> {
+// CHECK:           %[[DIM:.*]] = torch.constant.int 1
+// CHECK:           %[[UNSQUEEZED:.*]] = torch.aten.unsqueeze %[[SRC]], %[[DIM]] : !torch.vtensor<[?],f32>, !torch.int -> !torch.vtensor<[?,1],f32>
+// CHECK:           %[[STEP:.*]] = torch.constant.int 1
+// CHECK:           %[[ZERO:.*]] = torch.constant.int 0
+// CHECK:           %[[IS_NEGATIVE:.*]] = torch.aten.gt.int %[[ZERO]], %[[INDEX]] : !torch.int, !torch.int -> !torch.bool
+// CHECK:           %[[START:.*]] = torch.prim.If %[[IS_NEGATIVE]] -> (!torch.int) {
+// CHECK:             %[[SIZE:.*]] = torch.aten.size.int %[[SELF]], %[[DIM]] : !torch.vtensor<[?,?],f32>, !torch.int -> !torch.int
+// CHECK:             %[[POSITIVE:.*]] = torch.aten.add.int %[[INDEX]], %[[SIZE]] : !torch.int, !torch.int -> !torch.int
+// CHECK:             torch.prim.If.yield %[[POSITIVE]] : !torch.int
+// CHECK:           } else {
+// CHECK:             torch.prim.If.yield %[[INDEX]] : !torch.int
+// CHECK:           }
+// CHECK:           %[[END:.*]] = torch.aten.add.int %[[START]], %[[STEP]] : !torch.int, !torch.int -> !torch.int
+// CHECK:           %[[RESULT:.*]] = torch.aten.slice_scatter %[[SELF]], %[[UNSQUEEZED]], %[[DIM]], %[[START]], %[[END]], %[[STEP]] : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,1],f32>, !torch.int, !torch.int, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[?,?],f32>
+func.func @torch.aten.select_scatter$runtime_index(%self: !torch.vtensor<[?,?],f32>, %src: !torch.vtensor<[?],f32>, %index: !torch.int) -> !torch.vtensor<[?,?],f32> {
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.select_scatter %self, %src, %int1, %index : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
+
 // -----
 // CHECK-LABEL:   func.func @torch.aten.hardsigmoid(
 // CHECK-SAME:               %[[INPUT:.*]]: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
@@ -1087,3 +1146,23 @@ func.func @torch.aten.repeat(%arg0: !torch.vtensor<[?,?],f32>, %arg1: !torch.int
   %2 = torch.aten.repeat %arg0, %1 : !torch.vtensor<[?,?],f32>, !torch.list<int> -> !torch.vtensor<[?,?,?],f32>
   return %2 : !torch.vtensor<[?,?,?],f32>
 }
+
+// -----
+// Without the op in legal-ops, the backward of a cross-entropy loss is
+// decomposed like any other.
+// CHECK-LABEL:   func.func @torch.aten._log_softmax_backward_data$nll_loss(
+// CHECK:           torch.aten.nll_loss_backward
+// CHECK-NOT:       torch.aten._log_softmax_backward_data
+func.func @torch.aten._log_softmax_backward_data$nll_loss(
+// CHECK:           %[[GRAD:.*]] = torch.aten.nll_loss_backward
+// CHECK:           %[[RESULT:.*]] = torch.aten._log_softmax_backward_data %[[GRAD]]
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[?,?],f32>
+func.func @torch.aten._log_softmax_backward_data$nll_loss(%grad_output: !torch.vtensor<[],f32>, %output: !torch.vtensor<[?,?],f32>, %target: !torch.vtensor<[?],si64>, %total_weight: !torch.vtensor<[],f32>) -> !torch.vtensor<[?,?],f32> {
+  %none = torch.constant.none
+  %int1 = torch.constant.int 1
+  %int6 = torch.constant.int 6
+  %int-100 = torch.constant.int -100
+  %0 = torch.aten.nll_loss_backward %grad_output, %output, %target, %none, %int1, %int-100, %total_weight : !torch.vtensor<[],f32>, !torch.vtensor<[?,?],f32>, !torch.vtensor<[?],si64>, !torch.none, !torch.int, !torch.int, !torch.vtensor<[],f32> -> !torch.vtensor<[?,?],f32>
+  %1 = torch.aten._log_softmax_backward_data %0, %output, %int1, %int6 : !torch.vtensor<[?,?],f32>, !torch.vtensor<[?,?],f32>, !torch.int, !torch.int -> !torch.vtensor<[?,?],f32>
+  return %1 : !torch.vtensor<[?,?],f32>
+}
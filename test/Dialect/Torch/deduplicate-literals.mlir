@@ -0,0 +1,47 @@
+// RUN: torch-mlir-opt -torch-deduplicate-literals -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @in_different_regions(
+// CHECK:           %[[LITERAL:.*]] = torch.vtensor.literal(dense<0.000000e+00> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+// CHECK:           %[[RESULT:.*]] = torch.prim.If %{{.*}} -> (!torch.vtensor<[2],f32>) {
+// CHECK-NEXT:        torch.prim.If.yield %[[LITERAL]] : !torch.vtensor<[2],f32>
+// CHECK-NEXT:      } else {
+// CHECK-NEXT:        torch.prim.If.yield %[[LITERAL]] : !torch.vtensor<[2],f32>
+// CHECK-NEXT:      }
+func.func @in_different_regions(%arg0: !torch.bool) -> !torch.vtensor<[2],f32> {
+  %0 = torch.prim.If %arg0 -> (!torch.vtensor<[2],f32>) {
+    %1 = torch.vtensor.literal(dense<0.0> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+    torch.prim.If.yield %1 : !torch.vtensor<[2],f32>
+  } else {
+    %1 = torch.vtensor.literal(dense<0.0> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+    torch.prim.If.yield %1 : !torch.vtensor<[2],f32>
+  }
+  return %0 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @different_payloads(
+// CHECK:           torch.vtensor.literal(dense<0.000000e+00> : tensor<2xf32>)
+// CHECK:           torch.vtensor.literal(dense<1.000000e+00> : tensor<2xf32>)
+func.func @different_payloads() -> (!torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>) {
+  %0 = torch.vtensor.literal(dense<0.0> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %1 = torch.vtensor.literal(dense<1.0> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  return %0, %1 : !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @non_value_tensors(
+// CHECK:           %[[LITERAL:.*]] = torch.tensor.literal(dense<0.000000e+00> : tensor<2xf32>) : !torch.tensor
+// CHECK:           %[[COPY0:.*]] = torch.copy.to_vtensor %[[LITERAL]] : !torch.vtensor
+// CHECK:           %[[COPY1:.*]] = torch.copy.to_vtensor %[[LITERAL]] : !torch.vtensor
+// CHECK:           %[[MUTATED:.*]] = torch.tensor.literal(dense<0.000000e+00> : tensor<2xf32>) : !torch.tensor
+func.func @non_value_tensors() -> (!torch.vtensor, !torch.vtensor, !torch.tensor) {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<2xf32>) : !torch.tensor
+  %1 = torch.copy.to_vtensor %0 : !torch.vtensor
+  %2 = torch.tensor.literal(dense<0.0> : tensor<2xf32>) : !torch.tensor
+  %3 = torch.copy.to_vtensor %2 : !torch.vtensor
+  // Returned, so it might be mutated by the caller.
+  %4 = torch.tensor.literal(dense<0.0> : tensor<2xf32>) : !torch.tensor
+  return %1, %3, %4 : !torch.vtensor, !torch.vtensor, !torch.tensor
+}
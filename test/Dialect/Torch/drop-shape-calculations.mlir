@@ -55,3 +55,28 @@ func.func @shape_calc_in_loop(%arg: !torch.vtensor<[2,?],unk>) -> !torch.vtensor
   return %arg : !torch.vtensor<[2,?],unk>
   // CHECK: return %[[ARG]] : !torch.vtensor<[2,?],unk>
 }
+
+// -----
+
+// The shape calculation of a custom kernel call is attached to it.
+// CHECK-LABEL:   func.func @custom_kernel(
+// CHECK-SAME:                 %[[ARG:.*]]: !torch.vtensor<[2,?],f32>) -> !torch.vtensor<[2,?],f32> {
+// CHECK:           %[[INT1:.*]] = torch.constant.int 1
+// CHECK:           %[[INT2:.*]] = torch.constant.int 2
+// CHECK:           %[[SIZE:.*]] = torch.aten.size.int %[[ARG]], %[[INT1]] : !torch.vtensor<[2,?],f32>, !torch.int -> !torch.int
+// CHECK:           %[[SHAPE:.*]] = torch.prim.ListConstruct %[[INT2]], %[[SIZE]] : (!torch.int, !torch.int) -> !torch.list<int>
+// CHECK:           %[[RESULT:.*]] = torch.operator "my_ops.gelu"(%[[ARG]], %[[SHAPE]]) {torch.custom_kernel = "my_ops_gelu", torch.custom_kernel_num_inputs = 1 : i64} : (!torch.vtensor<[2,?],f32>, !torch.list<int>) -> !torch.vtensor<[2,?],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[2,?],f32>
+func.func @custom_kernel(%arg0: !torch.vtensor<[2,?],f32>) -> !torch.vtensor<[2,?],f32> {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0 = torch.shape.calculate  {
+    %1 = torch.operator "my_ops.gelu"(%arg0) {torch.custom_kernel = "my_ops_gelu"} : (!torch.vtensor<[2,?],f32>) -> !torch.vtensor<[2,?],f32>
+    torch.shape.calculate.yield %1 : !torch.vtensor<[2,?],f32>
+  } shapes  {
+    %1 = torch.aten.size.int %arg0, %int1 : !torch.vtensor<[2,?],f32>, !torch.int -> !torch.int
+    %2 = torch.prim.ListConstruct %int2, %1 : (!torch.int, !torch.int) -> !torch.list<int>
+    torch.shape.calculate.yield.shapes %2 : !torch.list<int>
+  } : !torch.vtensor<[2,?],f32>
+  return %0 : !torch.vtensor<[2,?],f32>
+}
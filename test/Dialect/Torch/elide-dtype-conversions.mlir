@@ -0,0 +1,115 @@
+// RUN: torch-mlir-opt -torch-elide-dtype-conversions -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @elide_dtype_conversions$round_trip(
+// CHECK-SAME:                                                   %[[ARG:.*]]: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32> {
+// CHECK:           return %[[ARG]] : !torch.vtensor<[2],f32>
+func.func @elide_dtype_conversions$round_trip(%arg0: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32> {
+  %int6 = torch.constant.int 6
+  %int7 = torch.constant.int 7
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %0 = torch.aten.to.dtype %arg0, %int7, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f64>
+  %1 = torch.aten.to.dtype %0, %int6, %false, %false, %none : !torch.vtensor<[2],f64>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  return %1 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// The i64 to f64 conversion rounds, but the f32 to f64 one doesn't.
+// CHECK-LABEL:   func.func @elide_dtype_conversions$chain(
+// CHECK-SAME:                                              %[[ARG:.*]]: !torch.vtensor<[2],si64>) -> !torch.vtensor<[2],f32> {
+// CHECK:           %[[F32:.*]] = torch.aten.to.dtype %[[ARG]], {{.*}} : !torch.vtensor<[2],si64>, {{.*}} -> !torch.vtensor<[2],f32>
+// CHECK:           return %[[F32]] : !torch.vtensor<[2],f32>
+func.func @elide_dtype_conversions$chain(%arg0: !torch.vtensor<[2],si64>) -> !torch.vtensor<[2],f32> {
+  %int6 = torch.constant.int 6
+  %int7 = torch.constant.int 7
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %0 = torch.aten.to.dtype %arg0, %int6, %false, %false, %none : !torch.vtensor<[2],si64>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  %1 = torch.aten.to.dtype %0, %int7, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f64>
+  %2 = torch.aten.to.dtype %1, %int6, %false, %false, %none : !torch.vtensor<[2],f64>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  return %2 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// Converting to f16 rounds, so the round trip is kept.
+// CHECK-LABEL:   func.func @elide_dtype_conversions$rounding_round_trip(
+// CHECK:           %[[F16:.*]] = torch.aten.to.dtype {{.*}} -> !torch.vtensor<[2],f16>
+// CHECK:           %[[F32:.*]] = torch.aten.to.dtype %[[F16]], {{.*}} -> !torch.vtensor<[2],f32>
+// CHECK:           return %[[F32]] : !torch.vtensor<[2],f32>
+func.func @elide_dtype_conversions$rounding_round_trip(%arg0: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32> {
+  %int5 = torch.constant.int 5
+  %int6 = torch.constant.int 6
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %0 = torch.aten.to.dtype %arg0, %int5, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f16>
+  %1 = torch.aten.to.dtype %0, %int6, %false, %false, %none : !torch.vtensor<[2],f16>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  return %1 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @elide_dtype_conversions$literal() -> (!torch.vtensor<[3],f32>, !torch.vtensor<[2],f16>) {
+// CHECK:           %[[INTS:.*]] = torch.vtensor.literal(dense<[-1.000000e+00, 0.000000e+00, 3.000000e+00]> : tensor<3xf32>) : !torch.vtensor<[3],f32>
+// CHECK:           %[[SPLAT:.*]] = torch.vtensor.literal(dense<2.500000e+00> : tensor<2xf16>) : !torch.vtensor<[2],f16>
+// CHECK:           return %[[INTS]], %[[SPLAT]] : !torch.vtensor<[3],f32>, !torch.vtensor<[2],f16>
+func.func @elide_dtype_conversions$literal() -> (!torch.vtensor<[3],f32>, !torch.vtensor<[2],f16>) {
+  %int5 = torch.constant.int 5
+  %int6 = torch.constant.int 6
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %0 = torch.vtensor.literal(dense<[-1, 0, 3]> : tensor<3xsi64>) : !torch.vtensor<[3],si64>
+  %1 = torch.aten.to.dtype %0, %int6, %false, %false, %none : !torch.vtensor<[3],si64>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[3],f32>
+  %2 = torch.vtensor.literal(dense<2.5> : tensor<2xf64>) : !torch.vtensor<[2],f64>
+  %3 = torch.aten.to.dtype %2, %int5, %false, %false, %none : !torch.vtensor<[2],f64>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f16>
+  return %1, %3 : !torch.vtensor<[3],f32>, !torch.vtensor<[2],f16>
+}
+
+// -----
+
+// The add of f16 tensors promoted to f32 and the mul by an exact f32 scale
+// are computed in f16.
+// CHECK-LABEL:   func.func @elide_dtype_conversions$narrow(
+// CHECK-SAME:                                               %[[LHS:.*]]: !torch.vtensor<[2],f16>, %[[RHS:.*]]: !torch.vtensor<[2],f16>) -> !torch.vtensor<[2],f16> {
+// CHECK:           %[[INT1:.*]] = torch.constant.int 1
+// CHECK:           %[[ADD:.*]] = torch.aten.add.Tensor %[[LHS]], %[[RHS]], %[[INT1]] : !torch.vtensor<[2],f16>, !torch.vtensor<[2],f16>, !torch.int -> !torch.vtensor<[2],f16>
+// CHECK:           %[[SCALE:.*]] = torch.vtensor.literal(dense<5.000000e-01> : tensor<f16>) : !torch.vtensor<[],f16>
+// CHECK:           %[[MUL:.*]] = torch.aten.mul.Tensor %[[ADD]], %[[SCALE]] : !torch.vtensor<[2],f16>, !torch.vtensor<[],f16> -> !torch.vtensor<[2],f16>
+// CHECK:           return %[[MUL]] : !torch.vtensor<[2],f16>
+func.func @elide_dtype_conversions$narrow(%arg0: !torch.vtensor<[2],f16>, %arg1: !torch.vtensor<[2],f16>) -> !torch.vtensor<[2],f16> {
+  %int1 = torch.constant.int 1
+  %int5 = torch.constant.int 5
+  %int6 = torch.constant.int 6
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %0 = torch.aten.to.dtype %arg0, %int6, %false, %false, %none : !torch.vtensor<[2],f16>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  %1 = torch.aten.to.dtype %arg1, %int6, %false, %false, %none : !torch.vtensor<[2],f16>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  %2 = torch.aten.add.Tensor %0, %1, %int1 : !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.int -> !torch.vtensor<[2],f32>
+  %3 = torch.aten.to.dtype %2, %int5, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f16>
+  %4 = torch.aten.to.dtype %3, %int6, %false, %false, %none : !torch.vtensor<[2],f16>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  %5 = torch.vtensor.literal(dense<5.000000e-01> : tensor<f32>) : !torch.vtensor<[],f32>
+  %6 = torch.aten.mul.Tensor %4, %5 : !torch.vtensor<[2],f32>, !torch.vtensor<[],f32> -> !torch.vtensor<[2],f32>
+  %7 = torch.aten.to.dtype %6, %int5, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f16>
+  return %7 : !torch.vtensor<[2],f16>
+}
+
+// -----
+
+// The exp rounds differently in f32 and f16, and the f32 add has another use.
+// CHECK-LABEL:   func.func @elide_dtype_conversions$no_narrow(
+// CHECK:           torch.aten.exp {{.*}} -> !torch.vtensor<[2],f32>
+// CHECK:           torch.aten.add.Tensor {{.*}} -> !torch.vtensor<[2],f32>
+func.func @elide_dtype_conversions$no_narrow(%arg0: !torch.vtensor<[2],f16>) -> (!torch.vtensor<[2],f16>, !torch.vtensor<[2],f16>, !torch.vtensor<[2],f32>) {
+  %int1 = torch.constant.int 1
+  %int5 = torch.constant.int 5
+  %int6 = torch.constant.int 6
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %0 = torch.aten.to.dtype %arg0, %int6, %false, %false, %none : !torch.vtensor<[2],f16>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f32>
+  %1 = torch.aten.exp %0 : !torch.vtensor<[2],f32> -> !torch.vtensor<[2],f32>
+  %2 = torch.aten.to.dtype %1, %int5, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f16>
+  %3 = torch.aten.add.Tensor %0, %0, %int1 : !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.int -> !torch.vtensor<[2],f32>
+  %4 = torch.aten.to.dtype %3, %int5, %false, %false, %none : !torch.vtensor<[2],f32>, !torch.int, !torch.bool, !torch.bool, !torch.none -> !torch.vtensor<[2],f16>
+  return %2, %4, %3 : !torch.vtensor<[2],f16>, !torch.vtensor<[2],f16>, !torch.vtensor<[2],f32>
+}
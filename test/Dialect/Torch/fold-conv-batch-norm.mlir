@@ -0,0 +1,53 @@
+// RUN: torch-mlir-opt -torch-fold-conv-batch-norm -split-input-file %s | FileCheck %s
+
+// Scale = weight / sqrt(running_var + eps) = [2.0, 0.5], so the conv weight
+// [[1.0], [2.0]] becomes [[2.0], [1.0]], and the bias becomes
+// (conv_bias - running_mean) * scale + bias = [(1 - 3) * 2 + 1, (2 - 0) * 0.5 + 0]
+// = [-3.0, 1.0].
+// CHECK-LABEL:   func.func @fold_conv_batch_norm(
+// CHECK-SAME:                                    %[[INPUT:.*]]: !torch.vtensor<[1,1,4,4],f32>) -> !torch.vtensor<[1,2,4,4],f32> {
+// CHECK-DAG:       %[[WEIGHT:.*]] = torch.vtensor.literal(dense<{{\[\[\[\[}}2.000000e+00]]], {{\[\[\[}}1.000000e+00]]]]> : tensor<2x1x1x1xf32>) : !torch.vtensor<[2,1,1,1],f32>
+// CHECK-DAG:       %[[BIAS:.*]] = torch.vtensor.literal(dense<[-3.000000e+00, 1.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+// CHECK:           %[[CONV:.*]] = torch.aten.convolution %[[INPUT]], %[[WEIGHT]], %[[BIAS]]
+// CHECK-NOT:       torch.aten.batch_norm
+// CHECK:           return %[[CONV]] : !torch.vtensor<[1,2,4,4],f32>
+func.func @fold_conv_batch_norm(%arg0: !torch.vtensor<[1,1,4,4],f32>) -> !torch.vtensor<[1,2,4,4],f32> {
+  %weight = torch.vtensor.literal(dense<[[[[1.000000e+00]]], [[[2.000000e+00]]]]> : tensor<2x1x1x1xf32>) : !torch.vtensor<[2,1,1,1],f32>
+  %bias = torch.vtensor.literal(dense<[1.000000e+00, 2.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %bn_weight = torch.vtensor.literal(dense<[2.000000e+00, 1.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %bn_bias = torch.vtensor.literal(dense<[1.000000e+00, 0.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %running_mean = torch.vtensor.literal(dense<[3.000000e+00, 0.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %running_var = torch.vtensor.literal(dense<[1.000000e+00, 4.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %float1.000000e-01 = torch.constant.float 1.000000e-01
+  %float0.000000e00 = torch.constant.float 0.000000e+00
+  %ones = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %zeros = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.convolution %arg0, %weight, %bias, %ones, %zeros, %ones, %false, %zeros, %int1 : !torch.vtensor<[1,1,4,4],f32>, !torch.vtensor<[2,1,1,1],f32>, !torch.vtensor<[2],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,2,4,4],f32>
+  %1 = torch.aten.batch_norm %0, %bn_weight, %bn_bias, %running_mean, %running_var, %false, %float1.000000e-01, %float0.000000e00, %false : !torch.vtensor<[1,2,4,4],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.vtensor<[1,2,4,4],f32>
+  return %1 : !torch.vtensor<[1,2,4,4],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @training_mode(
+// CHECK:           torch.aten.batch_norm
+func.func @training_mode(%arg0: !torch.vtensor<[1,1,4,4],f32>) -> !torch.vtensor<[1,2,4,4],f32> {
+  %weight = torch.vtensor.literal(dense<[[[[1.000000e+00]]], [[[2.000000e+00]]]]> : tensor<2x1x1x1xf32>) : !torch.vtensor<[2,1,1,1],f32>
+  %running_mean = torch.vtensor.literal(dense<[3.000000e+00, 0.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %running_var = torch.vtensor.literal(dense<[1.000000e+00, 4.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %none = torch.constant.none
+  %true = torch.constant.bool true
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %float1.000000e-01 = torch.constant.float 1.000000e-01
+  %float1.000000e-05 = torch.constant.float 1.000000e-05
+  %ones = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %zeros = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.convolution %arg0, %weight, %none, %ones, %zeros, %ones, %false, %zeros, %int1 : !torch.vtensor<[1,1,4,4],f32>, !torch.vtensor<[2,1,1,1],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,2,4,4],f32>
+  %1 = torch.aten.batch_norm %0, %none, %none, %running_mean, %running_var, %true, %float1.000000e-01, %float1.000000e-05, %false : !torch.vtensor<[1,2,4,4],f32>, !torch.none, !torch.none, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.vtensor<[1,2,4,4],f32>
+  return %1 : !torch.vtensor<[1,2,4,4],f32>
+}
@@ -0,0 +1,133 @@
+// RUN: torch-mlir-opt -torch-fold-literal-tensors="max-elements=6 max-splat-elements=5000" -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @mul_scalar() -> !torch.vtensor<[2],f32> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<[1.000000e+00, -3.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+// CHECK:           return %[[RET]] : !torch.vtensor<[2],f32>
+func.func @mul_scalar() -> !torch.vtensor<[2],f32> {
+  %0 = torch.vtensor.literal(dense<[2.000000e+00, -6.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %float5.000000e-01 = torch.constant.float 5.000000e-01
+  %1 = torch.aten.mul.Scalar %0, %float5.000000e-01 : !torch.vtensor<[2],f32>, !torch.float -> !torch.vtensor<[2],f32>
+  return %1 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @add_tensor$broadcast() -> !torch.vtensor<[2,3],si64> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<{{\[\[}}2, 4, 6], [3, 5, 7]]> : tensor<2x3xsi64>) : !torch.vtensor<[2,3],si64>
+// CHECK:           return %[[RET]] : !torch.vtensor<[2,3],si64>
+func.func @add_tensor$broadcast() -> !torch.vtensor<[2,3],si64> {
+  %0 = torch.vtensor.literal(dense<[[0], [1]]> : tensor<2x1xsi64>) : !torch.vtensor<[2,1],si64>
+  %1 = torch.vtensor.literal(dense<[1, 2, 3]> : tensor<3xsi64>) : !torch.vtensor<[3],si64>
+  %int2 = torch.constant.int 2
+  %2 = torch.aten.add.Tensor %0, %1, %int2 : !torch.vtensor<[2,1],si64>, !torch.vtensor<[3],si64>, !torch.int -> !torch.vtensor<[2,3],si64>
+  return %2 : !torch.vtensor<[2,3],si64>
+}
+
+// -----
+
+// A causal mask computed from `aten.arange`.
+// CHECK-LABEL:   func.func @arange_mask() -> !torch.vtensor<[2,2],i1> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<{{\[\[}}false, false], [true, false]]> : tensor<2x2xi1>) : !torch.vtensor<[2,2],i1>
+// CHECK:           return %[[RET]] : !torch.vtensor<[2,2],i1>
+func.func @arange_mask() -> !torch.vtensor<[2,2],i1> {
+  %none = torch.constant.none
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0 = torch.aten.arange %int2, %none, %none, %none, %none : !torch.int, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[2],si64>
+  %1 = torch.aten.unsqueeze %0, %int0 : !torch.vtensor<[2],si64>, !torch.int -> !torch.vtensor<[1,2],si64>
+  %2 = torch.aten.unsqueeze %0, %int1 : !torch.vtensor<[2],si64>, !torch.int -> !torch.vtensor<[2,1],si64>
+  %3 = torch.aten.lt.Tensor %1, %2 : !torch.vtensor<[1,2],si64>, !torch.vtensor<[2,1],si64> -> !torch.vtensor<[2,2],i1>
+  return %3 : !torch.vtensor<[2,2],i1>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @transpose() -> !torch.vtensor<[3,2],f32> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<{{\[\[}}1.000000e+00, 4.000000e+00], [2.000000e+00, 5.000000e+00], [3.000000e+00, 6.000000e+00]]> : tensor<3x2xf32>) : !torch.vtensor<[3,2],f32>
+// CHECK:           return %[[RET]] : !torch.vtensor<[3,2],f32>
+func.func @transpose() -> !torch.vtensor<[3,2],f32> {
+  %0 = torch.vtensor.literal(dense<[[1.000000e+00, 2.000000e+00, 3.000000e+00], [4.000000e+00, 5.000000e+00, 6.000000e+00]]> : tensor<2x3xf32>) : !torch.vtensor<[2,3],f32>
+  %int0 = torch.constant.int 0
+  %int-1 = torch.constant.int -1
+  %1 = torch.aten.transpose.int %0, %int0, %int-1 : !torch.vtensor<[2,3],f32>, !torch.int, !torch.int -> !torch.vtensor<[3,2],f32>
+  return %1 : !torch.vtensor<[3,2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @no_fold$non_literal_operand(
+// CHECK:           torch.aten.mul.Tensor
+func.func @no_fold$non_literal_operand(%arg0: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32> {
+  %0 = torch.vtensor.literal(dense<[2.000000e+00, -6.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %1 = torch.aten.mul.Tensor %0, %arg0 : !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32> -> !torch.vtensor<[2],f32>
+  return %1 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @neg$splat() -> !torch.vtensor<[5000],f32> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<-1.000000e+00> : tensor<5000xf32>) : !torch.vtensor<[5000],f32>
+// CHECK:           return %[[RET]] : !torch.vtensor<[5000],f32>
+func.func @neg$splat() -> !torch.vtensor<[5000],f32> {
+  %0 = torch.vtensor.literal(dense<1.000000e+00> : tensor<5000xf32>) : !torch.vtensor<[5000],f32>
+  %1 = torch.aten.neg %0 : !torch.vtensor<[5000],f32> -> !torch.vtensor<[5000],f32>
+  return %1 : !torch.vtensor<[5000],f32>
+}
+
+// -----
+
+// The splat would be materialized with more than `max-splat-elements` elements
+// by the backends that don't fuse it.
+// CHECK-LABEL:   func.func @neg$large_splat() -> !torch.vtensor<[5001],f32> {
+// CHECK:           torch.aten.neg
+func.func @neg$large_splat() -> !torch.vtensor<[5001],f32> {
+  %0 = torch.vtensor.literal(dense<1.000000e+00> : tensor<5001xf32>) : !torch.vtensor<[5001],f32>
+  %1 = torch.aten.neg %0 : !torch.vtensor<[5001],f32> -> !torch.vtensor<[5001],f32>
+  return %1 : !torch.vtensor<[5001],f32>
+}
+
+// -----
+
+// The decomposed form of `aten.full`.
+// CHECK-LABEL:   func.func @fill_scalar() -> !torch.vtensor<[64,64],f32> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<3.000000e+00> : tensor<64x64xf32>) : !torch.vtensor<[64,64],f32>
+// CHECK:           return %[[RET]] : !torch.vtensor<[64,64],f32>
+func.func @fill_scalar() -> !torch.vtensor<[64,64],f32> {
+  %none = torch.constant.none
+  %int64 = torch.constant.int 64
+  %int3 = torch.constant.int 3
+  %0 = torch.prim.ListConstruct %int64, %int64 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.empty.memory_format %0, %none, %none, %none, %none, %none : !torch.list<int>, !torch.none, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[64,64],f32>
+  %2 = torch.valsem.aten.fill.Scalar %1, %int3 : !torch.vtensor<[64,64],f32>, !torch.int -> !torch.vtensor<[64,64],f32>
+  return %2 : !torch.vtensor<[64,64],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @zeros_expand() -> !torch.vtensor<[8,64],si64> {
+// CHECK:           %[[RET:.*]] = torch.vtensor.literal(dense<0> : tensor<8x64xsi64>) : !torch.vtensor<[8,64],si64>
+// CHECK:           return %[[RET]] : !torch.vtensor<[8,64],si64>
+func.func @zeros_expand() -> !torch.vtensor<[8,64],si64> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int1 = torch.constant.int 1
+  %int8 = torch.constant.int 8
+  %int64 = torch.constant.int 64
+  %0 = torch.prim.ListConstruct %int1, %int64 : (!torch.int, !torch.int) -> !torch.list<int>
+  %1 = torch.aten.zeros %0, %none, %none, %none, %none : !torch.list<int>, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[1,64],si64>
+  %2 = torch.prim.ListConstruct %int8, %int64 : (!torch.int, !torch.int) -> !torch.list<int>
+  %3 = torch.aten.expand %1, %2, %false : !torch.vtensor<[1,64],si64>, !torch.list<int>, !torch.bool -> !torch.vtensor<[8,64],si64>
+  return %3 : !torch.vtensor<[8,64],si64>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @no_fold$too_large(
+// CHECK:           torch.aten.arange
+func.func @no_fold$too_large() -> !torch.vtensor<[8],si64> {
+  %none = torch.constant.none
+  %int8 = torch.constant.int 8
+  %0 = torch.aten.arange %int8, %none, %none, %none, %none : !torch.int, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[8],si64>
+  return %0 : !torch.vtensor<[8],si64>
+}
@@ -0,0 +1,43 @@
+// RUN: torch-mlir-opt -torch-force-inference-mode -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @dropout(
+// CHECK-SAME:                       %[[INPUT:.*]]: !torch.vtensor<[?],f32>,
+// CHECK-SAME:                       %[[TRAIN:.*]]: !torch.bool) -> !torch.vtensor<[?],f32> {
+// CHECK:           %[[P:.*]] = torch.constant.float
+// CHECK:           %[[FALSE:.*]] = torch.constant.bool false
+// CHECK:           %[[RESULT:.*]] = torch.aten.dropout %[[INPUT]], %[[P]], %[[FALSE]] : !torch.vtensor<[?],f32>, !torch.float, !torch.bool -> !torch.vtensor<[?],f32>
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[?],f32>
+func.func @dropout(%arg0: !torch.vtensor<[?],f32>, %train: !torch.bool) -> !torch.vtensor<[?],f32> {
+  %float0.5 = torch.constant.float 5.000000e-01
+  %0 = torch.aten.dropout %arg0, %float0.5, %train : !torch.vtensor<[?],f32>, !torch.float, !torch.bool -> !torch.vtensor<[?],f32>
+  return %0 : !torch.vtensor<[?],f32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @batch_norm(
+// CHECK:           %[[FALSE:.*]] = torch.constant.bool false
+// CHECK:           torch.aten.batch_norm %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %[[FALSE]],
+func.func @batch_norm(%arg0: !torch.vtensor<[?,2,?],f32>, %weight: !torch.vtensor<[2],f32>, %bias: !torch.vtensor<[2],f32>, %mean: !torch.vtensor<[2],f32>, %var: !torch.vtensor<[2],f32>) -> !torch.vtensor<[?,2,?],f32> {
+  %true = torch.constant.bool true
+  %float1.000000e-01 = torch.constant.float 1.000000e-01
+  %float1.000000e-05 = torch.constant.float 1.000000e-05
+  %0 = torch.aten.batch_norm %arg0, %weight, %bias, %mean, %var, %true, %float1.000000e-01, %float1.000000e-05, %true : !torch.vtensor<[?,2,?],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.vtensor<[?,2,?],f32>
+  return %0 : !torch.vtensor<[?,2,?],f32>
+}
+
+// -----
+
+// Without running stats, the batch norm keeps normalizing with the stats of
+// the batch.
+// CHECK-LABEL:   func.func @batch_norm$no_running_stats(
+// CHECK:           %[[TRUE:.*]] = torch.constant.bool true
+// CHECK:           torch.aten.batch_norm %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %[[TRUE]],
+func.func @batch_norm$no_running_stats(%arg0: !torch.vtensor<[?,2,?],f32>, %weight: !torch.vtensor<[2],f32>, %bias: !torch.vtensor<[2],f32>) -> !torch.vtensor<[?,2,?],f32> {
+  %true = torch.constant.bool true
+  %none = torch.constant.none
+  %float1.000000e-01 = torch.constant.float 1.000000e-01
+  %float1.000000e-05 = torch.constant.float 1.000000e-05
+  %0 = torch.aten.batch_norm %arg0, %weight, %bias, %none, %none, %true, %float1.000000e-01, %float1.000000e-05, %true : !torch.vtensor<[?,2,?],f32>, !torch.vtensor<[2],f32>, !torch.vtensor<[2],f32>, !torch.none, !torch.none, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.vtensor<[?,2,?],f32>
+  return %0 : !torch.vtensor<[?,2,?],f32>
+}
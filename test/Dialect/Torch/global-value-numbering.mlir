@@ -0,0 +1,83 @@
+// RUN: torch-mlir-opt -torch-global-value-numbering -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @commutative_ops(
+// CHECK-SAME:                               %[[A:.*]]: !torch.vtensor<[2,3],f32>, %[[B:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[MUL:.*]] = torch.aten.mul.Tensor %[[A]], %[[B]]
+// CHECK-NOT:       torch.aten.mul.Tensor
+// CHECK:           %[[ADD:.*]] = torch.aten.add.Tensor %[[MUL]], %[[A]], %{{.*}}
+// CHECK-NOT:       torch.aten.add.Tensor %[[A]], %[[MUL]], %int1
+// CHECK:           %[[SUM:.*]] = torch.aten.add.Tensor %[[ADD]], %[[ADD]], %{{.*}}
+// CHECK:           %[[SCALED0:.*]] = torch.aten.add.Tensor %[[SUM]], %[[B]], %[[INT2:.*]] :
+// CHECK:           %[[SCALED1:.*]] = torch.aten.add.Tensor %[[B]], %[[SUM]], %[[INT2]] :
+// CHECK:           %[[RESULT:.*]] = torch.aten.sub.Tensor %[[SCALED0]], %[[SCALED1]], %{{.*}}
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[2,3],f32>
+func.func @commutative_ops(%a: !torch.vtensor<[2,3],f32>, %b: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0 = torch.aten.mul.Tensor %a, %b : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+  %1 = torch.aten.mul.Tensor %b, %a : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+  %2 = torch.aten.add.Tensor %0, %a, %int1 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  %3 = torch.aten.add.Tensor %a, %1, %int1 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  %4 = torch.aten.add.Tensor %2, %3, %int1 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  // With an `alpha` other than 1, the operands can't be swapped.
+  %5 = torch.aten.add.Tensor %4, %b, %int2 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  %6 = torch.aten.add.Tensor %b, %4, %int2 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  %7 = torch.aten.sub.Tensor %5, %6, %int1 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  return %7 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// The product computed in both branches is hoisted out of the `prim.If`, then
+// merged with the one computed after it, and the tensor computed before the
+// `prim.If` is reused in its branches.
+// CHECK-LABEL:   func.func @branches(
+// CHECK-SAME:                        %[[A:.*]]: !torch.vtensor<[2,3],f32>, %[[B:.*]]: !torch.vtensor<[2,3],f32>, %[[COND:.*]]: !torch.bool) -> !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[TANH:.*]] = torch.aten.tanh %[[A]]
+// CHECK:           %[[MUL:.*]] = torch.aten.mul.Tensor %[[A]], %[[B]]
+// CHECK:           %[[IF:.*]] = torch.prim.If %[[COND]] -> (!torch.vtensor<[2,3],f32>) {
+// CHECK-NOT:         torch.aten.tanh
+// CHECK:             %[[RELU:.*]] = torch.aten.relu %[[MUL]]
+// CHECK:             %[[THEN:.*]] = torch.aten.mul.Tensor %[[RELU]], %[[TANH]]
+// CHECK:             torch.prim.If.yield %[[THEN]]
+// CHECK:           } else {
+// CHECK:             %[[ELSE:.*]] = torch.aten.sigmoid %[[MUL]]
+// CHECK:             torch.prim.If.yield %[[ELSE]]
+// CHECK:           }
+// CHECK:           %[[RESULT:.*]] = torch.aten.add.Tensor %[[IF]], %[[MUL]], %{{.*}}
+// CHECK:           return %[[RESULT]] : !torch.vtensor<[2,3],f32>
+func.func @branches(%a: !torch.vtensor<[2,3],f32>, %b: !torch.vtensor<[2,3],f32>, %cond: !torch.bool) -> !torch.vtensor<[2,3],f32> {
+  %int1 = torch.constant.int 1
+  %0 = torch.aten.tanh %a : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+  %1 = torch.prim.If %cond -> (!torch.vtensor<[2,3],f32>) {
+    %mul = torch.aten.mul.Tensor %a, %b : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    %relu = torch.aten.relu %mul : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    %tanh = torch.aten.tanh %a : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    %3 = torch.aten.mul.Tensor %relu, %tanh : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    torch.prim.If.yield %3 : !torch.vtensor<[2,3],f32>
+  } else {
+    %mul = torch.aten.mul.Tensor %b, %a : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    %3 = torch.aten.sigmoid %mul : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    torch.prim.If.yield %3 : !torch.vtensor<[2,3],f32>
+  }
+  %2 = torch.aten.mul.Tensor %a, %b : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+  %3 = torch.aten.add.Tensor %1, %2, %int1 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+  return %3 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// Random ops and ops on non-value tensors are not merged.
+// CHECK-LABEL:   func.func @not_merged(
+// CHECK:           torch.aten.rand_like
+// CHECK:           torch.aten.rand_like
+// CHECK:           torch.aten.mul.Tensor
+// CHECK:           torch.aten.mul.Tensor
+func.func @not_merged(%a: !torch.vtensor<[2,3],f32>, %t: !torch.tensor<[2,3],f32>) -> (!torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.tensor<[2,3],f32>, !torch.tensor<[2,3],f32>) {
+  %none = torch.constant.none
+  %0 = torch.aten.rand_like %a, %none, %none, %none, %none, %none : !torch.vtensor<[2,3],f32>, !torch.none, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[2,3],f32>
+  %1 = torch.aten.rand_like %a, %none, %none, %none, %none, %none : !torch.vtensor<[2,3],f32>, !torch.none, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[2,3],f32>
+  %2 = torch.aten.mul.Tensor %t, %t : !torch.tensor<[2,3],f32>, !torch.tensor<[2,3],f32> -> !torch.tensor<[2,3],f32>
+  %3 = torch.aten.mul.Tensor %t, %t : !torch.tensor<[2,3],f32>, !torch.tensor<[2,3],f32> -> !torch.tensor<[2,3],f32>
+  return %0, %1, %2, %3 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32>, !torch.tensor<[2,3],f32>, !torch.tensor<[2,3],f32>
+}
@@ -35,3 +35,50 @@ func.func @forward() -> (!torch.tensor, !torch.tensor, !torch.tensor) {
   // CHECK:           return %[[READONLY]], %[[PUBLIC]], %[[MUTATED]] : !torch.tensor, !torch.tensor, !torch.tensor
   return %0, %1, %2 : !torch.tensor, !torch.tensor, !torch.tensor
 }
+
+// -----
+
+// CHECK-LABEL: torch.global_slot "private" @mutated_in_place
+torch.global_slot "private" @mutated_in_place : !torch.tensor  {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<3xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+
+// Not inlined: the tensor stored in the slot is mutated in place, through a
+// view of it.
+// CHECK-LABEL:   func.func @forward(
+// CHECK:           %[[MUTATED:.*]] = torch.global_slot.get @mutated_in_place : !torch.tensor
+// CHECK:           torch.tensor_static_info_cast %[[MUTATED]]
+func.func @forward(%arg0: !torch.tensor) {
+  %int1 = torch.constant.int 1
+  %0 = torch.global_slot.get @mutated_in_place : !torch.tensor
+  %1 = torch.tensor_static_info_cast %0 : !torch.tensor to !torch.tensor<[3],f32>
+  %2 = torch.aten.add_.Tensor %1, %arg0, %int1 : !torch.tensor<[3],f32>, !torch.tensor, !torch.int -> !torch.tensor<[3],f32>
+  return
+}
+
+// -----
+
+// CHECK-LABEL: torch.global_slot "private" @running_mean
+torch.global_slot "private" @running_mean : !torch.tensor  {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<3xf32>) : !torch.tensor
+  torch.global_slot.init %0 : !torch.tensor
+}
+
+// Not inlined: a batch norm in training mode updates its running stats in
+// place.
+// CHECK-LABEL:   func.func @forward(
+// CHECK:           %[[RUNNING_MEAN:.*]] = torch.global_slot.get @running_mean : !torch.tensor
+// CHECK:           torch.derefine %[[RUNNING_MEAN]]
+func.func @forward(%arg0: !torch.tensor, %arg1: !torch.tensor) -> !torch.tensor {
+  %true = torch.constant.bool true
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %momentum = torch.constant.float 1.000000e-01
+  %eps = torch.constant.float 1.000000e-05
+  %0 = torch.global_slot.get @running_mean : !torch.tensor
+  %1 = torch.derefine %0 : !torch.tensor to !torch.optional<tensor>
+  %2 = torch.derefine %arg1 : !torch.tensor to !torch.optional<tensor>
+  %3 = torch.aten.batch_norm %arg0, %none, %none, %1, %2, %true, %momentum, %eps, %false : !torch.tensor, !torch.none, !torch.none, !torch.optional<tensor>, !torch.optional<tensor>, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.tensor
+  return %3 : !torch.tensor
+}
@@ -136,6 +136,16 @@ func.func private @tensor.invalid_dtype() -> !torch.tensor<*,tuple<>>
 
 // -----
 
+// expected-error @+1 {{invalid sparsity 1 : i64 for !torch.tensor type}}
+func.func private @tensor.invalid_sparsity() -> !torch.tensor<[4,8],f32,1>
+
+// -----
+
+// expected-error @+1 {{requires sizes of the same rank}}
+func.func private @tensor.sparsity_rank_mismatch() -> !torch.vtensor<[4],f32,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>
+
+// -----
+
 func.func @torch.tensor() {
   // Incompatible shape.
   // expected-error@+1 {{must be Multi-dimensional array modeling Torch's Tensor type, but got}}
@@ -163,6 +173,22 @@ func.func @torch.tensor() {
 
 // -----
 
+func.func @torch.vtensor.external_literal() {
+  // expected-error@+1 {{result type must have static sizes and a dtype}}
+  %0 = torch.vtensor.external_literal "weights.bin", 0 : !torch.vtensor<[?],f32>
+  return
+}
+
+// -----
+
+func.func @torch.vtensor.external_literal() {
+  // expected-error@+1 {{offset must be non-negative}}
+  %0 = torch.vtensor.external_literal "weights.bin", -1 : !torch.vtensor<[2],f32>
+  return
+}
+
+// -----
+
 func.func @torch.prim.ListConstruct() {
   %int2 = torch.constant.int 2
   // expected-error@+1 {{operand types should have the same type as the list contained type}}
@@ -0,0 +1,105 @@
+// RUN: torch-mlir-opt -torch-loop-invariant-code-motion -split-input-file %s | FileCheck %s
+
+// The loop runs at least once, so ops that may fail are hoisted too.
+// CHECK-LABEL:   func.func @hoist_loop_invariants(
+// CHECK-SAME:                                     %[[X:.*]]: !torch.vtensor<[2,3],f32>, %[[W:.*]]: !torch.vtensor<[3,2],f32>) -> !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[T:.*]] = torch.aten.t %[[W]]
+// CHECK:           %[[LOOP:.*]] = torch.prim.Loop %{{.*}}, %{{.*}}, init(%[[X]]) {
+// CHECK:           ^bb0(%{{.*}}: !torch.int, %[[ACC:.*]]: !torch.vtensor<[2,3],f32>):
+// CHECK-NOT:         torch.aten.t
+// CHECK:             %[[MUL:.*]] = torch.aten.mul.Tensor %[[ACC]], %[[T]]
+// CHECK:             torch.prim.Loop.condition %{{.*}}, iter(%[[MUL]] : !torch.vtensor<[2,3],f32>)
+func.func @hoist_loop_invariants(%x: !torch.vtensor<[2,3],f32>, %w: !torch.vtensor<[3,2],f32>) -> !torch.vtensor<[2,3],f32> {
+  %true = torch.constant.bool true
+  %int4 = torch.constant.int 4
+  %0 = torch.prim.Loop %int4, %true, init(%x) {
+  ^bb0(%i: !torch.int, %acc: !torch.vtensor<[2,3],f32>):
+    %t = torch.aten.t %w : !torch.vtensor<[3,2],f32> -> !torch.vtensor<[2,3],f32>
+    %1 = torch.aten.mul.Tensor %acc, %t : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    torch.prim.Loop.condition %true, iter(%1 : !torch.vtensor<[2,3],f32>)
+  } : (!torch.int, !torch.bool, !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// The ops using the induction variable or drawing random numbers stay in the
+// loop.
+// CHECK-LABEL:   func.func @no_hoist_variants(
+// CHECK:           torch.prim.Loop
+// CHECK:             torch.aten.mul.Scalar
+// CHECK:             torch.aten.rand_like
+func.func @no_hoist_variants(%x: !torch.vtensor<[2,3],f32>, %n: !torch.int) -> !torch.vtensor<[2,3],f32> {
+  %true = torch.constant.bool true
+  %none = torch.constant.none
+  %0 = torch.prim.Loop %n, %true, init(%x) {
+  ^bb0(%i: !torch.int, %acc: !torch.vtensor<[2,3],f32>):
+    %1 = torch.aten.mul.Scalar %x, %i : !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],f32>
+    %2 = torch.aten.rand_like %x, %none, %none, %none, %none, %none : !torch.vtensor<[2,3],f32>, !torch.none, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[2,3],f32>
+    %3 = torch.aten.mul.Tensor %1, %2 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+    torch.prim.Loop.condition %true, iter(%3 : !torch.vtensor<[2,3],f32>)
+  } : (!torch.int, !torch.bool, !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// The mask computed in both branches is hoisted out of the `prim.If`, and then
+// out of the loop. The mask computed in one branch only is not.
+// CHECK-LABEL:   func.func @hoist_common_ops(
+// CHECK-SAME:                                %[[X:.*]]: !torch.vtensor<[2,3],f32>, %[[B:.*]]: !torch.bool,
+// CHECK:           %[[MASK:.*]] = torch.aten.gt.Scalar %[[X]]
+// CHECK:           torch.prim.Loop
+// CHECK:             torch.prim.If %[[B]]
+// CHECK-NOT:           torch.aten.gt.Scalar
+// CHECK:               torch.aten.where.self %[[MASK]]
+// CHECK:             } else {
+// CHECK:               torch.aten.lt.Scalar
+// CHECK:               torch.aten.where.self %[[MASK]]
+func.func @hoist_common_ops(%x: !torch.vtensor<[2,3],f32>, %b: !torch.bool) -> !torch.vtensor<[2,3],f32> {
+  %true = torch.constant.bool true
+  %int0 = torch.constant.int 0
+  %int4 = torch.constant.int 4
+  %0 = torch.prim.Loop %int4, %true, init(%x) {
+  ^bb0(%i: !torch.int, %acc: !torch.vtensor<[2,3],f32>):
+    %1 = torch.prim.If %b -> (!torch.vtensor<[2,3],f32>) {
+      %mask = torch.aten.gt.Scalar %x, %int0 : !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],i1>
+      %2 = torch.aten.where.self %mask, %acc, %x : !torch.vtensor<[2,3],i1>, !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+      torch.prim.If.yield %2 : !torch.vtensor<[2,3],f32>
+    } else {
+      %mask = torch.aten.gt.Scalar %x, %int0 : !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],i1>
+      %lt = torch.aten.lt.Scalar %x, %int0 : !torch.vtensor<[2,3],f32>, !torch.int -> !torch.vtensor<[2,3],i1>
+      %2 = torch.aten.where.self %mask, %x, %acc : !torch.vtensor<[2,3],i1>, !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+      %3 = torch.aten.where.self %lt, %2, %acc : !torch.vtensor<[2,3],i1>, !torch.vtensor<[2,3],f32>, !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+      torch.prim.If.yield %3 : !torch.vtensor<[2,3],f32>
+    }
+    torch.prim.Loop.condition %true, iter(%1 : !torch.vtensor<[2,3],f32>)
+  } : (!torch.int, !torch.bool, !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32>
+  return %0 : !torch.vtensor<[2,3],f32>
+}
+
+// -----
+
+// The loop may not run at all, so only the ops that cannot fail are hoisted.
+// CHECK-LABEL:   func.func @hoist_non_failing_ops(
+// CHECK:           torch.aten.add.int
+// CHECK:           torch.prim.Loop
+// CHECK:             torch.aten.__getitem__.t
+// CHECK:             torch.aten.floordiv.int
+// CHECK:             torch.aten.select.int
+func.func @hoist_non_failing_ops(%x: !torch.vtensor<[4,3],f32>, %list: !torch.list<int>, %n: !torch.int, %k: !torch.int) -> !torch.vtensor<[3],f32> {
+  %true = torch.constant.bool true
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %0 = torch.prim.Loop %n, %true, init(%x) {
+  ^bb0(%i: !torch.int, %acc: !torch.vtensor<[4,3],f32>):
+    %1 = torch.aten.add.int %n, %int1 : !torch.int, !torch.int -> !torch.int
+    %2 = torch.aten.__getitem__.t %list, %int0 : !torch.list<int>, !torch.int -> !torch.int
+    %3 = torch.aten.floordiv.int %1, %k : !torch.int, !torch.int -> !torch.int
+    %4 = torch.aten.select.int %x, %int0, %3 : !torch.vtensor<[4,3],f32>, !torch.int, !torch.int -> !torch.vtensor<[3],f32>
+    %5 = torch.aten.add.Tensor %acc, %4, %int1 : !torch.vtensor<[4,3],f32>, !torch.vtensor<[3],f32>, !torch.int -> !torch.vtensor<[4,3],f32>
+    torch.prim.Loop.condition %true, iter(%5 : !torch.vtensor<[4,3],f32>)
+  } : (!torch.int, !torch.bool, !torch.vtensor<[4,3],f32>) -> !torch.vtensor<[4,3],f32>
+  %6 = torch.aten.select.int %0, %int0, %int0 : !torch.vtensor<[4,3],f32>, !torch.int, !torch.int -> !torch.vtensor<[3],f32>
+  return %6 : !torch.vtensor<[3],f32>
+}
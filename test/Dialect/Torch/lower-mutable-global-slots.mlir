@@ -0,0 +1,89 @@
+// RUN: torch-mlir-opt -torch-lower-mutable-global-slots -split-input-file -verify-diagnostics %s | FileCheck %s
+
+// CHECK-LABEL:   torch.global_slot "private" @cache : !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[INIT:.*]] = torch.vtensor.literal(dense<0.000000e+00> : tensor<2x3xf32>) : !torch.vtensor<[2,3],f32>
+// CHECK:           torch.global_slot.init %[[INIT]] : !torch.vtensor<[2,3],f32>
+// CHECK:         }
+torch.global_slot "private" @cache : !torch.tensor {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<2x3xf32>) : !torch.tensor<[2,3],f32>
+  torch.global_slot.init %0 : !torch.tensor<[2,3],f32>
+}
+
+// CHECK-LABEL:   func.func @mutated_in_place(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.tensor) -> !torch.tensor {
+// CHECK:           %[[VALUE:.*]] = torch.global_slot.get @cache : !torch.vtensor<[2,3],f32>
+// CHECK:           %[[OBJECT:.*]] = torch.copy.to_tensor %[[VALUE]] : !torch.tensor<[2,3],f32>
+// CHECK:           %[[CAST:.*]] = torch.tensor_static_info_cast %[[OBJECT]] : !torch.tensor<[2,3],f32> to !torch.tensor
+// CHECK:           %[[INT1:.*]] = torch.constant.int 1
+// CHECK:           %[[ADD:.*]] = torch.aten.add_.Tensor %[[CAST]], %[[ARG]], %[[INT1]] : !torch.tensor, !torch.tensor, !torch.int -> !torch.tensor
+// CHECK-NOT:       torch.global_slot.get
+// CHECK:           %[[CAST2:.*]] = torch.tensor_static_info_cast %[[OBJECT]] : !torch.tensor<[2,3],f32> to !torch.tensor
+// CHECK:           %[[NEW_VALUE:.*]] = torch.copy.to_vtensor %[[OBJECT]] : !torch.vtensor<[2,3],f32>
+// CHECK:           torch.global_slot.set @cache = %[[NEW_VALUE]] : !torch.vtensor<[2,3],f32>
+// CHECK:           return %[[CAST2]] : !torch.tensor
+func.func @mutated_in_place(%arg0: !torch.tensor) -> !torch.tensor {
+  %0 = torch.global_slot.get @cache : !torch.tensor
+  %int1 = torch.constant.int 1
+  %1 = torch.aten.add_.Tensor %0, %arg0, %int1 : !torch.tensor, !torch.tensor, !torch.int -> !torch.tensor
+  %2 = torch.global_slot.get @cache : !torch.tensor
+  return %2 : !torch.tensor
+}
+
+// -----
+
+torch.global_slot "private" @state : !torch.tensor {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<4xf32>) : !torch.tensor<[4],f32>
+  torch.global_slot.init %0 : !torch.tensor<[4],f32>
+}
+
+// CHECK-LABEL:   func.func @set(
+// CHECK-SAME:            %[[ARG:.*]]: !torch.tensor) -> !torch.tensor {
+// CHECK-NOT:       torch.global_slot.get
+// CHECK:           %[[VALUE:.*]] = torch.copy.to_vtensor %[[ARG]] : !torch.vtensor
+// CHECK:           %[[CAST:.*]] = torch.tensor_static_info_cast %[[VALUE]] : !torch.vtensor to !torch.vtensor<[4],f32>
+// CHECK:           torch.global_slot.set @state = %[[CAST]] : !torch.vtensor<[4],f32>
+// CHECK:           return %[[ARG]] : !torch.tensor
+func.func @set(%arg0: !torch.tensor) -> !torch.tensor {
+  torch.global_slot.set @state = %arg0 : !torch.tensor
+  %0 = torch.global_slot.get @state : !torch.tensor
+  return %0 : !torch.tensor
+}
+
+// CHECK-LABEL:   func.func @read(
+// CHECK:           %[[VALUE:.*]] = torch.global_slot.get @state : !torch.vtensor<[4],f32>
+// CHECK:           %[[OBJECT:.*]] = torch.copy.to_tensor %[[VALUE]] : !torch.tensor<[4],f32>
+// CHECK:           %[[CAST:.*]] = torch.tensor_static_info_cast %[[OBJECT]] : !torch.tensor<[4],f32> to !torch.tensor
+// CHECK:           torch.copy.to_vtensor
+// CHECK:           torch.global_slot.set @state
+// CHECK:           return %[[CAST]] : !torch.tensor
+func.func @read() -> !torch.tensor {
+  %0 = torch.global_slot.get @state : !torch.tensor
+  return %0 : !torch.tensor
+}
+
+// -----
+
+// expected-error @+1 {{unimplemented: tensor global slot not initialized with a tensor literal}}
+torch.global_slot "private" @computed : !torch.tensor {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<4xf32>) : !torch.tensor<[4],f32>
+  %1 = torch.aten.relu %0 : !torch.tensor<[4],f32> -> !torch.tensor
+  torch.global_slot.init %1 : !torch.tensor
+}
+
+// -----
+
+torch.global_slot "private" @branchy : !torch.tensor {
+  %0 = torch.tensor.literal(dense<0.0> : tensor<4xf32>) : !torch.tensor<[4],f32>
+  torch.global_slot.init %0 : !torch.tensor<[4],f32>
+}
+
+func.func @in_region(%arg0: !torch.bool, %arg1: !torch.tensor) {
+  torch.prim.If %arg0 -> () {
+    // expected-error @+1 {{unimplemented: tensor global slot accessed outside of the entry block of its function}}
+    torch.global_slot.set @branchy = %arg1 : !torch.tensor
+    torch.prim.If.yield
+  } else {
+    torch.prim.If.yield
+  }
+  return
+}
@@ -91,7 +91,7 @@ func.func @unmodeled_mutation(%arg0: !torch.vtensor, %arg1: !torch.vtensor) -> !
   return %result : !torch.vtensor
 }
 
-// We don't yet handle nontrivial cases involving control flow.
+// We don't yet handle overwrites nested in regions.
 // CHECK-LABEL:   func.func @unimplemented_control_flow(
 // CHECK:           torch.copy.to_vtensor
 func.func @unimplemented_control_flow(%arg0: !torch.vtensor, %arg1: !torch.vtensor, %cond: !torch.bool) -> (!torch.vtensor, !torch.vtensor) {
@@ -107,6 +107,43 @@ func.func @unimplemented_control_flow(%arg0: !torch.vtensor, %arg1: !torch.vtens
   return %equal_to_arg0, %equal_to_arg1 : !torch.vtensor, !torch.vtensor
 }
 
+// Reads and views in regions see the contents at the point of the region op.
+// CHECK-LABEL:   func.func @reads_in_regions(
+// CHECK-SAME:                               %[[ARG0:.*]]: !torch.vtensor, %[[ARG1:.*]]: !torch.vtensor, %[[COND:.*]]: !torch.bool) -> (!torch.vtensor, !torch.vtensor) {
+// CHECK-NOT:       torch.copy
+// CHECK:           %[[IF:.*]] = torch.prim.If %[[COND]] -> (!torch.vtensor) {
+// CHECK:             torch.prim.If.yield %[[ARG0]] : !torch.vtensor
+// CHECK:           } else {
+// CHECK:             %[[UNSQUEEZE:.*]] = torch.aten.unsqueeze %[[ARG0]], %{{.*}} : !torch.vtensor, !torch.int -> !torch.vtensor
+// CHECK:             torch.prim.If.yield %[[UNSQUEEZE]] : !torch.vtensor
+// CHECK:           }
+// CHECK:           torch.prim.Loop
+// CHECK:             "test.use"(%[[ARG1]]) : (!torch.vtensor) -> ()
+// CHECK-NOT:       torch.overwrite.tensor.contents
+// CHECK:           return %[[IF]], %[[ARG1]] : !torch.vtensor, !torch.vtensor
+func.func @reads_in_regions(%arg0: !torch.vtensor, %arg1: !torch.vtensor, %cond: !torch.bool) -> (!torch.vtensor, !torch.vtensor) {
+  %int0 = torch.constant.int 0
+  %true = torch.constant.bool true
+  %tensor = torch.copy.to_tensor %arg0 : !torch.tensor
+  %0 = torch.prim.If %cond -> (!torch.vtensor) {
+    %equal_to_arg0 = torch.copy.to_vtensor %tensor : !torch.vtensor
+    torch.prim.If.yield %equal_to_arg0 : !torch.vtensor
+  } else {
+    %view = torch.aten.unsqueeze %tensor, %int0 : !torch.tensor, !torch.int -> !torch.tensor
+    %view_of_arg0 = torch.copy.to_vtensor %view : !torch.vtensor
+    torch.prim.If.yield %view_of_arg0 : !torch.vtensor
+  }
+  torch.overwrite.tensor.contents %arg1 overwrites %tensor : !torch.vtensor, !torch.tensor
+  torch.prim.Loop %int0, %true, init() {
+  ^bb0(%iv: !torch.int):
+    %equal_to_arg1 = torch.copy.to_vtensor %tensor : !torch.vtensor
+    "test.use"(%equal_to_arg1) : (!torch.vtensor) -> ()
+    torch.prim.Loop.condition %true, iter()
+  } : (!torch.int, !torch.bool) -> ()
+  %1 = torch.copy.to_vtensor %tensor : !torch.vtensor
+  return %0, %1 : !torch.vtensor, !torch.vtensor
+}
+
 // CHECK-LABEL:   func.func @non_value_tensor_returned(
 // CHECK-SAME:                                    %[[VALUE_T:.*]]: !torch.vtensor) -> !torch.tensor {
 // CHECK:           %[[T:.*]] = torch.copy.to_tensor %[[VALUE_T]] : !torch.tensor
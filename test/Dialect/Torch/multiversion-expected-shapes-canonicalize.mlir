@@ -0,0 +1,15 @@
+// RUN: torch-mlir-opt -pass-pipeline='func.func(torch-multiversion-expected-shapes,torch-reduce-op-variants,canonicalize)' %s | FileCheck %s
+
+// The canonicalizations that follow the pass in the backend pipeline keep
+// the specialized version static.
+// CHECK-LABEL:   func.func @expected_shapes(
+// CHECK-SAME:                               %[[X:.*]]: !torch.vtensor<[?,3],f32>) -> !torch.vtensor {
+// CHECK:           torch.prim.If
+// CHECK:             %[[X_STATIC:.*]] = torch.tensor_static_info_cast %[[X]] : !torch.vtensor<[?,3],f32> to !torch.vtensor<[8,3],f32>
+// CHECK:             torch.aten.tanh %[[X_STATIC]] : !torch.vtensor<[8,3],f32> -> !torch.vtensor
+// CHECK:           } else {
+// CHECK:             torch.aten.tanh %[[X]] : !torch.vtensor<[?,3],f32> -> !torch.vtensor
+func.func @expected_shapes(%arg0: !torch.vtensor<[?,3],f32> {torch.expected_shape = [8, 3]}) -> !torch.vtensor {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor<[?,3],f32> -> !torch.vtensor
+  return %0 : !torch.vtensor
+}
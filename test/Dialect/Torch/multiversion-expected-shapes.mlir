@@ -0,0 +1,73 @@
+// RUN: torch-mlir-opt -torch-multiversion-expected-shapes -split-input-file -verify-diagnostics %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @expected_shapes(
+// CHECK-SAME:                               %[[X:.*]]: !torch.vtensor<[?,3],f32>, %[[Y:.*]]: !torch.vtensor<[?,?],f32>) -> !torch.vtensor {
+// CHECK:           %[[INT0:.*]] = torch.constant.int 0
+// CHECK:           %[[X_SIZE0:.*]] = torch.aten.size.int %[[X]], %[[INT0]] : !torch.vtensor<[?,3],f32>, !torch.int -> !torch.int
+// CHECK:           %[[INT8:.*]] = torch.constant.int 8
+// CHECK:           %[[X_EQ0:.*]] = torch.aten.eq.int %[[X_SIZE0]], %[[INT8]] : !torch.int, !torch.int -> !torch.bool
+// CHECK:           %[[Y_SIZE0:.*]] = torch.aten.size.int %[[Y]], %{{.*}} : !torch.vtensor<[?,?],f32>, !torch.int -> !torch.int
+// CHECK:           %[[Y_EQ0:.*]] = torch.aten.eq.int %[[Y_SIZE0]], %{{.*}} : !torch.int, !torch.int -> !torch.bool
+// CHECK:           %[[AND0:.*]] = torch.prim.If %[[X_EQ0]] -> (!torch.bool) {
+// CHECK:             torch.prim.If.yield %[[Y_EQ0]] : !torch.bool
+// CHECK:           } else {
+// CHECK:             %[[FALSE:.*]] = torch.constant.bool false
+// CHECK:             torch.prim.If.yield %[[FALSE]] : !torch.bool
+// CHECK:           }
+// CHECK:           %[[Y_SIZE1:.*]] = torch.aten.size.int %[[Y]], %{{.*}} : !torch.vtensor<[?,?],f32>, !torch.int -> !torch.int
+// CHECK:           %[[Y_EQ1:.*]] = torch.aten.eq.int %[[Y_SIZE1]], %{{.*}} : !torch.int, !torch.int -> !torch.bool
+// CHECK:           %[[AND1:.*]] = torch.prim.If %[[AND0]] -> (!torch.bool) {
+// CHECK:             torch.prim.If.yield %[[Y_EQ1]] : !torch.bool
+// CHECK:           } else {
+// CHECK:           %[[RESULT:.*]] = torch.prim.If %[[AND1]] -> (!torch.vtensor) {
+// CHECK:             %[[X_STATIC:.*]] = torch.tensor_static_info_cast %[[X]] : !torch.vtensor<[?,3],f32> to !torch.vtensor<[8,3],f32>
+// CHECK:             %[[Y_STATIC:.*]] = torch.tensor_static_info_cast %[[Y]] : !torch.vtensor<[?,?],f32> to !torch.vtensor<[3,4],f32>
+// CHECK:             %[[MM:.*]] = torch.aten.mm %[[X_STATIC]], %[[Y_STATIC]] : !torch.vtensor<[8,3],f32>, !torch.vtensor<[3,4],f32> -> !torch.vtensor
+// CHECK:             torch.prim.If.yield %[[MM]] : !torch.vtensor
+// CHECK:           } else {
+// CHECK:             %[[GENERIC_MM:.*]] = torch.aten.mm %[[X]], %[[Y]] : !torch.vtensor<[?,3],f32>, !torch.vtensor<[?,?],f32> -> !torch.vtensor
+// CHECK:             torch.prim.If.yield %[[GENERIC_MM]] : !torch.vtensor
+// CHECK:           }
+// CHECK:           return %[[RESULT]] : !torch.vtensor
+func.func @expected_shapes(%arg0: !torch.vtensor<[?,3],f32> {torch.expected_shape = [8, 3]}, %arg1: !torch.vtensor<[?,?],f32> {torch.expected_shape = [3, 4]}) -> !torch.vtensor {
+  %0 = torch.aten.mm %arg0, %arg1 : !torch.vtensor<[?,3],f32>, !torch.vtensor<[?,?],f32> -> !torch.vtensor
+  return %0 : !torch.vtensor
+}
+
+// -----
+
+// The users that don't allow refining their types, like the return of the
+// argument itself, read it cast back to its original type.
+// CHECK-LABEL:   func.func @cast_back(
+// CHECK-SAME:                         %[[X:.*]]: !torch.vtensor<[?,3],f32>) -> (!torch.vtensor, !torch.vtensor<[?,3],f32>) {
+// CHECK:           torch.prim.If %{{.*}} -> (!torch.vtensor, !torch.vtensor<[?,3],f32>) {
+// CHECK:             %[[X_STATIC:.*]] = torch.tensor_static_info_cast %[[X]] : !torch.vtensor<[?,3],f32> to !torch.vtensor<[8,3],f32>
+// CHECK:             %[[X_DYNAMIC:.*]] = torch.tensor_static_info_cast %[[X_STATIC]] : !torch.vtensor<[8,3],f32> to !torch.vtensor<[?,3],f32>
+// CHECK:             %[[TANH:.*]] = torch.aten.tanh %[[X_STATIC]] : !torch.vtensor<[8,3],f32> -> !torch.vtensor
+// CHECK:             torch.prim.If.yield %[[TANH]], %[[X_DYNAMIC]] : !torch.vtensor, !torch.vtensor<[?,3],f32>
+func.func @cast_back(%arg0: !torch.vtensor<[?,3],f32> {torch.expected_shape = [8, 3]}) -> (!torch.vtensor, !torch.vtensor<[?,3],f32>) {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor<[?,3],f32> -> !torch.vtensor
+  return %0, %arg0 : !torch.vtensor, !torch.vtensor<[?,3],f32>
+}
+
+// -----
+
+// An expected shape that is already the static shape of the argument doesn't
+// add a version.
+// CHECK-LABEL:   func.func @already_static(
+// CHECK-SAME:                              %[[X:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.vtensor {
+// CHECK-NOT:       torch.prim.If
+// CHECK:           %[[TANH:.*]] = torch.aten.tanh %[[X]]
+// CHECK:           return %[[TANH]] : !torch.vtensor
+func.func @already_static(%arg0: !torch.vtensor<[2,3],f32> {torch.expected_shape = [2, 3]}) -> !torch.vtensor {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor<[2,3],f32> -> !torch.vtensor
+  return %0 : !torch.vtensor
+}
+
+// -----
+
+// expected-error @+1 {{expected shape of argument 0 doesn't match its static sizes}}
+func.func @mismatched_static_size(%arg0: !torch.vtensor<[?,3],f32> {torch.expected_shape = [8, 4]}) -> !torch.vtensor {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor<[?,3],f32> -> !torch.vtensor
+  return %0 : !torch.vtensor
+}
@@ -7,6 +7,14 @@ func.func @torch.operator(%arg0: !torch.tensor, %arg1: !torch.tensor) -> !torch.
   return %0 : !torch.tensor
 }
 
+// CHECK-LABEL:   func.func @torch.per_channel_affine.create(
+func.func @torch.per_channel_affine.create(%arg0: !torch.tensor<[2,3],si8>, %arg1: !torch.tensor<[2],f64>, %arg2: !torch.tensor<[2],si64>) -> !torch.tensor<[2,3],!torch.qint8> {
+  %int0 = torch.constant.int 0
+  // CHECK: torch.per_channel_affine.create %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}} : !torch.tensor<[2,3],si8>, !torch.tensor<[2],f64>, !torch.tensor<[2],si64>, !torch.int -> !torch.tensor<[2,3],!torch.qint8>
+  %0 = torch.per_channel_affine.create %arg0, %arg1, %arg2, %int0 : !torch.tensor<[2,3],si8>, !torch.tensor<[2],f64>, !torch.tensor<[2],si64>, !torch.int -> !torch.tensor<[2,3],!torch.qint8>
+  return %0 : !torch.tensor<[2,3],!torch.qint8>
+}
+
 func.func @torch.linear_params.create(%arg0: !torch.tensor, %arg1: !torch.tensor) -> (!torch.LinearParams, !torch.LinearParams) {
   %with_bias = torch.linear_params.create %arg0, %arg1 : !torch.tensor, !torch.tensor
   %without_bias = torch.linear_params.create %arg0 : !torch.tensor
@@ -27,6 +35,8 @@ func.func private @tensor.ranked() -> !torch.tensor<[?,?,?],unk>
 func.func private @tensor.some_sizes_known() -> !torch.tensor<[?,2,?,4],unk>
 // CHECK: @tensor.fully_determined() -> !torch.vtensor<[1,2,3,4],f32>
 func.func private @tensor.fully_determined() -> !torch.vtensor<[1,2,3,4],f32>
+// CHECK: @tensor.sparse() -> !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{{.*}}"dense", "compressed"{{.*}}>>
+func.func private @tensor.sparse() -> !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>
 
 // CHECK: @tuple.empty() -> !torch.tuple<>
 func.func private @tuple.empty() -> !torch.tuple<>
@@ -61,6 +71,20 @@ func.func @torch.vtensor.literal() {
   return
 }
 
+// CHECK-LABEL:   func.func @torch.vtensor.literal$sparse() {
+func.func @torch.vtensor.literal$sparse() {
+  // CHECK: torch.vtensor.literal(sparse<{{\[}}[0, 1], [2, 3]], [1.000000e+00, 2.000000e+00]> : tensor<4x8xf32, #sparse_tensor.encoding<{{.*}}>>) : !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{{.*}}>>
+  %0 = torch.vtensor.literal(sparse<[[0, 1], [2, 3]], [1.0, 2.0]> : tensor<4x8xf32, #sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>) : !torch.vtensor<[4,8],f32,#sparse_tensor.encoding<{dimLevelType = ["dense", "compressed"]}>>
+  return
+}
+
+// CHECK-LABEL:   func.func @torch.vtensor.external_literal() {
+func.func @torch.vtensor.external_literal() {
+  // CHECK: torch.vtensor.external_literal "weights.bin", 4096 : !torch.vtensor<[3,2],f32>
+  %0 = torch.vtensor.external_literal "weights.bin", 4096 : !torch.vtensor<[3,2],f32>
+  return
+}
+
 func.func @derefine(%arg0: !torch.tensor) -> !torch.optional<tensor> {
   %0 = torch.derefine %arg0 : !torch.tensor to !torch.optional<tensor>
   return %0 : !torch.optional<tensor>
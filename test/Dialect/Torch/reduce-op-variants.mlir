@@ -89,7 +89,7 @@ func.func @convert_to_value_semantic_tensors_optional(%t: !torch.tensor,
 // CHECK:           %[[C1:.*]] = torch.constant.int 1
 // CHECK:           %[[TENSOR0:.*]] = torch.copy.to_vtensor %[[ARG0]] : !torch.vtensor<[2,2],f32>
 // CHECK:           %[[TENSOR1:.*]] = torch.copy.to_vtensor %[[ARG1]] : !torch.vtensor<[2,2],f32>
-// CHECK:           %[[TENSOR_RESULT:.*]] = torch.aten.add.Tensor %[[TENSOR0]], %[[TENSOR1]], %[[C1]] : !torch.vtensor<[2,2],f32>, !torch.vtensor<[2,2],f32>, !torch.int -> !torch.vtensor<[2,2],f32>
+// CHECK:           %[[TENSOR_RESULT:.*]] = torch.aten.add.Tensor %[[TENSOR0]], %[[TENSOR1]], %[[C1]] {torch.inplace} : !torch.vtensor<[2,2],f32>, !torch.vtensor<[2,2],f32>, !torch.int -> !torch.vtensor<[2,2],f32>
 // Note: This somewhat redundant conversion back and forth
 // (which is cleaned up by canonicalization) is an artifact of two patterns
 // being applied in sequence.
@@ -134,7 +134,7 @@ func.func @convert_to_value_semantic_tensors_optional_list(%self: !torch.tensor<
 // CHECK-SAME:         %[[T:.*]]: !torch.tensor, %[[MIN:.*]]: !torch.float, %[[MAX:.*]]: !torch.float,
 // CHECK-SAME:         %[[GENERATOR:.*]]: !torch.none) -> !torch.tensor {
 // CHECK:           %[[T_VTENSOR:.*]] = torch.copy.to_vtensor %[[T]] : !torch.vtensor
-// CHECK:           %[[VRET:.*]] = torch.valsem.aten.uniform %[[T_VTENSOR]], %[[MIN]], %[[MAX]], %[[GENERATOR]] :
+// CHECK:           %[[VRET:.*]] = torch.valsem.aten.uniform %[[T_VTENSOR]], %[[MIN]], %[[MAX]], %[[GENERATOR]] {torch.inplace} :
 // CHECK-SAME:         !torch.vtensor, !torch.float, !torch.float, !torch.none -> !torch.vtensor
 // CHECK:           %[[RET:.*]] = torch.copy.to_tensor %[[VRET]] : !torch.tensor
 // CHECK:           %[[COPY_VTENSOR:.*]] = torch.copy.to_vtensor %[[RET]] : !torch.vtensor
@@ -150,7 +150,7 @@ func.func @torch.aten.uniform_(%t: !torch.tensor, %min: !torch.float, %max: !tor
 // CHECK:           %[[GENERATOR:.*]] = torch.constant.none
 // CHECK:           %[[P:.*]] = torch.constant.float 5.000000e-01
 // CHECK:           %[[T_VTENSOR:.*]] = torch.copy.to_vtensor %[[T]] : !torch.vtensor
-// CHECK:           %[[VRET:.*]] = torch.valsem.aten.bernoulli.float %[[T_VTENSOR]], %[[P]], %[[GENERATOR]] : !torch.vtensor, !torch.float, !torch.none -> !torch.vtensor
+// CHECK:           %[[VRET:.*]] = torch.valsem.aten.bernoulli.float %[[T_VTENSOR]], %[[P]], %[[GENERATOR]] {torch.inplace} : !torch.vtensor, !torch.float, !torch.none -> !torch.vtensor
 // CHECK:           %[[RET:.*]] = torch.copy.to_tensor %[[VRET]] : !torch.tensor
 // CHECK:           %[[COPY_VTENSOR:.*]] = torch.copy.to_vtensor %[[RET]] : !torch.vtensor
 // CHECK:           torch.overwrite.tensor.contents %[[COPY_VTENSOR]] overwrites %[[T]] : !torch.vtensor, !torch.tensor
@@ -166,7 +166,7 @@ func.func @torch.aten.bernoulli_.float(%t: !torch.tensor) -> !torch.tensor {
 // CHECK-SAME:                                  %[[T:.*]]: !torch.tensor) -> !torch.tensor {
 // CHECK:           %[[VALUE:.*]] = torch.constant.int 1
 // CHECK:           %[[T_VTENSOR:.*]] = torch.copy.to_vtensor %[[T]] : !torch.vtensor
-// CHECK:           %[[VRET:.*]] = torch.valsem.aten.fill.Scalar %[[T_VTENSOR]], %[[VALUE]] : !torch.vtensor, !torch.int -> !torch.vtensor
+// CHECK:           %[[VRET:.*]] = torch.valsem.aten.fill.Scalar %[[T_VTENSOR]], %[[VALUE]] {torch.inplace} : !torch.vtensor, !torch.int -> !torch.vtensor
 // CHECK:           %[[RET:.*]] = torch.copy.to_tensor %[[VRET]] : !torch.tensor
 // CHECK:           %[[COPY_VTENSOR:.*]] = torch.copy.to_vtensor %[[RET]] : !torch.vtensor
 // CHECK:           torch.overwrite.tensor.contents %[[COPY_VTENSOR]] overwrites %[[T]] : !torch.vtensor, !torch.tensor
@@ -186,7 +186,7 @@ func.func @torch.aten.fill_.Scalar(%t: !torch.tensor) -> !torch.tensor {
 // CHECK:           %[[INDEX_VTENSOR:.*]] = torch.copy.to_vtensor %[[INDEX]] : !torch.vtensor
 // CHECK:           %[[INDICES_LIST:.*]] = torch.prim.ListConstruct %[[INDEX_VTENSOR]] : (!torch.vtensor) -> !torch.list<vtensor>
 // CHECK:           %[[VALUES_VTENSOR:.*]] = torch.copy.to_vtensor %[[VALUES]] : !torch.vtensor
-// CHECK:           %[[VRET:.*]] = torch.valsem.aten.index_put_impl %[[SELF_VTENSOR]], %[[INDICES_LIST]], %[[VALUES_VTENSOR]], %[[TRUE]], %[[FALSE]] : !torch.vtensor, !torch.list<vtensor>, !torch.vtensor, !torch.bool, !torch.bool -> !torch.vtensor
+// CHECK:           %[[VRET:.*]] = torch.valsem.aten.index_put_impl %[[SELF_VTENSOR]], %[[INDICES_LIST]], %[[VALUES_VTENSOR]], %[[TRUE]], %[[FALSE]] {torch.inplace} : !torch.vtensor, !torch.list<vtensor>, !torch.vtensor, !torch.bool, !torch.bool -> !torch.vtensor
 // CHECK:           %[[RET:.*]] = torch.copy.to_tensor %[[VRET]] : !torch.tensor
 // CHECK:           %[[COPY_VTENSOR:.*]] = torch.copy.to_vtensor %[[RET]] : !torch.vtensor
 // CHECK:           torch.overwrite.tensor.contents %[[COPY_VTENSOR]] overwrites %[[SELF]] : !torch.vtensor, !torch.tensor
@@ -205,7 +205,7 @@ func.func @torch.aten._index_put_impl_(%self: !torch.tensor, %index: !torch.tens
 // CHECK:           %[[FALSE:.*]] = torch.constant.bool false
 // CHECK:           %[[DST_VTENSOR:.*]] = torch.copy.to_vtensor %[[DST]] : !torch.vtensor
 // CHECK:           %[[SRC_VTENSOR:.*]] = torch.copy.to_vtensor %[[SRC]] : !torch.vtensor
-// CHECK:           %[[VRET:.*]] = torch.valsem.aten.copy %[[DST_VTENSOR]], %[[SRC_VTENSOR]], %[[FALSE]] : !torch.vtensor, !torch.vtensor, !torch.bool -> !torch.vtensor
+// CHECK:           %[[VRET:.*]] = torch.valsem.aten.copy %[[DST_VTENSOR]], %[[SRC_VTENSOR]], %[[FALSE]] {torch.inplace} : !torch.vtensor, !torch.vtensor, !torch.bool -> !torch.vtensor
 // CHECK:           %[[RET:.*]] = torch.copy.to_tensor %[[VRET]] : !torch.tensor
 // CHECK:           %[[COPY_VTENSOR:.*]] = torch.copy.to_vtensor %[[RET]] : !torch.vtensor
 // CHECK:           torch.overwrite.tensor.contents %[[COPY_VTENSOR]] overwrites %[[DST]] : !torch.vtensor, !torch.tensor
@@ -215,3 +215,85 @@ func.func @torch.aten.copy_(%dst: !torch.tensor, %src : !torch.tensor) -> !torch
   %ret = torch.aten.copy_ %dst, %src, %false : !torch.tensor, !torch.tensor, !torch.bool -> !torch.tensor
   return %ret : !torch.tensor
 }
+
+// A copy into a slice of a tensor scatters the copied slice into the tensor.
+// CHECK-LABEL:   func.func @torch.aten.copy_$into_slice(
+// CHECK-SAME:                          %[[X:.*]]: !torch.tensor,
+// CHECK-SAME:                          %[[Y:.*]]: !torch.tensor,
+// CHECK-SAME:                          %[[I:.*]]: !torch.int) {
+// CHECK:           %[[INT0:.*]] = torch.constant.int 0
+// CHECK:           %[[INT1:.*]] = torch.constant.int 1
+// CHECK:           %[[NONE:.*]] = torch.constant.none
+// CHECK:           %[[X_VTENSOR:.*]] = torch.copy.to_vtensor %[[X]] : !torch.vtensor
+// CHECK:           %[[SLICE:.*]] = torch.aten.slice.Tensor %[[X_VTENSOR]], %[[INT0]], %[[NONE]], %[[NONE]], %[[INT1]] : !torch.vtensor, !torch.int, !torch.none, !torch.none, !torch.int -> !torch.vtensor
+// CHECK:           %[[SELECT:.*]] = torch.aten.select.int %[[SLICE]], %[[INT1]], %[[I]] : !torch.vtensor, !torch.int, !torch.int -> !torch.vtensor
+// CHECK:           %[[Y_VTENSOR:.*]] = torch.copy.to_vtensor %[[Y]] : !torch.vtensor
+// CHECK:           %[[COPY:.*]] = torch.valsem.aten.copy %[[SELECT]], %[[Y_VTENSOR]], %{{.*}} : !torch.vtensor, !torch.vtensor, !torch.bool -> !torch.vtensor
+// CHECK:           %[[SELECT_SCATTER:.*]] = torch.aten.select_scatter %[[SLICE]], %[[COPY]], %[[INT1]], %[[I]] : !torch.vtensor, !torch.vtensor, !torch.int, !torch.int -> !torch.vtensor
+// CHECK:           %[[SLICE_SCATTER:.*]] = torch.aten.slice_scatter %[[X_VTENSOR]], %[[SELECT_SCATTER]], %[[INT0]], %[[NONE]], %[[NONE]], %[[INT1]] {torch.inplace} : !torch.vtensor, !torch.vtensor, !torch.int, !torch.none, !torch.none, !torch.int -> !torch.vtensor
+// CHECK:           torch.overwrite.tensor.contents %[[SLICE_SCATTER]] overwrites %[[X]] : !torch.vtensor, !torch.tensor
+// CHECK-NOT:       torch.aten.copy_
+// CHECK:           return
+func.func @torch.aten.copy_$into_slice(%x: !torch.tensor, %y: !torch.tensor, %i: !torch.int) {
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %0 = torch.aten.slice.Tensor %x, %int0, %none, %none, %int1 : !torch.tensor, !torch.int, !torch.none, !torch.none, !torch.int -> !torch.tensor
+  %1 = torch.aten.select.int %0, %int1, %i : !torch.tensor, !torch.int, !torch.int -> !torch.tensor
+  %2 = torch.aten.copy_ %1, %y, %false : !torch.tensor, !torch.tensor, !torch.bool -> !torch.tensor
+  return
+}
+
+// CHECK-LABEL:   func.func @torch.aten.batch_norm$training(
+// CHECK-SAME:                          %[[INPUT:.*]]: !torch.tensor, %[[WEIGHT:.*]]: !torch.tensor, %[[BIAS:.*]]: !torch.tensor,
+// CHECK-SAME:                          %[[RUNNING_MEAN:.*]]: !torch.tensor, %[[RUNNING_VAR:.*]]: !torch.tensor) -> !torch.tensor {
+// CHECK:           %[[RUNNING_MEAN_VTENSOR:.*]] = torch.copy.to_vtensor %[[RUNNING_MEAN]] : !torch.vtensor
+// CHECK:           %[[RUNNING_VAR_VTENSOR:.*]] = torch.copy.to_vtensor %[[RUNNING_VAR]] : !torch.vtensor
+// CHECK:           %[[BN:.*]]:5 = torch.valsem.aten.native_batch_norm.functional %{{.*}}, %{{.*}}, %{{.*}}, %[[RUNNING_MEAN_VTENSOR]], %[[RUNNING_VAR_VTENSOR]], %{{.*}}, %{{.*}}, %{{.*}} : {{.*}} -> !torch.vtensor, !torch.vtensor<[?],unk>, !torch.vtensor<[?],unk>, !torch.vtensor, !torch.vtensor
+// CHECK:           %[[OUTPUT:.*]] = torch.copy.to_tensor %[[BN]]#0 : !torch.tensor
+// CHECK:           %[[NEW_RUNNING_MEAN:.*]] = torch.copy.to_tensor %[[BN]]#3 : !torch.tensor
+// CHECK:           %[[NEW_RUNNING_VAR:.*]] = torch.copy.to_tensor %[[BN]]#4 : !torch.tensor
+// CHECK:           %[[NEW_RUNNING_MEAN_VTENSOR:.*]] = torch.copy.to_vtensor %[[NEW_RUNNING_MEAN]] : !torch.vtensor
+// CHECK:           torch.overwrite.tensor.contents %[[NEW_RUNNING_MEAN_VTENSOR]] overwrites %[[RUNNING_MEAN]] : !torch.vtensor, !torch.tensor
+// CHECK:           %[[NEW_RUNNING_VAR_VTENSOR:.*]] = torch.copy.to_vtensor %[[NEW_RUNNING_VAR]] : !torch.vtensor
+// CHECK:           torch.overwrite.tensor.contents %[[NEW_RUNNING_VAR_VTENSOR]] overwrites %[[RUNNING_VAR]] : !torch.vtensor, !torch.tensor
+// CHECK:           return %[[OUTPUT]] : !torch.tensor
+func.func @torch.aten.batch_norm$training(%input: !torch.tensor, %weight: !torch.tensor, %bias: !torch.tensor, %running_mean: !torch.tensor, %running_var: !torch.tensor) -> !torch.tensor {
+  %true = torch.constant.bool true
+  %false = torch.constant.bool false
+  %momentum = torch.constant.float 1.000000e-01
+  %eps = torch.constant.float 1.000000e-05
+  %w = torch.derefine %weight : !torch.tensor to !torch.optional<tensor>
+  %b = torch.derefine %bias : !torch.tensor to !torch.optional<tensor>
+  %rm = torch.derefine %running_mean : !torch.tensor to !torch.optional<tensor>
+  %rv = torch.derefine %running_var : !torch.tensor to !torch.optional<tensor>
+  %ret = torch.aten.batch_norm %input, %w, %b, %rm, %rv, %true, %momentum, %eps, %false : !torch.tensor, !torch.optional<tensor>, !torch.optional<tensor>, !torch.optional<tensor>, !torch.optional<tensor>, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.tensor
+  return %ret : !torch.tensor
+}
+
+// CHECK-LABEL:   func.func @torch.aten.batch_norm$inference(
+// CHECK-NOT:       torch.valsem.aten.native_batch_norm.functional
+// CHECK-NOT:       torch.overwrite.tensor.contents
+// CHECK:           torch.aten.batch_norm
+func.func @torch.aten.batch_norm$inference(%input: !torch.tensor, %running_mean: !torch.tensor, %running_var: !torch.tensor) -> !torch.tensor {
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %momentum = torch.constant.float 1.000000e-01
+  %eps = torch.constant.float 1.000000e-05
+  %rm = torch.derefine %running_mean : !torch.tensor to !torch.optional<tensor>
+  %rv = torch.derefine %running_var : !torch.tensor to !torch.optional<tensor>
+  %ret = torch.aten.batch_norm %input, %none, %none, %rm, %rv, %false, %momentum, %eps, %false : !torch.tensor, !torch.none, !torch.none, !torch.optional<tensor>, !torch.optional<tensor>, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.tensor
+  return %ret : !torch.tensor
+}
+
+// CHECK-LABEL:   func.func @convert_to_value_semantic_tensors_custom_kernel(
+// CHECK-SAME:                                       %[[ARG:.*]]: !torch.tensor<[2],f32>) -> !torch.tensor<[2],f32> {
+// CHECK:           %[[OPERAND_TENSOR:.*]] = torch.copy.to_vtensor %[[ARG]] : !torch.vtensor<[2],f32>
+// CHECK:           %[[RESULT_TENSOR:.*]] = torch.operator "my_ops.gelu"(%[[OPERAND_TENSOR]]) {torch.custom_kernel = "my_ops_gelu"} : (!torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32>
+// CHECK:           %[[RET:.*]] = torch.copy.to_tensor %[[RESULT_TENSOR]] : !torch.tensor<[2],f32>
+// CHECK:           return %[[RET]] : !torch.tensor<[2],f32>
+func.func @convert_to_value_semantic_tensors_custom_kernel(%arg0: !torch.tensor<[2],f32>) -> !torch.tensor<[2],f32> {
+  %0 = torch.operator "my_ops.gelu"(%arg0) {torch.custom_kernel = "my_ops_gelu"} : (!torch.tensor<[2],f32>) -> !torch.tensor<[2],f32>
+  return %0 : !torch.tensor<[2],f32>
+}
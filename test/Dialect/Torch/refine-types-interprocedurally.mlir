@@ -0,0 +1,38 @@
+// RUN: torch-mlir-opt -torch-refine-types-interprocedurally -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func private @callee(
+// CHECK-SAME:                              %[[ARG:.*]]: !torch.vtensor<*,f32>) -> !torch.vtensor<*,f32> {
+// CHECK:           %[[ARG_ERASED:.*]] = torch.tensor_static_info_cast %[[ARG]] : !torch.vtensor<*,f32> to !torch.vtensor
+// CHECK:           %[[TANH:.*]] = torch.aten.tanh %[[ARG_ERASED]] : !torch.vtensor -> !torch.vtensor<*,f32>
+// CHECK:           return %[[TANH]] : !torch.vtensor<*,f32>
+func.func private @callee(%arg0: !torch.vtensor) -> !torch.vtensor {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor -> !torch.vtensor
+  return %0 : !torch.vtensor
+}
+
+// CHECK-LABEL:   func.func @caller(
+// CHECK-SAME:                      %[[ARG:.*]]: !torch.vtensor<*,f32>) -> !torch.vtensor {
+// CHECK:           %[[RESULT:.*]] = call @callee(%{{.*}}) : (!torch.vtensor<*,f32>) -> !torch.vtensor<*,f32>
+// CHECK:           torch.tensor_static_info_cast %[[RESULT]] : !torch.vtensor<*,f32> to !torch.vtensor
+func.func @caller(%arg0: !torch.vtensor<*,f32>) -> !torch.vtensor {
+  %0 = torch.tensor_static_info_cast %arg0 : !torch.vtensor<*,f32> to !torch.vtensor
+  %1 = call @callee(%0) : (!torch.vtensor) -> !torch.vtensor
+  return %1 : !torch.vtensor
+}
+
+// -----
+
+// Public functions can be called from outside the module, so nothing can be
+// assumed about their arguments.
+// CHECK-LABEL:   func.func @public_callee(
+// CHECK-SAME:                             %{{.*}}: !torch.vtensor) -> !torch.vtensor {
+func.func @public_callee(%arg0: !torch.vtensor) -> !torch.vtensor {
+  %0 = torch.aten.tanh %arg0 : !torch.vtensor -> !torch.vtensor
+  return %0 : !torch.vtensor
+}
+
+func.func @call_public(%arg0: !torch.vtensor<*,f32>) -> !torch.vtensor {
+  %0 = torch.tensor_static_info_cast %arg0 : !torch.vtensor<*,f32> to !torch.vtensor
+  %1 = call @public_callee(%0) : (!torch.vtensor) -> !torch.vtensor
+  return %1 : !torch.vtensor
+}
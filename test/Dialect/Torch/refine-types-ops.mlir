@@ -346,3 +346,15 @@ func.func @torch.aten.tensor$specified_dtype(%t: !torch.list<list<float>>) -> !t
   %ret = torch.aten.tensor %t, %int4, %none, %false : !torch.list<list<float>>, !torch.int, !torch.none, !torch.bool -> !torch.tensor
   return %ret : !torch.tensor
 }
+
+// -----
+// CHECK-LABEL:   func.func @custom_kernel(
+// CHECK-SAME:        %[[ARG:.*]]: !torch.vtensor<[2],f32>,
+// CHECK-SAME:        %[[SCALE:.*]]: !torch.int) -> !torch.vtensor {
+// CHECK:           %[[RET:.*]] = torch.operator "my_ops.scale"(%[[SCALE]], %[[ARG]]) {torch.custom_kernel = "my_ops_scale"} : (!torch.int, !torch.vtensor<[2],f32>) -> !torch.vtensor<*,f32>
+// CHECK:           %[[CAST:.*]] = torch.tensor_static_info_cast %[[RET]] : !torch.vtensor<*,f32> to !torch.vtensor
+// CHECK:           return %[[CAST]] : !torch.vtensor
+func.func @custom_kernel(%arg0: !torch.vtensor<[2],f32>, %scale: !torch.int) -> !torch.vtensor {
+  %ret = torch.operator "my_ops.scale"(%scale, %arg0) {torch.custom_kernel = "my_ops_scale"} : (!torch.int, !torch.vtensor<[2],f32>) -> !torch.vtensor
+  return %ret : !torch.vtensor
+}
@@ -406,3 +406,58 @@ func.func @basic_integration(%arg0: !torch.vtensor<[?,?],unk>) -> !torch.vtensor
   } : !torch.vtensor
   return %0 : !torch.vtensor
 }
+
+// Both shape calculations are structurally identical and capture values with
+// the same static information, so the simplified version of the first one is
+// reused for the second one.
+// CHECK-LABEL:   func.func @memoized_shape_calculations(
+// CHECK-SAME:                                         %[[ARG0:.*]]: !torch.vtensor<[2,3],f32>,
+// CHECK-SAME:                                         %[[ARG1:.*]]: !torch.vtensor<[2,3],f32>) -> (!torch.vtensor, !torch.vtensor) {
+// CHECK:           %[[RESULT0:.*]] = torch.shape.calculate {
+// CHECK:           } : !torch.vtensor<[2,3],unk>
+// CHECK:           %[[RESULT1:.*]] = torch.shape.calculate {
+// CHECK:           } : !torch.vtensor<[2,3],unk>
+func.func @memoized_shape_calculations(%arg0: !torch.vtensor<[2,3],f32>, %arg1: !torch.vtensor<[2,3],f32>) -> (!torch.vtensor, !torch.vtensor) {
+  %0 = torch.shape.calculate {
+    %2 = torch.tensor_static_info_cast %arg0 : !torch.vtensor<[2,3],f32> to !torch.vtensor
+    torch.shape.calculate.yield %2 : !torch.vtensor
+  } shapes {
+    %2 = torch.aten.size %arg0 : !torch.vtensor<[2,3],f32> -> !torch.list<int>
+    torch.shape.calculate.yield.shapes %2 : !torch.list<int>
+  } : !torch.vtensor
+  %1 = torch.shape.calculate {
+    %2 = torch.tensor_static_info_cast %arg1 : !torch.vtensor<[2,3],f32> to !torch.vtensor
+    torch.shape.calculate.yield %2 : !torch.vtensor
+  } shapes {
+    %2 = torch.aten.size %arg1 : !torch.vtensor<[2,3],f32> -> !torch.list<int>
+    torch.shape.calculate.yield.shapes %2 : !torch.list<int>
+  } : !torch.vtensor
+  return %0, %1 : !torch.vtensor, !torch.vtensor
+}
+
+// The captured list is mutated between the shape calculations, so neither is
+// memoized, and neither is refined.
+// CHECK-LABEL:   func.func @memoized_shape_calculations$mutated_list(
+// CHECK:           %[[RESULT0:.*]] = torch.shape.calculate {
+// CHECK:           } : !torch.vtensor
+// CHECK:           torch.aten.append.t
+// CHECK:           %[[RESULT1:.*]] = torch.shape.calculate {
+// CHECK:           } : !torch.vtensor
+func.func @memoized_shape_calculations$mutated_list(%arg0: !torch.vtensor) -> (!torch.vtensor, !torch.vtensor) {
+  %int2 = torch.constant.int 2
+  %int3 = torch.constant.int 3
+  %int4 = torch.constant.int 4
+  %list = torch.prim.ListConstruct %int2, %int3 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.shape.calculate {
+    torch.shape.calculate.yield %arg0 : !torch.vtensor
+  } shapes {
+    torch.shape.calculate.yield.shapes %list : !torch.list<int>
+  } : !torch.vtensor
+  %1 = torch.aten.append.t %list, %int4 : !torch.list<int>, !torch.int -> !torch.list<int>
+  %2 = torch.shape.calculate {
+    torch.shape.calculate.yield %arg0 : !torch.vtensor
+  } shapes {
+    torch.shape.calculate.yield.shapes %list : !torch.list<int>
+  } : !torch.vtensor
+  return %0, %2 : !torch.vtensor, !torch.vtensor
+}
@@ -0,0 +1,26 @@
+// RUN: torch-mlir-opt -torch-simplify-to-fixed-point -split-input-file %s | FileCheck %s
+// RUN: torch-mlir-opt -torch-simplify-to-fixed-point="max-iterations=1" -split-input-file %s | FileCheck %s --check-prefix=ONE-ROUND
+
+// This needs two rounds: the first folds the `torch.prim.If`, exposing the
+// refined `torch.aten.tanh` to the return only after RefinePublicReturn ran,
+// so the return type is refined by the second round.
+// CHECK-LABEL:   func.func @refine_and_simplify(
+// CHECK-SAME:                                   %[[ARG:.*]]: !torch.vtensor<[2,3],f32>) -> !torch.vtensor<[2,3],f32> {
+// CHECK:           %[[TANH:.*]] = torch.aten.tanh %[[ARG]] : !torch.vtensor<[2,3],f32> -> !torch.vtensor<[2,3],f32>
+// CHECK:           return %[[TANH]] : !torch.vtensor<[2,3],f32>
+// ONE-ROUND-LABEL: func.func @refine_and_simplify(
+// ONE-ROUND-SAME:    -> !torch.vtensor {
+func.func @refine_and_simplify(%arg0: !torch.vtensor<[2,3],f32>) -> !torch.vtensor {
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0 = torch.aten.add.int %int1, %int1 : !torch.int, !torch.int -> !torch.int
+  %1 = torch.aten.eq.int %0, %int2 : !torch.int, !torch.int -> !torch.bool
+  %2 = torch.prim.If %1 -> (!torch.vtensor) {
+    %3 = torch.aten.tanh %arg0 : !torch.vtensor<[2,3],f32> -> !torch.vtensor
+    torch.prim.If.yield %3 : !torch.vtensor
+  } else {
+    %3 = torch.tensor_static_info_cast %arg0 : !torch.vtensor<[2,3],f32> to !torch.vtensor
+    torch.prim.If.yield %3 : !torch.vtensor
+  }
+  return %2 : !torch.vtensor
+}
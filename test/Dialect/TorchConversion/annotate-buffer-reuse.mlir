@@ -0,0 +1,62 @@
+// RUN: torch-mlir-opt %s -torch-annotate-buffer-reuse -split-input-file | FileCheck %s
+
+#map = affine_map<(d0) -> (d0)>
+
+// The activations alternate between two slots, except the returned one.
+// CHECK-LABEL:   func.func @ping_pong(
+// CHECK-SAME:            %[[ARG:.*]]: tensor<4xf32>) -> tensor<4xf32> {
+// CHECK:           %[[INIT0:.*]] = linalg.init_tensor [4] {torch_c.reuse_slot = 0 : i64} : tensor<4xf32>
+// CHECK:           %[[A:.*]] = linalg.generic {{.*}} ins(%[[ARG]] : tensor<4xf32>) outs(%[[INIT0]] : tensor<4xf32>)
+// CHECK:           %[[INIT1:.*]] = linalg.init_tensor [4] {torch_c.reuse_slot = 1 : i64} : tensor<4xf32>
+// CHECK:           %[[B:.*]] = linalg.generic {{.*}} ins(%[[A]] : tensor<4xf32>) outs(%[[INIT1]] : tensor<4xf32>)
+// CHECK:           %[[INIT2:.*]] = linalg.init_tensor [4] {torch_c.reuse_slot = 0 : i64} : tensor<4xf32>
+// CHECK:           %[[C:.*]] = linalg.generic {{.*}} ins(%[[B]] : tensor<4xf32>) outs(%[[INIT2]] : tensor<4xf32>)
+// CHECK:           %[[INIT3:.*]] = linalg.init_tensor [4] : tensor<4xf32>
+// CHECK:           %[[D:.*]] = linalg.generic {{.*}} ins(%[[C]] : tensor<4xf32>) outs(%[[INIT3]] : tensor<4xf32>)
+// CHECK:           return %[[D]] : tensor<4xf32>
+func.func @ping_pong(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+  %init = linalg.init_tensor [4] : tensor<4xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%arg0 : tensor<4xf32>) outs(%init : tensor<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %r = math.tanh %in : f32
+    linalg.yield %r : f32
+  } -> tensor<4xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%0 : tensor<4xf32>) outs(%init : tensor<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %r = math.tanh %in : f32
+    linalg.yield %r : f32
+  } -> tensor<4xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%1 : tensor<4xf32>) outs(%init : tensor<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %r = math.tanh %in : f32
+    linalg.yield %r : f32
+  } -> tensor<4xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%2 : tensor<4xf32>) outs(%init : tensor<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %r = math.tanh %in : f32
+    linalg.yield %r : f32
+  } -> tensor<4xf32>
+  return %3 : tensor<4xf32>
+}
+
+// -----
+
+// A tensor lives as long as the views of it do.
+// CHECK-LABEL:   func.func @view(
+// CHECK:           linalg.init_tensor [2, 2] {torch_c.reuse_slot = 0 : i64} : tensor<2x2xf32>
+// CHECK:           linalg.init_tensor [4] {torch_c.reuse_slot = 1 : i64} : tensor<4xf32>
+func.func @view(%arg0: tensor<2x2xf32>) -> tensor<f32> {
+  %cst = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [2, 2] : tensor<2x2xf32>
+  %0 = linalg.fill ins(%cst : f32) outs(%init : tensor<2x2xf32>) -> tensor<2x2xf32>
+  %1 = tensor.collapse_shape %0 [[0, 1]] : tensor<2x2xf32> into tensor<4xf32>
+  %init1 = linalg.init_tensor [4] : tensor<4xf32>
+  %2 = linalg.fill ins(%cst : f32) outs(%init1 : tensor<4xf32>) -> tensor<4xf32>
+  %init2 = linalg.init_tensor [] : tensor<f32>
+  %3 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>, affine_map<(d0) -> ()>], iterator_types = ["reduction"]} ins(%1, %2 : tensor<4xf32>, tensor<4xf32>) outs(%init2 : tensor<f32>) {
+  ^bb0(%a: f32, %b: f32, %out: f32):
+    %r = arith.addf %a, %b : f32
+    linalg.yield %r : f32
+  } -> tensor<f32>
+  return %3 : tensor<f32>
+}
@@ -0,0 +1,27 @@
+// RUN: torch-mlir-opt -torch-externalize-literals="file=%t.bin min-bytes=16" %s | FileCheck %s
+// RUN: torch-mlir-opt -torch-externalize-literals="file=%t.bin min-bytes=16" %s | torch-mlir-opt -convert-torch-to-tosa | FileCheck %s --check-prefix=RELOAD
+
+// CHECK-LABEL:   func.func @literals() -> (!torch.vtensor<[4],f32>, !torch.vtensor<[4],f32>, !torch.vtensor<[2],si64>, !torch.vtensor<[8],f32>, !torch.vtensor<[2],f32>, tensor<4xf32>) {
+// CHECK:           %[[F32:.*]] = torch.vtensor.external_literal "{{.*}}.bin", 0 : !torch.vtensor<[4],f32>
+// CHECK:           %[[SAME_F32:.*]] = torch.vtensor.external_literal "{{.*}}.bin", 0 : !torch.vtensor<[4],f32>
+// CHECK:           %[[SI64:.*]] = torch.vtensor.external_literal "{{.*}}.bin", 4096 : !torch.vtensor<[2],si64>
+// CHECK:           %[[SPLAT:.*]] = torch.vtensor.literal(dense<1.000000e+00> : tensor<8xf32>) : !torch.vtensor<[8],f32>
+// CHECK:           %[[SMALL:.*]] = torch.vtensor.literal(dense<[1.000000e+00, 2.000000e+00]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+// CHECK:           %[[CONSTANT:.*]] = torch_c.external_literal "{{.*}}.bin", 8192 : tensor<4xf32>
+// CHECK:           return %[[F32]], %[[SAME_F32]], %[[SI64]], %[[SPLAT]], %[[SMALL]], %[[CONSTANT]]
+
+// The data read back from the file is that of the literals.
+// RELOAD-LABEL:  func.func @literals(
+// RELOAD:          "tosa.const"() {value = dense<[1.000000e+00, 2.000000e+00, 3.000000e+00, 4.000000e+00]> : tensor<4xf32>}
+// RELOAD:          "tosa.const"() {value = dense<[1.000000e+00, 2.000000e+00, 3.000000e+00, 4.000000e+00]> : tensor<4xf32>}
+// RELOAD:          "tosa.const"() {value = dense<[5, 6]> : tensor<2xi64>}
+func.func @literals() -> (!torch.vtensor<[4],f32>, !torch.vtensor<[4],f32>, !torch.vtensor<[2],si64>, !torch.vtensor<[8],f32>, !torch.vtensor<[2],f32>, tensor<4xf32>) {
+  %0 = torch.vtensor.literal(dense<[1.0, 2.0, 3.0, 4.0]> : tensor<4xf32>) : !torch.vtensor<[4],f32>
+  %1 = torch.vtensor.literal(dense<[1.0, 2.0, 3.0, 4.0]> : tensor<4xf32>) : !torch.vtensor<[4],f32>
+  %2 = torch.vtensor.literal(dense<[5, 6]> : tensor<2xsi64>) : !torch.vtensor<[2],si64>
+  // Splats and literals smaller than `min-bytes` stay in the IR.
+  %3 = torch.vtensor.literal(dense<1.0> : tensor<8xf32>) : !torch.vtensor<[8],f32>
+  %4 = torch.vtensor.literal(dense<[1.0, 2.0]> : tensor<2xf32>) : !torch.vtensor<[2],f32>
+  %5 = arith.constant dense<[4.0, 3.0, 2.0, 1.0]> : tensor<4xf32>
+  return %0, %1, %2, %3, %4, %5 : !torch.vtensor<[4],f32>, !torch.vtensor<[4],f32>, !torch.vtensor<[2],si64>, !torch.vtensor<[8],f32>, !torch.vtensor<[2],f32>, tensor<4xf32>
+}
@@ -115,3 +115,19 @@ func.func @identity$torch.float(%arg0: !torch.float) -> !torch.float {
 func.func @identity$torch.Generator(%arg0: !torch.Generator) -> !torch.Generator {
   return %arg0 : !torch.Generator
 }
+
+// CHECK-LABEL:   torch_c.global_tensor "private" @state : tensor<2xi64> = dense<[1, 2]> : tensor<2xi64>
+// CHECK-LABEL:   func.func @global_slot_tensor(
+// CHECK-SAME:            %[[ARG:.*]]: tensor<2xi64>) -> tensor<2xi64> {
+// CHECK:           %[[VALUE:.*]] = torch_c.global_tensor.load @state : tensor<2xi64>
+// CHECK:           torch_c.global_tensor.store @state, %[[ARG]] : tensor<2xi64>
+// CHECK:           return %[[VALUE]] : tensor<2xi64>
+torch.global_slot "private" @state : !torch.vtensor<[2],si64> {
+  %0 = torch.vtensor.literal(dense<[1, 2]> : tensor<2xsi64>) : !torch.vtensor<[2],si64>
+  torch.global_slot.init %0 : !torch.vtensor<[2],si64>
+}
+func.func @global_slot_tensor(%arg0: !torch.vtensor<[2],si64>) -> !torch.vtensor<[2],si64> {
+  %0 = torch.global_slot.get @state : !torch.vtensor<[2],si64>
+  torch.global_slot.set @state = %arg0 : !torch.vtensor<[2],si64>
+  return %0 : !torch.vtensor<[2],si64>
+}
@@ -0,0 +1,50 @@
+// RUN: torch-mlir-opt -torch-insert-slice-destination-passing -split-input-file %s | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// CHECK-LABEL:   func.func @concat_of_elementwise(
+// CHECK-SAME:                                     %[[LHS:.*]]: tensor<2x4xf32>, %[[RHS:.*]]: tensor<3x4xf32>) -> tensor<5x4xf32> {
+// CHECK:           %[[DEST:.*]] = linalg.init_tensor [5, 4] : tensor<5x4xf32>
+// CHECK:           %[[SLICE0:.*]] = tensor.extract_slice %[[DEST]][0, 0] [2, 4] [1, 1] : tensor<5x4xf32> to tensor<2x4xf32>
+// CHECK:           %[[EXP:.*]] = linalg.generic {{.*}} ins(%[[LHS]] : tensor<2x4xf32>) outs(%[[SLICE0]] : tensor<2x4xf32>)
+// CHECK:           %[[INSERT0:.*]] = tensor.insert_slice %[[EXP]] into %[[DEST]][0, 0] [2, 4] [1, 1] : tensor<2x4xf32> into tensor<5x4xf32>
+// CHECK:           %[[SLICE1:.*]] = tensor.extract_slice %[[INSERT0]][2, 0] [3, 4] [1, 1] : tensor<5x4xf32> to tensor<3x4xf32>
+// CHECK:           %[[NEG:.*]] = linalg.generic {{.*}} ins(%[[RHS]] : tensor<3x4xf32>) outs(%[[SLICE1]] : tensor<3x4xf32>)
+// CHECK:           %[[INSERT1:.*]] = tensor.insert_slice %[[NEG]] into %[[INSERT0]][2, 0] [3, 4] [1, 1] : tensor<3x4xf32> into tensor<5x4xf32>
+// CHECK:           return %[[INSERT1]] : tensor<5x4xf32>
+func.func @concat_of_elementwise(%arg0: tensor<2x4xf32>, %arg1: tensor<3x4xf32>) -> tensor<5x4xf32> {
+  %init0 = linalg.init_tensor [2, 4] : tensor<2x4xf32>
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<2x4xf32>) outs(%init0 : tensor<2x4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %exp = math.exp %in : f32
+    linalg.yield %exp : f32
+  } -> tensor<2x4xf32>
+  %init1 = linalg.init_tensor [3, 4] : tensor<3x4xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg1 : tensor<3x4xf32>) outs(%init1 : tensor<3x4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %neg = arith.negf %in : f32
+    linalg.yield %neg : f32
+  } -> tensor<3x4xf32>
+  %dest = linalg.init_tensor [5, 4] : tensor<5x4xf32>
+  %2 = tensor.insert_slice %0 into %dest[0, 0] [2, 4] [1, 1] : tensor<2x4xf32> into tensor<5x4xf32>
+  %3 = tensor.insert_slice %1 into %2[2, 0] [3, 4] [1, 1] : tensor<3x4xf32> into tensor<5x4xf32>
+  return %3 : tensor<5x4xf32>
+}
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// The generic reads its output, so it can't be computed in the destination.
+// CHECK-LABEL:   func.func @accumulating_generic(
+// CHECK:           linalg.generic {{.*}} outs(%{{.*}} : tensor<2x4xf32>)
+// CHECK-NOT:       tensor.extract_slice
+func.func @accumulating_generic(%arg0: tensor<2x4xf32>, %arg1: tensor<2x4xf32>, %arg2: tensor<5x4xf32>) -> tensor<5x4xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<2x4xf32>) outs(%arg1 : tensor<2x4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %add = arith.addf %in, %out : f32
+    linalg.yield %add : f32
+  } -> tensor<2x4xf32>
+  %1 = tensor.insert_slice %0 into %arg2[0, 0] [2, 4] [1, 1] : tensor<2x4xf32> into tensor<5x4xf32>
+  return %1 : tensor<5x4xf32>
+}
@@ -0,0 +1,116 @@
+// RUN: torch-mlir-opt -torch-narrow-index-tensors -split-input-file %s | FileCheck %s
+
+#map0 = affine_map<(d0, d1) -> (d0)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+
+// CHECK-LABEL:   func.func @constant_indices(
+// CHECK-SAME:                                %[[INPUT:.*]]: tensor<8x4xf32>) -> tensor<3x4xf32> {
+// CHECK:           %[[INDICES:.*]] = arith.constant dense<[7, 0, 3]> : tensor<3xi32>
+// CHECK:           linalg.generic {{.*}} ins(%[[INDICES]] : tensor<3xi32>)
+// CHECK:           ^bb0(%[[INDEX:.*]]: i32, %{{.*}}: f32):
+// CHECK:             %[[CAST:.*]] = arith.index_cast %[[INDEX]] : i32 to index
+// CHECK:             tensor.extract %[[INPUT]][%[[CAST]], %{{.*}}] : tensor<8x4xf32>
+func.func @constant_indices(%arg0: tensor<8x4xf32>) -> tensor<3x4xf32> {
+  %indices = arith.constant dense<[7, 0, 3]> : tensor<3xi64>
+  %init = linalg.init_tensor [3, 4] : tensor<3x4xf32>
+  %0 = linalg.generic {indexing_maps = [#map0, #map1], iterator_types = ["parallel", "parallel"]} ins(%indices : tensor<3xi64>) outs(%init : tensor<3x4xf32>) {
+  ^bb0(%index: i64, %out: f32):
+    %1 = arith.index_cast %index : i64 to index
+    %2 = linalg.index 1 : index
+    %3 = tensor.extract %arg0[%1, %2] : tensor<8x4xf32>
+    linalg.yield %3 : f32
+  } -> tensor<3x4xf32>
+  return %0 : tensor<3x4xf32>
+}
+
+// -----
+
+#map = affine_map<(d0) -> (d0)>
+
+// CHECK-LABEL:   func.func @computed_indices(
+// CHECK-SAME:                                %[[WEIGHT:.*]]: tensor<100x16xf32>, %[[IDS:.*]]: tensor<5xi64>) -> tensor<16xf32> {
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor [5] : tensor<5xi32>
+// CHECK:           %[[INDICES:.*]] = linalg.generic {{.*}} ins(%[[IDS]] : tensor<5xi64>) outs(%[[INIT]] : tensor<5xi32>) {
+// CHECK:           ^bb0(%[[ID:.*]]: i64, %{{.*}}: i32):
+// CHECK:             %[[SUM:.*]] = arith.addi %[[ID]], %{{.*}} : i64
+// CHECK:             %[[I32_MIN:.*]] = arith.constant -2147483648 : i64
+// CHECK:             %[[I32_MAX:.*]] = arith.constant 2147483647 : i64
+// CHECK:             %[[LOWER:.*]] = arith.maxsi %[[SUM]], %[[I32_MIN]] : i64
+// CHECK:             %[[UPPER:.*]] = arith.minsi %[[LOWER]], %[[I32_MAX]] : i64
+// CHECK:             %[[TRUNC:.*]] = arith.trunci %[[UPPER]] : i64 to i32
+// CHECK:             linalg.yield %[[TRUNC]] : i32
+// CHECK:           } -> tensor<5xi32>
+// CHECK:           %[[INDEX:.*]] = tensor.extract %[[INDICES]][%{{.*}}] : tensor<5xi32>
+// CHECK:           %[[C0_I32:.*]] = arith.constant 0 : i32
+// CHECK:           arith.cmpi sge, %[[INDEX]], %[[C0_I32]] : i32
+// CHECK:           %[[CAST:.*]] = arith.index_cast %[[INDEX]] : i32 to index
+// CHECK:           tensor.extract_slice %[[WEIGHT]][%[[CAST]], 0] [1, 16] [1, 1]
+func.func @computed_indices(%arg0: tensor<100x16xf32>, %arg1: tensor<5xi64>) -> tensor<16xf32> {
+  %c1_i64 = arith.constant 1 : i64
+  %c0_i64 = arith.constant 0 : i64
+  %c2 = arith.constant 2 : index
+  %c100 = arith.constant 100 : index
+  %init = linalg.init_tensor [5] : tensor<5xi64>
+  %indices = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%arg1 : tensor<5xi64>) outs(%init : tensor<5xi64>) {
+  ^bb0(%id: i64, %out: i64):
+    %sum = arith.addi %id, %c1_i64 : i64
+    linalg.yield %sum : i64
+  } -> tensor<5xi64>
+  %index = tensor.extract %indices[%c2] : tensor<5xi64>
+  %nonNegative = arith.cmpi sge, %index, %c0_i64 : i64
+  cf.assert %nonNegative, "index must be larger or equal to 0"
+  %cast = arith.index_cast %index : i64 to index
+  %inBounds = arith.cmpi ult, %cast, %c100 : index
+  cf.assert %inBounds, "index must be in [0, num_embeddings)"
+  %row = tensor.extract_slice %arg0[%cast, 0] [1, 16] [1, 1] : tensor<100x16xf32> to tensor<16xf32>
+  return %row : tensor<16xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @dynamic_indexed_dim(
+// CHECK:           arith.constant dense<[7, 0, 3]> : tensor<3xi64>
+func.func @dynamic_indexed_dim(%arg0: tensor<?xf32>) -> f32 {
+  %c1 = arith.constant 1 : index
+  %indices = arith.constant dense<[7, 0, 3]> : tensor<3xi64>
+  %index = tensor.extract %indices[%c1] : tensor<3xi64>
+  %cast = arith.index_cast %index : i64 to index
+  %0 = tensor.extract %arg0[%cast] : tensor<?xf32>
+  return %0 : f32
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @not_only_indices(
+// CHECK:           arith.constant dense<[7, 0, 3]> : tensor<3xi64>
+func.func @not_only_indices(%arg0: tensor<8xf32>) -> (f32, tensor<3xi64>) {
+  %c1 = arith.constant 1 : index
+  %indices = arith.constant dense<[7, 0, 3]> : tensor<3xi64>
+  %index = tensor.extract %indices[%c1] : tensor<3xi64>
+  %cast = arith.index_cast %index : i64 to index
+  %0 = tensor.extract %arg0[%cast] : tensor<8xf32>
+  return %0, %indices : f32, tensor<3xi64>
+}
+
+// -----
+
+#map = affine_map<(d0) -> (d0)>
+
+// An index compared with the bound of the i32 range would compare differently
+// once saturated.
+// CHECK-LABEL:   func.func @compared_with_i32_max(
+// CHECK:           linalg.generic {{.*}} -> tensor<5xi64>
+func.func @compared_with_i32_max(%arg0: tensor<8xf32>, %arg1: tensor<5xi64>) -> (f32, i1) {
+  %c2 = arith.constant 2 : index
+  %max = arith.constant 2147483647 : i64
+  %init = linalg.init_tensor [5] : tensor<5xi64>
+  %indices = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%arg1 : tensor<5xi64>) outs(%init : tensor<5xi64>) {
+  ^bb0(%id: i64, %out: i64):
+    linalg.yield %id : i64
+  } -> tensor<5xi64>
+  %index = tensor.extract %indices[%c2] : tensor<5xi64>
+  %isMax = arith.cmpi eq, %index, %max : i64
+  %cast = arith.index_cast %index : i64 to index
+  %0 = tensor.extract %arg0[%cast] : tensor<8xf32>
+  return %0, %isMax : f32, i1
+}
@@ -14,3 +14,19 @@ func.func @builtin_tensor_interop(%arg0: tensor<*xf32>, %arg1: tensor<3x?xi8>, %
   %4 = torch_c.to_builtin_tensor %arg3 : !torch.vtensor<[3,?],si8> -> tensor<3x?xi8>
   return
 }
+
+// CHECK-LABEL: func.func @external_literal(
+func.func @external_literal() -> tensor<3x5xf32> {
+  // CHECK: torch_c.external_literal "weights.bin", 4096 : tensor<3x5xf32>
+  %0 = torch_c.external_literal "weights.bin", 4096 : tensor<3x5xf32>
+  return %0 : tensor<3x5xf32>
+}
+
+// CHECK-LABEL: func.func @call_kernel(
+func.func @call_kernel(%arg0: tensor<?x4xf32>, %arg1: f64, %arg2: tensor<?x4xf32>, %arg3: tensor<3xi64>) -> (tensor<?x4xf32>, tensor<3xi64>) {
+  // CHECK: torch_c.call_kernel "my_ops_fused_gelu" ins(%arg0, %arg1 : tensor<?x4xf32>, f64) outs(%arg2 : tensor<?x4xf32>) -> tensor<?x4xf32>
+  %0 = torch_c.call_kernel "my_ops_fused_gelu" ins(%arg0, %arg1 : tensor<?x4xf32>, f64) outs(%arg2 : tensor<?x4xf32>) -> tensor<?x4xf32>
+  // CHECK: torch_c.call_kernel "my_ops_iota" outs(%arg3 : tensor<3xi64>) -> tensor<3xi64>
+  %1 = torch_c.call_kernel "my_ops_iota" outs(%arg3 : tensor<3xi64>) -> tensor<3xi64>
+  return %0, %1 : tensor<?x4xf32>, tensor<3xi64>
+}
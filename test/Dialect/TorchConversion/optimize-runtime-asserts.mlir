@@ -0,0 +1,94 @@
+// RUN: torch-mlir-opt %s -torch-optimize-runtime-asserts -split-input-file | FileCheck %s
+// RUN: torch-mlir-opt %s -torch-optimize-runtime-asserts=elide -split-input-file | FileCheck %s --check-prefix=ELIDE
+
+// CHECK-LABEL:   func.func @hoist_and_deduplicate(
+// CHECK-SAME:                                     %[[ARG0:.*]]: tensor<?xf32>,
+// CHECK-SAME:                                     %[[ARG1:.*]]: tensor<?xf32>) -> tensor<?xf32> {
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[DIM0:.*]] = tensor.dim %[[ARG0]], %[[C0]] : tensor<?xf32>
+// CHECK:           %[[DIM1:.*]] = tensor.dim %[[ARG1]], %[[C0]] : tensor<?xf32>
+// CHECK:           %[[EQ:.*]] = arith.cmpi eq, %[[DIM0]], %[[DIM1]] : index
+// CHECK:           cf.assert %[[EQ]], "mismatched size for broadcast"
+// CHECK-NOT:       cf.assert
+// CHECK:           linalg.init_tensor
+// CHECK:           linalg.generic
+// CHECK:           linalg.generic
+// CHECK:           return
+// ELIDE-LABEL:   func.func @hoist_and_deduplicate(
+// ELIDE-NOT:       cf.assert
+func.func @hoist_and_deduplicate(%arg0: tensor<?xf32>, %arg1: tensor<?xf32>) -> tensor<?xf32> {
+  %c0 = arith.constant 0 : index
+  %dim0 = tensor.dim %arg0, %c0 : tensor<?xf32>
+  %init = linalg.init_tensor [%dim0] : tensor<?xf32>
+  %dim1 = tensor.dim %arg1, %c0 : tensor<?xf32>
+  %eq = arith.cmpi eq, %dim0, %dim1 : index
+  cf.assert %eq, "mismatched size for broadcast"
+  %0 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%arg0, %arg1 : tensor<?xf32>, tensor<?xf32>) outs(%init : tensor<?xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32):
+    %s = arith.addf %a, %b : f32
+    linalg.yield %s : f32
+  } -> tensor<?xf32>
+  cf.assert %eq, "mismatched size for broadcast"
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%0, %arg1 : tensor<?xf32>, tensor<?xf32>) outs(%init : tensor<?xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32):
+    %s = arith.mulf %a, %b : f32
+    linalg.yield %s : f32
+  } -> tensor<?xf32>
+  return %1 : tensor<?xf32>
+}
+
+// -----
+
+// The condition depends on the result of a kernel, so the assert stays after
+// it.
+// CHECK-LABEL:   func.func @not_hoistable(
+// CHECK:           %[[GENERIC:.*]] = linalg.generic
+// CHECK:           %[[DIM:.*]] = tensor.dim %[[GENERIC]]
+// CHECK:           cf.assert
+// CHECK:           return
+// ELIDE-LABEL:   func.func @not_hoistable(
+// ELIDE-NOT:       cf.assert
+func.func @not_hoistable(%arg0: tensor<?xf32>, %arg1: index) -> tensor<?xf32> {
+  %c0 = arith.constant 0 : index
+  %dim0 = tensor.dim %arg0, %c0 : tensor<?xf32>
+  %init = linalg.init_tensor [%dim0] : tensor<?xf32>
+  %0 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%arg0 : tensor<?xf32>) outs(%init : tensor<?xf32>) {
+  ^bb0(%a: f32, %c: f32):
+    %s = arith.negf %a : f32
+    linalg.yield %s : f32
+  } -> tensor<?xf32>
+  %dim = tensor.dim %0, %c0 : tensor<?xf32>
+  %eq = arith.cmpi eq, %dim, %arg1 : index
+  cf.assert %eq, "mismatched size"
+  return %0 : tensor<?xf32>
+}
+
+// -----
+
+// The element is only read after the assert that the index is in bounds,
+// which stays in place, so the assert on the element isn't hoisted above it.
+// CHECK-LABEL:   func.func @guarded_by_kept_assert(
+// CHECK:           %[[GENERIC:.*]] = linalg.generic
+// CHECK:           cf.assert %{{.*}}, "index out of bounds"
+// CHECK:           %[[ELEMENT:.*]] = tensor.extract %{{.*}}[%{{.*}}] : tensor<?xi64>
+// CHECK:           %[[IS_POSITIVE:.*]] = arith.cmpi sgt, %[[ELEMENT]], %{{.*}} : i64
+// CHECK:           cf.assert %[[IS_POSITIVE]], "expected a positive element"
+// CHECK:           return
+func.func @guarded_by_kept_assert(%arg0: tensor<?xf32>, %arg1: tensor<?xi64>, %arg2: index) -> tensor<?xf32> {
+  %c0 = arith.constant 0 : index
+  %c0_i64 = arith.constant 0 : i64
+  %dim0 = tensor.dim %arg0, %c0 : tensor<?xf32>
+  %init = linalg.init_tensor [%dim0] : tensor<?xf32>
+  %0 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%arg0 : tensor<?xf32>) outs(%init : tensor<?xf32>) {
+  ^bb0(%a: f32, %c: f32):
+    %s = arith.negf %a : f32
+    linalg.yield %s : f32
+  } -> tensor<?xf32>
+  %dim = tensor.dim %0, %c0 : tensor<?xf32>
+  %in_bounds = arith.cmpi ult, %arg2, %dim : index
+  cf.assert %in_bounds, "index out of bounds"
+  %element = tensor.extract %arg1[%arg2] : tensor<?xi64>
+  %is_positive = arith.cmpi sgt, %element, %c0_i64 : i64
+  cf.assert %is_positive, "expected a positive element"
+  return %0 : tensor<?xf32>
+}
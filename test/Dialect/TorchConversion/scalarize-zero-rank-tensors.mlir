@@ -0,0 +1,83 @@
+// RUN: torch-mlir-opt -torch-scalarize-zero-rank-tensors -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @chain_of_scalar_ops(
+// CHECK-SAME:                                   %[[A:.*]]: f32, %[[B:.*]]: f32) -> f32 {
+// CHECK:           %[[SUM:.*]] = arith.addf %[[A]], %[[B]] : f32
+// CHECK:           %[[PRODUCT:.*]] = arith.mulf %[[SUM]], %[[SUM]] : f32
+// CHECK:           return %[[PRODUCT]] : f32
+func.func @chain_of_scalar_ops(%arg0: f32, %arg1: f32) -> f32 {
+  %init0 = linalg.init_tensor [] : tensor<f32>
+  %a = linalg.fill ins(%arg0 : f32) outs(%init0 : tensor<f32>) -> tensor<f32>
+  %init1 = linalg.init_tensor [] : tensor<f32>
+  %b = linalg.fill ins(%arg1 : f32) outs(%init1 : tensor<f32>) -> tensor<f32>
+  %init2 = linalg.init_tensor [] : tensor<f32>
+  %sum = linalg.generic {indexing_maps = [affine_map<() -> ()>, affine_map<() -> ()>, affine_map<() -> ()>], iterator_types = []} ins(%a, %b : tensor<f32>, tensor<f32>) outs(%init2 : tensor<f32>) {
+  ^bb0(%x: f32, %y: f32, %out: f32):
+    %0 = arith.addf %x, %y : f32
+    linalg.yield %0 : f32
+  } -> tensor<f32>
+  %init3 = linalg.init_tensor [] : tensor<f32>
+  %product = linalg.generic {indexing_maps = [affine_map<() -> ()>, affine_map<() -> ()>], iterator_types = []} ins(%sum : tensor<f32>) outs(%init3 : tensor<f32>) {
+  ^bb0(%x: f32, %out: f32):
+    %0 = arith.mulf %x, %x : f32
+    linalg.yield %0 : f32
+  } -> tensor<f32>
+  %cast = tensor.cast %product : tensor<f32> to tensor<f32>
+  %result = tensor.extract %cast[] : tensor<f32>
+  return %result : f32
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @returned_tensor(
+// CHECK-SAME:                               %[[A:.*]]: tensor<f32>) -> tensor<f32> {
+// CHECK:           %[[X:.*]] = tensor.extract %[[A]][] : tensor<f32>
+// CHECK:           %[[NEG:.*]] = arith.negf %[[X]] : f32
+// CHECK:           %[[RESULT:.*]] = tensor.from_elements %[[NEG]] : tensor<f32>
+// CHECK:           return %[[RESULT]] : tensor<f32>
+func.func @returned_tensor(%arg0: tensor<f32>) -> tensor<f32> {
+  %init = linalg.init_tensor [] : tensor<f32>
+  %0 = linalg.generic {indexing_maps = [affine_map<() -> ()>, affine_map<() -> ()>], iterator_types = []} ins(%arg0 : tensor<f32>) outs(%init : tensor<f32>) {
+  ^bb0(%x: f32, %out: f32):
+    %1 = arith.negf %x : f32
+    linalg.yield %1 : f32
+  } -> tensor<f32>
+  return %0 : tensor<f32>
+}
+
+// -----
+
+#map0 = affine_map<(d0) -> (d0)>
+#map1 = affine_map<(d0) -> ()>
+
+// CHECK:     #[[MAP:.*]] = affine_map<(d0) -> (d0)>
+// CHECK-LABEL:   func.func @scalar_operand_of_broadcast(
+// CHECK-SAME:                                           %[[X:.*]]: tensor<4xf32>, %[[SCALE:.*]]: f32) -> tensor<4xf32> {
+// CHECK:           %[[INIT:.*]] = linalg.init_tensor [4] : tensor<4xf32>
+// CHECK:           %[[RESULT:.*]] = linalg.generic {indexing_maps = [#[[MAP]], #[[MAP]]], iterator_types = ["parallel"]} ins(%[[X]] : tensor<4xf32>) outs(%[[INIT]] : tensor<4xf32>) {
+// CHECK:           ^bb0(%[[IN:.*]]: f32, %{{.*}}: f32):
+// CHECK:             %[[PRODUCT:.*]] = arith.mulf %[[IN]], %[[SCALE]] : f32
+// CHECK:             linalg.yield %[[PRODUCT]] : f32
+// CHECK:           } -> tensor<4xf32>
+// CHECK:           return %[[RESULT]] : tensor<4xf32>
+func.func @scalar_operand_of_broadcast(%arg0: tensor<4xf32>, %arg1: f32) -> tensor<4xf32> {
+  %init0 = linalg.init_tensor [] : tensor<f32>
+  %scale = linalg.fill ins(%arg1 : f32) outs(%init0 : tensor<f32>) -> tensor<f32>
+  %init1 = linalg.init_tensor [4] : tensor<4xf32>
+  %0 = linalg.generic {indexing_maps = [#map0, #map1, #map0], iterator_types = ["parallel"]} ins(%arg0, %scale : tensor<4xf32>, tensor<f32>) outs(%init1 : tensor<4xf32>) {
+  ^bb0(%x: f32, %s: f32, %out: f32):
+    %1 = arith.mulf %x, %s : f32
+    linalg.yield %1 : f32
+  } -> tensor<4xf32>
+  return %0 : tensor<4xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @fill_with_conversion(
+// CHECK:           linalg.fill
+func.func @fill_with_conversion(%arg0: f64) -> tensor<f32> {
+  %init = linalg.init_tensor [] : tensor<f32>
+  %0 = linalg.fill ins(%arg0 : f64) outs(%init : tensor<f32>) -> tensor<f32>
+  return %0 : tensor<f32>
+}
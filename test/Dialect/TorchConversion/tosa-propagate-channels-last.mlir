@@ -0,0 +1,107 @@
+// RUN: torch-mlir-opt -torch-tosa-propagate-channels-last -canonicalize -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL:   func.func @relu_between_transposes(
+// CHECK-SAME:                              %[[ARG:.*]]: tensor<1x4x4x3xf32>) -> tensor<1x3x4x4xf32> {
+// CHECK:           %[[CLAMP:.*]] = "tosa.clamp"(%[[ARG]])
+// CHECK-SAME:          -> tensor<1x4x4x3xf32>
+// CHECK:           %[[NCHW:.*]] = "tosa.transpose"(%[[CLAMP]], %{{.*}}) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+// CHECK-NOT:       "tosa.transpose"
+// CHECK:           return %[[NCHW]] : tensor<1x3x4x4xf32>
+func.func @relu_between_transposes(%arg0: tensor<1x4x4x3xf32>) -> tensor<1x3x4x4xf32> {
+  %nhwc_to_nchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchw_to_nhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %1 = "tosa.clamp"(%0) {min_fp = 0.0 : f32, max_fp = 3.40282347E+38 : f32, min_int = 0 : i64, max_int = 2147483647 : i64} : (tensor<1x3x4x4xf32>) -> tensor<1x3x4x4xf32>
+  %2 = "tosa.transpose"(%1, %nchw_to_nhwc) : (tensor<1x3x4x4xf32>, tensor<4xi32>) -> tensor<1x4x4x3xf32>
+  %3 = "tosa.transpose"(%2, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  return %3 : tensor<1x3x4x4xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @bias_add(
+// CHECK-SAME:                        %[[ARG:.*]]: tensor<1x4x4x3xf32>) -> tensor<1x4x4x3xf32> {
+// CHECK:           %[[BIAS:.*]] = "tosa.const"() {value = dense<{{\[\[\[}}[1.000000e+00, 2.000000e+00, 3.000000e+00]]]]> : tensor<1x1x1x3xf32>}
+// CHECK:           %[[ADD:.*]] = "tosa.add"(%[[ARG]], %[[BIAS]]) : (tensor<1x4x4x3xf32>, tensor<1x1x1x3xf32>) -> tensor<1x4x4x3xf32>
+// CHECK-NOT:       "tosa.transpose"
+// CHECK:           return %[[ADD]] : tensor<1x4x4x3xf32>
+func.func @bias_add(%arg0: tensor<1x4x4x3xf32>) -> tensor<1x4x4x3xf32> {
+  %nhwc_to_nchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchw_to_nhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %bias = "tosa.const"() {value = dense<[[[[1.0]], [[2.0]], [[3.0]]]]> : tensor<1x3x1x1xf32>} : () -> tensor<1x3x1x1xf32>
+  %0 = "tosa.transpose"(%arg0, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %1 = "tosa.add"(%0, %bias) : (tensor<1x3x4x4xf32>, tensor<1x3x1x1xf32>) -> tensor<1x3x4x4xf32>
+  %2 = "tosa.transpose"(%1, %nchw_to_nhwc) : (tensor<1x3x4x4xf32>, tensor<4xi32>) -> tensor<1x4x4x3xf32>
+  return %2 : tensor<1x4x4x3xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @residual_add(
+// CHECK-SAME:                            %[[LHS:.*]]: tensor<1x4x4x3xf32>,
+// CHECK-SAME:                            %[[RHS:.*]]: tensor<1x4x4x3xf32>) -> tensor<1x4x4x3xf32> {
+// CHECK:           %[[ADD:.*]] = "tosa.add"(%[[LHS]], %[[RHS]]) : (tensor<1x4x4x3xf32>, tensor<1x4x4x3xf32>) -> tensor<1x4x4x3xf32>
+// CHECK:           return %[[ADD]] : tensor<1x4x4x3xf32>
+func.func @residual_add(%arg0: tensor<1x4x4x3xf32>, %arg1: tensor<1x4x4x3xf32>) -> tensor<1x4x4x3xf32> {
+  %nhwc_to_nchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchw_to_nhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %1 = "tosa.transpose"(%arg1, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %2 = "tosa.add"(%0, %1) : (tensor<1x3x4x4xf32>, tensor<1x3x4x4xf32>) -> tensor<1x3x4x4xf32>
+  %3 = "tosa.transpose"(%2, %nchw_to_nhwc) : (tensor<1x3x4x4xf32>, tensor<4xi32>) -> tensor<1x4x4x3xf32>
+  return %3 : tensor<1x4x4x3xf32>
+}
+
+// -----
+
+// The other operand of the add can't be transposed for free.
+// CHECK-LABEL:   func.func @unknown_layout_operand(
+// CHECK:           "tosa.transpose"
+// CHECK:           "tosa.add"
+func.func @unknown_layout_operand(%arg0: tensor<1x4x4x3xf32>, %arg1: tensor<1x3x4x4xf32>) -> tensor<1x3x4x4xf32> {
+  %nhwc_to_nchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %1 = "tosa.add"(%0, %arg1) : (tensor<1x3x4x4xf32>, tensor<1x3x4x4xf32>) -> tensor<1x3x4x4xf32>
+  return %1 : tensor<1x3x4x4xf32>
+}
+
+// -----
+
+// The casts that end the lowerings of convolutions don't keep a relu and the
+// next pooling op in NCHW.
+// CHECK-LABEL:   func.func @pooling_after_cast(
+// CHECK-SAME:                                  %[[ARG:.*]]: tensor<1x4x4x3xf32>) -> tensor<1x2x2x3xf32> {
+// CHECK:           %[[CAST:.*]] = tensor.cast %[[ARG]] : tensor<1x4x4x3xf32> to tensor<1x?x?x3xf32>
+// CHECK:           %[[CLAMP:.*]] = "tosa.clamp"(%[[CAST]])
+// CHECK-SAME:          -> tensor<1x?x?x3xf32>
+// CHECK-NOT:       "tosa.transpose"
+// CHECK:           %[[POOL:.*]] = "tosa.max_pool2d"(%[[CLAMP]])
+// CHECK:           return %[[POOL]] : tensor<1x2x2x3xf32>
+func.func @pooling_after_cast(%arg0: tensor<1x4x4x3xf32>) -> tensor<1x2x2x3xf32> {
+  %nhwc_to_nchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchw_to_nhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %1 = tensor.cast %0 : tensor<1x3x4x4xf32> to tensor<1x3x?x?xf32>
+  %2 = "tosa.clamp"(%1) {min_fp = 0.0 : f32, max_fp = 3.40282347E+38 : f32, min_int = 0 : i64, max_int = 2147483647 : i64} : (tensor<1x3x?x?xf32>) -> tensor<1x3x?x?xf32>
+  %3 = "tosa.transpose"(%2, %nchw_to_nhwc) : (tensor<1x3x?x?xf32>, tensor<4xi32>) -> tensor<1x?x?x3xf32>
+  %4 = "tosa.max_pool2d"(%3) {kernel = [2, 2], pad = [0, 0, 0, 0], stride = [2, 2]} : (tensor<1x?x?x3xf32>) -> tensor<1x2x2x3xf32>
+  return %4 : tensor<1x2x2x3xf32>
+}
+
+// -----
+
+// The transpose is also returned, so sinking it below the relu would leave two
+// transposes instead of one.
+// CHECK-LABEL:   func.func @multi_use_transpose(
+// CHECK-SAME:                                   %[[ARG:.*]]: tensor<1x4x4x3xf32>) -> (tensor<1x3x4x4xf32>, tensor<1x3x4x4xf32>) {
+// CHECK:           %[[NCHW:.*]] = "tosa.transpose"(%[[ARG]], %{{.*}}) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+// CHECK:           %[[CLAMP:.*]] = "tosa.clamp"(%[[NCHW]])
+// CHECK-SAME:          -> tensor<1x3x4x4xf32>
+// CHECK-NOT:       "tosa.transpose"
+// CHECK:           return %[[NCHW]], %[[CLAMP]] : tensor<1x3x4x4xf32>, tensor<1x3x4x4xf32>
+func.func @multi_use_transpose(%arg0: tensor<1x4x4x3xf32>) -> (tensor<1x3x4x4xf32>, tensor<1x3x4x4xf32>) {
+  %nhwc_to_nchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwc_to_nchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %1 = "tosa.clamp"(%0) {min_fp = 0.0 : f32, max_fp = 3.40282347E+38 : f32, min_int = 0 : i64, max_int = 2147483647 : i64} : (tensor<1x3x4x4xf32>) -> tensor<1x3x4x4xf32>
+  return %0, %1 : tensor<1x3x4x4xf32>, tensor<1x3x4x4xf32>
+}
@@ -26,3 +26,21 @@ func.func @unresolved_operator(%arg0: !torch.vtensor<[],f32>, %arg1: !torch.int)
   torch.operator "aten.mul.Scalar"(%arg0, %arg1) : (!torch.vtensor<[],f32>, !torch.int) -> !torch.vtensor<[],f32>
   return
 }
+
+// -----
+
+// The calls to custom kernels are lowered by the backends once the shapes of
+// their results are attached.
+func.func @custom_kernel(%arg0: !torch.vtensor<[2],f32>, %arg1: !torch.list<int>) -> !torch.vtensor<[2],f32> {
+  %0 = torch.operator "my_ops.gelu"(%arg0, %arg1) {torch.custom_kernel = "my_ops_gelu", torch.custom_kernel_num_inputs = 1 : i64} : (!torch.vtensor<[2],f32>, !torch.list<int>) -> !torch.vtensor<[2],f32>
+  return %0 : !torch.vtensor<[2],f32>
+}
+
+// -----
+
+func.func @custom_kernel_without_result_shapes(%arg0: !torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32> {
+  // expected-error@+2 {{unsupported by backend lowering: `torch.operator` op}}
+  // expected-note@+1 {{this is likely due to a missing op that needs to be generated by torch_ods_gen.py}}
+  %0 = torch.operator "my_ops.gelu"(%arg0) {torch.custom_kernel = "my_ops_gelu"} : (!torch.vtensor<[2],f32>) -> !torch.vtensor<[2],f32>
+  return %0 : !torch.vtensor<[2],f32>
+}
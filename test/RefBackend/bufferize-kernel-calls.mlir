@@ -0,0 +1,40 @@
+// RUN: torch-mlir-opt %s -refback-bufferize-kernel-calls -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK:         func.func private @refbackend_custom_kernel_my_ops_gelu(memref<?x?xf32>, f64, memref<?x?xf32>) attributes {llvm.emit_c_interface}
+// CHECK-LABEL:   func.func @call_kernel(
+// CHECK-SAME:            %[[ARG:.*]]: tensor<?x4xf32>, %[[ALPHA:.*]]: f64, %[[INIT:.*]]: tensor<?x4xf32>) -> tensor<?x4xf32> {
+// CHECK:           %[[ARG_BUFFER:.*]] = bufferization.to_memref %[[ARG]] : memref<?x4xf32>
+// CHECK:           %[[ARG_CAST:.*]] = memref.cast %[[ARG_BUFFER]] : memref<?x4xf32> to memref<?x?xf32>
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[DIM0:.*]] = tensor.dim %[[INIT]], %[[C0]] : tensor<?x4xf32>
+// CHECK:           %[[OUT:.*]] = memref.alloc(%[[DIM0]]) : memref<?x4xf32>
+// CHECK:           %[[OUT_CAST:.*]] = memref.cast %[[OUT]] : memref<?x4xf32> to memref<?x?xf32>
+// CHECK:           %[[RESULT:.*]] = bufferization.to_tensor %[[OUT]] : memref<?x4xf32>
+// CHECK:           call @refbackend_custom_kernel_my_ops_gelu(%[[ARG_CAST]], %[[ALPHA]], %[[OUT_CAST]]) : (memref<?x?xf32>, f64, memref<?x?xf32>) -> ()
+// CHECK:           return %[[RESULT]] : tensor<?x4xf32>
+func.func @call_kernel(%arg0: tensor<?x4xf32>, %alpha: f64, %init: tensor<?x4xf32>) -> tensor<?x4xf32> {
+  %0 = torch_c.call_kernel "my_ops_gelu" ins(%arg0, %alpha : tensor<?x4xf32>, f64) outs(%init : tensor<?x4xf32>) -> tensor<?x4xf32>
+  return %0 : tensor<?x4xf32>
+}
+
+// -----
+
+// The calls with the same types share the declaration of the kernel.
+// CHECK:         func.func private @refbackend_custom_kernel_my_ops_iota(memref<?xi64>) attributes {llvm.emit_c_interface}
+// CHECK-NOT:     func.func private @refbackend_custom_kernel_my_ops_iota
+// CHECK-LABEL:   func.func @two_calls(
+// CHECK-COUNT-2:   call @refbackend_custom_kernel_my_ops_iota(
+func.func @two_calls(%arg0: tensor<3xi64>, %arg1: tensor<5xi64>) -> (tensor<3xi64>, tensor<5xi64>) {
+  %0 = torch_c.call_kernel "my_ops_iota" outs(%arg0 : tensor<3xi64>) -> tensor<3xi64>
+  %1 = torch_c.call_kernel "my_ops_iota" outs(%arg1 : tensor<5xi64>) -> tensor<5xi64>
+  return %0, %1 : tensor<3xi64>, tensor<5xi64>
+}
+
+// -----
+
+func.func @mismatched_calls(%arg0: tensor<3xi64>, %arg1: tensor<5xf32>) -> (tensor<3xi64>, tensor<5xf32>) {
+  %0 = torch_c.call_kernel "my_ops_iota" outs(%arg0 : tensor<3xi64>) -> tensor<3xi64>
+  // expected-error @+1 {{the types of the call to kernel 'my_ops_iota' don't match those of another call to it}}
+  %1 = torch_c.call_kernel "my_ops_iota" outs(%arg1 : tensor<5xf32>) -> tensor<5xf32>
+  return %0, %1 : tensor<3xi64>, tensor<5xf32>
+}
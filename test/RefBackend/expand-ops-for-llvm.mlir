@@ -0,0 +1,61 @@
+// RUN: torch-mlir-opt %s -refback-expand-ops-for-llvm -split-input-file | FileCheck %s
+// RUN: torch-mlir-opt %s -refback-expand-ops-for-llvm="fast-math=true" -split-input-file | FileCheck %s --check-prefix=FAST-MATH
+
+// CHECK-LABEL:   func.func @addf_bf16(
+// CHECK-SAME:                         %[[LHS:.*]]: bf16, %[[RHS:.*]]: bf16) -> bf16 {
+// CHECK:           %[[LHS_BITS:.*]] = arith.bitcast %[[LHS]] : bf16 to i16
+// CHECK:           %[[LHS_EXT:.*]] = arith.extui %[[LHS_BITS]] : i16 to i32
+// CHECK:           %[[LHS_SHL:.*]] = arith.shli %[[LHS_EXT]], %{{.*}} : i32
+// CHECK:           %[[LHS_F32:.*]] = arith.bitcast %[[LHS_SHL]] : i32 to f32
+// CHECK:           %[[RHS_F32:.*]] = arith.bitcast %{{.*}} : i32 to f32
+// CHECK:           %[[SUM:.*]] = arith.addf %[[LHS_F32]], %[[RHS_F32]] : f32
+// CHECK:           %[[BITS:.*]] = arith.bitcast %[[SUM]] : f32 to i32
+// CHECK:           %[[ROUNDED:.*]] = arith.addi %[[BITS]], %{{.*}} : i32
+// CHECK:           %[[HIGH:.*]] = arith.shrui %[[ROUNDED]], %{{.*}} : i32
+// CHECK:           %[[TRUNC:.*]] = arith.trunci %[[HIGH]] : i32 to i16
+// CHECK:           %[[IS_NAN:.*]] = arith.cmpf uno, %[[SUM]], %[[SUM]] : f32
+// CHECK:           %[[RESULT_BITS:.*]] = arith.select %[[IS_NAN]], %{{.*}}, %[[TRUNC]] : i16
+// CHECK:           %[[RESULT:.*]] = arith.bitcast %[[RESULT_BITS]] : i16 to bf16
+// CHECK:           return %[[RESULT]] : bf16
+func.func @addf_bf16(%arg0: bf16, %arg1: bf16) -> bf16 {
+  %0 = arith.addf %arg0, %arg1 : bf16
+  return %0 : bf16
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @tanh_f16(
+// CHECK-SAME:                        %[[ARG:.*]]: f16) -> f16 {
+// CHECK:           %[[EXT:.*]] = arith.extf %[[ARG]] : f16 to f32
+// CHECK-NOT:       math.tanh
+// CHECK:           %[[RESULT:.*]] = arith.truncf %{{.*}} : f32 to f16
+// CHECK:           return %[[RESULT]] : f16
+func.func @tanh_f16(%arg0: f16) -> f16 {
+  %0 = math.tanh %arg0 : f16
+  return %0 : f16
+}
+
+// -----
+
+// Arithmetic on f16 is left to LLVM.
+// CHECK-LABEL:   func.func @mulf_f16(
+// CHECK:           arith.mulf %{{.*}}, %{{.*}} : f16
+func.func @mulf_f16(%arg0: f16, %arg1: f16) -> f16 {
+  %0 = arith.mulf %arg0, %arg1 : f16
+  return %0 : f16
+}
+
+// -----
+
+// Without fast math, exp is left to libm.
+// CHECK-LABEL:   func.func @exp_f32(
+// CHECK:           math.exp
+// FAST-MATH-LABEL: func.func @exp_f32(
+// FAST-MATH-NOT:   math.exp
+// FAST-MATH:       math.fma
+// FAST-MATH-NOT:   math.exp
+// FAST-MATH:       return
+func.func @exp_f32(%arg0: f32) -> f32 {
+  %0 = math.exp %arg0 : f32
+  return %0 : f32
+}
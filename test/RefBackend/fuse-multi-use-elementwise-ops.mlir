@@ -0,0 +1,85 @@
+// RUN: torch-mlir-opt %s -split-input-file -pass-pipeline='func.func(refback-fuse-multi-use-elementwise-ops)' | FileCheck %s
+
+#map = affine_map<(d0) -> (d0)>
+
+// An SGD-momentum update: the new momentum buffer is both returned and used to
+// update the parameter.
+// CHECK-LABEL:   func.func @sgd_momentum(
+// CHECK-SAME:            %[[PARAM:.*]]: tensor<?xf32>, %[[BUF:.*]]: tensor<?xf32>, %[[GRAD:.*]]: tensor<?xf32>) -> (tensor<?xf32>, tensor<?xf32>) {
+// CHECK:           %[[FUSED:.*]]:2 = linalg.generic
+// CHECK-SAME:        ins(%[[PARAM]], %[[BUF]], %[[GRAD]] : tensor<?xf32>, tensor<?xf32>, tensor<?xf32>) outs(%[[PARAM]], %[[BUF]] : tensor<?xf32>, tensor<?xf32>) {
+// CHECK:           ^bb0(%[[P:.*]]: f32, %[[B:.*]]: f32, %[[G:.*]]: f32, %{{.*}}: f32, %{{.*}}: f32):
+// CHECK:             %[[SCALED_BUF:.*]] = arith.mulf %[[B]], %{{.*}} : f32
+// CHECK:             %[[NEW_BUF:.*]] = arith.addf %[[SCALED_BUF]], %[[G]] : f32
+// CHECK:             %[[STEP:.*]] = arith.mulf %[[NEW_BUF]], %{{.*}} : f32
+// CHECK:             %[[NEW_PARAM:.*]] = arith.subf %[[P]], %[[STEP]] : f32
+// CHECK:             linalg.yield %[[NEW_PARAM]], %[[NEW_BUF]] : f32, f32
+// CHECK:           } -> (tensor<?xf32>, tensor<?xf32>)
+// CHECK-NOT:       linalg.generic
+// CHECK:           return %[[FUSED]]#0, %[[FUSED]]#1 : tensor<?xf32>, tensor<?xf32>
+func.func @sgd_momentum(%param: tensor<?xf32>, %buf: tensor<?xf32>, %grad: tensor<?xf32>) -> (tensor<?xf32>, tensor<?xf32>) {
+  %momentum = arith.constant 0.9 : f32
+  %lr = arith.constant 0.1 : f32
+  %newBuf = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel"]} ins(%buf, %grad : tensor<?xf32>, tensor<?xf32>) outs(%buf : tensor<?xf32>) {
+  ^bb0(%b: f32, %g: f32, %out: f32):
+    %0 = arith.mulf %b, %momentum : f32
+    %1 = arith.addf %0, %g : f32
+    linalg.yield %1 : f32
+  } -> tensor<?xf32>
+  %newParam = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel"]} ins(%param, %newBuf : tensor<?xf32>, tensor<?xf32>) outs(%param : tensor<?xf32>) {
+  ^bb0(%p: f32, %b: f32, %out: f32):
+    %0 = arith.mulf %b, %lr : f32
+    %1 = arith.subf %p, %0 : f32
+    linalg.yield %1 : f32
+  } -> tensor<?xf32>
+  return %newParam, %newBuf : tensor<?xf32>, tensor<?xf32>
+}
+
+// -----
+
+#map = affine_map<(d0) -> (d0)>
+
+// The producer is used before the consumer, so the fused op could not replace
+// that use.
+// CHECK-LABEL:   func.func @use_before_consumer(
+// CHECK:           linalg.generic
+// CHECK:           tensor.dim
+// CHECK:           linalg.generic
+func.func @use_before_consumer(%arg0: tensor<?xf32>) -> (tensor<?xf32>, index) {
+  %c0 = arith.constant 0 : index
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%arg0 : tensor<?xf32>) outs(%arg0 : tensor<?xf32>) {
+  ^bb0(%x: f32, %out: f32):
+    %2 = arith.negf %x : f32
+    linalg.yield %2 : f32
+  } -> tensor<?xf32>
+  %dim = tensor.dim %0, %c0 : tensor<?xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%0 : tensor<?xf32>) outs(%arg0 : tensor<?xf32>) {
+  ^bb0(%x: f32, %out: f32):
+    %2 = arith.mulf %x, %x : f32
+    linalg.yield %2 : f32
+  } -> tensor<?xf32>
+  return %1, %dim : tensor<?xf32>, index
+}
+
+// -----
+
+#map0 = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1, d0)>
+
+// The consumer reads the result of the producer transposed.
+// CHECK-LABEL:   func.func @transposed_read(
+// CHECK:           linalg.generic
+// CHECK:           linalg.generic
+func.func @transposed_read(%arg0: tensor<4x4xf32>) -> (tensor<4x4xf32>, tensor<4x4xf32>) {
+  %0 = linalg.generic {indexing_maps = [#map0, #map0], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<4x4xf32>) outs(%arg0 : tensor<4x4xf32>) {
+  ^bb0(%x: f32, %out: f32):
+    %2 = arith.negf %x : f32
+    linalg.yield %2 : f32
+  } -> tensor<4x4xf32>
+  %1 = linalg.generic {indexing_maps = [#map1, #map0], iterator_types = ["parallel", "parallel"]} ins(%0 : tensor<4x4xf32>) outs(%arg0 : tensor<4x4xf32>) {
+  ^bb0(%x: f32, %out: f32):
+    %2 = arith.mulf %x, %x : f32
+    linalg.yield %2 : f32
+  } -> tensor<4x4xf32>
+  return %1, %0 : tensor<4x4xf32>, tensor<4x4xf32>
+}
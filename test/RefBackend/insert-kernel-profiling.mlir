@@ -0,0 +1,102 @@
+// RUN: torch-mlir-opt %s -refback-insert-kernel-profiling -split-input-file | FileCheck %s
+
+// CHECK:         memref.global "private" constant @__refbackend_kernel_name : memref<{{[0-9]+}}xi8> = dense<[
+// CHECK:         func.func private @refbackend_profile_begin() -> i64 attributes {llvm.emit_c_interface}
+// CHECK:         func.func private @refbackend_profile_end(memref<?xi8>, i64, i64) attributes {llvm.emit_c_interface}
+// CHECK-LABEL:   func.func @fill(
+// CHECK-SAME:                    %[[ARG:.*]]: memref<?x4xf32>) {
+// CHECK:           %[[NAME:.*]] = memref.get_global @__refbackend_kernel_name
+// CHECK:           %[[CAST:.*]] = memref.cast %[[NAME]] : memref<{{[0-9]+}}xi8> to memref<?xi8>
+// CHECK:           %[[C0:.*]] = arith.constant 0 : i64
+// CHECK:           %[[STATIC:.*]] = arith.constant 16 : i64
+// CHECK:           %[[DIM:.*]] = memref.dim %[[ARG]], %{{.*}} : memref<?x4xf32>
+// CHECK:           %[[DIM_I64:.*]] = arith.index_cast %[[DIM]] : index to i64
+// CHECK:           %[[SIZE:.*]] = arith.muli %[[STATIC]], %[[DIM_I64]] : i64
+// CHECK:           %[[BYTES:.*]] = arith.addi %[[C0]], %[[SIZE]] : i64
+// CHECK:           %[[START:.*]] = call @refbackend_profile_begin() : () -> i64
+// CHECK:           linalg.fill
+// CHECK:           call @refbackend_profile_end(%[[CAST]], %[[START]], %[[BYTES]]) : (memref<?xi8>, i64, i64) -> ()
+// CHECK:           return
+func.func @fill(%arg0: memref<?x4xf32>) {
+  %cst = arith.constant 0.0 : f32
+  linalg.fill ins(%cst : f32) outs(%arg0 : memref<?x4xf32>)
+  return
+}
+
+// -----
+
+// The ops nested in a kernel are timed as part of it.
+// CHECK-LABEL:   func.func @nested(
+// CHECK:           call @refbackend_profile_begin()
+// CHECK-NEXT:      linalg.generic
+// CHECK:             linalg.yield
+// CHECK:           call @refbackend_profile_end(
+// CHECK-NOT:       call @refbackend_profile_begin()
+// CHECK:           return
+#map = affine_map<(d0) -> (d0)>
+func.func @nested(%arg0: memref<4xf32>, %arg1: memref<4xf32>) {
+  linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%arg0 : memref<4xf32>) outs(%arg1 : memref<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    linalg.yield %in : f32
+  }
+  return
+}
+
+// -----
+
+// The tiles of a matmul and the fills of its padding are timed as a single
+// kernel, named after the matmul.
+// CHECK:         memref.global "private" constant @__refbackend_kernel_name : memref<{{[0-9]+}}xi8> = dense<[108, 105, 110, 97, 108, 103, 46, 109, 97, 116, 109, 117, 108,
+// CHECK-LABEL:   func.func @tiled(
+// CHECK:           %[[START:.*]] = call @refbackend_profile_begin()
+// CHECK-NEXT:      scf.for
+// CHECK-NOT:         call @refbackend_profile
+// CHECK:             linalg.fill
+// CHECK-NOT:         call @refbackend_profile
+// CHECK:             linalg.matmul
+// CHECK:           }
+// CHECK-NEXT:      call @refbackend_profile_end(%{{.*}}, %[[START]], %{{.*}})
+func.func @tiled(%lhs: memref<64x32xf32>, %rhs: memref<32x16xf32>, %out: memref<64x16xf32>) {
+  %c0 = arith.constant 0 : index
+  %c8 = arith.constant 8 : index
+  %c64 = arith.constant 64 : index
+  %cst = arith.constant 0.0 : f32
+  scf.for %i = %c0 to %c64 step %c8 {
+    %lhsTile = memref.subview %lhs[%i, 0] [8, 32] [1, 1] : memref<64x32xf32> to memref<8x32xf32, affine_map<(d0, d1)[s0] -> (d0 * 32 + s0 + d1)>>
+    %outTile = memref.subview %out[%i, 0] [8, 16] [1, 1] : memref<64x16xf32> to memref<8x16xf32, affine_map<(d0, d1)[s0] -> (d0 * 16 + s0 + d1)>>
+    linalg.fill ins(%cst : f32) outs(%outTile : memref<8x16xf32, affine_map<(d0, d1)[s0] -> (d0 * 16 + s0 + d1)>>) loc("mm")
+    linalg.matmul ins(%lhsTile, %rhs : memref<8x32xf32, affine_map<(d0, d1)[s0] -> (d0 * 32 + s0 + d1)>>, memref<32x16xf32>) outs(%outTile : memref<8x16xf32, affine_map<(d0, d1)[s0] -> (d0 * 16 + s0 + d1)>>) loc("mm")
+  }
+  return
+}
+
+// -----
+
+// The ops of a loop lowered from different ops are timed separately.
+// CHECK-LABEL:   func.func @loop_of_kernels(
+// CHECK:           scf.for
+// CHECK:             call @refbackend_profile_begin()
+// CHECK-NEXT:        linalg.fill
+// CHECK-NEXT:        call @refbackend_profile_end(
+// CHECK:             call @refbackend_profile_begin()
+// CHECK-NEXT:        linalg.fill
+// CHECK-NEXT:        call @refbackend_profile_end(
+func.func @loop_of_kernels(%arg0: memref<4xf32>, %arg1: memref<4xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %cst = arith.constant 0.0 : f32
+  scf.for %i = %c0 to %c4 step %c1 {
+    linalg.fill ins(%cst : f32) outs(%arg0 : memref<4xf32>) loc("a")
+    linalg.fill ins(%cst : f32) outs(%arg1 : memref<4xf32>) loc("b")
+  }
+  return
+}
+
+// -----
+
+// CHECK-NOT:     @refbackend_profile_begin
+// CHECK-LABEL:   func.func @no_kernels(
+func.func @no_kernels(%arg0: memref<4xf32>) {
+  return
+}
@@ -4,12 +4,8 @@
 // CHECK-LABEL:   func.func @f() -> i64 {
 // CHECK:           %[[MEMREF:.*]] = memref.get_global @global_seed : memref<i64>
 // CHECK:           %[[SEED:.*]] = memref.load %[[MEMREF]][] : memref<i64>
-// CHECK:           %[[MULTIPLIER:.*]] = arith.constant 6364136223846793005 : i64
-// CHECK:           %[[INC:.*]] = arith.constant 1442695040888963407 : i64
-// CHECK:           %[[MUL:.*]] = arith.muli %[[SEED]], %[[MULTIPLIER]] : i64
-// CHECK:           %[[TEMP:.*]] = arith.addi %[[MUL]], %[[INC]] : i64
-// CHECK:           %[[CST127:.*]] = arith.constant 127 : i64
-// CHECK:           %[[NEXT_SEED:.*]] = arith.andi %[[TEMP]], %[[CST127]] : i64
+// CHECK:           %[[C1:.*]] = arith.constant 1 : i64
+// CHECK:           %[[NEXT_SEED:.*]] = arith.addi %[[SEED]], %[[C1]] : i64
 // CHECK:           memref.store %[[NEXT_SEED]], %[[MEMREF]][] : memref<i64>
 // CHECK:           return %[[NEXT_SEED]] : i64
 module {
@@ -18,3 +14,13 @@ module {
     return %seed : i64
   }
 }
+
+// -----
+
+// CHECK-NOT:     memref.global
+// CHECK-LABEL:   func.func @no_rng() {
+module {
+  func.func @no_rng() {
+    return
+  }
+}
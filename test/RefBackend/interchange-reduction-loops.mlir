@@ -0,0 +1,70 @@
+// RUN: torch-mlir-opt %s -split-input-file -pass-pipeline='func.func(refback-interchange-reduction-loops)' | FileCheck %s
+
+#transposed = affine_map<(d0, d1) -> (d1, d0)>
+#rows = affine_map<(d0, d1) -> (d0)>
+
+// The sum over the rows of a transposed tensor reads the input in row-major
+// order and accumulates into a row of partial sums.
+// CHECK-DAG:     #[[IDENTITY:.*]] = affine_map<(d0, d1) -> (d0, d1)>
+// CHECK-DAG:     #[[COLUMNS:.*]] = affine_map<(d0, d1) -> (d1)>
+// CHECK-LABEL:   func.func @transposed_sum(
+// CHECK:           linalg.generic {indexing_maps = [#[[IDENTITY]], #[[COLUMNS]]], iterator_types = ["reduction", "parallel"]}
+// CHECK-SAME:        ins(%{{.*}} : tensor<?x?xf32>) outs(%{{.*}} : tensor<?xf32>)
+func.func @transposed_sum(%arg0: tensor<?x?xf32>, %init: tensor<?xf32>) -> tensor<?xf32> {
+  %0 = linalg.generic {indexing_maps = [#transposed, #rows], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<?x?xf32>) outs(%init : tensor<?xf32>) {
+  ^bb0(%x: f32, %acc: f32):
+    %1 = arith.addf %x, %acc : f32
+    linalg.yield %1 : f32
+  } -> tensor<?xf32>
+  return %0 : tensor<?xf32>
+}
+
+// -----
+
+#transposed = affine_map<(d0, d1) -> (d1, d0)>
+#rows = affine_map<(d0, d1) -> (d0)>
+
+// The index of the reduced loop follows it to its new position.
+// CHECK-LABEL:   func.func @transposed_argmax(
+// CHECK:           linalg.generic {{.*}} iterator_types = ["reduction", "parallel"]
+// CHECK:             linalg.index 0 : index
+func.func @transposed_argmax(%arg0: tensor<?x?xf32>, %initVal: tensor<?xf32>, %initIdx: tensor<?xi64>) -> (tensor<?xf32>, tensor<?xi64>) {
+  %0:2 = linalg.generic {indexing_maps = [#transposed, #rows, #rows], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<?x?xf32>) outs(%initVal, %initIdx : tensor<?xf32>, tensor<?xi64>) {
+  ^bb0(%x: f32, %val: f32, %idx: i64):
+    %1 = linalg.index 1 : index
+    %2 = arith.index_cast %1 : index to i64
+    %3 = arith.cmpf ogt, %x, %val : f32
+    %4 = arith.select %3, %x, %val : f32
+    %5 = arith.select %3, %2, %idx : i64
+    linalg.yield %4, %5 : f32, i64
+  } -> (tensor<?xf32>, tensor<?xi64>)
+  return %0#0, %0#1 : tensor<?xf32>, tensor<?xi64>
+}
+
+// -----
+
+#identity = affine_map<(d0, d1) -> (d0, d1)>
+#columns = affine_map<(d0, d1) -> (d1)>
+#lhs = affine_map<(d0, d1, d2) -> (d0, d2)>
+#rhs = affine_map<(d0, d1, d2) -> (d2, d1)>
+#out = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// A reduction already reading its input in row-major order, and a matmul,
+// none of whose inputs is indexed by all the loops, are left alone.
+// CHECK-LABEL:   func.func @unchanged(
+// CHECK:           linalg.generic {{.*}} iterator_types = ["reduction", "parallel"]
+// CHECK:           linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "reduction"]
+func.func @unchanged(%arg0: tensor<?x?xf32>, %init: tensor<?xf32>, %rhs: tensor<?x?xf32>, %out: tensor<?x?xf32>) -> (tensor<?xf32>, tensor<?x?xf32>) {
+  %0 = linalg.generic {indexing_maps = [#identity, #columns], iterator_types = ["reduction", "parallel"]} ins(%arg0 : tensor<?x?xf32>) outs(%init : tensor<?xf32>) {
+  ^bb0(%x: f32, %acc: f32):
+    %2 = arith.addf %x, %acc : f32
+    linalg.yield %2 : f32
+  } -> tensor<?xf32>
+  %1 = linalg.generic {indexing_maps = [#lhs, #rhs, #out], iterator_types = ["parallel", "parallel", "reduction"]} ins(%arg0, %rhs : tensor<?x?xf32>, tensor<?x?xf32>) outs(%out : tensor<?x?xf32>) {
+  ^bb0(%a: f32, %b: f32, %acc: f32):
+    %2 = arith.mulf %a, %b : f32
+    %3 = arith.addf %2, %acc : f32
+    linalg.yield %3 : f32
+  } -> tensor<?x?xf32>
+  return %0, %1 : tensor<?xf32>, tensor<?x?xf32>
+}
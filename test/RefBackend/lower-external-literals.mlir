@@ -0,0 +1,35 @@
+// RUN: torch-mlir-opt %s -refback-lower-global-tensors | FileCheck %s
+
+// CHECK:         memref.global "private" @__refbackend_external_literal_0 : memref<2xf32>
+// CHECK:         memref.global "private" @__refbackend_external_literal_1 : memref<3xi64>
+// CHECK-NOT:     memref.global
+
+// The same literal used twice is loaded once.
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:            %[[ARG:.*]]: tensor<2xf32>) -> (tensor<2xf32>, tensor<3xi64>) {
+// CHECK:           %[[W:.*]] = memref.get_global @__refbackend_external_literal_0 : memref<2xf32>
+// CHECK:           %[[W_TENSOR:.*]] = bufferization.to_tensor %[[W]] : memref<2xf32>
+// CHECK:           %[[SAME_W:.*]] = memref.get_global @__refbackend_external_literal_0 : memref<2xf32>
+// CHECK:           %[[SAME_W_TENSOR:.*]] = bufferization.to_tensor %[[SAME_W]] : memref<2xf32>
+// CHECK:           %[[SUM:.*]] = arith.addf %[[W_TENSOR]], %[[SAME_W_TENSOR]] : tensor<2xf32>
+// CHECK:           %[[I:.*]] = memref.get_global @__refbackend_external_literal_1 : memref<3xi64>
+// CHECK:           %[[I_TENSOR:.*]] = bufferization.to_tensor %[[I]] : memref<3xi64>
+// CHECK:           return %[[SUM]], %[[I_TENSOR]] : tensor<2xf32>, tensor<3xi64>
+func.func @forward(%arg0: tensor<2xf32>) -> (tensor<2xf32>, tensor<3xi64>) {
+  %0 = torch_c.external_literal "weights.bin", 0 : tensor<2xf32>
+  %1 = torch_c.external_literal "weights.bin", 0 : tensor<2xf32>
+  %2 = arith.addf %0, %1 : tensor<2xf32>
+  %3 = torch_c.external_literal "weights.bin", 8 : tensor<3xi64>
+  return %2, %3 : tensor<2xf32>, tensor<3xi64>
+}
+
+// CHECK-LABEL:   func.func @refbackend_load_external_literals(
+// CHECK-SAME:            %[[W_DATA:.*]]: tensor<2xf32>, %[[I_DATA:.*]]: tensor<3xi64>)
+// CHECK-SAME:            attributes {refbackend.external_literals = [{file = "weights.bin", offset = 0 : i64, type = memref<2xf32>}, {file = "weights.bin", offset = 8 : i64, type = memref<3xi64>}]} {
+// CHECK:           %[[W_SOURCE:.*]] = bufferization.to_memref %[[W_DATA]] : memref<2xf32>
+// CHECK:           %[[W_TARGET:.*]] = memref.get_global @__refbackend_external_literal_0 : memref<2xf32>
+// CHECK:           memref.copy %[[W_SOURCE]], %[[W_TARGET]] : memref<2xf32> to memref<2xf32>
+// CHECK:           %[[I_SOURCE:.*]] = bufferization.to_memref %[[I_DATA]] : memref<3xi64>
+// CHECK:           %[[I_TARGET:.*]] = memref.get_global @__refbackend_external_literal_1 : memref<3xi64>
+// CHECK:           memref.copy %[[I_SOURCE]], %[[I_TARGET]] : memref<3xi64> to memref<3xi64>
+// CHECK:           return
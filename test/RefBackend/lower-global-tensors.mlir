@@ -0,0 +1,37 @@
+// RUN: torch-mlir-opt %s -refback-lower-global-tensors | FileCheck %s
+
+// CHECK-LABEL:   memref.global "private" @__refbackend_state_cache : memref<2xf32> = dense<0.000000e+00>
+// CHECK-NOT:     torch_c.global_tensor
+torch_c.global_tensor "private" @cache : tensor<2xf32> = dense<0.0> : tensor<2xf32>
+
+// CHECK-LABEL:   func.func @update(
+// CHECK-SAME:            %[[ARG:.*]]: tensor<2xf32>) {
+// CHECK:           %[[GLOBAL:.*]] = memref.get_global @__refbackend_state_cache : memref<2xf32>
+// CHECK:           %[[VALUE:.*]] = bufferization.to_tensor %[[GLOBAL]] : memref<2xf32>
+// CHECK:           %[[SUM:.*]] = arith.addf %[[VALUE]], %[[ARG]] : tensor<2xf32>
+// CHECK:           %[[SOURCE:.*]] = bufferization.to_memref %[[SUM]] : memref<2xf32>
+// CHECK:           %[[TARGET:.*]] = memref.get_global @__refbackend_state_cache : memref<2xf32>
+// CHECK:           memref.copy %[[SOURCE]], %[[TARGET]] : memref<2xf32> to memref<2xf32>
+// CHECK:           return
+func.func @update(%arg0: tensor<2xf32>) {
+  %0 = torch_c.global_tensor.load @cache : tensor<2xf32>
+  %1 = arith.addf %0, %arg0 : tensor<2xf32>
+  torch_c.global_tensor.store @cache, %1 : tensor<2xf32>
+  return
+}
+
+// The old value is returned after the store, so it is copied out of the
+// global.
+// CHECK-LABEL:   func.func @swap(
+// CHECK-SAME:            %[[ARG:.*]]: tensor<2xf32>) -> tensor<2xf32> {
+// CHECK:           %[[GLOBAL:.*]] = memref.get_global @__refbackend_state_cache : memref<2xf32>
+// CHECK:           %[[COPY:.*]] = memref.alloc() : memref<2xf32>
+// CHECK:           memref.copy %[[GLOBAL]], %[[COPY]] : memref<2xf32> to memref<2xf32>
+// CHECK:           %[[VALUE:.*]] = bufferization.to_tensor %[[COPY]] : memref<2xf32>
+// CHECK:           memref.copy
+// CHECK:           return %[[VALUE]] : tensor<2xf32>
+func.func @swap(%arg0: tensor<2xf32>) -> tensor<2xf32> {
+  %0 = torch_c.global_tensor.load @cache : tensor<2xf32>
+  torch_c.global_tensor.store @cache, %arg0 : tensor<2xf32>
+  return %0 : tensor<2xf32>
+}
@@ -0,0 +1,82 @@
+// RUN: torch-mlir-opt %s -refback-lower-linalg-to-library-calls -split-input-file | FileCheck %s
+
+// CHECK:         func.func private @refbackend_kernel_matmul_f32(memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>) attributes {llvm.emit_c_interface}
+// CHECK-LABEL:   func.func @matmul(
+// CHECK-SAME:            %[[LHS:.*]]: memref<4x8xf32>, %[[RHS:.*]]: memref<8x16xf32>, %[[OUT:.*]]: memref<4x16xf32>) {
+// CHECK:           %[[LHS_CAST:.*]] = memref.cast %[[LHS]] : memref<4x8xf32> to memref<?x?xf32>
+// CHECK:           %[[RHS_CAST:.*]] = memref.cast %[[RHS]] : memref<8x16xf32> to memref<?x?xf32>
+// CHECK:           %[[OUT_CAST:.*]] = memref.cast %[[OUT]] : memref<4x16xf32> to memref<?x?xf32>
+// CHECK:           call @refbackend_kernel_matmul_f32(%[[LHS_CAST]], %[[RHS_CAST]], %[[OUT_CAST]])
+// CHECK-NOT:       linalg.matmul
+func.func @matmul(%lhs: memref<4x8xf32>, %rhs: memref<8x16xf32>, %out: memref<4x16xf32>) {
+  linalg.matmul ins(%lhs, %rhs : memref<4x8xf32>, memref<8x16xf32>) outs(%out : memref<4x16xf32>)
+  return
+}
+
+// -----
+
+// CHECK:         func.func private @refbackend_kernel_batch_matmul_f32(memref<?x?x?xf32>, memref<?x?x?xf32>, memref<?x?x?xf32>) attributes {llvm.emit_c_interface}
+// CHECK-LABEL:   func.func @batch_matmul(
+// CHECK:           call @refbackend_kernel_batch_matmul_f32(
+// CHECK-NOT:       linalg.batch_matmul
+func.func @batch_matmul(%lhs: memref<2x4x8xf32>, %rhs: memref<2x8x16xf32>, %out: memref<2x4x16xf32>) {
+  linalg.batch_matmul ins(%lhs, %rhs : memref<2x4x8xf32>, memref<2x8x16xf32>) outs(%out : memref<2x4x16xf32>)
+  return
+}
+
+// -----
+
+// CHECK:         func.func private @refbackend_kernel_conv_2d_nchw_fchw_f32(memref<?x?x?x?xf32>, memref<?x?x?x?xf32>, memref<?x?x?x?xf32>, i64, i64, i64, i64) attributes {llvm.emit_c_interface}
+// CHECK-LABEL:   func.func @conv(
+// CHECK:           %[[STRIDE_H:.*]] = arith.constant 2 : i64
+// CHECK:           %[[STRIDE_W:.*]] = arith.constant 2 : i64
+// CHECK:           %[[DILATION_H:.*]] = arith.constant 1 : i64
+// CHECK:           %[[DILATION_W:.*]] = arith.constant 1 : i64
+// CHECK:           call @refbackend_kernel_conv_2d_nchw_fchw_f32(%{{.*}}, %{{.*}}, %{{.*}}, %[[STRIDE_H]], %[[STRIDE_W]], %[[DILATION_H]], %[[DILATION_W]])
+// CHECK-NOT:       linalg.conv_2d_nchw_fchw
+func.func @conv(%input: memref<1x3x9x9xf32>, %filter: memref<8x3x3x3xf32>, %out: memref<1x8x4x4xf32>) {
+  linalg.conv_2d_nchw_fchw {dilations = dense<1> : vector<2xi64>, strides = dense<2> : vector<2xi64>}
+    ins(%input, %filter : memref<1x3x9x9xf32>, memref<8x3x3x3xf32>) outs(%out : memref<1x8x4x4xf32>)
+  return
+}
+
+// -----
+
+// The kernels only take statically shaped f32 operands.
+
+// CHECK-NOT:     refbackend_kernel
+// CHECK-LABEL:   func.func @unsupported(
+// CHECK:           linalg.matmul ins(%{{.*}}, %{{.*}} : memref<?x8xf32>
+// CHECK:           linalg.matmul ins(%{{.*}}, %{{.*}} : memref<4x8xf64>
+func.func @unsupported(%dynamic: memref<?x8xf32>, %rhs: memref<8x16xf32>, %out: memref<?x16xf32>,
+                       %f64: memref<4x8xf64>, %rhs_f64: memref<8x16xf64>, %out_f64: memref<4x16xf64>) {
+  linalg.matmul ins(%dynamic, %rhs : memref<?x8xf32>, memref<8x16xf32>) outs(%out : memref<?x16xf32>)
+  linalg.matmul ins(%f64, %rhs_f64 : memref<4x8xf64>, memref<8x16xf64>) outs(%out_f64 : memref<4x16xf64>)
+  return
+}
+
+// -----
+
+#strided = affine_map<(d0, d1) -> (d0 * 32 + d1)>
+
+// The strided operands are copied to contiguous buffers around the call, and
+// the output is copied back.
+
+// CHECK-LABEL:   func.func @strided(
+// CHECK-SAME:            %[[LHS:.*]]: memref<4x8xf32, #{{.*}}>, %[[RHS:.*]]: memref<8x16xf32>, %[[OUT:.*]]: memref<4x16xf32, #{{.*}}>) {
+// CHECK:           %[[LHS_COPY:.*]] = memref.alloc() : memref<4x8xf32>
+// CHECK:           memref.copy %[[LHS]], %[[LHS_COPY]]
+// CHECK:           %[[LHS_CAST:.*]] = memref.cast %[[LHS_COPY]] : memref<4x8xf32> to memref<?x?xf32>
+// CHECK:           %[[RHS_CAST:.*]] = memref.cast %[[RHS]] : memref<8x16xf32> to memref<?x?xf32>
+// CHECK:           %[[OUT_COPY:.*]] = memref.alloc() : memref<4x16xf32>
+// CHECK:           memref.copy %[[OUT]], %[[OUT_COPY]]
+// CHECK:           %[[OUT_CAST:.*]] = memref.cast %[[OUT_COPY]] : memref<4x16xf32> to memref<?x?xf32>
+// CHECK:           call @refbackend_kernel_matmul_f32(%[[LHS_CAST]], %[[RHS_CAST]], %[[OUT_CAST]])
+// CHECK-NEXT:      memref.dealloc %[[LHS_COPY]]
+// CHECK-NEXT:      memref.copy %[[OUT_COPY]], %[[OUT]]
+// CHECK-NEXT:      memref.dealloc %[[OUT_COPY]]
+// CHECK-NOT:       linalg.matmul
+func.func @strided(%lhs: memref<4x8xf32, #strided>, %rhs: memref<8x16xf32>, %out: memref<4x16xf32, #strided>) {
+  linalg.matmul ins(%lhs, %rhs : memref<4x8xf32, #strided>, memref<8x16xf32>) outs(%out : memref<4x16xf32, #strided>)
+  return
+}
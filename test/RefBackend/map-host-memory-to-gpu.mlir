@@ -0,0 +1,69 @@
+// RUN: torch-mlir-opt %s -refback-map-host-memory-to-gpu -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK:         memref.global "private" @weight : memref<4xf32> = dense<1.000000e+00> {alignment = 4096 : i64}
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:                       %[[ARG0:.*]]: memref<*xf32>, %[[ARG1:.*]]: memref<*xf32>)
+// CHECK-NOT:       gpu.host_register
+// CHECK:           %[[INPUT:.*]] = memref.cast %[[ARG0]] : memref<*xf32> to memref<?xf32>
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[SIZE:.*]] = memref.dim %[[ARG0]], %[[C0]] : memref<*xf32>
+// CHECK:           %[[STAGED_INPUT:.*]] = memref.alloc(%[[SIZE]]) : memref<?xf32>
+// CHECK:           %[[T0:.*]] = gpu.wait async
+// CHECK:           %[[T1:.*]] = gpu.memcpy async [%[[T0]]] %[[STAGED_INPUT]], %[[INPUT]] : memref<?xf32>, memref<?xf32>
+// CHECK:           gpu.wait [%[[T1]]]
+// CHECK:           %[[OUTPUT:.*]] = memref.cast %[[ARG1]] : memref<*xf32> to memref<4xf32>
+// CHECK:           %[[STAGED_OUTPUT:.*]] = memref.alloc() : memref<4xf32>
+// CHECK-NOT:       gpu.memcpy
+// CHECK:           %[[X:.*]] = memref.load %[[STAGED_INPUT]]
+// CHECK:           memref.store %[[X]], %[[STAGED_OUTPUT]]
+// CHECK:           memref.dealloc %[[STAGED_INPUT]] : memref<?xf32>
+// CHECK:           %[[T2:.*]] = gpu.wait async
+// CHECK:           %[[T3:.*]] = gpu.memcpy async [%[[T2]]] %[[OUTPUT]], %[[STAGED_OUTPUT]] : memref<4xf32>, memref<4xf32>
+// CHECK:           gpu.wait [%[[T3]]]
+// CHECK:           memref.dealloc %[[STAGED_OUTPUT]] : memref<4xf32>
+// CHECK:           return
+// CHECK-LABEL:   func.func @refbackend_register_gpu_memory() attributes {llvm.emit_c_interface} {
+// CHECK:           %[[WEIGHT:.*]] = memref.get_global @weight : memref<4xf32>
+// CHECK:           %[[WEIGHT_UNRANKED:.*]] = memref.cast %[[WEIGHT]] : memref<4xf32> to memref<*xf32>
+// CHECK:           gpu.host_register %[[WEIGHT_UNRANKED]] : memref<*xf32>
+// CHECK:           return
+memref.global "private" constant @weight : memref<4xf32> = dense<1.0>
+func.func @forward(%arg0: memref<*xf32>, %arg1: memref<*xf32>) attributes {llvm.emit_c_interface, refbackend.result_types = [memref<4xf32>]} {
+  %0 = memref.cast %arg0 : memref<*xf32> to memref<?xf32>
+  %1 = memref.cast %arg1 : memref<*xf32> to memref<4xf32>
+  %c0 = arith.constant 0 : index
+  %2 = memref.load %0[%c0] : memref<?xf32>
+  %3 = memref.get_global @weight : memref<4xf32>
+  %4 = memref.load %3[%c0] : memref<4xf32>
+  %5 = arith.addf %2, %4 : f32
+  memref.store %5, %1[%c0] : memref<4xf32>
+  return
+}
+
+// -----
+
+// Without globals, nothing is registered, and the private functions are
+// called with memory that is already staged.
+// CHECK-NOT:     memref.global
+// CHECK-LABEL:   func.func private @callee(
+// CHECK-SAME:                              %[[ARG:.*]]: memref<2xf32>) {
+// CHECK-NEXT:      return
+// CHECK-LABEL:   func.func @no_globals(
+// CHECK:           gpu.memcpy
+// CHECK-NOT:     func.func @refbackend_register_gpu_memory
+func.func private @callee(%arg0: memref<2xf32>) {
+  return
+}
+func.func @no_globals(%arg0: memref<*xf32>) attributes {llvm.emit_c_interface} {
+  %0 = memref.cast %arg0 : memref<*xf32> to memref<2xf32>
+  call @callee(%0) : (memref<2xf32>) -> ()
+  return
+}
+
+// -----
+
+func.func @strided(%arg0: memref<*xf32>) attributes {llvm.emit_c_interface} {
+  // expected-error @+1 {{strided arguments cannot be mapped to the GPU}}
+  %0 = memref.cast %arg0 : memref<*xf32> to memref<?xf32, affine_map<(d0)[s0, s1] -> (d0 * s1 + s0)>>
+  return
+}
@@ -0,0 +1,65 @@
+// RUN: torch-mlir-opt %s -refback-munge-calling-conventions="destination-passing=true" -split-input-file | FileCheck %s
+
+// CHECK-LABEL:   func.func @in_place(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>, %[[ARG1:.*]]: memref<*xf32>)
+// CHECK-SAME:            attributes {llvm.emit_c_interface, refbackend.result_types = [memref<4xf32>]} {
+// CHECK:           %[[OUT:.*]] = memref.cast %[[ARG1]] : memref<*xf32> to memref<4xf32>
+// CHECK:           %[[IN:.*]] = memref.cast %[[ARG0]] : memref<*xf32> to memref<4xf32>
+// CHECK-NOT:       memref.alloc
+// CHECK:           linalg.copy ins(%[[IN]] : memref<4xf32>) outs(%[[OUT]] : memref<4xf32>)
+// CHECK-NOT:       memref.copy
+// CHECK:           return
+func.func @in_place(%arg0: memref<4xf32>) -> memref<4xf32> {
+  %0 = memref.alloc() : memref<4xf32>
+  linalg.copy ins(%arg0 : memref<4xf32>) outs(%0 : memref<4xf32>)
+  return %0 : memref<4xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @copy_and_scalar(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>, %[[ARG1:.*]]: memref<*xf32>, %[[ARG2:.*]]: memref<*xi64>)
+// CHECK-SAME:            attributes {llvm.emit_c_interface, refbackend.result_types = [memref<4xf32>, i64]} {
+// CHECK:           %[[OUT0:.*]] = memref.cast %[[ARG1]] : memref<*xf32> to memref<4xf32>
+// CHECK:           %[[OUT1:.*]] = memref.cast %[[ARG2]] : memref<*xi64> to memref<i64>
+// CHECK:           %[[IN:.*]] = memref.cast %[[ARG0]] : memref<*xf32> to memref<4xf32>
+// CHECK:           %[[C4:.*]] = arith.constant 4 : i64
+// CHECK:           memref.copy %[[IN]], %[[OUT0]] : memref<4xf32> to memref<4xf32>
+// CHECK:           memref.store %[[C4]], %[[OUT1]][] : memref<i64>
+// CHECK:           return
+func.func @copy_and_scalar(%arg0: memref<4xf32>) -> (memref<4xf32>, i64) {
+  %c4 = arith.constant 4 : i64
+  return %arg0, %c4 : memref<4xf32>, i64
+}
+
+// -----
+
+// Dynamically shaped results keep going through the callbacks.
+// CHECK-LABEL:   func.func @dynamic(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>) attributes {llvm.emit_c_interface} {
+// CHECK:           call @refbackend_consume_func_return_mrf32
+func.func @dynamic(%arg0: memref<?xf32>) -> memref<?xf32> {
+  return %arg0 : memref<?xf32>
+}
+
+// -----
+
+// The arguments with a layout are read through the strides of their
+// descriptors, and the results with a layout are written to contiguous
+// outputs.
+// CHECK-LABEL:   func.func @strided(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>, %[[ARG1:.*]]: memref<*xf32>)
+// CHECK-SAME:            attributes {llvm.emit_c_interface, refbackend.result_types = [memref<4xf32>], refbackend.strided_arguments} {
+// CHECK:           %[[OUT:.*]] = memref.cast %[[ARG1]] : memref<*xf32> to memref<4xf32>
+// CHECK:           %[[IN:.*]] = memref.cast %[[ARG0]] : memref<*xf32> to memref<4xf32, #{{.*}}>
+// CHECK-NOT:       memref.alloc
+// CHECK:           linalg.copy ins(%[[IN]] : memref<4xf32, #{{.*}}>) outs(%[[OUT]] : memref<4xf32>)
+// CHECK-NOT:       memref.copy
+// CHECK:           return
+#strided = affine_map<(d0)[s0, s1] -> (d0 * s1 + s0)>
+func.func @strided(%arg0: memref<4xf32, #strided>) -> memref<4xf32, #strided> {
+  %0 = memref.alloc() : memref<4xf32>
+  linalg.copy ins(%arg0 : memref<4xf32, #strided>) outs(%0 : memref<4xf32>)
+  %1 = memref.cast %0 : memref<4xf32> to memref<4xf32, #strided>
+  return %1 : memref<4xf32, #strided>
+}
@@ -0,0 +1,46 @@
+// RUN: torch-mlir-opt %s -refback-munge-calling-conventions="owned-results=true" -split-input-file | FileCheck %s
+
+// CHECK-LABEL:   func.func @allocated(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>) attributes {llvm.emit_c_interface} {
+// CHECK:           %[[ALLOC:.*]] = memref.alloc(%{{.*}}) : memref<?xf32>
+// CHECK-NOT:       memref.copy
+// CHECK:           %[[RESULT:.*]] = memref.cast %[[ALLOC]] : memref<?xf32> to memref<*xf32>
+// CHECK:           call @refbackend_consume_func_return_mrf32(%[[RESULT]]) : (memref<*xf32>) -> ()
+// CHECK:           return
+func.func @allocated(%arg0: memref<?xf32>) -> memref<?xf32> {
+  %c0 = arith.constant 0 : index
+  %0 = memref.dim %arg0, %c0 : memref<?xf32>
+  %1 = memref.alloc(%0) : memref<?xf32>
+  return %1 : memref<?xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @argument(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>) attributes {llvm.emit_c_interface} {
+// CHECK:           %[[VAL:.*]] = memref.cast %[[ARG0]] : memref<*xf32> to memref<?xf32>
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[DIM:.*]] = memref.dim %[[VAL]], %[[C0]] : memref<?xf32>
+// CHECK:           %[[COPY:.*]] = memref.alloc(%[[DIM]]) : memref<?xf32>
+// CHECK:           memref.copy %[[VAL]], %[[COPY]] : memref<?xf32> to memref<?xf32>
+// CHECK:           %[[RESULT:.*]] = memref.cast %[[COPY]] : memref<?xf32> to memref<*xf32>
+// CHECK:           call @refbackend_consume_func_return_mrf32(%[[RESULT]]) : (memref<*xf32>) -> ()
+// CHECK:           return
+func.func @argument(%arg0: memref<?xf32>) -> memref<?xf32> {
+  return %arg0 : memref<?xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @returned_twice(
+// CHECK:           %[[ALLOC:.*]] = memref.alloc() : memref<2xf32>
+// CHECK:           %[[RESULT0:.*]] = memref.cast %[[ALLOC]] : memref<2xf32> to memref<*xf32>
+// CHECK:           %[[COPY:.*]] = memref.alloc() : memref<2xf32>
+// CHECK:           memref.copy %[[ALLOC]], %[[COPY]] : memref<2xf32> to memref<2xf32>
+// CHECK:           %[[RESULT1:.*]] = memref.cast %[[COPY]] : memref<2xf32> to memref<*xf32>
+// CHECK:           call @refbackend_consume_func_return_mrf32_mrf32(%[[RESULT0]], %[[RESULT1]]) : (memref<*xf32>, memref<*xf32>) -> ()
+// CHECK:           return
+func.func @returned_twice() -> (memref<2xf32>, memref<2xf32>) {
+  %0 = memref.alloc() : memref<2xf32>
+  return %0, %0 : memref<2xf32>, memref<2xf32>
+}
@@ -70,3 +70,34 @@ func.func @multiple_return_values(%arg0: memref<?xf32>, %arg1: memref<?xf32>, %a
 func.func @two_return_values(%arg0: memref<?xf32>, %arg1: memref<?xi64>) -> (memref<?xf32>, memref<?xi64>) {
   return %arg0 ,%arg1 : memref<?xf32>, memref<?xi64>
 }
+
+// -----
+
+// CHECK-LABEL:   func.func @bf16(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xbf16>) attributes {llvm.emit_c_interface} {
+// CHECK:           %[[VAL:.*]] = memref.cast %[[ARG0]] : memref<*xbf16> to memref<?xbf16>
+// CHECK:           %[[RESULT:.*]] = memref.cast %[[VAL]] : memref<?xbf16> to memref<*xbf16>
+// CHECK:           call @refbackend_consume_func_return_mrbf16(%[[RESULT]]) : (memref<*xbf16>) -> ()
+// CHECK:           return
+func.func @bf16(%arg0: memref<?xbf16>) -> memref<?xbf16> {
+  return %arg0 : memref<?xbf16>
+}
+
+// -----
+
+// A result with a layout that isn't allocated by the function is copied into
+// a contiguous buffer.
+// CHECK-LABEL:   func.func @strided(
+// CHECK-SAME:            %[[ARG0:.*]]: memref<*xf32>) attributes {llvm.emit_c_interface, refbackend.strided_arguments} {
+// CHECK:           %[[VAL:.*]] = memref.cast %[[ARG0]] : memref<*xf32> to memref<?xf32, #{{.*}}>
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[DIM:.*]] = memref.dim %[[VAL]], %[[C0]] : memref<?xf32, #{{.*}}>
+// CHECK:           %[[COPY:.*]] = memref.alloc(%[[DIM]]) : memref<?xf32>
+// CHECK:           memref.copy %[[VAL]], %[[COPY]] : memref<?xf32, #{{.*}}> to memref<?xf32>
+// CHECK:           %[[RESULT:.*]] = memref.cast %[[COPY]] : memref<?xf32> to memref<*xf32>
+// CHECK:           call @refbackend_consume_func_return_mrf32(%[[RESULT]]) : (memref<*xf32>) -> ()
+// CHECK:           return
+#strided = affine_map<(d0)[s0, s1] -> (d0 * s1 + s0)>
+func.func @strided(%arg0: memref<?xf32, #strided>) -> memref<?xf32, #strided> {
+  return %arg0 : memref<?xf32, #strided>
+}
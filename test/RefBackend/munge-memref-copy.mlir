@@ -0,0 +1,23 @@
+// RUN: torch-mlir-opt %s -refback-munge-memref-copy -split-input-file | FileCheck %s
+
+// CHECK-LABEL:   func.func @contiguous(
+// CHECK-SAME:                          %[[FROM:.*]]: memref<?x4xf32>, %[[TO:.*]]: memref<?x4xf32>) {
+// CHECK:           memref.copy %[[FROM]], %[[TO]] : memref<?x4xf32> to memref<?x4xf32>
+// CHECK-NOT:       linalg.generic
+func.func @contiguous(%arg0: memref<?x4xf32>, %arg1: memref<?x4xf32>) {
+  memref.copy %arg0, %arg1 : memref<?x4xf32> to memref<?x4xf32>
+  return
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @strided(
+// CHECK-SAME:                       %[[FROM:.*]]: memref<2x4xf32, #{{.*}}>, %[[TO:.*]]: memref<2x4xf32>) {
+// CHECK-NOT:       memref.copy
+// CHECK:           linalg.generic {{.*}} ins(%[[FROM]] : memref<2x4xf32, #{{.*}}>) outs(%[[TO]] : memref<2x4xf32>)
+// CHECK:             linalg.yield
+#strided = affine_map<(d0, d1)[s0] -> (d0 * 8 + s0 + d1)>
+func.func @strided(%arg0: memref<2x4xf32, #strided>, %arg1: memref<2x4xf32>) {
+  memref.copy %arg0, %arg1 : memref<2x4xf32, #strided> to memref<2x4xf32>
+  return
+}
@@ -0,0 +1,71 @@
+// RUN: torch-mlir-opt %s -refback-plan-memory -split-input-file | FileCheck %s
+// RUN: torch-mlir-opt %s -refback-plan-memory="arena-per-call=true" -split-input-file | FileCheck %s --check-prefix=PER-CALL
+
+// %0 is dead once %1 is computed, so %2 reuses its memory.
+// CHECK:         memref.global "private" @__refbackend_arena_chain : memref<512xi8> = uninitialized {alignment = 64 : i64}
+// CHECK-LABEL:   func.func @chain(
+// CHECK-SAME:                     %[[ARG:.*]]: memref<8x8xf32>) -> memref<8x8xf32> {
+// CHECK:           %[[ARENA:.*]] = memref.get_global @__refbackend_arena_chain : memref<512xi8>
+// CHECK:           %[[OFFSET0:.*]] = arith.constant 0 : index
+// CHECK:           %[[BUF0:.*]] = memref.view %[[ARENA]][%[[OFFSET0]]][] : memref<512xi8> to memref<8x8xf32>
+// CHECK:           %[[OFFSET1:.*]] = arith.constant 256 : index
+// CHECK:           %[[BUF1:.*]] = memref.view %[[ARENA]][%[[OFFSET1]]][] : memref<512xi8> to memref<8x8xf32>
+// CHECK:           %[[OFFSET2:.*]] = arith.constant 0 : index
+// CHECK:           %[[BUF2:.*]] = memref.view %[[ARENA]][%[[OFFSET2]]][] : memref<512xi8> to memref<8x8xf32>
+// CHECK:           %[[RET:.*]] = memref.alloc() : memref<8x8xf32>
+// CHECK:           return %[[RET]] : memref<8x8xf32>
+
+// PER-CALL-NOT:     memref.global
+// PER-CALL-LABEL:   func.func @chain(
+// PER-CALL:           %[[ARENA:.*]] = memref.alloc() {alignment = 64 : i64} : memref<512xi8>
+// PER-CALL-COUNT-3:   memref.view %[[ARENA]]
+// PER-CALL:           %[[RET:.*]] = memref.alloc() : memref<8x8xf32>
+// PER-CALL:           memref.dealloc %[[ARENA]] : memref<512xi8>
+// PER-CALL:           return %[[RET]] : memref<8x8xf32>
+func.func @chain(%arg0: memref<8x8xf32>) -> memref<8x8xf32> {
+  %0 = memref.alloc() : memref<8x8xf32>
+  linalg.copy ins(%arg0 : memref<8x8xf32>) outs(%0 : memref<8x8xf32>)
+  %1 = memref.alloc() : memref<8x8xf32>
+  linalg.copy ins(%0 : memref<8x8xf32>) outs(%1 : memref<8x8xf32>)
+  %2 = memref.alloc() : memref<8x8xf32>
+  linalg.copy ins(%1 : memref<8x8xf32>) outs(%2 : memref<8x8xf32>)
+  %3 = memref.alloc() : memref<8x8xf32>
+  linalg.copy ins(%2 : memref<8x8xf32>) outs(%3 : memref<8x8xf32>)
+  return %3 : memref<8x8xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @no_plan$dynamic_and_escaping(
+// CHECK-NOT:       memref.view
+// CHECK:           memref.alloc(%{{.*}}) : memref<?xf32>
+// CHECK:           memref.alloc() : memref<4xf32>
+// CHECK:           memref.cast
+func.func @no_plan$dynamic_and_escaping(%arg0: index) -> memref<?xf32> {
+  %0 = memref.alloc(%arg0) : memref<?xf32>
+  %1 = memref.alloc() : memref<4xf32>
+  %2 = memref.cast %1 : memref<4xf32> to memref<?xf32>
+  return %2 : memref<?xf32>
+}
+
+// -----
+
+// The library kernels don't hold on to their operands after the call, so the
+// buffers they are passed are still planned.
+// CHECK-LABEL:   func.func @library_call(
+// CHECK:           %[[ARENA:.*]] = memref.get_global @__refbackend_arena_library_call : memref<256xi8>
+// CHECK:           %[[BUF:.*]] = memref.view %[[ARENA]]
+// CHECK:           %[[CAST:.*]] = memref.cast %[[BUF]] : memref<8x8xf32> to memref<?x?xf32>
+// CHECK:           call @refbackend_kernel_matmul_f32(%{{.*}}, %{{.*}}, %[[CAST]])
+// PER-CALL-LABEL:   func.func @library_call(
+// PER-CALL:           memref.view
+func.func private @refbackend_kernel_matmul_f32(memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>) attributes {llvm.emit_c_interface}
+func.func @library_call(%arg0: memref<8x8xf32>) -> memref<8x8xf32> {
+  %0 = memref.alloc() : memref<8x8xf32>
+  %1 = memref.cast %arg0 : memref<8x8xf32> to memref<?x?xf32>
+  %2 = memref.cast %0 : memref<8x8xf32> to memref<?x?xf32>
+  call @refbackend_kernel_matmul_f32(%1, %1, %2) : (memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>) -> ()
+  %3 = memref.alloc() : memref<8x8xf32>
+  linalg.copy ins(%0 : memref<8x8xf32>) outs(%3 : memref<8x8xf32>)
+  return %3 : memref<8x8xf32>
+}
@@ -0,0 +1,118 @@
+// RUN: torch-mlir-opt %s -refback-tile-and-pad-linalg-ops -split-input-file | FileCheck %s
+
+// CHECK-LABEL:   func.func @matmul$static(
+// CHECK:           scf.for
+// CHECK:             scf.for
+// CHECK:               scf.for
+// CHECK-NOT:             tensor.pad
+// CHECK:                 linalg.matmul ins(%{{.*}}, %{{.*}} : tensor<8x8xf32>, tensor<8x16xf32>) outs(%{{.*}} : tensor<8x16xf32>) -> tensor<8x16xf32>
+func.func @matmul$static(%arg0: tensor<16x32xf32>, %arg1: tensor<32x64xf32>, %arg2: tensor<16x64xf32>) -> tensor<16x64xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<16x32xf32>, tensor<32x64xf32>) outs(%arg2 : tensor<16x64xf32>) -> tensor<16x64xf32>
+  return %0 : tensor<16x64xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @matmul$dynamic(
+// CHECK:           scf.for
+// CHECK:             scf.for
+// CHECK:               scf.for
+// CHECK:                 tensor.pad
+// CHECK:                 tensor.pad
+// CHECK:                 tensor.pad
+// CHECK:                 linalg.matmul ins(%{{.*}}, %{{.*}} : tensor<8x8xf32>, tensor<8x16xf32>) outs(%{{.*}} : tensor<8x16xf32>) -> tensor<8x16xf32>
+// CHECK:                 tensor.extract_slice
+func.func @matmul$dynamic(%arg0: tensor<?x?xf32>, %arg1: tensor<?x?xf32>, %arg2: tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<?x?xf32>, tensor<?x?xf32>) outs(%arg2 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @elementwise(
+// CHECK-NOT:       scf.for
+// CHECK:           linalg.generic
+func.func @elementwise(%arg0: tensor<16x64xf32>) -> tensor<16x64xf32> {
+  %0 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<16x64xf32>) outs(%arg0 : tensor<16x64xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %1 = arith.negf %in : f32
+    linalg.yield %1 : f32
+  } -> tensor<16x64xf32>
+  return %0 : tensor<16x64xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @matmul_epilogue(
+// CHECK:           scf.for
+// CHECK:             scf.for
+// CHECK:               scf.for
+// CHECK:                 linalg.matmul ins(%{{.*}}, %{{.*}} : tensor<8x8xf32>, tensor<8x16xf32>) outs(%{{.*}} : tensor<8x16xf32>) -> tensor<8x16xf32>
+// CHECK:               linalg.generic {{.*}} ins(%{{.*}} : tensor<8x16xf32>) outs(%{{.*}} : tensor<8x16xf32>)
+// CHECK:                 arith.maxf
+// CHECK-NOT:       linalg.matmul
+func.func @matmul_epilogue(%arg0: tensor<16x32xf32>, %arg1: tensor<32x64xf32>) -> tensor<16x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [16, 64] : tensor<16x64xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%init : tensor<16x64xf32>) -> tensor<16x64xf32>
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<16x32xf32>, tensor<32x64xf32>) outs(%fill : tensor<16x64xf32>) -> tensor<16x64xf32>
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%0 : tensor<16x64xf32>) outs(%init : tensor<16x64xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %2 = arith.maxf %in, %cst : f32
+    linalg.yield %2 : f32
+  } -> tensor<16x64xf32>
+  return %1 : tensor<16x64xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @conv_padded_input(
+// CHECK-NOT:       tensor.pad
+// CHECK:           scf.for
+// CHECK:             scf.for
+// CHECK:               scf.for
+// CHECK:                 scf.for
+// CHECK:                   tensor.extract_slice %arg0
+// CHECK:                   tensor.pad
+// CHECK:                   linalg.conv_2d_nchw_fchw
+func.func @conv_padded_input(%arg0: tensor<1x16x8x8xf32>, %arg1: tensor<16x16x3x3xf32>, %arg2: tensor<1x16x8x8xf32>) -> tensor<1x16x8x8xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.pad %arg0 low[0, 0, 1, 1] high[0, 0, 1, 1] {
+  ^bb0(%a: index, %b: index, %c: index, %d: index):
+    tensor.yield %cst : f32
+  } : tensor<1x16x8x8xf32> to tensor<1x16x10x10xf32>
+  %1 = linalg.conv_2d_nchw_fchw {dilations = dense<1> : vector<2xi64>, strides = dense<1> : vector<2xi64>} ins(%0, %arg1 : tensor<1x16x10x10xf32>, tensor<16x16x3x3xf32>) outs(%arg2 : tensor<1x16x8x8xf32>) -> tensor<1x16x8x8xf32>
+  return %1 : tensor<1x16x8x8xf32>
+}
+
+// -----
+
+// The residual is also returned, so fusing the epilogue would compute it both
+// whole and in the tiles of the epilogue.
+// CHECK-LABEL:   func.func @matmul_epilogue$shared_producer(
+// CHECK:           %[[RESIDUAL:.*]] = linalg.generic
+// CHECK:             math.exp
+// CHECK:           scf.for
+// CHECK:             scf.for
+// CHECK:               scf.for
+// CHECK:                 linalg.matmul
+// CHECK:           linalg.generic {{.*}} ins(%{{.*}}, %[[RESIDUAL]] : tensor<16x64xf32>, tensor<16x64xf32>)
+// CHECK-NOT:         math.exp
+// CHECK:             arith.addf
+func.func @matmul_epilogue$shared_producer(%arg0: tensor<16x32xf32>, %arg1: tensor<32x64xf32>, %arg2: tensor<16x64xf32>) -> (tensor<16x64xf32>, tensor<16x64xf32>) {
+  %cst = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [16, 64] : tensor<16x64xf32>
+  %residual = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%arg2 : tensor<16x64xf32>) outs(%init : tensor<16x64xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %2 = math.exp %in : f32
+    linalg.yield %2 : f32
+  } -> tensor<16x64xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%init : tensor<16x64xf32>) -> tensor<16x64xf32>
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<16x32xf32>, tensor<32x64xf32>) outs(%fill : tensor<16x64xf32>) -> tensor<16x64xf32>
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>], iterator_types = ["parallel", "parallel"]} ins(%0, %residual : tensor<16x64xf32>, tensor<16x64xf32>) outs(%init : tensor<16x64xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %2 = arith.addf %in, %in_0 : f32
+    linalg.yield %2 : f32
+  } -> tensor<16x64xf32>
+  return %1, %residual : tensor<16x64xf32>, tensor<16x64xf32>
+}
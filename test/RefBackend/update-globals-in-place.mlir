@@ -0,0 +1,46 @@
+// RUN: torch-mlir-opt %s -split-input-file -pass-pipeline='func.func(refback-update-globals-in-place)' | FileCheck %s
+
+memref.global "private" @__refbackend_state_cache : memref<4xf32> = dense<0.0>
+
+// CHECK-LABEL:   func.func @updated(
+// CHECK-SAME:            %[[ARG:.*]]: memref<4xf32>) {
+// CHECK-NOT:       memref.alloc
+// CHECK-NOT:       memref.copy
+// CHECK:           %[[GLOBAL:.*]] = memref.get_global @__refbackend_state_cache : memref<4xf32>
+// CHECK:           linalg.generic {{.*}} ins(%[[ARG]] : memref<4xf32>) outs(%[[GLOBAL]] : memref<4xf32>)
+// CHECK-NOT:       memref.copy
+// CHECK:           return
+func.func @updated(%arg0: memref<4xf32>) {
+  %0 = memref.get_global @__refbackend_state_cache : memref<4xf32>
+  %1 = memref.alloc() : memref<4xf32>
+  memref.copy %0, %1 : memref<4xf32> to memref<4xf32>
+  linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%arg0 : memref<4xf32>) outs(%1 : memref<4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %2 = arith.addf %in, %out : f32
+    linalg.yield %2 : f32
+  }
+  %3 = memref.get_global @__refbackend_state_cache : memref<4xf32>
+  memref.copy %1, %3 : memref<4xf32> to memref<4xf32>
+  return
+}
+
+// -----
+
+memref.global "private" @__refbackend_state_cache : memref<4xf32> = dense<0.0>
+
+// The old value of the global is read after the update, so it can't be
+// overwritten.
+// CHECK-LABEL:   func.func @old_value_read(
+// CHECK:           memref.alloc
+// CHECK:           memref.copy
+// CHECK:           memref.copy
+func.func @old_value_read(%arg0: memref<4xf32>) {
+  %0 = memref.get_global @__refbackend_state_cache : memref<4xf32>
+  %1 = memref.alloc() : memref<4xf32>
+  memref.copy %0, %1 : memref<4xf32> to memref<4xf32>
+  memref.copy %arg0, %1 : memref<4xf32> to memref<4xf32>
+  memref.copy %0, %arg0 : memref<4xf32> to memref<4xf32>
+  %3 = memref.get_global @__refbackend_state_cache : memref<4xf32>
+  memref.copy %1, %3 : memref<4xf32> to memref<4xf32>
+  return
+}
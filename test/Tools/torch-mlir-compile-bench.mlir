@@ -0,0 +1,22 @@
+// RUN: torch-mlir-compile-bench %s -pass-pipeline=canonicalize -iterations=2 | FileCheck %s
+// RUN: torch-mlir-compile-bench %s -pass-pipeline=canonicalize -iterations=2 -json | FileCheck %s --check-prefix=JSON
+
+// CHECK: torch-mlir-compile-bench.mlir: 2 runs of 'canonicalize'
+// CHECK: Pipeline time: mean {{.*}} ms, min {{.*}} ms, max {{.*}} ms
+// CHECK: Peak heap usage of a run:
+// CHECK: IR size: 5 ops ({{[0-9]+}} bytes) -> 3 ops ({{[0-9]+}} bytes)
+// CHECK: canonicalize (1 runs)
+
+// JSON: "module": "torch-mlir-compile-bench.mlir"
+// JSON: "pipeline": "canonicalize"
+// JSON: "peak_heap_bytes": {{[0-9]+}}
+// JSON: "ops_before": 5
+// JSON: "ops_after": 3
+// JSON: "pass": "canonicalize"
+// JSON: "runs": 1
+
+func.func @add_zero(%arg0: i32) -> i32 {
+  %c0 = arith.constant 0 : i32
+  %0 = arith.addi %arg0, %c0 : i32
+  return %0 : i32
+}
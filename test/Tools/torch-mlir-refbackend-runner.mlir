@@ -0,0 +1,25 @@
+// RUN: torch-mlir-opt %s -convert-scf-to-cf -convert-memref-to-llvm -convert-arith-to-llvm -convert-func-to-llvm -reconcile-unrealized-casts > %t.mlir
+// RUN: torch-mlir-refbackend-runner %t.mlir -e forward -arg=1,2,3 -arg=10,20,30 | FileCheck %s
+// RUN: not torch-mlir-refbackend-runner %t.mlir -e missing 2>&1 | FileCheck %s --check-prefix=MISSING
+
+// The runtime calls the packed C interface of the function, which takes the
+// pointers to the unranked memref descriptors of its inputs and outputs.
+// CHECK: output 0: [1.100000e+01, 2.200000e+01, 3.300000e+01]
+
+// MISSING: error: 'missing' is not a function with static result shapes
+
+func.func @forward(%arg0: memref<*xf32>, %arg1: memref<*xf32>, %arg2: memref<*xf32>) attributes {llvm.emit_c_interface, refbackend.result_types = [memref<3xf32>]} {
+  %lhs = memref.cast %arg0 : memref<*xf32> to memref<3xf32>
+  %rhs = memref.cast %arg1 : memref<*xf32> to memref<3xf32>
+  %out = memref.cast %arg2 : memref<*xf32> to memref<3xf32>
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c3 = arith.constant 3 : index
+  scf.for %i = %c0 to %c3 step %c1 {
+    %0 = memref.load %lhs[%i] : memref<3xf32>
+    %1 = memref.load %rhs[%i] : memref<3xf32>
+    %2 = arith.addf %0, %1 : f32
+    memref.store %2, %out[%i] : memref<3xf32>
+  }
+  return
+}
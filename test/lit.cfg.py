@@ -60,6 +60,8 @@ llvm_config.with_environment('PATH', config.llvm_tools_dir, append_path=True)
 tool_dirs = [config.standalone_tools_dir, config.llvm_tools_dir]
 tools = [
     'torch-mlir-opt',
+    'torch-mlir-compile-bench',
+    'torch-mlir-refbackend-runner',
     ToolSubst('%PYTHON', config.python_executable, unresolved='ignore'),
 ]
 
@@ -0,0 +1,47 @@
+# -*- Python -*-
+# This file is licensed under a pytorch-style license
+# See LICENSE.pytorch for license information.
+
+import sys
+
+import torch
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+
+# RUN: %PYTHON %s %t.bin | torch-mlir-opt | FileCheck %s
+
+mb = ModuleBuilder()
+
+class TestModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        # Tensors at least as large as the threshold are stored in the file,
+        # each one starting on a page boundary.
+        # CHECK: %[[BIG:.*]] = torch.vtensor.external_literal "{{.*}}.bin", 0 : !torch.vtensor<[2,4],f32>
+        # CHECK: %[[BIG_T:.*]] = torch.copy.to_tensor %[[BIG]] : !torch.tensor<[2,4],f32>
+        # CHECK: %[[BIG64:.*]] = torch.vtensor.external_literal "{{.*}}.bin", 4096 : !torch.vtensor<[4],si64>
+        # CHECK: %[[BIG64_T:.*]] = torch.copy.to_tensor %[[BIG64]] : !torch.tensor<[4],si64>
+        # Smaller tensors are still embedded in the IR.
+        # CHECK: %[[SMALL:.*]] = torch.tensor.literal(dense<1.000000e+00> : tensor<2xf32>) : !torch.tensor<[2],f32>
+        # CHECK: torch.nn_module {
+        # CHECK:   torch.slot "big", %[[BIG_T]]
+        # CHECK:   torch.slot "big64", %[[BIG64_T]]
+        # CHECK:   torch.slot "small", %[[SMALL]]
+        self.big = torch.ones(2, 4)
+        self.big64 = torch.arange(4)
+        self.small = torch.ones(2)
+
+
+test_module = TestModule()
+recursivescriptmodule = torch.jit.script(test_module)
+# TODO: Automatically handle unpacking Python class RecursiveScriptModule into the underlying ScriptModule.
+mb.import_module(recursivescriptmodule._c, externalWeightsFile=sys.argv[1],
+                 externalWeightsMinBytes=32)
+mb.module.operation.print()
+
+with open(sys.argv[1], "rb") as f:
+    data = f.read()
+assert len(data) == 4096 + 4 * 8
+assert torch.equal(
+    torch.frombuffer(bytearray(data[:32]), dtype=torch.float32), torch.ones(8))
+assert torch.equal(
+    torch.frombuffer(bytearray(data[4096:]), dtype=torch.int64), torch.arange(4))
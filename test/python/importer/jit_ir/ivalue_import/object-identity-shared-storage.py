@@ -0,0 +1,41 @@
+# -*- Python -*-
+# This file is licensed under a pytorch-style license
+# See LICENSE.pytorch for license information.
+
+import typing
+
+import torch
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+
+# RUN: %PYTHON %s | torch-mlir-opt | FileCheck %s
+
+mb = ModuleBuilder()
+
+class Submodule(torch.nn.Module):
+    def __init__(self, t):
+        super().__init__()
+        self.t = t
+
+class TestModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        # Tensors with distinct identity that are exact views of the same
+        # storage (as with tied parameters) are imported as a single value.
+        # CHECK: %[[T:.*]] = torch.tensor.literal
+        # CHECK-NOT: torch.tensor.literal
+        # CHECK: %[[M:.*]] = torch.nn_module {
+        # CHECK:   torch.slot "t", %[[T]]
+        # CHECK: torch.nn_module {
+        # CHECK:   torch.slot "t1", %[[T]]
+        # CHECK:   torch.slot "t2", %[[T]]
+        # CHECK:   torch.slot "m", %[[M]]
+        self.t1 = torch.tensor([10., 20.])
+        self.t2 = self.t1.view(2)
+        self.m = Submodule(self.t1.detach())
+
+
+test_module = TestModule()
+recursivescriptmodule = torch.jit.script(test_module)
+# TODO: Automatically handle unpacking Python class RecursiveScriptModule into the underlying ScriptModule.
+mb.import_module(recursivescriptmodule._c)
+mb.module.operation.print()
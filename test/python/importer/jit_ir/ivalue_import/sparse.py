@@ -0,0 +1,34 @@
+# -*- Python -*-
+# This file is licensed under a pytorch-style license
+# See LICENSE.pytorch for license information.
+
+import typing
+
+import torch
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+
+# RUN: %PYTHON %s | torch-mlir-opt | FileCheck %s
+
+mb = ModuleBuilder()
+
+class TestModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        # The indices are not coalesced: (1, 2) is given twice.
+        self.matrix = torch.sparse_coo_tensor([[1, 0, 1], [2, 3, 2]],
+                                              [1.0, 2.0, 3.0], (2, 4))
+        self.vector = torch.sparse_coo_tensor([[3]], [5], (8,))
+
+# CHECK: %[[MATRIX:.*]] = torch.tensor.literal(sparse<{{\[}}[0, 3], [1, 2]], [2.000000e+00, 4.000000e+00]> : tensor<2x4xf32, #sparse_tensor.encoding<{{.*}}"dense", "compressed"{{.*}}>>) : !torch.tensor<[2,4],f32,#sparse_tensor.encoding<{{.*}}"dense", "compressed"{{.*}}>>
+# CHECK: %[[VECTOR:.*]] = torch.tensor.literal(sparse<{{.*}}> : tensor<8xsi64, #sparse_tensor.encoding<{{.*}}"compressed"{{.*}}>>) : !torch.tensor<[8],si64,#sparse_tensor.encoding<{{.*}}"compressed"{{.*}}>>
+# CHECK: torch.nn_module {
+# CHECK:   torch.slot "matrix", %[[MATRIX]] : !torch.tensor<[2,4],f32,#sparse_tensor.encoding<{{.*}}>>
+# CHECK:   torch.slot "vector", %[[VECTOR]] : !torch.tensor<[8],si64,#sparse_tensor.encoding<{{.*}}>>
+# CHECK: }
+
+
+test_module = TestModule()
+recursivescriptmodule = torch.jit.script(test_module)
+# TODO: Automatically handle unpacking Python class RecursiveScriptModule into the underlying ScriptModule.
+mb.import_module(recursivescriptmodule._c)
+mb.module.operation.print()
@@ -0,0 +1,34 @@
+# -*- Python -*-
+# This file is licensed under a pytorch-style license
+# See LICENSE.pytorch for license information.
+
+import torch
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder, LocationImportMode
+
+# RUN: %PYTHON %s | FileCheck %s
+
+@torch.jit.script
+def add3(t0, t1, t2):
+  # CHECK-LABEL: FUNCTION
+  # CHECK: func.func @__torch__.add3
+  # All ops get the location of the first node with source information.
+  # CHECK: debug-info-modes.py":[[# @LINE + 1]]
+  intermediate = t0 + t1
+  # CHECK-NOT: debug-info-modes.py":[[# @LINE + 1]]
+  final = intermediate + t2
+  return final
+
+print("FUNCTION")
+mb = ModuleBuilder()
+mb.import_function(add3, locationImportMode=LocationImportMode.FUNCTION)
+mb.module.operation.print(enable_debug_info=True)
+print()
+
+# CHECK-LABEL: NONE
+# CHECK: func.func @__torch__.add3
+# CHECK-NOT: debug-info-modes.py
+print("NONE")
+mb = ModuleBuilder()
+mb.import_function(add3, locationImportMode=LocationImportMode.NONE)
+mb.module.operation.print(enable_debug_info=True)
+print()
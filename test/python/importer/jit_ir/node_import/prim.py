@@ -160,5 +160,13 @@ graph():
   return (%list)
 """))
 
+# Tracing records the tensor as a constant of the graph.
+# CHECK-LABEL:   func.func @{{.*}}prim_Constant_tensor(
+# CHECK:           %[[LITERAL:.*]] = torch.tensor.literal(dense<[1.000000e+00, 2.000000e+00]> : tensor<2xf32>) : !torch.tensor<[2],f32>
+# CHECK:           torch.aten.add.Tensor %{{.*}}, %[[LITERAL]]
+def prim_Constant_tensor(x):
+    return x + torch.tensor([1.0, 2.0])
+mb.import_function(torch.jit.trace(prim_Constant_tensor, torch.ones(2)))
+
 mb.module.operation.print()
 print()
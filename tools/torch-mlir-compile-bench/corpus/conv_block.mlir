@@ -0,0 +1,65 @@
+// A convolution, batch norm and ReLU block followed by a classifier head, as
+// imported from TorchScript.
+module attributes {torch.debug_module_name = "ConvBlock"} {
+  func.func private @__torch__.ConvBlock.forward(%arg0: !torch.nn.Module<"__torch__.ConvBlock">, %arg1: !torch.tensor {torch.type_bound = !torch.vtensor<[4,3,64,64],f32>}) -> !torch.tensor {
+    %int0 = torch.constant.int 0
+    %int1 = torch.constant.int 1
+    %int2 = torch.constant.int 2
+    %int-1 = torch.constant.int -1
+    %false = torch.constant.bool false
+    %true = torch.constant.bool true
+    %float1.000000e-01 = torch.constant.float 1.000000e-01
+    %float1.000000e-05 = torch.constant.float 1.000000e-05
+    %0 = torch.prim.GetAttr %arg0["conv_weight"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %1 = torch.prim.GetAttr %arg0["conv_bias"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %2 = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+    %3 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+    %4 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+    %5 = torch.aten.conv2d %arg1, %0, %1, %2, %3, %4, %int1 : !torch.tensor, !torch.tensor, !torch.tensor, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.int -> !torch.tensor
+    %6 = torch.prim.GetAttr %arg0["bn_weight"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %7 = torch.prim.GetAttr %arg0["bn_bias"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %8 = torch.prim.GetAttr %arg0["bn_running_mean"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %9 = torch.prim.GetAttr %arg0["bn_running_var"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %10 = torch.aten.batch_norm %5, %6, %7, %8, %9, %false, %float1.000000e-01, %float1.000000e-05, %true : !torch.tensor, !torch.tensor, !torch.tensor, !torch.tensor, !torch.tensor, !torch.bool, !torch.float, !torch.float, !torch.bool -> !torch.tensor
+    %11 = torch.aten.relu %10 : !torch.tensor -> !torch.tensor
+    %12 = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+    %13 = torch.aten.adaptive_avg_pool2d %11, %12 : !torch.tensor, !torch.list<int> -> !torch.tensor
+    %14 = torch.aten.flatten.using_ints %13, %int1, %int-1 : !torch.tensor, !torch.int, !torch.int -> !torch.tensor
+    %15 = torch.prim.GetAttr %arg0["fc_weight"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %16 = torch.prim.GetAttr %arg0["fc_bias"] : !torch.nn.Module<"__torch__.ConvBlock"> -> !torch.tensor
+    %17 = torch.aten.linear %14, %15, %16 : !torch.tensor, !torch.tensor, !torch.tensor -> !torch.tensor
+    return %17 : !torch.tensor
+  }
+  torch.class_type @__torch__.ConvBlock {
+    torch.attr private "training" : !torch.bool
+    torch.attr private "conv_weight" : !torch.tensor
+    torch.attr private "conv_bias" : !torch.tensor
+    torch.attr private "bn_weight" : !torch.tensor
+    torch.attr private "bn_bias" : !torch.tensor
+    torch.attr private "bn_running_mean" : !torch.tensor
+    torch.attr private "bn_running_var" : !torch.tensor
+    torch.attr private "fc_weight" : !torch.tensor
+    torch.attr private "fc_bias" : !torch.tensor
+    torch.method "forward", @__torch__.ConvBlock.forward
+  }
+  %false = torch.constant.bool false
+  %0 = torch.tensor.literal(dense<1.000000e-02> : tensor<32x3x3x3xf32>) : !torch.tensor<[32,3,3,3],f32>
+  %1 = torch.tensor.literal(dense<0.000000e+00> : tensor<32xf32>) : !torch.tensor<[32],f32>
+  %2 = torch.tensor.literal(dense<1.000000e+00> : tensor<32xf32>) : !torch.tensor<[32],f32>
+  %3 = torch.tensor.literal(dense<0.000000e+00> : tensor<32xf32>) : !torch.tensor<[32],f32>
+  %4 = torch.tensor.literal(dense<0.000000e+00> : tensor<32xf32>) : !torch.tensor<[32],f32>
+  %5 = torch.tensor.literal(dense<1.000000e+00> : tensor<32xf32>) : !torch.tensor<[32],f32>
+  %6 = torch.tensor.literal(dense<1.000000e-02> : tensor<10x32xf32>) : !torch.tensor<[10,32],f32>
+  %7 = torch.tensor.literal(dense<0.000000e+00> : tensor<10xf32>) : !torch.tensor<[10],f32>
+  %8 = torch.nn_module {
+    torch.slot "training", %false : !torch.bool
+    torch.slot "conv_weight", %0 : !torch.tensor<[32,3,3,3],f32>
+    torch.slot "conv_bias", %1 : !torch.tensor<[32],f32>
+    torch.slot "bn_weight", %2 : !torch.tensor<[32],f32>
+    torch.slot "bn_bias", %3 : !torch.tensor<[32],f32>
+    torch.slot "bn_running_mean", %4 : !torch.tensor<[32],f32>
+    torch.slot "bn_running_var", %5 : !torch.tensor<[32],f32>
+    torch.slot "fc_weight", %6 : !torch.tensor<[10,32],f32>
+    torch.slot "fc_bias", %7 : !torch.tensor<[10],f32>
+  } : !torch.nn.Module<"__torch__.ConvBlock">
+}
@@ -0,0 +1,46 @@
+// A three-layer perceptron, as imported from TorchScript.
+module attributes {torch.debug_module_name = "MLP"} {
+  func.func private @__torch__.MLP.forward(%arg0: !torch.nn.Module<"__torch__.MLP">, %arg1: !torch.tensor {torch.type_bound = !torch.vtensor<[32,256],f32>}) -> !torch.tensor {
+    %0 = torch.prim.GetAttr %arg0["fc1_weight"] : !torch.nn.Module<"__torch__.MLP"> -> !torch.tensor
+    %1 = torch.prim.GetAttr %arg0["fc1_bias"] : !torch.nn.Module<"__torch__.MLP"> -> !torch.tensor
+    %2 = torch.aten.linear %arg1, %0, %1 : !torch.tensor, !torch.tensor, !torch.tensor -> !torch.tensor
+    %3 = torch.aten.relu %2 : !torch.tensor -> !torch.tensor
+    %4 = torch.prim.GetAttr %arg0["fc2_weight"] : !torch.nn.Module<"__torch__.MLP"> -> !torch.tensor
+    %5 = torch.prim.GetAttr %arg0["fc2_bias"] : !torch.nn.Module<"__torch__.MLP"> -> !torch.tensor
+    %6 = torch.aten.linear %3, %4, %5 : !torch.tensor, !torch.tensor, !torch.tensor -> !torch.tensor
+    %7 = torch.aten.relu %6 : !torch.tensor -> !torch.tensor
+    %8 = torch.prim.GetAttr %arg0["fc3_weight"] : !torch.nn.Module<"__torch__.MLP"> -> !torch.tensor
+    %9 = torch.prim.GetAttr %arg0["fc3_bias"] : !torch.nn.Module<"__torch__.MLP"> -> !torch.tensor
+    %10 = torch.aten.linear %7, %8, %9 : !torch.tensor, !torch.tensor, !torch.tensor -> !torch.tensor
+    %int1 = torch.constant.int 1
+    %none = torch.constant.none
+    %11 = torch.aten.log_softmax.int %10, %int1, %none : !torch.tensor, !torch.int, !torch.none -> !torch.tensor
+    return %11 : !torch.tensor
+  }
+  torch.class_type @__torch__.MLP {
+    torch.attr private "training" : !torch.bool
+    torch.attr private "fc1_weight" : !torch.tensor
+    torch.attr private "fc1_bias" : !torch.tensor
+    torch.attr private "fc2_weight" : !torch.tensor
+    torch.attr private "fc2_bias" : !torch.tensor
+    torch.attr private "fc3_weight" : !torch.tensor
+    torch.attr private "fc3_bias" : !torch.tensor
+    torch.method "forward", @__torch__.MLP.forward
+  }
+  %false = torch.constant.bool false
+  %0 = torch.tensor.literal(dense<1.000000e-02> : tensor<512x256xf32>) : !torch.tensor<[512,256],f32>
+  %1 = torch.tensor.literal(dense<0.000000e+00> : tensor<512xf32>) : !torch.tensor<[512],f32>
+  %2 = torch.tensor.literal(dense<1.000000e-02> : tensor<512x512xf32>) : !torch.tensor<[512,512],f32>
+  %3 = torch.tensor.literal(dense<0.000000e+00> : tensor<512xf32>) : !torch.tensor<[512],f32>
+  %4 = torch.tensor.literal(dense<1.000000e-02> : tensor<10x512xf32>) : !torch.tensor<[10,512],f32>
+  %5 = torch.tensor.literal(dense<0.000000e+00> : tensor<10xf32>) : !torch.tensor<[10],f32>
+  %6 = torch.nn_module {
+    torch.slot "training", %false : !torch.bool
+    torch.slot "fc1_weight", %0 : !torch.tensor<[512,256],f32>
+    torch.slot "fc1_bias", %1 : !torch.tensor<[512],f32>
+    torch.slot "fc2_weight", %2 : !torch.tensor<[512,512],f32>
+    torch.slot "fc2_bias", %3 : !torch.tensor<[512],f32>
+    torch.slot "fc3_weight", %4 : !torch.tensor<[10,512],f32>
+    torch.slot "fc3_bias", %5 : !torch.tensor<[10],f32>
+  } : !torch.nn.Module<"__torch__.MLP">
+}
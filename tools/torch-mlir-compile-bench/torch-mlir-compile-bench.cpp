@@ -0,0 +1,333 @@
+//===- torch-mlir-compile-bench.cpp - Compile-time benchmark driver -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+//
+// Runs a pass pipeline on each module of a corpus a number of times, and
+// reports the time of the pipeline and of each pass, the peak heap usage of
+// the pipeline, and the size of the IR before and after the pipeline. Each run
+// starts from a freshly parsed module, and parsing is not timed.
+//
+// For example:
+//
+//   torch-mlir-compile-bench tools/torch-mlir-compile-bench/corpus/*.mlir \
+//     -pass-pipeline=torchscript-module-to-torch-backend-pipeline \
+//     -iterations=10
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/InitAllDialects.h"
+#include "mlir/InitAllPasses.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/FileUtilities.h"
+#include "torch-mlir/InitAll.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+using namespace mlir;
+
+static llvm::cl::list<std::string>
+    inputFilenames(llvm::cl::Positional, llvm::cl::OneOrMore,
+                   llvm::cl::desc("<corpus modules>"));
+
+static llvm::cl::opt<std::string>
+    passPipeline("pass-pipeline", llvm::cl::Required,
+                 llvm::cl::desc("The textual pass pipeline to benchmark, "
+                                "anchored on the module"));
+
+static llvm::cl::opt<unsigned>
+    iterations("iterations", llvm::cl::init(5),
+               llvm::cl::desc("The number of runs of the pipeline on each "
+                              "module"));
+
+static llvm::cl::opt<bool> enableThreading(
+    "threading", llvm::cl::init(false),
+    llvm::cl::desc("Run the passes multithreaded, which makes the per-pass "
+                   "times add up to more than the pipeline time"));
+
+static llvm::cl::opt<bool>
+    jsonOutput("json", llvm::cl::init(false),
+               llvm::cl::desc("Print the results as JSON, one object per "
+                              "module"));
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The time of the passes of a pipeline, accumulated over its runs, and the
+// peak heap usage sampled around each pass, above the usage when the pipeline
+// started.
+class BenchmarkInstrumentation : public PassInstrumentation {
+public:
+  struct PassTime {
+    double seconds = 0;
+    unsigned runs = 0;
+  };
+
+  void runBeforePass(Pass *pass, Operation *op) override {
+    sampleHeap();
+    std::lock_guard<std::mutex> lock(mutex);
+    starts[{pass, op}] = Clock::now();
+  }
+  void runAfterPass(Pass *pass, Operation *op) override { record(pass, op); }
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    record(pass, op);
+  }
+
+  void sampleHeap() {
+    size_t usage = llvm::sys::Process::GetMallocUsage();
+    std::lock_guard<std::mutex> lock(mutex);
+    peakHeap = std::max(peakHeap, usage);
+  }
+
+  // Starts measuring the peak heap usage from the current usage, which
+  // includes the parsed module and whatever earlier modules left allocated.
+  void resetHeap() {
+    size_t usage = llvm::sys::Process::GetMallocUsage();
+    std::lock_guard<std::mutex> lock(mutex);
+    baseHeap = peakHeap = usage;
+  }
+
+  // The peak heap usage since `resetHeap`, above the usage at that point.
+  size_t getPeakHeapIncrease() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peakHeap - baseHeap;
+  }
+
+  // By pass argument, in the order the passes first ran. The passes nesting
+  // other passes count the time of the nested passes.
+  llvm::MapVector<StringRef, PassTime> passTimes;
+
+private:
+  void record(Pass *pass, Operation *op) {
+    Clock::time_point end = Clock::now();
+    sampleHeap();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = starts.find({pass, op});
+    if (it == starts.end())
+      return;
+    // The adaptors running nested pass managers have no argument: their time
+    // is that of the passes they run.
+    StringRef argument = pass->getArgument();
+    if (!argument.empty()) {
+      PassTime &time = passTimes[argument];
+      time.seconds += std::chrono::duration<double>(end - it->second).count();
+      time.runs++;
+    }
+    starts.erase(it);
+  }
+
+  std::mutex mutex;
+  DenseMap<std::pair<Pass *, Operation *>, Clock::time_point> starts;
+  size_t baseHeap = 0;
+  size_t peakHeap = 0;
+};
+
+// The number of operations of a module and the size of its textual form,
+// without the contents of large constants.
+struct IRSize {
+  int64_t numOps = 0;
+  size_t numBytes = 0;
+};
+
+// The results of the runs of the pipeline on a module.
+struct ModuleResults {
+  std::string name;
+  SmallVector<double> seconds;
+  IRSize sizeBefore;
+  IRSize sizeAfter;
+  // The largest peak heap usage of a run, above the usage before the run.
+  size_t peakHeap = 0;
+  std::vector<std::pair<std::string, BenchmarkInstrumentation::PassTime>>
+      passTimes;
+};
+} // namespace
+
+static IRSize getIRSize(ModuleOp module) {
+  IRSize size;
+  module.walk([&](Operation *) { size.numOps++; });
+  std::string text;
+  llvm::raw_string_ostream os(text);
+  module.print(os, OpPrintingFlags().elideLargeElementsAttrs());
+  size.numBytes = os.str().size();
+  return size;
+}
+
+static FailureOr<ModuleResults> benchmarkModule(MLIRContext &context,
+                                                StringRef filename) {
+  std::string errorMessage;
+  std::unique_ptr<llvm::MemoryBuffer> buffer =
+      openInputFile(filename, &errorMessage);
+  if (!buffer) {
+    llvm::errs() << errorMessage << "\n";
+    return failure();
+  }
+
+  ModuleResults results;
+  results.name = llvm::sys::path::filename(filename).str();
+  for (unsigned i = 0; i < iterations; i++) {
+    OwningOpRef<ModuleOp> module =
+        parseSourceString<ModuleOp>(buffer->getBuffer(), &context);
+    if (!module) {
+      llvm::errs() << "failed to parse " << filename << "\n";
+      return failure();
+    }
+    if (i == 0)
+      results.sizeBefore = getIRSize(*module);
+
+    PassManager pm(&context);
+    applyPassManagerCLOptions(pm);
+    auto ownedInstrumentation = std::make_unique<BenchmarkInstrumentation>();
+    BenchmarkInstrumentation *runInstrumentation = ownedInstrumentation.get();
+    pm.addInstrumentation(std::move(ownedInstrumentation));
+    if (failed(parsePassPipeline(passPipeline, pm, llvm::errs())))
+      return failure();
+
+    runInstrumentation->resetHeap();
+    Clock::time_point start = Clock::now();
+    LogicalResult result = pm.run(*module);
+    Clock::time_point end = Clock::now();
+    if (failed(result)) {
+      llvm::errs() << "the pipeline failed on " << filename << "\n";
+      return failure();
+    }
+    results.seconds.push_back(
+        std::chrono::duration<double>(end - start).count());
+    results.peakHeap =
+        std::max(results.peakHeap, runInstrumentation->getPeakHeapIncrease());
+    for (auto &it : runInstrumentation->passTimes) {
+      auto existing = llvm::find_if(results.passTimes, [&](auto &passTime) {
+        return passTime.first == it.first;
+      });
+      if (existing == results.passTimes.end()) {
+        results.passTimes.emplace_back(it.first.str(), it.second);
+        continue;
+      }
+      existing->second.seconds += it.second.seconds;
+      existing->second.runs += it.second.runs;
+    }
+    if (i + 1 == iterations)
+      results.sizeAfter = getIRSize(*module);
+  }
+  llvm::stable_sort(results.passTimes, [](auto &lhs, auto &rhs) {
+    return lhs.second.seconds > rhs.second.seconds;
+  });
+  return results;
+}
+
+static void printText(const ModuleResults &results) {
+  llvm::outs() << "===" << std::string(73, '-') << "===\n";
+  llvm::outs() << results.name << ": " << results.seconds.size()
+               << " runs of '" << passPipeline << "'\n";
+  llvm::outs() << "===" << std::string(73, '-') << "===\n";
+  double total = 0;
+  for (double seconds : results.seconds)
+    total += seconds;
+  double mean = total / results.seconds.size();
+  llvm::outs() << llvm::format(
+      "  Pipeline time: mean %.3f ms, min %.3f ms, max %.3f ms\n", mean * 1e3,
+      *std::min_element(results.seconds.begin(), results.seconds.end()) * 1e3,
+      *std::max_element(results.seconds.begin(), results.seconds.end()) * 1e3);
+  llvm::outs() << llvm::format("  Peak heap usage of a run: %.1f MiB\n",
+                               results.peakHeap / (1024.0 * 1024.0));
+  llvm::outs() << "  IR size: " << results.sizeBefore.numOps << " ops ("
+               << results.sizeBefore.numBytes << " bytes) -> "
+               << results.sizeAfter.numOps << " ops ("
+               << results.sizeAfter.numBytes << " bytes)\n";
+  llvm::outs() << "  Per-pass time, per run, including nested passes:\n";
+  for (auto &it : results.passTimes) {
+    double seconds = it.second.seconds / results.seconds.size();
+    llvm::outs() << llvm::format("  %10.3f ms %6.1f%%  ", seconds * 1e3,
+                                 100 * seconds / mean)
+                 << it.first << " (" << it.second.runs / results.seconds.size()
+                 << " runs)\n";
+  }
+  llvm::outs() << "\n";
+}
+
+static void printJson(llvm::json::OStream &json,
+                      const ModuleResults &results) {
+  json.object([&] {
+    json.attribute("module", results.name);
+    json.attribute("pipeline", passPipeline);
+    json.attributeArray("seconds", [&] {
+      for (double seconds : results.seconds)
+        json.value(seconds);
+    });
+    json.attribute("peak_heap_bytes", static_cast<int64_t>(results.peakHeap));
+    json.attribute("ops_before", results.sizeBefore.numOps);
+    json.attribute("bytes_before",
+                   static_cast<int64_t>(results.sizeBefore.numBytes));
+    json.attribute("ops_after", results.sizeAfter.numOps);
+    json.attribute("bytes_after",
+                   static_cast<int64_t>(results.sizeAfter.numBytes));
+    json.attributeArray("passes", [&] {
+      for (auto &it : results.passTimes) {
+        json.object([&] {
+          json.attribute("pass", it.first);
+          json.attribute("seconds",
+                         it.second.seconds / results.seconds.size());
+          json.attribute("runs", static_cast<int64_t>(it.second.runs /
+                                                      results.seconds.size()));
+        });
+      }
+    });
+  });
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  registerAllPasses();
+  mlir::torch::registerAllPasses();
+  registerPassManagerCLOptions();
+  llvm::cl::ParseCommandLineOptions(argc, argv,
+                                    "Torch-MLIR compile-time benchmark\n");
+  if (iterations == 0) {
+    llvm::errs() << "-iterations must be positive\n";
+    return 1;
+  }
+
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  mlir::torch::registerAllDialects(registry);
+  MLIRContext context(registry);
+  context.loadAllAvailableDialects();
+  if (!enableThreading)
+    context.disableMultithreading();
+
+  llvm::json::OStream json(llvm::outs(), /*IndentSize=*/2);
+  if (jsonOutput)
+    json.arrayBegin();
+  for (const std::string &filename : inputFilenames) {
+    FailureOr<ModuleResults> results = benchmarkModule(context, filename);
+    if (failed(results))
+      return 1;
+    if (jsonOutput)
+      printJson(json, *results);
+    else
+      printText(*results);
+  }
+  if (jsonOutput) {
+    json.arrayEnd();
+    llvm::outs() << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+//===- torch-mlir-refbackend-runner.cpp - Runs RefBackend modules ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+//
+// Invokes a function of a module lowered to the LLVM dialect by the
+// RefBackend, or of a shared library written by `export_shared_library`,
+// through the C++ runtime, and prints its results. The inputs and the results
+// are 1-D f32 memrefs.
+//
+// For example:
+//
+//   torch-mlir-refbackend-runner module.mlir -e forward -arg=1,2,3
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/RefBackend/Runtime.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir::torch::RefBackend;
+
+static llvm::cl::opt<std::string>
+    inputFilename(llvm::cl::Positional, llvm::cl::init("-"),
+                  llvm::cl::desc("<input module or shared library>"));
+
+static llvm::cl::opt<std::string>
+    functionName("e", llvm::cl::Required,
+                 llvm::cl::desc("The function to invoke"));
+
+static llvm::cl::list<std::string>
+    args("arg", llvm::cl::desc("A comma-separated 1-D f32 input, in the "
+                               "order of the arguments"));
+
+static llvm::cl::list<std::string>
+    sharedLibs("shared-libs", llvm::cl::CommaSeparated,
+               llvm::cl::desc("The libraries to link the module with"));
+
+static llvm::cl::opt<bool> isSharedLibrary(
+    "shared-library", llvm::cl::init(false),
+    llvm::cl::desc("Load the input as a shared library rather than JIT "
+                   "compiling it"));
+
+// Returns the size of the 1-D f32 memref `type`, or -1 for other types.
+static int64_t getVectorSize(llvm::StringRef type) {
+  int64_t size;
+  if (!type.consume_front("memref<") || !type.consume_back("xf32>") ||
+      type.getAsInteger(10, size))
+    return -1;
+  return size;
+}
+
+static StridedMemRefType<float, 1> getDescriptor(std::vector<float> &data) {
+  return {data.data(), data.data(), 0, {(int64_t)data.size()}, {1}};
+}
+
+static int reportError(llvm::Error error) {
+  llvm::errs() << "error: " << llvm::toString(std::move(error)) << "\n";
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv,
+                                    "Torch-MLIR RefBackend runner\n");
+
+  llvm::SmallVector<llvm::StringRef> sharedLibPaths(sharedLibs.begin(),
+                                              sharedLibs.end());
+  llvm::Expected<std::unique_ptr<Runtime>> runtime =
+      isSharedLibrary ? Runtime::loadSharedLibrary(inputFilename)
+                      : Runtime::loadModuleFile(inputFilename, sharedLibPaths);
+  if (!runtime)
+    return reportError(runtime.takeError());
+
+  llvm::Expected<llvm::ArrayRef<std::string>> resultTypes =
+      (*runtime)->getResultTypes(functionName);
+  if (!resultTypes)
+    return reportError(resultTypes.takeError());
+
+  // The descriptors point to the data, and must not move once taken.
+  std::vector<std::vector<float>> inputData, outputData;
+  for (const std::string &arg : args) {
+    std::vector<float> &data = inputData.emplace_back();
+    llvm::SmallVector<llvm::StringRef> elements;
+    llvm::SplitString(arg, elements, ",");
+    for (llvm::StringRef element : elements) {
+      double value;
+      if (element.trim().getAsDouble(value)) {
+        llvm::errs() << "error: '" << element << "' is not a number\n";
+        return 1;
+      }
+      data.push_back(value);
+    }
+  }
+  for (const std::string &type : *resultTypes) {
+    int64_t size = getVectorSize(type);
+    if (size < 0) {
+      llvm::errs() << "error: the result type " << type
+                   << " is not a 1-D f32 memref\n";
+      return 1;
+    }
+    outputData.emplace_back(size);
+  }
+
+  std::vector<StridedMemRefType<float, 1>> inputs, outputs;
+  for (std::vector<float> &data : inputData)
+    inputs.push_back(getDescriptor(data));
+  for (std::vector<float> &data : outputData)
+    outputs.push_back(getDescriptor(data));
+  llvm::SmallVector<MemRefArg> inputArgs, outputArgs;
+  for (StridedMemRefType<float, 1> &input : inputs)
+    inputArgs.push_back(getMemRefArg(input));
+  for (StridedMemRefType<float, 1> &output : outputs)
+    outputArgs.push_back(getMemRefArg(output));
+
+  if (llvm::Error error =
+          (*runtime)->invoke(functionName, inputArgs, outputArgs))
+    return reportError(std::move(error));
+
+  for (auto it : llvm::enumerate(outputData)) {
+    llvm::outs() << "output " << it.index() << ": [";
+    llvm::interleaveComma(it.value(), llvm::outs());
+    llvm::outs() << "]\n";
+  }
+  return 0;
+}